@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_BATCHENVIRONMENT_HH_
+#define IGNITION_GAZEBO_BATCHENVIRONMENT_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+#include <ignition/gazebo/ServerConfig.hh>
+#include <ignition/gazebo/Types.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class IGNITION_GAZEBO_HIDDEN BatchEnvironmentPrivate;
+
+    /// \class BatchEnvironment BatchEnvironment.hh
+    /// ignition/gazebo/BatchEnvironment.hh
+    /// \brief Steps a batch of identical worlds together, exchanging
+    /// observations and actions through contiguous arrays instead of
+    /// transport messages. This is meant for reinforcement learning
+    /// rollouts, where a learner calls Step() in a tight loop.
+    ///
+    /// The first world of the configured SDF is cloned once per batch
+    /// entry, and all copies are stepped in lockstep on a shared thread
+    /// pool, as fast as possible.
+    ///
+    /// Observations and actions are registered by scoped entity name, such
+    /// as `model::joint`, and component type. Each one takes a fixed number
+    /// of doubles per world, and both arrays are laid out world-major:
+    /// entry `i` of world `k` is at `k * ObservationSize() + i`.
+    ///
+    /// Supported observations:
+    ///   * components::JointPosition, components::JointVelocity: 1 value,
+    ///     the first axis of the joint.
+    ///   * components::Pose: 7 values, `x y z qw qx qy qz`, relative to the
+    ///     entity's parent.
+    ///
+    /// Supported actions:
+    ///   * components::JointForceCmd, components::JointVelocityCmd: 1 value,
+    ///     the first axis of the joint.
+    ///
+    /// ## Example Usage
+    ///
+    /// ```
+    /// ignition::gazebo::ServerConfig config;
+    /// config.SetSdfFile("cart_pole.sdf");
+    /// ignition::gazebo::BatchEnvironment env(config, 64);
+    /// env.AddObservation("cart_pole::pole_joint",
+    ///     ignition::gazebo::components::JointPosition::typeId);
+    /// env.AddAction("cart_pole::cart_joint",
+    ///     ignition::gazebo::components::JointForceCmd::typeId);
+    /// env.Reset();
+    /// while (learning)
+    /// {
+    ///   policy(env.Observations(), env.Actions());
+    ///   env.Step();
+    /// }
+    /// ```
+    class IGNITION_GAZEBO_VISIBLE BatchEnvironment
+    {
+      /// \brief Constructor
+      /// \param[in] _config Server configuration. Its SDF string, or its SDF
+      /// file if the string is empty, provides the world to be cloned.
+      /// \param[in] _count Number of worlds in the batch.
+      public: BatchEnvironment(const ServerConfig &_config,
+                               const unsigned int _count);
+
+      /// \brief Destructor
+      public: ~BatchEnvironment();
+
+      /// \brief Get the number of worlds in the batch.
+      /// \return Number of worlds, which is zero if the world couldn't be
+      /// loaded.
+      public: unsigned int Count() const;
+
+      /// \brief Append an observation to each world's observation vector.
+      /// \param[in] _scopedName Scoped name of the entity relative to the
+      /// world, such as `model::link`.
+      /// \param[in] _type Type of the component to be observed.
+      /// \return False if the entity wasn't found or the component type isn't
+      /// supported.
+      public: bool AddObservation(const std::string &_scopedName,
+                                  const ComponentTypeId _type);
+
+      /// \brief Append an action to each world's action vector.
+      /// \param[in] _scopedName Scoped name of the entity relative to the
+      /// world, such as `model::joint`.
+      /// \param[in] _type Type of the command component to be written.
+      /// \return False if the entity wasn't found or the component type isn't
+      /// supported.
+      public: bool AddAction(const std::string &_scopedName,
+                             const ComponentTypeId _type);
+
+      /// \brief Get the number of observation values of each world.
+      /// \return Observation size.
+      public: std::size_t ObservationSize() const;
+
+      /// \brief Get the number of action values of each world.
+      /// \return Action size.
+      public: std::size_t ActionSize() const;
+
+      /// \brief Get the observations of all worlds, which are updated by
+      /// Step() and Reset().
+      /// \return Array of Count() * ObservationSize() values.
+      public: const double *Observations() const;
+
+      /// \brief Get the actions of all worlds, to be filled in by the caller
+      /// before each Step().
+      /// \return Array of Count() * ActionSize() values.
+      public: double *Actions();
+
+      /// \brief Apply the actions and step all worlds, then update the
+      /// observations. The actions are applied again before each iteration.
+      /// \param[in] _iterations Number of iterations to step.
+      /// \return False if the worlds couldn't be run.
+      public: bool Step(const uint64_t _iterations = 1);
+
+      /// \brief Restore all worlds to their initial state and update the
+      /// observations. Joint positions and top level model poses are
+      /// restored, and joint velocities are zeroed. Simulation time keeps
+      /// increasing.
+      /// \return False if the worlds couldn't be run.
+      public: bool Reset();
+
+      /// \brief Restore a single world to its initial state and update the
+      /// observations, leaving the other worlds as they are.
+      /// \param[in] _world Index of the world.
+      /// \return False if the index is invalid or the worlds couldn't be run.
+      public: bool Reset(const unsigned int _world);
+
+      /// \brief Copy the current state of one world into all the others and
+      /// update the observations. This branches a world for what-if
+      /// rollouts: each copy can then be given different actions and
+      /// stepped, and Fork() or Reset() discards the branches. Joint
+      /// positions and velocities and top level model poses are copied,
+      /// but the velocities of free models aren't.
+      /// \param[in] _source Index of the world to be copied.
+      /// \return False if the index is invalid or the worlds couldn't be run.
+      public: bool Fork(const unsigned int _source);
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<BatchEnvironmentPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
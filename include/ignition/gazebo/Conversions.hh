@@ -80,6 +80,33 @@ namespace ignition
     /// \param[in] _in Chrono duration object.
     void set(msgs::Time *_msg, const std::chrono::steady_clock::duration &_in);
 
+    /// \brief Helper function that sets a mutable msgs::Geometry object
+    /// to the values contained in a sdf::Geometry object. The message is
+    /// cleared first, so it can be reused across calls without allocating
+    /// its fields again. The result is the same as
+    /// convert<msgs::Geometry>(_in).
+    /// \param[out] _msg Geometry message to set.
+    /// \param[in] _in SDF Geometry object.
+    void set(msgs::Geometry *_msg, const sdf::Geometry &_in);
+
+    /// \brief Helper function that sets a mutable msgs::Material object
+    /// to the values contained in a sdf::Material object. The message is
+    /// cleared first, so it can be reused across calls without allocating
+    /// its fields again. The result is the same as
+    /// convert<msgs::Material>(_in).
+    /// \param[out] _msg Material message to set.
+    /// \param[in] _in SDF Material object.
+    void set(msgs::Material *_msg, const sdf::Material &_in);
+
+    /// \brief Helper function that sets a mutable msgs::Light object
+    /// to the values contained in a sdf::Light object. The message is
+    /// cleared first, so it can be reused across calls without allocating
+    /// its fields again. The result is the same as
+    /// convert<msgs::Light>(_in).
+    /// \param[out] _msg Light message to set.
+    /// \param[in] _in SDF Light object.
+    void set(msgs::Light *_msg, const sdf::Light &_in);
+
     /// \brief Generic conversion from an SDF geometry to another type.
     /// \param[in] _in SDF geometry.
     /// \return Conversion result.
@@ -60,6 +60,42 @@ namespace ignition
 
     /// \brief Indicates a non-existant or invalid Entity.
     const Entity kNullEntity{0};
+
+    /// \brief Number of low bits of an Entity holding the index of its slot
+    /// in the entity table of the EntityComponentManager. The remaining high
+    /// bits hold the generation of the slot, which is increased every time
+    /// the slot is reused, so that entity ids are never reused. Entities
+    /// which don't reuse a slot have generation 0, so their id is the index.
+    const unsigned int kEntityIndexBits{40};
+
+    /// \brief Largest generation an entity can have.
+    const uint64_t kMaxEntityGeneration{
+        (uint64_t{1} << (64 - kEntityIndexBits)) - 1};
+
+    /// \brief Get the slot index of an entity.
+    /// \param[in] _entity Entity.
+    /// \return The low kEntityIndexBits bits of the entity.
+    inline uint64_t EntityIndex(const Entity _entity)
+    {
+      return _entity & ((uint64_t{1} << kEntityIndexBits) - 1);
+    }
+
+    /// \brief Get the slot generation of an entity.
+    /// \param[in] _entity Entity.
+    /// \return The high bits of the entity.
+    inline uint64_t EntityGeneration(const Entity _entity)
+    {
+      return _entity >> kEntityIndexBits;
+    }
+
+    /// \brief Make an entity from a slot index and generation.
+    /// \param[in] _index Slot index, must fit in kEntityIndexBits bits.
+    /// \param[in] _generation Generation of the slot.
+    /// \return The entity.
+    inline Entity MakeEntity(const uint64_t _index, const uint64_t _generation)
+    {
+      return (_generation << kEntityIndexBits) | _index;
+    }
     }
   }
 }
@@ -20,10 +20,15 @@
 #include <ignition/msgs/serialized.pb.h>
 #include <ignition/msgs/serialized_map.pb.h>
 
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <istream>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <tuple>
 #include <typeinfo>
 #include <type_traits>
 #include <unordered_set>
@@ -46,7 +51,98 @@ namespace ignition
     // Inline bracket to help doxygen filtering.
     inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     // Forward declarations.
+    class ComponentStorageBase;
     class IGNITION_GAZEBO_HIDDEN EntityComponentManagerPrivate;
+    class SpatialIndex;
+    class TaskPool;
+
+    /// \brief Term of an `Each` query that only matches entities which don't
+    /// have a component of type `ComponentTypeT`. The term doesn't add an
+    /// argument to the callback. For example, this iterates over all models
+    /// that aren't static:
+    ///
+    ///     _ecm.Each<components::Model, Without<components::Static>>(
+    ///         [&](const Entity &_entity, const components::Model *) -> bool
+    ///         {
+    ///           return true;
+    ///         });
+    template<typename ComponentTypeT>
+    struct Without
+    {
+    };
+
+    /// \brief Term of an `Each` query that matches entities whether or not
+    /// they have a component of type `ComponentTypeT`. The callback receives
+    /// a pointer to the component, which is nullptr for entities that don't
+    /// have it.
+    template<typename ComponentTypeT>
+    struct Optional
+    {
+    };
+
+    namespace traits
+    {
+      /// \brief Type trait that determines if `T` is a `std::function`.
+      template<typename T>
+      struct IsStdFunction : std::false_type
+      {
+      };
+
+      /// \brief Specialization for `std::function`.
+      template<typename ReturnT, typename ...ArgTs>
+      struct IsStdFunction<std::function<ReturnT(ArgTs...)>> : std::true_type
+      {
+      };
+
+      /// \brief Enabled for callables that aren't a `std::function`. Used to
+      /// choose between the type-erased and the inlined overloads of `Each`.
+      template<typename FunctionT>
+      using EnableIfNotStdFunction = std::enable_if_t<
+          !IsStdFunction<std::decay_t<FunctionT>>::value>;
+
+      /// \brief Describes a term of an `Each` query. A plain component type
+      /// is required, see the `Without` and `Optional` specializations.
+      template<typename T>
+      struct ViewTerm
+      {
+        /// \brief The component type of the term.
+        using ComponentType = T;
+
+        /// \brief Whether entities must not have the component.
+        static constexpr bool kExcluded = false;
+
+        /// \brief Whether entities may lack the component.
+        static constexpr bool kOptional = false;
+      };
+
+      /// \brief Specialization for excluded component types.
+      template<typename T>
+      struct ViewTerm<Without<T>>
+      {
+        /// \brief The component type of the term.
+        using ComponentType = T;
+
+        /// \brief Whether entities must not have the component.
+        static constexpr bool kExcluded = true;
+
+        /// \brief Whether entities may lack the component.
+        static constexpr bool kOptional = false;
+      };
+
+      /// \brief Specialization for optional component types.
+      template<typename T>
+      struct ViewTerm<Optional<T>>
+      {
+        /// \brief The component type of the term.
+        using ComponentType = T;
+
+        /// \brief Whether entities must not have the component.
+        static constexpr bool kExcluded = false;
+
+        /// \brief Whether entities may lack the component.
+        static constexpr bool kOptional = true;
+      };
+    }
 
     /// \brief Type alias for the graph that holds entities.
     /// Each vertex is an entity, and the direction points from the parent to
@@ -54,6 +150,71 @@ namespace ignition
     /// All edges are positive booleans.
     using EntityGraph = math::graph::DirectedGraph<Entity, bool>;
 
+    /// \brief Estimate of the memory held by an EntityComponentManager, see
+    /// EntityComponentManager::MemoryUsage. Sizes are in bytes, and only
+    /// count the manager's own containers, including their unused capacity.
+    /// Memory owned by the component data, such as strings or meshes, isn't
+    /// counted.
+    struct EcmMemoryUsage
+    {
+      /// \brief Memory held by the storage of one component type.
+      struct ComponentType
+      {
+        /// \brief Name of the component type.
+        std::string name;
+
+        /// \brief Number of components.
+        std::size_t count{0};
+
+        /// \brief Bytes of the storage, including change tracking.
+        std::size_t bytes{0};
+      };
+
+      /// \brief Storage of each component type, keyed by type id.
+      std::map<ComponentTypeId, ComponentType> componentTypes;
+
+      /// \brief Bytes of the storage of all component types.
+      std::size_t componentBytes{0};
+
+      /// \brief Number of views.
+      std::size_t viewCount{0};
+
+      /// \brief Bytes of all views.
+      std::size_t viewBytes{0};
+
+      /// \brief Number of archetypes, that is, distinct sets of component
+      /// types held by entities.
+      std::size_t archetypeCount{0};
+
+      /// \brief Bytes of all archetypes.
+      std::size_t archetypeBytes{0};
+
+      /// \brief Bytes of the table locating each entity's components.
+      std::size_t entityTableBytes{0};
+
+      /// \brief Number of entities whose descendants are cached.
+      std::size_t descendantCacheEntries{0};
+
+      /// \brief Bytes of the descendant cache.
+      std::size_t descendantCacheBytes{0};
+
+      /// \brief Number of entries in the lists of changed components of all
+      /// types, and of new and removed entities.
+      std::size_t changeTrackingEntries{0};
+
+      /// \brief Bytes of those lists.
+      std::size_t changeTrackingBytes{0};
+
+      /// \brief Get the sum of all the bytes above.
+      /// \return Total bytes.
+      std::size_t TotalBytes() const
+      {
+        return this->componentBytes + this->viewBytes + this->archetypeBytes +
+            this->entityTableBytes + this->descendantCacheBytes +
+            this->changeTrackingBytes;
+      }
+    };
+
     /** \class EntityComponentManager EntityComponentManager.hh \
      * ignition/gazebo/EntityComponentManager.hh
     **/
@@ -73,6 +234,41 @@ namespace ignition
       /// \return An id for the Entity, or kNullEntity on failure.
       public: Entity CreateEntity();
 
+      /// \brief Start a batch of entity and component creation, such as when
+      /// spawning many entities at once. Until the batch is committed, views
+      /// aren't updated when components are created or removed, and new
+      /// entities aren't reported as new. Parents set with SetParentEntity
+      /// are seen by ParentEntity and Descendants right away, but are only
+      /// added to the graph returned by Entities() on commit.
+      ///
+      /// Batches can be nested. The deferred work is applied on every
+      /// commit, and work is deferred until the outermost batch is committed.
+      public: void BeginBatch();
+
+      /// \brief Apply all the work deferred since BeginBatch, and end the
+      /// batch.
+      public: void CommitBatch();
+
+      /// \brief Clone an entity and all of its descendants, copying all of
+      /// their components. This is much cheaper than creating the same
+      /// entities again from SDF, so it's useful to spawn many copies of a
+      /// prototype. Systems such as physics and rendering create their
+      /// resources for the clones from their components, as they do for any
+      /// new entity. Plugins loaded for the original entities aren't loaded
+      /// for the clones.
+      ///
+      /// The ParentEntity components of the clones and the joints of
+      /// JointStates components are updated to refer to the clones. Other
+      /// components which refer to entities keep referring to the originals.
+      /// \param[in] _entity Root of the subtree to clone.
+      /// \param[in] _parent Parent of the cloned root, or kNullEntity to
+      /// leave it without parent.
+      /// \param[in] _name Name of the cloned root. If empty, it keeps the
+      /// original's name.
+      /// \return The cloned root, or kNullEntity if _entity doesn't exist.
+      public: Entity Clone(Entity _entity, Entity _parent,
+          const std::string &_name);
+
       /// \brief Get the number of entities on the server.
       /// \return Entity count.
       public: size_t EntityCount() const;
@@ -280,6 +476,9 @@ namespace ignition
       ///
       /// \detail Component type must have inequality operator.
       ///
+      /// If the name index is enabled and a Name component is given, only
+      /// the entities with that name are compared, see SetNameIndex.
+      ///
       /// \param[in] _desiredComponents All the components which must match.
       /// \return Entity or kNullEntity if no entity has the exact components.
       public: template<typename ...ComponentTypeTs>
@@ -295,6 +494,9 @@ namespace ignition
       ///
       /// \detail Component type must have inequality operator.
       ///
+      /// If the name index is enabled and a Name component is given, only
+      /// the entities with that name are compared, see SetNameIndex.
+      ///
       /// \param[in] _desiredComponents All the components which must match.
       /// \return All matching entities, or an empty vector if no child entity
       /// has the exact components.
@@ -447,6 +649,139 @@ namespace ignition
                   bool(const Entity &_entity,
                        const ComponentTypeTs *...)>>::type _f) const;
 
+      /// \brief Same as the `EachNoCache` overloads above, but takes any
+      /// callable instead of a `std::function`, so the callback can be
+      /// inlined. The callback is invoked with the entity and const pointers
+      /// to its components.
+      /// \param[in] _f Callback function to be called for each matching entity.
+      /// \tparam ComponentTypeTs All the desired component types.
+      /// \tparam FunctionT Type of the callable, which is deduced.
+      public: template<typename ...ComponentTypeTs, typename FunctionT,
+                       typename = traits::EnableIfNotStdFunction<FunctionT>>
+              void EachNoCache(FunctionT &&_f) const;
+
+      /// \brief Same as the `EachNoCache` overloads above, but takes any
+      /// callable instead of a `std::function`, so the callback can be
+      /// inlined. The callback is invoked with the entity and mutable
+      /// pointers to its components.
+      /// \param[in] _f Callback function to be called for each matching entity.
+      /// \tparam ComponentTypeTs All the desired component types.
+      /// \tparam FunctionT Type of the callable, which is deduced.
+      public: template<typename ...ComponentTypeTs, typename FunctionT,
+                       typename = traits::EnableIfNotStdFunction<FunctionT>>
+              void EachNoCache(FunctionT &&_f);
+
+      /// \brief Same as the `Each` overloads above, but takes any callable
+      /// instead of a `std::function`. This avoids type erasure and lets the
+      /// compiler inline the callback into the loop over the view. The
+      /// callback is invoked with the entity and const pointers to its
+      /// components.
+      ///
+      /// Besides plain component types, the query accepts `Without<T>` terms,
+      /// which exclude entities that have a `T`, and `Optional<T>` terms,
+      /// which pass a pointer that is nullptr for entities without a `T`.
+      /// Like plain types, both terms are resolved once when the view is
+      /// built and kept up to date as components are added and removed.
+      /// \param[in] _f Callback function to be called for each matching entity.
+      /// \tparam ComponentTypeTs All the desired component types and terms.
+      /// \tparam FunctionT Type of the callable, which is deduced.
+      /// \warning This function should not be called outside of System's
+      /// PreUpdate, Update, or PostUpdate callbacks.
+      public: template<typename ...ComponentTypeTs, typename FunctionT,
+                       typename = traits::EnableIfNotStdFunction<FunctionT>>
+              void Each(FunctionT &&_f) const;
+
+      /// \brief Same as the `Each` overloads above, but takes any callable
+      /// instead of a `std::function`. This avoids type erasure and lets the
+      /// compiler inline the callback into the loop over the view. The
+      /// callback is invoked with the entity and mutable pointers to its
+      /// components.
+      ///
+      /// Besides plain component types, the query accepts `Without<T>` terms,
+      /// which exclude entities that have a `T`, and `Optional<T>` terms,
+      /// which pass a pointer that is nullptr for entities without a `T`.
+      /// Like plain types, both terms are resolved once when the view is
+      /// built and kept up to date as components are added and removed.
+      /// \param[in] _f Callback function to be called for each matching entity.
+      /// \tparam ComponentTypeTs All the desired component types and terms.
+      /// \tparam FunctionT Type of the callable, which is deduced.
+      /// \warning This function should not be called outside of System's
+      /// PreUpdate, Update, or PostUpdate callbacks.
+      public: template<typename ...ComponentTypeTs, typename FunctionT,
+                       typename = traits::EnableIfNotStdFunction<FunctionT>>
+              void Each(FunctionT &&_f);
+
+      /// \brief Same as the `EachNew` overloads above, but takes any callable
+      /// instead of a `std::function`, so the callback can be inlined.
+      /// \param[in] _f Callback function to be called for each matching entity.
+      /// \tparam ComponentTypeTs All the desired component types.
+      /// \tparam FunctionT Type of the callable, which is deduced.
+      public: template<typename ...ComponentTypeTs, typename FunctionT,
+                       typename = traits::EnableIfNotStdFunction<FunctionT>>
+              void EachNew(FunctionT &&_f) const;
+
+      /// \brief Same as the `EachNew` overloads above, but takes any callable
+      /// instead of a `std::function`, so the callback can be inlined.
+      /// \param[in] _f Callback function to be called for each matching entity.
+      /// \tparam ComponentTypeTs All the desired component types.
+      /// \tparam FunctionT Type of the callable, which is deduced.
+      public: template<typename ...ComponentTypeTs, typename FunctionT,
+                       typename = traits::EnableIfNotStdFunction<FunctionT>>
+              void EachNew(FunctionT &&_f);
+
+      /// \brief Same as the `EachRemoved` overload above, but takes any
+      /// callable instead of a `std::function`, so the callback can be
+      /// inlined.
+      /// \param[in] _f Callback function to be called for each matching entity.
+      /// \tparam ComponentTypeTs All the desired component types.
+      /// \tparam FunctionT Type of the callable, which is deduced.
+      public: template<typename ...ComponentTypeTs, typename FunctionT,
+                       typename = traits::EnableIfNotStdFunction<FunctionT>>
+              void EachRemoved(FunctionT &&_f) const;
+
+      /// \brief Get all entities which contain given component types, as well
+      /// as the mutable components, and invoke the callback for them
+      /// concurrently on a shared pool of threads. The cached view is split
+      /// in chunks of `_grainSize` entities, and this call blocks until all
+      /// entities have been processed.
+      ///
+      /// The callback may be called concurrently from multiple threads, so it
+      /// must follow these rules:
+      /// * It may read and write the data of the components it receives, and
+      ///   only those of the entity it is called for.
+      /// * It may read other components from the ECM.
+      /// * It must not create or remove entities or components, call
+      ///   `SetChanged`, or call other `Each` functions for component types
+      ///   that haven't been queried before, since these modify the ECM.
+      /// * Any other state it touches must be synchronized by the caller.
+      ///
+      /// The callback's return value, if any, is ignored; all entities are
+      /// always visited, in no particular order.
+      /// \param[in] _f Callback function to be called for each matching entity.
+      /// \param[in] _grainSize Maximum number of entities processed by a
+      /// single task. Smaller values balance the load better, larger values
+      /// reduce scheduling overhead.
+      /// \tparam ComponentTypeTs All the desired mutable component types.
+      /// \tparam FunctionT Type of the callable, which is deduced.
+      /// \warning This function should not be called outside of System's
+      /// PreUpdate or Update callbacks.
+      public: template<typename ...ComponentTypeTs, typename FunctionT>
+              void ParallelEach(FunctionT &&_f, std::size_t _grainSize = 64);
+
+      /// \brief Const version of ParallelEach, which passes const pointers
+      /// to the components. The same rules apply, except that component data
+      /// must not be written.
+      /// \param[in] _f Callback function to be called for each matching entity.
+      /// \param[in] _grainSize Maximum number of entities processed by a
+      /// single task.
+      /// \tparam ComponentTypeTs All the desired component types.
+      /// \tparam FunctionT Type of the callable, which is deduced.
+      /// \warning This function should not be called outside of System's
+      /// PreUpdate, Update, or PostUpdate callbacks.
+      public: template<typename ...ComponentTypeTs, typename FunctionT>
+              void ParallelEach(FunctionT &&_f,
+                  std::size_t _grainSize = 64) const;
+
       /// \brief Get a graph with all the entities. Entities are vertices and
       /// edges point from parent to children.
       /// \return Entity graph.
@@ -491,10 +826,20 @@ namespace ignition
       /// \return True if there are new entities.
       public: bool HasNewEntities() const;
 
+      /// \brief Get the number of entities created since new entities were
+      /// last cleared, usually during the current step.
+      /// \return Number of new entities.
+      public: std::size_t NewEntityCount() const;
+
       /// \brief Get whether there are any entities marked to be removed.
       /// \return True if there are entities marked to be removed.
       public: bool HasEntitiesMarkedForRemoval() const;
 
+      /// \brief Get the number of entities marked to be removed.
+      /// \return Number of entities marked to be removed, or the number of
+      /// entities if all of them are.
+      public: std::size_t EntitiesMarkedForRemovalCount() const;
+
       /// \brief Get whether there are one-time component changes. These changes
       /// do not happen frequently and should be processed immediately.
       /// \return True if there are any components with one-time changes.
@@ -526,6 +871,10 @@ namespace ignition
       /// to get all components.
       /// \param[in] _full True to get all the entities and components.
       /// False will get only components and entities that have changed.
+      /// \param[in, out] _state Message to populate. If it was allocated on a
+      /// google::protobuf::Arena, the entity and component messages are
+      /// allocated on the same arena, so callers can reuse the memory by
+      /// resetting the arena between calls.
       public: void State(
                   msgs::SerializedStateMap &_state,
                   const std::unordered_set<Entity> &_entities = {},
@@ -574,12 +923,104 @@ namespace ignition
       public: gazebo::ComponentState ComponentState(const Entity _entity,
           const ComponentTypeId _typeId) const;
 
+      /// \brief Estimate the memory held by this manager, per component
+      /// type, view and cache. This takes time linear in the number of
+      /// entities, views and component types, so it's meant to be called
+      /// periodically, from the simulation thread.
+      /// \return Memory usage estimate.
+      public: EcmMemoryUsage MemoryUsage() const;
+
+      /// \brief Call a function for each component of the given type which
+      /// was marked as changed since the last step. Unchanged components
+      /// aren't visited, so the cost is proportional to the number of changed
+      /// components.
+      /// \param[in] _f Callable with the signature
+      /// `bool(const Entity &, const ComponentTypeT *, gazebo::ComponentState)`
+      /// which receives the entity, its component and the component's change
+      /// state. Return false to stop iterating. The callback must not create
+      /// or remove components of this type, or mark them as changed.
+      public: template<typename ComponentTypeT, typename FunctionT>
+              void EachChanged(FunctionT &&_f) const;
+
+      /// \brief Check whether any component of the given type was marked as
+      /// changed since the last step. This takes constant time, so systems
+      /// can use it to skip work on steps where nothing relevant changed.
+      /// \tparam ComponentTypeT Type of the components.
+      /// \return True if at least one component of the type has changed.
+      public: template<typename ComponentTypeT>
+              bool HasChangedComponents() const;
+
+      /// \brief Check whether any component of the given type was marked as
+      /// changed since the last step.
+      /// \param[in] _typeId Type of the components.
+      /// \return True if at least one component of the type has changed.
+      public: bool HasChangedComponents(const ComponentTypeId _typeId) const;
+
+      /// \brief Register a callback which is called once per simulation step
+      /// for each component of the given type which changed during the
+      /// step, after all systems have been updated. Components which didn't
+      /// change aren't visited, so systems don't need to poll every step.
+      /// \param[in] _f Callable with the signature
+      /// `void(const Entity &, const ComponentTypeT *, gazebo::ComponentState)`
+      /// which receives the entity, its component and the component's change
+      /// state. The callback must not modify the entity component manager
+      /// or register and remove observers.
+      /// \tparam ComponentTypeT Type of the components to observe.
+      /// \return An id for RemoveComponentObserver.
+      public: template<typename ComponentTypeT, typename FunctionT>
+              std::size_t OnComponentChanged(FunctionT &&_f);
+
+      /// \brief Remove a callback registered with OnComponentChanged.
+      /// \param[in] _id Id returned by OnComponentChanged.
+      /// \return True if the observer existed.
+      public: bool RemoveComponentObserver(const std::size_t _id);
+
       /// \brief All future entities will have an id that starts at _offset.
       /// This can be used to avoid entity id collisions, such as during log
       /// playback.
+      /// Entity recycling is disabled, since the entities below the offset
+      /// are created elsewhere and may reuse free slots themselves.
       /// \param[in] _offset Offset value.
       public: void SetEntityCreateOffset(uint64_t _offset);
 
+      /// \brief Set whether new entities reuse the slots of removed entities,
+      /// see EntityIndex. A reused slot gets the next generation, so the new
+      /// entity's id is different from all previous ids, but it is larger
+      /// than 32 bits. This keeps memory bounded in worlds which create and
+      /// remove entities over long periods of time. Disabled by default.
+      /// \param[in] _recycle True to reuse slots.
+      public: void SetEntityRecycling(bool _recycle);
+
+      /// \brief Set whether to keep an index of the entities by their Name
+      /// component, and by their Name and ParentEntity components together.
+      /// With the index, EntityByComponents, EntitiesByComponents and
+      /// ChildrenByComponents take time proportional to the number of
+      /// entities with the given name instead of the number of entities
+      /// with the given component types, when a Name component is among
+      /// the desired components. This speeds up lookups such as
+      /// Model::LinkByName in large worlds, at the cost of some memory and
+      /// of updating the index whenever a Name or ParentEntity component is
+      /// created, removed or changed. Changes to the data of these
+      /// components must go through SetComponentData or be followed by
+      /// SetChanged to be indexed. Disabled by default.
+      /// \param[in] _enable True to enable the index. Enabling it indexes
+      /// the existing entities.
+      public: void SetNameIndex(bool _enable);
+
+      /// \brief Get whether the name index is enabled, see SetNameIndex.
+      /// \return True if enabled.
+      public: bool NameIndex() const;
+
+      /// \brief Get a counter which changes whenever a component is created
+      /// or removed, including when entities are removed, and whenever a
+      /// Name or ParentEntity component is changed through
+      /// SetComponentData, SetChanged or SetState. As long as it doesn't
+      /// change, pointers returned by Component stay valid, and lookups by
+      /// name and parent give the same results, so helpers such as Link and
+      /// Model can cache them instead of looking them up on every call.
+      /// \return The counter, never 0.
+      public: uint64_t StructureVersion() const;
+
       /// \brief Clear the list of newly added entities so that a call to
       /// EachAdded after this will have no entities to iterate. This function
       /// is protected to facilitate testing.
@@ -597,6 +1038,39 @@ namespace ignition
       /// \brief Mark all components as not changed.
       protected: void SetAllComponentsUnchanged();
 
+      /// \brief Call the observers registered with OnComponentChanged for
+      /// each changed component of their type. This function is protected
+      /// to facilitate testing.
+      protected: void NotifyComponentObservers() const;
+
+      /// \brief Add the entities which changed during this step to a set:
+      /// the new entities, the ones being removed, and the ones which had
+      /// components changed or removed. This takes time proportional to the
+      /// number of changes, so callers can accumulate the changes over many
+      /// steps. This function is protected to facilitate testing.
+      /// \param[in, out] _entities Set the entities are added to.
+      protected: void AddChangedEntities(
+          std::unordered_set<Entity> &_entities) const;
+
+      /// \brief Set whether component lookups should skip locking the
+      /// component storages. This is meant to be enabled only while systems
+      /// run PostUpdate, when the ECM is read-only and may be accessed from
+      /// multiple threads. Components must not be created or removed while
+      /// lock-free reads are enabled.
+      /// \param[in] _lockFree True to enable lock-free reads.
+      protected: void SetLockFreeReads(bool _lockFree);
+
+      /// \brief Get whether component lookups are currently lock-free.
+      /// \return True if lock-free reads are enabled.
+      protected: bool LockFreeReads() const;
+
+      /// \brief Set the pool of threads used by ParallelEach and to
+      /// serialize state. The pool must outlive the entity component
+      /// manager, or be reset before it's destroyed.
+      /// \param[in] _pool The pool, or nullptr to use a pool shared by the
+      /// whole process.
+      protected: void SetTaskPool(TaskPool *_pool);
+
       /// \brief Get whether an Entity exists and is new.
       ///
       /// Entities are considered new in the time between their creation and a
@@ -632,6 +1106,43 @@ namespace ignition
                    const ComponentTypeId _componentTypeId,
                    const components::BaseComponent *_data);
 
+      /// \brief Implementation of CreateComponent which deserializes the
+      /// component directly into its storage.
+      /// \param[in] _entity The entity that will be associated with
+      /// the component.
+      /// \param[in] _componentTypeId Id of the component type.
+      /// \param[in] _in Stream holding the serialized component.
+      /// \return Key that uniquely identifies the component.
+      private: ComponentKey CreateComponentImplementation(
+                   const Entity _entity,
+                   const ComponentTypeId _componentTypeId,
+                   std::istream &_in);
+
+      /// \brief Get the storage a new component of a type is created in,
+      /// creating the storage if needed.
+      /// \param[in] _entity The entity that will be associated with
+      /// the component.
+      /// \param[in] _componentTypeId Id of the component type.
+      /// \return The storage, or nullptr if the type isn't registered.
+      private: ComponentStorageBase *StorageForNewComponent(
+                   const Entity _entity,
+                   const ComponentTypeId _componentTypeId);
+
+      /// \brief Add a component which was just created in its storage to
+      /// an entity.
+      /// \param[in] _entity The entity that will be associated with
+      /// the component.
+      /// \param[in] _componentTypeId Id of the component type.
+      /// \param[in] _storage Storage of the component.
+      /// \param[in] _componentIdPair Id of the component, and whether the
+      /// storage was expanded, as returned when it was created.
+      /// \return Key that uniquely identifies the component.
+      private: ComponentKey AddNewComponent(
+                   const Entity _entity,
+                   const ComponentTypeId _componentTypeId,
+                   ComponentStorageBase *_storage,
+                   const std::pair<ComponentId, bool> &_componentIdPair);
+
       /// \brief Get a component based on a component type.
       /// \param[in] _entity The entity.
       /// \param[in] _type Id of the component type.
@@ -664,60 +1175,127 @@ namespace ignition
       private: components::BaseComponent *ComponentImplementation(
                    const ComponentKey &_key);
 
-      /// \brief End of the AddComponentToView recursion. This function is
-      /// called when Rest is empty.
-      /// \param[in, out] _view The FirstComponent will be added to the
-      /// _view.
-      /// \param[in] _entity The entity.
-      private: template<typename FirstComponent,
-                        typename ...RemainingComponents,
-                        typename std::enable_if<
-                          sizeof...(RemainingComponents) == 0, int>::type = 0>
-          void AddComponentsToView(detail::View &_view,
-               const Entity _entity) const;
-
-      /// \brief Recursively add components to a view. This function is
-      /// called when Rest is NOT empty.
-      /// \param[in, out] _view The FirstComponent will be added to the
-      /// _view.
-      /// \param[in] _entity The entity.
-      private: template<typename FirstComponent,
-                        typename ...RemainingComponents,
-                        typename std::enable_if<
-                          sizeof...(RemainingComponents) != 0, int>::type = 0>
-          void AddComponentsToView(detail::View &_view,
-              const Entity _entity) const;
+      /// \brief Get a component based on the dense index of its type, see
+      /// Component::typeIndex. This finds the storage of the type without
+      /// hashing the type id, and is used by views while iterating.
+      /// \param[in] _typeIndex Dense index of the component type.
+      /// \param[in] _id Id of the component within its storage.
+      /// \return The component, or nullptr if there's no storage for the
+      /// type.
+      private: const components::BaseComponent *ComponentByTypeIndex(
+                   const std::size_t _typeIndex, const ComponentId _id) const;
 
       /// \brief Find a View that matches the set of ComponentTypeIds. If
       /// a match is not found, then a new view is created.
-      /// \tparam ComponentTypeTs All the component types that define a view.
+      /// \tparam ComponentTypeTs All the component types, or `Without` and
+      /// `Optional` terms, that define a view.
       /// \return A reference to the view.
       private: template<typename ...ComponentTypeTs>
           detail::View &FindView() const;
 
-      /// \brief Find a view based on the provided component type ids.
-      /// \param[in] _types The component type ids that serve as a key into
-      /// a map of views.
+      /// \brief Get the callback arguments that a term of an `Each` query
+      /// contributes for one entity of a view.
+      /// \param[in] _view The view being iterated.
+      /// \param[in] _index Index of the entity in the view.
+      /// \tparam TermT The component type or term.
+      /// \tparam kConst Whether to return const pointers.
+      /// \return An empty tuple for `Without` terms, otherwise a tuple with
+      /// a pointer to the component.
+      private: template<typename TermT, bool kConst>
+          auto EachArguments(const detail::View &_view,
+              const std::size_t _index) const;
+
+      /// \brief Find a view based on the provided key.
+      /// \param[in] _key The key into the map of views.
       /// \param[out] _iter Iterator to the found element in the view map.
       /// Check the return value to see if this iterator is valid.
       /// \return True if the view was found, false otherwise.
-      private: bool FindView(const std::set<ComponentTypeId> &_types,
-          std::map<detail::ComponentTypeKey,
+      private: bool FindView(const detail::ViewKey &_key,
+          std::map<detail::ViewKey,
           detail::View>::iterator &_iter) const;  // NOLINT
 
       /// \brief Add a new view to the set of stored views.
-      /// \param[in] _types The set of component type ids that is the key
-      /// for the view.
+      /// \param[in] _key The key for the view.
       /// \param[in] _view The view to add.
       /// \return An iterator to the view.
-      private: std::map<detail::ComponentTypeKey, detail::View>::iterator
-          AddView(const std::set<ComponentTypeId> &_types,
+      private: std::map<detail::ViewKey, detail::View>::iterator
+          AddView(const detail::ViewKey &_key,
               detail::View &&_view) const;
 
+      /// \brief Add all entities which match a view key to a view, together
+      /// with their components.
+      /// \param[in] _key Key of the view.
+      /// \param[in, out] _view View to populate, expected to be empty.
+      private: void PopulateView(const detail::ViewKey &_key,
+          detail::View &_view) const;
+
       /// \brief Update views that contain the provided entity.
       /// \param[in] _entity The entity.
       private: void UpdateViews(const Entity _entity);
 
+      /// \brief Run a task over the index range [0, _count) on the shared
+      /// task pool, split in chunks of at most _grainSize indices. Component
+      /// reads don't lock the storages while the task runs.
+      /// \param[in] _count Number of indices.
+      /// \param[in] _grainSize Maximum number of indices per chunk.
+      /// \param[in] _task Task receiving the range [_begin, _end) to process.
+      private: void ParallelFor(std::size_t _count, std::size_t _grainSize,
+          const std::function<void(std::size_t _begin, std::size_t _end)>
+          &_task) const;
+
+      /// \brief Call a function for each changed component of a type.
+      /// \param[in] _typeId Type of the components.
+      /// \param[in] _f Callback, see EachChanged.
+      private: void EachChangedImplementation(const ComponentTypeId _typeId,
+          const std::function<bool(const Entity &,
+              const components::BaseComponent *,
+              gazebo::ComponentState)> &_f) const;
+
+      /// \brief Register an observer of a component type.
+      /// \param[in] _typeId Type of the components.
+      /// \param[in] _f Callback, see OnComponentChanged.
+      /// \return Id of the observer.
+      private: std::size_t AddComponentObserver(const ComponentTypeId _typeId,
+          std::function<void(const Entity &,
+              const components::BaseComponent *,
+              gazebo::ComponentState)> _f);
+
+      /// \brief Get the spatial index shared by the systems using this
+      /// manager, creating it on first use. See SpatialIndex::Shared.
+      /// \return The shared index.
+      private: std::shared_ptr<SpatialIndex> SharedSpatialIndex() const;
+
+      /// \brief Get the entities which may match the given components from
+      /// the name index.
+      /// \param[in] _desired Components to match. The Name and
+      /// ParentEntity components among them are used to query the index.
+      /// \param[out] _candidates Entities with the given name, and parent if
+      /// given, sorted in ascending order. The other components still need
+      /// to be compared.
+      /// \return False if the index is disabled or there's no Name component
+      /// among the desired components, in which case all entities need to
+      /// be compared.
+      private: bool NameIndexCandidates(
+          std::initializer_list<const components::BaseComponent *> _desired,
+          std::vector<Entity> &_candidates) const;
+
+      /// \brief Update the name index after a component of an entity was
+      /// created, removed or changed. Does nothing if the index is disabled
+      /// or the component isn't a Name or ParentEntity component.
+      /// \param[in] _entity The entity.
+      /// \param[in] _typeId Type of the component.
+      private: void UpdateNameIndex(const Entity _entity,
+          const ComponentTypeId _typeId);
+
+      /// \brief Check whether an entity has all the given components, with
+      /// the given values.
+      /// \param[in] _entity The entity.
+      /// \param[in] _desiredComponents Components to compare.
+      /// \return True if all the components match.
+      private: template<typename ...ComponentTypeTs>
+               bool ComponentsMatch(const Entity _entity,
+                   const ComponentTypeTs &..._desiredComponents) const;
+
       /// \brief Get a component ID based on an entity and the component's type.
       /// \param[in] _entity The entity.
       /// \param[in] _type Component type ID.
@@ -764,6 +1342,10 @@ namespace ignition
       // Make View a friend so that it can access components.
       // This should be safe since View is internal to Gazebo.
       friend class detail::View;
+
+      // Make SpatialIndex a friend so that the index shared by systems lives
+      // as long as the manager.
+      friend class SpatialIndex;
     };
     }
   }
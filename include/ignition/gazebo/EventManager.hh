@@ -64,23 +64,7 @@ namespace ignition
               ignition::common::ConnectionPtr
               Connect(const typename E::CallbackT &_subscriber)
               {
-                if (this->events.find(typeid(E)) == this->events.end()) {
-                  this->events[typeid(E)] = std::make_unique<E>();
-                }
-
-                E *eventPtr = dynamic_cast<E *>(this->events[typeid(E)].get());
-                // All values in the map should be derived from Event,
-                // so this shouldn't be an issue, but it doesn't hurt to check.
-                if (eventPtr != nullptr)
-                {
-                  return eventPtr->Connect(_subscriber);
-                }
-                else
-                {
-                  ignerr << "Failed to connect event: "
-                    << typeid(E).name() << std::endl;
-                  return nullptr;
-                }
+                return this->EventPtr<E>()->Connect(_subscriber);
               }
 
       /// \brief Emit an event signal to connected subscribers.
@@ -89,31 +73,37 @@ namespace ignition
       public: template <typename E, typename ... Args>
               void Emit(Args && ... _args)
               {
-                if (this->events.find(typeid(E)) == this->events.end())
-                {
-                  // If there are no events of type E in the map, create it.
-                  // But it also means there is nothing to signal.
-                  //
-                  // This is also needed to suppress unused function warnings
-                  // for Events that are purely emitted, with no connections.
-                  this->events[typeid(E)] = std::make_unique<E>();
-                  return;
-                }
-
-                E *eventPtr = dynamic_cast<E *>(this->events[typeid(E)].get());
-                // All values in the map should be derived from Event,
-                // so this shouldn't be an issue, but it doesn't hurt to check.
-                if (eventPtr != nullptr)
-                {
-                  eventPtr->Signal(std::forward<Args>(_args) ...);
-                }
-                else
-                {
-                  ignerr << "Failed to signal event: "
-                    << typeid(E).name() << std::endl;
-                }
+                // Emitting an event without connections still creates it,
+                // which is also needed to suppress unused function warnings
+                // for events that are purely emitted.
+                this->EventPtr<E>()->Signal(std::forward<Args>(_args) ...);
               }
 
+      /// \brief Get the event of type E, creating it if needed.
+      ///
+      /// Events are owned by a map keyed by type, whose lookups compare
+      /// type names. Events are emitted at high rates, such as on every
+      /// render, so the address of each type's typeinfo is also cached,
+      /// which only takes a pointer hash to look up. A type may have one
+      /// typeinfo per shared library, so it may be cached more than once,
+      /// always pointing to the same event.
+      /// \return The event, never null.
+      private: template <typename E>
+               E *EventPtr()
+               {
+                 const std::type_info *type = &typeid(E);
+                 auto cached = this->eventCache.find(type);
+                 if (cached != this->eventCache.end())
+                   return static_cast<E *>(cached->second);
+
+                 // Only events of type E are stored under typeid(E)
+                 auto &event = this->events[typeid(E)];
+                 if (!event)
+                   event = std::make_unique<E>();
+
+                 this->eventCache[type] = event.get();
+                 return static_cast<E *>(event.get());
+               }
 
       /// \brief Convenience type for storing typeinfo references.
       private: using TypeInfoRef = std::reference_wrapper<const std::type_info>;
@@ -140,6 +130,11 @@ namespace ignition
       private: std::unordered_map<TypeInfoRef,
                                   std::unique_ptr<ignition::common::Event>,
                                   Hasher, EqualTo> events;
+
+      /// \brief Events by the address of their type's typeinfo, see
+      /// EventPtr.
+      private: std::unordered_map<const std::type_info *,
+                                  ignition::common::Event *> eventCache;
     };
     }
   }
@@ -60,6 +60,11 @@ namespace ignition
     ///    Link link(entity);
     ///    std::string name = link.Name(ecm);
     ///
+    /// The components read on every step, such as the world pose and
+    /// velocities, are kept in the object after they're first looked up,
+    /// until a component is created or removed in the entity component
+    /// manager. Because of this, a Link shouldn't be used from several
+    /// threads at once.
     class IGNITION_GAZEBO_VISIBLE Link
     {
       /// \brief Constructor
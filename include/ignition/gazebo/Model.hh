@@ -56,6 +56,11 @@ namespace ignition
     ///    Model model(entity);
     ///    std::string name = model.Name(ecm);
     ///
+    /// The entities found by LinkByName and JointByName are kept in the
+    /// object until a component is created or removed, or a name changes,
+    /// in the entity component manager. Because of this, a Model shouldn't
+    /// be used from several threads at once.
+    ///
     /// \todo(louise) Store the ecm instead of passing it at every API call.
     class IGNITION_GAZEBO_VISIBLE Model {
       /// \brief Constructor
@@ -18,6 +18,7 @@
 #define IGNITION_GAZEBO_CREATEREMOVE_HH_
 
 #include <memory>
+#include <vector>
 
 #include <sdf/Actor.hh>
 #include <sdf/Collision.hh>
@@ -86,7 +87,8 @@ namespace ignition
       public: ~SdfEntityCreator();
 
       /// \brief Create all entities that exist in the sdf::World object and
-      /// load their plugins.
+      /// load their plugins. The models are created as with
+      /// CreateEntities(const std::vector<const sdf::Model *> &).
       /// \param[in] _world SDF world object.
       /// \return World entity.
       public: Entity CreateEntities(const sdf::World *_world);
@@ -97,6 +99,15 @@ namespace ignition
       /// \return Model entity.
       public: Entity CreateEntities(const sdf::Model *_model);
 
+      /// \brief Create all entities that exist in several sdf::Model objects
+      /// and load their plugins. The components of the models are built
+      /// concurrently, and then added to the ECM in the same order as if
+      /// the models were created one by one, so the entities are the same.
+      /// \param[in] _models SDF model objects.
+      /// \return Model entities, in the same order as the models.
+      public: std::vector<Entity> CreateEntities(
+                  const std::vector<const sdf::Model *> &_models);
+
       /// \brief Create all entities that exist in the sdf::Actor object and
       /// load their plugins.
       /// \param[in] _actor SDF actor object.
@@ -155,6 +166,22 @@ namespace ignition
       /// \param[in] _parent Entity which should be _child's parent.
       public: void SetParent(Entity _child, Entity _parent);
 
+      /// \brief Start creating a batch of entities, such as when spawning
+      /// many models at once. The entity component manager's views are only
+      /// updated when the batch is committed, and the plugins of models,
+      /// actors, sensors and visuals created during the batch are loaded
+      /// then, once the views are up to date. This lets callers set the
+      /// parent and pose of new entities before their plugins are loaded.
+      ///
+      /// Batches can be nested, plugins are loaded when the outermost batch
+      /// is committed.
+      /// \sa EntityComponentManager::BeginBatch
+      public: void BeginBatch();
+
+      /// \brief Commit a batch begun with BeginBatch, and load the plugins of
+      /// the entities created during it.
+      public: void CommitBatch();
+
       /// \brief Overloaded function to recursively create model entities
       /// and make sure a) only one canonical link is created per model tree,
       /// and b) we override the nested model's static property to true if
@@ -18,13 +18,17 @@
 #define IGNITION_GAZEBO_SERVER_HH_
 
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <ignition/msgs/param_v.pb.h>
 #include <ignition/gazebo/config.hh>
 #include <ignition/gazebo/EntityComponentManager.hh>
 #include <ignition/gazebo/Export.hh>
 #include <ignition/gazebo/ServerConfig.hh>
 #include <ignition/gazebo/SystemPluginPtr.hh>
+#include <ignition/gazebo/Types.hh>
 
 namespace ignition
 {
@@ -33,6 +37,7 @@ namespace ignition
     // Inline bracket to help doxygen filtering.
     inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     // Forware declarations
+    class BatchEnvironment;
     class ServerPrivate;
 
     /// \class Server Server.hh ignition/gazebo/Server.hh
@@ -71,6 +76,27 @@ namespace ignition
     /// a world from the command line. If simulation starts running, the
     /// GUI client may miss the first few simulation iterations.
     ///
+    /// Applications which drive simulation from their own loop, such as
+    /// co-simulations, can step a world on their own thread instead, and
+    /// access its entities between steps through callbacks:
+    ///
+    /// ```
+    /// ignition::gazebo::Server server(config);
+    /// server.AddPreStepCallback(
+    ///     [&](const ignition::gazebo::UpdateInfo &_info,
+    ///         ignition::gazebo::EntityComponentManager &_ecm)
+    ///     {
+    ///       // Write commands to the ECM
+    ///     });
+    /// server.AddPostStepCallback(
+    ///     [&](const ignition::gazebo::UpdateInfo &_info,
+    ///         ignition::gazebo::EntityComponentManager &_ecm)
+    ///     {
+    ///       // Read results from the ECM
+    ///     });
+    /// server.Step(10);
+    /// ```
+    ///
     /// ## Services
     ///
     /// The following are services provided by the Server.
@@ -88,6 +114,12 @@ namespace ignition
     ///   3. /gazebo/resource_paths/add : ignition::msgs::Empty
     ///     + Add new resource paths.
     ///
+    ///   4. /world/<world_name>/trace/dump(ignition::msgs::StringMsg) :
+    ///      ignition::msgs::StringMsg
+    ///     + Write the latest trace events to a file in the Chrome trace
+    ///       event format, and return its path. Only available if
+    ///       ServerConfig::SetTraceEventsPerThread was set.
+    ///
     /// ## Topics
     ///
     /// The following are topics provided by the Server.
@@ -104,6 +136,22 @@ namespace ignition
     /// 3. /gazebo/resource_paths : ignition::msgs::StringMsg_V
     ///   + Updated list of resource paths.
     ///
+    /// 4. /world/<world_name>/stats/network : ignition::msgs::Param_V
+    ///   + Telemetry of the peers of a distributed simulation, see
+    ///     NetworkStats(). Published once per second.
+    ///
+    /// 5. /world/<world_name>/stats/memory : ignition::msgs::Param_V
+    ///   + Memory used by the entity component manager, see
+    ///     EntityComponentManager::MemoryUsage(). The first parameter holds
+    ///     the totals, followed by one parameter per component type, largest
+    ///     first. Published every 5 seconds while there are subscribers.
+    ///
+    /// 6. /world/<world_name>/diagnostics/slow_step : ignition::msgs::Param_V
+    ///   + Published after each step slower than
+    ///     ServerConfig::SlowStepThreshold(). The first parameter holds the
+    ///     step duration and the entity counts, followed by the slowest
+    ///     systems and their phase, slowest first.
+    ///
     class IGNITION_GAZEBO_VISIBLE Server
     {
       /// \brief Construct the server using the parameters specified in a
@@ -144,6 +192,46 @@ namespace ignition
                        const uint64_t _iterations = 0,
                        const bool _paused = true);
 
+      /// \brief Function called around the steps of Step(), with the update
+      /// information of the last step and the entity component manager of
+      /// the world.
+      public: using StepCallback = std::function<void(const UpdateInfo &,
+                  EntityComponentManager &)>;
+
+      /// \brief Step a world on the calling thread, as fast as possible.
+      /// Simulation is unpaused, isn't paced to real time and the server
+      /// doesn't wait for signals. Before each step, the callbacks added
+      /// with AddPreStepCallback() are called, and once the step is
+      /// complete, including its PostUpdate, the callbacks added with
+      /// AddPostStepCallback() are called. Nothing else accesses the
+      /// world's entities while callbacks run, so they can be read and
+      /// modified directly.
+      /// \param[in] _iterations Number of steps to perform.
+      /// \param[in] _worldIndex Index of the world.
+      /// \return True if the steps were performed, false if the server is
+      /// already running or the world was stopped, or std::nullopt if
+      /// _worldIndex is invalid.
+      public: std::optional<bool> Step(const uint64_t _iterations = 1,
+                  const unsigned int _worldIndex = 0);
+
+      /// \brief Add a callback called before each step of Step(). The
+      /// server must not be running when calling this.
+      /// \param[in] _cb Callback, called in the order of addition.
+      /// \param[in] _worldIndex Index of the world.
+      /// \return Whether the callback was added, or std::nullopt if
+      /// _worldIndex is invalid.
+      public: std::optional<bool> AddPreStepCallback(StepCallback _cb,
+                  const unsigned int _worldIndex = 0);
+
+      /// \brief Add a callback called after each step of Step(). The
+      /// server must not be running when calling this.
+      /// \param[in] _cb Callback, called in the order of addition.
+      /// \param[in] _worldIndex Index of the world.
+      /// \return Whether the callback was added, or std::nullopt if
+      /// _worldIndex is invalid.
+      public: std::optional<bool> AddPostStepCallback(StepCallback _cb,
+                  const unsigned int _worldIndex = 0);
+
       /// \brief Run the server once, all systems will be updated once and
       /// then this returns. This is a blocking call.
       /// \param[in] _paused True to run the simulation in a paused state,
@@ -270,8 +358,47 @@ namespace ignition
                                       bool _recursive = true,
                                       const unsigned int _worldIndex = 0);
 
+      /// \brief Capture the full state of a world in memory, so that it can
+      /// be restored later with Restore() without reloading SDF. The header
+      /// stamp holds the simulation time.
+      /// \param[in] _worldIndex Index of the world.
+      /// \return The state, or std::nullopt if _worldIndex is invalid.
+      public: std::optional<msgs::SerializedStateMap> Snapshot(
+                  const unsigned int _worldIndex = 0) const;
+
+      /// \brief Restore the state of a world captured by Snapshot(). The state
+      /// is applied right before the world's next iteration, so this can be
+      /// called while the server is running. Entities created after the
+      /// snapshot are removed, and the physics system resets joints and top
+      /// level models to their captured positions and joint velocities.
+      /// Joint velocities are only restored for joints which had a
+      /// components::JointVelocity when the snapshot was taken, and link
+      /// velocities of free models aren't restored.
+      /// \param[in] _snapshot State to restore.
+      /// \param[in] _worldIndex Index of the world.
+      /// \return True if the world referenced by _worldIndex exists, false
+      /// otherwise.
+      public: bool Restore(const msgs::SerializedStateMap &_snapshot,
+                           const unsigned int _worldIndex = 0);
+
+      /// \brief Get the telemetry of the peers of a distributed simulation,
+      /// as last reported in their heartbeats. There is one parameter per
+      /// peer, this server first, with the keys "id", "hostname", "role",
+      /// "step_time_ms" (wall time of the peer's last step),
+      /// "state_size_bytes" (state sent by a secondary or received by the
+      /// primary on its last step) and "queue_depth" (steps sent to the peer
+      /// which it hasn't finished; only known on the primary).
+      /// \param[in] _worldIndex Index of the world.
+      /// \return The telemetry, or std::nullopt if _worldIndex is invalid or
+      /// the world isn't part of a distributed simulation.
+      public: std::optional<msgs::Param_V> NetworkStats(
+                  const unsigned int _worldIndex = 0) const;
+
       /// \brief Private data
       private: std::unique_ptr<ServerPrivate> dataPtr;
+
+      /// \brief Batch environments step the simulation runners directly.
+      friend class BatchEnvironment;
     };
     }
   }
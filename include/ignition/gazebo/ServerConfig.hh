@@ -18,6 +18,7 @@
 #define IGNITION_GAZEBO_SERVERCONFIG_HH_
 
 #include <chrono>
+#include <cstddef>
 #include <list>
 #include <memory>
 #include <optional> // NOLINT(*)
@@ -212,6 +213,25 @@ namespace ignition
       /// \sa SetNetworkSecondaries(unsigned int _secondaries)
       public: unsigned int NetworkSecondaries() const;
 
+      /// \brief Set how many steps the network secondaries may lag behind
+      /// the primary. With a lag of zero, the primary waits for every
+      /// secondary to finish a step before running the next one. Otherwise,
+      /// the primary keeps sending steps while secondaries are at most
+      /// _lag steps behind, and applies their states as they arrive, which
+      /// hides the round trip latency at the cost of using states up to
+      /// _lag steps old. This value is valid only when
+      /// SetNetworkRole("primary") is also used.
+      /// \param[in] _lag Maximum number of steps not yet done by all
+      /// secondaries. Defaults to 0.
+      /// \sa NetworkMaxStepLag() const
+      public: void SetNetworkMaxStepLag(unsigned int _lag);
+
+      /// \brief Get how many steps the network secondaries may lag behind
+      /// the primary.
+      /// \return Maximum number of steps not yet done by all secondaries.
+      /// \sa SetNetworkMaxStepLag(unsigned int _lag)
+      public: unsigned int NetworkMaxStepLag() const;
+
       /// \brief Set the network role, which is one of [primary, secondary].
       /// If primary is used, then make sure to also set the numer of
       /// network secondaries via
@@ -275,6 +295,18 @@ namespace ignition
       /// \param[in] _playbackPath Path to recorded states
       public: void SetLogPlaybackPath(const std::string &_playbackPath);
 
+      /// \brief Queue recorded states to play back once the previous ones
+      /// are over, in the same world. Entities of each log are removed
+      /// before the next one starts, while systems such as sensors stay
+      /// loaded. If no path was set, this sets LogPlaybackPath.
+      /// \param[in] _playbackPath Path to recorded states
+      public: void AddLogPlaybackPath(const std::string &_playbackPath);
+
+      /// \brief Get the paths of all recorded states to play back, in
+      /// order, starting with LogPlaybackPath.
+      /// \return Paths to recorded states
+      public: const std::vector<std::string> &LogPlaybackPaths() const;
+
       /// \brief Get whether meshes and material files are recorded
       /// \return True if resources should be recorded.
       public: bool LogRecordResources() const;
@@ -291,6 +323,20 @@ namespace ignition
       /// \param[in] _path File path to compress log files to
       public: void SetLogRecordCompressPath(const std::string &_path);
 
+      /// \brief Get the sim time between full state keyframes recorded in
+      /// the log.
+      /// \return Keyframe interval, 0 if no keyframes are recorded.
+      public: std::chrono::steady_clock::duration
+          LogRecordKeyframeInterval() const;
+
+      /// \brief Set the sim time between full state keyframes recorded in
+      /// the log. Playback seeks to the closest keyframe instead of
+      /// replaying the log from the start, at the cost of a larger log. The
+      /// default is 0, which records no keyframes.
+      /// \param[in] _interval Keyframe interval, such as 60s.
+      public: void SetLogRecordKeyframeInterval(
+          const std::chrono::steady_clock::duration &_interval);
+
       /// \brief The given random seed.
       /// \return The random seed or 0 if not specified.
       public: unsigned int Seed() const;
@@ -299,6 +345,190 @@ namespace ignition
       /// \param[in] _seed The seed.
       public: void SetSeed(unsigned int _seed);
 
+      /// \brief Get the number of threads used to run systems and other
+      /// parallel work, including the simulation thread.
+      /// \return Number of threads, or 0 if one thread per hardware thread
+      /// is used.
+      public: unsigned int ThreadCount() const;
+
+      /// \brief Set the number of threads used to run systems and other
+      /// parallel work, including the simulation thread. This can be used to
+      /// limit the simulator to a subset of the cores of a shared machine.
+      /// \param[in] _count Number of threads. One runs everything on the
+      /// simulation thread, and 0, the default, uses one thread per hardware
+      /// thread.
+      public: void SetThreadCount(unsigned int _count);
+
+      /// \brief Get whether the PostUpdate of a step runs in the background
+      /// while the simulation thread prepares the next step.
+      /// \return True if PostUpdate is pipelined.
+      public: bool PipelinedPostUpdate() const;
+
+      /// \brief Set whether the PostUpdate of a step runs in the background
+      /// while the simulation thread paces and prepares the next step. The
+      /// end of a step, such as entity removals, is then deferred until the
+      /// PostUpdate is done. This is disabled by default, and is ignored by
+      /// distributed simulation.
+      /// \param[in] _pipelined True to pipeline PostUpdate.
+      public: void SetPipelinedPostUpdate(bool _pipelined);
+
+      /// \brief Get how long the simulation thread busy-waits at the end of
+      /// each real-time sleep.
+      /// \return Spin-wait duration, 0 if the thread only sleeps.
+      public: std::chrono::steady_clock::duration SpinWaitTime() const;
+
+      /// \brief Set how long the simulation thread busy-waits at the end of
+      /// each real-time sleep. The thread sleeps until this long before the
+      /// next step is due, then spins on the clock, so that steps start on
+      /// time even when the OS wakes threads up late. This costs one core
+      /// for up to that duration on every step. The default is 0, which
+      /// only sleeps.
+      /// \param[in] _duration Spin-wait duration, such as 200us.
+      public: void SetSpinWaitTime(
+                  const std::chrono::steady_clock::duration &_duration);
+
+      /// \brief Get the real-time priority of the simulation thread.
+      /// \return SCHED_FIFO priority, or 0 for the default scheduling.
+      public: int RealTimePriority() const;
+
+      /// \brief Set a real-time priority for the simulation thread, which
+      /// is then scheduled with SCHED_FIFO. This is only supported on Linux,
+      /// and usually requires the CAP_SYS_NICE capability. The default is 0,
+      /// which keeps the default scheduling.
+      /// \param[in] _priority SCHED_FIFO priority, between 1 and 99, or 0.
+      public: void SetRealTimePriority(int _priority);
+
+      /// \brief Get the CPUs the simulation thread is pinned to.
+      /// \return Indices of the CPUs, empty if the thread isn't pinned.
+      public: const std::vector<unsigned int> &CpuAffinity() const;
+
+      /// \brief Pin the simulation thread to a set of CPUs. This is only
+      /// supported on Linux. By default, the thread isn't pinned.
+      /// \param[in] _cpus Indices of the CPUs, empty to not pin the thread.
+      public: void SetCpuAffinity(const std::vector<unsigned int> &_cpus);
+
+      /// \brief Get the CPUs the worker threads are pinned to.
+      /// \return Indices of the CPUs, empty if the threads aren't pinned.
+      /// \sa SetWorkerCpuAffinity(const std::vector<unsigned int> &)
+      public: const std::vector<unsigned int> &WorkerCpuAffinity() const;
+
+      /// \brief Pin the server's worker threads to a set of CPUs. These are
+      /// the threads of the pool running parallel work, such as State()
+      /// serialization, and the PostUpdate thread if PostUpdate is
+      /// pipelined. This is only supported on Linux. By default, the threads
+      /// aren't pinned.
+      ///
+      /// Together with SetCpuAffinity, this keeps a server's threads on a
+      /// given set of cores, such as one NUMA node. Linux allocates memory on
+      /// the node of the thread which first touches it, so component storage
+      /// created by these threads stays local. ign-transport threads inherit
+      /// the affinity of the thread which creates the first node, so the
+      /// whole process should be pinned, for example with `taskset` or
+      /// `numactl`, to confine them too.
+      /// \param[in] _cpus Indices of the CPUs, empty to not pin the threads.
+      public: void SetWorkerCpuAffinity(const std::vector<unsigned int> &_cpus);
+
+      /// \brief Get whether the worlds of the server are stepped in
+      /// lockstep.
+      /// \return True if the worlds are stepped in lockstep.
+      public: bool LockstepWorlds() const;
+
+      /// \brief Step all worlds of the server in lockstep, from a single
+      /// thread. Each iteration waits until the step of every world is due,
+      /// then steps the worlds concurrently on the shared thread pool. This
+      /// makes Server::Run and Server::RunOnce advance all worlds together,
+      /// which suits running many small worlds in one process. By default,
+      /// each world runs on its own thread, at its own pace. This is
+      /// ignored by distributed simulation.
+      /// \param[in] _lockstep True to step the worlds in lockstep.
+      public: void SetLockstepWorlds(bool _lockstep);
+
+      /// \brief Get whether the entities of each world are indexed by name.
+      /// \return True if the name index is enabled.
+      public: bool NameIndex() const;
+
+      /// \brief Index the entities of each world by their Name and
+      /// ParentEntity components, so that lookups such as
+      /// Model::LinkByName and EntityComponentManager::EntityByComponents
+      /// with a Name component don't scan all entities. This speeds up
+      /// loading plugins in worlds with many models, at the cost of
+      /// some memory. See EntityComponentManager::SetNameIndex. The default
+      /// is false.
+      /// \param[in] _enable True to enable the index.
+      public: void SetNameIndex(bool _enable);
+
+      /// \brief Get the number of trace events kept per thread.
+      /// \return Number of events, 0 if tracing is disabled.
+      public: std::size_t TraceEventsPerThread() const;
+
+      /// \brief Record the latest scoped events of the simulation, such as
+      /// steps and the update phase of each system, into a ring buffer per
+      /// thread. The buffers can be dumped at any time in the Chrome trace
+      /// event format through the `/world/<world_name>/trace/dump` service,
+      /// which is only advertised when tracing is enabled. Unlike
+      /// IGN_PROFILE, this doesn't need the profiler to be compiled in, and
+      /// recording costs a few nanoseconds per event. The default is 0,
+      /// which disables tracing.
+      /// \param[in] _count Number of events kept per thread, such as
+      /// 100000.
+      public: void SetTraceEventsPerThread(std::size_t _count);
+
+      /// \brief Get the wall-clock duration above which a step is reported
+      /// as slow.
+      /// \return Threshold, 0 if slow steps aren't reported.
+      public: std::chrono::steady_clock::duration SlowStepThreshold() const;
+
+      /// \brief Report steps whose systems take longer than a threshold of
+      /// wall-clock time. Each slow step logs a warning, at most once per
+      /// second, and publishes the systems which took longest, the entity
+      /// count and the pending entity creations and removals on
+      /// `/world/<world_name>/diagnostics/slow_step`. The LogRecord system
+      /// records that topic with `<record_diagnostics>`. The default is 0,
+      /// which doesn't check steps.
+      /// \param[in] _threshold Threshold, such as 100ms.
+      public: void SetSlowStepThreshold(
+                  const std::chrono::steady_clock::duration &_threshold);
+
+      /// \brief Get the directory holding crash-recovery checkpoints.
+      /// \return Path to the directory. Empty if checkpoints are disabled.
+      /// \sa SetCheckpointPath(const std::string &_path)
+      public: const std::string &CheckpointPath() const;
+
+      /// \brief Periodically write the full state of each world to a
+      /// checkpoint file in a directory, named after the world with the
+      /// `.ckpt` extension. Only the entities which changed since the
+      /// previous checkpoint are serialized, and they're written to a
+      /// memory-mapped file on a background thread, so checkpoints are cheap
+      /// enough to take often. The file always holds the latest complete
+      /// checkpoint, even if the process dies while writing one. See
+      /// SetCheckpointResume to resume from it.
+      /// \param[in] _path Path to the directory. Empty disables
+      /// checkpoints, which is the default.
+      public: void SetCheckpointPath(const std::string &_path);
+
+      /// \brief Get the simulation time between checkpoints.
+      /// \return Period.
+      public: std::chrono::steady_clock::duration CheckpointPeriod() const;
+
+      /// \brief Set the simulation time between checkpoints. The default
+      /// is 10s.
+      /// \param[in] _period Period. 0 takes a checkpoint on every step.
+      public: void SetCheckpointPeriod(
+                  const std::chrono::steady_clock::duration &_period);
+
+      /// \brief Get whether worlds resume from their checkpoint.
+      /// \return True if worlds resume from their checkpoint.
+      public: bool CheckpointResume() const;
+
+      /// \brief Resume each world from the latest checkpoint in the
+      /// CheckpointPath directory, if there's one. The world is loaded from
+      /// SDF, plugins included, then its entities, components, simulation
+      /// time and iteration count are restored right before the first step,
+      /// as with Server::Restore. The default is false, which overwrites
+      /// existing checkpoints.
+      /// \param[in] _resume True to resume.
+      public: void SetCheckpointResume(bool _resume);
+
       /// \brief Get the update period duration.
       /// \return The desired update period, or nullopt if
       /// an UpdateRate has not been set.
@@ -319,6 +549,40 @@ namespace ignition
       /// ~/.ignition/fuel.
       public: void SetResourceCache(const std::string &_path);
 
+      /// \brief Get the maximum number of resources downloaded concurrently
+      /// before a world is loaded.
+      /// \return Maximum number of concurrent downloads.
+      /// \sa SetResourceFetchParallelism(unsigned int _parallelism)
+      public: unsigned int ResourceFetchParallelism() const;
+
+      /// \brief Set the maximum number of resources downloaded concurrently
+      /// before a world is loaded. All the model URIs included by the world
+      /// are fetched into the resource cache up front, so that loading the
+      /// world doesn't download them one at a time. The default is 8.
+      /// \param[in] _parallelism Maximum number of concurrent downloads. 0
+      /// disables the prefetch, so resources are only downloaded as the
+      /// world is loaded.
+      public: void SetResourceFetchParallelism(unsigned int _parallelism);
+
+      /// \brief Get the directory holding snapshots of loaded worlds.
+      /// \return Path to the directory. Empty if the cache isn't used.
+      /// \sa SetWorldCachePath(const std::string &_path)
+      public: const std::string &WorldCachePath() const;
+
+      /// \brief Set the directory holding snapshots of loaded worlds. After
+      /// a world is loaded, its entities and components are stored there,
+      /// together with a hash of the world's SDF with all its includes
+      /// expanded. When the same world is loaded again, its entities are
+      /// restored from the snapshot instead of being created from SDF. The
+      /// SDF is still parsed, since plugins are loaded from it. Worlds which
+      /// use levels or performers aren't cached as a whole. Instead, each
+      /// model is stored in its own level chunk the first time it's created,
+      /// and restored from it whenever its level is loaded again, in the same
+      /// or a later run.
+      /// \param[in] _path Path to the directory. Empty disables the cache,
+      /// which is the default.
+      public: void SetWorldCachePath(const std::string &_path);
+
       /// \brief Physics engine plugin library to load.
       /// \return File containing physics engine library.
       public: const std::string &PhysicsEngine() const;
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SPATIALINDEX_HH_
+#define IGNITION_GAZEBO_SPATIALINDEX_HH_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Vector3.hh>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/EntityComponentManager.hh>
+#include <ignition/gazebo/Export.hh>
+#include <ignition/gazebo/Types.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class IGNITION_GAZEBO_HIDDEN SpatialIndexPrivate;
+    //
+    /// \class SpatialIndex SpatialIndex.hh ignition/gazebo/SpatialIndex.hh
+    /// \brief Broadphase over the world axis aligned boxes of top level
+    /// models and performers, which systems can query by box, sphere or
+    /// frustum instead of testing every entity.
+    ///
+    /// Boxes are binned into a uniform grid. A model's box is its
+    /// components::AxisAlignedBox, if it has a valid one, grown to include
+    /// the model's origin. Otherwise it's just the origin. A performer's box
+    /// is its box geometry centered at its model's origin.
+    ///
+    /// The index is kept up to date incrementally from the new, removed and
+    /// changed poses and boxes of each step, so its cost is proportional to
+    /// what changed. Steps it isn't updated for are caught up with a full
+    /// rebuild.
+    ///
+    /// Systems normally share one index per world through Shared, called
+    /// from PostUpdate:
+    ///
+    ///     auto index = SpatialIndex::Shared(_info, _ecm);
+    ///     std::vector<Entity> performers;
+    ///     index->Query(SpatialIndex::Layer::PERFORMERS, region, performers);
+    class IGNITION_GAZEBO_VISIBLE SpatialIndex
+    {
+      /// \brief Kinds of entities in the index.
+      public: enum class Layer
+      {
+        /// \brief Top level models.
+        MODELS,
+
+        /// \brief Performers, with components::Performer.
+        PERFORMERS
+      };
+
+      /// \brief Constructor
+      /// \param[in] _cellSize Size of the grid cells in meters, which should
+      /// be about the size of typical queries.
+      public: explicit SpatialIndex(double _cellSize = 10.0);
+
+      /// \brief Destructor
+      public: ~SpatialIndex();
+
+      /// \brief Get the index shared by all systems of a world, brought up
+      /// to date with the current step the first time it's requested in the
+      /// step. Meant to be called from PostUpdate, once the step's changes
+      /// are done.
+      /// \param[in] _info Current update info.
+      /// \param[in] _ecm Entity-component manager of the world.
+      /// \return Index which is valid until the next step.
+      public: static std::shared_ptr<const SpatialIndex> Shared(
+          const UpdateInfo &_info, const EntityComponentManager &_ecm);
+
+      /// \brief Bring the index up to date with the current step. Calling
+      /// it again during the same step does nothing, unless paused.
+      /// \param[in] _info Current update info.
+      /// \param[in] _ecm Entity-component manager.
+      public: void Update(const UpdateInfo &_info,
+          const EntityComponentManager &_ecm);
+
+      /// \brief Index every model and performer again.
+      /// \param[in] _ecm Entity-component manager.
+      public: void Rebuild(const EntityComponentManager &_ecm);
+
+      /// \brief Get the number of indexed entities.
+      /// \param[in] _layer Kind of entities.
+      /// \return Number of entities.
+      public: std::size_t Count(Layer _layer) const;
+
+      /// \brief Get the indexed box of an entity.
+      /// \param[in] _layer Kind of the entity.
+      /// \param[in] _entity Entity.
+      /// \return World box, or nullopt if the entity isn't indexed.
+      public: std::optional<math::AxisAlignedBox> Box(Layer _layer,
+          const Entity _entity) const;
+
+      /// \brief Find the entities whose box intersects a box.
+      /// \param[in] _layer Kind of entities.
+      /// \param[in] _box World box.
+      /// \param[out] _entities Entities found, in no particular order.
+      public: void Query(Layer _layer, const math::AxisAlignedBox &_box,
+          std::vector<Entity> &_entities) const;
+
+      /// \brief Find the entities whose box intersects a sphere.
+      /// \param[in] _layer Kind of entities.
+      /// \param[in] _center World position of the center.
+      /// \param[in] _radius Radius.
+      /// \param[out] _entities Entities found, in no particular order.
+      public: void Query(Layer _layer, const math::Vector3d &_center,
+          double _radius, std::vector<Entity> &_entities) const;
+
+      /// \brief Find the entities whose box may intersect a frustum.
+      /// \param[in] _layer Kind of entities.
+      /// \param[in] _frustum Frustum, posed in the world.
+      /// \param[out] _entities Entities found, in no particular order.
+      public: void Query(Layer _layer, const math::Frustum &_frustum,
+          std::vector<Entity> &_entities) const;
+
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<SpatialIndexPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
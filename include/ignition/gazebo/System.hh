@@ -18,6 +18,7 @@
 #define IGNITION_GAZEBO_SYSTEM_HH_
 
 #include <memory>
+#include <set>
 
 #include <ignition/gazebo/config.hh>
 #include <ignition/gazebo/EntityComponentManager.hh>
@@ -100,6 +101,21 @@ namespace ignition
                   EventManager &_eventMgr) = 0;
     };
 
+    /// \class ISystemConfigureParallel ISystem.hh ignition/gazebo/System.hh
+    /// \brief Interface for a system whose Configure can run concurrently
+    /// with the Configure of other systems.
+    ///
+    /// Systems which opt in are configured together right before the next
+    /// simulation step, instead of as soon as they are loaded. Their
+    /// Configure may only read entities and components, and must not use the
+    /// EventManager, since other systems are configured at the same time.
+    class IGNITION_GAZEBO_VISIBLE ISystemConfigureParallel {
+      /// \brief Declare whether this instance can be configured concurrently.
+      /// \return True if Configure only reads the EntityComponentManager
+      /// and doesn't use the EventManager.
+      public: virtual bool ConfigureParallel() const = 0;
+    };
+
     /// \class ISystemPreUpdate ISystem.hh ignition/gazebo/System.hh
     /// \brief Interface for a system that uses the PreUpdate phase
     class IGNITION_GAZEBO_VISIBLE ISystemPreUpdate {
@@ -114,6 +130,47 @@ namespace ignition
                                   EntityComponentManager &_ecm) = 0;
     };
 
+    /// \brief Component types which a system accesses during a PreUpdate or
+    /// Update phase, see ISystemAccess.
+    struct SystemAccess
+    {
+      /// \brief Component types whose data the system reads.
+      std::set<ComponentTypeId> reads;
+
+      /// \brief Component types whose data the system writes, or marks as
+      /// changed.
+      std::set<ComponentTypeId> writes;
+    };
+
+    /// \class ISystemAccess ISystem.hh ignition/gazebo/System.hh
+    /// \brief Interface for a system that declares which components it
+    /// accesses during PreUpdate and Update, so that it can run concurrently
+    /// with other systems of the same phase.
+    ///
+    /// Access is called before each PreUpdate and Update phase. Systems whose
+    /// declarations don't conflict, that is, none of them writes a component
+    /// type that another one reads or writes, may run at the same time. They
+    /// still run after all earlier systems they conflict with, in the order
+    /// the systems were loaded. Systems which don't implement this interface
+    /// run alone.
+    ///
+    /// While running concurrently, a system must only access the declared
+    /// component types, and it must not create or remove entities or
+    /// components. A system which needs to do that during a phase, for
+    /// example to create its command components on the first step, should
+    /// return false for that phase.
+    class IGNITION_GAZEBO_VISIBLE ISystemAccess {
+      /// \brief Declare the components accessed during the next phase.
+      /// \param[in] _ecm The EntityComponentManager of the given simulation
+      /// instance.
+      /// \param[out] _access Component types the system reads and writes.
+      /// It's empty when the function is called.
+      /// \return True if the system can run concurrently with other systems,
+      /// false if it must run alone.
+      public: virtual bool Access(const EntityComponentManager &_ecm,
+                                  SystemAccess &_access) = 0;
+    };
+
     /// \class ISystemPostUpdate ISystem.hh ignition/gazebo/System.hh
     /// \brief Interface for a system that uses the PostUpdate phase
     class IGNITION_GAZEBO_VISIBLE ISystemPostUpdate{
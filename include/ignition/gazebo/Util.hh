@@ -17,9 +17,11 @@
 #ifndef IGNITION_GAZEBO_UTIL_HH_
 #define IGNITION_GAZEBO_UTIL_HH_
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include <ignition/common/Mesh.hh>
 #include <ignition/math/Pose3.hh>
 #include "ignition/gazebo/config.hh"
 #include "ignition/gazebo/Entity.hh"
@@ -155,6 +157,17 @@ namespace ignition
     std::string IGNITION_GAZEBO_VISIBLE validTopic(
         const std::vector<std::string> &_topics);
 
+    /// \brief Parse a mesh file with the loader of its format, as
+    /// common::MeshManager::Load does, but without registering the mesh.
+    /// The MeshManager isn't thread-safe, so this is the way to load meshes
+    /// off the thread which uses the MeshManager. The mesh can be registered
+    /// later on that thread with common::MeshManager::AddMesh.
+    /// \param[in] _fullPath Full path to the mesh file.
+    /// \return The mesh, named after its path, or nullptr if it couldn't be
+    /// parsed.
+    std::unique_ptr<common::Mesh> IGNITION_GAZEBO_VISIBLE parseMeshFile(
+        const std::string &_fullPath);
+
     /// \brief Environment variable holding resource paths.
     const std::string kResourcePathEnv{"IGN_GAZEBO_RESOURCE_PATH"};
 
@@ -56,6 +56,11 @@ namespace ignition
     ///
     ///    World world(entity);
     ///    std::string name = world.Name(ecm);
+    ///
+    /// The entities found by ModelByName, LightByName and ActorByName are
+    /// kept in the object until a component is created or removed, or a
+    /// name changes, in the entity component manager. Because of this, a
+    /// World shouldn't be used from several threads at once.
     class IGNITION_GAZEBO_VISIBLE World {
       /// \brief Constructor
       /// \param[in] _entity World entity
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_COMPONENTS_ATREST_HH_
+#define IGNITION_GAZEBO_COMPONENTS_ATREST_HH_
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+#include "ignition/gazebo/components/Factory.hh"
+#include "ignition/gazebo/components/Component.hh"
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace components
+{
+  /// \brief This component marks a top level model whose links haven't
+  /// moved for a while. It's added and removed by the physics system as the
+  /// model comes to rest and starts moving again, so systems can skip
+  /// resting models with `Without<components::AtRest>`.
+  using AtRest = Component<NoData, class AtRestTag>;
+  IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.AtRest", AtRest)
+}
+}
+}
+}
+#endif
@@ -42,7 +42,9 @@ namespace components
 {
   /// \brief A component type that contains axis aligned box,
   /// ignition::math::AxisAlignedBox, information.
-  /// The axis aligned box is created from collisions in the entity
+  /// The axis aligned box is created from collisions in the entity.
+  /// The physics system only updates a model's box after the model moves.
+  /// Set the component to a default constructed box to request an update.
   using AxisAlignedBox = Component<ignition::math::AxisAlignedBox,
       class AxisAlignedBoxTag, serializers::AxisAlignedBoxSerializer>;
   IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.AxisAlignedBox",
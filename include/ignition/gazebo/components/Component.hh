@@ -17,13 +17,18 @@
 #ifndef IGNITION_GAZEBO_COMPONENTS_COMPONENT_HH_
 #define IGNITION_GAZEBO_COMPONENTS_COMPONENT_HH_
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <sstream>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <ignition/common/Console.hh>
+#include <ignition/math/Pose3.hh>
 
 #include <ignition/gazebo/config.hh>
 #include <ignition/gazebo/Export.hh>
@@ -198,6 +203,262 @@ namespace serializers
   };
 }
 
+namespace serializers
+{
+  /// \brief Serializer which writes the data's bytes straight into a string
+  /// buffer, without going through streams. This is meant for POD-like data
+  /// which is serialized often, such as poses and velocities. The output
+  /// uses the host's byte order, so it should only be read back on the same
+  /// architecture.
+  ///
+  /// The primary template doesn't support any type. Supported types have a
+  /// specialization with `kSupported` set to true and the functions:
+  ///
+  ///     static void Serialize(std::string &_out, const DataType &_data);
+  ///     static bool Deserialize(const char *&_in, const char *_end,
+  ///         DataType &_data);
+  ///
+  /// \tparam DataType Type to serialize.
+  template <typename DataType, typename Enable = void>
+  class BinarySerializer
+  {
+    /// \brief Whether DataType can be serialized in binary form.
+    public: static constexpr bool kSupported{false};
+  };
+
+  /// \brief Binary serializer for arithmetic and enum types.
+  template <typename DataType>
+  class BinarySerializer<DataType, typename std::enable_if<
+      std::is_arithmetic<DataType>::value ||
+      std::is_enum<DataType>::value>::type>
+  {
+    /// \brief Whether DataType can be serialized in binary form.
+    public: static constexpr bool kSupported{true};
+
+    /// \brief Serialization
+    /// \param[in, out] _out Buffer to append the data to.
+    /// \param[in] _data Data to serialize.
+    public: static void Serialize(std::string &_out, const DataType &_data)
+    {
+      _out.append(reinterpret_cast<const char *>(&_data), sizeof(DataType));
+    }
+
+    /// \brief Deserialization
+    /// \param[in, out] _in Start of the data, moved past the bytes read.
+    /// \param[in] _end End of the buffer.
+    /// \param[out] _data Deserialized data.
+    /// \return False if the buffer is too short.
+    public: static bool Deserialize(const char *&_in, const char *_end,
+                                    DataType &_data)
+    {
+      if (_end - _in < static_cast<std::ptrdiff_t>(sizeof(DataType)))
+        return false;
+      std::memcpy(&_data, _in, sizeof(DataType));
+      _in += sizeof(DataType);
+      return true;
+    }
+  };
+
+  /// \brief Binary serializer for ignition::math::Vector3.
+  template <typename T>
+  class BinarySerializer<math::Vector3<T>>
+  {
+    /// \brief Whether DataType can be serialized in binary form.
+    public: static constexpr bool kSupported{true};
+
+    /// \brief Serialization
+    /// \param[in, out] _out Buffer to append the data to.
+    /// \param[in] _vec Vector to serialize.
+    public: static void Serialize(std::string &_out,
+                                  const math::Vector3<T> &_vec)
+    {
+      BinarySerializer<T>::Serialize(_out, _vec.X());
+      BinarySerializer<T>::Serialize(_out, _vec.Y());
+      BinarySerializer<T>::Serialize(_out, _vec.Z());
+    }
+
+    /// \brief Deserialization
+    /// \param[in, out] _in Start of the data, moved past the bytes read.
+    /// \param[in] _end End of the buffer.
+    /// \param[out] _vec Deserialized vector.
+    /// \return False if the buffer is too short.
+    public: static bool Deserialize(const char *&_in, const char *_end,
+                                    math::Vector3<T> &_vec)
+    {
+      T x, y, z;
+      if (!BinarySerializer<T>::Deserialize(_in, _end, x) ||
+          !BinarySerializer<T>::Deserialize(_in, _end, y) ||
+          !BinarySerializer<T>::Deserialize(_in, _end, z))
+      {
+        return false;
+      }
+      _vec.Set(x, y, z);
+      return true;
+    }
+  };
+
+  /// \brief Binary serializer for ignition::math::Quaternion.
+  template <typename T>
+  class BinarySerializer<math::Quaternion<T>>
+  {
+    /// \brief Whether DataType can be serialized in binary form.
+    public: static constexpr bool kSupported{true};
+
+    /// \brief Serialization
+    /// \param[in, out] _out Buffer to append the data to.
+    /// \param[in] _quat Quaternion to serialize.
+    public: static void Serialize(std::string &_out,
+                                  const math::Quaternion<T> &_quat)
+    {
+      BinarySerializer<T>::Serialize(_out, _quat.W());
+      BinarySerializer<T>::Serialize(_out, _quat.X());
+      BinarySerializer<T>::Serialize(_out, _quat.Y());
+      BinarySerializer<T>::Serialize(_out, _quat.Z());
+    }
+
+    /// \brief Deserialization
+    /// \param[in, out] _in Start of the data, moved past the bytes read.
+    /// \param[in] _end End of the buffer.
+    /// \param[out] _quat Deserialized quaternion.
+    /// \return False if the buffer is too short.
+    public: static bool Deserialize(const char *&_in, const char *_end,
+                                    math::Quaternion<T> &_quat)
+    {
+      T w, x, y, z;
+      if (!BinarySerializer<T>::Deserialize(_in, _end, w) ||
+          !BinarySerializer<T>::Deserialize(_in, _end, x) ||
+          !BinarySerializer<T>::Deserialize(_in, _end, y) ||
+          !BinarySerializer<T>::Deserialize(_in, _end, z))
+      {
+        return false;
+      }
+      _quat.Set(w, x, y, z);
+      return true;
+    }
+  };
+
+  /// \brief Binary serializer for ignition::math::Pose3.
+  template <typename T>
+  class BinarySerializer<math::Pose3<T>>
+  {
+    /// \brief Whether DataType can be serialized in binary form.
+    public: static constexpr bool kSupported{true};
+
+    /// \brief Serialization
+    /// \param[in, out] _out Buffer to append the data to.
+    /// \param[in] _pose Pose to serialize.
+    public: static void Serialize(std::string &_out,
+                                  const math::Pose3<T> &_pose)
+    {
+      BinarySerializer<math::Vector3<T>>::Serialize(_out, _pose.Pos());
+      BinarySerializer<math::Quaternion<T>>::Serialize(_out, _pose.Rot());
+    }
+
+    /// \brief Deserialization
+    /// \param[in, out] _in Start of the data, moved past the bytes read.
+    /// \param[in] _end End of the buffer.
+    /// \param[out] _pose Deserialized pose.
+    /// \return False if the buffer is too short.
+    public: static bool Deserialize(const char *&_in, const char *_end,
+                                    math::Pose3<T> &_pose)
+    {
+      math::Vector3<T> pos;
+      math::Quaternion<T> rot;
+      if (!BinarySerializer<math::Vector3<T>>::Deserialize(_in, _end, pos) ||
+          !BinarySerializer<math::Quaternion<T>>::Deserialize(_in, _end, rot))
+      {
+        return false;
+      }
+      _pose.Set(pos, rot);
+      return true;
+    }
+  };
+
+  /// \brief Binary serializer for vectors of arithmetic types, such as the
+  /// `std::vector<double>` held by joint components. The size is written
+  /// first, followed by the elements. `std::vector<bool>` is packed and has
+  /// no `data()`, so it has its own specialization below.
+  template <typename T>
+  class BinarySerializer<std::vector<T>,
+      typename std::enable_if<std::is_arithmetic<T>::value &&
+      !std::is_same<T, bool>::value>::type>
+  {
+    /// \brief Whether DataType can be serialized in binary form.
+    public: static constexpr bool kSupported{true};
+
+    /// \brief Serialization
+    /// \param[in, out] _out Buffer to append the data to.
+    /// \param[in] _vec Vector to serialize.
+    public: static void Serialize(std::string &_out,
+                                  const std::vector<T> &_vec)
+    {
+      BinarySerializer<uint64_t>::Serialize(_out, _vec.size());
+      _out.append(reinterpret_cast<const char *>(_vec.data()),
+          _vec.size() * sizeof(T));
+    }
+
+    /// \brief Deserialization
+    /// \param[in, out] _in Start of the data, moved past the bytes read.
+    /// \param[in] _end End of the buffer.
+    /// \param[out] _vec Deserialized vector.
+    /// \return False if the buffer is too short.
+    public: static bool Deserialize(const char *&_in, const char *_end,
+                                    std::vector<T> &_vec)
+    {
+      uint64_t size;
+      if (!BinarySerializer<uint64_t>::Deserialize(_in, _end, size) ||
+          static_cast<uint64_t>(_end - _in) / sizeof(T) < size)
+      {
+        return false;
+      }
+      _vec.resize(size);
+      std::memcpy(_vec.data(), _in, size * sizeof(T));
+      _in += size * sizeof(T);
+      return true;
+    }
+  };
+
+  /// \brief Binary serializer for `std::vector<bool>`. The size is written
+  /// first, followed by one byte per element.
+  template <>
+  class BinarySerializer<std::vector<bool>>
+  {
+    /// \brief Whether DataType can be serialized in binary form.
+    public: static constexpr bool kSupported{true};
+
+    /// \brief Serialization
+    /// \param[in, out] _out Buffer to append the data to.
+    /// \param[in] _vec Vector to serialize.
+    public: static void Serialize(std::string &_out,
+                                  const std::vector<bool> &_vec)
+    {
+      BinarySerializer<uint64_t>::Serialize(_out, _vec.size());
+      for (const bool value : _vec)
+        _out.push_back(value ? 1 : 0);
+    }
+
+    /// \brief Deserialization
+    /// \param[in, out] _in Start of the data, moved past the bytes read.
+    /// \param[in] _end End of the buffer.
+    /// \param[out] _vec Deserialized vector.
+    /// \return False if the buffer is too short.
+    public: static bool Deserialize(const char *&_in, const char *_end,
+                                    std::vector<bool> &_vec)
+    {
+      uint64_t size;
+      if (!BinarySerializer<uint64_t>::Deserialize(_in, _end, size) ||
+          static_cast<uint64_t>(_end - _in) < size)
+      {
+        return false;
+      }
+      _vec.resize(size);
+      for (uint64_t i = 0; i < size; ++i)
+        _vec[i] = (*_in++ != 0);
+      return true;
+    }
+  };
+}
+
 namespace components
 {
   /// \brief Convenient type to be used by components that don't wrap any data.
@@ -270,6 +531,30 @@ namespace components
       }
     };
 
+    /// \brief Appends a binary version of the component to a buffer, such
+    /// as a protobuf string field, without going through streams. The format
+    /// is not compatible with Serialize(), so readers must know which one was
+    /// used. By default, binary serialization isn't supported, in which case
+    /// callers should fall back to Serialize().
+    ///
+    /// \param[in, out] _out Buffer to append to. It's left unchanged if
+    /// binary serialization isn't supported.
+    /// \return True if the component was serialized.
+    public: virtual bool SerializeBinary(std::string &/*_out*/) const
+    {
+      return false;
+    }
+
+    /// \brief Fills a component from the output of SerializeBinary().
+    ///
+    /// \param[in] _in Binary data.
+    /// \return True if the component supports binary serialization and the
+    /// data was valid. The component is left unchanged otherwise.
+    public: virtual bool DeserializeBinary(const std::string &/*_in*/)
+    {
+      return false;
+    }
+
     /// \brief Returns the unique ID for the component's type.
     /// The ID is derived from the name that is manually chosen during the
     /// Factory registration and is guaranteed to be the same across compilers
@@ -347,6 +632,12 @@ namespace components
     // Documentation inherited
     public: void Deserialize(std::istream &_in) override;
 
+    // Documentation inherited
+    public: bool SerializeBinary(std::string &_out) const override;
+
+    // Documentation inherited
+    public: bool DeserializeBinary(const std::string &_in) override;
+
     /// \brief Get the mutable component data. This function will be
     /// deprecated in Gazebo 3, replaced by const DataType &Data() const.
     /// Use void SetData(const DataType &) to modify data.
@@ -375,6 +666,11 @@ namespace components
     /// Factory registration.
     public: inline static ComponentTypeId typeId{0};
 
+    /// \brief Dense index of this component type, used to index arrays and
+    /// bitmasks of component types instead of hashing the ID. This is set
+    /// through the Factory registration, and is 0 while unregistered.
+    public: inline static std::size_t typeIndex{0};
+
     /// \brief Unique name for this component type. This is set through the
     /// Factory registration.
     public: inline static std::string typeName;
@@ -414,10 +710,21 @@ namespace components
     // Documentation inherited
     public: void Deserialize(std::istream &_in) override;
 
+    // Documentation inherited
+    public: bool SerializeBinary(std::string &_out) const override;
+
+    // Documentation inherited
+    public: bool DeserializeBinary(const std::string &_in) override;
+
     /// \brief Unique ID for this component type. This is set through the
     /// Factory registration.
     public: inline static ComponentTypeId typeId{0};
 
+    /// \brief Dense index of this component type, used to index arrays and
+    /// bitmasks of component types instead of hashing the ID. This is set
+    /// through the Factory registration, and is 0 while unregistered.
+    public: inline static std::size_t typeIndex{0};
+
     /// \brief Unique name for this component type. This is set through the
     /// Factory registration.
     public: inline static std::string typeName;
@@ -487,6 +794,46 @@ namespace components
     Serializer::Deserialize(_in, this->Data());
   }
 
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  bool Component<DataType, Identifier, Serializer>::SerializeBinary(
+      std::string &_out) const
+  {
+    if constexpr (serializers::BinarySerializer<DataType>::kSupported)
+    {
+      serializers::BinarySerializer<DataType>::Serialize(_out, this->Data());
+      return true;
+    }
+    else
+    {
+      return BaseComponent::SerializeBinary(_out);
+    }
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  bool Component<DataType, Identifier, Serializer>::DeserializeBinary(
+      const std::string &_in)
+  {
+    if constexpr (serializers::BinarySerializer<DataType>::kSupported)
+    {
+      const char *begin = _in.data();
+      const char *end = begin + _in.size();
+      DataType newData;
+      if (!serializers::BinarySerializer<DataType>::Deserialize(
+            begin, end, newData) || begin != end)
+      {
+        return false;
+      }
+      this->data = std::move(newData);
+      return true;
+    }
+    else
+    {
+      return BaseComponent::DeserializeBinary(_in);
+    }
+  }
+
   //////////////////////////////////////////////////
   template <typename DataType, typename Identifier, typename Serializer>
   ComponentTypeId Component<DataType, Identifier, Serializer>::TypeId() const
@@ -532,6 +879,23 @@ namespace components
   {
     Serializer::Deserialize(_in);
   }
+
+  //////////////////////////////////////////////////
+  template <typename Identifier, typename Serializer>
+  bool Component<NoData, Identifier, Serializer>::SerializeBinary(
+      std::string &) const
+  {
+    // There's no data to write
+    return true;
+  }
+
+  //////////////////////////////////////////////////
+  template <typename Identifier, typename Serializer>
+  bool Component<NoData, Identifier, Serializer>::DeserializeBinary(
+      const std::string &_in)
+  {
+    return _in.empty();
+  }
 }
 }
 }
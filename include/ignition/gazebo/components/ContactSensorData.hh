@@ -32,7 +32,9 @@ namespace gazebo
 inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
 namespace components
 {
-  /// \brief A component type that contains a list of contacts.
+  /// \brief A component type that contains a list of contacts. It's
+  /// refilled by the physics system every step, but only flagged as a
+  /// one-time change when the set of collisions in contact changes.
   using ContactSensorData =
       Component<msgs::Contacts,
       class ContactSensorDataTag, serializers::MsgSerializer>;
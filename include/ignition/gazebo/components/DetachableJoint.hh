@@ -41,12 +41,17 @@ namespace components
     Entity childLink;
     // \brief Type of joint. Only the "fixed" joint type is currently supported.
     std::string jointType = {"fixed"};
+    /// \brief Whether the links are attached. A disabled joint keeps its
+    /// entity, so it can be enabled again by changing this value and marking
+    /// the component as changed, instead of creating a new entity.
+    bool enabled{true};
 
     public: bool operator==(const DetachableJointInfo &_info) const
     {
       return (this->parentLink == _info.parentLink) &&
              (this->childLink == _info.childLink) &&
-             (this->jointType == _info.jointType);
+             (this->jointType == _info.jointType) &&
+             (this->enabled == _info.enabled);
     }
 
     public: bool operator!=(const DetachableJointInfo &_info) const
@@ -70,7 +75,7 @@ namespace serializers
                 const components::DetachableJointInfo &_info)
     {
       _out << _info.parentLink << " " << _info.childLink << " "
-           << _info.jointType;
+           << _info.jointType << " " << _info.enabled;
       return _out;
     }
 
@@ -82,6 +87,15 @@ namespace serializers
                 std::istream &_in, components::DetachableJointInfo &_info)
     {
       _in >> _info.parentLink >> _info.childLink >> _info.jointType;
+
+      // Streams from older versions don't have the enabled flag
+      int enabled{1};
+      if (!(_in >> enabled))
+      {
+        _in.clear();
+        enabled = 1;
+      }
+      _info.enabled = enabled != 0;
       return _in;
     }
   };
@@ -22,6 +22,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <ignition/common/SingletonT.hh>
@@ -122,6 +123,15 @@ namespace components
       ComponentTypeT::typeId = typeHash;
       ComponentTypeT::typeName = _type;
 
+      // Libraries which register the same type share its index
+      auto indexIt = this->indicesById.find(typeHash);
+      if (indexIt == this->indicesById.end())
+      {
+        indexIt = this->indicesById.emplace(typeHash,
+            this->indicesById.size() + 1).first;
+      }
+      ComponentTypeT::typeIndex = indexIt->second;
+
       // Check if component has already been registered by another library
       auto runtimeName = typeid(ComponentTypeT).name();
       auto runtimeNameIt = this->runtimeNamesById.find(typeHash);
@@ -167,6 +177,7 @@ namespace components
       this->Unregister(ComponentTypeT::typeId);
 
       ComponentTypeT::typeId = 0;
+      ComponentTypeT::typeIndex = 0;
     }
 
     /// \brief Unregister a component so that the factory can't create instances
@@ -280,6 +291,25 @@ namespace components
       return this->compsById.find(_typeId) != this->compsById.end();
     }
 
+    /// \brief Get the dense index of a component type, see
+    /// Component::typeIndex. Indices are kept when types are unregistered,
+    /// so a type registered again gets the same index.
+    /// \param[in] _typeId Type ID of the component.
+    /// \return Index from 1 to TypeIndexCount() - 1, or 0 if the type was
+    /// never registered.
+    public: std::size_t TypeIndex(ComponentTypeId _typeId) const
+    {
+      auto it = this->indicesById.find(_typeId);
+      return it == this->indicesById.end() ? 0 : it->second;
+    }
+
+    /// \brief Get the size of arrays indexed by component type index.
+    /// \return One more than the largest assigned index.
+    public: std::size_t TypeIndexCount() const
+    {
+      return this->indicesById.size() + 1;
+    }
+
     /// \brief Get a component's type name given its type ID.
     /// return Unique component name.
     public: std::string Name(ComponentTypeId _typeId) const
@@ -309,6 +339,9 @@ namespace components
     /// type id.
     private: std::map<ComponentTypeId, StorageDescriptorBase *> storagesById;
 
+    /// \brief Dense indices of all types ever registered, by type ID.
+    private: std::unordered_map<ComponentTypeId, std::size_t> indicesById;
+
     /// \brief A list of IDs and their equivalent names.
     /// \detail Make it non-static on version 2.0.
     public: inline static std::map<ComponentTypeId, std::string> namesById;
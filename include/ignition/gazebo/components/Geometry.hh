@@ -17,6 +17,9 @@
 #ifndef IGNITION_GAZEBO_COMPONENTS_GEOMETRY_HH_
 #define IGNITION_GAZEBO_COMPONENTS_GEOMETRY_HH_
 
+#include <sstream>
+#include <string>
+
 #include <ignition/msgs/geometry.pb.h>
 
 #include <sdf/Geometry.hh>
@@ -24,6 +27,7 @@
 #include <ignition/gazebo/components/Factory.hh>
 #include <ignition/gazebo/components/Component.hh>
 #include <ignition/gazebo/components/Serialization.hh>
+#include <ignition/gazebo/components/SharedComponent.hh>
 #include <ignition/gazebo/config.hh>
 #include <ignition/gazebo/Conversions.hh>
 
@@ -41,9 +45,33 @@ namespace serializers
 
 namespace components
 {
-  /// \brief This component holds an entity's geometry.
-  using Geometry = Component<sdf::Geometry, class GeometryTag,
-                             serializers::GeometrySerializer>;
+  /// \brief Geometries are interned by their serialized form and their SDF
+  /// element, which holds data that isn't serialized, such as the path mesh
+  /// URIs are relative to. Geometries which weren't loaded from SDF aren't
+  /// shared.
+  template <typename Serializer>
+  class SharedDataKey<sdf::Geometry, Serializer>
+  {
+    /// \brief Get the key of a geometry.
+    /// \param[in] _data Geometry.
+    /// \return Key, or an empty string if the geometry has no element.
+    public: static std::string Key(const sdf::Geometry &_data)
+    {
+      if (nullptr == _data.Element())
+        return std::string();
+
+      std::ostringstream ostr;
+      Serializer::Serialize(ostr, _data);
+      const std::string msg = ostr.str();
+      return std::to_string(msg.size()) + "\n" + msg +
+          _data.Element()->FilePath() + "\n" + _data.Element()->ToString("");
+    }
+  };
+
+  /// \brief This component holds an entity's geometry. Identical geometries,
+  /// such as those of copies of the same model, share their data.
+  using Geometry = SharedComponent<sdf::Geometry, class GeometryTag,
+                                   serializers::GeometrySerializer>;
 
   IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.Geometry", Geometry)
 
@@ -22,6 +22,7 @@
 #include <ignition/gazebo/components/Factory.hh>
 #include <ignition/gazebo/components/Component.hh>
 #include <ignition/gazebo/components/Serialization.hh>
+#include <ignition/gazebo/components/SharedComponent.hh>
 #include <ignition/gazebo/config.hh>
 #include <ignition/gazebo/Conversions.hh>
 
@@ -39,9 +40,10 @@ namespace serializers
 
 namespace components
 {
-  /// \brief This component holds an entity's inertial.
-  using Inertial = Component<math::Inertiald, class InertialTag,
-                             serializers::InertialSerializer>;
+  /// \brief This component holds an entity's inertial. Identical inertials,
+  /// such as those of copies of the same model, share their data.
+  using Inertial = SharedComponent<math::Inertiald, class InertialTag,
+                                   serializers::InertialSerializer>;
   IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.Inertial", Inertial)
 }
 }
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_COMPONENTS_JOINTSTATES_HH_
+#define IGNITION_GAZEBO_COMPONENTS_JOINTSTATES_HH_
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <ignition/gazebo/Entity.hh>
+#include <ignition/gazebo/components/Factory.hh>
+#include <ignition/gazebo/components/Component.hh>
+#include <ignition/gazebo/config.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace components
+{
+  /// \brief Positions and velocities of several joints of a model, stored
+  /// contiguously. The axes of joint `joints[j]` are at indices
+  /// `[offsets[j], offsets[j + 1])` of `positions` and `velocities`.
+  struct JointStatesData
+  {
+    /// \brief Joint entities, in the order their axes are stored. Systems
+    /// append the joints they need. If left empty, the physics system fills
+    /// it with all joints of the model.
+    std::vector<Entity> joints;
+
+    /// \brief Index of the first axis of each joint, followed by the total
+    /// number of axes. Filled by the physics system.
+    std::vector<std::size_t> offsets;
+
+    /// \brief Joint positions in SI units, filled by the physics system.
+    std::vector<double> positions;
+
+    /// \brief Joint velocities in SI units, filled by the physics system.
+    std::vector<double> velocities;
+
+    public: bool operator==(const JointStatesData &_states) const
+    {
+      return (this->joints == _states.joints) &&
+             (this->offsets == _states.offsets) &&
+             (this->positions == _states.positions) &&
+             (this->velocities == _states.velocities);
+    }
+
+    public: bool operator!=(const JointStatesData &_states) const
+    {
+      return !(*this == _states);
+    }
+  };
+}
+
+namespace serializers
+{
+  /// \brief Serializer for JointStatesData object
+  class JointStatesSerializer
+  {
+    /// \brief Serialization for `JointStatesData`.
+    /// \param[in] _out Output stream.
+    /// \param[in] _states JointStatesData object to stream
+    /// \return The stream.
+    public: static std::ostream &Serialize(
+                std::ostream &_out,
+                const components::JointStatesData &_states)
+    {
+      _out << _states.joints.size() << " " << _states.offsets.size() << " "
+           << _states.positions.size();
+      for (const auto &joint : _states.joints)
+        _out << " " << joint;
+      for (const auto &offset : _states.offsets)
+        _out << " " << offset;
+      for (const auto &position : _states.positions)
+        _out << " " << position;
+      for (const auto &velocity : _states.velocities)
+        _out << " " << velocity;
+      return _out;
+    }
+
+    /// \brief Deserialization for `JointStatesData`.
+    /// \param[in] _in Input stream.
+    /// \param[in] _states JointStatesData object to populate
+    /// \return The stream.
+    public: static std::istream &Deserialize(
+                std::istream &_in, components::JointStatesData &_states)
+    {
+      std::size_t jointCount{0};
+      std::size_t offsetCount{0};
+      std::size_t axisCount{0};
+      _in >> jointCount >> offsetCount >> axisCount;
+
+      _states.joints.resize(jointCount);
+      for (auto &joint : _states.joints)
+        _in >> joint;
+
+      _states.offsets.resize(offsetCount);
+      for (auto &offset : _states.offsets)
+        _in >> offset;
+
+      _states.positions.resize(axisCount);
+      for (auto &position : _states.positions)
+        _in >> position;
+
+      _states.velocities.resize(axisCount);
+      for (auto &velocity : _states.velocities)
+        _in >> velocity;
+      return _in;
+    }
+  };
+}
+
+namespace components
+{
+  /// \brief A component that holds the joint states of a model in a single
+  /// buffer. Systems add it to a model to have the physics system fill in
+  /// all of the model's joints at once, instead of looking up a
+  /// JointPosition and JointVelocity component per joint. The buffers are
+  /// resized in place, so they aren't reallocated every step.
+  using JointStates = Component<JointStatesData, class JointStatesTag,
+                                serializers::JointStatesSerializer>;
+  IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.JointStates",
+                                JointStates)
+}
+}
+}
+}
+
+#endif
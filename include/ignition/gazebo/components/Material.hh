@@ -17,6 +17,9 @@
 #ifndef IGNITION_GAZEBO_COMPONENTS_MATERIAL_HH_
 #define IGNITION_GAZEBO_COMPONENTS_MATERIAL_HH_
 
+#include <sstream>
+#include <string>
+
 #include <ignition/msgs/material.pb.h>
 
 #include <sdf/Material.hh>
@@ -24,6 +27,7 @@
 #include <ignition/gazebo/components/Factory.hh>
 #include <ignition/gazebo/components/Component.hh>
 #include <ignition/gazebo/components/Serialization.hh>
+#include <ignition/gazebo/components/SharedComponent.hh>
 #include <ignition/gazebo/config.hh>
 
 namespace ignition
@@ -39,9 +43,33 @@ namespace serializers
 }
 namespace components
 {
-  /// \brief This component holds an entity's material.
-  using Material = Component<sdf::Material, class MaterialTag,
-                             serializers::MaterialSerializer>;
+  /// \brief Materials are interned by their serialized form and their SDF
+  /// element, which holds data that isn't serialized, such as the path
+  /// texture URIs are relative to. Materials which weren't loaded from SDF
+  /// aren't shared.
+  template <typename Serializer>
+  class SharedDataKey<sdf::Material, Serializer>
+  {
+    /// \brief Get the key of a material.
+    /// \param[in] _data Material.
+    /// \return Key, or an empty string if the material has no element.
+    public: static std::string Key(const sdf::Material &_data)
+    {
+      if (nullptr == _data.Element())
+        return std::string();
+
+      std::ostringstream ostr;
+      Serializer::Serialize(ostr, _data);
+      const std::string msg = ostr.str();
+      return std::to_string(msg.size()) + "\n" + msg + _data.FilePath() +
+          "\n" + _data.Element()->ToString("");
+    }
+  };
+
+  /// \brief This component holds an entity's material. Identical materials,
+  /// such as those of copies of the same model, share their data.
+  using Material = SharedComponent<sdf::Material, class MaterialTag,
+                                   serializers::MaterialSerializer>;
   IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.Material", Material)
 }
 }
@@ -35,7 +35,9 @@ namespace components
   using Model = Component<NoData, class ModelTag>;
   IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.Model", Model)
 
-  /// \brief A component that holds the model's SDF DOM
+  /// \brief A component that holds the model's SDF DOM. Only top level
+  /// models have it, the DOM of nested models is part of their top level
+  /// model's.
   using ModelSdf = Component<sdf::Model, class ModelTag>;
   IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.ModelSdf", ModelSdf)
 }
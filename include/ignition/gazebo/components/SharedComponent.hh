@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_COMPONENTS_SHAREDCOMPONENT_HH_
+#define IGNITION_GAZEBO_COMPONENTS_SHAREDCOMPONENT_HH_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <ignition/gazebo/components/Component.hh>
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+#include <ignition/gazebo/Types.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace components
+{
+  /// \brief Computes the key used to intern the data of a SharedComponent.
+  /// Two values with the same key are considered equal and share a single
+  /// copy, so the key must capture everything that tells values apart. By
+  /// default, the key is the output of the component's serializer.
+  /// Specializations may return an empty key for values which shouldn't be
+  /// shared.
+  /// \tparam DataType Type of the data being interned.
+  /// \tparam Serializer Serializer of the component.
+  template <typename DataType, typename Serializer>
+  class SharedDataKey
+  {
+    /// \brief Get the key of a value.
+    /// \param[in] _data Value.
+    /// \return Key, or an empty string if the value shouldn't be shared.
+    public: static std::string Key(const DataType &_data)
+    {
+      std::ostringstream ostr;
+      Serializer::Serialize(ostr, _data);
+      return ostr.str();
+    }
+  };
+
+  /// \brief A component which wraps immutable data shared by all components
+  /// holding an equal value, instead of storing a copy per entity. Values
+  /// are interned by their SharedDataKey when the component is constructed,
+  /// deserialized or set, and copies of a component share its data.
+  ///
+  /// The interface is the same as Component's. Reading through the const
+  /// Data() never copies. The mutable Data() detaches the component with a
+  /// copy of the data if it's shared, so it should be avoided on large
+  /// worlds, use SetData() instead.
+  ///
+  /// This is meant for large components which are often identical across
+  /// entities, such as the geometry of every copy of a model:
+  /// \code
+  ///     using Geometry = SharedComponent<sdf::Geometry, class GeometryTag,
+  ///                                      serializers::GeometrySerializer>;
+  /// \endcode
+  ///
+  /// \tparam DataType Type of the data being wrapped by this component.
+  /// \tparam Identifier Unique identifier for the component class, to avoid
+  /// collision.
+  /// \tparam Serializer A class that can serialize `DataType`.
+  template <typename DataType, typename Identifier,
+            typename Serializer = serializers::DefaultSerializer<DataType>>
+  class SharedComponent : public BaseComponent
+  {
+    /// \brief Alias for DataType
+    public: using Type = DataType;
+
+    /// \brief Default constructor
+    public: SharedComponent() = default;
+
+    /// \brief Constructor
+    /// \param[in] _data Data to intern
+    public: explicit SharedComponent(DataType _data);
+
+    /// \brief Destructor.
+    public: ~SharedComponent() override = default;
+
+    /// \brief Equality operator.
+    /// \param[in] _component Component to compare to.
+    /// \return True if equal.
+    public: bool operator==(const SharedComponent &_component) const;
+
+    /// \brief Inequality operator.
+    /// \param[in] _component Component to compare to.
+    /// \return True if different.
+    public: bool operator!=(const SharedComponent &_component) const;
+
+    // Documentation inherited
+    public: ComponentTypeId TypeId() const override;
+
+    // Documentation inherited
+    public: void Serialize(std::ostream &_out) const override;
+
+    // Documentation inherited
+    public: void Deserialize(std::istream &_in) override;
+
+    /// \brief Get the mutable component data. The data is copied first if
+    /// it's shared with other components.
+    /// \return Mutable reference to the component's own data.
+    public: DataType &Data();
+
+    /// \brief Set the data of this component. The new data is interned.
+    /// \param[in] _data New data for this component.
+    /// \param[in] _eql Equality comparison function. This function should
+    /// return true if two instances of DataType are equal.
+    /// \return True if the _eql function returns false.
+    public: bool SetData(const DataType &_data,
+                const std::function<
+                  bool(const DataType &, const DataType &)> &_eql);
+
+    /// \brief Get the immutable component data.
+    /// \return Immutable reference to the shared data.
+    public: const DataType &Data() const;
+
+    /// \brief Get whether this component shares its data with another one.
+    /// \param[in] _component Component to compare to.
+    /// \return True if both components point to the same data.
+    public: bool SharesData(const SharedComponent &_component) const;
+
+    /// \brief Get the interned copy of a value.
+    /// \param[in] _data Value to intern.
+    /// \return Shared data equal to _data.
+    private: static std::shared_ptr<DataType> Intern(DataType _data);
+
+    /// \brief Get the default value, which is shared by all default
+    /// constructed components.
+    /// \return Default value.
+    private: static const std::shared_ptr<DataType> &Default();
+
+    /// \brief Shared data. It's never null.
+    private: std::shared_ptr<DataType> data{Default()};
+
+    /// \brief True if the data was copied by the mutable Data() and isn't
+    /// interned. It may still be shared with copies of this component.
+    private: bool detached{false};
+
+    /// \brief Unique ID for this component type. This is set through the
+    /// Factory registration.
+    public: inline static ComponentTypeId typeId{0};
+
+    /// \brief Unique name for this component type. This is set through the
+    /// Factory registration.
+    public: inline static std::string typeName;
+  };
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  SharedComponent<DataType, Identifier, Serializer>::SharedComponent(
+      DataType _data)
+    : data(Intern(std::move(_data)))
+  {
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  DataType &SharedComponent<DataType, Identifier, Serializer>::Data()
+  {
+    // Copy on write. Interned data must never change, even when no other
+    // component holds it, because the pool may hand it out again.
+    if (!this->detached || this->data.use_count() > 1)
+    {
+      this->data = std::make_shared<DataType>(*this->data);
+      this->detached = true;
+    }
+    return *this->data;
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  bool SharedComponent<DataType, Identifier, Serializer>::SetData(
+      const DataType &_data,
+      const std::function<bool(const DataType &, const DataType &)> &_eql)
+  {
+    if (_eql(_data, *this->data))
+      return false;
+    this->data = Intern(_data);
+    this->detached = false;
+    return true;
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  const DataType &SharedComponent<DataType, Identifier, Serializer>::Data()
+      const
+  {
+    return *this->data;
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  bool SharedComponent<DataType, Identifier, Serializer>::SharesData(
+      const SharedComponent<DataType, Identifier, Serializer> &_component)
+      const
+  {
+    return this->data == _component.data;
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  bool SharedComponent<DataType, Identifier, Serializer>::operator==(
+      const SharedComponent<DataType, Identifier, Serializer> &_component)
+      const
+  {
+    return this->data == _component.data || *this->data == *_component.data;
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  bool SharedComponent<DataType, Identifier, Serializer>::operator!=(
+      const SharedComponent<DataType, Identifier, Serializer> &_component)
+      const
+  {
+    return !(*this == _component);
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  void SharedComponent<DataType, Identifier, Serializer>::Serialize(
+      std::ostream &_out) const
+  {
+    Serializer::Serialize(_out, *this->data);
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  void SharedComponent<DataType, Identifier, Serializer>::Deserialize(
+      std::istream &_in)
+  {
+    DataType newData;
+    Serializer::Deserialize(_in, newData);
+    this->data = Intern(std::move(newData));
+    this->detached = false;
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  ComponentTypeId SharedComponent<DataType, Identifier, Serializer>::TypeId()
+      const
+  {
+    return typeId;
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  std::shared_ptr<DataType>
+      SharedComponent<DataType, Identifier, Serializer>::Intern(
+      DataType _data)
+  {
+    std::string key = SharedDataKey<DataType, Serializer>::Key(_data);
+    if (key.empty())
+      return std::make_shared<DataType>(std::move(_data));
+
+    // The pool only keeps weak references, so values are released with the
+    // last component holding them. Expired entries are purged whenever the
+    // pool doubles in size.
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::weak_ptr<DataType>>
+        pool;
+    static std::size_t purgeSize{64};
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &entry = pool[key];
+    if (auto shared = entry.lock())
+      return shared;
+
+    auto shared = std::make_shared<DataType>(std::move(_data));
+    entry = shared;
+
+    if (pool.size() >= purgeSize)
+    {
+      for (auto it = pool.begin(); it != pool.end();)
+      {
+        if (it->second.expired())
+          it = pool.erase(it);
+        else
+          ++it;
+      }
+      purgeSize = pool.size() * 2 + 64;
+    }
+    return shared;
+  }
+
+  //////////////////////////////////////////////////
+  template <typename DataType, typename Identifier, typename Serializer>
+  const std::shared_ptr<DataType> &
+      SharedComponent<DataType, Identifier, Serializer>::Default()
+  {
+    static const std::shared_ptr<DataType> value =
+        std::make_shared<DataType>();
+    return value;
+  }
+}
+}
+}
+}
+#endif
@@ -37,7 +37,9 @@ namespace components
   /// \brief A component type that contains the slip compliance parameters to be
   /// set on a collision. The 0 and 1 index values correspond to the slip
   /// compliance parameters in friction direction 1 (fdir1) and friction
-  /// direction 2 (fdir2) respectively.
+  /// direction 2 (fdir2) respectively. Unlike other commands, the component
+  /// isn't cleared after each step, so it holds the last command, and it's
+  /// only applied again once its value changes.
   using SlipComplianceCmd =
     Component<std::vector<double>, class SlipComplianceCmdTag>;
   IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.SlipComplianceCmd ",
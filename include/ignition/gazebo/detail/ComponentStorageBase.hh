@@ -17,10 +17,16 @@
 #ifndef IGNITION_GAZEBO_DETAIL_COMPONENTSTORAGEBASE_HH_
 #define IGNITION_GAZEBO_DETAIL_COMPONENTSTORAGEBASE_HH_
 
-#include <map>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include "ignition/gazebo/components/Component.hh"
+#include "ignition/gazebo/Entity.hh"
 #include "ignition/gazebo/Export.hh"
 #include "ignition/gazebo/Types.hh"
 
@@ -50,6 +56,17 @@ namespace ignition
       public: virtual std::pair<ComponentId, bool> Create(
                   const components::BaseComponent *_data) = 0;
 
+      /// \brief Deserialize a component directly into the storage, without
+      /// a temporary component.
+      /// \param[in] _id Id of the component to update, or
+      /// kComponentIdInvalid to create a new component.
+      /// \param[in] _in Stream holding the serialized component.
+      /// \return Id of the component, and whether the components array was
+      /// expanded. kComponentIdInvalid is returned if there's no component
+      /// with the given id.
+      public: virtual std::pair<ComponentId, bool> DeserializeInPlace(
+                  const ComponentId _id, std::istream &_in) = 0;
+
       /// \brief Remove a component based on an id.
       /// \param[in] _id Id of the component to remove.
       /// \return True if the component was removed.
@@ -76,8 +93,114 @@ namespace ignition
       /// \return First component or nullptr if there are no components.
       public: virtual components::BaseComponent *First() = 0;
 
+      /// \brief Get the number of components.
+      /// \return Number of components.
+      public: virtual std::size_t Size() const = 0;
+
+      /// \brief Estimate the memory held by the storage, including unused
+      /// capacity and change tracking, but not memory owned by the
+      /// component data.
+      /// \return Size in bytes.
+      public: virtual std::size_t MemoryUsage() const = 0;
+
+      /// \brief Set whether reads skip the storage mutex. While lock-free
+      /// reads are enabled, the caller must guarantee that no component of
+      /// this type is created or removed, which is the case while systems
+      /// run PostUpdate.
+      /// \param[in] _lockFree True to stop locking on reads.
+      public: void SetLockFreeReads(bool _lockFree)
+      {
+        this->lockFreeReads.store(_lockFree, std::memory_order_relaxed);
+      }
+
+      /// \brief Get whether reads currently skip the storage mutex.
+      /// \return True if lock-free reads are enabled.
+      public: bool LockFreeReads() const
+      {
+        return this->lockFreeReads.load(std::memory_order_relaxed);
+      }
+
+      /// \brief Set the change state of a component. The first time a
+      /// component is marked as changed since the last ClearChanged(), its
+      /// id is appended to the list returned by ChangedComponents().
+      /// \param[in] _id Id of the component.
+      /// \param[in] _entity Entity which owns the component.
+      /// \param[in] _state New change state.
+      /// \return True if the component exists.
+      public: virtual bool SetChanged(const ComponentId _id,
+                  const Entity _entity, const ComponentState _state) = 0;
+
+      /// \brief Get the change state of a component.
+      /// \param[in] _id Id of the component.
+      /// \return The component's change state, or NoChange if the
+      /// component doesn't exist.
+      public: virtual ComponentState Changed(const ComponentId _id) const = 0;
+
+      /// \brief Mark all components as unchanged. This only visits the
+      /// components which were marked as changed.
+      public: virtual void ClearChanged() = 0;
+
+      /// \brief Get the components which were marked as changed since the
+      /// last ClearChanged(), in the order they were first marked. An entry
+      /// may refer to a component which has since been removed or reset to
+      /// NoChange, so callers should filter entries using Changed().
+      /// \return Pairs of component id and owning entity.
+      public: const std::vector<std::pair<ComponentId, Entity>>
+          &ChangedComponents() const
+      {
+        return this->changedComponents;
+      }
+
+      /// \brief Get the number of components with a one-time change.
+      /// \return Number of components in the OneTimeChange state.
+      public: std::size_t OneTimeChangeCount() const
+      {
+        return this->oneTimeChangeCount;
+      }
+
+      /// \brief Get the number of components with a periodic change.
+      /// \return Number of components in the PeriodicChange state.
+      public: std::size_t PeriodicChangeCount() const
+      {
+        return this->periodicChangeCount;
+      }
+
+      /// \brief Update the change counters when a component goes from one
+      /// change state to another.
+      /// \param[in] _from Previous state.
+      /// \param[in] _to New state.
+      protected: void UpdateChangeCounts(const ComponentState _from,
+                     const ComponentState _to)
+      {
+        if (_from == ComponentState::OneTimeChange)
+          --this->oneTimeChangeCount;
+        else if (_from == ComponentState::PeriodicChange)
+          --this->periodicChangeCount;
+
+        if (_to == ComponentState::OneTimeChange)
+          ++this->oneTimeChangeCount;
+        else if (_to == ComponentState::PeriodicChange)
+          ++this->periodicChangeCount;
+      }
+
       /// \brief Mutex used to prevent data corruption.
       protected: mutable std::mutex mutex;
+
+      /// \brief Components marked as changed since the last ClearChanged().
+      /// The vector keeps its capacity when it's cleared, so marking
+      /// components as changed doesn't allocate in the steady state.
+      protected: std::vector<std::pair<ComponentId, Entity>> changedComponents;
+
+      /// \brief Number of components in the OneTimeChange state.
+      protected: std::size_t oneTimeChangeCount{0};
+
+      /// \brief Number of components in the PeriodicChange state.
+      protected: std::size_t periodicChangeCount{0};
+
+      /// \brief True if reads should not lock the mutex. Readers and writers
+      /// are synchronized externally when this is toggled, so relaxed
+      /// ordering is enough.
+      protected: std::atomic<bool> lockFreeReads{false};
     };
 
     /// \brief Templated implementation of component storage.
@@ -99,6 +222,8 @@ namespace ignition
         // See also this class's Create() function, which expands the value
         // of components vector whenever the capacity is reached.
         this->components.reserve(100);
+        this->ids.reserve(100);
+        this->states.reserve(100);
       }
 
       // Documentation inherited.
@@ -110,37 +235,33 @@ namespace ignition
         auto iter = this->idMap.find(_id);
 
         // Make sure the component exists.
-        if (iter != this->idMap.end())
+        if (iter == this->idMap.end())
+          return false;
+
+        const int index = iter->second;
+        const int lastIndex = static_cast<int>(this->components.size()) - 1;
+
+        // Move the component at the back of the vector into the slot being
+        // freed, and use the slot-to-id back pointer to fix its mapping. This
+        // keeps the components contiguous without walking the id map.
+        this->UpdateChangeCounts(StateOf(this->states[index]),
+            ComponentState::NoChange);
+        if (index != lastIndex)
         {
-          // Handle the case where there are more components than the
-          // component to be removed
-          if (this->components.size() > 1)
-          {
-            // Swap the component to be removed with the component at the
-            // back of the vector.
-            std::swap(this->components[iter->second],
-                      this->components.back());
-
-            // After the swap, we have to fix all the id mappings.
-            for (auto idIter =this->idMap.begin();
-                idIter != this->idMap.end(); ++idIter)
-            {
-              if (static_cast<unsigned int>(idIter->second) ==
-                  this->components.size()-1)
-              {
-                idIter->second = iter->second;
-              }
-            }
-          }
-
-          // Remove the component.
-          this->components.pop_back();
-
-          // Remove the id mapping.
-          this->idMap.erase(iter);
-          return true;
+          this->components[index] = std::move(this->components.back());
+          this->ids[index] = this->ids.back();
+          this->states[index] = this->states.back();
+          this->idMap[this->ids[index]] = index;
         }
-        return false;
+
+        // Remove the component.
+        this->components.pop_back();
+        this->ids.pop_back();
+        this->states.pop_back();
+
+        // Remove the id mapping.
+        this->idMap.erase(iter);
+        return true;
       }
 
       // Documentation inherited.
@@ -148,29 +269,50 @@ namespace ignition
       {
         this->idCounter = 0;
         this->idMap.clear();
+        this->ids.clear();
+        this->states.clear();
         this->components.clear();
+        this->changedComponents.clear();
+        this->oneTimeChangeCount = 0;
+        this->periodicChangeCount = 0;
       }
 
       // Documentation inherited.
       public: std::pair<ComponentId, bool> Create(
                   const components::BaseComponent *_data) final
       {
-        ComponentId result;  // = kComponentIdInvalid;
-        bool expanded = false;
-        if (this->components.size() == this->components.capacity())
+        // Copy the component first, the data may be in this storage, such
+        // as when cloning entities, and reserving would invalidate it
+        ComponentTypeT component(*static_cast<const ComponentTypeT *>(_data));
+
+        bool expanded = this->ReserveOne();
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        ComponentId result = this->AddSlot();
+        this->components.push_back(std::move(component));
+
+        return {result, expanded};
+      }
+
+      // Documentation inherited.
+      public: std::pair<ComponentId, bool> DeserializeInPlace(
+                  const ComponentId _id, std::istream &_in) final
+      {
+        if (_id != kComponentIdInvalid)
         {
-          this->components.reserve(this->components.capacity() + 100);
-          expanded = true;
+          auto comp = this->Component(_id);
+          if (nullptr == comp)
+            return {kComponentIdInvalid, false};
+          comp->Deserialize(_in);
+          return {_id, false};
         }
 
+        bool expanded = this->ReserveOne();
+
         std::lock_guard<std::mutex> lock(this->mutex);
-        // cppcheck-suppress unmatchedSuppression
-        // cppcheck-suppress postfixOperator
-        result = this->idCounter++;
-        this->idMap[result] = this->components.size();
-        // Copy the component
-        this->components.push_back(std::move(
-              ComponentTypeT(*static_cast<const ComponentTypeT *>(_data))));
+        ComponentId result = this->AddSlot();
+        this->components.emplace_back();
+        this->components.back().Deserialize(_in);
 
         return {result, expanded};
       }
@@ -185,23 +327,157 @@ namespace ignition
       }
 
       public: components::BaseComponent *Component(const ComponentId _id) final
+      {
+        if (this->LockFreeReads())
+          return this->ComponentNoLock(_id);
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->ComponentNoLock(_id);
+      }
+
+      // Documentation inherited.
+      public: components::BaseComponent *First() final
+      {
+        if (this->LockFreeReads())
+          return this->FirstNoLock();
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->FirstNoLock();
+      }
+
+      // Documentation inherited.
+      public: std::size_t Size() const final
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->components.size();
+      }
+
+      // Documentation inherited.
+      public: std::size_t MemoryUsage() const final
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        // Each node of the id map holds the pair and a link, and each
+        // bucket a pointer
+        const std::size_t idMapBytes = this->idMap.size() *
+            (sizeof(std::pair<const ComponentId, int>) + sizeof(void *)) +
+            this->idMap.bucket_count() * sizeof(void *);
+
+        return sizeof(*this) +
+            this->components.capacity() * sizeof(ComponentTypeT) +
+            this->ids.capacity() * sizeof(ComponentId) +
+            this->states.capacity() * sizeof(uint8_t) + idMapBytes +
+            this->changedComponents.capacity() *
+            sizeof(std::pair<ComponentId, Entity>);
+      }
+
+      // Documentation inherited.
+      public: bool SetChanged(const ComponentId _id, const Entity _entity,
+                  const ComponentState _state) final
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto iter = this->idMap.find(_id);
+        if (iter == this->idMap.end())
+          return false;
+
+        uint8_t &slot = this->states[iter->second];
+        this->UpdateChangeCounts(StateOf(slot), _state);
+
+        // Only list the component the first time it changes, resetting it to
+        // NoChange keeps it listed.
+        if (_state != ComponentState::NoChange && !(slot & kListedBit))
+        {
+          slot |= kListedBit;
+          this->changedComponents.emplace_back(_id, _entity);
+        }
+        slot = static_cast<uint8_t>((slot & kListedBit) |
+            static_cast<uint8_t>(_state));
+        return true;
+      }
+
+      // Documentation inherited.
+      public: ComponentState Changed(const ComponentId _id) const final
+      {
+        std::unique_lock<std::mutex> lock(this->mutex, std::defer_lock);
+        if (!this->LockFreeReads())
+          lock.lock();
+
+        auto iter = this->idMap.find(_id);
+        if (iter == this->idMap.end())
+          return ComponentState::NoChange;
+        return StateOf(this->states[iter->second]);
+      }
+
+      // Documentation inherited.
+      public: void ClearChanged() final
       {
         std::lock_guard<std::mutex> lock(this->mutex);
+        for (const auto &changed : this->changedComponents)
+        {
+          auto iter = this->idMap.find(changed.first);
+          if (iter != this->idMap.end())
+            this->states[iter->second] = 0u;
+        }
+        this->changedComponents.clear();
+        this->oneTimeChangeCount = 0;
+        this->periodicChangeCount = 0;
+      }
 
+      /// \brief Get the change state stored in a slot's flags.
+      /// \param[in] _slot Slot flags.
+      /// \return The change state.
+      private: static ComponentState StateOf(const uint8_t _slot)
+      {
+        return static_cast<ComponentState>(_slot & kStateMask);
+      }
+
+      /// \brief Make room for one more component.
+      /// \return True if the components array was expanded.
+      private: bool ReserveOne()
+      {
+        if (this->components.size() < this->components.capacity())
+          return false;
+
+        this->components.reserve(this->components.capacity() + 100);
+        this->ids.reserve(this->components.capacity());
+        this->states.reserve(this->components.capacity());
+        return true;
+      }
+
+      /// \brief Assign an id to the component about to be appended to the
+      /// components vector. Must hold the mutex.
+      /// \return Id of the component.
+      private: ComponentId AddSlot()
+      {
+        // cppcheck-suppress unmatchedSuppression
+        // cppcheck-suppress postfixOperator
+        ComponentId result = this->idCounter++;
+        this->idMap[result] = this->components.size();
+        this->ids.push_back(result);
+        this->states.push_back(0u);
+        return result;
+      }
+
+      /// \brief Get a component based on an id without locking.
+      /// \param[in] _id Id of the component to get.
+      /// \return A pointer to the component, or nullptr if the component
+      /// could not be found.
+      private: components::BaseComponent *ComponentNoLock(const ComponentId _id)
+      {
         auto iter = this->idMap.find(_id);
 
         if (iter != this->idMap.end())
         {
           return static_cast<components::BaseComponent *>(
-              &this->components.at(iter->second));
+              &this->components[iter->second]);
         }
         return nullptr;
       }
 
-      // Documentation inherited.
-      public: components::BaseComponent *First() final
+      /// \brief Get the first component without locking.
+      /// \return First component or nullptr if there are no components.
+      private: components::BaseComponent *FirstNoLock()
       {
-        std::lock_guard<std::mutex> lock(this->mutex);
         if (!this->components.empty())
           return static_cast<components::BaseComponent *>(&this->components[0]);
         return nullptr;
@@ -212,7 +488,25 @@ namespace ignition
       private: ComponentId idCounter = 0;
 
       /// \brief Map of ComponentId to Components (see the components vector).
-      private: std::map<ComponentId, int> idMap;
+      private: std::unordered_map<ComponentId, int> idMap;
+
+      /// \brief Id of the component stored at each index of the components
+      /// vector. This is the inverse of idMap, and is used to fix the id
+      /// mapping in constant time when a component is moved on removal.
+      private: std::vector<ComponentId> ids;
+
+      /// \brief Change flags of the component stored at each index of the
+      /// components vector. The low bits hold the ComponentState, and
+      /// kListedBit is set once the component has been appended to
+      /// changedComponents.
+      private: std::vector<uint8_t> states;
+
+      /// \brief Bits of a slot's flags which hold the ComponentState.
+      private: static constexpr uint8_t kStateMask = 0x3;
+
+      /// \brief Bit set in a slot's flags once the component is listed in
+      /// changedComponents.
+      private: static constexpr uint8_t kListedBit = 0x4;
 
       /// \brief Sequential storage of components.
       public: std::vector<ComponentTypeT> components;
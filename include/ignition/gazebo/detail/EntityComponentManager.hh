@@ -17,9 +17,11 @@
 #ifndef IGNITION_GAZEBO_DETAIL_ENTITYCOMPONENTMANAGER_HH_
 #define IGNITION_GAZEBO_DETAIL_ENTITYCOMPONENTMANAGER_HH_
 
+#include <cstddef>
 #include <cstring>
 #include <map>
 #include <set>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -166,7 +168,11 @@ bool EntityComponentManager::SetComponentData(const Entity _entity,
     return true;
   }
 
-  return comp->SetData(_data, CompareData<typename ComponentTypeT::Type>);
+  const bool changed =
+      comp->SetData(_data, CompareData<typename ComponentTypeT::Type>);
+  if (changed)
+    this->UpdateNameIndex(_entity, ComponentTypeT::typeId);
+  return changed;
 }
 
 //////////////////////////////////////////////////
@@ -190,6 +196,18 @@ template<typename ...ComponentTypeTs>
 Entity EntityComponentManager::EntityByComponents(
     const ComponentTypeTs &..._desiredComponents) const
 {
+  // Only compare the entities with the desired name, if indexed
+  std::vector<Entity> candidates;
+  if (this->NameIndexCandidates({&_desiredComponents...}, candidates))
+  {
+    for (const Entity entity : candidates)
+    {
+      if (this->ComponentsMatch(entity, _desiredComponents...))
+        return entity;
+    }
+    return kNullEntity;
+  }
+
   // Get all entities which have components of the desired types
   const auto &view = this->FindView<ComponentTypeTs...>();
 
@@ -228,6 +246,19 @@ template<typename ...ComponentTypeTs>
 std::vector<Entity> EntityComponentManager::EntitiesByComponents(
     const ComponentTypeTs &..._desiredComponents) const
 {
+  // Only compare the entities with the desired name, if indexed
+  std::vector<Entity> candidates;
+  if (this->NameIndexCandidates({&_desiredComponents...}, candidates))
+  {
+    std::vector<Entity> result;
+    for (const Entity entity : candidates)
+    {
+      if (this->ComponentsMatch(entity, _desiredComponents...))
+        result.push_back(entity);
+    }
+    return result;
+  }
+
   // Get all entities which have components of the desired types
   const auto &view = this->FindView<ComponentTypeTs...>();
 
@@ -265,6 +296,22 @@ template<typename ...ComponentTypeTs>
 std::vector<Entity> EntityComponentManager::ChildrenByComponents(Entity _parent,
      const ComponentTypeTs &..._desiredComponents) const
 {
+  // Only compare the children with the desired name, if indexed
+  std::vector<Entity> candidates;
+  if (this->NameIndexCandidates({&_desiredComponents...}, candidates))
+  {
+    std::vector<Entity> result;
+    for (const Entity entity : candidates)
+    {
+      if (this->ParentEntity(entity) == _parent &&
+          this->ComponentsMatch(entity, _desiredComponents...))
+      {
+        result.push_back(entity);
+      }
+    }
+    return result;
+  }
+
   // Get all entities which have components of the desired types
   const auto &view = this->FindView<ComponentTypeTs...>();
 
@@ -304,6 +351,27 @@ std::vector<Entity> EntityComponentManager::ChildrenByComponents(Entity _parent,
   return result;
 }
 
+//////////////////////////////////////////////////
+template<typename ...ComponentTypeTs>
+bool EntityComponentManager::ComponentsMatch(const Entity _entity,
+    const ComponentTypeTs &..._desiredComponents) const
+{
+  bool different{false};
+  ForEach([&](const auto &_desiredComponent)
+  {
+    auto entityComponent = this->Component<
+        std::remove_cv_t<std::remove_reference_t<
+            decltype(_desiredComponent)>>>(_entity);
+
+    if (nullptr == entityComponent || *entityComponent != _desiredComponent)
+    {
+      different = true;
+    }
+  }, _desiredComponents...);
+
+  return !different;
+}
+
 //////////////////////////////////////////////////
 template <typename T>
 struct EntityComponentManager::identity  // NOLINT
@@ -316,10 +384,33 @@ template<typename ...ComponentTypeTs>
 void EntityComponentManager::EachNoCache(typename identity<std::function<
     bool(const Entity &_entity, const ComponentTypeTs *...)>>::type _f) const
 {
+  this->EachNoCache<ComponentTypeTs...>(
+      [&_f](const Entity &_entity, const ComponentTypeTs *..._components)
+      {
+        return _f(_entity, _components...);
+      });
+}
+
+//////////////////////////////////////////////////
+template<typename ...ComponentTypeTs>
+void EntityComponentManager::EachNoCache(typename identity<std::function<
+    bool(const Entity &_entity, ComponentTypeTs *...)>>::type _f)
+{
+  this->EachNoCache<ComponentTypeTs...>(
+      [&_f](const Entity &_entity, ComponentTypeTs *..._components)
+      {
+        return _f(_entity, _components...);
+      });
+}
+
+//////////////////////////////////////////////////
+template<typename ...ComponentTypeTs, typename FunctionT, typename>
+void EntityComponentManager::EachNoCache(FunctionT &&_f) const
+{
+  const auto types = std::set<ComponentTypeId>{ComponentTypeTs::typeId...};
   for (const auto &vertex : this->Entities().Vertices())
   {
     Entity entity = vertex.first;
-    auto types = std::set<ComponentTypeId>{ComponentTypeTs::typeId...};
 
     if (this->EntityMatches(entity, types))
     {
@@ -333,14 +424,13 @@ void EntityComponentManager::EachNoCache(typename identity<std::function<
 }
 
 //////////////////////////////////////////////////
-template<typename ...ComponentTypeTs>
-void EntityComponentManager::EachNoCache(typename identity<std::function<
-    bool(const Entity &_entity, ComponentTypeTs *...)>>::type _f)
+template<typename ...ComponentTypeTs, typename FunctionT, typename>
+void EntityComponentManager::EachNoCache(FunctionT &&_f)
 {
+  const auto types = std::set<ComponentTypeId>{ComponentTypeTs::typeId...};
   for (const auto &vertex : this->Entities().Vertices())
   {
     Entity entity = vertex.first;
-    auto types = std::set<ComponentTypeId>{ComponentTypeTs::typeId...};
 
     if (this->EntityMatches(entity, types))
     {
@@ -357,6 +447,29 @@ void EntityComponentManager::EachNoCache(typename identity<std::function<
 template<typename ...ComponentTypeTs>
 void EntityComponentManager::Each(typename identity<std::function<
     bool(const Entity &_entity, const ComponentTypeTs *...)>>::type _f) const
+{
+  this->Each<ComponentTypeTs...>(
+      [&_f](const Entity &_entity, const ComponentTypeTs *..._components)
+      {
+        return _f(_entity, _components...);
+      });
+}
+
+//////////////////////////////////////////////////
+template<typename ...ComponentTypeTs>
+void EntityComponentManager::Each(typename identity<std::function<
+    bool(const Entity &_entity, ComponentTypeTs *...)>>::type _f)
+{
+  this->Each<ComponentTypeTs...>(
+      [&_f](const Entity &_entity, ComponentTypeTs *..._components)
+      {
+        return _f(_entity, _components...);
+      });
+}
+
+//////////////////////////////////////////////////
+template<typename ...ComponentTypeTs, typename FunctionT, typename>
+void EntityComponentManager::Each(FunctionT &&_f) const
 {
   // Get the view. This will create a new view if one does not already
   // exist.
@@ -364,19 +477,27 @@ void EntityComponentManager::Each(typename identity<std::function<
 
   // Iterate over the entities in the view, and invoke the callback
   // function.
-  for (const Entity entity : view.entities)
+  for (std::size_t i = 0; i < view.entities.size();)
   {
-    if (!_f(entity, view.Component<ComponentTypeTs>(entity, this)...))
+    const Entity entity = view.entities[i];
+    if (!std::apply(_f, std::tuple_cat(std::make_tuple(entity),
+            this->EachArguments<ComponentTypeTs, true>(view, i)...)))
     {
       break;
     }
+
+    // The callback may have added or removed entities from the view, in
+    // which case resume right after the entity that was just visited.
+    if (i < view.entities.size() && view.entities[i] == entity)
+      ++i;
+    else
+      i = view.IndexAfter(entity);
   }
 }
 
 //////////////////////////////////////////////////
-template<typename ...ComponentTypeTs>
-void EntityComponentManager::Each(typename identity<std::function<
-    bool(const Entity &_entity, ComponentTypeTs *...)>>::type _f)
+template<typename ...ComponentTypeTs, typename FunctionT, typename>
+void EntityComponentManager::Each(FunctionT &&_f)
 {
   // Get the view. This will create a new view if one does not already
   // exist.
@@ -384,12 +505,21 @@ void EntityComponentManager::Each(typename identity<std::function<
 
   // Iterate over the entities in the view, and invoke the callback
   // function.
-  for (const Entity entity : view.entities)
+  for (std::size_t i = 0; i < view.entities.size();)
   {
-    if (!_f(entity, view.Component<ComponentTypeTs>(entity, this)...))
+    const Entity entity = view.entities[i];
+    if (!std::apply(_f, std::tuple_cat(std::make_tuple(entity),
+            this->EachArguments<ComponentTypeTs, false>(view, i)...)))
     {
       break;
     }
+
+    // The callback may have added or removed entities from the view, in
+    // which case resume right after the entity that was just visited.
+    if (i < view.entities.size() && view.entities[i] == entity)
+      ++i;
+    else
+      i = view.IndexAfter(entity);
   }
 }
 
@@ -405,6 +535,29 @@ void EntityComponentManager::ForEach(Function _f,
 template <typename... ComponentTypeTs>
 void EntityComponentManager::EachNew(typename identity<std::function<
     bool(const Entity &_entity, ComponentTypeTs *...)>>::type _f)
+{
+  this->EachNew<ComponentTypeTs...>(
+      [&_f](const Entity &_entity, ComponentTypeTs *..._components)
+      {
+        return _f(_entity, _components...);
+      });
+}
+
+//////////////////////////////////////////////////
+template <typename... ComponentTypeTs>
+void EntityComponentManager::EachNew(typename identity<std::function<
+    bool(const Entity &_entity, const ComponentTypeTs *...)>>::type _f) const
+{
+  this->EachNew<ComponentTypeTs...>(
+      [&_f](const Entity &_entity, const ComponentTypeTs *..._components)
+      {
+        return _f(_entity, _components...);
+      });
+}
+
+//////////////////////////////////////////////////
+template<typename ...ComponentTypeTs, typename FunctionT, typename>
+void EntityComponentManager::EachNew(FunctionT &&_f)
 {
   // Get the view. This will create a new view if one does not already
   // exist.
@@ -423,13 +576,12 @@ void EntityComponentManager::EachNew(typename identity<std::function<
 }
 
 //////////////////////////////////////////////////
-template <typename... ComponentTypeTs>
-void EntityComponentManager::EachNew(typename identity<std::function<
-    bool(const Entity &_entity, const ComponentTypeTs *...)>>::type _f) const
+template<typename ...ComponentTypeTs, typename FunctionT, typename>
+void EntityComponentManager::EachNew(FunctionT &&_f) const
 {
   // Get the view. This will create a new view if one does not already
   // exist.
-  detail::View &view = this->FindView<ComponentTypeTs...>();
+  const detail::View &view = this->FindView<ComponentTypeTs...>();
 
   // Iterate over the entities in the view and in the newly created
   // entities list, and invoke the callback
@@ -447,10 +599,21 @@ void EntityComponentManager::EachNew(typename identity<std::function<
 template<typename ...ComponentTypeTs>
 void EntityComponentManager::EachRemoved(typename identity<std::function<
     bool(const Entity &_entity, const ComponentTypeTs *...)>>::type _f) const
+{
+  this->EachRemoved<ComponentTypeTs...>(
+      [&_f](const Entity &_entity, const ComponentTypeTs *..._components)
+      {
+        return _f(_entity, _components...);
+      });
+}
+
+//////////////////////////////////////////////////
+template<typename ...ComponentTypeTs, typename FunctionT, typename>
+void EntityComponentManager::EachRemoved(FunctionT &&_f) const
 {
   // Get the view. This will create a new view if one does not already
   // exist.
-  detail::View &view = this->FindView<ComponentTypeTs...>();
+  const detail::View &view = this->FindView<ComponentTypeTs...>();
 
   // Iterate over the entities in the view and in the newly created
   // entities list, and invoke the callback
@@ -465,95 +628,118 @@ void EntityComponentManager::EachRemoved(typename identity<std::function<
 }
 
 //////////////////////////////////////////////////
-template<typename FirstComponent,
-         typename ...RemainingComponents,
-         typename std::enable_if<
-           sizeof...(RemainingComponents) == 0, int>::type>
-void EntityComponentManager::AddComponentsToView(detail::View &_view,
-    const Entity _entity) const
+template<typename ...ComponentTypeTs, typename FunctionT>
+void EntityComponentManager::ParallelEach(FunctionT &&_f,
+    std::size_t _grainSize)
 {
-  const ComponentTypeId typeId = FirstComponent::typeId;
+  // Get the view before going parallel, so that it's not created
+  // concurrently.
+  detail::View &view = this->FindView<ComponentTypeTs...>();
 
-  const ComponentId compId =
-      this->EntityComponentIdFromType(_entity, typeId);
-  if (compId >= 0)
-  {
-    // Add the component to the view.
-    _view.AddComponent(_entity, typeId, compId);
-  }
-  else
-  {
-    ignerr << "Entity[" << _entity << "] has no component of type["
-      << typeId << "]. This should never happen.\n";
-  }
+  this->ParallelFor(view.entities.size(), _grainSize,
+      [&](std::size_t _begin, std::size_t _end)
+      {
+        for (std::size_t i = _begin; i < _end; ++i)
+        {
+          _f(view.entities[i], view.ComponentAt<ComponentTypeTs>(i, this)...);
+        }
+      });
 }
 
 //////////////////////////////////////////////////
-template<typename FirstComponent,
-         typename ...RemainingComponents,
-         typename std::enable_if<
-           sizeof...(RemainingComponents) != 0, int>::type>
-void EntityComponentManager::AddComponentsToView(detail::View &_view,
-    const Entity _entity) const
+template<typename ...ComponentTypeTs, typename FunctionT>
+void EntityComponentManager::ParallelEach(FunctionT &&_f,
+    std::size_t _grainSize) const
 {
-  const ComponentTypeId typeId = FirstComponent::typeId;
-  const ComponentId compId =
-      this->EntityComponentIdFromType(_entity, typeId);
-  if (compId >= 0)
-  {
-    // Add the component to the view.
-    _view.AddComponent(_entity, typeId, compId);
-  }
-  else
-  {
-    ignerr << "Entity[" << _entity << "] has no component of type["
-      << typeId << "]. This should never happen.\n";
-  }
+  // Get the view before going parallel, so that it's not created
+  // concurrently.
+  const detail::View &view = this->FindView<ComponentTypeTs...>();
+
+  this->ParallelFor(view.entities.size(), _grainSize,
+      [&](std::size_t _begin, std::size_t _end)
+      {
+        for (std::size_t i = _begin; i < _end; ++i)
+        {
+          _f(view.entities[i], static_cast<const ComponentTypeTs *>(
+              view.ComponentAt<ComponentTypeTs>(i, this))...);
+        }
+      });
+}
+
+//////////////////////////////////////////////////
+template<typename ComponentTypeT, typename FunctionT>
+void EntityComponentManager::EachChanged(FunctionT &&_f) const
+{
+  this->EachChangedImplementation(ComponentTypeT::typeId,
+      [&_f](const Entity &_entity, const components::BaseComponent *_comp,
+          gazebo::ComponentState _state) -> bool
+      {
+        return _f(_entity, static_cast<const ComponentTypeT *>(_comp),
+            _state);
+      });
+}
+
+//////////////////////////////////////////////////
+template<typename ComponentTypeT>
+bool EntityComponentManager::HasChangedComponents() const
+{
+  return this->HasChangedComponents(ComponentTypeT::typeId);
+}
 
-  // Add the remaining components to the view.
-  this->AddComponentsToView<RemainingComponents...>(_view, _entity);
+//////////////////////////////////////////////////
+template<typename ComponentTypeT, typename FunctionT>
+std::size_t EntityComponentManager::OnComponentChanged(FunctionT &&_f)
+{
+  return this->AddComponentObserver(ComponentTypeT::typeId,
+      [f = std::forward<FunctionT>(_f)](const Entity &_entity,
+          const components::BaseComponent *_comp,
+          gazebo::ComponentState _state)
+      {
+        f(_entity, static_cast<const ComponentTypeT *>(_comp), _state);
+      });
 }
 
 //////////////////////////////////////////////////
 template<typename ...ComponentTypeTs>
 detail::View &EntityComponentManager::FindView() const
 {
-  auto types = std::set<ComponentTypeId>{ComponentTypeTs::typeId...};
+  detail::ViewKey key;
+  ((traits::ViewTerm<ComponentTypeTs>::kExcluded ? key.excluded :
+    traits::ViewTerm<ComponentTypeTs>::kOptional ? key.optional :
+    key.required).insert(
+      traits::ViewTerm<ComponentTypeTs>::ComponentType::typeId), ...);
 
-  std::map<detail::ComponentTypeKey, detail::View>::iterator viewIter;
+  std::map<detail::ViewKey, detail::View>::iterator viewIter;
 
   // Find the view. If the view doesn't exist, then create a new view.
-  if (!this->FindView(types, viewIter))
+  if (!this->FindView(key, viewIter))
   {
-    detail::View view;
-    // Add all the entities that match the component types to the
-    // view.
-    for (const auto &vertex : this->Entities().Vertices())
-    {
-      Entity entity = vertex.first;
-      if (this->EntityMatches(entity, types))
-      {
-        view.AddEntity(entity, this->IsNewEntity(entity));
-        // If there is a request to delete this entity, update the view as
-        // well
-        if (this->IsMarkedForRemoval(entity))
-        {
-          view.AddEntityToRemoved(entity);
-        }
-
-        // Store pointers to all the components. This recursively adds
-        // all the ComponentTypeTs that belong to the entity to the view.
-        this->AddComponentsToView<ComponentTypeTs...>(view, entity);
-      }
-    }
+    detail::View view(key.required, key.optional);
+    // Add all the entities that match the key to the view.
+    this->PopulateView(key, view);
 
     // Store the view.
-    return this->AddView(types, std::move(view))->second;
+    return this->AddView(key, std::move(view))->second;
   }
 
   return viewIter->second;
 }
 
+//////////////////////////////////////////////////
+template<typename TermT, bool kConst>
+auto EntityComponentManager::EachArguments(const detail::View &_view,
+    const std::size_t _index) const
+{
+  using ComponentT = typename traits::ViewTerm<TermT>::ComponentType;
+  using PointerT = std::conditional_t<kConst,
+      const ComponentT *, ComponentT *>;
+
+  if constexpr (traits::ViewTerm<TermT>::kExcluded)
+    return std::tuple<>();
+  else
+    return std::tuple<PointerT>(_view.ComponentAt<ComponentT>(_index, this));
+}
+
 //////////////////////////////////////////////////
 template<typename ComponentTypeT>
 bool EntityComponentManager::RemoveComponent(Entity _entity)
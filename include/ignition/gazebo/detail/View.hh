@@ -17,10 +17,13 @@
 #ifndef IGNITION_GAZEBO_DETAIL_VIEW_HH_
 #define IGNITION_GAZEBO_DETAIL_VIEW_HH_
 
-#include <map>
+#include <cstddef>
+#include <cstdint>
 #include <set>
 #include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 #include "ignition/gazebo/components/Component.hh"
 #include "ignition/gazebo/Entity.hh"
 #include "ignition/gazebo/Export.hh"
@@ -37,6 +40,31 @@ namespace detail
 /// \brief A key into the map of views
 using ComponentTypeKey = std::set<ComponentTypeId>;
 
+/// \brief A key into the map of views. The entities of a view have all of
+/// the required component types and none of the excluded ones. The
+/// optional component types don't affect which entities belong to the
+/// view, but their ids are cached for the entities that have them.
+struct ViewKey
+{
+  /// \brief Component types the entities must have.
+  ComponentTypeKey required;
+
+  /// \brief Component types the entities must not have.
+  ComponentTypeKey excluded;
+
+  /// \brief Component types the entities may have.
+  ComponentTypeKey optional;
+
+  /// \brief Less than operator, so keys can be used in a map.
+  /// \param[in] _other Key to compare to.
+  /// \return True if this key orders before _other.
+  bool operator<(const ViewKey &_other) const
+  {
+    return std::tie(this->required, this->excluded, this->optional) <
+        std::tie(_other.required, _other.excluded, _other.optional);
+  }
+};
+
 /// \brief A view is a cache to entities, and their components, that
 /// match a set of component types. A cache is used because systems will
 /// frequently, potentially every iteration, query the
@@ -47,6 +75,17 @@ using ComponentTypeKey = std::set<ComponentTypeId>;
 /// compared to the frequency of queries performed by systems.
 class IGNITION_GAZEBO_VISIBLE View
 {
+  /// \brief Default constructor. A view constructed this way has no
+  /// component types, see the constructor that takes a ComponentTypeKey.
+  public: View() = default;
+
+  /// \brief Constructor
+  /// \param[in] _types Component types that define this view.
+  /// \param[in] _optionalTypes Component types whose ids are also cached,
+  /// for the entities that have them.
+  public: explicit View(const ComponentTypeKey &_types,
+              const ComponentTypeKey &_optionalTypes = {});
+
   /// Get a pointer to a component for an entity based on a component type.
   /// \param[in] _entity The entity.
   /// \param[in] _ecm Pointer to the entity component manager.
@@ -57,7 +96,8 @@ class IGNITION_GAZEBO_VISIBLE View
   {
     ComponentTypeId typeId = ComponentTypeT::typeId;
     return static_cast<const ComponentTypeT *>(
-        this->ComponentImplementation(_entity, typeId, _ecm));
+        this->ComponentImplementation(_entity, typeId,
+            ComponentTypeT::typeIndex, _ecm));
   }
 
   /// Get a pointer to a component for an entity based on a component type.
@@ -71,7 +111,25 @@ class IGNITION_GAZEBO_VISIBLE View
     ComponentTypeId typeId = ComponentTypeT::typeId;
     return static_cast<ComponentTypeT *>(
         const_cast<components::BaseComponent *>(
-          this->ComponentImplementation(_entity, typeId, _ecm)));
+          this->ComponentImplementation(_entity, typeId,
+              ComponentTypeT::typeIndex, _ecm)));
+  }
+
+  /// Get a pointer to a component for the entity stored at a given index
+  /// of the `entities` vector. This avoids searching for the entity, and is
+  /// what Each uses while scanning the view.
+  /// \param[in] _index Index of the entity in `entities`.
+  /// \param[in] _ecm Pointer to the entity component manager.
+  /// \return Pointer to the component.
+  public: template<typename ComponentTypeT>
+          ComponentTypeT *ComponentAt(const std::size_t _index,
+              const EntityComponentManager *_ecm) const
+  {
+    ComponentTypeId typeId = ComponentTypeT::typeId;
+    return static_cast<ComponentTypeT *>(
+        const_cast<components::BaseComponent *>(
+          this->ComponentAtImplementation(_index, typeId,
+              ComponentTypeT::typeIndex, _ecm)));
   }
 
   /// \brief Add an entity to the view.
@@ -90,6 +148,12 @@ class IGNITION_GAZEBO_VISIBLE View
   public: bool RemoveEntity(const Entity _entity,
                            const ComponentTypeKey &_key);
 
+  /// \brief Remove many entities from the view, in one pass over it.
+  /// \param[in] _entities Entities to remove, sorted. Entities which aren't
+  /// in the view are ignored.
+  /// \return Number of entities removed.
+  public: std::size_t RemoveEntities(const std::vector<Entity> &_entities);
+
   /// \brief Add the entity to the list of entities to be removed
   /// \param[in] _entity The entity to add.
   /// \return True if the entity was added to the list, false if the entity
@@ -104,21 +168,61 @@ class IGNITION_GAZEBO_VISIBLE View
                             const ComponentTypeId _compTypeId,
                             const ComponentId _compId);
 
+  /// \brief Get the index of an entity in the `entities` vector.
+  /// \param[in] _entity The entity.
+  /// \return Index of the entity, or `entities.size()` if the entity is
+  /// not part of the view.
+  public: std::size_t EntityIndex(const Entity _entity) const;
+
+  /// \brief Get the index of the first entity in the `entities` vector
+  /// that is greater than the given entity. This is used to resume
+  /// iterating after the view was modified from within a callback.
+  /// \param[in] _entity The entity.
+  /// \return Index of the next entity, which may be `entities.size()`.
+  public: std::size_t IndexAfter(const Entity _entity) const;
+
+  /// \brief Remove all entities and their components from the view,
+  /// keeping the component types.
+  public: void ClearEntities();
+
   /// \brief Implementation of the Component accessor.
   /// \param[in] _entity The entity.
   /// \param[in] _typeId Type id of the component.
+  /// \param[in] _typeIndex Dense index of the component type.
   /// \param[in] _ecm Pointer to the EntityComponentManager.
   /// \return Pointer to the component, or nullptr if not found.
   private: const components::BaseComponent *ComponentImplementation(
                const Entity _entity,
                ComponentTypeId _typeId,
+               std::size_t _typeIndex,
+               const EntityComponentManager *_ecm) const;
+
+  /// \brief Implementation of the ComponentAt accessor.
+  /// \param[in] _index Index of the entity in `entities`.
+  /// \param[in] _typeId Type id of the component.
+  /// \param[in] _typeIndex Dense index of the component type, used to
+  /// find its storage without hashing the type id.
+  /// \param[in] _ecm Pointer to the EntityComponentManager.
+  /// \return Pointer to the component, or nullptr if not found or if the
+  /// entity doesn't have an optional component.
+  private: const components::BaseComponent *ComponentAtImplementation(
+               const std::size_t _index,
+               ComponentTypeId _typeId,
+               std::size_t _typeIndex,
                const EntityComponentManager *_ecm) const;
 
+  /// \brief Get the column of a component type in `componentIds`.
+  /// \param[in] _typeId Type id of the component.
+  /// \return The column, or `componentTypes.size()` if the type doesn't
+  /// belong to this view.
+  private: std::size_t TypeColumn(const ComponentTypeId _typeId) const;
+
   /// \brief Clear the list of new entities
   public: void ClearNewEntities();
 
-  /// \brief All the entities that belong to this view.
-  public: std::set<Entity> entities;
+  /// \brief All the entities that belong to this view, sorted in ascending
+  /// order so that iteration is a linear scan over contiguous memory.
+  public: std::vector<Entity> entities;
 
   /// \brief List of newly created entities
   public: std::set<Entity> newEntities;
@@ -126,9 +230,24 @@ class IGNITION_GAZEBO_VISIBLE View
   /// \brief List of entities about to be removed
   public: std::set<Entity> toRemoveEntities;
 
-  /// \brief All of the components for each entity.
-  public: std::map<std::pair<Entity, ComponentTypeId>,
-          ComponentId> components;
+  /// \brief The component types of this view, required and optional,
+  /// sorted in ascending order. Each type's position is its column in
+  /// `componentIds`.
+  public: std::vector<ComponentTypeId> componentTypes;
+
+  /// \brief The component ids of all entities. This is a row-major table
+  /// parallel to `entities`, with one row per entity and one column per
+  /// component type in `componentTypes`. Optional components that an
+  /// entity doesn't have are stored as kComponentIdInvalid.
+  public: std::vector<ComponentId> componentIds;
+
+  /// \brief Bitmask of the required component types, by type index, see
+  /// Component::typeIndex. Set by the EntityComponentManager so that
+  /// matching an entity's component types is a few bit tests.
+  public: std::vector<uint64_t> requiredMask;
+
+  /// \brief Bitmask of the excluded component types, by type index.
+  public: std::vector<uint64_t> excludedMask;
 };
 /// \endcond
 }
@@ -20,7 +20,11 @@
 #include <ignition/msgs/serialized.pb.h>
 
 #include <QtCore>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include <ignition/transport/Node.hh>
 
@@ -35,6 +39,10 @@ namespace gazebo
 inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
 /// \brief Responsible for running GUI systems as new states are received from
 /// the backend.
+///
+/// If the IGN_GAZEBO_COMPRESSED_STATE environment variable is set to 1,
+/// states are received compressed from the `state/compressed` topic, which
+/// uses less bandwidth for remote servers.
 class IGNITION_GAZEBO_VISIBLE GuiRunner : public QObject
 {
   Q_OBJECT
@@ -57,10 +65,28 @@ class IGNITION_GAZEBO_VISIBLE GuiRunner : public QObject
   /// \param[in] _res Response containing new state.
   private: void OnStateAsyncService(const msgs::SerializedStepMap &_res);
 
-  /// \brief Callback when a new state is received from the server.
+  /// \brief Callback when a new state is received from the server. The
+  /// state is queued for the update thread.
   /// \param[in] _msg New state message.
   private: void OnState(const msgs::SerializedStepMap &_msg);
 
+  /// \brief Callback when a new compressed state is received from the
+  /// server. The state is decompressed and handled as by OnState.
+  /// \param[in] _data Compressed state message.
+  /// \param[in] _size Size of the compressed message.
+  /// \param[in] _info Information about the message.
+  private: void OnCompressedState(const char *_data, const size_t _size,
+      const transport::MessageInfo &_info);
+
+  /// \brief Apply queued states and update plugins, until the runner is
+  /// destroyed. States which arrive while plugins are updating are applied
+  /// together, and plugins are updated once for all of them.
+  private: void UpdateLoop();
+
+  /// \brief Let the server know a state was processed.
+  /// \param[in] _msg State message.
+  private: void AckState(const msgs::SerializedStepMap &_msg);
+
   /// \brief Entity-component manager.
   private: gazebo::EntityComponentManager ecm;
 
@@ -70,6 +96,33 @@ class IGNITION_GAZEBO_VISIBLE GuiRunner : public QObject
   /// \brief Topic to request state
   private: std::string stateTopic;
 
+  /// \brief Whether to subscribe to compressed states.
+  private: bool compressedState{false};
+
+  /// \brief Publishes the sequence number of each state once it's
+  /// processed, so the server doesn't send states faster than they can be
+  /// processed.
+  private: transport::Node::Publisher stateAckPub;
+
+  /// \brief Identifies this client's acknowledgements.
+  private: std::string clientId;
+
+  /// \brief States received and not applied yet, oldest first.
+  private: std::deque<msgs::SerializedStepMap> stateQueue;
+
+  /// \brief Protects stateQueue and stopUpdates.
+  private: std::mutex stateQueueMutex;
+
+  /// \brief Notifies the update thread of new states.
+  private: std::condition_variable stateQueueCv;
+
+  /// \brief Set to stop the update thread.
+  private: bool stopUpdates{false};
+
+  /// \brief Applies states and updates plugins, so transport threads aren't
+  /// held by slow updates.
+  private: std::thread updateThread;
+
   /// \brief Latest update info
   private: UpdateInfo updateInfo;
 };
@@ -18,8 +18,10 @@
 #define IGNITION_GAZEBO_GUI_GUISYSTEM_HH_
 
 #include <QtCore>
+#include <unordered_set>
 
 #include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Types.hh>
 #include <ignition/gazebo/EntityComponentManager.hh>
 #include <ignition/gazebo/Export.hh>
 #include <ignition/gui/Plugin.hh>
@@ -46,13 +48,22 @@ namespace gazebo
     Q_OBJECT
 
     /// \brief Update callback called every time the system is stepped.
-    /// This is called at an Ignition transport thread, so any interaction
-    /// with Qt should be done through signals and slots.
+    /// This is called at a worker thread, so any interaction with Qt should
+    /// be done through signals and slots.
     /// \param[in] _info Current simulation information, such as time.
     /// \param[in] _ecm Mutable reference to the ECM, so the system can read
     /// and write entities and their components.
     public: virtual void Update(const UpdateInfo &/*_info*/,
                                 EntityComponentManager &/*_ecm*/){}
+
+    /// \brief Component types the system uses. If not empty, Update is
+    /// skipped for states which don't change any of them, nor add or remove
+    /// entities.
+    /// \return Component type IDs, empty to update on every state.
+    public: virtual std::unordered_set<ComponentTypeId> ComponentTypes() const
+    {
+      return {};
+    }
   };
 }
 }
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_ASYNCVIDEOENCODER_HH_
+#define IGNITION_GAZEBO_ASYNCVIDEOENCODER_HH_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <ignition/common/VideoEncoder.hh>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+// Forward declare private data class.
+class AsyncVideoEncoderPrivate;
+
+/// \brief Encodes video frames on a dedicated thread, so the thread
+/// producing them, typically a render thread, isn't held up by encoding.
+///
+/// Frames are queued, and are encoded in order. Up to 10 frames can be
+/// queued. Frames which arrive while the queue is full are dropped, and a
+/// warning is printed once per video.
+class IGNITION_GAZEBO_VISIBLE AsyncVideoEncoder
+{
+  /// \brief Constructor
+  public: AsyncVideoEncoder();
+
+  /// \brief Destructor. Encodes the queued frames and saves the video if
+  /// encoding.
+  public: ~AsyncVideoEncoder();
+
+  /// \brief Start encoding a video, see common::VideoEncoder::Start.
+  /// Stops the current video first, if any.
+  /// \param[in] _format Video format, such as mp4.
+  /// \param[in] _filename File the video is saved to.
+  /// \param[in] _width Width of the frames in pixels.
+  /// \param[in] _height Height of the frames in pixels.
+  /// \param[in] _fps Frames per second of the video.
+  /// \param[in] _bitRate Bit rate of the video.
+  /// \return True if encoding started.
+  public: bool Start(const std::string &_format,
+      const std::string &_filename, unsigned int _width,
+      unsigned int _height, unsigned int _fps = VIDEO_ENCODER_FPS_DEFAULT,
+      unsigned int _bitRate = VIDEO_ENCODER_BITRATE_DEFAULT);
+
+  /// \brief Queue a frame, without copying it. The frame is kept alive
+  /// until it's encoded.
+  /// \param[in] _frame RGB frame, 3 bytes per pixel.
+  /// \param[in] _width Width of the frame in pixels.
+  /// \param[in] _height Height of the frame in pixels.
+  /// \param[in] _timestamp Time of the frame.
+  /// \return False if not encoding or if the queue is full.
+  public: bool AddFrame(const std::shared_ptr<const unsigned char> &_frame,
+      unsigned int _width, unsigned int _height,
+      const std::chrono::steady_clock::time_point &_timestamp);
+
+  /// \brief Queue a copy of a frame. Buffers are reused between frames.
+  /// \param[in] _frame RGB frame, 3 bytes per pixel.
+  /// \param[in] _width Width of the frame in pixels.
+  /// \param[in] _height Height of the frame in pixels.
+  /// \param[in] _timestamp Time of the frame.
+  /// \return False if not encoding or if the queue is full.
+  public: bool AddFrame(const unsigned char *_frame, unsigned int _width,
+      unsigned int _height,
+      const std::chrono::steady_clock::time_point &_timestamp);
+
+  /// \brief Wait for the queued frames to be encoded, then save the video.
+  /// \return True if the video was saved.
+  public: bool Stop();
+
+  /// \brief Whether a video is being encoded.
+  /// \return True between Start and Stop.
+  public: bool IsEncoding() const;
+
+  /// \brief Set a callback called on the encoding thread for each frame
+  /// added to the video. Frames may be skipped by the encoder to keep the
+  /// video's frame rate.
+  /// \param[in] _cb Callback receiving the frame's timestamp.
+  public: void SetFrameAddedCallback(
+      std::function<void(const std::chrono::steady_clock::time_point &)>
+      _cb);
+
+  /// \internal
+  /// \brief Private data pointer
+  private: std::unique_ptr<AsyncVideoEncoderPrivate> dataPtr;
+};
+}
+}
+}
+#endif
@@ -17,10 +17,13 @@
 #ifndef IGNITION_GAZEBO_RENDERING_EVENTS_HH_
 #define IGNITION_GAZEBO_RENDERING_EVENTS_HH_
 
+#include <memory>
 
 #include <ignition/common/Event.hh>
+#include <ignition/msgs/image.pb.h>
 
 #include "ignition/gazebo/config.hh"
+#include "ignition/gazebo/Entity.hh"
 
 namespace ignition
 {
@@ -53,6 +56,35 @@ namespace ignition
       /// \endcode
       using PostRender = ignition::common::EventT<void(void),
           struct PostRenderTag>;
+
+      /// \brief Emitted by in-process consumers to start or stop receiving
+      /// NewImageFrame events for a camera, depth camera or thermal camera
+      /// sensor. Requests are counted per sensor, so each request to start
+      /// must be matched by one to stop. Connect to NewImageFrame before
+      /// starting.
+      ///
+      /// For example:
+      /// \code
+      /// eventManager.Emit<ignition::gazebo::events::EnableImageFrames>(
+      ///     sensorEntity, true);
+      /// \endcode
+      using EnableImageFrames = ignition::common::EventT<
+          void(const Entity &, bool), struct EnableImageFramesTag>;
+
+      /// \brief The new image frame event is emitted in the rendering thread
+      /// when a sensor enabled with EnableImageFrames generates an image.
+      /// The frame is shared by all callbacks without being serialized, so it
+      /// must not be modified. Callbacks may keep it for as long as they need
+      /// it, for example to process it in another thread.
+      ///
+      /// For example:
+      /// \code
+      /// eventManager.Emit<ignition::gazebo::events::NewImageFrame>(
+      ///     sensorEntity, frame);
+      /// \endcode
+      using NewImageFrame = ignition::common::EventT<
+          void(const Entity &, const std::shared_ptr<const msgs::Image> &),
+          struct NewImageFrameTag>;
       }
     }  // namespace events
   }  // namespace gazebo
@@ -17,6 +17,7 @@
 #ifndef IGNITION_GAZEBO_RENDERUTIL_HH_
 #define IGNITION_GAZEBO_RENDERUTIL_HH_
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -158,6 +159,16 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     /// \param[in] _active True if active.
     public: void SetTransformActive(bool _active);
 
+    /// \brief Set how long each call to Update may spend creating new
+    /// entities. Entities which don't fit are created on the following calls
+    /// in the order they were received, so frames stay short while many
+    /// entities are added at once. Updates to entities not created yet are
+    /// held until they're created.
+    /// \param[in] _budget Time budget per call. Zero, the default, creates
+    /// all new entities on the next call.
+    public: void SetCreationBudget(
+        const std::chrono::steady_clock::duration &_budget);
+
     /// \brief Private data pointer.
     private: std::unique_ptr<RenderUtilPrivate> dataPtr;
   };
@@ -18,6 +18,7 @@
 #ifndef IGNITION_GAZEBO_SCENEMANAGER_HH_
 #define IGNITION_GAZEBO_SCENEMANAGER_HH_
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -126,7 +127,10 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     public: rendering::VisualPtr CreateLink(Entity _id,
         const sdf::Link &_link, Entity _parentId = 0);
 
-    /// \brief Create a visual
+    /// \brief Create a visual. Visuals which end up with identical
+    /// materials share the same material objects, so the render engine can
+    /// batch and instance repeated models. Callers which change the material
+    /// of a single visual should give its geometry a copy first.
     /// \param[in] _id Unique visual id
     /// \param[in] _visual Visual sdf dom
     /// \param[in] _parentId Parent id
@@ -242,6 +246,34 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     /// \param[in] _id Entity's unique id
     public: void RemoveEntity(Entity _id);
 
+    /// \brief Hide top level visuals which are beyond the far clip plane
+    /// of every sensor, and show them again once they come back into range.
+    /// This saves the render engine from processing visuals no sensor can
+    /// see. Nothing is culled if any sensor isn't a camera, since its range
+    /// is unknown. Culled visuals are hidden with all their descendants, so
+    /// this shouldn't be combined with toggling the visibility of
+    /// individual descendants.
+    public: void CullByDistance();
+
+    /// \brief Set whether meshes are loaded by worker threads. When enabled,
+    /// a visual whose mesh isn't loaded yet is created without geometry,
+    /// and its geometry is attached by AttachLoadedMeshes once the mesh is
+    /// ready, so that loading large meshes doesn't stall rendering.
+    /// Disabled by default, so that sensors see complete visuals.
+    /// \param[in] _async True to load meshes asynchronously.
+    public: void SetAsyncMeshLoading(bool _async);
+
+    /// \brief Get whether meshes are loaded by worker threads.
+    /// \return True if meshes are loaded asynchronously.
+    public: bool AsyncMeshLoading() const;
+
+    /// \brief Attach the geometry of visuals whose meshes finished loading,
+    /// until the deadline passes.
+    /// \param[in] _deadline Time after which no more geometry is attached.
+    /// \return Number of visuals still waiting for their meshes.
+    public: std::size_t AttachLoadedMeshes(
+        const std::chrono::steady_clock::time_point &_deadline);
+
     /// \brief Get the entity for a given node.
     /// \param[in] _node Node to get the entity for.
     /// \return The entity for that node, or `kNullEntity` for no entity.
@@ -259,6 +291,14 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     private: rendering::GeometryPtr LoadGeometry(const sdf::Geometry &_geom,
         math::Vector3d &_scale, math::Pose3d &_localPose);
 
+    /// \brief Create a visual's geometry and materials, and attach them to
+    /// the visual.
+    /// \param[in] _id Visual entity
+    /// \param[in] _visualVis Visual to attach the geometry to
+    /// \param[in] _visual Visual sdf dom
+    private: void AttachGeometry(Entity _id,
+        const rendering::VisualPtr &_visualVis, const sdf::Visual &_visual);
+
     /// \brief Load a material
     /// \param[in] _material Material sdf dom
     /// \return Material object loaded from the sdf dom
@@ -17,6 +17,14 @@
 
 #include "Barrier.hh"
 
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 class ignition::gazebo::BarrierPrivate
 {
   /// \brief Mutex for syncronization
@@ -32,20 +40,50 @@ class ignition::gazebo::BarrierPrivate
   public: unsigned int threadCount;
 
   /// \brief Current remaining thread count (decrements from threadCount)
-  public: unsigned int count;
+  public: std::atomic<unsigned int> count;
+
+  /// \brief Barrier generation, incremented when all threads report. It's
+  /// only incremented while holding the mutex, so that parked threads can't
+  /// miss the notification.
+  public: std::atomic<unsigned int> generation{0};
+
+  /// \brief Number of threads parked on the condition variable. Guarded by
+  /// the mutex.
+  public: unsigned int parked{0};
 
-  /// \brief Barrier generation, incremented when all threads report
-  public: unsigned int generation{0};
+  /// \brief Time to spin before parking, in nanoseconds.
+  public: std::atomic<int64_t> spinNs{0};
 };
 
 using namespace ignition::gazebo;
 
+//////////////////////////////////////////////////
+/// \brief Hint to the CPU that this is a spin loop.
+static inline void cpuRelax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
 //////////////////////////////////////////////////
 Barrier::Barrier(unsigned int _threadCount)
+  : Barrier(_threadCount, std::chrono::nanoseconds::zero())
+{
+}
+
+//////////////////////////////////////////////////
+Barrier::Barrier(unsigned int _threadCount,
+    const std::chrono::nanoseconds &_spin)
   : dataPtr(std::make_unique<BarrierPrivate>())
 {
   this->dataPtr->threadCount = _threadCount;
   this->dataPtr->count = _threadCount;
+  this->SetSpinDuration(_spin);
 }
 
 //////////////////////////////////////////////////
@@ -59,23 +97,56 @@ Barrier::ExitStatus Barrier::Wait()
     return Barrier::ExitStatus::CANCELLED;
   }
 
-  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  // The generation must be read before decrementing the count, otherwise
+  // the last thread could release it in between.
   unsigned int gen = this->dataPtr->generation;
 
   if (--this->dataPtr->count == 0)
   {
-    // All threads have reached the wait, so reset the barrier.
-    this->dataPtr->generation++;
+    // All threads have reached the wait, so reset the barrier. The count is
+    // reset before the generation is incremented, so released threads find
+    // it ready for their next Wait.
     this->dataPtr->count = this->dataPtr->threadCount;
-    this->dataPtr->cv.notify_all();
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->generation++;
+    if (this->dataPtr->parked > 0)
+      this->dataPtr->cv.notify_all();
     return Barrier::ExitStatus::DONE_LAST;
   }
 
-  while (gen == this->dataPtr->generation && !this->dataPtr->cancelled)
+  // Spin for a while, hoping the last thread arrives before it's worth
+  // parking. The clock is only checked every few iterations, since reading
+  // it costs more than the check itself.
+  const int64_t spinNs = this->dataPtr->spinNs;
+  if (spinNs > 0)
+  {
+    const auto deadline = std::chrono::steady_clock::now() +
+        std::chrono::nanoseconds(spinNs);
+    for (unsigned int i = 1; gen == this->dataPtr->generation; ++i)
+    {
+      if (i % 64 == 0)
+      {
+        if (std::chrono::steady_clock::now() >= deadline)
+          break;
+        // Let the thread we're waiting for run, in case it shares our core
+        std::this_thread::yield();
+      }
+      cpuRelax();
+    }
+  }
+
+  if (gen == this->dataPtr->generation)
   {
     // All threads haven't reached, so wait until generation is reached
     // or a cancel occurs
-    this->dataPtr->cv.wait(lock);
+    std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->parked++;
+    this->dataPtr->cv.wait(lock, [&]
+        {
+          return gen != this->dataPtr->generation ||
+              this->dataPtr->cancelled;
+        });
+    this->dataPtr->parked--;
   }
 
   if (this->dataPtr->cancelled)
@@ -98,3 +169,14 @@ void Barrier::Cancel()
   this->dataPtr->cv.notify_all();
 }
 
+//////////////////////////////////////////////////
+void Barrier::SetSpinDuration(const std::chrono::nanoseconds &_spin)
+{
+  this->dataPtr->spinNs = std::max<int64_t>(0, _spin.count());
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds Barrier::SpinDuration() const
+{
+  return std::chrono::nanoseconds(this->dataPtr->spinNs.load());
+}
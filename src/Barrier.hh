@@ -19,6 +19,7 @@
 #define IGNITION_GAZEBO_BARRIER_HH_
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -42,6 +43,11 @@ namespace ignition
     /// all required threads have reached the wait() method.  This is useful
     /// for syncronizing work across many threads.
     ///
+    /// Threads may spin for a short time before parking on a condition
+    /// variable, see SetSpinDuration. When generations are released every
+    /// few microseconds, as in a fast step loop, spinning avoids the cost of
+    /// putting a thread to sleep and waking it up again.
+    ///
     /// Note that this can likely be replaced once the C++ concurrency TS
     /// is ratified: https://en.cppreference.com/w/cpp/experimental/barrier
     class IGNITION_GAZEBO_VISIBLE Barrier
@@ -53,6 +59,13 @@ namespace ignition
       ///       1 main thread would require _threadCount=11.
       public: explicit Barrier(unsigned int _threadCount);
 
+      /// \brief Constructor
+      /// \param[in] _threadCount Number of threads to syncronize, including
+      /// the main thread.
+      /// \param[in] _spin Time threads spin in Wait before parking.
+      public: Barrier(unsigned int _threadCount,
+                      const std::chrono::nanoseconds &_spin);
+
       /// \brief Destructor
       public: ~Barrier();
 
@@ -85,6 +98,18 @@ namespace ignition
       ///        return CANCELLED
       public: void Cancel();
 
+      /// \brief Set how long threads spin in Wait, waiting for the last
+      /// thread, before they park until they're notified. Spinning burns a
+      /// core, so it should only be used when the other threads are expected
+      /// to arrive soon. Defaults to zero, which parks right away. It may be
+      /// changed while threads are waiting, and applies to the next Wait.
+      /// \param[in] _spin Spin duration.
+      public: void SetSpinDuration(const std::chrono::nanoseconds &_spin);
+
+      /// \brief Get how long threads spin in Wait before parking.
+      /// \return Spin duration.
+      public: std::chrono::nanoseconds SpinDuration() const;
+
       /// \brief Pointer to private data.
       private: std::unique_ptr<BarrierPrivate> dataPtr;
     };
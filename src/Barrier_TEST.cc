@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
 #include <thread>
 
 #include "Barrier.hh"
@@ -30,9 +32,10 @@ inline bool wasCancelled(const gazebo::Barrier::ExitStatus &_ret)
 }
 
 //////////////////////////////////////////////////
-void syncThreadsTest(unsigned int _threadCount)
+void syncThreadsTest(unsigned int _threadCount,
+    std::chrono::nanoseconds _spin = std::chrono::nanoseconds::zero())
 {
-  auto barrier = std::make_unique<gazebo::Barrier>(_threadCount + 1);
+  auto barrier = std::make_unique<gazebo::Barrier>(_threadCount + 1, _spin);
 
   unsigned int preBarrier { 0 };
   unsigned int postBarrier { 0 };
@@ -120,6 +123,85 @@ TEST(Barrier, Sync50Threads)
   syncThreadsTest(50);
 }
 
+//////////////////////////////////////////////////
+TEST(Barrier, SpinSync)
+{
+  // Spin for less than the test waits, so threads park
+  syncThreadsTest(5, std::chrono::milliseconds(10));
+
+  // Spin for longer than the test waits, so threads are released while
+  // spinning
+  syncThreadsTest(5, std::chrono::seconds(1));
+}
+
+//////////////////////////////////////////////////
+TEST(Barrier, SpinDuration)
+{
+  gazebo::Barrier barrier(2);
+  EXPECT_EQ(std::chrono::nanoseconds::zero(), barrier.SpinDuration());
+
+  barrier.SetSpinDuration(std::chrono::microseconds(50));
+  EXPECT_EQ(std::chrono::microseconds(50), barrier.SpinDuration());
+
+  barrier.SetSpinDuration(std::chrono::nanoseconds(-1));
+  EXPECT_EQ(std::chrono::nanoseconds::zero(), barrier.SpinDuration());
+}
+
+//////////////////////////////////////////////////
+/// \brief Hand over between two threads many times, like the simulation
+/// and PostUpdate threads do every step, and check that each round trip runs
+/// the worker exactly once, between the two barriers.
+/// \param[in] _spin Spin duration of the barriers.
+void roundTrip(std::chrono::nanoseconds _spin)
+{
+  const int iterations{1000};
+  gazebo::Barrier start(2, _spin);
+  gazebo::Barrier stop(2, _spin);
+
+  std::atomic<int> counter{0};
+  auto t = std::thread([&]()
+  {
+    while (start.Wait() != gazebo::Barrier::ExitStatus::CANCELLED)
+    {
+      ++counter;
+      if (stop.Wait() == gazebo::Barrier::ExitStatus::CANCELLED)
+        break;
+    }
+  });
+
+  int outOfOrder{0};
+  for (int i = 0; i < iterations; ++i)
+  {
+    // The worker hasn't started this round trip yet
+    if (counter != i)
+      ++outOfOrder;
+    EXPECT_FALSE(wasCancelled(start.Wait()));
+    EXPECT_FALSE(wasCancelled(stop.Wait()));
+
+    // The worker finished this round trip before releasing stop
+    if (counter != i + 1)
+      ++outOfOrder;
+  }
+
+  start.Cancel();
+  t.join();
+
+  EXPECT_EQ(0, outOfOrder);
+  EXPECT_EQ(iterations, counter);
+}
+
+//////////////////////////////////////////////////
+TEST(Barrier, RoundTripBlocking)
+{
+  roundTrip(std::chrono::nanoseconds::zero());
+}
+
+//////////////////////////////////////////////////
+TEST(Barrier, RoundTripSpin)
+{
+  roundTrip(std::chrono::microseconds(100));
+}
+
 //////////////////////////////////////////////////
 TEST(Barrier, Cancel)
 {
@@ -0,0 +1,593 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/StringUtils.hh>
+#include <ignition/math/Pose3.hh>
+#include <sdf/Element.hh>
+#include <sdf/Root.hh>
+
+#include "ignition/gazebo/components/Joint.hh"
+#include "ignition/gazebo/components/JointForceCmd.hh"
+#include "ignition/gazebo/components/JointPosition.hh"
+#include "ignition/gazebo/components/JointPositionReset.hh"
+#include "ignition/gazebo/components/JointVelocity.hh"
+#include "ignition/gazebo/components/JointVelocityCmd.hh"
+#include "ignition/gazebo/components/JointVelocityReset.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/PoseCmd.hh"
+#include "ignition/gazebo/components/Static.hh"
+#include "ignition/gazebo/components/World.hh"
+#include "ignition/gazebo/BatchEnvironment.hh"
+#include "ignition/gazebo/Server.hh"
+
+#include "ServerPrivate.hh"
+#include "SimulationRunner.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief An observation or action, mapped onto one component of one entity
+/// in each world.
+struct BatchTerm
+{
+  /// \brief Type of the mapped component.
+  public: ComponentTypeId type{kComponentTypeIdInvalid};
+
+  /// \brief Number of values taken in each world's vector.
+  public: std::size_t size{0};
+
+  /// \brief Offset of the first value in each world's vector.
+  public: std::size_t offset{0};
+
+  /// \brief Mapped entity of each world.
+  public: std::vector<Entity> entities;
+};
+
+/// \brief Dynamic state of a world. Entities are listed in the same order in
+/// all worlds, so a state captured from one world can be applied to another
+/// by index.
+struct BatchWorldState
+{
+  /// \brief Joint positions.
+  public: std::vector<std::pair<Entity, std::vector<double>>> jointPositions;
+
+  /// \brief Joint velocities, in the same order as the positions.
+  public: std::vector<std::vector<double>> jointVelocities;
+
+  /// \brief Poses of top level models which aren't static.
+  public: std::vector<std::pair<Entity, math::Pose3d>> modelPoses;
+};
+
+class ignition::gazebo::BatchEnvironmentPrivate
+{
+  /// \brief Get the entity component manager of a world.
+  /// \param[in] _world Index of the world.
+  /// \return The world's entity component manager.
+  public: EntityComponentManager &Ecm(const unsigned int _world);
+
+  /// \brief Find the entities with the given scoped name in all worlds.
+  /// \param[in] _scopedName Scoped name relative to the worlds.
+  /// \param[out] _entities The entity of each world.
+  /// \return True if all worlds have the entity.
+  public: bool FindEntities(const std::string &_scopedName,
+                            std::vector<Entity> &_entities);
+
+  /// \brief Record the initial state of all worlds.
+  public: void CaptureInitialState();
+
+  /// \brief Record the current dynamic state of a world.
+  /// \param[in] _world Index of the world.
+  /// \param[out] _state The world's state.
+  public: void CaptureState(const unsigned int _world,
+                            BatchWorldState &_state);
+
+  /// \brief Request a world to be set to the given state on its next
+  /// update.
+  /// \param[in] _world Index of the world.
+  /// \param[in] _state State captured from any world of the batch.
+  public: void RequestState(const unsigned int _world,
+                            const BatchWorldState &_state);
+
+  /// \brief Run a single paused iteration, so that pending commands are
+  /// applied, and update the observations.
+  /// \return False if the worlds couldn't be run.
+  public: bool RunPaused();
+
+  /// \brief Copy the actions into the command components.
+  public: void ScatterActions();
+
+  /// \brief Copy the observed components into the observations.
+  public: void GatherObservations();
+
+  /// \brief Server holding one world per batch entry.
+  public: std::unique_ptr<Server> server;
+
+  /// \brief Number of worlds.
+  public: unsigned int count{0};
+
+  /// \brief Registered observations, in order.
+  public: std::vector<BatchTerm> observationTerms;
+
+  /// \brief Registered actions, in order.
+  public: std::vector<BatchTerm> actionTerms;
+
+  /// \brief Observation size of each world.
+  public: std::size_t observationSize{0};
+
+  /// \brief Action size of each world.
+  public: std::size_t actionSize{0};
+
+  /// \brief Observations of all worlds, world-major.
+  public: std::vector<double> observations;
+
+  /// \brief Actions of all worlds, world-major.
+  public: std::vector<double> actions;
+
+  /// \brief Initial state of each world.
+  public: std::vector<BatchWorldState> initialStates;
+};
+
+//////////////////////////////////////////////////
+BatchEnvironment::BatchEnvironment(const ServerConfig &_config,
+    const unsigned int _count)
+  : dataPtr(std::make_unique<BatchEnvironmentPrivate>())
+{
+  sdf::Root root;
+  sdf::Errors errors;
+  if (!_config.SdfString().empty())
+    errors = root.LoadSdfString(_config.SdfString());
+  else
+    errors = root.Load(_config.SdfFile());
+
+  if (!errors.empty())
+  {
+    for (auto &err : errors)
+      ignerr << err << "\n";
+    return;
+  }
+
+  auto rootElem = root.Element();
+  if (_count == 0 || !rootElem || !rootElem->HasElement("world"))
+  {
+    ignerr << "Failed to create a batch of [" << _count << "] worlds."
+           << std::endl;
+    return;
+  }
+
+  // Clone the first world, giving each copy a unique name
+  auto worldElem = rootElem->GetElement("world");
+  auto worldName = worldElem->Get<std::string>("name");
+  std::string sdfString = "<?xml version='1.0'?><sdf version='" +
+      root.Version() + "'>";
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    auto clone = worldElem->Clone();
+    clone->GetAttribute("name")->Set(worldName + "_" + std::to_string(i));
+    sdfString += clone->ToString("");
+  }
+  sdfString += "</sdf>";
+
+  ServerConfig config(_config);
+  config.SetSdfString(sdfString);
+  config.SetLockstepWorlds(true);
+  this->dataPtr->server = std::make_unique<Server>(config);
+  this->dataPtr->count = this->dataPtr->server->dataPtr->simRunners.size();
+
+  // Rollouts aren't paced to real time
+  for (unsigned int i = 0; i < this->dataPtr->count; ++i)
+  {
+    this->dataPtr->server->SetUpdatePeriod(
+        std::chrono::steady_clock::duration::zero(), i);
+  }
+
+  this->dataPtr->CaptureInitialState();
+}
+
+//////////////////////////////////////////////////
+BatchEnvironment::~BatchEnvironment() = default;
+
+//////////////////////////////////////////////////
+unsigned int BatchEnvironment::Count() const
+{
+  return this->dataPtr->count;
+}
+
+//////////////////////////////////////////////////
+bool BatchEnvironment::AddObservation(const std::string &_scopedName,
+    const ComponentTypeId _type)
+{
+  BatchTerm term;
+  term.type = _type;
+  if (_type == components::JointPosition::typeId ||
+      _type == components::JointVelocity::typeId)
+  {
+    term.size = 1;
+  }
+  else if (_type == components::Pose::typeId)
+  {
+    term.size = 7;
+  }
+  else
+  {
+    ignerr << "Unsupported observation component type [" << _type
+           << "] for entity [" << _scopedName << "]." << std::endl;
+    return false;
+  }
+
+  if (!this->dataPtr->FindEntities(_scopedName, term.entities))
+    return false;
+
+  // Make sure the physics system fills the joint state in
+  for (unsigned int i = 0; i < this->dataPtr->count; ++i)
+  {
+    auto &ecm = this->dataPtr->Ecm(i);
+    auto entity = term.entities[i];
+    if (_type == components::JointVelocity::typeId &&
+        !ecm.Component<components::JointVelocity>(entity))
+    {
+      ecm.CreateComponent(entity, components::JointVelocity());
+    }
+  }
+
+  term.offset = this->dataPtr->observationSize;
+  this->dataPtr->observationSize += term.size;
+  this->dataPtr->observationTerms.push_back(std::move(term));
+  this->dataPtr->observations.assign(
+      this->dataPtr->count * this->dataPtr->observationSize, 0.0);
+  this->dataPtr->GatherObservations();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BatchEnvironment::AddAction(const std::string &_scopedName,
+    const ComponentTypeId _type)
+{
+  BatchTerm term;
+  term.type = _type;
+  if (_type == components::JointForceCmd::typeId ||
+      _type == components::JointVelocityCmd::typeId)
+  {
+    term.size = 1;
+  }
+  else
+  {
+    ignerr << "Unsupported action component type [" << _type
+           << "] for entity [" << _scopedName << "]." << std::endl;
+    return false;
+  }
+
+  if (!this->dataPtr->FindEntities(_scopedName, term.entities))
+    return false;
+
+  term.offset = this->dataPtr->actionSize;
+  this->dataPtr->actionSize += term.size;
+  this->dataPtr->actionTerms.push_back(std::move(term));
+  this->dataPtr->actions.assign(
+      this->dataPtr->count * this->dataPtr->actionSize, 0.0);
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::size_t BatchEnvironment::ObservationSize() const
+{
+  return this->dataPtr->observationSize;
+}
+
+//////////////////////////////////////////////////
+std::size_t BatchEnvironment::ActionSize() const
+{
+  return this->dataPtr->actionSize;
+}
+
+//////////////////////////////////////////////////
+const double *BatchEnvironment::Observations() const
+{
+  return this->dataPtr->observations.data();
+}
+
+//////////////////////////////////////////////////
+double *BatchEnvironment::Actions()
+{
+  return this->dataPtr->actions.data();
+}
+
+//////////////////////////////////////////////////
+bool BatchEnvironment::Step(const uint64_t _iterations)
+{
+  if (!this->dataPtr->server)
+    return false;
+
+  // Physics clears the commands after each iteration, so they're written
+  // for every iteration.
+  for (uint64_t i = 0; i < _iterations; ++i)
+  {
+    this->dataPtr->ScatterActions();
+    if (!this->dataPtr->server->RunOnce(false))
+      return false;
+  }
+
+  this->dataPtr->GatherObservations();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BatchEnvironment::Reset()
+{
+  if (!this->dataPtr->server)
+    return false;
+
+  for (unsigned int i = 0; i < this->dataPtr->count; ++i)
+    this->dataPtr->RequestState(i, this->dataPtr->initialStates[i]);
+
+  return this->dataPtr->RunPaused();
+}
+
+//////////////////////////////////////////////////
+bool BatchEnvironment::Reset(const unsigned int _world)
+{
+  if (_world >= this->dataPtr->count)
+  {
+    ignerr << "Invalid world index [" << _world << "], batch has ["
+           << this->dataPtr->count << "] worlds." << std::endl;
+    return false;
+  }
+
+  this->dataPtr->RequestState(_world, this->dataPtr->initialStates[_world]);
+  return this->dataPtr->RunPaused();
+}
+
+//////////////////////////////////////////////////
+bool BatchEnvironment::Fork(const unsigned int _source)
+{
+  if (_source >= this->dataPtr->count)
+  {
+    ignerr << "Invalid world index [" << _source << "], batch has ["
+           << this->dataPtr->count << "] worlds." << std::endl;
+    return false;
+  }
+
+  BatchWorldState state;
+  this->dataPtr->CaptureState(_source, state);
+  for (unsigned int i = 0; i < this->dataPtr->count; ++i)
+  {
+    if (i != _source)
+      this->dataPtr->RequestState(i, state);
+  }
+
+  return this->dataPtr->RunPaused();
+}
+
+//////////////////////////////////////////////////
+EntityComponentManager &BatchEnvironmentPrivate::Ecm(
+    const unsigned int _world)
+{
+  return this->server->dataPtr->simRunners[_world]->EntityCompMgr();
+}
+
+//////////////////////////////////////////////////
+bool BatchEnvironmentPrivate::FindEntities(const std::string &_scopedName,
+    std::vector<Entity> &_entities)
+{
+  auto names = common::Split(_scopedName, ':');
+  _entities.clear();
+  for (unsigned int i = 0; i < this->count; ++i)
+  {
+    auto &ecm = this->Ecm(i);
+    auto entity = ecm.EntityByComponents(components::World());
+    for (const auto &name : names)
+    {
+      if (name.empty())
+        continue;
+
+      entity = ecm.EntityByComponents(components::Name(name),
+          components::ParentEntity(entity));
+      if (kNullEntity == entity)
+        break;
+    }
+
+    if (kNullEntity == entity)
+    {
+      ignerr << "Failed to find entity [" << _scopedName << "] in world ["
+             << i << "]." << std::endl;
+      return false;
+    }
+    _entities.push_back(entity);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void BatchEnvironmentPrivate::CaptureInitialState()
+{
+  // Have physics fill in all joint positions and velocities, without
+  // stepping
+  for (unsigned int i = 0; i < this->count; ++i)
+  {
+    auto &ecm = this->Ecm(i);
+    ecm.Each<components::Joint>(
+        [&](const Entity &_entity, const components::Joint *) -> bool
+        {
+          if (!ecm.Component<components::JointPosition>(_entity))
+            ecm.CreateComponent(_entity, components::JointPosition());
+          if (!ecm.Component<components::JointVelocity>(_entity))
+            ecm.CreateComponent(_entity, components::JointVelocity());
+          return true;
+        });
+  }
+  this->server->RunOnce(true);
+
+  // Worlds are reset at rest
+  this->initialStates.resize(this->count);
+  for (unsigned int i = 0; i < this->count; ++i)
+  {
+    auto &state = this->initialStates[i];
+    this->CaptureState(i, state);
+    for (std::size_t j = 0; j < state.jointPositions.size(); ++j)
+    {
+      state.jointVelocities[j].assign(
+          state.jointPositions[j].second.size(), 0.0);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void BatchEnvironmentPrivate::CaptureState(const unsigned int _world,
+    BatchWorldState &_state)
+{
+  auto &ecm = this->Ecm(_world);
+  auto worldEntity = ecm.EntityByComponents(components::World());
+
+  ecm.Each<components::Joint, components::JointPosition>(
+      [&](const Entity &_entity, const components::Joint *,
+          const components::JointPosition *_pos) -> bool
+      {
+        _state.jointPositions.emplace_back(_entity, _pos->Data());
+        auto vel = ecm.Component<components::JointVelocity>(_entity);
+        _state.jointVelocities.push_back(vel ? vel->Data() :
+            std::vector<double>(_pos->Data().size(), 0.0));
+        return true;
+      });
+
+  ecm.Each<components::Model, components::ParentEntity, components::Pose>(
+      [&](const Entity &_entity, const components::Model *,
+          const components::ParentEntity *_parent,
+          const components::Pose *_pose) -> bool
+      {
+        auto staticComp = ecm.Component<components::Static>(_entity);
+        if (_parent->Data() == worldEntity &&
+            (!staticComp || !staticComp->Data()))
+        {
+          _state.modelPoses.emplace_back(_entity, _pose->Data());
+        }
+        return true;
+      });
+}
+
+//////////////////////////////////////////////////
+void BatchEnvironmentPrivate::RequestState(const unsigned int _world,
+    const BatchWorldState &_state)
+{
+  auto &ecm = this->Ecm(_world);
+
+  // The state may come from another world, so its values are written to
+  // this world's entities, which are listed in the same order
+  const auto &entities = this->initialStates[_world];
+  if (entities.jointPositions.size() != _state.jointPositions.size() ||
+      entities.modelPoses.size() != _state.modelPoses.size())
+  {
+    ignerr << "World [" << _world << "] doesn't match the state's entities."
+           << std::endl;
+    return;
+  }
+
+  for (std::size_t j = 0; j < _state.jointPositions.size(); ++j)
+  {
+    auto entity = entities.jointPositions[j].first;
+    ecm.SetComponentData<components::JointPositionReset>(entity,
+        _state.jointPositions[j].second);
+    ecm.SetComponentData<components::JointVelocityReset>(entity,
+        _state.jointVelocities[j]);
+  }
+
+  for (std::size_t j = 0; j < _state.modelPoses.size(); ++j)
+  {
+    ecm.SetComponentData<components::WorldPoseCmd>(
+        entities.modelPoses[j].first, _state.modelPoses[j].second);
+  }
+}
+
+//////////////////////////////////////////////////
+bool BatchEnvironmentPrivate::RunPaused()
+{
+  if (!this->server->RunOnce(true))
+    return false;
+
+  this->GatherObservations();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void BatchEnvironmentPrivate::ScatterActions()
+{
+  // Reused for all commands, so scattering doesn't allocate
+  std::vector<double> cmd(1);
+  for (unsigned int i = 0; i < this->count; ++i)
+  {
+    auto &ecm = this->Ecm(i);
+    const double *values = this->actions.data() + i * this->actionSize;
+    for (const auto &term : this->actionTerms)
+    {
+      cmd[0] = values[term.offset];
+      if (term.type == components::JointForceCmd::typeId)
+      {
+        ecm.SetComponentData<components::JointForceCmd>(term.entities[i],
+            cmd);
+      }
+      else
+      {
+        ecm.SetComponentData<components::JointVelocityCmd>(term.entities[i],
+            cmd);
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void BatchEnvironmentPrivate::GatherObservations()
+{
+  for (unsigned int i = 0; i < this->count; ++i)
+  {
+    const auto &ecm = this->Ecm(i);
+    double *values = this->observations.data() + i * this->observationSize;
+    for (const auto &term : this->observationTerms)
+    {
+      double *value = values + term.offset;
+      auto entity = term.entities[i];
+      if (term.type == components::Pose::typeId)
+      {
+        auto pose = ecm.ComponentData<components::Pose>(entity).value_or(
+            math::Pose3d::Zero);
+        value[0] = pose.Pos().X();
+        value[1] = pose.Pos().Y();
+        value[2] = pose.Pos().Z();
+        value[3] = pose.Rot().W();
+        value[4] = pose.Rot().X();
+        value[5] = pose.Rot().Y();
+        value[6] = pose.Rot().Z();
+        continue;
+      }
+
+      std::optional<std::vector<double>> data;
+      if (term.type == components::JointPosition::typeId)
+        data = ecm.ComponentData<components::JointPosition>(entity);
+      else
+        data = ecm.ComponentData<components::JointVelocity>(entity);
+
+      value[0] = (data && !data->empty()) ? data->front() : 0.0;
+    }
+  }
+}
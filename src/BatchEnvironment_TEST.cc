@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
+
+#include "ignition/gazebo/components/JointForceCmd.hh"
+#include "ignition/gazebo/components/JointPosition.hh"
+#include "ignition/gazebo/components/JointVelocity.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/BatchEnvironment.hh"
+#include "ignition/gazebo/ServerConfig.hh"
+#include "ignition/gazebo/test_config.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+class BatchEnvironmentTest : public ::testing::TestWithParam<int>
+{
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    common::Console::SetVerbosity(4);
+
+    common::setenv("IGN_GAZEBO_SYSTEM_PLUGIN_PATH",
+      common::joinPaths(PROJECT_BINARY_PATH, "lib"));
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_P(BatchEnvironmentTest, InvalidWorld)
+{
+  ServerConfig config;
+  config.SetSdfString("<sdf version='1.6'></sdf>");
+
+  BatchEnvironment env(config, 2);
+  EXPECT_EQ(0u, env.Count());
+  EXPECT_FALSE(env.Step());
+  EXPECT_FALSE(env.Reset());
+  EXPECT_FALSE(env.Reset(0));
+}
+
+/////////////////////////////////////////////////
+TEST_P(BatchEnvironmentTest, StepAndReset)
+{
+  ServerConfig config;
+  config.SetSdfFile(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "revolute_joint.sdf"));
+
+  BatchEnvironment env(config, 2);
+  ASSERT_EQ(2u, env.Count());
+
+  // Invalid terms
+  EXPECT_FALSE(env.AddObservation("revolute_demo::j2",
+      components::Name::typeId));
+  EXPECT_FALSE(env.AddObservation("revolute_demo::missing",
+      components::JointPosition::typeId));
+  EXPECT_FALSE(env.AddAction("revolute_demo::j2",
+      components::JointPosition::typeId));
+
+  EXPECT_TRUE(env.AddObservation("revolute_demo::j2",
+      components::JointPosition::typeId));
+  EXPECT_TRUE(env.AddObservation("revolute_demo::j2",
+      components::JointVelocity::typeId));
+  EXPECT_TRUE(env.AddObservation("revolute_demo",
+      components::Pose::typeId));
+  EXPECT_TRUE(env.AddAction("revolute_demo::j2",
+      components::JointForceCmd::typeId));
+  EXPECT_EQ(9u, env.ObservationSize());
+  EXPECT_EQ(1u, env.ActionSize());
+
+  // Both worlds start in the same state
+  ASSERT_TRUE(env.Reset());
+  const std::vector<double> initial(env.Observations(),
+      env.Observations() + env.ObservationSize());
+  for (std::size_t i = 0; i < env.ObservationSize(); ++i)
+  {
+    EXPECT_DOUBLE_EQ(initial[i],
+        env.Observations()[env.ObservationSize() + i]) << i;
+  }
+  EXPECT_NEAR(0.0, initial[1], 1e-6);
+
+  // Only the first world is pushed
+  env.Actions()[0] = 10.0;
+  env.Actions()[1] = 0.0;
+  ASSERT_TRUE(env.Step(50));
+  const double *obs = env.Observations();
+  EXPECT_GT(std::abs(obs[1] - obs[env.ObservationSize() + 1]), 1e-3);
+
+  // Resetting a single world leaves the other alone
+  const double pushedVel = obs[1];
+  ASSERT_TRUE(env.Reset(1));
+  EXPECT_DOUBLE_EQ(pushedVel, obs[1]);
+  EXPECT_NEAR(initial[0], obs[env.ObservationSize()], 1e-6);
+  EXPECT_NEAR(0.0, obs[env.ObservationSize() + 1], 1e-6);
+
+  // Resetting all worlds restores the initial observations
+  ASSERT_TRUE(env.Reset());
+  for (unsigned int w = 0; w < env.Count(); ++w)
+  {
+    for (std::size_t i = 0; i < env.ObservationSize(); ++i)
+    {
+      EXPECT_NEAR(initial[i], obs[w * env.ObservationSize() + i], 1e-6)
+          << w << " " << i;
+    }
+  }
+
+  EXPECT_FALSE(env.Reset(2));
+}
+
+/////////////////////////////////////////////////
+TEST_P(BatchEnvironmentTest, Fork)
+{
+  ServerConfig config;
+  config.SetSdfFile(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "revolute_joint.sdf"));
+
+  BatchEnvironment env(config, 3);
+  ASSERT_EQ(3u, env.Count());
+
+  EXPECT_TRUE(env.AddObservation("revolute_demo::j2",
+      components::JointPosition::typeId));
+  EXPECT_TRUE(env.AddObservation("revolute_demo::j2",
+      components::JointVelocity::typeId));
+  EXPECT_TRUE(env.AddAction("revolute_demo::j2",
+      components::JointForceCmd::typeId));
+  ASSERT_TRUE(env.Reset());
+
+  // Move the second world away from the others
+  const std::size_t size = env.ObservationSize();
+  env.Actions()[1] = 10.0;
+  ASSERT_TRUE(env.Step(50));
+  const double *obs = env.Observations();
+  EXPECT_GT(std::abs(obs[size + 1] - obs[1]), 1e-3);
+
+  // All worlds continue from the second world's state
+  const double pos = obs[size];
+  const double vel = obs[size + 1];
+  ASSERT_TRUE(env.Fork(1));
+  for (unsigned int w = 0; w < env.Count(); ++w)
+  {
+    EXPECT_NEAR(pos, obs[w * size], 1e-6) << w;
+    EXPECT_NEAR(vel, obs[w * size + 1], 1e-6) << w;
+  }
+
+  // Branches diverge with different actions
+  env.Actions()[0] = 10.0;
+  env.Actions()[1] = 0.0;
+  env.Actions()[2] = -10.0;
+  ASSERT_TRUE(env.Step(20));
+  EXPECT_GT(obs[1], obs[size + 1]);
+  EXPECT_GT(obs[size + 1], obs[2 * size + 1]);
+
+  EXPECT_FALSE(env.Fork(3));
+}
+
+// Run multiple times
+INSTANTIATE_TEST_SUITE_P(ServerRepeat, BatchEnvironmentTest,
+    ::testing::Range(1, 2));
@@ -0,0 +1,671 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "Checkpoint.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+
+using namespace ignition;
+using namespace gazebo;
+
+namespace
+{
+/// \brief Identifies checkpoint files, and their version.
+constexpr char kMagic[8] = {'I', 'G', 'N', 'C', 'K', 'P', 'T', '1'};
+
+/// \brief Size of a page. The two headers are on their own pages.
+constexpr uint64_t kPageSize{4096};
+
+/// \brief Offset of the first block, after the two headers.
+constexpr uint64_t kDataOffset{2 * kPageSize};
+
+/// \brief Size class of the smallest blocks, 64 bytes.
+constexpr unsigned int kMinSizeClass{6};
+
+/// \brief Size of a new file.
+constexpr uint64_t kInitialSize{uint64_t{1} << 20};
+
+/// \brief Written in host byte order, checkpoints are read on the host
+/// which wrote them. The header of generation N is written on page N % 2,
+/// so a header torn while it's written leaves the previous one.
+struct Header
+{
+  /// \brief kMagic.
+  char magic[8];
+
+  /// \brief Incremented on each checkpoint, 0 if never written.
+  uint64_t generation;
+
+  /// \brief Simulation time, in nanoseconds.
+  int64_t simTime;
+
+  /// \brief Iteration count.
+  uint64_t iterations;
+
+  /// \brief Offset of the index block.
+  uint64_t indexOffset;
+
+  /// \brief Number of entries in the index block.
+  uint64_t indexCount;
+
+  /// \brief Checksum of the fields above.
+  uint64_t checksum;
+};
+
+/// \brief Location of the block of an entity.
+struct IndexEntry
+{
+  /// \brief Entity ID.
+  uint64_t entity;
+
+  /// \brief Offset of the serialized msgs::SerializedEntityMap.
+  uint64_t offset;
+
+  /// \brief Size of the serialized message.
+  uint64_t size;
+};
+
+/// \brief A block of the file.
+struct Block
+{
+  /// \brief Offset in the file.
+  uint64_t offset{0};
+
+  /// \brief Size of the data in the block.
+  uint64_t size{0};
+
+  /// \brief The block has room for 2^sizeClass bytes. 0 if there's no
+  /// block.
+  unsigned int sizeClass{0};
+};
+
+//////////////////////////////////////////////////
+/// \brief FNV-1a checksum of a header.
+/// \param[in] _header Header.
+/// \return Checksum of the fields before the checksum.
+uint64_t checksum(const Header &_header)
+{
+  const auto *bytes = reinterpret_cast<const unsigned char *>(&_header);
+  uint64_t hash{14695981039346656037ull};
+  for (std::size_t i = 0; i < offsetof(Header, checksum); ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the size class of a block, the smallest power of two which
+/// holds the given size.
+/// \param[in] _size Size of the data.
+/// \return Size class.
+unsigned int sizeClass(uint64_t _size)
+{
+  unsigned int result{kMinSizeClass};
+  while ((uint64_t{1} << result) < _size)
+    ++result;
+  return result;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the serialized size of a message.
+/// \param[in] _msg Message.
+/// \return Size in bytes.
+uint64_t byteSize(const google::protobuf::Message &_msg)
+{
+#if GOOGLE_PROTOBUF_VERSION >= 3004000
+  return _msg.ByteSizeLong();
+#else
+  return _msg.ByteSize();
+#endif
+}
+
+//////////////////////////////////////////////////
+/// \brief Read the state a header points to.
+/// \param[in] _data Contents of the file.
+/// \param[in] _size Size of the file.
+/// \param[in] _header Header of the checkpoint.
+/// \param[out] _state State to populate.
+/// \return False if the checkpoint is corrupted.
+bool readState(const char *_data, uint64_t _size, const Header &_header,
+    msgs::SerializedStateMap &_state)
+{
+  _state.Clear();
+  if (_header.indexOffset < kDataOffset || _header.indexOffset > _size ||
+      _header.indexCount > (_size - _header.indexOffset) / sizeof(IndexEntry))
+  {
+    return false;
+  }
+
+  for (uint64_t i = 0; i < _header.indexCount; ++i)
+  {
+    IndexEntry entry;
+    std::memcpy(&entry,
+        _data + _header.indexOffset + i * sizeof(IndexEntry), sizeof(entry));
+    if (entry.offset < kDataOffset || entry.offset > _size ||
+        entry.size > _size - entry.offset)
+    {
+      return false;
+    }
+
+    auto &entityMsg = (*_state.mutable_entities())[entry.entity];
+    if (!entityMsg.ParseFromArray(_data + entry.offset,
+        static_cast<int>(entry.size)))
+    {
+      return false;
+    }
+  }
+
+  auto header = _state.mutable_header();
+  header->mutable_stamp()->set_sec(_header.simTime / 1000000000);
+  header->mutable_stamp()->set_nsec(_header.simTime % 1000000000);
+  auto data = header->add_data();
+  data->set_key("iteration");
+  data->add_value(std::to_string(_header.iterations));
+  return true;
+}
+}
+
+/// \brief Private data class.
+class ignition::gazebo::CheckpointPrivate
+{
+  /// \brief Write the queued checkpoints, on the background thread.
+  public: void Run();
+
+  /// \brief Write a checkpoint.
+  /// \param[in] _state Checkpoint, see Checkpoint::Write.
+  /// \return False if writing failed.
+  public: bool WriteState(const msgs::SerializedStateMap &_state);
+
+  /// \brief Create a new file to write to.
+  /// \return False if it couldn't be created.
+  public: bool Open();
+
+  /// \brief Grow the file, and map it again, if it's smaller than a size.
+  /// \param[in] _size Minimum size.
+  /// \return False if the file couldn't be grown.
+  public: bool Reserve(uint64_t _size);
+
+  /// \brief Allocate a block, reusing blocks freed by previous checkpoints
+  /// before growing the file.
+  /// \param[in] _size Size of the data.
+  /// \return The block, with a size class of 0 if the file couldn't be
+  /// grown.
+  public: Block Allocate(uint64_t _size);
+
+  /// \brief Flush the blocks, then write a header pointing to them.
+  /// \param[in] _header Header, without the generation nor the checksum.
+  /// \return False if writing failed.
+  public: bool Commit(Header &_header);
+
+  /// \brief Unmap and close the file.
+  public: void Close();
+
+  /// \brief Path of the checkpoint file.
+  public: std::string path;
+
+  /// \brief Path the first checkpoint is written to, before it's renamed
+  /// to the checkpoint path. This keeps the previous file until a new
+  /// checkpoint is complete.
+  public: std::string tmpPath;
+
+  /// \brief Whether the file was renamed to the checkpoint path.
+  public: bool renamed{false};
+
+#ifdef _WIN32
+  /// \brief Contents of the file, written as a whole on each commit.
+  public: std::vector<char> buffer;
+#else
+  /// \brief File descriptor of the file.
+  public: int fd{-1};
+#endif
+
+  /// \brief Mapped contents of the file.
+  public: char *data{nullptr};
+
+  /// \brief Size of the file.
+  public: uint64_t size{0};
+
+  /// \brief End of the allocated blocks.
+  public: uint64_t end{kDataOffset};
+
+  /// \brief Offsets of the free blocks, by size class.
+  public: std::vector<std::vector<uint64_t>> freeBlocks;
+
+  /// \brief Blocks which the latest committed checkpoint points to, but
+  /// the one being written doesn't. They're freed once it's committed.
+  public: std::vector<Block> releasedBlocks;
+
+  /// \brief Block of each entity, by entity ID.
+  public: std::unordered_map<uint64_t, Block> blocks;
+
+  /// \brief Block of the index.
+  public: Block index;
+
+  /// \brief Generation of the latest committed checkpoint.
+  public: uint64_t generation{0};
+
+  /// \brief Whether writing failed. Later checkpoints are dropped.
+  public: bool failed{false};
+
+  /// \brief Protects the members below.
+  public: std::mutex mutex;
+
+  /// \brief Signals changes of the members below.
+  public: std::condition_variable cv;
+
+  /// \brief Checkpoint waiting to be written.
+  public: std::unique_ptr<msgs::SerializedStateMap> pending;
+
+  /// \brief Whether a checkpoint is being written.
+  public: bool busy{false};
+
+  /// \brief Whether the thread should exit.
+  public: bool stop{false};
+
+  /// \brief Background thread writing the checkpoints.
+  public: std::thread thread;
+};
+
+//////////////////////////////////////////////////
+Checkpoint::Checkpoint(const std::string &_path)
+  : dataPtr(std::make_unique<CheckpointPrivate>())
+{
+  this->dataPtr->path = _path;
+  this->dataPtr->tmpPath = _path + ".tmp";
+  this->dataPtr->thread = std::thread(&CheckpointPrivate::Run,
+      this->dataPtr.get());
+}
+
+//////////////////////////////////////////////////
+Checkpoint::~Checkpoint()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->cv.notify_all();
+  this->dataPtr->thread.join();
+  this->dataPtr->Close();
+}
+
+//////////////////////////////////////////////////
+void Checkpoint::Write(std::unique_ptr<msgs::SerializedStateMap> _state)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto &pending = this->dataPtr->pending;
+    if (!pending)
+    {
+      pending = std::move(_state);
+    }
+    else
+    {
+      // Entities hold all their components, so newer ones replace older
+      for (auto &entity : *_state->mutable_entities())
+        (*pending->mutable_entities())[entity.first].Swap(&entity.second);
+      pending->mutable_header()->Swap(_state->mutable_header());
+    }
+  }
+  this->dataPtr->cv.notify_all();
+}
+
+//////////////////////////////////////////////////
+void Checkpoint::Flush()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->cv.wait(lock, [this]
+      {
+        return !this->dataPtr->pending && !this->dataPtr->busy;
+      });
+}
+
+//////////////////////////////////////////////////
+bool Checkpoint::Read(const std::string &_path,
+    msgs::SerializedStateMap &_state)
+{
+  const char *data{nullptr};
+  uint64_t size{0};
+
+#ifdef _WIN32
+  std::ifstream file(_path, std::ios::binary);
+  if (!file)
+    return false;
+  std::vector<char> buffer((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  data = buffer.data();
+  size = buffer.size();
+#else
+  int fd = open(_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat info;
+  void *addr{MAP_FAILED};
+  if (fstat(fd, &info) == 0 &&
+      static_cast<uint64_t>(info.st_size) >= kDataOffset)
+  {
+    addr = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+
+  if (MAP_FAILED == addr)
+    return false;
+  data = static_cast<const char *>(addr);
+  size = info.st_size;
+#endif
+
+  // Try the valid headers, newest first
+  std::vector<Header> headers;
+  for (uint64_t page = 0; page < 2 && size >= kDataOffset; ++page)
+  {
+    Header header;
+    std::memcpy(&header, data + page * kPageSize, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+        header.generation > 0 && header.checksum == checksum(header))
+    {
+      headers.push_back(header);
+    }
+  }
+  std::sort(headers.begin(), headers.end(),
+      [](const Header &_a, const Header &_b)
+      {
+        return _a.generation > _b.generation;
+      });
+
+  bool result{false};
+  for (const auto &header : headers)
+  {
+    result = readState(data, size, header, _state);
+    if (result)
+      break;
+
+    ignwarn << "Checkpoint [" << header.generation << "] of [" << _path
+            << "] is corrupted." << std::endl;
+  }
+
+#ifndef _WIN32
+  munmap(const_cast<char *>(data), size);
+#endif
+  return result;
+}
+
+//////////////////////////////////////////////////
+void CheckpointPrivate::Run()
+{
+  while (true)
+  {
+    std::unique_ptr<msgs::SerializedStateMap> state;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->cv.wait(lock, [this]
+          {
+            return this->stop || this->pending;
+          });
+      if (!this->pending)
+        return;
+
+      state = std::move(this->pending);
+      this->busy = true;
+    }
+
+    if (!this->failed && !this->WriteState(*state))
+    {
+      ignerr << "Failed to write checkpoint [" << this->path
+             << "], no more checkpoints will be written." << std::endl;
+      this->failed = true;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->busy = false;
+    }
+    this->cv.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+bool CheckpointPrivate::WriteState(const msgs::SerializedStateMap &_state)
+{
+  IGN_PROFILE("Checkpoint::WriteState");
+
+  if (nullptr == this->data && !this->Open())
+    return false;
+
+  // Write the changed entities to new blocks, so the blocks of the latest
+  // checkpoint stay intact until the header points to the new ones
+  for (const auto &entity : _state.entities())
+  {
+    auto it = this->blocks.find(entity.first);
+    if (it != this->blocks.end())
+    {
+      this->releasedBlocks.push_back(it->second);
+      this->blocks.erase(it);
+    }
+
+    if (entity.second.remove())
+      continue;
+
+    Block block = this->Allocate(byteSize(entity.second));
+    if (0 == block.sizeClass ||
+        !entity.second.SerializeToArray(this->data + block.offset,
+            static_cast<int>(block.size)))
+    {
+      return false;
+    }
+    this->blocks[entity.first] = block;
+  }
+
+  std::vector<IndexEntry> entries;
+  entries.reserve(this->blocks.size());
+  for (const auto &block : this->blocks)
+    entries.push_back({block.first, block.second.offset, block.second.size});
+
+  if (this->index.sizeClass != 0)
+    this->releasedBlocks.push_back(this->index);
+  this->index = this->Allocate(entries.size() * sizeof(IndexEntry));
+  if (0 == this->index.sizeClass)
+    return false;
+  if (!entries.empty())
+  {
+    std::memcpy(this->data + this->index.offset, entries.data(),
+        this->index.size);
+  }
+
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  header.simTime = static_cast<int64_t>(_state.header().stamp().sec()) *
+      1000000000 + _state.header().stamp().nsec();
+  for (const auto &data : _state.header().data())
+  {
+    if (data.key() == "iteration" && data.value_size() > 0)
+      header.iterations = std::stoull(data.value(0));
+  }
+  header.indexOffset = this->index.offset;
+  header.indexCount = entries.size();
+  if (!this->Commit(header))
+    return false;
+
+  // The previous checkpoint's blocks can now be reused
+  for (const auto &block : this->releasedBlocks)
+  {
+    if (block.sizeClass >= this->freeBlocks.size())
+      this->freeBlocks.resize(block.sizeClass + 1);
+    this->freeBlocks[block.sizeClass].push_back(block.offset);
+  }
+  this->releasedBlocks.clear();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool CheckpointPrivate::Open()
+{
+#ifndef _WIN32
+  this->fd = open(this->tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (this->fd < 0)
+  {
+    ignerr << "Failed to create checkpoint [" << this->tmpPath << "]: "
+           << std::strerror(errno) << std::endl;
+    return false;
+  }
+#endif
+  return this->Reserve(kInitialSize);
+}
+
+//////////////////////////////////////////////////
+bool CheckpointPrivate::Reserve(uint64_t _size)
+{
+  if (_size <= this->size)
+    return true;
+
+  // Grow geometrically, in whole pages
+  uint64_t newSize = std::max(_size, this->size * 2);
+  newSize = (newSize + kPageSize - 1) / kPageSize * kPageSize;
+
+#ifdef _WIN32
+  this->buffer.resize(newSize, 0);
+  this->data = this->buffer.data();
+#else
+  if (ftruncate(this->fd, static_cast<off_t>(newSize)) != 0)
+  {
+    ignerr << "Failed to grow checkpoint [" << this->path << "] to ["
+           << newSize << "] bytes: " << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  void *addr = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+      this->fd, 0);
+  if (MAP_FAILED == addr)
+  {
+    ignerr << "Failed to map checkpoint [" << this->path << "]: "
+           << std::strerror(errno) << std::endl;
+    return false;
+  }
+  if (nullptr != this->data)
+    munmap(this->data, this->size);
+  this->data = static_cast<char *>(addr);
+#endif
+
+  this->size = newSize;
+  return true;
+}
+
+//////////////////////////////////////////////////
+Block CheckpointPrivate::Allocate(uint64_t _size)
+{
+  Block block;
+  block.size = _size;
+  block.sizeClass = sizeClass(_size);
+
+  if (block.sizeClass < this->freeBlocks.size() &&
+      !this->freeBlocks[block.sizeClass].empty())
+  {
+    block.offset = this->freeBlocks[block.sizeClass].back();
+    this->freeBlocks[block.sizeClass].pop_back();
+    return block;
+  }
+
+  const uint64_t capacity = uint64_t{1} << block.sizeClass;
+  if (!this->Reserve(this->end + capacity))
+  {
+    block.sizeClass = 0;
+    return block;
+  }
+  block.offset = this->end;
+  this->end += capacity;
+  return block;
+}
+
+//////////////////////////////////////////////////
+bool CheckpointPrivate::Commit(Header &_header)
+{
+  std::memcpy(_header.magic, kMagic, sizeof(kMagic));
+  _header.generation = this->generation + 1;
+  _header.checksum = checksum(_header);
+
+#ifdef _WIN32
+  // Without a mapping, write the whole file and replace the previous one
+  std::memcpy(this->data + (_header.generation % 2) * kPageSize, &_header,
+      sizeof(_header));
+  {
+    std::ofstream file(this->tmpPath, std::ios::binary | std::ios::trunc);
+    file.write(this->data, static_cast<std::streamsize>(this->end));
+    if (!file)
+      return false;
+  }
+  std::remove(this->path.c_str());
+  if (std::rename(this->tmpPath.c_str(), this->path.c_str()) != 0)
+    return false;
+#else
+  // Only the pages touched since the previous checkpoint are written back
+  if (msync(this->data, this->size, MS_SYNC) != 0)
+    return false;
+
+  std::memcpy(this->data + (_header.generation % 2) * kPageSize, &_header,
+      sizeof(_header));
+  if (msync(this->data, kDataOffset, MS_SYNC) != 0)
+    return false;
+
+  if (!this->renamed)
+  {
+    if (std::rename(this->tmpPath.c_str(), this->path.c_str()) != 0)
+      return false;
+    this->renamed = true;
+  }
+#endif
+
+  this->generation = _header.generation;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void CheckpointPrivate::Close()
+{
+#ifdef _WIN32
+  this->buffer.clear();
+#else
+  if (nullptr != this->data)
+    munmap(this->data, this->size);
+  if (this->fd >= 0)
+    close(this->fd);
+  this->fd = -1;
+#endif
+  this->data = nullptr;
+  this->size = 0;
+}
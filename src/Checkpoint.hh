@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_CHECKPOINT_HH_
+#define IGNITION_GAZEBO_CHECKPOINT_HH_
+
+#include <ignition/msgs/serialized_map.pb.h>
+
+#include <memory>
+#include <string>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declaration
+    class CheckpointPrivate;
+
+    /// \class Checkpoint Checkpoint.hh
+    /// \brief Crash-recovery checkpoints of the state of a world, kept in a
+    /// memory-mapped file.
+    ///
+    /// Each entity is stored as its own serialized block, so a checkpoint
+    /// only rewrites the blocks of the entities which changed since the
+    /// previous one, and the OS only writes back the pages they touched.
+    /// Changed blocks are written to free space instead of over the blocks
+    /// of the latest checkpoint, which becomes free once the new one is
+    /// committed by a header, so the file always holds a complete
+    /// checkpoint, even if the process dies while writing.
+    ///
+    /// Writes happen on a background thread. On Windows, the file isn't
+    /// mapped, and is rewritten as a whole on each checkpoint.
+    class IGNITION_GAZEBO_VISIBLE Checkpoint
+    {
+      /// \brief Constructor. The file isn't touched until the first write,
+      /// so a previous checkpoint can still be read.
+      /// \param[in] _path Path of the file.
+      public: explicit Checkpoint(const std::string &_path);
+
+      /// \brief Destructor. Waits for pending writes.
+      public: ~Checkpoint();
+
+      /// \brief Queue a checkpoint to be written in the background. If the
+      /// previous one wasn't written yet, the two are merged.
+      /// \param[in] _state Entities which changed since the previous
+      /// checkpoint, with all their components, or with remove set if they
+      /// were removed. The first checkpoint must hold all entities, and
+      /// replaces the previous contents of the file. The header stamp holds
+      /// the simulation time, and the header data holds the iteration count
+      /// with the key "iteration", as in SimulationRunner::Snapshot.
+      public: void Write(std::unique_ptr<msgs::SerializedStateMap> _state);
+
+      /// \brief Wait until all queued checkpoints are written.
+      public: void Flush();
+
+      /// \brief Read the latest complete checkpoint of a file.
+      /// \param[in] _path Path of the file.
+      /// \param[out] _state Full state of the world, with the header set as
+      /// when it was written.
+      /// \return True if a checkpoint was read.
+      public: static bool Read(const std::string &_path,
+                  msgs::SerializedStateMap &_state);
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<CheckpointPrivate> dataPtr;
+    };
+    }  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
+  }  // namespace gazebo
+}  // namespace ignition
+
+#endif  // IGNITION_GAZEBO_CHECKPOINT_HH_
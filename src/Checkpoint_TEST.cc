@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "Checkpoint.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+/// \brief Create a checkpoint.
+/// \param[in] _sec Simulation time, in seconds.
+/// \param[in] _iteration Iteration count.
+/// \return The checkpoint, without entities.
+std::unique_ptr<msgs::SerializedStateMap> makeState(int _sec,
+    uint64_t _iteration)
+{
+  auto state = std::make_unique<msgs::SerializedStateMap>();
+  state->mutable_header()->mutable_stamp()->set_sec(_sec);
+  auto data = state->mutable_header()->add_data();
+  data->set_key("iteration");
+  data->add_value(std::to_string(_iteration));
+  return state;
+}
+
+/////////////////////////////////////////////////
+/// \brief Add an entity with one component to a checkpoint.
+/// \param[in] _state Checkpoint.
+/// \param[in] _entity Entity ID.
+/// \param[in] _data Serialized component.
+void addEntity(msgs::SerializedStateMap &_state, uint64_t _entity,
+    const std::string &_data)
+{
+  auto &entity = (*_state.mutable_entities())[_entity];
+  entity.set_id(_entity);
+  auto &comp = (*entity.mutable_components())[1];
+  comp.set_type(1);
+  comp.set_component(_data);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the serialized component of an entity in a checkpoint.
+/// \param[in] _state Checkpoint.
+/// \param[in] _entity Entity ID.
+/// \return The component, empty if the entity isn't there.
+std::string component(const msgs::SerializedStateMap &_state,
+    uint64_t _entity)
+{
+  auto it = _state.entities().find(_entity);
+  if (it == _state.entities().end())
+    return "";
+  return it->second.components().at(1).component();
+}
+
+/////////////////////////////////////////////////
+TEST(Checkpoint, WriteRead)
+{
+  const std::string path{"Checkpoint_TEST.ckpt"};
+  std::remove(path.c_str());
+
+  msgs::SerializedStateMap state;
+  EXPECT_FALSE(Checkpoint::Read(path, state));
+
+  {
+    Checkpoint checkpoint(path);
+
+    // Full checkpoint
+    auto full = makeState(1, 1000);
+    addEntity(*full, 1, "world");
+    addEntity(*full, 2, "model");
+    addEntity(*full, 3, std::string(10000, 'x'));
+    checkpoint.Write(std::move(full));
+    checkpoint.Flush();
+
+    ASSERT_TRUE(Checkpoint::Read(path, state));
+    EXPECT_EQ(1, state.header().stamp().sec());
+    ASSERT_EQ(1, state.header().data_size());
+    EXPECT_EQ("1000", state.header().data(0).value(0));
+    EXPECT_EQ(3, state.entities_size());
+    EXPECT_EQ("model", component(state, 2));
+    EXPECT_EQ(10000u, component(state, 3).size());
+
+    // Only changes, merged if written before the previous one is done
+    auto changed = makeState(2, 2000);
+    addEntity(*changed, 2, "moved model");
+    auto removed = makeState(3, 3000);
+    (*removed->mutable_entities())[3].set_remove(true);
+    addEntity(*removed, 4, "new model");
+    checkpoint.Write(std::move(changed));
+    checkpoint.Write(std::move(removed));
+    checkpoint.Flush();
+  }
+
+  ASSERT_TRUE(Checkpoint::Read(path, state));
+  EXPECT_EQ(3, state.header().stamp().sec());
+  EXPECT_EQ("3000", state.header().data(0).value(0));
+  EXPECT_EQ(3, state.entities_size());
+  EXPECT_EQ("world", component(state, 1));
+  EXPECT_EQ("moved model", component(state, 2));
+  EXPECT_EQ("", component(state, 3));
+  EXPECT_EQ("new model", component(state, 4));
+
+  // A new writer replaces the file once its first checkpoint is complete
+  {
+    Checkpoint checkpoint(path);
+    ASSERT_TRUE(Checkpoint::Read(path, state));
+    EXPECT_EQ(3, state.entities_size());
+
+    auto full = makeState(4, 4000);
+    addEntity(*full, 1, "world");
+    checkpoint.Write(std::move(full));
+  }
+  ASSERT_TRUE(Checkpoint::Read(path, state));
+  EXPECT_EQ(4, state.header().stamp().sec());
+  EXPECT_EQ(1, state.entities_size());
+
+  std::remove(path.c_str());
+}
+
+/////////////////////////////////////////////////
+TEST(Checkpoint, TornHeader)
+{
+  const std::string path{"Checkpoint_TEST_torn.ckpt"};
+  std::remove(path.c_str());
+
+  {
+    Checkpoint checkpoint(path);
+    auto first = makeState(1, 1000);
+    addEntity(*first, 1, "first");
+    checkpoint.Write(std::move(first));
+    checkpoint.Flush();
+
+    auto second = makeState(2, 2000);
+    addEntity(*second, 1, "second");
+    checkpoint.Write(std::move(second));
+  }
+
+  // Corrupt the newest header, on the first page, as if the process died
+  // while writing it
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in |
+        std::ios::out);
+    file.seekp(20);
+    file.put('\xff');
+  }
+
+  // The previous checkpoint is still intact
+  msgs::SerializedStateMap state;
+  ASSERT_TRUE(Checkpoint::Read(path, state));
+  EXPECT_EQ(1, state.header().stamp().sec());
+  EXPECT_EQ("first", component(state, 1));
+
+  // Nothing valid left
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << std::string(10000, '\0');
+  }
+  EXPECT_FALSE(Checkpoint::Read(path, state));
+
+  std::remove(path.c_str());
+}
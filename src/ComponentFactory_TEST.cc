@@ -16,6 +16,7 @@
 */
 
 #include <gtest/gtest.h>
+#include <sstream>
 #include "ignition/gazebo/test_config.hh"
 #include "ignition/gazebo/components/Component.hh"
 #include "ignition/gazebo/components/Factory.hh"
@@ -91,6 +92,41 @@ TEST_F(ComponentFactoryTest, Register)
   EXPECT_EQ("", factory->Name(MyCustom::typeId));
 }
 
+/////////////////////////////////////////////////
+TEST_F(ComponentFactoryTest, TypeIndex)
+{
+  auto factory = components::Factory::Instance();
+
+  using MyIndexed = components::Component<components::NoData,
+      class MyIndexedTag>;
+  EXPECT_EQ(0u, MyIndexed::typeIndex);
+
+  factory->Register<MyIndexed>("ign_gazebo_components.MyIndexed",
+      new components::ComponentDescriptor<MyIndexed>(),
+      new components::StorageDescriptor<MyIndexed>());
+
+  // Indices are dense and unique
+  const auto index = MyIndexed::typeIndex;
+  EXPECT_NE(0u, index);
+  EXPECT_LT(index, factory->TypeIndexCount());
+  EXPECT_EQ(index, factory->TypeIndex(MyIndexed::typeId));
+  EXPECT_NE(0u, components::Pose::typeIndex);
+  EXPECT_NE(index, components::Pose::typeIndex);
+  EXPECT_EQ(0u, factory->TypeIndex(123456789u));
+
+  // The index is kept for the type if it's registered again
+  const auto typeId = MyIndexed::typeId;
+  factory->Unregister<MyIndexed>();
+  EXPECT_EQ(0u, MyIndexed::typeIndex);
+  EXPECT_EQ(index, factory->TypeIndex(typeId));
+
+  factory->Register<MyIndexed>("ign_gazebo_components.MyIndexed",
+      new components::ComponentDescriptor<MyIndexed>(),
+      new components::StorageDescriptor<MyIndexed>());
+  EXPECT_EQ(index, MyIndexed::typeIndex);
+  factory->Unregister<MyIndexed>();
+}
+
 /////////////////////////////////////////////////
 TEST_F(ComponentFactoryTest, New)
 {
@@ -127,3 +163,42 @@ TEST_F(ComponentFactoryTest, New)
   }
 }
 
+
+/////////////////////////////////////////////////
+TEST_F(ComponentFactoryTest, DeserializeInPlace)
+{
+  auto storage = components::Factory::Instance()->NewStorage(
+      components::Pose::typeId);
+  ASSERT_NE(nullptr, storage);
+
+  std::ostringstream ostr;
+  components::Pose(math::Pose3d(1, 2, 3, 0, 0, 0)).Serialize(ostr);
+
+  // New component
+  std::istringstream istr(ostr.str());
+  auto created = storage->DeserializeInPlace(kComponentIdInvalid, istr);
+  ASSERT_NE(kComponentIdInvalid, created.first);
+  EXPECT_EQ(1u, storage->Size());
+
+  auto comp = static_cast<const components::Pose *>(
+      storage->Component(created.first));
+  ASSERT_NE(nullptr, comp);
+  EXPECT_EQ(math::Pose3d(1, 2, 3, 0, 0, 0), comp->Data());
+
+  // Existing component
+  ostr.str("");
+  components::Pose(math::Pose3d(4, 5, 6, 0, 0, 0)).Serialize(ostr);
+  istr.clear();
+  istr.str(ostr.str());
+  auto updated = storage->DeserializeInPlace(created.first, istr);
+  EXPECT_EQ(created.first, updated.first);
+  EXPECT_FALSE(updated.second);
+  EXPECT_EQ(1u, storage->Size());
+  EXPECT_EQ(math::Pose3d(4, 5, 6, 0, 0, 0), comp->Data());
+
+  // Missing component
+  istr.clear();
+  istr.str(ostr.str());
+  EXPECT_EQ(kComponentIdInvalid,
+      storage->DeserializeInPlace(created.first + 1, istr).first);
+}
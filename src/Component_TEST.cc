@@ -19,14 +19,21 @@
 #include <ignition/msgs/int32.pb.h>
 
 #include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include <sdf/Element.hh>
 #include <ignition/common/Console.hh>
 #include <ignition/math/Inertial.hh>
 
 #include "ignition/gazebo/components/Component.hh"
+#include "ignition/gazebo/components/JointPosition.hh"
+#include "ignition/gazebo/components/LinearVelocity.hh"
 #include "ignition/gazebo/components/Serialization.hh"
+#include "ignition/gazebo/components/SharedComponent.hh"
 #include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 
 using namespace ignition;
@@ -501,6 +508,109 @@ TEST_F(ComponentTest, IStream)
   }
 }
 
+//////////////////////////////////////////////////
+TEST_F(ComponentTest, Binary)
+{
+  // Pose
+  {
+    components::Pose comp(math::Pose3d(1, 2, 3, 0.1, 0.2, 0.3));
+    std::string buffer;
+    EXPECT_TRUE(comp.SerializeBinary(buffer));
+    EXPECT_EQ(7 * sizeof(double), buffer.size());
+
+    components::Pose other;
+    EXPECT_TRUE(other.DeserializeBinary(buffer));
+    EXPECT_EQ(comp.Data(), other.Data());
+
+    // Truncated data leaves the component unchanged
+    components::Pose truncated(math::Pose3d(4, 5, 6, 0, 0, 0));
+    EXPECT_FALSE(truncated.DeserializeBinary(buffer.substr(0, 10)));
+    EXPECT_EQ(math::Pose3d(4, 5, 6, 0, 0, 0), truncated.Data());
+
+    // Trailing data is rejected
+    EXPECT_FALSE(truncated.DeserializeBinary(buffer + "x"));
+  }
+
+  // Vector3d, appending to an existing buffer
+  {
+    components::LinearVelocity comp(math::Vector3d(-1, 0.5, 10));
+    std::string buffer;
+    EXPECT_TRUE(comp.SerializeBinary(buffer));
+    EXPECT_TRUE(comp.SerializeBinary(buffer));
+    EXPECT_EQ(6 * sizeof(double), buffer.size());
+
+    components::LinearVelocity other;
+    EXPECT_TRUE(other.DeserializeBinary(buffer.substr(0, buffer.size() / 2)));
+    EXPECT_EQ(comp.Data(), other.Data());
+  }
+
+  // Vector of doubles, with a custom stream serializer
+  {
+    components::JointPosition comp({0.1, -2.0, 3.5});
+    std::string buffer;
+    EXPECT_TRUE(comp.SerializeBinary(buffer));
+
+    components::JointPosition other;
+    EXPECT_TRUE(other.DeserializeBinary(buffer));
+    EXPECT_EQ(comp.Data(), other.Data());
+
+    // Size larger than the data
+    buffer[0] = 100;
+    EXPECT_FALSE(other.DeserializeBinary(buffer));
+    EXPECT_EQ(comp.Data(), other.Data());
+  }
+
+  // Vector of bools, which has no contiguous data
+  {
+    using Custom = components::Component<std::vector<bool>, class CustomTag>;
+    Custom comp({true, false, false, true, true});
+    std::string buffer;
+    EXPECT_TRUE(comp.SerializeBinary(buffer));
+    EXPECT_EQ(sizeof(uint64_t) + 5, buffer.size());
+
+    Custom other;
+    EXPECT_TRUE(other.DeserializeBinary(buffer));
+    EXPECT_EQ(comp.Data(), other.Data());
+
+    // Size larger than the data
+    buffer[0] = 100;
+    EXPECT_FALSE(other.DeserializeBinary(buffer));
+    EXPECT_EQ(comp.Data(), other.Data());
+  }
+
+  // Arithmetic types
+  {
+    using Custom = components::Component<int, class CustomTag>;
+    Custom comp(-123);
+    std::string buffer;
+    EXPECT_TRUE(comp.SerializeBinary(buffer));
+
+    Custom other;
+    EXPECT_TRUE(other.DeserializeBinary(buffer));
+    EXPECT_EQ(-123, other.Data());
+  }
+
+  // Types without binary support
+  {
+    components::Name comp("name");
+    std::string buffer{"unchanged"};
+    EXPECT_FALSE(comp.SerializeBinary(buffer));
+    EXPECT_EQ("unchanged", buffer);
+    EXPECT_FALSE(comp.DeserializeBinary(buffer));
+    EXPECT_EQ("name", comp.Data());
+  }
+
+  // Component without data
+  {
+    using Custom = components::Component<components::NoData, class CustomTag>;
+    Custom comp;
+    std::string buffer;
+    EXPECT_TRUE(comp.SerializeBinary(buffer));
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_TRUE(comp.DeserializeBinary(buffer));
+  }
+}
+
 //////////////////////////////////////////////////
 TEST_F(ComponentTest, TypeId)
 {
@@ -548,3 +658,61 @@ TEST_F(ComponentTest, TypeName)
     EXPECT_EQ("123456", comp.typeName);
   }
 }
+
+//////////////////////////////////////////////////
+TEST_F(ComponentTest, SharedComponent)
+{
+  using Custom = components::SharedComponent<std::string, class SharedTag>;
+  auto eql = [](const std::string &_a, const std::string &_b)
+  {
+    return _a == _b;
+  };
+
+  // Equal values share their data
+  Custom comp1(std::string("shared"));
+  Custom comp2(std::string("shared"));
+  Custom comp3(std::string("other"));
+  EXPECT_TRUE(comp1.SharesData(comp2));
+  EXPECT_FALSE(comp1.SharesData(comp3));
+  EXPECT_EQ(comp1, comp2);
+  EXPECT_NE(comp1, comp3);
+
+  // Copies share their data
+  Custom copy(comp1);
+  EXPECT_TRUE(copy.SharesData(comp1));
+
+  // Default constructed components share the default value
+  Custom default1;
+  Custom default2;
+  EXPECT_TRUE(default1.SharesData(default2));
+  EXPECT_TRUE(default1.Data().empty());
+
+  // Setting data only changes the component being set
+  EXPECT_FALSE(comp2.SetData("shared", eql));
+  EXPECT_TRUE(comp2.SetData("other", eql));
+  EXPECT_EQ("other", comp2.Data());
+  EXPECT_EQ("shared", comp1.Data());
+  EXPECT_TRUE(comp2.SharesData(comp3));
+
+  // Mutating data copies it first, even if no other component holds it
+  copy.Data() = "changed";
+  EXPECT_EQ("changed", copy.Data());
+  EXPECT_EQ("shared", comp1.Data());
+  EXPECT_FALSE(copy.SharesData(comp1));
+
+  comp1.Data() = "changed too";
+  Custom comp4(std::string("shared"));
+  EXPECT_EQ("shared", comp4.Data());
+  EXPECT_FALSE(comp4.SharesData(comp1));
+
+  // Deserialized data is interned
+  std::istringstream istr("other");
+  Custom deserialized;
+  deserialized.Deserialize(istr);
+  EXPECT_EQ("other", deserialized.Data());
+  EXPECT_TRUE(deserialized.SharesData(comp3));
+
+  std::ostringstream ostr;
+  deserialized.Serialize(ostr);
+  EXPECT_EQ("other", ostr.str());
+}
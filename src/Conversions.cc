@@ -125,7 +125,7 @@ msgs::Collision ignition::gazebo::convert(const sdf::Collision &_in)
   msgs::Collision out;
   out.set_name(_in.Name());
   msgs::Set(out.mutable_pose(), _in.RawPose());
-  out.mutable_geometry()->CopyFrom(convert<msgs::Geometry>(*_in.Geom()));
+  set(out.mutable_geometry(), *_in.Geom());
 
   return out;
 }
@@ -146,36 +146,44 @@ template<>
 msgs::Geometry ignition::gazebo::convert(const sdf::Geometry &_in)
 {
   msgs::Geometry out;
+  set(&out, _in);
+  return out;
+}
+
+//////////////////////////////////////////////////
+void ignition::gazebo::set(msgs::Geometry *_msg, const sdf::Geometry &_in)
+{
+  _msg->Clear();
   if (_in.Type() == sdf::GeometryType::BOX && _in.BoxShape())
   {
-    out.set_type(msgs::Geometry::BOX);
-    msgs::Set(out.mutable_box()->mutable_size(), _in.BoxShape()->Size());
+    _msg->set_type(msgs::Geometry::BOX);
+    msgs::Set(_msg->mutable_box()->mutable_size(), _in.BoxShape()->Size());
   }
   else if (_in.Type() == sdf::GeometryType::CYLINDER && _in.CylinderShape())
   {
-    out.set_type(msgs::Geometry::CYLINDER);
-    out.mutable_cylinder()->set_radius(_in.CylinderShape()->Radius());
-    out.mutable_cylinder()->set_length(_in.CylinderShape()->Length());
+    _msg->set_type(msgs::Geometry::CYLINDER);
+    _msg->mutable_cylinder()->set_radius(_in.CylinderShape()->Radius());
+    _msg->mutable_cylinder()->set_length(_in.CylinderShape()->Length());
   }
   else if (_in.Type() == sdf::GeometryType::PLANE && _in.PlaneShape())
   {
-    out.set_type(msgs::Geometry::PLANE);
-    msgs::Set(out.mutable_plane()->mutable_normal(),
+    _msg->set_type(msgs::Geometry::PLANE);
+    msgs::Set(_msg->mutable_plane()->mutable_normal(),
               _in.PlaneShape()->Normal());
-    msgs::Set(out.mutable_plane()->mutable_size(),
+    msgs::Set(_msg->mutable_plane()->mutable_size(),
               _in.PlaneShape()->Size());
   }
   else if (_in.Type() == sdf::GeometryType::SPHERE && _in.SphereShape())
   {
-    out.set_type(msgs::Geometry::SPHERE);
-    out.mutable_sphere()->set_radius(_in.SphereShape()->Radius());
+    _msg->set_type(msgs::Geometry::SPHERE);
+    _msg->mutable_sphere()->set_radius(_in.SphereShape()->Radius());
   }
   else if (_in.Type() == sdf::GeometryType::MESH && _in.MeshShape())
   {
     auto meshSdf = _in.MeshShape();
 
-    out.set_type(msgs::Geometry::MESH);
-    auto meshMsg = out.mutable_mesh();
+    _msg->set_type(msgs::Geometry::MESH);
+    auto meshMsg = _msg->mutable_mesh();
 
     msgs::Set(meshMsg->mutable_scale(), meshSdf->Scale());
     meshMsg->set_filename(asFullPath(meshSdf->Uri(), meshSdf->FilePath()));
@@ -187,7 +195,6 @@ msgs::Geometry ignition::gazebo::convert(const sdf::Geometry &_in)
     ignerr << "Geometry type [" << static_cast<int>(_in.Type())
            << "] not supported" << std::endl;
   }
-  return out;
 }
 
 //////////////////////////////////////////////////
@@ -258,14 +265,22 @@ template<>
 msgs::Material ignition::gazebo::convert(const sdf::Material &_in)
 {
   msgs::Material out;
-  msgs::Set(out.mutable_ambient(), _in.Ambient());
-  msgs::Set(out.mutable_diffuse(), _in.Diffuse());
-  msgs::Set(out.mutable_specular(), _in.Specular());
-  msgs::Set(out.mutable_emissive(), _in.Emissive());
-  out.set_lighting(_in.Lighting());
+  set(&out, _in);
+  return out;
+}
+
+//////////////////////////////////////////////////
+void ignition::gazebo::set(msgs::Material *_msg, const sdf::Material &_in)
+{
+  _msg->Clear();
+  msgs::Set(_msg->mutable_ambient(), _in.Ambient());
+  msgs::Set(_msg->mutable_diffuse(), _in.Diffuse());
+  msgs::Set(_msg->mutable_specular(), _in.Specular());
+  msgs::Set(_msg->mutable_emissive(), _in.Emissive());
+  _msg->set_lighting(_in.Lighting());
 
   // todo(anyone) add double_sided field to msgs::Material
-  auto data = out.mutable_header()->add_data();
+  auto data = _msg->mutable_header()->add_data();
   data->set_key("double_sided");
   std::string *value = data->add_value();
   *value = std::to_string(_in.DoubleSided());
@@ -273,7 +288,7 @@ msgs::Material ignition::gazebo::convert(const sdf::Material &_in)
   sdf::Pbr *pbr = _in.PbrMaterial();
   if (pbr)
   {
-    msgs::Material::PBR *pbrMsg = out.mutable_pbr();
+    msgs::Material::PBR *pbrMsg = _msg->mutable_pbr();
     sdf::PbrWorkflow *workflow = pbr->Workflow(sdf::PbrWorkflowType::METAL);
     if (workflow)
       pbrMsg->set_type(msgs::Material_PBR_WorkflowType_METAL);
@@ -309,7 +324,6 @@ msgs::Material ignition::gazebo::convert(const sdf::Material &_in)
           asFullPath(workflow->EmissiveMap(), _in.FilePath()));
     }
   }
-  return out;
 }
 
 //////////////////////////////////////////////////
@@ -444,26 +458,33 @@ template<>
 msgs::Light ignition::gazebo::convert(const sdf::Light &_in)
 {
   msgs::Light out;
-  out.set_name(_in.Name());
-  msgs::Set(out.mutable_pose(), _in.RawPose());
-  msgs::Set(out.mutable_diffuse(), _in.Diffuse());
-  msgs::Set(out.mutable_specular(), _in.Specular());
-  out.set_attenuation_constant(_in.ConstantAttenuationFactor());
-  out.set_attenuation_linear(_in.LinearAttenuationFactor());
-  out.set_attenuation_quadratic(_in.QuadraticAttenuationFactor());
-  out.set_range(_in.AttenuationRange());
-  msgs::Set(out.mutable_direction(), _in.Direction());
-  out.set_cast_shadows(_in.CastShadows());
-  out.set_spot_inner_angle(_in.SpotInnerAngle().Radian());
-  out.set_spot_outer_angle(_in.SpotOuterAngle().Radian());
-  out.set_spot_falloff(_in.SpotFalloff());
+  set(&out, _in);
+  return out;
+}
+
+//////////////////////////////////////////////////
+void ignition::gazebo::set(msgs::Light *_msg, const sdf::Light &_in)
+{
+  _msg->Clear();
+  _msg->set_name(_in.Name());
+  msgs::Set(_msg->mutable_pose(), _in.RawPose());
+  msgs::Set(_msg->mutable_diffuse(), _in.Diffuse());
+  msgs::Set(_msg->mutable_specular(), _in.Specular());
+  _msg->set_attenuation_constant(_in.ConstantAttenuationFactor());
+  _msg->set_attenuation_linear(_in.LinearAttenuationFactor());
+  _msg->set_attenuation_quadratic(_in.QuadraticAttenuationFactor());
+  _msg->set_range(_in.AttenuationRange());
+  msgs::Set(_msg->mutable_direction(), _in.Direction());
+  _msg->set_cast_shadows(_in.CastShadows());
+  _msg->set_spot_inner_angle(_in.SpotInnerAngle().Radian());
+  _msg->set_spot_outer_angle(_in.SpotOuterAngle().Radian());
+  _msg->set_spot_falloff(_in.SpotFalloff());
   if (_in.Type() == sdf::LightType::POINT)
-    out.set_type(msgs::Light_LightType_POINT);
+    _msg->set_type(msgs::Light_LightType_POINT);
   else if (_in.Type() == sdf::LightType::SPOT)
-    out.set_type(msgs::Light_LightType_SPOT);
+    _msg->set_type(msgs::Light_LightType_SPOT);
   else if (_in.Type() == sdf::LightType::DIRECTIONAL)
-    out.set_type(msgs::Light_LightType_DIRECTIONAL);
-  return out;
+    _msg->set_type(msgs::Light_LightType_DIRECTIONAL);
 }
 
 //////////////////////////////////////////////////
@@ -433,6 +433,68 @@ TEST(Conversions, GeometryPlane)
   EXPECT_EQ(math::Vector3d::UnitY, newGeometry.PlaneShape()->Normal());
 }
 
+/////////////////////////////////////////////////
+TEST(Conversions, SetReusedMessages)
+{
+  // Messages filled with one value and then reused for another must match
+  // a fresh conversion of the second value
+  sdf::Geometry box;
+  box.SetType(sdf::GeometryType::BOX);
+  sdf::Box boxShape;
+  boxShape.SetSize(math::Vector3d(1, 2, 3));
+  box.SetBoxShape(boxShape);
+
+  sdf::Geometry sphere;
+  sphere.SetType(sdf::GeometryType::SPHERE);
+  sdf::Sphere sphereShape;
+  sphereShape.SetRadius(0.5);
+  sphere.SetSphereShape(sphereShape);
+
+  msgs::Geometry geometryMsg;
+  set(&geometryMsg, box);
+  EXPECT_EQ(convert<msgs::Geometry>(box).DebugString(),
+      geometryMsg.DebugString());
+  set(&geometryMsg, sphere);
+  EXPECT_FALSE(geometryMsg.has_box());
+  EXPECT_EQ(convert<msgs::Geometry>(sphere).DebugString(),
+      geometryMsg.DebugString());
+
+  sdf::Material pbrMaterial;
+  pbrMaterial.SetDiffuse(math::Color(0.1f, 0.2f, 0.3f, 1.0f));
+  sdf::Pbr pbr;
+  sdf::PbrWorkflow workflow;
+  workflow.SetType(sdf::PbrWorkflowType::METAL);
+  workflow.SetMetalness(0.3);
+  pbr.SetWorkflow(workflow.Type(), workflow);
+  pbrMaterial.SetPbrMaterial(pbr);
+
+  sdf::Material material;
+  material.SetDoubleSided(true);
+
+  msgs::Material materialMsg;
+  set(&materialMsg, pbrMaterial);
+  set(&materialMsg, material);
+  EXPECT_FALSE(materialMsg.has_pbr());
+  EXPECT_EQ(1, materialMsg.header().data_size());
+  EXPECT_EQ(convert<msgs::Material>(material).DebugString(),
+      materialMsg.DebugString());
+
+  sdf::Light spot;
+  spot.SetName("spot");
+  spot.SetType(sdf::LightType::SPOT);
+  spot.SetCastShadows(true);
+
+  sdf::Light point;
+  point.SetName("point");
+  point.SetType(sdf::LightType::POINT);
+
+  msgs::Light lightMsg;
+  set(&lightMsg, spot);
+  set(&lightMsg, point);
+  EXPECT_EQ(convert<msgs::Light>(point).DebugString(),
+      lightMsg.DebugString());
+}
+
 /////////////////////////////////////////////////
 TEST(Conversions, Inertial)
 {
@@ -15,21 +15,431 @@
  *
 */
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <shared_mutex>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include <google/protobuf/arena.h>
 #include <ignition/common/Profiler.hh>
-#include <ignition/math/graph/GraphAlgorithms.hh>
 #include "ignition/gazebo/components/Component.hh"
 #include "ignition/gazebo/components/Factory.hh"
+#include "ignition/gazebo/components/JointStates.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/SpatialIndex.hh"
+
+#include "TaskPool.hh"
 
 using namespace ignition;
 using namespace gazebo;
 
+namespace
+{
+/// \brief Number of entities removed in one step from which storages and
+/// views are purged in parallel.
+constexpr std::size_t kParallelRemoveMinEntities{256};
+
+/// \brief Estimate the memory of a hash container: one node per element,
+/// holding the element and a link, and one pointer per bucket.
+/// \param[in] _container Unordered map or set.
+/// \return Size in bytes.
+template<typename ContainerT>
+std::size_t HashContainerBytes(const ContainerT &_container)
+{
+  return _container.size() *
+      (sizeof(typename ContainerT::value_type) + sizeof(void *)) +
+      _container.bucket_count() * sizeof(void *);
+}
+
+/// \brief Get a bitmask of component types, with one bit per type index,
+/// see components::Component::typeIndex.
+/// \param[in] _types Component types.
+/// \return The bitmask, as 64 bit words.
+template<typename ContainerT>
+std::vector<uint64_t> typeMask(const ContainerT &_types)
+{
+  std::vector<uint64_t> mask;
+  for (const ComponentTypeId type : _types)
+  {
+    const std::size_t index =
+        components::Factory::Instance()->TypeIndex(type);
+    if (index / 64 >= mask.size())
+      mask.resize(index / 64 + 1, 0);
+    mask[index / 64] |= uint64_t{1} << (index % 64);
+  }
+  return mask;
+}
+
+/// \brief Estimate the memory of a tree container: one node per element,
+/// holding the element, three links and the color.
+/// \param[in] _container Ordered map or set.
+/// \return Size in bytes.
+template<typename ContainerT>
+std::size_t TreeContainerBytes(const ContainerT &_container)
+{
+  return _container.size() *
+      (sizeof(typename ContainerT::value_type) + 4 * sizeof(void *));
+}
+
+/// \brief All entities which have exactly the same set of component types.
+/// The ids of their components are stored in a contiguous row-major table,
+/// with one row per entity and one column per component type, so entities
+/// don't need a map of their own, and views can match whole archetypes
+/// instead of checking every entity.
+struct Archetype
+{
+  /// \brief Get the column of a component type.
+  /// \param[in] _typeId Component type.
+  /// \return The column, or the number of types if the archetype doesn't
+  /// have the component type.
+  std::size_t Column(const ComponentTypeId _typeId) const
+  {
+    auto iter = std::lower_bound(this->types.begin(), this->types.end(),
+        _typeId);
+    if (iter == this->types.end() || *iter != _typeId)
+      return this->types.size();
+    return iter - this->types.begin();
+  }
+
+  /// \brief Check whether the archetype has all the given component types.
+  /// \param[in] _types Component types.
+  /// \return True if all types are in the archetype.
+  bool Matches(const std::set<ComponentTypeId> &_types) const
+  {
+    return std::includes(this->types.begin(), this->types.end(),
+        _types.begin(), _types.end());
+  }
+
+  /// \brief Check whether the entities of the archetype belong to a view,
+  /// that is, whether the archetype has all of the view's required types
+  /// and none of its excluded types. This compares the bitmasks of the
+  /// types, see typeMask.
+  /// \param[in] _view The view, with its masks set.
+  /// \return True if the archetype matches the view.
+  bool Matches(const detail::View &_view) const
+  {
+    const std::size_t words = this->signature.size();
+    for (std::size_t i = 0; i < _view.requiredMask.size(); ++i)
+    {
+      const uint64_t have = i < words ? this->signature[i] : 0;
+      if ((have & _view.requiredMask[i]) != _view.requiredMask[i])
+        return false;
+    }
+    for (std::size_t i = 0; i < _view.excludedMask.size() && i < words; ++i)
+    {
+      if ((this->signature[i] & _view.excludedMask[i]) != 0)
+        return false;
+    }
+    return true;
+  }
+
+  /// \brief Estimate the memory held by the archetype.
+  /// \return Size in bytes.
+  std::size_t MemoryUsage() const
+  {
+    return sizeof(*this) +
+        this->types.capacity() * sizeof(ComponentTypeId) +
+        this->storages.capacity() * sizeof(ComponentStorageBase *) +
+        this->signature.capacity() * sizeof(uint64_t) +
+        this->entities.capacity() * sizeof(Entity) +
+        this->componentIds.capacity() * sizeof(ComponentId) +
+        HashContainerBytes(this->addEdges) +
+        HashContainerBytes(this->removeEdges);
+  }
+
+  /// \brief Component types, sorted in ascending order.
+  std::vector<ComponentTypeId> types;
+
+  /// \brief Storage of each component type, in the order of `types`, so
+  /// that finding a component doesn't hash its type.
+  std::vector<ComponentStorageBase *> storages;
+
+  /// \brief Bitmask of the component types, see typeMask.
+  std::vector<uint64_t> signature;
+
+  /// \brief Entities, in no particular order. The index of an entity is
+  /// its row in `componentIds`.
+  std::vector<Entity> entities;
+
+  /// \brief Component ids of all entities.
+  std::vector<ComponentId> componentIds;
+
+  /// \brief Archetypes reached by adding a component type to this one.
+  std::unordered_map<ComponentTypeId, Archetype *> addEdges;
+
+  /// \brief Archetypes reached by removing a component type from this one.
+  std::unordered_map<ComponentTypeId, Archetype *> removeEdges;
+};
+
+/// \brief Location of an entity's components.
+struct EntityRecord
+{
+  /// \brief Get the id of one of the entity's components.
+  /// \param[in] _typeId Component type.
+  /// \return The component id, or -1 if the entity doesn't have a component
+  /// of that type.
+  ComponentId Id(const ComponentTypeId _typeId) const
+  {
+    const std::size_t column = this->archetype->Column(_typeId);
+    if (column >= this->archetype->types.size())
+      return -1;
+    return this->IdAt(column);
+  }
+
+  /// \brief Get the id of the component in a column of the archetype.
+  /// \param[in] _column Column, must be valid.
+  /// \return The component id.
+  ComponentId IdAt(const std::size_t _column) const
+  {
+    return this->archetype->componentIds[
+        this->row * this->archetype->types.size() + _column];
+  }
+
+  /// \brief Archetype holding the entity.
+  Archetype *archetype{nullptr};
+
+  /// \brief Row of the entity in the archetype.
+  std::size_t row{0};
+};
+
+/// \brief Per-entity data of the entity table.
+struct EntitySlot
+{
+  /// \brief Entity in the slot, or kNullEntity if the slot is free.
+  Entity entity{kNullEntity};
+
+  /// \brief Largest generation of all entities which used the slot.
+  uint64_t generation{0};
+
+  /// \brief True if the entity has been created. Components can be created
+  /// for entities which don't exist, so an entity may have a slot before it
+  /// is created.
+  bool alive{false};
+
+  /// \brief Location of the entity's components. The archetype is null if
+  /// the entity never had a component.
+  EntityRecord record;
+
+  /// \brief Parent of the entity, mirroring the entity graph.
+  Entity parent{kNullEntity};
+
+  /// \brief Children of the entity, mirroring the entity graph.
+  std::vector<Entity> children;
+};
+
+/// \brief Flat table of entities, where each entity is stored in the slot at
+/// its index, see EntityIndex. Removed entities free their slot, and new
+/// entities can reuse free slots with the next generation, so that the table
+/// doesn't grow when entities are created and removed over time.
+///
+/// Entities whose slot is taken by another entity or is far beyond the end
+/// of the table, such as entities created with an offset, are stored in a
+/// map instead.
+class EntityTable
+{
+  /// \brief Find the slot of an entity.
+  /// \param[in] _entity Entity.
+  /// \return The slot, or nullptr if the entity isn't in the table.
+  public: EntitySlot *Find(const Entity _entity)
+  {
+    const uint64_t index = EntityIndex(_entity);
+    if (index < this->slots.size() && this->slots[index].entity == _entity)
+      return &this->slots[index];
+
+    if (this->overflow.empty())
+      return nullptr;
+    auto iter = this->overflow.find(_entity);
+    return iter == this->overflow.end() ? nullptr : &iter->second;
+  }
+
+  /// \brief Find the slot of an entity.
+  /// \param[in] _entity Entity.
+  /// \return The slot, or nullptr if the entity isn't in the table.
+  public: const EntitySlot *Find(const Entity _entity) const
+  {
+    return const_cast<EntityTable *>(this)->Find(_entity);
+  }
+
+  /// \brief Get the slot of an entity, adding the entity if needed.
+  /// \param[in] _entity Entity, can't be kNullEntity.
+  /// \return The slot.
+  public: EntitySlot &Insert(const Entity _entity)
+  {
+    if (auto slot = this->Find(_entity))
+      return *slot;
+
+    const uint64_t index = EntityIndex(_entity);
+    const uint64_t generation = EntityGeneration(_entity);
+    if (index > 0 && index < this->slots.size() + kMaxGap)
+    {
+      if (index >= this->slots.size())
+        this->slots.resize(index + 1);
+
+      // Reusing the slot must not give an entity which is in the map
+      EntitySlot &slot = this->slots[index];
+      slot.generation = std::max(slot.generation, generation);
+      if (slot.entity == kNullEntity)
+      {
+        slot.entity = _entity;
+        return slot;
+      }
+    }
+
+    EntitySlot &slot = this->overflow[_entity];
+    slot.entity = _entity;
+    return slot;
+  }
+
+  /// \brief Remove an entity, freeing its slot.
+  /// \param[in] _entity Entity.
+  public: void Erase(const Entity _entity)
+  {
+    const uint64_t index = EntityIndex(_entity);
+    if (index < this->slots.size() && this->slots[index].entity == _entity)
+    {
+      EntitySlot &slot = this->slots[index];
+      const uint64_t generation = slot.generation;
+      slot = EntitySlot();
+      slot.generation = generation;
+      if (this->recycle && slot.generation < kMaxEntityGeneration)
+        this->freeSlots.push_back(index);
+      return;
+    }
+    this->overflow.erase(_entity);
+  }
+
+  /// \brief Remove all entities. Slots which were used can still be reused.
+  public: void Clear()
+  {
+    this->freeSlots.clear();
+    for (uint64_t index = 0; index < this->slots.size(); ++index)
+    {
+      EntitySlot &slot = this->slots[index];
+      if (slot.entity == kNullEntity)
+        continue;
+
+      const uint64_t generation = slot.generation;
+      slot = EntitySlot();
+      slot.generation = generation;
+      if (this->recycle && slot.generation < kMaxEntityGeneration)
+        this->freeSlots.push_back(index);
+    }
+    this->overflow.clear();
+  }
+
+  /// \brief Get a new entity which reuses a free slot. The entity isn't
+  /// added to the table.
+  /// \return The entity, or kNullEntity if there are no free slots.
+  public: Entity Recycle()
+  {
+    while (!this->freeSlots.empty())
+    {
+      const uint64_t index = this->freeSlots.back();
+      this->freeSlots.pop_back();
+
+      // The slot may have been taken since it was freed
+      EntitySlot &slot = this->slots[index];
+      while (slot.entity == kNullEntity &&
+          slot.generation < kMaxEntityGeneration)
+      {
+        Entity entity = MakeEntity(index, ++slot.generation);
+        if (this->overflow.find(entity) == this->overflow.end())
+          return entity;
+      }
+    }
+    return kNullEntity;
+  }
+
+  /// \brief Set whether free slots are reused by Recycle.
+  /// \param[in] _recycle True to reuse free slots.
+  public: void SetRecycle(const bool _recycle)
+  {
+    this->recycle = _recycle;
+    if (!_recycle)
+      this->freeSlots.clear();
+  }
+
+  /// \brief Estimate the memory held by the table.
+  /// \return Size in bytes.
+  public: std::size_t MemoryUsage() const
+  {
+    std::size_t bytes = this->slots.capacity() * sizeof(EntitySlot) +
+        this->freeSlots.capacity() * sizeof(uint64_t) +
+        HashContainerBytes(this->overflow);
+    for (const auto &slot : this->slots)
+      bytes += slot.children.capacity() * sizeof(Entity);
+    for (const auto &entry : this->overflow)
+      bytes += entry.second.children.capacity() * sizeof(Entity);
+    return bytes;
+  }
+
+  /// \brief Largest distance from the end of the table at which entities get
+  /// a slot. Entities which are further away are stored in the map.
+  private: static constexpr uint64_t kMaxGap{1 << 16};
+
+  /// \brief Slots, indexed by entity index. Slot 0 is never used.
+  private: std::vector<EntitySlot> slots;
+
+  /// \brief Indices of the free slots which can be reused.
+  private: std::vector<uint64_t> freeSlots;
+
+  /// \brief Entities which don't have a slot.
+  private: std::unordered_map<Entity, EntitySlot> overflow;
+
+  /// \brief True if free slots are reused.
+  private: bool recycle{false};
+};
+
+/// \brief Key of the name index: the parent given by the ParentEntity
+/// component, kNullEntity if there's none, and the name.
+using NameKey = std::pair<Entity, std::string>;
+
+/// \brief Hash of a name index key.
+struct NameKeyHash
+{
+  /// \brief Hash a key.
+  /// \param[in] _key The key.
+  /// \return The hash.
+  std::size_t operator()(const NameKey &_key) const
+  {
+    return std::hash<std::string>()(_key.second) ^
+        (std::hash<Entity>()(_key.first) * 0x9e3779b97f4a7c15ULL);
+  }
+};
+
+/// \brief Insert an entity into a sorted list, if it's not there yet.
+/// \param[in, out] _entities Sorted list.
+/// \param[in] _entity Entity to insert.
+void insertSorted(std::vector<Entity> &_entities, const Entity _entity)
+{
+  auto it = std::lower_bound(_entities.begin(), _entities.end(), _entity);
+  if (it == _entities.end() || *it != _entity)
+    _entities.insert(it, _entity);
+}
+
+/// \brief Remove an entity from a sorted list.
+/// \param[in, out] _entities Sorted list.
+/// \param[in] _entity Entity to remove.
+void eraseSorted(std::vector<Entity> &_entities, const Entity _entity)
+{
+  auto it = std::lower_bound(_entities.begin(), _entities.end(), _entity);
+  if (it != _entities.end() && *it == _entity)
+    _entities.erase(it);
+}
+}
+
 class ignition::gazebo::EntityComponentManagerPrivate
 {
   /// \brief Implementation of the CreateEntity function, which takes a specific
@@ -45,6 +455,24 @@ class ignition::gazebo::EntityComponentManagerPrivate
   public: void InsertEntityRecursive(Entity _entity,
       std::unordered_set<Entity> &_set);
 
+  /// \brief Remove the cached descendants of an entity and all its
+  /// ancestors, whose subtrees contain the entity.
+  /// \param[in] _entity Entity whose subtree changed.
+  public: void InvalidateDescendants(Entity _entity);
+
+  /// \brief Detach an entity from its parent in the parent index.
+  /// \param[in, out] _slot Slot of the entity.
+  public: void DetachFromParent(EntitySlot &_slot);
+
+  /// \brief Add an entity to the name index.
+  /// \param[in] _entity The entity.
+  /// \param[in] _key Parent and name of the entity.
+  public: void IndexName(const Entity _entity, const NameKey &_key);
+
+  /// \brief Remove an entity from the name index, if it's there.
+  /// \param[in] _entity The entity.
+  public: void UnindexName(const Entity _entity);
+
   /// \brief Register a new component type.
   /// \param[in] _typeId Type if of the new component.
   /// \return True if created successfully.
@@ -72,21 +500,64 @@ class ignition::gazebo::EntityComponentManagerPrivate
       msgs::SerializedStateMap &_msg,
       const std::unordered_set<ComponentTypeId> &_types = {});
 
+  /// \brief Add the changes since the last step to a state message. This
+  /// includes entities marked for removal, components marked as changed and
+  /// removed components, and only visits the changed components.
+  /// \param[in, out] _msg State message
+  /// \param[in] _types Type IDs of components to be serialized. Leave empty
+  /// to get all changed components.
+  /// \param[in] _entities Entities to be serialized. Leave empty to get all
+  /// changed entities.
+  public: void AddChangesToMessage(msgs::SerializedStateMap &_msg,
+      const std::unordered_set<ComponentTypeId> &_types = {},
+      const std::unordered_set<Entity> &_entities = {});
+
+  /// \brief Find the record of an entity which has or had components.
+  /// \param[in] _entity Entity.
+  /// \return The entity's record, or nullptr if it never had components.
+  public: EntityRecord *FindRecord(const Entity _entity);
+
+  /// \brief Get the record of an entity, adding the entity to the archetype
+  /// without components if it doesn't have one yet.
+  /// \param[in] _entity Entity.
+  /// \return The entity's record.
+  public: EntityRecord &CreateRecord(const Entity _entity);
+
+  /// \brief Find the archetype with the given component types, creating it
+  /// if it doesn't exist yet.
+  /// \param[in] _types Component types, sorted in ascending order.
+  /// \return The archetype.
+  public: Archetype *FindArchetype(const std::vector<ComponentTypeId> &_types);
+
+  /// \brief Move an entity to the archetype with one more or one less
+  /// component type.
+  /// \param[in] _entity Entity being moved.
+  /// \param[in, out] _record Record of the entity.
+  /// \param[in] _typeId Component type being added or removed.
+  /// \param[in] _add True to add the type, false to remove it.
+  /// \param[in] _id Id of the added component. Ignored when removing.
+  public: void MoveEntity(const Entity _entity, EntityRecord &_record,
+      const ComponentTypeId _typeId, bool _add, ComponentId _id = -1);
+
+  /// \brief Remove an entity's row from its archetype. The last row takes its
+  /// place, so the record of the entity in that row is updated.
+  /// \param[in] _record Record of the entity being removed.
+  public: void RemoveFromArchetype(const EntityRecord &_record);
+
   /// \brief Map of component storage classes. The key is a component
   /// type id, and the value is a pointer to the component storage.
   public: std::unordered_map<ComponentTypeId,
           std::unique_ptr<ComponentStorageBase>> components;
 
+  /// \brief Component storages, indexed by the dense index of their type,
+  /// see components::Component::typeIndex. Types without a storage are
+  /// null. The storages are owned by `components`.
+  public: std::vector<ComponentStorageBase *> storagesByIndex;
+
   /// \brief A graph holding all entities, arranged according to their
   /// parenting.
   public: EntityGraph entities;
 
-  /// \brief Components that have been changed through a peridic change.
-  public: std::set<ComponentKey> periodicChangedComponents;
-
-  /// \brief Components that have been changed through a one-time change.
-  public: std::set<ComponentKey> oneTimeChangedComponents;
-
   /// \brief Entities that have just been created
   public: std::unordered_set<Entity> newlyCreatedEntities;
 
@@ -96,25 +567,31 @@ class ignition::gazebo::EntityComponentManagerPrivate
   /// \brief Flag that indicates if all entities should be removed.
   public: bool removeAllEntities{false};
 
-  /// \brief True if the entityComponents map was changed.  Primarily used
+  /// \brief True if the entities with components changed.  Primarily used
   /// by the multithreading functionality in `State()` to allocate work to
   /// each thread.
   public: bool entityComponentsDirty{true};
 
-  /// \brief The set of components that each entity has.
-  /// NOTE: Any modification of this data structure must be followed
+  /// \brief See EntityComponentManager::StructureVersion. Starts at 1, so
+  /// that caches can use 0 as never filled.
+  public: uint64_t structureVersion{1};
+
+  /// \brief All entities, and the location of the components of each
+  /// entity which has or had any.
+  /// NOTE: Any modification of the records must be followed
   /// by setting `entityComponentsDirty` to true.
-  public: std::unordered_map<Entity,
-          std::unordered_map<ComponentTypeId, ComponentKey>> entityComponents;
+  public: EntityTable entityTable;
+
+  /// \brief All archetypes, keyed by their component types. Archetypes are
+  /// only removed together with all entities, so pointers to them stay valid.
+  public: std::map<std::vector<ComponentTypeId>, std::unique_ptr<Archetype>>
+          archetypes;
 
-  /// \brief A vector of iterators to evenly distributed spots in the
-  /// `entityComponents` map.  Threads in the `State` function use this
-  /// vector for easy access of their pre-allocated work.  This vector
-  /// is recalculated if `entityComponents` is changed (when
+  /// \brief All entities which have or had components.  Threads in the
+  /// `State` function split this vector in chunks.  This vector is
+  /// recalculated if the records in `entityTable` changed (when
   /// `entityComponentsDirty` == true).
-  public: std::vector<std::unordered_map<Entity,
-          std::unordered_map<ComponentTypeId, ComponentKey>>::iterator>
-            entityComponentIterators;
+  public: std::vector<Entity> stateEntities;
 
   /// \brief A mutex to protect newly created entities.
   public: std::mutex entityCreatedMutex;
@@ -122,28 +599,108 @@ class ignition::gazebo::EntityComponentManagerPrivate
   /// \brief A mutex to protect entity remove.
   public: std::mutex entityRemoveMutex;
 
-  /// \brief A mutex to protect from concurrent writes to views
-  public: mutable std::mutex viewsMutex;
+  /// \brief A mutex to protect from concurrent writes to views. Looking up
+  /// a view only takes a shared lock, so readers which run in parallel,
+  /// such as PostUpdate systems, don't serialize once their views exist.
+  public: mutable std::shared_mutex viewsMutex;
 
   /// \brief A mutex to protect removed components
   public: mutable std::mutex removedComponentsMutex;
 
   /// \brief The set of all views.
-  public: mutable std::map<detail::ComponentTypeKey, detail::View> views;
+  public: mutable std::map<detail::ViewKey, detail::View> views;
 
   /// \brief Cache of previously queried descendants. The key is the parent
   /// entity for which descendants were queried, and the value are all its
-  /// descendants.
+  /// descendants. Changing the parent of an entity only removes the entries
+  /// of the entity's ancestors.
   public: mutable std::unordered_map<Entity, std::unordered_set<Entity>>
           descendantCache;
 
   /// \brief Keep track of entities already used to ensure uniqueness.
   public: uint64_t entityCount{0};
 
+  /// \brief True if component storages are in lock-free read mode.
+  public: bool lockFreeReads{false};
+
+  /// \brief Pool used for parallel work, or nullptr to use the shared pool.
+  public: TaskPool *taskPool{nullptr};
+
+  /// \brief Get the pool used for parallel work.
+  /// \return The pool.
+  public: TaskPool &Pool() const
+  {
+    return nullptr == this->taskPool ? TaskPool::Shared() : *this->taskPool;
+  }
+
+  /// \brief Lock a mutex which protects data that is read by const
+  /// functions. In lock-free read mode the data can't change, so the
+  /// returned lock doesn't own the mutex and readers don't contend.
+  /// \param[in] _mutex Mutex to lock.
+  /// \return The lock.
+  public: std::unique_lock<std::mutex> ReadLock(std::mutex &_mutex) const
+  {
+    if (this->lockFreeReads)
+      return std::unique_lock<std::mutex>(_mutex, std::defer_lock);
+    return std::unique_lock<std::mutex>(_mutex);
+  }
+
+  /// \brief Number of calls to BeginBatch which haven't been committed.
+  public: int batchDepth{0};
+
+  /// \brief Entities created during the batch, which are marked as new on
+  /// commit.
+  public: std::vector<Entity> batchCreatedEntities;
+
+  /// \brief Entities whose components were created or removed during the
+  /// batch, whose views are updated on commit.
+  public: std::vector<Entity> batchChangedEntities;
+
+  /// \brief Entities whose parent was set during the batch, whose graph edges
+  /// are added on commit.
+  public: std::vector<Entity> batchParentedEntities;
+
+  /// \brief True if a component storage reported that views need to be
+  /// rebuilt during the batch.
+  public: bool batchRebuildViews{false};
+
+  /// \brief Defer updating the views of an entity until the batch is
+  /// committed.
+  /// \param[in] _entity Entity whose components changed.
+  public: void DeferUpdateViews(const Entity _entity);
+
   /// \brief Unordered multimap of removed components. The key is the entity to
   /// which belongs the component, and the value is the component being
   /// removed.
   std::unordered_multimap<Entity, ComponentKey> removedComponents;
+
+  /// \brief Observers registered with OnComponentChanged, keyed by their
+  /// id. The value holds the observed component type and the callback.
+  public: std::map<std::size_t, std::pair<ComponentTypeId,
+          std::function<void(const Entity &, const components::BaseComponent *,
+              gazebo::ComponentState)>>> componentObservers;
+
+  /// \brief Id of the next observer registered with OnComponentChanged.
+  public: std::size_t nextObserverId{0};
+
+  /// \brief Spatial index shared by the systems, created on first use.
+  public: std::shared_ptr<SpatialIndex> spatialIndex;
+
+  /// \brief Protects spatialIndex.
+  public: std::mutex spatialIndexMutex;
+
+  /// \brief Whether the name index is kept, see SetNameIndex.
+  public: bool nameIndexEnabled{false};
+
+  /// \brief Entities with a Name component, sorted, by name.
+  public: std::unordered_map<std::string, std::vector<Entity>> entitiesByName;
+
+  /// \brief Entities with a Name component, sorted, by parent and name.
+  public: std::unordered_map<NameKey, std::vector<Entity>, NameKeyHash>
+      entitiesByParentName;
+
+  /// \brief Key each entity is indexed with, to remove it from the index.
+  public: std::unordered_map<Entity, NameKey> indexedNames;
 };
 
 //////////////////////////////////////////////////
@@ -164,7 +721,12 @@ size_t EntityComponentManager::EntityCount() const
 /////////////////////////////////////////////////
 Entity EntityComponentManager::CreateEntity()
 {
-  Entity entity = ++this->dataPtr->entityCount;
+  // Reuse the slot of a removed entity, if there's any
+  Entity entity = this->dataPtr->entityTable.Recycle();
+  if (kNullEntity != entity)
+    return this->dataPtr->CreateEntityImplementation(entity);
+
+  entity = ++this->dataPtr->entityCount;
 
   if (entity == std::numeric_limits<uint64_t>::max())
   {
@@ -176,21 +738,175 @@ Entity EntityComponentManager::CreateEntity()
   return this->dataPtr->CreateEntityImplementation(entity);
 }
 
+/////////////////////////////////////////////////
+void EntityComponentManager::BeginBatch()
+{
+  ++this->dataPtr->batchDepth;
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::CommitBatch()
+{
+  IGN_PROFILE("EntityComponentManager::CommitBatch");
+  if (this->dataPtr->batchDepth <= 0)
+  {
+    ignerr << "Trying to commit a batch which hasn't begun." << std::endl;
+    return;
+  }
+  --this->dataPtr->batchDepth;
+
+  // Graph edges, from the parents the entities have now
+  for (const Entity child : this->dataPtr->batchParentedEntities)
+  {
+    const EntitySlot *slot = this->dataPtr->entityTable.Find(child);
+    if (nullptr == slot || !slot->alive || kNullEntity == slot->parent ||
+        this->dataPtr->entities.EdgeFromVertices(slot->parent, child).Id() !=
+        math::graph::kNullId)
+    {
+      continue;
+    }
+    this->dataPtr->entities.AddEdge({slot->parent, child}, true);
+  }
+  this->dataPtr->batchParentedEntities.clear();
+
+  // New entities, which the views need to know about
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->entityCreatedMutex);
+    this->dataPtr->newlyCreatedEntities.insert(
+        this->dataPtr->batchCreatedEntities.begin(),
+        this->dataPtr->batchCreatedEntities.end());
+  }
+  this->dataPtr->batchCreatedEntities.clear();
+
+  // Views
+  auto &changed = this->dataPtr->batchChangedEntities;
+  if (this->dataPtr->batchRebuildViews)
+  {
+    this->RebuildViews();
+  }
+  else
+  {
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    for (const Entity entity : changed)
+      this->UpdateViews(entity);
+  }
+  changed.clear();
+  this->dataPtr->batchRebuildViews = false;
+}
+
+/////////////////////////////////////////////////
+Entity EntityComponentManager::Clone(Entity _entity, Entity _parent,
+    const std::string &_name)
+{
+  IGN_PROFILE("EntityComponentManager::Clone");
+  if (!this->HasEntity(_entity))
+  {
+    ignerr << "Trying to clone entity [" << _entity
+           << "], which doesn't exist." << std::endl;
+    return kNullEntity;
+  }
+
+  // Clone in id order, so the clones are numbered like the originals
+  auto descendants = this->Descendants(_entity);
+  std::vector<Entity> originals(descendants.begin(), descendants.end());
+  std::sort(originals.begin(), originals.end());
+
+  this->BeginBatch();
+
+  std::unordered_map<Entity, Entity> clones;
+  clones.reserve(originals.size());
+  for (const Entity original : originals)
+  {
+    const Entity clone = this->CreateEntity();
+    clones[original] = clone;
+
+    for (const ComponentTypeId type : this->ComponentTypes(original))
+    {
+      this->CreateComponentImplementation(clone, type,
+          this->ComponentImplementation(original, type));
+    }
+  }
+
+  auto cloneOf = [&clones](Entity _original)
+  {
+    auto it = clones.find(_original);
+    return it == clones.end() ? _original : it->second;
+  };
+
+  for (const Entity original : originals)
+  {
+    const Entity clone = clones[original];
+    const Entity parent = original == _entity ?
+        _parent : cloneOf(this->ParentEntity(original));
+    this->SetParentEntity(clone, parent);
+
+    auto parentComp = this->Component<components::ParentEntity>(clone);
+    if (parentComp && kNullEntity == parent)
+      this->RemoveComponent<components::ParentEntity>(clone);
+    else if (parentComp)
+      parentComp->Data() = parent;
+    else if (kNullEntity != parent)
+      this->CreateComponent(clone, components::ParentEntity(parent));
+
+    auto jointStates = this->Component<components::JointStates>(clone);
+    if (jointStates)
+    {
+      for (Entity &joint : jointStates->Data().joints)
+        joint = cloneOf(joint);
+    }
+  }
+
+  const Entity root = clones[_entity];
+  if (!_name.empty())
+  {
+    auto nameComp = this->Component<components::Name>(root);
+    if (nameComp)
+      nameComp->Data() = _name;
+    else
+      this->CreateComponent(root, components::Name(_name));
+  }
+
+  this->CommitBatch();
+
+  return root;
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManagerPrivate::DeferUpdateViews(const Entity _entity)
+{
+  // Entities usually get all their components in a row
+  if (this->batchChangedEntities.empty() ||
+      this->batchChangedEntities.back() != _entity)
+  {
+    this->batchChangedEntities.push_back(_entity);
+  }
+}
+
 /////////////////////////////////////////////////
 Entity EntityComponentManagerPrivate::CreateEntityImplementation(Entity _entity)
 {
   IGN_PROFILE("EntityComponentManager::CreateEntityImplementation");
   this->entities.AddVertex(std::to_string(_entity), _entity, _entity);
 
+  // Entities created with a given id, such as by SetState, mustn't be handed
+  // out again by CreateEntity. Only the index is counted, the generation is
+  // part of the id.
+  if (EntityIndex(_entity) > this->entityCount)
+    this->entityCount = EntityIndex(_entity);
+  this->entityTable.Insert(_entity).alive = true;
+
   // Add entity to the list of newly created entities
+  if (this->batchDepth > 0)
+  {
+    this->batchCreatedEntities.push_back(_entity);
+  }
+  else
   {
     std::lock_guard<std::mutex> lock(this->entityCreatedMutex);
     this->newlyCreatedEntities.insert(_entity);
   }
 
-  // Reset descendants cache
-  this->descendantCache.clear();
-
   return _entity;
 }
 
@@ -217,13 +933,46 @@ void EntityComponentManager::ClearRemovedComponents()
 void EntityComponentManagerPrivate::InsertEntityRecursive(Entity _entity,
     std::unordered_set<Entity> &_set)
 {
-  for (const auto &vertex : this->entities.AdjacentsFrom(_entity))
+  if (const EntitySlot *slot = this->entityTable.Find(_entity))
   {
-    this->InsertEntityRecursive(vertex.first, _set);
+    for (const Entity child : slot->children)
+    {
+      this->InsertEntityRecursive(child, _set);
+    }
   }
   _set.insert(_entity);
 }
 
+/////////////////////////////////////////////////
+void EntityComponentManagerPrivate::InvalidateDescendants(Entity _entity)
+{
+  if (this->descendantCache.empty())
+    return;
+
+  while (kNullEntity != _entity)
+  {
+    this->descendantCache.erase(_entity);
+    const EntitySlot *slot = this->entityTable.Find(_entity);
+    _entity = nullptr == slot ? kNullEntity : slot->parent;
+  }
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManagerPrivate::DetachFromParent(EntitySlot &_slot)
+{
+  if (kNullEntity == _slot.parent)
+    return;
+
+  this->InvalidateDescendants(_slot.parent);
+  if (EntitySlot *parentSlot = this->entityTable.Find(_slot.parent))
+  {
+    auto &siblings = parentSlot->children;
+    siblings.erase(std::find(siblings.begin(), siblings.end(),
+        _slot.entity));
+  }
+  _slot.parent = kNullEntity;
+}
+
 /////////////////////////////////////////////////
 void EntityComponentManager::RequestRemoveEntity(Entity _entity,
     bool _recursive)
@@ -273,9 +1022,11 @@ void EntityComponentManager::ProcessRemoveEntityRequests()
     IGN_PROFILE("RemoveAll");
     this->dataPtr->removeAllEntities = false;
     this->dataPtr->entities = EntityGraph();
-    this->dataPtr->entityComponents.clear();
+    this->dataPtr->entityTable.Clear();
+    this->dataPtr->archetypes.clear();
     this->dataPtr->toRemoveEntities.clear();
     this->dataPtr->entityComponentsDirty = true;
+    ++this->dataPtr->structureVersion;
 
     for (std::pair<const ComponentTypeId,
         std::unique_ptr<ComponentStorageBase>> &comp: this->dataPtr->components)
@@ -285,47 +1036,110 @@ void EntityComponentManager::ProcessRemoveEntityRequests()
 
     // All views are now invalid.
     this->dataPtr->views.clear();
+    this->dataPtr->descendantCache.clear();
+
+    this->dataPtr->entitiesByName.clear();
+    this->dataPtr->entitiesByParentName.clear();
+    this->dataPtr->indexedNames.clear();
   }
   else
   {
     IGN_PROFILE("Remove");
-    // Otherwise iterate through the list of entities to remove.
-    for (const Entity entity : this->dataPtr->toRemoveEntities)
+    const auto &toRemove = this->dataPtr->toRemoveEntities;
+
+    // Entities and graph are updated in one pass, while the components to
+    // remove are grouped by storage, so each storage and each view is
+    // purged once, in parallel with the others.
+    std::vector<Entity> removed;
+    removed.reserve(toRemove.size());
+    std::unordered_map<ComponentStorageBase *, std::vector<ComponentId>>
+        storageRemovals;
+    for (const Entity entity : toRemove)
     {
       // Make sure the entity exists and is not removed.
       if (!this->HasEntity(entity))
         continue;
+      removed.push_back(entity);
 
       // Remove from graph
       this->dataPtr->entities.RemoveVertex(entity);
 
-      auto entityIter = this->dataPtr->entityComponents.find(entity);
-      // Remove the components, if any.
-      if (entityIter != this->dataPtr->entityComponents.end())
+      // Remove from the parent index. The graph edges to the children are
+      // gone, so they're now parentless. Links to entities which are
+      // removed too are left alone, their slots are freed anyway, and
+      // detaching only from surviving parents invalidates each cached
+      // ancestor chain once per removed subtree.
+      EntitySlot *slot = this->dataPtr->entityTable.Find(entity);
+      if (toRemove.find(slot->parent) == toRemove.end())
+        this->dataPtr->DetachFromParent(*slot);
+      for (const Entity child : slot->children)
       {
-        for (const auto &key : entityIter->second)
+        if (toRemove.find(child) != toRemove.end())
+          continue;
+        if (EntitySlot *childSlot = this->dataPtr->entityTable.Find(child))
+          childSlot->parent = kNullEntity;
+      }
+      this->dataPtr->descendantCache.erase(entity);
+      this->dataPtr->UnindexName(entity);
+
+      EntityRecord *entityRecord = this->dataPtr->FindRecord(entity);
+      // Collect the components, if any.
+      if (nullptr != entityRecord)
+      {
+        const EntityRecord &record = *entityRecord;
+        const auto &storages = record.archetype->storages;
+        for (std::size_t column = 0; column < storages.size(); ++column)
         {
-          this->dataPtr->components.at(key.second.first)->Remove(
-              key.second.second);
+          storageRemovals[storages[column]].push_back(record.IdAt(column));
         }
 
-        // Remove the entry in the entityComponent map
-        this->dataPtr->entityComponents.erase(entity);
+        // Remove the entity from its archetype
+        this->dataPtr->RemoveFromArchetype(record);
         this->dataPtr->entityComponentsDirty = true;
       }
 
-      // Remove the entity from views.
-      for (auto &view : this->dataPtr->views)
-      {
-        view.second.RemoveEntity(entity, view.first);
-      }
+      // Free the entity's slot
+      this->dataPtr->entityTable.Erase(entity);
     }
     // Clear the set of entities to remove.
     this->dataPtr->toRemoveEntities.clear();
-  }
 
-  // Reset descendants cache
-  this->dataPtr->descendantCache.clear();
+    if (!removed.empty())
+    {
+      ++this->dataPtr->structureVersion;
+      std::sort(removed.begin(), removed.end());
+
+      // Removing a few entities isn't worth waking up other threads
+      const std::size_t grainSize =
+          removed.size() < kParallelRemoveMinEntities ?
+          std::numeric_limits<std::size_t>::max() : 1u;
+
+      std::vector<std::pair<ComponentStorageBase *,
+          std::vector<ComponentId>>> groups(
+          std::make_move_iterator(storageRemovals.begin()),
+          std::make_move_iterator(storageRemovals.end()));
+      this->dataPtr->Pool().ParallelFor(groups.size(), grainSize,
+          [&](std::size_t _begin, std::size_t _end)
+          {
+            for (std::size_t i = _begin; i < _end; ++i)
+            {
+              for (const ComponentId id : groups[i].second)
+                groups[i].first->Remove(id);
+            }
+          });
+
+      std::vector<detail::View *> views;
+      views.reserve(this->dataPtr->views.size());
+      for (auto &view : this->dataPtr->views)
+        views.push_back(&view.second);
+      this->dataPtr->Pool().ParallelFor(views.size(), grainSize,
+          [&](std::size_t _begin, std::size_t _end)
+          {
+            for (std::size_t i = _begin; i < _end; ++i)
+              views[i]->RemoveEntities(removed);
+          });
+    }
+  }
 }
 
 /////////////////////////////////////////////////
@@ -346,13 +1160,24 @@ bool EntityComponentManager::RemoveComponent(
   if (!this->EntityHasComponent(_entity, _key))
     return false;
 
+  if (this->dataPtr->lockFreeReads)
+  {
+    ignerr << "Removing component of type [" << _key.first
+           << "] from entity [" << _entity << "] while lock-free reads are "
+           << "enabled. Components shouldn't be removed during PostUpdate."
+           << std::endl;
+  }
+
   this->dataPtr->components.at(_key.first)->Remove(_key.second);
-  this->dataPtr->entityComponents[_entity].erase(_key.first);
-  this->dataPtr->oneTimeChangedComponents.erase(_key);
-  this->dataPtr->periodicChangedComponents.erase(_key);
+  this->dataPtr->MoveEntity(_entity,
+      *this->dataPtr->FindRecord(_entity), _key.first, false);
   this->dataPtr->entityComponentsDirty = true;
+  ++this->dataPtr->structureVersion;
 
-  this->UpdateViews(_entity);
+  if (this->dataPtr->batchDepth > 0)
+    this->dataPtr->DeferUpdateViews(_entity);
+  else
+    this->UpdateViews(_entity);
 
   // Add component to map of removed components
   {
@@ -360,6 +1185,8 @@ bool EntityComponentManager::RemoveComponent(
     this->dataPtr->removedComponents.insert(std::make_pair(_entity, _key));
   }
 
+  this->UpdateNameIndex(_entity, _key.first);
+
   return true;
 }
 
@@ -367,10 +1194,7 @@ bool EntityComponentManager::RemoveComponent(
 bool EntityComponentManager::EntityHasComponent(const Entity _entity,
     const ComponentKey &_key) const
 {
-  if (!this->HasEntity(_entity))
-    return false;
-  auto &compMap = this->dataPtr->entityComponents[_entity];
-  return compMap.find(_key.first) != compMap.end();
+  return this->EntityHasComponentType(_entity, _key.first);
 }
 
 /////////////////////////////////////////////////
@@ -380,19 +1204,19 @@ bool EntityComponentManager::EntityHasComponentType(const Entity _entity,
   if (!this->HasEntity(_entity))
     return false;
 
-  auto iter = this->dataPtr->entityComponents.find(_entity);
+  auto iter = this->dataPtr->FindRecord(_entity);
 
-  if (iter == this->dataPtr->entityComponents.end())
+  if (nullptr == iter)
     return false;
 
-  auto typeIter = iter->second.find(_typeId);
-  return (typeIter != iter->second.end());
+  const Archetype *archetype = iter->archetype;
+  return archetype->Column(_typeId) < archetype->types.size();
 }
 
 /////////////////////////////////////////////////
 bool EntityComponentManager::IsNewEntity(const Entity _entity) const
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->entityCreatedMutex);
+  auto lock = this->dataPtr->ReadLock(this->dataPtr->entityCreatedMutex);
   return this->dataPtr->newlyCreatedEntities.find(_entity) !=
          this->dataPtr->newlyCreatedEntities.end();
 }
@@ -400,7 +1224,7 @@ bool EntityComponentManager::IsNewEntity(const Entity _entity) const
 /////////////////////////////////////////////////
 bool EntityComponentManager::IsMarkedForRemoval(const Entity _entity) const
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->entityRemoveMutex);
+  auto lock = this->dataPtr->ReadLock(this->dataPtr->entityRemoveMutex);
   if (this->dataPtr->removeAllEntities)
   {
     return true;
@@ -415,48 +1239,64 @@ ComponentState EntityComponentManager::ComponentState(const Entity _entity,
 {
   auto result = ComponentState::NoChange;
 
-  auto ecIter = this->dataPtr->entityComponents.find(_entity);
+  auto ecIter = this->dataPtr->FindRecord(_entity);
 
-  if (ecIter == this->dataPtr->entityComponents.end())
+  if (nullptr == ecIter)
     return result;
 
-  auto typeKey = ecIter->second.find(_typeId);
-  if (typeKey == ecIter->second.end())
+  const ComponentId id = ecIter->Id(_typeId);
+  if (id < 0)
     return result;
 
-  if (this->dataPtr->oneTimeChangedComponents.find(typeKey->second) !=
-      this->dataPtr->oneTimeChangedComponents.end())
-  {
-    result = ComponentState::OneTimeChange;
-  }
-  else if (this->dataPtr->periodicChangedComponents.find(typeKey->second) !=
-      this->dataPtr->periodicChangedComponents.end())
-  {
-    result = ComponentState::PeriodicChange;
-  }
+  auto storageIter = this->dataPtr->components.find(_typeId);
+  if (storageIter == this->dataPtr->components.end())
+    return result;
 
-  return result;
+  return storageIter->second->Changed(id);
 }
 
 /////////////////////////////////////////////////
 bool EntityComponentManager::HasNewEntities() const
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->entityCreatedMutex);
+  auto lock = this->dataPtr->ReadLock(this->dataPtr->entityCreatedMutex);
   return !this->dataPtr->newlyCreatedEntities.empty();
 }
 
+/////////////////////////////////////////////////
+std::size_t EntityComponentManager::NewEntityCount() const
+{
+  auto lock = this->dataPtr->ReadLock(this->dataPtr->entityCreatedMutex);
+  return this->dataPtr->newlyCreatedEntities.size();
+}
+
 /////////////////////////////////////////////////
 bool EntityComponentManager::HasEntitiesMarkedForRemoval() const
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->entityRemoveMutex);
+  auto lock = this->dataPtr->ReadLock(this->dataPtr->entityRemoveMutex);
   return this->dataPtr->removeAllEntities ||
       !this->dataPtr->toRemoveEntities.empty();
 }
 
+/////////////////////////////////////////////////
+std::size_t EntityComponentManager::EntitiesMarkedForRemovalCount() const
+{
+  {
+    auto lock = this->dataPtr->ReadLock(this->dataPtr->entityRemoveMutex);
+    if (!this->dataPtr->removeAllEntities)
+      return this->dataPtr->toRemoveEntities.size();
+  }
+  return this->EntityCount();
+}
+
 /////////////////////////////////////////////////
 bool EntityComponentManager::HasOneTimeComponentChanges() const
 {
-  return !this->dataPtr->oneTimeChangedComponents.empty();
+  for (const auto &storage : this->dataPtr->components)
+  {
+    if (storage.second->OneTimeChangeCount() > 0)
+      return true;
+  }
+  return false;
 }
 
 /////////////////////////////////////////////////
@@ -464,9 +1304,10 @@ std::unordered_set<ComponentTypeId>
     EntityComponentManager::ComponentTypesWithPeriodicChanges() const
 {
   std::unordered_set<ComponentTypeId> periodicComponents;
-  for (const auto& compPair : this->dataPtr->periodicChangedComponents)
+  for (const auto &storage : this->dataPtr->components)
   {
-    periodicComponents.insert(compPair.first);
+    if (storage.second->PeriodicChangeCount() > 0)
+      periodicComponents.insert(storage.first);
   }
   return periodicComponents;
 }
@@ -474,31 +1315,29 @@ std::unordered_set<ComponentTypeId>
 /////////////////////////////////////////////////
 bool EntityComponentManager::HasEntity(const Entity _entity) const
 {
-  auto vertex = this->dataPtr->entities.VertexFromId(_entity);
-  return vertex.Id() != math::graph::kNullId;
+  const EntitySlot *slot = this->dataPtr->entityTable.Find(_entity);
+  return nullptr != slot && slot->alive;
 }
 
 /////////////////////////////////////////////////
 Entity EntityComponentManager::ParentEntity(const Entity _entity) const
 {
-  auto parents = this->Entities().AdjacentsTo(_entity);
-  if (parents.empty())
-    return kNullEntity;
-
-  // TODO(louise) Do we want to support multiple parents?
-  return parents.begin()->first;
+  const EntitySlot *slot = this->dataPtr->entityTable.Find(_entity);
+  return nullptr == slot ? kNullEntity : slot->parent;
 }
 
 /////////////////////////////////////////////////
 bool EntityComponentManager::SetParentEntity(const Entity _child,
     const Entity _parent)
 {
-  // Remove current parent(s)
-  auto parents = this->Entities().AdjacentsTo(_child);
-  for (const auto &parent : parents)
+  // Remove current parent
+  EntitySlot *childSlot = this->dataPtr->entityTable.Find(_child);
+  if (nullptr != childSlot && kNullEntity != childSlot->parent)
   {
-    auto edge = this->dataPtr->entities.EdgeFromVertices(parent.first, _child);
+    auto edge = this->dataPtr->entities.EdgeFromVertices(childSlot->parent,
+        _child);
     this->dataPtr->entities.RemoveEdge(edge);
+    this->dataPtr->DetachFromParent(*childSlot);
   }
 
   // Leave parent-less
@@ -507,9 +1346,32 @@ bool EntityComponentManager::SetParentEntity(const Entity _child,
     return true;
   }
 
+  // Only update the parent index during a batch
+  if (this->dataPtr->batchDepth > 0)
+  {
+    EntitySlot *parentSlot = this->dataPtr->entityTable.Find(_parent);
+    if (nullptr == childSlot || !childSlot->alive ||
+        nullptr == parentSlot || !parentSlot->alive)
+    {
+      return false;
+    }
+    parentSlot->children.push_back(_child);
+    childSlot->parent = _parent;
+    this->dataPtr->InvalidateDescendants(_parent);
+    this->dataPtr->batchParentedEntities.push_back(_child);
+    return true;
+  }
+
   // Add edge
   auto edge = this->dataPtr->entities.AddEdge({_parent, _child}, true);
-  return (math::graph::kNullId != edge.Id());
+  if (math::graph::kNullId == edge.Id())
+    return false;
+
+  // Both entities exist, since the edge was added
+  this->dataPtr->entityTable.Find(_parent)->children.push_back(_child);
+  childSlot->parent = _parent;
+  this->dataPtr->InvalidateDescendants(_parent);
+  return true;
 }
 
 /////////////////////////////////////////////////
@@ -517,6 +1379,39 @@ ComponentKey EntityComponentManager::CreateComponentImplementation(
     const Entity _entity, const ComponentTypeId _componentTypeId,
     const components::BaseComponent *_data)
 {
+  auto storage = this->StorageForNewComponent(_entity, _componentTypeId);
+  if (nullptr == storage)
+    return ComponentKey();
+
+  return this->AddNewComponent(_entity, _componentTypeId, storage,
+      storage->Create(_data));
+}
+
+/////////////////////////////////////////////////
+ComponentKey EntityComponentManager::CreateComponentImplementation(
+    const Entity _entity, const ComponentTypeId _componentTypeId,
+    std::istream &_in)
+{
+  auto storage = this->StorageForNewComponent(_entity, _componentTypeId);
+  if (nullptr == storage)
+    return ComponentKey();
+
+  return this->AddNewComponent(_entity, _componentTypeId, storage,
+      storage->DeserializeInPlace(kComponentIdInvalid, _in));
+}
+
+/////////////////////////////////////////////////
+ComponentStorageBase *EntityComponentManager::StorageForNewComponent(
+    const Entity _entity, const ComponentTypeId _componentTypeId)
+{
+  if (this->dataPtr->lockFreeReads)
+  {
+    ignerr << "Creating component of type [" << _componentTypeId
+           << "] for entity [" << _entity << "] while lock-free reads are "
+           << "enabled. Components shouldn't be created during PostUpdate."
+           << std::endl;
+  }
+
   // If type hasn't been instantiated yet, create a storage for it
   if (!this->HasComponentType(_componentTypeId))
   {
@@ -525,26 +1420,46 @@ ComponentKey EntityComponentManager::CreateComponentImplementation(
       ignerr << "Failed to create component of type [" << _componentTypeId
              << "] for entity [" << _entity
              << "]. Type has not been properly registered." << std::endl;
-      return ComponentKey();
+      return nullptr;
     }
   }
 
-  // Instantiate the new component.
-  std::pair<ComponentId, bool> componentIdPair =
-    this->dataPtr->components[_componentTypeId]->Create(_data);
+  return this->dataPtr->components[_componentTypeId].get();
+}
 
+/////////////////////////////////////////////////
+ComponentKey EntityComponentManager::AddNewComponent(const Entity _entity,
+    const ComponentTypeId _componentTypeId, ComponentStorageBase *_storage,
+    const std::pair<ComponentId, bool> &_componentIdPair)
+{
+  const auto &componentIdPair = _componentIdPair;
   ComponentKey componentKey{_componentTypeId, componentIdPair.first};
 
-  this->dataPtr->entityComponents[_entity].insert(
-      {_componentTypeId, componentKey});
-  this->dataPtr->oneTimeChangedComponents.insert(componentKey);
+  // If the entity already has a component of this type, it keeps it
+  EntityRecord &record = this->dataPtr->CreateRecord(_entity);
+  if (record.archetype->Column(_componentTypeId) >=
+      record.archetype->types.size())
+  {
+    this->dataPtr->MoveEntity(_entity, record, _componentTypeId, true,
+        componentIdPair.first);
+  }
+  _storage->SetChanged(componentIdPair.first, _entity,
+      ComponentState::OneTimeChange);
   this->dataPtr->entityComponentsDirty = true;
+  ++this->dataPtr->structureVersion;
 
-  if (componentIdPair.second)
+  if (this->dataPtr->batchDepth > 0)
+  {
+    this->dataPtr->batchRebuildViews |= componentIdPair.second;
+    this->dataPtr->DeferUpdateViews(_entity);
+  }
+  else if (componentIdPair.second)
     this->RebuildViews();
   else
     this->UpdateViews(_entity);
 
+  this->UpdateNameIndex(_entity, _componentTypeId);
+
   return componentKey;
 }
 
@@ -552,38 +1467,23 @@ ComponentKey EntityComponentManager::CreateComponentImplementation(
 bool EntityComponentManager::EntityMatches(Entity _entity,
     const std::set<ComponentTypeId> &_types) const
 {
-  auto iter = this->dataPtr->entityComponents.find(_entity);
-  if (iter == this->dataPtr->entityComponents.end())
+  auto iter = this->dataPtr->FindRecord(_entity);
+  if (nullptr == iter)
     return false;
 
-  // \todo(nkoenig) The performance of this could be improved.
-  // It might be possible to create bitmask for component sets.
-  // Fixing this might not be high priority, unless we expect frequent
-  // creation of entities and/or queries.
-  for (const ComponentTypeId &type : _types)
-  {
-    auto typeIter = iter->second.find(type);
-    if (typeIter == iter->second.end())
-      return false;
-  }
-
-  return true;
+  return iter->archetype->Matches(_types);
 }
 
 /////////////////////////////////////////////////
 ComponentId EntityComponentManager::EntityComponentIdFromType(
     const Entity _entity, const ComponentTypeId _type) const
 {
-  auto ecIter = this->dataPtr->entityComponents.find(_entity);
+  auto ecIter = this->dataPtr->FindRecord(_entity);
 
-  if (ecIter == this->dataPtr->entityComponents.end())
+  if (nullptr == ecIter)
     return -1;
 
-  auto typeIter = ecIter->second.find(_type);
-  if (typeIter != ecIter->second.end())
-    return typeIter->second.second;
-
-  return -1;
+  return ecIter->Id(_type);
 }
 
 /////////////////////////////////////////////////
@@ -592,34 +1492,32 @@ const components::BaseComponent
     const Entity _entity, const ComponentTypeId _type) const
 {
   IGN_PROFILE("EntityComponentManager::ComponentImplementation");
-  auto ecIter = this->dataPtr->entityComponents.find(_entity);
+  auto ecIter = this->dataPtr->FindRecord(_entity);
 
-  if (ecIter == this->dataPtr->entityComponents.end())
+  if (nullptr == ecIter)
     return nullptr;
 
-  auto typeIter = ecIter->second.find(_type);
-  if (typeIter != ecIter->second.end())
-    return this->dataPtr->components.at(typeIter->second.first)->Component(
-        typeIter->second.second);
+  const std::size_t column = ecIter->archetype->Column(_type);
+  if (column >= ecIter->archetype->types.size())
+    return nullptr;
 
-  return nullptr;
+  return ecIter->archetype->storages[column]->Component(ecIter->IdAt(column));
 }
 
 /////////////////////////////////////////////////
 components::BaseComponent *EntityComponentManager::ComponentImplementation(
     const Entity _entity, const ComponentTypeId _type)
 {
-  auto ecIter = this->dataPtr->entityComponents.find(_entity);
+  auto ecIter = this->dataPtr->FindRecord(_entity);
 
-  if (ecIter == this->dataPtr->entityComponents.end())
+  if (nullptr == ecIter)
     return nullptr;
 
-  auto typeIter = ecIter->second.find(_type);
-  if (typeIter != ecIter->second.end())
-    return this->dataPtr->components.at(typeIter->second.first)->Component(
-        typeIter->second.second);
+  const std::size_t column = ecIter->archetype->Column(_type);
+  if (column >= ecIter->archetype->types.size())
+    return nullptr;
 
-  return nullptr;
+  return ecIter->archetype->storages[column]->Component(ecIter->IdAt(column));
 }
 
 /////////////////////////////////////////////////
@@ -647,6 +1545,18 @@ components::BaseComponent *EntityComponentManager::ComponentImplementation(
   return nullptr;
 }
 
+/////////////////////////////////////////////////
+const components::BaseComponent *EntityComponentManager::ComponentByTypeIndex(
+    const std::size_t _typeIndex, const ComponentId _id) const
+{
+  if (_typeIndex >= this->dataPtr->storagesByIndex.size())
+    return nullptr;
+
+  const ComponentStorageBase *storage =
+      this->dataPtr->storagesByIndex[_typeIndex];
+  return nullptr == storage ? nullptr : storage->Component(_id);
+}
+
 /////////////////////////////////////////////////
 bool EntityComponentManager::HasComponentType(
     const ComponentTypeId _typeId) const
@@ -668,6 +1578,13 @@ bool EntityComponentManagerPrivate::CreateComponentStorage(
     return false;
   }
 
+  storage->SetLockFreeReads(this->lockFreeReads);
+
+  const std::size_t index = components::Factory::Instance()->TypeIndex(_typeId);
+  if (index >= this->storagesByIndex.size())
+    this->storagesByIndex.resize(index + 1, nullptr);
+  this->storagesByIndex[index] = storage.get();
+
   this->components[_typeId] = std::move(storage);
   igndbg << "Using components of type [" << _typeId << "] / ["
          << components::Factory::Instance()->Name(_typeId) << "].\n";
@@ -675,6 +1592,107 @@ bool EntityComponentManagerPrivate::CreateComponentStorage(
   return true;
 }
 
+/////////////////////////////////////////////////
+EntityRecord *EntityComponentManagerPrivate::FindRecord(const Entity _entity)
+{
+  EntitySlot *slot = this->entityTable.Find(_entity);
+  if (nullptr == slot || nullptr == slot->record.archetype)
+    return nullptr;
+  return &slot->record;
+}
+
+/////////////////////////////////////////////////
+EntityRecord &EntityComponentManagerPrivate::CreateRecord(const Entity _entity)
+{
+  EntityRecord &record = this->entityTable.Insert(_entity).record;
+  if (nullptr == record.archetype)
+  {
+    record.archetype = this->FindArchetype({});
+    record.archetype->entities.push_back(_entity);
+    record.row = record.archetype->entities.size() - 1;
+  }
+  return record;
+}
+
+/////////////////////////////////////////////////
+Archetype *EntityComponentManagerPrivate::FindArchetype(
+    const std::vector<ComponentTypeId> &_types)
+{
+  auto &archetype = this->archetypes[_types];
+  if (nullptr == archetype)
+  {
+    archetype = std::make_unique<Archetype>();
+    archetype->types = _types;
+    archetype->signature = typeMask(_types);
+
+    // Storages are created before entities get components of their type
+    for (const ComponentTypeId type : _types)
+      archetype->storages.push_back(this->components.at(type).get());
+  }
+  return archetype.get();
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManagerPrivate::MoveEntity(const Entity _entity,
+    EntityRecord &_record, const ComponentTypeId _typeId, bool _add,
+    ComponentId _id)
+{
+  Archetype *from = _record.archetype;
+
+  // Entities usually get the same components in the same order, so the
+  // target archetype is cached on the edges of the graph of archetypes
+  auto &edges = _add ? from->addEdges : from->removeEdges;
+  auto edgeIter = edges.find(_typeId);
+  Archetype *to{nullptr};
+  if (edgeIter != edges.end())
+  {
+    to = edgeIter->second;
+  }
+  else
+  {
+    std::vector<ComponentTypeId> types = from->types;
+    auto typeIter = std::lower_bound(types.begin(), types.end(), _typeId);
+    if (_add)
+      types.insert(typeIter, _typeId);
+    else
+      types.erase(typeIter);
+
+    to = this->FindArchetype(types);
+    edges[_typeId] = to;
+    (_add ? to->removeEdges : to->addEdges)[_typeId] = from;
+  }
+
+  // Append the entity's components to the target archetype
+  to->entities.push_back(_entity);
+  for (const ComponentTypeId type : to->types)
+  {
+    to->componentIds.push_back(type == _typeId ? _id : _record.Id(type));
+  }
+
+  this->RemoveFromArchetype(_record);
+  _record.archetype = to;
+  _record.row = to->entities.size() - 1;
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManagerPrivate::RemoveFromArchetype(
+    const EntityRecord &_record)
+{
+  Archetype *archetype = _record.archetype;
+  const std::size_t typeCount = archetype->types.size();
+  const std::size_t last = archetype->entities.size() - 1;
+  if (_record.row != last)
+  {
+    const Entity moved = archetype->entities[last];
+    archetype->entities[_record.row] = moved;
+    std::copy_n(archetype->componentIds.begin() + last * typeCount, typeCount,
+        archetype->componentIds.begin() + _record.row * typeCount);
+    this->FindRecord(moved)->row = _record.row;
+  }
+  archetype->entities.pop_back();
+  archetype->componentIds.resize(last * typeCount);
+}
+
 /////////////////////////////////////////////////
 components::BaseComponent *EntityComponentManager::First(
     const ComponentTypeId _componentTypeId)
@@ -694,34 +1712,35 @@ const EntityGraph &EntityComponentManager::Entities() const
 }
 
 //////////////////////////////////////////////////
-bool EntityComponentManager::FindView(const std::set<ComponentTypeId> &_types,
-    std::map<detail::ComponentTypeKey, detail::View>::iterator &_iter) const
+bool EntityComponentManager::FindView(const detail::ViewKey &_key,
+    std::map<detail::ViewKey, detail::View>::iterator &_iter) const
 {
-  std::lock_guard<std::mutex> lockViews(this->dataPtr->viewsMutex);
-  _iter = this->dataPtr->views.find(_types);
+  std::shared_lock<std::shared_mutex> lockViews(this->dataPtr->viewsMutex);
+  _iter = this->dataPtr->views.find(_key);
   return _iter != this->dataPtr->views.end();
 }
 
 //////////////////////////////////////////////////
-std::map<detail::ComponentTypeKey, detail::View>::iterator
-    EntityComponentManager::AddView(const std::set<ComponentTypeId> &_types,
+std::map<detail::ViewKey, detail::View>::iterator
+    EntityComponentManager::AddView(const detail::ViewKey &_key,
     detail::View &&_view) const
 {
   // If the view already exists, then the map will return the iterator to
   // the location that prevented the insertion.
-  std::lock_guard<std::mutex> lockViews(this->dataPtr->viewsMutex);
+  std::unique_lock<std::shared_mutex> lockViews(this->dataPtr->viewsMutex);
   return this->dataPtr->views.insert(
-      std::make_pair(_types, std::move(_view))).first;
+      std::make_pair(_key, std::move(_view))).first;
 }
 
 //////////////////////////////////////////////////
 void EntityComponentManager::UpdateViews(const Entity _entity)
 {
   IGN_PROFILE("EntityComponentManager::UpdateViews");
+  const EntityRecord *record = this->dataPtr->FindRecord(_entity);
   for (auto &view : this->dataPtr->views)
   {
     // Add/update the entity if it matches the view.
-    if (this->EntityMatches(_entity, view.first))
+    if (nullptr != record && record->archetype->Matches(view.second))
     {
       view.second.AddEntity(_entity, this->IsNewEntity(_entity));
       // If there is a request to delete this entity, update the view as
@@ -730,15 +1749,16 @@ void EntityComponentManager::UpdateViews(const Entity _entity)
       {
         view.second.AddEntityToRemoved(_entity);
       }
-      for (const ComponentTypeId &compTypeId : view.first)
+      // Optional components the entity lacks are reset to invalid ids
+      for (const ComponentTypeId &compTypeId : view.second.componentTypes)
       {
         view.second.AddComponent(_entity, compTypeId,
-            this->EntityComponentIdFromType(_entity, compTypeId));
+            record->Id(compTypeId));
       }
     }
     else
     {
-      view.second.RemoveEntity(_entity, view.first);
+      view.second.RemoveEntity(_entity, view.first.required);
     }
   }
 }
@@ -749,31 +1769,50 @@ void EntityComponentManager::RebuildViews()
   IGN_PROFILE("EntityComponentManager::RebuildViews");
   for (auto &view : this->dataPtr->views)
   {
-    view.second.entities.clear();
-    view.second.components.clear();
-    // Add all the entities that match the component types to the
-    // view.
-    for (const auto &vertex : this->dataPtr->entities.Vertices())
+    view.second.ClearEntities();
+    this->PopulateView(view.first, view.second);
+  }
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManager::PopulateView(
+    const detail::ViewKey &_key, detail::View &_view) const
+{
+  IGN_PROFILE("EntityComponentManager::PopulateView");
+
+  _view.requiredMask = typeMask(_key.required);
+  _view.excludedMask = typeMask(_key.excluded);
+
+  // Gather the rows of all archetypes which match the view's key, in entity
+  // order so that each entity is appended to the view
+  std::vector<std::pair<Entity, const EntityRecord *>> matches;
+  for (const auto &archetype : this->dataPtr->archetypes)
+  {
+    if (!archetype.second->Matches(_view))
+      continue;
+
+    for (Entity entity : archetype.second->entities)
     {
-      Entity entity = vertex.first;
-      if (this->EntityMatches(entity, view.first))
-      {
-        view.second.AddEntity(entity, this->IsNewEntity(entity));
-        // If there is a request to delete this entity, update the view as
-        // well
-        if (this->IsMarkedForRemoval(entity))
-        {
-          view.second.AddEntityToRemoved(entity);
-        }
-        // Store pointers to all the components. This recursively adds
-        // all the ComponentTypeTs that belong to the entity to the view.
-        for (const ComponentTypeId &compTypeId : view.first)
-        {
-          view.second.AddComponent(entity, compTypeId,
-              this->EntityComponentIdFromType(
-                entity, compTypeId));
-        }
-      }
+      matches.emplace_back(entity,
+          this->dataPtr->FindRecord(entity));
+    }
+  }
+  std::sort(matches.begin(), matches.end(),
+      [](const auto &_a, const auto &_b) {return _a.first < _b.first;});
+
+  for (const auto &match : matches)
+  {
+    const Entity entity = match.first;
+    _view.AddEntity(entity, this->IsNewEntity(entity));
+    // If there is a request to delete this entity, update the view as
+    // well
+    if (this->IsMarkedForRemoval(entity))
+    {
+      _view.AddEntityToRemoved(entity);
+    }
+    for (const ComponentTypeId &compTypeId : _view.componentTypes)
+    {
+      _view.AddComponent(entity, compTypeId, match.second->Id(compTypeId));
     }
   }
 }
@@ -783,7 +1822,7 @@ void EntityComponentManagerPrivate::SetRemovedComponentsMsgs(Entity &_entity,
     msgs::SerializedEntity *_entityMsg,
     const std::unordered_set<ComponentTypeId> &_types)
 {
-  std::lock_guard<std::mutex> lock(this->removedComponentsMutex);
+  auto lock = this->ReadLock(this->removedComponentsMutex);
   auto entRemovedComps = this->removedComponents.equal_range(_entity);
   for (auto it = entRemovedComps.first; it != entRemovedComps.second; ++it)
   {
@@ -808,23 +1847,21 @@ void EntityComponentManagerPrivate::SetRemovedComponentsMsgs(Entity &_entity,
     msgs::SerializedStateMap &_msg,
     const std::unordered_set<ComponentTypeId> &_types)
 {
-  std::lock_guard<std::mutex> lock(this->removedComponentsMutex);
+  auto lock = this->ReadLock(this->removedComponentsMutex);
   uint64_t nEntityKeys = this->removedComponents.count(_entity);
   if (nEntityKeys == 0)
     return;
 
   // The message need not necessarily contain the entity initially. For
   // instance, when AddEntityToMessage() calls this function, the entity may
-  // have some removed components but none in entityComponents that changed,
+  // have some removed components but none of its components changed,
   // so the entity may not have been added to the message beforehand.
   auto entIter = _msg.mutable_entities()->find(_entity);
   if (entIter == _msg.mutable_entities()->end())
   {
-    msgs::SerializedEntityMap ent;
-    ent.set_id(_entity);
-    entIter =
-      (_msg.mutable_entities())->insert({static_cast<uint64_t>(_entity), ent})
-      .first;
+    (*_msg.mutable_entities())[static_cast<uint64_t>(_entity)].set_id(
+        _entity);
+    entIter = _msg.mutable_entities()->find(_entity);
   }
 
   auto entRemovedComps = this->removedComponents.equal_range(_entity);
@@ -837,15 +1874,84 @@ void EntityComponentManagerPrivate::SetRemovedComponentsMsgs(Entity &_entity,
       continue;
     }
 
-    msgs::SerializedComponent compMsg;
+    // Build the message in place, so it's allocated on the state message's
+    // arena if it has one
+    auto &compMsg = (*(entIter->second.mutable_components()))[
+      static_cast<int64_t>(removedComponent.first)];
+
+    // Empty data is needed for the component to be processed afterwards
+    compMsg.set_component(" ");
+    compMsg.set_type(removedComponent.first);
+    compMsg.set_remove(true);
+  }
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::AddChangesToMessage(
+    msgs::SerializedStateMap &_msg,
+    const std::unordered_set<ComponentTypeId> &_types,
+    const std::unordered_set<Entity> &_entities)
+{
+  auto included = [&_entities](Entity _entity)
+  {
+    return _entities.empty() || _entities.find(_entity) != _entities.end();
+  };
+
+  auto entityMsg = [&_msg](Entity _entity) -> msgs::SerializedEntityMap &
+  {
+    auto &ent = (*_msg.mutable_entities())[static_cast<uint64_t>(_entity)];
+    ent.set_id(_entity);
+    return ent;
+  };
+
+  // Entities being removed
+  for (const auto &entity : this->toRemoveEntities)
+  {
+    if (included(entity) && nullptr != this->FindRecord(entity))
+      entityMsg(entity).set_remove(true);
+  }
+
+  // Changed components
+  for (const auto &storage : this->components)
+  {
+    if (!_types.empty() && _types.find(storage.first) == _types.end())
+      continue;
+
+    for (const auto &changed : storage.second->ChangedComponents())
+    {
+      if (storage.second->Changed(changed.first) == ComponentState::NoChange ||
+          !included(changed.second))
+      {
+        continue;
+      }
+
+      const components::BaseComponent *compBase =
+          storage.second->Component(changed.first);
+
+      auto &cmp = (*entityMsg(changed.second).mutable_components())[
+          static_cast<int64_t>(storage.first)];
+      cmp.set_type(compBase->TypeId());
 
-    // Empty data is needed for the component to be processed afterwards
-    compMsg.set_component(" ");
-    compMsg.set_type(removedComponent.first);
-    compMsg.set_remove(true);
+      std::ostringstream ostr;
+      compBase->Serialize(ostr);
+      cmp.set_component(ostr.str());
+    }
+  }
 
-    (*(entIter->second.mutable_components()))[
-      static_cast<int64_t>(removedComponent.first)] = compMsg;
+  // Removed components
+  std::unordered_set<Entity> removedEntities;
+  {
+    auto lock = this->ReadLock(this->removedComponentsMutex);
+    for (const auto &removed : this->removedComponents)
+    {
+      if (included(removed.first))
+        removedEntities.insert(removed.first);
+    }
+  }
+  for (Entity entity : removedEntities)
+  {
+    if (nullptr != this->FindRecord(entity))
+      this->SetRemovedComponentsMsgs(entity, _msg, _types);
   }
 }
 
@@ -855,8 +1961,8 @@ void EntityComponentManager::AddEntityToMessage(msgs::SerializedState &_msg,
 {
   auto entityMsg = _msg.add_entities();
   entityMsg->set_id(_entity);
-  auto iter = this->dataPtr->entityComponents.find(_entity);
-  if (iter == this->dataPtr->entityComponents.end())
+  auto iter = this->dataPtr->FindRecord(_entity);
+  if (nullptr == iter)
     return;
 
   if (this->dataPtr->toRemoveEntities.find(_entity) !=
@@ -870,25 +1976,21 @@ void EntityComponentManager::AddEntityToMessage(msgs::SerializedState &_msg,
   auto types = _types;
   if (types.empty())
   {
-    for (auto &type : this->dataPtr->entityComponents[_entity])
-    {
-      types.insert(type.first);
-    }
+    types.insert(iter->archetype->types.begin(),
+        iter->archetype->types.end());
   }
 
   for (const ComponentTypeId type : types)
   {
     // If the entity does not have the component, continue
-    std::unordered_map<ComponentTypeId, ComponentKey>::iterator typeIter =
-      iter->second.find(type);
-    if (typeIter == iter->second.end())
+    const ComponentId id = iter->Id(type);
+    if (id < 0)
     {
       continue;
     }
-    ComponentKey comp = (typeIter->second);
 
     auto compMsg = entityMsg->add_components();
-    auto compBase = this->ComponentImplementation(_entity, comp.first);
+    auto compBase = this->dataPtr->components.at(type)->Component(id);
     compMsg->set_type(compBase->TypeId());
 
     std::ostringstream ostr;
@@ -907,8 +2009,8 @@ void EntityComponentManager::AddEntityToMessage(msgs::SerializedStateMap &_msg,
     Entity _entity, const std::unordered_set<ComponentTypeId> &_types,
     bool _full) const
 {
-  auto iter = this->dataPtr->entityComponents.find(_entity);
-  if (iter == this->dataPtr->entityComponents.end())
+  auto iter = this->dataPtr->FindRecord(_entity);
+  if (nullptr == iter)
     return;
 
   // Set the default entity iterator to the end. This will allow us to know
@@ -923,9 +2025,8 @@ void EntityComponentManager::AddEntityToMessage(msgs::SerializedStateMap &_msg,
     entIter = _msg.mutable_entities()->find(_entity);
     if (entIter == _msg.mutable_entities()->end())
     {
-      msgs::SerializedEntityMap ent;
-      ent.set_id(_entity);
-      (*_msg.mutable_entities())[static_cast<uint64_t>(_entity)] = ent;
+      (*_msg.mutable_entities())[static_cast<uint64_t>(_entity)].set_id(
+          _entity);
       entIter = _msg.mutable_entities()->find(_entity);
     }
 
@@ -937,32 +2038,26 @@ void EntityComponentManager::AddEntityToMessage(msgs::SerializedStateMap &_msg,
   auto types = _types;
   if (types.empty())
   {
-    for (auto &type : this->dataPtr->entityComponents[_entity])
-    {
-      types.insert(type.first);
-    }
+    types.insert(iter->archetype->types.begin(),
+        iter->archetype->types.end());
   }
 
   // Empty means all types
   for (const ComponentTypeId type : types)
   {
-    std::unordered_map<ComponentTypeId, ComponentKey>::iterator typeIter =
-      iter->second.find(type);
-    if (typeIter == iter->second.end())
+    const ComponentId id = iter->Id(type);
+    if (id < 0)
     {
       continue;
     }
 
-    ComponentKey comp = typeIter->second;
-    const components::BaseComponent *compBase =
-      this->ComponentImplementation(_entity, comp.first);
+    ComponentKey comp{type, id};
+    const ComponentStorageBase *storage =
+      this->dataPtr->components.at(type).get();
+    const components::BaseComponent *compBase = storage->Component(id);
 
     // If not sending full state, skip unchanged components
-    if (!_full &&
-        this->dataPtr->oneTimeChangedComponents.find(comp) ==
-        this->dataPtr->oneTimeChangedComponents.end() &&
-        this->dataPtr->periodicChangedComponents.find(comp) ==
-        this->dataPtr->periodicChangedComponents.end())
+    if (!_full && storage->Changed(id) == ComponentState::NoChange)
     {
       continue;
     }
@@ -974,9 +2069,8 @@ void EntityComponentManager::AddEntityToMessage(msgs::SerializedStateMap &_msg,
       entIter = _msg.mutable_entities()->find(_entity);
       if (entIter == _msg.mutable_entities()->end())
       {
-        msgs::SerializedEntityMap ent;
-        ent.set_id(_entity);
-        (*_msg.mutable_entities())[static_cast<uint64_t>(_entity)] = ent;
+        (*_msg.mutable_entities())[static_cast<uint64_t>(_entity)].set_id(
+            _entity);
         entIter = _msg.mutable_entities()->find(_entity);
       }
     }
@@ -986,10 +2080,8 @@ void EntityComponentManager::AddEntityToMessage(msgs::SerializedStateMap &_msg,
     // message if it's not present.
     if (compIter == entIter->second.mutable_components()->end())
     {
-      msgs::SerializedComponent cmp;
-      cmp.set_type(compBase->TypeId());
       (*(entIter->second.mutable_components()))[
-        static_cast<int64_t>(comp.first)] = cmp;
+        static_cast<int64_t>(comp.first)].set_type(compBase->TypeId());
       compIter = entIter->second.mutable_components()->find(comp.first);
     }
 
@@ -1048,47 +2140,19 @@ void EntityComponentManager::ChangedState(
 //////////////////////////////////////////////////
 void EntityComponentManagerPrivate::CalculateStateThreadLoad()
 {
-  // If the entity component vector is dirty, we need to recalculate the
-  // threads and each threads work load
+  // If the entities with components changed, we need to recalculate the
+  // entities processed by the threads
   if (!this->entityComponentsDirty)
     return;
 
   this->entityComponentsDirty = false;
-  this->entityComponentIterators.clear();
-  auto startIt = this->entityComponents.begin();
-  int numComponents = this->entityComponents.size();
-
-  // Set the number of threads to spawn to the min of the calculated thread
-  // count or max threads that the hardware supports
-  int maxThreads = std::thread::hardware_concurrency();
-  uint64_t numThreads = std::min(numComponents, maxThreads);
-
-  int componentsPerThread = std::ceil(static_cast<double>(numComponents) /
-    numThreads);
-
-  igndbg << "Updated state thread iterators: " << numThreads
-         << " threads processing around " << componentsPerThread
-         << " components each." << std::endl;
-
-  // Push back the starting iterator
-  this->entityComponentIterators.push_back(startIt);
-  for (uint64_t i = 0; i < numThreads; ++i)
-  {
-    // If we have added all of the components to the iterator vector, we are
-    // done so push back the end iterator
-    numComponents -= componentsPerThread;
-    if (numComponents <= 0)
-    {
-      this->entityComponentIterators.push_back(
-          this->entityComponents.end());
-      break;
-    }
-
-    // Get the iterator to the next starting group of components
-    auto nextIt = std::next(startIt, componentsPerThread);
-    this->entityComponentIterators.push_back(nextIt);
-    startIt = nextIt;
+  this->stateEntities.clear();
+  for (const auto &archetype : this->archetypes)
+  {
+    this->stateEntities.insert(this->stateEntities.end(),
+        archetype.second->entities.begin(), archetype.second->entities.end());
   }
+  std::sort(this->stateEntities.begin(), this->stateEntities.end());
 }
 
 //////////////////////////////////////////////////
@@ -1097,9 +2161,9 @@ ignition::msgs::SerializedState EntityComponentManager::State(
     const std::unordered_set<ComponentTypeId> &_types) const
 {
   ignition::msgs::SerializedState stateMsg;
-  for (const auto &it : this->dataPtr->entityComponents)
+  this->dataPtr->CalculateStateThreadLoad();
+  for (const Entity entity : this->dataPtr->stateEntities)
   {
-    auto entity = it.first;
     if (!_entities.empty() && _entities.find(entity) == _entities.end())
     {
       continue;
@@ -1118,46 +2182,65 @@ void EntityComponentManager::State(
     const std::unordered_set<ComponentTypeId> &_types,
     bool _full) const
 {
-  std::mutex stateMapMutex;
-  std::vector<std::thread> workers;
+  // Incremental state only needs the changed components, so visit the
+  // storages' lists of changed components instead of every entity.
+  if (!_full)
+  {
+    this->dataPtr->AddChangesToMessage(_state, _types, _entities);
+    return;
+  }
 
   this->dataPtr->CalculateStateThreadLoad();
 
-  auto functor = [&](auto itStart, auto itEnd)
+  // Each chunk of entities is serialized into its own preallocated map, so
+  // the workers don't need to synchronize with each other. The maps are on
+  // the same arena as the output, if any, so that moving their entities into
+  // the output doesn't copy them.
+  // There are as many chunks as threads in the task pool, counting the
+  // calling thread, or fewer if there aren't enough entities.
+  const auto &entities = this->dataPtr->stateEntities;
+  const std::size_t numChunks = std::min<std::size_t>(entities.size(),
+      this->dataPtr->Pool().ThreadCount() + 1);
+  const std::size_t chunkSize = numChunks == 0 ? 0 :
+      (entities.size() + numChunks - 1) / numChunks;
+  std::vector<msgs::SerializedStateMap> heapMaps;
+  std::vector<msgs::SerializedStateMap *> chunkMaps(numChunks);
+  google::protobuf::Arena *arena = _state.GetArena();
+  if (nullptr == arena)
+    heapMaps.resize(numChunks);
+  for (std::size_t chunk = 0; chunk < numChunks; ++chunk)
   {
-    msgs::SerializedStateMap threadMap;
-    while (itStart != itEnd)
-    {
-      auto entity = (*itStart).first;
-      if (_entities.empty() || _entities.find(entity) != _entities.end())
+    chunkMaps[chunk] = nullptr == arena ? &heapMaps[chunk] :
+        google::protobuf::Arena::Create<msgs::SerializedStateMap>(arena);
+  }
+
+  this->dataPtr->Pool().ParallelFor(numChunks, 1,
+      [&](std::size_t _begin, std::size_t _end)
       {
-        this->AddEntityToMessage(threadMap, entity, _types, _full);
-      }
-      itStart++;
-    }
-    std::lock_guard<std::mutex> lock(stateMapMutex);
+        for (std::size_t chunk = _begin; chunk < _end; ++chunk)
+        {
+          const std::size_t end =
+              std::min(entities.size(), (chunk + 1) * chunkSize);
+          for (std::size_t i = chunk * chunkSize; i < end; ++i)
+          {
+            const Entity entity = entities[i];
+            if (_entities.empty() || _entities.find(entity) != _entities.end())
+            {
+              this->AddEntityToMessage(*chunkMaps[chunk], entity, _types,
+                  _full);
+            }
+          }
+        }
+      });
 
-    for (const auto &entity : threadMap.entities())
+  // Move the serialized entities into the output message
+  for (auto *chunkMap : chunkMaps)
+  {
+    for (auto &entity : *chunkMap->mutable_entities())
     {
-      (*_state.mutable_entities())[static_cast<uint64_t>(entity.first)] =
-          entity.second;
+      (*_state.mutable_entities())[entity.first].Swap(&entity.second);
     }
-  };
-
-  // Spawn workers
-  uint64_t numThreads = this->dataPtr->entityComponentIterators.size() - 1;
-  for (uint64_t i = 0; i < numThreads; i++)
-  {
-    workers.push_back(std::thread(functor,
-        this->dataPtr->entityComponentIterators[i],
-        this->dataPtr->entityComponentIterators[i+1]));
   }
-
-  // Wait for each thread to finish processing its components
-  std::for_each(workers.begin(), workers.end(), [](std::thread &_t)
-  {
-    _t.join();
-  });
 }
 
 //////////////////////////////////////////////////
@@ -1214,21 +2297,7 @@ void EntityComponentManager::SetState(
         continue;
       }
 
-      // Create component
-      auto newComp = components::Factory::Instance()->New(compMsg.type());
-
-      if (nullptr == newComp)
-      {
-        ignerr << "Failed to deserialize component of type [" << compMsg.type()
-               << "]" << std::endl;
-        continue;
-      }
-
-      std::istringstream istr(compMsg.component());
-      newComp->Deserialize(istr);
-
-      // Get type id
-      auto typeId = newComp->TypeId();
+      const ComponentTypeId typeId = type;
 
       // TODO(louise) Move into if, see TODO below
       this->RemoveComponent(entity, typeId);
@@ -1242,10 +2311,11 @@ void EntityComponentManager::SetState(
       // Get Component
       auto comp = this->ComponentImplementation(entity, typeId);
 
-      // Create if new
+      // Create if new, deserialized directly into its storage
       if (nullptr == comp)
       {
-        this->CreateComponentImplementation(entity, typeId, newComp.get());
+        std::istringstream istr(compMsg.component());
+        this->CreateComponentImplementation(entity, typeId, istr);
       }
       // Update component value
       else
@@ -1267,7 +2337,42 @@ void EntityComponentManager::SetState(
     const ignition::msgs::SerializedStateMap &_stateMsg)
 {
   IGN_PROFILE("EntityComponentManager::SetState Map");
-  // Create / remove / update entities
+
+  // Note on merging forward:
+  // `has_one_time_component_changes` field is available in Edifice so
+  // this workaround can be removed
+  auto flag = ComponentState::PeriodicChange;
+  for (int i = 0; i < _stateMsg.header().data_size(); ++i)
+  {
+    if (_stateMsg.header().data(i).key() ==
+        "has_one_time_component_changes")
+    {
+      int v = stoi(_stateMsg.header().data(i).value(0));
+      if (v)
+        flag = ComponentState::OneTimeChange;
+      break;
+    }
+  }
+
+  // Updates of existing components, grouped by type so that each type's
+  // storage is resolved once and the types can be deserialized in parallel.
+  // Ids are kept instead of pointers because creating components may
+  // reallocate a storage.
+  struct ComponentUpdate
+  {
+    Entity entity;
+    ComponentId id;
+    const std::string *data;
+  };
+  std::unordered_map<ComponentTypeId, std::vector<ComponentUpdate>> updates;
+
+  // Views are updated once, after all entities and components are in place
+  this->BeginBatch();
+
+  // Reused for all new components, so its buffer isn't reallocated each time
+  std::istringstream istr;
+
+  // Create / remove entities and components, collect updates
   for (const auto &iter : _stateMsg.entities())
   {
     const auto &entityMsg = iter.second;
@@ -1287,6 +2392,9 @@ void EntityComponentManager::SetState(
       this->dataPtr->CreateEntityImplementation(entity);
     }
 
+    // Found once per entity, and again after its components change
+    EntityRecord *record{nullptr};
+
     // Create / remove / update components
     for (const auto &compIter : iter.second.components())
     {
@@ -1320,56 +2428,75 @@ void EntityComponentManager::SetState(
       if (compMsg.remove())
       {
         this->RemoveComponent(entity, compIter.first);
+        record = nullptr;
         continue;
       }
 
-      // Get Component
-      components::BaseComponent *comp =
-        this->ComponentImplementation(entity, compIter.first);
-
-      // Create if new
-      if (nullptr == comp)
+      // Update component value
+      if (nullptr == record)
+        record = this->dataPtr->FindRecord(entity);
+      const ComponentId id =
+          nullptr == record ? -1 : record->Id(compIter.first);
+      if (id >= 0)
       {
-        // Create component
-        auto newComp = components::Factory::Instance()->New(compMsg.type());
+        updates[compIter.first].push_back({entity, id, &compMsg.component()});
+        continue;
+      }
 
-        if (nullptr == newComp)
-        {
-          ignerr << "Failed to create component of type [" << compMsg.type()
-            << "]" << std::endl;
-          continue;
-        }
+      // Create component, deserialized directly into its storage
+      istr.clear();
+      istr.str(compMsg.component());
+      this->CreateComponentImplementation(entity, compIter.first, istr);
+      record = nullptr;
+    }
+  }
 
-        std::istringstream istr(compMsg.component());
-        newComp->Deserialize(istr);
+  // Deserialize the updates, one task per type. Each storage is only
+  // touched by one thread, so its lock isn't contended.
+  std::vector<std::pair<ComponentStorageBase *,
+      const std::vector<ComponentUpdate> *>> groups;
+  groups.reserve(updates.size());
+  for (const auto &typeUpdates : updates)
+  {
+    auto storageIter = this->dataPtr->components.find(typeUpdates.first);
+    if (storageIter != this->dataPtr->components.end())
+      groups.emplace_back(storageIter->second.get(), &typeUpdates.second);
+  }
 
-        this->CreateComponentImplementation(entity,
-            newComp->TypeId(), newComp.get());
-      }
-      // Update component value
-      else
+  this->dataPtr->Pool().ParallelFor(groups.size(), 1,
+      [&](std::size_t _begin, std::size_t _end)
       {
-        std::istringstream istr(compMsg.component());
-        comp->Deserialize(istr);
-        // Note on merging forward:
-        // `has_one_time_component_changes` field is available in Edifice so
-        // this workaround can be removed
-        auto flag = ComponentState::PeriodicChange;
-        for (int i = 0; i < _stateMsg.header().data_size(); ++i)
+        std::istringstream groupIstr;
+        for (std::size_t g = _begin; g < _end; ++g)
         {
-          if (_stateMsg.header().data(i).key() ==
-              "has_one_time_component_changes")
+          ComponentStorageBase *storage = groups[g].first;
+          for (const auto &update : *groups[g].second)
           {
-            int v = stoi(_stateMsg.header().data(i).value(0));
-            if (v)
-              flag = ComponentState::OneTimeChange;
-            break;
+            groupIstr.clear();
+            groupIstr.str(*update.data);
+            if (kComponentIdInvalid ==
+                storage->DeserializeInPlace(update.id, groupIstr).first)
+            {
+              continue;
+            }
+            storage->SetChanged(update.id, update.entity, flag);
           }
         }
-        this->SetChanged(entity, compIter.first, flag);
-      }
+      });
+
+  // The name index isn't thread safe, so it's updated afterwards
+  for (const auto &typeUpdates : updates)
+  {
+    if (typeUpdates.first != components::Name::typeId &&
+        typeUpdates.first != components::ParentEntity::typeId)
+    {
+      continue;
     }
+    for (const auto &update : typeUpdates.second)
+      this->UpdateNameIndex(update.entity, typeUpdates.first);
   }
+
+  this->CommitBatch();
 }
 
 //////////////////////////////////////////////////
@@ -1388,10 +2515,7 @@ std::unordered_set<Entity> EntityComponentManager::Descendants(Entity _entity)
   if (!this->HasEntity(_entity))
     return descendants;
 
-  auto descVector = math::graph::BreadthFirstSort(this->dataPtr->entities,
-      _entity);
-  std::move(descVector.begin(), descVector.end(), std::inserter(descendants,
-      descendants.end()));
+  this->dataPtr->InsertEntityRecursive(_entity, descendants);
 
   this->dataPtr->descendantCache[_entity] = descendants;
   return descendants;
@@ -1400,8 +2524,53 @@ std::unordered_set<Entity> EntityComponentManager::Descendants(Entity _entity)
 //////////////////////////////////////////////////
 void EntityComponentManager::SetAllComponentsUnchanged()
 {
-  this->dataPtr->periodicChangedComponents.clear();
-  this->dataPtr->oneTimeChangedComponents.clear();
+  for (auto &storage : this->dataPtr->components)
+  {
+    storage.second->ClearChanged();
+  }
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::SetLockFreeReads(bool _lockFree)
+{
+  this->dataPtr->lockFreeReads = _lockFree;
+  for (auto &storage : this->dataPtr->components)
+  {
+    storage.second->SetLockFreeReads(_lockFree);
+  }
+}
+
+/////////////////////////////////////////////////
+bool EntityComponentManager::LockFreeReads() const
+{
+  return this->dataPtr->lockFreeReads;
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::SetTaskPool(TaskPool *_pool)
+{
+  this->dataPtr->taskPool = _pool;
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::ParallelFor(std::size_t _count,
+    std::size_t _grainSize,
+    const std::function<void(std::size_t, std::size_t)> &_task) const
+{
+  IGN_PROFILE("EntityComponentManager::ParallelFor");
+
+  // Components can't be created or removed while the task runs, so the
+  // storages don't need to be locked on reads. During PostUpdate this is
+  // already the case, so leave it for the runner to restore.
+  const bool wasLockFree = this->dataPtr->lockFreeReads;
+  auto self = const_cast<EntityComponentManager *>(this);
+  if (!wasLockFree)
+    self->SetLockFreeReads(true);
+
+  this->dataPtr->Pool().ParallelFor(_count, _grainSize, _task);
+
+  if (!wasLockFree)
+    self->SetLockFreeReads(false);
 }
 
 /////////////////////////////////////////////////
@@ -1409,29 +2578,219 @@ void EntityComponentManager::SetChanged(
     const Entity _entity, const ComponentTypeId _type,
     gazebo::ComponentState _c)
 {
-  auto ecIter = this->dataPtr->entityComponents.find(_entity);
+  auto ecIter = this->dataPtr->FindRecord(_entity);
 
-  if (ecIter == this->dataPtr->entityComponents.end())
+  if (nullptr == ecIter)
     return;
 
-  auto typeIter = ecIter->second.find(_type);
-  if (typeIter == ecIter->second.end())
+  const ComponentId id = ecIter->Id(_type);
+  if (id < 0)
+    return;
+
+  this->dataPtr->components.at(_type)->SetChanged(id, _entity, _c);
+
+  // The data may have been modified in place
+  this->UpdateNameIndex(_entity, _type);
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::EachChangedImplementation(
+    const ComponentTypeId _typeId,
+    const std::function<bool(const Entity &,
+        const components::BaseComponent *,
+        gazebo::ComponentState)> &_f) const
+{
+  auto storageIter = this->dataPtr->components.find(_typeId);
+  if (storageIter == this->dataPtr->components.end())
     return;
 
-  if (_c == ComponentState::PeriodicChange)
+  const ComponentStorageBase *storage = storageIter->second.get();
+  for (const auto &changed : storage->ChangedComponents())
+  {
+    auto state = storage->Changed(changed.first);
+    if (state == ComponentState::NoChange)
+      continue;
+
+    if (!_f(changed.second, storage->Component(changed.first), state))
+      break;
+  }
+}
+
+/////////////////////////////////////////////////
+bool EntityComponentManager::HasChangedComponents(
+    const ComponentTypeId _typeId) const
+{
+  auto storageIter = this->dataPtr->components.find(_typeId);
+  if (storageIter == this->dataPtr->components.end())
+    return false;
+
+  return storageIter->second->OneTimeChangeCount() > 0 ||
+      storageIter->second->PeriodicChangeCount() > 0;
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::AddChangedEntities(
+    std::unordered_set<Entity> &_entities) const
+{
   {
-    this->dataPtr->periodicChangedComponents.insert(typeIter->second);
-    this->dataPtr->oneTimeChangedComponents.erase(typeIter->second);
+    auto lock = this->dataPtr->ReadLock(this->dataPtr->entityCreatedMutex);
+    _entities.insert(this->dataPtr->newlyCreatedEntities.begin(),
+        this->dataPtr->newlyCreatedEntities.end());
   }
-  else if (_c == ComponentState::OneTimeChange)
+
   {
-    this->dataPtr->periodicChangedComponents.erase(typeIter->second);
-    this->dataPtr->oneTimeChangedComponents.insert(typeIter->second);
+    auto lock = this->dataPtr->ReadLock(this->dataPtr->entityRemoveMutex);
+    if (this->dataPtr->removeAllEntities)
+    {
+      for (const auto &vertex : this->dataPtr->entities.Vertices())
+        _entities.insert(vertex.first);
+    }
+    _entities.insert(this->dataPtr->toRemoveEntities.begin(),
+        this->dataPtr->toRemoveEntities.end());
   }
-  else
+
+  for (const auto &storage : this->dataPtr->components)
+  {
+    for (const auto &changed : storage.second->ChangedComponents())
+    {
+      if (storage.second->Changed(changed.first) != ComponentState::NoChange)
+        _entities.insert(changed.second);
+    }
+  }
+
+  auto lock = this->dataPtr->ReadLock(this->dataPtr->removedComponentsMutex);
+  for (const auto &removed : this->dataPtr->removedComponents)
+    _entities.insert(removed.first);
+}
+
+/////////////////////////////////////////////////
+EcmMemoryUsage EntityComponentManager::MemoryUsage() const
+{
+  IGN_PROFILE("EntityComponentManager::MemoryUsage");
+
+  EcmMemoryUsage usage;
+
+  for (const auto &storage : this->dataPtr->components)
+  {
+    auto &type = usage.componentTypes[storage.first];
+    type.name = components::Factory::Instance()->Name(storage.first);
+    type.count = storage.second->Size();
+    type.bytes = storage.second->MemoryUsage();
+    usage.componentBytes += type.bytes;
+    usage.changeTrackingEntries +=
+        storage.second->ChangedComponents().size();
+  }
+
+  {
+    std::shared_lock<std::shared_mutex> lock(this->dataPtr->viewsMutex);
+    usage.viewCount = this->dataPtr->views.size();
+    usage.viewBytes = TreeContainerBytes(this->dataPtr->views);
+    for (const auto &view : this->dataPtr->views)
+    {
+      usage.viewBytes +=
+          TreeContainerBytes(view.first.required) +
+          TreeContainerBytes(view.first.excluded) +
+          TreeContainerBytes(view.first.optional) +
+          view.second.entities.capacity() * sizeof(Entity) +
+          view.second.componentTypes.capacity() * sizeof(ComponentTypeId) +
+          view.second.componentIds.capacity() * sizeof(ComponentId) +
+          TreeContainerBytes(view.second.newEntities) +
+          TreeContainerBytes(view.second.toRemoveEntities);
+    }
+  }
+
+  usage.archetypeCount = this->dataPtr->archetypes.size();
+  usage.archetypeBytes = TreeContainerBytes(this->dataPtr->archetypes);
+  for (const auto &archetype : this->dataPtr->archetypes)
+  {
+    usage.archetypeBytes +=
+        archetype.first.capacity() * sizeof(ComponentTypeId) +
+        archetype.second->MemoryUsage();
+  }
+
+  usage.entityTableBytes = this->dataPtr->entityTable.MemoryUsage() +
+      this->dataPtr->stateEntities.capacity() * sizeof(Entity);
+
+  // The name index is counted with the entity table
+  usage.entityTableBytes +=
+      HashContainerBytes(this->dataPtr->entitiesByName) +
+      HashContainerBytes(this->dataPtr->entitiesByParentName) +
+      HashContainerBytes(this->dataPtr->indexedNames);
+  for (const auto &entry : this->dataPtr->entitiesByName)
+  {
+    usage.entityTableBytes += entry.first.capacity() +
+        entry.second.capacity() * sizeof(Entity);
+  }
+  for (const auto &entry : this->dataPtr->entitiesByParentName)
+  {
+    usage.entityTableBytes += entry.first.second.capacity() +
+        entry.second.capacity() * sizeof(Entity);
+  }
+
+  usage.descendantCacheEntries = this->dataPtr->descendantCache.size();
+  usage.descendantCacheBytes =
+      HashContainerBytes(this->dataPtr->descendantCache);
+  for (const auto &entry : this->dataPtr->descendantCache)
+    usage.descendantCacheBytes += HashContainerBytes(entry.second);
+
+  // Changed components are tracked by each storage, so their lists are
+  // already part of the component bytes
+  usage.changeTrackingEntries += this->dataPtr->newlyCreatedEntities.size() +
+      this->dataPtr->toRemoveEntities.size();
+  usage.changeTrackingBytes =
+      HashContainerBytes(this->dataPtr->newlyCreatedEntities) +
+      HashContainerBytes(this->dataPtr->toRemoveEntities);
+
+  return usage;
+}
+
+/////////////////////////////////////////////////
+std::size_t EntityComponentManager::AddComponentObserver(
+    const ComponentTypeId _typeId,
+    std::function<void(const Entity &, const components::BaseComponent *,
+        gazebo::ComponentState)> _f)
+{
+  const std::size_t id = this->dataPtr->nextObserverId++;
+  this->dataPtr->componentObservers.emplace(id,
+      std::make_pair(_typeId, std::move(_f)));
+  return id;
+}
+
+/////////////////////////////////////////////////
+bool EntityComponentManager::RemoveComponentObserver(const std::size_t _id)
+{
+  return this->dataPtr->componentObservers.erase(_id) > 0;
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<SpatialIndex> EntityComponentManager::SharedSpatialIndex()
+    const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->spatialIndexMutex);
+  if (!this->dataPtr->spatialIndex)
+    this->dataPtr->spatialIndex = std::make_shared<SpatialIndex>();
+  return this->dataPtr->spatialIndex;
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::NotifyComponentObservers() const
+{
+  IGN_PROFILE("EntityComponentManager::NotifyComponentObservers");
+  for (const auto &observer : this->dataPtr->componentObservers)
   {
-    this->dataPtr->periodicChangedComponents.erase(typeIter->second);
-    this->dataPtr->oneTimeChangedComponents.erase(typeIter->second);
+    const ComponentTypeId typeId = observer.second.first;
+    if (!this->HasChangedComponents(typeId))
+      continue;
+
+    const auto &callback = observer.second.second;
+    this->EachChangedImplementation(typeId,
+        [&callback](const Entity &_entity,
+            const components::BaseComponent *_comp,
+            gazebo::ComponentState _state) -> bool
+        {
+          callback(_entity, _comp, _state);
+          return true;
+        });
   }
 }
 
@@ -1441,14 +2800,12 @@ std::unordered_set<ComponentTypeId> EntityComponentManager::ComponentTypes(
 {
   std::unordered_set<ComponentTypeId> result;
 
-  auto it = this->dataPtr->entityComponents.find(_entity);
-  if (it == this->dataPtr->entityComponents.end())
+  auto it = this->dataPtr->FindRecord(_entity);
+  if (nullptr == it)
     return result;
 
-  for (const auto &key : it->second)
-  {
-    result.insert(key.first);
-  }
+  result.insert(it->archetype->types.begin(),
+      it->archetype->types.end());
 
   return result;
 }
@@ -1464,4 +2821,147 @@ void EntityComponentManager::SetEntityCreateOffset(uint64_t _offset)
   }
 
   this->dataPtr->entityCount = _offset;
+
+  // Entities below the offset are created elsewhere, and may reuse slots
+  this->dataPtr->entityTable.SetRecycle(false);
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::SetEntityRecycling(bool _recycle)
+{
+  this->dataPtr->entityTable.SetRecycle(_recycle);
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::SetNameIndex(bool _enable)
+{
+  if (this->dataPtr->nameIndexEnabled == _enable)
+    return;
+
+  this->dataPtr->nameIndexEnabled = _enable;
+  this->dataPtr->entitiesByName.clear();
+  this->dataPtr->entitiesByParentName.clear();
+  this->dataPtr->indexedNames.clear();
+  if (!_enable)
+    return;
+
+  this->Each<components::Name>(
+      [&](const Entity &_entity, const components::Name *) -> bool
+      {
+        this->UpdateNameIndex(_entity, components::Name::typeId);
+        return true;
+      });
+}
+
+/////////////////////////////////////////////////
+bool EntityComponentManager::NameIndex() const
+{
+  return this->dataPtr->nameIndexEnabled;
+}
+
+/////////////////////////////////////////////////
+uint64_t EntityComponentManager::StructureVersion() const
+{
+  return this->dataPtr->structureVersion;
+}
+
+/////////////////////////////////////////////////
+bool EntityComponentManager::NameIndexCandidates(
+    std::initializer_list<const components::BaseComponent *> _desired,
+    std::vector<Entity> &_candidates) const
+{
+  if (!this->dataPtr->nameIndexEnabled)
+    return false;
+
+  const components::Name *name{nullptr};
+  const components::ParentEntity *parent{nullptr};
+  for (const auto *desired : _desired)
+  {
+    if (desired->TypeId() == components::Name::typeId)
+      name = static_cast<const components::Name *>(desired);
+    else if (desired->TypeId() == components::ParentEntity::typeId)
+      parent = static_cast<const components::ParentEntity *>(desired);
+  }
+
+  if (nullptr == name)
+    return false;
+
+  _candidates.clear();
+  if (nullptr != parent)
+  {
+    auto it = this->dataPtr->entitiesByParentName.find(
+        NameKey(parent->Data(), name->Data()));
+    if (it != this->dataPtr->entitiesByParentName.end())
+      _candidates = it->second;
+  }
+  else
+  {
+    auto it = this->dataPtr->entitiesByName.find(name->Data());
+    if (it != this->dataPtr->entitiesByName.end())
+      _candidates = it->second;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::UpdateNameIndex(const Entity _entity,
+    const ComponentTypeId _typeId)
+{
+  if (_typeId != components::Name::typeId &&
+      _typeId != components::ParentEntity::typeId)
+  {
+    return;
+  }
+
+  // Lookups by name may give a different result now
+  ++this->dataPtr->structureVersion;
+
+  if (!this->dataPtr->nameIndexEnabled)
+    return;
+
+  this->dataPtr->UnindexName(_entity);
+
+  auto name = this->Component<components::Name>(_entity);
+  if (nullptr == name)
+    return;
+
+  auto parent = this->Component<components::ParentEntity>(_entity);
+  this->dataPtr->IndexName(_entity, NameKey(
+      nullptr == parent ? kNullEntity : parent->Data(), name->Data()));
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManagerPrivate::IndexName(const Entity _entity,
+    const NameKey &_key)
+{
+  insertSorted(this->entitiesByName[_key.second], _entity);
+  insertSorted(this->entitiesByParentName[_key], _entity);
+  this->indexedNames[_entity] = _key;
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManagerPrivate::UnindexName(const Entity _entity)
+{
+  auto indexed = this->indexedNames.find(_entity);
+  if (indexed == this->indexedNames.end())
+    return;
+
+  const NameKey &key = indexed->second;
+  auto byName = this->entitiesByName.find(key.second);
+  if (byName != this->entitiesByName.end())
+  {
+    eraseSorted(byName->second, _entity);
+    if (byName->second.empty())
+      this->entitiesByName.erase(byName);
+  }
+
+  auto byParentName = this->entitiesByParentName.find(key);
+  if (byParentName != this->entitiesByParentName.end())
+  {
+    eraseSorted(byParentName->second, _entity);
+    if (byParentName->second.empty())
+      this->entitiesByParentName.erase(byParentName);
+  }
+
+  this->indexedNames.erase(indexed);
 }
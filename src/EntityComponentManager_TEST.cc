@@ -16,12 +16,22 @@
 */
 
 #include <gtest/gtest.h>
+#include <google/protobuf/arena.h>
+
+#include <atomic>
+#include <map>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Rand.hh>
 
 #include "ignition/gazebo/components/Factory.hh"
+#include "ignition/gazebo/components/JointStates.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/config.hh"
@@ -91,10 +101,22 @@ class EntityCompMgrTest : public EntityComponentManager
   {
     this->SetAllComponentsUnchanged();
   }
+  public: void RunNotifyComponentObservers()
+  {
+    this->NotifyComponentObservers();
+  }
   public: void RunClearRemovedComponents()
   {
     this->ClearRemovedComponents();
   }
+  public: void RunSetLockFreeReads(bool _lockFree)
+  {
+    this->SetLockFreeReads(_lockFree);
+  }
+  public: bool RunLockFreeReads() const
+  {
+    return this->LockFreeReads();
+  }
 };
 
 class EntityComponentManagerFixture : public ::testing::TestWithParam<int>
@@ -416,6 +438,189 @@ TEST_P(EntityComponentManagerFixture, RemoveAddAdjacent)
   EXPECT_EQ(components::Pose(math::Pose3d(1010, 81, 821, 0, 0, 0)), *pose4);
 }
 
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, RemoveManyComponents)
+{
+  const int count = 1000;
+  std::vector<Entity> entities;
+  for (int i = 0; i < count; ++i)
+  {
+    Entity entity = manager.CreateEntity();
+    manager.CreateComponent(entity, IntComponent(i));
+    entities.push_back(entity);
+  }
+
+  // Remove every third component, starting from the front so that the
+  // components at the back of the storage are moved around.
+  for (int i = 0; i < count; i += 3)
+  {
+    EXPECT_TRUE(manager.RemoveComponent<IntComponent>(entities[i]));
+    EXPECT_FALSE(manager.RemoveComponent<IntComponent>(entities[i]));
+  }
+
+  // The remaining components still hold their original values.
+  for (int i = 0; i < count; ++i)
+  {
+    auto comp = manager.Component<IntComponent>(entities[i]);
+    if (i % 3 == 0)
+    {
+      EXPECT_EQ(nullptr, comp);
+    }
+    else
+    {
+      ASSERT_NE(nullptr, comp);
+      EXPECT_EQ(i, comp->Data());
+    }
+  }
+
+  // New components can be added and found after the removals.
+  for (int i = 0; i < count; i += 3)
+    manager.CreateComponent(entities[i], IntComponent(-i));
+
+  for (int i = 0; i < count; ++i)
+  {
+    auto comp = manager.Component<IntComponent>(entities[i]);
+    ASSERT_NE(nullptr, comp);
+    EXPECT_EQ(i % 3 == 0 ? -i : i, comp->Data());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, LockFreeReads)
+{
+  Entity entity1 = manager.CreateEntity();
+  manager.CreateComponent(entity1, IntComponent(123));
+
+  EXPECT_FALSE(manager.RunLockFreeReads());
+  manager.RunSetLockFreeReads(true);
+  EXPECT_TRUE(manager.RunLockFreeReads());
+
+  // Lookups work the same while lock-free reads are enabled
+  auto intComp = manager.Component<IntComponent>(entity1);
+  ASSERT_NE(nullptr, intComp);
+  EXPECT_EQ(123, intComp->Data());
+  EXPECT_EQ(nullptr, manager.Component<DoubleComponent>(entity1));
+
+  int count{0};
+  manager.Each<IntComponent>(
+      [&](const Entity &, const IntComponent *_comp) -> bool
+      {
+        EXPECT_EQ(123, _comp->Data());
+        ++count;
+        return true;
+      });
+  EXPECT_EQ(1, count);
+
+  // Storages created while lock-free reads are enabled follow the current
+  // mode, and keep following it when it's switched
+  EXPECT_TRUE(manager.RunLockFreeReads());
+  manager.CreateComponent(entity1, DoubleComponent(0.5));
+  auto doubleComp = manager.Component<DoubleComponent>(entity1);
+  ASSERT_NE(nullptr, doubleComp);
+  EXPECT_DOUBLE_EQ(0.5, doubleComp->Data());
+
+  manager.RunSetLockFreeReads(false);
+  EXPECT_FALSE(manager.RunLockFreeReads());
+  doubleComp = manager.Component<DoubleComponent>(entity1);
+  ASSERT_NE(nullptr, doubleComp);
+  EXPECT_DOUBLE_EQ(0.5, doubleComp->Data());
+  EXPECT_EQ(123, manager.Component<IntComponent>(entity1)->Data());
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, ConcurrentReaders)
+{
+  for (int i = 0; i < 100; ++i)
+  {
+    Entity entity = manager.CreateEntity();
+    manager.CreateComponent(entity, IntComponent(i));
+    if (i % 2 == 0)
+      manager.CreateComponent(entity, DoubleComponent(i));
+  }
+  manager.RequestRemoveEntity(manager.CreateEntity());
+
+  // Readers run in parallel like PostUpdate systems, building some views
+  // and sharing others
+  manager.RunSetLockFreeReads(true);
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&, t]()
+    {
+      for (int iter = 0; iter < 20; ++iter)
+      {
+        int count = 0;
+        manager.Each<IntComponent>(
+            [&](const Entity &, const IntComponent *) -> bool
+            {
+              ++count;
+              return true;
+            });
+        if (t % 2 == 0)
+        {
+          manager.Each<IntComponent, DoubleComponent>(
+              [&](const Entity &, const IntComponent *,
+                  const DoubleComponent *) -> bool
+              {
+                ++count;
+                return true;
+              });
+        }
+        const int expected = t % 2 == 0 ? 150 : 100;
+        if (count != expected || !manager.HasEntitiesMarkedForRemoval())
+          ++failures;
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  manager.RunSetLockFreeReads(false);
+
+  EXPECT_EQ(0, failures);
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, ParallelEach)
+{
+  const int count = 1000;
+  for (int i = 0; i < count; ++i)
+  {
+    Entity entity = manager.CreateEntity();
+    manager.CreateComponent(entity, IntComponent(i));
+    if (i % 2 == 0)
+      manager.CreateComponent(entity, DoubleComponent(0.0));
+  }
+
+  // Write component data concurrently
+  manager.ParallelEach<IntComponent, DoubleComponent>(
+      [](const Entity &, IntComponent *_int, DoubleComponent *_double)
+      {
+        _double->Data() = _int->Data() * 2.0;
+      }, 16);
+
+  EXPECT_FALSE(manager.RunLockFreeReads());
+
+  // Check the results from a const ECM
+  const auto &constManager = manager;
+  std::atomic<int> visited{0};
+  constManager.ParallelEach<IntComponent, DoubleComponent>(
+      [&](const Entity &, const IntComponent *_int,
+          const DoubleComponent *_double)
+      {
+        EXPECT_DOUBLE_EQ(_int->Data() * 2.0, _double->Data());
+        ++visited;
+      }, 7);
+  EXPECT_EQ(count / 2, visited);
+
+  // Views without entities don't call the callback
+  manager.ParallelEach<StringComponent>(
+      [](const Entity &, StringComponent *)
+      {
+        FAIL() << "Callback shouldn't be called";
+      });
+}
+
 /////////////////////////////////////////////////
 TEST_P(EntityComponentManagerFixture, EntitiesAndComponents)
 {
@@ -1046,6 +1251,234 @@ TEST_P(EntityComponentManagerFixture, RemoveEntity)
   EXPECT_EQ(0u, manager.EntityCount());
 }
 
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, Batch)
+{
+  auto world = manager.CreateEntity();
+  manager.CreateComponent<IntComponent>(world, IntComponent(0));
+  manager.RunClearNewlyCreatedEntities();
+
+  auto countInts = [&]()
+  {
+    int count = 0;
+    manager.Each<IntComponent>(
+        [&](const Entity &, const IntComponent *) -> bool
+        {
+          ++count;
+          return true;
+        });
+    return count;
+  };
+  EXPECT_EQ(1, countInts());
+
+  manager.BeginBatch();
+  std::vector<Entity> entities;
+  for (int i = 1; i < 4; ++i)
+  {
+    auto entity = manager.CreateEntity();
+    manager.CreateComponent<IntComponent>(entity, IntComponent(i));
+    manager.CreateComponent<DoubleComponent>(entity, DoubleComponent(i));
+    EXPECT_TRUE(manager.SetParentEntity(entity, world));
+    entities.push_back(entity);
+  }
+
+  // The hierarchy is known, but not in the graph yet
+  EXPECT_EQ(world, manager.ParentEntity(entities[0]));
+  EXPECT_EQ(4u, manager.Descendants(world).size());
+  EXPECT_FALSE(manager.SetParentEntity(entities[0], 1000));
+  EXPECT_TRUE(manager.SetParentEntity(entities[0], world));
+
+  // Components are accessible, but existing views are only updated on
+  // commit
+  ASSERT_NE(nullptr, manager.Component<IntComponent>(entities[2]));
+  EXPECT_EQ(3, manager.Component<IntComponent>(entities[2])->Data());
+  manager.RemoveComponent<DoubleComponent>(entities[1]);
+  EXPECT_EQ(1, countInts());
+  EXPECT_FALSE(manager.HasNewEntities());
+  EXPECT_TRUE(manager.Entities().AdjacentsFrom(world).empty());
+
+  manager.CommitBatch();
+  EXPECT_EQ(4, countInts());
+  EXPECT_TRUE(manager.HasNewEntities());
+  EXPECT_EQ(3u, manager.Entities().AdjacentsFrom(world).size());
+  EXPECT_EQ(world, manager.ParentEntity(entities[0]));
+
+  int newCount = 0;
+  manager.EachNew<IntComponent, DoubleComponent>(
+      [&](const Entity &_entity, const IntComponent *,
+          const DoubleComponent *) -> bool
+      {
+        EXPECT_NE(entities[1], _entity);
+        ++newCount;
+        return true;
+      });
+  EXPECT_EQ(2, newCount);
+
+  // Committing a nested batch applies the deferred work
+  manager.BeginBatch();
+  manager.BeginBatch();
+  manager.CreateComponent<IntComponent>(manager.CreateEntity(),
+      IntComponent(4));
+  manager.CommitBatch();
+  EXPECT_EQ(5, countInts());
+  manager.CreateComponent<IntComponent>(manager.CreateEntity(),
+      IntComponent(5));
+  EXPECT_EQ(5, countInts());
+  manager.CommitBatch();
+  EXPECT_EQ(6, countInts());
+
+  // Committing without a batch is an error
+  manager.CommitBatch();
+  EXPECT_EQ(6, countInts());
+}
+
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, Clone)
+{
+  // world -> model -> link -> joint
+  auto world = manager.CreateEntity();
+  auto model = manager.CreateEntity();
+  auto link = manager.CreateEntity();
+  auto joint = manager.CreateEntity();
+  manager.CreateComponent(model, components::Name("model"));
+  manager.CreateComponent(model, components::ParentEntity(world));
+  manager.CreateComponent<IntComponent>(model, IntComponent(1));
+  components::JointStatesData states;
+  states.joints.push_back(joint);
+  states.joints.push_back(world);
+  manager.CreateComponent(model, components::JointStates(states));
+  manager.CreateComponent(link, components::Name("link"));
+  manager.CreateComponent(link, components::ParentEntity(model));
+  manager.CreateComponent<DoubleComponent>(link, DoubleComponent(2.0));
+  manager.CreateComponent(joint, components::ParentEntity(link));
+  EXPECT_TRUE(manager.SetParentEntity(model, world));
+  EXPECT_TRUE(manager.SetParentEntity(link, model));
+  EXPECT_TRUE(manager.SetParentEntity(joint, link));
+  EXPECT_EQ(4u, manager.EntityCount());
+
+  // Nothing to clone
+  EXPECT_EQ(kNullEntity, manager.Clone(1000, world, "clone"));
+  EXPECT_EQ(4u, manager.EntityCount());
+
+  auto clone = manager.Clone(model, world, "clone");
+  ASSERT_NE(kNullEntity, clone);
+  EXPECT_EQ(7u, manager.EntityCount());
+  EXPECT_EQ(world, manager.ParentEntity(clone));
+
+  // The root is renamed, all components are copied
+  EXPECT_EQ("clone", manager.Component<components::Name>(clone)->Data());
+  EXPECT_EQ("model", manager.Component<components::Name>(model)->Data());
+  EXPECT_EQ(1, manager.Component<IntComponent>(clone)->Data());
+  EXPECT_EQ(world,
+      manager.Component<components::ParentEntity>(clone)->Data());
+
+  // Children are cloned and refer to the cloned parents
+  auto descendants = manager.Descendants(clone);
+  EXPECT_EQ(3u, descendants.size());
+  auto clonedLink = manager.EntityByComponents(components::Name("link"),
+      components::ParentEntity(clone));
+  ASSERT_NE(kNullEntity, clonedLink);
+  EXPECT_NE(link, clonedLink);
+  EXPECT_EQ(clone, manager.ParentEntity(clonedLink));
+  EXPECT_DOUBLE_EQ(2.0,
+      manager.Component<DoubleComponent>(clonedLink)->Data());
+
+  auto clonedJoints =
+      manager.ChildrenByComponents(clonedLink,
+      components::ParentEntity(clonedLink));
+  ASSERT_EQ(1u, clonedJoints.size());
+  auto clonedJoint = clonedJoints[0];
+  EXPECT_NE(joint, clonedJoint);
+
+  // Joint states refer to the cloned joint, and keep entities outside of the
+  // subtree
+  auto clonedStates = manager.Component<components::JointStates>(clone);
+  ASSERT_NE(nullptr, clonedStates);
+  ASSERT_EQ(2u, clonedStates->Data().joints.size());
+  EXPECT_EQ(clonedJoint, clonedStates->Data().joints[0]);
+  EXPECT_EQ(world, clonedStates->Data().joints[1]);
+  EXPECT_EQ(joint,
+      manager.Component<components::JointStates>(model)->Data().joints[0]);
+
+  // Without a parent and name
+  auto orphan = manager.Clone(link, kNullEntity, "");
+  ASSERT_NE(kNullEntity, orphan);
+  EXPECT_EQ(kNullEntity, manager.ParentEntity(orphan));
+  EXPECT_EQ(nullptr, manager.Component<components::ParentEntity>(orphan));
+  EXPECT_EQ("link", manager.Component<components::Name>(orphan)->Data());
+  EXPECT_EQ(9u, manager.EntityCount());
+}
+
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, RecycleEntities)
+{
+  manager.SetEntityRecycling(true);
+
+  auto e1 = manager.CreateEntity();
+  auto e2 = manager.CreateEntity();
+  manager.CreateComponent<IntComponent>(e1, IntComponent(1));
+  manager.CreateComponent<IntComponent>(e2, IntComponent(2));
+  EXPECT_EQ(1u, EntityIndex(e1));
+  EXPECT_EQ(0u, EntityGeneration(e1));
+
+  // The removed entity's slot is reused with a new generation
+  manager.RequestRemoveEntity(e1);
+  manager.ProcessEntityRemovals();
+  auto e3 = manager.CreateEntity();
+  EXPECT_NE(e1, e3);
+  EXPECT_EQ(EntityIndex(e1), EntityIndex(e3));
+  EXPECT_EQ(1u, EntityGeneration(e3));
+  EXPECT_FALSE(manager.HasEntity(e1));
+  EXPECT_TRUE(manager.HasEntity(e3));
+  EXPECT_EQ(2u, manager.EntityCount());
+
+  // The new entity doesn't inherit the old entity's components
+  EXPECT_EQ(nullptr, manager.Component<IntComponent>(e1));
+  EXPECT_EQ(nullptr, manager.Component<IntComponent>(e3));
+  manager.CreateComponent<IntComponent>(e3, IntComponent(3));
+  EXPECT_EQ(3, manager.Component<IntComponent>(e3)->Data());
+  EXPECT_EQ(2, manager.Component<IntComponent>(e2)->Data());
+
+  // Slots are reused after removing all entities
+  manager.RequestRemoveEntities();
+  manager.ProcessEntityRemovals();
+  auto e4 = manager.CreateEntity();
+  EXPECT_FALSE(manager.HasEntity(e3));
+  EXPECT_NE(0u, EntityGeneration(e4));
+  EXPECT_NE(e3, e4);
+
+  // Entities with explicit ids get their own slot or are kept aside
+  msgs::SerializedStateMap stateMsg;
+  auto &entityMsg = (*stateMsg.mutable_entities())[e2];
+  entityMsg.set_id(e2);
+  manager.SetState(stateMsg);
+  EXPECT_TRUE(manager.HasEntity(e2));
+  EXPECT_TRUE(manager.HasEntity(e4));
+
+  // A recycled id received through the state only bumps the count by its
+  // index, so new entities start a fresh slot with generation 0
+  manager.SetEntityRecycling(false);
+  const Entity recycled = MakeEntity(500, 3);
+  msgs::SerializedStateMap recycledMsg;
+  (*recycledMsg.mutable_entities())[recycled].set_id(recycled);
+  manager.SetState(recycledMsg);
+  EXPECT_TRUE(manager.HasEntity(recycled));
+
+  auto e5 = manager.CreateEntity();
+  EXPECT_EQ(0u, EntityGeneration(e5));
+  EXPECT_EQ(501u, EntityIndex(e5));
+  EXPECT_TRUE(manager.HasEntity(e5));
+  EXPECT_TRUE(manager.HasEntity(recycled));
+  EXPECT_TRUE(manager.HasEntity(e2));
+  EXPECT_TRUE(manager.HasEntity(e4));
+
+  // Offsets disable recycling, so the ids below the offset are left alone
+  manager.SetEntityCreateOffset(1000);
+  manager.RequestRemoveEntity(e4);
+  manager.ProcessEntityRemovals();
+  EXPECT_EQ(1001u, manager.CreateEntity());
+}
+
 //////////////////////////////////////////////////
 TEST_P(EntityComponentManagerFixture, ViewsRemoveEntity)
 {
@@ -2098,6 +2531,65 @@ TEST_P(EntityComponentManagerFixture, Descendants)
   }
 }
 
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, DescendantsAfterChanges)
+{
+  // - 1
+  //   - 2
+  //     - 3
+  // - 4
+  auto e1 = manager.CreateEntity();
+  auto e2 = manager.CreateEntity();
+  auto e3 = manager.CreateEntity();
+  auto e4 = manager.CreateEntity();
+  EXPECT_TRUE(manager.SetParentEntity(e2, e1));
+  EXPECT_TRUE(manager.SetParentEntity(e3, e2));
+  EXPECT_EQ(e2, manager.ParentEntity(e3));
+  EXPECT_EQ(kNullEntity, manager.ParentEntity(e4));
+
+  EXPECT_EQ(3u, manager.Descendants(e1).size());
+  EXPECT_EQ(1u, manager.Descendants(e4).size());
+
+  // Creating an entity under a subtree updates the cached ancestors
+  auto e5 = manager.CreateEntity();
+  EXPECT_TRUE(manager.SetParentEntity(e5, e3));
+  EXPECT_EQ(4u, manager.Descendants(e1).size());
+  EXPECT_EQ(3u, manager.Descendants(e2).size());
+  EXPECT_EQ(1u, manager.Descendants(e4).size());
+
+  // Moving a subtree updates both the old and the new ancestors
+  EXPECT_TRUE(manager.SetParentEntity(e3, e4));
+  EXPECT_EQ(e4, manager.ParentEntity(e3));
+  EXPECT_EQ(2u, manager.Descendants(e1).size());
+  EXPECT_EQ(1u, manager.Descendants(e2).size());
+  auto ds = manager.Descendants(e4);
+  EXPECT_EQ(3u, ds.size());
+  EXPECT_NE(ds.end(), ds.find(e5));
+  EXPECT_EQ(1u, manager.Entities().AdjacentsTo(e3).size());
+
+  // Parents which don't exist are rejected
+  EXPECT_FALSE(manager.SetParentEntity(e3, 1000));
+  EXPECT_EQ(kNullEntity, manager.ParentEntity(e3));
+  EXPECT_EQ(1u, manager.Descendants(e4).size());
+  EXPECT_TRUE(manager.SetParentEntity(e3, e4));
+
+  // Removing an entity updates its ancestors and leaves its children
+  // parentless
+  manager.RequestRemoveEntity(e3, false);
+  manager.ProcessEntityRemovals();
+  EXPECT_EQ(1u, manager.Descendants(e4).size());
+  EXPECT_EQ(kNullEntity, manager.ParentEntity(e5));
+  EXPECT_TRUE(manager.Descendants(e3).empty());
+
+  // Recursive removal uses the same hierarchy
+  manager.RequestRemoveEntity(e1);
+  manager.ProcessEntityRemovals();
+  EXPECT_FALSE(manager.HasEntity(e1));
+  EXPECT_FALSE(manager.HasEntity(e2));
+  EXPECT_TRUE(manager.HasEntity(e4));
+  EXPECT_TRUE(manager.HasEntity(e5));
+}
+
 //////////////////////////////////////////////////
 TEST_P(EntityComponentManagerFixture, SetChanged)
 {
@@ -2177,6 +2669,266 @@ TEST_P(EntityComponentManagerFixture, SetChanged)
 }
 
 //////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, StateOnArena)
+{
+  for (int i = 0; i < 100; ++i)
+  {
+    Entity entity = manager.CreateEntity();
+    manager.CreateComponent<IntComponent>(entity, IntComponent(i));
+    manager.CreateComponent<StringComponent>(entity,
+        StringComponent(std::to_string(i)));
+  }
+  manager.RemoveComponent<StringComponent>(50);
+
+  msgs::SerializedStateMap heapMsg;
+  manager.State(heapMsg, {}, {}, true);
+
+  // Build the same state on an arena a few times, resetting it in between
+  google::protobuf::Arena arena;
+  for (int i = 0; i < 3; ++i)
+  {
+    auto arenaMsg =
+        google::protobuf::Arena::Create<msgs::SerializedStateMap>(&arena);
+    manager.State(*arenaMsg, {}, {}, true);
+
+    ASSERT_EQ(heapMsg.entities_size(), arenaMsg->entities_size());
+    for (const auto &entity : heapMsg.entities())
+    {
+      auto iter = arenaMsg->entities().find(entity.first);
+      ASSERT_NE(arenaMsg->entities().end(), iter);
+      EXPECT_EQ(entity.second.id(), iter->second.id());
+      ASSERT_EQ(entity.second.components_size(),
+          iter->second.components_size());
+      for (const auto &comp : entity.second.components())
+      {
+        auto compIter = iter->second.components().find(comp.first);
+        ASSERT_NE(iter->second.components().end(), compIter);
+        EXPECT_EQ(comp.second.type(), compIter->second.type());
+        EXPECT_EQ(comp.second.component(), compIter->second.component());
+        EXPECT_EQ(comp.second.remove(), compIter->second.remove());
+      }
+    }
+    arena.Reset();
+  }
+}
+
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, ChangedStateOfEntities)
+{
+  Entity e1 = manager.CreateEntity();
+  Entity e2 = manager.CreateEntity();
+  Entity e3 = manager.CreateEntity();
+  auto c1 = manager.CreateComponent<IntComponent>(e1, IntComponent(1));
+  auto c2 = manager.CreateComponent<IntComponent>(e2, IntComponent(2));
+  manager.CreateComponent<StringComponent>(e2, StringComponent("two"));
+  manager.CreateComponent<IntComponent>(e3, IntComponent(3));
+  manager.RunSetAllComponentsUnchanged();
+
+  manager.SetChanged(e1, c1.first, ComponentState::PeriodicChange);
+  manager.SetChanged(e2, c2.first, ComponentState::PeriodicChange);
+  manager.RemoveComponent<StringComponent>(e2);
+  manager.RequestRemoveEntity(e3);
+
+  // Only the changes of the requested entities are serialized
+  msgs::SerializedStateMap stateMsg;
+  manager.State(stateMsg, {e2, e3});
+  ASSERT_EQ(2, stateMsg.entities_size());
+  EXPECT_EQ(stateMsg.entities().end(), stateMsg.entities().find(e1));
+
+  auto e2Iter = stateMsg.entities().find(e2);
+  ASSERT_NE(stateMsg.entities().end(), e2Iter);
+  EXPECT_FALSE(e2Iter->second.remove());
+  ASSERT_EQ(2, e2Iter->second.components_size());
+
+  auto intIter = e2Iter->second.components().find(IntComponent::typeId);
+  ASSERT_NE(e2Iter->second.components().end(), intIter);
+  EXPECT_EQ(2, std::stoi(intIter->second.component()));
+  EXPECT_FALSE(intIter->second.remove());
+
+  auto stringIter =
+      e2Iter->second.components().find(StringComponent::typeId);
+  ASSERT_NE(e2Iter->second.components().end(), stringIter);
+  EXPECT_TRUE(stringIter->second.remove());
+
+  auto e3Iter = stateMsg.entities().find(e3);
+  ASSERT_NE(stateMsg.entities().end(), e3Iter);
+  EXPECT_TRUE(e3Iter->second.remove());
+
+  // Applying the changes to another manager creates the changed components
+  EntityComponentManager other;
+  other.SetState(stateMsg);
+  auto otherComp = other.Component<IntComponent>(e2);
+  ASSERT_NE(nullptr, otherComp);
+  EXPECT_EQ(2, otherComp->Data());
+}
+
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, EachChanged)
+{
+  Entity e1 = manager.CreateEntity();
+  Entity e2 = manager.CreateEntity();
+  Entity e3 = manager.CreateEntity();
+  manager.CreateComponent<IntComponent>(e1, IntComponent(1));
+  manager.CreateComponent<IntComponent>(e2, IntComponent(2));
+  manager.CreateComponent<IntComponent>(e3, IntComponent(3));
+  manager.CreateComponent<DoubleComponent>(e1, DoubleComponent(0.5));
+
+  // All new components have a one-time change
+  std::map<Entity, int> visited;
+  manager.EachChanged<IntComponent>(
+      [&](const Entity &_entity, const IntComponent *_int,
+          ComponentState _state) -> bool
+      {
+        EXPECT_NE(nullptr, _int);
+        EXPECT_EQ(ComponentState::OneTimeChange, _state);
+        visited[_entity] = _int->Data();
+        return true;
+      });
+  EXPECT_EQ(3u, visited.size());
+  EXPECT_EQ(1, visited[e1]);
+  EXPECT_EQ(3, visited[e3]);
+
+  manager.RunSetAllComponentsUnchanged();
+
+  int count = 0;
+  manager.EachChanged<IntComponent>(
+      [&](const Entity &, const IntComponent *, ComponentState) -> bool
+      {
+        ++count;
+        return true;
+      });
+  EXPECT_EQ(0, count);
+
+  // Only the changed components are visited, and marking a component twice
+  // or resetting it doesn't visit it twice
+  manager.SetChanged(e3, IntComponent::typeId,
+      ComponentState::PeriodicChange);
+  manager.SetChanged(e3, IntComponent::typeId,
+      ComponentState::PeriodicChange);
+  manager.SetChanged(e1, IntComponent::typeId,
+      ComponentState::OneTimeChange);
+  manager.SetChanged(e1, IntComponent::typeId, ComponentState::NoChange);
+  manager.SetChanged(e2, IntComponent::typeId,
+      ComponentState::OneTimeChange);
+  EXPECT_TRUE(manager.RemoveComponent(e2, IntComponent::typeId));
+
+  std::vector<std::pair<Entity, ComponentState>> changed;
+  manager.EachChanged<IntComponent>(
+      [&](const Entity &_entity, const IntComponent *_int,
+          ComponentState _state) -> bool
+      {
+        EXPECT_EQ(3, _int->Data());
+        changed.emplace_back(_entity, _state);
+        return true;
+      });
+  ASSERT_EQ(1u, changed.size());
+  EXPECT_EQ(e3, changed[0].first);
+  EXPECT_EQ(ComponentState::PeriodicChange, changed[0].second);
+  EXPECT_FALSE(manager.HasOneTimeComponentChanges());
+
+  // Incremental state only contains the changed component and the removed
+  // one
+  msgs::SerializedStateMap stateMsg;
+  manager.State(stateMsg);
+  ASSERT_EQ(2, stateMsg.entities_size());
+  ASSERT_EQ(1, stateMsg.entities().at(e3).components_size());
+  EXPECT_EQ("3", stateMsg.entities().at(e3).components().begin()->second
+      .component());
+  ASSERT_EQ(1, stateMsg.entities().at(e2).components_size());
+  EXPECT_TRUE(stateMsg.entities().at(e2).components().begin()->second
+      .remove());
+
+  // Returning false stops the iteration
+  manager.SetChanged(e1, IntComponent::typeId,
+      ComponentState::OneTimeChange);
+  count = 0;
+  manager.EachChanged<IntComponent>(
+      [&](const Entity &, const IntComponent *, ComponentState) -> bool
+      {
+        ++count;
+        return false;
+      });
+  EXPECT_EQ(1, count);
+
+  // Types without storage have no changes
+  manager.EachChanged<StringComponent>(
+      [&](const Entity &, const StringComponent *, ComponentState) -> bool
+      {
+        ADD_FAILURE() << "Unexpected StringComponent";
+        return true;
+      });
+}
+
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, ComponentObservers)
+{
+  EXPECT_FALSE(manager.HasChangedComponents<IntComponent>());
+  EXPECT_FALSE(manager.HasChangedComponents(DoubleComponent::typeId));
+
+  Entity e1 = manager.CreateEntity();
+  Entity e2 = manager.CreateEntity();
+  manager.CreateComponent<IntComponent>(e1, IntComponent(1));
+  manager.CreateComponent<IntComponent>(e2, IntComponent(2));
+  manager.CreateComponent<DoubleComponent>(e2, DoubleComponent(0.5));
+
+  std::vector<std::pair<Entity, int>> intChanges;
+  auto intObserver = manager.OnComponentChanged<IntComponent>(
+      [&](const Entity &_entity, const IntComponent *_int,
+          ComponentState _state)
+      {
+        EXPECT_NE(ComponentState::NoChange, _state);
+        intChanges.emplace_back(_entity, _int->Data());
+      });
+
+  int doubleChanges = 0;
+  auto doubleObserver = manager.OnComponentChanged<DoubleComponent>(
+      [&](const Entity &, const DoubleComponent *, ComponentState)
+      {
+        ++doubleChanges;
+      });
+  EXPECT_NE(intObserver, doubleObserver);
+
+  // New components count as changed
+  EXPECT_TRUE(manager.HasChangedComponents<IntComponent>());
+  manager.RunNotifyComponentObservers();
+  EXPECT_EQ((std::vector<std::pair<Entity, int>>{{e1, 1}, {e2, 2}}),
+      intChanges);
+  EXPECT_EQ(1, doubleChanges);
+
+  // Nothing is reported once the components are unchanged
+  manager.RunSetAllComponentsUnchanged();
+  EXPECT_FALSE(manager.HasChangedComponents<IntComponent>());
+  EXPECT_FALSE(manager.HasChangedComponents<DoubleComponent>());
+  intChanges.clear();
+  manager.RunNotifyComponentObservers();
+  EXPECT_TRUE(intChanges.empty());
+  EXPECT_EQ(1, doubleChanges);
+
+  // Only the changed components of the observed type are reported
+  manager.SetChanged(e2, IntComponent::typeId,
+      ComponentState::PeriodicChange);
+  EXPECT_TRUE(manager.HasChangedComponents<IntComponent>());
+  EXPECT_FALSE(manager.HasChangedComponents<DoubleComponent>());
+  manager.RunNotifyComponentObservers();
+  EXPECT_EQ((std::vector<std::pair<Entity, int>>{{e2, 2}}), intChanges);
+  EXPECT_EQ(1, doubleChanges);
+
+  // Removed components aren't reported
+  manager.RunSetAllComponentsUnchanged();
+  manager.SetChanged(e1, IntComponent::typeId);
+  EXPECT_TRUE(manager.RemoveComponent<IntComponent>(e1));
+  EXPECT_FALSE(manager.HasChangedComponents<IntComponent>());
+
+  // Removed observers aren't called
+  EXPECT_TRUE(manager.RemoveComponentObserver(intObserver));
+  EXPECT_FALSE(manager.RemoveComponentObserver(intObserver));
+  intChanges.clear();
+  manager.SetChanged(e2, IntComponent::typeId);
+  manager.RunNotifyComponentObservers();
+  EXPECT_TRUE(intChanges.empty());
+}
+
+/////////////////////////////////////////////////
 TEST_P(EntityComponentManagerFixture, SetEntityCreateOffset)
 {
   // First entity should have a value of 1.
@@ -2490,6 +3242,555 @@ TEST_P(EntityComponentManagerFixture, RemovedComponentsSyncBetweenServerAndGUI)
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Entities sharing and switching component signatures keep the
+/// right components, in queries and views alike.
+TEST_P(EntityComponentManagerFixture, ComponentSignatures)
+{
+  // Entities with the same components, added in different orders
+  std::vector<Entity> entities;
+  for (int i = 0; i < 6; ++i)
+  {
+    Entity entity = manager.CreateEntity();
+    entities.push_back(entity);
+    if (i % 2 == 0)
+    {
+      manager.CreateComponent<IntComponent>(entity, IntComponent(i));
+      manager.CreateComponent<DoubleComponent>(entity, DoubleComponent(i));
+    }
+    else
+    {
+      manager.CreateComponent<DoubleComponent>(entity, DoubleComponent(i));
+      manager.CreateComponent<IntComponent>(entity, IntComponent(i));
+    }
+  }
+
+  // Views created before the entities switch signatures
+  int count = 0;
+  manager.Each<IntComponent, DoubleComponent>(
+      [&](const Entity &, const IntComponent *_int,
+          const DoubleComponent *_double) -> bool
+      {
+        EXPECT_DOUBLE_EQ(_int->Data(), _double->Data());
+        ++count;
+        return true;
+      });
+  EXPECT_EQ(6, count);
+
+  // Move some entities to other signatures
+  EXPECT_TRUE(manager.RemoveComponent<DoubleComponent>(entities[0]));
+  EXPECT_TRUE(manager.RemoveComponent<IntComponent>(entities[1]));
+  manager.CreateComponent<BoolComponent>(entities[2], BoolComponent(true));
+  EXPECT_TRUE(manager.RemoveComponent<IntComponent>(entities[3]));
+  EXPECT_TRUE(manager.RemoveComponent<DoubleComponent>(entities[3]));
+  EXPECT_TRUE(manager.ComponentTypes(entities[3]).empty());
+
+  // Adding an existing component type keeps the original component
+  manager.CreateComponent<IntComponent>(entities[4], IntComponent(40));
+  ASSERT_NE(nullptr, manager.Component<IntComponent>(entities[4]));
+  EXPECT_EQ(4, manager.Component<IntComponent>(entities[4])->Data());
+
+  for (int i = 0; i < 6; ++i)
+  {
+    auto intComp = manager.Component<IntComponent>(entities[i]);
+    auto doubleComp = manager.Component<DoubleComponent>(entities[i]);
+    if (i == 1 || i == 3)
+    {
+      EXPECT_EQ(nullptr, intComp) << i;
+    }
+    else
+    {
+      ASSERT_NE(nullptr, intComp) << i;
+      EXPECT_EQ(i, intComp->Data());
+    }
+    if (i == 0 || i == 3)
+    {
+      EXPECT_EQ(nullptr, doubleComp) << i;
+    }
+    else
+    {
+      ASSERT_NE(nullptr, doubleComp) << i;
+      EXPECT_DOUBLE_EQ(i, doubleComp->Data());
+    }
+  }
+  EXPECT_TRUE(manager.EntityHasComponentType(entities[2],
+      BoolComponent::typeId));
+  EXPECT_EQ(3u, manager.ComponentTypes(entities[2]).size());
+
+  // Remove an entity, which moves another entity's row in its signature
+  manager.RequestRemoveEntity(entities[4]);
+  manager.ProcessEntityRemovals();
+  EXPECT_EQ(nullptr, manager.Component<IntComponent>(entities[4]));
+  ASSERT_NE(nullptr, manager.Component<IntComponent>(entities[5]));
+  EXPECT_EQ(5, manager.Component<IntComponent>(entities[5])->Data());
+
+  // Both existing and new views see the current signatures
+  std::vector<Entity> viewEntities;
+  manager.Each<IntComponent, DoubleComponent>(
+      [&](const Entity &_entity, const IntComponent *_int,
+          const DoubleComponent *_double) -> bool
+      {
+        EXPECT_DOUBLE_EQ(_int->Data(), _double->Data());
+        viewEntities.push_back(_entity);
+        return true;
+      });
+  EXPECT_EQ((std::vector<Entity>{entities[2], entities[5]}), viewEntities);
+
+  viewEntities.clear();
+  manager.Each<DoubleComponent, BoolComponent>(
+      [&](const Entity &_entity, const DoubleComponent *,
+          const BoolComponent *_bool) -> bool
+      {
+        EXPECT_TRUE(_bool->Data());
+        viewEntities.push_back(_entity);
+        return true;
+      });
+  EXPECT_EQ((std::vector<Entity>{entities[2]}), viewEntities);
+
+  viewEntities.clear();
+  manager.Each<DoubleComponent>(
+      [&](const Entity &_entity, const DoubleComponent *_double) -> bool
+      {
+        EXPECT_DOUBLE_EQ(static_cast<double>(_entity - entities[0]),
+            _double->Data());
+        viewEntities.push_back(_entity);
+        return true;
+      });
+  EXPECT_EQ((std::vector<Entity>{entities[1], entities[2], entities[5]}),
+      viewEntities);
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, EachWithoutOptional)
+{
+  Entity e1 = manager.CreateEntity();
+  manager.CreateComponent<IntComponent>(e1, IntComponent(1));
+
+  Entity e2 = manager.CreateEntity();
+  manager.CreateComponent<IntComponent>(e2, IntComponent(2));
+  manager.CreateComponent<BoolComponent>(e2, BoolComponent(true));
+
+  Entity e3 = manager.CreateEntity();
+  manager.CreateComponent<IntComponent>(e3, IntComponent(3));
+  manager.CreateComponent<DoubleComponent>(e3, DoubleComponent(3.0));
+
+  auto without = [&]()
+  {
+    std::vector<Entity> result;
+    manager.Each<IntComponent, Without<BoolComponent>>(
+        [&](const Entity &_entity, const IntComponent *_int) -> bool
+        {
+          EXPECT_EQ(static_cast<int>(_entity - e1 + 1), _int->Data());
+          result.push_back(_entity);
+          return true;
+        });
+    return result;
+  };
+
+  auto optional = [&]()
+  {
+    std::vector<std::pair<Entity, double>> result;
+    const auto &constManager = manager;
+    constManager.Each<IntComponent, Optional<DoubleComponent>>(
+        [&](const Entity &_entity, const IntComponent *,
+            const DoubleComponent *_double) -> bool
+        {
+          result.emplace_back(_entity,
+              nullptr == _double ? -1.0 : _double->Data());
+          return true;
+        });
+    return result;
+  };
+
+  using Pairs = std::vector<std::pair<Entity, double>>;
+
+  EXPECT_EQ((std::vector<Entity>{e1, e3}), without());
+  EXPECT_EQ((Pairs{{e1, -1.0}, {e2, -1.0}, {e3, 3.0}}), optional());
+
+  // The existing views follow component changes
+  manager.CreateComponent<BoolComponent>(e1, BoolComponent(false));
+  EXPECT_TRUE(manager.RemoveComponent<BoolComponent>(e2));
+  manager.CreateComponent<DoubleComponent>(e2, DoubleComponent(2.0));
+  EXPECT_TRUE(manager.RemoveComponent<DoubleComponent>(e3));
+
+  EXPECT_EQ((std::vector<Entity>{e2, e3}), without());
+  EXPECT_EQ((Pairs{{e1, -1.0}, {e2, 2.0}, {e3, -1.0}}), optional());
+
+  // Optional components can be modified through the mutable overload
+  manager.Each<Optional<DoubleComponent>, IntComponent>(
+      [&](const Entity &, DoubleComponent *_double, IntComponent *) -> bool
+      {
+        if (nullptr != _double)
+          _double->Data() += 1.0;
+        return true;
+      });
+  EXPECT_EQ((Pairs{{e1, -1.0}, {e2, 3.0}, {e3, -1.0}}), optional());
+
+  // Plain views are unaffected by views with terms
+  int count = 0;
+  manager.Each<IntComponent>(
+      [&](const Entity &, const IntComponent *) -> bool
+      {
+        ++count;
+        return true;
+      });
+  EXPECT_EQ(3, count);
+
+  // Entity removal and view rebuilds keep the terms
+  manager.RequestRemoveEntity(e3);
+  manager.ProcessEntityRemovals();
+  EXPECT_EQ((std::vector<Entity>{e2}), without());
+
+  manager.RebuildViews();
+  EXPECT_EQ((std::vector<Entity>{e2}), without());
+  EXPECT_EQ((Pairs{{e1, -1.0}, {e2, 3.0}}), optional());
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, MemoryUsage)
+{
+  auto empty = manager.MemoryUsage();
+  EXPECT_TRUE(empty.componentTypes.empty());
+  EXPECT_EQ(0u, empty.viewCount);
+  EXPECT_EQ(0u, empty.descendantCacheEntries);
+
+  Entity first{kNullEntity};
+  for (int i = 0; i < 200; ++i)
+  {
+    Entity entity = manager.CreateEntity();
+    if (kNullEntity == first)
+      first = entity;
+    manager.CreateComponent<IntComponent>(entity, IntComponent(i));
+    if (i % 2 == 0)
+      manager.CreateComponent<DoubleComponent>(entity, DoubleComponent(i));
+  }
+
+  auto usage = manager.MemoryUsage();
+  ASSERT_EQ(2u, usage.componentTypes.size());
+
+  const auto &ints = usage.componentTypes.at(IntComponent::typeId);
+  EXPECT_EQ(200u, ints.count);
+  EXPECT_GE(ints.bytes, 200u * sizeof(IntComponent));
+  EXPECT_FALSE(ints.name.empty());
+
+  const auto &doubles = usage.componentTypes.at(DoubleComponent::typeId);
+  EXPECT_EQ(100u, doubles.count);
+  EXPECT_GE(doubles.bytes, 100u * sizeof(DoubleComponent));
+
+  EXPECT_EQ(ints.bytes + doubles.bytes, usage.componentBytes);
+  EXPECT_EQ(2u, usage.archetypeCount);
+  EXPECT_GT(usage.entityTableBytes, empty.entityTableBytes);
+
+  // All entities and components are new
+  EXPECT_GE(usage.changeTrackingEntries, 200u + 300u);
+
+  // Views and caches are accounted for once they're used
+  manager.Each<IntComponent, DoubleComponent>(
+      [&](const Entity &, const IntComponent *,
+          const DoubleComponent *) -> bool
+      {
+        return true;
+      });
+  manager.Descendants(first);
+
+  auto withViews = manager.MemoryUsage();
+  EXPECT_EQ(1u, withViews.viewCount);
+  EXPECT_GE(withViews.viewBytes, 100u * sizeof(Entity));
+  EXPECT_EQ(1u, withViews.descendantCacheEntries);
+  EXPECT_GT(withViews.TotalBytes(), usage.TotalBytes());
+
+  // Change tracking is released at the end of the step
+  manager.RunClearNewlyCreatedEntities();
+  manager.RunSetAllComponentsUnchanged();
+  EXPECT_EQ(0u, manager.MemoryUsage().changeTrackingEntries);
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, NameIndex)
+{
+  EXPECT_FALSE(manager.NameIndex());
+
+  // Two models with a link of the same name
+  Entity model1 = manager.CreateEntity();
+  manager.CreateComponent(model1, components::Name("model1"));
+  Entity model2 = manager.CreateEntity();
+  manager.CreateComponent(model2, components::Name("model2"));
+
+  Entity link1 = manager.CreateEntity();
+  manager.SetParentEntity(link1, model1);
+  manager.CreateComponent(link1, components::Name("link"));
+  manager.CreateComponent(link1, components::ParentEntity(model1));
+  manager.CreateComponent(link1, IntComponent(1));
+
+  // Existing entities are indexed when enabling it
+  manager.SetNameIndex(true);
+  EXPECT_TRUE(manager.NameIndex());
+
+  Entity link2 = manager.CreateEntity();
+  manager.SetParentEntity(link2, model2);
+  manager.CreateComponent(link2, components::Name("link"));
+  manager.CreateComponent(link2, components::ParentEntity(model2));
+  manager.CreateComponent(link2, IntComponent(2));
+
+  EXPECT_EQ(model1, manager.EntityByComponents(components::Name("model1")));
+  EXPECT_EQ(link1, manager.EntityByComponents(components::Name("link")));
+  EXPECT_EQ(link1, manager.EntityByComponents(components::Name("link"),
+      components::ParentEntity(model1)));
+  EXPECT_EQ(link2, manager.EntityByComponents(
+      components::ParentEntity(model2), components::Name("link")));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("link"),
+      components::ParentEntity(link1)));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("none")));
+
+  // Other components are still compared
+  EXPECT_EQ(link2, manager.EntityByComponents(components::Name("link"),
+      IntComponent(2)));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(
+      components::Name("model1"), IntComponent(1)));
+
+  EXPECT_EQ(std::vector<Entity>({link1, link2}),
+      manager.EntitiesByComponents(components::Name("link")));
+  EXPECT_EQ(std::vector<Entity>({link2}),
+      manager.ChildrenByComponents(model2, components::Name("link")));
+
+  // Renaming through SetComponentData updates the index
+  EXPECT_TRUE(manager.SetComponentData<components::Name>(link2, "link2"));
+  EXPECT_EQ(std::vector<Entity>({link1}),
+      manager.EntitiesByComponents(components::Name("link")));
+  EXPECT_EQ(link2, manager.EntityByComponents(components::Name("link2"),
+      components::ParentEntity(model2)));
+
+  // So does modifying the data in place and marking it as changed
+  manager.Component<components::ParentEntity>(link2)->Data() = model1;
+  manager.SetChanged(link2, components::ParentEntity::typeId,
+      ComponentState::OneTimeChange);
+  EXPECT_EQ(link2, manager.EntityByComponents(components::Name("link2"),
+      components::ParentEntity(model1)));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("link2"),
+      components::ParentEntity(model2)));
+
+  // Removing the parent component keeps the name indexed
+  EXPECT_TRUE(manager.RemoveComponent<components::ParentEntity>(link2));
+  EXPECT_EQ(link2, manager.EntityByComponents(components::Name("link2")));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("link2"),
+      components::ParentEntity(model1)));
+
+  // Removing the name removes the entity from the index
+  EXPECT_TRUE(manager.RemoveComponent<components::Name>(link2));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("link2")));
+
+  // So does removing the entity
+  manager.RequestRemoveEntity(link1);
+  manager.ProcessEntityRemovals();
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("link")));
+  EXPECT_EQ(model2, manager.EntityByComponents(components::Name("model2")));
+
+  // Lookups give the same results without the index
+  manager.SetNameIndex(false);
+  EXPECT_FALSE(manager.NameIndex());
+  EXPECT_EQ(model2, manager.EntityByComponents(components::Name("model2")));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("link")));
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, SetStateBulk)
+{
+  // Source of the state, with entities holding several component types
+  EntityCompMgrTest source;
+  std::vector<Entity> entities;
+  for (int i = 0; i < 20; ++i)
+  {
+    Entity entity = source.CreateEntity();
+    source.CreateComponent(entity, IntComponent(i));
+    source.CreateComponent(entity, DoubleComponent(i * 0.5));
+    source.CreateComponent(entity, components::Name(
+        "entity_" + std::to_string(i)));
+    entities.push_back(entity);
+  }
+
+  manager.SetNameIndex(true);
+
+  // Create the view before setting the state
+  auto countEntities = [&]()
+  {
+    int count{0};
+    manager.Each<IntComponent, DoubleComponent>(
+        [&](const Entity &, const IntComponent *,
+            const DoubleComponent *) -> bool
+        {
+          ++count;
+          return true;
+        });
+    return count;
+  };
+  EXPECT_EQ(0, countEntities());
+
+  msgs::SerializedStateMap stateMsg;
+  source.State(stateMsg, {}, {}, true);
+  manager.SetState(stateMsg);
+
+  EXPECT_EQ(20u, manager.EntityCount());
+  EXPECT_EQ(20, countEntities());
+  EXPECT_EQ(entities[3], manager.EntityByComponents(
+      components::Name("entity_3")));
+
+  // Update all components of the existing entities, and add an entity
+  for (int i = 0; i < 20; ++i)
+  {
+    source.Component<IntComponent>(entities[i])->Data() = i + 100;
+    source.Component<DoubleComponent>(entities[i])->Data() = i * 2.0;
+    source.Component<components::Name>(entities[i])->Data() =
+        "renamed_" + std::to_string(i);
+  }
+  Entity added = source.CreateEntity();
+  source.CreateComponent(added, IntComponent(-1));
+  source.CreateComponent(added, DoubleComponent(-1.0));
+
+  manager.RunSetAllComponentsUnchanged();
+
+  stateMsg.Clear();
+  source.State(stateMsg, {}, {}, true);
+  manager.SetState(stateMsg);
+
+  EXPECT_EQ(21u, manager.EntityCount());
+  EXPECT_EQ(21, countEntities());
+  for (int i = 0; i < 20; ++i)
+  {
+    auto intComp = manager.Component<IntComponent>(entities[i]);
+    ASSERT_NE(nullptr, intComp);
+    EXPECT_EQ(i + 100, intComp->Data());
+
+    auto doubleComp = manager.Component<DoubleComponent>(entities[i]);
+    ASSERT_NE(nullptr, doubleComp);
+    EXPECT_DOUBLE_EQ(i * 2.0, doubleComp->Data());
+
+    EXPECT_EQ(ComponentState::PeriodicChange,
+        manager.ComponentState(entities[i], DoubleComponent::typeId));
+  }
+  EXPECT_EQ(-1, manager.Component<IntComponent>(added)->Data());
+
+  // Names updated in place are reindexed
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(
+      components::Name("entity_3")));
+  EXPECT_EQ(entities[3], manager.EntityByComponents(
+      components::Name("renamed_3")));
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, StructureVersion)
+{
+  auto version = manager.StructureVersion();
+  EXPECT_NE(0u, version);
+
+  // Creating an entity alone doesn't change it
+  Entity entity = manager.CreateEntity();
+  EXPECT_EQ(version, manager.StructureVersion());
+
+  auto changed = [&]()
+  {
+    auto previous = version;
+    version = manager.StructureVersion();
+    return previous != version;
+  };
+
+  manager.CreateComponent(entity, IntComponent(1));
+  EXPECT_TRUE(changed());
+  manager.CreateComponent(entity, components::Name("name"));
+  EXPECT_TRUE(changed());
+
+  // Changing data in place doesn't, unless it's a name
+  EXPECT_TRUE(manager.SetComponentData<IntComponent>(entity, 2));
+  EXPECT_FALSE(changed());
+  EXPECT_TRUE(manager.SetComponentData<components::Name>(entity, "other"));
+  EXPECT_TRUE(changed());
+
+  EXPECT_TRUE(manager.RemoveComponent<IntComponent>(entity));
+  EXPECT_TRUE(changed());
+
+  manager.RequestRemoveEntity(entity);
+  EXPECT_FALSE(changed());
+  manager.ProcessEntityRemovals();
+  EXPECT_TRUE(changed());
+
+  manager.CreateEntity();
+  manager.RequestRemoveEntities();
+  manager.ProcessEntityRemovals();
+  EXPECT_TRUE(changed());
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, RemoveManyEntities)
+{
+  // Enough entities to purge storages and views in parallel
+  Entity root = manager.CreateEntity();
+  std::vector<Entity> parents;
+  std::vector<Entity> children;
+  for (int i = 0; i < 400; ++i)
+  {
+    Entity parent = manager.CreateEntity();
+    manager.SetParentEntity(parent, root);
+    manager.CreateComponent(parent, IntComponent(i));
+
+    Entity child = manager.CreateEntity();
+    manager.SetParentEntity(child, parent);
+    manager.CreateComponent(child, IntComponent(-i));
+    manager.CreateComponent(child, DoubleComponent(i));
+
+    parents.push_back(parent);
+    children.push_back(child);
+  }
+
+  auto countInts = [&]()
+  {
+    int count{0};
+    manager.Each<IntComponent>([&](const Entity &, const IntComponent *)
+        {
+          ++count;
+          return true;
+        });
+    return count;
+  };
+  auto countBoth = [&]()
+  {
+    int count{0};
+    manager.Each<IntComponent, DoubleComponent>(
+        [&](const Entity &, const IntComponent *_int,
+            const DoubleComponent *_double)
+        {
+          EXPECT_DOUBLE_EQ(-_int->Data(), _double->Data());
+          ++count;
+          return true;
+        });
+    return count;
+  };
+
+  // Create the views and the descendant cache
+  EXPECT_EQ(800, countInts());
+  EXPECT_EQ(400, countBoth());
+  EXPECT_EQ(801u, manager.Descendants(root).size());
+
+  // Remove every other subtree, and some children alone
+  for (int i = 0; i < 400; i += 2)
+    manager.RequestRemoveEntity(parents[i]);
+  for (int i = 1; i < 100; i += 2)
+    manager.RequestRemoveEntity(children[i]);
+  manager.ProcessEntityRemovals();
+
+  EXPECT_EQ(350, countInts());
+  EXPECT_EQ(150, countBoth());
+  EXPECT_EQ(351u, manager.Descendants(root).size());
+  for (int i = 0; i < 400; ++i)
+  {
+    EXPECT_EQ(i % 2 == 1, manager.HasEntity(parents[i]));
+    EXPECT_EQ(i % 2 == 1 && i >= 100, manager.HasEntity(children[i]));
+    if (i % 2 == 1)
+    {
+      EXPECT_EQ(i, manager.Component<IntComponent>(parents[i])->Data());
+      EXPECT_EQ(root, manager.ParentEntity(parents[i]));
+    }
+  }
+}
+
 // Run multiple times. We want to make sure that static globals don't cause
 // problems.
 INSTANTIATE_TEST_SUITE_P(EntityComponentManagerRepeat,
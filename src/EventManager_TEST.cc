@@ -119,3 +119,28 @@ TEST(EventManager, Disambiguate)
   EXPECT_EQ(1, calls);
 }
 
+
+/////////////////////////////////////////////////
+TEST(EventManager, ConnectAfterEmit)
+{
+  EventManager eventManager;
+  using TestEvent = ignition::common::EventT<void(int), struct TestEventTag>;
+
+  // Emitting creates the event, later connections must use the same one
+  eventManager.Emit<TestEvent>(1);
+
+  int value{0};
+  auto connection = eventManager.Connect<TestEvent>(
+      [&](int _value) { value = _value; });
+
+  for (int i = 2; i < 100; ++i)
+  {
+    eventManager.Emit<TestEvent>(i);
+    EXPECT_EQ(i, value);
+  }
+
+  // Other managers have their own events
+  EventManager otherManager;
+  otherManager.Emit<TestEvent>(100);
+  EXPECT_EQ(99, value);
+}
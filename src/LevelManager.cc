@@ -17,26 +17,44 @@
 
 #include "LevelManager.hh"
 
+#include <ignition/msgs/serialized_map.pb.h>
+
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
 
 #include <sdf/Actor.hh>
 #include <sdf/Atmosphere.hh>
 #include <sdf/Light.hh>
 #include <sdf/Model.hh>
+#include <sdf/Sensor.hh>
 #include <sdf/World.hh>
 
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/MeshManager.hh>
 #include <ignition/common/Profiler.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/fuel_tools/ClientConfig.hh>
 
 #include "ignition/gazebo/Events.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 
 #include "ignition/gazebo/components/Actor.hh"
 #include "ignition/gazebo/components/Atmosphere.hh"
+#include "ignition/gazebo/components/ContactSensor.hh"
 #include "ignition/gazebo/components/Geometry.hh"
 #include "ignition/gazebo/components/Gravity.hh"
+#include "ignition/gazebo/components/JointStates.hh"
 #include "ignition/gazebo/components/Level.hh"
 #include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/Light.hh"
+#include "ignition/gazebo/components/Link.hh"
+#include "ignition/gazebo/components/LogicalCamera.hh"
 #include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/components/LevelBuffer.hh"
 #include "ignition/gazebo/components/LevelEntityNames.hh"
@@ -51,15 +69,81 @@
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/RenderEngineGuiPlugin.hh"
 #include "ignition/gazebo/components/RenderEngineServerPlugin.hh"
+#include "ignition/gazebo/components/ResourceCache.hh"
 #include "ignition/gazebo/components/Scene.hh"
+#include "ignition/gazebo/components/Sensor.hh"
+#include "ignition/gazebo/components/Visual.hh"
 #include "ignition/gazebo/components/Wind.hh"
 #include "ignition/gazebo/components/World.hh"
+#include "ignition/gazebo/Util.hh"
 
 #include "SimulationRunner.hh"
 
 using namespace ignition;
 using namespace gazebo;
 
+namespace
+{
+/// \brief Get the coordinates of the grid cell containing a point.
+/// \param[in] _point Point in the world frame.
+/// \param[in] _cellSize Size of a cell along each axis.
+/// \return Cell coordinates.
+std::array<int64_t, 3> cellCoordinates(const math::Vector3d &_point,
+    const math::Vector3d &_cellSize)
+{
+  std::array<int64_t, 3> cell;
+  for (std::size_t i = 0; i < 3; ++i)
+    cell[i] = static_cast<int64_t>(std::floor(_point[i] / _cellSize[i]));
+  return cell;
+}
+
+/// \brief Pack cell coordinates into a hash map key. Coordinates wrap around
+/// every 2^21 cells, which only adds candidates that fail the exact test.
+/// \param[in] _x X coordinate of the cell.
+/// \param[in] _y Y coordinate of the cell.
+/// \param[in] _z Z coordinate of the cell.
+/// \return Cell key.
+uint64_t cellKey(const int64_t _x, const int64_t _y, const int64_t _z)
+{
+  constexpr uint64_t mask = (uint64_t{1} << 21) - 1;
+  return ((static_cast<uint64_t>(_x) & mask) << 42) |
+         ((static_cast<uint64_t>(_y) & mask) << 21) |
+         (static_cast<uint64_t>(_z) & mask);
+}
+
+/// \brief Add the full paths of a geometry's mesh, if any.
+/// \param[in] _geom Geometry.
+/// \param[out] _paths Set of mesh paths to add to.
+void addMeshPath(const sdf::Geometry *_geom, std::set<std::string> &_paths)
+{
+  if (nullptr == _geom || _geom->Type() != sdf::GeometryType::MESH)
+    return;
+
+  auto mesh = _geom->MeshShape();
+  if (nullptr != mesh && !mesh->Uri().empty())
+    _paths.insert(asFullPath(mesh->Uri(), mesh->FilePath()));
+}
+
+/// \brief Collect the full paths of the meshes used by the visuals and
+/// collisions of a model and its nested models.
+/// \param[in] _model Model.
+/// \param[out] _paths Set of mesh paths to add to.
+void collectMeshPaths(const sdf::Model *_model, std::set<std::string> &_paths)
+{
+  for (uint64_t l = 0; l < _model->LinkCount(); ++l)
+  {
+    auto link = _model->LinkByIndex(l);
+    for (uint64_t c = 0; c < link->CollisionCount(); ++c)
+      addMeshPath(link->CollisionByIndex(c)->Geom(), _paths);
+    for (uint64_t v = 0; v < link->VisualCount(); ++v)
+      addMeshPath(link->VisualByIndex(v)->Geom(), _paths);
+  }
+
+  for (uint64_t m = 0; m < _model->ModelCount(); ++m)
+    collectMeshPaths(_model->ModelByIndex(m), _paths);
+}
+}
+
 /////////////////////////////////////////////////
 LevelManager::LevelManager(SimulationRunner *_runner, const bool _useLevels)
     : runner(_runner), useLevels(_useLevels)
@@ -77,6 +161,34 @@ LevelManager::LevelManager(SimulationRunner *_runner, const bool _useLevels)
   this->ReadLevelPerformerInfo();
   this->CreatePerformers();
 
+  // Only the default level is loaded at startup without levels and
+  // performers, so that's the only case where the initial load is the same
+  // on every run and can be cached
+  const auto &cachePath = this->runner->serverConfig.WorldCachePath();
+  if (!cachePath.empty() && !this->useLevels && this->performerMap.empty())
+  {
+    this->worldCacheFile = common::joinPaths(cachePath,
+        common::replaceAll(this->runner->sdfWorld->Name(), "/", "_") +
+        ".state");
+
+    // Included models are expanded in the SDF, so changes to them also
+    // invalidate the snapshot. The version invalidates snapshots of older
+    // component serializations.
+    std::stringstream hash;
+    hash << std::hex << std::hash<std::string>()(
+        this->runner->sdfWorld->Element()->ToString("") +
+        IGNITION_GAZEBO_VERSION_FULL);
+    this->worldCacheHash = hash.str();
+  }
+  // Otherwise, each model is stored in its own level chunk the first time
+  // it's created
+  else if (!cachePath.empty())
+  {
+    this->levelChunkDir = common::joinPaths(cachePath,
+        common::replaceAll(this->runner->sdfWorld->Name(), "/", "_") +
+        "_levels");
+  }
+
   std::string service = transport::TopicUtils::AsValidTopic("/world/" +
       this->runner->sdfWorld->Name() + "/level/set_performer");
   if (service.empty())
@@ -126,6 +238,13 @@ void LevelManager::ReadLevelPerformerInfo()
       components::RenderEngineGuiPlugin(
       this->runner->serverConfig.RenderEngineGui()));
 
+  // Same default as the fuel client created by the server
+  std::string resourceCache = this->runner->serverConfig.ResourceCache();
+  if (resourceCache.empty())
+    resourceCache = fuel_tools::ClientConfig().CacheLocation();
+  this->runner->entityCompMgr.CreateComponent(this->worldEntity,
+      components::ResourceCache(resourceCache));
+
   auto worldElem = this->runner->sdfWorld->Element();
 
   // Create Wind
@@ -337,11 +456,41 @@ void LevelManager::ReadLevels(const sdf::ElementPtr &_sdf)
 {
   IGN_PROFILE("LevelManager::ReadLevels");
 
+  this->levelIndexDirty = true;
+
   igndbg << "Reading levels info\n";
 
   if (_sdf == nullptr)
     return;
 
+  double budget = _sdf->Get<double>("level_load_budget", 0.0).first;
+  if (budget < 0)
+  {
+    ignwarn << "The level_load_budget parameter cannot be a negative number. "
+            << "Setting to 0.0\n";
+    budget = 0.0;
+  }
+  this->loadBudget = std::chrono::duration_cast<
+      std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(budget));
+
+  this->prefetchBuffer = _sdf->Get<double>("prefetch_buffer", 0.0).first;
+  if (this->prefetchBuffer < 0)
+  {
+    ignwarn << "The prefetch_buffer parameter cannot be a negative number. "
+            << "Setting to 0.0\n";
+    this->prefetchBuffer = 0.0;
+  }
+
+  int cap = _sdf->Get<int>("hibernation_cap", 0).first;
+  if (cap < 0)
+  {
+    ignwarn << "The hibernation_cap parameter cannot be a negative number. "
+            << "Setting to 0\n";
+    cap = 0;
+  }
+  this->hibernationCap = static_cast<std::size_t>(cap);
+
   for (auto level = _sdf->GetElement("level"); level;
        level = level->GetNextElement("level"))
   {
@@ -561,6 +710,11 @@ void LevelManager::UpdateLevelsState()
   // If levels are not being used, we only process the default level.
   if (this->useLevels)
   {
+    if (this->levelIndexDirty)
+      this->BuildLevelIndex();
+
+    bool hasPerformers{false};
+    std::vector<std::size_t> nearLevels;
     this->runner->entityCompMgr.Each<
       components::Performer,
       components::PerformerLevels,
@@ -569,7 +723,7 @@ void LevelManager::UpdateLevelsState()
           [&](const Entity &_perfEntity,
             components::Performer *,
             components::PerformerLevels *_perfLevels,
-            components::Geometry *_geometry,
+            const components::Geometry *_geometry,
             components::ParentEntity *_parent) -> bool
           {
           IGN_PROFILE("EachPerformer");
@@ -591,65 +745,63 @@ void LevelManager::UpdateLevelsState()
               pose->Data().Pos() + perfBox->Size() / 2};
 
           std::set<Entity> newPerfLevels;
+          hasPerformers = true;
 
-          // loop through levels and check for intersections
+          // Check the levels near the performer for intersections.
           // Add all levels with intersections to the levelsToLoad even if they
           // are currently active.
-          this->runner->entityCompMgr.Each<components::Level, components::Pose,
-            components::Geometry,
-            components::LevelBuffer >(
-                [&](const Entity &_entity, const components::Level *,
-                  const components::Pose *_pose,
-                  const components::Geometry *_levelGeometry,
-                  const components::LevelBuffer *_levelBuffer) -> bool
-                {
-                IGN_PROFILE("CheckPerformerAgainstLevel");
-                // Check if the performer is in this level
-                // assume a box for now
-                auto box = _levelGeometry->Data().BoxShape();
-                if (nullptr == box)
-                {
-                ignerr << "Level [" << _entity
-                << "]'s geometry is not a box." << std::endl;
-                return true;
-                }
-                auto buffer = _levelBuffer->Data();
-                auto center = _pose->Data().Pos();
-                math::AxisAlignedBox region{center - box->Size() / 2,
-                center + box->Size() / 2};
-
-                math::AxisAlignedBox outerRegion{
-                  center - (box->Size() / 2 + buffer),
-                         center + (box->Size() / 2 + buffer)};
-
-                if (region.Intersects(performerVolume))
-                {
-                  newPerfLevels.insert(_entity);
-                  levelsToLoad.push_back(_entity);
-                }
-                else
-                {
-                  // If the level is active, check if the performer is
-                  // outside of the buffer of this level
-                  if (this->IsLevelActive(_entity))
-                  {
-                    if (outerRegion.Intersects(performerVolume))
-                    {
-                      newPerfLevels.insert(_entity);
-                      levelsToLoad.push_back(_entity);
-                      return true;
-                    }
-                    // Otherwise, mark the level to be unloaded
-                    levelsToUnload.push_back(_entity);
-                  }
-                }
-                return true;
-                });
+          this->LevelsNear(performerVolume, nearLevels);
+          for (const auto index : nearLevels)
+          {
+            IGN_PROFILE("CheckPerformerAgainstLevel");
+            const auto &level = this->levelRegions[index];
+
+            // Active levels stay loaded while the performer is within their
+            // buffer. Levels which no performer keeps loaded are unloaded
+            // below.
+            if (level.region.Intersects(performerVolume) ||
+                (this->IsLevelActive(level.entity) &&
+                 level.outerRegion.Intersects(performerVolume)))
+            {
+              newPerfLevels.insert(level.entity);
+              levelsToLoad.push_back(level.entity);
+            }
+          }
 
           *_perfLevels = components::PerformerLevels(newPerfLevels);
 
+          // Prefetch the levels the performer is approaching
+          if (this->prefetchBuffer > 0)
+          {
+            math::AxisAlignedBox prefetchVolume{
+              performerVolume.Min() - this->prefetchBuffer,
+              performerVolume.Max() + this->prefetchBuffer};
+
+            this->LevelsNear(prefetchVolume, nearLevels);
+            for (const auto index : nearLevels)
+            {
+              const auto &level = this->levelRegions[index];
+              if (level.outerRegion.Intersects(prefetchVolume))
+                this->PrefetchLevel(level.entity);
+            }
+          }
+
           return true;
           });
+
+    // Active levels that no performer is in, or within the buffer of, are
+    // unloaded
+    if (hasPerformers)
+    {
+      for (const auto &level : this->activeLevels)
+      {
+        if (this->levelRegionIndex.find(level) !=
+            this->levelRegionIndex.end())
+        {
+          levelsToUnload.push_back(level);
+        }
+      }
+    }
   }
 
   // Sort levelsToLoad and levelsToUnload so as to run std::unique on them.
@@ -727,6 +879,27 @@ void LevelManager::UpdateLevelsState()
   {
     this->UnloadInactiveEntities(entityNamesToUnload);
   }
+  this->ProcessPendingLoads();
+  this->initialLoad = false;
+
+  // Register the meshes of prefetches which are done. The MeshManager isn't
+  // thread-safe, so this is only done on this thread.
+  for (auto it = this->prefetches.begin(); it != this->prefetches.end();)
+  {
+    if (it->wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      ++it;
+      continue;
+    }
+
+    auto &meshManager = *common::MeshManager::Instance();
+    for (auto &mesh : it->get())
+    {
+      if (mesh && !meshManager.HasMesh(mesh->Name()))
+        meshManager.AddMesh(mesh.release());
+    }
+    it = this->prefetches.erase(it);
+  }
 
   // Finally, upadte the list of active levels
   for (const auto &level : levelsToLoad)
@@ -759,6 +932,22 @@ void LevelManager::LoadActiveEntities(const std::set<std::string> &_namesToLoad)
     return;
   }
 
+  // Hibernated entities are still in the ECM, so they're only reactivated
+  std::set<std::string> namesToCreate;
+  for (const auto &name : _namesToLoad)
+  {
+    auto hibernatedIt = this->hibernatedIndex.find(name);
+    if (hibernatedIt == this->hibernatedIndex.end())
+    {
+      namesToCreate.insert(name);
+      continue;
+    }
+
+    this->hibernatedSize -= hibernatedIt->second->size;
+    this->hibernated.erase(hibernatedIt->second);
+    this->hibernatedIndex.erase(hibernatedIt);
+  }
+
   // Models
   for (uint64_t modelIndex = 0;
        modelIndex < this->runner->sdfWorld->ModelCount(); ++modelIndex)
@@ -766,11 +955,18 @@ void LevelManager::LoadActiveEntities(const std::set<std::string> &_namesToLoad)
     // There is no sdf::World::ModelByName so we have to iterate by index and
     // check if the model is in this level
     auto model = this->runner->sdfWorld->ModelByIndex(modelIndex);
-    if (_namesToLoad.find(model->Name()) != _namesToLoad.end())
+    if (namesToCreate.find(model->Name()) != namesToCreate.end())
     {
-      Entity modelEntity = this->entityCreator->CreateEntities(model);
+      this->pendingLoads.push_back({model->Name(), [this, model]()
+          {
+            if (this->RestoreLevelChunk(model))
+              return;
 
-      this->entityCreator->SetParent(modelEntity, this->worldEntity);
+            Entity modelEntity = this->entityCreator->CreateEntities(model);
+
+            this->entityCreator->SetParent(modelEntity, this->worldEntity);
+            this->SaveLevelChunk(model, modelEntity);
+          }, model});
     }
   }
 
@@ -781,11 +977,14 @@ void LevelManager::LoadActiveEntities(const std::set<std::string> &_namesToLoad)
     // There is no sdf::World::ActorByName so we have to iterate by index and
     // check if the actor is in this level
     auto actor = this->runner->sdfWorld->ActorByIndex(actorIndex);
-    if (_namesToLoad.find(actor->Name()) != _namesToLoad.end())
+    if (namesToCreate.find(actor->Name()) != namesToCreate.end())
     {
-      Entity actorEntity = this->entityCreator->CreateEntities(actor);
+      this->pendingLoads.push_back({actor->Name(), [this, actor]()
+          {
+            Entity actorEntity = this->entityCreator->CreateEntities(actor);
 
-      this->entityCreator->SetParent(actorEntity, this->worldEntity);
+            this->entityCreator->SetParent(actorEntity, this->worldEntity);
+          }});
     }
   }
 
@@ -794,29 +993,600 @@ void LevelManager::LoadActiveEntities(const std::set<std::string> &_namesToLoad)
        lightIndex < this->runner->sdfWorld->LightCount(); ++lightIndex)
   {
     auto light = this->runner->sdfWorld->LightByIndex(lightIndex);
-    if (_namesToLoad.find(light->Name()) != _namesToLoad.end())
+    if (namesToCreate.find(light->Name()) != namesToCreate.end())
     {
-      Entity lightEntity = this->entityCreator->CreateEntities(light);
+      this->pendingLoads.push_back({light->Name(), [this, light]()
+          {
+            Entity lightEntity = this->entityCreator->CreateEntities(light);
 
-      this->entityCreator->SetParent(lightEntity, this->worldEntity);
+            this->entityCreator->SetParent(lightEntity, this->worldEntity);
+          }});
     }
   }
 
+  // Queued entities count as active, so they aren't queued again
   this->activeEntityNames.insert(_namesToLoad.begin(), _namesToLoad.end());
 }
 
+/////////////////////////////////////////////////
+void LevelManager::ProcessPendingLoads()
+{
+  IGN_PROFILE("LevelManager::ProcessPendingLoads");
+
+  const bool limited =
+      !this->initialLoad && this->loadBudget.count() > 0;
+  const auto start = std::chrono::steady_clock::now();
+
+  // The initial load is restored from the world cache when possible, and
+  // stored in it otherwise
+  const bool useCache = this->initialLoad && !this->worldCacheFile.empty() &&
+      !this->pendingLoads.empty();
+  std::unordered_set<Entity> cachedBefore;
+  if (useCache)
+  {
+    if (this->RestoreWorldCache())
+    {
+      this->pendingLoads.clear();
+      return;
+    }
+    cachedBefore =
+        this->runner->entityCompMgr.Descendants(this->worldEntity);
+  }
+
+  // Without a budget, the models at the front of the queue are created all
+  // at once, so that their components are built concurrently. Models with a
+  // level chunk are restored from it instead.
+  if (!limited)
+  {
+    std::size_t count{0};
+    std::vector<const sdf::Model *> models;
+    for (const auto &load : this->pendingLoads)
+    {
+      if (nullptr == load.model)
+        break;
+      ++count;
+      if (!this->RestoreLevelChunk(load.model))
+        models.push_back(load.model);
+    }
+
+    if (!models.empty())
+    {
+      auto modelEntities = this->entityCreator->CreateEntities(models);
+      for (std::size_t i = 0; i < modelEntities.size(); ++i)
+      {
+        this->entityCreator->SetParent(modelEntities[i], this->worldEntity);
+        this->SaveLevelChunk(models[i], modelEntities[i]);
+      }
+    }
+
+    this->pendingLoads.erase(this->pendingLoads.begin(),
+        this->pendingLoads.begin() + count);
+  }
+
+  while (!this->pendingLoads.empty())
+  {
+    this->pendingLoads.front().create();
+    this->pendingLoads.pop_front();
+
+    if (limited &&
+        std::chrono::steady_clock::now() - start >= this->loadBudget)
+    {
+      break;
+    }
+  }
+
+  if (useCache)
+    this->SaveWorldCache(cachedBefore);
+}
+
+/////////////////////////////////////////////////
+/// \brief Entities paired with the SDF elements their plugins are loaded
+/// from.
+using EntityElements = std::vector<std::pair<Entity, sdf::ElementPtr>>;
+
+/////////////////////////////////////////////////
+/// \brief Create the components of a restored model and its descendants
+/// which hold SDF objects, since those aren't serialized, and collect the
+/// elements to load their plugins from. Only top level models hold their
+/// SDF DOM.
+/// \param[in] _ecm Entity component manager.
+/// \param[in] _model SDF of the model.
+/// \param[in] _entity Model entity.
+/// \param[out] _models Models and their elements.
+/// \param[out] _sensors Sensors and their elements.
+/// \param[out] _visuals Visuals and their elements.
+static void restoreModelSdf(EntityComponentManager &_ecm,
+    const sdf::Model *_model, Entity _entity, EntityElements &_models,
+    EntityElements &_sensors, EntityElements &_visuals)
+{
+  if (_ecm.ParentEntity(_entity) == kNullEntity ||
+      nullptr == _ecm.Component<components::Model>(_ecm.ParentEntity(_entity)))
+  {
+    _ecm.CreateComponent(_entity, components::ModelSdf(*_model));
+  }
+  _models.emplace_back(_entity, _model->Element());
+
+  for (uint64_t linkIndex = 0; linkIndex < _model->LinkCount(); ++linkIndex)
+  {
+    auto link = _model->LinkByIndex(linkIndex);
+    auto linkEntity = _ecm.EntityByComponents(components::Link(),
+        components::ParentEntity(_entity), components::Name(link->Name()));
+    if (kNullEntity == linkEntity)
+      continue;
+
+    for (uint64_t i = 0; i < link->SensorCount(); ++i)
+    {
+      auto sensor = link->SensorByIndex(i);
+      auto sensorEntity = _ecm.EntityByComponents(components::Sensor(),
+          components::ParentEntity(linkEntity),
+          components::Name(sensor->Name()));
+      if (kNullEntity == sensorEntity)
+        continue;
+
+      if (sensor->Type() == sdf::SensorType::LOGICAL_CAMERA)
+      {
+        _ecm.CreateComponent(sensorEntity,
+            components::LogicalCamera(sensor->Element()));
+      }
+      else if (sensor->Type() == sdf::SensorType::CONTACT)
+      {
+        _ecm.CreateComponent(sensorEntity,
+            components::ContactSensor(sensor->Element()));
+      }
+      _sensors.emplace_back(sensorEntity, sensor->Element());
+    }
+
+    for (uint64_t i = 0; i < link->VisualCount(); ++i)
+    {
+      auto visual = link->VisualByIndex(i);
+      auto visualEntity = _ecm.EntityByComponents(components::Visual(),
+          components::ParentEntity(linkEntity),
+          components::Name(visual->Name()));
+      if (kNullEntity != visualEntity)
+        _visuals.emplace_back(visualEntity, visual->Element());
+    }
+  }
+
+  for (uint64_t i = 0; i < _model->ModelCount(); ++i)
+  {
+    auto nested = _model->ModelByIndex(i);
+    auto nestedEntity = _ecm.EntityByComponents(components::Model(),
+        components::ParentEntity(_entity), components::Name(nested->Name()));
+    if (kNullEntity != nestedEntity)
+    {
+      restoreModelSdf(_ecm, nested, nestedEntity, _models, _sensors,
+          _visuals);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Load the plugins of restored entities, in the same order as when
+/// creating the entities from SDF.
+/// \param[in] _eventMgr Event manager to emit the load events on.
+/// \param[in] _models Models and their elements.
+/// \param[in] _sensors Sensors and their elements.
+/// \param[in] _visuals Visuals and their elements.
+/// \param[in] _actors Actors and their elements.
+static void loadRestoredPlugins(EventManager &_eventMgr,
+    EntityElements &_models, EntityElements &_sensors,
+    EntityElements &_visuals, EntityElements &_actors)
+{
+  auto byEntity = [](const auto &_a, const auto &_b)
+  {
+    return _a.first < _b.first;
+  };
+  std::sort(_models.begin(), _models.end(), byEntity);
+  std::sort(_sensors.begin(), _sensors.end(), byEntity);
+  std::sort(_visuals.begin(), _visuals.end(), byEntity);
+  for (const auto *list : {&_models, &_sensors, &_visuals, &_actors})
+  {
+    for (const auto &[entity, element] : *list)
+    {
+      _eventMgr.Emit<events::LoadPlugins>(entity, element);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Serialize entities for a cache, leaving out the components
+/// holding SDF objects, which can't be serialized. Those are created from
+/// the SDF when restoring.
+/// \param[in] _ecm Entity component manager.
+/// \param[in] _entities Entities to serialize.
+/// \param[out] _state Serialized entities.
+static void cacheState(const EntityComponentManager &_ecm,
+    const std::unordered_set<Entity> &_entities,
+    msgs::SerializedStateMap &_state)
+{
+  std::unordered_set<ComponentTypeId> types;
+  for (auto entity : _entities)
+  {
+    auto entityTypes = _ecm.ComponentTypes(entity);
+    types.insert(entityTypes.begin(), entityTypes.end());
+  }
+
+  types.erase(components::ModelSdf::typeId);
+  types.erase(components::LogicalCamera::typeId);
+  types.erase(components::ContactSensor::typeId);
+
+  _ecm.State(_state, _entities, types, true);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get a value from the header of a cached state.
+/// \param[in] _state Cached state.
+/// \param[in] _key Key of the value.
+/// \return The value, empty if not found.
+static std::string headerValue(const msgs::SerializedStateMap &_state,
+    const std::string &_key)
+{
+  for (const auto &data : _state.header().data())
+  {
+    if (data.key() == _key && data.value_size() > 0)
+      return data.value(0);
+  }
+  return std::string();
+}
+
+/////////////////////////////////////////////////
+/// \brief Add a value to the header of a cached state.
+/// \param[in] _key Key of the value.
+/// \param[in] _value The value.
+/// \param[out] _state Cached state.
+static void addHeaderValue(const std::string &_key, const std::string &_value,
+    msgs::SerializedStateMap &_state)
+{
+  auto data = _state.mutable_header()->add_data();
+  data->set_key(_key);
+  data->add_value(_value);
+}
+
+/////////////////////////////////////////////////
+bool LevelManager::RestoreWorldCache()
+{
+  IGN_PROFILE("LevelManager::RestoreWorldCache");
+
+  std::ifstream file(this->worldCacheFile, std::ios::binary);
+  if (!file)
+    return false;
+
+  msgs::SerializedStateMap state;
+  if (!state.ParseFromIstream(&file))
+  {
+    ignwarn << "Failed to read world cache [" << this->worldCacheFile
+            << "], loading the world from SDF." << std::endl;
+    return false;
+  }
+
+  if (headerValue(state, "world_cache_hash") != this->worldCacheHash)
+  {
+    ignmsg << "World cache [" << this->worldCacheFile << "] is out of date, "
+           << "loading the world from SDF." << std::endl;
+    return false;
+  }
+
+  auto &ecm = this->runner->entityCompMgr;
+  for (const auto &iter : state.entities())
+  {
+    if (ecm.HasEntity(iter.first))
+    {
+      ignwarn << "Entity [" << iter.first << "] of world cache ["
+              << this->worldCacheFile << "] already exists, loading the "
+              << "world from SDF." << std::endl;
+      return false;
+    }
+  }
+
+  ecm.BeginBatch();
+  ecm.SetState(state);
+
+  // The entity graph isn't part of the state
+  for (const auto &iter : state.entities())
+  {
+    auto parent = ecm.Component<components::ParentEntity>(iter.first);
+    if (nullptr != parent)
+      ecm.SetParentEntity(iter.first, parent->Data());
+  }
+
+  EntityElements models;
+  EntityElements actors;
+  EntityElements sensors;
+  EntityElements visuals;
+  for (const auto &load : this->pendingLoads)
+  {
+    auto entity = ecm.EntityByComponents(
+        components::ParentEntity(this->worldEntity),
+        components::Name(load.name));
+    if (kNullEntity == entity)
+      continue;
+
+    if (nullptr != load.model)
+    {
+      restoreModelSdf(ecm, load.model, entity, models, sensors, visuals);
+      continue;
+    }
+
+    // Deserialized actors don't have their SDF elements
+    if (nullptr == ecm.Component<components::Actor>(entity))
+      continue;
+    for (uint64_t i = 0; i < this->runner->sdfWorld->ActorCount(); ++i)
+    {
+      auto actor = this->runner->sdfWorld->ActorByIndex(i);
+      if (actor->Name() == load.name)
+        actors.emplace_back(entity, actor->Element());
+    }
+  }
+  ecm.CommitBatch();
+
+  loadRestoredPlugins(this->runner->EventMgr(), models, sensors, visuals,
+      actors);
+
+  ignmsg << "Restored [" << state.entities().size() << "] entities from "
+         << "world cache [" << this->worldCacheFile << "]." << std::endl;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void LevelManager::SaveWorldCache(const std::unordered_set<Entity> &_before)
+{
+  IGN_PROFILE("LevelManager::SaveWorldCache");
+
+  const auto &ecm = this->runner->entityCompMgr;
+
+  std::unordered_set<Entity> entities;
+  for (auto entity : ecm.Descendants(this->worldEntity))
+  {
+    if (_before.find(entity) == _before.end())
+      entities.insert(entity);
+  }
+
+  msgs::SerializedStateMap state;
+  cacheState(ecm, entities, state);
+  addHeaderValue("world_cache_hash", this->worldCacheHash, state);
+
+  common::createDirectories(common::parentPath(this->worldCacheFile));
+  std::ofstream file(this->worldCacheFile,
+      std::ios::binary | std::ios::trunc);
+  if (!file || !state.SerializeToOstream(&file))
+  {
+    ignwarn << "Failed to write world cache [" << this->worldCacheFile
+            << "]." << std::endl;
+    return;
+  }
+
+  igndbg << "Stored [" << entities.size() << "] entities in world cache ["
+         << this->worldCacheFile << "]." << std::endl;
+}
+
+/////////////////////////////////////////////////
+std::string LevelManager::LevelChunkFile(const sdf::Model *_model) const
+{
+  return common::joinPaths(this->levelChunkDir,
+      common::replaceAll(_model->Name(), "/", "_") + ".state");
+}
+
+/////////////////////////////////////////////////
+/// \brief Hash identifying the level chunk of a model. Included models are
+/// expanded in the SDF, so changes to them also invalidate the chunk.
+/// \param[in] _model SDF of the model.
+/// \return The hash.
+static std::string levelChunkHash(const sdf::Model *_model)
+{
+  std::stringstream hash;
+  hash << std::hex << std::hash<std::string>()(
+      _model->Element()->ToString("") + IGNITION_GAZEBO_VERSION_FULL);
+  return hash.str();
+}
+
+/////////////////////////////////////////////////
+bool LevelManager::RestoreLevelChunk(const sdf::Model *_model)
+{
+  if (this->levelChunkDir.empty())
+    return false;
+
+  IGN_PROFILE("LevelManager::RestoreLevelChunk");
+
+  const auto chunkFile = this->LevelChunkFile(_model);
+  std::ifstream file(chunkFile, std::ios::binary);
+  if (!file)
+    return false;
+
+  msgs::SerializedStateMap chunk;
+  if (!chunk.ParseFromIstream(&file))
+  {
+    ignwarn << "Failed to read level chunk [" << chunkFile << "], loading "
+            << "model [" << _model->Name() << "] from SDF." << std::endl;
+    return false;
+  }
+
+  if (headerValue(chunk, "level_chunk_hash") != levelChunkHash(_model))
+  {
+    igndbg << "Level chunk [" << chunkFile << "] is out of date, loading "
+           << "model [" << _model->Name() << "] from SDF." << std::endl;
+    return false;
+  }
+
+  Entity root{kNullEntity};
+  std::istringstream rootStr(headerValue(chunk, "level_chunk_root"));
+  if (!(rootStr >> root) ||
+      chunk.entities().find(root) == chunk.entities().end())
+  {
+    ignwarn << "Level chunk [" << chunkFile << "] has no model entity, "
+            << "loading model [" << _model->Name() << "] from SDF."
+            << std::endl;
+    return false;
+  }
+
+  auto &ecm = this->runner->entityCompMgr;
+  ecm.BeginBatch();
+
+  // The entities are created with new ids, since the ids stored in the chunk
+  // may be taken by entities of this run
+  std::unordered_map<Entity, Entity> ids;
+  msgs::SerializedStateMap state;
+  for (const auto &iter : chunk.entities())
+  {
+    Entity entity = ecm.CreateEntity();
+    ids[iter.first] = entity;
+
+    auto &entityMsg = (*state.mutable_entities())[entity];
+    entityMsg = iter.second;
+    entityMsg.set_id(entity);
+  }
+  ecm.SetState(state);
+
+  auto newId = [&ids](Entity _oldId)
+  {
+    auto it = ids.find(_oldId);
+    return it == ids.end() ? kNullEntity : it->second;
+  };
+
+  // The entity graph isn't part of the state, and components referring to
+  // entities hold the stored ids
+  for (const auto &[oldId, entity] : ids)
+  {
+    auto jointStates = ecm.Component<components::JointStates>(entity);
+    if (nullptr != jointStates)
+    {
+      for (Entity &joint : jointStates->Data().joints)
+        joint = newId(joint);
+    }
+
+    auto parent = ecm.Component<components::ParentEntity>(entity);
+    if (oldId == root || nullptr == parent)
+      continue;
+
+    parent->Data() = newId(parent->Data());
+    ecm.SetParentEntity(entity, parent->Data());
+  }
+  const Entity modelEntity = ids[root];
+  this->entityCreator->SetParent(modelEntity, this->worldEntity);
+
+  EntityElements models;
+  EntityElements sensors;
+  EntityElements visuals;
+  EntityElements actors;
+  restoreModelSdf(ecm, _model, modelEntity, models, sensors, visuals);
+  ecm.CommitBatch();
+
+  loadRestoredPlugins(this->runner->EventMgr(), models, sensors, visuals,
+      actors);
+
+  igndbg << "Restored model [" << _model->Name() << "] from level chunk ["
+         << chunkFile << "]." << std::endl;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void LevelManager::SaveLevelChunk(const sdf::Model *_model,
+    const Entity _entity)
+{
+  if (this->levelChunkDir.empty())
+    return;
+
+  IGN_PROFILE("LevelManager::SaveLevelChunk");
+
+  msgs::SerializedStateMap chunk;
+  cacheState(this->runner->entityCompMgr,
+      this->runner->entityCompMgr.Descendants(_entity), chunk);
+  addHeaderValue("level_chunk_hash", levelChunkHash(_model), chunk);
+  addHeaderValue("level_chunk_root", std::to_string(_entity), chunk);
+
+  const auto chunkFile = this->LevelChunkFile(_model);
+  common::createDirectories(this->levelChunkDir);
+  std::ofstream file(chunkFile, std::ios::binary | std::ios::trunc);
+  if (!file || !chunk.SerializeToOstream(&file))
+  {
+    ignwarn << "Failed to write level chunk [" << chunkFile << "]."
+            << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+void LevelManager::PrefetchLevel(const Entity _level)
+{
+  if (!this->prefetchedLevels.insert(_level).second)
+    return;
+
+  IGN_PROFILE("LevelManager::PrefetchLevel");
+
+  auto names = this->runner->entityCompMgr
+      .Component<components::LevelEntityNames>(_level);
+  if (nullptr == names)
+    return;
+
+  std::set<std::string> meshPaths;
+  for (uint64_t modelIndex = 0;
+       modelIndex < this->runner->sdfWorld->ModelCount(); ++modelIndex)
+  {
+    auto model = this->runner->sdfWorld->ModelByIndex(modelIndex);
+    if (names->Data().find(model->Name()) != names->Data().end())
+      collectMeshPaths(model, meshPaths);
+  }
+
+  auto &meshManager = *common::MeshManager::Instance();
+  for (auto it = meshPaths.begin(); it != meshPaths.end();)
+  {
+    if (meshManager.HasMesh(*it))
+      it = meshPaths.erase(it);
+    else
+      ++it;
+  }
+
+  if (meshPaths.empty())
+    return;
+
+  igndbg << "Prefetching [" << meshPaths.size() << "] meshes of level ["
+         << _level << "]" << std::endl;
+
+  // Only parse on the worker, the meshes are registered by UpdateLevelsState
+  this->prefetches.push_back(std::async(std::launch::async,
+      [meshPaths]()
+      {
+        std::vector<std::unique_ptr<common::Mesh>> meshes;
+        for (const auto &path : meshPaths)
+          meshes.push_back(parseMeshFile(path));
+        return meshes;
+      }));
+}
+
 /////////////////////////////////////////////////
 void LevelManager::UnloadInactiveEntities(
     const std::set<std::string> &_namesToUnload)
 {
+  // Entities which haven't been created yet only need to be dequeued
+  this->pendingLoads.erase(std::remove_if(this->pendingLoads.begin(),
+      this->pendingLoads.end(), [&](const PendingLoad &_load)
+      {
+        return _namesToUnload.find(_load.name) != _namesToUnload.end();
+      }), this->pendingLoads.end());
+
+  // Top level entities are hibernated if possible, and removed otherwise
+  auto unload = [&](const Entity _entity, const std::string &_name)
+  {
+    if (0 == this->hibernationCap ||
+        this->runner->entityCompMgr.ParentEntity(_entity) !=
+        this->worldEntity ||
+        this->hibernatedIndex.find(_name) != this->hibernatedIndex.end())
+    {
+      this->entityCreator->RequestRemoveEntity(_entity, true);
+      return;
+    }
+
+    const auto size =
+        this->runner->entityCompMgr.Descendants(_entity).size();
+    this->hibernated.push_back({_name, _entity, size});
+    this->hibernatedIndex[_name] = std::prev(this->hibernated.end());
+    this->hibernatedSize += size;
+  };
+
   this->runner->entityCompMgr.Each<components::Model, components::Name>(
       [&](const Entity &_entity, const components::Model *,
           const components::Name *_name) -> bool
       {
         if (_namesToUnload.find(_name->Data()) != _namesToUnload.end())
-        {
-          this->entityCreator->RequestRemoveEntity(_entity, true);
-        }
+          unload(_entity, _name->Data());
         return true;
       });
 
@@ -825,9 +1595,7 @@ void LevelManager::UnloadInactiveEntities(
           const components::Name *_name) -> bool
       {
         if (_namesToUnload.find(_name->Data()) != _namesToUnload.end())
-        {
-          this->entityCreator->RequestRemoveEntity(_entity, true);
-        }
+          unload(_entity, _name->Data());
         return true;
       });
 
@@ -836,18 +1604,147 @@ void LevelManager::UnloadInactiveEntities(
           const components::Name *_name) -> bool
       {
         if (_namesToUnload.find(_name->Data()) != _namesToUnload.end())
-        {
-          this->entityCreator->RequestRemoveEntity(_entity, true);
-        }
+          unload(_entity, _name->Data());
         return true;
       });
 
+  // Evict the least recently unloaded entities over the cap
+  while (this->hibernatedSize > this->hibernationCap)
+  {
+    const auto &oldest = this->hibernated.front();
+    this->entityCreator->RequestRemoveEntity(oldest.entity, true);
+    this->hibernatedSize -= oldest.size;
+    this->hibernatedIndex.erase(oldest.name);
+    this->hibernated.pop_front();
+  }
+
   for (const auto &name : _namesToUnload)
   {
     this->activeEntityNames.erase(name);
   }
 }
 
+/////////////////////////////////////////////////
+void LevelManager::BuildLevelIndex()
+{
+  IGN_PROFILE("LevelManager::BuildLevelIndex");
+
+  this->levelRegions.clear();
+  this->levelRegionIndex.clear();
+  this->levelGrid.clear();
+
+  math::Vector3d sizeSum;
+  this->runner->entityCompMgr.Each<components::Level, components::Pose,
+    components::Geometry, components::LevelBuffer>(
+        [&](const Entity &_entity, const components::Level *,
+          const components::Pose *_pose,
+          const components::Geometry *_levelGeometry,
+          const components::LevelBuffer *_levelBuffer) -> bool
+        {
+          // assume a box for now
+          auto box = _levelGeometry->Data().BoxShape();
+          if (nullptr == box)
+          {
+            ignerr << "Level [" << _entity
+                   << "]'s geometry is not a box." << std::endl;
+            return true;
+          }
+          auto buffer = _levelBuffer->Data();
+          auto center = _pose->Data().Pos();
+
+          LevelRegion level;
+          level.entity = _entity;
+          level.region = math::AxisAlignedBox(center - box->Size() / 2,
+              center + box->Size() / 2);
+          level.outerRegion = math::AxisAlignedBox(
+              center - (box->Size() / 2 + buffer),
+              center + (box->Size() / 2 + buffer));
+          sizeSum += level.outerRegion.Size();
+
+          this->levelRegionIndex[_entity] = this->levelRegions.size();
+          this->levelRegions.push_back(level);
+          return true;
+        });
+
+  // Cells are as large as an average level, so that each level only covers a
+  // few cells
+  this->levelCellSize = math::Vector3d::One;
+  if (!this->levelRegions.empty())
+  {
+    auto meanSize = sizeSum / static_cast<double>(this->levelRegions.size());
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      if (meanSize[i] > 0)
+        this->levelCellSize[i] = meanSize[i];
+    }
+  }
+
+  for (std::size_t index = 0; index < this->levelRegions.size(); ++index)
+  {
+    const auto &outerRegion = this->levelRegions[index].outerRegion;
+    auto minCell = cellCoordinates(outerRegion.Min(), this->levelCellSize);
+    auto maxCell = cellCoordinates(outerRegion.Max(), this->levelCellSize);
+    for (auto x = minCell[0]; x <= maxCell[0]; ++x)
+    {
+      for (auto y = minCell[1]; y <= maxCell[1]; ++y)
+      {
+        for (auto z = minCell[2]; z <= maxCell[2]; ++z)
+        {
+          this->levelGrid[cellKey(x, y, z)].push_back(index);
+        }
+      }
+    }
+  }
+
+  this->levelQueryStamps.assign(this->levelRegions.size(), 0);
+  this->levelIndexDirty = false;
+}
+
+/////////////////////////////////////////////////
+void LevelManager::LevelsNear(const math::AxisAlignedBox &_box,
+    std::vector<std::size_t> &_levels)
+{
+  _levels.clear();
+
+  auto minCell = cellCoordinates(_box.Min(), this->levelCellSize);
+  auto maxCell = cellCoordinates(_box.Max(), this->levelCellSize);
+
+  // Boxes covering more cells than there are levels are cheaper to check
+  // against every level
+  double cellCount{1};
+  for (std::size_t i = 0; i < 3; ++i)
+    cellCount *= static_cast<double>(maxCell[i] - minCell[i] + 1);
+  if (cellCount > static_cast<double>(this->levelRegions.size()))
+  {
+    for (std::size_t index = 0; index < this->levelRegions.size(); ++index)
+      _levels.push_back(index);
+    return;
+  }
+
+  ++this->levelQueryCount;
+  for (auto x = minCell[0]; x <= maxCell[0]; ++x)
+  {
+    for (auto y = minCell[1]; y <= maxCell[1]; ++y)
+    {
+      for (auto z = minCell[2]; z <= maxCell[2]; ++z)
+      {
+        auto cellIt = this->levelGrid.find(cellKey(x, y, z));
+        if (cellIt == this->levelGrid.end())
+          continue;
+
+        for (const auto index : cellIt->second)
+        {
+          if (this->levelQueryStamps[index] != this->levelQueryCount)
+          {
+            this->levelQueryStamps[index] = this->levelQueryCount;
+            _levels.push_back(index);
+          }
+        }
+      }
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 bool LevelManager::IsLevelActive(const Entity _entity) const
 {
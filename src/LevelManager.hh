@@ -21,14 +21,23 @@
 #include <ignition/msgs/boolean.pb.h>
 #include <ignition/msgs/stringmsg.pb.h>
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
 #include <list>
 #include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include <ignition/common/Mesh.hh>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Vector3.hh>
 #include <sdf/Element.hh>
 #include <sdf/Geometry.hh>
 #include <ignition/transport/Node.hh>
@@ -93,6 +102,46 @@ namespace ignition
       private: void LoadActiveEntities(
           const std::set<std::string> &_namesToLoad);
 
+      /// \brief Create queued entities, stopping once the per-step load
+      /// budget is spent. Each entity is created whole, so at least one is
+      /// created per call.
+      private: void ProcessPendingLoads();
+
+      /// \brief Restore the entities of the initial load from the world
+      /// cache, if the cache was stored for the same world.
+      /// \return True if the entities were restored.
+      private: bool RestoreWorldCache();
+
+      /// \brief Store the entities created by the initial load in the world
+      /// cache.
+      /// \param[in] _before Entities which existed before the initial load,
+      /// which aren't stored.
+      private: void SaveWorldCache(const std::unordered_set<Entity> &_before);
+
+      /// \brief Get the file holding the level chunk of a model.
+      /// \param[in] _model SDF of the model.
+      /// \return Path to the file.
+      private: std::string LevelChunkFile(const sdf::Model *_model) const;
+
+      /// \brief Restore a model and its descendants from its level chunk,
+      /// if the chunk was stored for the same model, and load their plugins.
+      /// \param[in] _model SDF of the model.
+      /// \return True if the model was restored.
+      private: bool RestoreLevelChunk(const sdf::Model *_model);
+
+      /// \brief Store a model created from SDF and its descendants in its
+      /// level chunk.
+      /// \param[in] _model SDF of the model.
+      /// \param[in] _entity Model entity.
+      private: void SaveLevelChunk(const sdf::Model *_model,
+                                   const Entity _entity);
+
+      /// \brief Start loading, in the background, the meshes used by the
+      /// entities of a level, so they are cached by the time the level is
+      /// loaded.
+      /// \param[in] _level Level entity.
+      private: void PrefetchLevel(const Entity _level);
+
       /// \brief Unload entities that have been marked for unloading.
       /// \param[in] _namesToUnload List of entity names to unload
       private: void UnloadInactiveEntities(
@@ -120,6 +169,17 @@ namespace ignition
       /// schedule them to be loaded
       private: void ConfigureDefaultLevel();
 
+      /// \brief Build the spatial index of level regions.
+      private: void BuildLevelIndex();
+
+      /// \brief Find the levels whose buffered region may intersect a box,
+      /// using the spatial index.
+      /// \param[in] _box Box to be checked, such as a performer's volume.
+      /// \param[out] _levels Indices into levelRegions of candidate levels,
+      /// without duplicates.
+      private: void LevelsNear(const math::AxisAlignedBox &_box,
+                               std::vector<std::size_t> &_levels);
+
       /// \brief Determine if a level is active
       /// \param[in] _entity Entity of level to be checked
       /// \return True of the level is currently active
@@ -178,6 +238,122 @@ namespace ignition
 
       /// \brief Mutex to protect performersToAdd list.
       private: std::mutex performerToAddMutex;
+
+      /// \brief Region covered by a level.
+      private: struct LevelRegion
+      {
+        /// \brief Level entity.
+        Entity entity;
+
+        /// \brief Region of the level.
+        math::AxisAlignedBox region;
+
+        /// \brief Region of the level extended by its buffer.
+        math::AxisAlignedBox outerRegion;
+      };
+
+      /// \brief Regions of all levels other than the default one.
+      private: std::vector<LevelRegion> levelRegions;
+
+      /// \brief Index into levelRegions of each level entity.
+      private: std::unordered_map<Entity, std::size_t> levelRegionIndex;
+
+      /// \brief Uniform grid over the buffered level regions, mapping a cell
+      /// key to the levels overlapping that cell.
+      private: std::unordered_map<uint64_t, std::vector<std::size_t>>
+          levelGrid;
+
+      /// \brief Size of a grid cell along each axis.
+      private: math::Vector3d levelCellSize{1, 1, 1};
+
+      /// \brief Query number in which each level was last returned by
+      /// LevelsNear, used to skip duplicates.
+      private: std::vector<uint64_t> levelQueryStamps;
+
+      /// \brief Number of LevelsNear queries so far.
+      private: uint64_t levelQueryCount{0};
+
+      /// \brief True if levels were created since the index was built.
+      private: bool levelIndexDirty{true};
+
+      /// \brief Entity waiting to be created.
+      private: struct PendingLoad
+      {
+        /// \brief Name of the entity.
+        std::string name;
+
+        /// \brief Creates the entity and sets its parent.
+        std::function<void()> create;
+
+        /// \brief Model to create, if the entity is a model. Models can be
+        /// created together with the other pending models.
+        const sdf::Model *model{nullptr};
+      };
+
+      /// \brief Entities of loaded levels which haven't been created yet,
+      /// in the order they were requested.
+      private: std::deque<PendingLoad> pendingLoads;
+
+      /// \brief Time spent creating level entities per update, zero for no
+      /// limit.
+      private: std::chrono::steady_clock::duration loadBudget{0};
+
+      /// \brief Distance beyond a level's buffer at which its meshes are
+      /// prefetched, zero to disable prefetching.
+      private: double prefetchBuffer{0.0};
+
+      /// \brief Levels whose meshes have been prefetched.
+      private: std::set<Entity> prefetchedLevels;
+
+      /// \brief Meshes being parsed on worker threads. They're registered
+      /// with common::MeshManager on the simulation thread once they're
+      /// ready.
+      private: std::vector<
+          std::future<std::vector<std::unique_ptr<common::Mesh>>>> prefetches;
+
+      /// \brief Entity of an unloaded level which is kept in the ECM, so it
+      /// can be reactivated without being created again.
+      private: struct HibernatedEntity
+      {
+        /// \brief Name of the entity.
+        std::string name;
+
+        /// \brief The entity.
+        Entity entity;
+
+        /// \brief Number of entities in its subtree, itself included.
+        std::size_t size;
+      };
+
+      /// \brief Hibernated entities, least recently unloaded first.
+      private: std::list<HibernatedEntity> hibernated;
+
+      /// \brief Position in hibernated of each hibernated entity name.
+      private: std::unordered_map<std::string,
+          std::list<HibernatedEntity>::iterator> hibernatedIndex;
+
+      /// \brief Total size of the hibernated entities.
+      private: std::size_t hibernatedSize{0};
+
+      /// \brief Maximum total size of the hibernated entities. Zero disables
+      /// hibernation, so unloaded entities are removed right away.
+      private: std::size_t hibernationCap{0};
+
+      /// \brief True until the first update, which loads its levels without
+      /// a budget so the initial world is complete.
+      private: bool initialLoad{true};
+
+      /// \brief File holding the snapshot of the world's initial load, empty
+      /// if the world cache isn't used.
+      private: std::string worldCacheFile;
+
+      /// \brief Hash of the world's SDF, which identifies the snapshot.
+      private: std::string worldCacheHash;
+
+      /// \brief Directory holding the level chunks, which are snapshots of
+      /// single models, empty if level chunks aren't used. They're used
+      /// instead of the world cache for worlds with levels or performers.
+      private: std::string levelChunkDir;
     };
     }
   }
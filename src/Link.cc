@@ -35,15 +35,72 @@
 
 #include "ignition/gazebo/Link.hh"
 
+#include "LookupCache.hh"
+
 class ignition::gazebo::LinkPrivate
 {
+  /// \brief Look up the components of the link again if the entity
+  /// component manager's structure changed since they were cached.
+  /// \param[in] _ecm Entity component manager.
+  /// \return This, with up to date components.
+  public: LinkPrivate &Cached(const EntityComponentManager &_ecm);
+
   /// \brief Id of link entity.
   public: Entity id{kNullEntity};
+
+  /// \brief Validity of the cached components.
+  public: LookupCacheStamp stamp;
+
+  /// \brief Cached link component, null if there's none.
+  public: const components::Link *link{nullptr};
+
+  /// \brief Cached world pose component, null if there's none.
+  public: const components::WorldPose *worldPose{nullptr};
+
+  /// \brief Cached inertial component, null if there's none.
+  public: const components::Inertial *inertial{nullptr};
+
+  /// \brief Cached world linear velocity component, null if there's none.
+  public: const components::WorldLinearVelocity *worldLinVel{nullptr};
+
+  /// \brief Cached world angular velocity component, null if there's none.
+  public: const components::WorldAngularVelocity *worldAngVel{nullptr};
+
+  /// \brief Cached world linear acceleration component, null if there's
+  /// none.
+  public: const components::WorldLinearAcceleration *worldLinAccel{nullptr};
+
+  /// \brief Cached wrench component, only looked up by AddWorldWrench,
+  /// which has write access to the entity component manager.
+  public: components::ExternalWorldWrenchCmd *wrench{nullptr};
+
+  /// \brief Whether wrench was looked up since the components were cached.
+  public: bool wrenchCached{false};
 };
 
 using namespace ignition;
 using namespace gazebo;
 
+//////////////////////////////////////////////////
+LinkPrivate &LinkPrivate::Cached(const EntityComponentManager &_ecm)
+{
+  if (!this->stamp.Refresh(_ecm))
+    return *this;
+
+  this->link = _ecm.Component<components::Link>(this->id);
+  this->worldPose = _ecm.Component<components::WorldPose>(this->id);
+  this->inertial = _ecm.Component<components::Inertial>(this->id);
+  this->worldLinVel =
+      _ecm.Component<components::WorldLinearVelocity>(this->id);
+  this->worldAngVel =
+      _ecm.Component<components::WorldAngularVelocity>(this->id);
+  this->worldLinAccel =
+      _ecm.Component<components::WorldLinearAcceleration>(this->id);
+  this->wrench = nullptr;
+  this->wrenchCached = false;
+  return *this;
+}
+
 //////////////////////////////////////////////////
 Link::Link(gazebo::Entity _entity)
   : dataPtr(std::make_unique<LinkPrivate>())
@@ -83,12 +140,13 @@ Entity Link::Entity() const
 void Link::ResetEntity(gazebo::Entity _newEntity)
 {
   this->dataPtr->id = _newEntity;
+  this->dataPtr->stamp.Reset();
 }
 
 //////////////////////////////////////////////////
 bool Link::Valid(const EntityComponentManager &_ecm) const
 {
-  return nullptr != _ecm.Component<components::Link>(this->dataPtr->id);
+  return nullptr != this->dataPtr->Cached(_ecm).link;
 }
 
 //////////////////////////////////////////////////
@@ -177,15 +235,20 @@ bool Link::WindMode(const EntityComponentManager &_ecm) const
 std::optional<math::Pose3d> Link::WorldPose(
     const EntityComponentManager &_ecm) const
 {
-  return _ecm.ComponentData<components::WorldPose>(this->dataPtr->id);
+  auto worldPose = this->dataPtr->Cached(_ecm).worldPose;
+  if (!worldPose)
+    return std::nullopt;
+
+  return std::make_optional(worldPose->Data());
 }
 
 //////////////////////////////////////////////////
 std::optional<math::Pose3d> Link::WorldInertialPose(
     const EntityComponentManager &_ecm) const
 {
-  auto inertial = _ecm.Component<components::Inertial>(this->dataPtr->id);
-  auto worldPose = _ecm.Component<components::WorldPose>(this->dataPtr->id);
+  const auto &cached = this->dataPtr->Cached(_ecm);
+  auto inertial = cached.inertial;
+  auto worldPose = cached.worldPose;
 
   if (!worldPose || !inertial)
     return std::nullopt;
@@ -197,7 +260,11 @@ std::optional<math::Pose3d> Link::WorldInertialPose(
 std::optional<math::Vector3d> Link::WorldLinearVelocity(
     const EntityComponentManager &_ecm) const
 {
-  return _ecm.ComponentData<components::WorldLinearVelocity>(this->dataPtr->id);
+  auto worldLinVel = this->dataPtr->Cached(_ecm).worldLinVel;
+  if (!worldLinVel)
+    return std::nullopt;
+
+  return std::make_optional(worldLinVel->Data());
 }
 
 //////////////////////////////////////////////////
@@ -205,12 +272,10 @@ std::optional<math::Vector3d> Link::WorldLinearVelocity(
     const EntityComponentManager &_ecm,
     const math::Vector3d &_offset) const
 {
-  auto worldLinVel =
-      _ecm.Component<components::WorldLinearVelocity>(this->dataPtr->id);
-  auto worldPose =
-      _ecm.Component<components::WorldPose>(this->dataPtr->id);
-  auto worldAngVel =
-      _ecm.Component<components::WorldAngularVelocity>(this->dataPtr->id);
+  const auto &cached = this->dataPtr->Cached(_ecm);
+  auto worldLinVel = cached.worldLinVel;
+  auto worldPose = cached.worldPose;
+  auto worldAngVel = cached.worldAngVel;
 
   if (!worldLinVel || !worldPose || !worldAngVel)
     return std::nullopt;
@@ -224,24 +289,31 @@ std::optional<math::Vector3d> Link::WorldLinearVelocity(
 std::optional<math::Vector3d> Link::WorldAngularVelocity(
     const EntityComponentManager &_ecm) const
 {
-  return _ecm.ComponentData<components::WorldAngularVelocity>(
-      this->dataPtr->id);
+  auto worldAngVel = this->dataPtr->Cached(_ecm).worldAngVel;
+  if (!worldAngVel)
+    return std::nullopt;
+
+  return std::make_optional(worldAngVel->Data());
 }
 
 //////////////////////////////////////////////////
 std::optional<math::Vector3d> Link::WorldLinearAcceleration(
     const EntityComponentManager &_ecm) const
 {
-  return _ecm.ComponentData<components::WorldLinearAcceleration>(
-      this->dataPtr->id);
+  auto worldLinAccel = this->dataPtr->Cached(_ecm).worldLinAccel;
+  if (!worldLinAccel)
+    return std::nullopt;
+
+  return std::make_optional(worldLinAccel->Data());
 }
 
 //////////////////////////////////////////////////
 std::optional<math::Matrix3d> Link::WorldInertiaMatrix(
     const EntityComponentManager &_ecm) const
 {
-  auto inertial = _ecm.Component<components::Inertial>(this->dataPtr->id);
-  auto worldPose = _ecm.Component<components::WorldPose>(this->dataPtr->id);
+  const auto &cached = this->dataPtr->Cached(_ecm);
+  auto inertial = cached.inertial;
+  auto worldPose = cached.worldPose;
 
   if (!worldPose || !inertial)
     return std::nullopt;
@@ -256,9 +328,9 @@ std::optional<math::Matrix3d> Link::WorldInertiaMatrix(
 std::optional<double> Link::WorldKineticEnergy(
     const EntityComponentManager &_ecm) const
 {
-  auto inertial = _ecm.Component<components::Inertial>(this->dataPtr->id);
-  auto worldAngVel =
-      _ecm.Component<components::WorldAngularVelocity>(this->dataPtr->id);
+  const auto &cached = this->dataPtr->Cached(_ecm);
+  auto inertial = cached.inertial;
+  auto worldAngVel = cached.worldAngVel;
 
   if (!worldAngVel || !inertial)
     return std::nullopt;
@@ -281,8 +353,9 @@ std::optional<double> Link::WorldKineticEnergy(
 void Link::AddWorldForce(EntityComponentManager &_ecm,
                          const math::Vector3d &_force) const
 {
-  auto inertial = _ecm.Component<components::Inertial>(this->dataPtr->id);
-  auto worldPose = _ecm.Component<components::WorldPose>(this->dataPtr->id);
+  const auto &cached = this->dataPtr->Cached(_ecm);
+  const components::Inertial *inertial = cached.inertial;
+  auto worldPose = cached.worldPose;
 
   // Can't apply force if the inertial's pose is not found
   if (!inertial || !worldPose)
@@ -304,8 +377,14 @@ void Link::AddWorldWrench(EntityComponentManager &_ecm,
                          const math::Vector3d &_force,
                          const math::Vector3d &_torque) const
 {
-  auto linkWrenchComp =
-      _ecm.Component<components::ExternalWorldWrenchCmd>(this->dataPtr->id);
+  auto &cached = this->dataPtr->Cached(_ecm);
+  if (!cached.wrenchCached)
+  {
+    cached.wrench =
+        _ecm.Component<components::ExternalWorldWrenchCmd>(this->dataPtr->id);
+    cached.wrenchCached = true;
+  }
+  auto linkWrenchComp = cached.wrench;
 
   components::ExternalWorldWrenchCmd wrench;
 
@@ -17,7 +17,10 @@
 
 #include <gtest/gtest.h>
 
+#include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/Link.hh"
+#include "ignition/gazebo/components/Link.hh"
+#include "ignition/gazebo/components/Pose.hh"
 
 /////////////////////////////////////////////////
 TEST(LinkTest, Constructor)
@@ -74,3 +77,45 @@ TEST(LinkTest, MoveAssignmentOperator)
   linkMoved = std::move(link);
   EXPECT_EQ(id, linkMoved.Entity());
 }
+
+/////////////////////////////////////////////////
+TEST(LinkTest, CachedComponents)
+{
+  using namespace ignition;
+  gazebo::EntityComponentManager ecm;
+
+  auto id = ecm.CreateEntity();
+  ecm.CreateComponent(id, gazebo::components::Link());
+  ecm.CreateComponent(id,
+      gazebo::components::WorldPose(math::Pose3d(1, 2, 3, 0, 0, 0)));
+
+  gazebo::Link link(id);
+  EXPECT_TRUE(link.Valid(ecm));
+  ASSERT_TRUE(link.WorldPose(ecm));
+  EXPECT_EQ(math::Pose3d(1, 2, 3, 0, 0, 0), *link.WorldPose(ecm));
+
+  // Data changed in place is seen
+  ecm.SetComponentData<gazebo::components::WorldPose>(id,
+      math::Pose3d(4, 5, 6, 0, 0, 0));
+  EXPECT_EQ(math::Pose3d(4, 5, 6, 0, 0, 0), *link.WorldPose(ecm));
+
+  // Removed components aren't
+  ecm.RemoveComponent<gazebo::components::WorldPose>(id);
+  EXPECT_FALSE(link.WorldPose(ecm));
+
+  // Components created after storage grew, and moved, are found again
+  for (int i = 0; i < 100; ++i)
+  {
+    ecm.CreateComponent(ecm.CreateEntity(),
+        gazebo::components::WorldPose(math::Pose3d::Zero));
+  }
+  ecm.CreateComponent(id,
+      gazebo::components::WorldPose(math::Pose3d(7, 8, 9, 0, 0, 0)));
+  ASSERT_TRUE(link.WorldPose(ecm));
+  EXPECT_EQ(math::Pose3d(7, 8, 9, 0, 0, 0), *link.WorldPose(ecm));
+
+  // Pointing to another entity
+  link.ResetEntity(ecm.CreateEntity());
+  EXPECT_FALSE(link.Valid(ecm));
+  EXPECT_FALSE(link.WorldPose(ecm));
+}
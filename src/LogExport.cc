@@ -0,0 +1,419 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "LogExport.hh"
+
+#include <ignition/msgs/pose_v.pb.h>
+#include <ignition/msgs/serialized.pb.h>
+#include <ignition/msgs/serialized_map.pb.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/transport/log/Log.hh>
+#include <ignition/transport/log/QueryOptions.hh>
+
+#include "ignition/gazebo/components/Factory.hh"
+#include "ignition/gazebo/components/JointForce.hh"
+#include "ignition/gazebo/components/JointPosition.hh"
+#include "ignition/gazebo/components/JointVelocity.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
+
+#include "systems/log/LogCompression.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+namespace
+{
+/// \brief Number of messages decoded in parallel at a time, so memory stays
+/// bounded for large logs.
+constexpr std::size_t kMessagesPerRound{20000};
+
+/// \brief Message copied out of the log, to be decoded by any thread.
+struct RawMessage
+{
+  /// \brief Sim time the message was recorded at.
+  std::chrono::nanoseconds time;
+
+  /// \brief Type name, after decompression.
+  std::string type;
+
+  /// \brief Serialized message, after decompression.
+  std::string data;
+};
+
+/// \brief Rows decoded by a thread, per table name.
+using Rows = std::map<std::string, std::string>;
+
+/// \brief Header of each table, set the first time a table gets rows.
+using Headers = std::map<std::string, std::string>;
+
+//////////////////////////////////////////////////
+/// \brief Format a time and entity, which start every row.
+/// \param[in] _time Sim time.
+/// \param[in] _entity Entity.
+/// \return The first two columns, with a trailing comma.
+std::string rowStart(const std::chrono::nanoseconds &_time, uint64_t _entity)
+{
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "%.9f,%llu,",
+      std::chrono::duration<double>(_time).count(),
+      static_cast<unsigned long long>(_entity));  // NOLINT(runtime/int)
+  return buffer;
+}
+
+//////////////////////////////////////////////////
+/// \brief Quote a string column if needed.
+/// \param[in] _value Value.
+/// \return CSV field.
+std::string csvString(const std::string &_value)
+{
+  if (_value.find_first_of(",\"\n") == std::string::npos)
+    return _value;
+
+  std::string quoted{"\""};
+  for (char c : _value)
+  {
+    if (c == '"')
+      quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+//////////////////////////////////////////////////
+/// \brief Format doubles as CSV fields.
+/// \param[in] _values Values.
+/// \return Comma separated fields, without a trailing comma.
+std::string csvDoubles(std::initializer_list<double> _values)
+{
+  std::string fields;
+  char buffer[32];
+  for (double value : _values)
+  {
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    if (!fields.empty())
+      fields += ',';
+    fields += buffer;
+  }
+  return fields;
+}
+
+//////////////////////////////////////////////////
+/// \brief Deserialize a component.
+/// \param[in] _data Serialized component.
+/// \param[out] _comp Component.
+template <typename ComponentT>
+void deserialize(const std::string &_data, ComponentT &_comp)
+{
+  std::istringstream istr(_data);
+  _comp.Deserialize(istr);
+}
+
+//////////////////////////////////////////////////
+/// \brief Decode a changed component into its table.
+/// \param[in] _time Sim time.
+/// \param[in] _entity Entity.
+/// \param[in] _comp Serialized component.
+/// \param[out] _rows Rows per table.
+/// \param[out] _headers Header of each table with rows.
+void addComponent(const std::chrono::nanoseconds &_time, uint64_t _entity,
+    const msgs::SerializedComponent &_comp, Rows &_rows, Headers &_headers)
+{
+  const auto typeId = static_cast<ComponentTypeId>(_comp.type());
+  auto table = components::Factory::Instance()->Name(typeId);
+  if (table.empty())
+    table = "component_" + std::to_string(typeId);
+
+  auto &rows = _rows[table];
+  const auto start = rowStart(_time, _entity) +
+      (_comp.remove() ? "1," : "0,");
+
+  if (typeId == components::Pose::typeId ||
+      typeId == components::WorldPose::typeId ||
+      typeId == components::TrajectoryPose::typeId)
+  {
+    _headers[table] = "sim_time,entity,removed,x,y,z,roll,pitch,yaw";
+    if (_comp.remove())
+    {
+      rows += start + ",,,,,\n";
+      return;
+    }
+    components::Pose comp;
+    deserialize(_comp.component(), comp);
+    const auto &pose = comp.Data();
+    rows += start + csvDoubles({pose.Pos().X(), pose.Pos().Y(),
+        pose.Pos().Z(), pose.Rot().Roll(), pose.Rot().Pitch(),
+        pose.Rot().Yaw()}) + "\n";
+  }
+  else if (typeId == components::JointPosition::typeId ||
+      typeId == components::JointVelocity::typeId ||
+      typeId == components::JointForce::typeId)
+  {
+    // One row per axis, so joints with any number of axes share columns
+    _headers[table] = "sim_time,entity,removed,axis,value";
+    if (_comp.remove())
+    {
+      rows += start + ",\n";
+      return;
+    }
+    components::JointPosition comp;
+    deserialize(_comp.component(), comp);
+    for (std::size_t i = 0; i < comp.Data().size(); ++i)
+    {
+      rows += start + std::to_string(i) + "," + csvDoubles({comp.Data()[i]}) +
+          "\n";
+    }
+  }
+  else if (typeId == components::Name::typeId)
+  {
+    _headers[table] = "sim_time,entity,removed,name";
+    if (_comp.remove())
+    {
+      rows += start + "\n";
+      return;
+    }
+    components::Name comp;
+    deserialize(_comp.component(), comp);
+    rows += start + csvString(comp.Data()) + "\n";
+  }
+  else
+  {
+    _headers[table] = "sim_time,entity,removed,data";
+    static const char kHex[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(_comp.component().size() * 2);
+    for (unsigned char c : _comp.component())
+    {
+      hex += kHex[c >> 4];
+      hex += kHex[c & 0xF];
+    }
+    rows += start + hex + "\n";
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Decode a recorded message into table rows.
+/// \param[in] _msg Message.
+/// \param[out] _rows Rows per table.
+/// \param[out] _headers Header of each table with rows.
+void decode(const RawMessage &_msg, Rows &_rows, Headers &_headers)
+{
+  if (_msg.type == "ignition.msgs.Pose_V")
+  {
+    msgs::Pose_V poses;
+    poses.ParseFromString(_msg.data);
+    if (poses.pose_size() > 0)
+      _headers["poses"] = "sim_time,entity,name,x,y,z,qw,qx,qy,qz";
+    auto &rows = _rows["poses"];
+    for (const auto &pose : poses.pose())
+    {
+      rows += rowStart(_msg.time, pose.id()) + csvString(pose.name()) + "," +
+          csvDoubles({pose.position().x(), pose.position().y(),
+          pose.position().z(), pose.orientation().w(),
+          pose.orientation().x(), pose.orientation().y(),
+          pose.orientation().z()}) + "\n";
+    }
+  }
+  else if (_msg.type == "ignition.msgs.SerializedStateMap")
+  {
+    msgs::SerializedStateMap state;
+    state.ParseFromString(_msg.data);
+
+    // Protobuf maps aren't ordered, sort so exports are reproducible
+    std::vector<const msgs::SerializedEntityMap *> entities;
+    for (const auto &entIt : state.entities())
+      entities.push_back(&entIt.second);
+    std::sort(entities.begin(), entities.end(),
+        [](const auto *_a, const auto *_b) {return _a->id() < _b->id();});
+
+    for (const auto *entity : entities)
+    {
+      if (entity->remove())
+      {
+        _headers["removed_entities"] = "sim_time,entity";
+        _rows["removed_entities"] += rowStart(_msg.time, entity->id()) + "\n";
+        continue;
+      }
+      std::map<int64_t, const msgs::SerializedComponent *> comps;
+      for (const auto &compIt : entity->components())
+        comps[compIt.first] = &compIt.second;
+      for (const auto &comp : comps)
+        addComponent(_msg.time, entity->id(), *comp.second, _rows, _headers);
+    }
+  }
+  else if (_msg.type == "ignition.msgs.SerializedState")
+  {
+    msgs::SerializedState state;
+    state.ParseFromString(_msg.data);
+    for (const auto &entity : state.entities())
+    {
+      if (entity.remove())
+      {
+        _headers["removed_entities"] = "sim_time,entity";
+        _rows["removed_entities"] += rowStart(_msg.time, entity.id()) + "\n";
+        continue;
+      }
+      for (const auto &comp : entity.components())
+        addComponent(_msg.time, entity.id(), comp, _rows, _headers);
+    }
+  }
+}
+}
+
+//////////////////////////////////////////////////
+bool ignition::gazebo::ExportLog(const std::string &_logPath,
+    const std::string &_outputDir)
+{
+  std::string dbPath = _logPath;
+  if (common::isDirectory(dbPath))
+    dbPath = common::joinPaths(dbPath, "state.tlog");
+
+  transport::log::Log log;
+  if (!common::isFile(dbPath) || !log.Open(dbPath))
+  {
+    ignerr << "Failed to open log file [" << dbPath << "]" << std::endl;
+    return false;
+  }
+
+  if (!common::exists(_outputDir) && !common::createDirectories(_outputDir))
+  {
+    ignerr << "Failed to create directory [" << _outputDir << "]"
+           << std::endl;
+    return false;
+  }
+
+  const std::string keyframeSuffix{"/state_keyframe"};
+  auto isKeyframe = [&keyframeSuffix](const std::string &_topic)
+  {
+    return _topic.size() > keyframeSuffix.size() &&
+        _topic.compare(_topic.size() - keyframeSuffix.size(),
+        keyframeSuffix.size(), keyframeSuffix) == 0;
+  };
+
+  const unsigned int threadCount =
+      std::max(1u, std::thread::hardware_concurrency());
+  std::map<std::string, std::unique_ptr<std::ofstream>> files;
+  std::size_t messageCount{0};
+  bool ok{true};
+
+  // Decode a round of messages in parallel, then append the rows of each
+  // chunk in order
+  auto exportRound = [&](const std::vector<RawMessage> &_messages)
+  {
+    const std::size_t chunks = std::min<std::size_t>(threadCount,
+        _messages.size());
+    std::vector<Rows> rows(chunks);
+    std::vector<Headers> headers(chunks);
+    std::vector<std::thread> threads;
+    for (std::size_t c = 0; c < chunks; ++c)
+    {
+      threads.emplace_back([&, c]
+      {
+        const std::size_t begin = _messages.size() * c / chunks;
+        const std::size_t end = _messages.size() * (c + 1) / chunks;
+        for (std::size_t i = begin; i < end; ++i)
+          decode(_messages[i], rows[c], headers[c]);
+      });
+    }
+    for (auto &thread : threads)
+      thread.join();
+
+    for (std::size_t c = 0; c < chunks; ++c)
+    {
+      for (const auto &table : rows[c])
+      {
+        if (table.second.empty())
+          continue;
+
+        auto &file = files[table.first];
+        if (!file)
+        {
+          auto path = common::joinPaths(_outputDir, table.first + ".csv");
+          file = std::make_unique<std::ofstream>(path, std::ios::binary);
+          if (!file->is_open())
+          {
+            ignerr << "Failed to create [" << path << "]" << std::endl;
+            ok = false;
+          }
+          *file << headers[c][table.first] << "\n";
+        }
+        *file << table.second;
+      }
+    }
+  };
+
+  std::vector<RawMessage> messages;
+  for (const auto &msg : log.QueryMessages())
+  {
+    if (isKeyframe(msg.Topic()))
+      continue;
+
+    RawMessage raw{msg.TimeReceived(), {}, {}};
+    if (systems::IsCompressedLogMessage(msg.Type()))
+    {
+      if (!systems::DecompressLogMessage(msg.Data(), msg.Type(), raw.data,
+          raw.type))
+      {
+        ignwarn << "Skipping corrupted message on [" << msg.Topic() << "]"
+                << std::endl;
+        continue;
+      }
+    }
+    else
+    {
+      raw.type = msg.Type();
+      raw.data = msg.Data();
+    }
+
+    messages.push_back(std::move(raw));
+    if (messages.size() >= kMessagesPerRound)
+    {
+      exportRound(messages);
+      messageCount += messages.size();
+      messages.clear();
+    }
+  }
+  exportRound(messages);
+  messageCount += messages.size();
+
+  for (auto &file : files)
+  {
+    file.second->flush();
+    if (!*file.second)
+      ok = false;
+  }
+
+  ignmsg << "Exported [" << messageCount << "] messages from [" << dbPath
+         << "] into [" << files.size() << "] tables in [" << _outputDir
+         << "]" << std::endl;
+  return ok;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_LOGEXPORT_HH_
+#define IGNITION_GAZEBO_LOGEXPORT_HH_
+
+#include <string>
+
+#include "ignition/gazebo/config.hh"
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    /// \brief Convert a log recorded by the LogRecord system into one CSV
+    /// table per component type, which analytics tools can load by column
+    /// without decoding protobuf messages.
+    ///
+    /// The tables are:
+    /// * `poses.csv`: Poses recorded on the dynamic pose topic.
+    /// * `removed_entities.csv`: Entities removed.
+    /// * `<component type name>.csv`: Changes to each component type. Poses,
+    ///   joint states and names are decoded into columns, other types are
+    ///   exported as hexadecimal serialized data.
+    ///
+    /// Every row starts with the sim time in seconds and the entity. Messages
+    /// are decoded in parallel, in chunks, so rows are in time order. Full
+    /// state keyframes aren't exported, since they repeat the changes.
+    /// \param[in] _logPath Directory of the recorded log, or path to its
+    /// state.tlog file.
+    /// \param[in] _outputDir Directory to write the tables to, created if it
+    /// doesn't exist.
+    /// \return True if the log was exported.
+    bool ExportLog(const std::string &_logPath, const std::string &_outputDir);
+    }
+  }  // namespace gazebo
+}  // namespace ignition
+
+#endif  // IGNITION_GAZEBO_LOGEXPORT_HH_
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_LOOKUPCACHE_HH_
+#define IGNITION_GAZEBO_LOOKUPCACHE_HH_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Entity.hh>
+#include <ignition/gazebo/EntityComponentManager.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    /// \brief Tells whether results cached from an entity component manager
+    /// are still valid, see EntityComponentManager::StructureVersion.
+    class LookupCacheStamp
+    {
+      /// \brief Check whether cached results are out of date, and consider
+      /// them up to date from now on.
+      /// \param[in] _ecm Entity component manager the results are looked up
+      /// in.
+      /// \return True if the results must be looked up again.
+      public: bool Refresh(const EntityComponentManager &_ecm)
+      {
+        const uint64_t version = _ecm.StructureVersion();
+        if (&_ecm == this->ecm && version == this->version)
+          return false;
+
+        this->ecm = &_ecm;
+        this->version = version;
+        return true;
+      }
+
+      /// \brief Mark cached results as out of date.
+      public: void Reset()
+      {
+        this->ecm = nullptr;
+        this->version = 0;
+      }
+
+      /// \brief Entity component manager of the cached results.
+      private: const EntityComponentManager *ecm{nullptr};
+
+      /// \brief Structure version of the cached results.
+      private: uint64_t version{0};
+    };
+
+    /// \brief Entities found by name, such as the links of a model, kept
+    /// until the structure of the entity component manager changes.
+    class NameLookupCache
+    {
+      /// \brief Find an entity by name, looking it up only if it's not
+      /// cached.
+      /// \param[in] _ecm Entity component manager.
+      /// \param[in] _name Name of the entity.
+      /// \param[in] _lookup Callable which looks up the entity, returning
+      /// kNullEntity if there's none.
+      /// \return The entity, or kNullEntity.
+      public: template <typename LookupT>
+              Entity Find(const EntityComponentManager &_ecm,
+                  const std::string &_name, LookupT &&_lookup)
+      {
+        if (this->stamp.Refresh(_ecm))
+          this->entities.clear();
+
+        auto it = this->entities.find(_name);
+        if (it != this->entities.end())
+          return it->second;
+
+        const Entity entity = _lookup();
+        this->entities.emplace(_name, entity);
+        return entity;
+      }
+
+      /// \brief Forget all cached entities.
+      public: void Reset()
+      {
+        this->stamp.Reset();
+        this->entities.clear();
+      }
+
+      /// \brief Validity of the cached entities.
+      private: LookupCacheStamp stamp;
+
+      /// \brief Cached entities by name, including names without an entity.
+      private: std::unordered_map<std::string, Entity> entities;
+    };
+    }
+  }
+}
+#endif
@@ -27,10 +27,18 @@
 #include "ignition/gazebo/components/WindMode.hh"
 #include "ignition/gazebo/Model.hh"
 
+#include "LookupCache.hh"
+
 class ignition::gazebo::ModelPrivate
 {
   /// \brief Id of model entity.
   public: Entity id{kNullEntity};
+
+  /// \brief Joints found by JointByName.
+  public: NameLookupCache jointsByName;
+
+  /// \brief Links found by LinkByName.
+  public: NameLookupCache linksByName;
 };
 
 using namespace ignition::gazebo;
@@ -130,20 +138,26 @@ std::string Model::SourceFilePath(const EntityComponentManager &_ecm) const
 Entity Model::JointByName(const EntityComponentManager &_ecm,
     const std::string &_name)
 {
-  return _ecm.EntityByComponents(
-      components::ParentEntity(this->dataPtr->id),
-      components::Name(_name),
-      components::Joint());
+  return this->dataPtr->jointsByName.Find(_ecm, _name, [&]
+      {
+        return _ecm.EntityByComponents(
+            components::ParentEntity(this->dataPtr->id),
+            components::Name(_name),
+            components::Joint());
+      });
 }
 
 //////////////////////////////////////////////////
 Entity Model::LinkByName(const EntityComponentManager &_ecm,
     const std::string &_name)
 {
-  return _ecm.EntityByComponents(
-      components::ParentEntity(this->dataPtr->id),
-      components::Name(_name),
-      components::Link());
+  return this->dataPtr->linksByName.Find(_ecm, _name, [&]
+      {
+        return _ecm.EntityByComponents(
+            components::ParentEntity(this->dataPtr->id),
+            components::Name(_name),
+            components::Link());
+      });
 }
 
 //////////////////////////////////////////////////
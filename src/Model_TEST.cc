@@ -17,7 +17,11 @@
 
 #include <gtest/gtest.h>
 
+#include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/Model.hh"
+#include "ignition/gazebo/components/Link.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
 
 /////////////////////////////////////////////////
 TEST(ModelTest, Constructor)
@@ -74,3 +78,30 @@ TEST(ModelTest, MoveAssignmentOperator)
   modelMoved = std::move(model);
   EXPECT_EQ(id, modelMoved.Entity());
 }
+
+/////////////////////////////////////////////////
+TEST(ModelTest, CachedLinkByName)
+{
+  using namespace ignition::gazebo;
+  EntityComponentManager ecm;
+
+  auto modelId = ecm.CreateEntity();
+  auto linkId = ecm.CreateEntity();
+  ecm.CreateComponent(linkId, components::Link());
+  ecm.CreateComponent(linkId, components::Name("link"));
+  ecm.CreateComponent(linkId, components::ParentEntity(modelId));
+
+  Model model(modelId);
+  EXPECT_EQ(linkId, model.LinkByName(ecm, "link"));
+  EXPECT_EQ(linkId, model.LinkByName(ecm, "link"));
+  EXPECT_EQ(kNullEntity, model.LinkByName(ecm, "other"));
+
+  // Renamed
+  ecm.SetComponentData<components::Name>(linkId, "other");
+  EXPECT_EQ(kNullEntity, model.LinkByName(ecm, "link"));
+  EXPECT_EQ(linkId, model.LinkByName(ecm, "other"));
+
+  // No longer a link
+  ecm.RemoveComponent<components::Link>(linkId);
+  EXPECT_EQ(kNullEntity, model.LinkByName(ecm, "other"));
+}
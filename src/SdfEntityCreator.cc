@@ -15,6 +15,12 @@
  *
 */
 
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Profiler.hh>
 
@@ -71,6 +77,39 @@
 #include "ignition/gazebo/components/WindMode.hh"
 #include "ignition/gazebo/components/World.hh"
 
+#include "TaskPool.hh"
+
+/// \brief Entities and components created from a model off the main thread,
+/// to be added to the ECM later. Staged entities are indices into the list of
+/// entities created.
+struct StagedEntities
+{
+  /// \brief Function that applies an operation to the ECM, given the
+  /// entities that the staged entities were created as
+  using Operation = std::function<void(
+      ignition::gazebo::EntityComponentManager &,
+      const std::vector<ignition::gazebo::Entity> &)>;
+
+  /// \brief Number of entities created
+  std::size_t entityCount{0};
+
+  /// \brief Component creations and parent changes, in order
+  std::vector<Operation> operations;
+
+  /// \brief Types of the components created for each staged entity
+  std::set<std::pair<ignition::gazebo::Entity,
+      ignition::gazebo::ComponentTypeId>> componentTypes;
+
+  /// \brief Models created, whose plugins should be loaded
+  std::map<ignition::gazebo::Entity, sdf::ElementPtr> newModels;
+
+  /// \brief Sensors created, whose plugins should be loaded
+  std::map<ignition::gazebo::Entity, sdf::ElementPtr> newSensors;
+
+  /// \brief Visuals created, whose plugins should be loaded
+  std::map<ignition::gazebo::Entity, sdf::ElementPtr> newVisuals;
+};
+
 class ignition::gazebo::SdfEntityCreatorPrivate
 {
   /// \brief Pointer to entity component manager. We don't assume ownership.
@@ -90,6 +129,82 @@ class ignition::gazebo::SdfEntityCreatorPrivate
   /// \brief Keep track of new visuals being added, so we load their plugins
   /// only after we have their scoped name.
   public: std::map<Entity, sdf::ElementPtr> newVisuals;
+
+  /// \brief Keep track of new actors created during a batch, so we load
+  /// their plugins when the batch is committed.
+  public: std::map<Entity, sdf::ElementPtr> newActors;
+
+  /// \brief Number of nested batches begun with BeginBatch.
+  public: int batchDepth{0};
+
+  /// \brief If not null, entities and components are recorded here instead of
+  /// being created in the ECM.
+  public: StagedEntities *staging{nullptr};
+
+  /// \brief Load the plugins of all new models, actors, sensors and visuals,
+  /// unless a batch is in progress.
+  public: void LoadPlugins();
+
+  /// \brief Create an entity, or stage it.
+  /// \return The new entity.
+  public: Entity CreateEntity();
+
+  /// \brief Create a component, or stage it.
+  /// \param[in] _entity Entity that will own the component.
+  /// \param[in] _data Component data.
+  public: template<typename ComponentTypeT>
+          void CreateComponent(Entity _entity, const ComponentTypeT &_data)
+  {
+    if (nullptr == this->staging)
+    {
+      this->ecm->CreateComponent(_entity, _data);
+      return;
+    }
+
+    this->staging->componentTypes.insert({_entity, ComponentTypeT::typeId});
+    this->staging->operations.push_back(
+        [_entity, _data](EntityComponentManager &_ecm,
+                         const std::vector<Entity> &_entities)
+        {
+          _ecm.CreateComponent(_entities[_entity], _data);
+        });
+  }
+
+  /// \brief Check whether an entity, created or staged, has a component.
+  /// \param[in] _entity Entity to check.
+  /// \return True if the entity has a component of type ComponentTypeT.
+  public: template<typename ComponentTypeT>
+          bool HasComponent(Entity _entity) const
+  {
+    if (nullptr == this->staging)
+      return nullptr != this->ecm->Component<ComponentTypeT>(_entity);
+
+    return this->staging->componentTypes.count(
+        {_entity, ComponentTypeT::typeId}) > 0;
+  }
+
+  /// \brief Store the SDF DOM of a top level model, to be used when saving
+  /// the world to file. Nested models are saved as part of their top level
+  /// model, so storing their DOM too would copy them once per level of
+  /// nesting.
+  /// \param[in] _entity Model entity.
+  /// \param[in] _model SDF model object.
+  public: void CreateModelSdf(Entity _entity, const sdf::Model *_model)
+  {
+    this->CreateComponent(_entity, components::ModelSdf(*_model));
+  }
+
+  /// \brief Set the parent of an entity, or stage it.
+  /// \param[in] _child Child entity.
+  /// \param[in] _parent Parent entity.
+  public: void SetParent(Entity _child, Entity _parent);
+
+  /// \brief Create all the staged entities and components in the ECM, in
+  /// the order they were staged.
+  /// \param[in] _staged Staged entities.
+  /// \return The entity created for the first staged entity, or kNullEntity
+  /// if nothing was staged.
+  public: Entity Commit(StagedEntities &_staged);
 };
 
 using namespace ignition;
@@ -148,6 +263,9 @@ Entity SdfEntityCreator::CreateEntities(const sdf::World *_world)
 {
   IGN_PROFILE("SdfEntityCreator::CreateEntities(sdf::World)");
 
+  // Update views once all entities are created, instead of on every component
+  this->dataPtr->ecm->BeginBatch();
+
   // World entity
   Entity worldEntity = this->dataPtr->ecm->CreateEntity();
 
@@ -171,12 +289,15 @@ Entity SdfEntityCreator::CreateEntities(const sdf::World *_world)
   }
 
   // Models
+  std::vector<const sdf::Model *> models;
   for (uint64_t modelIndex = 0; modelIndex < _world->ModelCount();
       ++modelIndex)
   {
-    auto model = _world->ModelByIndex(modelIndex);
-    auto modelEntity = this->CreateEntities(model);
+    models.push_back(_world->ModelByIndex(modelIndex));
+  }
 
+  for (auto modelEntity : this->CreateEntities(models))
+  {
     this->SetParent(modelEntity, worldEntity);
   }
 
@@ -218,6 +339,9 @@ Entity SdfEntityCreator::CreateEntities(const sdf::World *_world)
   this->dataPtr->ecm->CreateComponent(worldEntity,
       components::MagneticField(_world->MagneticField()));
 
+  // Plugins may query the ECM, so they need the views to be up to date
+  this->dataPtr->ecm->CommitBatch();
+
   this->dataPtr->eventManager->Emit<events::LoadPlugins>(worldEntity,
       _world->Element());
 
@@ -238,30 +362,117 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Model *_model)
   // canonical link in a model tree using the second arg in this recursive
   // function. We also override child nested models static property if parent
   // model is static
+  // Views are updated once the whole model tree has been created, before the
+  // plugins are loaded
+  this->dataPtr->ecm->BeginBatch();
   auto ent = this->CreateEntities(_model, true, false);
+  this->dataPtr->CreateModelSdf(ent, _model);
+  this->dataPtr->ecm->CommitBatch();
+
+  this->dataPtr->LoadPlugins();
+
+  return ent;
+}
+
+//////////////////////////////////////////////////
+std::vector<Entity> SdfEntityCreator::CreateEntities(
+    const std::vector<const sdf::Model *> &_models)
+{
+  IGN_PROFILE("SdfEntityCreator::CreateEntities(std::vector<sdf::Model>)");
+
+  // Converting the SDF of each model into components is independent of the
+  // other models, so it's done concurrently into separate staging buffers.
+  // These are then added to the ECM in order, so the entities are the same
+  // as when creating the models one by one.
+  std::vector<StagedEntities> stagedModels(_models.size());
+  TaskPool::Shared().ParallelFor(stagedModels.size(), 1,
+      [&](std::size_t _begin, std::size_t _end)
+      {
+        SdfEntityCreator creator(*this->dataPtr->ecm,
+            *this->dataPtr->eventManager);
+        for (auto i = _begin; i < _end; ++i)
+        {
+          creator.dataPtr->staging = &stagedModels[i];
+          auto staged = creator.CreateEntities(_models[i], true, false);
+          creator.dataPtr->CreateModelSdf(staged, _models[i]);
+          stagedModels[i].newModels = std::move(creator.dataPtr->newModels);
+          stagedModels[i].newSensors =
+              std::move(creator.dataPtr->newSensors);
+          stagedModels[i].newVisuals =
+              std::move(creator.dataPtr->newVisuals);
+          creator.dataPtr->newModels.clear();
+          creator.dataPtr->newSensors.clear();
+          creator.dataPtr->newVisuals.clear();
+        }
+      });
+
+  std::vector<Entity> entities;
+  entities.reserve(stagedModels.size());
+
+  this->dataPtr->ecm->BeginBatch();
+  for (auto &staged : stagedModels)
+    entities.push_back(this->dataPtr->Commit(staged));
+  this->dataPtr->ecm->CommitBatch();
+
+  this->dataPtr->LoadPlugins();
+
+  return entities;
+}
+
+//////////////////////////////////////////////////
+void SdfEntityCreator::BeginBatch()
+{
+  ++this->dataPtr->batchDepth;
+  this->dataPtr->ecm->BeginBatch();
+}
+
+//////////////////////////////////////////////////
+void SdfEntityCreator::CommitBatch()
+{
+  if (this->dataPtr->batchDepth <= 0)
+  {
+    ignerr << "Trying to commit a batch which hasn't begun." << std::endl;
+    return;
+  }
+
+  this->dataPtr->ecm->CommitBatch();
+  --this->dataPtr->batchDepth;
+  this->dataPtr->LoadPlugins();
+}
+
+//////////////////////////////////////////////////
+void SdfEntityCreatorPrivate::LoadPlugins()
+{
+  // Plugins may query the ECM, so wait until the views are up to date
+  if (this->batchDepth > 0)
+    return;
 
   // Load all model plugins afterwards, so we get scoped name for nested models.
-  for (const auto &[entity, element] : this->dataPtr->newModels)
+  for (const auto &[entity, element] : this->newModels)
   {
-    this->dataPtr->eventManager->Emit<events::LoadPlugins>(entity, element);
+    this->eventManager->Emit<events::LoadPlugins>(entity, element);
   }
-  this->dataPtr->newModels.clear();
+  this->newModels.clear();
+
+  for (const auto &[entity, element] : this->newActors)
+  {
+    this->eventManager->Emit<events::LoadPlugins>(entity, element);
+  }
+  this->newActors.clear();
 
   // Load sensor plugins after model, so we get scoped name.
-  for (const auto &[entity, element] : this->dataPtr->newSensors)
+  for (const auto &[entity, element] : this->newSensors)
   {
-    this->dataPtr->eventManager->Emit<events::LoadPlugins>(entity, element);
+    this->eventManager->Emit<events::LoadPlugins>(entity, element);
   }
-  this->dataPtr->newSensors.clear();
+  this->newSensors.clear();
 
   // Load visual plugins after model, so we get scoped name.
-  for (const auto &[entity, element] : this->dataPtr->newVisuals)
+  for (const auto &[entity, element] : this->newVisuals)
   {
-    this->dataPtr->eventManager->Emit<events::LoadPlugins>(entity, element);
+    this->eventManager->Emit<events::LoadPlugins>(entity, element);
   }
-  this->dataPtr->newVisuals.clear();
-
-  return ent;
+  this->newVisuals.clear();
 }
 
 //////////////////////////////////////////////////
@@ -269,22 +480,22 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Model *_model,
     bool _createCanonicalLink, bool _staticParent)
 {
   // Entity
-  Entity modelEntity = this->dataPtr->ecm->CreateEntity();
+  Entity modelEntity = this->dataPtr->CreateEntity();
 
   // Components
-  this->dataPtr->ecm->CreateComponent(modelEntity, components::Model());
-  this->dataPtr->ecm->CreateComponent(modelEntity,
+  this->dataPtr->CreateComponent(modelEntity, components::Model());
+  this->dataPtr->CreateComponent(modelEntity,
       components::Pose(ResolveSdfPose(_model->SemanticPose())));
-  this->dataPtr->ecm->CreateComponent(modelEntity,
+  this->dataPtr->CreateComponent(modelEntity,
       components::Name(_model->Name()));
   bool isStatic = _model->Static() || _staticParent;
-  this->dataPtr->ecm->CreateComponent(modelEntity,
+  this->dataPtr->CreateComponent(modelEntity,
       components::Static(isStatic));
-  this->dataPtr->ecm->CreateComponent(
+  this->dataPtr->CreateComponent(
       modelEntity, components::WindMode(_model->EnableWind()));
-  this->dataPtr->ecm->CreateComponent(
+  this->dataPtr->CreateComponent(
       modelEntity, components::SelfCollide(_model->SelfCollide()));
-  this->dataPtr->ecm->CreateComponent(
+  this->dataPtr->CreateComponent(
       modelEntity, components::SourceFilePath(_model->Element()->FilePath()));
 
   // NOTE: Pose components of links, visuals, and collisions are expressed in
@@ -304,15 +515,15 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Model *_model,
         ((_model->CanonicalLinkName().empty() && linkIndex == 0) ||
         (link == _model->CanonicalLink())))
     {
-      this->dataPtr->ecm->CreateComponent(linkEntity,
+      this->dataPtr->CreateComponent(linkEntity,
           components::CanonicalLink());
       canonicalLinkCreated = true;
     }
 
     // Set wind mode if the link didn't override it
-    if (!this->dataPtr->ecm->Component<components::WindMode>(linkEntity))
+    if (!this->dataPtr->HasComponent<components::WindMode>(linkEntity))
     {
-      this->dataPtr->ecm->CreateComponent(
+      this->dataPtr->CreateComponent(
           linkEntity, components::WindMode(_model->EnableWind()));
     }
   }
@@ -343,10 +554,6 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Model *_model,
     this->SetParent(nestedModelEntity, modelEntity);
   }
 
-  // Store the model's SDF DOM to be used when saving the world to file
-  this->dataPtr->ecm->CreateComponent(
-      modelEntity, components::ModelSdf(*_model));
-
   // Keep track of models so we can load their plugins after loading the entire
   // model and having its full scoped name.
   this->dataPtr->newModels[modelEntity] = _model->Element();
@@ -360,18 +567,25 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Actor *_actor)
   IGN_PROFILE("SdfEntityCreator::CreateEntities(sdf::Actor)");
 
   // Entity
-  Entity actorEntity = this->dataPtr->ecm->CreateEntity();
+  Entity actorEntity = this->dataPtr->CreateEntity();
 
   // Components
-  this->dataPtr->ecm->CreateComponent(actorEntity, components::Actor(*_actor));
-  this->dataPtr->ecm->CreateComponent(actorEntity,
+  this->dataPtr->CreateComponent(actorEntity, components::Actor(*_actor));
+  this->dataPtr->CreateComponent(actorEntity,
       components::Pose(_actor->RawPose()));
-  this->dataPtr->ecm->CreateComponent(actorEntity,
+  this->dataPtr->CreateComponent(actorEntity,
       components::Name(_actor->Name()));
 
   // Actor plugins
-  this->dataPtr->eventManager->Emit<events::LoadPlugins>(actorEntity,
-      _actor->Element());
+  if (this->dataPtr->batchDepth > 0)
+  {
+    this->dataPtr->newActors[actorEntity] = _actor->Element();
+  }
+  else
+  {
+    this->dataPtr->eventManager->Emit<events::LoadPlugins>(actorEntity,
+        _actor->Element());
+  }
 
   return actorEntity;
 }
@@ -382,13 +596,13 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Light *_light)
   IGN_PROFILE("SdfEntityCreator::CreateEntities(sdf::Light)");
 
   // Entity
-  Entity lightEntity = this->dataPtr->ecm->CreateEntity();
+  Entity lightEntity = this->dataPtr->CreateEntity();
 
   // Components
-  this->dataPtr->ecm->CreateComponent(lightEntity, components::Light(*_light));
-  this->dataPtr->ecm->CreateComponent(lightEntity,
+  this->dataPtr->CreateComponent(lightEntity, components::Light(*_light));
+  this->dataPtr->CreateComponent(lightEntity,
       components::Pose(ResolveSdfPose(_light->SemanticPose())));
-  this->dataPtr->ecm->CreateComponent(lightEntity,
+  this->dataPtr->CreateComponent(lightEntity,
       components::Name(_light->Name()));
 
   return lightEntity;
@@ -400,21 +614,21 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Link *_link)
   IGN_PROFILE("SdfEntityCreator::CreateEntities(sdf::Link)");
 
   // Entity
-  Entity linkEntity = this->dataPtr->ecm->CreateEntity();
+  Entity linkEntity = this->dataPtr->CreateEntity();
 
   // Components
-  this->dataPtr->ecm->CreateComponent(linkEntity, components::Link());
+  this->dataPtr->CreateComponent(linkEntity, components::Link());
 
-  this->dataPtr->ecm->CreateComponent(linkEntity,
+  this->dataPtr->CreateComponent(linkEntity,
       components::Pose(ResolveSdfPose(_link->SemanticPose())));
-  this->dataPtr->ecm->CreateComponent(linkEntity,
+  this->dataPtr->CreateComponent(linkEntity,
       components::Name(_link->Name()));
-  this->dataPtr->ecm->CreateComponent(linkEntity,
+  this->dataPtr->CreateComponent(linkEntity,
       components::Inertial(_link->Inertial()));
 
   if (_link->EnableWind())
   {
-    this->dataPtr->ecm->CreateComponent(
+    this->dataPtr->CreateComponent(
         linkEntity, components::WindMode(_link->EnableWind()));
   }
 
@@ -467,35 +681,35 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Joint *_joint)
   IGN_PROFILE("SdfEntityCreator::CreateEntities(sdf::Joint)");
 
   // Entity
-  Entity jointEntity = this->dataPtr->ecm->CreateEntity();
+  Entity jointEntity = this->dataPtr->CreateEntity();
 
   // Components
-  this->dataPtr->ecm->CreateComponent(jointEntity,
+  this->dataPtr->CreateComponent(jointEntity,
       components::Joint());
-  this->dataPtr->ecm->CreateComponent(jointEntity,
+  this->dataPtr->CreateComponent(jointEntity,
       components::JointType(_joint->Type()));
 
   if (_joint->Axis(0))
   {
-    this->dataPtr->ecm->CreateComponent(jointEntity,
+    this->dataPtr->CreateComponent(jointEntity,
         components::JointAxis(*_joint->Axis(0)));
   }
 
   if (_joint->Axis(1))
   {
-    this->dataPtr->ecm->CreateComponent(jointEntity,
+    this->dataPtr->CreateComponent(jointEntity,
         components::JointAxis2(*_joint->Axis(1)));
   }
 
-  this->dataPtr->ecm->CreateComponent(jointEntity,
+  this->dataPtr->CreateComponent(jointEntity,
       components::Pose(ResolveSdfPose(_joint->SemanticPose())));
-  this->dataPtr->ecm->CreateComponent(jointEntity ,
+  this->dataPtr->CreateComponent(jointEntity ,
       components::Name(_joint->Name()));
-  this->dataPtr->ecm->CreateComponent(jointEntity ,
+  this->dataPtr->CreateComponent(jointEntity ,
       components::ThreadPitch(_joint->ThreadPitch()));
-  this->dataPtr->ecm->CreateComponent(jointEntity,
+  this->dataPtr->CreateComponent(jointEntity,
       components::ParentLinkName(_joint->ParentLinkName()));
-  this->dataPtr->ecm->CreateComponent(jointEntity,
+  this->dataPtr->CreateComponent(jointEntity,
       components::ChildLinkName(_joint->ChildLinkName()));
 
   return jointEntity;
@@ -507,37 +721,37 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Visual *_visual)
   IGN_PROFILE("SdfEntityCreator::CreateEntities(sdf::Visual)");
 
   // Entity
-  Entity visualEntity = this->dataPtr->ecm->CreateEntity();
+  Entity visualEntity = this->dataPtr->CreateEntity();
 
   // Components
-  this->dataPtr->ecm->CreateComponent(visualEntity, components::Visual());
-  this->dataPtr->ecm->CreateComponent(visualEntity,
+  this->dataPtr->CreateComponent(visualEntity, components::Visual());
+  this->dataPtr->CreateComponent(visualEntity,
       components::Pose(ResolveSdfPose(_visual->SemanticPose())));
-  this->dataPtr->ecm->CreateComponent(visualEntity,
+  this->dataPtr->CreateComponent(visualEntity,
       components::Name(_visual->Name()));
-  this->dataPtr->ecm->CreateComponent(visualEntity,
+  this->dataPtr->CreateComponent(visualEntity,
       components::CastShadows(_visual->CastShadows()));
-  this->dataPtr->ecm->CreateComponent(visualEntity,
+  this->dataPtr->CreateComponent(visualEntity,
       components::Transparency(_visual->Transparency()));
-  this->dataPtr->ecm->CreateComponent(visualEntity,
+  this->dataPtr->CreateComponent(visualEntity,
       components::VisibilityFlags(_visual->VisibilityFlags()));
 
   if (_visual->HasLaserRetro())
   {
-    this->dataPtr->ecm->CreateComponent(visualEntity,
+    this->dataPtr->CreateComponent(visualEntity,
         components::LaserRetro(_visual->LaserRetro()));
   }
 
   if (_visual->Geom())
   {
-    this->dataPtr->ecm->CreateComponent(visualEntity,
+    this->dataPtr->CreateComponent(visualEntity,
         components::Geometry(*_visual->Geom()));
   }
 
   // \todo(louise) Populate with default material if undefined
   if (_visual->Material())
   {
-    this->dataPtr->ecm->CreateComponent(visualEntity,
+    this->dataPtr->CreateComponent(visualEntity,
         components::Material(*_visual->Material()));
   }
 
@@ -554,23 +768,23 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Collision *_collision)
   IGN_PROFILE("SdfEntityCreator::CreateEntities(sdf::Collision)");
 
   // Entity
-  Entity collisionEntity = this->dataPtr->ecm->CreateEntity();
+  Entity collisionEntity = this->dataPtr->CreateEntity();
 
   // Components
-  this->dataPtr->ecm->CreateComponent(collisionEntity,
+  this->dataPtr->CreateComponent(collisionEntity,
       components::Collision());
-  this->dataPtr->ecm->CreateComponent(collisionEntity,
+  this->dataPtr->CreateComponent(collisionEntity,
       components::Pose(ResolveSdfPose(_collision->SemanticPose())));
-  this->dataPtr->ecm->CreateComponent(collisionEntity,
+  this->dataPtr->CreateComponent(collisionEntity,
       components::Name(_collision->Name()));
 
   if (_collision->Geom())
   {
-    this->dataPtr->ecm->CreateComponent(collisionEntity,
+    this->dataPtr->CreateComponent(collisionEntity,
         components::Geometry(*_collision->Geom()));
   }
 
-  this->dataPtr->ecm->CreateComponent(collisionEntity,
+  this->dataPtr->CreateComponent(collisionEntity,
       components::CollisionElement(*_collision));
 
   return collisionEntity;
@@ -582,107 +796,107 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Sensor *_sensor)
   IGN_PROFILE("SdfEntityCreator::CreateEntities(sdf::Sensor)");
 
   // Entity
-  Entity sensorEntity = this->dataPtr->ecm->CreateEntity();
+  Entity sensorEntity = this->dataPtr->CreateEntity();
 
   // Components
-  this->dataPtr->ecm->CreateComponent(sensorEntity,
+  this->dataPtr->CreateComponent(sensorEntity,
       components::Sensor());
-  this->dataPtr->ecm->CreateComponent(sensorEntity,
+  this->dataPtr->CreateComponent(sensorEntity,
       components::Pose(ResolveSdfPose(_sensor->SemanticPose())));
-  this->dataPtr->ecm->CreateComponent(sensorEntity,
+  this->dataPtr->CreateComponent(sensorEntity,
       components::Name(_sensor->Name()));
 
   if (_sensor->Type() == sdf::SensorType::CAMERA)
   {
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::Camera(*_sensor));
   }
   else if (_sensor->Type() == sdf::SensorType::GPU_LIDAR)
   {
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::GpuLidar(*_sensor));
   }
   else if (_sensor->Type() == sdf::SensorType::LIDAR)
   {
     // \todo(anyone) Implement CPU-base lidar
-    // this->dataPtr->ecm->CreateComponent(sensorEntity,
+    // this->dataPtr->CreateComponent(sensorEntity,
     //     components::Lidar(*_sensor));
     ignwarn << "Sensor type LIDAR not supported yet. Try using"
       << "a GPU LIDAR instead." << std::endl;
   }
   else if (_sensor->Type() == sdf::SensorType::DEPTH_CAMERA)
   {
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::DepthCamera(*_sensor));
   }
   else if (_sensor->Type() == sdf::SensorType::RGBD_CAMERA)
   {
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::RgbdCamera(*_sensor));
   }
   else if (_sensor->Type() == sdf::SensorType::THERMAL_CAMERA)
   {
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::ThermalCamera(*_sensor));
   }
   else if (_sensor->Type() == sdf::SensorType::AIR_PRESSURE)
   {
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::AirPressureSensor(*_sensor));
 
     // create components to be filled by physics
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::WorldPose(math::Pose3d::Zero));
   }
   else if (_sensor->Type() == sdf::SensorType::ALTIMETER)
   {
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::Altimeter(*_sensor));
 
     // create components to be filled by physics
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::WorldPose(math::Pose3d::Zero));
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::WorldLinearVelocity(math::Vector3d::Zero));
   }
   else if (_sensor->Type() == sdf::SensorType::IMU)
   {
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
             components::Imu(*_sensor));
 
     // create components to be filled by physics
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
             components::WorldPose(math::Pose3d::Zero));
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
             components::AngularVelocity(math::Vector3d::Zero));
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
             components::LinearAcceleration(math::Vector3d::Zero));
   }
   else if (_sensor->Type() == sdf::SensorType::LOGICAL_CAMERA)
   {
     auto elem = _sensor->Element();
 
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::LogicalCamera(elem));
 
     // create components to be filled by physics
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::WorldPose(math::Pose3d::Zero));
   }
   else if (_sensor->Type() == sdf::SensorType::MAGNETOMETER)
   {
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::Magnetometer(*_sensor));
 
     // create components to be filled by physics
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
         components::WorldPose(math::Pose3d::Zero));
   }
   else if (_sensor->Type() == sdf::SensorType::CONTACT)
   {
     auto elem = _sensor->Element();
 
-    this->dataPtr->ecm->CreateComponent(sensorEntity,
+    this->dataPtr->CreateComponent(sensorEntity,
             components::ContactSensor(elem));
     // We will let the contact system create the necessary components for
     // physics to populate.
@@ -721,9 +935,59 @@ void SdfEntityCreator::RequestRemoveEntity(Entity _entity, bool _recursive)
 //////////////////////////////////////////////////
 void SdfEntityCreator::SetParent(Entity _child, Entity _parent)
 {
+  this->dataPtr->SetParent(_child, _parent);
+}
+
+//////////////////////////////////////////////////
+Entity SdfEntityCreatorPrivate::CreateEntity()
+{
+  if (nullptr == this->staging)
+    return this->ecm->CreateEntity();
+
+  return this->staging->entityCount++;
+}
+
+//////////////////////////////////////////////////
+void SdfEntityCreatorPrivate::SetParent(Entity _child, Entity _parent)
+{
+  if (nullptr != this->staging)
+  {
+    this->staging->operations.push_back(
+        [_child, _parent](EntityComponentManager &_ecm,
+                          const std::vector<Entity> &_entities)
+        {
+          _ecm.SetParentEntity(_entities[_child], _entities[_parent]);
+          _ecm.CreateComponent(_entities[_child],
+              components::ParentEntity(_entities[_parent]));
+        });
+    return;
+  }
+
   // TODO(louise) Figure out a way to avoid duplication while keeping all
   // state in components and also keeping a convenient graph in the ECM
-  this->dataPtr->ecm->SetParentEntity(_child, _parent);
-  this->dataPtr->ecm->CreateComponent(_child,
-      components::ParentEntity(_parent));
+  this->ecm->SetParentEntity(_child, _parent);
+  this->ecm->CreateComponent(_child, components::ParentEntity(_parent));
+}
+
+//////////////////////////////////////////////////
+Entity SdfEntityCreatorPrivate::Commit(StagedEntities &_staged)
+{
+  std::vector<Entity> entities;
+  entities.reserve(_staged.entityCount);
+  for (std::size_t i = 0; i < _staged.entityCount; ++i)
+    entities.push_back(this->ecm->CreateEntity());
+
+  for (const auto &operation : _staged.operations)
+    operation(*this->ecm, entities);
+
+  for (const auto &[entity, element] : _staged.newModels)
+    this->newModels[entities[entity]] = element;
+  for (const auto &[entity, element] : _staged.newSensors)
+    this->newSensors[entities[entity]] = element;
+  for (const auto &[entity, element] : _staged.newVisuals)
+    this->newVisuals[entities[entity]] = element;
+
+  _staged = StagedEntities();
+
+  return entities.empty() ? kNullEntity : entities.front();
 }
@@ -18,6 +18,7 @@
 #include "SdfGenerator.hh"
 
 #include <memory>
+#include <sstream>
 #include <vector>
 
 #include <sdf/sdf.hh>
@@ -43,23 +44,6 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE
 {
 namespace sdf_generator
 {
-  /////////////////////////////////////////////////
-  /// \brief Copy sdf::Element from component
-  /// \param[in] _comp Component containing an sdf::Element. The component has
-  /// to be a DOM object
-  /// \param[out] _elem Output sdf::Element
-  /// \returns False if the component is nullptr
-  template <typename ComponentT>
-  static bool copySdf(ComponentT *_comp, const sdf::ElementPtr &_elem)
-  {
-    if (nullptr != _comp)
-    {
-      _elem->Copy(_comp->Data().Element());
-      return true;
-    }
-    return false;
-  }
-
   /////////////////////////////////////////////////
   /// \brief Remove version number from Fuel URI
   /// \param[in, out] _uri The URI from which the version number is removed.
@@ -244,18 +228,290 @@ namespace sdf_generator
   }
 
   /////////////////////////////////////////////////
-  std::optional<std::string> generateWorld(
-      const EntityComponentManager &_ecm, const Entity &_entity,
+  /// \brief Set the name and pose of a model or include element.
+  /// \param[in, out] _elem Element to update
+  /// \param[in] _model Model the element is generated from
+  /// \param[in] _nameElem Whether the name is an element, as in <include>,
+  /// instead of an attribute, as in <model>
+  static void setNameAndPose(const sdf::ElementPtr &_elem,
+                             const ModelSnapshot &_model, bool _nameElem)
+  {
+    if (_nameElem)
+      _elem->GetElement("name")->Set(_model.name);
+    else
+      _elem->GetAttribute("name")->Set(_model.name);
+
+    auto poseElem = _elem->GetElement("pose");
+
+    // Remove all attributes of poseElem
+    sdf::ParamPtr relativeTo = poseElem->GetAttribute("relative_to");
+    if (nullptr != relativeTo)
+    {
+      relativeTo->Reset();
+    }
+    poseElem->Set(_model.pose);
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Update a sdf::Element of an inlined model from a snapshot.
+  /// \param[in, out] _elem sdf::Element to update
+  /// \param[in] _model Model snapshot
+  /// \returns true if update succeeded.
+  static bool updateModelElement(const sdf::ElementPtr &_elem,
+                                 const ModelSnapshot &_model)
+  {
+    if (nullptr == _model.sdf)
+      return false;
+    _elem->Copy(_model.sdf);
+
+    // Update sdf based current components. Here are the list of components to
+    // be updated:
+    // - Name
+    // - Pose
+    // This list is to be updated as other components become updateable during
+    // simulation
+    setNameAndPose(_elem, _model, false);
+
+    if (_elem->HasElement("link") && _model.hasSourceFilePath)
+    {
+      // Update relative URIs to use absolute paths. Relative URIs work fine in
+      // included models, but they have to be converted to absolute URIs when
+      // the included model is expanded.
+      relativeToAbsoluteUri(_elem, common::parentPath(_model.sourceFilePath));
+    }
+    return true;
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Add the <model> or <include> element of a top level model to a
+  /// world element.
+  /// \param[in, out] _worldElem World element to add to
+  /// \param[in] _model Model snapshot
+  /// \param[in] _worldDir Directory containing the world file
+  /// \param[in] _includeUriMap Map from file paths to URIs used to preserve
+  /// included Fuel models
+  /// \param[in] _config Configuration for the world generator
+  /// \returns The added element
+  static sdf::ElementPtr addModelElement(const sdf::ElementPtr &_worldElem,
+      const ModelSnapshot &_model, const std::string &_worldDir,
       const IncludeUriMap &_includeUriMap,
       const msgs::SdfGeneratorConfig &_config)
   {
+    auto modelDir = common::parentPath(_model.sdf->FilePath());
+
+    bool modelFromInclude = isModelFromInclude(modelDir, _worldDir);
+
+    auto uriMapIt = _includeUriMap.find(modelDir);
+
+    auto modelConfig = _config.global_entity_gen_config();
+    auto modelConfigIt =
+        _config.override_entity_gen_configs().find(_model.scopedName);
+    if (modelConfigIt != _config.override_entity_gen_configs().end())
+    {
+      mergeWithOverride(modelConfig, modelConfigIt->second);
+    }
+
+    if (modelConfig.expand_include_tags().data() || !modelFromInclude)
+    {
+      auto modelElem = _worldElem->AddElement("model");
+      updateModelElement(modelElem, _model);
+      return modelElem;
+    }
+
+    std::string uriStr;
+    if (uriMapIt != _includeUriMap.end())
+    {
+      // The fuel URI might have a version number. If it does, we remove
+      // it unless saveFuelModelVersion is set to true.
+      // Check if this is a fuel URI. We assume that it is a fuel URI if
+      // the scheme is http or https.
+      common::URI uri(uriMapIt->second);
+      if (uri.Scheme() == "http" || uri.Scheme() == "https")
+      {
+        removeVersionFromUri(uri);
+      }
+
+      if (modelConfig.save_fuel_version().data())
+      {
+        // Find out the model version from the file path. Note that we
+        // do this from the file path instead of the Fuel URI because the
+        // URI may not contain version information.
+        //
+        // We are assuming here that, for Fuel models, the directory
+        // containing the sdf file has the same name as the model version.
+        // For example, if the uri is
+        // https://example.org/1.0/test/models/Backpack
+        // the path to the directory containing the sdf file (modelDir)
+        // will be:
+        // $HOME/.ignition/fuel/example.org/test/models/Backpack/2/
+        // and the basename of the directory is "1", which is the model
+        // version.
+        //
+        // However, if symlinks (or other types of indirection) are used,
+        // the pattern of modelDir will be different. The assumption here
+        // is that regardless of the indirection, the name of the
+        // directory containing the sdf file can be used as the version
+        // number
+        //
+        uri.Path() /= common::basename(modelDir);
+      }
+      uriStr = uri.Str();
+    }
+    else
+    {
+      // The model is not in the includeUriMap, but expandIncludeTags =
+      // false, so we will assume that its uri is the file path of the
+      // model on the local machine
+      uriStr = "file://" + modelDir;
+    }
+
+    auto includeElem = _worldElem->AddElement("include");
+    includeElem->GetElement("uri")->Set(uriStr);
+    setNameAndPose(includeElem, _model, true);
+    return includeElem;
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Get the snapshot of a single model.
+  /// \param[in] _ecm Immutable reference to the Entity Component Manager
+  /// \param[in] _entity Model entity
+  /// \param[in] _modelSdf ModelSdf component of the model, if any
+  /// \returns Model snapshot
+  static ModelSnapshot snapshotModel(const EntityComponentManager &_ecm,
+      const Entity &_entity, const components::ModelSdf *_modelSdf)
+  {
+    ModelSnapshot model;
+    if (nullptr != _modelSdf)
+      model.sdf = _modelSdf->Data().Element();
+
+    auto *nameComp = _ecm.Component<components::Name>(_entity);
+    if (nullptr != nameComp)
+      model.name = nameComp->Data();
+
+    auto *poseComp = _ecm.Component<components::Pose>(_entity);
+    if (nullptr != poseComp)
+      model.pose = poseComp->Data();
+
+    const auto *pathComp =
+      _ecm.Component<components::SourceFilePath>(_entity);
+    if (nullptr != pathComp)
+    {
+      model.hasSourceFilePath = true;
+      model.sourceFilePath = pathComp->Data();
+    }
+
+    model.scopedName = scopedName(_entity, _ecm, "::", false);
+    return model;
+  }
+
+  /////////////////////////////////////////////////
+  bool snapshotWorld(const EntityComponentManager &_ecm,
+                     const Entity &_entity, WorldSnapshot &_snapshot)
+  {
+    const auto *worldSdf = _ecm.Component<components::WorldSdf>(_entity);
+    if (nullptr == worldSdf)
+      return false;
+
+    _snapshot.sdf = worldSdf->Data().Element();
+    _snapshot.models.clear();
+
+    _ecm.Each<components::Model, components::ModelSdf>(
+        [&](const Entity &_modelEntity, const components::Model *,
+            const components::ModelSdf *_modelSdf)
+        {
+          // skip nested models as they are not direct children of world
+          auto parentComp = _ecm.Component<components::ParentEntity>(
+              _modelEntity);
+          if (parentComp && parentComp->Data() != _entity)
+            return true;
+
+          _snapshot.models.push_back(
+              snapshotModel(_ecm, _modelEntity, _modelSdf));
+          return true;
+        });
+    return true;
+  }
+
+  /////////////////////////////////////////////////
+  bool generateWorld(std::ostream &_out, const WorldSnapshot &_snapshot,
+      const IncludeUriMap &_includeUriMap,
+      const msgs::SdfGeneratorConfig &_config,
+      const std::function<void(std::size_t, std::size_t)> &_progress)
+  {
+    if (nullptr == _snapshot.sdf)
+      return false;
+
+    // Copy everything but the models, which may be most of the world
     sdf::ElementPtr elem = std::make_shared<sdf::Element>();
     sdf::initFile("root.sdf", elem);
     auto worldElem = elem->AddElement("world");
-    if (!updateWorldElement(worldElem, _ecm, _entity, _includeUriMap, _config))
+    for (std::size_t i = 0; i < _snapshot.sdf->GetAttributeCount(); ++i)
+    {
+      auto attr = _snapshot.sdf->GetAttribute(i);
+      auto newAttr = worldElem->GetAttribute(attr->GetKey());
+      if (nullptr != newAttr && (attr->GetSet() || attr->GetRequired()))
+        newAttr->SetFromString(attr->GetAsString());
+    }
+    for (auto child = _snapshot.sdf->GetFirstElement(); child;
+         child = child->GetNextElement())
+    {
+      if (child->GetName() == "model")
+        continue;
+      auto clone = child->Clone();
+      clone->SetParent(worldElem);
+      worldElem->InsertElement(clone);
+    }
+
+    auto worldDir = common::parentPath(_snapshot.sdf->FilePath());
+
+    // Split the world around its closing tag, and write the models in
+    // between one at a time
+    const std::string worldStr = elem->ToString("");
+    const auto closePos = worldStr.rfind("</world>");
+    if (closePos == std::string::npos)
+    {
+      // The world has no children, so it's written as a single tag
+      for (std::size_t i = 0; i < _snapshot.models.size(); ++i)
+      {
+        addModelElement(worldElem, _snapshot.models[i], worldDir,
+            _includeUriMap, _config);
+        if (_progress)
+          _progress(i + 1, _snapshot.models.size());
+      }
+      _out << elem->ToString("");
+      return true;
+    }
+
+    const auto lineStart = worldStr.rfind('\n', closePos) + 1;
+    _out.write(worldStr.data(), lineStart);
+    for (std::size_t i = 0; i < _snapshot.models.size(); ++i)
+    {
+      auto modelElem = addModelElement(worldElem, _snapshot.models[i],
+          worldDir, _includeUriMap, _config);
+      _out << modelElem->ToString("    ");
+      worldElem->RemoveChild(modelElem);
+      if (_progress)
+        _progress(i + 1, _snapshot.models.size());
+    }
+    _out.write(worldStr.data() + lineStart, worldStr.size() - lineStart);
+    return static_cast<bool>(_out);
+  }
+
+  /////////////////////////////////////////////////
+  std::optional<std::string> generateWorld(
+      const EntityComponentManager &_ecm, const Entity &_entity,
+      const IncludeUriMap &_includeUriMap,
+      const msgs::SdfGeneratorConfig &_config)
+  {
+    WorldSnapshot snapshot;
+    if (!snapshotWorld(_ecm, _entity, snapshot))
+      return std::nullopt;
+
+    std::ostringstream out;
+    if (!generateWorld(out, snapshot, _includeUriMap, _config))
       return std::nullopt;
 
-    return elem->ToString("");
+    return out.str();
   }
 
   /////////////////////////////////////////////////
@@ -265,13 +521,11 @@ namespace sdf_generator
                           const IncludeUriMap &_includeUriMap,
                           const msgs::SdfGeneratorConfig &_config)
   {
-    const auto *worldSdf = _ecm.Component<components::WorldSdf>(_entity);
-
-    if (nullptr == worldSdf)
+    WorldSnapshot snapshot;
+    if (!snapshotWorld(_ecm, _entity, snapshot))
       return false;
 
-    if (!copySdf(_ecm.Component<components::WorldSdf>(_entity), _elem))
-      return false;
+    _elem->Copy(snapshot.sdf);
 
     // First remove child entities of <world> whose names can be changed during
     // simulation (eg. models). Then we add them back from the data in the
@@ -291,91 +545,11 @@ namespace sdf_generator
       _elem->RemoveChild(e);
     }
 
-    auto worldDir = common::parentPath(worldSdf->Data().Element()->FilePath());
-
-    _ecm.Each<components::Model, components::ModelSdf>(
-        [&](const Entity &_modelEntity, const components::Model *,
-            const components::ModelSdf *_modelSdf)
-        {
-          // skip nested models as they are not direct children of world
-          auto parentComp = _ecm.Component<components::ParentEntity>(
-              _modelEntity);
-          if (parentComp && parentComp->Data() != _entity)
-            return true;
-
-          auto modelDir =
-              common::parentPath(_modelSdf->Data().Element()->FilePath());
-          const std::string modelName =
-              scopedName(_modelEntity, _ecm, "::", false);
-
-          bool modelFromInclude = isModelFromInclude(modelDir, worldDir);
-
-          auto uriMapIt = _includeUriMap.find(modelDir);
-
-          auto modelConfig = _config.global_entity_gen_config();
-          auto modelConfigIt =
-              _config.override_entity_gen_configs().find(modelName);
-          if (modelConfigIt != _config.override_entity_gen_configs().end())
-          {
-            mergeWithOverride(modelConfig, modelConfigIt->second);
-          }
-
-          if (modelConfig.expand_include_tags().data() || !modelFromInclude)
-          {
-            auto modelElem = _elem->AddElement("model");
-            updateModelElement(modelElem, _ecm, _modelEntity);
-          }
-          else if (uriMapIt != _includeUriMap.end())
-          {
-            // The fuel URI might have a version number. If it does, we remove
-            // it unless saveFuelModelVersion is set to true.
-            // Check if this is a fuel URI. We assume that it is a fuel URI if
-            // the scheme is http or https.
-            common::URI uri(uriMapIt->second);
-            if (uri.Scheme() == "http" || uri.Scheme() == "https")
-            {
-              removeVersionFromUri(uri);
-            }
-
-            if (modelConfig.save_fuel_version().data())
-            {
-              // Find out the model version from the file path. Note that we
-              // do this from the file path instead of the Fuel URI because the
-              // URI may not contain version information.
-              //
-              // We are assuming here that, for Fuel models, the directory
-              // containing the sdf file has the same name as the model version.
-              // For example, if the uri is
-              // https://example.org/1.0/test/models/Backpack
-              // the path to the directory containing the sdf file (modelDir)
-              // will be:
-              // $HOME/.ignition/fuel/example.org/test/models/Backpack/2/
-              // and the basename of the directory is "1", which is the model
-              // version.
-              //
-              // However, if symlinks (or other types of indirection) are used,
-              // the pattern of modelDir will be different. The assumption here
-              // is that regardless of the indirection, the name of the
-              // directory containing the sdf file can be used as the version
-              // number
-              //
-              uri.Path() /= common::basename(modelDir);
-            }
-
-            auto includeElem = _elem->AddElement("include");
-            updateIncludeElement(includeElem, _ecm, _modelEntity, uri.Str());
-          }
-          else
-          {
-            // The model is not in the includeUriMap, but expandIncludeTags =
-            // false, so we will assume that its uri is the file path of the
-            // model on the local machine
-            auto includeElem = _elem->AddElement("include");
-            const std::string uri = "file://" + modelDir;
-            updateIncludeElement(includeElem, _ecm, _modelEntity, uri);
-          }
-          return true;
-        });
+    auto worldDir = common::parentPath(snapshot.sdf->FilePath());
+    for (const auto &model : snapshot.models)
+    {
+      addModelElement(_elem, model, worldDir, _includeUriMap, _config);
+    }
 
     return true;
   }
@@ -385,41 +559,8 @@ namespace sdf_generator
                           const EntityComponentManager &_ecm,
                           const Entity &_entity)
   {
-    if (!copySdf(_ecm.Component<components::ModelSdf>(_entity), _elem))
-      return false;
-
-    // Update sdf based current components. Here are the list of components to
-    // be updated:
-    // - Name
-    // - Pose
-    // This list is to be updated as other components become updateable during
-    // simulation
-    auto *nameComp = _ecm.Component<components::Name>(_entity);
-    _elem->GetAttribute("name")->Set(nameComp->Data());
-
-    auto *poseComp = _ecm.Component<components::Pose>(_entity);
-
-    auto poseElem = _elem->GetElement("pose");
-
-    // Remove all attributes of poseElem
-    sdf::ParamPtr relativeTo = poseElem->GetAttribute("relative_to");
-    if (nullptr != relativeTo)
-    {
-      relativeTo->Reset();
-    }
-    poseElem->Set(poseComp->Data());
-
-    const auto *pathComp =
-      _ecm.Component<components::SourceFilePath>(_entity);
-
-    if (_elem->HasElement("link") && nullptr != pathComp)
-    {
-      // Update relative URIs to use absolute paths. Relative URIs work fine in
-      // included models, but they have to be converted to absolute URIs when
-      // the included model is expanded.
-      relativeToAbsoluteUri(_elem, common::parentPath(pathComp->Data()));
-    }
-    return true;
+    return updateModelElement(_elem, snapshotModel(_ecm, _entity,
+        _ecm.Component<components::ModelSdf>(_entity)));
   }
 
   /////////////////////////////////////////////////
@@ -428,21 +569,7 @@ namespace sdf_generator
                             const Entity &_entity, const std::string &_uri)
   {
     _elem->GetElement("uri")->Set(_uri);
-
-    auto *nameComp = _ecm.Component<components::Name>(_entity);
-    _elem->GetElement("name")->Set(nameComp->Data());
-
-    auto *poseComp = _ecm.Component<components::Pose>(_entity);
-
-    auto poseElem = _elem->GetElement("pose");
-
-    // Remove all attributes of poseElem
-    sdf::ParamPtr relativeTo = poseElem->GetAttribute("relative_to");
-    if (nullptr != relativeTo)
-    {
-      relativeTo->Reset();
-    }
-    poseElem->Set(poseComp->Data());
+    setNameAndPose(_elem, snapshotModel(_ecm, _entity, nullptr), true);
     return true;
   }
 }
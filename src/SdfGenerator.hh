@@ -20,8 +20,14 @@
 #include <ignition/msgs/sdf_generator_config.pb.h>
 
 #include <sdf/Element.hh>
+#include <functional>
+#include <optional>
+#include <ostream>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
 
 #include "ignition/gazebo/EntityComponentManager.hh"
 
@@ -36,6 +42,68 @@ namespace sdf_generator
 {
   using IncludeUriMap = std::unordered_map<std::string, std::string>;
 
+  /// \brief State of a top level model needed to generate its SDFormat.
+  struct ModelSnapshot
+  {
+    /// \brief Element the model was loaded from. It's shared with the
+    /// ModelSdf component, which never changes it.
+    sdf::ElementPtr sdf;
+
+    /// \brief Current name.
+    std::string name;
+
+    /// \brief Scoped name, used to find configuration overrides.
+    std::string scopedName;
+
+    /// \brief Current pose.
+    math::Pose3d pose;
+
+    /// \brief Whether the model has a source file path.
+    bool hasSourceFilePath{false};
+
+    /// \brief Path of the file the model was loaded from.
+    std::string sourceFilePath;
+  };
+
+  /// \brief State of a world needed to generate its SDFormat. It only holds
+  /// a few values per top level model, so it's cheap to take on the
+  /// simulation thread, and the world can then be generated on another
+  /// thread.
+  struct WorldSnapshot
+  {
+    /// \brief Element the world was loaded from. It's shared with the
+    /// WorldSdf component, which never changes it.
+    sdf::ElementPtr sdf;
+
+    /// \brief Top level models.
+    std::vector<ModelSnapshot> models;
+  };
+
+  /// \brief Take a snapshot of a world, which can be used to generate its
+  /// SDFormat without accessing the Entity Component Manager.
+  /// \input[in] _ecm Immutable reference to the Entity Component Manager
+  /// \input[in] _entity World entity
+  /// \input[out] _snapshot Snapshot of the world
+  /// \returns True if the entity is a world with an SDF element.
+  bool snapshotWorld(const EntityComponentManager &_ecm,
+                     const Entity &_entity, WorldSnapshot &_snapshot);
+
+  /// \brief Write the SDFormat representation of a world to a stream. Models
+  /// are generated and written one at a time, so the whole world is never
+  /// held in memory as a single element tree or string.
+  /// \input[out] _out Stream to write to, such as a file
+  /// \input[in] _snapshot Snapshot of the world
+  /// \input[in] _includeUriMap Map from file paths to URIs used to preserve
+  /// included Fuel models
+  /// \input[in] _config Configuration for the world generator
+  /// \input[in] _progress Called after each model is written, with the
+  /// number of models written so far and the total number of models.
+  /// \returns True if generation succeeded.
+  bool generateWorld(std::ostream &_out, const WorldSnapshot &_snapshot,
+      const IncludeUriMap &_includeUriMap = IncludeUriMap(),
+      const msgs::SdfGeneratorConfig &_config = msgs::SdfGeneratorConfig(),
+      const std::function<void(std::size_t, std::size_t)> &_progress = {});
+
   /// \brief Generate the SDFormat representation of a world
   /// \input[in] _ecm Immutable reference to the Entity Component Manager
   /// \input[in] _entity World entity
@@ -18,6 +18,8 @@
 #include <gtest/gtest.h>
 #include <tinyxml2.h>
 
+#include <sstream>
+
 #include <ignition/common/Console.hh>
 #include <ignition/fuel_tools/ClientConfig.hh>
 #include <ignition/fuel_tools/Interface.hh>
@@ -875,6 +877,34 @@ TEST_F(GenerateWorldFixture, ModelsInline)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(GenerateWorldFixture, StreamFromSnapshot)
+{
+  const std::string worldFile{"test/worlds/save_world.sdf"};
+  this->LoadWorld(worldFile);
+  Entity worldEntity = this->ecm.EntityByComponents(components::World());
+
+  sdf_generator::WorldSnapshot snapshot;
+  ASSERT_TRUE(sdf_generator::snapshotWorld(this->ecm, worldEntity, snapshot));
+  EXPECT_FALSE(snapshot.models.empty());
+
+  this->sdfGenConfig.mutable_global_entity_gen_config()
+      ->mutable_expand_include_tags()
+      ->set_data(true);
+  std::ostringstream out;
+  ASSERT_TRUE(sdf_generator::generateWorld(out, snapshot, this->includeUriMap,
+      this->sdfGenConfig));
+
+  sdf::Root newRoot;
+  newRoot.LoadSdfString(out.str());
+  EXPECT_TRUE(isSubset(newRoot.Element(), this->root.Element()));
+  EXPECT_TRUE(isSubset(this->root.Element(), newRoot.Element()));
+
+  // Not a world
+  EXPECT_FALSE(sdf_generator::snapshotWorld(this->ecm, kNullEntity,
+      snapshot));
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int _argc, char **_argv)
@@ -15,6 +15,10 @@
  *
 */
 
+#include <fstream>
+#include <sstream>
+#include <utility>
+
 #include <ignition/common/SystemPaths.hh>
 #include <ignition/fuel_tools/Interface.hh>
 #include <ignition/fuel_tools/ClientConfig.hh>
@@ -109,6 +113,8 @@ Server::Server(const ServerConfig &_config)
       msg += "File path [" + _config.SdfFile() + "].\n";
     }
     ignmsg <<  msg;
+    this->dataPtr->PrefetchResources(_config.SdfString(),
+        _config.ResourceFetchParallelism());
     errors = this->dataPtr->sdfRoot.LoadSdfString(_config.SdfString());
   }
   else if (!_config.SdfFile().empty())
@@ -160,6 +166,17 @@ Server::Server(const ServerConfig &_config)
 
     ignmsg << "Loading SDF world file[" << filePath << "].\n";
 
+    // Download the included resources concurrently first, so that loading
+    // the world below finds them in the cache.
+    if (_config.ResourceFetchParallelism() > 0u)
+    {
+      std::ifstream sdfStream(filePath);
+      std::stringstream sdfContents;
+      sdfContents << sdfStream.rdbuf();
+      this->dataPtr->PrefetchResources(sdfContents.str(),
+          _config.ResourceFetchParallelism());
+    }
+
     // \todo(nkoenig) Async resource download.
     // This call can block for a long period of time while
     // resources are downloaded. Blocking here causes the GUI to block with
@@ -263,6 +280,89 @@ bool Server::RunOnce(const bool _paused)
   return this->Run(true, 1, _paused);
 }
 
+/////////////////////////////////////////////////
+std::optional<bool> Server::Step(const uint64_t _iterations,
+    const unsigned int _worldIndex)
+{
+  if (_worldIndex >= this->dataPtr->simRunners.size())
+    return std::nullopt;
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->runMutex);
+    if (this->dataPtr->running)
+    {
+      ignwarn << "The server is already running.\n";
+      return false;
+    }
+    this->dataPtr->running = true;
+  }
+
+  auto &runner = *this->dataPtr->simRunners[_worldIndex];
+  auto &ecm = runner.EntityCompMgr();
+  const auto &preStep = this->dataPtr->preStepCallbacks[_worldIndex];
+  const auto &postStep = this->dataPtr->postStepCallbacks[_worldIndex];
+
+  runner.SetPaused(false);
+  runner.StartRun();
+
+  uint64_t iteration{0};
+  for (; iteration < _iterations && runner.Running(); ++iteration)
+  {
+    for (const auto &cb : preStep)
+      cb(runner.CurrentInfo(), ecm);
+
+    // Within the requested steps, messages and statistics are only
+    // processed on the last one, as for Run
+    runner.RunIteration(iteration + 1 < _iterations);
+
+    // The callbacks may modify the ECM, so the step must be complete
+    runner.WaitForPostUpdate();
+
+    for (const auto &cb : postStep)
+      cb(runner.CurrentInfo(), ecm);
+  }
+
+  runner.StopRun();
+  this->dataPtr->running = false;
+  return iteration == _iterations;
+}
+
+/////////////////////////////////////////////////
+std::optional<bool> Server::AddPreStepCallback(StepCallback _cb,
+    const unsigned int _worldIndex)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->runMutex);
+  if (this->dataPtr->running)
+  {
+    ignerr << "Cannot add step callback while the server is running.\n";
+    return false;
+  }
+
+  if (_worldIndex >= this->dataPtr->simRunners.size())
+    return std::nullopt;
+
+  this->dataPtr->preStepCallbacks[_worldIndex].push_back(std::move(_cb));
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::optional<bool> Server::AddPostStepCallback(StepCallback _cb,
+    const unsigned int _worldIndex)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->runMutex);
+  if (this->dataPtr->running)
+  {
+    ignerr << "Cannot add step callback while the server is running.\n";
+    return false;
+  }
+
+  if (_worldIndex >= this->dataPtr->simRunners.size())
+    return std::nullopt;
+
+  this->dataPtr->postStepCallbacks[_worldIndex].push_back(std::move(_cb));
+  return true;
+}
+
 /////////////////////////////////////////////////
 void Server::SetUpdatePeriod(
     const std::chrono::steady_clock::duration &_updatePeriod,
@@ -374,6 +474,42 @@ std::optional<Entity> Server::EntityByName(const std::string &_name,
   return std::nullopt;
 }
 
+//////////////////////////////////////////////////
+std::optional<msgs::SerializedStateMap> Server::Snapshot(
+    const unsigned int _worldIndex) const
+{
+  if (_worldIndex >= this->dataPtr->simRunners.size())
+    return std::nullopt;
+
+  msgs::SerializedStateMap snapshot;
+  this->dataPtr->simRunners[_worldIndex]->Snapshot(snapshot);
+  return snapshot;
+}
+
+//////////////////////////////////////////////////
+std::optional<msgs::Param_V> Server::NetworkStats(
+    const unsigned int _worldIndex) const
+{
+  if (_worldIndex >= this->dataPtr->simRunners.size())
+    return std::nullopt;
+
+  msgs::Param_V stats;
+  if (!this->dataPtr->simRunners[_worldIndex]->NetworkStats(stats))
+    return std::nullopt;
+  return stats;
+}
+
+//////////////////////////////////////////////////
+bool Server::Restore(const msgs::SerializedStateMap &_snapshot,
+    const unsigned int _worldIndex)
+{
+  if (_worldIndex >= this->dataPtr->simRunners.size())
+    return false;
+
+  this->dataPtr->simRunners[_worldIndex]->Restore(_snapshot);
+  return true;
+}
+
 //////////////////////////////////////////////////
 bool Server::RequestRemoveEntity(const std::string &_name,
     bool _recursive, const unsigned int _worldIndex)
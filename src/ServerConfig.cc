@@ -225,17 +225,34 @@ class ignition::gazebo::ServerConfigPrivate
             useLogRecord(_cfg->useLogRecord),
             logRecordPath(_cfg->logRecordPath),
             logIgnoreSdfPath(_cfg->logIgnoreSdfPath),
-            logPlaybackPath(_cfg->logPlaybackPath),
+            logPlaybackPaths(_cfg->logPlaybackPaths),
             logRecordResources(_cfg->logRecordResources),
             logRecordCompressPath(_cfg->logRecordCompressPath),
+            logRecordKeyframeInterval(_cfg->logRecordKeyframeInterval),
             resourceCache(_cfg->resourceCache),
+            resourceFetchParallelism(_cfg->resourceFetchParallelism),
+            worldCachePath(_cfg->worldCachePath),
             physicsEngine(_cfg->physicsEngine),
             renderEngineServer(_cfg->renderEngineServer),
             renderEngineGui(_cfg->renderEngineGui),
             plugins(_cfg->plugins),
             networkRole(_cfg->networkRole),
             networkSecondaries(_cfg->networkSecondaries),
+            networkMaxStepLag(_cfg->networkMaxStepLag),
             seed(_cfg->seed),
+            threadCount(_cfg->threadCount),
+            pipelinedPostUpdate(_cfg->pipelinedPostUpdate),
+            spinWaitTime(_cfg->spinWaitTime),
+            realTimePriority(_cfg->realTimePriority),
+            cpuAffinity(_cfg->cpuAffinity),
+            workerCpuAffinity(_cfg->workerCpuAffinity),
+            lockstepWorlds(_cfg->lockstepWorlds),
+            nameIndex(_cfg->nameIndex),
+            traceEventsPerThread(_cfg->traceEventsPerThread),
+            slowStepThreshold(_cfg->slowStepThreshold),
+            checkpointPath(_cfg->checkpointPath),
+            checkpointPeriod(_cfg->checkpointPeriod),
+            checkpointResume(_cfg->checkpointResume),
             logRecordTopics(_cfg->logRecordTopics) { }
 
   // \brief The SDF file that the server should load
@@ -260,8 +277,9 @@ class ignition::gazebo::ServerConfigPrivate
   /// \brief Whether log record path is specified from command line
   public: bool logIgnoreSdfPath{false};
 
-  /// \brief Path to recorded states to play back using logging system
-  public: std::string logPlaybackPath = "";
+  /// \brief Paths to recorded states to play back using logging system, in
+  /// order
+  public: std::vector<std::string> logPlaybackPaths;
 
   /// \brief Record meshes and material files
   public: bool logRecordResources{false};
@@ -269,10 +287,19 @@ class ignition::gazebo::ServerConfigPrivate
   /// \brief Path to compress log files to
   public: std::string logRecordCompressPath = "";
 
+  /// \brief Sim time between recorded full state keyframes, 0 for none.
+  public: std::chrono::steady_clock::duration logRecordKeyframeInterval{0};
+
   /// \brief Path to where simulation resources, such as models downloaded
   /// from fuel.ignitionrobotics.org, should be stored.
   public: std::string resourceCache = "";
 
+  /// \brief Maximum number of resources downloaded concurrently.
+  public: unsigned int resourceFetchParallelism = 8;
+
+  /// \brief Directory holding snapshots of loaded worlds.
+  public: std::string worldCachePath = "";
+
   /// \brief File containing physics engine plugin. If empty, DART will be used.
   public: std::string physicsEngine = "";
 
@@ -293,9 +320,53 @@ class ignition::gazebo::ServerConfigPrivate
   /// \brief The number of network secondaries.
   public: unsigned int networkSecondaries = 0;
 
+  /// \brief Number of steps the network secondaries may lag behind.
+  public: unsigned int networkMaxStepLag = 0;
+
   /// \brief The given random seed.
   public: unsigned int seed = 0;
 
+  /// \brief Number of threads used for parallel work, or 0 to use one per
+  /// hardware thread.
+  public: unsigned int threadCount = 0;
+
+  /// \brief Whether PostUpdate runs in the background.
+  public: bool pipelinedPostUpdate = false;
+
+  /// \brief Busy-wait duration at the end of real-time sleeps.
+  public: std::chrono::steady_clock::duration spinWaitTime{0};
+
+  /// \brief SCHED_FIFO priority of the simulation thread, 0 for none.
+  public: int realTimePriority = 0;
+
+  /// \brief CPUs the simulation thread is pinned to.
+  public: std::vector<unsigned int> cpuAffinity;
+
+  /// \brief CPUs the worker threads are pinned to.
+  public: std::vector<unsigned int> workerCpuAffinity;
+
+  /// \brief Whether worlds are stepped in lockstep.
+  public: bool lockstepWorlds = false;
+
+  /// \brief Whether entities are indexed by name.
+  public: bool nameIndex = false;
+
+  /// \brief Trace events kept per thread, 0 to disable tracing.
+  public: std::size_t traceEventsPerThread = 0;
+
+  /// \brief Duration above which steps are reported, 0 for none.
+  public: std::chrono::steady_clock::duration slowStepThreshold{0};
+
+  /// \brief Directory holding checkpoints, empty to disable them.
+  public: std::string checkpointPath = "";
+
+  /// \brief Sim time between checkpoints.
+  public: std::chrono::steady_clock::duration checkpointPeriod{
+      std::chrono::seconds(10)};
+
+  /// \brief Whether worlds resume from their checkpoint.
+  public: bool checkpointResume = false;
+
   /// \brief Timestamp that marks when this ServerConfig was created.
   public: std::chrono::time_point<std::chrono::system_clock> timestamp;
 
@@ -397,6 +468,18 @@ unsigned int ServerConfig::NetworkSecondaries() const
   return this->dataPtr->networkSecondaries;
 }
 
+/////////////////////////////////////////////////
+void ServerConfig::SetNetworkMaxStepLag(unsigned int _lag)
+{
+  this->dataPtr->networkMaxStepLag = _lag;
+}
+
+/////////////////////////////////////////////////
+unsigned int ServerConfig::NetworkMaxStepLag() const
+{
+  return this->dataPtr->networkMaxStepLag;
+}
+
 /////////////////////////////////////////////////
 void ServerConfig::SetNetworkRole(const std::string &_role)
 {
@@ -456,13 +539,30 @@ void ServerConfig::SetLogIgnoreSdfPath(bool _ignore)
 /////////////////////////////////////////////////
 const std::string ServerConfig::LogPlaybackPath() const
 {
-  return this->dataPtr->logPlaybackPath;
+  if (this->dataPtr->logPlaybackPaths.empty())
+    return "";
+  return this->dataPtr->logPlaybackPaths.front();
 }
 
 /////////////////////////////////////////////////
 void ServerConfig::SetLogPlaybackPath(const std::string &_playbackPath)
 {
-  this->dataPtr->logPlaybackPath = _playbackPath;
+  this->dataPtr->logPlaybackPaths.clear();
+  if (!_playbackPath.empty())
+    this->dataPtr->logPlaybackPaths.push_back(_playbackPath);
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::AddLogPlaybackPath(const std::string &_playbackPath)
+{
+  if (!_playbackPath.empty())
+    this->dataPtr->logPlaybackPaths.push_back(_playbackPath);
+}
+
+/////////////////////////////////////////////////
+const std::vector<std::string> &ServerConfig::LogPlaybackPaths() const
+{
+  return this->dataPtr->logPlaybackPaths;
 }
 
 /////////////////////////////////////////////////
@@ -489,6 +589,20 @@ void ServerConfig::SetLogRecordCompressPath(const std::string &_path)
   this->dataPtr->logRecordCompressPath = _path;
 }
 
+/////////////////////////////////////////////////
+std::chrono::steady_clock::duration
+    ServerConfig::LogRecordKeyframeInterval() const
+{
+  return this->dataPtr->logRecordKeyframeInterval;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetLogRecordKeyframeInterval(
+    const std::chrono::steady_clock::duration &_interval)
+{
+  this->dataPtr->logRecordKeyframeInterval = _interval;
+}
+
 /////////////////////////////////////////////////
 unsigned int ServerConfig::Seed() const
 {
@@ -502,6 +616,166 @@ void ServerConfig::SetSeed(unsigned int _seed)
   ignition::math::Rand::Seed(_seed);
 }
 
+/////////////////////////////////////////////////
+unsigned int ServerConfig::ThreadCount() const
+{
+  return this->dataPtr->threadCount;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetThreadCount(unsigned int _count)
+{
+  this->dataPtr->threadCount = _count;
+}
+
+/////////////////////////////////////////////////
+bool ServerConfig::PipelinedPostUpdate() const
+{
+  return this->dataPtr->pipelinedPostUpdate;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetPipelinedPostUpdate(bool _pipelined)
+{
+  this->dataPtr->pipelinedPostUpdate = _pipelined;
+}
+
+/////////////////////////////////////////////////
+std::chrono::steady_clock::duration ServerConfig::SpinWaitTime() const
+{
+  return this->dataPtr->spinWaitTime;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetSpinWaitTime(
+    const std::chrono::steady_clock::duration &_duration)
+{
+  this->dataPtr->spinWaitTime = _duration;
+}
+
+/////////////////////////////////////////////////
+int ServerConfig::RealTimePriority() const
+{
+  return this->dataPtr->realTimePriority;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetRealTimePriority(int _priority)
+{
+  this->dataPtr->realTimePriority = _priority;
+}
+
+/////////////////////////////////////////////////
+const std::vector<unsigned int> &ServerConfig::CpuAffinity() const
+{
+  return this->dataPtr->cpuAffinity;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetCpuAffinity(const std::vector<unsigned int> &_cpus)
+{
+  this->dataPtr->cpuAffinity = _cpus;
+}
+
+/////////////////////////////////////////////////
+const std::vector<unsigned int> &ServerConfig::WorkerCpuAffinity() const
+{
+  return this->dataPtr->workerCpuAffinity;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetWorkerCpuAffinity(
+    const std::vector<unsigned int> &_cpus)
+{
+  this->dataPtr->workerCpuAffinity = _cpus;
+}
+
+/////////////////////////////////////////////////
+bool ServerConfig::LockstepWorlds() const
+{
+  return this->dataPtr->lockstepWorlds;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetLockstepWorlds(bool _lockstep)
+{
+  this->dataPtr->lockstepWorlds = _lockstep;
+}
+
+/////////////////////////////////////////////////
+bool ServerConfig::NameIndex() const
+{
+  return this->dataPtr->nameIndex;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetNameIndex(bool _enable)
+{
+  this->dataPtr->nameIndex = _enable;
+}
+
+/////////////////////////////////////////////////
+std::size_t ServerConfig::TraceEventsPerThread() const
+{
+  return this->dataPtr->traceEventsPerThread;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetTraceEventsPerThread(std::size_t _count)
+{
+  this->dataPtr->traceEventsPerThread = _count;
+}
+
+/////////////////////////////////////////////////
+std::chrono::steady_clock::duration ServerConfig::SlowStepThreshold() const
+{
+  return this->dataPtr->slowStepThreshold;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetSlowStepThreshold(
+    const std::chrono::steady_clock::duration &_threshold)
+{
+  this->dataPtr->slowStepThreshold = _threshold;
+}
+
+/////////////////////////////////////////////////
+const std::string &ServerConfig::CheckpointPath() const
+{
+  return this->dataPtr->checkpointPath;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetCheckpointPath(const std::string &_path)
+{
+  this->dataPtr->checkpointPath = _path;
+}
+
+/////////////////////////////////////////////////
+std::chrono::steady_clock::duration ServerConfig::CheckpointPeriod() const
+{
+  return this->dataPtr->checkpointPeriod;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetCheckpointPeriod(
+    const std::chrono::steady_clock::duration &_period)
+{
+  this->dataPtr->checkpointPeriod = _period;
+}
+
+/////////////////////////////////////////////////
+bool ServerConfig::CheckpointResume() const
+{
+  return this->dataPtr->checkpointResume;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetCheckpointResume(bool _resume)
+{
+  this->dataPtr->checkpointResume = _resume;
+}
+
 /////////////////////////////////////////////////
 const std::string &ServerConfig::ResourceCache() const
 {
@@ -514,6 +788,30 @@ void ServerConfig::SetResourceCache(const std::string &_path)
   this->dataPtr->resourceCache = _path;
 }
 
+/////////////////////////////////////////////////
+unsigned int ServerConfig::ResourceFetchParallelism() const
+{
+  return this->dataPtr->resourceFetchParallelism;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetResourceFetchParallelism(unsigned int _parallelism)
+{
+  this->dataPtr->resourceFetchParallelism = _parallelism;
+}
+
+/////////////////////////////////////////////////
+const std::string &ServerConfig::WorldCachePath() const
+{
+  return this->dataPtr->worldCachePath;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetWorldCachePath(const std::string &_path)
+{
+  this->dataPtr->worldCachePath = _path;
+}
+
 /////////////////////////////////////////////////
 const std::string &ServerConfig::PhysicsEngine() const
 {
@@ -569,14 +867,15 @@ ServerConfig::LogPlaybackPlugin() const
   playbackElem = std::make_shared<sdf::Element>();
   playbackElem->SetName("plugin");
 
-  if (!this->LogPlaybackPath().empty())
+  // One element per log, played in order
+  for (const std::string &path : this->LogPlaybackPaths())
   {
     sdf::ElementPtr pathElem = std::make_shared<sdf::Element>();
     pathElem->SetName("playback_path");
     playbackElem->AddElementDescription(pathElem);
-    pathElem = playbackElem->GetElement("playback_path");
+    pathElem = playbackElem->AddElement("playback_path");
     pathElem->AddValue("string", "", false, "");
-    pathElem->Set<std::string>(this->LogPlaybackPath());
+    pathElem->Set<std::string>(path);
   }
 
   return ServerConfig::PluginInfo(entityName,
@@ -639,6 +938,18 @@ ServerConfig::LogRecordPlugin() const
     cPathElem->Set<std::string>(this->LogRecordCompressPath());
   }
 
+  if (this->LogRecordKeyframeInterval() >
+      std::chrono::steady_clock::duration::zero())
+  {
+    sdf::ElementPtr keyframeElem = std::make_shared<sdf::Element>();
+    keyframeElem->SetName("keyframe_interval");
+    recordElem->AddElementDescription(keyframeElem);
+    keyframeElem = recordElem->GetElement("keyframe_interval");
+    keyframeElem->AddValue("double", "0", false, "");
+    keyframeElem->Set<double>(std::chrono::duration<double>(
+        this->LogRecordKeyframeInterval()).count());
+  }
+
   // If record topics specified, add in SDF
   for (const std::string &topic : this->LogRecordTopics())
   {
@@ -226,5 +226,192 @@ TEST(ServerConfig, GenerateRecordPlugin)
   EXPECT_EQ(plugin.EntityName(), "*");
   EXPECT_EQ(plugin.EntityType(), "world");
   EXPECT_EQ(plugin.Name(), "ignition::gazebo::systems::LogRecord");
+  EXPECT_FALSE(plugin.Sdf()->HasElement("keyframe_interval"));
+
+  config.SetLogRecordKeyframeInterval(std::chrono::milliseconds(1500));
+  ServerConfig copy(config);
+  EXPECT_EQ(std::chrono::milliseconds(1500),
+      copy.LogRecordKeyframeInterval());
+
+  plugin = copy.LogRecordPlugin();
+  ASSERT_TRUE(plugin.Sdf()->HasElement("keyframe_interval"));
+  EXPECT_DOUBLE_EQ(1.5, plugin.Sdf()->Get<double>("keyframe_interval"));
+}
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, GeneratePlaybackPlugin)
+{
+  ServerConfig config;
+  EXPECT_TRUE(config.LogPlaybackPath().empty());
+  EXPECT_TRUE(config.LogPlaybackPaths().empty());
+
+  config.AddLogPlaybackPath("foo/first");
+  config.AddLogPlaybackPath("foo/second");
+  EXPECT_EQ("foo/first", config.LogPlaybackPath());
+
+  ServerConfig copy(config);
+  ASSERT_EQ(2u, copy.LogPlaybackPaths().size());
+  EXPECT_EQ("foo/second", copy.LogPlaybackPaths()[1]);
+
+  auto plugin = copy.LogPlaybackPlugin();
+  EXPECT_EQ(plugin.Name(), "ignition::gazebo::systems::LogPlayback");
+  auto pathElem = plugin.Sdf()->GetElement("playback_path");
+  ASSERT_NE(nullptr, pathElem);
+  EXPECT_EQ("foo/first", pathElem->Get<std::string>());
+  pathElem = pathElem->GetNextElement("playback_path");
+  ASSERT_NE(nullptr, pathElem);
+  EXPECT_EQ("foo/second", pathElem->Get<std::string>());
+  EXPECT_EQ(nullptr, pathElem->GetNextElement("playback_path"));
+
+  // Setting a path replaces the queue
+  config.SetLogPlaybackPath("foo/only");
+  ASSERT_EQ(1u, config.LogPlaybackPaths().size());
+  EXPECT_EQ("foo/only", config.LogPlaybackPath());
 }
 
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, ThreadCount)
+{
+  ServerConfig config;
+  EXPECT_EQ(0u, config.ThreadCount());
+
+  config.SetThreadCount(3u);
+  EXPECT_EQ(3u, config.ThreadCount());
+
+  ServerConfig copy(config);
+  EXPECT_EQ(3u, copy.ThreadCount());
+}
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, PipelinedPostUpdate)
+{
+  ServerConfig config;
+  EXPECT_FALSE(config.PipelinedPostUpdate());
+
+  config.SetPipelinedPostUpdate(true);
+  EXPECT_TRUE(config.PipelinedPostUpdate());
+
+  ServerConfig copy(config);
+  EXPECT_TRUE(copy.PipelinedPostUpdate());
+}
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, RealTimePacing)
+{
+  ServerConfig config;
+  EXPECT_EQ(std::chrono::steady_clock::duration::zero(),
+      config.SpinWaitTime());
+  EXPECT_EQ(0, config.RealTimePriority());
+  EXPECT_TRUE(config.CpuAffinity().empty());
+  EXPECT_TRUE(config.WorkerCpuAffinity().empty());
+
+  config.SetSpinWaitTime(std::chrono::microseconds(200));
+  config.SetRealTimePriority(80);
+  config.SetCpuAffinity({2u, 3u});
+  config.SetWorkerCpuAffinity({4u, 5u, 6u});
+
+  ServerConfig copy(config);
+  EXPECT_EQ(std::chrono::microseconds(200), copy.SpinWaitTime());
+  EXPECT_EQ(80, copy.RealTimePriority());
+  EXPECT_EQ(std::vector<unsigned int>({2u, 3u}), copy.CpuAffinity());
+  EXPECT_EQ(std::vector<unsigned int>({4u, 5u, 6u}),
+      copy.WorkerCpuAffinity());
+}
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, LockstepWorlds)
+{
+  ServerConfig config;
+  EXPECT_FALSE(config.LockstepWorlds());
+
+  config.SetLockstepWorlds(true);
+  EXPECT_TRUE(config.LockstepWorlds());
+
+  ServerConfig copy(config);
+  EXPECT_TRUE(copy.LockstepWorlds());
+}
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, NameIndex)
+{
+  ServerConfig config;
+  EXPECT_FALSE(config.NameIndex());
+
+  config.SetNameIndex(true);
+  EXPECT_TRUE(config.NameIndex());
+
+  ServerConfig copy(config);
+  EXPECT_TRUE(copy.NameIndex());
+}
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, TraceEventsPerThread)
+{
+  ServerConfig config;
+  EXPECT_EQ(0u, config.TraceEventsPerThread());
+
+  config.SetTraceEventsPerThread(1000u);
+  EXPECT_EQ(1000u, config.TraceEventsPerThread());
+
+  ServerConfig copy(config);
+  EXPECT_EQ(1000u, copy.TraceEventsPerThread());
+}
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, SlowStepThreshold)
+{
+  ServerConfig config;
+  EXPECT_EQ(std::chrono::steady_clock::duration::zero(),
+      config.SlowStepThreshold());
+
+  config.SetSlowStepThreshold(std::chrono::milliseconds(100));
+  EXPECT_EQ(std::chrono::milliseconds(100), config.SlowStepThreshold());
+
+  ServerConfig copy(config);
+  EXPECT_EQ(std::chrono::milliseconds(100), copy.SlowStepThreshold());
+}
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, Checkpoint)
+{
+  ServerConfig config;
+  EXPECT_TRUE(config.CheckpointPath().empty());
+  EXPECT_EQ(std::chrono::seconds(10), config.CheckpointPeriod());
+  EXPECT_FALSE(config.CheckpointResume());
+
+  config.SetCheckpointPath("/tmp/checkpoints");
+  config.SetCheckpointPeriod(std::chrono::seconds(1));
+  config.SetCheckpointResume(true);
+
+  ServerConfig copy(config);
+  EXPECT_EQ("/tmp/checkpoints", copy.CheckpointPath());
+  EXPECT_EQ(std::chrono::seconds(1), copy.CheckpointPeriod());
+  EXPECT_TRUE(copy.CheckpointResume());
+}
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, ResourceFetchParallelism)
+{
+  ServerConfig config;
+  EXPECT_EQ(8u, config.ResourceFetchParallelism());
+
+  config.SetResourceFetchParallelism(0u);
+  EXPECT_EQ(0u, config.ResourceFetchParallelism());
+
+  ServerConfig copy(config);
+  EXPECT_EQ(0u, copy.ResourceFetchParallelism());
+}
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, WorldCachePath)
+{
+  ServerConfig config;
+  EXPECT_TRUE(config.WorldCachePath().empty());
+
+  config.SetWorldCachePath("/tmp/world_cache");
+  EXPECT_EQ("/tmp/world_cache", config.WorldCachePath());
+
+  ServerConfig copy(config);
+  EXPECT_EQ("/tmp/world_cache", copy.WorldCachePath());
+}
@@ -18,10 +18,17 @@
 
 #include <tinyxml2.h>
 
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
 #include <sdf/Root.hh>
 #include <sdf/World.hh>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
 #include <ignition/common/Util.hh>
 
 #include <ignition/fuel_tools/Interface.hh>
@@ -30,6 +37,7 @@
 
 #include "ignition/gazebo/Util.hh"
 #include "SimulationRunner.hh"
+#include "TaskPool.hh"
 
 using namespace ignition;
 using namespace gazebo;
@@ -160,7 +168,12 @@ bool ServerPrivate::Run(const uint64_t _iterations,
 
   // Minor performance tweak. In many situations there will only be one
   // simulation runner, and we can avoid using the thread pool.
-  if (this->simRunners.size() == 1)
+  if (this->simRunners.size() > 1 && this->config.LockstepWorlds() &&
+      !this->config.UseDistributedSimulation())
+  {
+    result = this->RunLockstep(_iterations);
+  }
+  else if (this->simRunners.size() == 1)
   {
     result = this->simRunners[0]->Run(_iterations);
   }
@@ -182,6 +195,54 @@ bool ServerPrivate::Run(const uint64_t _iterations,
   return result;
 }
 
+/////////////////////////////////////////////////
+bool ServerPrivate::RunLockstep(const uint64_t _iterations)
+{
+  IGN_PROFILE_THREAD_NAME("ServerLockstep");
+
+  for (auto &runner : this->simRunners)
+    runner->StartRun();
+
+  // Iterations processed by each runner
+  std::vector<uint64_t> processed(this->simRunners.size(), 0);
+  std::vector<std::size_t> active;
+  while (this->running)
+  {
+    // Runners which were stopped, or are done, aren't stepped anymore
+    active.clear();
+    for (std::size_t i = 0; i < this->simRunners.size(); ++i)
+    {
+      if (this->simRunners[i]->Running() &&
+          (_iterations == 0 || processed[i] < _iterations))
+      {
+        active.push_back(i);
+      }
+    }
+    if (active.empty())
+      break;
+
+    IGN_PROFILE("ServerPrivate::RunLockstep - Iteration");
+
+    // Wait until the steps of all runners are due
+    for (auto i : active)
+      this->simRunners[i]->Pace();
+
+    // Each runner is a task, and its systems submit their own parallel work
+    // to the same pool.
+    this->taskPool->ParallelFor(active.size(), 1,
+        [&](std::size_t _begin, std::size_t _end)
+        {
+          for (std::size_t i = _begin; i < _end; ++i)
+            processed[active[i]] += this->simRunners[active[i]]->RunIteration();
+        });
+  }
+
+  for (auto &runner : this->simRunners)
+    runner->StopRun();
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 sdf::ElementPtr GetRecordPluginElem(sdf::Root &_sdfRoot)
 {
@@ -241,6 +302,15 @@ void ServerPrivate::AddRecordPlugin(const ServerConfig &_config)
     std::tie(sdfCompress, hasCompress) =
       recordPluginElem->Get<bool>("compress", false);
 
+    if (recordPluginElem->HasElement("keyframe_interval"))
+    {
+      auto keyframeInterval =
+          recordPluginElem->Get<double>("keyframe_interval");
+      this->config.SetLogRecordKeyframeInterval(
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(keyframeInterval)));
+    }
+
     hasRecordTopics = recordPluginElem->HasElement("record_topic");
     if (hasRecordTopics)
     {
@@ -281,6 +351,13 @@ void ServerPrivate::AddRecordPlugin(const ServerConfig &_config)
   if (_config.LogRecordResources())
     this->config.SetLogRecordResources(true);
 
+  if (_config.LogRecordKeyframeInterval() >
+      std::chrono::steady_clock::duration::zero())
+  {
+    this->config.SetLogRecordKeyframeInterval(
+        _config.LogRecordKeyframeInterval());
+  }
+
   if (_config.LogRecordCompressPath() != ".zip")
   {
     this->config.SetLogRecordCompressPath(_config.LogRecordCompressPath());
@@ -299,6 +376,9 @@ void ServerPrivate::AddRecordPlugin(const ServerConfig &_config)
 //////////////////////////////////////////////////
 void ServerPrivate::CreateEntities()
 {
+  if (!this->taskPool)
+    this->taskPool = SimulationRunner::CreateTaskPool(this->config);
+
   // Create a simulation runner for each world.
   for (uint64_t worldIndex = 0; worldIndex <
        this->sdfRoot.WorldCount(); ++worldIndex)
@@ -310,7 +390,7 @@ void ServerPrivate::CreateEntities()
       this->worldNames.push_back(world->Name());
     }
     auto runner = std::make_unique<SimulationRunner>(
-        world, this->systemLoader, this->config);
+        world, this->systemLoader, this->config, this->taskPool.get());
     runner->SetFuelUriMap(this->fuelUriMap);
     this->simRunners.push_back(std::move(runner));
   }
@@ -453,3 +533,67 @@ std::string ServerPrivate::FetchResourceUri(const common::URI &_uri)
 {
   return this->FetchResource(_uri.Str());
 }
+
+//////////////////////////////////////////////////
+void ServerPrivate::PrefetchResources(const std::string &_sdf,
+    unsigned int _parallelism)
+{
+  if (0u == _parallelism || nullptr == this->fuelClient)
+    return;
+
+  // Parsing errors are reported when the document is actually loaded
+  tinyxml2::XMLDocument doc;
+  if (doc.Parse(_sdf.c_str()) != tinyxml2::XML_SUCCESS)
+    return;
+
+  // Collect the remote URIs of all includes, without duplicates
+  std::set<std::string> uris;
+  std::function<void(const tinyxml2::XMLElement *)> collect =
+      [&](const tinyxml2::XMLElement *_elem)
+  {
+    for (auto *child = _elem->FirstChildElement(); child != nullptr;
+        child = child->NextSiblingElement())
+    {
+      if (std::string(child->Name()) == "include")
+      {
+        auto *uriElem = child->FirstChildElement("uri");
+        if (nullptr != uriElem && nullptr != uriElem->GetText())
+        {
+          auto uri = common::trimmed(uriElem->GetText());
+          auto scheme = common::URI(uri).Scheme();
+          if (scheme == "http" || scheme == "https")
+            uris.insert(uri);
+        }
+      }
+      collect(child);
+    }
+  };
+  collect(doc.RootElement());
+
+  if (uris.empty())
+    return;
+
+  const std::vector<std::string> pending(uris.begin(), uris.end());
+  igndbg << "Prefetching [" << pending.size() << "] resources.\n";
+
+  // Downloads mostly wait on the network, so use a dedicated pool of the
+  // requested size instead of the compute pool. The calling thread also
+  // takes part in the work.
+  const auto threads = std::min<std::size_t>(_parallelism, pending.size());
+  TaskPool pool(static_cast<unsigned int>(threads) - 1u);
+  pool.ParallelFor(pending.size(), 1,
+      [&](std::size_t _begin, std::size_t _end)
+      {
+        // FuelClient isn't thread-safe, so each download uses its own client
+        // with the same configuration
+        fuel_tools::FuelClient client(this->fuelClient->Config());
+        for (auto i = _begin; i < _end; ++i)
+        {
+          if (fuel_tools::fetchResourceWithClient(pending[i], client).empty())
+          {
+            ignwarn << "Failed to prefetch [" << pending[i] << "]. It will "
+                    << "be fetched again while loading.\n";
+          }
+        }
+      });
+}
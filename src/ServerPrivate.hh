@@ -41,6 +41,7 @@
 
 #include "ignition/gazebo/config.hh"
 #include "ignition/gazebo/Export.hh"
+#include "ignition/gazebo/Server.hh"
 #include "ignition/gazebo/ServerConfig.hh"
 #include "ignition/gazebo/SystemLoader.hh"
 
@@ -53,6 +54,7 @@ namespace ignition
     // Inline bracket to help doxygen filtering.
     inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     class SimulationRunner;
+    class TaskPool;
 
     // Private data for Server
     class IGNITION_GAZEBO_HIDDEN ServerPrivate
@@ -70,6 +72,13 @@ namespace ignition
       public: bool Run(const uint64_t _iterations,
                  std::optional<std::condition_variable *> _cond = std::nullopt);
 
+      /// \brief Step all simulation runners in lockstep from the calling
+      /// thread, see ServerConfig::SetLockstepWorlds.
+      /// \param[in] _iterations Number of iterations of each runner, 0 to
+      /// run until stopped.
+      /// \return True if the operation completed successfully.
+      private: bool RunLockstep(const uint64_t _iterations);
+
       /// \brief Add logging record plugin.
       /// \param[in] _config Server configuration parameters.
       public: void AddRecordPlugin(const ServerConfig &_config);
@@ -95,6 +104,17 @@ namespace ignition
       /// \return Path to the downloaded resource, empty on error.
       public: std::string FetchResourceUri(const common::URI &_uri);
 
+      /// \brief Download all the resources included by an SDF document into
+      /// the resource cache, several at a time, so that loading the document
+      /// afterwards finds them cached instead of downloading them one by
+      /// one. Nested includes of downloaded models are left to be fetched
+      /// while loading.
+      /// \param[in] _sdf SDF document as a string.
+      /// \param[in] _parallelism Maximum number of concurrent downloads. 0
+      /// disables the prefetch.
+      public: void PrefetchResources(const std::string &_sdf,
+                                     unsigned int _parallelism);
+
       /// \brief Signal handler callback
       /// \param[in] _sig The signal number
       private: void OnSignal(int _sig);
@@ -117,6 +137,11 @@ namespace ignition
       /// \brief A pool of worker threads.
       public: common::WorkerPool workerPool{2};
 
+      /// \brief Pool of worker threads shared by all simulation runners, so
+      /// that the number of threads doesn't grow with the number of worlds.
+      /// Created with the runners, which it must outlive.
+      public: std::unique_ptr<TaskPool> taskPool;
+
       /// \brief All the simulation runners.
       public: std::vector<std::unique_ptr<SimulationRunner>> simRunners;
 
@@ -130,6 +155,16 @@ namespace ignition
       /// \brief Thread that executes systems.
       public: std::thread runThread;
 
+      /// \brief Callbacks called before each step of Server::Step, keyed by
+      /// world index.
+      public: std::unordered_map<unsigned int,
+                  std::vector<Server::StepCallback>> preStepCallbacks;
+
+      /// \brief Callbacks called after each step of Server::Step, keyed by
+      /// world index.
+      public: std::unordered_map<unsigned int,
+                  std::vector<Server::StepCallback>> postStepCallbacks;
+
       /// \brief Our signal handler.
       public: ignition::common::SignalHandler sigHandler;
 
@@ -16,8 +16,12 @@
 */
 
 #include <gtest/gtest.h>
+#include <cmath>
 #include <csignal>
+#include <string>
+#include <thread>
 #include <vector>
+#include <ignition/common/Filesystem.hh>
 #include <ignition/common/StringUtils.hh>
 #include <ignition/common/Util.hh>
 #include <ignition/math/Rand.hh>
@@ -26,7 +30,11 @@
 
 #include "ignition/gazebo/components/AxisAlignedBox.hh"
 #include "ignition/gazebo/components/Geometry.hh"
+#include "ignition/gazebo/components/Joint.hh"
+#include "ignition/gazebo/components/JointPosition.hh"
+#include "ignition/gazebo/components/JointVelocity.hh"
 #include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/Entity.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/System.hh"
@@ -522,6 +530,74 @@ TEST_P(ServerFixture, RunOnceUnpaused)
   EXPECT_EQ(100u, mockSystem->postUpdateCallCount);
 }
 
+/////////////////////////////////////////////////
+TEST_P(ServerFixture, StepCallbacks)
+{
+  gazebo::Server server;
+  EXPECT_EQ(0u, *server.IterationCount());
+
+  // Load a system
+  gazebo::SystemLoader systemLoader;
+  auto mockSystemPlugin = systemLoader.LoadPlugin(
+      "libMockSystem.so", "ignition::gazebo::MockSystem", nullptr);
+  ASSERT_TRUE(mockSystemPlugin.has_value());
+  EXPECT_TRUE(*server.AddSystem(mockSystemPlugin.value()));
+  auto mockSystem = dynamic_cast<gazebo::MockSystem *>(
+      mockSystemPlugin.value()->QueryInterface<gazebo::System>());
+  ASSERT_NE(nullptr, mockSystem);
+
+  // Invalid world
+  EXPECT_FALSE(server.Step(1, 1).has_value());
+  EXPECT_FALSE(server.AddPreStepCallback(nullptr, 1).has_value());
+  EXPECT_FALSE(server.AddPostStepCallback(nullptr, 1).has_value());
+
+  // Callbacks run around each step, on this thread
+  const auto threadId = std::this_thread::get_id();
+  std::vector<std::string> calls;
+  gazebo::Entity created{gazebo::kNullEntity};
+  EXPECT_TRUE(*server.AddPreStepCallback(
+      [&](const gazebo::UpdateInfo &_info,
+          gazebo::EntityComponentManager &_ecm)
+      {
+        EXPECT_EQ(threadId, std::this_thread::get_id());
+        calls.push_back("pre " + std::to_string(_info.iterations));
+
+        // The ECM can be modified directly
+        if (gazebo::kNullEntity == created)
+          created = _ecm.CreateEntity();
+      }));
+  EXPECT_TRUE(*server.AddPostStepCallback(
+      [&](const gazebo::UpdateInfo &_info,
+          gazebo::EntityComponentManager &_ecm)
+      {
+        EXPECT_EQ(threadId, std::this_thread::get_id());
+        EXPECT_FALSE(_info.paused);
+        EXPECT_TRUE(_ecm.HasEntity(created));
+        calls.push_back("post " + std::to_string(_info.iterations));
+      }));
+  mockSystem->preUpdateCallback =
+      [&](const gazebo::UpdateInfo &_info, gazebo::EntityComponentManager &)
+      {
+        calls.push_back("system " + std::to_string(_info.iterations));
+      };
+
+  EXPECT_TRUE(*server.Step(2));
+  EXPECT_EQ(2u, *server.IterationCount());
+  EXPECT_FALSE(server.Running());
+  EXPECT_EQ(2u, mockSystem->postUpdateCallCount);
+
+  const std::vector<std::string> expected{"pre 0", "system 1", "post 1",
+      "pre 1", "system 2", "post 2"};
+  EXPECT_EQ(expected, calls);
+
+  // Steps continue from where they left off
+  calls.clear();
+  EXPECT_TRUE(*server.Step());
+  EXPECT_EQ(3u, *server.IterationCount());
+  ASSERT_EQ(3u, calls.size());
+  EXPECT_EQ("post 3", calls.back());
+}
+
 /////////////////////////////////////////////////
 TEST_P(ServerFixture, RunOncePaused)
 {
@@ -591,6 +667,181 @@ TEST_P(ServerFixture, RunNonBlockingMultiple)
   EXPECT_FALSE(*server.Running(0));
 }
 
+/////////////////////////////////////////////////
+TEST_P(ServerFixture, RunLockstepWorlds)
+{
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfFile(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "multiple_worlds.sdf"));
+  serverConfig.SetLockstepWorlds(true);
+  gazebo::Server server(serverConfig);
+
+  // Make the worlds run fast
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    server.SetUpdatePeriod(1ns, i);
+    EXPECT_EQ(0u, *server.IterationCount(i));
+  }
+
+  // All worlds advance together
+  EXPECT_TRUE(server.Run(true, 10, false));
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    EXPECT_EQ(10u, *server.IterationCount(i));
+    EXPECT_FALSE(*server.Running(i));
+  }
+
+  EXPECT_TRUE(server.RunOnce(false));
+  for (unsigned int i = 0; i < 3; ++i)
+    EXPECT_EQ(11u, *server.IterationCount(i));
+
+  EXPECT_FALSE(server.Running());
+}
+
+/////////////////////////////////////////////////
+TEST_P(ServerFixture, WorldCache)
+{
+  const auto cachePath =
+      common::joinPaths(PROJECT_BINARY_PATH, "test", "world_cache");
+  common::removeAll(cachePath);
+
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "shapes.sdf"));
+  serverConfig.SetWorldCachePath(cachePath);
+
+  // The first load stores the world in the cache
+  {
+    gazebo::Server server(serverConfig);
+    EXPECT_EQ(16u, *server.EntityCount());
+  }
+  EXPECT_TRUE(common::exists(common::joinPaths(cachePath, "default.state")));
+
+  // The second load restores it
+  gazebo::Server server(serverConfig);
+  EXPECT_EQ(16u, *server.EntityCount());
+  EXPECT_EQ(3u, *server.SystemCount());
+  EXPECT_TRUE(server.HasEntity("box"));
+  EXPECT_TRUE(server.HasEntity("sphere"));
+  EXPECT_TRUE(server.HasEntity("cylinder"));
+
+  EXPECT_TRUE(server.Run(true, 10, false));
+  EXPECT_EQ(10u, *server.IterationCount());
+
+  common::removeAll(cachePath);
+}
+
+/////////////////////////////////////////////////
+TEST_P(ServerFixture, LevelChunks)
+{
+  const auto cachePath =
+      common::joinPaths(PROJECT_BINARY_PATH, "test", "level_chunks");
+  common::removeAll(cachePath);
+
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "levels.sdf"));
+  serverConfig.SetUseLevels(true);
+  serverConfig.SetWorldCachePath(cachePath);
+
+  // The first load stores each loaded model in its own chunk
+  std::size_t entityCount{0};
+  {
+    gazebo::Server server(serverConfig);
+    entityCount = *server.EntityCount();
+  }
+  const auto chunkPath = common::joinPaths(cachePath, "levels_levels");
+  EXPECT_FALSE(common::exists(common::joinPaths(cachePath, "levels.state")));
+  EXPECT_TRUE(common::exists(common::joinPaths(chunkPath, "tile_0.state")));
+  // Performers are created before levels, and aren't stored
+  EXPECT_FALSE(common::exists(common::joinPaths(chunkPath, "sphere.state")));
+
+  // The second load restores the level models from their chunks
+  gazebo::Server server(serverConfig);
+  EXPECT_EQ(entityCount, *server.EntityCount());
+  EXPECT_TRUE(server.HasEntity("tile_0"));
+  EXPECT_TRUE(server.HasEntity("sphere"));
+  EXPECT_TRUE(server.HasEntity("box"));
+
+  EXPECT_TRUE(server.Run(true, 10, false));
+  EXPECT_EQ(10u, *server.IterationCount());
+
+  common::removeAll(cachePath);
+}
+
+/////////////////////////////////////////////////
+TEST_P(ServerFixture, SnapshotRestore)
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "revolute_joint.sdf"));
+
+  gazebo::Server server(serverConfig);
+  server.SetUpdatePeriod(1ns);
+
+  EXPECT_EQ(std::nullopt, server.Snapshot(1));
+  EXPECT_FALSE(server.Restore(msgs::SerializedStateMap(), 1));
+
+  // Record the pendulum's trajectory, and create an entity midway
+  std::vector<double> positions;
+  test::Relay testSystem;
+  testSystem.OnPreUpdate(
+    [](const gazebo::UpdateInfo &_info, gazebo::EntityComponentManager &_ecm)
+    {
+      _ecm.Each<components::Joint>(
+          [&](const Entity &_entity, const components::Joint *) -> bool
+          {
+            if (!_ecm.Component<components::JointPosition>(_entity))
+            {
+              _ecm.CreateComponent(_entity, components::JointPosition());
+              _ecm.CreateComponent(_entity, components::JointVelocity());
+            }
+            return true;
+          });
+
+      if (_info.iterations == 30)
+      {
+        auto entity = _ecm.CreateEntity();
+        _ecm.CreateComponent(entity, components::Name("extra"));
+      }
+    });
+  testSystem.OnPostUpdate(
+    [&positions](const gazebo::UpdateInfo &,
+        const gazebo::EntityComponentManager &_ecm)
+    {
+      auto joint = _ecm.EntityByComponents(components::Joint(),
+          components::Name("j2"));
+      auto pos = _ecm.ComponentData<components::JointPosition>(joint);
+      ASSERT_TRUE(pos.has_value());
+      ASSERT_FALSE(pos->empty());
+      positions.push_back(pos->front());
+    });
+  server.AddSystem(testSystem.systemPtr);
+
+  server.Run(true, 10, false);
+  auto snapshot = server.Snapshot();
+  ASSERT_TRUE(snapshot.has_value());
+
+  server.Run(true, 50, false);
+  EXPECT_EQ(60u, *server.IterationCount());
+  EXPECT_TRUE(server.HasEntity("extra"));
+  ASSERT_EQ(60u, positions.size());
+  EXPECT_GT(std::abs(positions[59] - positions[9]), 1e-3);
+
+  // Restoring rewinds the iterations and removes entities created since
+  EXPECT_TRUE(server.Restore(*snapshot));
+  server.Run(true, 1, false);
+  EXPECT_EQ(11u, *server.IterationCount());
+  EXPECT_FALSE(server.HasEntity("extra"));
+
+  // The trajectory is replayed
+  server.Run(true, 49, false);
+  EXPECT_EQ(60u, *server.IterationCount());
+  ASSERT_EQ(110u, positions.size());
+  for (std::size_t i = 0; i < 50; ++i)
+    EXPECT_NEAR(positions[10 + i], positions[60 + i], 1e-4) << i;
+}
+
 /////////////////////////////////////////////////
 TEST_P(ServerFixture, SigInt)
 {
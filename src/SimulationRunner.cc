@@ -17,14 +17,39 @@
 
 #include "SimulationRunner.hh"
 
+#include <ignition/msgs/param_v.pb.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <algorithm>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <sdf/Root.hh>
 
+#include "ignition/common/Filesystem.hh"
 #include "ignition/common/Profiler.hh"
+#include "ignition/common/Util.hh"
+#include "ignition/gazebo/components/Joint.hh"
+#include "ignition/gazebo/components/JointPosition.hh"
+#include "ignition/gazebo/components/JointPositionReset.hh"
+#include "ignition/gazebo/components/JointVelocity.hh"
+#include "ignition/gazebo/components/JointVelocityReset.hh"
 #include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/PoseCmd.hh"
 #include "ignition/gazebo/components/Sensor.hh"
+#include "ignition/gazebo/components/Static.hh"
 #include "ignition/gazebo/components/Visual.hh"
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/components/Physics.hh"
@@ -35,21 +60,105 @@
 
 #include "network/NetworkManagerPrimary.hh"
 #include "SdfGenerator.hh"
+#include "Tracer.hh"
 
 using namespace ignition;
 using namespace gazebo;
 
 using StringSet = std::unordered_set<std::string>;
 
+namespace
+{
+/// \brief Wall-clock period of the statistics and clock messages when
+/// simulation runs as fast as possible.
+constexpr std::chrono::milliseconds kFreeRunPublishPeriod{1000 / 60};
+
+/// \brief Longest time the PostUpdate hand-over barriers spin before
+/// parking.
+constexpr std::chrono::microseconds kMaxBarrierSpin{100};
+
+/// \brief Longest update period for which the PostUpdate hand-over
+/// barriers spin, i.e. steps faster than 1 kHz.
+constexpr std::chrono::milliseconds kBarrierSpinMaxPeriod{1};
+
+/////////////////////////////////////////////////
+/// \brief Pin the calling thread to a set of CPUs.
+/// \param[in] _cpus Indices of the CPUs, empty to leave the thread as is.
+/// \param[in] _thread Name of the thread, for error messages.
+void pinCurrentThread(const std::vector<unsigned int> &_cpus,
+    const std::string &_thread)
+{
+  if (_cpus.empty())
+    return;
+
+#ifdef __linux__
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (auto cpu : _cpus)
+    CPU_SET(cpu, &cpus);
+
+  int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+  if (result != 0)
+  {
+    ignwarn << "Failed to set the CPU affinity of the " << _thread
+            << " thread: " << std::strerror(result) << std::endl;
+  }
+#else
+  ignwarn << "CPU affinity is only supported on Linux, ignoring it for the "
+          << _thread << " thread." << std::endl;
+#endif
+}
+
+/////////////////////////////////////////////////
+/// \brief Apply the real-time priority and CPU affinity of a server
+/// configuration to the calling thread.
+/// \param[in] _config Server configuration.
+void scheduleCurrentThread(const ServerConfig &_config)
+{
+  if (_config.RealTimePriority() != 0)
+  {
+#ifdef __linux__
+    sched_param param{};
+    param.sched_priority = _config.RealTimePriority();
+    int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0)
+    {
+      ignwarn << "Failed to set SCHED_FIFO priority ["
+              << _config.RealTimePriority() << "] on the simulation thread: "
+              << std::strerror(result) << std::endl;
+    }
+#else
+    ignwarn << "Real-time priority is only supported on Linux, ignoring it."
+            << std::endl;
+#endif
+  }
+
+  pinCurrentThread(_config.CpuAffinity(), "simulation");
+}
+}
+
 
 //////////////////////////////////////////////////
 SimulationRunner::SimulationRunner(const sdf::World *_world,
                                    const SystemLoaderPtr &_systemLoader,
-                                   const ServerConfig &_config)
+                                   const ServerConfig &_config,
+                                   TaskPool *_taskPool)
     // \todo(nkoenig) Either copy the world, or add copy constructor to the
     // World and other elements.
-    : sdfWorld(_world), serverConfig(_config)
+    : sdfWorld(_world), serverConfig(_config), taskPool(_taskPool)
 {
+  if (nullptr == this->taskPool)
+  {
+    this->ownTaskPool = CreateTaskPool(this->serverConfig);
+    this->taskPool = this->ownTaskPool.get();
+  }
+  this->entityCompMgr.SetTaskPool(this->taskPool);
+  this->entityCompMgr.SetNameIndex(this->serverConfig.NameIndex());
+
+  // The tracer is shared by all worlds of the process
+  if (this->serverConfig.TraceEventsPerThread() > 0)
+    Tracer::Enable(this->serverConfig.TraceEventsPerThread());
+
   if (nullptr == _world)
   {
     ignerr << "Can't start simulation runner with null world." << std::endl;
@@ -137,7 +246,8 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
           std::bind(&SimulationRunner::Step, this, std::placeholders::_1),
           this->entityCompMgr, &this->eventMgr,
           NetworkConfig::FromValues(
-            _config.NetworkRole(), _config.NetworkSecondaries()));
+            _config.NetworkRole(), _config.NetworkSecondaries(),
+            _config.NetworkMaxStepLag()));
     }
 
     if (this->networkMgr)
@@ -156,6 +266,32 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
     }
   }
 
+  // Run PostUpdate in the background, while the simulation thread paces the
+  // next step. Network managers step the runner themselves, and rely on steps
+  // being complete when they return, so they are left out.
+  if (this->serverConfig.PipelinedPostUpdate() && !this->networkMgr)
+  {
+    this->postUpdateStartBarrier = std::make_unique<Barrier>(2);
+    this->postUpdateStopBarrier = std::make_unique<Barrier>(2);
+    this->UpdateBarrierSpin();
+    this->postUpdateThread = std::thread([this]()
+    {
+      IGN_PROFILE_THREAD_NAME("PostUpdateThread");
+      pinCurrentThread(this->serverConfig.WorkerCpuAffinity(), "PostUpdate");
+      while (this->postUpdateStartBarrier->Wait() !=
+          Barrier::ExitStatus::CANCELLED)
+      {
+        this->RunPostUpdate(this->postUpdateInfo);
+        this->postUpdateEndTime = std::chrono::steady_clock::now();
+        if (this->postUpdateStopBarrier->Wait() ==
+            Barrier::ExitStatus::CANCELLED)
+        {
+          break;
+        }
+      }
+    });
+  }
+
   // Load the active levels
   this->levelMgr->UpdateLevelsState();
 
@@ -174,6 +310,9 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
 
   this->LoadLoggingPlugins(this->serverConfig);
 
+  if (!this->serverConfig.CheckpointPath().empty())
+    this->InitCheckpoints();
+
   // World control
   transport::NodeOptions opts;
   std::string ns{"/world/" + this->worldName};
@@ -224,12 +363,63 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
 
   ignmsg << "Serving world SDF generation service on [" << opts.NameSpace()
          << "/" << genWorldSdfService << "]" << std::endl;
+
+  std::string saveWorldSdfService{"save_world_sdf"};
+  this->node->Advertise(
+      saveWorldSdfService, &SimulationRunner::SaveWorldSdfService, this);
+  this->worldSdfProgressPub = this->node->Advertise<msgs::Param>(
+      saveWorldSdfService + "/progress");
+
+  ignmsg << "Serving background world SDF generation on ["
+         << opts.NameSpace() << "/" << saveWorldSdfService << "]"
+         << std::endl;
+
+  if (this->serverConfig.TraceEventsPerThread() > 0)
+  {
+    std::string traceDumpService{"trace/dump"};
+    this->node->Advertise(
+        traceDumpService, &SimulationRunner::TraceDumpService, this);
+
+    ignmsg << "Serving trace dumps on [" << opts.NameSpace() << "/"
+           << traceDumpService << "]" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+std::unique_ptr<TaskPool> SimulationRunner::CreateTaskPool(
+    const ServerConfig &_config)
+{
+  // The thread submitting work takes part in it, so it counts towards the
+  // number of threads.
+  unsigned int threadCount = _config.ThreadCount();
+  if (0u == threadCount)
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+  igndbg << "Running parallel work on [" << threadCount << "] threads"
+         << std::endl;
+  return std::make_unique<TaskPool>(threadCount - 1,
+      _config.WorkerCpuAffinity());
 }
 
 //////////////////////////////////////////////////
 SimulationRunner::~SimulationRunner()
 {
-  this->StopWorkerThreads();
+  if (this->postUpdateThread.joinable())
+  {
+    if (this->postUpdatePending)
+      this->postUpdateStopBarrier->Wait();
+    this->postUpdateStartBarrier->Cancel();
+    this->postUpdateThread.join();
+  }
+  this->entityCompMgr.SetTaskPool(nullptr);
+
+  // Jobs publish through this runner's node
+  std::vector<std::future<void>> jobs;
+  {
+    std::lock_guard<std::mutex> lock(this->worldSdfJobsMutex);
+    jobs.swap(this->worldSdfJobs);
+  }
+  for (auto &job : jobs)
+    job.wait();
 }
 
 /////////////////////////////////////////////////
@@ -281,6 +471,16 @@ void SimulationRunner::UpdateCurrentInfo()
 
   // Regular time flow
 
+  // Within a batch, the real time factor is only computed at the end.
+  if (this->batchedStep)
+  {
+    this->currentInfo.realTime = this->realTimeWatch.ElapsedRunTime();
+    this->currentInfo.simTime += this->stepSize;
+    ++this->currentInfo.iterations;
+    this->currentInfo.dt = this->stepSize;
+    return;
+  }
+
   // Store the real time and sim time only if not paused.
   if (this->realTimeWatch.Running())
   {
@@ -332,6 +532,80 @@ void SimulationRunner::UpdateCurrentInfo()
   }
 }
 
+/////////////////////////////////////////////////
+void SimulationRunner::ApplyRequestedRestore()
+{
+  std::unique_ptr<msgs::SerializedStateMap> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(this->restoreMutex);
+    snapshot = std::move(this->requestedRestore);
+  }
+  if (!snapshot)
+    return;
+
+  IGN_PROFILE("SimulationRunner::ApplyRequestedRestore");
+
+  // Entities created after the snapshot are removed at the end of this step,
+  // and the ones removed since then are recreated with their old IDs.
+  for (const auto &vertex : this->entityCompMgr.Entities().Vertices())
+  {
+    if (snapshot->entities().find(vertex.first) ==
+        snapshot->entities().end())
+    {
+      this->entityCompMgr.RequestRemoveEntity(vertex.first, false);
+    }
+  }
+  this->entityCompMgr.SetState(*snapshot);
+
+  // The physics engine state isn't in the ECM, so have the physics system
+  // reset joints and free models to the restored state.
+  this->entityCompMgr.Each<components::Joint, components::JointPosition>(
+      [&](const Entity &_entity, const components::Joint *,
+          const components::JointPosition *_pos) -> bool
+      {
+        auto vel = this->entityCompMgr.ComponentData<
+            components::JointVelocity>(_entity).value_or(
+            std::vector<double>(_pos->Data().size(), 0.0));
+        this->entityCompMgr.SetComponentData<components::JointPositionReset>(
+            _entity, _pos->Data());
+        this->entityCompMgr.SetComponentData<components::JointVelocityReset>(
+            _entity, vel);
+        return true;
+      });
+
+  auto worldEntity =
+      this->entityCompMgr.EntityByComponents(components::World());
+  this->entityCompMgr.Each<components::Model, components::ParentEntity,
+                           components::Pose>(
+      [&](const Entity &_entity, const components::Model *,
+          const components::ParentEntity *_parent,
+          const components::Pose *_pose) -> bool
+      {
+        auto staticComp =
+            this->entityCompMgr.Component<components::Static>(_entity);
+        if (_parent->Data() == worldEntity &&
+            (!staticComp || !staticComp->Data()))
+        {
+          this->entityCompMgr.SetComponentData<components::WorldPoseCmd>(
+              _entity, _pose->Data());
+        }
+        return true;
+      });
+
+  // Time continues from the snapshot, as if the steps in between never
+  // happened.
+  this->currentInfo.simTime =
+      convert<std::chrono::steady_clock::duration>(snapshot->header().stamp());
+  for (const auto &data : snapshot->header().data())
+  {
+    if (data.key() == "iteration" && data.value_size() > 0)
+      this->currentInfo.iterations = std::stoull(data.value(0));
+  }
+  this->realTimes.clear();
+  this->simTimes.clear();
+  this->realTimeFactor = 0;
+}
+
 /////////////////////////////////////////////////
 void SimulationRunner::UpdatePhysicsParams()
 {
@@ -361,6 +635,7 @@ void SimulationRunner::UpdatePhysicsParams()
     this->desiredRtf = newRTF;
     this->updatePeriod = std::chrono::nanoseconds(
         static_cast<int>(this->stepSize.count() / this->desiredRtf));
+    this->UpdateBarrierSpin();
 
     this->simTimes.clear();
     this->realTimes.clear();
@@ -376,7 +651,19 @@ void SimulationRunner::UpdatePhysicsParams()
 /////////////////////////////////////////////////
 void SimulationRunner::PublishStats()
 {
+  // Without a fixed update period, each step can take only microseconds of
+  // wall-clock time. Publish on wall-clock time then, so that GUIs and
+  // dashboards stay responsive without flooding transport.
+  if (this->updatePeriod <= std::chrono::steady_clock::duration::zero())
+  {
+    auto now = std::chrono::steady_clock::now();
+    if (now - this->statsPubTime < kFreeRunPublishPeriod)
+      return;
+    this->statsPubTime = now;
+  }
+
   IGN_PROFILE("SimulationRunner::PublishStats");
+  IGN_GAZEBO_TRACE("SimulationRunner::PublishStats");
 
   // Create the world statistics message.
   ignition::msgs::WorldStatistics msg;
@@ -398,14 +685,30 @@ void SimulationRunner::PublishStats()
 
   msg.set_paused(this->currentInfo.paused);
 
+  // Jitter of the step start times over the previous second, in ms
+  if (this->prevStepJitter.Count() > 0)
+  {
+    auto addJitter = [&msg](const std::string &_key,
+        const std::chrono::nanoseconds &_value)
+    {
+      auto data = msg.mutable_header()->add_data();
+      data->set_key(_key);
+      data->add_value(std::to_string(
+          std::chrono::duration<double, std::milli>(_value).count()));
+    };
+    addJitter("step_jitter_mean_ms", this->prevStepJitter.Mean());
+    addJitter("step_jitter_p99_ms", this->prevStepJitter.Percentile(0.99));
+    addJitter("step_jitter_max_ms", this->prevStepJitter.Max());
+  }
+
   // Publish the stats message. The stats message is throttled.
   this->statsPub.Publish(msg);
 
   if (this->rootStatsPub.Valid())
     this->rootStatsPub.Publish(msg);
 
-  // Create and publish the clock message. The clock message is not
-  // throttled.
+  // Create and publish the clock message. The clock message is only
+  // throttled when running as fast as possible.
   ignition::msgs::Clock clockMsg;
   clockMsg.mutable_real()->set_sec(realTimeSecNsec.first);
   clockMsg.mutable_real()->set_nsec(realTimeSecNsec.second);
@@ -422,122 +725,691 @@ void SimulationRunner::PublishStats()
 }
 
 /////////////////////////////////////////////////
-void SimulationRunner::AddSystem(const SystemPluginPtr &_system)
+void SimulationRunner::PublishSystemStats()
+{
+  auto now = std::chrono::steady_clock::now();
+  if (!this->systemStatsPub.Valid() || now - this->systemStatsPubTime < 1s)
+    return;
+  this->systemStatsPubTime = now;
+
+  IGN_PROFILE("SimulationRunner::PublishSystemStats");
+
+  auto toMs = [](const std::chrono::nanoseconds &_duration)
+  {
+    return std::chrono::duration<double, std::milli>(_duration).count();
+  };
+
+  // Statistics of one phase, as "<phase>_<stat>" parameters. They cover the
+  // steps since the last publication.
+  auto addPhase = [&](msgs::Param &_param, const std::string &_phase,
+      TimingHistogram &_times)
+  {
+    auto &params = *_param.mutable_params();
+
+    msgs::Any count;
+    count.set_type(msgs::Any::INT32);
+    count.set_int_value(static_cast<int>(_times.Count()));
+    params[_phase + "_count"] = count;
+
+    auto addMs = [&](const std::string &_stat,
+        const std::chrono::nanoseconds &_value)
+    {
+      msgs::Any value;
+      value.set_type(msgs::Any::DOUBLE);
+      value.set_double_value(toMs(_value));
+      params[_phase + "_" + _stat + "_ms"] = value;
+    };
+    addMs("mean", _times.Mean());
+    addMs("p50", _times.Percentile(0.5));
+    addMs("p99", _times.Percentile(0.99));
+    addMs("max", _times.Max());
+
+    _times.Reset();
+  };
+
+  msgs::Param_V msg;
+  msg.mutable_header()->mutable_stamp()->CopyFrom(
+      convert<msgs::Time>(this->currentInfo.simTime));
+
+  // The phase vectors hold systems in the same order as the systems vector
+  std::size_t preupdateIndex{0};
+  std::size_t updateIndex{0};
+  std::size_t postupdateIndex{0};
+  for (std::size_t i = 0; i < this->systems.size(); ++i)
+  {
+    const auto &system = this->systems[i];
+    auto param = msg.add_param();
+
+    msgs::Any name;
+    name.set_type(msgs::Any::STRING);
+    name.set_string_value(system.name.empty() ?
+        "system_" + std::to_string(i) : system.name);
+    (*param->mutable_params())["name"] = name;
+
+    if (system.preupdate)
+    {
+      addPhase(*param, "pre_update",
+          this->systemsPreupdateTimes[preupdateIndex++]);
+    }
+    if (system.update)
+      addPhase(*param, "update", this->systemsUpdateTimes[updateIndex++]);
+    if (system.postupdate)
+    {
+      addPhase(*param, "post_update",
+          this->systemsPostupdateTimes[postupdateIndex++]);
+    }
+  }
+
+  // Loading and unloading levels runs before the systems, in its own phase
+  auto levelsParam = msg.add_param();
+  msgs::Any levelsName;
+  levelsName.set_type(msgs::Any::STRING);
+  levelsName.set_string_value("LevelManager");
+  (*levelsParam->mutable_params())["name"] = levelsName;
+  addPhase(*levelsParam, "levels", this->levelsTimes);
+
+  this->systemStatsPub.Publish(msg);
+}
+
+/////////////////////////////////////////////////
+bool SimulationRunner::NetworkStats(msgs::Param_V &_stats) const
+{
+  if (!this->networkMgr)
+    return false;
+
+  _stats.mutable_header()->mutable_stamp()->CopyFrom(
+      convert<msgs::Time>(this->currentInfo.simTime));
+
+  for (const auto &peer : this->networkMgr->Peers())
+  {
+    auto &params = *_stats.add_param()->mutable_params();
+
+    auto addString = [&params](const std::string &_key,
+        const std::string &_value)
+    {
+      msgs::Any value;
+      value.set_type(msgs::Any::STRING);
+      value.set_string_value(_value);
+      params[_key] = value;
+    };
+    auto addDouble = [&params](const std::string &_key, double _value)
+    {
+      msgs::Any value;
+      value.set_type(msgs::Any::DOUBLE);
+      value.set_double_value(_value);
+      params[_key] = value;
+    };
+
+    addString("id", peer.id);
+    addString("hostname", peer.hostname);
+    switch (peer.role)
+    {
+      case NetworkRole::SimulationPrimary:
+        addString("role", "primary");
+        break;
+      case NetworkRole::SimulationSecondary:
+        addString("role", "secondary");
+        break;
+      case NetworkRole::ReadOnly:
+        addString("role", "readonly");
+        break;
+      case NetworkRole::None:
+      default:
+        addString("role", "none");
+        break;
+    }
+    addDouble("step_time_ms", peer.stepTime * 1e3);
+    addDouble("state_size_bytes", static_cast<double>(peer.stateSize));
+    addDouble("queue_depth", static_cast<double>(peer.queueDepth));
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::PublishNetworkStats()
+{
+  auto now = std::chrono::steady_clock::now();
+  if (!this->networkMgr || now - this->networkStatsPubTime < 1s)
+    return;
+  this->networkStatsPubTime = now;
+
+  IGN_PROFILE("SimulationRunner::PublishNetworkStats");
+
+  if (!this->networkStatsPub.Valid())
+  {
+    this->networkStatsPub =
+        this->node->Advertise<ignition::msgs::Param_V>("stats/network");
+  }
+
+  msgs::Param_V msg;
+  if (this->NetworkStats(msg))
+    this->networkStatsPub.Publish(msg);
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::PublishMemoryStats()
+{
+  auto now = std::chrono::steady_clock::now();
+  if (!this->memoryStatsPub.Valid() || now - this->memoryStatsPubTime < 5s)
+    return;
+  this->memoryStatsPubTime = now;
+
+  if (!this->memoryStatsPub.HasConnections())
+    return;
+
+  IGN_PROFILE("SimulationRunner::PublishMemoryStats");
+
+  const auto usage = this->entityCompMgr.MemoryUsage();
+
+  auto addString = [](msgs::Param &_param, const std::string &_key,
+      const std::string &_value)
+  {
+    msgs::Any value;
+    value.set_type(msgs::Any::STRING);
+    value.set_string_value(_value);
+    (*_param.mutable_params())[_key] = value;
+  };
+  auto addInt = [](msgs::Param &_param, const std::string &_key,
+      std::size_t _value)
+  {
+    msgs::Any value;
+    value.set_type(msgs::Any::INT32);
+    value.set_int_value(static_cast<int>(std::min<std::size_t>(_value,
+        std::numeric_limits<int>::max())));
+    (*_param.mutable_params())[_key] = value;
+  };
+  auto addBytes = [](msgs::Param &_param, const std::string &_key,
+      std::size_t _value)
+  {
+    msgs::Any value;
+    value.set_type(msgs::Any::DOUBLE);
+    value.set_double_value(static_cast<double>(_value));
+    (*_param.mutable_params())[_key + "_bytes"] = value;
+  };
+
+  msgs::Param_V msg;
+  msg.mutable_header()->mutable_stamp()->CopyFrom(
+      convert<msgs::Time>(this->currentInfo.simTime));
+
+  // The first parameter holds the totals
+  auto &total = *msg.add_param();
+  addString(total, "name", "total");
+  addBytes(total, "total", usage.TotalBytes());
+  addBytes(total, "component", usage.componentBytes);
+  addInt(total, "view_count", usage.viewCount);
+  addBytes(total, "view", usage.viewBytes);
+  addInt(total, "archetype_count", usage.archetypeCount);
+  addBytes(total, "archetype", usage.archetypeBytes);
+  addBytes(total, "entity_table", usage.entityTableBytes);
+  addInt(total, "descendant_cache_entries", usage.descendantCacheEntries);
+  addBytes(total, "descendant_cache", usage.descendantCacheBytes);
+  addInt(total, "change_tracking_entries", usage.changeTrackingEntries);
+  addBytes(total, "change_tracking", usage.changeTrackingBytes);
+
+  // Then one parameter per component type, largest first
+  std::vector<const EcmMemoryUsage::ComponentType *> types;
+  for (const auto &type : usage.componentTypes)
+    types.push_back(&type.second);
+  std::sort(types.begin(), types.end(),
+      [](const EcmMemoryUsage::ComponentType *_a,
+         const EcmMemoryUsage::ComponentType *_b)
+      {
+        return _a->bytes > _b->bytes;
+      });
+
+  for (const auto *type : types)
+  {
+    auto &param = *msg.add_param();
+    addString(param, "name", type->name);
+    addInt(param, "count", type->count);
+    addBytes(param, "component", type->bytes);
+  }
+
+  this->memoryStatsPub.Publish(msg);
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::InitCheckpoints()
+{
+  const auto &dir = this->serverConfig.CheckpointPath();
+  if (!common::exists(dir) && !common::createDirectories(dir))
+  {
+    ignerr << "Failed to create checkpoint directory [" << dir
+           << "], checkpoints are disabled." << std::endl;
+    return;
+  }
+  const auto path = common::joinPaths(dir,
+      common::replaceAll(this->worldName, "/", "_") + ".ckpt");
+
+  // Restored right before the first step. The first checkpoint replaces the
+  // file once it's complete.
+  if (this->serverConfig.CheckpointResume())
+  {
+    auto state = std::make_unique<msgs::SerializedStateMap>();
+    if (Checkpoint::Read(path, *state))
+    {
+      ignmsg << "Resuming world [" << this->worldName << "] from checkpoint ["
+             << path << "] at [" << state->header().stamp().sec() << "s]."
+             << std::endl;
+      std::lock_guard<std::mutex> lock(this->restoreMutex);
+      this->requestedRestore = std::move(state);
+    }
+    else
+    {
+      ignwarn << "No checkpoint to resume world [" << this->worldName
+              << "] from at [" << path << "]." << std::endl;
+    }
+  }
+
+  this->checkpoint = std::make_unique<Checkpoint>(path);
+  ignmsg << "Writing checkpoints of world [" << this->worldName << "] to ["
+         << path << "]." << std::endl;
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::UpdateCheckpoint()
+{
+  IGN_PROFILE("SimulationRunner::UpdateCheckpoint");
+
+  // Collecting the changed entities only costs as much as the changes, so
+  // they're accumulated every step, and only serialized when a checkpoint
+  // is due
+  if (!this->checkpointFull)
+    this->entityCompMgr.AddChangedEntities(this->checkpointEntities);
+
+  const auto &simTime = this->currentInfo.simTime;
+  const auto period = this->serverConfig.CheckpointPeriod();
+  if (!this->checkpointFull && simTime >= this->lastCheckpointTime &&
+      simTime - this->lastCheckpointTime < period)
+  {
+    return;
+  }
+
+  auto state = std::make_unique<msgs::SerializedStateMap>();
+  if (this->checkpointFull)
+  {
+    this->entityCompMgr.State(*state, {}, {}, true);
+  }
+  else if (!this->checkpointEntities.empty())
+  {
+    this->entityCompMgr.State(*state, this->checkpointEntities, {}, true);
+    for (Entity entity : this->checkpointEntities)
+    {
+      if (!this->entityCompMgr.HasEntity(entity) ||
+          this->entityCompMgr.IsMarkedForRemoval(entity))
+      {
+        auto &entityMsg = (*state->mutable_entities())[entity];
+        entityMsg.set_id(entity);
+        entityMsg.set_remove(true);
+      }
+    }
+  }
+  this->StampSnapshot(*state);
+  this->checkpoint->Write(std::move(state));
+
+  this->checkpointEntities.clear();
+  this->checkpointFull = false;
+  this->lastCheckpointTime = simTime;
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::CheckSlowStep(
+    const std::chrono::steady_clock::duration &_duration)
+{
+  const auto threshold = this->serverConfig.SlowStepThreshold();
+  if (threshold <= 0ns || _duration < threshold)
+    return;
+
+  IGN_PROFILE("SimulationRunner::CheckSlowStep");
+
+  // Time taken by each system during this step. The phase vectors hold
+  // systems in the same order as the systems vector.
+  struct SystemTime
+  {
+    std::string name;
+    std::string phase;
+    std::chrono::nanoseconds time;
+  };
+  std::vector<SystemTime> times;
+  std::size_t preupdateIndex{0};
+  std::size_t updateIndex{0};
+  std::size_t postupdateIndex{0};
+  for (std::size_t i = 0; i < this->systems.size(); ++i)
+  {
+    const auto &system = this->systems[i];
+    const std::string name = system.name.empty() ?
+        "system_" + std::to_string(i) : system.name;
+    if (system.preupdate)
+    {
+      times.push_back({name, "pre_update",
+          this->systemsPreupdateTimes[preupdateIndex++].Last()});
+    }
+    if (system.update)
+    {
+      times.push_back({name, "update",
+          this->systemsUpdateTimes[updateIndex++].Last()});
+    }
+    if (system.postupdate)
+    {
+      times.push_back({name, "post_update",
+          this->systemsPostupdateTimes[postupdateIndex++].Last()});
+    }
+  }
+
+  const std::size_t reportedCount = std::min<std::size_t>(5, times.size());
+  std::partial_sort(times.begin(), times.begin() + reportedCount,
+      times.end(), [](const SystemTime &_a, const SystemTime &_b)
+      {
+        return _a.time > _b.time;
+      });
+  times.resize(reportedCount);
+
+  const auto entityCount = this->entityCompMgr.EntityCount();
+  const auto newEntityCount = this->entityCompMgr.NewEntityCount();
+  const auto removedEntityCount =
+      this->entityCompMgr.EntitiesMarkedForRemovalCount();
+
+  auto toMs = [](const std::chrono::steady_clock::duration &_duration)
+  {
+    return std::chrono::duration<double, std::milli>(_duration).count();
+  };
+
+  // Warn at most once per second, a threshold below the usual step time
+  // would flood the console otherwise.
+  ++this->slowStepsSinceWarning;
+  auto now = std::chrono::steady_clock::now();
+  if (now - this->slowStepWarningTime >= 1s)
+  {
+    std::stringstream ss;
+    ss << "Step [" << this->currentInfo.iterations << "] took ["
+       << toMs(_duration) << " ms], over the [" << toMs(threshold)
+       << " ms] threshold.";
+    if (!times.empty())
+    {
+      ss << " Slowest system: [" << times[0].name << "] " << times[0].phase
+         << " [" << toMs(times[0].time) << " ms].";
+    }
+    ss << " Entities: [" << entityCount << "], new: [" << newEntityCount
+       << "], to remove: [" << removedEntityCount
+       << "]. Slow steps since the last warning: ["
+       << this->slowStepsSinceWarning << "].";
+    ignwarn << ss.str() << std::endl;
+    this->slowStepWarningTime = now;
+    this->slowStepsSinceWarning = 0;
+  }
+
+  if (!this->slowStepPub.Valid() || !this->slowStepPub.HasConnections())
+    return;
+
+  auto addDouble = [](msgs::Param &_param, const std::string &_key,
+      double _value)
+  {
+    msgs::Any value;
+    value.set_type(msgs::Any::DOUBLE);
+    value.set_double_value(_value);
+    (*_param.mutable_params())[_key] = value;
+  };
+  auto addInt = [](msgs::Param &_param, const std::string &_key,
+      std::size_t _value)
+  {
+    msgs::Any value;
+    value.set_type(msgs::Any::INT32);
+    value.set_int_value(static_cast<int>(std::min<std::size_t>(_value,
+        std::numeric_limits<int>::max())));
+    (*_param.mutable_params())[_key] = value;
+  };
+  auto addString = [](msgs::Param &_param, const std::string &_key,
+      const std::string &_value)
+  {
+    msgs::Any value;
+    value.set_type(msgs::Any::STRING);
+    value.set_string_value(_value);
+    (*_param.mutable_params())[_key] = value;
+  };
+
+  msgs::Param_V msg;
+  msg.mutable_header()->mutable_stamp()->CopyFrom(
+      convert<msgs::Time>(this->currentInfo.simTime));
+  auto iterationData = msg.mutable_header()->add_data();
+  iterationData->set_key("iteration");
+  iterationData->add_value(std::to_string(this->currentInfo.iterations));
+
+  // The first parameter describes the step, the following ones the slowest
+  // systems, slowest first
+  auto step = msg.add_param();
+  addDouble(*step, "step_ms", toMs(_duration));
+  addDouble(*step, "threshold_ms", toMs(threshold));
+  addInt(*step, "entity_count", entityCount);
+  addInt(*step, "new_entity_count", newEntityCount);
+  addInt(*step, "removed_entity_count", removedEntityCount);
+
+  for (const auto &time : times)
+  {
+    auto param = msg.add_param();
+    addString(*param, "name", time.name);
+    addString(*param, "phase", time.phase);
+    addDouble(*param, "ms", toMs(time.time));
+  }
+
+  this->slowStepPub.Publish(msg);
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::AddSystem(const SystemPluginPtr &_system,
+                                 const std::string &_name,
+                                 const SystemRate &_rate)
 {
   std::lock_guard<std::mutex> lock(this->pendingSystemsMutex);
-  this->pendingSystems.push_back(_system);
+  this->pendingSystems.push_back({_system, _name, _rate});
 }
 
 /////////////////////////////////////////////////
-void SimulationRunner::AddSystemToRunner(const SystemPluginPtr &_system)
+void SimulationRunner::AddSystemToRunner(const SystemPluginPtr &_system,
+                                         const std::string &_name,
+                                         const SystemRate &_rate)
 {
-  this->systems.push_back(SystemInternal(_system));
+  this->systems.push_back(SystemInternal(_system, _name, _rate));
 
   const auto &system = this->systems.back();
+  const std::string traceName = (_name.empty() ?
+      "system_" + std::to_string(this->systems.size() - 1) : _name) + "::";
 
   if (system.preupdate)
+  {
     this->systemsPreupdate.push_back(system.preupdate);
+    this->systemsPreupdateAccess.push_back(system.access);
+    this->systemsPreupdateTimes.emplace_back();
+    this->systemsPreupdateTraceIds.push_back(
+        Tracer::NameId(traceName + "PreUpdate"));
+    this->systemsPreupdateIndex.push_back(this->systems.size() - 1);
+  }
 
   if (system.update)
+  {
     this->systemsUpdate.push_back(system.update);
+    this->systemsUpdateAccess.push_back(system.access);
+    this->systemsUpdateTimes.emplace_back();
+    this->systemsUpdateTraceIds.push_back(
+        Tracer::NameId(traceName + "Update"));
+    this->systemsUpdateIndex.push_back(this->systems.size() - 1);
+  }
 
   if (system.postupdate)
+  {
     this->systemsPostupdate.push_back(system.postupdate);
+    this->systemsPostupdateTimes.emplace_back();
+    this->systemsPostupdateTraceIds.push_back(
+        Tracer::NameId(traceName + "PostUpdate"));
+    this->systemsPostupdateIndex.push_back(this->systems.size() - 1);
+  }
 }
 
 /////////////////////////////////////////////////
 void SimulationRunner::ProcessSystemQueue()
 {
   std::lock_guard<std::mutex> lock(this->pendingSystemsMutex);
-  auto pending = this->pendingSystems.size();
 
-  if (pending > 0)
+  // Systems which opted in only read the ECM during Configure, so they can be
+  // configured together before any of them is added.
+  if (!this->pendingConfigures.empty())
   {
-    // If additional systems are to be added, stop the existing threads.
-    this->StopWorkerThreads();
+    IGN_PROFILE("SimulationRunner::ProcessSystemQueue::Configure");
+    this->taskPool->ParallelFor(this->pendingConfigures.size(), 1,
+        [&](std::size_t _begin, std::size_t _end)
+        {
+          for (std::size_t i = _begin; i < _end; ++i)
+          {
+            const auto &pending = this->pendingConfigures[i];
+            pending.system->Configure(pending.entity, pending.sdf,
+                this->entityCompMgr, this->eventMgr);
+          }
+        });
+    this->pendingConfigures.clear();
   }
 
   for (const auto &system : this->pendingSystems)
   {
-    this->AddSystemToRunner(system);
+    this->AddSystemToRunner(system.system, system.name, system.rate);
   }
 
   this->pendingSystems.clear();
+}
 
-  // If additional systems were added, recreate the worker threads.
-  if (pending > 0)
-  {
-    igndbg << "Creating PostUpdate worker threads: "
-      << this->systemsPostupdate.size() + 1 << std::endl;
-
-    this->postUpdateStartBarrier =
-      std::make_unique<Barrier>(this->systemsPostupdate.size() + 1);
-    this->postUpdateStopBarrier =
-      std::make_unique<Barrier>(this->systemsPostupdate.size() + 1);
+/////////////////////////////////////////////////
+void SimulationRunner::UpdateSystems()
+{
+  IGN_PROFILE("SimulationRunner::UpdateSystems");
+  IGN_GAZEBO_TRACE("SimulationRunner::UpdateSystems");
 
-    this->postUpdateThreadsRunning = true;
-    int id = 0;
+  // Decide which decimated systems run on this iteration, they're skipped
+  // in all phases otherwise.
+  for (auto &system : this->systems)
+    system.rate.Step(this->currentInfo);
 
-    for (auto &system : this->systemsPostupdate)
+  // Run the stages of a phase in order. Systems of the same stage declared
+  // that they don't conflict, so they are run concurrently.
+  auto runStages = [this](const auto &_stages, const auto &_run)
+  {
+    for (const auto &stage : _stages)
     {
-      igndbg << "Creating postupdate worker thread (" << id << ")" << std::endl;
-
-      this->postUpdateThreads.push_back(std::thread([&, id]()
+      if (stage.size() == 1)
       {
-        std::stringstream ss;
-        ss << "PostUpdateThread: " << id;
-        IGN_PROFILE_THREAD_NAME(ss.str().c_str());
-        while (this->postUpdateThreadsRunning)
-        {
-          this->postUpdateStartBarrier->Wait();
-          if (this->postUpdateThreadsRunning)
+        _run(stage[0]);
+        continue;
+      }
+
+      this->taskPool->ParallelFor(stage.size(), 1,
+          [&](std::size_t _begin, std::size_t _end)
           {
-            system->PostUpdate(this->currentInfo, this->entityCompMgr);
-          }
-          this->postUpdateStopBarrier->Wait();
-        }
-        igndbg << "Exiting postupdate worker thread ("
-          << id << ")" << std::endl;
-      }));
-      id++;
+            for (std::size_t i = _begin; i < _end; ++i)
+              _run(stage[i]);
+          });
     }
-  }
-}
-
-/////////////////////////////////////////////////
-void SimulationRunner::UpdateSystems()
-{
-  IGN_PROFILE("SimulationRunner::UpdateSystems");
-  // \todo(nkoenig)  Systems used to be updated in parallel using
-  // an ignition::common::WorkerPool. There is overhead associated with
-  // this, most notably the creation and destruction of WorkOrders (see
-  // WorkerPool.cc). We could turn on parallel updates in the future, and/or
-  // turn it on if there are sufficient systems. More testing is required.
+  };
 
   {
     IGN_PROFILE("PreUpdate");
-    for (auto& system : this->systemsPreupdate)
-      system->PreUpdate(this->currentInfo, this->entityCompMgr);
+    IGN_GAZEBO_TRACE("PreUpdate");
+    runStages(this->preupdateScheduler.Schedule(this->systemsPreupdateAccess,
+        this->entityCompMgr), [this](std::size_t _index)
+        {
+          auto info = this->systems[this->systemsPreupdateIndex[_index]]
+              .rate.Info(this->currentInfo);
+          if (!info)
+            return;
+
+          auto start = std::chrono::steady_clock::now();
+          this->systemsPreupdate[_index]->PreUpdate(*info,
+              this->entityCompMgr);
+          auto end = std::chrono::steady_clock::now();
+          this->systemsPreupdateTimes[_index].Add(end - start);
+          Tracer::Record(this->systemsPreupdateTraceIds[_index], start, end);
+        });
   }
 
   {
     IGN_PROFILE("Update");
-    for (auto& system : this->systemsUpdate)
-      system->Update(this->currentInfo, this->entityCompMgr);
+    IGN_GAZEBO_TRACE("Update");
+    runStages(this->updateScheduler.Schedule(this->systemsUpdateAccess,
+        this->entityCompMgr), [this](std::size_t _index)
+        {
+          auto info = this->systems[this->systemsUpdateIndex[_index]]
+              .rate.Info(this->currentInfo);
+          if (!info)
+            return;
+
+          auto start = std::chrono::steady_clock::now();
+          this->systemsUpdate[_index]->Update(*info, this->entityCompMgr);
+          auto end = std::chrono::steady_clock::now();
+          this->systemsUpdateTimes[_index].Add(end - start);
+          Tracer::Record(this->systemsUpdateTraceIds[_index], start, end);
+        });
   }
 
   {
     IGN_PROFILE("PostUpdate");
-    // If no systems implementing PostUpdate have been added, then
-    // the barriers will be uninitialized, so guard against that condition.
-    if (this->postUpdateStartBarrier && this->postUpdateStopBarrier)
+    IGN_GAZEBO_TRACE("PostUpdate");
+    if (!this->systemsPostupdate.empty())
     {
-      this->postUpdateStartBarrier->Wait();
-      this->postUpdateStopBarrier->Wait();
+      // The ECM is read-only during PostUpdate, so the worker threads can
+      // look up components without locking the storages.
+      this->entityCompMgr.SetLockFreeReads(true);
+
+      // Hand over to the PostUpdate thread, the ECM stays read-only until
+      // WaitForPostUpdate.
+      if (this->postUpdateThread.joinable())
+      {
+        this->postUpdateInfo = this->currentInfo;
+        this->postUpdatePending = true;
+        this->postUpdateStartBarrier->Wait();
+        return;
+      }
+
+      this->RunPostUpdate(this->currentInfo);
+      this->entityCompMgr.SetLockFreeReads(false);
     }
   }
 }
 
+/////////////////////////////////////////////////
+void SimulationRunner::RunPostUpdate(const UpdateInfo &_info)
+{
+  // Each system is a task, which is picked up by the next idle thread of the
+  // pool, including this one.
+  this->taskPool->ParallelFor(this->systemsPostupdate.size(), 1,
+      [&](std::size_t _begin, std::size_t _end)
+      {
+        for (std::size_t i = _begin; i < _end; ++i)
+        {
+          auto info = this->systems[this->systemsPostupdateIndex[i]]
+              .rate.Info(_info);
+          if (!info)
+            continue;
+
+          auto start = std::chrono::steady_clock::now();
+          this->systemsPostupdate[i]->PostUpdate(*info, this->entityCompMgr);
+          auto end = std::chrono::steady_clock::now();
+          this->systemsPostupdateTimes[i].Add(end - start);
+          Tracer::Record(this->systemsPostupdateTraceIds[i], start, end);
+        }
+      });
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::WaitForPostUpdate()
+{
+  if (!this->postUpdatePending)
+    return;
+
+  IGN_PROFILE("SimulationRunner::WaitForPostUpdate");
+  IGN_GAZEBO_TRACE("SimulationRunner::WaitForPostUpdate");
+  this->postUpdateStopBarrier->Wait();
+  this->postUpdatePending = false;
+  this->entityCompMgr.SetLockFreeReads(false);
+
+  this->FinishStep(this->postUpdateEndTime);
+}
+
 /////////////////////////////////////////////////
 void SimulationRunner::Stop()
 {
@@ -551,25 +1423,6 @@ void SimulationRunner::OnStop()
   this->running = false;
 }
 
-/////////////////////////////////////////////////
-void SimulationRunner::StopWorkerThreads()
-{
-  this->postUpdateThreadsRunning = false;
-  if (this->postUpdateStartBarrier)
-  {
-    this->postUpdateStartBarrier->Cancel();
-  }
-  if (this->postUpdateStopBarrier)
-  {
-    this->postUpdateStopBarrier->Cancel();
-  }
-  for (auto &thread : this->postUpdateThreads)
-  {
-    thread.join();
-  }
-  this->postUpdateThreads.clear();
-}
-
 /////////////////////////////////////////////////
 bool SimulationRunner::Run(const uint64_t _iterations)
 {
@@ -599,16 +1452,45 @@ bool SimulationRunner::Run(const uint64_t _iterations)
       return true;
     }
   }
+
+  this->StartRun();
+
+  // Keep number of iterations requested by caller
+  uint64_t processedIterations{0};
+
+  // Execute all the systems until we are told to stop, or the number of
+  // iterations is reached.
+  while (this->running && (_iterations == 0 ||
+       processedIterations < _iterations))
+  {
+    IGN_PROFILE("SimulationRunner::Run - Iteration");
+
+    // Wait until the next step is due
+    this->Pace();
+
+    processedIterations += this->RunIteration();
+  }
+
+  this->StopRun();
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::StartRun()
+{
+  // Run may be called from different threads, schedule each of them once
+  if (this->scheduledThread != std::this_thread::get_id())
+  {
+    this->scheduledThread = std::this_thread::get_id();
+    scheduleCurrentThread(this->serverConfig);
+  }
+
   // Keep track of wall clock time. Only start the realTimeWatch if this
   // runner is not paused.
   if (!this->currentInfo.paused)
     this->realTimeWatch.Start();
 
-  // Variables for time keeping.
-  std::chrono::steady_clock::time_point startTime;
-  std::chrono::steady_clock::duration sleepTime;
-  std::chrono::steady_clock::duration actualSleep;
-
   this->running = true;
 
   // Create the world statistics publisher.
@@ -648,6 +1530,28 @@ bool SimulationRunner::Run(const uint64_t _iterations)
     }
   }
 
+  // Create the system statistics publisher.
+  if (!this->systemStatsPub.Valid())
+  {
+    this->systemStatsPub =
+        this->node->Advertise<ignition::msgs::Param_V>("stats/systems");
+  }
+
+  // Create the memory statistics publisher.
+  if (!this->memoryStatsPub.Valid())
+  {
+    this->memoryStatsPub =
+        this->node->Advertise<ignition::msgs::Param_V>("stats/memory");
+  }
+
+  // Create the slow step diagnostics publisher.
+  if (!this->slowStepPub.Valid() &&
+      this->serverConfig.SlowStepThreshold() > 0ns)
+  {
+    this->slowStepPub = this->node->Advertise<ignition::msgs::Param_V>(
+        "diagnostics/slow_step");
+  }
+
   // Create the clock publisher.
   if (!this->clockPub.Valid())
     this->clockPub = this->node->Advertise<ignition::msgs::Clock>("clock");
@@ -680,36 +1584,108 @@ bool SimulationRunner::Run(const uint64_t _iterations)
           "/clock");
     }
   }
+}
 
-  // Keep number of iterations requested by caller
+/////////////////////////////////////////////////
+uint64_t SimulationRunner::RunIteration(const bool _batched)
+{
   uint64_t processedIterations{0};
 
-  // Execute all the systems until we are told to stop, or the number of
-  // iterations is reached.
-  while (this->running && (_iterations == 0 ||
-       processedIterations < _iterations))
-  {
-    IGN_PROFILE("SimulationRunner::Run - Iteration");
+  // A pipelined PostUpdate of the previous step overlaps with the sleep
+  // of Pace. Wait for it before the ECM is modified again.
+  this->WaitForPostUpdate();
+
+  this->ApplyRequestedRestore();
 
-    // Update the step size and desired rtf
+  // Within a batch, only the systems need to be updated on every iteration.
+  // A paused runner keeps processing messages, so it can be unpaused.
+  this->batchedStep = !this->networkMgr && !this->currentInfo.paused &&
+      (_batched || this->pendingSimIterations > 1);
+
+  // Update the step size and desired rtf, which will pace the next
+  // iteration.
+  if (!this->batchedStep)
     this->UpdatePhysicsParams();
 
+  // Update time information. This will update the iteration count, RTF,
+  // and other values.
+  this->UpdateCurrentInfo();
+  if (!this->currentInfo.paused)
+  {
+    processedIterations++;
+  }
+
+  // If network, wait for network step, otherwise do our own step
+  if (this->networkMgr)
+  {
+    auto netPrimary =
+        dynamic_cast<NetworkManagerPrimary *>(this->networkMgr.get());
+    netPrimary->Step(this->currentInfo);
+  }
+  else
+  {
+    this->Step(this->currentInfo);
+  }
+
+  // Handle Server::RunOnce(false) in which a single paused run is executed
+  if (this->currentInfo.paused && this->blockingPausedStepPending)
+  {
+    processedIterations++;
+    this->currentInfo.iterations++;
+    this->blockingPausedStepPending = false;
+  }
+
+  return processedIterations;
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::StopRun()
+{
+  // Don't leave the last step unfinished
+  this->WaitForPostUpdate();
+
+  this->running = false;
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::Pace()
+{
+  const auto deadline = this->prevUpdateRealTime + this->updatePeriod;
+  const auto spinWaitTime = this->serverConfig.SpinWaitTime();
+
+  if (spinWaitTime > 0ns)
+  {
+    // Sleep coarsely, then spin on the clock for the last part, since the OS
+    // may wake a sleeping thread up late.
+    if (std::chrono::steady_clock::now() < deadline - spinWaitTime)
+    {
+      IGN_PROFILE("Sleep");
+      IGN_GAZEBO_TRACE("Sleep");
+      std::this_thread::sleep_until(deadline - spinWaitTime);
+    }
+
+    IGN_PROFILE("SpinWait");
+    IGN_GAZEBO_TRACE("SpinWait");
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+    }
+  }
+  else
+  {
     // Compute the time to sleep in order to match, as closely as possible,
     // the update period.
-    sleepTime = 0ns;
-    actualSleep = 0ns;
-
-    sleepTime = std::max(0ns, this->prevUpdateRealTime +
-        this->updatePeriod - std::chrono::steady_clock::now() -
-        this->sleepOffset);
+    std::chrono::steady_clock::duration sleepTime = std::max(0ns,
+        deadline - std::chrono::steady_clock::now() - this->sleepOffset);
+    std::chrono::steady_clock::duration actualSleep{0ns};
 
     // Only sleep if needed.
     if (sleepTime > 0ns)
     {
       IGN_PROFILE("Sleep");
+      IGN_GAZEBO_TRACE("Sleep");
       // Get the current time, sleep for the duration needed to match the
       // updatePeriod, and then record the actual time slept.
-      startTime = std::chrono::steady_clock::now();
+      auto startTime = std::chrono::steady_clock::now();
       std::this_thread::sleep_for(sleepTime);
       actualSleep = std::chrono::steady_clock::now() - startTime;
     }
@@ -719,61 +1695,86 @@ bool SimulationRunner::Run(const uint64_t _iterations)
     this->sleepOffset =
       std::chrono::duration_cast<std::chrono::nanoseconds>(
           (actualSleep - sleepTime) * 0.01 + this->sleepOffset * 0.99);
-
-    // Update time information. This will update the iteration count, RTF,
-    // and other values.
-    this->UpdateCurrentInfo();
-    if (!this->currentInfo.paused)
-    {
-      processedIterations++;
-    }
-
-    // If network, wait for network step, otherwise do our own step
-    if (this->networkMgr)
-    {
-      auto netPrimary =
-          dynamic_cast<NetworkManagerPrimary *>(this->networkMgr.get());
-      netPrimary->Step(this->currentInfo);
-    }
-    else
-    {
-      this->Step(this->currentInfo);
-    }
-
-    // Handle Server::RunOnce(false) in which a single paused run is executed
-    if (this->currentInfo.paused && this->blockingPausedStepPending)
-    {
-      processedIterations++;
-      this->currentInfo.iterations++;
-      this->blockingPausedStepPending = false;
-    }
   }
 
-  this->running = false;
+  // Record how far from its due time the step starts, either because the
+  // thread woke up late, or because the previous step took too long. The
+  // first step isn't due at any time.
+  auto now = std::chrono::steady_clock::now();
+  if (this->prevUpdateRealTime.time_since_epoch() != 0ns)
+    this->stepJitter.Add(now > deadline ? now - deadline : deadline - now);
 
-  return true;
+  if (now - this->stepJitterStart >= 1s)
+  {
+    this->prevStepJitter = this->stepJitter;
+    this->stepJitter.Reset();
+    this->stepJitterStart = now;
+  }
 }
 
 /////////////////////////////////////////////////
 void SimulationRunner::Step(const UpdateInfo &_info)
 {
   IGN_PROFILE("SimulationRunner::Step");
+  IGN_GAZEBO_TRACE("SimulationRunner::Step");
+
+  // In case a step was requested before the previous PostUpdate was done.
+  this->WaitForPostUpdate();
+
   this->currentInfo = _info;
 
   // Publish info
-  this->PublishStats();
+  if (!this->batchedStep)
+  {
+    this->PublishStats();
+    this->PublishSystemStats();
+    this->PublishNetworkStats();
+    this->PublishMemoryStats();
+  }
 
   // Record when the update step starts.
   this->prevUpdateRealTime = std::chrono::steady_clock::now();
 
-  this->levelMgr->UpdateLevelsState();
+  {
+    auto levelsStart = std::chrono::steady_clock::now();
+    this->levelMgr->UpdateLevelsState();
+    this->levelsTimes.Add(std::chrono::steady_clock::now() - levelsStart);
+  }
 
   // Handle pending systems
   this->ProcessSystemQueue();
 
+  // Snapshot the world for pending SDF generation requests
+  this->ProcessWorldSdfRequests();
+
   // Update all the systems.
   this->UpdateSystems();
 
+  // The rest of the step runs once the PostUpdate thread is done.
+  if (this->postUpdatePending)
+    return;
+
+  this->FinishStep(std::chrono::steady_clock::now());
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::FinishStep(
+    const std::chrono::steady_clock::time_point &_updateEnd)
+{
+  IGN_PROFILE("SimulationRunner::FinishStep");
+  IGN_GAZEBO_TRACE("SimulationRunner::FinishStep");
+
+  // Before the new entities and removals are processed, so they can be
+  // reported
+  this->CheckSlowStep(_updateEnd - this->prevUpdateRealTime);
+
+  // Let observers know about the components which changed during this step
+  this->entityCompMgr.NotifyComponentObservers();
+
+  // Before the change flags are cleared
+  if (this->checkpoint)
+    this->UpdateCheckpoint();
+
   if (!this->Paused() && this->pendingSimIterations > 0)
   {
     // Decrement the pending sim iterations, if there are any.
@@ -787,7 +1788,8 @@ void SimulationRunner::Step(const UpdateInfo &_info)
   }
 
   // Process world control messages.
-  this->ProcessMessages();
+  if (!this->batchedStep)
+    this->ProcessMessages();
 
   // Clear all new entities
   this->entityCompMgr.ClearNewlyCreatedEntities();
@@ -819,14 +1821,28 @@ void SimulationRunner::LoadPlugin(const Entity _entity,
   if (system)
   {
     auto systemConfig = system.value()->QueryInterface<ISystemConfigure>();
-    if (systemConfig != nullptr)
+    auto configParallel =
+        system.value()->QueryInterface<ISystemConfigureParallel>();
+    if (systemConfig != nullptr && configParallel != nullptr &&
+        configParallel->ConfigureParallel())
     {
-      systemConfig->Configure(_entity, _sdf,
-          this->entityCompMgr,
-          this->eventMgr);
+      // Configured with the other pending systems before being added
+      std::lock_guard<std::mutex> lock(this->pendingSystemsMutex);
+      this->pendingConfigures.push_back({systemConfig, _entity, _sdf});
+      this->pendingSystems.push_back({system.value(), _name,
+          SystemRate(_sdf)});
     }
+    else
+    {
+      if (systemConfig != nullptr)
+      {
+        systemConfig->Configure(_entity, _sdf,
+            this->entityCompMgr,
+            this->eventMgr);
+      }
 
-    this->AddSystem(system.value());
+      this->AddSystem(system.value(), _name, SystemRate(_sdf));
+    }
     igndbg << "Loaded system [" << _name
            << "] for entity [" << _entity << "]" << std::endl;
   }
@@ -1009,6 +2025,34 @@ void SimulationRunner::SetUpdatePeriod(
     const std::chrono::steady_clock::duration &_updatePeriod)
 {
   this->updatePeriod = _updatePeriod;
+  this->UpdateBarrierSpin();
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::UpdateBarrierSpin()
+{
+  if (!this->postUpdateStartBarrier || !this->postUpdateStopBarrier)
+    return;
+
+  // Parking a thread and waking it up again costs tens of microseconds,
+  // which adds up at high step rates. Spin for a fraction of the period
+  // then, so the hand-over to and from the PostUpdate thread is usually
+  // caught while spinning. At lower rates the threads mostly wait for the
+  // step pacing, and spinning would only burn a core.
+  std::chrono::nanoseconds spin{0};
+  if (this->updatePeriod <= std::chrono::steady_clock::duration::zero())
+  {
+    spin = kMaxBarrierSpin;
+  }
+  else if (this->updatePeriod <= kBarrierSpinMaxPeriod)
+  {
+    spin = std::min<std::chrono::nanoseconds>(kMaxBarrierSpin,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+        this->updatePeriod) / 10);
+  }
+
+  this->postUpdateStartBarrier->SetSpinDuration(spin);
+  this->postUpdateStopBarrier->SetSpinDuration(spin);
 }
 
 /////////////////////////////////////////////////
@@ -1099,6 +2143,7 @@ bool SimulationRunner::OnPlaybackControl(const msgs::LogPlaybackControl &_req,
 void SimulationRunner::ProcessMessages()
 {
   IGN_PROFILE("SimulationRunner::ProcessMessages");
+  IGN_GAZEBO_TRACE("SimulationRunner::ProcessMessages");
   std::lock_guard<std::mutex> lock(this->msgBufferMutex);
   this->ProcessWorldControl();
 }
@@ -1145,6 +2190,41 @@ const EntityComponentManager &SimulationRunner::EntityCompMgr() const
   return this->entityCompMgr;
 }
 
+/////////////////////////////////////////////////
+EntityComponentManager &SimulationRunner::EntityCompMgr()
+{
+  return this->entityCompMgr;
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::Snapshot(msgs::SerializedStateMap &_snapshot) const
+{
+  _snapshot.Clear();
+  this->entityCompMgr.State(_snapshot, {}, {}, true);
+  this->StampSnapshot(_snapshot);
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::StampSnapshot(
+    msgs::SerializedStateMap &_snapshot) const
+{
+  auto header = _snapshot.mutable_header();
+  header->Clear();
+  header->mutable_stamp()->CopyFrom(
+      convert<msgs::Time>(this->currentInfo.simTime));
+  auto data = header->add_data();
+  data->set_key("iteration");
+  data->add_value(std::to_string(this->currentInfo.iterations));
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::Restore(const msgs::SerializedStateMap &_snapshot)
+{
+  std::lock_guard<std::mutex> lock(this->restoreMutex);
+  this->requestedRestore =
+      std::make_unique<msgs::SerializedStateMap>(_snapshot);
+}
+
 /////////////////////////////////////////////////
 EventManager &SimulationRunner::EventMgr()
 {
@@ -1257,20 +2337,225 @@ bool SimulationRunner::GuiInfoService(ignition::msgs::GUI &_res)
 }
 
 //////////////////////////////////////////////////
+bool SimulationRunner::TraceDumpService(const msgs::StringMsg &_req,
+    msgs::StringMsg &_res)
+{
+  std::string path = _req.data();
+  if (path.empty())
+  {
+    auto now = std::chrono::system_clock::now();
+    path = common::joinPaths(common::cwd(), "ign_gazebo_trace_" +
+        std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+        now.time_since_epoch()).count()) + ".json");
+  }
+
+  if (!Tracer::WriteChromeTrace(path))
+  {
+    ignerr << "Failed to write trace to [" << path << "]" << std::endl;
+    return false;
+  }
+
+  ignmsg << "Wrote trace to [" << path << "]" << std::endl;
+  _res.set_data(path);
+  return true;
+}
+
+/////////////////////////////////////////////////
 bool SimulationRunner::GenerateWorldSdf(const msgs::SdfGeneratorConfig &_req,
                                         msgs::StringMsg &_res)
 {
-  // TODO(addisu) This is not thread-safe. Wait until it is safe to access the
-  // ECM.
+  WorldSdfSnapshot snapshot;
+  if (!this->running)
+  {
+    snapshot = this->TakeWorldSdfSnapshot();
+  }
+  else
+  {
+    // Let the simulation thread take the snapshot between steps
+    std::future<WorldSdfSnapshot> future;
+    {
+      std::lock_guard<std::mutex> lock(this->worldSdfRequestsMutex);
+      this->worldSdfRequests.emplace_back();
+      future = this->worldSdfRequests.back().get_future();
+    }
+    if (future.wait_for(std::chrono::seconds(5)) !=
+        std::future_status::ready)
+    {
+      ignerr << "Timed out waiting for a world snapshot to generate the "
+             << "world SDFormat." << std::endl;
+      return false;
+    }
+    snapshot = future.get();
+  }
+
+  if (!snapshot.valid)
+    return false;
+
+  std::ostringstream out;
+  if (!sdf_generator::generateWorld(out, snapshot.world, snapshot.fuelUriMap,
+        _req))
+  {
+    return false;
+  }
+  _res.set_data(out.str());
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SimulationRunner::SaveWorldSdfService(
+    const msgs::SdfGeneratorConfig &_req, msgs::StringMsg &_res)
+{
+  std::string id;
+  for (const auto &data : _req.header().data())
+  {
+    if (data.key() == "job_id" && data.value_size() > 0)
+      id = data.value(0);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->worldSdfRequestsMutex);
+    if (id.empty())
+      id = "save_world_sdf_" + std::to_string(this->worldSdfJobCount);
+    ++this->worldSdfJobCount;
+
+    // Snapshot on the simulation thread before the next step
+    if (this->running)
+      this->worldSdfJobRequests.emplace_back(id, _req);
+  }
+
+  if (!this->running)
+    this->StartWorldSdfJob(id, _req, this->TakeWorldSdfSnapshot());
+
+  _res.set_data(id);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SimulationRunner::StartWorldSdfJob(const std::string &_id,
+    const msgs::SdfGeneratorConfig &_config, WorldSdfSnapshot _snapshot)
+{
+  std::lock_guard<std::mutex> lock(this->worldSdfJobsMutex);
+
+  // Forget finished jobs
+  this->worldSdfJobs.erase(std::remove_if(this->worldSdfJobs.begin(),
+      this->worldSdfJobs.end(), [](const std::future<void> &_job)
+      {
+        return _job.wait_for(std::chrono::seconds(0)) ==
+            std::future_status::ready;
+      }), this->worldSdfJobs.end());
+
+  this->worldSdfJobs.push_back(std::async(std::launch::async,
+      [this, _id, _config, snapshot = std::move(_snapshot)]
+      {
+        this->RunWorldSdfJob(_id, _config, snapshot);
+      }));
+}
+
+//////////////////////////////////////////////////
+void SimulationRunner::RunWorldSdfJob(const std::string &_id,
+    const msgs::SdfGeneratorConfig &_config,
+    const WorldSdfSnapshot &_snapshot)
+{
+  IGN_PROFILE("SimulationRunner::RunWorldSdfJob");
+
+  auto publish = [&](double _progress, bool _done, bool _success,
+      const std::string &_sdf)
+  {
+    msgs::Param msg;
+    auto &params = *msg.mutable_params();
+
+    msgs::Any id;
+    id.set_type(msgs::Any::STRING);
+    id.set_string_value(_id);
+    params["job_id"] = id;
+
+    msgs::Any progress;
+    progress.set_type(msgs::Any::DOUBLE);
+    progress.set_double_value(_progress);
+    params["progress"] = progress;
+
+    msgs::Any done;
+    done.set_type(msgs::Any::BOOLEAN);
+    done.set_bool_value(_done);
+    params["done"] = done;
+
+    if (_done)
+    {
+      msgs::Any success;
+      success.set_type(msgs::Any::BOOLEAN);
+      success.set_bool_value(_success);
+      params["success"] = success;
+
+      msgs::Any sdf;
+      sdf.set_type(msgs::Any::STRING);
+      sdf.set_string_value(_sdf);
+      params["sdf"] = sdf;
+    }
+    this->worldSdfProgressPub.Publish(msg);
+  };
+
+  if (!_snapshot.valid)
+  {
+    ignerr << "Failed to take a world snapshot for job [" << _id << "]"
+           << std::endl;
+    publish(0.0, true, false, "");
+    return;
+  }
+
+  // Report progress at most every 100 ms
+  publish(0.0, false, false, "");
+  auto lastPublish = std::chrono::steady_clock::now();
+  auto progress = [&](std::size_t _written, std::size_t _total)
+  {
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastPublish < std::chrono::milliseconds(100))
+      return;
+    lastPublish = now;
+    publish(static_cast<double>(_written) / _total, false, false, "");
+  };
+
+  std::ostringstream out;
+  const bool success = sdf_generator::generateWorld(out, _snapshot.world,
+      _snapshot.fuelUriMap, _config, progress);
+  if (!success)
+  {
+    ignerr << "Failed to generate the world SDFormat for job [" << _id
+           << "]" << std::endl;
+  }
+  publish(1.0, true, success, success ? out.str() : "");
+}
+
+//////////////////////////////////////////////////
+SimulationRunner::WorldSdfSnapshot SimulationRunner::TakeWorldSdfSnapshot()
+    const
+{
+  IGN_PROFILE("SimulationRunner::TakeWorldSdfSnapshot");
+  WorldSdfSnapshot snapshot;
   Entity world = this->entityCompMgr.EntityByComponents(components::World());
-  std::optional<std::string> genString = sdf_generator::generateWorld(
-      this->entityCompMgr, world, this->fuelUriMap, _req);
-  if (genString.has_value())
+  snapshot.valid = sdf_generator::snapshotWorld(this->entityCompMgr, world,
+      snapshot.world);
+  snapshot.fuelUriMap = this->fuelUriMap;
+  return snapshot;
+}
+
+//////////////////////////////////////////////////
+void SimulationRunner::ProcessWorldSdfRequests()
+{
+  std::vector<std::promise<WorldSdfSnapshot>> requests;
+  std::vector<std::pair<std::string, msgs::SdfGeneratorConfig>> jobs;
   {
-    _res.set_data(*genString);
-    return true;
+    std::lock_guard<std::mutex> lock(this->worldSdfRequestsMutex);
+    if (this->worldSdfRequests.empty() && this->worldSdfJobRequests.empty())
+      return;
+    requests.swap(this->worldSdfRequests);
+    jobs.swap(this->worldSdfJobRequests);
   }
-  return false;
+
+  auto snapshot = this->TakeWorldSdfSnapshot();
+  for (auto &request : requests)
+    request.set_value(snapshot);
+  for (const auto &job : jobs)
+    this->StartWorldSdfJob(job.first, job.second, snapshot);
 }
 
 //////////////////////////////////////////////////
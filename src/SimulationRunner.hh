@@ -19,14 +19,18 @@
 
 #include <ignition/msgs/gui.pb.h>
 #include <ignition/msgs/log_playback_control.pb.h>
+#include <ignition/msgs/param_v.pb.h>
 #include <ignition/msgs/sdf_generator_config.pb.h>
+#include <ignition/msgs/stringmsg.pb.h>
 
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <future>
 #include <list>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -51,8 +55,14 @@
 #include "ignition/gazebo/Types.hh"
 
 #include "network/NetworkManager.hh"
-#include "LevelManager.hh"
 #include "Barrier.hh"
+#include "Checkpoint.hh"
+#include "LevelManager.hh"
+#include "SdfGenerator.hh"
+#include "SystemRate.hh"
+#include "SystemScheduler.hh"
+#include "TaskPool.hh"
+#include "TimingHistogram.hh"
 
 using namespace std::chrono_literals;
 
@@ -92,12 +102,21 @@ namespace ignition
     class SystemInternal
     {
       /// \brief Constructor
-      public: explicit SystemInternal(SystemPluginPtr _systemPlugin)
+      /// \param[in] _systemPlugin Plugin of the system.
+      /// \param[in] _name Name used to report the system, such as its plugin
+      /// name.
+      /// \param[in] _rate Iterations on which the system is updated.
+      public: explicit SystemInternal(SystemPluginPtr _systemPlugin,
+                                      std::string _name = "",
+                                      SystemRate _rate = SystemRate())
               : systemPlugin(std::move(_systemPlugin)),
+                name(std::move(_name)),
+                rate(std::move(_rate)),
                 system(systemPlugin->QueryInterface<System>()),
                 preupdate(systemPlugin->QueryInterface<ISystemPreUpdate>()),
                 update(systemPlugin->QueryInterface<ISystemUpdate>()),
-                postupdate(systemPlugin->QueryInterface<ISystemPostUpdate>())
+                postupdate(systemPlugin->QueryInterface<ISystemPostUpdate>()),
+                access(systemPlugin->QueryInterface<ISystemAccess>())
       {
       }
 
@@ -105,6 +124,12 @@ namespace ignition
       /// class as well as the shared library.
       public: SystemPluginPtr systemPlugin;
 
+      /// \brief Name used to report the system, may be empty.
+      public: std::string name;
+
+      /// \brief Iterations on which the system is updated.
+      public: SystemRate rate;
+
       /// \brief Access this system via the `System` interface
       public: System *system = nullptr;
 
@@ -120,6 +145,10 @@ namespace ignition
       /// Will be nullptr if the System doesn't implement this interface.
       public: ISystemPostUpdate *postupdate = nullptr;
 
+      /// \brief Access this system via the ISystemAccess interface
+      /// Will be nullptr if the System doesn't implement this interface.
+      public: ISystemAccess *access = nullptr;
+
       /// \brief Vector of queries and callbacks
       public: std::vector<EntityQueryCallback> updates;
     };
@@ -130,9 +159,20 @@ namespace ignition
       /// \param[in] _world Pointer to the SDF world.
       /// \param[in] _systemLoader Reference to system manager.
       /// \param[in] _useLevels Whether to use levles or not. False by default.
+      /// \param[in] _taskPool Pool to run parallel work on, which must
+      /// outlive the runner. It can be shared with other runners. If null,
+      /// the runner creates its own, see CreateTaskPool.
       public: explicit SimulationRunner(const sdf::World *_world,
                                 const SystemLoaderPtr &_systemLoader,
-                                const ServerConfig &_config = ServerConfig());
+                                const ServerConfig &_config = ServerConfig(),
+                                TaskPool *_taskPool = nullptr);
+
+      /// \brief Create a pool sized by ServerConfig::ThreadCount, counting
+      /// the thread which submits work.
+      /// \param[in] _config Server configuration.
+      /// \return The new pool.
+      public: static std::unique_ptr<TaskPool> CreateTaskPool(
+                  const ServerConfig &_config);
 
       /// \brief Destructor.
       public: virtual ~SimulationRunner();
@@ -143,33 +183,110 @@ namespace ignition
       /// \brief Internal method for handling stop event (to prevent recursion)
       private: void OnStop();
 
-      /// \brief Stop and join all post update worker threads
-      private: void StopWorkerThreads();
-
       /// \brief Run the simulationrunner.
       /// \param[in] _iterations Number of iterations.
       /// \return True if the operation completed successfully.
       public: bool Run(const uint64_t _iterations);
 
+      /// \brief Prepare the runner to be stepped by RunIteration, from the
+      /// calling thread. Run does this itself, it's only needed to drive the
+      /// runner from outside, such as in lockstep with other runners.
+      public: void StartRun();
+
+      /// \brief Run one iteration of the loop of Run, without waiting for
+      /// it to be due, see Pace.
+      /// \param[in] _batched True if more iterations of the same batch
+      /// follow this one. Message processing, statistics and physics
+      /// parameter updates are then deferred to the last iteration of the
+      /// batch. Iterations of a multi-step request are always batched. Run
+      /// doesn't batch its iterations, so that world control requests and
+      /// statistics are handled while it runs.
+      /// \return Number of iterations to count towards the iterations
+      /// requested from Run.
+      public: uint64_t RunIteration(const bool _batched = false);
+
+      /// \brief Finish the last iteration and leave the running state. Run
+      /// does this itself, it's the counterpart of StartRun.
+      public: void StopRun();
+
       /// \brief Perform a simulation step:
       /// * Publish stats and process control messages
       /// * Update levels and systems
       /// * Process entity creation / removal
+      /// When PostUpdate is pipelined, the last part of the step is deferred
+      /// until its PostUpdate is done, see WaitForPostUpdate.
       /// \param[in] _info Time information for the step.
       public: void Step(const UpdateInfo &_info);
 
+      /// \brief Wait for a PostUpdate running in the background to finish,
+      /// then finish its step. Does nothing if there's no such PostUpdate.
+      public: void WaitForPostUpdate();
+
       /// \brief Add system after the simulation runner has been instantiated
       /// \note This actually adds system to a queue. The system is added to the
       /// runner at the begining of the a simulation cycle (call to Run)
       /// \param[in] _system System to be added
-      public: void AddSystem(const SystemPluginPtr &_system);
+      /// \param[in] _name Name used to report the system, such as in the
+      /// system statistics.
+      /// \param[in] _rate Iterations on which the system is updated, every
+      /// iteration by default.
+      public: void AddSystem(const SystemPluginPtr &_system,
+                             const std::string &_name = "",
+                             const SystemRate &_rate = SystemRate());
 
       /// \brief Update all the systems
       public: void UpdateSystems();
 
+      /// \brief Run the PostUpdate of all systems on the task pool.
+      /// \param[in] _info Time information for the step.
+      private: void RunPostUpdate(const UpdateInfo &_info);
+
+      /// \brief Finish a step after its PostUpdate: notify observers,
+      /// process control messages and entity creation / removal.
+      /// \param[in] _updateEnd When the systems of the step were done.
+      private: void FinishStep(
+                   const std::chrono::steady_clock::time_point &_updateEnd);
+
+      /// \brief Report the step if its systems took longer than
+      /// ServerConfig::SlowStepThreshold.
+      /// \param[in] _duration Time taken by the systems of the step.
+      private: void CheckSlowStep(
+                   const std::chrono::steady_clock::duration &_duration);
+
+      /// \brief Open the checkpoint file of the world, and request a
+      /// restore from it if ServerConfig::CheckpointResume is set.
+      private: void InitCheckpoints();
+
+      /// \brief Track the entities which changed during the step, and
+      /// queue a checkpoint of them if one is due.
+      private: void UpdateCheckpoint();
+
+      /// \brief Set the header of a snapshot to the current simulation time
+      /// and iteration count.
+      /// \param[out] _snapshot Snapshot.
+      private: void StampSnapshot(msgs::SerializedStateMap &_snapshot) const;
+
       /// \brief Publish current world statistics.
       public: void PublishStats();
 
+      /// \brief Wait until the next step is due, according to the update
+      /// period, and record how late it starts.
+      public: void Pace();
+
+      /// \brief Publish the timing statistics of each system and of the
+      /// level manager, then reset them. This is throttled to once per
+      /// second of real time.
+      private: void PublishSystemStats();
+
+      /// \brief Publish the telemetry of the peers of a distributed
+      /// simulation. This is throttled to once per second of real time.
+      private: void PublishNetworkStats();
+
+      /// \brief Publish the memory usage of the entity component manager,
+      /// see EntityComponentManager::MemoryUsage. This is throttled to once
+      /// every 5 seconds of real time, and skipped when nobody subscribes.
+      private: void PublishMemoryStats();
+
       /// \brief Load system plugin for a given entity.
       /// \param[in] _entity Entity
       /// \param[in] _fname Filename of the plugin library
@@ -232,6 +349,10 @@ namespace ignition
       /// \return The update period.
       public: const std::chrono::steady_clock::duration &UpdatePeriod() const;
 
+      /// \brief Set how long the PostUpdate hand-over barriers spin before
+      /// parking, based on the update period.
+      private: void UpdateBarrierSpin();
+
       /// \brief Set the paused state.
       /// \param[in] _paused True to pause the simulation runner.
       public: void SetPaused(const bool _paused);
@@ -244,6 +365,30 @@ namespace ignition
       /// \return Reference to the entity component manager.
       public: const EntityComponentManager &EntityCompMgr() const;
 
+      /// \brief Get the mutable EntityComponentManager. It must only be
+      /// modified while the runner isn't running.
+      /// \return Reference to the entity component manager.
+      public: EntityComponentManager &EntityCompMgr();
+
+      /// \brief Capture the full state of the world in memory. The header
+      /// stamp holds the simulation time, and the header data holds the
+      /// iteration count with the key "iteration".
+      /// \param[out] _snapshot Message to be populated.
+      public: void Snapshot(msgs::SerializedStateMap &_snapshot) const;
+
+      /// \brief Get the telemetry of this peer and the peers it discovered,
+      /// if this runner is part of a distributed simulation.
+      /// \param[out] _stats Message populated with one parameter per peer.
+      /// \return False if this runner isn't part of a distributed
+      /// simulation.
+      public: bool NetworkStats(msgs::Param_V &_stats) const;
+
+      /// \brief Restore a state captured by Snapshot(). The state is applied
+      /// right before the next iteration, so this can be called while the
+      /// runner is running.
+      /// \param[in] _snapshot State to restore.
+      public: void Restore(const msgs::SerializedStateMap &_snapshot);
+
       /// \brief Return an entity with the provided name.
       /// \details If multiple entities with the same name exist, the first
       /// entity found will be returned.
@@ -327,6 +472,9 @@ namespace ignition
       /// \return True if successful.
       private: bool GuiInfoService(ignition::msgs::GUI &_res);
 
+      /// \brief Apply a state requested with Restore(), if any.
+      private: void ApplyRequestedRestore();
+
       /// \brief Calculate real time factor and populate currentInfo.
       private: void UpdateCurrentInfo();
 
@@ -339,13 +487,21 @@ namespace ignition
 
       /// \brief Actually add system to the runner
       /// \param[in] _system System to be added
-      public: void AddSystemToRunner(const SystemPluginPtr &_system);
+      /// \param[in] _name Name used to report the system.
+      /// \param[in] _rate Iterations on which the system is updated.
+      public: void AddSystemToRunner(const SystemPluginPtr &_system,
+                                     const std::string &_name = "",
+                                     const SystemRate &_rate = SystemRate());
 
       /// \brief Calls AddSystemToRunner to each system that is pending to be
-      /// added.
+      /// added. Systems which opted into ISystemConfigureParallel are
+      /// configured concurrently first.
       public: void ProcessSystemQueue();
 
-      /// \brief Generate the current world's SDFormat representation.
+      /// \brief Generate the current world's SDFormat representation. While
+      /// the simulation is running, only a snapshot of the world is taken on
+      /// the simulation thread, and the SDFormat is generated on the calling
+      /// thread, so saving a large world doesn't stall the simulation.
       /// \param[in] _req Request message with options for saving a world to an
       /// SDFormat file.
       /// \param[out] _res Generated SDFormat string.
@@ -353,6 +509,71 @@ namespace ignition
       public: bool GenerateWorldSdf(const msgs::SdfGeneratorConfig &_req,
                                     msgs::StringMsg &_res);
 
+      /// \brief Start generating the current world's SDFormat as a
+      /// background job, and return right away. A snapshot of the world is
+      /// taken on the simulation thread before the next step. The job
+      /// publishes its progress on the "save_world_sdf/progress" topic, see
+      /// RunWorldSdfJob.
+      /// \param[in] _req Options for saving the world. A "job_id" key in the
+      /// header identifies the job's progress messages, one is generated if
+      /// missing.
+      /// \param[out] _res ID of the job.
+      /// \return True if the job was queued.
+      public: bool SaveWorldSdfService(const msgs::SdfGeneratorConfig &_req,
+                                       msgs::StringMsg &_res);
+
+      /// \brief Service to write the trace events recorded so far to a
+      /// file, in the Chrome trace event format. See
+      /// ServerConfig::SetTraceEventsPerThread.
+      /// \param[in] _req Path of the file. If empty, a file named after the
+      /// current time is written to the working directory.
+      /// \param[out] _res Path of the written file.
+      /// \return True if the file was written.
+      public: bool TraceDumpService(const msgs::StringMsg &_req,
+                                    msgs::StringMsg &_res);
+
+      /// \brief What's needed to generate the world's SDFormat without
+      /// accessing the runner.
+      private: struct WorldSdfSnapshot
+      {
+        /// \brief Snapshot of the world.
+        sdf_generator::WorldSnapshot world;
+
+        /// \brief Copy of the file path to Fuel URI map.
+        sdf_generator::IncludeUriMap fuelUriMap;
+
+        /// \brief False if the world couldn't be found.
+        bool valid{false};
+      };
+
+      /// \brief Take a snapshot of the world for GenerateWorldSdf. It must be
+      /// called on the simulation thread, or while the simulation isn't
+      /// running.
+      /// \return The snapshot.
+      private: WorldSdfSnapshot TakeWorldSdfSnapshot() const;
+
+      /// \brief Fulfill the world snapshot requests made by GenerateWorldSdf
+      /// and SaveWorldSdfService since the last step.
+      private: void ProcessWorldSdfRequests();
+
+      /// \brief Start a world SDFormat generation job on its own thread.
+      /// \param[in] _id ID of the job.
+      /// \param[in] _config Options for saving the world.
+      /// \param[in] _snapshot Snapshot of the world.
+      private: void StartWorldSdfJob(const std::string &_id,
+                   const msgs::SdfGeneratorConfig &_config,
+                   WorldSdfSnapshot _snapshot);
+
+      /// \brief Generate the world's SDFormat, publishing msgs::Param
+      /// messages with the parameters "job_id", "progress" from 0 to 1,
+      /// "done", and, once done, "success" and "sdf".
+      /// \param[in] _id ID of the job.
+      /// \param[in] _config Options for saving the world.
+      /// \param[in] _snapshot Snapshot of the world.
+      private: void RunWorldSdfJob(const std::string &_id,
+                   const msgs::SdfGeneratorConfig &_config,
+                   const WorldSdfSnapshot &_snapshot);
+
       /// \brief Sets the file path to fuel URI map.
       /// \param[in] _map A populated map of file paths to fuel URIs.
       public: void SetFuelUriMap(
@@ -386,10 +607,40 @@ namespace ignition
       /// \brief All the systems.
       private: std::vector<SystemInternal> systems;
 
+      /// \brief A system waiting to be added to systems.
+      private: struct PendingSystem
+      {
+        /// \brief Plugin of the system.
+        SystemPluginPtr system;
+
+        /// \brief Name used to report the system.
+        std::string name;
+
+        /// \brief Iterations on which the system is updated.
+        SystemRate rate;
+      };
+
       /// \brief Pending systems to be added to systems.
-      private: std::vector<SystemPluginPtr> pendingSystems;
+      private: std::vector<PendingSystem> pendingSystems;
+
+      /// \brief A system whose Configure is deferred until it's added to the
+      /// runner, see ISystemConfigureParallel.
+      private: struct PendingConfigure
+      {
+        /// \brief Interface to configure the system through.
+        ISystemConfigure *system;
+
+        /// \brief Entity the system is attached to.
+        Entity entity;
+
+        /// \brief SDF element of the plugin.
+        sdf::ElementPtr sdf;
+      };
 
-      /// \brief Mutex to protect pendingSystems
+      /// \brief Systems in pendingSystems which still need to be configured.
+      private: std::vector<PendingConfigure> pendingConfigures;
+
+      /// \brief Mutex to protect pendingSystems and pendingConfigures
       private: mutable std::mutex pendingSystemsMutex;
 
       /// \brief Systems implementing Configure
@@ -401,9 +652,68 @@ namespace ignition
       /// \brief Systems implementing Update
       private: std::vector<ISystemUpdate *> systemsUpdate;
 
+      /// \brief Access interface of each system in systemsPreupdate, or
+      /// nullptr for systems which don't implement it.
+      private: std::vector<ISystemAccess *> systemsPreupdateAccess;
+
+      /// \brief Access interface of each system in systemsUpdate, or
+      /// nullptr for systems which don't implement it.
+      private: std::vector<ISystemAccess *> systemsUpdateAccess;
+
+      /// \brief Groups PreUpdate systems which can run concurrently.
+      private: SystemScheduler preupdateScheduler;
+
+      /// \brief Groups Update systems which can run concurrently.
+      private: SystemScheduler updateScheduler;
+
       /// \brief Systems implementing PostUpdate
       private: std::vector<ISystemPostUpdate *> systemsPostupdate;
 
+      /// \brief Time taken by each system in systemsPreupdate.
+      private: std::vector<TimingHistogram> systemsPreupdateTimes;
+
+      /// \brief Time taken by each system in systemsUpdate.
+      private: std::vector<TimingHistogram> systemsUpdateTimes;
+
+      /// \brief Time taken by each system in systemsPostupdate.
+      private: std::vector<TimingHistogram> systemsPostupdateTimes;
+
+      /// \brief Time taken to update the state of the levels, at the start
+      /// of each step.
+      private: TimingHistogram levelsTimes;
+
+      /// \brief Trace event name ID of each system in systemsPreupdate.
+      private: std::vector<uint32_t> systemsPreupdateTraceIds;
+
+      /// \brief Trace event name ID of each system in systemsUpdate.
+      private: std::vector<uint32_t> systemsUpdateTraceIds;
+
+      /// \brief Trace event name ID of each system in systemsPostupdate.
+      private: std::vector<uint32_t> systemsPostupdateTraceIds;
+
+      /// \brief Index in systems of each system in systemsPreupdate, to
+      /// find its rate.
+      private: std::vector<std::size_t> systemsPreupdateIndex;
+
+      /// \brief Index in systems of each system in systemsUpdate.
+      private: std::vector<std::size_t> systemsUpdateIndex;
+
+      /// \brief Index in systems of each system in systemsPostupdate.
+      private: std::vector<std::size_t> systemsPostupdateIndex;
+
+      /// \brief When the world statistics and clock were last published
+      /// while running as fast as possible.
+      private: std::chrono::steady_clock::time_point statsPubTime;
+
+      /// \brief When the system statistics were last published.
+      private: std::chrono::steady_clock::time_point systemStatsPubTime;
+
+      /// \brief When the network statistics were last published.
+      private: std::chrono::steady_clock::time_point networkStatsPubTime;
+
+      /// \brief When the memory statistics were last published.
+      private: std::chrono::steady_clock::time_point memoryStatsPubTime;
+
       /// \brief Manager of all events.
       private: EventManager eventMgr;
 
@@ -426,6 +736,21 @@ namespace ignition
       /// sleep durations.
       private: std::chrono::steady_clock::duration sleepOffset{0};
 
+      /// \brief How far from the update period each step started, over
+      /// the current window of one second.
+      private: TimingHistogram stepJitter;
+
+      /// \brief When the current step jitter window started.
+      private: std::chrono::steady_clock::time_point stepJitterStart;
+
+      /// \brief Step jitter of the previous window, reported with the world
+      /// statistics.
+      private: TimingHistogram prevStepJitter;
+
+      /// \brief Last thread which Run applied the real-time priority and CPU
+      /// affinity of the server configuration to.
+      private: std::thread::id scheduledThread;
+
       /// \brief This is the rate at which the systems are updated.
       /// The default update rate is 500hz, which is a period of 2ms.
       private: std::chrono::steady_clock::duration updatePeriod{2ms};
@@ -457,6 +782,36 @@ namespace ignition
       /// \brief Clock publisher for the root `/clock` topic.
       private: ignition::transport::Node::Publisher rootClockPub;
 
+      /// \brief System statistics publisher.
+      private: ignition::transport::Node::Publisher systemStatsPub;
+
+      /// \brief Network peer statistics publisher.
+      private: ignition::transport::Node::Publisher networkStatsPub;
+
+      /// \brief Memory statistics publisher.
+      private: ignition::transport::Node::Publisher memoryStatsPub;
+
+      /// \brief Publisher of slow step diagnostics.
+      private: ignition::transport::Node::Publisher slowStepPub;
+
+      /// \brief When a slow step was last warned about.
+      private: std::chrono::steady_clock::time_point slowStepWarningTime;
+
+      /// \brief Number of slow steps since the last warning.
+      private: uint64_t slowStepsSinceWarning{0};
+
+      /// \brief Writes the checkpoints, null if they're disabled.
+      private: std::unique_ptr<Checkpoint> checkpoint;
+
+      /// \brief Entities which changed since the last checkpoint.
+      private: std::unordered_set<Entity> checkpointEntities;
+
+      /// \brief Whether the next checkpoint holds all entities.
+      private: bool checkpointFull{true};
+
+      /// \brief Sim time of the last checkpoint.
+      private: std::chrono::steady_clock::duration lastCheckpointTime{0};
+
       /// \brief Name of world being simulated.
       private: std::string worldName;
 
@@ -496,6 +851,17 @@ namespace ignition
       /// time.s A negative value means there's no request from the user.
       private: std::chrono::steady_clock::duration requestedSeek{-1};
 
+      /// \brief True while stepping an iteration which isn't the last one
+      /// of a batch, see RunIteration.
+      private: bool batchedStep{false};
+
+      /// \brief State requested to be restored before the next iteration.
+      /// Null means there's no request.
+      private: std::unique_ptr<msgs::SerializedStateMap> requestedRestore;
+
+      /// \brief Mutex to protect requestedRestore.
+      private: std::mutex restoreMutex;
+
       /// \brief Keeps the latest simulation info.
       private: UpdateInfo currentInfo;
 
@@ -511,21 +877,64 @@ namespace ignition
       /// \brief Copy of the server configuration.
       public: ServerConfig serverConfig;
 
-      /// \brief Collection of threads running system PostUpdates
-      private: std::vector<std::thread> postUpdateThreads;
+      /// \brief Pool of worker threads which run system PostUpdates, and
+      /// other parallel work of the entity component manager. It may be
+      /// shared with other runners.
+      private: TaskPool *taskPool{nullptr};
+
+      /// \brief Pool created by this runner, if none was given.
+      private: std::unique_ptr<TaskPool> ownTaskPool;
 
-      /// \brief Flag to indicate running status of PostUpdate threads
-      private: std::atomic<bool> postUpdateThreadsRunning{false};
+      /// \brief Thread which runs PostUpdate in the background, while the
+      /// simulation thread prepares the next step. Only started if
+      /// ServerConfig::PipelinedPostUpdate is set.
+      private: std::thread postUpdateThread;
 
-      /// \brief Barrier to signal beginning of PostUpdate thread execution
+      /// \brief Barrier which releases the PostUpdate thread.
       private: std::unique_ptr<Barrier> postUpdateStartBarrier;
 
-      /// \brief Barrier to signal end of PostUpdate thread execution
+      /// \brief Barrier which the simulation thread waits on for the
+      /// PostUpdate thread to be done.
       private: std::unique_ptr<Barrier> postUpdateStopBarrier;
 
+      /// \brief True while a PostUpdate runs in the background, and its step
+      /// hasn't been finished.
+      private: bool postUpdatePending{false};
+
+      /// \brief When the last PostUpdate run in the background was done.
+      private: std::chrono::steady_clock::time_point postUpdateEndTime;
+
+      /// \brief Copy of the time information of the step whose PostUpdate
+      /// runs in the background, since currentInfo moves on to the next step.
+      private: UpdateInfo postUpdateInfo;
+
       /// \brief Map from file paths to Fuel URIs.
       private: std::unordered_map<std::string, std::string> fuelUriMap;
 
+      /// \brief Pending world snapshot requests of GenerateWorldSdf.
+      private: std::vector<std::promise<WorldSdfSnapshot>> worldSdfRequests;
+
+      /// \brief Pending world SDFormat jobs of SaveWorldSdfService, waiting
+      /// for a snapshot, by ID.
+      private: std::vector<std::pair<std::string, msgs::SdfGeneratorConfig>>
+                   worldSdfJobRequests;
+
+      /// \brief Number of jobs requested, used to generate job IDs.
+      private: uint64_t worldSdfJobCount{0};
+
+      /// \brief Mutex to protect worldSdfRequests, worldSdfJobRequests and
+      /// worldSdfJobCount.
+      private: std::mutex worldSdfRequestsMutex;
+
+      /// \brief Running world SDFormat jobs.
+      private: std::vector<std::future<void>> worldSdfJobs;
+
+      /// \brief Mutex to protect worldSdfJobs.
+      private: std::mutex worldSdfJobsMutex;
+
+      /// \brief Publisher of the progress of world SDFormat jobs.
+      private: transport::Node::Publisher worldSdfProgressPub;
+
       /// \brief True if Server::RunOnce triggered a blocking paused step
       private: bool blockingPausedStepPending{false};
 
@@ -19,6 +19,9 @@
 #include <tinyxml2.h>
 
 #include <ignition/common/Console.hh>
+#include <ignition/msgs/boolean.pb.h>
+#include <ignition/msgs/param_v.pb.h>
+#include <ignition/msgs/world_control.pb.h>
 #include <ignition/transport/Node.hh>
 #include <sdf/Box.hh>
 #include <sdf/Cylinder.hh>
@@ -1443,6 +1446,322 @@ TEST_P(SimulationRunnerTest, GenerateWorldSdf)
   EXPECT_EQ(3u, world->ModelCount());
 }
 
+/////////////////////////////////////////////////
+TEST_P(SimulationRunnerTest, SaveWorldSdf)
+{
+  // Load SDF file
+  sdf::Root root;
+  root.Load(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "shapes.sdf"));
+
+  ASSERT_EQ(1u, root.WorldCount());
+
+  std::mutex mutex;
+  std::vector<msgs::Param> progress;
+  std::function<void(const msgs::Param &)> cb =
+      [&](const msgs::Param &_msg)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        progress.push_back(_msg);
+      };
+
+  transport::Node node;
+  node.Subscribe("/world/default/save_world_sdf/progress", cb);
+
+  // Create simulation runner
+  auto systemLoader = std::make_shared<SystemLoader>();
+  SimulationRunner runner(root.WorldByIndex(0), systemLoader);
+
+  // The job starts right away, since the simulation isn't running
+  msgs::SdfGeneratorConfig req;
+  auto *jobId = req.mutable_header()->add_data();
+  jobId->set_key("job_id");
+  jobId->add_value("test_job");
+  msgs::StringMsg res;
+  EXPECT_TRUE(runner.SaveWorldSdfService(req, res));
+  EXPECT_EQ("test_job", res.data());
+
+  auto done = [&]()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !progress.empty() &&
+        progress.back().params().at("done").bool_value();
+  };
+  int sleep = 0;
+  while (!done() && sleep++ < 100)
+    std::this_thread::sleep_for(10ms);
+  ASSERT_TRUE(done());
+
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto &params = progress.back().params();
+  EXPECT_EQ("test_job", params.at("job_id").string_value());
+  EXPECT_DOUBLE_EQ(1.0, params.at("progress").double_value());
+  EXPECT_TRUE(params.at("success").bool_value());
+
+  sdf::Root newRoot;
+  newRoot.LoadSdfString(params.at("sdf").string_value());
+  ASSERT_EQ(1u, newRoot.WorldCount());
+  EXPECT_EQ(3u, newRoot.WorldByIndex(0)->ModelCount());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SimulationRunnerTest, BatchedRun)
+{
+  // Load SDF file
+  sdf::Root root;
+  root.Load(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "shapes.sdf"));
+
+  ASSERT_EQ(1u, root.WorldCount());
+
+  std::mutex mutex;
+  std::vector<msgs::Clock> clocks;
+  std::function<void(const msgs::Clock &)> cb =
+      [&](const msgs::Clock &_msg)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        clocks.push_back(_msg);
+      };
+
+  transport::Node node;
+  node.Subscribe("/world/default/clock", cb);
+
+  // Create simulation runner
+  auto systemLoader = std::make_shared<SystemLoader>();
+  SimulationRunner runner(root.WorldByIndex(0), systemLoader);
+  runner.SetPaused(false);
+
+  // Wait for the subscriber to be discovered
+  auto received = [&]()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return clocks.size();
+  };
+  int sleep = 0;
+  while (received() == 0u && sleep++ < 100)
+  {
+    EXPECT_TRUE(runner.Run(1));
+    std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_LT(0u, received());
+
+  // Runs of a number of iterations aren't batched, so the clock is
+  // published on every iteration
+  auto iterations = runner.CurrentInfo().iterations;
+  auto before = received();
+  EXPECT_TRUE(runner.Run(5));
+  EXPECT_EQ(iterations + 5, runner.CurrentInfo().iterations);
+
+  sleep = 0;
+  while (received() < before + 5 && sleep++ < 100)
+    std::this_thread::sleep_for(10ms);
+  EXPECT_EQ(before + 5, received());
+
+  // All iterations of a multi-step request step the systems, but the clock
+  // is only published by the iteration which handles the request and by
+  // the last one of the batch
+  runner.SetPaused(true);
+  msgs::WorldControl req;
+  req.set_multi_step(50);
+  msgs::Boolean rep;
+  bool result{false};
+  EXPECT_TRUE(node.Request("/world/default/control", req, 1000, rep,
+      result));
+  EXPECT_TRUE(result);
+
+  iterations = runner.CurrentInfo().iterations;
+  before = received();
+  EXPECT_TRUE(runner.Run(50));
+  EXPECT_EQ(iterations + 50, runner.CurrentInfo().iterations);
+  EXPECT_TRUE(runner.Paused());
+
+  std::this_thread::sleep_for(200ms);
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_LE(before + 1, clocks.size());
+  EXPECT_GE(before + 3, clocks.size());
+  auto simTime = math::durationToSecNsec(runner.CurrentInfo().simTime);
+  EXPECT_EQ(simTime.first, clocks.back().sim().sec());
+  EXPECT_EQ(simTime.second, clocks.back().sim().nsec());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SimulationRunnerTest, SystemStats)
+{
+  // Load SDF file
+  sdf::Root root;
+  root.Load(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "plugins.sdf"));
+
+  ASSERT_EQ(1u, root.WorldCount());
+
+  std::mutex mutex;
+  std::vector<msgs::Param_V> statsMsgs;
+  std::function<void(const msgs::Param_V &)> statsCb =
+      [&](const msgs::Param_V &_msg)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        statsMsgs.push_back(_msg);
+      };
+
+  transport::Node node;
+  node.Subscribe("/world/default/stats/systems", statsCb);
+
+  // Create simulation runner
+  auto systemLoader = std::make_shared<SystemLoader>();
+  SimulationRunner runner(root.WorldByIndex(0), systemLoader);
+  runner.SetPaused(false);
+
+  // Statistics are published on the last step of a run, at most once per
+  // second, and cover the steps since the previous message.
+  EXPECT_TRUE(runner.Run(2));
+  std::this_thread::sleep_for(1100ms);
+  EXPECT_TRUE(runner.Run(2));
+
+  int sleep = 0;
+  while (sleep++ < 100)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (statsMsgs.size() >= 2u)
+        break;
+    }
+    std::this_thread::sleep_for(10ms);
+  }
+
+  // The first message may be published before the subscriber is discovered
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_FALSE(statsMsgs.empty());
+
+  // The world system only implements Update
+  bool found{false};
+  for (const auto &param : statsMsgs.back().param())
+  {
+    const auto &params = param.params();
+    ASSERT_NE(params.end(), params.find("name"));
+    if (params.at("name").string_value() != "ignition::gazebo::TestWorldSystem")
+      continue;
+
+    found = true;
+    EXPECT_EQ(params.end(), params.find("pre_update_count"));
+    EXPECT_EQ(params.end(), params.find("post_update_count"));
+    ASSERT_NE(params.end(), params.find("update_count"));
+    EXPECT_EQ(2, params.at("update_count").int_value());
+
+    ASSERT_NE(params.end(), params.find("update_max_ms"));
+    ASSERT_NE(params.end(), params.find("update_p99_ms"));
+    ASSERT_NE(params.end(), params.find("update_p50_ms"));
+    ASSERT_NE(params.end(), params.find("update_mean_ms"));
+    EXPECT_GE(params.at("update_max_ms").double_value(),
+        params.at("update_p50_ms").double_value());
+    EXPECT_GE(params.at("update_max_ms").double_value(),
+        params.at("update_mean_ms").double_value());
+  }
+  EXPECT_TRUE(found);
+
+  // The level manager is reported after the systems
+  const auto &levels = statsMsgs.back().param(
+      statsMsgs.back().param_size() - 1).params();
+  ASSERT_NE(levels.end(), levels.find("name"));
+  EXPECT_EQ("LevelManager", levels.at("name").string_value());
+  EXPECT_NE(levels.end(), levels.find("levels_count"));
+  EXPECT_NE(levels.end(), levels.find("levels_max_ms"));
+
+  // See LoadPlugins
+  #if defined (__clang__)
+    for (const auto &name : {"WorldPluginComponent", "ModelPluginComponent",
+        "SensorPluginComponent"})
+    {
+      components::Factory::Instance()->Unregister(
+          ignition::common::hash64(name));
+    }
+  #endif
+}
+
+/////////////////////////////////////////////////
+TEST_P(SimulationRunnerTest, SlowStep)
+{
+  // Load SDF file
+  sdf::Root root;
+  root.Load(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "plugins.sdf"));
+
+  ASSERT_EQ(1u, root.WorldCount());
+
+  std::mutex mutex;
+  std::vector<msgs::Param_V> slowStepMsgs;
+  std::function<void(const msgs::Param_V &)> slowStepCb =
+      [&](const msgs::Param_V &_msg)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        slowStepMsgs.push_back(_msg);
+      };
+
+  transport::Node node;
+  node.Subscribe("/world/default/diagnostics/slow_step", slowStepCb);
+
+  // Every step is over the threshold
+  ServerConfig serverConfig;
+  serverConfig.SetSlowStepThreshold(1ns);
+
+  auto systemLoader = std::make_shared<SystemLoader>();
+  SimulationRunner runner(root.WorldByIndex(0), systemLoader, serverConfig);
+  runner.SetPaused(false);
+
+  // Keep stepping until the subscriber is discovered
+  int sleep = 0;
+  while (sleep++ < 100)
+  {
+    EXPECT_TRUE(runner.Run(1));
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!slowStepMsgs.empty())
+        break;
+    }
+    std::this_thread::sleep_for(10ms);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_FALSE(slowStepMsgs.empty());
+  const auto &msg = slowStepMsgs.back();
+
+  // The step, followed by the slowest systems
+  ASSERT_GE(msg.param_size(), 2);
+  const auto &step = msg.param(0).params();
+  ASSERT_NE(step.end(), step.find("step_ms"));
+  EXPECT_GT(step.at("step_ms").double_value(), 0.0);
+  ASSERT_NE(step.end(), step.find("entity_count"));
+  EXPECT_EQ(static_cast<int>(runner.EntityCompMgr().EntityCount()),
+      step.at("entity_count").int_value());
+  EXPECT_NE(step.end(), step.find("new_entity_count"));
+  EXPECT_NE(step.end(), step.find("removed_entity_count"));
+
+  bool found{false};
+  for (int i = 1; i < msg.param_size(); ++i)
+  {
+    const auto &params = msg.param(i).params();
+    ASSERT_NE(params.end(), params.find("name"));
+    ASSERT_NE(params.end(), params.find("phase"));
+    ASSERT_NE(params.end(), params.find("ms"));
+    if (params.at("name").string_value() ==
+        "ignition::gazebo::TestWorldSystem")
+    {
+      found = true;
+      EXPECT_EQ("update", params.at("phase").string_value());
+    }
+  }
+  EXPECT_TRUE(found);
+
+  // See LoadPlugins
+  #if defined (__clang__)
+    for (const auto &name : {"WorldPluginComponent", "ModelPluginComponent",
+        "SensorPluginComponent"})
+    {
+      components::Factory::Instance()->Unregister(
+          ignition::common::hash64(name));
+    }
+  #endif
+}
+
 // Run multiple times. We want to make sure that static globals don't cause
 // problems.
 INSTANTIATE_TEST_SUITE_P(ServerRepeat, SimulationRunnerTest,
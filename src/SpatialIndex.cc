@@ -0,0 +1,699 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "ignition/gazebo/SpatialIndex.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <ignition/common/Profiler.hh>
+#include <ignition/math/Pose3.hh>
+#include <sdf/Box.hh>
+#include <sdf/Geometry.hh>
+
+#include "ignition/gazebo/components/AxisAlignedBox.hh"
+#include "ignition/gazebo/components/Geometry.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/Performer.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/World.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+namespace
+{
+/// \brief Largest cell coordinate along each axis, so that the coordinates
+/// of a cell fit in 21 bits each.
+constexpr int64_t kMaxCell{(1 << 20) - 1};
+
+/// \brief Boxes covering more cells than this are kept in a list which all
+/// queries test, rather than in every cell they cover.
+constexpr double kMaxEntryCells{64};
+
+/// \brief Inclusive range of grid cells.
+struct CellRange
+{
+  /// \brief Smallest cell coordinates.
+  std::array<int64_t, 3> min;
+
+  /// \brief Largest cell coordinates.
+  std::array<int64_t, 3> max;
+
+  /// \brief Number of cells, as a double so huge ranges don't overflow.
+  /// \return Cell count.
+  double Count() const
+  {
+    return static_cast<double>(this->max[0] - this->min[0] + 1) *
+        static_cast<double>(this->max[1] - this->min[1] + 1) *
+        static_cast<double>(this->max[2] - this->min[2] + 1);
+  }
+
+  /// \brief Equality operator.
+  /// \param[in] _other Range to compare to.
+  /// \return True if equal.
+  bool operator==(const CellRange &_other) const
+  {
+    return this->min == _other.min && this->max == _other.max;
+  }
+};
+
+/// \brief Key of a cell in the grid's hash map.
+/// \param[in] _x X coordinate.
+/// \param[in] _y Y coordinate.
+/// \param[in] _z Z coordinate.
+/// \return Key.
+uint64_t cellKey(int64_t _x, int64_t _y, int64_t _z)
+{
+  return (static_cast<uint64_t>(_x + kMaxCell) << 42) |
+      (static_cast<uint64_t>(_y + kMaxCell) << 21) |
+      static_cast<uint64_t>(_z + kMaxCell);
+}
+}
+
+/// \brief Private SpatialIndex data class.
+class ignition::gazebo::SpatialIndexPrivate
+{
+  /// \brief An indexed entity.
+  public: struct Entry
+  {
+    /// \brief Indexed entity.
+    Entity entity;
+
+    /// \brief Model the performer belongs to, for performers.
+    Entity model;
+
+    /// \brief Smallest corner of the box.
+    math::Vector3d min;
+
+    /// \brief Largest corner of the box.
+    math::Vector3d max;
+
+    /// \brief Cells covered by the box.
+    CellRange cells;
+
+    /// \brief True if the box covers too many cells to be binned.
+    bool large;
+  };
+
+  /// \brief Entities of a layer, binned into cells.
+  public: struct Grid
+  {
+    /// \brief Entries, in no particular order.
+    std::vector<Entry> entries;
+
+    /// \brief Index in entries of each entity.
+    std::unordered_map<Entity, std::size_t> slots;
+
+    /// \brief Entities whose box covers each non-empty cell.
+    std::unordered_map<uint64_t, std::vector<Entity>> cells;
+
+    /// \brief Entities whose box is too large to be binned.
+    std::vector<Entity> large;
+  };
+
+  /// \brief Get the grid of a layer.
+  /// \param[in] _layer Layer.
+  /// \return The layer's grid.
+  public: Grid &LayerGrid(SpatialIndex::Layer _layer);
+
+  /// \brief Get the grid of a layer.
+  /// \param[in] _layer Layer.
+  /// \return The layer's grid.
+  public: const Grid &LayerGrid(SpatialIndex::Layer _layer) const;
+
+  /// \brief Cells covered by a box.
+  /// \param[in] _min Smallest corner.
+  /// \param[in] _max Largest corner.
+  /// \return Range of cells.
+  public: CellRange Cells(const math::Vector3d &_min,
+      const math::Vector3d &_max) const;
+
+  /// \brief Add an entity to its cells, or remove it from them.
+  /// \param[in] _grid Grid of the entry.
+  /// \param[in] _entry Entry.
+  /// \param[in] _add True to add, false to remove.
+  public: void Bin(Grid &_grid, const Entry &_entry, bool _add);
+
+  /// \brief Index an entity, or move it if already indexed.
+  /// \param[in] _grid Grid to index into.
+  /// \param[in] _entity Entity.
+  /// \param[in] _model Model of a performer.
+  /// \param[in] _min Smallest corner of the box.
+  /// \param[in] _max Largest corner of the box.
+  public: void Set(Grid &_grid, Entity _entity, Entity _model,
+      const math::Vector3d &_min, const math::Vector3d &_max);
+
+  /// \brief Remove an entity, if indexed.
+  /// \param[in] _grid Grid to remove from.
+  /// \param[in] _entity Entity.
+  public: void Remove(Grid &_grid, Entity _entity);
+
+  /// \brief Call a function for each entry whose box intersects a box.
+  /// \param[in] _grid Grid to search.
+  /// \param[in] _min Smallest corner of the box.
+  /// \param[in] _max Largest corner of the box.
+  /// \param[in] _f Function receiving each entry once.
+  public: template <typename FunctionT>
+          void Visit(const Grid &_grid, const math::Vector3d &_min,
+          const math::Vector3d &_max, FunctionT _f) const;
+
+  /// \brief Index a top level model, and its performers.
+  /// \param[in] _ecm Entity-component manager.
+  /// \param[in] _model Model entity.
+  public: void SetModel(const EntityComponentManager &_ecm, Entity _model);
+
+  /// \brief Index a performer.
+  /// \param[in] _ecm Entity-component manager.
+  /// \param[in] _performer Performer entity.
+  public: void SetPerformer(const EntityComponentManager &_ecm,
+      Entity _performer);
+
+  /// \brief Remove a performer, if indexed.
+  /// \param[in] _performer Performer entity.
+  public: void RemovePerformer(Entity _performer);
+
+  /// \brief Apply the changes of the current step.
+  /// \param[in] _ecm Entity-component manager.
+  public: void ApplyChanges(const EntityComponentManager &_ecm);
+
+  /// \brief Index everything again. The mutex must be locked.
+  /// \param[in] _ecm Entity-component manager.
+  public: void RebuildLocked(const EntityComponentManager &_ecm);
+
+  /// \brief Size of the grid cells.
+  public: double cellSize{10.0};
+
+  /// \brief Top level models.
+  public: Grid models;
+
+  /// \brief Performers.
+  public: Grid performers;
+
+  /// \brief Performers of each model.
+  public: std::unordered_map<Entity, std::vector<Entity>> modelPerformers;
+
+  /// \brief True once updated for some step.
+  public: bool updated{false};
+
+  /// \brief Iteration of the last update.
+  public: uint64_t iterations{0};
+
+  /// \brief Held exclusively while updating, and shared while querying.
+  public: mutable std::shared_mutex mutex;
+};
+
+//////////////////////////////////////////////////
+SpatialIndexPrivate::Grid &SpatialIndexPrivate::LayerGrid(
+    SpatialIndex::Layer _layer)
+{
+  return _layer == SpatialIndex::Layer::MODELS ? this->models :
+      this->performers;
+}
+
+//////////////////////////////////////////////////
+const SpatialIndexPrivate::Grid &SpatialIndexPrivate::LayerGrid(
+    SpatialIndex::Layer _layer) const
+{
+  return _layer == SpatialIndex::Layer::MODELS ? this->models :
+      this->performers;
+}
+
+//////////////////////////////////////////////////
+CellRange SpatialIndexPrivate::Cells(const math::Vector3d &_min,
+    const math::Vector3d &_max) const
+{
+  auto cell = [this](double _v)
+  {
+    const double c = std::floor(_v / this->cellSize);
+    return static_cast<int64_t>(std::clamp(c,
+        static_cast<double>(-kMaxCell), static_cast<double>(kMaxCell)));
+  };
+  return {{cell(_min.X()), cell(_min.Y()), cell(_min.Z())},
+      {cell(_max.X()), cell(_max.Y()), cell(_max.Z())}};
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::Bin(Grid &_grid, const Entry &_entry, bool _add)
+{
+  auto update = [&](std::vector<Entity> &_entities)
+  {
+    if (_add)
+    {
+      _entities.push_back(_entry.entity);
+      return;
+    }
+    auto it = std::find(_entities.begin(), _entities.end(), _entry.entity);
+    if (it != _entities.end())
+    {
+      *it = _entities.back();
+      _entities.pop_back();
+    }
+  };
+
+  if (_entry.large)
+  {
+    update(_grid.large);
+    return;
+  }
+
+  const auto &cells = _entry.cells;
+  for (auto x = cells.min[0]; x <= cells.max[0]; ++x)
+  {
+    for (auto y = cells.min[1]; y <= cells.max[1]; ++y)
+    {
+      for (auto z = cells.min[2]; z <= cells.max[2]; ++z)
+      {
+        const auto key = cellKey(x, y, z);
+        auto &entities = _grid.cells[key];
+        update(entities);
+        if (entities.empty())
+          _grid.cells.erase(key);
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::Set(Grid &_grid, Entity _entity, Entity _model,
+    const math::Vector3d &_min, const math::Vector3d &_max)
+{
+  const auto cells = this->Cells(_min, _max);
+  const bool large = cells.Count() > kMaxEntryCells;
+
+  auto it = _grid.slots.find(_entity);
+  if (it == _grid.slots.end())
+  {
+    _grid.slots[_entity] = _grid.entries.size();
+    _grid.entries.push_back({_entity, _model, _min, _max, cells, large});
+    this->Bin(_grid, _grid.entries.back(), true);
+    return;
+  }
+
+  // Only rebin if the box moved to other cells
+  auto &entry = _grid.entries[it->second];
+  entry.model = _model;
+  entry.min = _min;
+  entry.max = _max;
+  if (entry.large == large && entry.cells == cells)
+    return;
+
+  this->Bin(_grid, entry, false);
+  entry.cells = cells;
+  entry.large = large;
+  this->Bin(_grid, entry, true);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::Remove(Grid &_grid, Entity _entity)
+{
+  auto it = _grid.slots.find(_entity);
+  if (it == _grid.slots.end())
+    return;
+
+  const auto slot = it->second;
+  this->Bin(_grid, _grid.entries[slot], false);
+  if (slot + 1 != _grid.entries.size())
+  {
+    _grid.entries[slot] = std::move(_grid.entries.back());
+    _grid.slots[_grid.entries[slot].entity] = slot;
+  }
+  _grid.entries.pop_back();
+  _grid.slots.erase(_entity);
+}
+
+//////////////////////////////////////////////////
+template <typename FunctionT>
+void SpatialIndexPrivate::Visit(const Grid &_grid, const math::Vector3d &_min,
+    const math::Vector3d &_max, FunctionT _f) const
+{
+  if (_min.X() > _max.X() || _min.Y() > _max.Y() || _min.Z() > _max.Z())
+    return;
+
+  auto intersects = [&](const Entry &_entry)
+  {
+    return _entry.min.X() <= _max.X() && _entry.max.X() >= _min.X() &&
+        _entry.min.Y() <= _max.Y() && _entry.max.Y() >= _min.Y() &&
+        _entry.min.Z() <= _max.Z() && _entry.max.Z() >= _min.Z();
+  };
+
+  // Large queries are cheaper against every entry
+  const auto range = this->Cells(_min, _max);
+  if (range.Count() > static_cast<double>(_grid.entries.size()))
+  {
+    for (const auto &entry : _grid.entries)
+    {
+      if (intersects(entry))
+        _f(entry);
+    }
+    return;
+  }
+
+  for (auto x = range.min[0]; x <= range.max[0]; ++x)
+  {
+    for (auto y = range.min[1]; y <= range.max[1]; ++y)
+    {
+      for (auto z = range.min[2]; z <= range.max[2]; ++z)
+      {
+        auto it = _grid.cells.find(cellKey(x, y, z));
+        if (it == _grid.cells.end())
+          continue;
+
+        for (const auto entity : it->second)
+        {
+          const auto &entry = _grid.entries[_grid.slots.at(entity)];
+
+          // Entries covering several cells are only visited in the first
+          // cell they share with the query
+          if (x != std::max(entry.cells.min[0], range.min[0]) ||
+              y != std::max(entry.cells.min[1], range.min[1]) ||
+              z != std::max(entry.cells.min[2], range.min[2]))
+          {
+            continue;
+          }
+
+          if (intersects(entry))
+            _f(entry);
+        }
+      }
+    }
+  }
+
+  for (const auto entity : _grid.large)
+  {
+    const auto &entry = _grid.entries[_grid.slots.at(entity)];
+    if (intersects(entry))
+      _f(entry);
+  }
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::SetModel(const EntityComponentManager &_ecm,
+    Entity _model)
+{
+  auto parent = _ecm.Component<components::ParentEntity>(_model);
+  auto pose = _ecm.Component<components::Pose>(_model);
+  if (nullptr == parent || nullptr == pose ||
+      nullptr == _ecm.Component<components::World>(parent->Data()))
+  {
+    return;
+  }
+
+  auto min = pose->Data().Pos();
+  auto max = min;
+  auto box = _ecm.Component<components::AxisAlignedBox>(_model);
+  if (nullptr != box && box->Data().Min().X() <= box->Data().Max().X())
+  {
+    min.Min(box->Data().Min());
+    max.Max(box->Data().Max());
+  }
+  this->Set(this->models, _model, kNullEntity, min, max);
+
+  auto performersIt = this->modelPerformers.find(_model);
+  if (performersIt != this->modelPerformers.end())
+  {
+    // Copied, since setting a performer may drop it from the list
+    const auto modelPerformers = performersIt->second;
+    for (const auto performer : modelPerformers)
+      this->SetPerformer(_ecm, performer);
+  }
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::SetPerformer(const EntityComponentManager &_ecm,
+    Entity _performer)
+{
+  auto parent = _ecm.Component<components::ParentEntity>(_performer);
+  auto geometry = _ecm.Component<components::Geometry>(_performer);
+  auto pose = nullptr == parent ? nullptr :
+      _ecm.Component<components::Pose>(parent->Data());
+  auto box = nullptr == geometry ? nullptr : geometry->Data().BoxShape();
+  if (nullptr == pose || nullptr == box)
+  {
+    this->RemovePerformer(_performer);
+    return;
+  }
+
+  const auto &pos = pose->Data().Pos();
+  this->Set(this->performers, _performer, parent->Data(),
+      pos - box->Size() / 2, pos + box->Size() / 2);
+
+  auto &modelPerformers = this->modelPerformers[parent->Data()];
+  if (std::find(modelPerformers.begin(), modelPerformers.end(), _performer) ==
+      modelPerformers.end())
+  {
+    modelPerformers.push_back(_performer);
+  }
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::RemovePerformer(Entity _performer)
+{
+  auto it = this->performers.slots.find(_performer);
+  if (it == this->performers.slots.end())
+    return;
+
+  const auto model = this->performers.entries[it->second].model;
+  auto modelIt = this->modelPerformers.find(model);
+  if (modelIt != this->modelPerformers.end())
+  {
+    auto &modelPerformers = modelIt->second;
+    modelPerformers.erase(std::remove(modelPerformers.begin(),
+        modelPerformers.end(), _performer), modelPerformers.end());
+    if (modelPerformers.empty())
+      this->modelPerformers.erase(modelIt);
+  }
+  this->Remove(this->performers, _performer);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::ApplyChanges(const EntityComponentManager &_ecm)
+{
+  if (_ecm.HasEntitiesMarkedForRemoval())
+  {
+    _ecm.EachRemoved<components::Performer>(
+        [&](const Entity &_entity, const components::Performer *) -> bool
+        {
+          this->RemovePerformer(_entity);
+          return true;
+        });
+    _ecm.EachRemoved<components::Model>(
+        [&](const Entity &_entity, const components::Model *) -> bool
+        {
+          this->Remove(this->models, _entity);
+          return true;
+        });
+  }
+
+  if (_ecm.HasNewEntities())
+  {
+    _ecm.EachNew<components::Model>(
+        [&](const Entity &_entity, const components::Model *) -> bool
+        {
+          this->SetModel(_ecm, _entity);
+          return true;
+        });
+    _ecm.EachNew<components::Performer>(
+        [&](const Entity &_entity, const components::Performer *) -> bool
+        {
+          this->SetPerformer(_ecm, _entity);
+          return true;
+        });
+  }
+
+  // Only indexed models move their boxes
+  auto refresh = [&](const Entity &_entity, const auto *,
+      ComponentState) -> bool
+  {
+    if (this->models.slots.count(_entity) > 0)
+      this->SetModel(_ecm, _entity);
+    return true;
+  };
+  if (_ecm.HasChangedComponents<components::Pose>())
+    _ecm.EachChanged<components::Pose>(refresh);
+  if (_ecm.HasChangedComponents<components::AxisAlignedBox>())
+    _ecm.EachChanged<components::AxisAlignedBox>(refresh);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::RebuildLocked(const EntityComponentManager &_ecm)
+{
+  this->models = Grid();
+  this->performers = Grid();
+  this->modelPerformers.clear();
+
+  _ecm.Each<components::Model>(
+      [&](const Entity &_entity, const components::Model *) -> bool
+      {
+        this->SetModel(_ecm, _entity);
+        return true;
+      });
+  _ecm.Each<components::Performer>(
+      [&](const Entity &_entity, const components::Performer *) -> bool
+      {
+        this->SetPerformer(_ecm, _entity);
+        return true;
+      });
+}
+
+//////////////////////////////////////////////////
+SpatialIndex::SpatialIndex(double _cellSize)
+  : dataPtr(std::make_unique<SpatialIndexPrivate>())
+{
+  if (_cellSize > 0.0)
+    this->dataPtr->cellSize = _cellSize;
+}
+
+//////////////////////////////////////////////////
+SpatialIndex::~SpatialIndex() = default;
+
+//////////////////////////////////////////////////
+std::shared_ptr<const SpatialIndex> SpatialIndex::Shared(
+    const UpdateInfo &_info, const EntityComponentManager &_ecm)
+{
+  auto index = _ecm.SharedSpatialIndex();
+  index->Update(_info, _ecm);
+  return index;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Update(const UpdateInfo &_info,
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("SpatialIndex::Update");
+  std::unique_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+
+  auto &data = *this->dataPtr;
+  if (data.updated && _info.iterations == data.iterations && !_info.paused)
+    return;
+
+  // Changes of skipped steps aren't available anymore. Repeated updates
+  // while paused apply the same changes again, which is harmless.
+  const bool caughtUp = data.updated &&
+      (_info.iterations == data.iterations ||
+       _info.iterations == data.iterations + 1);
+  data.updated = true;
+  data.iterations = _info.iterations;
+
+  if (caughtUp)
+    data.ApplyChanges(_ecm);
+  else
+    data.RebuildLocked(_ecm);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Rebuild(const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("SpatialIndex::Rebuild");
+  std::unique_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->RebuildLocked(_ecm);
+}
+
+//////////////////////////////////////////////////
+std::size_t SpatialIndex::Count(Layer _layer) const
+{
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->LayerGrid(_layer).entries.size();
+}
+
+//////////////////////////////////////////////////
+std::optional<math::AxisAlignedBox> SpatialIndex::Box(Layer _layer,
+    const Entity _entity) const
+{
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  const auto &grid = this->dataPtr->LayerGrid(_layer);
+  auto it = grid.slots.find(_entity);
+  if (it == grid.slots.end())
+    return std::nullopt;
+
+  const auto &entry = grid.entries[it->second];
+  return math::AxisAlignedBox(entry.min, entry.max);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Query(Layer _layer, const math::AxisAlignedBox &_box,
+    std::vector<Entity> &_entities) const
+{
+  _entities.clear();
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Visit(this->dataPtr->LayerGrid(_layer), _box.Min(),
+      _box.Max(), [&](const SpatialIndexPrivate::Entry &_entry)
+      {
+        _entities.push_back(_entry.entity);
+      });
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Query(Layer _layer, const math::Vector3d &_center,
+    double _radius, std::vector<Entity> &_entities) const
+{
+  _entities.clear();
+  const math::Vector3d extent(_radius, _radius, _radius);
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Visit(this->dataPtr->LayerGrid(_layer), _center - extent,
+      _center + extent, [&](const SpatialIndexPrivate::Entry &_entry)
+      {
+        // Distance from the center to the closest point of the box
+        math::Vector3d closest = _center;
+        closest.Max(_entry.min);
+        closest.Min(_entry.max);
+        if ((closest - _center).SquaredLength() <= _radius * _radius)
+          _entities.push_back(_entry.entity);
+      });
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Query(Layer _layer, const math::Frustum &_frustum,
+    std::vector<Entity> &_entities) const
+{
+  _entities.clear();
+
+  // Bound the frustum's corners. It looks along its X axis.
+  const double tanHalfFov = std::tan(_frustum.FOV().Radian() / 2.0);
+  const auto &pose = _frustum.Pose();
+  math::Vector3d min = pose.Pos();
+  math::Vector3d max = pose.Pos();
+  for (const double distance : {_frustum.Near(), _frustum.Far()})
+  {
+    const double halfWidth = distance * tanHalfFov;
+    const double halfHeight = halfWidth / _frustum.AspectRatio();
+    for (const double y : {-halfWidth, halfWidth})
+    {
+      for (const double z : {-halfHeight, halfHeight})
+      {
+        const auto corner = pose.Pos() +
+            pose.Rot() * math::Vector3d(distance, y, z);
+        min.Min(corner);
+        max.Max(corner);
+      }
+    }
+  }
+
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Visit(this->dataPtr->LayerGrid(_layer), min, max,
+      [&](const SpatialIndexPrivate::Entry &_entry)
+      {
+        if (_frustum.Contains(math::AxisAlignedBox(_entry.min, _entry.max)))
+          _entities.push_back(_entry.entity);
+      });
+}
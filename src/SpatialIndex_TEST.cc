@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <ignition/math/Frustum.hh>
+#include <sdf/Box.hh>
+#include <sdf/Geometry.hh>
+
+#include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/SpatialIndex.hh"
+#include "ignition/gazebo/components/Geometry.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/Performer.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/World.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief ECM which can be stepped like the simulation runner does.
+class SpatialIndexEcm : public EntityComponentManager
+{
+  /// \brief Finish a step.
+  public: void Step()
+  {
+    this->ClearNewlyCreatedEntities();
+    this->ProcessRemoveEntityRequests();
+    this->SetAllComponentsUnchanged();
+  }
+};
+
+/// \brief Create a model.
+/// \param[in] _ecm Entity-component manager.
+/// \param[in] _parent Parent entity.
+/// \param[in] _pos Position of the model.
+/// \return Model entity.
+static Entity createModel(EntityComponentManager &_ecm, Entity _parent,
+    const math::Vector3d &_pos)
+{
+  auto entity = _ecm.CreateEntity();
+  _ecm.CreateComponent(entity, components::Model());
+  _ecm.CreateComponent(entity, components::ParentEntity(_parent));
+  _ecm.CreateComponent(entity,
+      components::Pose(math::Pose3d(_pos, math::Quaterniond::Identity)));
+  return entity;
+}
+
+/// \brief Sort entities, to compare query results.
+/// \param[in] _entities Entities.
+/// \return Sorted entities.
+static std::vector<Entity> sorted(std::vector<Entity> _entities)
+{
+  std::sort(_entities.begin(), _entities.end());
+  return _entities;
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialIndex, Query)
+{
+  SpatialIndexEcm ecm;
+  auto world = ecm.CreateEntity();
+  ecm.CreateComponent(world, components::World());
+
+  auto near = createModel(ecm, world, {0, 0, 0});
+  auto far = createModel(ecm, world, {50, 0, 0});
+  auto nested = createModel(ecm, near, {1, 0, 0});
+
+  sdf::Box box;
+  box.SetSize({2, 2, 2});
+  sdf::Geometry geometry;
+  geometry.SetType(sdf::GeometryType::BOX);
+  geometry.SetBoxShape(box);
+  auto performer = ecm.CreateEntity();
+  ecm.CreateComponent(performer, components::Performer());
+  ecm.CreateComponent(performer, components::ParentEntity(near));
+  ecm.CreateComponent(performer, components::Geometry(geometry));
+
+  SpatialIndex index;
+  UpdateInfo info;
+  info.iterations = 1;
+  index.Update(info, ecm);
+
+  // Nested models aren't indexed
+  EXPECT_EQ(2u, index.Count(SpatialIndex::Layer::MODELS));
+  EXPECT_EQ(1u, index.Count(SpatialIndex::Layer::PERFORMERS));
+  EXPECT_FALSE(index.Box(SpatialIndex::Layer::MODELS, nested));
+
+  auto performerBox = index.Box(SpatialIndex::Layer::PERFORMERS, performer);
+  ASSERT_TRUE(performerBox);
+  EXPECT_EQ(math::Vector3d(-1, -1, -1), performerBox->Min());
+  EXPECT_EQ(math::Vector3d(1, 1, 1), performerBox->Max());
+
+  std::vector<Entity> entities;
+  index.Query(SpatialIndex::Layer::MODELS,
+      math::AxisAlignedBox({-1, -1, -1}, {1, 1, 1}), entities);
+  EXPECT_EQ(std::vector<Entity>{near}, entities);
+
+  index.Query(SpatialIndex::Layer::MODELS,
+      math::AxisAlignedBox({-100, -100, -100}, {100, 100, 100}), entities);
+  EXPECT_EQ(sorted({near, far}), sorted(entities));
+
+  index.Query(SpatialIndex::Layer::MODELS, math::Vector3d(47, 0, 0), 3.5,
+      entities);
+  EXPECT_EQ(std::vector<Entity>{far}, entities);
+
+  index.Query(SpatialIndex::Layer::MODELS, math::Vector3d(47, 0, 0), 2.5,
+      entities);
+  EXPECT_TRUE(entities.empty());
+
+  // Frustum at the origin looking along +X, past the near model
+  math::Frustum frustum(1.0, 100.0, IGN_DTOR(60), 1.0,
+      math::Pose3d(-0.5, 0, 0, 0, 0, 0));
+  index.Query(SpatialIndex::Layer::MODELS, frustum, entities);
+  EXPECT_EQ(std::vector<Entity>{far}, entities);
+
+  // Looking the other way
+  frustum.SetPose(math::Pose3d(40, 0, 0, 0, 0, IGN_PI));
+  index.Query(SpatialIndex::Layer::MODELS, frustum, entities);
+  EXPECT_EQ(std::vector<Entity>{near}, entities);
+
+  // Move the near model, and its performer with it
+  ecm.Step();
+  ecm.Component<components::Pose>(near)->Data().Pos() = {100, 0, 0};
+  ecm.SetChanged(near, components::Pose::typeId);
+  info.iterations = 2;
+  index.Update(info, ecm);
+
+  index.Query(SpatialIndex::Layer::MODELS,
+      math::AxisAlignedBox({-1, -1, -1}, {1, 1, 1}), entities);
+  EXPECT_TRUE(entities.empty());
+  index.Query(SpatialIndex::Layer::PERFORMERS,
+      math::AxisAlignedBox({99, 0, 0}, {99.5, 0.5, 0.5}), entities);
+  EXPECT_EQ(std::vector<Entity>{performer}, entities);
+
+  // Remove the far model
+  ecm.Step();
+  ecm.RequestRemoveEntity(far);
+  info.iterations = 3;
+  index.Update(info, ecm);
+  EXPECT_EQ(1u, index.Count(SpatialIndex::Layer::MODELS));
+  EXPECT_FALSE(index.Box(SpatialIndex::Layer::MODELS, far));
+
+  // Skipped steps are caught up with a rebuild
+  ecm.Step();
+  ecm.RequestRemoveEntity(performer);
+  ecm.Step();
+  info.iterations = 5;
+  index.Update(info, ecm);
+  EXPECT_EQ(1u, index.Count(SpatialIndex::Layer::MODELS));
+  EXPECT_EQ(0u, index.Count(SpatialIndex::Layer::PERFORMERS));
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialIndex, Shared)
+{
+  SpatialIndexEcm ecm;
+  auto world = ecm.CreateEntity();
+  ecm.CreateComponent(world, components::World());
+  createModel(ecm, world, {0, 0, 0});
+
+  UpdateInfo info;
+  info.iterations = 1;
+  auto index = SpatialIndex::Shared(info, ecm);
+  ASSERT_NE(nullptr, index);
+  EXPECT_EQ(1u, index->Count(SpatialIndex::Layer::MODELS));
+  EXPECT_EQ(index, SpatialIndex::Shared(info, ecm));
+
+  // Each manager has its own index
+  SpatialIndexEcm otherEcm;
+  auto otherIndex = SpatialIndex::Shared(info, otherEcm);
+  EXPECT_NE(index, otherIndex);
+  EXPECT_EQ(0u, otherIndex->Count(SpatialIndex::Layer::MODELS));
+}
@@ -17,6 +17,7 @@
 
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <ignition/gazebo/SystemLoader.hh>
@@ -46,18 +47,7 @@ class ignition::gazebo::SystemLoaderPrivate
               const sdf::ElementPtr &/*_sdf*/,
               ignition::plugin::PluginPtr &_plugin)
   {
-    ignition::common::SystemPaths systemPaths;
-    systemPaths.SetPluginPathEnv(pluginPathEnv);
-
-    for (const auto &path : this->systemPluginPaths)
-      systemPaths.AddPluginPaths(path);
-
-    std::string homePath;
-    ignition::common::env(IGN_HOMEDIR, homePath);
-    systemPaths.AddPluginPaths(homePath + "/.ignition/gazebo/plugins");
-    systemPaths.AddPluginPaths(IGN_GAZEBO_PLUGIN_INSTALL_DIR);
-
-    auto pathToLib = systemPaths.FindSharedLibrary(_filename);
+    auto pathToLib = this->FindLibrary(_filename);
     if (pathToLib.empty())
     {
       // We assume ignition::gazebo corresponds to the levels feature
@@ -69,22 +59,29 @@ class ignition::gazebo::SystemLoaderPrivate
       return false;
     }
 
-    auto pluginNames = this->loader.LoadLib(pathToLib);
-    if (pluginNames.empty())
+    // Each library is only loaded once, all of its plugins can be
+    // instantiated afterwards.
+    if (this->loadedLibs.find(pathToLib) == this->loadedLibs.end())
     {
-      ignerr << "Failed to load system plugin [" << _filename <<
-                "] : couldn't load library on path [" << pathToLib <<
-                "]." << std::endl;
-      return false;
-    }
+      auto pluginNames = this->loader.LoadLib(pathToLib);
+      if (pluginNames.empty())
+      {
+        ignerr << "Failed to load system plugin [" << _filename <<
+                  "] : couldn't load library on path [" << pathToLib <<
+                  "]." << std::endl;
+        return false;
+      }
 
-    auto pluginName = *pluginNames.begin();
-    if (pluginName.empty())
-    {
-      ignerr << "Failed to load system plugin [" << _filename <<
-                "] : couldn't load library on path [" << pathToLib <<
-                "]." << std::endl;
-      return false;
+      auto pluginName = *pluginNames.begin();
+      if (pluginName.empty())
+      {
+        ignerr << "Failed to load system plugin [" << _filename <<
+                  "] : couldn't load library on path [" << pathToLib <<
+                  "]." << std::endl;
+        return false;
+      }
+
+      this->loadedLibs.insert(pathToLib);
     }
 
     _plugin = this->loader.Instantiate(_name);
@@ -109,6 +106,36 @@ class ignition::gazebo::SystemLoaderPrivate
     return true;
   }
 
+  //////////////////////////////////////////////////
+  /// \brief Find the shared library of a plugin. Paths which were found
+  /// are cached, so the search paths are only walked once per library.
+  /// \param[in] _filename Library file name, as given in the SDF.
+  /// \return Path to the library, or an empty string if not found.
+  public: std::string FindLibrary(const std::string &_filename)
+  {
+    auto cached = this->libPaths.find(_filename);
+    if (cached != this->libPaths.end())
+      return cached->second;
+
+    ignition::common::SystemPaths systemPaths;
+    systemPaths.SetPluginPathEnv(pluginPathEnv);
+
+    for (const auto &path : this->systemPluginPaths)
+      systemPaths.AddPluginPaths(path);
+
+    std::string homePath;
+    ignition::common::env(IGN_HOMEDIR, homePath);
+    systemPaths.AddPluginPaths(homePath + "/.ignition/gazebo/plugins");
+    systemPaths.AddPluginPaths(IGN_GAZEBO_PLUGIN_INSTALL_DIR);
+
+    auto pathToLib = systemPaths.FindSharedLibrary(_filename);
+
+    // Don't cache failures, the library may be added to the paths later
+    if (!pathToLib.empty())
+      this->libPaths[_filename] = pathToLib;
+    return pathToLib;
+  }
+
   // Default plugin search path environment variable
   public: std::string pluginPathEnv{"IGN_GAZEBO_SYSTEM_PLUGIN_PATH"};
 
@@ -118,6 +145,13 @@ class ignition::gazebo::SystemLoaderPrivate
   /// \brief Paths to search for system plugins.
   public: std::unordered_set<std::string> systemPluginPaths;
 
+  /// \brief Library paths found for each file name. It's cleared when a
+  /// search path is added, since it may take precedence.
+  public: std::unordered_map<std::string, std::string> libPaths;
+
+  /// \brief Paths of the libraries which were loaded.
+  public: std::unordered_set<std::string> loadedLibs;
+
   /// \brief System plugins that have instances loaded via the manager.
   public: std::unordered_set<SystemPluginPtr> systemPluginsAdded;
 };
@@ -134,7 +168,8 @@ SystemLoader::~SystemLoader() = default;
 //////////////////////////////////////////////////
 void SystemLoader::AddSystemPluginPath(const std::string &_path)
 {
-  this->dataPtr->systemPluginPaths.insert(_path);
+  if (this->dataPtr->systemPluginPaths.insert(_path).second)
+    this->dataPtr->libPaths.clear();
 }
 
 //////////////////////////////////////////////////
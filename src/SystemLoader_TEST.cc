@@ -65,3 +65,30 @@ TEST(SystemLoader, EmptyNames)
   auto system = sm.LoadPlugin("", "", element);
   ASSERT_FALSE(system.has_value());
 }
+
+/////////////////////////////////////////////////
+TEST(SystemLoader, LoadSameLibraryTwice)
+{
+  gazebo::SystemLoader sm;
+
+  auto testBuildPath = ignition::common::joinPaths(
+      std::string(PROJECT_BINARY_PATH), "lib");
+  sm.AddSystemPluginPath(testBuildPath);
+
+  const std::string filename = std::string("libignition-gazebo") +
+      IGNITION_GAZEBO_MAJOR_VERSION_STR + "-physics-system.so";
+  const std::string name = "ignition::gazebo::systems::Physics";
+  sdf::ElementPtr element;
+
+  // The second instance comes from the library loaded the first time, and
+  // is a different instance
+  auto system1 = sm.LoadPlugin(filename, name, element);
+  ASSERT_TRUE(system1.has_value());
+  auto system2 = sm.LoadPlugin(filename, name, element);
+  ASSERT_TRUE(system2.has_value());
+  EXPECT_NE(system1.value(), system2.value());
+
+  // Unknown plugins of a loaded library still fail
+  auto system3 = sm.LoadPlugin(filename, "not::a::Plugin", element);
+  EXPECT_FALSE(system3.has_value());
+}
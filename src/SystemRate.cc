@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "SystemRate.hh"
+
+#include <ignition/common/Console.hh>
+
+using namespace ignition;
+using namespace gazebo;
+
+//////////////////////////////////////////////////
+SystemRate::SystemRate(const sdf::ElementPtr &_sdf)
+{
+  if (!_sdf)
+    return;
+
+  if (_sdf->HasElement("system_update_rate"))
+  {
+    const double rate = _sdf->Get<double>("system_update_rate");
+    if (rate > 0.0)
+    {
+      this->period = std::chrono::duration_cast<
+          std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1.0 / rate));
+    }
+    else
+    {
+      ignwarn << "Ignoring <system_update_rate> [" << rate
+              << "], it must be positive." << std::endl;
+    }
+  }
+
+  if (_sdf->HasElement("system_update_iterations"))
+  {
+    const int count = _sdf->Get<int>("system_update_iterations");
+    if (count > 0)
+    {
+      this->iterations = static_cast<uint64_t>(count);
+    }
+    else
+    {
+      ignwarn << "Ignoring <system_update_iterations> [" << count
+              << "], it must be positive." << std::endl;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+SystemRate::SystemRate(std::chrono::steady_clock::duration _period,
+    uint64_t _iterations)
+  : period(_period), iterations(_iterations)
+{
+}
+
+//////////////////////////////////////////////////
+bool SystemRate::Decimated() const
+{
+  return this->period > std::chrono::steady_clock::duration::zero() ||
+      this->iterations > 1u;
+}
+
+//////////////////////////////////////////////////
+void SystemRate::Step(const UpdateInfo &_info)
+{
+  if (!this->Decimated())
+    return;
+
+  const bool wentBack = _info.simTime < this->info.simTime ||
+      _info.iterations < this->info.iterations;
+
+  this->due = !this->started || wentBack ||
+      (this->iterations > 1u &&
+       _info.iterations - this->info.iterations >= this->iterations) ||
+      (this->period > std::chrono::steady_clock::duration::zero() &&
+       _info.simTime >= this->nextTime);
+
+  if (!this->due)
+    return;
+
+  const auto dt = this->started ? _info.simTime - this->info.simTime :
+      _info.dt;
+  this->started = true;
+  this->info = _info;
+  this->info.dt = dt;
+
+  // Keep the updates on the period's grid, unless it fell behind by more
+  // than a period, such as after a seek or a long step.
+  this->nextTime += this->period;
+  if (wentBack || this->nextTime <= _info.simTime)
+    this->nextTime = _info.simTime + this->period;
+}
+
+//////////////////////////////////////////////////
+const UpdateInfo *SystemRate::Info(const UpdateInfo &_info) const
+{
+  if (!this->Decimated())
+    return &_info;
+  return this->due ? &this->info : nullptr;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_SYSTEMRATE_HH_
+#define IGNITION_GAZEBO_SYSTEMRATE_HH_
+
+#include <sdf/Element.hh>
+
+#include <chrono>
+#include <cstdint>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+#include <ignition/gazebo/Types.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    /// \class SystemRate SystemRate.hh
+    /// \brief Decides on which iterations a system runs, so that a system
+    /// can be updated less often than the world is stepped without handling
+    /// it itself.
+    ///
+    /// The rate is read from the plugin's SDF:
+    ///
+    /// - `<system_update_rate>`: Rate in Hz of simulation time at which the
+    /// system is updated.
+    /// - `<system_update_iterations>`: Number of iterations between updates
+    /// of the system.
+    ///
+    /// If both are set, the system is updated as soon as either is reached.
+    /// Otherwise it's updated every iteration. A decimated system is always
+    /// updated on its first iteration, and when simulation time or the
+    /// iteration count go back, such as on a rewind or seek. It's given the
+    /// time elapsed since its previous update as dt.
+    class IGNITION_GAZEBO_VISIBLE SystemRate
+    {
+      /// \brief Constructor of a system updated every iteration.
+      public: SystemRate() = default;
+
+      /// \brief Constructor.
+      /// \param[in] _sdf SDF element of the plugin, may be null.
+      public: explicit SystemRate(const sdf::ElementPtr &_sdf);
+
+      /// \brief Constructor.
+      /// \param[in] _period Simulation time between updates, zero for no
+      /// time based decimation.
+      /// \param[in] _iterations Iterations between updates, 0 or 1 for no
+      /// iteration based decimation.
+      public: SystemRate(std::chrono::steady_clock::duration _period,
+                  uint64_t _iterations);
+
+      /// \brief Whether the system skips some iterations.
+      /// \return True if it's decimated.
+      public: bool Decimated() const;
+
+      /// \brief Decide whether the system is due on an iteration. Must be
+      /// called once per iteration, before the system's callbacks.
+      /// \param[in] _info Information of the iteration.
+      public: void Step(const UpdateInfo &_info);
+
+      /// \brief Information to pass to the system on the current iteration.
+      /// \param[in] _info Information of the iteration, as passed to Step.
+      /// \return _info if the system isn't decimated, information with the
+      /// time elapsed since the previous update as dt if it's due, or null
+      /// if it must be skipped.
+      public: const UpdateInfo *Info(const UpdateInfo &_info) const;
+
+      /// \brief Simulation time between updates, zero if unused.
+      private: std::chrono::steady_clock::duration period{0};
+
+      /// \brief Iterations between updates, 0 or 1 if unused.
+      private: uint64_t iterations{0};
+
+      /// \brief Whether the system was updated yet.
+      private: bool started{false};
+
+      /// \brief Whether the system is due on the current iteration.
+      private: bool due{false};
+
+      /// \brief Simulation time at which the system is due next.
+      private: std::chrono::steady_clock::duration nextTime{0};
+
+      /// \brief Information of the latest update, with the accumulated dt.
+      private: UpdateInfo info;
+    };
+    }
+  }
+}
+#endif
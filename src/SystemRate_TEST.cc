@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include <sdf/Element.hh>
+
+#include "SystemRate.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace std::chrono_literals;
+
+/////////////////////////////////////////////////
+/// \brief Information of an unpaused iteration.
+/// \param[in] _iterations Iteration count.
+/// \param[in] _step Step size.
+/// \return Information with the simulation time of the iteration.
+UpdateInfo iteration(uint64_t _iterations,
+    std::chrono::steady_clock::duration _step = 10ms)
+{
+  UpdateInfo info;
+  info.iterations = _iterations;
+  info.simTime = _step * _iterations;
+  info.dt = _step;
+  info.paused = false;
+  return info;
+}
+
+/////////////////////////////////////////////////
+TEST(SystemRate, NotDecimated)
+{
+  SystemRate rate;
+  EXPECT_FALSE(rate.Decimated());
+
+  auto info = iteration(1);
+  rate.Step(info);
+  EXPECT_EQ(&info, rate.Info(info));
+
+  // Without rate elements in the SDF
+  auto sdf = std::make_shared<sdf::Element>();
+  sdf->SetName("plugin");
+  EXPECT_FALSE(SystemRate(sdf).Decimated());
+  EXPECT_FALSE(SystemRate(nullptr).Decimated());
+}
+
+/////////////////////////////////////////////////
+TEST(SystemRate, Period)
+{
+  // 20 Hz on a 10 ms step
+  SystemRate rate(50ms, 0);
+  EXPECT_TRUE(rate.Decimated());
+
+  // Always updated on the first iteration
+  auto info = iteration(1);
+  rate.Step(info);
+  ASSERT_NE(nullptr, rate.Info(info));
+  EXPECT_EQ(10ms, rate.Info(info)->dt);
+
+  int updates{0};
+  for (uint64_t i = 2; i <= 100; ++i)
+  {
+    info = iteration(i);
+    rate.Step(info);
+    if (auto due = rate.Info(info))
+    {
+      ++updates;
+      EXPECT_EQ(0u, i % 5) << i;
+      EXPECT_EQ(info.simTime, due->simTime);
+      EXPECT_EQ(i, due->iterations);
+      EXPECT_FALSE(due->paused);
+      EXPECT_EQ(i == 5u ? 40ms : 50ms, due->dt);
+    }
+  }
+  EXPECT_EQ(20, updates);
+
+  // Paused, time doesn't advance
+  info.paused = true;
+  info.dt = 0ms;
+  rate.Step(info);
+  EXPECT_EQ(nullptr, rate.Info(info));
+
+  // Rewind
+  info = iteration(0);
+  info.dt = -1000ms;
+  rate.Step(info);
+  ASSERT_NE(nullptr, rate.Info(info));
+  EXPECT_EQ(-1000ms, rate.Info(info)->dt);
+
+  info = iteration(1);
+  rate.Step(info);
+  EXPECT_EQ(nullptr, rate.Info(info));
+}
+
+/////////////////////////////////////////////////
+TEST(SystemRate, Iterations)
+{
+  auto sdf = std::make_shared<sdf::Element>();
+  sdf->SetName("plugin");
+  sdf::ElementPtr child(new sdf::Element);
+  child->SetParent(sdf);
+  child->SetName("system_update_iterations");
+  child->AddValue("int", "3", true);
+  sdf->InsertElement(child);
+
+  SystemRate rate(sdf);
+  EXPECT_TRUE(rate.Decimated());
+
+  int updates{0};
+  for (uint64_t i = 1; i <= 10; ++i)
+  {
+    auto info = iteration(i);
+    rate.Step(info);
+    if (auto due = rate.Info(info))
+    {
+      ++updates;
+      EXPECT_EQ(1u, i % 3) << i;
+      EXPECT_EQ(i == 1u ? 10ms : 30ms, due->dt);
+    }
+  }
+  EXPECT_EQ(4, updates);
+}
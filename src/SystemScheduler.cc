@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "SystemScheduler.hh"
+
+#include <algorithm>
+#include <set>
+
+using namespace ignition;
+using namespace gazebo;
+
+namespace
+{
+/// \brief Check whether two sorted sets have an element in common.
+/// \param[in] _a First set.
+/// \param[in] _b Second set.
+/// \return True if the sets intersect.
+bool Intersect(const std::set<ComponentTypeId> &_a,
+    const std::set<ComponentTypeId> &_b)
+{
+  auto a = _a.begin();
+  auto b = _b.begin();
+  while (a != _a.end() && b != _b.end())
+  {
+    if (*a < *b)
+      ++a;
+    else if (*b < *a)
+      ++b;
+    else
+      return true;
+  }
+  return false;
+}
+}
+
+//////////////////////////////////////////////////
+const std::vector<std::vector<std::size_t>> &SystemScheduler::Schedule(
+    const std::vector<ISystemAccess *> &_systems,
+    const EntityComponentManager &_ecm)
+{
+  this->access.resize(_systems.size());
+  this->accessPtrs.assign(_systems.size(), nullptr);
+  for (std::size_t i = 0; i < _systems.size(); ++i)
+  {
+    if (nullptr == _systems[i])
+      continue;
+
+    SystemAccess &systemAccess = this->access[i];
+    systemAccess.reads.clear();
+    systemAccess.writes.clear();
+    if (_systems[i]->Access(_ecm, systemAccess))
+      this->accessPtrs[i] = &systemAccess;
+  }
+
+  return this->Schedule(this->accessPtrs);
+}
+
+//////////////////////////////////////////////////
+const std::vector<std::vector<std::size_t>> &SystemScheduler::Schedule(
+    const std::vector<const SystemAccess *> &_access)
+{
+  // Each system goes in the stage after the latest of the earlier systems it
+  // conflicts with. Systems without access conflict with all of them.
+  this->levels.assign(_access.size(), 0u);
+  std::size_t stageCount = 0;
+  for (std::size_t i = 0; i < _access.size(); ++i)
+  {
+    for (std::size_t j = 0; j < i; ++j)
+    {
+      if (this->levels[j] + 1 <= this->levels[i])
+        continue;
+
+      if (nullptr == _access[i] || nullptr == _access[j] ||
+          Conflict(*_access[i], *_access[j]))
+      {
+        this->levels[i] = this->levels[j] + 1;
+      }
+    }
+    stageCount = std::max(stageCount, this->levels[i] + 1);
+  }
+
+  this->stages.resize(stageCount);
+  for (auto &stage : this->stages)
+    stage.clear();
+  for (std::size_t i = 0; i < _access.size(); ++i)
+    this->stages[this->levels[i]].push_back(i);
+
+  return this->stages;
+}
+
+//////////////////////////////////////////////////
+bool SystemScheduler::Conflict(const SystemAccess &_a,
+    const SystemAccess &_b)
+{
+  return Intersect(_a.writes, _b.writes) ||
+      Intersect(_a.writes, _b.reads) ||
+      Intersect(_a.reads, _b.writes);
+}
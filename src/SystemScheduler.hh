@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_SYSTEMSCHEDULER_HH_
+#define IGNITION_GAZEBO_SYSTEMSCHEDULER_HH_
+
+#include <cstddef>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/EntityComponentManager.hh>
+#include <ignition/gazebo/Export.hh>
+#include <ignition/gazebo/System.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    /// \class SystemScheduler SystemScheduler.hh
+    /// \brief Groups the systems of a phase into stages, using the component
+    /// types they declare through ISystemAccess. The systems of a stage
+    /// don't conflict with each other, so they can run concurrently, and
+    /// stages run one after the other.
+    ///
+    /// Each system is placed in the stage after the last stage holding an
+    /// earlier system it conflicts with. Systems which don't declare their
+    /// access conflict with all others, so they get a stage of their own and
+    /// the load order of conflicting systems is preserved.
+    class IGNITION_GAZEBO_VISIBLE SystemScheduler
+    {
+      /// \brief Ask the systems for their access and group them in stages.
+      /// \param[in] _systems Access interface of each system of the phase,
+      /// in load order, or nullptr for systems which don't implement it.
+      /// \param[in] _ecm Entity component manager passed to the systems.
+      /// \return The stages, in the order they should run. Each stage holds
+      /// indices into _systems. The result is valid until the next call.
+      public: const std::vector<std::vector<std::size_t>> &Schedule(
+                  const std::vector<ISystemAccess *> &_systems,
+                  const EntityComponentManager &_ecm);
+
+      /// \brief Group systems in stages based on their access.
+      /// \param[in] _access Access of each system, in load order, or nullptr
+      /// for systems which must run alone.
+      /// \return The stages, see the other Schedule overload.
+      public: const std::vector<std::vector<std::size_t>> &Schedule(
+                  const std::vector<const SystemAccess *> &_access);
+
+      /// \brief Check whether two systems can't run concurrently.
+      /// \param[in] _a Access of the first system.
+      /// \param[in] _b Access of the second system.
+      /// \return True if one system writes a component type which the other
+      /// reads or writes.
+      public: static bool Conflict(const SystemAccess &_a,
+                                   const SystemAccess &_b);
+
+      /// \brief Access declared by each system in the last Schedule call.
+      private: std::vector<SystemAccess> access;
+
+      /// \brief Pointers into access, or nullptr for systems which must run
+      /// alone.
+      private: std::vector<const SystemAccess *> accessPtrs;
+
+      /// \brief Stage of each system.
+      private: std::vector<std::size_t> levels;
+
+      /// \brief Systems of each stage.
+      private: std::vector<std::vector<std::size_t>> stages;
+    };
+    }  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
+  }  // namespace gazebo
+}  // namespace ignition
+
+#endif  // IGNITION_GAZEBO_SYSTEMSCHEDULER_HH_
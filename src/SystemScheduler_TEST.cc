@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ignition/gazebo/EntityComponentManager.hh"
+#include "SystemScheduler.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+using Stages = std::vector<std::vector<std::size_t>>;
+
+/////////////////////////////////////////////////
+TEST(SystemScheduler, Conflict)
+{
+  SystemAccess readA{{1}, {}};
+  SystemAccess writeA{{}, {1}};
+  SystemAccess readWriteB{{2}, {2}};
+
+  EXPECT_FALSE(SystemScheduler::Conflict(readA, readA));
+  EXPECT_TRUE(SystemScheduler::Conflict(readA, writeA));
+  EXPECT_TRUE(SystemScheduler::Conflict(writeA, readA));
+  EXPECT_TRUE(SystemScheduler::Conflict(writeA, writeA));
+  EXPECT_FALSE(SystemScheduler::Conflict(writeA, readWriteB));
+  EXPECT_FALSE(SystemScheduler::Conflict(SystemAccess(), SystemAccess()));
+}
+
+/////////////////////////////////////////////////
+TEST(SystemScheduler, Stages)
+{
+  SystemScheduler scheduler;
+  EXPECT_TRUE(scheduler.Schedule(std::vector<const SystemAccess *>()).empty());
+
+  // Independent controllers share a stage
+  SystemAccess controller1{{1}, {10}};
+  SystemAccess controller2{{2}, {11}};
+  SystemAccess controller3{{1, 2}, {12}};
+  EXPECT_EQ((Stages{{0, 1, 2}}), scheduler.Schedule(
+      {&controller1, &controller2, &controller3}));
+
+  // A system which reads a command runs after the system writing it, while
+  // independent systems can still run earlier
+  SystemAccess reader{{10}, {}};
+  EXPECT_EQ((Stages{{0, 2}, {1}}), scheduler.Schedule(
+      {&controller1, &reader, &controller2}));
+
+  // Systems without access run alone and keep their place in the order
+  EXPECT_EQ((Stages{{0, 1}, {2}, {3, 4}}), scheduler.Schedule(
+      {&controller1, &controller2, nullptr, &controller3, &reader}));
+  EXPECT_EQ((Stages{{0}, {1}, {2}}), scheduler.Schedule(
+      {nullptr, nullptr, nullptr}));
+
+  // Chains of conflicts need one stage per link
+  SystemAccess writer10{{}, {10}};
+  EXPECT_EQ((Stages{{0}, {1}, {2}}), scheduler.Schedule(
+      {&writer10, &reader, &writer10}));
+}
+
+/// \brief System which declares a fixed access.
+class AccessSystem : public ISystemAccess
+{
+  public: bool Access(const EntityComponentManager &,
+                      SystemAccess &_access) override
+  {
+    EXPECT_TRUE(_access.reads.empty());
+    EXPECT_TRUE(_access.writes.empty());
+    ++this->calls;
+    _access = this->access;
+    return this->parallel;
+  }
+
+  public: SystemAccess access;
+  public: bool parallel{true};
+  public: int calls{0};
+};
+
+/////////////////////////////////////////////////
+TEST(SystemScheduler, QueriesSystems)
+{
+  EntityComponentManager ecm;
+  AccessSystem a;
+  a.access.writes.insert(1);
+  AccessSystem b;
+  b.access.writes.insert(2);
+
+  SystemScheduler scheduler;
+  EXPECT_EQ((Stages{{0, 1}, {2}}), scheduler.Schedule(
+      std::vector<ISystemAccess *>{&a, &b, nullptr}, ecm));
+  EXPECT_EQ(1, a.calls);
+
+  // Systems can ask to run alone on some steps
+  b.parallel = false;
+  EXPECT_EQ((Stages{{0}, {1}, {2}}), scheduler.Schedule(
+      std::vector<ISystemAccess *>{&a, &b, nullptr}, ecm));
+  EXPECT_EQ(2, b.calls);
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "TaskPool.hh"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+namespace
+{
+/// \brief A range of work submitted through ParallelFor.
+class Job
+{
+  /// \brief Constructor
+  /// \param[in] _count Number of indices to process.
+  /// \param[in] _grainSize Maximum number of indices per chunk.
+  /// \param[in] _task Task to run on each chunk.
+  public: Job(std::size_t _count, std::size_t _grainSize,
+              const ignition::gazebo::TaskPool::Task &_task)
+    : count(_count), grainSize(_grainSize), task(_task)
+  {
+  }
+
+  /// \brief Claim and run the next chunk of this job.
+  /// \return False if there were no chunks left to claim.
+  public: bool RunChunk()
+  {
+    const std::size_t begin = this->next.fetch_add(this->grainSize);
+    if (begin >= this->count)
+      return false;
+
+    const std::size_t end = std::min(begin + this->grainSize, this->count);
+    this->task(begin, end);
+
+    // The thread that completes the last chunk wakes up the submitter
+    if (this->done.fetch_add(end - begin) + (end - begin) == this->count)
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->cv.notify_all();
+    }
+    return true;
+  }
+
+  /// \brief Block until all chunks are done.
+  public: void Wait()
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->cv.wait(lock, [this]
+    {
+      return this->done.load() == this->count;
+    });
+  }
+
+  /// \brief Number of indices to process.
+  public: const std::size_t count;
+
+  /// \brief Maximum number of indices per chunk.
+  public: const std::size_t grainSize;
+
+  /// \brief Task to run on each chunk.
+  public: const ignition::gazebo::TaskPool::Task &task;
+
+  /// \brief First index which hasn't been claimed yet.
+  public: std::atomic<std::size_t> next{0};
+
+  /// \brief Number of indices already processed.
+  public: std::atomic<std::size_t> done{0};
+
+  /// \brief Mutex used to signal completion.
+  public: std::mutex mutex;
+
+  /// \brief Condition variable used to signal completion.
+  public: std::condition_variable cv;
+};
+}
+
+class ignition::gazebo::TaskPoolPrivate
+{
+  /// \brief Loop run by each worker thread.
+  public: void WorkerLoop();
+
+  /// \brief Worker threads.
+  public: std::vector<std::thread> workers;
+
+  /// \brief Jobs which may still have chunks to claim.
+  public: std::deque<std::shared_ptr<Job>> jobs;
+
+  /// \brief Mutex protecting the jobs queue.
+  public: std::mutex mutex;
+
+  /// \brief Condition variable used to wake up workers.
+  public: std::condition_variable cv;
+
+  /// \brief Flag used to stop the workers.
+  public: bool stop{false};
+};
+
+using namespace ignition::gazebo;
+
+//////////////////////////////////////////////////
+void TaskPoolPrivate::WorkerLoop()
+{
+  while (true)
+  {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->cv.wait(lock, [this]
+      {
+        return this->stop || !this->jobs.empty();
+      });
+
+      if (this->stop)
+        return;
+
+      job = this->jobs.front();
+    }
+
+    // Keep working on the job until it runs out of chunks, then drop it from
+    // the queue so other jobs can be picked up.
+    while (job->RunChunk())
+    {
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->jobs.empty() && this->jobs.front() == job)
+      this->jobs.pop_front();
+  }
+}
+
+//////////////////////////////////////////////////
+TaskPool::TaskPool(unsigned int _threadCount,
+    const std::vector<unsigned int> &_cpus)
+  : dataPtr(std::make_unique<TaskPoolPrivate>())
+{
+  for (unsigned int i = 0; i < _threadCount; ++i)
+  {
+    this->dataPtr->workers.push_back(
+        std::thread(&TaskPoolPrivate::WorkerLoop, this->dataPtr.get()));
+  }
+
+  if (_cpus.empty() || this->dataPtr->workers.empty())
+    return;
+
+#ifdef __linux__
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (auto cpu : _cpus)
+    CPU_SET(cpu, &cpus);
+
+  for (auto &worker : this->dataPtr->workers)
+  {
+    int result = pthread_setaffinity_np(worker.native_handle(),
+        sizeof(cpus), &cpus);
+    if (result != 0)
+    {
+      ignwarn << "Failed to set the CPU affinity of a worker thread: "
+              << std::strerror(result) << std::endl;
+      break;
+    }
+  }
+#else
+  ignwarn << "CPU affinity is only supported on Linux, ignoring it."
+          << std::endl;
+#endif
+}
+
+//////////////////////////////////////////////////
+TaskPool::~TaskPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->cv.notify_all();
+
+  for (auto &worker : this->dataPtr->workers)
+    worker.join();
+}
+
+//////////////////////////////////////////////////
+unsigned int TaskPool::ThreadCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->workers.size());
+}
+
+//////////////////////////////////////////////////
+void TaskPool::ParallelFor(std::size_t _count, std::size_t _grainSize,
+    const Task &_task)
+{
+  if (_count == 0)
+    return;
+
+  _grainSize = std::max<std::size_t>(_grainSize, 1u);
+
+  // Short-cut if there's a single chunk or nobody to share it with
+  if (_count <= _grainSize || this->dataPtr->workers.empty())
+  {
+    _task(0, _count);
+    return;
+  }
+
+  auto job = std::make_shared<Job>(_count, _grainSize, _task);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->jobs.push_back(job);
+  }
+  this->dataPtr->cv.notify_all();
+
+  // The calling thread works on its own job too
+  while (job->RunChunk())
+  {
+  }
+
+  job->Wait();
+
+  // Make sure the job doesn't linger in the queue
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = std::find(this->dataPtr->jobs.begin(),
+      this->dataPtr->jobs.end(), job);
+  if (iter != this->dataPtr->jobs.end())
+    this->dataPtr->jobs.erase(iter);
+}
+
+//////////////////////////////////////////////////
+TaskPool &TaskPool::Shared()
+{
+  static TaskPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+  return pool;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_TASKPOOL_HH_
+#define IGNITION_GAZEBO_TASKPOOL_HH_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class TaskPoolPrivate;
+
+    /// \class TaskPool TaskPool.hh
+    /// \brief A pool of persistent worker threads that splits ranges of work
+    /// into chunks and runs them concurrently.
+    ///
+    /// Unlike common::WorkerPool, no work order is allocated per task, and
+    /// the calling thread takes part in the work, so the pool can be used
+    /// from within one of its own tasks without deadlocking. Multiple threads
+    /// can submit work at the same time.
+    class IGNITION_GAZEBO_VISIBLE TaskPool
+    {
+      /// \brief Signature of a task. It receives the half-open range of
+      /// indices [_begin, _end) it should process.
+      public: using Task = std::function<void(std::size_t _begin,
+          std::size_t _end)>;
+
+      /// \brief Constructor
+      /// \param[in] _threadCount Number of worker threads, not counting the
+      /// threads that submit work. Zero runs all work on the calling thread.
+      /// \param[in] _cpus CPUs the worker threads are pinned to, empty to
+      /// not pin them. Pinning is only supported on Linux.
+      public: explicit TaskPool(unsigned int _threadCount,
+                  const std::vector<unsigned int> &_cpus = {});
+
+      /// \brief Destructor. Joins all worker threads.
+      public: ~TaskPool();
+
+      /// \brief Get the number of worker threads.
+      /// \return Number of worker threads.
+      public: unsigned int ThreadCount() const;
+
+      /// \brief Run a task over the range [0, _count), split in chunks of at
+      /// most _grainSize indices. This blocks until all chunks are done.
+      /// \param[in] _count Number of indices to process.
+      /// \param[in] _grainSize Maximum number of indices per chunk. Zero is
+      /// treated as one.
+      /// \param[in] _task Task to run on each chunk. It may be called
+      /// concurrently from multiple threads.
+      public: void ParallelFor(std::size_t _count, std::size_t _grainSize,
+          const Task &_task);
+
+      /// \brief Get a pool shared by the whole process, with one worker
+      /// thread per hardware thread, minus the calling thread.
+      /// \return The shared pool.
+      public: static TaskPool &Shared();
+
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<TaskPoolPrivate> dataPtr;
+    };
+    }  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
+  }  // namespace gazebo
+}  // namespace ignition
+
+#endif  // IGNITION_GAZEBO_TASKPOOL_HH_
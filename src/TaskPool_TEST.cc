@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "TaskPool.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+TEST(TaskPool, ParallelFor)
+{
+  TaskPool pool(4);
+  EXPECT_EQ(4u, pool.ThreadCount());
+
+  std::vector<int> values(1001, 0);
+  pool.ParallelFor(values.size(), 10,
+      [&](std::size_t _begin, std::size_t _end)
+      {
+        EXPECT_LE(_end - _begin, 10u);
+        for (std::size_t i = _begin; i < _end; ++i)
+          ++values[i];
+      });
+
+  // Each index is visited exactly once
+  for (const auto &value : values)
+    EXPECT_EQ(1, value);
+}
+
+/////////////////////////////////////////////////
+TEST(TaskPool, EmptyAndSingleChunk)
+{
+  TaskPool pool(2);
+
+  pool.ParallelFor(0, 10, [&](std::size_t, std::size_t)
+      {
+        FAIL() << "Task shouldn't be called for an empty range";
+      });
+
+  int calls{0};
+  pool.ParallelFor(5, 10, [&](std::size_t _begin, std::size_t _end)
+      {
+        EXPECT_EQ(0u, _begin);
+        EXPECT_EQ(5u, _end);
+        ++calls;
+      });
+  EXPECT_EQ(1, calls);
+
+  // A zero grain size is treated as one
+  std::atomic<int> count{0};
+  pool.ParallelFor(5, 0, [&](std::size_t _begin, std::size_t _end)
+      {
+        EXPECT_EQ(1u, _end - _begin);
+        ++count;
+      });
+  EXPECT_EQ(5, count);
+}
+
+/////////////////////////////////////////////////
+TEST(TaskPool, NoWorkers)
+{
+  TaskPool pool(0);
+  EXPECT_EQ(0u, pool.ThreadCount());
+
+  auto id = std::this_thread::get_id();
+  int count{0};
+  pool.ParallelFor(100, 3, [&](std::size_t _begin, std::size_t _end)
+      {
+        EXPECT_EQ(id, std::this_thread::get_id());
+        count += static_cast<int>(_end - _begin);
+      });
+  EXPECT_EQ(100, count);
+}
+
+/////////////////////////////////////////////////
+TEST(TaskPool, NestedAndConcurrent)
+{
+  TaskPool pool(3);
+  std::atomic<int> count{0};
+
+  // Submit from several threads, each spawning nested work from the tasks
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.push_back(std::thread([&]()
+    {
+      for (int r = 0; r < 10; ++r)
+      {
+        pool.ParallelFor(20, 3, [&](std::size_t _begin, std::size_t _end)
+            {
+              pool.ParallelFor(_end - _begin, 1,
+                  [&](std::size_t _b, std::size_t _e)
+                  {
+                    count += static_cast<int>(_e - _b);
+                  });
+            });
+      }
+    }));
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_EQ(4 * 10 * 20, count);
+}
+
+/////////////////////////////////////////////////
+TEST(TaskPool, Shared)
+{
+  auto &pool = TaskPool::Shared();
+  EXPECT_EQ(&pool, &TaskPool::Shared());
+
+  std::atomic<int> count{0};
+  pool.ParallelFor(100, 7, [&](std::size_t _begin, std::size_t _end)
+      {
+        count += static_cast<int>(_end - _begin);
+      });
+  EXPECT_EQ(100, count);
+}
+
+/////////////////////////////////////////////////
+TEST(TaskPool, CpuAffinity)
+{
+  TaskPool pool(2, {0u});
+  EXPECT_EQ(2u, pool.ThreadCount());
+
+  const auto caller = std::this_thread::get_id();
+  std::atomic<int> count{0};
+  std::atomic<int> unpinned{0};
+  pool.ParallelFor(100, 1, [&](std::size_t _begin, std::size_t _end)
+      {
+        count += static_cast<int>(_end - _begin);
+#ifdef __linux__
+        // Workers only run on CPU 0
+        if (std::this_thread::get_id() == caller)
+          return;
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (CPU_COUNT(&cpus) != 1 || !CPU_ISSET(0, &cpus))
+          ++unpinned;
+#endif
+      });
+  EXPECT_EQ(100, count);
+  EXPECT_EQ(0, unpinned);
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "TimingHistogram.hh"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ignition;
+using namespace gazebo;
+
+//////////////////////////////////////////////////
+void TimingHistogram::Add(std::chrono::steady_clock::duration _duration)
+{
+  const auto ns = static_cast<uint64_t>(std::max<int64_t>(0,
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+      _duration).count()));
+
+  ++this->buckets[Bucket(ns)];
+  ++this->count;
+  this->sum += ns;
+  this->max = std::max(this->max, ns);
+  this->last = ns;
+}
+
+//////////////////////////////////////////////////
+void TimingHistogram::Reset()
+{
+  this->buckets.fill(0);
+  this->count = 0;
+  this->sum = 0;
+  this->max = 0;
+  this->last = 0;
+}
+
+//////////////////////////////////////////////////
+uint64_t TimingHistogram::Count() const
+{
+  return this->count;
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds TimingHistogram::Mean() const
+{
+  if (this->count == 0)
+    return std::chrono::nanoseconds::zero();
+  return std::chrono::nanoseconds(this->sum / this->count);
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds TimingHistogram::Max() const
+{
+  return std::chrono::nanoseconds(this->max);
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds TimingHistogram::Last() const
+{
+  return std::chrono::nanoseconds(this->last);
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds TimingHistogram::Percentile(double _fraction) const
+{
+  if (this->count == 0)
+    return std::chrono::nanoseconds::zero();
+
+  // Number of samples which must be shorter or equal to the result
+  const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(
+      std::ceil(std::clamp(_fraction, 0.0, 1.0) * this->count)));
+
+  uint64_t seen{0};
+  for (std::size_t i = 0; i < kBucketCount; ++i)
+  {
+    seen += this->buckets[i];
+    if (seen >= rank)
+    {
+      return std::chrono::nanoseconds(
+          std::min(BucketUpperBound(i), this->max));
+    }
+  }
+  return std::chrono::nanoseconds(this->max);
+}
+
+//////////////////////////////////////////////////
+std::size_t TimingHistogram::Bucket(uint64_t _ns)
+{
+  if (_ns < 4)
+    return static_cast<std::size_t>(_ns);
+
+  // Position of the most significant bit
+  std::size_t msb{2};
+  while (msb < 63 && (_ns >> (msb + 1)) != 0)
+    ++msb;
+
+  // The 2 bits after the most significant one pick the bucket within its
+  // power of two.
+  const std::size_t sub = (_ns >> (msb - 2)) & 3;
+  return 4 + (msb - 2) * 4 + sub;
+}
+
+//////////////////////////////////////////////////
+uint64_t TimingHistogram::BucketUpperBound(std::size_t _bucket)
+{
+  if (_bucket < 4)
+    return _bucket;
+
+  const std::size_t msb = (_bucket - 4) / 4 + 2;
+  const uint64_t sub = (_bucket - 4) % 4;
+  const uint64_t width = uint64_t{1} << (msb - 2);
+  return (4 + sub) * width + width - 1;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_TIMINGHISTOGRAM_HH_
+#define IGNITION_GAZEBO_TIMINGHISTOGRAM_HH_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    /// \class TimingHistogram TimingHistogram.hh
+    /// \brief Accumulates durations into logarithmic buckets, so that the
+    /// mean, maximum and percentiles of many samples can be reported without
+    /// storing the samples.
+    ///
+    /// Each power of two is split into 4 buckets, so percentiles are
+    /// reported with an error below 25%. Adding a sample doesn't allocate
+    /// and takes constant time, so it's cheap enough to time every system on
+    /// every step. A histogram must not be modified from multiple threads at
+    /// the same time.
+    class IGNITION_GAZEBO_VISIBLE TimingHistogram
+    {
+      /// \brief Add a sample.
+      /// \param[in] _duration Duration to add. Negative values count as 0.
+      public: void Add(std::chrono::steady_clock::duration _duration);
+
+      /// \brief Remove all samples.
+      public: void Reset();
+
+      /// \brief Get the number of samples.
+      /// \return Number of samples added since the last reset.
+      public: uint64_t Count() const;
+
+      /// \brief Get the mean of the samples.
+      /// \return Mean duration, or 0 if there are no samples.
+      public: std::chrono::nanoseconds Mean() const;
+
+      /// \brief Get the longest sample.
+      /// \return Maximum duration, or 0 if there are no samples.
+      public: std::chrono::nanoseconds Max() const;
+
+      /// \brief Get the latest sample.
+      /// \return Duration of the last sample added, or 0 if there are no
+      /// samples.
+      public: std::chrono::nanoseconds Last() const;
+
+      /// \brief Estimate a percentile of the samples.
+      /// \param[in] _fraction Fraction of samples, in [0, 1], which are
+      /// shorter or equal to the returned duration. For example, 0.99 for
+      /// the 99th percentile.
+      /// \return Upper bound of the bucket holding the percentile, clamped to
+      /// the maximum, or 0 if there are no samples.
+      public: std::chrono::nanoseconds Percentile(double _fraction) const;
+
+      /// \brief Get the bucket holding a duration.
+      /// \param[in] _ns Duration in nanoseconds.
+      /// \return Index of the bucket.
+      private: static std::size_t Bucket(uint64_t _ns);
+
+      /// \brief Get the longest duration held by a bucket.
+      /// \param[in] _bucket Index of the bucket.
+      /// \return Duration in nanoseconds.
+      private: static uint64_t BucketUpperBound(std::size_t _bucket);
+
+      /// \brief Number of buckets. Durations below 4ns have a bucket each,
+      /// and each following power of two has 4 buckets.
+      private: static constexpr std::size_t kBucketCount = 4 + 62 * 4;
+
+      /// \brief Number of samples in each bucket.
+      private: std::array<uint64_t, kBucketCount> buckets{};
+
+      /// \brief Number of samples.
+      private: uint64_t count{0};
+
+      /// \brief Sum of the samples, in nanoseconds.
+      private: uint64_t sum{0};
+
+      /// \brief Longest sample, in nanoseconds.
+      private: uint64_t max{0};
+
+      /// \brief Latest sample, in nanoseconds.
+      private: uint64_t last{0};
+    };
+    }  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
+  }  // namespace gazebo
+}  // namespace ignition
+
+#endif  // IGNITION_GAZEBO_TIMINGHISTOGRAM_HH_
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <limits>
+
+#include "TimingHistogram.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace std::chrono_literals;
+
+/////////////////////////////////////////////////
+TEST(TimingHistogram, Empty)
+{
+  TimingHistogram histogram;
+  EXPECT_EQ(0u, histogram.Count());
+  EXPECT_EQ(0ns, histogram.Mean());
+  EXPECT_EQ(0ns, histogram.Max());
+  EXPECT_EQ(0ns, histogram.Last());
+  EXPECT_EQ(0ns, histogram.Percentile(0.5));
+}
+
+/////////////////////////////////////////////////
+TEST(TimingHistogram, Stats)
+{
+  TimingHistogram histogram;
+
+  // 98 short samples and 2 long ones
+  for (int i = 0; i < 98; ++i)
+    histogram.Add(100us);
+  histogram.Add(10ms);
+  histogram.Add(20ms);
+
+  EXPECT_EQ(100u, histogram.Count());
+  EXPECT_EQ(20ms, histogram.Max());
+  EXPECT_EQ(20ms, histogram.Last());
+  EXPECT_EQ(std::chrono::nanoseconds(98 * 100us + 30ms) / 100,
+      histogram.Mean());
+
+  // Percentiles are bucket upper bounds, within 25% of the samples
+  auto p50 = histogram.Percentile(0.5);
+  EXPECT_GE(p50, 100us);
+  EXPECT_LE(p50, 125us);
+
+  auto p99 = histogram.Percentile(0.99);
+  EXPECT_GE(p99, 10ms);
+  EXPECT_LE(p99, 12500us);
+
+  EXPECT_EQ(20ms, histogram.Percentile(1.0));
+  EXPECT_LE(histogram.Percentile(0.0), 125us);
+
+  histogram.Reset();
+  EXPECT_EQ(0u, histogram.Count());
+  EXPECT_EQ(0ns, histogram.Max());
+  EXPECT_EQ(0ns, histogram.Last());
+  EXPECT_EQ(0ns, histogram.Percentile(0.99));
+}
+
+/////////////////////////////////////////////////
+TEST(TimingHistogram, Extremes)
+{
+  TimingHistogram histogram;
+  histogram.Add(-1ms);
+  histogram.Add(0ns);
+  histogram.Add(3ns);
+  histogram.Add(std::chrono::nanoseconds(
+      std::numeric_limits<int64_t>::max()));
+
+  EXPECT_EQ(4u, histogram.Count());
+  EXPECT_EQ(0ns, histogram.Percentile(0.5));
+  EXPECT_EQ(3ns, histogram.Percentile(0.75));
+  EXPECT_EQ(std::chrono::nanoseconds::max(), histogram.Max());
+  EXPECT_EQ(std::chrono::nanoseconds::max(), histogram.Percentile(1.0));
+}
@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "Tracer.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace ignition;
+using namespace gazebo;
+
+namespace
+{
+/// \brief One recorded event. The fields are atomics so that a dump can
+/// read them while the owning thread overwrites them.
+struct TraceEvent
+{
+  /// \brief ID of the event name.
+  std::atomic<uint32_t> nameId{0};
+
+  /// \brief Start time, in steady clock nanoseconds.
+  std::atomic<int64_t> start{0};
+
+  /// \brief End time, in steady clock nanoseconds.
+  std::atomic<int64_t> end{0};
+};
+
+/// \brief Ring buffer of the events of one thread. Only the owning thread
+/// writes to it.
+struct ThreadBuffer
+{
+  /// \brief Constructor
+  /// \param[in] _capacity Number of events kept.
+  /// \param[in] _epoch Registry epoch the buffer was created in.
+  /// \param[in] _tid Thread ID used in the trace.
+  ThreadBuffer(std::size_t _capacity, uint64_t _epoch, uint32_t _tid)
+    : events(new TraceEvent[_capacity + 1]), capacity(_capacity),
+      slots(_capacity + 1), epoch(_epoch), tid(_tid)
+  {
+  }
+
+  /// \brief Events, indexed by event count modulo the number of slots.
+  std::unique_ptr<TraceEvent[]> events;
+
+  /// \brief Number of events kept.
+  std::size_t capacity;
+
+  /// \brief Number of slots. There's one more than events kept, for the
+  /// event being recorded while a dump reads the others.
+  std::size_t slots;
+
+  /// \brief Registry epoch the buffer was created in.
+  uint64_t epoch;
+
+  /// \brief Thread ID used in the trace.
+  uint32_t tid;
+
+  /// \brief Number of events recorded so far.
+  std::atomic<uint64_t> head{0};
+
+  /// \brief True once the owning thread exited.
+  std::atomic<bool> exited{false};
+};
+
+/// \brief Names and buffers shared by all threads.
+struct TraceRegistry
+{
+  /// \brief Protects everything but the atomics.
+  std::mutex mutex;
+
+  /// \brief Event names, indexed by ID.
+  std::vector<std::string> names;
+
+  /// \brief Event name IDs, by name.
+  std::unordered_map<std::string, uint32_t> nameIds;
+
+  /// \brief Buffers of all threads which recorded in the current epoch.
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+  /// \brief Number of events kept per thread.
+  std::size_t capacity{0};
+
+  /// \brief Incremented whenever the capacity changes, which makes threads
+  /// allocate new buffers.
+  std::atomic<uint64_t> epoch{0};
+
+  /// \brief Thread ID given to the next buffer.
+  uint32_t nextTid{0};
+};
+
+/// \brief Buffers of exited threads kept for dumps. Threads of the task
+/// pool live as long as the server, so this only bounds short-lived
+/// threads.
+constexpr std::size_t kMaxExitedBuffers{16};
+
+//////////////////////////////////////////////////
+/// \brief Get the registry. It's never destroyed, so that threads exiting
+/// after static destruction can still use it.
+/// \return The registry.
+TraceRegistry &registry()
+{
+  static auto *reg = new TraceRegistry;
+  return *reg;
+}
+
+/// \brief Holds the buffer of a thread, and marks it when the thread exits.
+struct ThreadBufferHolder
+{
+  /// \brief Destructor
+  ~ThreadBufferHolder()
+  {
+    if (this->buffer)
+      this->buffer->exited = true;
+  }
+
+  /// \brief Buffer of the thread.
+  std::shared_ptr<ThreadBuffer> buffer;
+};
+
+/// \brief Buffer of the calling thread.
+thread_local ThreadBufferHolder tlsBuffer;
+
+//////////////////////////////////////////////////
+/// \brief Get the buffer of the calling thread, allocating it if needed.
+/// \return The buffer, or null if tracing isn't enabled.
+ThreadBuffer *threadBuffer()
+{
+  auto &reg = registry();
+  auto &holder = tlsBuffer;
+  if (holder.buffer && holder.buffer->epoch == reg.epoch.load())
+    return holder.buffer.get();
+
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  if (reg.capacity == 0)
+    return nullptr;
+
+  // Drop the oldest buffers of exited threads
+  std::size_t exited = std::count_if(reg.buffers.begin(), reg.buffers.end(),
+      [](const auto &_buffer) { return _buffer->exited.load(); });
+  for (auto it = reg.buffers.begin();
+       it != reg.buffers.end() && exited > kMaxExitedBuffers;)
+  {
+    if ((*it)->exited)
+    {
+      it = reg.buffers.erase(it);
+      --exited;
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  holder.buffer = std::make_shared<ThreadBuffer>(reg.capacity,
+      reg.epoch.load(), reg.nextTid++);
+  reg.buffers.push_back(holder.buffer);
+  return holder.buffer.get();
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a string as a JSON string literal.
+/// \param[out] _out Stream to write to.
+/// \param[in] _str String to write.
+void writeJsonString(std::ostream &_out, const std::string &_str)
+{
+  _out << '"';
+  for (char c : _str)
+  {
+    if (c == '"' || c == '\\')
+      _out << '\\' << c;
+    else if (static_cast<unsigned char>(c) < 0x20)
+      _out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+           << static_cast<int>(c) << std::dec << std::setfill(' ');
+    else
+      _out << c;
+  }
+  _out << '"';
+}
+}
+
+//////////////////////////////////////////////////
+void Tracer::Enable(std::size_t _eventsPerThread)
+{
+  auto &reg = registry();
+  {
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (reg.capacity != _eventsPerThread)
+    {
+      reg.capacity = _eventsPerThread;
+      reg.buffers.clear();
+      reg.nextTid = 0;
+      reg.epoch++;
+    }
+  }
+  enabled = _eventsPerThread > 0;
+}
+
+//////////////////////////////////////////////////
+void Tracer::Disable()
+{
+  enabled = false;
+}
+
+//////////////////////////////////////////////////
+uint32_t Tracer::NameId(const std::string &_name)
+{
+  auto &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  auto it = reg.nameIds.find(_name);
+  if (it != reg.nameIds.end())
+    return it->second;
+
+  const auto id = static_cast<uint32_t>(reg.names.size());
+  reg.names.push_back(_name);
+  reg.nameIds[_name] = id;
+  return id;
+}
+
+//////////////////////////////////////////////////
+void Tracer::Record(uint32_t _nameId,
+    const std::chrono::steady_clock::time_point &_start,
+    const std::chrono::steady_clock::time_point &_end)
+{
+  if (!Enabled())
+    return;
+
+  auto *buffer = threadBuffer();
+  if (nullptr == buffer)
+    return;
+
+  const uint64_t index = buffer->head.load(std::memory_order_relaxed);
+  auto &event = buffer->events[index % buffer->slots];
+
+  // Pairs with the fence in WriteChromeTrace, so that a dump which reads
+  // this event while it's being overwritten also sees the head moved past
+  // it, and skips it.
+  std::atomic_thread_fence(std::memory_order_release);
+  event.nameId.store(_nameId, std::memory_order_relaxed);
+  event.start.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      _start.time_since_epoch()).count(), std::memory_order_relaxed);
+  event.end.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      _end.time_since_epoch()).count(), std::memory_order_relaxed);
+  buffer->head.store(index + 1, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////
+std::size_t Tracer::WriteChromeTrace(std::ostream &_out)
+{
+  auto &reg = registry();
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  std::vector<std::string> names;
+  {
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    buffers = reg.buffers;
+    names = reg.names;
+  }
+
+  struct Event
+  {
+    uint32_t nameId;
+    int64_t start;
+    int64_t end;
+  };
+
+  const auto flags = _out.flags();
+  const auto precision = _out.precision();
+
+  std::size_t count{0};
+  _out << "{\"traceEvents\":[";
+  _out << std::fixed << std::setprecision(3);
+  for (const auto &buffer : buffers)
+  {
+    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+    const uint64_t first =
+        head > buffer->capacity ? head - buffer->capacity : 0;
+
+    std::vector<Event> events;
+    events.reserve(head - first);
+    for (uint64_t i = first; i < head; ++i)
+    {
+      const auto &event = buffer->events[i % buffer->slots];
+      events.push_back({event.nameId.load(std::memory_order_relaxed),
+          event.start.load(std::memory_order_relaxed),
+          event.end.load(std::memory_order_relaxed)});
+    }
+
+    // Events the thread started overwriting while they were read are
+    // skipped. The slot of the event being recorded holds the event one
+    // buffer length before it.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t newHead = buffer->head.load(std::memory_order_relaxed);
+    const uint64_t firstValid =
+        newHead >= buffer->slots ? newHead - buffer->slots + 1 : 0;
+
+    for (uint64_t i = std::max(first, firstValid); i < head; ++i)
+    {
+      const auto &event = events[i - first];
+      if (event.nameId >= names.size())
+        continue;
+
+      if (count > 0)
+        _out << ",";
+      _out << "\n{\"name\":";
+      writeJsonString(_out, names[event.nameId]);
+      _out << ",\"cat\":\"gazebo\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+           << buffer->tid
+           << ",\"ts\":" << event.start / 1000.0
+           << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+      ++count;
+    }
+  }
+  _out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  _out.flags(flags);
+  _out.precision(precision);
+  return count;
+}
+
+//////////////////////////////////////////////////
+bool Tracer::WriteChromeTrace(const std::string &_path)
+{
+  std::ofstream out(_path);
+  if (!out)
+    return false;
+
+  WriteChromeTrace(out);
+  return out.good();
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_TRACER_HH_
+#define IGNITION_GAZEBO_TRACER_HH_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    /// \class Tracer Tracer.hh
+    /// \brief Always available, low-overhead tracing of scoped events.
+    ///
+    /// Unlike IGN_PROFILE, which needs the Remotery profiler compiled in and
+    /// attached, the tracer can be enabled on any build, and the last events
+    /// can be dumped at any time, for example right after a live server
+    /// stutters.
+    ///
+    /// Each thread records into its own ring buffer, so recording doesn't
+    /// lock nor allocate, and only the latest events of each thread are
+    /// kept. When tracing is disabled, a scope costs one relaxed atomic load.
+    ///
+    /// Events are recorded with IGN_GAZEBO_TRACE, or with Record for events
+    /// which were timed anyway. They're dumped in the Chrome trace event
+    /// format, which can be opened with chrome://tracing or Perfetto.
+    class IGNITION_GAZEBO_VISIBLE Tracer
+    {
+      /// \brief Start recording events.
+      /// \param[in] _eventsPerThread Number of events kept per thread. The
+      /// buffers of threads which already recorded are reallocated if the
+      /// number changes.
+      public: static void Enable(std::size_t _eventsPerThread);
+
+      /// \brief Stop recording events. Events recorded so far are kept
+      /// until the next Enable.
+      public: static void Disable();
+
+      /// \brief Get whether events are being recorded.
+      /// \return True if enabled.
+      public: static bool Enabled()
+      {
+        return enabled.load(std::memory_order_relaxed);
+      }
+
+      /// \brief Get the ID of an event name, registering the name if it's
+      /// new. This locks, so IDs should be looked up once and kept.
+      /// \param[in] _name Event name.
+      /// \return Name ID.
+      public: static uint32_t NameId(const std::string &_name);
+
+      /// \brief Record an event on the calling thread's buffer. Does nothing
+      /// if tracing is disabled.
+      /// \param[in] _nameId ID of the event name, from NameId.
+      /// \param[in] _start Start of the event.
+      /// \param[in] _end End of the event.
+      public: static void Record(uint32_t _nameId,
+                  const std::chrono::steady_clock::time_point &_start,
+                  const std::chrono::steady_clock::time_point &_end);
+
+      /// \brief Write the recorded events of all threads in the Chrome
+      /// trace event format. Recording may continue meanwhile, events
+      /// overwritten while they're being read are skipped.
+      /// \param[out] _out Stream to write to.
+      /// \return Number of events written.
+      public: static std::size_t WriteChromeTrace(std::ostream &_out);
+
+      /// \brief Write the recorded events of all threads to a file, in the
+      /// Chrome trace event format.
+      /// \param[in] _path Path of the file.
+      /// \return True if the file was written.
+      public: static bool WriteChromeTrace(const std::string &_path);
+
+      /// \brief Whether events are being recorded.
+      private: inline static std::atomic<bool> enabled{false};
+    };
+
+    /// \brief Records an event from construction to destruction, if tracing
+    /// is enabled when the scope starts. Use IGN_GAZEBO_TRACE instead of
+    /// creating it directly.
+    class TraceScope
+    {
+      /// \brief Constructor
+      /// \param[in] _nameId ID of the event name, from Tracer::NameId.
+      public: explicit TraceScope(uint32_t _nameId)
+        : nameId(_nameId)
+      {
+        if (Tracer::Enabled())
+          this->start = std::chrono::steady_clock::now();
+      }
+
+      /// \brief Destructor, records the event.
+      public: ~TraceScope()
+      {
+        if (this->start.time_since_epoch().count() != 0)
+        {
+          Tracer::Record(this->nameId, this->start,
+              std::chrono::steady_clock::now());
+        }
+      }
+
+      /// \brief ID of the event name.
+      private: uint32_t nameId;
+
+      /// \brief Start of the event, zero if tracing was disabled.
+      private: std::chrono::steady_clock::time_point start;
+    };
+    }  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
+  }  // namespace gazebo
+}  // namespace ignition
+
+#define IGN_GAZEBO_TRACE_CONCAT_(a, b) a##b
+#define IGN_GAZEBO_TRACE_CONCAT(a, b) IGN_GAZEBO_TRACE_CONCAT_(a, b)
+
+/// \brief Trace the rest of the enclosing scope, see Tracer. The name is
+/// registered the first time the line runs.
+/// \param[in] _name Event name.
+#define IGN_GAZEBO_TRACE(_name) \
+  static const uint32_t IGN_GAZEBO_TRACE_CONCAT(ignTraceId, __LINE__) = \
+      ignition::gazebo::Tracer::NameId(_name); \
+  ignition::gazebo::TraceScope IGN_GAZEBO_TRACE_CONCAT(ignTrace, __LINE__)( \
+      IGN_GAZEBO_TRACE_CONCAT(ignTraceId, __LINE__))
+
+#endif  // IGNITION_GAZEBO_TRACER_HH_
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "Tracer.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+/// \brief Count the occurrences of a string.
+/// \param[in] _str String to search.
+/// \param[in] _sub String to count.
+/// \return Number of occurrences.
+std::size_t countOf(const std::string &_str, const std::string &_sub)
+{
+  std::size_t count{0};
+  for (auto pos = _str.find(_sub); pos != std::string::npos;
+       pos = _str.find(_sub, pos + _sub.size()))
+  {
+    ++count;
+  }
+  return count;
+}
+
+/////////////////////////////////////////////////
+/// \brief Dump the trace to a string.
+/// \param[out] _count Number of events.
+/// \return The trace.
+std::string dump(std::size_t &_count)
+{
+  std::ostringstream out;
+  _count = Tracer::WriteChromeTrace(out);
+  return out.str();
+}
+
+/////////////////////////////////////////////////
+TEST(Tracer, Disabled)
+{
+  Tracer::Disable();
+  EXPECT_FALSE(Tracer::Enabled());
+
+  // Reallocate the buffers, so events from other tests are dropped
+  Tracer::Enable(7);
+  Tracer::Disable();
+
+  {
+    IGN_GAZEBO_TRACE("disabled");
+  }
+
+  std::size_t count{0};
+  auto trace = dump(count);
+  EXPECT_EQ(0u, count);
+  EXPECT_EQ(0u, countOf(trace, "disabled"));
+}
+
+/////////////////////////////////////////////////
+TEST(Tracer, RingBuffer)
+{
+  Tracer::Enable(4);
+  EXPECT_TRUE(Tracer::Enabled());
+
+  // Same name, same ID
+  auto id = Tracer::NameId("ring \"event\"");
+  EXPECT_EQ(id, Tracer::NameId("ring \"event\""));
+  EXPECT_NE(id, Tracer::NameId("other"));
+
+  for (int i = 0; i < 10; ++i)
+  {
+    IGN_GAZEBO_TRACE("ring \"event\"");
+  }
+
+  // Only the last events are kept
+  std::size_t count{0};
+  auto trace = dump(count);
+  EXPECT_EQ(4u, count);
+  EXPECT_EQ(4u, countOf(trace, "\"name\":\"ring \\\"event\\\"\""));
+  EXPECT_EQ(0u, trace.find("{\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, trace.find("\"ph\":\"X\""));
+
+  Tracer::Disable();
+}
+
+/////////////////////////////////////////////////
+TEST(Tracer, Threads)
+{
+  Tracer::Enable(16);
+
+  auto id = Tracer::NameId("thread");
+  auto record = [&]()
+  {
+    auto now = std::chrono::steady_clock::now();
+    Tracer::Record(id, now, now + std::chrono::microseconds(5));
+  };
+
+  record();
+  std::thread t1(record);
+  std::thread t2(record);
+  t1.join();
+  t2.join();
+
+  // Events of exited threads are kept, each thread has its own ID
+  std::size_t count{0};
+  auto trace = dump(count);
+  EXPECT_EQ(3u, count);
+  EXPECT_EQ(3u, countOf(trace, "\"dur\":5.000"));
+  EXPECT_EQ(1u, countOf(trace, "\"tid\":0,"));
+  EXPECT_EQ(1u, countOf(trace, "\"tid\":1,"));
+  EXPECT_EQ(1u, countOf(trace, "\"tid\":2,"));
+
+  Tracer::Disable();
+}
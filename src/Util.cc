@@ -22,7 +22,13 @@
     #include <filesystem>
   #endif
 #endif
+#include <algorithm>
+#include <memory>
+
+#include <ignition/common/ColladaLoader.hh>
 #include <ignition/common/Filesystem.hh>
+#include <ignition/common/OBJLoader.hh>
+#include <ignition/common/STLLoader.hh>
 #include <ignition/common/StringUtils.hh>
 #include <ignition/transport/TopicUtils.hh>
 
@@ -439,6 +445,38 @@ std::string validTopic(const std::vector<std::string> &_topics)
   }
   return std::string();
 }
+
+//////////////////////////////////////////////////
+std::unique_ptr<common::Mesh> parseMeshFile(const std::string &_fullPath)
+{
+  if (!common::isFile(_fullPath))
+  {
+    ignerr << "Mesh file [" << _fullPath << "] not found." << std::endl;
+    return nullptr;
+  }
+
+  auto extension = common::lowercase(
+      _fullPath.substr(_fullPath.rfind('.') + 1));
+
+  std::unique_ptr<common::MeshLoader> loader;
+  if (extension == "dae")
+    loader = std::make_unique<common::ColladaLoader>();
+  else if (extension == "stl" || extension == "stlb" || extension == "stla")
+    loader = std::make_unique<common::STLLoader>();
+  else if (extension == "obj")
+    loader = std::make_unique<common::OBJLoader>();
+  else
+  {
+    ignerr << "Unsupported mesh format for file [" << _fullPath << "]."
+           << std::endl;
+    return nullptr;
+  }
+
+  std::unique_ptr<common::Mesh> mesh(loader->Load(_fullPath));
+  if (mesh)
+    mesh->SetName(_fullPath);
+  return mesh;
+}
 }
 }
 }
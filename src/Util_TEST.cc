@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/MeshManager.hh>
 #include <sdf/Actor.hh>
 #include <sdf/Light.hh>
 
@@ -33,6 +35,7 @@
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/Util.hh"
+#include "ignition/gazebo/test_config.hh"
 
 using namespace ignition;
 using namespace gazebo;
@@ -510,3 +513,23 @@ TEST_F(UtilTest, ValidTopic)
   EXPECT_EQ("not_bad", validTopic({fixable, invalid, good}));
   EXPECT_EQ("good", validTopic({invalid, good, fixable}));
 }
+
+/////////////////////////////////////////////////
+TEST_F(UtilTest, ParseMeshFile)
+{
+  const std::string path = common::joinPaths(PROJECT_SOURCE_PATH, "test",
+      "media", "duck.dae");
+
+  auto mesh = parseMeshFile(path);
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(path, mesh->Name());
+  EXPECT_LT(0u, mesh->SubMeshCount());
+
+  // The mesh is owned by the caller, not the MeshManager
+  EXPECT_FALSE(common::MeshManager::Instance()->HasMesh(path));
+
+  EXPECT_EQ(nullptr, parseMeshFile(
+      common::joinPaths(PROJECT_SOURCE_PATH, "does_not_exist.dae")));
+  EXPECT_EQ(nullptr, parseMeshFile(
+      common::joinPaths(PROJECT_SOURCE_PATH, "test", "media", "duck.png")));
+}
@@ -14,6 +14,9 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <iterator>
+
 #include "ignition/gazebo/detail/View.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 
@@ -21,10 +24,29 @@ using namespace ignition;
 using namespace gazebo;
 using namespace detail;
 
+//////////////////////////////////////////////////
+View::View(const ComponentTypeKey &_types,
+    const ComponentTypeKey &_optionalTypes)
+{
+  std::set_union(_types.begin(), _types.end(),
+      _optionalTypes.begin(), _optionalTypes.end(),
+      std::back_inserter(this->componentTypes));
+}
+
 //////////////////////////////////////////////////
 void View::AddEntity(const Entity _entity, const bool _new)
 {
-  this->entities.insert(_entity);
+  auto iter = std::lower_bound(this->entities.begin(), this->entities.end(),
+      _entity);
+  if (iter == this->entities.end() || *iter != _entity)
+  {
+    const std::size_t index = iter - this->entities.begin();
+    const std::size_t typeCount = this->componentTypes.size();
+    this->entities.insert(iter, _entity);
+    this->componentIds.insert(this->componentIds.begin() + index * typeCount,
+        typeCount, kComponentIdInvalid);
+  }
+
   if (_new)
   {
     this->newEntities.insert(_entity);
@@ -36,36 +58,138 @@ void View::AddComponent(const Entity _entity,
     const ComponentTypeId _typeId,
     const ComponentId _componentId)
 {
-  this->components.insert(
-      std::make_pair(std::make_pair(_entity, _typeId), _componentId));
+  const std::size_t index = this->EntityIndex(_entity);
+  const std::size_t column = this->TypeColumn(_typeId);
+  if (index >= this->entities.size() ||
+      column >= this->componentTypes.size())
+  {
+    return;
+  }
+
+  this->componentIds[index * this->componentTypes.size() + column] =
+      _componentId;
 }
 
 //////////////////////////////////////////////////
-bool View::RemoveEntity(const Entity _entity, const ComponentTypeKey &_key)
+bool View::RemoveEntity(const Entity _entity, const ComponentTypeKey &)
 {
-  if (this->entities.find(_entity) == this->entities.end())
+  const std::size_t index = this->EntityIndex(_entity);
+  if (index >= this->entities.size())
     return false;
 
   // Otherwise, remove the entity from the view
-  this->entities.erase(_entity);
+  this->entities.erase(this->entities.begin() + index);
   this->newEntities.erase(_entity);
   this->toRemoveEntities.erase(_entity);
 
-  // Remove the entity from the components map
-  for (const ComponentTypeId &compTypeId : _key)
-    this->components.erase(std::make_pair(_entity, compTypeId));
+  // Remove the entity's row of components
+  const std::size_t typeCount = this->componentTypes.size();
+  auto rowIter = this->componentIds.begin() + index * typeCount;
+  this->componentIds.erase(rowIter, rowIter + typeCount);
 
   return true;
 }
 
+//////////////////////////////////////////////////
+std::size_t View::RemoveEntities(const std::vector<Entity> &_entities)
+{
+  // Both lists are sorted, so the remaining rows are compacted in place
+  const std::size_t typeCount = this->componentTypes.size();
+  auto removed = _entities.begin();
+  std::size_t kept = 0;
+  for (std::size_t index = 0; index < this->entities.size(); ++index)
+  {
+    const Entity entity = this->entities[index];
+    removed = std::lower_bound(removed, _entities.end(), entity);
+    if (removed != _entities.end() && *removed == entity)
+    {
+      this->newEntities.erase(entity);
+      this->toRemoveEntities.erase(entity);
+      continue;
+    }
+
+    if (kept != index)
+    {
+      this->entities[kept] = entity;
+      std::copy_n(this->componentIds.begin() + index * typeCount, typeCount,
+          this->componentIds.begin() + kept * typeCount);
+    }
+    ++kept;
+  }
+
+  const std::size_t count = this->entities.size() - kept;
+  this->entities.resize(kept);
+  this->componentIds.resize(kept * typeCount);
+  return count;
+}
+
+//////////////////////////////////////////////////
+std::size_t View::EntityIndex(const Entity _entity) const
+{
+  auto iter = std::lower_bound(this->entities.begin(), this->entities.end(),
+      _entity);
+  if (iter == this->entities.end() || *iter != _entity)
+    return this->entities.size();
+  return iter - this->entities.begin();
+}
+
+//////////////////////////////////////////////////
+std::size_t View::IndexAfter(const Entity _entity) const
+{
+  return std::upper_bound(this->entities.begin(), this->entities.end(),
+      _entity) - this->entities.begin();
+}
+
+//////////////////////////////////////////////////
+std::size_t View::TypeColumn(const ComponentTypeId _typeId) const
+{
+  // Views hold a handful of types, so a linear search is the fastest option
+  for (std::size_t i = 0; i < this->componentTypes.size(); ++i)
+  {
+    if (this->componentTypes[i] == _typeId)
+      return i;
+  }
+  return this->componentTypes.size();
+}
+
+//////////////////////////////////////////////////
+void View::ClearEntities()
+{
+  this->entities.clear();
+  this->componentIds.clear();
+}
+
 /////////////////////////////////////////////////
 const components::BaseComponent *View::ComponentImplementation(
     const Entity _entity,
     ComponentTypeId _typeId,
+    std::size_t _typeIndex,
     const EntityComponentManager *_ecm) const
 {
-  return _ecm->ComponentImplementation(
-      {_typeId, this->components.at({_entity, _typeId})});
+  const std::size_t index = this->EntityIndex(_entity);
+  if (index >= this->entities.size())
+    return nullptr;
+
+  return this->ComponentAtImplementation(index, _typeId, _typeIndex, _ecm);
+}
+
+/////////////////////////////////////////////////
+const components::BaseComponent *View::ComponentAtImplementation(
+    const std::size_t _index,
+    ComponentTypeId _typeId,
+    std::size_t _typeIndex,
+    const EntityComponentManager *_ecm) const
+{
+  const std::size_t column = this->TypeColumn(_typeId);
+  if (column >= this->componentTypes.size())
+    return nullptr;
+
+  const ComponentId id =
+      this->componentIds[_index * this->componentTypes.size() + column];
+  if (id == kComponentIdInvalid)
+    return nullptr;
+
+  return _ecm->ComponentByTypeIndex(_typeIndex, id);
 }
 
 //////////////////////////////////////////////////
@@ -77,7 +201,7 @@ void View::ClearNewEntities()
 //////////////////////////////////////////////////
 bool View::AddEntityToRemoved(const Entity _entity)
 {
-  if (this->entities.find(_entity) == this->entities.end())
+  if (this->EntityIndex(_entity) >= this->entities.size())
     return false;
   this->toRemoveEntities.insert(_entity);
   return true;
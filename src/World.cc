@@ -28,10 +28,21 @@
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/World.hh"
 
+#include "LookupCache.hh"
+
 class ignition::gazebo::WorldPrivate
 {
   /// \brief Id of world entity.
   public: Entity id{kNullEntity};
+
+  /// \brief Lights found by LightByName.
+  public: NameLookupCache lightsByName;
+
+  /// \brief Actors found by ActorByName.
+  public: NameLookupCache actorsByName;
+
+  /// \brief Models found by ModelByName.
+  public: NameLookupCache modelsByName;
 };
 
 using namespace ignition;
@@ -109,46 +120,55 @@ std::optional<math::Vector3d> World::MagneticField(
 Entity World::LightByName(const EntityComponentManager &_ecm,
     const std::string &_name) const
 {
-  // Can't use components::Light in EntityByComponents, see
-  // https://github.com/ignitionrobotics/ign-gazebo/issues/376
-  auto entities = _ecm.EntitiesByComponents(
-      components::ParentEntity(this->dataPtr->id),
-      components::Name(_name));
+  return this->dataPtr->lightsByName.Find(_ecm, _name, [&]
+      {
+        // Can't use components::Light in EntityByComponents, see
+        // https://github.com/ignitionrobotics/ign-gazebo/issues/376
+        auto entities = _ecm.EntitiesByComponents(
+            components::ParentEntity(this->dataPtr->id),
+            components::Name(_name));
 
-  for (const auto &entity : entities)
-  {
-    if (_ecm.Component<components::Light>(entity))
-      return entity;
-  }
-  return kNullEntity;
+        for (const auto &entity : entities)
+        {
+          if (_ecm.Component<components::Light>(entity))
+            return entity;
+        }
+        return kNullEntity;
+      });
 }
 
 //////////////////////////////////////////////////
 Entity World::ActorByName(const EntityComponentManager &_ecm,
     const std::string &_name) const
 {
-  // Can't use components::Actor in EntityByComponents, see
-  // https://github.com/ignitionrobotics/ign-gazebo/issues/376
-  auto entities = _ecm.EntitiesByComponents(
-      components::ParentEntity(this->dataPtr->id),
-      components::Name(_name));
+  return this->dataPtr->actorsByName.Find(_ecm, _name, [&]
+      {
+        // Can't use components::Actor in EntityByComponents, see
+        // https://github.com/ignitionrobotics/ign-gazebo/issues/376
+        auto entities = _ecm.EntitiesByComponents(
+            components::ParentEntity(this->dataPtr->id),
+            components::Name(_name));
 
-  for (const auto &entity : entities)
-  {
-    if (_ecm.Component<components::Actor>(entity))
-      return entity;
-  }
-  return kNullEntity;
+        for (const auto &entity : entities)
+        {
+          if (_ecm.Component<components::Actor>(entity))
+            return entity;
+        }
+        return kNullEntity;
+      });
 }
 
 //////////////////////////////////////////////////
 Entity World::ModelByName(const EntityComponentManager &_ecm,
     const std::string &_name) const
 {
-  return _ecm.EntityByComponents(
-      components::ParentEntity(this->dataPtr->id),
-      components::Name(_name),
-      components::Model());
+  return this->dataPtr->modelsByName.Find(_ecm, _name, [&]
+      {
+        return _ecm.EntityByComponents(
+            components::ParentEntity(this->dataPtr->id),
+            components::Name(_name),
+            components::Model());
+      });
 }
 
 //////////////////////////////////////////////////
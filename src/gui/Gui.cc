@@ -83,6 +83,11 @@ std::unique_ptr<ignition::gui::Application> createGui(
   app->Engine()->addImportPath(IGN_GAZEBO_GUI_PLUGIN_INSTALL_DIR);
   std::string defaultGuiConfigName = "gui.config";
 
+  // Remote view clients only display images rendered on the server, so they
+  // don't mirror the entities
+  bool remoteView = nullptr != _guiConfig &&
+      std::string(_guiConfig) == "_remote_view_";
+
   // Set default config file for Gazebo
   std::string defaultConfig;
   if (nullptr == _defaultGuiConfig)
@@ -93,6 +98,10 @@ std::unique_ptr<ignition::gui::Application> createGui(
     {
       defaultGuiConfigName = "playback_gui.config";
     }
+    else if (remoteView)
+    {
+      defaultGuiConfigName = "remote_view_gui.config";
+    }
     ignition::common::env(IGN_HOMEDIR, defaultConfig);
     defaultConfig = ignition::common::joinPaths(defaultConfig, ".ignition",
         "gazebo", defaultGuiConfigName);
@@ -169,7 +178,7 @@ std::unique_ptr<ignition::gui::Application> createGui(
 
   // Configuration file from command line
   if (_guiConfig != nullptr && std::strlen(_guiConfig) > 0 &&
-      std::string(_guiConfig) != "_playback_")
+      std::string(_guiConfig) != "_playback_" && !remoteView)
   {
     // Use the first world name with the config file
     // TODO(anyone) Most of ign-gazebo's transport API includes the world name,
@@ -189,7 +198,7 @@ std::unique_ptr<ignition::gui::Application> createGui(
     }
   }
   // GUI configuration from SDF (request to server)
-  else
+  else if (!remoteView)
   {
     // TODO(anyone) Parallelize this if multiple worlds becomes an important use
     // case.
@@ -253,7 +262,7 @@ std::unique_ptr<ignition::gui::Application> createGui(
     mainWin->configChanged();
   }
 
-  if (0 == runnerCount)
+  if (0 == runnerCount && !remoteView)
   {
     ignerr << "Failed to start a GUI runner." << std::endl;
     return nullptr;
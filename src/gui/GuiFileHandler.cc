@@ -18,6 +18,7 @@
 #include <ignition/msgs/sdf_generator_config.pb.h>
 
 #include <fstream>
+#include <string>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Profiler.hh>
@@ -36,78 +37,161 @@ void GuiFileHandler::SaveWorldAs(const QString &_fileUrl,
   IGN_PROFILE("GuiFileHandler::SaveWorldAs");
   QUrl url(_fileUrl);
 
-  bool status = false;
-  std::stringstream statusMsg;
-
   std::string suffix = ".sdf";
   if (url.fileName().endsWith(".sdf"))
     suffix = "";
 
-  std::string localPath = url.toLocalFile().toStdString() + suffix;
+  {
+    std::lock_guard<std::mutex> lock(this->saveMutex);
+    this->savePath = url.toLocalFile().toStdString() + suffix;
+
+    // Progress messages of other saves, from this or other GUIs, are ignored
+    this->saveJobId = "gui_" +
+        QUuid::createUuid().toString().toStdString();
+
+    this->saveConfig.Clear();
+    auto *jobId = this->saveConfig.mutable_header()->add_data();
+    jobId->set_key("job_id");
+    jobId->add_value(this->saveJobId);
+
+    auto *globalConfig = this->saveConfig.mutable_global_entity_gen_config();
+    msgs::Set(globalConfig->mutable_expand_include_tags(),
+              _config->property("expandIncludeTags").toBool());
+    msgs::Set(globalConfig->mutable_save_fuel_version(),
+              _config->property("saveFuelModelVersion").toBool());
+  }
+
   std::string service{"/gazebo/worlds"};
-  ignition::msgs::StringMsg_V worldsMsg;
+  if (!this->node.Request(service, &GuiFileHandler::OnWorlds, this))
+  {
+    this->FinishSave(false, "Service call to " + service +
+        " failed. Cannot save world.\n");
+  }
+}
 
-  bool result{false};
-  unsigned int timeout{5000};
-  bool ret = this->node.Request(service, timeout, worldsMsg, result);
-  if (!ret || !result)
+/////////////////////////////////////////////////
+void GuiFileHandler::OnWorlds(const msgs::StringMsg_V &_rep,
+    const bool _result)
+{
+  if (!_result)
   {
-    statusMsg << "Service call to " << service
-                  << " failed. Cannot save world.\n";
+    this->FinishSave(false,
+        "Service call to /gazebo/worlds failed. Cannot save world.\n");
+    return;
   }
+
   // TODO(addisu) Support saving multiple worlds
-  else if (worldsMsg.data_size() > 0)
+  if (_rep.data_size() == 0)
   {
-    const auto &worldName = worldsMsg.data(0);
-    const std::string sdfGenService{std::string("/world/") + worldName +
-                                    "/generate_world_sdf"};
-    msgs::StringMsg genWorldSdf;
-    msgs::SdfGeneratorConfig req;
+    this->FinishSave(false, "No world to save.\n");
+    return;
+  }
 
-    auto *globalConfig = req.mutable_global_entity_gen_config();
-    msgs::Set(globalConfig->mutable_expand_include_tags(),
-              _config->property("expandIncludeTags").toBool());
-    msgs::Set(globalConfig->mutable_save_fuel_version(),
-              _config->property("saveFuelModelVersion").toBool());
+  const auto &worldName = _rep.data(0);
+  const std::string saveService{"/world/" + worldName + "/save_world_sdf"};
 
-    bool serviceCall =
-        this->node.Request(sdfGenService, req, timeout, genWorldSdf, result);
-    if (serviceCall && result && !genWorldSdf.data().empty())
+  msgs::SdfGeneratorConfig req;
+  {
+    std::lock_guard<std::mutex> lock(this->saveMutex);
+    const auto topic = saveService + "/progress";
+    if (topic != this->progressTopic)
     {
-      igndbg << "Saving world: " << worldName << " to: " << localPath << "\n";
-      std::ofstream fs(localPath, std::ios::out);
-      if (fs.is_open())
-      {
-        fs << genWorldSdf.data();
-        status = true;
-        statusMsg << "World saved to " << localPath << "\n";
-      }
-      else
-      {
-        statusMsg << "File: " << localPath << " could not be opened for "
-                      << "saving. Please check that the directory containg the "
-                      << "file exists and the correct permissions are set.\n";
-      }
+      if (!this->progressTopic.empty())
+        this->node.Unsubscribe(this->progressTopic);
+      this->node.Subscribe(topic, &GuiFileHandler::OnSaveProgress, this);
+      this->progressTopic = topic;
     }
-    else
+    req = this->saveConfig;
+  }
+
+  igndbg << "Saving world: " << worldName << std::endl;
+  if (!this->node.Request(saveService, req, &GuiFileHandler::OnSaveStarted,
+      this))
+  {
+    this->FinishSave(false, "Service call to " + saveService +
+        " failed. Cannot save world.\n");
+  }
+}
+
+/////////////////////////////////////////////////
+void GuiFileHandler::OnSaveStarted(const msgs::StringMsg &,
+    const bool _result)
+{
+  if (!_result)
+  {
+    this->FinishSave(false, "Unknown error occured when saving the world. "
+        "Please check the console output of ign-gazebo\n");
+  }
+}
+
+/////////////////////////////////////////////////
+void GuiFileHandler::OnSaveProgress(const msgs::Param &_msg)
+{
+  const auto &params = _msg.params();
+  auto param = [&](const std::string &_key) -> const msgs::Any *
+  {
+    auto it = params.find(_key);
+    return it == params.end() ? nullptr : &it->second;
+  };
+
+  auto id = param("job_id");
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(this->saveMutex);
+    if (nullptr == id || this->saveJobId.empty() ||
+        id->string_value() != this->saveJobId)
     {
-      if (!serviceCall)
-      {
-        statusMsg << "Service call for generating world SDFormat timed out\n";
-      }
-      statusMsg << "Unknown error occured when saving the world. Please check "
-                << "the console output of ign-gazebo\n";
+      return;
     }
+    path = this->savePath;
   }
 
-  if (!status)
+  auto done = param("done");
+  if (nullptr == done || !done->bool_value())
   {
-    ignerr << statusMsg.str();
+    auto progress = param("progress");
+    if (nullptr != progress)
+      emit newSaveWorldProgress(progress->double_value());
+    return;
   }
-  else
+
+  auto success = param("success");
+  auto sdf = param("sdf");
+  if (nullptr == success || !success->bool_value() || nullptr == sdf ||
+      sdf->string_value().empty())
   {
-    ignmsg << statusMsg.str();
+    this->FinishSave(false, "Unknown error occured when saving the world. "
+        "Please check the console output of ign-gazebo\n");
+    return;
   }
-  emit newSaveWorldStatus(status, QString::fromStdString(statusMsg.str()));
+
+  std::ofstream fs(path, std::ios::out);
+  if (!fs.is_open())
+  {
+    this->FinishSave(false, "File: " + path + " could not be opened for "
+        "saving. Please check that the directory containg the file exists "
+        "and the correct permissions are set.\n");
+    return;
+  }
+  fs << sdf->string_value();
+  this->FinishSave(true, "World saved to " + path + "\n");
 }
 
+/////////////////////////////////////////////////
+void GuiFileHandler::FinishSave(bool _status, const std::string &_msg)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->saveMutex);
+    this->saveJobId.clear();
+  }
+
+  if (!_status)
+  {
+    ignerr << _msg;
+  }
+  else
+  {
+    ignmsg << _msg;
+  }
+  emit newSaveWorldStatus(_status, QString::fromStdString(_msg));
+}
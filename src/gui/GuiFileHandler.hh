@@ -17,9 +17,13 @@
 #ifndef IGNITION_GAZEBO_GUI_GUIFILEHANDLER_HH_
 #define IGNITION_GAZEBO_GUI_GUIFILEHANDLER_HH_
 
+#include <ignition/msgs/param.pb.h>
 #include <ignition/msgs/sdf_generator_config.pb.h>
+#include <ignition/msgs/stringmsg.pb.h>
+#include <ignition/msgs/stringmsg_v.pb.h>
 
 #include <QtCore>
+#include <mutex>
 #include <string>
 
 #include <ignition/transport/Node.hh>
@@ -36,11 +40,17 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
 namespace gui
 {
 /// \brief Class for handling saving and loading of SDFormat files
+///
+/// Worlds are saved by a background job on the server, so neither the GUI
+/// nor the simulation waits for the SDFormat to be generated. The job's
+/// progress is reported with newSaveWorldProgress, and its completion with
+/// newSaveWorldStatus, once the file is written.
 class IGNITION_GAZEBO_VISIBLE GuiFileHandler : public QObject
 {
   Q_OBJECT
 
-  /// \brief Function called from QML when user asks to save a world file
+  /// \brief Function called from QML when user asks to save a world file.
+  /// Returns right away, a save in progress is superseded.
   /// \param[in] _fileUrl Url to world file.
   /// \param[in] _config Object that contains configuration options for SDFormat
   /// file generation
@@ -52,8 +62,48 @@ class IGNITION_GAZEBO_VISIBLE GuiFileHandler : public QObject
   /// \param[in] _msg New status message.
   signals: void newSaveWorldStatus(bool _status, const QString &_msg);
 
+  /// \brief Signal for displaying the progress of a save.
+  /// \param[in] _progress Progress, from 0 to 1.
+  signals: void newSaveWorldProgress(double _progress);
+
+  /// \brief Callback with the names of the worlds, which starts the save.
+  /// \param[in] _rep World names.
+  /// \param[in] _result Whether the request succeeded.
+  private: void OnWorlds(const msgs::StringMsg_V &_rep, const bool _result);
+
+  /// \brief Callback when the server started the save job.
+  /// \param[in] _rep ID of the job.
+  /// \param[in] _result Whether the request succeeded.
+  private: void OnSaveStarted(const msgs::StringMsg &_rep,
+      const bool _result);
+
+  /// \brief Callback with the progress of save jobs.
+  /// \param[in] _msg Progress, see SimulationRunner::RunWorldSdfJob.
+  private: void OnSaveProgress(const msgs::Param &_msg);
+
+  /// \brief Finish the current save and report its status.
+  /// \param[in] _status False if saving the world failed.
+  /// \param[in] _msg Status message.
+  private: void FinishSave(bool _status, const std::string &_msg);
+
   /// \brief Transport node.
   private: transport::Node node;
+
+  /// \brief Protects the save members below, which are used from the Qt
+  /// and transport threads.
+  private: std::mutex saveMutex;
+
+  /// \brief ID of the current save job, empty if there's none.
+  private: std::string saveJobId;
+
+  /// \brief Path the current save is written to.
+  private: std::string savePath;
+
+  /// \brief Options of the current save.
+  private: msgs::SdfGeneratorConfig saveConfig;
+
+  /// \brief Progress topic subscribed to.
+  private: std::string progressTopic;
 };
 }
 }
@@ -15,11 +15,20 @@
  *
 */
 
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_set>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Profiler.hh>
+#include <ignition/common/Util.hh>
 #include <ignition/fuel_tools/Interface.hh>
 #include <ignition/gui/Application.hh>
 #include <ignition/gui/MainWindow.hh>
+#include <ignition/msgs/uint64.pb.h>
+#include <ignition/transport/NetUtils.hh>
 
 // Include all components so they have first-class support
 #include "ignition/gazebo/components/components.hh"
@@ -27,6 +36,8 @@
 #include "ignition/gazebo/gui/GuiRunner.hh"
 #include "ignition/gazebo/gui/GuiSystem.hh"
 
+#include "../systems/log/LogCompression.hh"
+
 using namespace ignition;
 using namespace gazebo;
 
@@ -49,6 +60,18 @@ GuiRunner::GuiRunner(const std::string &_worldName)
     return;
   }
 
+  std::string compressedEnv;
+  this->compressedState =
+      common::env("IGN_GAZEBO_COMPRESSED_STATE", compressedEnv) &&
+      compressedEnv == "1";
+
+  this->clientId = transport::hostname() + ":" +
+      std::to_string(gui::App()->applicationPid());
+  this->stateAckPub = this->node.Advertise<msgs::UInt64>(
+      this->stateTopic + "/ack");
+
+  this->updateThread = std::thread(&GuiRunner::UpdateLoop, this);
+
   common::addFindFileURICallback([] (common::URI _uri)
   {
     return fuel_tools::fetchResource(_uri.Str());
@@ -61,7 +84,16 @@ GuiRunner::GuiRunner(const std::string &_worldName)
 }
 
 /////////////////////////////////////////////////
-GuiRunner::~GuiRunner() = default;
+GuiRunner::~GuiRunner()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->stateQueueMutex);
+    this->stopUpdates = true;
+  }
+  this->stateQueueCv.notify_all();
+  if (this->updateThread.joinable())
+    this->updateThread.join();
+}
 
 /////////////////////////////////////////////////
 void GuiRunner::RequestState()
@@ -123,27 +155,138 @@ void GuiRunner::OnStateAsyncService(const msgs::SerializedStepMap &_res)
   this->node.UnadvertiseSrv(reqSrv);
 
   // Only subscribe to periodic updates after receiving initial state
-  if (this->node.SubscribedTopics().empty())
+  if (!this->node.SubscribedTopics().empty())
+    return;
+
+  if (this->compressedState)
+  {
+    std::function<void(const char *, const size_t,
+        const transport::MessageInfo &)> cb =
+        std::bind(&GuiRunner::OnCompressedState, this, std::placeholders::_1,
+        std::placeholders::_2, std::placeholders::_3);
+    this->node.SubscribeRaw(this->stateTopic + "/compressed", cb,
+        std::string(msgs::SerializedStepMap().GetTypeName()) +
+        systems::kCompressedLogTypeSuffix);
+  }
+  else
+  {
     this->node.Subscribe(this->stateTopic, &GuiRunner::OnState, this);
+  }
+}
+
+/////////////////////////////////////////////////
+void GuiRunner::OnCompressedState(const char *_data, const size_t _size,
+    const transport::MessageInfo &_info)
+{
+  std::string data;
+  std::string type;
+  msgs::SerializedStepMap msg;
+  if (!systems::DecompressLogMessage(std::string(_data, _size), _info.Type(),
+      data, type) || type != msg.GetTypeName() ||
+      !msg.ParseFromString(data))
+  {
+    ignerr << "Failed to decompress state message." << std::endl;
+    return;
+  }
+  this->OnState(msg);
 }
 
 /////////////////////////////////////////////////
 void GuiRunner::OnState(const msgs::SerializedStepMap &_msg)
 {
-  IGN_PROFILE_THREAD_NAME("GuiRunner::OnState");
-  IGN_PROFILE("GuiRunner::Update");
+  {
+    std::lock_guard<std::mutex> lock(this->stateQueueMutex);
+    this->stateQueue.push_back(_msg);
+  }
+  this->stateQueueCv.notify_one();
+}
+
+/////////////////////////////////////////////////
+void GuiRunner::UpdateLoop()
+{
+  IGN_PROFILE_THREAD_NAME("GuiRunner::UpdateLoop");
+
+  std::deque<msgs::SerializedStepMap> states;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(this->stateQueueMutex);
+      this->stateQueueCv.wait(lock, [this]
+          {
+            return this->stopUpdates || !this->stateQueue.empty();
+          });
+      if (this->stopUpdates)
+        return;
+      states.swap(this->stateQueue);
+    }
+
+    IGN_PROFILE("GuiRunner::Update");
 
-  this->ecm.SetState(_msg.state());
+    // Component types changed by these states, read from the messages so
+    // plugins which don't use them can be skipped
+    std::unordered_set<ComponentTypeId> changedTypes;
+    {
+      IGN_PROFILE("SetState");
+      for (const auto &msg : states)
+      {
+        for (const auto &[id, entityMsg] : msg.state().entities())
+        {
+          for (const auto &[type, compMsg] : entityMsg.components())
+            changedTypes.insert(type);
+        }
+        this->ecm.SetState(msg.state());
+      }
+    }
+    const bool entitiesChanged = this->ecm.HasNewEntities() ||
+        this->ecm.HasEntitiesMarkedForRemoval();
+
+    // Update all plugins. Components changed by these states are flagged as
+    // changed until all plugins are updated.
+    this->updateInfo = convert<UpdateInfo>(states.back().stats());
+    auto plugins = gui::App()->findChildren<GuiSystem *>();
+    for (auto plugin : plugins)
+    {
+      if (!entitiesChanged)
+      {
+        auto types = plugin->ComponentTypes();
+        if (!types.empty() && std::none_of(types.begin(), types.end(),
+            [&](const ComponentTypeId &_type)
+            {
+              return changedTypes.find(_type) != changedTypes.end();
+            }))
+        {
+          continue;
+        }
+      }
+      plugin->Update(this->updateInfo, this->ecm);
+    }
+    this->ecm.ClearNewlyCreatedEntities();
+    this->ecm.SetAllComponentsUnchanged();
+    this->ecm.ProcessRemoveEntityRequests();
+    this->ecm.ClearRemovedComponents();
 
-  // Update all plugins
-  this->updateInfo = convert<UpdateInfo>(_msg.stats());
-  auto plugins = gui::App()->findChildren<GuiSystem *>();
-  for (auto plugin : plugins)
+    for (const auto &msg : states)
+      this->AckState(msg);
+    states.clear();
+  }
+}
+
+/////////////////////////////////////////////////
+void GuiRunner::AckState(const msgs::SerializedStepMap &_msg)
+{
+  // Let the server know this state was processed
+  for (const auto &data : _msg.header().data())
   {
-    plugin->Update(this->updateInfo, this->ecm);
+    if (data.key() != "seq" || data.value_size() == 0)
+      continue;
+
+    msgs::UInt64 ack;
+    auto idData = ack.mutable_header()->add_data();
+    idData->set_key("id");
+    idData->add_value(this->clientId);
+    ack.set_data(std::stoull(data.value(0)));
+    this->stateAckPub.Publish(ack);
+    break;
   }
-  this->ecm.ClearNewlyCreatedEntities();
-  this->ecm.ProcessRemoveEntityRequests();
-  this->ecm.ClearRemovedComponents();
 }
 
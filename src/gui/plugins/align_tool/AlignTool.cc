@@ -32,6 +32,7 @@
 #include <ignition/rendering/Visual.hh>
 #include <ignition/rendering/Geometry.hh>
 #include <ignition/rendering/Material.hh>
+#include <ignition/rendering/Mesh.hh>
 #include <ignition/rendering/RenderTypes.hh>
 #include <ignition/rendering/RenderingIface.hh>
 #include <ignition/rendering/RenderEngine.hh>
@@ -319,6 +320,15 @@ void AlignTool::UpdateTransparency(const rendering::NodePtr &_node,
       // If the entity isn't already transparent, make it transparent
       if (geomTransparency == this->dataPtr->originalTransparency.end())
       {
+        // Identical visuals may share a material, so give this one its own
+        // copy before changing it
+        auto mesh = std::dynamic_pointer_cast<rendering::Mesh>(geom);
+        if (mesh && mesh->SubMeshCount() > 0)
+          mesh->SubMeshByIndex(0)->SetMaterial(geomMat);
+        else
+          geom->SetMaterial(geomMat);
+        geomMat = geom->Material();
+
         this->dataPtr->originalTransparency[geom->Name()] =
             geomMat->Transparency();
         geomMat->SetTransparency(1.0 - ((1.0 - geomMat->Transparency()) * 0.5));
@@ -15,8 +15,10 @@
  *
 */
 
+#include <chrono>
 #include <iostream>
 #include <regex>
+#include <unordered_set>
 #include <ignition/common/Console.hh>
 #include <ignition/common/Profiler.hh>
 #include <ignition/gui/Application.hh>
@@ -95,12 +97,46 @@ namespace ignition::gazebo
 
     /// \brief Transport node for making command requests
     public: transport::Node node;
+
+    /// \brief Entity whose components were last refreshed, kNullEntity to
+    /// refresh all components on the next update.
+    public: Entity refreshedEntity{kNullEntity};
+
+    /// \brief When the components were last refreshed.
+    public: std::chrono::steady_clock::time_point refreshTime;
+
+    /// \brief Components of the inspected entity which changed since the
+    /// last refresh.
+    public: std::unordered_set<ComponentTypeId> changedTypes;
   };
 }
 
+/// \brief Minimum time between refreshes of the components, about the
+/// display rate. Values changing faster than this can't be seen anyway.
+constexpr std::chrono::milliseconds kRefreshPeriod{16};
+
 using namespace ignition;
 using namespace gazebo;
 
+//////////////////////////////////////////////////
+/// \brief Whether a component only marks the type of the entity, and is
+/// shown as the entity type rather than as a component.
+/// \param[in] _typeId Component type ID.
+/// \return True for entity type components.
+bool entityTypeComponent(ComponentTypeId _typeId)
+{
+  return _typeId == components::World::typeId ||
+      _typeId == components::Model::typeId ||
+      _typeId == components::Link::typeId ||
+      _typeId == components::Collision::typeId ||
+      _typeId == components::Visual::typeId ||
+      _typeId == components::Sensor::typeId ||
+      _typeId == components::Joint::typeId ||
+      _typeId == components::Performer::typeId ||
+      _typeId == components::Level::typeId ||
+      _typeId == components::Actor::typeId;
+}
+
 //////////////////////////////////////////////////
 template<>
 void ignition::gazebo::setData(QStandardItem *_item, const math::Pose3d &_data)
@@ -361,6 +397,45 @@ void ComponentInspector::Update(const UpdateInfo &,
 
   auto componentTypes = _ecm.ComponentTypes(this->dataPtr->entity);
 
+  // Keep track of the components which changed since the last refresh, so
+  // only those are converted for display. Change flags are cleared after
+  // every update, even when the refresh is skipped.
+  const bool refreshAll =
+      this->dataPtr->refreshedEntity != this->dataPtr->entity;
+  bool typesChanged{false};
+  std::size_t displayedCount{0};
+  for (const auto &typeId : componentTypes)
+  {
+    if (entityTypeComponent(typeId))
+      continue;
+
+    ++displayedCount;
+    if (this->dataPtr->componentsModel.items.find(typeId) ==
+        this->dataPtr->componentsModel.items.end())
+    {
+      typesChanged = true;
+    }
+    else if (!refreshAll && _ecm.ComponentState(this->dataPtr->entity,
+        typeId) != ComponentState::NoChange)
+    {
+      this->dataPtr->changedTypes.insert(typeId);
+    }
+  }
+  typesChanged = typesChanged ||
+      this->dataPtr->componentsModel.items.size() != displayedCount;
+
+  // Refreshes are capped at about the display rate, unless the components
+  // to display changed
+  auto now = std::chrono::steady_clock::now();
+  if (!refreshAll && !typesChanged &&
+      (this->dataPtr->changedTypes.empty() ||
+      now - this->dataPtr->refreshTime < kRefreshPeriod))
+  {
+    return;
+  }
+  this->dataPtr->refreshTime = now;
+  this->dataPtr->refreshedEntity = this->dataPtr->entity;
+
   // List all components
   for (const auto &typeId : componentTypes)
   {
@@ -442,6 +517,12 @@ void ComponentInspector::Update(const UpdateInfo &,
     auto itemIt = this->dataPtr->componentsModel.items.find(typeId);
     if (itemIt != this->dataPtr->componentsModel.items.end())
     {
+      // Unchanged values are already displayed
+      if (!refreshAll && this->dataPtr->changedTypes.find(typeId) ==
+          this->dataPtr->changedTypes.end())
+      {
+        continue;
+      }
       item = itemIt->second;
     }
     // Add component to list
@@ -677,6 +758,8 @@ void ComponentInspector::Update(const UpdateInfo &,
     }
   }
 
+  this->dataPtr->changedTypes.clear();
+
   // Remove components no longer present
   for (auto itemIt : this->dataPtr->componentsModel.items)
   {
@@ -777,6 +860,10 @@ bool ComponentInspector::Paused() const
 void ComponentInspector::SetPaused(bool _paused)
 {
   this->dataPtr->paused = _paused;
+
+  // Changes weren't tracked while paused
+  if (!_paused)
+    this->dataPtr->refreshedEntity = kNullEntity;
   this->PausedChanged();
 }
 
@@ -17,7 +17,11 @@
 
 #include "EntityTree.hh"
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <utility>
 #include <vector>
 
 #include <ignition/common/Console.hh>
@@ -60,6 +64,15 @@ namespace ignition::gazebo
 using namespace ignition;
 using namespace gazebo;
 
+/// \brief Role holding the entity name.
+constexpr int kEntityNameRole{100};
+
+/// \brief Role holding the entity ID, as a string.
+constexpr int kEntityRole{101};
+
+/// \brief Role holding the entity type.
+constexpr int kTypeRole{102};
+
 //////////////////////////////////////////////////
 QString entityType(Entity _entity,
     const EntityComponentManager &_ecm)
@@ -102,105 +115,323 @@ TreeModel::TreeModel() : QStandardItemModel()
 {
 }
 
+/////////////////////////////////////////////////
+QStandardItem *newEntityItem(const TreeModel::EntityInfo &_info)
+{
+  auto item = new QStandardItem(_info.name);
+  item->setData(_info.name, kEntityNameRole);
+  item->setData(QString::number(_info.entity), kEntityRole);
+  item->setData(_info.type, kTypeRole);
+  return item;
+}
+
 /////////////////////////////////////////////////
 void TreeModel::AddEntity(unsigned int _entity, const QString &_entityName,
     unsigned int _parentEntity, const QString &_type)
 {
-  IGN_PROFILE_THREAD_NAME("Qt thread");
-  IGN_PROFILE("TreeModel::AddEntity");
-  QStandardItem *parentItem{nullptr};
+  this->AddEntities({{_entity, _entityName, _parentEntity, _type}});
+}
+
+/////////////////////////////////////////////////
+void TreeModel::RemoveEntity(unsigned int _entity)
+{
+  this->RemoveEntities({_entity});
+}
+
+/////////////////////////////////////////////////
+void TreeModel::QueueChanges(std::vector<EntityInfo> &&_added,
+    std::vector<Entity> &&_removed)
+{
+  if (_added.empty() && _removed.empty())
+    return;
 
-  // Root
-  if (_parentEntity == kNullEntity)
+  std::lock_guard<std::mutex> lock(this->queueMutex);
+  if (this->addedQueue.empty())
+  {
+    this->addedQueue = std::move(_added);
+  }
+  else
   {
-    parentItem = this->invisibleRootItem();
+    std::move(_added.begin(), _added.end(),
+        std::back_inserter(this->addedQueue));
   }
+  this->removedQueue.insert(this->removedQueue.end(), _removed.begin(),
+      _removed.end());
 
-  // Nested
-  // TODO(louise) There should be a way to easily access these from
-  // QStandardItemModel instead of keeping our own map
-  auto item = this->entityItems.find(_parentEntity);
-  if (item != this->entityItems.end())
+  // A single invocation applies everything queued until it runs
+  if (!this->changesQueued)
   {
-    parentItem = item->second;
+    this->changesQueued = true;
+    QMetaObject::invokeMethod(this, "ProcessChanges", Qt::QueuedConnection);
   }
+}
+
+/////////////////////////////////////////////////
+void TreeModel::ProcessChanges()
+{
+  IGN_PROFILE_THREAD_NAME("Qt thread");
+  IGN_PROFILE("TreeModel::ProcessChanges");
 
-  if (nullptr == parentItem)
+  std::vector<EntityInfo> added;
+  std::vector<Entity> removed;
   {
-    this->pendingEntities.push_back(
-      {_entity, _entityName, _parentEntity, _type});
-    return;
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+    added.swap(this->addedQueue);
+    removed.swap(this->removedQueue);
+    this->changesQueued = false;
   }
 
-  // New entity item
-  auto entityItem = new QStandardItem(_entityName);
-  entityItem->setData(_entityName, this->roleNames().key("entityName"));
-  entityItem->setData(QString::number(_entity),
-      this->roleNames().key("entity"));
-  entityItem->setData(_type, this->roleNames().key("type"));
+  // Entity IDs aren't reused, so an entity removed in this batch was added
+  // before it
+  this->AddEntities(added);
+  this->RemoveEntities(removed);
+}
+
+/////////////////////////////////////////////////
+void TreeModel::AddEntities(const std::vector<EntityInfo> &_added)
+{
+  IGN_PROFILE("TreeModel::AddEntities");
 
-  parentItem->appendRow(entityItem);
+  // New items of each parent, appended at once so views handle a single
+  // insertion per parent
+  std::vector<std::pair<QStandardItem *, QList<QStandardItem *>>> newRows;
+  std::unordered_map<QStandardItem *, std::size_t> newRowsIndex;
 
-  this->entityItems[_entity] = entityItem;
+  std::function<void(const EntityInfo &)> add =
+      [&](const EntityInfo &_info)
+  {
+    if (this->entities.find(_info.entity) != this->entities.end())
+      return;
 
-  // Check if there are pending children
-  auto sep = std::partition(this->pendingEntities.begin(),
-      this->pendingEntities.end(), [&_entity](const EntityInfo &_entityInfo)
+    if (_info.parentEntity != kNullEntity &&
+        this->entities.find(_info.parentEntity) == this->entities.end())
+    {
+      this->pendingEntities[_info.parentEntity].push_back(_info);
+      return;
+    }
+
+    this->entities[_info.entity] = _info;
+
+    // Root entities and children of expanded entities get an item right
+    // away, others when their parent is expanded
+    QStandardItem *parentItem{nullptr};
+    if (_info.parentEntity == kNullEntity)
+    {
+      parentItem = this->invisibleRootItem();
+    }
+    else if (this->fetchedEntities.find(_info.parentEntity) !=
+        this->fetchedEntities.end())
+    {
+      parentItem = this->entityItems[_info.parentEntity];
+    }
+
+    if (nullptr == parentItem)
+    {
+      this->unfetchedChildren[_info.parentEntity].push_back(_info.entity);
+    }
+    else
+    {
+      auto item = newEntityItem(_info);
+      this->entityItems[_info.entity] = item;
+
+      auto index = newRowsIndex.find(parentItem);
+      if (index == newRowsIndex.end())
       {
-        return _entityInfo.parentEntity != _entity;
-      });
+        index = newRowsIndex.emplace(parentItem, newRows.size()).first;
+        newRows.push_back({parentItem, {}});
+      }
+      newRows[index->second].second.append(item);
+    }
 
-  for (auto it = sep; it != this->pendingEntities.end(); ++it)
+    // Check if there are pending children
+    auto pending = this->pendingEntities.find(_info.entity);
+    if (pending != this->pendingEntities.end())
+    {
+      auto children = std::move(pending->second);
+      this->pendingEntities.erase(pending);
+      for (const auto &child : children)
+        add(child);
+    }
+  };
+
+  for (const auto &info : _added)
+    add(info);
+
+  for (auto &rows : newRows)
+    rows.first->appendRows(rows.second);
+}
+
+/////////////////////////////////////////////////
+void TreeModel::RemoveEntities(const std::vector<Entity> &_removed)
+{
+  IGN_PROFILE("TreeModel::RemoveEntities");
+
+  for (const auto &entity : _removed)
   {
-    this->AddEntity(it->entity, it->name, it->parentEntity, it->type);
+    auto infoIt = this->entities.find(entity);
+    if (infoIt == this->entities.end())
+    {
+      // See if it's pending
+      for (auto &pending : this->pendingEntities)
+      {
+        auto &children = pending.second;
+        children.erase(std::remove_if(children.begin(), children.end(),
+            [&entity](const EntityInfo &_entityInfo)
+            {
+              return _entityInfo.entity == entity;
+            }), children.end());
+      }
+      this->pendingEntities.erase(entity);
+      continue;
+    }
+
+    QStandardItem *item{nullptr};
+    auto itemIt = this->entityItems.find(entity);
+    if (itemIt != this->entityItems.end())
+      item = itemIt->second;
+
+    // Entities without an item are only listed by their parent
+    const auto parentEntity = infoIt->second.parentEntity;
+    if (nullptr == item)
+    {
+      auto siblings = this->unfetchedChildren.find(parentEntity);
+      if (siblings != this->unfetchedChildren.end())
+      {
+        auto &children = siblings->second;
+        children.erase(std::remove(children.begin(), children.end(), entity),
+            children.end());
+        if (children.empty())
+          this->unfetchedChildren.erase(siblings);
+      }
+    }
+
+    this->ForgetEntity(entity);
+
+    // Remove from the view
+    if (nullptr != item)
+    {
+      if (nullptr == item->parent())
+        this->removeRow(item->row());
+      else
+        item->parent()->removeRow(item->row());
+    }
   }
-  this->pendingEntities.erase(sep, this->pendingEntities.end());
 }
 
 /////////////////////////////////////////////////
-void TreeModel::RemoveEntity(unsigned int _entity)
+void TreeModel::ForgetEntity(Entity _entity)
 {
-  IGN_PROFILE("TreeModel::RemoveEntity");
-  QStandardItem *item{nullptr};
   auto itemIt = this->entityItems.find(_entity);
   if (itemIt != this->entityItems.end())
   {
-    item = itemIt->second;
+    const auto item = itemIt->second;
+    for (int i = 0; i < item->rowCount(); ++i)
+    {
+      this->ForgetEntity(
+          item->child(i)->data(kEntityRole).toUInt());
+    }
+    this->entityItems.erase(itemIt);
   }
 
-  if (nullptr == item)
+  auto unfetched = this->unfetchedChildren.find(_entity);
+  if (unfetched != this->unfetchedChildren.end())
   {
-    // See if it's pending
-    auto toRemove = std::remove_if(this->pendingEntities.begin(),
-        this->pendingEntities.end(), [&_entity](const EntityInfo &_entityInfo)
-        {
-          return _entityInfo.entity == _entity;
-        });
-    this->pendingEntities.erase(toRemove, this->pendingEntities.end());
+    auto children = std::move(unfetched->second);
+    this->unfetchedChildren.erase(unfetched);
+    for (const auto &child : children)
+      this->ForgetEntity(child);
+  }
+
+  this->fetchedEntities.erase(_entity);
+  this->entities.erase(_entity);
+}
 
+/////////////////////////////////////////////////
+void TreeModel::FetchChildren(Entity _entity)
+{
+  auto itemIt = this->entityItems.find(_entity);
+  if (itemIt == this->entityItems.end())
+    return;
+
+  this->fetchedEntities.insert(_entity);
+
+  auto unfetched = this->unfetchedChildren.find(_entity);
+  if (unfetched == this->unfetchedChildren.end())
     return;
+
+  IGN_PROFILE("TreeModel::FetchChildren");
+
+  QList<QStandardItem *> rows;
+  for (const auto &child : unfetched->second)
+  {
+    auto item = newEntityItem(this->entities[child]);
+    this->entityItems[child] = item;
+    rows.append(item);
   }
+  this->unfetchedChildren.erase(unfetched);
+
+  itemIt->second->appendRows(rows);
+}
+
+/////////////////////////////////////////////////
+QStandardItem *TreeModel::PopulateEntity(Entity _entity)
+{
+  auto itemIt = this->entityItems.find(_entity);
+  if (itemIt != this->entityItems.end())
+    return itemIt->second;
 
-  // Remove all children from our custom map
-  std::function<void(const QStandardItem *)> removeChildren =
-      [&](const QStandardItem *_item)
+  auto infoIt = this->entities.find(_entity);
+  if (infoIt == this->entities.end() ||
+      infoIt->second.parentEntity == kNullEntity)
   {
-    for (int i = 0; i < _item->rowCount(); ++i)
-    {
-      auto childItem = _item->child(i);
-      removeChildren(childItem);
-      this->entityItems.erase(childItem->data(
-          this->roleNames().key("entity")).toUInt());
-    }
-  };
-  this->entityItems.erase(_entity);
-  removeChildren(item);
+    return nullptr;
+  }
 
-  // Remove from the view
-  if (nullptr == item->parent())
-    this->removeRow(item->row());
-  else
-    item->parent()->removeRow(item->row());
+  const auto parentEntity = infoIt->second.parentEntity;
+  if (nullptr == this->PopulateEntity(parentEntity))
+    return nullptr;
+
+  this->FetchChildren(parentEntity);
+
+  itemIt = this->entityItems.find(_entity);
+  return itemIt == this->entityItems.end() ? nullptr : itemIt->second;
+}
+
+/////////////////////////////////////////////////
+bool TreeModel::hasChildren(const QModelIndex &_parent) const
+{
+  // Entities which haven't been expanded yet can still be expanded
+  return this->canFetchMore(_parent) ||
+      QStandardItemModel::hasChildren(_parent);
+}
+
+/////////////////////////////////////////////////
+bool TreeModel::canFetchMore(const QModelIndex &_parent) const
+{
+  if (!_parent.isValid())
+    return false;
+
+  return this->unfetchedChildren.find(this->EntityId(_parent)) !=
+      this->unfetchedChildren.end();
+}
+
+/////////////////////////////////////////////////
+void TreeModel::fetchMore(const QModelIndex &_parent)
+{
+  if (!_parent.isValid())
+    return;
+
+  this->FetchChildren(this->EntityId(_parent));
+}
+
+/////////////////////////////////////////////////
+QModelIndex TreeModel::IndexForEntity(unsigned int _entity)
+{
+  auto item = this->PopulateEntity(_entity);
+  if (nullptr == item)
+    return QModelIndex();
+
+  return this->indexFromItem(item);
 }
 
 /////////////////////////////////////////////////
@@ -211,7 +442,7 @@ QString TreeModel::EntityType(const QModelIndex &_index) const
   if (!item)
     return type;
 
-  QVariant typeVar  = item->data(this->roleNames().key("type"));
+  QVariant typeVar  = item->data(kTypeRole);
   if (!typeVar.isValid())
     return type;
 
@@ -247,7 +478,7 @@ unsigned int TreeModel::EntityId(const QModelIndex &_index) const
   if (!item)
     return entity;
 
-  QVariant entityVar  = item->data(this->roleNames().key("entity"));
+  QVariant entityVar  = item->data(kEntityRole);
   if (!entityVar.isValid())
     return entity;
 
@@ -257,9 +488,9 @@ unsigned int TreeModel::EntityId(const QModelIndex &_index) const
 /////////////////////////////////////////////////
 QHash<int, QByteArray> TreeModel::roleNames() const
 {
-  return {std::pair(100, "entityName"),
-          std::pair(101, "entity"),
-          std::pair(102, "type")};
+  return {std::pair(kEntityNameRole, "entityName"),
+          std::pair(kEntityRole, "entity"),
+          std::pair(kTypeRole, "type")};
 }
 
 /////////////////////////////////////////////////
@@ -288,6 +519,11 @@ void EntityTree::LoadConfig(const tinyxml2::XMLElement *)
 void EntityTree::Update(const UpdateInfo &, EntityComponentManager &_ecm)
 {
   IGN_PROFILE("EntityTree::Update");
+
+  // Changes are handed to the model in a single batch
+  std::vector<TreeModel::EntityInfo> added;
+  std::vector<Entity> removed;
+
   // Treat all pre-existent entities as new at startup
   if (!this->dataPtr->initialized)
   {
@@ -320,12 +556,10 @@ void EntityTree::Update(const UpdateInfo &, EntityComponentManager &_ecm)
         parentEntity = kNullEntity;
       }
 
-      QMetaObject::invokeMethod(&this->dataPtr->treeModel, "AddEntity",
-          Qt::QueuedConnection,
-          Q_ARG(unsigned int, _entity),
-          Q_ARG(QString, QString::fromStdString(_name->Data())),
-          Q_ARG(unsigned int, parentEntity),
-          Q_ARG(QString, entityType(_entity, _ecm)));
+      added.push_back({static_cast<unsigned int>(_entity),
+          QString::fromStdString(_name->Data()),
+          static_cast<unsigned int>(parentEntity),
+          entityType(_entity, _ecm)});
       return true;
     });
     this->dataPtr->initialized = true;
@@ -348,12 +582,10 @@ void EntityTree::Update(const UpdateInfo &, EntityComponentManager &_ecm)
         parentEntity = kNullEntity;
       }
 
-      QMetaObject::invokeMethod(&this->dataPtr->treeModel, "AddEntity",
-          Qt::QueuedConnection,
-          Q_ARG(unsigned int, _entity),
-          Q_ARG(QString, QString::fromStdString(_name->Data())),
-          Q_ARG(unsigned int, parentEntity),
-          Q_ARG(QString, entityType(_entity, _ecm)));
+      added.push_back({static_cast<unsigned int>(_entity),
+          QString::fromStdString(_name->Data()),
+          static_cast<unsigned int>(parentEntity),
+          entityType(_entity, _ecm)});
       return true;
     });
   }
@@ -362,11 +594,12 @@ void EntityTree::Update(const UpdateInfo &, EntityComponentManager &_ecm)
     [&](const Entity &_entity,
         const components::Name *)->bool
   {
-    QMetaObject::invokeMethod(&this->dataPtr->treeModel, "RemoveEntity",
-        Qt::QueuedConnection,
-        Q_ARG(unsigned int, _entity));
+    removed.push_back(_entity);
     return true;
   });
+
+  this->dataPtr->treeModel.QueueChanges(std::move(added),
+      std::move(removed));
 }
 
 /////////////////////////////////////////////////
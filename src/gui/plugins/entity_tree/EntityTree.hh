@@ -18,8 +18,10 @@
 #ifndef IGNITION_GAZEBO_GUI_ENTITYTREE_HH_
 #define IGNITION_GAZEBO_GUI_ENTITYTREE_HH_
 
-#include <map>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <ignition/gazebo/gui/GuiSystem.hh>
@@ -30,11 +32,32 @@ namespace gazebo
 {
   class EntityTreePrivate;
 
-  /// \brief TODO
+  /// \brief Model of the entity tree. Entities are added and removed in
+  /// batches, and the items of an entity's children are only created once
+  /// the entity is expanded, so the cost of opening the tree depends on
+  /// what is shown rather than on the size of the world.
   class TreeModel : public QStandardItemModel
   {
     Q_OBJECT
 
+    /// \brief Entity information used to queue the pending entities
+    public: struct EntityInfo
+    {
+      /// \brief Entity ID
+      // cppcheck-suppress unusedStructMember
+      unsigned int entity;
+
+      /// \brief Entity name
+      QString name;
+
+      /// \brief Parent ID
+      // cppcheck-suppress unusedStructMember
+      unsigned int parentEntity;
+
+      /// \brief Entity type
+      QString type;
+    };
+
     /// \brief Constructor
     public: explicit TreeModel();
 
@@ -44,6 +67,25 @@ namespace gazebo
     // Documentation inherited
     public: QHash<int, QByteArray> roleNames() const override;
 
+    // Documentation inherited
+    public: bool hasChildren(
+        const QModelIndex &_parent = QModelIndex()) const override;
+
+    // Documentation inherited
+    public: bool canFetchMore(const QModelIndex &_parent) const override;
+
+    // Documentation inherited
+    public: void fetchMore(const QModelIndex &_parent) override;
+
+    /// \brief Queue entities to be added and removed. They're applied
+    /// together, on the next iteration of the Qt event loop. This can be
+    /// called from any thread.
+    /// \param[in] _added Entities to add, parents may come after their
+    /// children.
+    /// \param[in] _removed Entities to remove.
+    public: void QueueChanges(std::vector<EntityInfo> &&_added,
+        std::vector<Entity> &&_removed);
+
     /// \brief Add an entity to the tree.
     /// \param[in] _entity Entity to be added
     /// \param[in] _entityName Name of entity to be added
@@ -59,6 +101,9 @@ namespace gazebo
     /// \param[in] _entity Entity to be removed
     public slots: void RemoveEntity(unsigned int _entity);
 
+    /// \brief Apply the changes queued with QueueChanges.
+    public slots: void ProcessChanges();
+
     /// \brief Get the entity type of a tree item at specified index
     /// \param[in] _index Model index
     /// \return Type of entity
@@ -74,30 +119,66 @@ namespace gazebo
     /// \return Entity ID
     public: Q_INVOKABLE unsigned int EntityId(const QModelIndex &_index) const;
 
+    /// \brief Get the index of an entity, creating the items of its
+    /// ancestors' children if they haven't been expanded yet.
+    /// \param[in] _entity Entity ID
+    /// \return Model index, invalid if the entity isn't in the tree.
+    public: Q_INVOKABLE QModelIndex IndexForEntity(unsigned int _entity);
+
+    /// \brief Add entities, appending the new items of each parent at once.
+    /// \param[in] _added Entities to add.
+    private: void AddEntities(const std::vector<EntityInfo> &_added);
+
+    /// \brief Remove entities and their descendants.
+    /// \param[in] _removed Entities to remove.
+    private: void RemoveEntities(const std::vector<Entity> &_removed);
+
+    /// \brief Create the items of an entity's children which don't have
+    /// one yet. New children get items right away from then on.
+    /// \param[in] _entity Entity, which must have an item.
+    private: void FetchChildren(Entity _entity);
+
+    /// \brief Get the item of an entity, creating the items of its
+    /// ancestors' children as needed.
+    /// \param[in] _entity Entity
+    /// \return The item, or null if the entity isn't in the tree.
+    private: QStandardItem *PopulateEntity(Entity _entity);
+
+    /// \brief Forget an entity and its descendants, without touching the
+    /// items.
+    /// \param[in] _entity Entity
+    private: void ForgetEntity(Entity _entity);
+
+    /// \brief All entities in the tree, by ID, including the ones without
+    /// an item yet.
+    private: std::unordered_map<Entity, EntityInfo> entities;
+
     /// \brief Keep track of which item corresponds to which entity.
-    private: std::map<Entity, QStandardItem *> entityItems;
+    private: std::unordered_map<Entity, QStandardItem *> entityItems;
 
-    /// \brief Entity information used to queue the pending entities
-    struct EntityInfo
-    {
-      /// \brief Entity ID
-      // cppcheck-suppress unusedStructMember
-      unsigned int entity;
+    /// \brief Children without an item, by parent.
+    private: std::unordered_map<Entity, std::vector<Entity>>
+        unfetchedChildren;
 
-      /// \brief Entity name
-      QString name;
+    /// \brief Entities whose children all have items.
+    private: std::unordered_set<Entity> fetchedEntities;
 
-      /// \brief Parent ID
-      // cppcheck-suppress unusedStructMember
-      unsigned int parentEntity;
+    /// \brief If an entity is added before its parent, we queue it here,
+    /// by parent, until their parent shows up or they are deleted.
+    private: std::unordered_map<Entity, std::vector<EntityInfo>>
+        pendingEntities;
 
-      /// \brief Entity type
-      QString type;
-    };
+    /// \brief Protects the queued changes.
+    private: std::mutex queueMutex;
+
+    /// \brief Entities queued to be added.
+    private: std::vector<EntityInfo> addedQueue;
+
+    /// \brief Entities queued to be removed.
+    private: std::vector<Entity> removedQueue;
 
-    /// \brief If an entity is added before its parent, we queue it in this
-    /// vector until their parent shows up or they are deleted.
-    private: std::vector<EntityInfo> pendingEntities;
+    /// \brief True if ProcessChanges has been invoked but hasn't run yet.
+    private: bool changesQueued{false};
   };
 
   /// \brief Displays a tree view with all the entities in the world.
@@ -61,29 +61,24 @@ Rectangle {
     tree.selection.clear()
   }
 
-  /*
-   * Iterate through item's children until the one corresponding to _entity is
-   * found and select that.
-   */
-  function selectFromCpp(_entity, itemId) {
-    if (EntityTreeModel.data(itemId, 101) == _entity) {
-      tree.selection.select(itemId, ItemSelectionModel.Select)
-      return
-    }
-    for (var i = 0; i < EntityTreeModel.rowCount(itemId); i++) {
-      selectFromCpp(_entity, EntityTreeModel.index(i, 0, itemId))
-    }
-  }
-
   /*
    * Callback when an entity selection comes from the C++ code.
    * For example, if it comes from the 3D window.
+   * The model creates the items of collapsed ancestors as needed, which are
+   * then expanded so the entity is visible.
    */
   function onEntitySelectedFromCpp(_entity) {
-    for(var i = 0; i < EntityTreeModel.rowCount(); i++) {
-      var itemId = EntityTreeModel.index(i, 0)
-      selectFromCpp(_entity, itemId)
-    }
+    var index = EntityTreeModel.IndexForEntity(_entity)
+    if (!index.valid)
+      return
+
+    var ancestors = []
+    for (var parent = index.parent; parent.valid; parent = parent.parent)
+      ancestors.unshift(parent)
+    for (var i = 0; i < ancestors.length; i++)
+      tree.expand(ancestors[i])
+
+    tree.selection.select(index, ItemSelectionModel.Select)
   }
 
   TreeView {
@@ -184,14 +179,19 @@ Rectangle {
           font.pointSize: 12
         }
 
-        ToolTip {
-          visible: ma.containsMouse
-          delay: tooltipDelay
-          text: model === null || model.entity === undefined ?
-              "Entity Id: ?" : "Entity Id: " + model.entity
-          y: itemDel.z - 30
-          enter: null
-          exit: null
+        // Only the hovered item instantiates a tooltip, so delegates stay
+        // cheap to create while scrolling through large worlds
+        Loader {
+          active: ma.containsMouse
+          sourceComponent: ToolTip {
+            visible: true
+            delay: tooltipDelay
+            text: model === null || model.entity === undefined ?
+                "Entity Id: ?" : "Entity Id: " + model.entity
+            y: itemDel.z - 30
+            enter: null
+            exit: null
+          }
         }
 
         MouseArea {
@@ -18,14 +18,18 @@
 #include "PlaybackScrubber.hh"
 
 #include <ignition/msgs/boolean.pb.h>
+#include <ignition/msgs/int32.pb.h>
 #include <ignition/msgs/stringmsg.pb.h>
 
 #include <chrono>
 #include <ctime>
 #include <iostream>
+#include <mutex>
+#include <optional>
 #include <regex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <ignition/math/Helpers.hh>
 
@@ -67,12 +71,44 @@ namespace ignition::gazebo
 
     /// \brief Bool holding if the simulation is currently paused.
     public: bool paused{false};
+
+    /// \brief Protects the scrub and keyframe members below, which are
+    /// used from the Qt, update and transport threads.
+    public: std::mutex scrubMutex;
+
+    /// \brief Latest slider value sought while dragging, not sent yet.
+    public: std::optional<double> pendingScrub;
+
+    /// \brief True while a scrub seek waits for its response.
+    public: bool scrubInFlight{false};
+
+    /// \brief When the last scrub seek was sent.
+    public: std::chrono::steady_clock::time_point lastScrubSeek;
+
+    /// \brief Previous slider value while dragging, negative when not
+    /// dragging.
+    public: double lastScrubValue{-1.0};
+
+    /// \brief Direction of the drag, sent to LogPlayback.
+    public: int scrubDirection{0};
+
+    /// \brief Publisher of the scrub direction.
+    public: transport::Node::Publisher scrubPub;
+
+    /// \brief True once the keyframes were requested.
+    public: bool keyframesRequested{false};
+
+    /// \brief Keyframe positions on the slider, from 0 to 1.
+    public: std::vector<double> keyframes;
   };
 }
 
 using namespace ignition;
 using namespace gazebo;
 
+/// \brief Minimum time between seeks while dragging the slider.
+static constexpr std::chrono::milliseconds kScrubPeriod{100};
+
 /////////////////////////////////////////////////
 PlaybackScrubber::PlaybackScrubber() : GuiSystem(),
   dataPtr(std::make_unique<PlaybackScrubberPrivate>())
@@ -158,6 +194,26 @@ void PlaybackScrubber::Update(const UpdateInfo &_info,
     }
   }
 
+  // Keyframes to mark on the timeline, and the scrub hint publisher, once
+  // the log and world are known
+  if (!this->dataPtr->worldName.empty() && totalDuration > 0)
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->scrubMutex);
+    if (!this->dataPtr->keyframesRequested)
+    {
+      this->dataPtr->keyframesRequested = true;
+      const std::string playbackTopic{
+          "/world/" + this->dataPtr->worldName + "/playback"};
+      this->dataPtr->scrubPub = this->dataPtr->node.Advertise<msgs::Int32>(
+          playbackTopic + "/scrub");
+      this->dataPtr->node.Request(playbackTopic + "/keyframes",
+          &PlaybackScrubber::OnKeyframesResponse, this);
+    }
+
+    // Seeks coalesced while the previous one was in flight
+    this->FlushScrub();
+  }
+
   auto simTime = math::durationToSecNsec(_info.simTime);
   this->dataPtr->currentTime =
     math::secNsecToTimePoint(simTime.first, simTime.second);
@@ -229,19 +285,144 @@ void PlaybackScrubber::OnTimeEntered(const QString &_time)
 }
 
 /////////////////////////////////////////////////
-void PlaybackScrubber::OnDrop(double _value)
+std::chrono::steady_clock::time_point PlaybackScrubber::TimeAt(
+    double _value) const
 {
-  unsigned int timeout = 1000;
-  msgs::Boolean res;
-  bool result{false};
-
   auto totalDuration =
     std::chrono::duration_cast<std::chrono::nanoseconds>(
         this->dataPtr->endTime - this->dataPtr->startTime);
-  auto newTime = this->dataPtr->startTime +
+  return this->dataPtr->startTime +
     std::chrono::duration_cast<std::chrono::nanoseconds>(
         totalDuration * _value);
-  std::pair<int64_t, int64_t> jumpToTime = math::timePointToSecNsec(newTime);
+}
+
+/////////////////////////////////////////////////
+QString PlaybackScrubber::TimeAtProgress(double _value)
+{
+  return QString::fromStdString(math::timePointToString(this->TimeAt(_value)));
+}
+
+/////////////////////////////////////////////////
+QVariantList PlaybackScrubber::Keyframes()
+{
+  QVariantList keyframes;
+  std::lock_guard<std::mutex> lock(this->dataPtr->scrubMutex);
+  for (auto keyframe : this->dataPtr->keyframes)
+    keyframes.push_back(keyframe);
+  return keyframes;
+}
+
+/////////////////////////////////////////////////
+void PlaybackScrubber::OnKeyframesResponse(const msgs::Double_V &_rep,
+    const bool _result)
+{
+  // Logs without keyframes, or older LogPlayback versions
+  if (!_result || _rep.data_size() == 0)
+    return;
+
+  auto totalDuration = std::chrono::duration<double>(
+      this->dataPtr->endTime - this->dataPtr->startTime).count();
+  auto startTime = std::chrono::duration<double>(
+      this->dataPtr->startTime.time_since_epoch()).count();
+  if (totalDuration <= 0.0)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->scrubMutex);
+    this->dataPtr->keyframes.clear();
+    for (auto time : _rep.data())
+    {
+      auto progress = (time - startTime) / totalDuration;
+      if (progress >= 0.0 && progress <= 1.0)
+        this->dataPtr->keyframes.push_back(progress);
+    }
+  }
+  this->newKeyframes();
+}
+
+/////////////////////////////////////////////////
+void PlaybackScrubber::OnScrub(double _value)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->scrubMutex);
+
+  // Let LogPlayback prefetch keyframes in the direction of the drag
+  if (this->dataPtr->lastScrubValue >= 0.0 &&
+      _value != this->dataPtr->lastScrubValue)
+  {
+    int direction = _value > this->dataPtr->lastScrubValue ? 1 : -1;
+    if (direction != this->dataPtr->scrubDirection)
+    {
+      this->dataPtr->scrubDirection = direction;
+      msgs::Int32 msg;
+      msg.set_data(direction);
+      this->dataPtr->scrubPub.Publish(msg);
+    }
+  }
+  this->dataPtr->lastScrubValue = _value;
+
+  this->dataPtr->pendingScrub = _value;
+  this->FlushScrub();
+}
+
+/////////////////////////////////////////////////
+void PlaybackScrubber::FlushScrub()
+{
+  auto now = std::chrono::steady_clock::now();
+  if (!this->dataPtr->pendingScrub || this->dataPtr->scrubInFlight ||
+      now - this->dataPtr->lastScrubSeek < kScrubPeriod ||
+      this->dataPtr->worldName.empty())
+  {
+    return;
+  }
+
+  auto jumpToTime = math::timePointToSecNsec(
+      this->TimeAt(*this->dataPtr->pendingScrub));
+  this->dataPtr->pendingScrub.reset();
+
+  msgs::LogPlaybackControl playbackMsg;
+  playbackMsg.mutable_seek()->set_sec(jumpToTime.first);
+  playbackMsg.mutable_seek()->set_nsec(jumpToTime.second);
+  playbackMsg.set_pause(this->dataPtr->paused);
+  if (this->dataPtr->node.Request(
+      "/world/" + this->dataPtr->worldName + "/playback/control",
+      playbackMsg, &PlaybackScrubber::OnScrubResponse, this))
+  {
+    this->dataPtr->scrubInFlight = true;
+    this->dataPtr->lastScrubSeek = now;
+  }
+}
+
+/////////////////////////////////////////////////
+void PlaybackScrubber::OnScrubResponse(const msgs::Boolean &,
+    const bool)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->scrubMutex);
+  this->dataPtr->scrubInFlight = false;
+}
+
+/////////////////////////////////////////////////
+void PlaybackScrubber::OnDrop(double _value)
+{
+  // The drag is over, the final seek supersedes pending ones
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->scrubMutex);
+    this->dataPtr->pendingScrub.reset();
+    this->dataPtr->lastScrubValue = -1.0;
+    if (this->dataPtr->scrubDirection != 0)
+    {
+      this->dataPtr->scrubDirection = 0;
+      msgs::Int32 msg;
+      msg.set_data(0);
+      this->dataPtr->scrubPub.Publish(msg);
+    }
+  }
+
+  unsigned int timeout = 1000;
+  msgs::Boolean res;
+  bool result{false};
+
+  std::pair<int64_t, int64_t> jumpToTime =
+      math::timePointToSecNsec(this->TimeAt(_value));
 
   msgs::LogPlaybackControl playbackMsg;
 
@@ -21,6 +21,9 @@
 #include <chrono>
 #include <memory>
 
+#include <ignition/msgs/boolean.pb.h>
+#include <ignition/msgs/double_v.pb.h>
+
 #include <ignition/gui/Plugin.hh>
 #include <ignition/gazebo/gui/GuiSystem.hh>
 
@@ -30,8 +33,12 @@ namespace gazebo
 {
   class PlaybackScrubberPrivate;
 
-  /// \brief Provides buttons for adding a box, sphere, or cylinder
-  /// to the scene
+  /// \brief Slider to seek through log playback.
+  ///
+  /// While the slider is dragged, seeks are coalesced, so at most one is in
+  /// flight and they're sent at most every 100 ms, and the scrub direction
+  /// is sent to LogPlayback, which prefetches the keyframes ahead. The
+  /// keyframes of the log are marked on the timeline.
   class PlaybackScrubber : public ignition::gazebo::GuiSystem
   {
     Q_OBJECT
@@ -71,6 +78,21 @@ namespace gazebo
     /// \return The current time in format dd hh:mm:ss.nnn as a QString.
     public slots: QString CurrentTimeAsString();
 
+    /// \brief Callback in Qt thread while the slider is dragged. Seeks are
+    /// coalesced until the previous one is answered.
+    /// \param[in] _value The current value of the slider, from 0 to 1,
+    /// inclusive
+    public slots: void OnScrub(double _value);
+
+    /// \brief Get the log time at a position of the slider.
+    /// \param[in] _value Value of the slider, from 0 to 1, inclusive
+    /// \return The time in format dd hh:mm:ss.nnn as a QString.
+    public slots: QString TimeAtProgress(double _value);
+
+    /// \brief Get the positions of the log's keyframes on the slider.
+    /// \return Values from 0 to 1, inclusive.
+    public slots: QVariantList Keyframes();
+
     /// \brief Callback in Qt thread when the slider is released.
     /// \param[in] _value The current value of the slider, from 0 to 1,
     /// inclusive
@@ -83,6 +105,30 @@ namespace gazebo
     /// \brief Notify that progress has advanced in the log file.
     signals: void newProgress();
 
+    /// \brief Notify that the keyframes of the log were received.
+    signals: void newKeyframes();
+
+    /// \brief Send the pending scrub seek, if the previous one was answered
+    /// and enough time passed. Must be called with the scrub mutex locked.
+    private: void FlushScrub();
+
+    /// \brief Get the log time at a position of the slider.
+    /// \param[in] _value Value of the slider, from 0 to 1, inclusive
+    /// \return The time.
+    private: std::chrono::steady_clock::time_point TimeAt(double _value) const;
+
+    /// \brief Callback when a scrub seek is answered.
+    /// \param[in] _rep Response.
+    /// \param[in] _result Whether the request succeeded.
+    private: void OnScrubResponse(const msgs::Boolean &_rep,
+        const bool _result);
+
+    /// \brief Callback with the keyframe times of the log.
+    /// \param[in] _rep Keyframe times in seconds.
+    /// \param[in] _result Whether the request succeeded.
+    private: void OnKeyframesResponse(const msgs::Double_V &_rep,
+        const bool _result);
+
     /// \internal
     /// \brief Pointer to private data.
     private: std::unique_ptr<PlaybackScrubberPrivate> dataPtr;
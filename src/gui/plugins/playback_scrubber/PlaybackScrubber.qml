@@ -52,6 +52,11 @@ GridLayout {
    */
   property var endTime: ""
 
+  /**
+   * Positions of the log's keyframes on the slider, from 0 to 1.
+   */
+  property var keyframes: []
+
   /**
    * Update the slider to the new values if it is currently being dragged.
    */
@@ -80,7 +85,11 @@ GridLayout {
    * Update the current time the playback scrubber is at.
    */
   function updateCurrentTime() {
-    currentTime = PlaybackScrubber.CurrentTimeAsString();
+    // While dragging, the time under the handle is shown instead
+    if (!playbackScrubber.isPressed)
+    {
+      currentTime = PlaybackScrubber.CurrentTimeAsString();
+    }
   }
 
   Connections {
@@ -91,6 +100,9 @@ GridLayout {
       updateEndTime();
       updateCurrentTime();
     }
+    onNewKeyframes: {
+      keyframes = PlaybackScrubber.Keyframes();
+    }
   }
   Slider {
     id: slider
@@ -102,6 +114,13 @@ GridLayout {
     to: 1
     stepSize: 0.001
     topPadding: 17
+    onValueChanged: {
+      if (pressed)
+      {
+        PlaybackScrubber.OnScrub(slider.value);
+        currentTime = PlaybackScrubber.TimeAtProgress(slider.value);
+      }
+    }
     onPressedChanged: {
       if (!pressed)
       {
@@ -113,6 +132,18 @@ GridLayout {
         playbackScrubber.isPressed = true;
       }
     }
+
+    // Keyframe markers, seeks near them are the fastest
+    Repeater {
+      model: keyframes
+      Rectangle {
+        x: slider.leftPadding + modelData * slider.availableWidth - width / 2
+        y: slider.topPadding + slider.availableHeight / 2 + 4
+        width: 2
+        height: 6
+        color: Material.theme == Material.Light ? "#808080" : "#b0b0b0"
+      }
+    }
   }
 
   TextField {
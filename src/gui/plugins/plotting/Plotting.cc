@@ -17,6 +17,11 @@
 
 #include "Plotting.hh"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+
 #include <ignition/plugin/Register.hh>
 #include "ignition/gazebo/components/AngularAcceleration.hh"
 #include "ignition/gazebo/components/AngularVelocity.hh"
@@ -39,6 +44,26 @@
 
 namespace ignition::gazebo
 {
+  /// \brief Fixed-capacity ring buffer of the samples of one attribute
+  class TimeSeries
+  {
+    /// \brief Samples, x is the time and y the value. Once full, the
+    /// oldest sample is at next.
+    public: std::vector<math::Vector2d> samples;
+
+    /// \brief Index the next sample is written to, once full
+    public: std::size_t next{0};
+
+    /// \brief Sample with the minimum value since the last take
+    public: math::Vector2d pendingMin;
+
+    /// \brief Sample with the maximum value since the last take
+    public: math::Vector2d pendingMax;
+
+    /// \brief Whether there are samples since the last take
+    public: bool hasPending{false};
+  };
+
   class PlottingPrivate
   {
     /// \brief Interface to communicate with Qml
@@ -48,6 +73,16 @@ namespace ignition::gazebo
     /// map key: string contains EntityID + "," + ComponentID
     public: std::map<std::string,
       std::shared_ptr<PlotComponent>> components;
+
+    /// \brief Protects components, which are registered from the Qt thread
+    /// and sampled from the update thread
+    public: std::mutex mutex;
+
+    /// \brief Number of samples kept per attribute
+    public: std::size_t historySize{10000};
+
+    /// \brief Last time points were sent to the charts
+    public: std::chrono::steady_clock::time_point plotTime;
   };
 
   class PlotComponentPrivate
@@ -65,21 +100,42 @@ namespace ignition::gazebo
     /// ex: x,y,z attributes in Vector3d type component
     public: std::map<std::string,
       std::shared_ptr<ignition::gui::PlotData>> data;
+
+    /// \brief sample history of each attribute
+    public: std::map<std::string, TimeSeries> history;
+
+    /// \brief charts of each attribute which haven't received the history
+    public: std::map<std::string, std::set<int>> newCharts;
+
+    /// \brief number of samples kept per attribute
+    public: std::size_t historySize{0};
+
+    /// \brief time of the last sample
+    public: double lastTime{std::numeric_limits<double>::lowest()};
   };
 }
 
+/// \brief Minimum period between points sent to the charts. Samples in
+/// between are decimated.
+static constexpr std::chrono::milliseconds kPlotPeriod{33};
+
+/// \brief Maximum number of history points sent to a new chart
+static constexpr std::size_t kMaxHistoryPoints{2000};
+
 using namespace ignition::gazebo;
 using namespace ignition::gui;
 
 //////////////////////////////////////////////////
 PlotComponent::PlotComponent(const std::string &_type,
                              ignition::gazebo::Entity _entity,
-                             ComponentTypeId _typeId) :
+                             ComponentTypeId _typeId,
+                             std::size_t _historySize) :
     dataPtr(std::make_unique<PlotComponentPrivate>())
 {
   this->dataPtr->entity = _entity;
   this->dataPtr->typeId = _typeId;
   this->dataPtr->type = _type;
+  this->dataPtr->historySize = std::max<std::size_t>(1u, _historySize);
 
   if (_type == "Vector3d")
   {
@@ -127,6 +183,12 @@ PlotComponent::PlotComponent(const std::string &_type,
   }
   else
     ignwarn << "Invalid Plot Component Type:" << _type << std::endl;
+
+  for (const auto &attribute : this->dataPtr->data)
+  {
+    this->dataPtr->history[attribute.first].samples.reserve(
+        this->dataPtr->historySize);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -143,6 +205,7 @@ void PlotComponent::RegisterChart(std::string _attribute, int _chart)
     return;
   }
   this->dataPtr->data[_attribute]->AddChart(_chart);
+  this->dataPtr->newCharts[_attribute].insert(_chart);
 }
 
 //////////////////////////////////////////////////
@@ -154,6 +217,7 @@ void PlotComponent::UnRegisterChart(std::string _attribute, int _chart)
     return;
   }
   this->dataPtr->data[_attribute]->RemoveChart(_chart);
+  this->dataPtr->newCharts[_attribute].erase(_chart);
 }
 
 //////////////////////////////////////////////////
@@ -173,6 +237,142 @@ void PlotComponent::SetAttributeValue(std::string _attribute,
     this->dataPtr->data[_attribute]->SetValue(_value);
 }
 
+//////////////////////////////////////////////////
+void PlotComponent::Sample(double _time)
+{
+  if (_time <= this->dataPtr->lastTime)
+  {
+    if (_time == this->dataPtr->lastTime)
+      return;
+
+    // Time went back, the old samples don't belong to this run anymore
+    for (auto &series : this->dataPtr->history)
+    {
+      series.second.samples.clear();
+      series.second.next = 0;
+      series.second.hasPending = false;
+    }
+  }
+  this->dataPtr->lastTime = _time;
+
+  for (auto &series : this->dataPtr->history)
+  {
+    math::Vector2d sample(_time,
+        this->dataPtr->data[series.first]->Value());
+
+    auto &ts = series.second;
+    if (ts.samples.size() < this->dataPtr->historySize)
+    {
+      ts.samples.push_back(sample);
+    }
+    else
+    {
+      ts.samples[ts.next] = sample;
+      ts.next = (ts.next + 1) % ts.samples.size();
+    }
+
+    if (!ts.hasPending)
+    {
+      ts.pendingMin = sample;
+      ts.pendingMax = sample;
+      ts.hasPending = true;
+    }
+    else if (sample.Y() < ts.pendingMin.Y())
+    {
+      ts.pendingMin = sample;
+    }
+    else if (sample.Y() > ts.pendingMax.Y())
+    {
+      ts.pendingMax = sample;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+std::vector<math::Vector2d> PlotComponent::TakeSamples(
+    const std::string &_attribute)
+{
+  std::vector<math::Vector2d> points;
+  auto it = this->dataPtr->history.find(_attribute);
+  if (it == this->dataPtr->history.end() || !it->second.hasPending)
+    return points;
+
+  auto &ts = it->second;
+  ts.hasPending = false;
+  if (ts.pendingMin.X() == ts.pendingMax.X())
+  {
+    points.push_back(ts.pendingMin);
+  }
+  else if (ts.pendingMin.X() < ts.pendingMax.X())
+  {
+    points.push_back(ts.pendingMin);
+    points.push_back(ts.pendingMax);
+  }
+  else
+  {
+    points.push_back(ts.pendingMax);
+    points.push_back(ts.pendingMin);
+  }
+  return points;
+}
+
+//////////////////////////////////////////////////
+std::vector<math::Vector2d> PlotComponent::History(
+    const std::string &_attribute, std::size_t _maxPoints) const
+{
+  std::vector<math::Vector2d> points;
+  auto it = this->dataPtr->history.find(_attribute);
+  if (it == this->dataPtr->history.end())
+    return points;
+
+  const auto &ts = it->second;
+  const std::size_t count = ts.samples.size();
+  auto sample = [&ts, count](std::size_t _i) -> const math::Vector2d &
+  {
+    return ts.samples[(ts.next + _i) % count];
+  };
+
+  if (count <= _maxPoints)
+  {
+    points.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+      points.push_back(sample(i));
+    return points;
+  }
+
+  // Each bucket contributes its minimum and maximum
+  const std::size_t buckets = std::max<std::size_t>(1u, _maxPoints / 2);
+  const std::size_t bucketSize = (count + buckets - 1) / buckets;
+  points.reserve(buckets * 2);
+  for (std::size_t start = 0; start < count; start += bucketSize)
+  {
+    const std::size_t end = std::min(count, start + bucketSize);
+    std::size_t minIdx = start;
+    std::size_t maxIdx = start;
+    for (std::size_t i = start + 1; i < end; ++i)
+    {
+      if (sample(i).Y() < sample(minIdx).Y())
+        minIdx = i;
+      else if (sample(i).Y() > sample(maxIdx).Y())
+        maxIdx = i;
+    }
+    points.push_back(sample(std::min(minIdx, maxIdx)));
+    if (minIdx != maxIdx)
+      points.push_back(sample(std::max(minIdx, maxIdx)));
+  }
+  return points;
+}
+
+//////////////////////////////////////////////////
+std::set<int> PlotComponent::TakeNewCharts(const std::string &_attribute)
+{
+  std::set<int> charts;
+  auto it = this->dataPtr->newCharts.find(_attribute);
+  if (it != this->dataPtr->newCharts.end())
+    charts.swap(it->second);
+  return charts;
+}
+
 //////////////////////////////////////////////////
 std::map<std::string, std::shared_ptr<PlotData>> PlotComponent::Data() const
 {
@@ -218,10 +418,29 @@ Plotting ::~Plotting()
 }
 
 //////////////////////////////////////////
-void Plotting::LoadConfig(const tinyxml2::XMLElement *)
+void Plotting::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
 {
   if (this->title.empty())
     this->title = "Plotting";
+
+  if (_pluginElem)
+  {
+    if (auto elem = _pluginElem->FirstChildElement("history_size"))
+    {
+      unsigned int historySize{0};
+      if (elem->QueryUnsignedText(&historySize) == tinyxml2::XML_SUCCESS &&
+          historySize > 0)
+      {
+        std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+        this->dataPtr->historySize = historySize;
+      }
+      else
+      {
+        ignerr << "Invalid <history_size>, using ["
+               << this->dataPtr->historySize << "]" << std::endl;
+      }
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -319,10 +538,11 @@ void Plotting::RegisterChartToComponent(uint64_t _entity, uint64_t _typeId,
 {
   std::string Id = std::to_string(_entity) + "," + std::to_string(_typeId);
 
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   if (this->dataPtr->components.count(Id) == 0)
   {
     this->dataPtr->components[Id] = std::make_shared<PlotComponent>(
-          _type, _entity, _typeId);
+          _type, _entity, _typeId, this->dataPtr->historySize);
   }
 
   this->dataPtr->components[Id]->RegisterChart(_attribute, _chart);
@@ -335,6 +555,7 @@ void Plotting::UnRegisterChartFromComponent(uint64_t _entity, uint64_t _typeId,
   std::string id = std::to_string(_entity) + "," + std::to_string(_typeId);
   igndbg << "UnRegister [" << id  << "]" << std::endl;
 
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   if (this->dataPtr->components.count(id) == 0)
     return;
 
@@ -361,6 +582,13 @@ std::string Plotting::ComponentName(const uint64_t &_typeId)
 void Plotting ::Update(const ignition::gazebo::UpdateInfo &_info,
                        ignition::gazebo::EntityComponentManager &_ecm)
 {
+  // This runs on the GUI update thread, on every state received, so all
+  // states are sampled, while the Qt thread only draws
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const double time =
+      std::chrono::duration<double>(_info.simTime).count();
+
   for (auto component : this->dataPtr->components)
   {
     auto entity = component.second->Entity();
@@ -487,17 +715,42 @@ void Plotting ::Update(const ignition::gazebo::UpdateInfo &_info,
       }
     }
 
+    component.second->Sample(time);
+  }
+
+  // Send points at a bounded rate, decimating the samples in between
+  auto now = std::chrono::steady_clock::now();
+  if (now - this->dataPtr->plotTime < kPlotPeriod)
+    return;
+  this->dataPtr->plotTime = now;
+
+  for (auto component : this->dataPtr->components)
+  {
     for (auto attribute : component.second->Data())
     {
-      for (auto chart : attribute.second->Charts())
-      {
-        QString attributeName = QString::fromStdString(
-                    component.first + "," + attribute.first);
-        double y = attribute.second->Value();
+      auto points = component.second->TakeSamples(attribute.first);
+      auto newCharts = component.second->TakeNewCharts(attribute.first);
+      if (points.empty() && newCharts.empty())
+        continue;
+
+      QString attributeName = QString::fromStdString(
+                  component.first + "," + attribute.first);
 
-        double x = _info.simTime.count() * std::pow(10, -9);
+      // New charts get the history instead, which includes the new samples
+      std::vector<math::Vector2d> history;
+      if (!newCharts.empty())
+        history = component.second->History(attribute.first,
+            kMaxHistoryPoints);
 
-        emit this->dataPtr->plottingIface->plot(chart, attributeName, x, y);
+      for (auto chart : attribute.second->Charts())
+      {
+        const auto &chartPoints =
+            newCharts.count(chart) > 0 ? history : points;
+        for (const auto &point : chartPoints)
+        {
+          emit this->dataPtr->plottingIface->plot(chart, attributeName,
+              point.X(), point.Y());
+        }
       }
     }
   }
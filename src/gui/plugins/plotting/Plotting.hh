@@ -21,15 +21,19 @@
 #include <ignition/gui/Application.hh>
 #include <ignition/gui/PlottingInterface.hh>
 #include <ignition/gazebo/gui/GuiSystem.hh>
+#include <ignition/math/Vector2.hh>
 #include <ignition/math/Vector3.hh>
 #include <ignition/math/Pose3.hh>
 #include <ignition/msgs/light.pb.h>
 
 #include "sdf/Physics.hh"
 
+#include <cstddef>
 #include <map>
+#include <set>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace ignition {
 
@@ -38,16 +42,20 @@ namespace gazebo {
 class PlotComponentPrivate;
 
 /// \brief A container of the component data that keeps track of the registered
-/// attributes and update their values and their registered charts
+/// attributes and update their values and their registered charts.
+/// The samples of each attribute are kept in a fixed-capacity ring buffer,
+/// so plotting for a long time doesn't grow memory.
 class PlotComponent
 {
   /// \brief Constructor
   /// \param[in] _type component data type (Pose3d, Vector3d, double)
   /// \param [in] _entity entity id of that component
   /// \param [in] _typeId type identifier unique to each component type
+  /// \param [in] _historySize number of samples kept per attribute
   public: PlotComponent(const std::string &_type,
                         ignition::gazebo::Entity _entity,
-                        ComponentTypeId _typeId);
+                        ComponentTypeId _typeId,
+                        std::size_t _historySize = 10000);
 
   /// \brief Destructor
   public: ~PlotComponent();
@@ -73,6 +81,33 @@ class PlotComponent
   /// \param[in] _value value to be set to the attribute
   public: void SetAttributeValue(std::string _attribute, const double &_value);
 
+  /// \brief Add the current value of every attribute to its history.
+  /// Samples which don't advance in time are dropped, and the history is
+  /// cleared if time goes back, for example when the world is reset.
+  /// \param[in] _time simulation time of the values, in seconds
+  public: void Sample(double _time);
+
+  /// \brief Get the samples added since the last call, decimated to the
+  /// ones with the minimum and maximum values, in time order.
+  /// \param[in] _attribute component attribute
+  /// \return At most 2 points, x is the time and y the value
+  public: std::vector<ignition::math::Vector2d> TakeSamples(
+              const std::string &_attribute);
+
+  /// \brief Get the history of an attribute, decimated by keeping the
+  /// minimum and maximum of evenly sized buckets, so spikes aren't lost.
+  /// \param[in] _attribute component attribute
+  /// \param[in] _maxPoints maximum number of points returned
+  /// \return Points in time order, x is the time and y the value
+  public: std::vector<ignition::math::Vector2d> History(
+              const std::string &_attribute, std::size_t _maxPoints) const;
+
+  /// \brief Get the charts registered to an attribute since the last call,
+  /// which haven't received its history yet.
+  /// \param[in] _attribute component attribute
+  /// \return chart IDs
+  public: std::set<int> TakeNewCharts(const std::string &_attribute);
+
   /// \brief Get all attributes of the component
   /// \return component attributes
   public: std::map<std::string, std::shared_ptr<ignition::gui::PlotData>>
@@ -93,7 +128,16 @@ class PlotComponent
 class PlottingPrivate;
 
 /// \brief Physics data plotting handler that keeps track of the
-/// registered components, update them and update the plot
+/// registered components, update them and update the plot.
+///
+/// Components are sampled on every state received by the GUI, from the
+/// update thread, and the charts are sent decimated points at a bounded
+/// rate.
+///
+/// ## Configuration
+///
+/// * \<history_size\> : Number of samples kept per attribute, used to
+///                       fill charts added later. Defaults to 10000.
 class Plotting : public ignition::gazebo::GuiSystem
 {
   Q_OBJECT
@@ -104,7 +148,7 @@ class Plotting : public ignition::gazebo::GuiSystem
   public: ~Plotting();
 
   // Documentation inherited
-  public: void LoadConfig(const tinyxml2::XMLElement *) override;
+  public: void LoadConfig(const tinyxml2::XMLElement *_pluginElem) override;
 
   // Documentation inherited
   public: void Update(const ignition::gazebo::UpdateInfo &_info,
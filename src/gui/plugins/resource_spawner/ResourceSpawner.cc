@@ -21,8 +21,17 @@
 #include <ignition/msgs/stringmsg.pb.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <fstream>
+#include <mutex>
 #include <set>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <sdf/Root.hh>
 #include <sdf/parser.hh>
@@ -64,10 +73,33 @@ namespace ignition::gazebo
             fuelClient = nullptr;
 
     /// \brief The map to cache resources after a search is made on an owner,
-    /// reduces redundant searches
+    /// reduces redundant searches. Filled progressively by the Fuel thread.
     public: std::unordered_map<std::string,
             std::vector<Resource>> ownerModelMap;
 
+    /// \brief Resources of each local path, scanned in the background
+    public: std::unordered_map<std::string,
+            std::vector<Resource>> localModelMap;
+
+    /// \brief Local paths being scanned
+    public: std::set<std::string> scanningPaths;
+
+    /// \brief Protects ownerModelMap, localModelMap and scanningPaths, which
+    /// are written by the loading threads
+    public: std::mutex resourcesMutex;
+
+    /// \brief Thread loading the Fuel catalogs
+    public: std::thread fuelThread;
+
+    /// \brief Threads scanning local paths
+    public: std::vector<std::thread> scanThreads;
+
+    /// \brief Set on destruction to stop the loading threads
+    public: std::atomic<bool> stop{false};
+
+    /// \brief Owners currently listed, only used on the Qt thread
+    public: std::set<std::string> listedOwners;
+
     /// \brief Holds all of the relevant data used by `DisplayData()` in order
     /// to filter and sort the displayed resources as desired by the user.
     public: Display displayData;
@@ -77,6 +109,79 @@ namespace ignition::gazebo
 using namespace ignition;
 using namespace gazebo;
 
+/// \brief Number of Fuel models fetched between updates of the owner list,
+/// when there's no cached index yet
+static constexpr std::size_t kFuelBatchSize{200};
+
+/////////////////////////////////////////////////
+/// \brief Get the path of the cached index of a Fuel server's models
+/// \param[in] _serverUrl URL of the server
+/// \return Path of the index file
+static std::string fuelIndexPath(const std::string &_serverUrl)
+{
+  std::string fileName = _serverUrl;
+  std::replace_if(fileName.begin(), fileName.end(),
+      [](char _c) { return !std::isalnum(static_cast<unsigned char>(_c)); },
+      '_');
+
+  std::string home;
+  common::env(IGN_HOMEDIR, home);
+  return common::joinPaths(home, ".ignition", "gazebo", "resource_spawner",
+      fileName + ".index");
+}
+
+/////////////////////////////////////////////////
+/// \brief Read the cached index of a Fuel server's models
+/// \param[in] _serverUrl URL of the server
+/// \return Identifiers of the models, one per line as
+/// "owner<TAB>name<TAB>unique name"
+static std::vector<std::array<std::string, 3>> readFuelIndex(
+    const std::string &_serverUrl)
+{
+  std::vector<std::array<std::string, 3>> ids;
+  std::ifstream in(fuelIndexPath(_serverUrl));
+  std::string line;
+  while (std::getline(in, line))
+  {
+    std::array<std::string, 3> id;
+    std::istringstream lineStream(line);
+    if (std::getline(lineStream, id[0], '\t') &&
+        std::getline(lineStream, id[1], '\t') &&
+        std::getline(lineStream, id[2]))
+    {
+      ids.push_back(id);
+    }
+  }
+  return ids;
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the cached index of a Fuel server's models
+/// \param[in] _serverUrl URL of the server
+/// \param[in] _ids Identifiers of the models
+static void writeFuelIndex(const std::string &_serverUrl,
+    const std::vector<std::array<std::string, 3>> &_ids)
+{
+  auto path = fuelIndexPath(_serverUrl);
+  common::createDirectories(common::parentPath(path));
+
+  // Write to a temporary file first, so a GUI closed while writing doesn't
+  // leave a truncated index
+  auto tmpPath = path + ".tmp";
+  {
+    std::ofstream out(tmpPath);
+    for (const auto &id : _ids)
+      out << id[0] << '\t' << id[1] << '\t' << id[2] << '\n';
+    if (!out)
+    {
+      ignwarn << "Failed to write Fuel index [" << tmpPath << "]"
+              << std::endl;
+      return;
+    }
+  }
+  common::moveFile(tmpPath, path);
+}
+
 /////////////////////////////////////////////////
 PathModel::PathModel() : QStandardItemModel()
 {
@@ -221,7 +326,17 @@ ResourceSpawner::ResourceSpawner()
 }
 
 /////////////////////////////////////////////////
-ResourceSpawner::~ResourceSpawner() = default;
+ResourceSpawner::~ResourceSpawner()
+{
+  this->dataPtr->stop = true;
+  if (this->dataPtr->fuelThread.joinable())
+    this->dataPtr->fuelThread.join();
+  for (auto &thread : this->dataPtr->scanThreads)
+  {
+    if (thread.joinable())
+      thread.join();
+  }
+}
 
 /////////////////////////////////////////////////
 void ResourceSpawner::SetThumbnail(const std::string &_thumbnailPath,
@@ -328,6 +443,7 @@ std::vector<Resource> ResourceSpawner::FuelResources(const std::string &_owner)
 {
   std::vector<Resource> fuelResources;
 
+  std::lock_guard<std::mutex> lock(this->dataPtr->resourcesMutex);
   if (this->dataPtr->ownerModelMap.find(_owner) !=
       this->dataPtr->ownerModelMap.end())
   {
@@ -437,7 +553,12 @@ void ResourceSpawner::Resources(std::vector<Resource> &_resources)
   }
   else
   {
-    _resources = this->LocalResources(this->dataPtr->displayData.ownerPath);
+    // Scanned in the background, see OnPathClicked
+    std::lock_guard<std::mutex> lock(this->dataPtr->resourcesMutex);
+    auto it = this->dataPtr->localModelMap.find(
+        this->dataPtr->displayData.ownerPath);
+    if (it != this->dataPtr->localModelMap.end())
+      _resources = it->second;
   }
 }
 
@@ -468,8 +589,66 @@ void ResourceSpawner::AddPath(const std::string &_path)
 /////////////////////////////////////////////////
 void ResourceSpawner::OnPathClicked(const QString &_path)
 {
-  this->dataPtr->displayData.ownerPath = _path.toStdString();
+  const auto path = _path.toStdString();
+  this->dataPtr->displayData.ownerPath = path;
   this->dataPtr->displayData.isFuel = false;
+
+  // Scan the path in the background. Resources found by a previous scan
+  // are displayed meanwhile, and updated once the scan is done, in case
+  // models were added since.
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->resourcesMutex);
+    if (!this->dataPtr->scanningPaths.insert(path).second)
+      return;
+  }
+
+  this->dataPtr->scanThreads.emplace_back([this, path]
+  {
+    auto resources = this->LocalResources(path);
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->resourcesMutex);
+      this->dataPtr->scanningPaths.erase(path);
+      this->dataPtr->localModelMap[path] = std::move(resources);
+    }
+    if (!this->dataPtr->stop)
+    {
+      QMetaObject::invokeMethod(this, "OnLocalResourcesLoaded",
+          Qt::QueuedConnection, Q_ARG(QString, QString::fromStdString(path)));
+    }
+  });
+}
+
+/////////////////////////////////////////////////
+void ResourceSpawner::OnLocalResourcesLoaded(const QString &_path)
+{
+  if (!this->dataPtr->displayData.isFuel &&
+      this->dataPtr->displayData.ownerPath == _path.toStdString())
+  {
+    this->DisplayResources();
+  }
+}
+
+/////////////////////////////////////////////////
+void ResourceSpawner::OnFuelResourcesLoaded()
+{
+  std::set<std::string> owners;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->resourcesMutex);
+    for (const auto &owner : this->dataPtr->ownerModelMap)
+      owners.insert(owner.first);
+  }
+
+  // Owners are only relisted when they change, which clears the selection
+  if (owners != this->dataPtr->listedOwners)
+  {
+    this->dataPtr->ownerModel.clear();
+    for (const auto &owner : owners)
+      this->dataPtr->ownerModel.AddPath(owner);
+    this->dataPtr->listedOwners = owners;
+  }
+
+  if (this->dataPtr->displayData.isFuel)
+    this->DisplayResources();
 }
 
 /////////////////////////////////////////////////
@@ -494,6 +673,7 @@ void ResourceSpawner::OnDownloadFuelResource(const QString &_path,
     this->dataPtr->resourceModel.UpdateResourceModel(index, modelResource);
 
     // Update the ground truth ownerModelMap
+    std::lock_guard<std::mutex> lock(this->dataPtr->resourcesMutex);
     if (this->dataPtr->ownerModelMap.find(_owner.toStdString()) !=
         this->dataPtr->ownerModelMap.end())
     {
@@ -554,59 +734,120 @@ void ResourceSpawner::LoadConfig(const tinyxml2::XMLElement *)
   ignmsg << "Please wait... Loading models from Fuel.\n";
 
   // Add notice for the user that fuel resources are being loaded
-  this->dataPtr->ownerModel.AddPath("Please wait... Loading models from Fuel.");
+  const std::string waitMsg{"Please wait... Loading models from Fuel."};
+  this->dataPtr->ownerModel.AddPath(waitMsg);
+  this->dataPtr->listedOwners = {waitMsg};
 
-  // Pull in fuel models asynchronously
-  std::thread t([this, servers]
+  // Pull in fuel models asynchronously. The index cached from the last run
+  // is listed first, then the catalogs are fetched and the index updated.
+  this->dataPtr->fuelThread = std::thread([this, servers]
   {
-    // A set isn't necessary to keep track of the owners, but it
-    // maintains alphabetical order
-    std::set<std::string> ownerSet;
-    for (auto const &server : servers)
+    // Models of each server
+    std::vector<std::vector<std::array<std::string, 3>>> serverIds(
+        servers.size());
+
+    // Resources already built, by unique name, so the model cache is only
+    // checked once per model
+    std::unordered_map<std::string, Resource> built;
+
+    // Build the resources of all servers and pass them to the Qt thread
+    auto publish = [&]()
     {
-      std::vector<ignition::fuel_tools::ModelIdentifier> models;
-      for (auto iter = this->dataPtr->fuelClient->Models(server); iter; ++iter)
+      std::unordered_map<std::string, std::vector<Resource>> ownerMap;
+      for (const auto &ids : serverIds)
       {
-        models.push_back(iter->Identification());
+        for (const auto &id : ids)
+        {
+          if (this->dataPtr->stop)
+            return;
+
+          auto builtIt = built.find(id[2]);
+          if (builtIt != built.end())
+          {
+            ownerMap[id[0]].push_back(builtIt->second);
+            continue;
+          }
+
+          Resource resource;
+          resource.owner = id[0];
+          resource.name = id[1];
+          resource.isFuel = true;
+          resource.isDownloaded = false;
+          resource.sdfPath = id[2];
+          std::string path;
+
+          // If the resource is cached, we can go ahead and populate the
+          // respective information
+          if (this->dataPtr->fuelClient->CachedModel(
+                ignition::common::URI(id[2]), path))
+          {
+            resource.isDownloaded = true;
+            resource.sdfPath = ignition::common::joinPaths(path, "model.sdf");
+            std::string thumbnailPath = common::joinPaths(path, "thumbnails");
+            this->SetThumbnail(thumbnailPath, resource);
+          }
+          built[id[2]] = resource;
+          ownerMap[id[0]].push_back(resource);
+        }
       }
 
-      // Create each fuel resource and add them to the ownerModelMap
-      for (auto id : models)
       {
-        Resource resource;
-        resource.name = id.Name();
-        resource.isFuel = true;
-        resource.isDownloaded = false;
-        resource.owner = id.Owner();
-        resource.sdfPath = id.UniqueName();
-        std::string path;
-
-        // If the resource is cached, we can go ahead and populate the
-        // respective information
-        if (this->dataPtr->fuelClient->CachedModel(
-              ignition::common::URI(id.UniqueName()), path))
+        std::lock_guard<std::mutex> lock(this->dataPtr->resourcesMutex);
+        this->dataPtr->ownerModelMap.swap(ownerMap);
+      }
+      QMetaObject::invokeMethod(this, "OnFuelResourcesLoaded",
+          Qt::QueuedConnection);
+    };
+
+    std::vector<bool> hasIndex;
+    for (std::size_t i = 0; i < servers.size(); ++i)
+    {
+      serverIds[i] = readFuelIndex(servers[i].Url().Str());
+      hasIndex.push_back(!serverIds[i].empty());
+    }
+    if (std::find(hasIndex.begin(), hasIndex.end(), true) != hasIndex.end())
+      publish();
+
+    for (std::size_t i = 0; i < servers.size(); ++i)
+    {
+      std::vector<std::array<std::string, 3>> ids;
+      for (auto iter = this->dataPtr->fuelClient->Models(servers[i]); iter;
+           ++iter)
+      {
+        if (this->dataPtr->stop)
+          return;
+
+        auto id = iter->Identification();
+        ids.push_back({id.Owner(), id.Name(), id.UniqueName()});
+
+        // Without an index, list the models as they arrive
+        if (!hasIndex[i] && ids.size() % kFuelBatchSize == 0)
         {
-          resource.isDownloaded = true;
-          resource.sdfPath = ignition::common::joinPaths(path, "model.sdf");
-          std::string thumbnailPath = common::joinPaths(path, "thumbnails");
-          this->SetThumbnail(thumbnailPath, resource);
+          serverIds[i] = ids;
+          publish();
         }
-        ownerSet.insert(id.Owner());
-        this->dataPtr->ownerModelMap[id.Owner()].push_back(resource);
       }
-    }
 
-    // Clear the loading message
-    this->dataPtr->ownerModel.clear();
+      if (ids.empty())
+      {
+        ignwarn << "No models fetched from Fuel server ["
+                << servers[i].Url().Str() << "]" << std::endl;
+        continue;
+      }
 
-    // Add all unique owners to the owner model
-    for (const auto &resource : ownerSet)
-    {
-      this->dataPtr->ownerModel.AddPath(resource);
+      if (ids != serverIds[i])
+      {
+        serverIds[i] = ids;
+        writeFuelIndex(servers[i].Url().Str(), ids);
+        publish();
+      }
     }
+
+    // Clear the loading message if nothing was listed yet
+    QMetaObject::invokeMethod(this, "OnFuelResourcesLoaded",
+        Qt::QueuedConnection);
     ignmsg << "Fuel resources loaded.\n";
   });
-  t.detach();
 }
 
 /////////////////////////////////////////////////
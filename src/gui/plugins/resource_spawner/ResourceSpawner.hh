@@ -200,10 +200,20 @@ namespace gazebo
     public slots: void DisplayResources();
 
     /// \brief Callback when a resource path is selected, will clear the
-    /// currently loaded resources and load the ones at the specified path
+    /// currently loaded resources and start loading the ones at the
+    /// specified path in the background
     /// \param[in] _path The path to search resources
     public slots: void OnPathClicked(const QString &_path);
 
+    /// \brief Called on the Qt thread when the resources of a local path
+    /// are done loading, displays them if the path is still selected.
+    /// \param[in] _path The path which was searched
+    private slots: void OnLocalResourcesLoaded(const QString &_path);
+
+    /// \brief Called on the Qt thread whenever more Fuel resources are
+    /// loaded, updates the owner list and the displayed resources.
+    private slots: void OnFuelResourcesLoaded();
+
     /// \brief Callback when a fuel owner is selected, will clear the
     /// currently loaded resources and load the ones belonging to the
     /// specified owner.
@@ -441,6 +441,10 @@ Rectangle {
                 (model.thumbnail == "" ?
                 "NoThumbnail.png" : "file:" + model.thumbnail)
                 fillMode: Image.PreserveAspectFit
+                // Decode thumbnails off the GUI thread, at the cell size
+                asynchronous: true
+                sourceSize.width: gridView.cellWidth
+                sourceSize.height: gridView.cellHeight
               }
             }
             MouseArea {
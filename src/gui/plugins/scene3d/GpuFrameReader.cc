@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "GpuFrameReader.hh"
+
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+
+#include <algorithm>
+#include <cstring>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+
+using namespace ignition;
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+GpuFrameReader::~GpuFrameReader() = default;
+
+/////////////////////////////////////////////////
+bool GpuFrameReader::Init()
+{
+  if (this->initialized)
+    return this->supported;
+  this->initialized = true;
+
+  auto context = QOpenGLContext::currentContext();
+  if (nullptr == context || context->format().majorVersion() < 3)
+  {
+    ignwarn << "OpenGL 3.0 isn't available, video frames will be read "
+            << "synchronously." << std::endl;
+    return false;
+  }
+
+  this->gl = context->extraFunctions();
+  this->gl->glGenFramebuffers(1, &this->fbo);
+  for (auto &slot : this->slots)
+    this->gl->glGenBuffers(1, &slot.pbo);
+
+  this->supported = true;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool GpuFrameReader::Read(unsigned int _texture, unsigned int _width,
+    unsigned int _height,
+    const std::chrono::steady_clock::time_point &_timestamp,
+    const FrameCallback &_cb)
+{
+  IGN_PROFILE("GpuFrameReader::Read");
+  if (0u == _texture || 0u == _width || 0u == _height || !this->Init())
+    return false;
+
+  // Make room, the next slot holds the oldest frame when all are in use
+  if (this->pending.size() == kSlotCount)
+  {
+    this->Deliver(this->pending.front(), _cb);
+    this->pending.pop_front();
+  }
+
+  Slot &slot = this->slots[this->next];
+  auto gl = this->gl;
+
+  // The renderer keeps track of its own bindings, so they're restored
+  GLint prevFbo{0};
+  GLint prevPbo{0};
+  GLint prevAlignment{4};
+  gl->glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevFbo);
+  gl->glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &prevPbo);
+  gl->glGetIntegerv(GL_PACK_ALIGNMENT, &prevAlignment);
+
+  gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, this->fbo);
+  gl->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+      GL_TEXTURE_2D, _texture, 0);
+  const bool complete = gl->glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) ==
+      GL_FRAMEBUFFER_COMPLETE;
+  if (complete)
+  {
+    const std::size_t size = std::size_t{_width} * _height * 3u;
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    if (slot.size != size)
+    {
+      gl->glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size),
+          nullptr, GL_STREAM_READ);
+      slot.size = size;
+    }
+    gl->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    gl->glReadBuffer(GL_COLOR_ATTACHMENT0);
+    gl->glReadPixels(0, 0, static_cast<GLsizei>(_width),
+        static_cast<GLsizei>(_height), GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    slot.fence = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.width = _width;
+    slot.height = _height;
+    slot.timestamp = _timestamp;
+  }
+
+  gl->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+      GL_TEXTURE_2D, 0, 0);
+  gl->glPixelStorei(GL_PACK_ALIGNMENT, prevAlignment);
+  gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, static_cast<GLuint>(prevPbo));
+  gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(prevFbo));
+
+  if (!complete)
+  {
+    ignwarn << "Can't read back texture [" << _texture << "], video frames "
+            << "will be read synchronously." << std::endl;
+    this->Release();
+    this->initialized = true;
+    return false;
+  }
+
+  // Make sure the fence reaches the GPU, so it's signaled without waiting
+  gl->glFlush();
+  this->pending.push_back(this->next);
+  this->next = (this->next + 1) % kSlotCount;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void GpuFrameReader::Collect(bool _wait, const FrameCallback &_cb)
+{
+  IGN_PROFILE("GpuFrameReader::Collect");
+  while (!this->pending.empty())
+  {
+    const std::size_t index = this->pending.front();
+    const auto fence = this->slots[index].fence;
+    if (!_wait && nullptr != fence &&
+        this->gl->glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+    {
+      return;
+    }
+    this->Deliver(index, _cb);
+    this->pending.pop_front();
+  }
+}
+
+/////////////////////////////////////////////////
+void GpuFrameReader::Deliver(std::size_t _slot, const FrameCallback &_cb)
+{
+  Slot &slot = this->slots[_slot];
+  auto gl = this->gl;
+
+  if (nullptr == slot.fence)
+    return;
+
+  // Wait for up to a second if it's not done yet
+  gl->glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+      1000000000u);
+  gl->glDeleteSync(slot.fence);
+  slot.fence = nullptr;
+
+  // Reuse a buffer the encoder is done with
+  if (slot.size != this->bufferSize)
+  {
+    this->buffers.clear();
+    this->bufferSize = slot.size;
+  }
+  std::shared_ptr<unsigned char> buffer;
+  for (auto &candidate : this->buffers)
+  {
+    if (candidate.use_count() == 1)
+    {
+      buffer = candidate;
+      break;
+    }
+  }
+  if (!buffer)
+  {
+    buffer = std::shared_ptr<unsigned char>(new unsigned char[slot.size],
+        std::default_delete<unsigned char[]>());
+    this->buffers.push_back(buffer);
+  }
+
+  GLint prevPbo{0};
+  gl->glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &prevPbo);
+  gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+  auto pixels = static_cast<const unsigned char *>(gl->glMapBufferRange(
+      GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(slot.size),
+      GL_MAP_READ_BIT));
+  bool mapped = nullptr != pixels;
+  if (mapped)
+  {
+    // OpenGL rows start at the bottom
+    const std::size_t rowSize = std::size_t{slot.width} * 3u;
+    for (unsigned int row = 0; row < slot.height; ++row)
+    {
+      std::memcpy(buffer.get() + row * rowSize,
+          pixels + (slot.height - 1u - row) * rowSize, rowSize);
+    }
+    gl->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, static_cast<GLuint>(prevPbo));
+
+  if (mapped)
+    _cb(buffer, slot.width, slot.height, slot.timestamp);
+}
+
+/////////////////////////////////////////////////
+void GpuFrameReader::Release()
+{
+  if (this->supported)
+  {
+    for (auto &slot : this->slots)
+    {
+      if (slot.fence)
+        this->gl->glDeleteSync(slot.fence);
+      this->gl->glDeleteBuffers(1, &slot.pbo);
+      slot = Slot();
+    }
+    this->gl->glDeleteFramebuffers(1, &this->fbo);
+    this->fbo = 0;
+  }
+
+  this->pending.clear();
+  this->next = 0;
+  this->buffers.clear();
+  this->bufferSize = 0;
+  this->gl = nullptr;
+  this->supported = false;
+  this->initialized = false;
+}
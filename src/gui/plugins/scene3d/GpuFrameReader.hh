@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_GUI_GPUFRAMEREADER_HH_
+#define IGNITION_GAZEBO_GUI_GPUFRAMEREADER_HH_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ignition/gazebo/config.hh"
+
+class QOpenGLExtraFunctions;
+struct __GLsync;
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+  /// \brief Reads render textures back from the GPU without waiting for
+  /// them, so the render thread isn't stalled while recording video.
+  ///
+  /// Each read copies the texture into a pixel buffer object and returns
+  /// right away. Frames are handed out by Collect, in order, once the GPU
+  /// is done with them, typically one or two frames later. All functions
+  /// must be called on a thread whose current OpenGL context can use the
+  /// textures, and requires OpenGL 3.0 or later.
+  class GpuFrameReader
+  {
+    /// \brief Receives a frame which was read back.
+    /// The arguments are the RGB pixels, 3 bytes per pixel and top row
+    /// first, the width and height in pixels, and the frame's timestamp.
+    /// The pixels aren't reused while the pointer is kept.
+    public: using FrameCallback = std::function<void(
+        const std::shared_ptr<const unsigned char> &, unsigned int,
+        unsigned int, const std::chrono::steady_clock::time_point &)>;
+
+    /// \brief Destructor. Release must have been called while the context
+    /// was current, or the OpenGL objects are leaked.
+    public: ~GpuFrameReader();
+
+    /// \brief Start reading back a texture. If all the buffers are in use,
+    /// the oldest frame is collected first, waiting for it if needed.
+    /// \param[in] _texture OpenGL id of a 2D texture.
+    /// \param[in] _width Width of the texture in pixels.
+    /// \param[in] _height Height of the texture in pixels.
+    /// \param[in] _timestamp Time of the frame.
+    /// \param[in] _cb Receives the frames collected to make room.
+    /// \return False if asynchronous reads aren't supported, in which case
+    /// the frame must be read some other way.
+    public: bool Read(unsigned int _texture, unsigned int _width,
+                unsigned int _height,
+                const std::chrono::steady_clock::time_point &_timestamp,
+                const FrameCallback &_cb);
+
+    /// \brief Hand out the frames which finished reading back.
+    /// \param[in] _wait True to wait for all pending frames, such as when
+    /// recording stops.
+    /// \param[in] _cb Receives the frames, oldest first.
+    public: void Collect(bool _wait, const FrameCallback &_cb);
+
+    /// \brief Drop pending frames and delete the OpenGL objects.
+    public: void Release();
+
+    /// \brief Check support and create the OpenGL objects, once.
+    /// \return True if asynchronous reads are supported.
+    private: bool Init();
+
+    /// \brief Map a pending buffer and hand out its frame.
+    /// \param[in] _slot Index of the buffer.
+    /// \param[in] _cb Receives the frame.
+    private: void Deliver(std::size_t _slot, const FrameCallback &_cb);
+
+    /// \brief A pixel buffer object, and the frame being read into it.
+    private: struct Slot
+    {
+      /// \brief Pixel buffer object.
+      unsigned int pbo{0};
+
+      /// \brief Size of the buffer in bytes.
+      std::size_t size{0};
+
+      /// \brief Signaled when the GPU wrote the frame to the buffer.
+      __GLsync *fence{nullptr};
+
+      /// \brief Width of the frame in pixels.
+      unsigned int width{0};
+
+      /// \brief Height of the frame in pixels.
+      unsigned int height{0};
+
+      /// \brief Time of the frame.
+      std::chrono::steady_clock::time_point timestamp;
+    };
+
+    /// \brief Number of frames which can be read back at once.
+    private: static constexpr std::size_t kSlotCount{3};
+
+    /// \brief OpenGL functions of the context, null before Init.
+    private: QOpenGLExtraFunctions *gl{nullptr};
+
+    /// \brief Whether Init ran.
+    private: bool initialized{false};
+
+    /// \brief Whether the context supports asynchronous reads.
+    private: bool supported{false};
+
+    /// \brief Framebuffer the textures are attached to for reading.
+    private: unsigned int fbo{0};
+
+    /// \brief Buffers frames are read into.
+    private: std::array<Slot, kSlotCount> slots;
+
+    /// \brief Slots with a pending read, oldest first.
+    private: std::deque<std::size_t> pending;
+
+    /// \brief Slot written by the next read.
+    private: std::size_t next{0};
+
+    /// \brief CPU buffers handed out with frames, reused once released.
+    private: std::vector<std::shared_ptr<unsigned char>> buffers;
+
+    /// \brief Size in bytes of each of buffers.
+    private: std::size_t bufferSize{0};
+  };
+}
+}
+}
+#endif
@@ -17,7 +17,10 @@
 
 #include "Scene3D.hh"
 
+#include <ignition/msgs/pose_v.pb.h>
+
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <condition_variable>
 #include <limits>
@@ -39,7 +42,6 @@
 #include <ignition/common/MeshManager.hh>
 #include <ignition/common/Profiler.hh>
 #include <ignition/common/Uuid.hh>
-#include <ignition/common/VideoEncoder.hh>
 
 #include <ignition/plugin/Register.hh>
 
@@ -66,8 +68,11 @@
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/gui/GuiEvents.hh"
+#include "ignition/gazebo/rendering/AsyncVideoEncoder.hh"
 #include "ignition/gazebo/rendering/RenderUtil.hh"
 
+#include "GpuFrameReader.hh"
+
 /// \brief condition variable for lockstepping video recording
 /// todo(anyone) avoid using a global condition variable when we support
 /// multiple viewports in the future.
@@ -307,8 +312,15 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     /// \brief Image from user camera
     public: rendering::Image cameraImage;
 
-    /// \brief Video encoder
-    public: common::VideoEncoder videoEncoder;
+    /// \brief Video encoder, encoding on its own thread
+    public: AsyncVideoEncoder videoEncoder;
+
+    /// \brief Reads recorded frames back from the GPU without stalling
+    /// rendering.
+    public: GpuFrameReader frameReader;
+
+    /// \brief Passes the frames read back by frameReader to videoEncoder.
+    public: GpuFrameReader::FrameCallback encodeFrame;
 
     /// \brief Ray query for mouse clicks
     public: rendering::RayQueryPtr rayQuery;
@@ -325,6 +337,12 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     /// \brief Name of service for setting entity pose
     public: std::string poseCmdService;
 
+    /// \brief Publisher of the poses of entities being dragged
+    public: transport::Node::Publisher poseEditPub;
+
+    /// \brief When a pose was last streamed while dragging
+    public: std::chrono::steady_clock::time_point lastPoseEdit;
+
     /// \brief Name of service for creating entity
     public: std::string createCmdService;
 
@@ -457,11 +475,45 @@ IgnRenderer::IgnRenderer()
     this->dataPtr->node.Advertise<msgs::Time>(recorderStatsTopic);
   ignmsg << "Video recorder stats topic advertised on ["
          << recorderStatsTopic << "]" << std::endl;
+
+  this->dataPtr->encodeFrame =
+      [this](const std::shared_ptr<const unsigned char> &_frame,
+          unsigned int _width, unsigned int _height,
+          const std::chrono::steady_clock::time_point &_t)
+      {
+        this->dataPtr->videoEncoder.AddFrame(_frame, _width, _height, _t);
+      };
+
+  // publish recorder stats as frames are encoded
+  this->dataPtr->videoEncoder.SetFrameAddedCallback(
+      [this](const std::chrono::steady_clock::time_point &_t)
+      {
+        if (this->dataPtr->recordStartTime ==
+            std::chrono::steady_clock::time_point(
+            std::chrono::duration(std::chrono::seconds(0))))
+        {
+          // start time, i.e. time when first frame is added
+          this->dataPtr->recordStartTime = _t;
+        }
+
+        std::chrono::steady_clock::duration dt;
+        dt = _t - this->dataPtr->recordStartTime;
+        int64_t sec, nsec;
+        std::tie(sec, nsec) = ignition::math::durationToSecNsec(dt);
+        msgs::Time msg;
+        msg.set_sec(sec);
+        msg.set_nsec(nsec);
+        this->dataPtr->recorderStatsPub.Publish(msg);
+      });
 }
 
 
 /////////////////////////////////////////////////
-IgnRenderer::~IgnRenderer() = default;
+IgnRenderer::~IgnRenderer()
+{
+  // Finish encoding before the stats publisher goes away
+  this->dataPtr->videoEncoder.Stop();
+}
 
 ////////////////////////////////////////////////
 RenderUtil *IgnRenderer::RenderUtil() const
@@ -565,8 +617,6 @@ void IgnRenderer::Render()
       // Video recorder is on. Add more frames to it
       if (this->dataPtr->videoEncoder.IsEncoding())
       {
-        this->dataPtr->camera->Copy(this->dataPtr->cameraImage);
-
         std::chrono::steady_clock::time_point t =
             std::chrono::steady_clock::now();
         if (this->dataPtr->recordVideoUseSimTime)
@@ -574,28 +624,19 @@ void IgnRenderer::Render()
           t = std::chrono::steady_clock::time_point(
               this->dataPtr->renderUtil.SimTime());
         }
-        bool frameAdded = this->dataPtr->videoEncoder.AddFrame(
-            this->dataPtr->cameraImage.Data<unsigned char>(), width, height, t);
 
-        if (frameAdded)
+        // Frames are read back asynchronously and reach the encoder a frame
+        // or two later. Encoded on the encoder's thread, which publishes
+        // recorder stats.
+        this->dataPtr->frameReader.Collect(false,
+            this->dataPtr->encodeFrame);
+        if (!this->dataPtr->frameReader.Read(this->textureId, width, height,
+            t, this->dataPtr->encodeFrame))
         {
-          // publish recorder stats
-          if (this->dataPtr->recordStartTime ==
-              std::chrono::steady_clock::time_point(
-              std::chrono::duration(std::chrono::seconds(0))))
-          {
-            // start time, i.e. time when first frame is added
-            this->dataPtr->recordStartTime = t;
-          }
-
-          std::chrono::steady_clock::duration dt;
-          dt = t - this->dataPtr->recordStartTime;
-          int64_t sec, nsec;
-          std::tie(sec, nsec) = ignition::math::durationToSecNsec(dt);
-          msgs::Time msg;
-          msg.set_sec(sec);
-          msg.set_nsec(nsec);
-          this->dataPtr->recorderStatsPub.Publish(msg);
+          this->dataPtr->camera->Copy(this->dataPtr->cameraImage);
+          this->dataPtr->videoEncoder.AddFrame(
+              this->dataPtr->cameraImage.Data<unsigned char>(), width, height,
+              t);
         }
       }
       // Video recorder is idle. Start recording.
@@ -623,6 +664,7 @@ void IgnRenderer::Render()
     }
     else if (this->dataPtr->videoEncoder.IsEncoding())
     {
+      this->dataPtr->frameReader.Collect(true, this->dataPtr->encodeFrame);
       this->dataPtr->videoEncoder.Stop();
     }
   }
@@ -947,6 +989,11 @@ void IgnRenderer::HandleMouseEvent()
   this->HandleModelPlacement();
   this->HandleMouseTransformControl();
   this->HandleMouseViewControl();
+
+  // The hover position is handled once per mouse move, not once per frame.
+  // While placing, it's kept until the spawn preview uses it.
+  if (!this->dataPtr->isPlacing)
+    this->dataPtr->hoverDirty = false;
 }
 
 /////////////////////////////////////////////////
@@ -954,7 +1001,24 @@ void IgnRenderer::BroadcastHoverPos()
 {
   if (this->dataPtr->hoverDirty)
   {
-    math::Vector3d pos = this->ScreenToScene(this->dataPtr->mouseHoverPos);
+    math::Vector3d pos;
+
+    // Nothing under the mouse, skip the ray query against all visuals
+    if (this->gpuPicking && !this->VisualAt(this->dataPtr->mouseHoverPos))
+    {
+      double nx = 2.0 * this->dataPtr->mouseHoverPos.X() /
+          this->dataPtr->camera->ImageWidth() - 1.0;
+      double ny = 1.0 - 2.0 * this->dataPtr->mouseHoverPos.Y() /
+          this->dataPtr->camera->ImageHeight();
+      this->dataPtr->rayQuery->SetFromCamera(
+          this->dataPtr->camera, math::Vector2d(nx, ny));
+      pos = this->dataPtr->rayQuery->Origin() +
+          this->dataPtr->rayQuery->Direction() * 10;
+    }
+    else
+    {
+      pos = this->ScreenToScene(this->dataPtr->mouseHoverPos);
+    }
 
     ignition::gui::events::HoverToScene hoverToSceneEvent(pos);
     ignition::gui::App()->sendEvent(
@@ -1016,9 +1080,8 @@ void IgnRenderer::HandleMouseContextMenu()
     if (dt.Length() > 5.0)
       return;
 
-    rendering::VisualPtr visual = this->dataPtr->camera->Scene()->VisualAt(
-          this->dataPtr->camera,
-          this->dataPtr->mouseEvent.Pos());
+    rendering::VisualPtr visual = this->VisualAt(
+        this->dataPtr->mouseEvent.Pos());
 
     if (!visual)
       return;
@@ -1452,11 +1515,7 @@ void IgnRenderer::HandleMouseTransformControl()
       // Select entity
       else if (!this->dataPtr->mouseEvent.Dragging())
       {
-        rendering::VisualPtr v = this->dataPtr->camera->VisualAt(
-              this->dataPtr->mouseEvent.Pos());
-
-        rendering::VisualPtr visual = this->dataPtr->camera->Scene()->VisualAt(
-              this->dataPtr->camera,
+        rendering::VisualPtr visual = this->VisualAt(
               this->dataPtr->mouseEvent.Pos());
 
         if (!visual)
@@ -1626,11 +1685,48 @@ void IgnRenderer::HandleMouseTransformControl()
       }
       this->dataPtr->transformControl.Scale(scale);
     }
+
+    // Scaling doesn't change the pose
+    if (this->dataPtr->transformControl.Mode() !=
+        rendering::TransformMode::TM_SCALE)
+    {
+      this->PublishPoseEdit();
+    }
     this->dataPtr->drag = 0;
     this->dataPtr->mouseDirty = false;
   }
 }
 
+/////////////////////////////////////////////////
+void IgnRenderer::PublishPoseEdit()
+{
+  auto now = std::chrono::steady_clock::now();
+  if (now - this->dataPtr->lastPoseEdit < std::chrono::milliseconds(33))
+    return;
+
+  rendering::NodePtr node = this->dataPtr->transformControl.Node();
+  if (!node)
+    return;
+
+  if (!this->dataPtr->poseEditPub)
+  {
+    auto topic = transport::TopicUtils::AsValidTopic(
+        "/world/" + this->worldName + "/pose_edit");
+    if (topic.empty())
+      return;
+    this->dataPtr->poseEditPub =
+        this->dataPtr->node.Advertise<msgs::Pose_V>(topic);
+  }
+  this->dataPtr->lastPoseEdit = now;
+
+  msgs::Pose_V msg;
+  auto pose = msg.add_pose();
+  pose->set_name(node->Name());
+  msgs::Set(pose->mutable_position(), node->WorldPosition());
+  msgs::Set(pose->mutable_orientation(), node->WorldRotation());
+  this->dataPtr->poseEditPub.Publish(msg);
+}
+
 
 /////////////////////////////////////////////////
 void IgnRenderer::HandleMouseViewControl()
@@ -1747,6 +1843,10 @@ void IgnRenderer::Initialize()
 /////////////////////////////////////////////////
 void IgnRenderer::Destroy()
 {
+  // The context is current, so pending frames can still be recorded
+  this->dataPtr->frameReader.Collect(true, this->dataPtr->encodeFrame);
+  this->dataPtr->frameReader.Release();
+
   auto engine = rendering::engine(this->dataPtr->renderUtil.EngineName());
   if (!engine)
     return;
@@ -2065,6 +2165,16 @@ void IgnRenderer::NewMouseEvent(const common::MouseEvent &_e,
   this->dataPtr->mouseDirty = true;
 }
 
+/////////////////////////////////////////////////
+rendering::VisualPtr IgnRenderer::VisualAt(const math::Vector2i &_screenPos)
+{
+  if (this->gpuPicking)
+    return this->dataPtr->camera->VisualAt(_screenPos);
+
+  return this->dataPtr->camera->Scene()->VisualAt(this->dataPtr->camera,
+      _screenPos);
+}
+
 /////////////////////////////////////////////////
 math::Vector3d IgnRenderer::ScreenToPlane(
     const math::Vector2i &_screenPos) const
@@ -2473,9 +2583,28 @@ void Scene3D::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
 
   renderWindow->forceActiveFocus();
 
+  // Keep frames short when many entities are added at once
+  std::chrono::milliseconds creationBudget{10};
+  bool asyncMeshLoading{true};
+
   // Custom parameters
   if (_pluginElem)
   {
+    if (auto elem = _pluginElem->FirstChildElement("creation_budget"))
+    {
+      int budget{0};
+      if (elem->QueryIntText(&budget) == tinyxml2::XML_SUCCESS &&
+          budget >= 0)
+      {
+        creationBudget = std::chrono::milliseconds(budget);
+      }
+      else
+      {
+        ignerr << "Invalid <creation_budget>, using ["
+               << creationBudget.count() << "] ms" << std::endl;
+      }
+    }
+
     if (auto elem = _pluginElem->FirstChildElement("engine"))
     {
       std::string engineName = elem->GetText();
@@ -2641,7 +2770,20 @@ void Scene3D::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
         visibilityMaskStr >> visibilityMask;
       renderWindow->SetVisibilityMask(visibilityMask);
     }
+
+    if (auto elem = _pluginElem->FirstChildElement("gpu_picking"))
+    {
+      auto gpuPicking = true;
+      elem->QueryBoolText(&gpuPicking);
+      renderWindow->SetGpuPicking(gpuPicking);
+    }
+
+    if (auto elem = _pluginElem->FirstChildElement("async_mesh_loading"))
+      elem->QueryBoolText(&asyncMeshLoading);
   }
+  this->dataPtr->renderUtil->SetCreationBudget(creationBudget);
+  this->dataPtr->renderUtil->SceneManager().SetAsyncMeshLoading(
+      asyncMeshLoading);
 
   // transform mode
   this->dataPtr->transformModeService =
@@ -3200,6 +3342,12 @@ void RenderWindowItem::SetVisibilityMask(uint32_t _mask)
   this->dataPtr->renderThread->ignRenderer.visibilityMask = _mask;
 }
 
+/////////////////////////////////////////////////
+void RenderWindowItem::SetGpuPicking(bool _gpuPicking)
+{
+  this->dataPtr->renderThread->ignRenderer.gpuPicking = _gpuPicking;
+}
+
 /////////////////////////////////////////////////
 void RenderWindowItem::OnHovered(const ignition::math::Vector2i &_hoverPos)
 {
@@ -76,6 +76,17 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
   ///     * \<p_gain\>    : Camera follow movement p gain.
   ///     * \<target\>    : Target to follow.
   /// * \<fullscreen\> : Optional starting the window in fullscreen.
+  /// * \<creation_budget\> : Optional time in milliseconds each frame may
+  ///                         spend creating new entities, defaults to 10.
+  ///                         The rest are created on the following frames.
+  ///                         Zero creates all of them on the next frame.
+  /// * \<gpu_picking\> : Optional, true to pick entities for selection and
+  ///                     hover by rendering their IDs to an offscreen
+  ///                     selection buffer, false to use ray queries against
+  ///                     the visuals. Defaults to true.
+  /// * \<async_mesh_loading\> : Optional, true to load meshes on worker
+  ///                            threads, showing their visuals once the
+  ///                            meshes are ready. Defaults to true.
   class Scene3D : public ignition::gazebo::GuiSystem
   {
     Q_OBJECT
@@ -373,6 +384,10 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     /// \brief Handle mouse event for transform control
     private: void HandleMouseTransformControl();
 
+    /// \brief Stream the pose of the entity being dragged to the server,
+    /// at most every 33 ms. The final pose is still set on release.
+    private: void PublishPoseEdit();
+
     /// \brief Handle entity selection requests
     private: void HandleEntitySelection();
 
@@ -388,6 +403,14 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     /// \brief Broadcasts a right click within the scene
     private: void BroadcastRightClick();
 
+    /// \brief Get the visual under a screen position. With GPU picking,
+    /// this reads the camera's selection buffer, which costs the same
+    /// however complex the scene is. Otherwise it casts a ray against the
+    /// visuals.
+    /// \param[in] _screenPos 2D coordinates on the screen, in pixels.
+    /// \return The visual, null if there's none.
+    private: rendering::VisualPtr VisualAt(const math::Vector2i &_screenPos);
+
     /// \brief Generate a unique entity id.
     /// \return The unique entity id
     private: Entity UniqueId();
@@ -461,6 +484,10 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     /// \brief Camera visibility mask
     public: uint32_t visibilityMask = 0xFFFFFFFFu;
 
+    /// \brief True to pick visuals from the camera's selection buffer,
+    /// false to use ray queries.
+    public: bool gpuPicking = true;
+
     /// \brief True if engine has been initialized;
     public: bool initialized = false;
 
@@ -540,6 +567,11 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     /// \param[in] _mask Visibility mask to set to
     public: void SetVisibilityMask(uint32_t _mask);
 
+    /// \brief Set whether to pick visuals from the camera's selection
+    /// buffer instead of with ray queries
+    /// \param[in] _gpuPicking True to use the selection buffer
+    public: void SetGpuPicking(bool _gpuPicking);
+
     /// \brief Set the transform mode
     /// \param[in] _mode New transform mode to set to
     public: void SetTransformMode(const std::string &_mode);
@@ -17,6 +17,8 @@
 
 #include "VisualizeLidar.hh"
 
+#include <algorithm>
+#include <cmath>
 #include <string>
 #include <utility>
 #include <vector>
@@ -45,6 +47,7 @@
 #include "ignition/gazebo/gui/GuiEvents.hh"
 #include "ignition/gazebo/rendering/RenderUtil.hh"
 
+#include "ignition/rendering/Camera.hh"
 #include "ignition/rendering/RenderTypes.hh"
 #include "ignition/rendering/RenderingIface.hh"
 #include "ignition/rendering/RenderEngine.hh"
@@ -85,9 +88,23 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE
     /// \brief URI sequence to the lidar link
     public: std::string lidarString{""};
 
-    /// \brief LaserScan message from sensor
+    /// \brief Latest LaserScan message from sensor. Scans received between
+    /// two frames replace each other, only the latest one is drawn.
     public: msgs::LaserScan msg;
 
+    /// \brief Ranges passed to the visual, reused across scans so large
+    /// scans don't allocate on every frame
+    public: std::vector<double> ranges;
+
+    /// \brief Camera of the scene, used to decimate distant scans
+    public: rendering::CameraPtr camera;
+
+    /// \brief Decimation stride of the points currently drawn
+    public: unsigned int stride{1};
+
+    /// \brief Whether the range limits of the visual need to be set
+    public: bool rangeDirty{false};
+
     /// \brief Pose of the lidar visual
     public: math::Pose3d lidarPose{math::Pose3d::Zero};
 
@@ -118,7 +135,7 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE
     /// \brief Reset visual flag
     public: bool resetVisual{false};
 
-    /// \brief lidar visual display dirty flag
+    /// \brief lidar visual display dirty flag, set when a new scan arrives
     public: bool visualDirty{false};
 
     /// \brief lidar sensor entity dirty flag
@@ -131,6 +148,54 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE
 using namespace ignition;
 using namespace gazebo;
 
+/// \brief Maximum number of points drawn when the camera is close to the
+/// lidar. Enough for a 128 beam, 2048 column lidar.
+static constexpr std::size_t kMaxPoints{262144};
+
+/// \brief Distance from the camera up to which the point budget is
+/// kMaxPoints. Farther, it decreases with the square of the distance, as
+/// the area the scan covers on screen does.
+static constexpr double kFullDetailDistance{5.0};
+
+/// \brief Maximum decimation stride
+static constexpr unsigned int kMaxStride{16};
+
+/////////////////////////////////////////////////
+/// \brief Number of rays kept out of a dimension of the scan
+/// \param[in] _count Number of rays
+/// \param[in] _stride Decimation stride
+/// \return Number of rays kept
+static unsigned int decimatedCount(unsigned int _count, unsigned int _stride)
+{
+  if (_count == 0)
+    return 0;
+  return (_count - 1) / _stride + 1;
+}
+
+/////////////////////////////////////////////////
+/// \brief Choose how much to decimate a scan, based on its size and on the
+/// distance to the camera
+/// \param[in] _horizontal Number of horizontal rays
+/// \param[in] _vertical Number of vertical rays
+/// \param[in] _distance Distance from the camera to the lidar
+/// \return Stride, 1 to keep all rays
+static unsigned int decimationStride(unsigned int _horizontal,
+    unsigned int _vertical, double _distance)
+{
+  double budget = static_cast<double>(kMaxPoints);
+  if (_distance > kFullDetailDistance)
+    budget *= std::pow(kFullDetailDistance / _distance, 2);
+
+  unsigned int stride{1};
+  while (stride < kMaxStride &&
+      static_cast<double>(decimatedCount(_horizontal, stride)) *
+      decimatedCount(_vertical, stride) > budget)
+  {
+    stride *= 2;
+  }
+  return stride;
+}
+
 /////////////////////////////////////////////////
 VisualizeLidar::VisualizeLidar()
   : GuiSystem(), dataPtr(new VisualizeLidarPrivate)
@@ -205,9 +270,79 @@ void VisualizeLidar::LoadLidar()
     this->dataPtr->scene = scene;
     root->AddChild(this->dataPtr->lidar);
     this->dataPtr->initialized = true;
+
+    // The user camera, for decimation
+    for (unsigned int i = 0; i < scene->SensorCount(); ++i)
+    {
+      auto cam = std::dynamic_pointer_cast<rendering::Camera>(
+          scene->SensorByIndex(i));
+      if (cam)
+      {
+        this->dataPtr->camera = cam;
+        break;
+      }
+    }
   }
 }
 
+/////////////////////////////////////////////////
+void VisualizeLidar::UpdatePoints()
+{
+  IGN_PROFILE("VisualizeLidar::UpdatePoints");
+
+  const auto &msg = this->dataPtr->msg;
+  const unsigned int hCount = msg.count();
+  const unsigned int vCount = std::max(1u, msg.vertical_count());
+  if (static_cast<std::size_t>(msg.ranges_size()) <
+      static_cast<std::size_t>(hCount) * vCount)
+  {
+    ignerr << "LaserScan has [" << msg.ranges_size() << "] ranges, expected ["
+           << hCount * vCount << "]" << std::endl;
+    return;
+  }
+
+  double distance{0.0};
+  if (this->dataPtr->camera)
+  {
+    distance = this->dataPtr->camera->WorldPosition().Distance(
+        this->dataPtr->lidarPose.Pos());
+  }
+  const unsigned int stride = decimationStride(hCount, vCount, distance);
+  this->dataPtr->stride = stride;
+
+  // Keep the first ray of each dimension and every stride-th one after it,
+  // so the kept rays are still evenly spread
+  const unsigned int hKept = decimatedCount(hCount, stride);
+  const unsigned int vKept = decimatedCount(vCount, stride);
+  const double hStep = hCount > 1 ?
+      (msg.angle_max() - msg.angle_min()) / (hCount - 1) : 0.0;
+  const double vStep = vCount > 1 ?
+      (msg.vertical_angle_max() - msg.vertical_angle_min()) / (vCount - 1) :
+      0.0;
+
+  auto &ranges = this->dataPtr->ranges;
+  ranges.clear();
+  ranges.reserve(static_cast<std::size_t>(hKept) * vKept);
+  for (unsigned int v = 0; v < vCount; v += stride)
+  {
+    const auto *row = msg.ranges().data() + static_cast<std::size_t>(v) *
+        hCount;
+    for (unsigned int h = 0; h < hCount; h += stride)
+      ranges.push_back(row[h]);
+  }
+
+  auto &lidar = this->dataPtr->lidar;
+  lidar->SetVerticalRayCount(vKept);
+  lidar->SetHorizontalRayCount(hKept);
+  lidar->SetMinHorizontalAngle(msg.angle_min());
+  lidar->SetMaxHorizontalAngle(msg.angle_min() +
+      hStep * (hKept - 1) * stride);
+  lidar->SetMinVerticalAngle(msg.vertical_angle_min());
+  lidar->SetMaxVerticalAngle(msg.vertical_angle_min() +
+      vStep * (vKept - 1) * stride);
+  lidar->SetPoints(ranges);
+}
+
 /////////////////////////////////////////////////
 void VisualizeLidar::LoadConfig(const tinyxml2::XMLElement *)
 {
@@ -239,8 +374,29 @@ bool VisualizeLidar::eventFilter(QObject *_obj, QEvent *_event)
         this->dataPtr->lidar->ClearPoints();
         this->dataPtr->resetVisual = false;
       }
-      if (this->dataPtr->visualDirty)
+      if (this->dataPtr->rangeDirty)
+      {
+        this->dataPtr->lidar->SetMaxRange(this->dataPtr->maxVisualRange);
+        this->dataPtr->lidar->SetMinRange(this->dataPtr->minVisualRange);
+        this->dataPtr->rangeDirty = false;
+      }
+
+      // Rebuild the visual for new scans, and when the camera moved enough
+      // to change the decimation
+      bool rebuild = this->dataPtr->visualDirty;
+      if (!rebuild && this->dataPtr->camera &&
+          this->dataPtr->msg.ranges_size() > 0)
       {
+        auto distance = this->dataPtr->camera->WorldPosition().Distance(
+            this->dataPtr->lidarPose.Pos());
+        rebuild = decimationStride(this->dataPtr->msg.count(),
+            std::max(1u, this->dataPtr->msg.vertical_count()), distance) !=
+            this->dataPtr->stride;
+      }
+
+      if (rebuild)
+      {
+        this->UpdatePoints();
         this->dataPtr->lidar->SetWorldPose(this->dataPtr->lidarPose);
         this->dataPtr->lidar->Update();
         this->dataPtr->visualDirty = false;
@@ -456,27 +612,11 @@ void VisualizeLidar::SetTopicList(const QStringList &_topicList)
 //////////////////////////////////////////////////
 void VisualizeLidar::OnScan(const msgs::LaserScan &_msg)
 {
-  std::lock_guard<std::mutex>(this->dataPtr->serviceMutex);
+  // Only keep the scan here, the visual is rebuilt on the render thread
+  std::lock_guard<std::mutex> lock(this->dataPtr->serviceMutex);
   if (this->dataPtr->initialized)
   {
-    this->dataPtr->msg = std::move(_msg);
-    this->dataPtr->lidar->SetVerticalRayCount(
-                                  this->dataPtr->msg.vertical_count());
-    this->dataPtr->lidar->SetHorizontalRayCount(
-                                  this->dataPtr->msg.count());
-    this->dataPtr->lidar->SetMinHorizontalAngle(
-                                  this->dataPtr->msg.angle_min());
-    this->dataPtr->lidar->SetMaxHorizontalAngle(
-                                  this->dataPtr->msg.angle_max());
-    this->dataPtr->lidar->SetMinVerticalAngle(
-                                  this->dataPtr->msg.vertical_angle_min());
-    this->dataPtr->lidar->SetMaxVerticalAngle(
-                                  this->dataPtr->msg.vertical_angle_max());
-
-    this->dataPtr->lidar->SetPoints(std::vector<double>(
-                                  this->dataPtr->msg.ranges().begin(),
-                                  this->dataPtr->msg.ranges().end()));
-
+    this->dataPtr->msg = _msg;
     this->dataPtr->visualDirty = true;
 
     for (auto data_values : this->dataPtr->msg.header().data())
@@ -490,8 +630,7 @@ void VisualizeLidar::OnScan(const msgs::LaserScan &_msg)
           this->dataPtr->lidarEntityDirty = true;
           this->dataPtr->maxVisualRange = this->dataPtr->msg.range_max();
           this->dataPtr->minVisualRange = this->dataPtr->msg.range_min();
-          this->dataPtr->lidar->SetMaxRange(this->dataPtr->maxVisualRange);
-          this->dataPtr->lidar->SetMinRange(this->dataPtr->minVisualRange);
+          this->dataPtr->rangeDirty = true;
           this->MinRangeChanged();
           this->MaxRangeChanged();
           break;
@@ -131,6 +131,10 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE
     /// \return Range, the minimum distance sensed by the sensor.
     public: Q_INVOKABLE QString MinRange() const;
 
+    /// \brief Pass the latest scan to the visual, decimated based on the
+    /// distance to the camera. Must be called from the render thread.
+    private: void UpdatePoints();
+
     /// \internal
     /// \brief Pointer to private data
     private: std::unique_ptr<VisualizeLidarPrivate> dataPtr;
@@ -271,8 +271,14 @@ Rectangle {
 
   Connections {
     target: GuiFileHandler
+    onNewSaveWorldProgress: {
+      saveProgressBar.value = _progress;
+      if (!saveProgress.opened)
+        saveProgress.open();
+    }
     onNewSaveWorldStatus: {
       console.log(_msg);
+      saveProgress.close();
       lastSaveSuccess = _status
       if (!_status) {
         fileSaveFailure.text =  _msg;
@@ -281,6 +287,28 @@ Rectangle {
     }
   }
 
+  /**
+   * Progress of a world being saved in the background
+   */
+  Popup {
+    id: saveProgress
+    parent: ApplicationWindow.overlay
+    x: (parent.width - width) / 2
+    y: parent.height - height - 20
+    closePolicy: Popup.NoAutoClose
+
+    ColumnLayout {
+      Label {
+        text: "Saving world..."
+      }
+      ProgressBar {
+        id: saveProgressBar
+        from: 0
+        to: 1
+      }
+    }
+  }
+
   /**
    * Message dialogs for failure messages emitted by GuiFileHandler
    */
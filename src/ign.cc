@@ -17,16 +17,26 @@
 
 #include "ign.hh"
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include <ignition/msgs/param_v.pb.h>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
 #include <ignition/fuel_tools/FuelClient.hh>
 #include <ignition/fuel_tools/ClientConfig.hh>
 #include <ignition/fuel_tools/Result.hh>
 #include <ignition/fuel_tools/WorldIdentifier.hh>
+#include <ignition/transport/Node.hh>
 
 #include "ignition/gazebo/config.hh"
 #include "ignition/gazebo/Server.hh"
@@ -34,6 +44,8 @@
 
 #include "ignition/gazebo/gui/Gui.hh"
 
+#include "LogExport.hh"
+
 //////////////////////////////////////////////////
 extern "C" IGNITION_GAZEBO_VISIBLE char *ignitionGazeboVersion()
 {
@@ -323,9 +335,15 @@ extern "C" IGNITION_GAZEBO_VISIBLE int runServer(const char *_sdfString,
     }
     else
     {
-      ignmsg << "Playing back states" << _playback << std::endl;
-      serverConfig.SetLogPlaybackPath(ignition::common::absPath(
-        std::string(_playback)));
+      // Batches of logs are separated by newlines, and played one after
+      // another
+      std::vector<std::string> logs = ignition::common::split(
+          _playback, "\n");
+      for (const std::string &log : logs)
+      {
+        ignmsg << "Playing back states" << log << std::endl;
+        serverConfig.AddLogPlaybackPath(ignition::common::absPath(log));
+      }
     }
   }
 
@@ -354,6 +372,84 @@ extern "C" IGNITION_GAZEBO_VISIBLE int runServer(const char *_sdfString,
   return 0;
 }
 
+//////////////////////////////////////////////////
+extern "C" IGNITION_GAZEBO_VISIBLE int printSystemStats(
+    const char *_worldName)
+{
+  std::string topic = ignition::transport::TopicUtils::AsValidTopic(
+      "/world/" + std::string(_worldName) + "/stats/systems");
+  if (topic.empty())
+  {
+    ignerr << "Invalid world name [" << _worldName << "]" << std::endl;
+    return 1;
+  }
+
+  std::mutex mutex;
+  std::condition_variable received;
+  std::optional<ignition::msgs::Param_V> stats;
+
+  ignition::transport::Node node;
+  std::function<void(const ignition::msgs::Param_V &)> cb =
+      [&](const ignition::msgs::Param_V &_msg)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats = _msg;
+        received.notify_all();
+      };
+  node.Subscribe(topic, cb);
+
+  // Statistics are published once per second
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!received.wait_for(lock, std::chrono::seconds(5),
+        [&stats] { return stats.has_value(); }))
+    {
+      std::cerr << "No system statistics received on [" << topic
+                << "]. Is the world running?" << std::endl;
+      return 1;
+    }
+  }
+
+  auto get = [](const ignition::msgs::Param &_param, const std::string &_key)
+      -> const ignition::msgs::Any *
+  {
+    auto it = _param.params().find(_key);
+    return it == _param.params().end() ? nullptr : &it->second;
+  };
+
+  std::printf("%-40s %-11s %7s %9s %9s %9s %9s\n", "System", "Phase",
+      "Count", "Mean(ms)", "p50(ms)", "p99(ms)", "Max(ms)");
+  for (const auto &param : stats->param())
+  {
+    auto name = get(param, "name");
+    for (const std::string phase :
+        {"levels", "pre_update", "update", "post_update"})
+    {
+      auto count = get(param, phase + "_count");
+      if (nullptr == count)
+        continue;
+
+      auto ms = [&](const std::string &_stat)
+      {
+        auto value = get(param, phase + "_" + _stat + "_ms");
+        return nullptr == value ? 0.0 : value->double_value();
+      };
+
+      std::printf("%-40s %-11s %7d %9.3f %9.3f %9.3f %9.3f\n",
+          nullptr == name ? "" : name->string_value().c_str(), phase.c_str(),
+          count->int_value(), ms("mean"), ms("p50"), ms("p99"), ms("max"));
+    }
+  }
+  return 0;
+}
+
+//////////////////////////////////////////////////
+extern "C" IGNITION_GAZEBO_VISIBLE int exportLog(const char *_logPath,
+    const char *_outputDir)
+{
+  return ignition::gazebo::ExportLog(_logPath, _outputDir) ? 0 : 1;
+}
+
 //////////////////////////////////////////////////
 extern "C" IGNITION_GAZEBO_VISIBLE int runGui(const char *_guiConfig)
 {
@@ -47,7 +47,8 @@ extern "C" IGNITION_GAZEBO_VISIBLE const char *worldInstallDir();
 /// \param[in] _recordResources --record-resources option
 /// \param[in] _logOverwrite --log-overwrite option
 /// \param[in] _logCompress --log-compress option
-/// \param[in] _playback --playback option
+/// \param[in] _playback --playback option, or newline separated paths of
+/// the logs listed by --playback-batch
 /// \param[in] _physicsEngine --physics-engine option
 /// \param[in] _renderEngineServer --render-engine-server option
 /// \param[in] _renderEngineGui --render-engine-gui option
@@ -64,6 +65,22 @@ extern "C" IGNITION_GAZEBO_VISIBLE int runServer(const char *_sdfString,
     const char *_renderEngineGui, const char *_file,
     const char *_recordTopics);
 
+/// \brief External hook to print the timing statistics of the systems of a
+/// running world, as published on /world/<name>/stats/systems.
+/// \param[in] _worldName Name of the world.
+/// \return 0 if successful, 1 if no statistics were received.
+extern "C" IGNITION_GAZEBO_VISIBLE int printSystemStats(
+    const char *_worldName);
+
+/// \brief External hook to export a recorded log as CSV tables, one per
+/// component type.
+/// \param[in] _logPath --export-log option, path to the recorded log.
+/// \param[in] _outputDir --export-dir option, directory to write the tables
+/// to.
+/// \return 0 if successful, 1 if not.
+extern "C" IGNITION_GAZEBO_VISIBLE int exportLog(const char *_logPath,
+    const char *_outputDir);
+
 /// \brief External hook to run simulation GUI.
 /// \param[in] _guiConfig Path to Ignition GUI configuration file.
 /// \return 0 if successful, 1 if not.
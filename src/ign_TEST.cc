@@ -19,7 +19,9 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <fstream>
 #include <string>
+#include <ignition/common/Filesystem.hh>
 #include <ignition/utilities/ExtraTestMacros.hh>
 
 #include "ignition/gazebo/test_config.hh"  // NOLINT(build/include)
@@ -159,3 +161,39 @@ TEST(CmdLine, ResourcePath)
   EXPECT_EQ(output.find("Unable to find file plugins.sdf"), std::string::npos)
       << output;
 }
+
+/////////////////////////////////////////////////
+TEST(CmdLine, ExportLog)
+{
+  auto logPath = ignition::common::joinPaths(kBinPath, "test_export_log");
+  ignition::common::removeAll(logPath);
+
+  std::string cmd = kIgnCommand + " -r -v 4 --iterations 50 --record " +
+    "--record-path " + logPath + " " + std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/shapes.sdf";
+  std::cout << "Running command [" << cmd << "]" << std::endl;
+  customExecStr(cmd);
+  ASSERT_TRUE(ignition::common::isFile(
+      ignition::common::joinPaths(logPath, "state.tlog")));
+
+  cmd = std::string(BREW_RUBY) + std::string(IGN_PATH) +
+    "/ign gazebo -v 4 --export-log " + logPath;
+  std::cout << "Running command [" << cmd << "]" << std::endl;
+  std::string output = customExecStr(cmd);
+  EXPECT_NE(output.find("Exported"), std::string::npos) << output;
+
+  // Names of the entities created at the start
+  auto namesPath = ignition::common::joinPaths(logPath, "export",
+      "ign_gazebo_components.Name.csv");
+  std::ifstream names(namesPath);
+  ASSERT_TRUE(names.is_open()) << namesPath;
+  std::string line;
+  ASSERT_TRUE(std::getline(names, line));
+  EXPECT_EQ("sim_time,entity,removed,name", line);
+  bool foundBox{false};
+  while (std::getline(names, line))
+    foundBox = foundBox || line.find(",0,box") != std::string::npos;
+  EXPECT_TRUE(foundBox);
+
+  ignition::common::removeAll(logPath);
+}
@@ -43,15 +43,28 @@ namespace ignition
       /// \param[in] _role One of [primary, secondary].
       /// \param[in] _secondaries Number of secondaries the primary should
       /// expect. This is only meaningful if _role == primary.
+      /// \param[in] _maxStepLag Number of steps the secondaries may lag
+      /// behind. This is only meaningful if _role == primary.
       /// \return A NetworkConfig object based on the provided values.
       public: static NetworkConfig FromValues(const std::string &_role,
-                                              unsigned int _secondaries = 0);
+                                              unsigned int _secondaries = 0,
+                                              unsigned int _maxStepLag = 0);
 
       /// \brief Role of this network participant
       public: NetworkRole role { NetworkRole::None };
 
       /// \brief Expect number of network secondaries.
       public: size_t numSecondariesExpected { 0 };
+
+      /// \brief Number of steps sent to secondaries which they may not have
+      /// finished yet when the primary steps again. Zero waits for all
+      /// secondaries on every step.
+      public: unsigned int maxStepLag { 0 };
+
+      /// \brief Exchange steps and states through shared memory with peers
+      /// running on the same host, instead of ign-transport. Both the
+      /// primary and the secondary must allow it.
+      public: bool useSharedMemory { true };
     };
     }
   }  // namespace gazebo
@@ -40,6 +40,14 @@ TEST(NetworkManager, ValueConstructor)
     auto config = NetworkConfig::FromValues("PRIMARY", 3);
     assert(config.role == NetworkRole::SimulationPrimary);
     assert(config.numSecondariesExpected == 3);
+    assert(config.maxStepLag == 0);
+  }
+
+  {
+    // Primary which lets secondaries lag behind
+    auto config = NetworkConfig::FromValues("PRIMARY", 3, 2);
+    assert(config.role == NetworkRole::SimulationPrimary);
+    assert(config.maxStepLag == 2);
   }
 
   {
@@ -175,3 +175,11 @@ NetworkConfig NetworkManager::Config() const
 {
   return this->dataPtr->config;
 }
+
+//////////////////////////////////////////////////
+std::vector<PeerInfo> NetworkManager::Peers() const
+{
+  if (!this->dataPtr->tracker)
+    return {};
+  return this->dataPtr->tracker->Peers();
+}
@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <ignition/transport/NodeOptions.hh>
 #include <ignition/gazebo/config.hh>
@@ -28,6 +29,7 @@
 #include <ignition/gazebo/EventManager.hh>
 
 #include "NetworkConfig.hh"
+#include "PeerInfo.hh"
 
 namespace ignition
 {
@@ -118,6 +120,11 @@ namespace ignition
       /// \return The manager's config.
       public: NetworkConfig Config() const;
 
+      /// \brief Get the latest information about this peer and all peers it
+      /// has discovered, including their step telemetry.
+      /// \return This peer, followed by the discovered peers.
+      public: std::vector<PeerInfo> Peers() const;
+
       /// \brief Private data
       protected: std::unique_ptr<NetworkManagerPrivate> dataPtr;
     };
@@ -18,7 +18,6 @@
 #include "NetworkManagerPrimary.hh"
 
 #include <algorithm>
-#include <future>
 #include <set>
 #include <string>
 #include <utility>
@@ -30,6 +29,8 @@
 #include "msgs/peer_control.pb.h"
 #include "msgs/simulation_step.pb.h"
 
+#include "ignition/gazebo/components/LevelEntityNames.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
 #include "ignition/gazebo/components/PerformerAffinity.hh"
 #include "ignition/gazebo/components/PerformerLevels.hh"
 #include "ignition/gazebo/Conversions.hh"
@@ -44,6 +45,24 @@ using namespace ignition;
 using namespace gazebo;
 using namespace std::chrono_literals;
 
+namespace
+{
+/// \brief Weight of the latest step time in the moving average of each
+/// secondary's step time.
+constexpr double kStepTimeSmoothing{0.05};
+
+/// \brief A performer is migrated only if the slowest secondary takes this
+/// much longer per step than the fastest one.
+constexpr double kImbalanceRatio{1.25};
+
+/// \brief Minimum number of iterations between migrations.
+constexpr uint64_t kMigrationCooldown{500};
+
+/// \brief Size of each shared memory channel with a secondary on the same
+/// host. Pages are only committed as the ring wraps into them.
+constexpr std::size_t kSharedMemoryCapacity{32 * 1024 * 1024};
+}
+
 //////////////////////////////////////////////////
 NetworkManagerPrimary::NetworkManagerPrimary(
     const std::function<void(const UpdateInfo &_info)> &_stepFunction,
@@ -57,9 +76,34 @@ NetworkManagerPrimary::NetworkManagerPrimary(
   this->node.Subscribe("step_ack", &NetworkManagerPrimary::OnStepAck, this);
 }
 
+//////////////////////////////////////////////////
+NetworkManagerPrimary::~NetworkManagerPrimary()
+{
+  this->stopAckThreads = true;
+  for (auto &secondary : this->secondaries)
+  {
+    if (secondary.second->ackThread.joinable())
+      secondary.second->ackThread.join();
+  }
+}
+
 //////////////////////////////////////////////////
 void NetworkManagerPrimary::Handshake()
 {
+  // Secondaries on this host can skip ign-transport's sockets
+  std::set<std::string> localPeers;
+  if (this->dataPtr->config.useSharedMemory)
+  {
+    for (const auto &info : this->dataPtr->tracker->Peers())
+    {
+      if (info.role == NetworkRole::SimulationSecondary &&
+          info.hostname == this->dataPtr->peerInfo.hostname)
+      {
+        localPeers.insert(info.id);
+      }
+    }
+  }
+
   auto peers = this->dataPtr->tracker->SecondaryPeers();
   for (const auto &peer : peers)
   {
@@ -70,6 +114,18 @@ void NetworkManagerPrimary::Handshake()
     sc->id = peer;
     sc->prefix = peer.substr(0, 8);
 
+    if (localPeers.find(peer) != localPeers.end())
+    {
+      const std::string shmName = "/ign_gazebo_" +
+          this->dataPtr->peerInfo.id.substr(0, 8) + "_" + sc->prefix;
+      sc->stepChannel = SharedMemoryChannel::Create(shmName + "_step",
+          kSharedMemoryCapacity);
+      sc->ackChannel = SharedMemoryChannel::Create(shmName + "_ack",
+          kSharedMemoryCapacity);
+      if (sc->stepChannel && sc->ackChannel)
+        req.set_shm_name(shmName);
+    }
+
     bool result;
     std::string topic {sc->prefix + "/control"};
     unsigned int timeout = 5000;
@@ -96,6 +152,19 @@ void NetworkManagerPrimary::Handshake()
              << timeout << " ms" << std::endl;
     }
 
+    if (sc->ready && resp.shm_enabled())
+    {
+      igndbg << "Using shared memory [" << req.shm_name()
+             << "] with secondary [" << sc->prefix << "]" << std::endl;
+      sc->ackThread = std::thread(&NetworkManagerPrimary::ReadAcks, this,
+          sc->ackChannel.get());
+    }
+    else
+    {
+      sc->stepChannel.reset();
+      sc->ackChannel.reset();
+    }
+
     this->secondaries[sc->prefix] = std::move(sc);
   }
 }
@@ -113,6 +182,7 @@ bool NetworkManagerPrimary::Ready() const
 bool NetworkManagerPrimary::Step(const UpdateInfo &_info)
 {
   IGN_PROFILE("NetworkManagerPrimary::Step");
+  const auto stepStart = std::chrono::steady_clock::now();
 
   // Check all secondaries have been registered
   bool ready = true;
@@ -142,43 +212,104 @@ bool NetworkManagerPrimary::Step(const UpdateInfo &_info)
     return false;
   }
 
-  // Send step to all secondaries
-  this->secondaryStates.clear();
-  this->secondaryStatesPromise = std::promise<void>{};
-  auto future = this->secondaryStatesPromise.get_future();
-  this->simStepPub.Publish(step);
+  // Send step to all secondaries, serialized once for all the ones on this
+  // host
+  std::string stepData;
+  bool remoteSecondaries{false};
+  for (const auto &secondary : this->secondaries)
+  {
+    auto &channel = secondary.second->stepChannel;
+    if (!channel)
+    {
+      remoteSecondaries = true;
+      continue;
+    }
+
+    if (stepData.empty() && !step.SerializeToString(&stepData))
+    {
+      ignerr << "Failed to serialize step." << std::endl;
+      return false;
+    }
 
-  // Block until all secondaries are done
+    if (!channel->Write(stepData, 10s))
+    {
+      ignerr << "Failed to send step to secondary [" << secondary.first
+             << "] through shared memory [" << channel->Name()
+             << "]. Stopping simulation." << std::endl;
+      if (this->dataPtr->eventMgr)
+        this->dataPtr->eventMgr->Emit<events::Stop>();
+      return false;
+    }
+  }
+  if (remoteSecondaries)
+    this->simStepPub.Publish(step);
+  ++this->stepsSent;
+
+  // Step the primary's own systems while the secondaries step. They see the
+  // states received up to the previous step, which are applied below for
+  // the next step.
+  this->dataPtr->stepFunction(_info);
+
+  this->dataPtr->ecm->SetAllComponentsUnchanged();
+
+  // Block until the secondaries are at most maxStepLag steps behind. Without
+  // lag, this waits for all of them to finish the step just sent.
+  std::vector<msgs::SerializedStateMap> states;
   {
     IGN_PROFILE("Waiting for secondaries");
 
-    auto result = future.wait_for(10s);
+    std::unique_lock<std::mutex> lock(this->secondaryStatesMutex);
+    const uint64_t maxLag = this->dataPtr->config.maxStepLag;
+    auto caughtUp = this->secondaryStatesCv.wait_for(lock, 10s, [&]
+        {
+          return this->stepsSent - this->stepsDone <= maxLag;
+        });
 
-    if (std::future_status::ready != result)
+    if (!caughtUp)
     {
-      ignerr << "Waited 10 s and got only [" << this->secondaryStates.size()
+      const auto pending = this->stepAcks.begin();
+      ignerr << "Waited 10 s and got only ["
+             << (pending == this->stepAcks.end() ? 0u : pending->second)
              << " / " << this->secondaries.size()
              << "] responses from secondaries. Stopping simulation."
              << std::endl;
       this->dataPtr->eventMgr->Emit<events::Stop>();
       return false;
     }
+
+    states.swap(this->secondaryStates);
+
+    for (const auto &secondary : this->secondaries)
+    {
+      this->dataPtr->tracker->SetQueueDepth(secondary.second->id,
+          this->stepsSent - this->secondaryAcks[secondary.second->prefix]);
+    }
   }
 
   // Update primary state with states received from secondaries
+  uint64_t stateSize{0};
   {
     IGN_PROFILE("Updating primary state");
-    for (const auto &msg : this->secondaryStates)
+    // Secondaries only send what changed, which is applied as a single batch
+    // so views are updated once for all of them
+    this->dataPtr->ecm->BeginBatch();
+    for (const auto &msg : states)
     {
       this->dataPtr->ecm->SetState(msg);
+      stateSize += msg.ByteSizeLong();
     }
-    this->secondaryStates.clear();
+    this->dataPtr->ecm->CommitBatch();
   }
 
-  // Step all systems
-  this->dataPtr->stepFunction(_info);
-
-  this->dataPtr->ecm->SetAllComponentsUnchanged();
+  uint64_t queueDepth;
+  {
+    std::lock_guard<std::mutex> lock(this->secondaryStatesMutex);
+    queueDepth = this->stepsSent - this->stepsDone;
+  }
+  const std::chrono::duration<double> stepTime =
+      std::chrono::steady_clock::now() - stepStart;
+  this->dataPtr->tracker->SetTelemetry(stepTime.count(), stateSize,
+      queueDepth);
 
   return true;
 }
@@ -199,10 +330,73 @@ std::map<std::string, SecondaryControl::Ptr>
 //////////////////////////////////////////////////
 void NetworkManagerPrimary::OnStepAck(const msgs::SerializedStateMap &_msg)
 {
-  this->secondaryStates.push_back(_msg);
-  if (this->secondaryStates.size() == this->secondaries.size())
+  uint64_t iteration{0};
+  std::string secondary;
+  double stepTime{-1.0};
+  for (int i = 0; i < _msg.header().data_size(); ++i)
   {
-    this->secondaryStatesPromise.set_value();
+    const auto &data = _msg.header().data(i);
+    if (data.value_size() == 0)
+      continue;
+
+    if (data.key() == "iteration")
+      iteration = std::stoull(data.value(0));
+    else if (data.key() == "secondary")
+      secondary = data.value(0);
+    else if (data.key() == "step_time")
+      stepTime = std::stod(data.value(0));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->secondaryStatesMutex);
+    this->secondaryStates.push_back(_msg);
+
+    if (!secondary.empty())
+      ++this->secondaryAcks[secondary];
+
+    if (!secondary.empty() && stepTime >= 0.0)
+    {
+      auto timeIt = this->secondaryStepTimes.find(secondary);
+      if (timeIt == this->secondaryStepTimes.end())
+        this->secondaryStepTimes[secondary] = stepTime;
+      else
+        timeIt->second += kStepTimeSmoothing * (stepTime - timeIt->second);
+    }
+
+    // Steps are finished in order, so count the oldest ones which all
+    // secondaries have acknowledged
+    ++this->stepAcks[iteration];
+    while (!this->stepAcks.empty() &&
+        this->stepAcks.begin()->second >= this->secondaries.size())
+    {
+      this->stepAcks.erase(this->stepAcks.begin());
+      ++this->stepsDone;
+    }
+  }
+  this->secondaryStatesCv.notify_all();
+}
+
+//////////////////////////////////////////////////
+void NetworkManagerPrimary::ReadAcks(SharedMemoryChannel *_channel)
+{
+  std::string data;
+  msgs::SerializedStateMap msg;
+  while (!this->stopAckThreads)
+  {
+    if (!_channel->Read(data, 100ms))
+    {
+      if (_channel->Closed())
+        break;
+      continue;
+    }
+
+    if (!msg.ParseFromString(data))
+    {
+      ignerr << "Failed to parse step ack from shared memory ["
+             << _channel->Name() << "]" << std::endl;
+      continue;
+    }
+    this->OnStepAck(msg);
   }
 }
 
@@ -235,6 +429,13 @@ void NetworkManagerPrimary::PopulateAffinities(
   // All performers
   std::set<Entity> allPerformers;
 
+  // Estimated cost of simulating each performer: itself, plus the entities
+  // of the levels it's in
+  std::map<Entity, double> pCost;
+
+  // Number of entities in each level
+  std::map<Entity, double> lCost;
+
   // Go through performers and assign affinities
   this->dataPtr->ecm->Each<
         components::PerformerLevels>(
@@ -252,65 +453,174 @@ void NetworkManagerPrimary::PopulateAffinities(
       }
 
       // New levels
+      double cost{1.0};
       for (const auto &level : _perfLevels->Data())
       {
         lToPNew[level].insert(_entity);
+
+        auto costIt = lCost.find(level);
+        if (costIt == lCost.end())
+        {
+          auto names = this->dataPtr->ecm->Component<
+              components::LevelEntityNames>(level);
+          costIt = lCost.emplace(level,
+              nullptr == names ? 0.0 : names->Data().size()).first;
+        }
+        cost += costIt->second;
       }
+      pCost[_entity] = cost;
 
       return true;
     });
 
-  // First assignment: distribute levels evenly across secondaries
+  // First assignment: keep the performers of each level together, and give
+  // each group to the secondary with the least load so far, largest groups
+  // first
   if (pToSPrevious.empty())
   {
-    auto secondaryIt = this->secondaries.begin();
-
+    std::vector<std::pair<double, std::vector<Entity>>> groups;
     for (const auto &[level, performers] : lToPNew)
     {
+      std::vector<Entity> group;
+      double cost{0.0};
       for (const auto &performer : performers)
       {
-        this->SetAffinity(performer, secondaryIt->second->prefix,
-            _msg.add_affinity());
-
-        // Remove performers as they are assigned
-        allPerformers.erase(performer);
-      }
-
-      // Round-robin levels
-      secondaryIt++;
-      if (secondaryIt == this->secondaries.end())
-      {
-        secondaryIt = this->secondaries.begin();
+        // Performers in several levels go with the first one
+        if (allPerformers.erase(performer) == 0)
+          continue;
+        group.push_back(performer);
+        cost += pCost[performer];
       }
+      if (!group.empty())
+        groups.emplace_back(cost, std::move(group));
     }
 
     // Also assign level-less performers
     for (auto performer : allPerformers)
-    {
-      this->SetAffinity(performer, secondaryIt->second->prefix,
-          _msg.add_affinity());
+      groups.push_back({pCost[performer], {performer}});
+
+    std::stable_sort(groups.begin(), groups.end(),
+        [](const auto &_a, const auto &_b)
+        {
+          return _a.first > _b.first;
+        });
+
+    std::map<std::string, double> sLoad;
+    for (const auto &secondary : this->secondaries)
+      sLoad[secondary.second->prefix] = 0.0;
 
-      // Round-robin performers
-      secondaryIt++;
-      if (secondaryIt == this->secondaries.end())
+    for (const auto &[cost, group] : groups)
+    {
+      auto leastLoaded = std::min_element(sLoad.begin(), sLoad.end(),
+          [](const auto &_a, const auto &_b)
+          {
+            return _a.second < _b.second;
+          });
+      for (const auto &performer : group)
       {
-        secondaryIt = this->secondaries.begin();
+        this->SetAffinity(performer, leastLoaded->first,
+            _msg.add_affinity());
       }
+      leastLoaded->second += cost;
     }
     return;
   }
 
-  // TODO(louise) Process level changes
+  this->Rebalance(pToSPrevious, pCost, _msg.stats().iterations(), _msg);
+}
+
+//////////////////////////////////////////////////
+void NetworkManagerPrimary::Rebalance(
+    const std::map<Entity, std::string> &_affinities,
+    const std::map<Entity, double> &_costs, uint64_t _iteration,
+    private_msgs::SimulationStep &_msg)
+{
+  if (_iteration < this->nextRebalanceIteration)
+    return;
+
+  std::map<std::string, double> stepTimes;
+  {
+    std::lock_guard<std::mutex> lock(this->secondaryStatesMutex);
+    stepTimes = this->secondaryStepTimes;
+  }
+  if (stepTimes.size() < 2 || stepTimes.size() < this->secondaries.size())
+    return;
+
+  auto byTime = [](const auto &_a, const auto &_b)
+  {
+    return _a.second < _b.second;
+  };
+  const auto fastest =
+      *std::min_element(stepTimes.begin(), stepTimes.end(), byTime);
+  const auto slowest =
+      *std::max_element(stepTimes.begin(), stepTimes.end(), byTime);
+
+  // Hysteresis: small differences aren't worth a migration
+  if (slowest.second <= fastest.second * kImbalanceRatio)
+    return;
+
+  // Time the slowest secondary spends on each unit of cost
+  double slowCost{0.0};
+  for (const auto &[performer, secondary] : _affinities)
+  {
+    if (secondary == slowest.first)
+      slowCost += _costs.at(performer);
+  }
+  if (slowCost <= 0.0)
+    return;
+  const double timePerCost = slowest.second / slowCost;
+
+  // Pick the performer which leaves the two secondaries closest to each
+  // other, if any makes the slowest step faster
+  Entity best{kNullEntity};
+  double bestStepTime{slowest.second};
+  for (const auto &[performer, secondary] : _affinities)
+  {
+    if (secondary != slowest.first)
+      continue;
+
+    const double moved = _costs.at(performer) * timePerCost;
+    const double stepTime = std::max(slowest.second - moved,
+        fastest.second + moved);
+    if (stepTime < bestStepTime)
+    {
+      best = performer;
+      bestStepTime = stepTime;
+    }
+  }
+  if (kNullEntity == best)
+    return;
+
+  ignmsg << "Migrating performer [" << best << "] from secondary ["
+         << slowest.first << "] (" << slowest.second * 1e3
+         << " ms per step) to secondary [" << fastest.first << "] ("
+         << fastest.second * 1e3 << " ms per step)." << std::endl;
+
+  this->SetAffinity(best, fastest.first, _msg.add_affinity(), true);
+  this->nextRebalanceIteration = _iteration + kMigrationCooldown;
 }
 
 //////////////////////////////////////////////////
 void NetworkManagerPrimary::SetAffinity(Entity _performer,
-    const std::string &_secondary, private_msgs::PerformerAffinity *_msg)
+    const std::string &_secondary, private_msgs::PerformerAffinity *_msg,
+    bool _migrate)
 {
   // Populate message
   _msg->mutable_entity()->set_id(_performer);
   _msg->set_secondary_prefix(_secondary);
 
+  // The new secondary may have removed the performer's model already
+  if (_migrate)
+  {
+    auto parent =
+        this->dataPtr->ecm->Component<components::ParentEntity>(_performer);
+    if (parent)
+    {
+      this->dataPtr->ecm->State(*_msg->mutable_state(),
+          this->dataPtr->ecm->Descendants(parent->Data()), {}, true);
+    }
+  }
+
   // Set component
   this->dataPtr->ecm->RemoveComponent<components::PerformerAffinity>(
       _performer);
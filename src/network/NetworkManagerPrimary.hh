@@ -18,10 +18,13 @@
 #define IGNITION_GAZEBO_NETWORK_NETWORKMANAGERPRIMARY_HH_
 
 #include <atomic>
-#include <future>
+#include <condition_variable>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <ignition/gazebo/config.hh>
@@ -32,6 +35,7 @@
 #include "msgs/simulation_step.pb.h"
 
 #include "NetworkManager.hh"
+#include "SharedMemoryChannel.hh"
 
 namespace ignition
 {
@@ -50,6 +54,17 @@ namespace ignition
       /// \brief prefix namespace of the secondary peer
       std::string prefix;
 
+      /// \brief Channel steps are written to, if the secondary runs on the
+      /// same host. Null if steps are published through ign-transport.
+      std::unique_ptr<SharedMemoryChannel> stepChannel;
+
+      /// \brief Channel the secondary writes its acks to, if stepChannel is
+      /// set.
+      std::unique_ptr<SharedMemoryChannel> ackChannel;
+
+      /// \brief Thread reading acks from ackChannel.
+      std::thread ackThread;
+
       /// \brief Convenience alias for unique_ptr.
       using Ptr = std::unique_ptr<SecondaryControl>;
     };
@@ -67,6 +82,9 @@ namespace ignition
           const NetworkConfig &_config,
           const NodeOptions &_options);
 
+      /// \brief Destructor
+      public: ~NetworkManagerPrimary() override;
+
       // Documentation inherited
       public: void Handshake() override;
 
@@ -77,6 +95,13 @@ namespace ignition
       /// This method is called at the beginning of a simulation iteration.
       /// It will populate the info argument with the appropriate values for
       /// the simuation iteration.
+      /// The step is sent to all secondaries, and the primary's systems are
+      /// stepped while the secondaries step, on the states received so far.
+      /// The states the secondaries send back are then applied, so they're
+      /// seen by the primary's systems on the next step. If
+      /// NetworkConfig::maxStepLag is set, this only waits until secondaries
+      /// are at most that many steps behind, so the states applied may be
+      /// from previous steps.
       /// \param[inout] _info current simulation update information
       /// \return True if simulation step was successfully synced.
       public: bool Step(const UpdateInfo &_info);
@@ -92,6 +117,11 @@ namespace ignition
       /// \param[in] _msg Message containing secondary's updated state.
       private: void OnStepAck(const msgs::SerializedStateMap &_msg);
 
+      /// \brief Read acks from a secondary's shared memory channel until
+      /// the channel is closed or this is destroyed.
+      /// \param[in] _channel Channel to read from.
+      private: void ReadAcks(SharedMemoryChannel *_channel);
+
       /// \brief Check if the step publisher has connections.
       private: bool SecondariesCanStep() const;
 
@@ -104,8 +134,21 @@ namespace ignition
       /// \param[in] _performer Performer entity.
       /// \param[in] _secondary Secondary identifier.
       /// \param[out] _msg Message to be populated.
+      /// \param[in] _migrate True if the performer moves from another
+      /// secondary, so its state is sent along.
       private: void SetAffinity(Entity _performer,
-          const std::string &_secondary, private_msgs::PerformerAffinity *_msg);
+          const std::string &_secondary, private_msgs::PerformerAffinity *_msg,
+          bool _migrate = false);
+
+      /// \brief Move a performer from the slowest secondary to the fastest
+      /// one, if the slowest has been slower for long enough.
+      /// \param[in] _affinities Current secondary of each performer.
+      /// \param[in] _costs Estimated cost of simulating each performer.
+      /// \param[in] _iteration Current iteration.
+      /// \param[out] _msg Step message populated with the new affinity.
+      private: void Rebalance(const std::map<Entity, std::string> &_affinities,
+          const std::map<Entity, double> &_costs, uint64_t _iteration,
+          private_msgs::SimulationStep &_msg);
 
       /// \brief Container of currently used secondary peers
       private: std::map<std::string, SecondaryControl::Ptr> secondaries;
@@ -116,11 +159,40 @@ namespace ignition
       /// \brief Publisher for network step sync
       private: ignition::transport::Node::Publisher simStepPub;
 
-      /// \brief Keep track of states received from secondaries.
+      /// \brief States received from secondaries which haven't been applied
+      /// yet, in the order they arrived.
       private: std::vector<msgs::SerializedStateMap> secondaryStates;
 
-      /// \brief Promise used to notify when all secondaryStates where received.
-      private: std::promise<void> secondaryStatesPromise;
+      /// \brief Number of acks received for each step which not all
+      /// secondaries have finished yet, keyed by iteration.
+      private: std::map<uint64_t, std::size_t> stepAcks;
+
+      /// \brief Number of steps sent to the secondaries.
+      private: uint64_t stepsSent{0};
+
+      /// \brief Number of steps finished by all secondaries.
+      private: uint64_t stepsDone{0};
+
+      /// \brief Protects secondaryStates, stepAcks and stepsDone.
+      private: std::mutex secondaryStatesMutex;
+
+      /// \brief Notified when a step ack is received.
+      private: std::condition_variable secondaryStatesCv;
+
+      /// \brief Moving average of the step time of each secondary, in
+      /// seconds, keyed by prefix. Protected by secondaryStatesMutex.
+      private: std::map<std::string, double> secondaryStepTimes;
+
+      /// \brief Number of acks received from each secondary, keyed by
+      /// prefix. Protected by secondaryStatesMutex.
+      private: std::map<std::string, uint64_t> secondaryAcks;
+
+      /// \brief Iteration before which no performer is migrated, so a
+      /// migration shows in the step times before the next one.
+      private: uint64_t nextRebalanceIteration{0};
+
+      /// \brief Set to stop the threads reading acks from shared memory.
+      private: std::atomic<bool> stopAckThreads{false};
     };
     }
   }  // namespace gazebo
@@ -16,6 +16,7 @@
 */
 
 #include <algorithm>
+#include <chrono>
 #include <string>
 
 #include <ignition/common/Console.hh>
@@ -36,6 +37,7 @@
 
 using namespace ignition;
 using namespace gazebo;
+using namespace std::chrono_literals;
 
 //////////////////////////////////////////////////
 NetworkManagerSecondary::NetworkManagerSecondary(
@@ -64,6 +66,14 @@ NetworkManagerSecondary::NetworkManagerSecondary(
   this->stepAckPub = this->node.Advertise<msgs::SerializedStateMap>("step_ack");
 }
 
+//////////////////////////////////////////////////
+NetworkManagerSecondary::~NetworkManagerSecondary()
+{
+  this->stopStepThread = true;
+  if (this->stepThread.joinable())
+    this->stepThread.join();
+}
+
 //////////////////////////////////////////////////
 bool NetworkManagerSecondary::Ready() const
 {
@@ -91,16 +101,75 @@ std::string NetworkManagerSecondary::Namespace() const
 bool NetworkManagerSecondary::OnControl(const private_msgs::PeerControl &_req,
                                         private_msgs::PeerControl& _resp)
 {
+  // The primary runs on the same host, get steps through shared memory
+  if (!_req.shm_name().empty() && this->dataPtr->config.useSharedMemory &&
+      !this->sharedMemoryActive)
+  {
+    this->stepChannel = SharedMemoryChannel::Open(_req.shm_name() + "_step");
+    this->ackChannel = SharedMemoryChannel::Open(_req.shm_name() + "_ack");
+    if (this->stepChannel && this->ackChannel)
+    {
+      igndbg << "Secondary [" << this->Namespace()
+             << "] using shared memory [" << _req.shm_name() << "]"
+             << std::endl;
+      this->sharedMemoryActive = true;
+      this->stepThread = std::thread(&NetworkManagerSecondary::ReadSteps,
+          this);
+    }
+    else
+    {
+      this->stepChannel.reset();
+      this->ackChannel.reset();
+    }
+  }
+
   this->enableSim = _req.enable_sim();
   _resp.set_enable_sim(this->enableSim);
+  _resp.set_shm_enabled(this->sharedMemoryActive);
   return true;
 }
 
+/////////////////////////////////////////////////
+void NetworkManagerSecondary::ReadSteps()
+{
+  std::string data;
+  private_msgs::SimulationStep msg;
+  while (!this->stopStepThread && !this->dataPtr->stopReceived)
+  {
+    if (!this->stepChannel->Read(data, 100ms))
+    {
+      if (this->stepChannel->Closed())
+        break;
+      continue;
+    }
+
+    if (!msg.ParseFromString(data))
+    {
+      ignerr << "Failed to parse step from shared memory ["
+             << this->stepChannel->Name() << "]" << std::endl;
+      continue;
+    }
+    this->ProcessStep(msg);
+  }
+}
+
 /////////////////////////////////////////////////
 void NetworkManagerSecondary::OnStep(
     const private_msgs::SimulationStep &_msg)
 {
-  IGN_PROFILE("NetworkManagerSecondary::OnStep");
+  // Steps for secondaries on the primary's host are only published if there
+  // are also remote secondaries, and this one reads them from shared memory
+  if (this->sharedMemoryActive)
+    return;
+
+  this->ProcessStep(_msg);
+}
+
+/////////////////////////////////////////////////
+void NetworkManagerSecondary::ProcessStep(
+    const private_msgs::SimulationStep &_msg)
+{
+  IGN_PROFILE("NetworkManagerSecondary::ProcessStep");
 
   // Throttle the number of step messages going to the debug output.
   if (!_msg.stats().paused() && _msg.stats().iterations() % 1000 == 0)
@@ -117,6 +186,10 @@ void NetworkManagerSecondary::OnStep(
 
     if (affinityMsg.secondary_prefix() == this->Namespace())
     {
+      // Performers migrated from another secondary come with their state
+      if (affinityMsg.has_state() && !this->dataPtr->ecm->HasEntity(entityId))
+        this->dataPtr->ecm->SetState(affinityMsg.state());
+
       this->performers.insert(entityId);
 
       ignmsg << "Secondary [" << this->Namespace()
@@ -126,9 +199,12 @@ void NetworkManagerSecondary::OnStep(
     // If performer has been assigned to another secondary, remove it
     else
     {
+      // The performer may have been removed already, if it was assigned to
+      // another secondary before
       auto parent =
           this->dataPtr->ecm->Component<components::ParentEntity>(entityId);
-      this->dataPtr->ecm->RequestRemoveEntity(parent->Data());
+      if (parent)
+        this->dataPtr->ecm->RequestRemoveEntity(parent->Data());
 
       if (this->performers.find(entityId) != this->performers.end())
       {
@@ -144,7 +220,10 @@ void NetworkManagerSecondary::OnStep(
   auto info = convert<UpdateInfo>(_msg.stats());
 
   // Step runner
+  const auto stepStart = std::chrono::steady_clock::now();
   this->dataPtr->stepFunction(info);
+  const std::chrono::duration<double> stepTime =
+      std::chrono::steady_clock::now() - stepStart;
 
   // Update state with all the performer's entities
   std::unordered_set<Entity> entities;
@@ -174,7 +253,33 @@ void NetworkManagerSecondary::OnStep(
   data->set_key("has_one_time_component_changes");
   data->add_value(this->dataPtr->ecm->HasOneTimeComponentChanges() ? "1" : "0");
 
-  this->stepAckPub.Publish(stateMsg);
+  // Lets the primary know which step is done when it doesn't wait for each
+  // step
+  data = stateMsg.mutable_header()->add_data();
+  data->set_key("iteration");
+  data->add_value(std::to_string(info.iterations));
+
+  // Used by the primary to balance the load across secondaries
+  data = stateMsg.mutable_header()->add_data();
+  data->set_key("secondary");
+  data->add_value(this->Namespace());
+  data = stateMsg.mutable_header()->add_data();
+  data->set_key("step_time");
+  data->add_value(std::to_string(stepTime.count()));
+
+  // Acks which don't fit in shared memory go through ign-transport, the
+  // primary listens to both
+  bool sent{false};
+  if (this->sharedMemoryActive)
+  {
+    std::string data;
+    sent = stateMsg.SerializeToString(&data) &&
+        this->ackChannel->Write(data, 1s);
+  }
+  if (!sent)
+    this->stepAckPub.Publish(stateMsg);
+  this->dataPtr->tracker->SetTelemetry(stepTime.count(),
+      stateMsg.ByteSizeLong());
 
   this->dataPtr->ecm->SetAllComponentsUnchanged();
 }
@@ -20,6 +20,7 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_set>
 
 #include <ignition/gazebo/config.hh>
@@ -30,6 +31,7 @@
 #include "msgs/peer_control.pb.h"
 
 #include "NetworkManager.hh"
+#include "SharedMemoryChannel.hh"
 
 namespace ignition
 {
@@ -50,6 +52,9 @@ namespace ignition
           const NetworkConfig &_config,
           const NodeOptions &_options);
 
+      /// \brief Destructor
+      public: ~NetworkManagerSecondary() override;
+
       // Documentation inherited
       public: bool Ready() const override;
 
@@ -67,9 +72,19 @@ namespace ignition
                              private_msgs::PeerControl &_resp);
 
       /// \brief Callback when step commands are received from the primary
+      /// through ign-transport.
       /// \param[in] _msg Step message.
       private: void OnStep(const private_msgs::SimulationStep &_msg);
 
+      /// \brief Run a step received from the primary and send back the
+      /// resulting state.
+      /// \param[in] _msg Step message.
+      private: void ProcessStep(const private_msgs::SimulationStep &_msg);
+
+      /// \brief Read steps from stepChannel and process them until the
+      /// channel is closed or this is destroyed.
+      private: void ReadSteps();
+
       /// \brief Flag to control enabling/disabling simulation secondary.
       private: std::atomic<bool> enableSim {false};
 
@@ -81,6 +96,22 @@ namespace ignition
 
       /// \brief Collection of performers associated with this secondary.
       private: std::unordered_set<Entity> performers;
+
+      /// \brief Channel steps are read from, if the primary runs on the same
+      /// host.
+      private: std::unique_ptr<SharedMemoryChannel> stepChannel;
+
+      /// \brief Channel acks are written to, if stepChannel is set.
+      private: std::unique_ptr<SharedMemoryChannel> ackChannel;
+
+      /// \brief Thread reading steps from stepChannel.
+      private: std::thread stepThread;
+
+      /// \brief True once steps come through shared memory.
+      private: std::atomic<bool> sharedMemoryActive{false};
+
+      /// \brief Set to stop stepThread.
+      private: std::atomic<bool> stopStepThread{false};
     };
     }
   }  // namespace gazebo
@@ -48,6 +48,9 @@ ignition::gazebo::private_msgs::PeerInfo ignition::gazebo::toProto(
   ignition::gazebo::private_msgs::PeerInfo proto;
   proto.set_id(_info.id);
   proto.set_hostname(_info.hostname);
+  proto.set_step_time(_info.stepTime);
+  proto.set_state_size(_info.stateSize);
+  proto.set_queue_depth(_info.queueDepth);
 
   switch (_info.role)
   {
@@ -76,6 +79,9 @@ PeerInfo ignition::gazebo::fromProto(
   PeerInfo info;
   info.id = _proto.id();
   info.hostname = _proto.hostname();
+  info.stepTime = _proto.step_time();
+  info.stateSize = _proto.state_size();
+  info.queueDepth = _proto.queue_depth();
 
   switch (_proto.role())
   {
@@ -17,6 +17,7 @@
 #ifndef IGNITION_GAZEBO_NETWORK_PEERINFO_HH_
 #define IGNITION_GAZEBO_NETWORK_PEERINFO_HH_
 
+#include <cstdint>
 #include <string>
 
 #include <ignition/gazebo/config.hh>
@@ -47,6 +48,19 @@ namespace ignition
 
       /// \brief Peer's role in the network
       public: NetworkRole role;
+
+      /// \brief Wall time of the peer's last step, in seconds.
+      public: double stepTime{0.0};
+
+      /// \brief Size of the state the peer sent, if it's a secondary, or
+      /// received, if it's the primary, on its last step, in bytes.
+      public: uint64_t stateSize{0};
+
+      /// \brief Number of steps sent to this peer which it hasn't finished
+      /// yet. For the primary, steps which not all secondaries have
+      /// finished. Only known by the primary, which sets it for itself and
+      /// for each secondary.
+      public: uint64_t queueDepth{0};
     };
     }
 
@@ -116,6 +116,40 @@ size_t PeerTracker::NumPeers(const NetworkRole &_role) const
   return count;
 }
 
+/////////////////////////////////////////////////
+void PeerTracker::SetTelemetry(double _stepTime, uint64_t _stateSize,
+    uint64_t _queueDepth)
+{
+  auto lock = PeerLock(this->peersMutex);
+  this->info.stepTime = _stepTime;
+  this->info.stateSize = _stateSize;
+  this->info.queueDepth = _queueDepth;
+}
+
+/////////////////////////////////////////////////
+void PeerTracker::SetQueueDepth(const std::string &_id, uint64_t _queueDepth)
+{
+  auto lock = PeerLock(this->peersMutex);
+  auto iter = this->peers.find(_id);
+  if (iter == this->peers.end())
+    return;
+
+  iter->second.info.queueDepth = _queueDepth;
+  iter->second.localQueueDepth = true;
+}
+
+/////////////////////////////////////////////////
+std::vector<PeerInfo> PeerTracker::Peers() const
+{
+  auto lock = PeerLock(this->peersMutex);
+  std::vector<PeerInfo> result;
+  result.reserve(this->peers.size() + 1);
+  result.push_back(this->info);
+  for (const auto &peer : this->peers)
+    result.push_back(peer.second.info);
+  return result;
+}
+
 /////////////////////////////////////////////////
 void PeerTracker::HeartbeatLoop()
 {
@@ -125,7 +159,12 @@ void PeerTracker::HeartbeatLoop()
   while (this->heartbeatRunning)
   {
     lastUpdateTime = Clock::now();
-    this->heartbeatPub.Publish(toProto(this->info));
+    private_msgs::PeerInfo heartbeat;
+    {
+      auto lock = PeerLock(this->peersMutex);
+      heartbeat = toProto(this->info);
+    }
+    this->heartbeatPub.Publish(heartbeat);
 
     std::vector<PeerInfo> toRemove;
     for (auto peer : this->peers)
@@ -216,6 +255,9 @@ void PeerTracker::OnPeerHeartbeat(const private_msgs::PeerInfo &_info)
 
   // Update information about the state of this peer.
   auto &peerState = this->peers[peer.id];
+  if (peerState.localQueueDepth)
+    peer.queueDepth = peerState.info.queueDepth;
+  peerState.info = peer;
   peerState.lastSeen = std::chrono::steady_clock::now();
   peerState.lastHeader = std::chrono::steady_clock::time_point(
       std::chrono::seconds(_info.header().stamp().sec()) +
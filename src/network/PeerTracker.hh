@@ -17,6 +17,7 @@
 #ifndef IGNITION_GAZEBO_NETWORK_PEERTRACKER_HH_
 #define IGNITION_GAZEBO_NETWORK_PEERTRACKER_HH_
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -125,6 +126,28 @@ namespace ignition
                 return NumPeers(NetworkRole::ReadOnly);
               }
 
+      /// \brief Set the telemetry of this peer, which is sent to the other
+      /// peers with the next heartbeats.
+      /// \param[in] _stepTime Wall time of the last step, in seconds.
+      /// \param[in] _stateSize Size of the state sent or received on the
+      /// last step, in bytes.
+      /// \param[in] _queueDepth Steps sent which not all secondaries have
+      /// finished. Only meaningful for the primary.
+      public: void SetTelemetry(double _stepTime, uint64_t _stateSize,
+                                uint64_t _queueDepth = 0);
+
+      /// \brief Set the number of steps sent to a peer which it hasn't
+      /// finished yet. It's kept across heartbeats, which don't carry it for
+      /// secondaries.
+      /// \param[in] _id Id of the peer.
+      /// \param[in] _queueDepth Number of steps.
+      public: void SetQueueDepth(const std::string &_id, uint64_t _queueDepth);
+
+      /// \brief Get the latest information about this peer and all
+      /// discovered peers, including their telemetry.
+      /// \return This peer, followed by the discovered peers.
+      public: std::vector<PeerInfo> Peers() const;
+
       /// \brief Retrieve the ids of discovered peers.
       public: std::vector<std::string> SecondaryPeers() const
               {
@@ -175,6 +198,10 @@ namespace ignition
 
         /// \brief Keep last time heartbeat was received
         std::chrono::steady_clock::time_point lastSeen;
+
+        /// \brief True if the queue depth was set locally, so heartbeats
+        /// don't override it.
+        bool localQueueDepth{false};
       };
 
       /// \brief Convenience type alias
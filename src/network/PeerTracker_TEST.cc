@@ -273,6 +273,64 @@ TEST(PeerTracker, Namespaced)
   EXPECT_EQ(1u, tracker4.NumPeers());
 }
 
+//////////////////////////////////////////////////
+TEST(PeerTracker, Telemetry)
+{
+  ignition::common::Console::SetVerbosity(4);
+  EventManager eventMgr;
+
+  auto options = ignition::transport::NodeOptions();
+  options.SetPartition("telemetry");
+  auto primary = PeerTracker(
+      PeerInfo(NetworkRole::SimulationPrimary), &eventMgr, options);
+  auto secondary = PeerTracker(
+      PeerInfo(NetworkRole::SimulationSecondary), &eventMgr, options);
+  primary.SetHeartbeatPeriod(std::chrono::milliseconds(10));
+  secondary.SetHeartbeatPeriod(std::chrono::milliseconds(10));
+
+  secondary.SetTelemetry(0.002, 1234);
+  primary.SetTelemetry(0.003, 2345, 2);
+
+  // Wait for heartbeats carrying the telemetry
+  auto peerOf = [](const PeerTracker &_tracker)
+  {
+    auto peers = _tracker.Peers();
+    return peers.size() < 2 ? PeerInfo() : peers[1];
+  };
+  for (int sleep = 0; sleep < 30 &&
+      (peerOf(primary).stateSize == 0 || peerOf(secondary).stateSize == 0);
+      ++sleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+
+  // Each tracker lists itself first
+  auto primaryPeers = primary.Peers();
+  ASSERT_EQ(2u, primaryPeers.size());
+  EXPECT_EQ(NetworkRole::SimulationPrimary, primaryPeers[0].role);
+  EXPECT_DOUBLE_EQ(0.003, primaryPeers[0].stepTime);
+  EXPECT_EQ(2345u, primaryPeers[0].stateSize);
+  EXPECT_EQ(2u, primaryPeers[0].queueDepth);
+
+  EXPECT_EQ(NetworkRole::SimulationSecondary, primaryPeers[1].role);
+  EXPECT_DOUBLE_EQ(0.002, primaryPeers[1].stepTime);
+  EXPECT_EQ(1234u, primaryPeers[1].stateSize);
+  EXPECT_EQ(0u, primaryPeers[1].queueDepth);
+
+  auto secondaryPeers = secondary.Peers();
+  ASSERT_EQ(2u, secondaryPeers.size());
+  EXPECT_EQ(2345u, secondaryPeers[1].stateSize);
+  EXPECT_EQ(2u, secondaryPeers[1].queueDepth);
+
+  // Queue depths set locally aren't overridden by heartbeats
+  primary.SetQueueDepth(primaryPeers[1].id, 3);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  primaryPeers = primary.Peers();
+  ASSERT_EQ(2u, primaryPeers.size());
+  EXPECT_EQ(3u, primaryPeers[1].queueDepth);
+  EXPECT_EQ(1234u, primaryPeers[1].stateSize);
+}
+
 //////////////////////////////////////////////////
 // Only on Linux for the moment
 #ifdef  __linux__
@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "SharedMemoryChannel.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <ignition/common/Console.hh>
+
+using namespace ignition;
+using namespace gazebo;
+
+namespace
+{
+/// \brief Number of times a waiting end polls without sleeping. Steps are
+/// usually answered within this time, so the latency of a sleep is avoided.
+constexpr int kSpinCount{2000};
+
+/// \brief Time waited between polls once spinning is over.
+constexpr std::chrono::microseconds kPollPeriod{20};
+
+/// \brief Wait until a condition is true, the channel is closed or the
+/// timeout expires.
+/// \param[in] _ready Condition to wait for.
+/// \param[in] _closed True if the channel is closed.
+/// \param[in] _timeout Maximum time to wait.
+/// \return True if the condition is true.
+template <typename Ready, typename Closed>
+bool waitFor(Ready _ready, Closed _closed, std::chrono::milliseconds _timeout)
+{
+  const auto deadline = std::chrono::steady_clock::now() + _timeout;
+  for (int i = 0; !_ready(); ++i)
+  {
+    if (_closed())
+      return _ready();
+
+    if (i < kSpinCount)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    if (std::chrono::steady_clock::now() >= deadline)
+      return false;
+    std::this_thread::sleep_for(kPollPeriod);
+  }
+  return true;
+}
+}
+
+//////////////////////////////////////////////////
+/// \brief Written and read by both processes. The reader and writer
+/// positions are kept on different cache lines, so each end only invalidates
+/// the other's line when it moves.
+struct SharedMemoryChannel::Header
+{
+  /// \brief Total number of bytes written, only changed by the writer.
+  alignas(64) std::atomic<uint64_t> head;
+
+  /// \brief Total number of bytes read, only changed by the reader.
+  alignas(64) std::atomic<uint64_t> tail;
+
+  /// \brief Set by either end when it goes away.
+  alignas(64) std::atomic<uint32_t> closed;
+
+  /// \brief Size of the ring buffer in bytes.
+  uint64_t capacity;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+    "Shared memory channels need lock-free 64 bit atomics");
+
+//////////////////////////////////////////////////
+std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::Create(
+    const std::string &_name, std::size_t _capacity)
+{
+#ifdef _WIN32
+  (void)_name;
+  (void)_capacity;
+  return nullptr;
+#else
+  // A previous run may have crashed before removing it
+  shm_unlink(_name.c_str());
+
+  int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    ignerr << "Failed to create shared memory [" << _name << "]: "
+           << std::strerror(errno) << std::endl;
+    return nullptr;
+  }
+
+  const std::size_t size = sizeof(Header) + _capacity;
+  void *addr{MAP_FAILED};
+  if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+  {
+    addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  const int error = errno;
+  close(fd);
+
+  if (MAP_FAILED == addr)
+  {
+    ignerr << "Failed to map shared memory [" << _name << "]: "
+           << std::strerror(error) << std::endl;
+    shm_unlink(_name.c_str());
+    return nullptr;
+  }
+
+  std::unique_ptr<SharedMemoryChannel> channel(new SharedMemoryChannel);
+  channel->header = new (addr) Header;
+  channel->header->head = 0;
+  channel->header->tail = 0;
+  channel->header->closed = 0;
+  channel->header->capacity = _capacity;
+  channel->buffer = static_cast<char *>(addr) + sizeof(Header);
+  channel->mappedSize = size;
+  channel->name = _name;
+  channel->owner = true;
+  return channel;
+#endif
+}
+
+//////////////////////////////////////////////////
+std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::Open(
+    const std::string &_name)
+{
+#ifdef _WIN32
+  (void)_name;
+  return nullptr;
+#else
+  int fd = shm_open(_name.c_str(), O_RDWR, 0600);
+  if (fd < 0)
+  {
+    ignerr << "Failed to open shared memory [" << _name << "]: "
+           << std::strerror(errno) << std::endl;
+    return nullptr;
+  }
+
+  struct stat info;
+  void *addr{MAP_FAILED};
+  if (fstat(fd, &info) == 0 &&
+      static_cast<std::size_t>(info.st_size) > sizeof(Header))
+  {
+    addr = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+        fd, 0);
+  }
+  close(fd);
+
+  if (MAP_FAILED == addr)
+  {
+    ignerr << "Failed to map shared memory [" << _name << "]" << std::endl;
+    return nullptr;
+  }
+
+  // The creator may still be resizing it
+  auto header = static_cast<Header *>(addr);
+  if (header->capacity != info.st_size - sizeof(Header))
+  {
+    ignerr << "Shared memory [" << _name << "] has an invalid size"
+           << std::endl;
+    munmap(addr, info.st_size);
+    return nullptr;
+  }
+
+  std::unique_ptr<SharedMemoryChannel> channel(new SharedMemoryChannel);
+  channel->header = header;
+  channel->buffer = static_cast<char *>(addr) + sizeof(Header);
+  channel->mappedSize = info.st_size;
+  channel->name = _name;
+  return channel;
+#endif
+}
+
+//////////////////////////////////////////////////
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+#ifndef _WIN32
+  if (nullptr == this->header)
+    return;
+
+  this->Close();
+  munmap(this->header, this->mappedSize);
+  if (this->owner)
+    shm_unlink(this->name.c_str());
+#endif
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryChannel::Write(const std::string &_data,
+    std::chrono::milliseconds _timeout)
+{
+  const uint32_t size = static_cast<uint32_t>(_data.size());
+  const uint64_t total = sizeof(size) + _data.size();
+  const uint64_t capacity = this->header->capacity;
+  if (total > capacity)
+    return false;
+
+  const uint64_t head = this->header->head.load(std::memory_order_relaxed);
+  auto hasRoom = [&]
+  {
+    const uint64_t tail = this->header->tail.load(std::memory_order_acquire);
+    return capacity - (head - tail) >= total;
+  };
+  if (!waitFor(hasRoom, [this]{return this->Closed();}, _timeout) ||
+      this->Closed())
+  {
+    return false;
+  }
+
+  this->CopyIn(head, reinterpret_cast<const char *>(&size), sizeof(size));
+  this->CopyIn(head + sizeof(size), _data.data(), _data.size());
+  this->header->head.store(head + total, std::memory_order_release);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryChannel::Read(std::string &_data,
+    std::chrono::milliseconds _timeout)
+{
+  const uint64_t tail = this->header->tail.load(std::memory_order_relaxed);
+  uint32_t size{0};
+  auto hasMessage = [&]
+  {
+    const uint64_t head = this->header->head.load(std::memory_order_acquire);
+    return head - tail >= sizeof(size);
+  };
+  if (!waitFor(hasMessage, [this]{return this->Closed();}, _timeout))
+    return false;
+
+  // The writer only publishes whole messages
+  this->CopyOut(tail, reinterpret_cast<char *>(&size), sizeof(size));
+  _data.resize(size);
+  this->CopyOut(tail + sizeof(size), &_data[0], size);
+  this->header->tail.store(tail + sizeof(size) + size,
+      std::memory_order_release);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SharedMemoryChannel::Close()
+{
+  this->header->closed.store(1, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////
+bool SharedMemoryChannel::Closed() const
+{
+  return this->header->closed.load(std::memory_order_acquire) != 0;
+}
+
+//////////////////////////////////////////////////
+const std::string &SharedMemoryChannel::Name() const
+{
+  return this->name;
+}
+
+//////////////////////////////////////////////////
+void SharedMemoryChannel::CopyIn(uint64_t _offset, const char *_data,
+    std::size_t _size)
+{
+  const uint64_t capacity = this->header->capacity;
+  const std::size_t start = _offset % capacity;
+  const std::size_t first = std::min<std::size_t>(_size, capacity - start);
+  std::memcpy(this->buffer + start, _data, first);
+  std::memcpy(this->buffer, _data + first, _size - first);
+}
+
+//////////////////////////////////////////////////
+void SharedMemoryChannel::CopyOut(uint64_t _offset, char *_data,
+    std::size_t _size) const
+{
+  const uint64_t capacity = this->header->capacity;
+  const std::size_t start = _offset % capacity;
+  const std::size_t first = std::min<std::size_t>(_size, capacity - start);
+  std::memcpy(_data, this->buffer + start, first);
+  std::memcpy(_data + first, this->buffer, _size - first);
+}
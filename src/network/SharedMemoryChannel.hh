@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_NETWORK_SHAREDMEMORYCHANNEL_HH_
+#define IGNITION_GAZEBO_NETWORK_SHAREDMEMORYCHANNEL_HH_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    /// \class SharedMemoryChannel SharedMemoryChannel.hh
+    ///   ignition/gazebo/network/SharedMemoryChannel.hh
+    /// \brief Single producer, single consumer queue of messages in a POSIX
+    /// shared memory ring buffer, used by network peers running on the same
+    /// host instead of going through ign-transport's sockets.
+    ///
+    /// One process creates the channel and the other one opens it by name.
+    /// Each message is a byte string, typically a serialized protobuf
+    /// message. Only one thread may write and only one thread may read at a
+    /// time.
+    ///
+    /// Shared memory channels aren't available on Windows, where Create and
+    /// Open always return nullptr.
+    class IGNITION_GAZEBO_VISIBLE SharedMemoryChannel
+    {
+      /// \brief Create a new channel, replacing any stale one with the same
+      /// name. The channel is removed from the system when the returned
+      /// object is destroyed.
+      /// \param[in] _name Name of the channel, starting with '/'.
+      /// \param[in] _capacity Size of the ring buffer in bytes. Memory is
+      /// only committed as it's used.
+      /// \return The channel, or nullptr if it couldn't be created.
+      public: static std::unique_ptr<SharedMemoryChannel> Create(
+          const std::string &_name, std::size_t _capacity);
+
+      /// \brief Open a channel created by another process.
+      /// \param[in] _name Name passed to Create.
+      /// \return The channel, or nullptr if it couldn't be opened.
+      public: static std::unique_ptr<SharedMemoryChannel> Open(
+          const std::string &_name);
+
+      /// \brief Destructor. Closes the channel, so the other end stops
+      /// waiting.
+      public: ~SharedMemoryChannel();
+
+      /// \brief Append a message, waiting for the reader to make room if
+      /// needed.
+      /// \param[in] _data Message to be written.
+      /// \param[in] _timeout Maximum time to wait for room.
+      /// \return False if the message doesn't fit in the buffer, if there
+      /// wasn't room before the timeout, or if the channel is closed.
+      public: bool Write(const std::string &_data,
+          std::chrono::milliseconds _timeout);
+
+      /// \brief Take the oldest message, waiting for one if needed.
+      /// \param[out] _data Message read.
+      /// \param[in] _timeout Maximum time to wait for a message.
+      /// \return False if there was no message before the timeout, or if the
+      /// channel is closed and empty.
+      public: bool Read(std::string &_data,
+          std::chrono::milliseconds _timeout);
+
+      /// \brief Mark the channel as closed, so both ends stop waiting.
+      public: void Close();
+
+      /// \brief Whether either end closed the channel.
+      /// \return True if closed.
+      public: bool Closed() const;
+
+      /// \brief Name of the channel.
+      /// \return Name passed to Create or Open.
+      public: const std::string &Name() const;
+
+      /// \brief Constructor, use Create or Open instead.
+      private: SharedMemoryChannel() = default;
+
+      /// \brief Copy bytes into the ring buffer.
+      /// \param[in] _offset Position in the stream of bytes written so far.
+      /// \param[in] _data Bytes to be copied.
+      /// \param[in] _size Number of bytes.
+      private: void CopyIn(uint64_t _offset, const char *_data,
+          std::size_t _size);
+
+      /// \brief Copy bytes out of the ring buffer.
+      /// \param[in] _offset Position in the stream of bytes written so far.
+      /// \param[out] _data Destination.
+      /// \param[in] _size Number of bytes.
+      private: void CopyOut(uint64_t _offset, char *_data,
+          std::size_t _size) const;
+
+      /// \brief Layout of the start of the shared memory.
+      private: struct Header;
+
+      /// \brief Pointer to the mapped shared memory.
+      private: Header *header{nullptr};
+
+      /// \brief Start of the ring buffer, right after the header.
+      private: char *buffer{nullptr};
+
+      /// \brief Size of the mapping in bytes.
+      private: std::size_t mappedSize{0};
+
+      /// \brief Name of the channel.
+      private: std::string name;
+
+      /// \brief True if this object created the channel and removes it.
+      private: bool owner{false};
+    };
+    }
+  }  // namespace gazebo
+}  // namespace ignition
+
+#endif  // IGNITION_GAZEBO_NETWORK_SHAREDMEMORYCHANNEL_HH_
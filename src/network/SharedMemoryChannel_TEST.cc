@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+#include "SharedMemoryChannel.hh"
+
+using namespace ignition::gazebo;
+using namespace std::chrono_literals;
+
+/////////////////////////////////////////////////
+TEST(SharedMemoryChannel, WriteRead)
+{
+#ifdef _WIN32
+  // Not available on Windows
+  EXPECT_EQ(nullptr, SharedMemoryChannel::Create("/ign_gazebo_test", 1000));
+  return;
+#endif
+  auto writer = SharedMemoryChannel::Create("/ign_gazebo_test_channel", 1000);
+  ASSERT_NE(nullptr, writer);
+  auto reader = SharedMemoryChannel::Open("/ign_gazebo_test_channel");
+  ASSERT_NE(nullptr, reader);
+  EXPECT_EQ("/ign_gazebo_test_channel", reader->Name());
+
+  std::string data;
+  EXPECT_FALSE(reader->Read(data, 1ms));
+
+  // Too large for the buffer
+  EXPECT_FALSE(writer->Write(std::string(1000, 'x'), 1ms));
+
+  // Messages wrap around the end of the buffer many times
+  auto message = [](int _i)
+  {
+    return std::string(_i % 300, 'a' + _i % 26) + std::to_string(_i);
+  };
+  std::thread writerThread([&]
+  {
+    for (int i = 0; i < 1000; ++i)
+      EXPECT_TRUE(writer->Write(message(i), 1s));
+  });
+  for (int i = 0; i < 1000; ++i)
+  {
+    ASSERT_TRUE(reader->Read(data, 1s));
+    EXPECT_EQ(message(i), data);
+  }
+  writerThread.join();
+
+  // Closed by either end
+  EXPECT_FALSE(reader->Closed());
+  writer.reset();
+  EXPECT_TRUE(reader->Closed());
+  EXPECT_FALSE(reader->Read(data, 1s));
+  EXPECT_EQ(nullptr, SharedMemoryChannel::Open("/ign_gazebo_test_channel"));
+}
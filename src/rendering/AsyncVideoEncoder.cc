@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+
+#include "ignition/gazebo/rendering/AsyncVideoEncoder.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Maximum number of frames waiting to be encoded.
+static constexpr std::size_t kMaxQueuedFrames{10};
+
+/// Private data for the AsyncVideoEncoder class
+class ignition::gazebo::AsyncVideoEncoderPrivate
+{
+  /// \brief A frame waiting to be encoded.
+  public: struct Frame
+  {
+    /// \brief Frame data.
+    std::shared_ptr<const unsigned char> data;
+
+    /// \brief Buffer owning the data, if it was copied, to be reused.
+    std::shared_ptr<unsigned char> buffer;
+
+    /// \brief Width in pixels.
+    unsigned int width;
+
+    /// \brief Height in pixels.
+    unsigned int height;
+
+    /// \brief Time of the frame.
+    std::chrono::steady_clock::time_point timestamp;
+  };
+
+  /// \brief Encode queued frames until stopThread is set.
+  public: void Run();
+
+  /// \brief Queue a frame, if there's room.
+  /// \param[in] _frame Frame to be queued.
+  /// \return True if queued.
+  public: bool Push(Frame &&_frame);
+
+  /// \brief Wait until the thread isn't encoding and nothing is queued.
+  /// \param[in] _lock Lock holding mutex.
+  public: void WaitIdle(std::unique_lock<std::mutex> &_lock);
+
+  /// \brief Encoder, only used by the encoding thread while encoding.
+  public: common::VideoEncoder encoder;
+
+  /// \brief Called for each frame added to the video.
+  public: std::function<void(const std::chrono::steady_clock::time_point &)>
+      frameAddedCb;
+
+  /// \brief Protects the members below.
+  public: mutable std::mutex mutex;
+
+  /// \brief Notified when frames are queued, encoded, or the thread should
+  /// stop.
+  public: std::condition_variable cv;
+
+  /// \brief Frames waiting to be encoded, oldest first.
+  public: std::deque<Frame> queue;
+
+  /// \brief Buffers for copied frames which can be reused.
+  public: std::vector<std::shared_ptr<unsigned char>> spareBuffers;
+
+  /// \brief Size in bytes of the spare buffers.
+  public: std::size_t bufferSize{0};
+
+  /// \brief True between Start and Stop.
+  public: bool encoding{false};
+
+  /// \brief True while the thread is encoding a frame it took.
+  public: bool busy{false};
+
+  /// \brief True if a frame was dropped since Start.
+  public: bool dropped{false};
+
+  /// \brief Set to stop the thread.
+  public: bool stopThread{false};
+
+  /// \brief Encoding thread.
+  public: std::thread thread;
+};
+
+//////////////////////////////////////////////////
+void AsyncVideoEncoderPrivate::Run()
+{
+  IGN_PROFILE_THREAD_NAME("AsyncVideoEncoder");
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->cv.wait(lock, [this]
+        {
+          return this->stopThread || !this->queue.empty();
+        });
+    if (this->queue.empty())
+      return;
+
+    Frame frame = std::move(this->queue.front());
+    this->queue.pop_front();
+    this->busy = true;
+    lock.unlock();
+
+    {
+      IGN_PROFILE("AsyncVideoEncoder::AddFrame");
+      if (this->encoder.AddFrame(frame.data.get(), frame.width,
+          frame.height, frame.timestamp) && this->frameAddedCb)
+      {
+        this->frameAddedCb(frame.timestamp);
+      }
+    }
+    frame.data.reset();
+
+    lock.lock();
+    if (frame.buffer && frame.buffer.use_count() == 1 &&
+        frame.width * frame.height * 3 == this->bufferSize)
+    {
+      this->spareBuffers.push_back(std::move(frame.buffer));
+    }
+    this->busy = false;
+    this->cv.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+bool AsyncVideoEncoderPrivate::Push(Frame &&_frame)
+{
+  if (!this->encoding)
+    return false;
+
+  if (this->queue.size() >= kMaxQueuedFrames)
+  {
+    if (!this->dropped)
+    {
+      ignwarn << "Video encoding can't keep up, dropping frames" << std::endl;
+      this->dropped = true;
+    }
+    return false;
+  }
+
+  this->queue.push_back(std::move(_frame));
+  this->cv.notify_all();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void AsyncVideoEncoderPrivate::WaitIdle(std::unique_lock<std::mutex> &_lock)
+{
+  this->cv.wait(_lock, [this]
+      {
+        return !this->busy && this->queue.empty();
+      });
+}
+
+//////////////////////////////////////////////////
+AsyncVideoEncoder::AsyncVideoEncoder()
+  : dataPtr(std::make_unique<AsyncVideoEncoderPrivate>())
+{
+  this->dataPtr->thread =
+      std::thread(&AsyncVideoEncoderPrivate::Run, this->dataPtr.get());
+}
+
+//////////////////////////////////////////////////
+AsyncVideoEncoder::~AsyncVideoEncoder()
+{
+  this->Stop();
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stopThread = true;
+  }
+  this->dataPtr->cv.notify_all();
+  if (this->dataPtr->thread.joinable())
+    this->dataPtr->thread.join();
+}
+
+//////////////////////////////////////////////////
+bool AsyncVideoEncoder::Start(const std::string &_format,
+    const std::string &_filename, unsigned int _width, unsigned int _height,
+    unsigned int _fps, unsigned int _bitRate)
+{
+  this->Stop();
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->WaitIdle(lock);
+  if (!this->dataPtr->encoder.Start(_format, _filename, _width, _height,
+      _fps, _bitRate))
+  {
+    return false;
+  }
+  this->dataPtr->encoding = true;
+  this->dataPtr->dropped = false;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool AsyncVideoEncoder::AddFrame(
+    const std::shared_ptr<const unsigned char> &_frame, unsigned int _width,
+    unsigned int _height,
+    const std::chrono::steady_clock::time_point &_timestamp)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->Push(
+      {_frame, nullptr, _width, _height, _timestamp});
+}
+
+//////////////////////////////////////////////////
+bool AsyncVideoEncoder::AddFrame(const unsigned char *_frame,
+    unsigned int _width, unsigned int _height,
+    const std::chrono::steady_clock::time_point &_timestamp)
+{
+  const std::size_t size = _width * _height * 3;
+  std::shared_ptr<unsigned char> buffer;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (!this->dataPtr->encoding ||
+        this->dataPtr->queue.size() >= kMaxQueuedFrames)
+    {
+      return this->dataPtr->Push({});
+    }
+
+    if (size != this->dataPtr->bufferSize)
+    {
+      this->dataPtr->spareBuffers.clear();
+      this->dataPtr->bufferSize = size;
+    }
+    if (!this->dataPtr->spareBuffers.empty())
+    {
+      buffer = std::move(this->dataPtr->spareBuffers.back());
+      this->dataPtr->spareBuffers.pop_back();
+    }
+  }
+
+  // Copy outside the lock, so the encoding thread isn't held up
+  if (!buffer)
+  {
+    buffer = std::shared_ptr<unsigned char>(new unsigned char[size],
+        std::default_delete<unsigned char[]>());
+  }
+  std::memcpy(buffer.get(), _frame, size);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->Push(
+      {buffer, buffer, _width, _height, _timestamp});
+}
+
+//////////////////////////////////////////////////
+bool AsyncVideoEncoder::Stop()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  if (!this->dataPtr->encoding)
+    return false;
+
+  this->dataPtr->encoding = false;
+  this->dataPtr->WaitIdle(lock);
+  return this->dataPtr->encoder.Stop();
+}
+
+//////////////////////////////////////////////////
+bool AsyncVideoEncoder::IsEncoding() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->encoding;
+}
+
+//////////////////////////////////////////////////
+void AsyncVideoEncoder::SetFrameAddedCallback(
+    std::function<void(const std::chrono::steady_clock::time_point &)> _cb)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->frameAddedCb = std::move(_cb);
+}
@@ -20,6 +20,7 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <utility>
 
 #include <ignition/msgs.hh>
 #include <ignition/transport/Node.hh>
@@ -44,6 +45,20 @@ class ignition::gazebo::MarkerManagerPrivate
   /// \return True if the marker was processed successfully.
   public: bool ProcessMarkerMsg(const ignition::msgs::Marker &_msg);
 
+  /// \brief Queue a marker message, merging it with the add/modify message
+  /// already queued for the same marker, if any. Must be called with the
+  /// mutex locked.
+  /// \param[in] _msg The message data.
+  public: void QueueMarkerMsg(const ignition::msgs::Marker &_msg);
+
+  /// \brief Check whether a marker's material already matches a message,
+  /// so that it doesn't need to be recreated.
+  /// \param[in] _msg The message data.
+  /// \param[in] _material Current material of the marker.
+  /// \return True if the colors and lighting match.
+  public: static bool MaterialMatches(const ignition::msgs::Marker &_msg,
+              const rendering::MaterialPtr &_material);
+
   /// \brief Converts an ignition msg render type to ignition rendering
   /// \param[in] _msg The message data
   /// \return Converted rendering type, if any.
@@ -105,6 +120,11 @@ class ignition::gazebo::MarkerManagerPrivate
   /// \brief List of marker message to process.
   public: std::list<ignition::msgs::Marker> markerMsgs;
 
+  /// \brief Last queued message of each marker with an id, by namespace and
+  /// id, so that successive updates are processed once.
+  public: std::map<std::pair<std::string, uint64_t>,
+      std::list<ignition::msgs::Marker>::iterator> queuedMarkers;
+
   /// \brief Pointer to the scene
   public: rendering::ScenePtr scene;
 
@@ -211,37 +231,34 @@ void MarkerManagerPrivate::Update()
   std::lock_guard<std::mutex> lock(this->mutex);
 
   // Process the marker messages.
-  for (auto markerIter = this->markerMsgs.begin();
-       markerIter != this->markerMsgs.end();)
-  {
-    this->ProcessMarkerMsg(*markerIter);
-    this->markerMsgs.erase(markerIter++);
-  }
-
+  for (const auto &markerMsg : this->markerMsgs)
+    this->ProcessMarkerMsg(markerMsg);
+  this->markerMsgs.clear();
+  this->queuedMarkers.clear();
 
   // Erase any markers that have a lifetime.
   for (auto mit = this->visuals.begin();
        mit != this->visuals.end();)
   {
-    for (auto it = mit->second.cbegin();
-         it != mit->second.cend(); ++it)
+    for (auto it = mit->second.cbegin(); it != mit->second.cend();)
     {
-      if (it->second->GeometryCount() == 0u)
-        continue;
+      ignition::rendering::MarkerPtr markerPtr;
+      if (it->second->GeometryCount() > 0u)
+      {
+        markerPtr = std::dynamic_pointer_cast<ignition::rendering::Marker>(
+            it->second->GeometryByIndex(0u));
+      }
 
-      ignition::rendering::MarkerPtr markerPtr =
-            std::dynamic_pointer_cast<ignition::rendering::Marker>
-            (it->second->GeometryByIndex(0u));
-      if (markerPtr != nullptr)
+      if (markerPtr != nullptr && markerPtr->Lifetime().count() != 0 &&
+          (markerPtr->Lifetime() <= simTime ||
+          this->simTime < this->lastSimTime))
       {
-        if (markerPtr->Lifetime().count() != 0 &&
-            (markerPtr->Lifetime() <= simTime ||
-            this->simTime < this->lastSimTime))
-        {
-          this->scene->DestroyVisual(it->second);
-          it = mit->second.erase(it);
-          break;
-        }
+        this->scene->DestroyVisual(it->second);
+        it = mit->second.erase(it);
+      }
+      else
+      {
+        ++it;
       }
     }
 
@@ -320,10 +337,12 @@ void MarkerManagerPrivate::SetMarker(const ignition::msgs::Marker &_msg,
   }
   // Set Marker Render Type
   ignition::rendering::MarkerType markerType = MsgToType(_msg);
-  _markerPtr->SetType(markerType);
+  if (_markerPtr->Type() != markerType)
+    _markerPtr->SetType(markerType);
 
-  // Set Marker Material
-  if (_msg.has_material())
+  // Set Marker Material, unless it's unchanged
+  if (_msg.has_material() &&
+      !MaterialMatches(_msg, _markerPtr->Material()))
   {
     rendering::MaterialPtr materialPtr = MsgToMaterial(_msg);
     _markerPtr->SetMaterial(materialPtr, true /* clone */);
@@ -482,15 +501,21 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
               std::dynamic_pointer_cast<ignition::rendering::Marker>
               (visualIter->second->GeometryByIndex(0));
 
-        visualIter->second->RemoveGeometryByIndex(0);
-
         // Set the visual values from the Marker Message
         this->SetVisual(_msg, visualIter->second);
 
-        // Set the marker values from the Marker Message
-        this->SetMarker(_msg, markerPtr);
-
-        visualIter->second->AddGeometry(markerPtr);
+        // The marker's points are rewritten in place. Changing its type
+        // recreates its renderable, which must then be attached again.
+        if (markerPtr->Type() != this->MsgToType(_msg))
+        {
+          visualIter->second->RemoveGeometryByIndex(0);
+          this->SetMarker(_msg, markerPtr);
+          visualIter->second->AddGeometry(markerPtr);
+        }
+        else
+        {
+          this->SetMarker(_msg, markerPtr);
+        }
       }
     }
     // Otherwise create a new marker
@@ -614,7 +639,7 @@ bool MarkerManagerPrivate::OnList(ignition::msgs::Marker_V &_rep)
 void MarkerManagerPrivate::OnMarkerMsg(const ignition::msgs::Marker &_req)
 {
   std::lock_guard<std::mutex> lock(this->mutex);
-  this->markerMsgs.push_back(_req);
+  this->QueueMarkerMsg(_req);
 }
 
 /////////////////////////////////////////////////
@@ -622,8 +647,71 @@ bool MarkerManagerPrivate::OnMarkerMsgArray(
     const ignition::msgs::Marker_V&_req, ignition::msgs::Boolean &_res)
 {
   std::lock_guard<std::mutex> lock(this->mutex);
-  std::copy(_req.marker().begin(), _req.marker().end(),
-            std::back_inserter(this->markerMsgs));
+  for (const auto &marker : _req.marker())
+    this->QueueMarkerMsg(marker);
   _res.set_data(true);
   return true;
 }
+
+/////////////////////////////////////////////////
+void MarkerManagerPrivate::QueueMarkerMsg(const ignition::msgs::Marker &_msg)
+{
+  // Markers without an id get a new one each time
+  if (_msg.id() == 0)
+  {
+    this->markerMsgs.push_back(_msg);
+    return;
+  }
+
+  // Messages queued before deleting all markers must be processed first
+  if (_msg.action() == ignition::msgs::Marker::DELETE_ALL)
+  {
+    this->markerMsgs.push_back(_msg);
+    this->queuedMarkers.clear();
+    return;
+  }
+
+  const auto key = std::make_pair(_msg.ns(), _msg.id());
+  auto queued = this->queuedMarkers.find(key);
+  if (queued == this->queuedMarkers.end() ||
+      queued->second->action() != ignition::msgs::Marker::ADD_MODIFY ||
+      _msg.action() != ignition::msgs::Marker::ADD_MODIFY)
+  {
+    this->markerMsgs.push_back(_msg);
+    this->queuedMarkers[key] = std::prev(this->markerMsgs.end());
+    return;
+  }
+
+  // Processing both messages in order is the same as processing the new
+  // one, with the optional fields it lacks taken from the queued one
+  auto &merged = *queued->second;
+  ignition::msgs::Marker previous = std::move(merged);
+  merged = _msg;
+  if (merged.type() == ignition::msgs::Marker::NONE)
+    merged.set_type(previous.type());
+  if (!merged.has_pose() && previous.has_pose())
+    *merged.mutable_pose() = previous.pose();
+  if (!merged.has_scale() && previous.has_scale())
+    *merged.mutable_scale() = previous.scale();
+  if (!merged.has_material() && previous.has_material())
+    *merged.mutable_material() = previous.material();
+  if (merged.parent().empty())
+    merged.set_parent(previous.parent());
+  if (merged.point().empty())
+    *merged.mutable_point() = previous.point();
+}
+
+/////////////////////////////////////////////////
+bool MarkerManagerPrivate::MaterialMatches(const ignition::msgs::Marker &_msg,
+    const rendering::MaterialPtr &_material)
+{
+  if (!_material)
+    return false;
+
+  const auto &mat = _msg.material();
+  return _material->Ambient() == msgs::Convert(mat.ambient()) &&
+      _material->Diffuse() == msgs::Convert(mat.diffuse()) &&
+      _material->Specular() == msgs::Convert(mat.specular()) &&
+      _material->Emissive() == msgs::Convert(mat.emissive()) &&
+      _material->LightingEnabled() == mat.lighting();
+}
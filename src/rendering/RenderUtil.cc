@@ -15,10 +15,14 @@
  *
  */
 
+#include <chrono>
+#include <deque>
+#include <iterator>
 #include <map>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 #include <vector>
 
@@ -87,6 +91,89 @@
 using namespace ignition;
 using namespace gazebo;
 
+namespace
+{
+/// \brief Poses of entities, stored in a flat array indexed by entity id.
+/// Entity ids are small consecutive integers, so setting a pose doesn't hash
+/// or allocate once an entity was seen, and clearing only touches the
+/// entities which were set.
+class EntityPoses
+{
+  /// \brief Set the pose of an entity.
+  /// \param[in] _entity Entity.
+  /// \param[in] _pose Pose.
+  public: void Set(Entity _entity, const math::Pose3d &_pose)
+  {
+    if (_entity >= this->poses.size())
+    {
+      this->poses.resize(_entity + 1);
+      this->isSet.resize(_entity + 1, false);
+    }
+    if (!this->isSet[_entity])
+    {
+      this->isSet[_entity] = true;
+      this->entities.push_back(_entity);
+    }
+    this->poses[_entity] = _pose;
+  }
+
+  /// \brief Get the pose of an entity.
+  /// \param[in] _entity Entity.
+  /// \return The pose, or nullptr if not set.
+  public: const math::Pose3d *Find(Entity _entity) const
+  {
+    if (_entity >= this->isSet.size() || !this->isSet[_entity])
+      return nullptr;
+    return &this->poses[_entity];
+  }
+
+  /// \brief Entities whose pose is set, in the order they were first set.
+  /// \return The entities.
+  public: const std::vector<Entity> &Entities() const
+  {
+    return this->entities;
+  }
+
+  /// \brief Move the poses of some entities into other poses.
+  /// \param[in] _entities Entities to be moved.
+  /// \param[out] _into Poses which receive them.
+  public: void Extract(const std::unordered_set<Entity> &_entities,
+      EntityPoses &_into)
+  {
+    if (_entities.empty())
+      return;
+
+    auto extracted = [&](Entity _entity)
+    {
+      if (_entities.find(_entity) == _entities.end())
+        return false;
+      _into.Set(_entity, this->poses[_entity]);
+      this->isSet[_entity] = false;
+      return true;
+    };
+    this->entities.erase(std::remove_if(this->entities.begin(),
+        this->entities.end(), extracted), this->entities.end());
+  }
+
+  /// \brief Unset all poses. Memory is kept for the next poses.
+  public: void Clear()
+  {
+    for (auto entity : this->entities)
+      this->isSet[entity] = false;
+    this->entities.clear();
+  }
+
+  /// \brief Poses, indexed by entity.
+  private: std::vector<math::Pose3d> poses;
+
+  /// \brief Whether the pose at each index is set.
+  private: std::vector<bool> isSet;
+
+  /// \brief Entities whose pose is set.
+  private: std::vector<Entity> entities;
+};
+}
+
 // Private data class.
 class ignition::gazebo::RenderUtilPrivate
 {
@@ -107,6 +194,13 @@ class ignition::gazebo::RenderUtilPrivate
   /// \param[in] _ecm The entity-component manager
   public: void UpdateRenderingEntities(const EntityComponentManager &_ecm);
 
+  /// \brief Queue the temperature of a visual to be sent to the rendering
+  /// engine, if it has a uniform temperature or a heat signature.
+  /// \param[in] _ecm The entity-component manager
+  /// \param[in] _entity Visual entity
+  public: void UpdateTemperature(const EntityComponentManager &_ecm,
+      const Entity _entity);
+
   /// \brief Total time elapsed in simulation. This will not increase while
   /// paused.
   public: std::chrono::steady_clock::duration simTime{0};
@@ -183,8 +277,12 @@ class ignition::gazebo::RenderUtilPrivate
   /// remove request is received
   public: std::unordered_map<Entity, uint64_t> removeEntities;
 
-  /// \brief A map of entity ids and pose updates.
-  public: std::unordered_map<Entity, math::Pose3d> entityPoses;
+  /// \brief Pose updates received from the ECM.
+  public: EntityPoses entityPoses;
+
+  /// \brief Pose updates being applied by the render thread. Swapped with
+  /// entityPoses on each Update, so their memory is reused.
+  public: EntityPoses renderPoses;
 
   /// \brief A map of entity ids and light updates.
   public: std::unordered_map<Entity, msgs::Light> entityLights;
@@ -320,8 +418,133 @@ class ignition::gazebo::RenderUtilPrivate
   /// <resolution, temperature range (min, max)>
   public:std::unordered_map<Entity,
       std::tuple<double, components::TemperatureRangeInfo>> thermalCameraData;
+
+  /// \brief Create queued entities from the front of a queue until it's
+  /// empty or the creation budget runs out.
+  /// \param[in] _queue Queue of entities, the entity id being the first
+  /// element of each tuple.
+  /// \param[in] _create Function which creates one entity.
+  /// \param[in] _deadline Time when the creation budget runs out.
+  /// \return True if the queue is empty.
+  public: template <typename Queue, typename Create>
+          bool CreatePending(Queue &_queue, Create _create,
+              const std::chrono::steady_clock::time_point &_deadline);
+
+  /// \brief Hold back updates to entities which haven't been created yet,
+  /// so they're applied once the entity exists. Updates held back on
+  /// previous frames are merged in first, newer values replacing them.
+  /// \param[in,out] _updates Updates received for this frame.
+  /// \param[in,out] _deferred Updates held back.
+  public: template <typename Map>
+          void DeferPendingUpdates(Map &_updates, Map &_deferred) const;
+
+  /// \brief Time each call to Update may spend creating entities. Zero
+  /// means no limit.
+  public: std::chrono::steady_clock::duration creationBudget{0};
+
+  /// \brief Models waiting to be created on the render thread, in the order
+  /// they were received. Only accessed by the render thread, the same goes
+  /// for the rest of the pending queues and deferred updates.
+  public: std::deque<std::tuple<Entity, sdf::Model, Entity, uint64_t>>
+      pendingModels;
+
+  /// \brief Links waiting to be created.
+  public: std::deque<std::tuple<Entity, sdf::Link, Entity>> pendingLinks;
+
+  /// \brief Visuals waiting to be created.
+  public: std::deque<std::tuple<Entity, sdf::Visual, Entity>> pendingVisuals;
+
+  /// \brief Actors waiting to be created.
+  public: std::deque<std::tuple<Entity, sdf::Actor, Entity>> pendingActors;
+
+  /// \brief Lights waiting to be created.
+  public: std::deque<std::tuple<Entity, sdf::Light, Entity>> pendingLights;
+
+  /// \brief Particle emitters waiting to be created.
+  public: std::deque<std::tuple<Entity, msgs::ParticleEmitter, Entity>>
+      pendingParticleEmitters;
+
+  /// \brief Ids of all entities in the pending queues.
+  public: std::unordered_set<Entity> pendingEntities;
+
+  /// \brief Pose updates held back until their entities are created.
+  public: EntityPoses deferredPoses;
+
+  /// \brief Light updates held back until their entities are created.
+  public: std::unordered_map<Entity, msgs::Light> deferredLights;
+
+  /// \brief Particle emitter commands held back until their entities are
+  /// created.
+  public: std::unordered_map<Entity, msgs::ParticleEmitter>
+      deferredParticleEmittersCmds;
+
+  /// \brief Trajectory poses held back until their entities are created.
+  public: std::unordered_map<Entity, math::Pose3d> deferredTrajectoryPoses;
+
+  /// \brief Actor transforms held back until their entities are created.
+  public: std::map<Entity, std::map<std::string, math::Matrix4d>>
+      deferredActorTransforms;
+
+  /// \brief Actor animations held back until their entities are created.
+  public: std::unordered_map<Entity, AnimationUpdateData>
+      deferredActorAnimationData;
+
+  /// \brief Temperatures held back until their entities are created.
+  public: std::map<Entity, std::tuple<float, float, std::string>>
+      deferredTemp;
+
+  /// \brief Thermal camera properties held back until their entities are
+  /// created.
+  public: std::unordered_map<Entity,
+      std::tuple<double, components::TemperatureRangeInfo>>
+      deferredThermalCameraData;
 };
 
+//////////////////////////////////////////////////
+template <typename Queue, typename Create>
+bool RenderUtilPrivate::CreatePending(Queue &_queue, Create _create,
+    const std::chrono::steady_clock::time_point &_deadline)
+{
+  while (!_queue.empty())
+  {
+    if (this->creationBudget > std::chrono::steady_clock::duration::zero() &&
+        std::chrono::steady_clock::now() >= _deadline)
+    {
+      return false;
+    }
+    _create(_queue.front());
+    this->pendingEntities.erase(std::get<0>(_queue.front()));
+    _queue.pop_front();
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+template <typename Map>
+void RenderUtilPrivate::DeferPendingUpdates(Map &_updates,
+    Map &_deferred) const
+{
+  for (auto &it : _deferred)
+    _updates.try_emplace(it.first, std::move(it.second));
+  _deferred.clear();
+
+  if (this->pendingEntities.empty())
+    return;
+
+  for (auto it = _updates.begin(); it != _updates.end();)
+  {
+    if (this->pendingEntities.find(it->first) != this->pendingEntities.end())
+    {
+      _deferred.emplace(it->first, std::move(it->second));
+      it = _updates.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 RenderUtil::RenderUtil() : dataPtr(std::make_unique<RenderUtilPrivate>())
 {
@@ -521,7 +744,8 @@ void RenderUtil::Update()
   auto newParticleEmittersCmds =
     std::move(this->dataPtr->newParticleEmittersCmds);
   auto removeEntities = std::move(this->dataPtr->removeEntities);
-  auto entityPoses = std::move(this->dataPtr->entityPoses);
+  std::swap(this->dataPtr->entityPoses, this->dataPtr->renderPoses);
+  auto &entityPoses = this->dataPtr->renderPoses;
   auto entityLights = std::move(this->dataPtr->entityLights);
   auto trajectoryPoses = std::move(this->dataPtr->trajectoryPoses);
   auto actorTransforms = std::move(this->dataPtr->actorTransforms);
@@ -539,7 +763,7 @@ void RenderUtil::Update()
   this->dataPtr->newParticleEmitters.clear();
   this->dataPtr->newParticleEmittersCmds.clear();
   this->dataPtr->removeEntities.clear();
-  this->dataPtr->entityPoses.clear();
+  this->dataPtr->entityPoses.Clear();
   this->dataPtr->entityLights.clear();
   this->dataPtr->trajectoryPoses.clear();
   this->dataPtr->actorTransforms.clear();
@@ -558,6 +782,22 @@ void RenderUtil::Update()
   }
   this->dataPtr->updateMutex.unlock();
 
+  // Queue new entities behind the ones which didn't fit in previous frames
+  auto enqueue = [this](auto &_queue, auto &_entities)
+  {
+    for (auto &entity : _entities)
+    {
+      this->dataPtr->pendingEntities.insert(std::get<0>(entity));
+      _queue.push_back(std::move(entity));
+    }
+  };
+  enqueue(this->dataPtr->pendingModels, newModels);
+  enqueue(this->dataPtr->pendingLinks, newLinks);
+  enqueue(this->dataPtr->pendingVisuals, newVisuals);
+  enqueue(this->dataPtr->pendingActors, newActors);
+  enqueue(this->dataPtr->pendingLights, newLights);
+  enqueue(this->dataPtr->pendingParticleEmitters, newParticleEmitters);
+
   // scene - only one scene is supported for now
   // extend the sensor system to support mutliple scenes in the future
   for (auto &scene : newScenes)
@@ -590,61 +830,139 @@ void RenderUtil::Update()
         this->dataPtr->sensorEntities.erase(sensorEntityIt);
       }
     }
-  }
 
-  // create new entities
-  {
-    IGN_PROFILE("RenderUtil::Update Create");
-    for (const auto &model : newModels)
+    // Drop entities removed before they were created. Since entites to be
+    // created and removed are queued, the creation timestamp of models is
+    // checked to make sure we do not drop a new entity when there is also a
+    // remove request with a more recent timestamp
+    // \todo(anyone) add test to check scene entities are properly added
+    // and removed.
+    if (!removeEntities.empty() && !this->dataPtr->pendingEntities.empty())
     {
-      uint64_t iteration = std::get<3>(model);
-      Entity entityId = std::get<0>(model);
-      // since entites to be created and removed are queued, we need
-      // to check their creation timestamp to make sure we do not create a new
-      // entity when there is also a remove request with a more recent
-      // timestamp
-      // \todo(anyone) add test to check scene entities are properly added
-      // and removed.
-      auto removeIt = removeEntities.find(entityId);
-      if (removeIt != removeEntities.end())
+      auto removed = [&](const auto &_entity)
       {
-        uint64_t removeIteration = removeIt->second;
-        if (iteration < removeIteration)
-          continue;
-      }
-      this->dataPtr->sceneManager.CreateModel(
-          entityId, std::get<1>(model), std::get<2>(model));
-    }
-
-    for (const auto &link : newLinks)
-    {
-      this->dataPtr->sceneManager.CreateLink(
-          std::get<0>(link), std::get<1>(link), std::get<2>(link));
+        return removeEntities.find(std::get<0>(_entity)) !=
+            removeEntities.end();
+      };
+      auto drop = [&](auto &_queue, auto _removed)
+      {
+        _queue.erase(std::remove_if(_queue.begin(), _queue.end(), _removed),
+            _queue.end());
+      };
+      drop(this->dataPtr->pendingModels, [&](const auto &_model)
+          {
+            auto removeIt = removeEntities.find(std::get<0>(_model));
+            return removeIt != removeEntities.end() &&
+                std::get<3>(_model) < removeIt->second;
+          });
+      drop(this->dataPtr->pendingLinks, removed);
+      drop(this->dataPtr->pendingVisuals, removed);
+      drop(this->dataPtr->pendingActors, removed);
+      drop(this->dataPtr->pendingLights, removed);
+      drop(this->dataPtr->pendingParticleEmitters, removed);
+
+      this->dataPtr->pendingEntities.clear();
+      auto track = [this](const auto &_queue)
+      {
+        for (const auto &entity : _queue)
+          this->dataPtr->pendingEntities.insert(std::get<0>(entity));
+      };
+      track(this->dataPtr->pendingModels);
+      track(this->dataPtr->pendingLinks);
+      track(this->dataPtr->pendingVisuals);
+      track(this->dataPtr->pendingActors);
+      track(this->dataPtr->pendingLights);
+      track(this->dataPtr->pendingParticleEmitters);
     }
+  }
 
-    for (const auto &visual : newVisuals)
-    {
-      this->dataPtr->sceneManager.CreateVisual(
-          std::get<0>(visual), std::get<1>(visual), std::get<2>(visual));
-    }
+  // create new entities, parents before children, until the budget runs out
+  {
+    IGN_PROFILE("RenderUtil::Update Create");
+    const auto deadline =
+        std::chrono::steady_clock::now() + this->dataPtr->creationBudget;
+    auto &sceneManager = this->dataPtr->sceneManager;
+    const bool created =
+        this->dataPtr->CreatePending(this->dataPtr->pendingModels,
+          [&](const auto &_model)
+          {
+            sceneManager.CreateModel(std::get<0>(_model),
+                std::get<1>(_model), std::get<2>(_model));
+          }, deadline) &&
+        this->dataPtr->CreatePending(this->dataPtr->pendingLinks,
+          [&](const auto &_link)
+          {
+            sceneManager.CreateLink(std::get<0>(_link), std::get<1>(_link),
+                std::get<2>(_link));
+          }, deadline) &&
+        this->dataPtr->CreatePending(this->dataPtr->pendingVisuals,
+          [&](const auto &_visual)
+          {
+            sceneManager.CreateVisual(std::get<0>(_visual),
+                std::get<1>(_visual), std::get<2>(_visual));
+          }, deadline) &&
+        this->dataPtr->CreatePending(this->dataPtr->pendingActors,
+          [&](const auto &_actor)
+          {
+            sceneManager.CreateActor(std::get<0>(_actor),
+                std::get<1>(_actor), std::get<2>(_actor));
+          }, deadline) &&
+        this->dataPtr->CreatePending(this->dataPtr->pendingLights,
+          [&](const auto &_light)
+          {
+            sceneManager.CreateLight(std::get<0>(_light),
+                std::get<1>(_light), std::get<2>(_light));
+          }, deadline) &&
+        this->dataPtr->CreatePending(this->dataPtr->pendingParticleEmitters,
+          [&](const auto &_emitter)
+          {
+            sceneManager.CreateParticleEmitter(std::get<0>(_emitter),
+                std::get<1>(_emitter), std::get<2>(_emitter));
+          }, deadline);
 
-    for (const auto &actor : newActors)
+    // Meshes loaded by worker threads share the same budget
+    if (sceneManager.AsyncMeshLoading())
     {
-      this->dataPtr->sceneManager.CreateActor(
-          std::get<0>(actor), std::get<1>(actor), std::get<2>(actor));
+      sceneManager.AttachLoadedMeshes(
+          this->dataPtr->creationBudget >
+          std::chrono::steady_clock::duration::zero() ?
+          deadline : std::chrono::steady_clock::time_point::max());
     }
 
-    for (const auto &light : newLights)
+    // Sensors are attached to the entities above, so they wait until all of
+    // those are created
+    if (!created && !newSensors.empty())
     {
-      this->dataPtr->sceneManager.CreateLight(
-          std::get<0>(light), std::get<1>(light), std::get<2>(light));
+      std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
+      this->dataPtr->newSensors.insert(this->dataPtr->newSensors.begin(),
+          std::make_move_iterator(newSensors.begin()),
+          std::make_move_iterator(newSensors.end()));
+      newSensors.clear();
     }
 
-    for (const auto &emitter : newParticleEmitters)
+    // Updates to entities which are still queued are applied once they exist
+    for (auto entity : this->dataPtr->deferredPoses.Entities())
     {
-      this->dataPtr->sceneManager.CreateParticleEmitter(
-          std::get<0>(emitter), std::get<1>(emitter), std::get<2>(emitter));
+      if (!entityPoses.Find(entity))
+        entityPoses.Set(entity, *this->dataPtr->deferredPoses.Find(entity));
     }
+    this->dataPtr->deferredPoses.Clear();
+    entityPoses.Extract(this->dataPtr->pendingEntities,
+        this->dataPtr->deferredPoses);
+    this->dataPtr->DeferPendingUpdates(entityLights,
+        this->dataPtr->deferredLights);
+    this->dataPtr->DeferPendingUpdates(newParticleEmittersCmds,
+        this->dataPtr->deferredParticleEmittersCmds);
+    this->dataPtr->DeferPendingUpdates(trajectoryPoses,
+        this->dataPtr->deferredTrajectoryPoses);
+    this->dataPtr->DeferPendingUpdates(actorTransforms,
+        this->dataPtr->deferredActorTransforms);
+    this->dataPtr->DeferPendingUpdates(actorAnimationData,
+        this->dataPtr->deferredActorAnimationData);
+    this->dataPtr->DeferPendingUpdates(entityTemp,
+        this->dataPtr->deferredTemp);
+    this->dataPtr->DeferPendingUpdates(thermalCameraData,
+        this->dataPtr->deferredThermalCameraData);
 
     for (const auto &emitterCmd : newParticleEmittersCmds)
     {
@@ -777,9 +1095,9 @@ void RenderUtil::Update()
   // update entities' pose
   {
     IGN_PROFILE("RenderUtil::Update Poses");
-    for (const auto &pose : entityPoses)
+    for (auto entity : entityPoses.Entities())
     {
-      auto node = this->dataPtr->sceneManager.NodeById(pose.first);
+      auto node = this->dataPtr->sceneManager.NodeById(entity);
       if (!node)
         continue;
 
@@ -798,14 +1116,14 @@ void RenderUtil::Update()
         entityId = std::get<int>(vis->UserData("gazebo-entity"));
       }
       if ((this->dataPtr->transformActive &&
-          (pose.first == this->dataPtr->selectedEntities.back() ||
+          (entity == this->dataPtr->selectedEntities.back() ||
           entityId == this->dataPtr->selectedEntities.back())) ||
           updateNode)
       {
         continue;
       }
 
-      node->SetLocalPose(pose.second);
+      node->SetLocalPose(*entityPoses.Find(entity));
     }
 
     // update entities' local transformations
@@ -823,9 +1141,9 @@ void RenderUtil::Update()
         }
 
         math::Pose3d globalPose;
-        if (entityPoses.find(tf.first) != entityPoses.end())
+        if (auto pose = entityPoses.Find(tf.first))
         {
-          globalPose = entityPoses[tf.first];
+          globalPose = *pose;
         }
 
         math::Pose3d trajPose;
@@ -916,9 +1234,9 @@ void RenderUtil::Update()
 
         // update actor trajectory animation
         math::Pose3d globalPose;
-        if (entityPoses.find(it.first) != entityPoses.end())
+        if (auto pose = entityPoses.Find(it.first))
         {
-          globalPose = entityPoses[it.first];
+          globalPose = *pose;
         }
 
         math::Pose3d trajPose;
@@ -1003,7 +1321,7 @@ void RenderUtil::Update()
   }
 
   // update thermal camera
-  for (const auto &thermal : this->dataPtr->thermalCameraData)
+  for (const auto &thermal : thermalCameraData)
   {
     Entity id = thermal.first;
     rendering::ThermalCameraPtr camera =
@@ -1162,30 +1480,7 @@ void RenderUtilPrivate::CreateRenderingEntities(
             visual.SetLaserRetro(laserRetro->Data());
           }
 
-          if (auto temp = _ecm.Component<components::Temperature>(_entity))
-          {
-            // get the uniform temperature for the entity
-            this->entityTemp[_entity] =
-              std::make_tuple<float, float, std::string>(
-                  temp->Data().Kelvin(), 0.0, "");
-          }
-          else
-          {
-            // entity doesn't have a uniform temperature. Check if it has
-            // a heat signature with an associated temperature range
-            auto heatSignature =
-              _ecm.Component<components::SourceFilePath>(_entity);
-            auto tempRange =
-               _ecm.Component<components::TemperatureRange>(_entity);
-            if (heatSignature && tempRange)
-            {
-              this->entityTemp[_entity] =
-                std::make_tuple<float, float, std::string>(
-                    tempRange->Data().min.Kelvin(),
-                    tempRange->Data().max.Kelvin(),
-                    std::string(heatSignature->Data()));
-            }
-          }
+          this->UpdateTemperature(_ecm, _entity);
 
           this->newVisuals.push_back(
               std::make_tuple(_entity, visual, _parent->Data()));
@@ -1390,30 +1685,7 @@ void RenderUtilPrivate::CreateRenderingEntities(
             visual.SetLaserRetro(laserRetro->Data());
           }
 
-          if (auto temp = _ecm.Component<components::Temperature>(_entity))
-          {
-            // get the uniform temperature for the entity
-            this->entityTemp[_entity] =
-              std::make_tuple<float, float, std::string>(
-                  temp->Data().Kelvin(), 0.0, "");
-          }
-          else
-          {
-            // entity doesn't have a uniform temperature. Check if it has
-            // a heat signature with an associated temperature range
-            auto heatSignature =
-              _ecm.Component<components::SourceFilePath>(_entity);
-            auto tempRange =
-               _ecm.Component<components::TemperatureRange>(_entity);
-            if (heatSignature && tempRange)
-            {
-              this->entityTemp[_entity] =
-                std::make_tuple<float, float, std::string>(
-                    tempRange->Data().min.Kelvin(),
-                    tempRange->Data().max.Kelvin(),
-                    std::string(heatSignature->Data()));
-            }
-          }
+          this->UpdateTemperature(_ecm, _entity);
 
           this->newVisuals.push_back(
               std::make_tuple(_entity, visual, _parent->Data()));
@@ -1540,7 +1812,7 @@ void RenderUtilPrivate::UpdateRenderingEntities(
         const components::Model *,
         const components::Pose *_pose)->bool
       {
-        this->entityPoses[_entity] = _pose->Data();
+        this->entityPoses.Set(_entity, _pose->Data());
         return true;
       });
 
@@ -1549,7 +1821,7 @@ void RenderUtilPrivate::UpdateRenderingEntities(
         const components::Link *,
         const components::Pose *_pose)->bool
       {
-        this->entityPoses[_entity] = _pose->Data();
+        this->entityPoses.Set(_entity, _pose->Data());
         return true;
       });
 
@@ -1559,7 +1831,7 @@ void RenderUtilPrivate::UpdateRenderingEntities(
         const components::Visual *,
         const components::Pose *_pose)->bool
       {
-        this->entityPoses[_entity] = _pose->Data();
+        this->entityPoses.Set(_entity, _pose->Data());
         return true;
       });
 
@@ -1570,7 +1842,7 @@ void RenderUtilPrivate::UpdateRenderingEntities(
         const components::Pose *_pose)->bool
       {
         // Trajectory origin
-        this->entityPoses[_entity] = _pose->Data();
+        this->entityPoses.Set(_entity, _pose->Data());
 
         auto animTimeComp = _ecm.Component<components::AnimationTime>(_entity);
         auto animNameComp = _ecm.Component<components::AnimationName>(_entity);
@@ -1619,7 +1891,7 @@ void RenderUtilPrivate::UpdateRenderingEntities(
         const components::Light *,
         const components::Pose *_pose)->bool
       {
-        this->entityPoses[_entity] = _pose->Data();
+        this->entityPoses.Set(_entity, _pose->Data());
         return true;
       });
 
@@ -1629,7 +1901,7 @@ void RenderUtilPrivate::UpdateRenderingEntities(
         const components::Camera *,
         const components::Pose *_pose)->bool
       {
-        this->entityPoses[_entity] = _pose->Data();
+        this->entityPoses.Set(_entity, _pose->Data());
         return true;
       });
 
@@ -1639,7 +1911,7 @@ void RenderUtilPrivate::UpdateRenderingEntities(
         const components::DepthCamera *,
         const components::Pose *_pose)->bool
       {
-        this->entityPoses[_entity] = _pose->Data();
+        this->entityPoses.Set(_entity, _pose->Data());
         return true;
       });
 
@@ -1649,7 +1921,7 @@ void RenderUtilPrivate::UpdateRenderingEntities(
         const components::RgbdCamera *,
         const components::Pose *_pose)->bool
       {
-        this->entityPoses[_entity] = _pose->Data();
+        this->entityPoses.Set(_entity, _pose->Data());
         return true;
       });
 
@@ -1659,7 +1931,7 @@ void RenderUtilPrivate::UpdateRenderingEntities(
         const components::GpuLidar *,
         const components::Pose *_pose)->bool
       {
-        this->entityPoses[_entity] = _pose->Data();
+        this->entityPoses.Set(_entity, _pose->Data());
         return true;
       });
 
@@ -1669,9 +1941,51 @@ void RenderUtilPrivate::UpdateRenderingEntities(
         const components::ThermalCamera *,
         const components::Pose *_pose)->bool
       {
-        this->entityPoses[_entity] = _pose->Data();
+        this->entityPoses.Set(_entity, _pose->Data());
         return true;
       });
+
+  // Temperatures are stored in the visuals, so they only need to be sent
+  // again when they change
+  auto updateTemperature = [&](const Entity &_entity, const auto *,
+      ComponentState) -> bool
+  {
+    if (_ecm.Component<components::Visual>(_entity))
+      this->UpdateTemperature(_ecm, _entity);
+    return true;
+  };
+  _ecm.EachChanged<components::Temperature>(updateTemperature);
+  _ecm.EachChanged<components::TemperatureRange>(updateTemperature);
+}
+
+//////////////////////////////////////////////////
+void RenderUtilPrivate::UpdateTemperature(const EntityComponentManager &_ecm,
+    const Entity _entity)
+{
+  if (auto temp = _ecm.Component<components::Temperature>(_entity))
+  {
+    // get the uniform temperature for the entity
+    this->entityTemp[_entity] =
+      std::make_tuple<float, float, std::string>(
+          temp->Data().Kelvin(), 0.0, "");
+  }
+  else
+  {
+    // entity doesn't have a uniform temperature. Check if it has
+    // a heat signature with an associated temperature range
+    auto heatSignature =
+      _ecm.Component<components::SourceFilePath>(_entity);
+    auto tempRange =
+       _ecm.Component<components::TemperatureRange>(_entity);
+    if (heatSignature && tempRange)
+    {
+      this->entityTemp[_entity] =
+        std::make_tuple<float, float, std::string>(
+            tempRange->Data().min.Kelvin(),
+            tempRange->Data().max.Kelvin(),
+            std::string(heatSignature->Data()));
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -1971,6 +2285,13 @@ void RenderUtil::SetTransformActive(bool _active)
   this->dataPtr->transformActive = _active;
 }
 
+////////////////////////////////////////////////
+void RenderUtil::SetCreationBudget(
+    const std::chrono::steady_clock::duration &_budget)
+{
+  this->dataPtr->creationBudget = _budget;
+}
+
 ////////////////////////////////////////////////
 void RenderUtilPrivate::HighlightNode(const rendering::NodePtr &_node)
 {
@@ -16,7 +16,23 @@
  */
 
 
+#include <google/protobuf/util/message_differencer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <limits>
 #include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
 
 #include <sdf/Box.hh>
 #include <sdf/Collision.hh>
@@ -29,12 +45,14 @@
 #include <ignition/common/Animation.hh>
 #include <ignition/common/Console.hh>
 #include <ignition/common/KeyFrame.hh>
+#include <ignition/common/Mesh.hh>
 #include <ignition/common/MeshManager.hh>
 #include <ignition/common/Skeleton.hh>
 #include <ignition/common/SkeletonAnimation.hh>
 
 #include <ignition/msgs/Utility.hh>
 
+#include <ignition/rendering/Camera.hh>
 #include <ignition/rendering/Geometry.hh>
 #include <ignition/rendering/Light.hh>
 #include <ignition/rendering/Material.hh>
@@ -76,6 +94,22 @@ class ignition::gazebo::SceneManagerPrivate
   public: std::map<Entity, std::vector<common::TrajectoryInfo>>
                     actorTrajectories;
 
+  /// \brief Key of a skeleton animation evaluation: the skeleton, the
+  /// animation index, whether it's evaluated at a distance along X rather
+  /// than at a time, that distance or time, and whether it loops.
+  public: using SkeletonPoseKey =
+      std::tuple<const common::Skeleton *, unsigned int, bool, double, bool>;
+
+  /// \brief Skeleton animation evaluations, with the skin space transform
+  /// of each node sorted by node name. Shared by all actors which play the
+  /// same animation at the same time.
+  public: std::map<SkeletonPoseKey,
+      std::vector<std::pair<std::string, math::Matrix4d>>> skeletonPoseCache;
+
+  /// \brief Sim time for which skeletonPoseCache was computed.
+  public: std::chrono::steady_clock::duration skeletonPoseCacheTime{
+      std::chrono::steady_clock::duration::min()};
+
   /// \brief Map of light entity in Gazebo to light pointers.
   public: std::map<Entity, rendering::LightPtr> lights;
 
@@ -83,9 +117,98 @@ class ignition::gazebo::SceneManagerPrivate
   /// rendering pointers.
   public: std::map<Entity, rendering::ParticleEmitterPtr> particleEmitters;
 
+  /// \brief Last data applied to each particle emitter, so that updates
+  /// only touch the properties which changed.
+  public: std::unordered_map<Entity, msgs::ParticleEmitter>
+      particleEmitterMsgs;
+
   /// \brief Map of sensor entity in Gazebo to sensor pointers.
   public: std::map<Entity, rendering::SensorPtr> sensors;
 
+  /// \brief Materials shared by all visuals with the same material.
+  public: struct SharedMaterials
+  {
+    /// \brief Material of the geometry, or one per submesh for meshes
+    /// which use their own materials. Null for submeshes without one.
+    public: std::vector<rendering::MaterialPtr> materials;
+
+    /// \brief Number of visuals using the materials.
+    public: unsigned int users{0};
+  };
+
+  /// \brief Shared materials, keyed by the output of MaterialKey.
+  public: std::unordered_map<std::string, SharedMaterials> sharedMaterials;
+
+  /// \brief Key into sharedMaterials used by each visual entity.
+  public: std::unordered_map<Entity, std::string> visualMaterialKeys;
+
+  /// \brief Get a key which is the same for all visuals that end up with
+  /// identical materials.
+  /// \param[in] _visual Visual sdf dom
+  /// \return Key into sharedMaterials
+  public: std::string MaterialKey(const sdf::Visual &_visual) const;
+
+  /// \brief Stop a visual from using its shared materials, destroying
+  /// them if no other visual uses them.
+  /// \param[in] _id Visual entity
+  public: void ReleaseMaterials(Entity _id);
+
+  /// \brief Bounding sphere of a top level visual used for culling.
+  public: struct CullBounds
+  {
+    /// \brief Center in the visual's frame.
+    public: math::Vector3d center;
+
+    /// \brief Radius, infinite if the visual has no bounding box yet.
+    public: double radius{0.0};
+  };
+
+  /// \brief Bounding spheres of top level visuals, computed the first time
+  /// they're culled.
+  public: std::unordered_map<Entity, CullBounds> cullBounds;
+
+  /// \brief Top level visuals hidden by CullByDistance.
+  public: std::unordered_set<Entity> culledVisuals;
+
+  /// \brief Drop the cached bounds of the top level visual containing a
+  /// visual whose descendants changed, showing it again if it was culled.
+  /// \param[in] _visual Visual which was added
+  public: void ResetCullBounds(const rendering::VisualPtr &_visual);
+
+  /// \brief Visual whose mesh is being loaded by a worker thread.
+  public: struct PendingMeshVisual
+  {
+    /// \brief The visual, which has no geometry yet.
+    public: rendering::VisualPtr visual;
+
+    /// \brief Visual sdf dom.
+    public: sdf::Visual sdf;
+
+    /// \brief Full path of the mesh.
+    public: std::string fullPath;
+  };
+
+  /// \brief Start loading the mesh of a visual on a worker thread, unless
+  /// it's not a mesh, or it's loaded already.
+  /// \param[in] _id Visual entity
+  /// \param[in] _visualVis Visual created for the entity
+  /// \param[in] _visual Visual sdf dom
+  /// \return True if the geometry must wait for the mesh to be loaded.
+  public: bool DeferMesh(Entity _id, const rendering::VisualPtr &_visualVis,
+      const sdf::Visual &_visual);
+
+  /// \brief True to load meshes on worker threads.
+  public: bool asyncMeshLoading{false};
+
+  /// \brief Meshes being parsed by worker threads, keyed by full path. The
+  /// workers don't touch the MeshManager, which isn't thread-safe. The
+  /// meshes are registered with it by AttachLoadedMeshes.
+  public: std::unordered_map<std::string,
+      std::future<std::unique_ptr<common::Mesh>>> meshLoads;
+
+  /// \brief Visuals waiting for their mesh to be loaded.
+  public: std::unordered_map<Entity, PendingMeshVisual> pendingMeshVisuals;
+
   /// \brief Helper function to compute actor trajectory at specified tiime
   /// \param[in] _id Actor entity's unique id
   /// \param[in] _time Simulation time
@@ -224,6 +347,7 @@ rendering::VisualPtr SceneManager::CreateLink(Entity _id,
 
   if (parent)
     parent->AddChild(linkVis);
+  this->dataPtr->ResetCullBounds(linkVis);
 
   return linkVis;
 }
@@ -272,6 +396,24 @@ rendering::VisualPtr SceneManager::CreateVisual(Entity _id,
     visualVis->SetUserData("laser_retro", _visual.LaserRetro());
   }
 
+  if (!this->dataPtr->DeferMesh(_id, visualVis, _visual))
+    this->AttachGeometry(_id, visualVis, _visual);
+
+  // visibility flags
+  visualVis->SetVisibilityFlags(_visual.VisibilityFlags());
+
+  this->dataPtr->visuals[_id] = visualVis;
+  if (parent)
+    parent->AddChild(visualVis);
+  this->dataPtr->ResetCullBounds(visualVis);
+
+  return visualVis;
+}
+
+/////////////////////////////////////////////////
+void SceneManager::AttachGeometry(Entity _id,
+    const rendering::VisualPtr &_visualVis, const sdf::Visual &_visual)
+{
   math::Vector3d scale = math::Vector3d::One;
   math::Pose3d localPose;
   rendering::GeometryPtr geom =
@@ -285,90 +427,168 @@ rendering::VisualPtr SceneManager::CreateVisual(Entity _id,
     if (localPose != math::Pose3d::Zero)
     {
       rendering::VisualPtr geomVis =
-          this->dataPtr->scene->CreateVisual(name + "_geom");
+          this->dataPtr->scene->CreateVisual(_visualVis->Name() + "_geom");
       geomVis->AddGeometry(geom);
       geomVis->SetLocalPose(localPose);
-      visualVis->AddChild(geomVis);
+      _visualVis->AddChild(geomVis);
     }
     else
     {
-      visualVis->AddGeometry(geom);
+      _visualVis->AddGeometry(geom);
     }
 
-    visualVis->SetLocalScale(scale);
+    _visualVis->SetLocalScale(scale);
 
-    // set material
-    rendering::MaterialPtr material{nullptr};
-    if (_visual.Material())
-    {
-      material = this->LoadMaterial(*_visual.Material());
-    }
-    // Don't set a default material for meshes because they
-    // may have their own
-    // TODO(anyone) support overriding mesh material
-    else if (_visual.Geom()->Type() != sdf::GeometryType::MESH)
+    // Visuals with the same material share it instead of each having a
+    // copy, so the render engine can batch and instance identical visuals
+    std::string materialKey = this->dataPtr->MaterialKey(_visual);
+    auto shared = this->dataPtr->sharedMaterials.find(materialKey);
+    auto mesh = std::dynamic_pointer_cast<rendering::Mesh>(geom);
+    bool subMeshMaterials = !_visual.Material() &&
+        _visual.Geom()->Type() == sdf::GeometryType::MESH;
+    if (shared == this->dataPtr->sharedMaterials.end())
     {
-      // create default material
-      material = this->dataPtr->scene->Material("ign-grey");
-      if (!material)
+      SceneManagerPrivate::SharedMaterials newShared;
+
+      // set material
+      rendering::MaterialPtr material{nullptr};
+      if (_visual.Material())
+      {
+        material = this->LoadMaterial(*_visual.Material());
+      }
+      // Don't set a default material for meshes because they
+      // may have their own
+      // TODO(anyone) support overriding mesh material
+      else if (!subMeshMaterials)
       {
-        material = this->dataPtr->scene->CreateMaterial("ign-grey");
+        // create default material
+        material = this->dataPtr->scene->CreateMaterial();
         material->SetAmbient(0.3, 0.3, 0.3);
         material->SetDiffuse(0.7, 0.7, 0.7);
         material->SetSpecular(1.0, 1.0, 1.0);
         material->SetRoughness(0.2);
         material->SetMetalness(1.0);
       }
-    }
-    else
-    {
-      // meshes created by mesh loader may have their own materials
-      // update/override their properties based on input sdf element values
-      auto mesh = std::dynamic_pointer_cast<rendering::Mesh>(geom);
-      for (unsigned int i = 0; i < mesh->SubMeshCount(); ++i)
+      else
       {
-        auto submesh = mesh->SubMeshByIndex(i);
-        auto submeshMat = submesh->Material();
-        if (submeshMat)
+        // meshes created by mesh loader may have their own materials
+        // update/override their properties based on input sdf element values
+        for (unsigned int i = 0; i < mesh->SubMeshCount(); ++i)
         {
-          double productAlpha = (1.0-_visual.Transparency()) *
-              (1.0 - submeshMat->Transparency());
-          submeshMat->SetTransparency(1 - productAlpha);
-          submeshMat->SetCastShadows(_visual.CastShadows());
+          auto submesh = mesh->SubMeshByIndex(i);
+          auto submeshMat = submesh->Material();
+          if (submeshMat)
+          {
+            double productAlpha = (1.0-_visual.Transparency()) *
+                (1.0 - submeshMat->Transparency());
+            submeshMat->SetTransparency(1 - productAlpha);
+            submeshMat->SetCastShadows(_visual.CastShadows());
+
+            // The submesh owns its material, and would destroy it with
+            // this visual
+            submeshMat = submeshMat->Clone();
+          }
+          newShared.materials.push_back(submeshMat);
         }
       }
+
+      if (material)
+      {
+        // set transparency
+        material->SetTransparency(_visual.Transparency());
+
+        // cast shadows
+        material->SetCastShadows(_visual.CastShadows());
+
+        newShared.materials.push_back(material);
+      }
+
+      shared = this->dataPtr->sharedMaterials.emplace(materialKey,
+          std::move(newShared)).first;
     }
 
-    if (material)
+    const auto &materials = shared->second.materials;
+    if (subMeshMaterials)
     {
-      // set transparency
-      material->SetTransparency(_visual.Transparency());
-
-      // cast shadows
-      material->SetCastShadows(_visual.CastShadows());
-
-      geom->SetMaterial(material);
-      // todo(anyone) SetMaterial function clones the input material.
-      // but does not take ownership of it so we need to destroy it here.
-      // This is not ideal. We should let ign-rendering handle the lifetime
-      // of this material
-      this->dataPtr->scene->DestroyMaterial(material);
+      for (unsigned int i = 0;
+           i < mesh->SubMeshCount() && i < materials.size(); ++i)
+      {
+        if (materials[i])
+          mesh->SubMeshByIndex(i)->SetMaterial(materials[i], false);
+      }
     }
+    else if (!materials.empty())
+    {
+      geom->SetMaterial(materials[0], false);
+    }
+    ++shared->second.users;
+    this->dataPtr->visualMaterialKeys[_id] = materialKey;
   }
   else
   {
     ignerr << "Failed to load geometry for visual: " << _visual.Name()
            << std::endl;
   }
+}
 
-  // visibility flags
-  visualVis->SetVisibilityFlags(_visual.VisibilityFlags());
+/////////////////////////////////////////////////
+void SceneManager::SetAsyncMeshLoading(bool _async)
+{
+  this->dataPtr->asyncMeshLoading = _async;
+}
 
-  this->dataPtr->visuals[_id] = visualVis;
-  if (parent)
-    parent->AddChild(visualVis);
+/////////////////////////////////////////////////
+bool SceneManager::AsyncMeshLoading() const
+{
+  return this->dataPtr->asyncMeshLoading;
+}
 
-  return visualVis;
+/////////////////////////////////////////////////
+std::size_t SceneManager::AttachLoadedMeshes(
+    const std::chrono::steady_clock::time_point &_deadline)
+{
+  // Register the meshes which finished parsing
+  auto &meshManager = *common::MeshManager::Instance();
+  for (auto it = this->dataPtr->meshLoads.begin();
+       it != this->dataPtr->meshLoads.end();)
+  {
+    if (it->second.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready)
+    {
+      ++it;
+      continue;
+    }
+
+    auto mesh = it->second.get();
+    if (mesh && !meshManager.HasMesh(it->first))
+      meshManager.AddMesh(mesh.release());
+    it = this->dataPtr->meshLoads.erase(it);
+  }
+
+  auto &pending = this->dataPtr->pendingMeshVisuals;
+  for (auto it = pending.begin(); it != pending.end();)
+  {
+    if (std::chrono::steady_clock::now() >= _deadline)
+      break;
+
+    if (this->dataPtr->meshLoads.find(it->second.fullPath) !=
+        this->dataPtr->meshLoads.end())
+    {
+      ++it;
+      continue;
+    }
+
+    // The mesh is in the mesh manager now, so the geometry is created
+    // without decoding it
+    const Entity id = it->first;
+    auto entry = std::move(it->second);
+    it = pending.erase(it);
+    this->AttachGeometry(id, entry.visual, entry.sdf);
+    entry.visual->SetVisibilityFlags(entry.sdf.VisibilityFlags());
+    this->dataPtr->ResetCullBounds(entry.visual);
+  }
+
+  return pending.size();
 }
 
 /////////////////////////////////////////////////
@@ -1039,52 +1259,75 @@ rendering::ParticleEmitterPtr SceneManager::UpdateParticleEmitter(Entity _id,
   }
   auto emitter = emitterIt->second;
 
+  // Only apply the properties which changed since the last update. Setting
+  // the material or the color range reloads textures, so commands which
+  // only toggle emission or change the rate stay cheap.
+  auto lastIt = this->dataPtr->particleEmitterMsgs.find(_id);
+  const bool first = lastIt == this->dataPtr->particleEmitterMsgs.end();
+  const msgs::ParticleEmitter &last = first ? _emitter : lastIt->second;
+  auto changed = [&first](const google::protobuf::Message &_new,
+      const google::protobuf::Message &_last)
+  {
+    return first ||
+        !google::protobuf::util::MessageDifferencer::Equals(_new, _last);
+  };
+
   // Type.
-  switch (_emitter.type())
+  if (first || _emitter.type() != last.type())
   {
-    case ignition::msgs::ParticleEmitter_EmitterType_BOX:
+    switch (_emitter.type())
     {
-      emitter->SetType(ignition::rendering::EmitterType::EM_BOX);
-      break;
-    }
-    case ignition::msgs::ParticleEmitter_EmitterType_CYLINDER:
-    {
-      emitter->SetType(ignition::rendering::EmitterType::EM_CYLINDER);
-      break;
-    }
-    case ignition::msgs::ParticleEmitter_EmitterType_ELLIPSOID:
-    {
-      emitter->SetType(ignition::rendering::EmitterType::EM_ELLIPSOID);
-      break;
-    }
-    default:
-    {
-      emitter->SetType(ignition::rendering::EmitterType::EM_POINT);
+      case ignition::msgs::ParticleEmitter_EmitterType_BOX:
+      {
+        emitter->SetType(ignition::rendering::EmitterType::EM_BOX);
+        break;
+      }
+      case ignition::msgs::ParticleEmitter_EmitterType_CYLINDER:
+      {
+        emitter->SetType(ignition::rendering::EmitterType::EM_CYLINDER);
+        break;
+      }
+      case ignition::msgs::ParticleEmitter_EmitterType_ELLIPSOID:
+      {
+        emitter->SetType(ignition::rendering::EmitterType::EM_ELLIPSOID);
+        break;
+      }
+      default:
+      {
+        emitter->SetType(ignition::rendering::EmitterType::EM_POINT);
+      }
     }
   }
 
   // Emitter size.
-  if (_emitter.has_size())
+  if (_emitter.has_size() && changed(_emitter.size(), last.size()))
     emitter->SetEmitterSize(ignition::msgs::Convert(_emitter.size()));
 
   // Rate.
-  emitter->SetRate(_emitter.rate());
+  if (first || _emitter.rate() != last.rate())
+    emitter->SetRate(_emitter.rate());
 
   // Duration.
-  emitter->SetDuration(_emitter.duration());
+  if (first || _emitter.duration() != last.duration())
+    emitter->SetDuration(_emitter.duration());
 
   // Emitting.
-  emitter->SetEmitting(_emitter.emitting());
+  if (first || _emitter.emitting() != last.emitting())
+    emitter->SetEmitting(_emitter.emitting());
 
   // Particle size.
-  emitter->SetParticleSize(
-    ignition::msgs::Convert(_emitter.particle_size()));
+  if (changed(_emitter.particle_size(), last.particle_size()))
+  {
+    emitter->SetParticleSize(
+      ignition::msgs::Convert(_emitter.particle_size()));
+  }
 
   // Lifetime.
-  emitter->SetLifetime(_emitter.lifetime());
+  if (first || _emitter.lifetime() != last.lifetime())
+    emitter->SetLifetime(_emitter.lifetime());
 
   // Material.
-  if (_emitter.has_material())
+  if (_emitter.has_material() && changed(_emitter.material(), last.material()))
   {
     ignition::rendering::MaterialPtr material =
       this->LoadMaterial(convert<sdf::Material>(_emitter.material()));
@@ -1092,28 +1335,43 @@ rendering::ParticleEmitterPtr SceneManager::UpdateParticleEmitter(Entity _id,
   }
 
   // Velocity range.
-  emitter->SetVelocityRange(_emitter.min_velocity(), _emitter.max_velocity());
-
-  // Color range image.
-  if (!_emitter.color_range_image().empty())
+  if (first || _emitter.min_velocity() != last.min_velocity() ||
+      _emitter.max_velocity() != last.max_velocity())
   {
-    emitter->SetColorRangeImage(_emitter.color_range_image());
+    emitter->SetVelocityRange(_emitter.min_velocity(),
+        _emitter.max_velocity());
   }
-  // Color range.
-  else if (_emitter.has_color_start() && _emitter.has_color_end())
+
+  const bool colorChanged = first ||
+      _emitter.color_range_image() != last.color_range_image() ||
+      changed(_emitter.color_start(), last.color_start()) ||
+      changed(_emitter.color_end(), last.color_end());
+  if (colorChanged)
   {
-    emitter->SetColorRange(
-      ignition::msgs::Convert(_emitter.color_start()),
-      ignition::msgs::Convert(_emitter.color_end()));
+    // Color range image.
+    if (!_emitter.color_range_image().empty())
+    {
+      emitter->SetColorRangeImage(_emitter.color_range_image());
+    }
+    // Color range.
+    else if (_emitter.has_color_start() && _emitter.has_color_end())
+    {
+      emitter->SetColorRange(
+        ignition::msgs::Convert(_emitter.color_start()),
+        ignition::msgs::Convert(_emitter.color_end()));
+    }
   }
 
   // Scale rate.
-  emitter->SetScaleRate(_emitter.scale_rate());
+  if (first || _emitter.scale_rate() != last.scale_rate())
+    emitter->SetScaleRate(_emitter.scale_rate());
 
   // pose
-  if (_emitter.has_pose())
+  if (_emitter.has_pose() && changed(_emitter.pose(), last.pose()))
     emitter->SetLocalPose(msgs::Convert(_emitter.pose()));
 
+  this->dataPtr->particleEmitterMsgs[_id] = _emitter;
+
   return emitter;
 }
 
@@ -1334,18 +1592,32 @@ std::map<std::string, math::Matrix4d> SceneManager::ActorSkeletonTransformsAt(
   {
     auto skel = vIt->second;
     unsigned int animIndex = traj.AnimIndex();
-    std::map<std::string, math::Matrix4d> rawFrames;
 
     double timeSeconds = std::chrono::duration<double>(time).count();
 
-    if (followTraj)
+    // check interpolate x.
+    // todo(anyone) there is a problem with PoseAtX that causes
+    // it to go into an infinite loop if the animation has no x displacement
+    // e.g. a person standing that does not move in x direction
+    double distance = followTraj ? traj.DistanceSoFar(time) : 0.0;
+    bool atX = followTraj && traj.Waypoints()->InterpolateX() &&
+        !math::equal(distance, 0.0);
+
+    // Actors that share a skin share its skeleton, so the evaluation of an
+    // animation at a given time is shared by all of them. The cache only
+    // holds evaluations for the latest sim time.
+    if (_time != this->dataPtr->skeletonPoseCacheTime)
     {
-      double distance = traj.DistanceSoFar(time);
-      // check interpolate x.
-      // todo(anyone) there is a problem with PoseAtX that causes
-      // it to go into an infinite loop if the animation has no x displacement
-      // e.g. a person standing that does not move in x direction
-      if (traj.Waypoints()->InterpolateX() && !math::equal(distance, 0.0))
+      this->dataPtr->skeletonPoseCache.clear();
+      this->dataPtr->skeletonPoseCacheTime = _time;
+    }
+    SceneManagerPrivate::SkeletonPoseKey key{skel.get(), animIndex, atX,
+        atX ? distance : timeSeconds, !noLoop};
+    auto cacheIt = this->dataPtr->skeletonPoseCache.find(key);
+    if (cacheIt == this->dataPtr->skeletonPoseCache.end())
+    {
+      std::map<std::string, math::Matrix4d> rawFrames;
+      if (atX)
       {
         rawFrames = skel->Animation(animIndex)->PoseAtX(distance,
                                         skel->RootNode()->Name());
@@ -1354,23 +1626,30 @@ std::map<std::string, math::Matrix4d> SceneManager::ActorSkeletonTransformsAt(
       {
         rawFrames = skel->Animation(animIndex)->PoseAt(timeSeconds, !noLoop);
       }
-    }
-    else
-    {
-      rawFrames = skel->Animation(animIndex)->PoseAt(timeSeconds, !noLoop);
-    }
 
-    for (auto pair : rawFrames)
-    {
-      std::string nodeName = pair.first;
-      auto nodeTf = pair.second;
+      std::vector<std::pair<std::string, math::Matrix4d>> skinFrames;
+      skinFrames.reserve(rawFrames.size());
+      for (const auto &pair : rawFrames)
+      {
+        const std::string &nodeName = pair.first;
+        const auto &nodeTf = pair.second;
+
+        std::string skinName = skel->NodeNameAnimToSkin(animIndex, nodeName);
+        math::Matrix4d skinTf = skel->AlignTranslation(animIndex, nodeName)
+                * nodeTf * skel->AlignRotation(animIndex, nodeName);
 
-      std::string skinName = skel->NodeNameAnimToSkin(animIndex, nodeName);
-      math::Matrix4d skinTf = skel->AlignTranslation(animIndex, nodeName)
-              * nodeTf * skel->AlignRotation(animIndex, nodeName);
+        skinFrames.emplace_back(std::move(skinName), skinTf);
+      }
 
-      allFrames[skinName] = skinTf;
+      // Sorted by name, so that the map below is built in linear time
+      std::sort(skinFrames.begin(), skinFrames.end(),
+          [](const auto &_a, const auto &_b) { return _a.first < _b.first; });
+      cacheIt = this->dataPtr->skeletonPoseCache.emplace(
+          key, std::move(skinFrames)).first;
     }
+
+    for (const auto &frame : cacheIt->second)
+      allFrames.emplace_hint(allFrames.end(), frame.first, frame.second);
   }
 
   // correct animation root pose
@@ -1403,6 +1682,10 @@ void SceneManager::RemoveEntity(Entity _id)
     {
       this->dataPtr->scene->DestroyVisual(it->second);
       this->dataPtr->visuals.erase(it);
+      this->dataPtr->pendingMeshVisuals.erase(_id);
+      this->dataPtr->ReleaseMaterials(_id);
+      this->dataPtr->cullBounds.erase(_id);
+      this->dataPtr->culledVisuals.erase(_id);
       return;
     }
   }
@@ -1423,6 +1706,7 @@ void SceneManager::RemoveEntity(Entity _id)
     {
       this->dataPtr->scene->DestroyVisual(it->second);
       this->dataPtr->particleEmitters.erase(it);
+      this->dataPtr->particleEmitterMsgs.erase(_id);
       return;
     }
   }
@@ -1439,6 +1723,81 @@ void SceneManager::RemoveEntity(Entity _id)
   }
 }
 
+/////////////////////////////////////////////////
+void SceneManager::CullByDistance()
+{
+  if (!this->dataPtr->scene)
+    return;
+
+  // Position and range of each sensor
+  std::vector<std::pair<math::Vector3d, double>> ranges;
+  bool cull = !this->dataPtr->sensors.empty();
+  for (const auto &it : this->dataPtr->sensors)
+  {
+    auto camera = std::dynamic_pointer_cast<rendering::Camera>(it.second);
+    if (!camera)
+    {
+      // Unknown range, so everything may be seen
+      cull = false;
+      break;
+    }
+    ranges.emplace_back(camera->WorldPosition(), camera->FarClipPlane());
+  }
+
+  auto root = this->dataPtr->scene->RootVisual();
+  for (const auto &it : this->dataPtr->visuals)
+  {
+    const auto &visual = it.second;
+    if (visual->Parent() != root)
+      continue;
+
+    bool inRange = !cull;
+    if (cull)
+    {
+      auto boundsIt = this->dataPtr->cullBounds.find(it.first);
+      if (boundsIt == this->dataPtr->cullBounds.end())
+      {
+        SceneManagerPrivate::CullBounds bounds;
+        auto box = visual->LocalBoundingBox();
+        if (box.Min().X() > box.Max().X())
+        {
+          bounds.radius = std::numeric_limits<double>::infinity();
+        }
+        else
+        {
+          bounds.center = box.Center();
+          bounds.radius = box.Size().Length() * 0.5;
+        }
+        boundsIt = this->dataPtr->cullBounds.emplace(it.first, bounds).first;
+      }
+
+      auto center =
+          visual->WorldPose().CoordPositionAdd(boundsIt->second.center);
+      for (const auto &range : ranges)
+      {
+        if (center.Distance(range.first) - boundsIt->second.radius <=
+            range.second)
+        {
+          inRange = true;
+          break;
+        }
+      }
+    }
+
+    auto culledIt = this->dataPtr->culledVisuals.find(it.first);
+    if (!inRange && culledIt == this->dataPtr->culledVisuals.end())
+    {
+      visual->SetVisible(false);
+      this->dataPtr->culledVisuals.insert(it.first);
+    }
+    else if (inRange && culledIt != this->dataPtr->culledVisuals.end())
+    {
+      visual->SetVisible(true);
+      this->dataPtr->culledVisuals.erase(culledIt);
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 rendering::VisualPtr SceneManager::TopLevelVisual(
     const rendering::VisualPtr &_visual) const
@@ -1575,3 +1934,108 @@ AnimationUpdateData SceneManagerPrivate::ActorTrajectoryAt(
   animData.valid = true;
   return animData;
 }
+
+/////////////////////////////////////////////////
+std::string SceneManagerPrivate::MaterialKey(const sdf::Visual &_visual) const
+{
+  std::ostringstream key;
+  key << std::setprecision(17);
+  if (_visual.Material())
+  {
+    // Texture maps are relative to the file the material was loaded from
+    key << "material:" << _visual.Material()->FilePath() << ":"
+        << convert<msgs::Material>(*_visual.Material()).SerializeAsString();
+  }
+  else if (_visual.Geom()->Type() == sdf::GeometryType::MESH)
+  {
+    auto meshShape = _visual.Geom()->MeshShape();
+    key << "mesh:" << asFullPath(meshShape->Uri(), meshShape->FilePath())
+        << ":" << meshShape->Submesh() << ":" << meshShape->CenterSubmesh();
+  }
+  else
+  {
+    key << "default";
+  }
+  key << ":" << _visual.Transparency() << ":" << _visual.CastShadows();
+  return key.str();
+}
+
+/////////////////////////////////////////////////
+void SceneManagerPrivate::ReleaseMaterials(Entity _id)
+{
+  auto keyIt = this->visualMaterialKeys.find(_id);
+  if (keyIt == this->visualMaterialKeys.end())
+    return;
+
+  auto it = this->sharedMaterials.find(keyIt->second);
+  if (it != this->sharedMaterials.end() && --it->second.users == 0)
+  {
+    for (const auto &material : it->second.materials)
+    {
+      if (material)
+        this->scene->DestroyMaterial(material);
+    }
+    this->sharedMaterials.erase(it);
+  }
+  this->visualMaterialKeys.erase(keyIt);
+}
+
+/////////////////////////////////////////////////
+bool SceneManagerPrivate::DeferMesh(Entity _id,
+    const rendering::VisualPtr &_visualVis, const sdf::Visual &_visual)
+{
+  if (!this->asyncMeshLoading ||
+      _visual.Geom()->Type() != sdf::GeometryType::MESH)
+  {
+    return false;
+  }
+
+  auto fullPath = asFullPath(_visual.Geom()->MeshShape()->Uri(),
+      _visual.Geom()->MeshShape()->FilePath());
+  if (fullPath.empty() ||
+      (this->meshLoads.find(fullPath) == this->meshLoads.end() &&
+       common::MeshManager::Instance()->HasMesh(fullPath)))
+  {
+    return false;
+  }
+
+  // Decoding large meshes takes long enough to stall the frame. The mesh is
+  // only parsed on the worker, and registered by AttachLoadedMeshes.
+  if (this->meshLoads.find(fullPath) == this->meshLoads.end())
+  {
+    this->meshLoads[fullPath] = std::async(std::launch::async,
+        [fullPath]()
+        {
+          return parseMeshFile(fullPath);
+        });
+  }
+  this->pendingMeshVisuals[_id] = {_visualVis, _visual, fullPath};
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SceneManagerPrivate::ResetCullBounds(const rendering::VisualPtr &_visual)
+{
+  if (this->cullBounds.empty() && this->culledVisuals.empty())
+    return;
+
+  rendering::NodePtr rootNode = this->scene->RootVisual();
+  rendering::NodePtr node = _visual;
+  while (node && node->Parent() != rootNode)
+    node = node->Parent();
+
+  auto topLevel = std::dynamic_pointer_cast<rendering::Visual>(node);
+  if (!topLevel)
+    return;
+
+  auto userData = topLevel->UserData("gazebo-entity");
+  if (!std::holds_alternative<int>(userData))
+    return;
+  Entity id = std::get<int>(userData);
+
+  this->cullBounds.erase(id);
+
+  // Newly added descendants wouldn't be hidden along with the rest
+  if (this->culledVisuals.erase(id) > 0)
+    topLevel->SetVisible(true);
+}
@@ -24,6 +24,7 @@
 #include <ignition/transport/Node.hh>
 
 #include "ignition/gazebo/components/JointForceCmd.hh"
+#include "ignition/gazebo/components/JointForceTarget.hh"
 #include "ignition/gazebo/Model.hh"
 #include "ignition/gazebo/Util.hh"
 
@@ -138,21 +139,32 @@ void ApplyJointForce::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
   if (_info.paused)
     return;
 
+  double forceCmd;
+  auto target = _ecm.Component<components::JointForceTarget>(
+      this->dataPtr->jointEntity);
+  if (target && !target->Data().empty())
+  {
+    forceCmd = target->Data()[0];
+  }
+  else
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->jointForceCmdMutex);
+    forceCmd = this->dataPtr->jointForceCmd;
+  }
+
   // Update joint force
   auto force = _ecm.Component<components::JointForceCmd>(
       this->dataPtr->jointEntity);
 
-  std::lock_guard<std::mutex> lock(this->dataPtr->jointForceCmdMutex);
-
   if (force == nullptr)
   {
     _ecm.CreateComponent(
         this->dataPtr->jointEntity,
-        components::JointForceCmd({this->dataPtr->jointForceCmd}));
+        components::JointForceCmd({forceCmd}));
   }
   else
   {
-    force->Data()[0] += this->dataPtr->jointForceCmd;
+    force->Data()[0] += forceCmd;
   }
 }
 
@@ -32,6 +32,9 @@ namespace systems
   class ApplyJointForcePrivate;
 
   /// \brief This system applies a force to the first axis of a specified joint.
+  /// The force is received on the topic
+  /// "/model/<model_name>/joint/<joint_name>/cmd_force", or read from a
+  /// JointForceTarget component on the joint, see components::JointForceTarget.
   class IGNITION_GAZEBO_VISIBLE ApplyJointForce
       : public System,
         public ISystemConfigure,
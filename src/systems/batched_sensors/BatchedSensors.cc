@@ -0,0 +1,590 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "BatchedSensors.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/plugin/Register.hh>
+
+#include <sdf/AirPressure.hh>
+#include <sdf/Altimeter.hh>
+#include <sdf/Imu.hh>
+#include <sdf/Magnetometer.hh>
+#include <sdf/Noise.hh>
+#include <sdf/Sensor.hh>
+
+#include <ignition/common/Profiler.hh>
+
+#include <ignition/math/Helpers.hh>
+
+#include <ignition/sensors/AirPressureSensor.hh>
+#include <ignition/sensors/AltimeterSensor.hh>
+#include <ignition/sensors/ImuSensor.hh>
+#include <ignition/sensors/MagnetometerSensor.hh>
+#include <ignition/sensors/SensorFactory.hh>
+
+#include "ignition/gazebo/components/AirPressureSensor.hh"
+#include "ignition/gazebo/components/Altimeter.hh"
+#include "ignition/gazebo/components/AngularVelocity.hh"
+#include "ignition/gazebo/components/Gravity.hh"
+#include "ignition/gazebo/components/Imu.hh"
+#include "ignition/gazebo/components/LinearAcceleration.hh"
+#include "ignition/gazebo/components/LinearVelocity.hh"
+#include "ignition/gazebo/components/MagneticField.hh"
+#include "ignition/gazebo/components/Magnetometer.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/Sensor.hh"
+#include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/Util.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Sensors of one type, sorted by entity.
+template<typename SensorT>
+class SensorArray
+{
+  /// \brief Add a sensor.
+  /// \param[in] _entity Sensor entity.
+  /// \param[in] _sensor The sensor.
+  /// \param[in] _noisy Whether the sensor has noise.
+  public: void Insert(const Entity _entity, std::unique_ptr<SensorT> _sensor,
+                      const bool _noisy)
+  {
+    auto index = this->Find(_entity);
+    this->entities.insert(this->entities.begin() + index, _entity);
+    this->sensors.insert(this->sensors.begin() + index, std::move(_sensor));
+    this->noisy.insert(this->noisy.begin() + index, _noisy);
+  }
+
+  /// \brief Remove a sensor.
+  /// \param[in] _entity Sensor entity.
+  /// \return True if there was a sensor for the entity.
+  public: bool Erase(const Entity _entity)
+  {
+    auto index = this->Find(_entity);
+    if (index == this->entities.size() || this->entities[index] != _entity)
+      return false;
+
+    this->entities.erase(this->entities.begin() + index);
+    this->sensors.erase(this->sensors.begin() + index);
+    this->noisy.erase(this->noisy.begin() + index);
+    return true;
+  }
+
+  /// \brief Find the position of an entity.
+  /// \param[in] _entity Sensor entity.
+  /// \return Index of the first entity not less than _entity.
+  public: std::size_t Find(const Entity _entity) const
+  {
+    return std::lower_bound(this->entities.begin(), this->entities.end(),
+        _entity) - this->entities.begin();
+  }
+
+  /// \brief Feed the components of each sensor entity to its sensor. The
+  /// ECM's views and this array are both sorted by entity, so they are walked
+  /// together instead of looking up each sensor.
+  /// \param[in] _ecm Immutable reference to ECM.
+  /// \param[in] _f Function called with each sensor and its components.
+  public: template<typename ...ComponentTypeTs, typename FunctionT>
+          void Feed(const EntityComponentManager &_ecm, FunctionT &&_f)
+  {
+    if (this->entities.empty())
+      return;
+
+    std::size_t next = 0;
+    _ecm.Each<ComponentTypeTs...>(
+        [&](const Entity &_entity, const ComponentTypeTs *..._components)
+        {
+          while (next < this->entities.size() &&
+                 this->entities[next] < _entity)
+          {
+            ++next;
+          }
+          if (next == this->entities.size())
+            return false;
+
+          // Entities whose sensor failed to be created are skipped
+          if (this->entities[next] == _entity)
+            _f(*this->sensors[next++], _components...);
+          return true;
+        });
+  }
+
+  /// \brief Update the measurements of all sensors, which also publishes
+  /// them. Sensors without noise are updated concurrently on the ECM's task
+  /// pool. Noise is drawn from a random generator shared by the whole
+  /// process, so sensors with noise are updated one at a time afterwards, in
+  /// entity order, to keep seeded runs reproducible.
+  /// \param[in] _ecm Immutable reference to ECM.
+  /// \param[in] _now Current simulation time.
+  public: template<typename ComponentT>
+          void Update(const EntityComponentManager &_ecm,
+                      const std::chrono::steady_clock::duration &_now)
+  {
+    if (this->entities.empty())
+      return;
+
+    _ecm.ParallelEach<ComponentT>(
+        [&](const Entity &_entity, const ComponentT *)
+        {
+          auto index = this->Find(_entity);
+          if (index == this->entities.size() ||
+              this->entities[index] != _entity || this->noisy[index])
+          {
+            return;
+          }
+          static_cast<sensors::Sensor *>(this->sensors[index].get())->Update(
+              _now, false);
+        }, 16);
+
+    for (std::size_t i = 0; i < this->entities.size(); ++i)
+    {
+      if (this->noisy[i])
+      {
+        static_cast<sensors::Sensor *>(this->sensors[i].get())->Update(
+            _now, false);
+      }
+    }
+  }
+
+  /// \brief Remove the sensors of entities whose sensor component has been
+  /// removed.
+  /// \param[in] _ecm Immutable reference to ECM.
+  /// \param[in] _type Sensor type, for error messages.
+  public: template<typename ComponentT>
+          void Remove(const EntityComponentManager &_ecm,
+                      const std::string &_type)
+  {
+    _ecm.EachRemoved<ComponentT>(
+      [&](const Entity &_entity, const ComponentT *)->bool
+        {
+          if (!this->Erase(_entity))
+          {
+            ignerr << "Internal error, missing " << _type
+                   << " sensor for entity [" << _entity << "]" << std::endl;
+          }
+          return true;
+        });
+  }
+
+  /// \brief Sensor entities, in ascending order.
+  public: std::vector<Entity> entities;
+
+  /// \brief Sensors, parallel to `entities`.
+  public: std::vector<std::unique_ptr<SensorT>> sensors;
+
+  /// \brief Whether each sensor has noise, parallel to `entities`.
+  public: std::vector<bool> noisy;
+};
+
+/// \brief Whether a sensor has noise on any of its measurements.
+/// \param[in] _data SDF description of the sensor.
+/// \return True if any measurement has noise.
+static bool hasNoise(const sdf::Sensor &_data)
+{
+  std::vector<const sdf::Noise *> noises;
+  if (auto imu = _data.ImuSensor())
+  {
+    noises = {&imu->LinearAccelerationXNoise(),
+        &imu->LinearAccelerationYNoise(), &imu->LinearAccelerationZNoise(),
+        &imu->AngularVelocityXNoise(), &imu->AngularVelocityYNoise(),
+        &imu->AngularVelocityZNoise()};
+  }
+  else if (auto altimeter = _data.AltimeterSensor())
+  {
+    noises = {&altimeter->VerticalPositionNoise(),
+        &altimeter->VerticalVelocityNoise()};
+  }
+  else if (auto magnetometer = _data.MagnetometerSensor())
+  {
+    noises = {&magnetometer->XNoise(), &magnetometer->YNoise(),
+        &magnetometer->ZNoise()};
+  }
+  else if (auto airPressure = _data.AirPressureSensor())
+  {
+    noises = {&airPressure->PressureNoise()};
+  }
+
+  for (const auto *noise : noises)
+  {
+    if (noise->Type() != sdf::NoiseType::NONE)
+      return true;
+  }
+  return false;
+}
+
+/// \brief Private BatchedSensors data class.
+class ignition::gazebo::systems::BatchedSensorsPrivate
+{
+  /// \brief Create a sensor for an entity.
+  /// \param[in] _ecm Mutable reference to ECM.
+  /// \param[in] _entity Sensor entity.
+  /// \param[in] _data SDF description of the sensor.
+  /// \param[in] _parent Parent entity of the sensor.
+  /// \param[in] _topicSuffix Suffix of the default topic.
+  /// \return The sensor, or null if it couldn't be created.
+  public: template<typename SensorT>
+          std::unique_ptr<SensorT> CreateSensor(EntityComponentManager &_ecm,
+              const Entity _entity, sdf::Sensor _data, const Entity _parent,
+              const std::string &_topicSuffix);
+
+  /// \brief Create sensors for new sensor entities
+  /// \param[in] _ecm Mutable reference to ECM.
+  public: void CreateSensors(EntityComponentManager &_ecm);
+
+  /// \brief Update sensor data based on physics data
+  /// \param[in] _ecm Immutable reference to ECM.
+  public: void UpdateSensors(const EntityComponentManager &_ecm);
+
+  /// \brief Remove sensors if their entities have been removed from
+  /// simulation.
+  /// \param[in] _ecm Immutable reference to ECM.
+  public: void RemoveSensors(const EntityComponentManager &_ecm);
+
+  /// \brief All IMUs.
+  public: SensorArray<sensors::ImuSensor> imus;
+
+  /// \brief All altimeters.
+  public: SensorArray<sensors::AltimeterSensor> altimeters;
+
+  /// \brief All magnetometers.
+  public: SensorArray<sensors::MagnetometerSensor> magnetometers;
+
+  /// \brief All air pressure sensors.
+  public: SensorArray<sensors::AirPressureSensor> airPressures;
+
+  /// \brief Whether IMUs are handled by this system.
+  public: bool imuEnabled{true};
+
+  /// \brief Whether altimeters are handled by this system.
+  public: bool altimeterEnabled{true};
+
+  /// \brief Whether magnetometers are handled by this system.
+  public: bool magnetometerEnabled{true};
+
+  /// \brief Whether air pressure sensors are handled by this system.
+  public: bool airPressureEnabled{true};
+
+  /// \brief Ign-sensors sensor factory for creating sensors
+  public: sensors::SensorFactory sensorFactory;
+
+  /// \brief World entity
+  public: Entity worldEntity{kNullEntity};
+};
+
+//////////////////////////////////////////////////
+BatchedSensors::BatchedSensors()
+  : System(), dataPtr(std::make_unique<BatchedSensorsPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+BatchedSensors::~BatchedSensors() = default;
+
+//////////////////////////////////////////////////
+void BatchedSensors::Configure(const Entity &_entity,
+    const std::shared_ptr<const sdf::Element> &_sdf,
+    EntityComponentManager &/*_ecm*/, EventManager &/*_eventMgr*/)
+{
+  this->dataPtr->worldEntity = _entity;
+
+  this->dataPtr->imuEnabled = _sdf->Get<bool>("imu", true).first;
+  this->dataPtr->altimeterEnabled =
+      _sdf->Get<bool>("altimeter", true).first;
+  this->dataPtr->magnetometerEnabled =
+      _sdf->Get<bool>("magnetometer", true).first;
+  this->dataPtr->airPressureEnabled =
+      _sdf->Get<bool>("air_pressure", true).first;
+}
+
+//////////////////////////////////////////////////
+void BatchedSensors::PreUpdate(const UpdateInfo &/*_info*/,
+    EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("BatchedSensors::PreUpdate");
+  this->dataPtr->CreateSensors(_ecm);
+}
+
+//////////////////////////////////////////////////
+void BatchedSensors::PostUpdate(const UpdateInfo &_info,
+                                const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("BatchedSensors::PostUpdate");
+
+  // \TODO(anyone) Support rewind
+  if (_info.dt < std::chrono::steady_clock::duration::zero())
+  {
+    ignwarn << "Detected jump back in time ["
+        << std::chrono::duration_cast<std::chrono::seconds>(_info.dt).count()
+        << "s]. System may not work properly." << std::endl;
+  }
+
+  // Only update and publish if not paused.
+  if (!_info.paused)
+  {
+    this->dataPtr->UpdateSensors(_ecm);
+
+    // Update measurement time
+    auto time = math::durationToSecNsec(_info.simTime);
+    auto now = math::secNsecToDuration(time.first, time.second);
+
+    this->dataPtr->imus.Update<components::Imu>(_ecm, now);
+    this->dataPtr->altimeters.Update<components::Altimeter>(_ecm, now);
+    this->dataPtr->magnetometers.Update<components::Magnetometer>(_ecm, now);
+    this->dataPtr->airPressures.Update<components::AirPressureSensor>(_ecm,
+        now);
+  }
+
+  this->dataPtr->RemoveSensors(_ecm);
+}
+
+//////////////////////////////////////////////////
+template<typename SensorT>
+std::unique_ptr<SensorT> BatchedSensorsPrivate::CreateSensor(
+    EntityComponentManager &_ecm, const Entity _entity, sdf::Sensor _data,
+    const Entity _parent, const std::string &_topicSuffix)
+{
+  std::string sensorScopedName =
+      removeParentScope(scopedName(_entity, _ecm, "::", false), "::");
+  _data.SetName(sensorScopedName);
+  // check topic
+  if (_data.Topic().empty())
+  {
+    std::string topic = scopedName(_entity, _ecm) + _topicSuffix;
+    _data.SetTopic(topic);
+  }
+  std::unique_ptr<SensorT> sensor =
+      this->sensorFactory.CreateSensor<SensorT>(_data);
+  if (nullptr == sensor)
+  {
+    ignerr << "Failed to create sensor [" << sensorScopedName << "]"
+           << std::endl;
+    return nullptr;
+  }
+
+  // set sensor parent
+  std::string parentName =
+      _ecm.Component<components::Name>(_parent)->Data();
+  sensor->SetParent(parentName);
+
+  // Set topic
+  _ecm.CreateComponent(_entity, components::SensorTopic(sensor->Topic()));
+
+  return sensor;
+}
+
+//////////////////////////////////////////////////
+void BatchedSensorsPrivate::CreateSensors(EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("BatchedSensorsPrivate::CreateSensors");
+
+  // The WorldPose components of new sensors were just created and so they
+  // are empty. We'll compute the world poses manually here.
+  if (this->imuEnabled)
+  {
+    _ecm.EachNew<components::Imu, components::ParentEntity>(
+      [&](const Entity &_entity,
+          const components::Imu *_imu,
+          const components::ParentEntity *_parent)->bool
+        {
+          // Get the world acceleration (defined in world frame)
+          auto gravity =
+              _ecm.Component<components::Gravity>(this->worldEntity);
+          if (nullptr == gravity)
+          {
+            ignerr << "World missing gravity." << std::endl;
+            return false;
+          }
+
+          auto sensor = this->CreateSensor<sensors::ImuSensor>(_ecm,
+              _entity, _imu->Data(), _parent->Data(), "/imu");
+          if (nullptr == sensor)
+            return true;
+
+          // set gravity - assume it remains fixed
+          sensor->SetGravity(gravity->Data());
+          sensor->SetOrientationReference(worldPose(_entity, _ecm).Rot());
+
+          this->imus.Insert(_entity, std::move(sensor),
+              hasNoise(_imu->Data()));
+          return true;
+        });
+  }
+
+  if (this->altimeterEnabled)
+  {
+    _ecm.EachNew<components::Altimeter, components::ParentEntity>(
+      [&](const Entity &_entity,
+          const components::Altimeter *_altimeter,
+          const components::ParentEntity *_parent)->bool
+        {
+          auto sensor = this->CreateSensor<sensors::AltimeterSensor>(_ecm,
+              _entity, _altimeter->Data(), _parent->Data(), "/altimeter");
+          if (nullptr == sensor)
+            return true;
+
+          // Set the reference z pos
+          double verticalReference = worldPose(_entity, _ecm).Pos().Z();
+          sensor->SetVerticalReference(verticalReference);
+          sensor->SetPosition(verticalReference);
+
+          this->altimeters.Insert(_entity, std::move(sensor),
+              hasNoise(_altimeter->Data()));
+          return true;
+        });
+  }
+
+  if (this->magnetometerEnabled)
+  {
+    _ecm.EachNew<components::Magnetometer, components::ParentEntity>(
+      [&](const Entity &_entity,
+          const components::Magnetometer *_magnetometer,
+          const components::ParentEntity *_parent)->bool
+        {
+          // Get the world magnetic field (defined in world frame)
+          auto worldField =
+              _ecm.Component<components::MagneticField>(this->worldEntity);
+          if (nullptr == worldField)
+          {
+            ignerr << "World missing magnetic field." << std::endl;
+            return false;
+          }
+
+          auto sensor = this->CreateSensor<sensors::MagnetometerSensor>(
+              _ecm, _entity, _magnetometer->Data(), _parent->Data(),
+              "/magnetometer");
+          if (nullptr == sensor)
+            return true;
+
+          // Assume the field is uniform in the world and does not change
+          // throughout simulation
+          sensor->SetWorldMagneticField(worldField->Data());
+          sensor->SetWorldPose(worldPose(_entity, _ecm));
+
+          this->magnetometers.Insert(_entity, std::move(sensor),
+              hasNoise(_magnetometer->Data()));
+          return true;
+        });
+  }
+
+  if (this->airPressureEnabled)
+  {
+    _ecm.EachNew<components::AirPressureSensor, components::ParentEntity>(
+      [&](const Entity &_entity,
+          const components::AirPressureSensor *_airPressure,
+          const components::ParentEntity *_parent)->bool
+        {
+          auto sensor = this->CreateSensor<sensors::AirPressureSensor>(_ecm,
+              _entity, _airPressure->Data(), _parent->Data(),
+              "/air_pressure");
+          if (nullptr == sensor)
+            return true;
+
+          sensor->SetPose(worldPose(_entity, _ecm));
+
+          this->airPressures.Insert(_entity, std::move(sensor),
+              hasNoise(_airPressure->Data()));
+          return true;
+        });
+  }
+}
+
+//////////////////////////////////////////////////
+void BatchedSensorsPrivate::UpdateSensors(const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("BatchedSensorsPrivate::UpdateSensors");
+
+  this->imus.Feed<components::Imu, components::WorldPose,
+      components::AngularVelocity, components::LinearAcceleration>(_ecm,
+      [](sensors::ImuSensor &_sensor, const components::Imu *,
+         const components::WorldPose *_worldPose,
+         const components::AngularVelocity *_angularVel,
+         const components::LinearAcceleration *_linearAccel)
+      {
+        _sensor.SetWorldPose(_worldPose->Data());
+        _sensor.SetAngularVelocity(_angularVel->Data());
+        _sensor.SetLinearAcceleration(_linearAccel->Data());
+      });
+
+  this->altimeters.Feed<components::Altimeter, components::WorldPose,
+      components::WorldLinearVelocity>(_ecm,
+      [](sensors::AltimeterSensor &_sensor, const components::Altimeter *,
+         const components::WorldPose *_worldPose,
+         const components::WorldLinearVelocity *_worldLinearVel)
+      {
+        _sensor.SetPosition(_worldPose->Data().Pos().Z());
+        _sensor.SetVerticalVelocity(_worldLinearVel->Data().Z());
+      });
+
+  this->magnetometers.Feed<components::Magnetometer,
+      components::WorldPose>(_ecm,
+      [](sensors::MagnetometerSensor &_sensor,
+         const components::Magnetometer *,
+         const components::WorldPose *_worldPose)
+      {
+        _sensor.SetWorldPose(_worldPose->Data());
+      });
+
+  this->airPressures.Feed<components::AirPressureSensor,
+      components::WorldPose>(_ecm,
+      [](sensors::AirPressureSensor &_sensor,
+         const components::AirPressureSensor *,
+         const components::WorldPose *_worldPose)
+      {
+        _sensor.SetPose(_worldPose->Data());
+      });
+}
+
+//////////////////////////////////////////////////
+void BatchedSensorsPrivate::RemoveSensors(const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("BatchedSensorsPrivate::RemoveSensors");
+
+  if (this->imuEnabled)
+    this->imus.Remove<components::Imu>(_ecm, "IMU");
+  if (this->altimeterEnabled)
+    this->altimeters.Remove<components::Altimeter>(_ecm, "altimeter");
+  if (this->magnetometerEnabled)
+  {
+    this->magnetometers.Remove<components::Magnetometer>(_ecm,
+        "magnetometer");
+  }
+  if (this->airPressureEnabled)
+  {
+    this->airPressures.Remove<components::AirPressureSensor>(_ecm,
+        "air pressure");
+  }
+}
+
+IGNITION_ADD_PLUGIN(BatchedSensors, System,
+  BatchedSensors::ISystemConfigure,
+  BatchedSensors::ISystemPreUpdate,
+  BatchedSensors::ISystemPostUpdate
+)
+
+IGNITION_ADD_PLUGIN_ALIAS(BatchedSensors,
+                          "ignition::gazebo::systems::BatchedSensors")
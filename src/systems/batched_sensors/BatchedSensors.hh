@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_BATCHEDSENSORS_HH_
+#define IGNITION_GAZEBO_SYSTEMS_BATCHEDSENSORS_HH_
+
+#include <memory>
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+#include <ignition/gazebo/System.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  // Forward declarations.
+  class BatchedSensorsPrivate;
+
+  /// \class BatchedSensors BatchedSensors.hh
+  /// ignition/gazebo/systems/BatchedSensors.hh
+  /// \brief A single system that updates all IMU, altimeter, magnetometer and
+  /// air pressure sensors of a world. It replaces the Imu, Altimeter,
+  /// Magnetometer and AirPressure systems, which must not be loaded together
+  /// with it, and publishes on the same topics.
+  ///
+  /// Sensors of each type are kept in arrays sorted by entity, in the same
+  /// order as the ECM's views. Each step, one pass over the view of each
+  /// sensor type feeds the poses and velocities to the sensors without any
+  /// map lookups. The sensors are then updated concurrently on the ECM's task
+  /// pool, except for sensors with noise, which are updated one at a time in
+  /// entity order so that seeded runs stay reproducible.
+  ///
+  /// ## System parameters
+  ///
+  /// `<imu>`, `<altimeter>`, `<magnetometer>`, `<air_pressure>`: Optional
+  /// booleans to disable the handling of a sensor type, so that it can be
+  /// left to its own system. All default to true.
+  class IGNITION_GAZEBO_VISIBLE BatchedSensors:
+    public System,
+    public ISystemConfigure,
+    public ISystemPreUpdate,
+    public ISystemPostUpdate
+  {
+    /// \brief Constructor
+    public: explicit BatchedSensors();
+
+    /// \brief Destructor
+    public: ~BatchedSensors() override;
+
+    // Documentation inherited
+    public: void Configure(const Entity &_entity,
+                           const std::shared_ptr<const sdf::Element> &_sdf,
+                           EntityComponentManager &_ecm,
+                           EventManager &_eventMgr) final;
+
+    /// Documentation inherited
+    public: void PreUpdate(const UpdateInfo &_info,
+                           EntityComponentManager &_ecm) final;
+
+    /// Documentation inherited
+    public: void PostUpdate(const UpdateInfo &_info,
+                            const EntityComponentManager &_ecm) final;
+
+    /// \brief Private data pointer.
+    private: std::unique_ptr<BatchedSensorsPrivate> dataPtr;
+  };
+  }
+}
+}
+}
+#endif
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <deque>
 #include <functional>
 #include <string>
@@ -57,6 +58,12 @@ class ignition::gazebo::systems::LinearBatteryPluginPrivate
   /// \brief Reset the plugin
   public: void Reset();
 
+  /// \brief Integrate the battery over the time accumulated since the last
+  /// integration, with the load of that time, and update the BatterySoC
+  /// component.
+  /// \param[in] _ecm Mutable reference to the ECM.
+  public: void Integrate(EntityComponentManager &_ecm);
+
   /// \brief Get the current state of charge of the battery.
   /// \return State of charge of the battery in range [0.0, 1.0].
   public: double StateOfCharge() const;
@@ -135,6 +142,26 @@ class ignition::gazebo::systems::LinearBatteryPluginPrivate
   /// \brief Simulation time handled during a single update.
   public: std::chrono::steady_clock::duration stepSize;
 
+  /// \brief Simulation time integrated at once, see `<update_rate>`. Zero
+  /// integrates every step.
+  public: std::chrono::steady_clock::duration updatePeriod{0};
+
+  /// \brief Simulation time which passed while draining or charging since
+  /// the last integration.
+  public: std::chrono::steady_clock::duration pendingTime{0};
+
+  /// \brief Whether the battery was draining during the pending time. The
+  /// power load only changes with the drain and charge status, so it's
+  /// constant until the next integration.
+  public: bool loadDraining{false};
+
+  /// \brief Whether the battery was charging during the pending time.
+  public: bool loadCharging{false};
+
+  /// \brief Whether the state changed in the current step, so that it's
+  /// published. Only used with an update period.
+  public: bool stateChanged{true};
+
   /// \brief Flag on whether the battery should start draining
   public: bool startDraining = true;
 
@@ -248,6 +275,22 @@ void LinearBatteryPlugin::Configure(const Entity &_entity,
   if (_sdf->HasElement("fix_issue_225"))
     this->dataPtr->fixIssue225 = _sdf->Get<bool>("fix_issue_225");
 
+  if (_sdf->HasElement("update_rate"))
+  {
+    auto rate = _sdf->Get<double>("update_rate");
+    if (rate > 0)
+    {
+      this->dataPtr->updatePeriod =
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1.0 / rate));
+    }
+    else if (rate < 0)
+    {
+      ignerr << "<update_rate> value should be positive. Updating every "
+             << "step instead." << std::endl;
+    }
+  }
+
   if (_sdf->HasElement("battery_name") && _sdf->HasElement("voltage"))
   {
     auto batteryName = _sdf->Get<std::string>("battery_name");
@@ -459,8 +502,44 @@ void LinearBatteryPlugin::Update(const UpdateInfo &_info,
   if (_info.paused)
     return;
 
-  if (!this->dataPtr->startDraining && !this->dataPtr->startCharging)
-    return;
+  const bool draining = this->dataPtr->startDraining;
+  const bool charging = this->dataPtr->startCharging;
+  const bool loadChanged = draining != this->dataPtr->loadDraining ||
+      charging != this->dataPtr->loadCharging;
+
+  if (this->dataPtr->updatePeriod > std::chrono::steady_clock::duration::zero())
+  {
+    // Time accumulated with the previous load is integrated before the load
+    // changes
+    if (loadChanged)
+    {
+      if (this->dataPtr->pendingTime >
+          std::chrono::steady_clock::duration::zero())
+      {
+        this->dataPtr->Integrate(_ecm);
+      }
+      this->dataPtr->stateChanged = true;
+    }
+    this->dataPtr->loadDraining = draining;
+    this->dataPtr->loadCharging = charging;
+
+    if (!draining && !charging)
+      return;
+
+    this->dataPtr->pendingTime += _info.dt;
+    if (this->dataPtr->pendingTime < this->dataPtr->updatePeriod)
+      return;
+  }
+  else
+  {
+    this->dataPtr->loadDraining = draining;
+    this->dataPtr->loadCharging = charging;
+
+    if (!draining && !charging)
+      return;
+
+    this->dataPtr->pendingTime = _info.dt;
+  }
 
   // Find the time at which battery starts to drain
   int simTime = static_cast<int>(
@@ -477,29 +556,44 @@ void LinearBatteryPlugin::Update(const UpdateInfo &_info,
       " minutes passed.\n";
   }
 
+  this->dataPtr->Integrate(_ecm);
+}
+
+//////////////////////////////////////////////////
+void LinearBatteryPluginPrivate::Integrate(EntityComponentManager &_ecm)
+{
   // Update actual battery
-  this->dataPtr->stepSize = _info.dt;
+  this->stepSize = this->pendingTime;
+  this->pendingTime = std::chrono::steady_clock::duration::zero();
 
-  // Sanity check: tau should be between [dt, +inf).
+  // Sanity check: tau should be between [dt, +inf). The filter is solved
+  // exactly when integrating several steps at once, so it doesn't apply.
   double dt = (std::chrono::duration_cast<std::chrono::nanoseconds>(
-    this->dataPtr->stepSize).count()) * 1e-9;
-  if (this->dataPtr->tau < dt)
+    this->stepSize).count()) * 1e-9;
+  if (this->tau < dt &&
+      this->updatePeriod == std::chrono::steady_clock::duration::zero())
   {
     ignerr << "<smooth_current_tau> should be in the range [dt, +inf) but is "
-           << "configured with [" << this->dataPtr->tau << "]. We'll be using "
+           << "configured with [" << this->tau << "]. We'll be using "
            << "[" << dt << "] instead" << std::endl;
-    this->dataPtr->tau = dt;
+    this->tau = dt;
   }
 
-  if (this->dataPtr->battery)
+  if (this->battery)
   {
-    this->dataPtr->battery->Update();
+    this->battery->Update();
+    this->stateChanged = true;
 
     // Update component
     auto *batteryComp =
-      _ecm.Component<components::BatterySoC>(this->dataPtr->batteryEntity);
+      _ecm.Component<components::BatterySoC>(this->batteryEntity);
 
-    batteryComp->Data() = this->dataPtr->StateOfCharge();
+    if (batteryComp && batteryComp->Data() != this->StateOfCharge())
+    {
+      batteryComp->Data() = this->StateOfCharge();
+      _ecm.SetChanged(this->batteryEntity, components::BatterySoC::typeId,
+          ComponentState::PeriodicChange);
+    }
   }
 }
 
@@ -512,6 +606,15 @@ void LinearBatteryPlugin::PostUpdate(const UpdateInfo &_info,
   if (_info.paused || !this->dataPtr->statePub)
     return;
 
+  // With an update period, the state only changes when integrated
+  if (this->dataPtr->updatePeriod >
+      std::chrono::steady_clock::duration::zero())
+  {
+    if (!this->dataPtr->stateChanged)
+      return;
+    this->dataPtr->stateChanged = false;
+  }
+
   // Publish battery state
   msgs::BatteryState msg;
   msg.mutable_header()->mutable_stamp()->CopyFrom(
@@ -543,9 +646,9 @@ double LinearBatteryPlugin::OnUpdateVoltage(
 {
   IGN_ASSERT(_battery != nullptr, "common::Battery is null.");
 
-  if (fabs(_battery->Voltage()) < 1e-3 && !this->dataPtr->startCharging)
+  if (fabs(_battery->Voltage()) < 1e-3 && !this->dataPtr->loadCharging)
     return 0.0;
-  if (this->dataPtr->StateOfCharge() < 0 && !this->dataPtr->startCharging)
+  if (this->dataPtr->StateOfCharge() < 0 && !this->dataPtr->loadCharging)
     return _battery->Voltage();
 
   auto prevSocInt = static_cast<int>(this->dataPtr->StateOfCharge() * 100);
@@ -556,7 +659,7 @@ double LinearBatteryPlugin::OnUpdateVoltage(
   double totalpower = 0.0;
   double k = dt / this->dataPtr->tau;
 
-  if (this->dataPtr->startDraining)
+  if (this->dataPtr->loadDraining)
   {
     for (auto powerLoad : _battery->PowerLoads())
       totalpower += powerLoad.second;
@@ -568,11 +671,29 @@ double LinearBatteryPlugin::OnUpdateVoltage(
   auto iCharge = this->dataPtr->c / this->dataPtr->tCharge;
 
   // add charging current to battery
-  if (this->dataPtr->startCharging && this->dataPtr->StateOfCharge() < 0.9)
+  if (this->dataPtr->loadCharging && this->dataPtr->StateOfCharge() < 0.9)
     this->dataPtr->iraw -= iCharge;
 
-  this->dataPtr->ismooth = this->dataPtr->ismooth + k *
-    (this->dataPtr->iraw - this->dataPtr->ismooth);
+  // Charge drawn, in Ah
+  double drawn{0.0};
+  if (this->dataPtr->updatePeriod ==
+      std::chrono::steady_clock::duration::zero())
+  {
+    this->dataPtr->ismooth = this->dataPtr->ismooth + k *
+      (this->dataPtr->iraw - this->dataPtr->ismooth);
+    drawn = dt * this->dataPtr->ismooth / 3600.0;
+  }
+  else
+  {
+    // The raw current is constant over the interval, so the smoothed current
+    // decays exponentially towards it, and its integral has a closed form
+    double decay = exp(-k);
+    double i0 = this->dataPtr->ismooth;
+    this->dataPtr->ismooth = this->dataPtr->iraw +
+      (i0 - this->dataPtr->iraw) * decay;
+    drawn = (this->dataPtr->iraw * dt +
+      (i0 - this->dataPtr->iraw) * this->dataPtr->tau * (1 - decay)) / 3600.0;
+  }
 
   if (!this->dataPtr->fixIssue225)
   {
@@ -585,9 +706,7 @@ double LinearBatteryPlugin::OnUpdateVoltage(
     this->dataPtr->dtList.push_back(dt);
   }
 
-  // Convert dt to hours
-  this->dataPtr->q = this->dataPtr->q - ((dt * this->dataPtr->ismooth) /
-    3600.0);
+  this->dataPtr->q = this->dataPtr->q - drawn;
 
   // open circuit voltage
   double voltage = this->dataPtr->e0 + this->dataPtr->e1 * (
@@ -58,6 +58,12 @@ namespace systems
   ///                 (Required if <enable_recharge> is set to true)
   /// <fix_issue_225> True to change the battery behavior to fix some issues
   /// described in https://github.com/ignitionrobotics/ign-gazebo/issues/225.
+  /// <update_rate> Rate in Hz of simulation time at which the battery is
+  ///               integrated and its BatterySoC component and state are
+  ///               updated. The time in between is integrated at once,
+  ///               solving the current smoothing exactly, and also when the
+  ///               battery starts or stops draining or charging. Defaults to
+  ///               0, which integrates every step.
   class IGNITION_GAZEBO_VISIBLE LinearBatteryPlugin
       : public System,
         public ISystemConfigure,
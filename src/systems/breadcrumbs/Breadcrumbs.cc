@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <iterator>
 #include <string>
+#include <tuple>
 #include <utility>
 
 #include <ignition/common/Profiler.hh>
@@ -41,6 +42,7 @@
 #include "ignition/gazebo/components/ParentEntity.hh"
 #include "ignition/gazebo/components/Performer.hh"
 #include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/PoseCmd.hh"
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/Util.hh"
 
@@ -168,9 +170,110 @@ void Breadcrumbs::Configure(const Entity &_entity,
 
   this->worldEntity = _ecm.EntityByComponents(components::World());
 
+  if (_sdf->HasElement("pool"))
+    this->CreatePool(_sdf->GetElementImpl("pool"), _ecm);
+
   this->initialized = true;
 }
 
+//////////////////////////////////////////////////
+void Breadcrumbs::CreatePool(const sdf::ElementPtr &_sdf,
+    EntityComponentManager &_ecm)
+{
+  int size = _sdf->Get<int>("size", 0).first;
+  if (this->maxDeployments > 0)
+    size = std::min(size, this->maxDeployments);
+  if (size <= 0)
+    return;
+
+  const math::Pose3d poolPose = _sdf->Get<math::Pose3d>("pose",
+      math::Pose3d(0, 0, -1000, 0, 0, 0)).first;
+  const double spacing = _sdf->Get<double>("spacing", 1.0).first;
+  const sdf::Model &templateModel = *this->modelRoot.ModelByIndex(0);
+
+  // Static model holding the pooled breadcrumbs in place
+  Entity staticLink{kNullEntity};
+  if (!templateModel.Static())
+  {
+    this->LoadStaticModel();
+    std::string staticName = templateModel.Name() + "__pool__";
+    this->MakeUniqueName(_ecm, staticName, true);
+    sdf::Model staticModel = this->staticModelToSpawn;
+    staticModel.SetName(staticName);
+    staticModel.SetRawPose(poolPose);
+    Entity staticEntity = this->creator->CreateEntities(&staticModel);
+    this->creator->SetParent(staticEntity, this->worldEntity);
+    this->modelNames.insert(staticName);
+    staticLink = _ecm.EntityByComponents(components::Link(),
+        components::ParentEntity(staticEntity),
+        components::Name("static_link"));
+  }
+
+  for (int i = 0; i < size; ++i)
+  {
+    sdf::Model modelToSpawn = templateModel;
+    std::string name = modelToSpawn.Name() + "_" + std::to_string(i);
+    if (!this->MakeUniqueName(_ecm, name, this->allowRenaming))
+    {
+      ignwarn << "Entity named [" << name << "] already exists and "
+              << "[allow_renaming] is false. The breadcrumb pool only has ["
+              << i << "] breadcrumbs." << std::endl;
+      break;
+    }
+    modelToSpawn.SetName(name);
+    modelToSpawn.SetRawPose(
+        poolPose * math::Pose3d(i * spacing, 0, 0, 0, 0, 0));
+
+    Entity entity = this->creator->CreateEntities(&modelToSpawn);
+    this->creator->SetParent(entity, this->worldEntity);
+    this->modelNames.insert(name);
+
+    Entity joint{kNullEntity};
+    if (kNullEntity != staticLink)
+      joint = this->AttachToStatic(staticLink, entity, _ecm);
+    this->pool.emplace_back(entity, joint);
+  }
+
+  this->modelNames.clear();
+  this->modelNamesValid = false;
+
+  igndbg << "Created a pool of [" << this->pool.size() << "] breadcrumbs."
+         << std::endl;
+}
+
+//////////////////////////////////////////////////
+bool Breadcrumbs::MakeUniqueName(const EntityComponentManager &_ecm,
+    std::string &_name, bool _allowRenaming)
+{
+  if (!this->modelNamesValid)
+  {
+    _ecm.Each<components::Name, components::Model>(
+        [&](const Entity &, const components::Name *_nameComp,
+            const components::Model *)
+        {
+          this->modelNames.insert(_nameComp->Data());
+          return true;
+        });
+    this->modelNamesValid = true;
+  }
+
+  // Check if there's a model with the same name.
+  if (this->modelNames.find(_name) == this->modelNames.end())
+    return true;
+
+  if (!_allowRenaming)
+    return false;
+
+  std::string newName = _name;
+  int counter = 0;
+  while (this->modelNames.find(newName) != this->modelNames.end())
+  {
+    newName = _name + "_" + std::to_string(++counter);
+  }
+  _name = newName;
+  return true;
+}
+
 //////////////////////////////////////////////////
 void Breadcrumbs::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
     ignition::gazebo::EntityComponentManager &_ecm)
@@ -196,6 +299,15 @@ void Breadcrumbs::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
       return;
     }
 
+    // Move pooled breadcrumbs deployed on the previous iteration, now that
+    // they've been detached
+    for (const auto &[entity, pose] : this->poolPoses)
+    {
+      if (_ecm.HasEntity(entity))
+        _ecm.CreateComponent(entity, components::WorldPoseCmd(pose));
+    }
+    this->poolPoses.clear();
+
     auto poseComp = _ecm.Component<components::Pose>(this->model.Entity());
 
     for (std::size_t i = 0; i < cmds.size(); ++i)
@@ -203,51 +315,48 @@ void Breadcrumbs::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
       if (this->maxDeployments < 0 ||
           this->numDeployments < this->maxDeployments)
       {
-        sdf::Model modelToSpawn = *this->modelRoot.ModelByIndex(0);
-        std::string desiredName =
-            modelToSpawn.Name() + "_" + std::to_string(this->numDeployments);
-
-        std::vector<std::string> modelNames;
-        _ecm.Each<components::Name, components::Model>(
-            [&modelNames](const Entity &, const components::Name *_name,
-                          const components::Model *)
-            {
-              modelNames.push_back(_name->Data());
-              return true;
-            });
+        const sdf::Model &templateModel = *this->modelRoot.ModelByIndex(0);
+        const math::Pose3d pose = poseComp->Data() * templateModel.RawPose();
 
-        // Check if there's a model with the same name.
-        auto it = std::find(modelNames.begin(), modelNames.end(), desiredName);
-        if (it != modelNames.end())
+        Entity entity{kNullEntity};
+        std::string name;
+        if (!this->pool.empty())
+        {
+          // Release a pooled breadcrumb
+          Entity joint;
+          std::tie(entity, joint) = this->pool.front();
+          this->pool.pop_front();
+          if (kNullEntity != joint)
+            _ecm.RequestRemoveEntity(joint);
+          this->poolPoses.emplace_back(entity, pose);
+          name = _ecm.Component<components::Name>(entity)->Data();
+        }
+        else
         {
-          if (!this->allowRenaming)
+          name = templateModel.Name() + "_" +
+              std::to_string(this->numDeployments);
+          if (!this->MakeUniqueName(_ecm, name, this->allowRenaming))
           {
-            ignwarn << "Entity named [" << desiredName
+            ignwarn << "Entity named [" << name
                     << "] already exists and "
                     << "[allow_renaming] is false. Entity not spawned."
                     << std::endl;
+            this->modelNames.clear();
+            this->modelNamesValid = false;
             return;
           }
 
-          std::string newName = desiredName;
-          int counter = 0;
-          while (std::find(modelNames.begin(), modelNames.end(), newName) !=
-                 modelNames.end())
-          {
-            newName = desiredName + "_" + std::to_string(++counter);
-          }
-          desiredName = newName;
+          sdf::Model modelToSpawn = templateModel;
+          modelToSpawn.SetName(name);
+          modelToSpawn.SetRawPose(pose);
+          entity = this->creator->CreateEntities(&modelToSpawn);
+          this->creator->SetParent(entity, this->worldEntity);
+          this->modelNames.insert(name);
         }
-
-        modelToSpawn.SetName(desiredName);
-        modelToSpawn.SetRawPose(poseComp->Data() * modelToSpawn.RawPose());
-        ignmsg << "Deploying " << modelToSpawn.Name() << " at "
-               << modelToSpawn.RawPose() << std::endl;
-        Entity entity = this->creator->CreateEntities(&modelToSpawn);
-        this->creator->SetParent(entity, this->worldEntity);
+        ignmsg << "Deploying " << name << " at " << pose << std::endl;
 
         // keep track of entities that are set to auto disable
-        if (!modelToSpawn.Static() &&
+        if (!templateModel.Static() &&
             this->disablePhysicsTime >
             std::chrono::steady_clock::duration::zero())
         {
@@ -259,7 +368,7 @@ void Breadcrumbs::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
           auto worldName =
               _ecm.Component<components::Name>(this->worldEntity)->Data();
           msgs::StringMsg req;
-          req.set_data(modelToSpawn.Name());
+          req.set_data(name);
           this->node.Request<msgs::StringMsg, msgs::Boolean>(
               "/world/" + worldName + "/level/set_performer", req,
               [](const msgs::Boolean &, const bool)
@@ -287,6 +396,8 @@ void Breadcrumbs::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
       remainingMsg.set_data(this->maxDeployments - this->numDeployments);
       this->remainingPub.Publish(remainingMsg);
     }
+    this->modelNames.clear();
+    this->modelNamesValid = false;
 
     std::set<Entity> processedEntities;
     for (const auto &e : this->pendingGeometryUpdate)
@@ -354,16 +465,7 @@ bool Breadcrumbs::MakeStatic(Entity _entity, EntityComponentManager &_ecm)
   // breadcrumb to the static model
   // todo(anyone) Add a feature in ign-physics to support making a model
   // static
-  if (this->staticModelToSpawn.LinkCount() == 0u)
-  {
-    sdf::ElementPtr staticModelSDF(new sdf::Element);
-    sdf::initFile("model.sdf", staticModelSDF);
-    staticModelSDF->GetAttribute("name")->Set("static_model");
-    staticModelSDF->GetElement("static")->Set(true);
-    sdf::ElementPtr linkElem = staticModelSDF->AddElement("link");
-    linkElem->GetAttribute("name")->Set("static_link");
-    this->staticModelToSpawn.Load(staticModelSDF);
-  }
+  this->LoadStaticModel();
 
   auto bcPoseComp = _ecm.Component<components::Pose>(_entity);
   if (!bcPoseComp)
@@ -384,18 +486,40 @@ bool Breadcrumbs::MakeStatic(Entity _entity, EntityComponentManager &_ecm)
   if (parentLinkEntity == kNullEntity)
     return false;
 
+  return kNullEntity != this->AttachToStatic(parentLinkEntity, _entity, _ecm);
+}
+
+//////////////////////////////////////////////////
+void Breadcrumbs::LoadStaticModel()
+{
+  if (this->staticModelToSpawn.LinkCount() != 0u)
+    return;
+
+  sdf::ElementPtr staticModelSDF(new sdf::Element);
+  sdf::initFile("model.sdf", staticModelSDF);
+  staticModelSDF->GetAttribute("name")->Set("static_model");
+  staticModelSDF->GetElement("static")->Set(true);
+  sdf::ElementPtr linkElem = staticModelSDF->AddElement("link");
+  linkElem->GetAttribute("name")->Set("static_link");
+  this->staticModelToSpawn.Load(staticModelSDF);
+}
+
+//////////////////////////////////////////////////
+Entity Breadcrumbs::AttachToStatic(Entity _staticLink, Entity _entity,
+    EntityComponentManager &_ecm)
+{
   Entity childLinkEntity = _ecm.EntityByComponents(
       components::CanonicalLink(), components::ParentEntity(_entity));
 
   if (childLinkEntity == kNullEntity)
-    return false;
+    return kNullEntity;
 
   Entity detachableJointEntity = _ecm.CreateEntity();
   _ecm.CreateComponent(detachableJointEntity,
       components::DetachableJoint(
-      {parentLinkEntity, childLinkEntity, "fixed"}));
+      {_staticLink, childLinkEntity, "fixed"}));
 
-  return true;
+  return detachableJointEntity;
 }
 
 
@@ -17,10 +17,13 @@
 #ifndef IGNITION_GAZEBO_SYSTEMS_BREADCRUMBS_HH_
 #define IGNITION_GAZEBO_SYSTEMS_BREADCRUMBS_HH_
 
+#include <deque>
 #include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <sdf/Element.hh>
@@ -83,6 +86,18 @@ namespace systems
   /// `<topic_statistics>`: If true, then topic statistics are enabled on
   /// `<topic>` and error messages will be generated when messages are
   /// dropped. Default to false.
+  /// `<pool>`: Optional. Pre-create breadcrumbs when the system is
+  /// configured, so that deploying one only moves an existing model instead
+  /// of creating new physics and rendering entities mid-simulation. Pooled
+  /// breadcrumbs are named in deployment order and held in place by fixed
+  /// joints to a static model until deployed. Once the pool is used up,
+  /// breadcrumbs are created on deployment as usual. It contains:
+  ///   `<size>`: Number of breadcrumbs to pre-create, limited by
+  ///   `<max_deployments>`.
+  ///   `<pose>`: World pose where pooled breadcrumbs wait to be deployed.
+  ///   Defaults to `0 0 -1000 0 0 0`.
+  ///   `<spacing>`: Distance in meters between pooled breadcrumbs, along the
+  ///   X axis of `<pose>`. Defaults to 1.
   class IGNITION_GAZEBO_VISIBLE Breadcrumbs
       : public System,
         public ISystemConfigure,
@@ -111,6 +126,34 @@ namespace systems
     /// \return True if operation is successful, false otherwise
     public: bool MakeStatic(Entity _entity, EntityComponentManager &_ecm);
 
+    /// \brief Load staticModelToSpawn if it hasn't been loaded yet.
+    private: void LoadStaticModel();
+
+    /// \brief Create a fixed joint between a static link and the canonical
+    /// link of a model.
+    /// \param[in] _staticLink Link of a static model
+    /// \param[in] _entity Model to hold in place
+    /// \param[in] _ecm Entity component manager
+    /// \return The entity of the detachable joint, or kNullEntity if the
+    /// model has no canonical link
+    private: Entity AttachToStatic(Entity _staticLink, Entity _entity,
+                 EntityComponentManager &_ecm);
+
+    /// \brief Pre-create the pooled breadcrumbs.
+    /// \param[in] _sdf The <pool> element
+    /// \param[in] _ecm Entity component manager
+    private: void CreatePool(const sdf::ElementPtr &_sdf,
+                 EntityComponentManager &_ecm);
+
+    /// \brief Make a model name unique, if renaming is allowed.
+    /// \param[in] _ecm Entity component manager
+    /// \param[in,out] _name Desired name, which may be changed
+    /// \param[in] _allowRenaming Whether the name may be changed
+    /// \return False if a model with this name exists and renaming isn't
+    /// allowed
+    private: bool MakeUniqueName(const EntityComponentManager &_ecm,
+                 std::string &_name, bool _allowRenaming);
+
     /// \brief Set to true after initialization with valid parameters
     private: bool initialized{false};
 
@@ -165,6 +208,23 @@ namespace systems
     /// \brief SDF DOM of a static model with empty link
     private: sdf::Model staticModelToSpawn;
 
+    /// \brief Pooled breadcrumbs which haven't been deployed, in deployment
+    /// order, with the detachable joint holding each of them in place.
+    private: std::deque<std::pair<Entity, Entity>> pool;
+
+    /// \brief Pooled breadcrumbs being deployed, with their deployment pose.
+    /// They're moved on the iteration after deployment, once their joint has
+    /// been removed.
+    private: std::vector<std::pair<Entity, math::Pose3d>> poolPoses;
+
+    /// \brief Names of all models, gathered by MakeUniqueName on first use
+    /// and cleared after each update, so that they're not gathered for every
+    /// deployment.
+    private: std::unordered_set<std::string> modelNames;
+
+    /// \brief Whether modelNames has been gathered.
+    private: bool modelNamesValid{false};
+
     /// \brief Publishes remaining deployments.
     public: transport::Node::Publisher remainingPub;
 
@@ -36,6 +36,7 @@
 
 #include "ignition/gazebo/components/CenterOfVolume.hh"
 #include "ignition/gazebo/components/Collision.hh"
+#include "ignition/gazebo/components/ExternalWorldWrenchCmd.hh"
 #include "ignition/gazebo/components/Gravity.hh"
 #include "ignition/gazebo/components/Inertial.hh"
 #include "ignition/gazebo/components/Link.hh"
@@ -64,6 +65,15 @@ class ignition::gazebo::systems::BuoyancyPrivate
   /// \return The fluid density at the givein pose.
   public: double FluidDensity(const math::Pose3d &_pose) const;
 
+  /// \brief Create an empty wrench command for a buoyant link if it doesn't
+  /// have one yet. The Physics system clears the command every step instead
+  /// of removing it, so this only needs to be done once per link, and the
+  /// buoyancy of all links can then be written without creating components.
+  /// \param[in] _entity Link entity.
+  /// \param[in] _ecm Mutable reference to the ECM.
+  public: void CreateWrenchCmd(const Entity &_entity,
+              EntityComponentManager &_ecm) const;
+
   /// \brief Model interface
   public: Entity world{kNullEntity};
 
@@ -85,6 +95,19 @@ double BuoyancyPrivate::FluidDensity(const math::Pose3d & /*_pose*/) const
   return this->fluidDensity;
 }
 
+//////////////////////////////////////////////////
+void BuoyancyPrivate::CreateWrenchCmd(const Entity &_entity,
+    EntityComponentManager &_ecm) const
+{
+  if (nullptr == _ecm.Component<components::ExternalWorldWrenchCmd>(_entity))
+  {
+    components::ExternalWorldWrenchCmd wrench;
+    msgs::Set(wrench.Data().mutable_force(), math::Vector3d::Zero);
+    msgs::Set(wrench.Data().mutable_torque(), math::Vector3d::Zero);
+    _ecm.CreateComponent(_entity, wrench);
+  }
+}
+
 //////////////////////////////////////////////////
 Buoyancy::Buoyancy()
   : dataPtr(std::make_unique<BuoyancyPrivate>())
@@ -142,6 +165,7 @@ void Buoyancy::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
         _ecm.EntityHasComponentType(_entity,
           components::Volume().TypeId()))
     {
+      this->dataPtr->CreateWrenchCmd(_entity, _ecm);
       return true;
     }
 
@@ -223,6 +247,8 @@ void Buoyancy::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
 
       // Store the volume
       _ecm.CreateComponent(_entity, components::Volume(volumeSum));
+
+      this->dataPtr->CreateWrenchCmd(_entity, _ecm);
     }
 
     return true;
@@ -232,13 +258,18 @@ void Buoyancy::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
   if (_info.paused)
     return;
 
-  _ecm.Each<components::Link,
-            components::Volume,
-            components::CenterOfVolume>(
+  // Links are independent of each other, and the wrench is written to the
+  // link's own command component, so they're all processed concurrently
+  const math::Vector3d gravityVec = gravity->Data();
+  _ecm.ParallelEach<components::Link,
+                    components::Volume,
+                    components::CenterOfVolume,
+                    components::ExternalWorldWrenchCmd>(
       [&](const Entity &_entity,
-          const components::Link *,
-          const components::Volume *_volume,
-          const components::CenterOfVolume *_centerOfVolume) -> bool
+          components::Link *,
+          components::Volume *_volume,
+          components::CenterOfVolume *_centerOfVolume,
+          components::ExternalWorldWrenchCmd *_wrench)
     {
       // World pose of the link.
       math::Pose3d linkWorldPose = worldPose(_entity, _ecm);
@@ -248,7 +279,7 @@ void Buoyancy::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
       // object_density = mass/volume, so the mass term cancels.
       math::Vector3d buoyancy =
         -this->dataPtr->FluidDensity(linkWorldPose) *
-        _volume->Data() * gravity->Data();
+        _volume->Data() * gravityVec;
 
       // Convert the center of volume to the world frame
       math::Vector3d offsetWorld = linkWorldPose.Rot().RotateVector(
@@ -257,12 +288,13 @@ void Buoyancy::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
       // the center of volume.
       math::Vector3d torque = offsetWorld.Cross(buoyancy);
 
-      // Apply the wrench to the link. This wrench is applied in the
-      // Physics System.
-      Link link(_entity);
-      link.AddWorldWrench(_ecm, buoyancy, torque);
-
-      return true;
+      // Add the wrench to the link's command, the same way as
+      // Link::AddWorldWrench. This wrench is applied in the Physics System.
+      auto &wrench = _wrench->Data();
+      msgs::Set(wrench.mutable_force(),
+          msgs::Convert(wrench.force()) + buoyancy);
+      msgs::Set(wrench.mutable_torque(),
+          msgs::Convert(wrench.torque()) + torque);
   });
 }
 
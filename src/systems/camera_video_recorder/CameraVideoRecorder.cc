@@ -21,15 +21,11 @@
 #include <unordered_map>
 
 #include <ignition/common/Profiler.hh>
-#include <ignition/common/VideoEncoder.hh>
+#include <ignition/msgs/image.pb.h>
 #include <ignition/plugin/Register.hh>
 #include <ignition/transport/Node.hh>
 
-#include <ignition/rendering/Camera.hh>
-#include <ignition/rendering/RenderEngine.hh>
-#include <ignition/rendering/RenderingIface.hh>
-#include <ignition/rendering/Scene.hh>
-
+#include "ignition/gazebo/rendering/AsyncVideoEncoder.hh"
 #include "ignition/gazebo/rendering/Events.hh"
 
 #include "ignition/gazebo/components/Camera.hh"
@@ -55,30 +51,20 @@ class ignition::gazebo::systems::CameraVideoRecorderPrivate
   public: bool OnRecordVideo(const msgs::VideoRecord &_msg,
       msgs::Boolean &_res);
 
-  /// \brief Callback invoked in the rendering thread after a render update
-  public: void OnPostRender();
-
-  /// \brief Callback for new images
-  public: void OnImage(const msgs::Image &_msg);
+  /// \brief Callback for new image frames shared by the Sensors system.
+  /// Frames are encoded from these images, which the sensor already read
+  /// back from the GPU, instead of reading the camera back a second time.
+  /// \param[in] _entity Sensor entity.
+  /// \param[in] _frame Image frame.
+  public: void OnImageFrame(const Entity &_entity,
+      const std::shared_ptr<const msgs::Image> &_frame);
 
-  /// \brief Transport node
-  public: transport::Node node;
+  /// \brief Stop encoding and save the video, if encoding.
+  public: void StopEncoding();
 
   /// \brief Mutex to protect updates
   public: std::mutex updateMutex;
 
-  /// \brief Connection to the post-render event.
-  public: ignition::common::ConnectionPtr postRenderConn;
-
-  /// \brief Pointer to the event manager
-  public: EventManager *eventMgr = nullptr;
-
-  //// \brief Pointer to the rendering scene
-  public: rendering::ScenePtr scene;
-
-  /// \brief Pointer to the rendering camera
-  public: rendering::CameraPtr camera;
-
   /// \brief Name of service for recording video
   public: std::string service;
 
@@ -88,11 +74,8 @@ class ignition::gazebo::systems::CameraVideoRecorderPrivate
   /// \brief Name of the camera
   public: std::string cameraName;
 
-  /// \brief Image from user camera
-  public: rendering::Image cameraImage;
-
-  /// \brief Video encoder
-  public: common::VideoEncoder videoEncoder;
+  /// \brief Video encoder, encoding on its own thread
+  public: AsyncVideoEncoder videoEncoder;
 
   /// \brief Video encoding format
   public: std::string recordVideoFormat;
@@ -106,26 +89,105 @@ class ignition::gazebo::systems::CameraVideoRecorderPrivate
   /// \brief True to record a video from the rendering camera
   public: bool recordVideo = false;
 
-  /// \brief Topic that the sensor publishes to
-  public: std::string sensorTopic;
+  /// \brief Pointer to the event manager
+  public: EventManager *eventMgr = nullptr;
+
+  /// \brief Transport node
+  public: transport::Node node;
+
+  /// \brief Connection to the new image frame event while recording.
+  /// Declared last so frames stop arriving before the rest is destroyed.
+  public: ignition::common::ConnectionPtr frameConn;
 };
 
 //////////////////////////////////////////////////
-void CameraVideoRecorderPrivate::OnImage(const msgs::Image &)
+void CameraVideoRecorderPrivate::OnImageFrame(const Entity &_entity,
+    const std::shared_ptr<const msgs::Image> &_frame)
+{
+  if (_entity != this->entity)
+    return;
+
+  IGN_PROFILE("CameraVideoRecorderPrivate::OnImageFrame");
+  std::lock_guard<std::mutex> lock(this->updateMutex);
+  if (!this->recordVideo)
+    return;
+
+  const msgs::Image &image = *_frame;
+
+  if (image.pixel_format_type() != msgs::PixelFormatType::RGB_INT8)
+  {
+    ignerr << "Only RGB_INT8 images can be recorded, stopping video "
+           << "recording on [" << this->service << "]" << std::endl;
+    this->recordVideo = false;
+    this->StopEncoding();
+    return;
+  }
+
+  // Video recorder is idle. Start recording.
+  if (!this->videoEncoder.IsEncoding())
+  {
+    this->videoEncoder.Start(this->recordVideoFormat,
+        this->tmpVideoFilename, image.width(), image.height());
+
+    ignmsg << "Start video recording on [" << this->service << "]. "
+           << "Encoding to tmp file: ["
+           << this->tmpVideoFilename << "]" << std::endl;
+  }
+
+  // Video recorder is on. Add more frames to it, sharing the frame with the
+  // encoder's thread instead of copying it
+  std::shared_ptr<const unsigned char> data(_frame,
+      reinterpret_cast<const unsigned char *>(image.data().data()));
+  this->videoEncoder.AddFrame(data, image.width(), image.height(),
+      std::chrono::steady_clock::now());
+}
+
+//////////////////////////////////////////////////
+void CameraVideoRecorderPrivate::StopEncoding()
 {
-  // No work is done here. We need to subscribe to the sensor to make it active.
+  if (!this->videoEncoder.IsEncoding())
+    return;
+
+  // stop encoding
+  this->videoEncoder.Stop();
+
+  // move the tmp video file to user specified path
+  if (common::exists(this->tmpVideoFilename))
+  {
+    common::moveFile(this->tmpVideoFilename,
+        this->recordVideoSavePath);
+
+    // Remove old temp file, if it exists.
+    std::remove(this->tmpVideoFilename.c_str());
+  }
+  ignmsg << "Stop video recording on [" << this->service << "]. "
+         << "Saving file to: [" << this->recordVideoSavePath << "]"
+         << std::endl;
 }
 
 //////////////////////////////////////////////////
 bool CameraVideoRecorderPrivate::OnRecordVideo(const msgs::VideoRecord &_msg,
     msgs::Boolean &_res)
 {
-  std::lock_guard<std::mutex> lock(this->updateMutex);
   bool record = _msg.start() && !_msg.stop();
+
+  // Stop receiving frames, letting the sensor become inactive if there are
+  // no other consumers. This is done before locking, so a frame callback
+  // waiting for the lock doesn't hold it up.
+  if (!record && this->frameConn)
+  {
+    this->eventMgr->Emit<events::EnableImageFrames>(this->entity, false);
+    this->frameConn.reset();
+  }
+
+  std::lock_guard<std::mutex> lock(this->updateMutex);
   this->recordVideo = record;
 
   if (this->recordVideo)
   {
+    // A new recording replaces the current one
+    this->StopEncoding();
+
     this->recordVideoFormat = _msg.format();
     this->recordVideoSavePath = _msg.save_filename();
 
@@ -142,6 +204,7 @@ bool CameraVideoRecorderPrivate::OnRecordVideo(const msgs::VideoRecord &_msg,
         ignerr << "Video encoding format: '" << this->recordVideoFormat
                << "' not supported. Available formats are: mp4, ogv, and avi."
                << std::endl;
+        this->recordVideo = false;
         _res.set_data(false);
         return true;
       }
@@ -160,15 +223,20 @@ bool CameraVideoRecorderPrivate::OnRecordVideo(const msgs::VideoRecord &_msg,
     // recording is done
     this->tmpVideoFilename = std::to_string(this->entity) + "."
          + this->recordVideoFormat;
-  }
 
-  // Set up the render connection so we can do the encoding in the rendering
-  // thread
-  if (!this->postRenderConn)
+    // Requesting frames also makes the sensor active, otherwise it thinks
+    // there are no consumers and so does not actually render.
+    if (!this->frameConn)
+    {
+      this->frameConn = this->eventMgr->Connect<events::NewImageFrame>(
+          std::bind(&CameraVideoRecorderPrivate::OnImageFrame, this,
+          std::placeholders::_1, std::placeholders::_2));
+      this->eventMgr->Emit<events::EnableImageFrames>(this->entity, true);
+    }
+  }
+  else
   {
-    this->postRenderConn =
-        this->eventMgr->Connect<events::PostRender>(
-        std::bind(&CameraVideoRecorderPrivate::OnPostRender, this));
+    this->StopEncoding();
   }
 
   _res.set_data(true);
@@ -196,6 +264,7 @@ void CameraVideoRecorder::Configure(
   }
 
   this->dataPtr->entity = _entity;
+  this->dataPtr->eventMgr = &_eventMgr;
 
   // video recorder service topic name
   if (_sdf->HasElement("service"))
@@ -208,157 +277,6 @@ void CameraVideoRecorder::Configure(
              << "] not valid. Ignoring." << std::endl;
     }
   }
-  this->dataPtr->eventMgr = &_eventMgr;
-
-  // get sensor topic
-  sdf::Sensor sensorSdf = cameraEntComp->Data();
-  std::string topic  = sensorSdf.Topic();
-  if (topic.empty())
-  {
-    auto scoped = scopedName(_entity, _ecm);
-    topic = transport::TopicUtils::AsValidTopic(scoped + "/image");
-    if (topic.empty())
-    {
-      ignerr << "Failed to generate valid topic for entity [" << scoped
-             << "]" << std::endl;
-    }
-  }
-  this->dataPtr->sensorTopic = topic;
-}
-
-//////////////////////////////////////////////////
-void CameraVideoRecorderPrivate::OnPostRender()
-{
-  // get scene
-  if (!this->scene)
-  {
-    auto loadedEngNames = rendering::loadedEngines();
-    if (loadedEngNames.empty())
-      return;
-
-    // assume there is only one engine loaded
-    auto engineName = loadedEngNames[0];
-    if (loadedEngNames.size() > 1)
-    {
-      igndbg << "More than one engine is available. "
-        << "Camera video recorder system will use engine ["
-          << engineName << "]" << std::endl;
-    }
-    auto engine = rendering::engine(engineName);
-    if (!engine)
-    {
-      ignerr << "Internal error: failed to load engine [" << engineName
-        << "]. Camera video recorder system won't work." << std::endl;
-      return;
-    }
-
-    if (engine->SceneCount() == 0)
-      return;
-
-    // assume there is only one scene
-    // load scene
-    auto s = engine->SceneByIndex(0);
-    if (!s)
-    {
-      ignerr << "Internal error: scene is null." << std::endl;
-      return;
-    }
-    this->scene = s;
-  }
-
-  // return if scene not ready or no sensors available.
-  if (!this->scene->IsInitialized() ||
-      this->scene->SensorCount() == 0)
-  {
-    return;
-  }
-
-  // get camera
-  if (!this->camera)
-  {
-    auto sensor = this->scene->SensorByName(this->cameraName);
-    if (!sensor)
-    {
-      ignerr << "Unable to find sensor: " << this->cameraName
-             << std::endl;
-      return;
-    }
-    this->camera = std::dynamic_pointer_cast<rendering::Camera>(sensor);
-    if (!this->camera)
-    {
-      ignerr << "Sensor: " << this->cameraName << " is not a caemra"
-             << std::endl;
-      return;
-    }
-
-    return;
-  }
-
-  std::lock_guard<std::mutex> lock(this->updateMutex);
-
-  // record video
-  if (this->recordVideo)
-  {
-    unsigned int width = this->camera->ImageWidth();
-    unsigned int height = this->camera->ImageHeight();
-
-    if (this->cameraImage.Width() != width ||
-        this->cameraImage.Height() != height)
-    {
-      this->cameraImage = this->camera->CreateImage();
-    }
-
-    // Video recorder is on. Add more frames to it
-    if (this->videoEncoder.IsEncoding())
-    {
-      this->camera->Copy(this->cameraImage);
-      this->videoEncoder.AddFrame(
-          this->cameraImage.Data<unsigned char>(), width, height);
-    }
-    // Video recorder is idle. Start recording.
-    else
-    {
-      // hack! subscribe to the camera sensor topic in order to make the sensor
-      // active, otherwise the sensor thinks there are no subscribers and so
-      // does not actually render.
-      // todo(anyone) Make it possible to get a pointer to the sensor object so
-      // we can connect to its new image event
-      this->node.Subscribe(this->sensorTopic,
-          &CameraVideoRecorderPrivate::OnImage, this);
-
-      this->videoEncoder.Start(this->recordVideoFormat,
-          this->tmpVideoFilename, width, height);
-
-      ignmsg << "Start video recording on [" << this->service << "]. "
-             << "Encoding to tmp file: ["
-             << this->tmpVideoFilename << "]" << std::endl;
-    }
-  }
-  else if (this->videoEncoder.IsEncoding())
-  {
-    // unsubscribe to let the sensor become inactive if there are no
-    // other connections
-    this->node.Unsubscribe(this->sensorTopic);
-
-    // stop encoding
-    this->videoEncoder.Stop();
-
-    // move the tmp video file to user specified path
-    if (common::exists(this->tmpVideoFilename))
-    {
-      common::moveFile(this->tmpVideoFilename,
-          this->recordVideoSavePath);
-
-      // Remove old temp file, if it exists.
-      std::remove(this->tmpVideoFilename.c_str());
-    }
-    ignmsg << "Stop video recording on [" << this->service << "]. "
-           << "Saving file to: [" << this->recordVideoSavePath << "]"
-           << std::endl;
-
-    // reset the event connection to prevent unnecessary render callbacks
-    this->postRenderConn.reset();
-  }
 }
 
 //////////////////////////////////////////////////
@@ -15,7 +15,13 @@
  *
  */
 
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <optional>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <ignition/plugin/Register.hh>
@@ -33,6 +39,7 @@
 #include <ignition/gazebo/EntityComponentManager.hh>
 #include <ignition/gazebo/Util.hh>
 
+#include <sdf/Material.hh>
 #include <sdf/Visual.hh>
 #include <sdf/Mesh.hh>
 #include <sdf/Model.hh>
@@ -53,6 +60,35 @@ using namespace gazebo;
 using namespace systems;
 
 
+/// \brief Data of a visual needed to export it.
+struct VisualData
+{
+  /// \brief Pose of the visual in the world.
+  math::Pose3d worldPose;
+
+  /// \brief Geometry of the visual.
+  sdf::Geometry geometry;
+
+  /// \brief Material of the visual, if any.
+  std::optional<sdf::Material> material;
+
+  /// \brief Transparency of the visual.
+  double transparency{0.0};
+};
+
+/// \brief A submesh added to the world mesh, which still has to be placed.
+struct SubMeshPlacement
+{
+  /// \brief Submesh of the world mesh.
+  std::shared_ptr<common::SubMesh> subMesh;
+
+  /// \brief Scale of the geometry.
+  math::Vector3d scale;
+
+  /// \brief Pose of the visual in the world.
+  math::Matrix4d matrix;
+};
+
 class ignition::gazebo::systems::ColladaWorldExporterPrivate
 {
   // Default constructor
@@ -61,184 +97,264 @@ class ignition::gazebo::systems::ColladaWorldExporterPrivate
   /// \brief Has the world already been exported?.
   private: bool exported{false};
 
-  /// \brief Exports the world to a mesh.
+  /// \brief Exports the visuals of the world to a mesh. Meshes are looked up
+  /// and loaded through the MeshManager on the calling thread, and only the
+  /// world mesh, which is owned by the export, is baked in parallel. The
+  /// export is complete when this returns.
   /// \param[_ecm] _ecm Mutable reference to the EntityComponentManager.
   public: void Export(const EntityComponentManager &_ecm)
   {
     if (this->exported) return;
+    this->exported = true;
 
-    common::Mesh worldMesh;
-    std::vector<math::Matrix4d> subMeshMatrix;
-
+    std::string worldName;
     _ecm.Each<components::World, components::Name>(
       [&](const Entity /*& _entity*/,
         const components::World *,
         const components::Name * _name)->bool
     {
-      worldMesh.SetName(_name->Data());
+      worldName = _name->Data();
       return true;
     });
 
+    std::vector<VisualData> visuals;
     _ecm.Each<components::Visual,
-            components::Name,
             components::Geometry,
             components::Transparency>(
     [&](const ignition::gazebo::Entity &_entity,
         const components::Visual *,
-        const components::Name *_name,
         const components::Geometry *_geom,
         const components::Transparency *_transparency)->bool
     {
-      std::string name = _name->Data().empty() ? std::to_string(_entity) :
-          _name->Data();
+      VisualData visual;
+      visual.worldPose = gazebo::worldPose(_entity, _ecm);
+      visual.geometry = _geom->Data();
+      visual.transparency = _transparency->Data();
 
-      math::Pose3d worldPose = gazebo::worldPose(_entity, _ecm);
-
-      common::MaterialPtr mat = std::make_shared<common::Material>();
       auto material = _ecm.Component<components::Material>(_entity);
       if (material != nullptr)
+        visual.material = material->Data();
+
+      visuals.push_back(std::move(visual));
+      return true;
+    });
+
+    common::Mesh worldMesh;
+    worldMesh.SetName(worldName);
+
+    // Copy the submeshes and their materials into the world mesh. This
+    // reads meshes held by the MeshManager, which isn't thread-safe, so it's
+    // done in order on this thread.
+    std::vector<SubMeshPlacement> placements;
+    for (const auto &visual : visuals)
+      AddVisual(worldMesh, visual, placements);
+
+    Bake(worldMesh, placements);
+  }
+
+  /// \brief Place the submeshes of the world mesh and export it.
+  /// \param[in, out] _worldMesh World mesh, holding copies of the submeshes.
+  /// \param[in] _placements Placements of the submeshes.
+  private: static void Bake(common::Mesh &_worldMesh,
+      const std::vector<SubMeshPlacement> &_placements)
+  {
+    // Place every submesh in the world. Submeshes are independent copies
+    // owned by the world mesh, so they are split among threads.
+    const std::size_t threads =
+        std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t chunk = (_placements.size() + threads - 1) / threads;
+    std::vector<std::future<void>> futures;
+    for (std::size_t begin = 0; begin < _placements.size(); begin += chunk)
+    {
+      const std::size_t end = std::min(begin + chunk, _placements.size());
+      futures.push_back(std::async(std::launch::async, [&, begin, end]
+          {
+            for (std::size_t i = begin; i < end; ++i)
+              TransformSubMesh(_placements[i]);
+          }));
+    }
+    for (auto &future : futures)
+      future.get();
+
+    // Vertices are already in the world frame, so no matrices are needed
+    common::ColladaExporter exporter;
+    exporter.Export(&_worldMesh, "./" + _worldMesh.Name(), true);
+    ignmsg << "The world has been exported into the "
+           << "./" + _worldMesh.Name() << " directory." << std::endl;
+  }
+
+  /// \brief Add the submeshes of a visual to the world mesh.
+  /// \param[in, out] _worldMesh World mesh.
+  /// \param[in] _visual Visual to add.
+  /// \param[in, out] _placements Placements of the added submeshes.
+  private: static void AddVisual(common::Mesh &_worldMesh,
+      const VisualData &_visual, std::vector<SubMeshPlacement> &_placements)
+  {
+    const auto &geom = _visual.geometry;
+    math::Pose3d worldPose = _visual.worldPose;
+
+    common::MaterialPtr mat = std::make_shared<common::Material>();
+    if (_visual.material)
+    {
+      mat->SetDiffuse(_visual.material->Diffuse());
+      mat->SetAmbient(_visual.material->Ambient());
+      mat->SetEmissive(_visual.material->Emissive());
+      mat->SetSpecular(_visual.material->Specular());
+    }
+    mat->SetTransparency(_visual.transparency);
+
+    const ignition::common::Mesh *mesh;
+    math::Vector3d scale;
+    ignition::common::MeshManager *meshManager =
+        ignition::common::MeshManager::Instance();
+
+    auto addSubmeshFunc = [&](unsigned int k, int i) {
+        auto subm = _worldMesh.AddSubMesh(
+            *mesh->SubMeshByIndex(k).lock().get()).lock();
+        subm->SetMaterialIndex(i);
+        _placements.push_back({subm, scale, math::Matrix4d(worldPose)});
+    };
+
+    if (geom.Type() == sdf::GeometryType::BOX)
+    {
+      if (meshManager->HasMesh("unit_box"))
       {
-        mat->SetDiffuse(material->Data().Diffuse());
-        mat->SetAmbient(material->Data().Ambient());
-        mat->SetEmissive(material->Data().Emissive());
-        mat->SetSpecular(material->Data().Specular());
-      }
-      mat->SetTransparency(_transparency->Data());
-
-      const ignition::common::Mesh *mesh;
-      std::weak_ptr<ignition::common::SubMesh> subm;
-      math::Vector3d scale;
-      math::Matrix4d matrix(worldPose);
-      ignition::common::MeshManager *meshManager =
-          ignition::common::MeshManager::Instance();
-
-      auto addSubmeshFunc = [&](int i) {
-          subm = worldMesh.AddSubMesh(
-              *mesh->SubMeshByIndex(0).lock().get());
-          subm.lock()->SetMaterialIndex(i);
-          subm.lock()->Scale(scale);
-          subMeshMatrix.push_back(matrix);
-      };
-
-      if (_geom->Data().Type() == sdf::GeometryType::BOX)
-      {
-        if (meshManager->HasMesh("unit_box"))
-        {
-          mesh = meshManager->MeshByName("unit_box");
-          scale = _geom->Data().BoxShape()->Size();
-          int i = worldMesh.AddMaterial(mat);
+        mesh = meshManager->MeshByName("unit_box");
+        scale = geom.BoxShape()->Size();
+        int i = _worldMesh.AddMaterial(mat);
 
-          addSubmeshFunc(i);
-        }
+        addSubmeshFunc(0, i);
       }
-      else if (_geom->Data().Type() == sdf::GeometryType::CYLINDER)
+    }
+    else if (geom.Type() == sdf::GeometryType::CYLINDER)
+    {
+      if (meshManager->HasMesh("unit_cylinder"))
       {
-        if (meshManager->HasMesh("unit_cylinder"))
-        {
-          mesh = meshManager->MeshByName("unit_cylinder");
-          scale.X() = _geom->Data().CylinderShape()->Radius() * 2;
-          scale.Y() = scale.X();
-          scale.Z() = _geom->Data().CylinderShape()->Length();
+        mesh = meshManager->MeshByName("unit_cylinder");
+        scale.X() = geom.CylinderShape()->Radius() * 2;
+        scale.Y() = scale.X();
+        scale.Z() = geom.CylinderShape()->Length();
 
-          int i = worldMesh.AddMaterial(mat);
+        int i = _worldMesh.AddMaterial(mat);
 
-          addSubmeshFunc(i);
-        }
+        addSubmeshFunc(0, i);
       }
-      else if (_geom->Data().Type() == sdf::GeometryType::PLANE)
+    }
+    else if (geom.Type() == sdf::GeometryType::PLANE)
+    {
+      if (meshManager->HasMesh("unit_plane"))
       {
-        if (meshManager->HasMesh("unit_plane"))
-        {
-          // Create a rotation for the plane mesh to account
-          // for the normal vector.
-          mesh = meshManager->MeshByName("unit_plane");
-
-          scale.X() = _geom->Data().PlaneShape()->Size().X();
-          scale.Y() = _geom->Data().PlaneShape()->Size().Y();
-
-          // // The rotation is the angle between the +z(0,0,1) vector and the
-          // // normal, which are both expressed in the local (Visual) frame.
-          math::Vector3d normal = _geom->Data().PlaneShape()->Normal();
-          math::Quaterniond normalRot;
-          normalRot.From2Axes(math::Vector3d::UnitZ, normal.Normalized());
-          worldPose.Rot() = worldPose.Rot() * normalRot;
-
-          matrix = math::Matrix4d(worldPose);
-
-          int i = worldMesh.AddMaterial(mat);
-          addSubmeshFunc(i);
-        }
+        // Create a rotation for the plane mesh to account
+        // for the normal vector.
+        mesh = meshManager->MeshByName("unit_plane");
+
+        scale.X() = geom.PlaneShape()->Size().X();
+        scale.Y() = geom.PlaneShape()->Size().Y();
+
+        // // The rotation is the angle between the +z(0,0,1) vector and the
+        // // normal, which are both expressed in the local (Visual) frame.
+        math::Vector3d normal = geom.PlaneShape()->Normal();
+        math::Quaterniond normalRot;
+        normalRot.From2Axes(math::Vector3d::UnitZ, normal.Normalized());
+        worldPose.Rot() = worldPose.Rot() * normalRot;
+
+        int i = _worldMesh.AddMaterial(mat);
+        addSubmeshFunc(0, i);
       }
-      else if (_geom->Data().Type() == sdf::GeometryType::SPHERE)
+    }
+    else if (geom.Type() == sdf::GeometryType::SPHERE)
+    {
+      if (meshManager->HasMesh("unit_sphere"))
       {
-        if (meshManager->HasMesh("unit_sphere"))
-        {
-          mesh = meshManager->MeshByName("unit_sphere");
+        mesh = meshManager->MeshByName("unit_sphere");
 
-          scale.X() = _geom->Data().SphereShape()->Radius() * 2;
-          scale.Y() = scale.X();
-          scale.Z() = scale.X();
+        scale.X() = geom.SphereShape()->Radius() * 2;
+        scale.Y() = scale.X();
+        scale.Z() = scale.X();
 
-          int i = worldMesh.AddMaterial(mat);
+        int i = _worldMesh.AddMaterial(mat);
 
-          addSubmeshFunc(i);
-        }
+        addSubmeshFunc(0, i);
       }
-      else if (_geom->Data().Type() == sdf::GeometryType::MESH)
+    }
+    else if (geom.Type() == sdf::GeometryType::MESH)
+    {
+      auto fullPath = asFullPath(geom.MeshShape()->Uri(),
+          geom.MeshShape()->FilePath());
+
+      if (fullPath.empty())
       {
-        auto fullPath = asFullPath(_geom->Data().MeshShape()->Uri(),
-            _geom->Data().MeshShape()->FilePath());
+        ignerr << "Mesh geometry missing uri" << std::endl;
+        return;
+      }
 
-        if (fullPath.empty())
-        {
-          ignerr << "Mesh geometry missing uri" << std::endl;
-          return true;
-        }
-        mesh = meshManager->Load(fullPath);
+      // Meshes which were already loaded, for example by physics, are
+      // reused.
+      mesh = meshManager->HasMesh(fullPath) ?
+          meshManager->MeshByName(fullPath) : meshManager->Load(fullPath);
 
-        if (!mesh) {
-          ignerr << "mesh not found!" << std::endl;
-          return true;
-        }
+      if (!mesh) {
+        ignerr << "mesh not found!" << std::endl;
+        return;
+      }
 
-        for (unsigned int k = 0; k < mesh->SubMeshCount(); k++)
-        {
-          auto subMeshLock = mesh->SubMeshByIndex(k).lock();
-          int j = subMeshLock->MaterialIndex();
+      scale = geom.MeshShape()->Scale();
+      for (unsigned int k = 0; k < mesh->SubMeshCount(); k++)
+      {
+        auto subMeshLock = mesh->SubMeshByIndex(k).lock();
+        int j = subMeshLock->MaterialIndex();
 
-          int i = 0;
-          if (j != -1)
-          {
-            i = worldMesh.IndexOfMaterial(mesh->MaterialByIndex(j).get());
-            if (i < 0)
-            {
-              i = worldMesh.AddMaterial(mesh->MaterialByIndex(j));
-            }
-          }
-          else
+        int i = 0;
+        if (j != -1)
+        {
+          i = _worldMesh.IndexOfMaterial(mesh->MaterialByIndex(j).get());
+          if (i < 0)
           {
-            i = worldMesh.AddMaterial(mat);
+            i = _worldMesh.AddMaterial(mesh->MaterialByIndex(j));
           }
-
-          scale = _geom->Data().MeshShape()->Scale();
-
-          addSubmeshFunc(i);
         }
-      }
-      else
-      {
-        ignwarn << "Unsupported geometry type" << std::endl;
-      }
+        else
+        {
+          i = _worldMesh.AddMaterial(mat);
+        }
 
-      return true;
-    });
+        addSubmeshFunc(k, i);
+      }
+    }
+    else
+    {
+      ignwarn << "Unsupported geometry type" << std::endl;
+    }
+  }
 
-    common::ColladaExporter exporter;
-    exporter.Export(&worldMesh, "./" + worldMesh.Name(), true,
-                    subMeshMatrix);
-    ignmsg << "The world has been exported into the "
-           << "./" + worldMesh.Name() << " directory." << std::endl;
-    this->exported = true;
+  /// \brief Scale a submesh and transform it to the world frame. Normals
+  /// are only rotated, like the COLLADA exporter does.
+  /// \param[in] _placement Submesh and its transform.
+  private: static void TransformSubMesh(const SubMeshPlacement &_placement)
+  {
+    auto &subMesh = *_placement.subMesh;
+    const auto &m = _placement.matrix;
+    const auto &s = _placement.scale;
+
+    // Fold the scale into the affine transform, so each vertex only costs
+    // nine multiply-adds
+    const double a[3][4] = {
+      {m(0, 0) * s.X(), m(0, 1) * s.Y(), m(0, 2) * s.Z(), m(0, 3)},
+      {m(1, 0) * s.X(), m(1, 1) * s.Y(), m(1, 2) * s.Z(), m(1, 3)},
+      {m(2, 0) * s.X(), m(2, 1) * s.Y(), m(2, 2) * s.Z(), m(2, 3)}};
+
+    for (unsigned int i = 0; i < subMesh.VertexCount(); ++i)
+    {
+      const auto v = subMesh.Vertex(i);
+      subMesh.SetVertex(i, math::Vector3d(
+          a[0][0] * v.X() + a[0][1] * v.Y() + a[0][2] * v.Z() + a[0][3],
+          a[1][0] * v.X() + a[1][1] * v.Y() + a[1][2] * v.Z() + a[1][3],
+          a[2][0] * v.X() + a[2][1] * v.Y() + a[2][2] * v.Z() + a[2][3]));
+    }
+
+    const auto rot = m.Rotation();
+    for (unsigned int i = 0; i < subMesh.NormalCount(); ++i)
+      subMesh.SetNormal(i, rot * subMesh.Normal(i));
   }
 };
 
@@ -34,7 +34,9 @@ namespace systems
 
   /// \brief A plugin that exports a world to a mesh.
   /// When loaded the plugin will dump a mesh containing all the models in
-  /// the world to the current directory.
+  /// the world to the current directory. The export happens during the
+  /// first step, and is complete once that step finishes. The submeshes are
+  /// placed in the world frame in parallel.
   class IGNITION_GAZEBO_VISIBLE ColladaWorldExporter:
     public System,
     public ISystemPostUpdate
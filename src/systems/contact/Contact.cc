@@ -63,7 +63,9 @@ class ContactSensor
                            const msgs::Contacts &_contacts);
 
   /// \brief Publish sensor data over ign transport
-  public: void Publish();
+  /// \param[in] _changed True if contacts began or ended, in which case the
+  /// message is published even if it has no contacts.
+  public: void Publish(bool _changed = false);
 
   /// \brief Topic to publish data to
   public: std::string topic;
@@ -100,6 +102,10 @@ class ignition::gazebo::systems::ContactPrivate
   /// \brief A map of Contact entity to its Contact sensor.
   public: std::unordered_map<Entity,
       std::unique_ptr<ContactSensor>> entitySensorMap;
+
+  /// \brief Only publish when contacts begin or end, see
+  /// `<publish_on_change>`.
+  public: bool publishOnChange{false};
 };
 
 //////////////////////////////////////////////////
@@ -143,10 +149,10 @@ void ContactSensor::AddContacts(
 }
 
 //////////////////////////////////////////////////
-void ContactSensor::Publish()
+void ContactSensor::Publish(bool _changed)
 {
-  // Only publish if there are contacts
-  if (this->contactsMsg.contact_size() > 0)
+  // Only publish if there are contacts, or they just ended
+  if (this->contactsMsg.contact_size() > 0 || _changed)
   {
     this->pub.Publish(this->contactsMsg);
     this->contactsMsg.Clear();
@@ -218,6 +224,24 @@ void ContactPrivate::UpdateSensors(const UpdateInfo &_info,
   IGN_PROFILE("ContactPrivate::UpdateSensors");
   for (const auto &item : this->entitySensorMap)
   {
+    // Physics flags the contacts as changed when they begin or end
+    bool changed{false};
+    if (this->publishOnChange)
+    {
+      for (const Entity &entity : item.second->collisionEntities)
+      {
+        if (_ecm.ComponentState(entity,
+            components::ContactSensorData::typeId) ==
+            ComponentState::OneTimeChange)
+        {
+          changed = true;
+          break;
+        }
+      }
+      if (!changed)
+        continue;
+    }
+
     for (const Entity &entity : item.second->collisionEntities)
     {
       auto contacts = _ecm.Component<components::ContactSensorData>(entity);
@@ -229,6 +253,13 @@ void ContactPrivate::UpdateSensors(const UpdateInfo &_info,
         item.second->AddContacts(_info.simTime, contacts->Data());
       }
     }
+
+    if (changed)
+    {
+      item.second->contactsMsg.mutable_header()->mutable_stamp()->CopyFrom(
+          convert<msgs::Time>(_info.simTime));
+    }
+    item.second->Publish(changed);
   }
 }
 
@@ -259,6 +290,15 @@ Contact::Contact() : System(), dataPtr(std::make_unique<ContactPrivate>())
 {
 }
 
+//////////////////////////////////////////////////
+void Contact::Configure(const Entity &,
+                        const std::shared_ptr<const sdf::Element> &_sdf,
+                        EntityComponentManager &, EventManager &)
+{
+  this->dataPtr->publishOnChange =
+      _sdf->Get<bool>("publish_on_change", false).first;
+}
+
 //////////////////////////////////////////////////
 void Contact::PreUpdate(const UpdateInfo &, EntityComponentManager &_ecm)
 {
@@ -282,19 +322,15 @@ void Contact::PostUpdate(const UpdateInfo &_info,
 
   if (!_info.paused)
   {
+    // Update and publish sensor data
     this->dataPtr->UpdateSensors(_info, _ecm);
-
-    for (auto &it : this->dataPtr->entitySensorMap)
-    {
-      // Publish sensor data
-      it.second->Publish();
-    }
   }
 
   this->dataPtr->RemoveSensors(_ecm);
 }
 
 IGNITION_ADD_PLUGIN(Contact, System,
+  Contact::ISystemConfigure,
   Contact::ISystemPreUpdate,
   Contact::ISystemPostUpdate
 )
@@ -37,8 +37,18 @@ namespace systems
   **/
   /// \brief Contact sensor system which manages all contact sensors in
   /// simulation
+  ///
+  /// ## System Parameters
+  ///
+  /// `<publish_on_change>`: If true, sensors only publish in the steps in
+  /// which one of their collisions began or stopped touching another
+  /// collision, including an empty message once all contacts ended. Contact
+  /// positions are not tracked, so stable contacts aren't republished even if
+  /// they slide. Defaults to false, which publishes every step while there
+  /// are contacts.
   class IGNITION_GAZEBO_VISIBLE Contact :
     public System,
+    public ISystemConfigure,
     public ISystemPreUpdate,
     public ISystemPostUpdate
   {
@@ -48,6 +58,12 @@ namespace systems
     /// \brief Destructor
     public: ~Contact() final = default;
 
+    /// Documentation inherited
+    public: void Configure(const Entity &_entity,
+                           const std::shared_ptr<const sdf::Element> &_sdf,
+                           EntityComponentManager &_ecm,
+                           EventManager &_eventMgr) final;
+
     /// Documentation inherited
     public: void PreUpdate(const UpdateInfo &_info,
                            EntityComponentManager &_ecm) final;
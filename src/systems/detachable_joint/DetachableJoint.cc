@@ -105,6 +105,19 @@ void DetachableJoint::Configure(const Entity &_entity,
       "/detachable_joint/detach");
   this->topic = validTopic(topics);
 
+  // Setup attach topic
+  std::vector<std::string> attachTopics;
+  if (_sdf->HasElement("attach_topic"))
+  {
+    attachTopics.push_back(_sdf->Get<std::string>("attach_topic"));
+  }
+  attachTopics.push_back("/model/" + this->model.Name(_ecm) +
+      "/detachable_joint/attach");
+  this->attachTopic = validTopic(attachTopics);
+
+  this->reuseJoint =
+      _sdf->Get<bool>("reuse_joint", this->reuseJoint).first;
+
   this->suppressChildWarning =
       _sdf->Get<bool>("suppress_child_warning", this->suppressChildWarning)
           .first;
@@ -149,11 +162,16 @@ void DetachableJoint::PreUpdate(
             components::DetachableJoint({this->parentLinkEntity,
                                          this->childLinkEntity, "fixed"}));
 
+        this->attached = true;
+
         this->node.Subscribe(
             this->topic, &DetachableJoint::OnDetachRequest, this);
+        this->node.Subscribe(
+            this->attachTopic, &DetachableJoint::OnAttachRequest, this);
 
         ignmsg << "DetachableJoint subscribing to messages on "
-               << "[" << this->topic << "]" << std::endl;
+               << "[" << this->topic << "] and [" << this->attachTopic
+               << "]" << std::endl;
 
         this->initialized = true;
       }
@@ -172,23 +190,78 @@ void DetachableJoint::PreUpdate(
 
   if (this->initialized)
   {
-    if (this->detachRequested && (kNullEntity != this->detachableJointEntity))
+    if (this->detachRequested && this->attached)
     {
       // Detach the models
-      igndbg << "Removing entity: " << this->detachableJointEntity << std::endl;
-      _ecm.RequestRemoveEntity(this->detachableJointEntity);
-      this->detachableJointEntity = kNullEntity;
-      this->detachRequested = false;
+      if (this->reuseJoint)
+      {
+        igndbg << "Disabling entity: " << this->detachableJointEntity
+               << std::endl;
+        this->SetJointEnabled(_ecm, false);
+      }
+      else
+      {
+        igndbg << "Removing entity: " << this->detachableJointEntity
+               << std::endl;
+        _ecm.RequestRemoveEntity(this->detachableJointEntity);
+        this->detachableJointEntity = kNullEntity;
+      }
+      this->attached = false;
+    }
+    else if (this->attachRequested && !this->attached)
+    {
+      // Attach the models again
+      if (this->reuseJoint && kNullEntity != this->detachableJointEntity)
+      {
+        igndbg << "Enabling entity: " << this->detachableJointEntity
+               << std::endl;
+        this->SetJointEnabled(_ecm, true);
+      }
+      else
+      {
+        this->detachableJointEntity = _ecm.CreateEntity();
+        _ecm.CreateComponent(
+            this->detachableJointEntity,
+            components::DetachableJoint({this->parentLinkEntity,
+                                         this->childLinkEntity, "fixed"}));
+      }
+      this->attached = true;
     }
+    this->detachRequested = false;
+    this->attachRequested = false;
   }
 }
 
+//////////////////////////////////////////////////
+void DetachableJoint::SetJointEnabled(EntityComponentManager &_ecm,
+    bool _enabled)
+{
+  auto info = _ecm.ComponentData<components::DetachableJoint>(
+      this->detachableJointEntity);
+  if (!info)
+    return;
+
+  info->enabled = _enabled;
+  _ecm.SetComponentData<components::DetachableJoint>(
+      this->detachableJointEntity, *info);
+
+  // Physics only reacts to joints marked as changed
+  _ecm.SetChanged(this->detachableJointEntity,
+      components::DetachableJoint::typeId, ComponentState::OneTimeChange);
+}
+
 //////////////////////////////////////////////////
 void DetachableJoint::OnDetachRequest(const msgs::Empty &)
 {
   this->detachRequested = true;
 }
 
+//////////////////////////////////////////////////
+void DetachableJoint::OnAttachRequest(const msgs::Empty &)
+{
+  this->attachRequested = true;
+}
+
 IGNITION_ADD_PLUGIN(DetachableJoint,
                     ignition::gazebo::System,
                     DetachableJoint::ISystemConfigure,
@@ -50,6 +50,15 @@ namespace systems
   ///
   /// <topic> (optional): Topic name to be used for detaching connections
   ///
+  /// <attach_topic> (optional): Topic name to be used for attaching the
+  /// links again after they were detached. Defaults to
+  /// `/model/<model_name>/detachable_joint/attach`.
+  ///
+  /// <reuse_joint> (optional): If true, detaching disables the joint
+  /// instead of removing its entity, and attaching enables it again. This
+  /// is much cheaper for models which are attached and detached often,
+  /// such as grippers. Defaults to false.
+  ///
   /// <suppress_child_warning> (optional): If true, the system
   /// will not print a warning message if a child model does not exist yet.
   /// Otherwise, a warning message is printed. Defaults to false.
@@ -73,9 +82,18 @@ namespace systems
                 const ignition::gazebo::UpdateInfo &_info,
                 ignition::gazebo::EntityComponentManager &_ecm) final;
 
+    /// \brief Enable or disable the joint, keeping its entity.
+    /// \param[in] _ecm Entity component manager.
+    /// \param[in] _enabled True to attach the links, false to detach them.
+    private: void SetJointEnabled(EntityComponentManager &_ecm,
+                                  bool _enabled);
+
     /// \brief Callback for detach request topic
     private: void OnDetachRequest(const msgs::Empty &_msg);
 
+    /// \brief Callback for attach request topic
+    private: void OnAttachRequest(const msgs::Empty &_msg);
+
     /// \brief The model associated with this system.
     private: Model model;
 
@@ -88,6 +106,12 @@ namespace systems
     /// \brief Topic to be used for detaching connections
     private: std::string topic;
 
+    /// \brief Topic to be used for attaching connections
+    private: std::string attachTopic;
+
+    /// \brief Whether to keep the joint entity when detaching
+    private: bool reuseJoint{false};
+
     /// \brief Whether to suppress warning about missing child model.
     private: bool suppressChildWarning{false};
 
@@ -103,6 +127,12 @@ namespace systems
     /// \brief Whether detachment has been requested
     private: std::atomic<bool> detachRequested{false};
 
+    /// \brief Whether attachment has been requested
+    private: std::atomic<bool> attachRequested{false};
+
+    /// \brief Whether the links are currently attached
+    private: bool attached{false};
+
     /// \brief Ignition communication node.
     public: transport::Node node;
 
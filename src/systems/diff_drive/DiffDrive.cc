@@ -18,11 +18,16 @@
 #include "DiffDrive.hh"
 
 #include <ignition/msgs/odometry.pb.h>
+#include <ignition/msgs/pose_v.pb.h>
 
+#include <algorithm>
 #include <limits>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <ignition/common/Profiler.hh>
@@ -34,8 +39,13 @@
 #include "ignition/gazebo/components/CanonicalLink.hh"
 #include "ignition/gazebo/components/JointPosition.hh"
 #include "ignition/gazebo/components/JointVelocityCmd.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/TwistCmd.hh"
+#include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/Link.hh"
 #include "ignition/gazebo/Model.hh"
+#include "ignition/gazebo/World.hh"
 #include "ignition/gazebo/Util.hh"
 
 #include "SpeedLimiter.hh"
@@ -76,6 +86,44 @@ class ignition::gazebo::systems::DiffDrivePrivate
   public: void UpdateVelocity(const ignition::gazebo::UpdateInfo &_info,
     const ignition::gazebo::EntityComponentManager &_ecm);
 
+  /// \brief Finish configuring the system when it's attached to the world.
+  /// \param[in] _world World entity.
+  /// \param[in] _sdf The SDF element of the system.
+  /// \param[in] _ecm Mutable reference to the ECM.
+  public: void ConfigureFleet(Entity _world, const sdf::ElementPtr &_sdf,
+    EntityComponentManager &_ecm);
+
+  /// \brief Start driving a vehicle, when attached to the world. Does
+  /// nothing if the model isn't in the fleet, is already driven, or doesn't
+  /// have all the joints.
+  /// \param[in] _ecm Mutable reference to the ECM.
+  /// \param[in] _model Model entity.
+  /// \param[in] _name Name of the model.
+  public: void AddVehicle(EntityComponentManager &_ecm, Entity _model,
+    const std::string &_name);
+
+  /// \brief Stop driving a vehicle, when attached to the world.
+  /// \param[in] _model Model entity.
+  public: void RemoveVehicle(Entity _model);
+
+  /// \brief Set the wheel velocities of all vehicles, when attached to the
+  /// world.
+  /// \param[in] _info System update information.
+  /// \param[in] _ecm Mutable reference to the ECM.
+  public: void FleetPreUpdate(const UpdateInfo &_info,
+    EntityComponentManager &_ecm);
+
+  /// \brief Limit the commands, update the odometry of all vehicles and
+  /// publish it, when attached to the world.
+  /// \param[in] _info System update information.
+  /// \param[in] _ecm Immutable reference to the ECM.
+  public: void FleetPostUpdate(const UpdateInfo &_info,
+    const EntityComponentManager &_ecm);
+
+  /// \brief Callback for the fleet's velocity subscription.
+  /// \param[in] _msg Velocity message, for the vehicles in its header.
+  public: void OnFleetCmdVel(const msgs::Twist &_msg);
+
   /// \brief Ignition communication node.
   public: transport::Node node;
 
@@ -144,6 +192,57 @@ class ignition::gazebo::systems::DiffDrivePrivate
 
   /// \brief child_frame_id from sdf.
   public: std::string sdfChildFrameId;
+
+  /// \brief Whether the system is attached to the world, and drives the
+  /// vehicles below.
+  public: bool fleetMode{false};
+
+  /// \brief Names of the vehicles when attached to the world. Empty to
+  /// drive all models which have the joints.
+  public: std::unordered_set<std::string> fleetModelNames;
+
+  /// \brief Index of each vehicle in the arrays below, by model entity.
+  public: std::unordered_map<Entity, std::size_t> vehicleIndices;
+
+  /// \brief Index of each vehicle in the arrays below, by name. Protected
+  /// by the mutex, for the command callback.
+  public: std::unordered_map<std::string, std::size_t> vehicleNameIndices;
+
+  /// \brief Model entities of the vehicles.
+  public: std::vector<Entity> vehicles;
+
+  /// \brief Names of the vehicles.
+  public: std::vector<std::string> vehicleNames;
+
+  /// \brief Left joints of the vehicles, leftJointNames.size() per
+  /// vehicle, in the order of the names.
+  public: std::vector<Entity> vehicleLeftJoints;
+
+  /// \brief Right joints of the vehicles, rightJointNames.size() per
+  /// vehicle, in the order of the names.
+  public: std::vector<Entity> vehicleRightJoints;
+
+  /// \brief Last command received for each vehicle. Protected by the mutex.
+  public: std::vector<Commands> vehicleTargets;
+
+  /// \brief Previous control command of each vehicle.
+  public: std::vector<Commands> vehicleLast0Cmds;
+
+  /// \brief Control command before the previous one of each vehicle.
+  public: std::vector<Commands> vehicleLast1Cmds;
+
+  /// \brief Calculated speed of the left joints of each vehicle.
+  public: std::vector<double> vehicleLeftSpeeds;
+
+  /// \brief Calculated speed of the right joints of each vehicle.
+  public: std::vector<double> vehicleRightSpeeds;
+
+  /// \brief Odometry of each vehicle. The odometry isn't copyable, so
+  /// each one is allocated once and moved around.
+  public: std::vector<std::unique_ptr<math::DiffDriveOdometry>> vehicleOdoms;
+
+  /// \brief Odometry message of the fleet, reused between publications.
+  public: msgs::Pose_V fleetOdomMsg;
 };
 
 //////////////////////////////////////////////////
@@ -159,6 +258,8 @@ void DiffDrive::Configure(const Entity &_entity,
     EventManager &/*_eventMgr*/)
 {
   this->dataPtr->model = Model(_entity);
+  this->dataPtr->fleetMode =
+      _ecm.Component<components::World>(_entity) != nullptr;
 
   // Get the canonical link
   std::vector<Entity> links = _ecm.ChildrenByComponents(
@@ -166,10 +267,10 @@ void DiffDrive::Configure(const Entity &_entity,
   if (!links.empty())
     this->dataPtr->canonicalLink = Link(links[0]);
 
-  if (!this->dataPtr->model.Valid(_ecm))
+  if (!this->dataPtr->fleetMode && !this->dataPtr->model.Valid(_ecm))
   {
-    ignerr << "DiffDrive plugin should be attached to a model entity. "
-           << "Failed to initialize." << std::endl;
+    ignerr << "DiffDrive plugin should be attached to a model or world "
+           << "entity. Failed to initialize." << std::endl;
     return;
   }
 
@@ -259,6 +360,12 @@ void DiffDrive::Configure(const Entity &_entity,
   this->dataPtr->odom.SetWheelParams(this->dataPtr->wheelSeparation,
       this->dataPtr->wheelRadius, this->dataPtr->wheelRadius);
 
+  if (this->dataPtr->fleetMode)
+  {
+    this->dataPtr->ConfigureFleet(_entity, ptr->Clone(), _ecm);
+    return;
+  }
+
   // Subscribe to commands
   std::vector<std::string> topics;
   if (_sdf->HasElement("topic"))
@@ -299,6 +406,12 @@ void DiffDrive::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
 {
   IGN_PROFILE("DiffDrive::PreUpdate");
 
+  if (this->dataPtr->fleetMode)
+  {
+    this->dataPtr->FleetPreUpdate(_info, _ecm);
+    return;
+  }
+
   // \TODO(anyone) Support rewind
   if (_info.dt < std::chrono::steady_clock::duration::zero())
   {
@@ -371,7 +484,8 @@ void DiffDrive::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
     }
     else
     {
-      *vel = components::JointVelocityCmd({this->dataPtr->leftJointSpeed});
+      // Write in place, so the vector isn't reallocated every step
+      vel->Data().assign(1, this->dataPtr->leftJointSpeed);
     }
   }
 
@@ -387,7 +501,7 @@ void DiffDrive::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
     }
     else
     {
-      *vel = components::JointVelocityCmd({this->dataPtr->rightJointSpeed});
+      vel->Data().assign(1, this->dataPtr->rightJointSpeed);
     }
   }
 
@@ -419,6 +533,12 @@ void DiffDrive::PostUpdate(const UpdateInfo &_info,
   if (_info.paused)
     return;
 
+  if (this->dataPtr->fleetMode)
+  {
+    this->dataPtr->FleetPostUpdate(_info, _ecm);
+    return;
+  }
+
   this->dataPtr->UpdateVelocity(_info, _ecm);
   this->dataPtr->UpdateOdometry(_info, _ecm);
 }
@@ -513,12 +633,20 @@ void DiffDrivePrivate::UpdateOdometry(const ignition::gazebo::UpdateInfo &_info,
 
 //////////////////////////////////////////////////
 void DiffDrivePrivate::UpdateVelocity(const ignition::gazebo::UpdateInfo &_info,
-    const ignition::gazebo::EntityComponentManager &/*_ecm*/)
+    const ignition::gazebo::EntityComponentManager &_ecm)
 {
   IGN_PROFILE("DiffDrive::UpdateVelocity");
 
   double linVel;
   double angVel;
+
+  auto twistCmd = _ecm.Component<components::TwistCmd>(this->model.Entity());
+  if (twistCmd)
+  {
+    linVel = twistCmd->Data().linear().x();
+    angVel = twistCmd->Data().angular().z();
+  }
+  else
   {
     std::lock_guard<std::mutex> lock(this->mutex);
     linVel = this->targetVel.linear().x();
@@ -550,6 +678,326 @@ void DiffDrivePrivate::OnCmdVel(const msgs::Twist &_msg)
   this->targetVel = _msg;
 }
 
+//////////////////////////////////////////////////
+void DiffDrivePrivate::ConfigureFleet(Entity _world,
+    const sdf::ElementPtr &_sdf, EntityComponentManager &_ecm)
+{
+  for (auto modelElem = _sdf->GetElementImpl("model"); modelElem;
+       modelElem = modelElem->GetNextElement("model"))
+  {
+    this->fleetModelNames.insert(modelElem->Get<std::string>());
+  }
+
+  const std::string worldName = World(_world).Name(_ecm).value_or("");
+
+  std::vector<std::string> topics;
+  if (_sdf->HasElement("topic"))
+  {
+    topics.push_back(_sdf->Get<std::string>("topic"));
+  }
+  topics.push_back("/world/" + worldName + "/cmd_vel");
+  auto topic = validTopic(topics);
+
+  this->node.Subscribe(topic, &DiffDrivePrivate::OnFleetCmdVel, this);
+
+  std::vector<std::string> odomTopics;
+  if (_sdf->HasElement("odom_topic"))
+  {
+    odomTopics.push_back(_sdf->Get<std::string>("odom_topic"));
+  }
+  odomTopics.push_back("/world/" + worldName + "/odometry");
+  auto odomTopic = validTopic(odomTopics);
+
+  this->odomPub = this->node.Advertise<msgs::Pose_V>(odomTopic);
+
+  // Models created later are added on PreUpdate
+  _ecm.Each<components::Model, components::Name>(
+      [&](const Entity &_model, const components::Model *,
+          const components::Name *_name) -> bool
+      {
+        this->AddVehicle(_ecm, _model, _name->Data());
+        return true;
+      });
+
+  ignmsg << "DiffDrive driving " << this->vehicles.size()
+         << " vehicles, subscribing to twist messages on [" << topic << "]"
+         << std::endl;
+}
+
+//////////////////////////////////////////////////
+void DiffDrivePrivate::AddVehicle(EntityComponentManager &_ecm,
+    Entity _model, const std::string &_name)
+{
+  if (this->vehicleIndices.find(_model) != this->vehicleIndices.end())
+    return;
+
+  const bool listed = this->fleetModelNames.find(_name) !=
+      this->fleetModelNames.end();
+  if (!this->fleetModelNames.empty() && !listed)
+    return;
+
+  // All joints must be present, so the joint arrays keep their stride
+  Model vehicle(_model);
+  std::vector<Entity> left;
+  for (const auto &name : this->leftJointNames)
+    left.push_back(vehicle.JointByName(_ecm, name));
+  std::vector<Entity> right;
+  for (const auto &name : this->rightJointNames)
+    right.push_back(vehicle.JointByName(_ecm, name));
+
+  if (left.empty() || right.empty() ||
+      std::find(left.begin(), left.end(), kNullEntity) != left.end() ||
+      std::find(right.begin(), right.end(), kNullEntity) != right.end())
+  {
+    // Only models the fleet is restricted to are expected to have them
+    if (listed)
+    {
+      ignwarn << "Failed to find the wheel joints of vehicle [" << _name
+              << "], it won't be driven." << std::endl;
+    }
+    return;
+  }
+
+  // Create the joint position components used for odometry
+  if (!_ecm.Component<components::JointPosition>(left[0]))
+    _ecm.CreateComponent(left[0], components::JointPosition());
+  if (!_ecm.Component<components::JointPosition>(right[0]))
+    _ecm.CreateComponent(right[0], components::JointPosition());
+
+  auto vehicleOdom = std::make_unique<math::DiffDriveOdometry>();
+  vehicleOdom->SetWheelParams(this->wheelSeparation, this->wheelRadius,
+      this->wheelRadius);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  const std::size_t index = this->vehicles.size();
+  this->vehicleIndices[_model] = index;
+  this->vehicleNameIndices[_name] = index;
+  this->vehicles.push_back(_model);
+  this->vehicleNames.push_back(_name);
+  this->vehicleLeftJoints.insert(this->vehicleLeftJoints.end(),
+      left.begin(), left.end());
+  this->vehicleRightJoints.insert(this->vehicleRightJoints.end(),
+      right.begin(), right.end());
+  this->vehicleTargets.emplace_back();
+  this->vehicleLast0Cmds.emplace_back();
+  this->vehicleLast1Cmds.emplace_back();
+  this->vehicleLeftSpeeds.push_back(0.0);
+  this->vehicleRightSpeeds.push_back(0.0);
+  this->vehicleOdoms.push_back(std::move(vehicleOdom));
+}
+
+//////////////////////////////////////////////////
+void DiffDrivePrivate::RemoveVehicle(Entity _model)
+{
+  auto it = this->vehicleIndices.find(_model);
+  if (it == this->vehicleIndices.end())
+    return;
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  // Move the last vehicle into the removed one's slot
+  const std::size_t index = it->second;
+  const std::size_t last = this->vehicles.size() - 1;
+  const std::size_t leftCount = this->leftJointNames.size();
+  const std::size_t rightCount = this->rightJointNames.size();
+  this->vehicleIndices.erase(it);
+  this->vehicleNameIndices.erase(this->vehicleNames[index]);
+  if (index != last)
+  {
+    this->vehicles[index] = this->vehicles[last];
+    this->vehicleNames[index] = std::move(this->vehicleNames[last]);
+    std::copy_n(this->vehicleLeftJoints.begin() + last * leftCount,
+        leftCount, this->vehicleLeftJoints.begin() + index * leftCount);
+    std::copy_n(this->vehicleRightJoints.begin() + last * rightCount,
+        rightCount, this->vehicleRightJoints.begin() + index * rightCount);
+    this->vehicleTargets[index] = this->vehicleTargets[last];
+    this->vehicleLast0Cmds[index] = this->vehicleLast0Cmds[last];
+    this->vehicleLast1Cmds[index] = this->vehicleLast1Cmds[last];
+    this->vehicleLeftSpeeds[index] = this->vehicleLeftSpeeds[last];
+    this->vehicleRightSpeeds[index] = this->vehicleRightSpeeds[last];
+    this->vehicleOdoms[index] = std::move(this->vehicleOdoms[last]);
+
+    this->vehicleIndices[this->vehicles[index]] = index;
+    this->vehicleNameIndices[this->vehicleNames[index]] = index;
+  }
+
+  this->vehicles.pop_back();
+  this->vehicleNames.pop_back();
+  this->vehicleLeftJoints.resize(last * leftCount);
+  this->vehicleRightJoints.resize(last * rightCount);
+  this->vehicleTargets.pop_back();
+  this->vehicleLast0Cmds.pop_back();
+  this->vehicleLast1Cmds.pop_back();
+  this->vehicleLeftSpeeds.pop_back();
+  this->vehicleRightSpeeds.pop_back();
+  this->vehicleOdoms.pop_back();
+}
+
+//////////////////////////////////////////////////
+void DiffDrivePrivate::FleetPreUpdate(const UpdateInfo &_info,
+    EntityComponentManager &_ecm)
+{
+  _ecm.EachNew<components::Model, components::Name>(
+      [&](const Entity &_model, const components::Model *,
+          const components::Name *_name) -> bool
+      {
+        this->AddVehicle(_ecm, _model, _name->Data());
+        return true;
+      });
+
+  _ecm.EachRemoved<components::Model>(
+      [&](const Entity &_model, const components::Model *) -> bool
+      {
+        this->RemoveVehicle(_model);
+        return true;
+      });
+
+  // Nothing left to do if paused.
+  if (_info.paused)
+    return;
+
+  auto setSpeed = [&](Entity _joint, double _speed)
+  {
+    auto vel = _ecm.Component<components::JointVelocityCmd>(_joint);
+    if (vel == nullptr)
+      _ecm.CreateComponent(_joint, components::JointVelocityCmd({_speed}));
+    else
+      vel->Data().assign(1, _speed);
+  };
+
+  const std::size_t leftCount = this->leftJointNames.size();
+  const std::size_t rightCount = this->rightJointNames.size();
+  for (std::size_t i = 0; i < this->vehicles.size(); ++i)
+  {
+    for (std::size_t j = i * leftCount; j < (i + 1) * leftCount; ++j)
+      setSpeed(this->vehicleLeftJoints[j], this->vehicleLeftSpeeds[i]);
+    for (std::size_t j = i * rightCount; j < (i + 1) * rightCount; ++j)
+      setSpeed(this->vehicleRightJoints[j], this->vehicleRightSpeeds[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+void DiffDrivePrivate::FleetPostUpdate(const UpdateInfo &_info,
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("DiffDrive::FleetPostUpdate");
+
+  const std::size_t count = this->vehicles.size();
+  const double dt = std::chrono::duration<double>(_info.dt).count();
+
+  // Update the velocities. The latest commands are copied at once, so the
+  // callback isn't blocked for the whole fleet.
+  std::vector<Commands> targets;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    targets = this->vehicleTargets;
+  }
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    auto twistCmd = _ecm.Component<components::TwistCmd>(this->vehicles[i]);
+    double linVel = twistCmd ? twistCmd->Data().linear().x() : targets[i].lin;
+    double angVel = twistCmd ? twistCmd->Data().angular().z() : targets[i].ang;
+
+    auto &last0 = this->vehicleLast0Cmds[i];
+    auto &last1 = this->vehicleLast1Cmds[i];
+    this->limiterLin->Limit(linVel, last0.lin, last1.lin, dt);
+    this->limiterAng->Limit(angVel, last0.ang, last1.ang, dt);
+
+    last1 = last0;
+    last0.lin = linVel;
+    last0.ang = angVel;
+
+    this->vehicleRightSpeeds[i] =
+      (linVel + angVel * this->wheelSeparation / 2.0) / this->wheelRadius;
+    this->vehicleLeftSpeeds[i] =
+      (linVel - angVel * this->wheelSeparation / 2.0) / this->wheelRadius;
+  }
+
+  // Update the odometry
+  const std::chrono::steady_clock::time_point now(_info.simTime);
+  const std::size_t leftCount = this->leftJointNames.size();
+  const std::size_t rightCount = this->rightJointNames.size();
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    auto &vehicleOdom = *this->vehicleOdoms[i];
+    if (!vehicleOdom.Initialized())
+    {
+      vehicleOdom.Init(now);
+      continue;
+    }
+
+    auto leftPos = _ecm.Component<components::JointPosition>(
+        this->vehicleLeftJoints[i * leftCount]);
+    auto rightPos = _ecm.Component<components::JointPosition>(
+        this->vehicleRightJoints[i * rightCount]);
+    if (!leftPos || !rightPos || leftPos->Data().empty() ||
+        rightPos->Data().empty())
+    {
+      continue;
+    }
+
+    vehicleOdom.Update(leftPos->Data()[0], rightPos->Data()[0], now);
+  }
+
+  // Throttle publishing
+  auto diff = _info.simTime - this->lastOdomPubTime;
+  if (diff > std::chrono::steady_clock::duration::zero() &&
+      diff < this->odomPubPeriod)
+  {
+    return;
+  }
+  this->lastOdomPubTime = _info.simTime;
+
+  // Publish the odometry of all vehicles in a single message. Poses are
+  // reused from the previous publication.
+  auto &msg = this->fleetOdomMsg;
+  msg.mutable_header()->mutable_stamp()->CopyFrom(
+      convert<msgs::Time>(_info.simTime));
+  while (msg.pose_size() > static_cast<int>(count))
+    msg.mutable_pose()->RemoveLast();
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    auto *pose = static_cast<int>(i) < msg.pose_size() ?
+        msg.mutable_pose(static_cast<int>(i)) : msg.add_pose();
+    const auto &vehicleOdom = *this->vehicleOdoms[i];
+    pose->set_name(this->vehicleNames[i]);
+    pose->set_id(this->vehicles[i]);
+    pose->mutable_position()->set_x(vehicleOdom.X());
+    pose->mutable_position()->set_y(vehicleOdom.Y());
+    msgs::Set(pose->mutable_orientation(),
+        math::Quaterniond(0, 0, *vehicleOdom.Heading()));
+  }
+
+  this->odomPub.Publish(msg);
+}
+
+//////////////////////////////////////////////////
+void DiffDrivePrivate::OnFleetCmdVel(const msgs::Twist &_msg)
+{
+  Commands cmd;
+  cmd.lin = _msg.linear().x();
+  cmd.ang = _msg.angular().z();
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (const auto &data : _msg.header().data())
+  {
+    if (data.key() != "model")
+      continue;
+
+    for (const auto &name : data.value())
+    {
+      auto it = this->vehicleNameIndices.find(name);
+      if (it != this->vehicleNameIndices.end())
+        this->vehicleTargets[it->second] = cmd;
+    }
+    return;
+  }
+
+  // No vehicles listed, command all of them
+  std::fill(this->vehicleTargets.begin(), this->vehicleTargets.end(), cmd);
+}
+
 IGNITION_ADD_PLUGIN(DiffDrive,
                     ignition::gazebo::System,
                     DiffDrive::ISystemConfigure,
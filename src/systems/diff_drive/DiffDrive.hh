@@ -35,6 +35,11 @@ namespace systems
   /// \brief Differential drive controller which can be attached to a model
   /// with any number of left and right wheels.
   ///
+  /// The system can also be attached to the world, to drive a fleet of
+  /// identical vehicles with a single instance. All vehicles then share
+  /// the parameters below, receive commands on a single topic and have
+  /// their odometry published together in a single message.
+  ///
   /// # System Parameters
   ///
   /// `<left_joint>`: Name of a joint that controls a left wheel. This
@@ -56,11 +61,25 @@ namespace systems
   ///
   /// `<topic>`: Custom topic that this system will subscribe to in order to
   /// receive command velocity messages. This element if optional, and the
-  /// default value is `/model/{name_of_model}/cmd_vel`.
+  /// default value is `/model/{name_of_model}/cmd_vel`. Commands can also be
+  /// written to a TwistCmd component on the model, see components::TwistCmd.
   ///
   /// `<odom_topic>`: Custom topic on which this system will publish odometry
   /// messages. This element if optional, and the default value is
   /// `/model/{name_of_model}/odometry`.
+  ///
+  /// `<model>`: Only used when attached to the world. Name of a vehicle to
+  /// drive, may be repeated. If there are none, all models which have the
+  /// left and right joints are driven, including the ones spawned later.
+  ///
+  /// When attached to the world, `<topic>` defaults to
+  /// `/world/{name_of_world}/cmd_vel`. Each ignition::msgs::Twist received
+  /// on it is applied to the vehicles listed in the values of its `model`
+  /// header key, or to all vehicles if there's no such key. `<odom_topic>`
+  /// defaults to `/world/{name_of_world}/odometry`, on which an
+  /// ignition::msgs::Pose_V is published with the odometry pose of every
+  /// vehicle, named after the vehicle's model. `<frame_id>` and
+  /// `<child_frame_id>` are ignored.
   class IGNITION_GAZEBO_VISIBLE DiffDrive
       : public System,
         public ISystemConfigure,
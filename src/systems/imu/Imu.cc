@@ -17,6 +17,7 @@
 
 #include "Imu.hh"
 
+#include <set>
 #include <unordered_map>
 #include <utility>
 #include <string>
@@ -24,6 +25,8 @@
 #include <ignition/plugin/Register.hh>
 
 #include <sdf/Element.hh>
+#include <sdf/Imu.hh>
+#include <sdf/Noise.hh>
 
 #include <ignition/common/Profiler.hh>
 
@@ -55,6 +58,10 @@ class ignition::gazebo::systems::ImuPrivate
   public: std::unordered_map<Entity,
       std::unique_ptr<ignition::sensors::ImuSensor>> entitySensorMap;
 
+  /// \brief IMU entities whose sensor has noise. These are updated serially,
+  /// in entity order, after the others.
+  public: std::set<Entity> noisyEntities;
+
   /// \brief Ign-sensors sensor factory for creating sensors
   public: sensors::SensorFactory sensorFactory;
 
@@ -68,12 +75,39 @@ class ignition::gazebo::systems::ImuPrivate
   /// \param[in] _ecm Immutable reference to ECM.
   public: void Update(const EntityComponentManager &_ecm);
 
+  /// \brief Update the measurements of all IMUs, which also publishes them.
+  /// \param[in] _ecm Immutable reference to ECM.
+  /// \param[in] _now Current simulation time.
+  public: void UpdateSensors(const EntityComponentManager &_ecm,
+                             const std::chrono::steady_clock::duration &_now);
+
   /// \brief Remove IMU sensors if their entities have been removed from
   /// simulation.
   /// \param[in] _ecm Immutable reference to ECM.
   public: void RemoveImuEntities(const EntityComponentManager &_ecm);
 };
 
+//////////////////////////////////////////////////
+/// \brief Whether an IMU has noise on any of its measurements.
+/// \param[in] _data SDF description of the sensor.
+/// \return True if any measurement has noise.
+static bool hasNoise(const sdf::Sensor &_data)
+{
+  auto imu = _data.ImuSensor();
+  if (nullptr == imu)
+    return false;
+
+  for (const auto *noise : {&imu->LinearAccelerationXNoise(),
+      &imu->LinearAccelerationYNoise(), &imu->LinearAccelerationZNoise(),
+      &imu->AngularVelocityXNoise(), &imu->AngularVelocityYNoise(),
+      &imu->AngularVelocityZNoise()})
+  {
+    if (noise->Type() != sdf::NoiseType::NONE)
+      return true;
+  }
+  return false;
+}
+
 //////////////////////////////////////////////////
 Imu::Imu() : System(), dataPtr(std::make_unique<ImuPrivate>())
 {
@@ -109,13 +143,10 @@ void Imu::PostUpdate(const UpdateInfo &_info,
   {
     this->dataPtr->Update(_ecm);
 
-    for (auto &it : this->dataPtr->entitySensorMap)
-    {
-      // Update measurement time
-      auto time = math::durationToSecNsec(_info.simTime);
-      dynamic_cast<sensors::Sensor *>(it.second.get())->Update(
-          math::secNsecToDuration(time.first, time.second), false);
-    }
+    // Update measurement time
+    auto time = math::durationToSecNsec(_info.simTime);
+    this->dataPtr->UpdateSensors(_ecm,
+        math::secNsecToDuration(time.first, time.second));
   }
 
   this->dataPtr->RemoveImuEntities(_ecm);
@@ -183,6 +214,9 @@ void ImuPrivate::CreateImuEntities(EntityComponentManager &_ecm)
         math::Pose3d p = worldPose(_entity, _ecm);
         sensor->SetOrientationReference(p.Rot());
 
+        if (hasNoise(data))
+          this->noisyEntities.insert(_entity);
+
         // Set topic
         _ecm.CreateComponent(_entity, components::SensorTopic(sensor->Topic()));
 
@@ -229,6 +263,32 @@ void ImuPrivate::Update(const EntityComponentManager &_ecm)
       });
 }
 
+//////////////////////////////////////////////////
+void ImuPrivate::UpdateSensors(const EntityComponentManager &_ecm,
+    const std::chrono::steady_clock::duration &_now)
+{
+  IGN_PROFILE("ImuPrivate::UpdateSensors");
+  _ecm.ParallelEach<components::Imu>(
+    [&](const Entity &_entity, const components::Imu *)
+      {
+        if (!this->noisyEntities.empty() && this->noisyEntities.count(_entity))
+          return;
+
+        auto it = this->entitySensorMap.find(_entity);
+        if (it != this->entitySensorMap.end())
+        {
+          static_cast<sensors::Sensor *>(it->second.get())->Update(
+              _now, false);
+        }
+      }, 16);
+
+  for (const auto &entity : this->noisyEntities)
+  {
+    static_cast<sensors::Sensor *>(this->entitySensorMap[entity].get())
+        ->Update(_now, false);
+  }
+}
+
 //////////////////////////////////////////////////
 void ImuPrivate::RemoveImuEntities(
     const EntityComponentManager &_ecm)
@@ -247,6 +307,7 @@ void ImuPrivate::RemoveImuEntities(
         }
 
         this->entitySensorMap.erase(sensorId);
+        this->noisyEntities.erase(_entity);
 
         return true;
       });
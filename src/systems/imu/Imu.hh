@@ -37,6 +37,11 @@ namespace systems
   /// \brief This system manages all IMU sensors in simulation.
   /// Each IMU sensor eports vertical position, angular velocity
   /// and lienar acceleration readings over Ignition Transport.
+  ///
+  /// IMUs without noise are updated concurrently on the ECM's task pool.
+  /// Noise is drawn from a random generator shared by the whole process, so
+  /// IMUs with noise are updated one at a time, always in the same order, to
+  /// keep seeded runs reproducible.
   class IGNITION_GAZEBO_VISIBLE Imu:
     public System,
     public ISystemPreUpdate,
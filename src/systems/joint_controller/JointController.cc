@@ -29,6 +29,7 @@
 #include "ignition/gazebo/components/JointForceCmd.hh"
 #include "ignition/gazebo/components/JointVelocity.hh"
 #include "ignition/gazebo/components/JointVelocityCmd.hh"
+#include "ignition/gazebo/components/JointVelocityTarget.hh"
 #include "ignition/gazebo/Model.hh"
 
 using namespace ignition;
@@ -200,6 +201,13 @@ void JointController::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
     return;
 
   double targetVel;
+  auto target = _ecm.Component<components::JointVelocityTarget>(
+      this->dataPtr->jointEntity);
+  if (target && !target->Data().empty())
+  {
+    targetVel = target->Data()[0];
+  }
+  else
   {
     std::lock_guard<std::mutex> lock(this->dataPtr->jointVelCmdMutex);
     targetVel = this->dataPtr->jointVelCmd;
@@ -243,6 +251,29 @@ void JointController::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
   }
 }
 
+//////////////////////////////////////////////////
+bool JointController::Access(const EntityComponentManager &_ecm,
+    SystemAccess &_access)
+{
+  // Run alone until the joint is found and its components are created
+  const Entity joint = this->dataPtr->jointEntity;
+  if (joint == kNullEntity)
+    return false;
+
+  const ComponentTypeId cmdType = this->dataPtr->useForceCommands ?
+      components::JointForceCmd::typeId : components::JointVelocityCmd::typeId;
+  if (!_ecm.EntityHasComponentType(joint, components::JointVelocity::typeId) ||
+      !_ecm.EntityHasComponentType(joint, cmdType))
+  {
+    return false;
+  }
+
+  _access.reads.insert(components::JointVelocity::typeId);
+  _access.reads.insert(components::JointVelocityTarget::typeId);
+  _access.writes.insert(cmdType);
+  return true;
+}
+
 //////////////////////////////////////////////////
 void JointControllerPrivate::OnCmdVel(const msgs::Double &_msg)
 {
@@ -253,7 +284,8 @@ void JointControllerPrivate::OnCmdVel(const msgs::Double &_msg)
 IGNITION_ADD_PLUGIN(JointController,
                     ignition::gazebo::System,
                     JointController::ISystemConfigure,
-                    JointController::ISystemPreUpdate)
+                    JointController::ISystemPreUpdate,
+                    JointController::ISystemAccess)
 
 IGNITION_ADD_PLUGIN_ALIAS(JointController,
                           "ignition::gazebo::systems::JointController")
@@ -34,6 +34,11 @@ namespace systems
   /// \brief Joint controller which can be attached to a model with a reference
   /// to a single joint. Currently only the first axis of a joint is actuated.
   ///
+  /// Target velocities are received by default on the topic
+  /// "/model/<model_name>/joint/<joint_name>/cmd_vel", or read from a
+  /// JointVelocityTarget component on the joint, see
+  /// components::JointVelocityTarget.
+  ///
   /// ## System Parameters
   ///
   /// `<joint_name>` The name of the joint to control. Required parameter.
@@ -72,7 +77,8 @@ namespace systems
   class IGNITION_GAZEBO_VISIBLE JointController
       : public System,
         public ISystemConfigure,
-        public ISystemPreUpdate
+        public ISystemPreUpdate,
+        public ISystemAccess
   {
     /// \brief Constructor
     public: JointController();
@@ -91,6 +97,10 @@ namespace systems
                 const ignition::gazebo::UpdateInfo &_info,
                 ignition::gazebo::EntityComponentManager &_ecm) override;
 
+    // Documentation inherited
+    public: bool Access(const EntityComponentManager &_ecm,
+                        SystemAccess &_access) override;
+
     /// \brief Private data pointer
     private: std::unique_ptr<JointControllerPrivate> dataPtr;
   };
@@ -28,6 +28,7 @@
 
 #include "ignition/gazebo/components/JointForceCmd.hh"
 #include "ignition/gazebo/components/JointPosition.hh"
+#include "ignition/gazebo/components/JointPositionTarget.hh"
 #include "ignition/gazebo/Model.hh"
 
 using namespace ignition;
@@ -240,14 +241,25 @@ void JointPositionController::PreUpdate(
     return;
   }
 
-  // Update force command.
-  double error;
+  // The target holds a value per axis, unlike the topic, which only commands
+  // the controlled axis
+  double targetPos;
+  auto target = _ecm.Component<components::JointPositionTarget>(
+      this->dataPtr->jointEntity);
+  if (target && this->dataPtr->jointIndex < target->Data().size())
+  {
+    targetPos = target->Data()[this->dataPtr->jointIndex];
+  }
+  else
   {
     std::lock_guard<std::mutex> lock(this->dataPtr->jointCmdMutex);
-    error = jointPosComp->Data().at(this->dataPtr->jointIndex) -
-            this->dataPtr->jointPosCmd;
+    targetPos = this->dataPtr->jointPosCmd;
   }
 
+  // Update force command.
+  double error =
+      jointPosComp->Data().at(this->dataPtr->jointIndex) - targetPos;
+
   double force = this->dataPtr->posPid.Update(error, _info.dt);
 
   auto forceComp =
@@ -41,6 +41,10 @@ namespace systems
   /// This topic accepts ignition::msgs::Double values representing the target
   /// position.
   ///
+  /// Targets can also be written to a JointPositionTarget component on the
+  /// joint, see components::JointPositionTarget. It holds a value per axis,
+  /// and the one at `<joint_index>` is used.
+  ///
   /// ## System Parameters
   ///
   /// `<joint_name>` The name of the joint to control. Required parameter.
@@ -19,6 +19,8 @@
 
 #include <ignition/msgs/model.pb.h>
 
+#include <algorithm>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -27,8 +29,7 @@
 #include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/components/Joint.hh"
 #include "ignition/gazebo/components/JointForce.hh"
-#include "ignition/gazebo/components/JointPosition.hh"
-#include "ignition/gazebo/components/JointVelocity.hh"
+#include "ignition/gazebo/components/JointStates.hh"
 #include "ignition/gazebo/components/ParentEntity.hh"
 #include "ignition/gazebo/components/Pose.hh"
 
@@ -89,6 +90,29 @@ void JointStatePublisher::Configure(
       this->CreateComponents(_ecm, joint);
     }
   }
+
+  double updateRate = _sdf->Get<double>("update_rate", 0.0).first;
+  if (updateRate > 0)
+  {
+    std::chrono::duration<double> period{1 / updateRate};
+    this->updatePeriod =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+  }
+
+  this->changedOnly = _sdf->Get<bool>("changed_only", false).first;
+  this->lastJointValues.assign(this->joints.size(),
+      std::array<double, 6>{});
+  for (auto &values : this->lastJointValues)
+    values.fill(std::numeric_limits<double>::quiet_NaN());
+
+  int batchSize = _sdf->Get<int>("batch_size", 1).first;
+  if (batchSize < 1)
+  {
+    ignerr << "JointStatePublisher <batch_size> must be at least 1, got ["
+           << batchSize << "]. Using 1." << std::endl;
+    batchSize = 1;
+  }
+  this->batchSize = static_cast<unsigned int>(batchSize);
 }
 
 //////////////////////////////////////////////////
@@ -103,18 +127,21 @@ void JointStatePublisher::CreateComponents(EntityComponentManager &_ecm,
 
   this->joints.insert(_joint);
 
-  // Create joint position component if one doesn't exist
-  if (!_ecm.EntityHasComponentType(_joint,
-        components::JointPosition().TypeId()))
+  // Have physics fill in the joint's position and velocity together with
+  // the rest of the model's joints
+  auto *jointStates =
+      _ecm.Component<components::JointStates>(this->model.Entity());
+  if (!jointStates)
   {
-    _ecm.CreateComponent(_joint, components::JointPosition());
+    _ecm.CreateComponent(this->model.Entity(), components::JointStates());
+    jointStates =
+        _ecm.Component<components::JointStates>(this->model.Entity());
   }
-
-  // Create joint velocity component if one doesn't exist
-  if (!_ecm.EntityHasComponentType(_joint,
-        components::JointVelocity().TypeId()))
+  auto &stateJoints = jointStates->Data().joints;
+  if (std::find(stateJoints.begin(), stateJoints.end(), _joint) ==
+      stateJoints.end())
   {
-    _ecm.CreateComponent(_joint, components::JointVelocity());
+    stateJoints.push_back(_joint);
   }
 
   // Create joint force component if one doesn't exist
@@ -145,8 +172,16 @@ void JointStatePublisher::PostUpdate(const UpdateInfo &_info,
       // Advertise the state topic
       std::string topic = std::string("/world/") + worldName + "/model/"
         + this->model.Name(_ecm) + "/joint_state";
-      this->modelPub = std::make_unique<transport::Node::Publisher>(
-          this->node.Advertise<msgs::Model>(topic));
+      if (this->batchSize > 1)
+      {
+        this->modelPub = std::make_unique<transport::Node::Publisher>(
+            this->node.Advertise<msgs::Model_V>(topic));
+      }
+      else
+      {
+        this->modelPub = std::make_unique<transport::Node::Publisher>(
+            this->node.Advertise<msgs::Model>(topic));
+      }
     }
   }
 
@@ -154,8 +189,23 @@ void JointStatePublisher::PostUpdate(const UpdateInfo &_info,
   if (!this->modelPub)
     return;
 
-  // Create the message
-  msgs::Model msg;
+  // Skip until the update period has passed. If time has gone backward,
+  // publish and allow the time to be reset.
+  if (this->updatePeriod > std::chrono::steady_clock::duration::zero())
+  {
+    auto diff = _info.simTime - this->lastPubTime;
+    if ((diff > std::chrono::steady_clock::duration::zero()) &&
+        (diff < this->updatePeriod))
+    {
+      return;
+    }
+    this->lastPubTime = _info.simTime;
+  }
+
+  // Create the message, or add a sample to the batch
+  msgs::Model singleMsg;
+  msgs::Model &msg = this->batchSize > 1 ?
+      *this->batchMsg.add_models() : singleMsg;
   msg.mutable_header()->mutable_stamp()->CopyFrom(
       convert<msgs::Time>(_info.simTime));
 
@@ -169,7 +219,26 @@ void JointStatePublisher::PostUpdate(const UpdateInfo &_info,
   if (pose)
     msgs::Set(msg.mutable_pose(), pose->Data());
 
+  // Find the published joints in the model's joint states. Joints are only
+  // appended, so this is redone when their number changes.
+  const auto *jointStates =
+      _ecm.Component<components::JointStates>(this->model.Entity());
+  if (jointStates &&
+      jointStates->Data().joints.size() != this->stateJointCount)
+  {
+    const auto &stateJoints = jointStates->Data().joints;
+    this->stateJointCount = stateJoints.size();
+    this->stateIndices.clear();
+    for (const Entity &joint : this->joints)
+    {
+      this->stateIndices.push_back(static_cast<std::size_t>(std::distance(
+          stateJoints.begin(),
+          std::find(stateJoints.begin(), stateJoints.end(), joint))));
+    }
+  }
+
   // Process each joint
+  std::size_t jointIndex{0};
   for (const Entity &joint : this->joints)
   {
     // Add a joint message.
@@ -182,33 +251,26 @@ void JointStatePublisher::PostUpdate(const UpdateInfo &_info,
     if (pose)
       msgs::Set(jointMsg->mutable_pose(), pose->Data());
 
-    // Set the joint position
-    const auto *jointPositions  =
-      _ecm.Component<components::JointPosition>(joint);
-    if (jointPositions)
+    // Set the joint position and velocity
+    const std::size_t stateIndex = jointIndex < this->stateIndices.size() ?
+        this->stateIndices[jointIndex] : this->stateJointCount;
+    if (jointStates && stateIndex + 1 < jointStates->Data().offsets.size())
     {
-      for (size_t i = 0; i < jointPositions->Data().size(); ++i)
+      const auto &states = jointStates->Data();
+      const std::size_t first = states.offsets[stateIndex];
+      const std::size_t last = states.offsets[stateIndex + 1];
+      for (size_t i = first; i < last; ++i)
       {
-        if (i == 0)
-          jointMsg->mutable_axis1()->set_position(jointPositions->Data()[i]);
-        else if (i == 1)
-          jointMsg->mutable_axis2()->set_position(jointPositions->Data()[i]);
-        else
-          ignwarn << "Joint state publisher only supports two joint axis\n";
-      }
-    }
-
-    // Set the joint velocity
-    const auto *jointVelocity  =
-      _ecm.Component<components::JointVelocity>(joint);
-    if (jointVelocity)
-    {
-      for (size_t i = 0; i < jointVelocity->Data().size(); ++i)
-      {
-        if (i == 0)
-          jointMsg->mutable_axis1()->set_velocity(jointVelocity->Data()[i]);
-        else if (i == 1)
-          jointMsg->mutable_axis2()->set_velocity(jointVelocity->Data()[i]);
+        if (i == first)
+        {
+          jointMsg->mutable_axis1()->set_position(states.positions[i]);
+          jointMsg->mutable_axis1()->set_velocity(states.velocities[i]);
+        }
+        else if (i == first + 1)
+        {
+          jointMsg->mutable_axis2()->set_position(states.positions[i]);
+          jointMsg->mutable_axis2()->set_velocity(states.velocities[i]);
+        }
         else
           ignwarn << "Joint state publisher only supports two joint axis\n";
       }
@@ -229,10 +291,41 @@ void JointStatePublisher::PostUpdate(const UpdateInfo &_info,
           ignwarn << "Joint state publisher only supports two joint axis\n";
       }
     }
+
+    // Drop the joint if it hasn't changed since it was last published
+    if (this->changedOnly && jointIndex < this->lastJointValues.size())
+    {
+      const std::array<double, 6> values{
+          jointMsg->axis1().position(), jointMsg->axis1().velocity(),
+          jointMsg->axis1().force(), jointMsg->axis2().position(),
+          jointMsg->axis2().velocity(), jointMsg->axis2().force()};
+      if (values == this->lastJointValues[jointIndex])
+        msg.mutable_joint()->RemoveLast();
+      else
+        this->lastJointValues[jointIndex] = values;
+    }
+    ++jointIndex;
+  }
+
+  // Nothing to publish if no joint changed
+  if (this->changedOnly && msg.joint_size() == 0)
+  {
+    if (this->batchSize > 1)
+      this->batchMsg.mutable_models()->RemoveLast();
+    return;
   }
 
   // Publish the message.
-  this->modelPub->Publish(msg);
+  if (this->batchSize <= 1)
+  {
+    this->modelPub->Publish(msg);
+  }
+  else if (static_cast<unsigned int>(this->batchMsg.models_size()) >=
+      this->batchSize)
+  {
+    this->modelPub->Publish(this->batchMsg);
+    this->batchMsg.Clear();
+  }
 }
 
 IGNITION_ADD_PLUGIN(JointStatePublisher,
@@ -18,8 +18,13 @@
 #ifndef IGNITION_GAZEBO_SYSTEMS_STATE_PUBLISHER_HH_
 #define IGNITION_GAZEBO_SYSTEMS_STATE_PUBLISHER_HH_
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <set>
+#include <vector>
+#include <ignition/msgs/model_v.pb.h>
 #include <ignition/gazebo/Model.hh>
 #include <ignition/transport/Node.hh>
 #include <ignition/gazebo/System.hh>
@@ -45,6 +50,18 @@ namespace systems
   /// `<joint_name>`: Name of a joint to publish. This parameter can be
   /// specified multiple times, and is optional. All joints in a model will
   /// be published if joint names are not specified.
+  ///
+  /// `<update_rate>`: Rate in Hz at which joint states are published. Defaults
+  /// to 0, which publishes every simulation step.
+  ///
+  /// `<changed_only>`: Set to true to publish only the joints whose position,
+  /// velocity or force changed since they were last published. Nothing is
+  /// published while no joint changes. Defaults to false.
+  ///
+  /// `<batch_size>`: Number of joint state samples to gather in each
+  /// message. When greater than 1, the topic carries ignition::msgs::Model_V
+  /// messages instead, with one stamped ignition::msgs::Model per sample,
+  /// which cuts the number of messages at high rates. Defaults to 1.
   class IGNITION_GAZEBO_VISIBLE JointStatePublisher
       : public System,
         public ISystemConfigure,
@@ -82,6 +99,34 @@ namespace systems
 
     /// \brief The joints that will be published.
     private: std::set<Entity> joints;
+
+    /// \brief Index of each published joint in the model's JointStates
+    /// component, in the same order as `joints`.
+    private: std::vector<std::size_t> stateIndices;
+
+    /// \brief Number of joints in the JointStates component when
+    /// `stateIndices` was computed.
+    private: std::size_t stateJointCount{0};
+
+    /// \brief Publication period, zero to publish every step.
+    private: std::chrono::steady_clock::duration updatePeriod{0};
+
+    /// \brief Last time joint states were sampled.
+    private: std::chrono::steady_clock::duration lastPubTime{0};
+
+    /// \brief True to publish only the joints which changed.
+    private: bool changedOnly{false};
+
+    /// \brief Last published position, velocity and force of both axes of
+    /// each joint, in the same order as `joints`. Only used with
+    /// `changedOnly`.
+    private: std::vector<std::array<double, 6>> lastJointValues;
+
+    /// \brief Number of samples per message.
+    private: unsigned int batchSize{1};
+
+    /// \brief Samples gathered while batching.
+    private: msgs::Model_V batchMsg;
   };
   }
 }
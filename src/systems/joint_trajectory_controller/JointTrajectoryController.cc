@@ -35,8 +35,14 @@
 #include <ignition/transport/Publisher.hh>
 #include <ignition/transport/TopicUtils.hh>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "JointTrajectoryController.hh"
@@ -46,10 +52,10 @@ using namespace gazebo;
 using namespace systems;
 
 /// \brief Helper class that contains all parameters required to create and
-/// configure an instance of ActuatedJoint
+/// configure an actuated joint
 class JointParameters
 {
-  /// \brief Parse all parameters required for creation of ActuatedJoint and
+  /// \brief Parse all parameters required for creation of actuated joints and
   /// return them in a map
   /// \param[in] _sdf SDF reference used to obtain the parameters
   /// \param[in] _ecm Ignition Entity Component Manager
@@ -134,79 +140,72 @@ class JointParameters
   } positionPID, velocityPID;
 };
 
-/// \brief A single 1-axis joint that is controlled by JointTrajectoryController
-/// plugin
-class ActuatedJoint
+/// \brief Position or velocity PID controllers of all actuated joints, stored
+/// as structure-of-arrays so that all joints are updated in one pass. Each
+/// controller behaves like ignition::math::PID.
+class PidArray
 {
-  /// \brief Default contructor
-  public: ActuatedJoint() = default;
+  /// \brief Add a controller.
+  /// \param[in] _params Parameters of the controller.
+  public: void Add(const JointParameters::PID &_params);
+
+  /// \brief Update all controllers.
+  /// \param[in] _errors Error of each controller. Controllers whose error is
+  /// not finite output 0 and keep their state, like ignition::math::PID.
+  /// \param[in] _dt Time difference to update for.
+  /// \param[out] _cmds Command of each controller.
+  public: void Update(const std::vector<double> &_errors,
+                      const std::chrono::steady_clock::duration &_dt,
+                      std::vector<double> &_cmds);
+
+  /// \brief Reset the errors of all controllers.
+  public: void Reset();
 
-  /// \brief Constructor that properly configures the actuated joint
-  /// \param[in] _entity Entity of the joint
-  /// \param[in] _params All parameters of the joint required for its
-  /// configuration
-  public: ActuatedJoint(const Entity &_entity,
-                        const JointParameters &_params);
+  /// \brief Proportional gain of each controller
+  public: std::vector<double> pGain;
 
-  /// \brief Setup components required for control of this joint
-  /// \param[in,out] _ecm Ignition Entity Component Manager
-  public: void SetupComponents(
-              ignition::gazebo::EntityComponentManager &_ecm) const;
+  /// \brief Integral gain of each controller
+  public: std::vector<double> iGain;
 
-  /// \brief Set target of the joint that the controller will attempt to reach
-  /// \param[in] _targetPoint Targets of all controlled joint
-  /// \param[in] _jointIndex Index of the joint, used to determine what index
-  /// of `_targetPoint` to use
-  public: void SetTarget(
-              const ignition::msgs::JointTrajectoryPoint &_targetPoint,
-              const size_t &_jointIndex);
+  /// \brief Derivative gain of each controller
+  public: std::vector<double> dGain;
 
-  /// \brief Update command force that is applied on the joint
-  /// \param[in,out] _ecm Ignition Entity Component Manager
-  /// \param[in] _dt Time difference to update for
-  public: void Update(ignition::gazebo::EntityComponentManager &_ecm,
-                      const std::chrono::steady_clock::duration &_dt);
+  /// \brief Integral lower limit of each controller
+  public: std::vector<double> iMin;
 
-  /// \brief Reset the target of the joint
-  public: void ResetTarget();
+  /// \brief Integral upper limit of each controller
+  public: std::vector<double> iMax;
 
-  /// \brief Reset the position and velocity PID error on the joint
-  public: void ResetPIDs();
+  /// \brief Output min value of each controller
+  public: std::vector<double> cmdMin;
 
-  /// \brief Entity of the joint
-  public: Entity entity;
+  /// \brief Output max value of each controller
+  public: std::vector<double> cmdMax;
 
-  /// \brief Target state that the joint controller should reach
-  public: struct TargetState
-  {
-    /// \brief Target position of the joint
-    double position;
-    /// \brief Target position of the joint
-    double velocity;
-    /// \brief Target acceleration of the joint
-    /// \attention Acceleration control is NOT implemented at the moment
-    double acceleration;
-    /// \brief Target force or torque of the joint
-    double effort;
-  } target;
+  /// \brief Output offset of each controller
+  public: std::vector<double> cmdOffset;
 
-  /// \brief Initial position of the joint
-  public: double initialPosition;
+  /// \brief Integral error of each controller
+  public: std::vector<double> iErr;
 
-  /// \brief List of PID controllers used for the control of this actuated joint
-  public: struct PIDs
-  {
-    /// \brief Position PID controller
-    ignition::math::PID position;
-    /// \brief Velocity PID controller
-    ignition::math::PID velocity;
-  } pids;
+  /// \brief Previous proportional error of each controller
+  public: std::vector<double> pErrLast;
 };
 
 /// \brief Information about trajectory that is followed by
-/// JointTrajectoryController plugin
+/// JointTrajectoryController plugin. The trajectory is preprocessed when it's
+/// received, so that following it only requires evaluating contiguous arrays
+/// of targets, indexed by actuated joint.
 class Trajectory
 {
+  /// \brief Preprocess a trajectory message.
+  /// \param[in] _msg Trajectory message.
+  /// \param[in] _jointIndices Index of each actuated joint, by name.
+  /// \param[in] _interpolate True to compute splines between points.
+  public: void Load(const ignition::msgs::JointTrajectory &_msg,
+              const std::unordered_map<std::string, std::size_t> &_jointIndices,
+              bool _interpolate);
+
   /// \brief Update index of trajectory points, such that it directs to a point
   /// that needs to be currently followed
   /// \param[in] _simTime Current simulation time
@@ -214,6 +213,23 @@ class Trajectory
   public: bool UpdateCurrentPoint(
               const std::chrono::steady_clock::duration &_simTime);
 
+  /// \brief Set the targets of the current point. Targets that the point
+  /// doesn't specify are left unchanged.
+  /// \param[in, out] _positions Target position of each actuated joint.
+  /// \param[in, out] _velocities Target velocity of each actuated joint.
+  /// \param[in, out] _efforts Target effort of each actuated joint.
+  public: void SetTargets(std::vector<double> &_positions,
+                          std::vector<double> &_velocities,
+                          std::vector<double> &_efforts) const;
+
+  /// \brief Evaluate the splines leading to the current point, if any.
+  /// \param[in] _simTime Current simulation time
+  /// \param[in, out] _positions Target position of each actuated joint.
+  /// \param[in, out] _velocities Target velocity of each actuated joint.
+  public: void Interpolate(const std::chrono::steady_clock::duration &_simTime,
+                           std::vector<double> &_positions,
+                           std::vector<double> &_velocities) const;
+
   /// \brief Determine if the trajectory goal was reached
   /// \return True if trajectory goal was reached, False otherwise
   public: bool IsGoalReached() const;
@@ -222,8 +238,8 @@ class Trajectory
   /// \return Fraction of the completed points in range (0.0, 1.0]
   public: float ComputeProgress() const;
 
-  /// \brief Reset trajectory internals, i.e. clean list of joint names, points
-  /// and reset index of the current point
+  /// \brief Reset trajectory internals, i.e. clean list of points and reset
+  /// index of the current point
   public: void Reset();
 
   /// \brief Status of the trajectory
@@ -244,13 +260,36 @@ class Trajectory
   /// \brief Index of the current trajectory point
   public: unsigned int pointIndex;
 
-  /// \brief Ordered joints that need to be actuated to follow the current
-  /// trajectory
-  public: std::vector<std::string> jointNames;
+  /// \brief Number of actuated joints, i.e. the stride of the arrays below
+  public: std::size_t jointCount{0};
+
+  /// \brief Time from start of each point
+  public: std::vector<std::chrono::steady_clock::duration> times;
+
+  /// \brief Target positions of each point, NaN where a point doesn't
+  /// specify the target of an actuated joint
+  public: std::vector<double> positions;
+
+  /// \brief Target velocities of each point, NaN where unspecified
+  public: std::vector<double> velocities;
+
+  /// \brief Target efforts of each point, NaN where unspecified
+  public: std::vector<double> efforts;
 
-  /// \brief Trajectory defined in terms of temporal points, whose members are
-  /// ordered according to `jointNames`
-  public: std::vector<ignition::msgs::JointTrajectoryPoint> points;
+  /// \brief Cubic position spline of each joint over the segment that ends
+  /// at each point, as p(s) = a + b * s + c * s^2 + d * s^3, where s is the
+  /// time in seconds since the previous point. They are NaN where the
+  /// position of either end is unspecified, and empty without interpolation.
+  public: std::vector<double> splineA;
+
+  /// \brief Linear coefficients of the splines, see splineA
+  public: std::vector<double> splineB;
+
+  /// \brief Quadratic coefficients of the splines, see splineA
+  public: std::vector<double> splineC;
+
+  /// \brief Cubic coefficients of the splines, see splineA
+  public: std::vector<double> splineD;
 };
 
 /// \brief Private data of the JointTrajectoryController plugin
@@ -269,6 +308,25 @@ class ignition::gazebo::systems::JointTrajectoryControllerPrivate
               const std::shared_ptr<const sdf::Element> &_sdf,
               EntityComponentManager &_ecm) const;
 
+  /// \brief Add an actuated joint
+  /// \param[in] _entity Entity of the joint
+  /// \param[in] _name Name of the joint
+  /// \param[in] _params All parameters of the joint required for its
+  /// configuration
+  public: void AddJoint(const Entity &_entity, const std::string &_name,
+                        const JointParameters &_params);
+
+  /// \brief Setup components required for control of the actuated joints
+  /// \param[in,out] _ecm Ignition Entity Component Manager
+  public: void SetupComponents(
+              ignition::gazebo::EntityComponentManager &_ecm) const;
+
+  /// \brief Update command forces that are applied on all actuated joints
+  /// \param[in,out] _ecm Ignition Entity Component Manager
+  /// \param[in] _dt Time difference to update for
+  public: void UpdateForces(ignition::gazebo::EntityComponentManager &_ecm,
+                            const std::chrono::steady_clock::duration &_dt);
+
   /// \brief Callback for joint trajectory subscription
   /// \param[in] _msg A new message describing a joint trajectory that needs
   /// to be followed
@@ -285,9 +343,44 @@ class ignition::gazebo::systems::JointTrajectoryControllerPrivate
   /// \brief Publisher of the progress for currently followed trajectory
   public: transport::Node::Publisher progressPub;
 
-  /// \brief Map of actuated joints, where the first entry of pair is the name
-  /// of the joint
-  public: std::map<std::string, ActuatedJoint> actuatedJoints;
+  /// \brief Entity of each actuated joint
+  public: std::vector<Entity> jointEntities;
+
+  /// \brief Index of each actuated joint, by name. It isn't modified after
+  /// Configure, so it's safe to read from the transport thread.
+  public: std::unordered_map<std::string, std::size_t> jointIndices;
+
+  /// \brief Initial position of each actuated joint
+  public: std::vector<double> initialPositions;
+
+  /// \brief Target position of each actuated joint
+  public: std::vector<double> targetPositions;
+
+  /// \brief Target velocity of each actuated joint
+  public: std::vector<double> targetVelocities;
+
+  /// \brief Target force or torque of each actuated joint
+  public: std::vector<double> targetEfforts;
+
+  /// \brief Position PID controller of each actuated joint
+  public: PidArray positionPids;
+
+  /// \brief Velocity PID controller of each actuated joint
+  public: PidArray velocityPids;
+
+  /// \brief Position error of each actuated joint, reused every step
+  public: std::vector<double> positionErrors;
+
+  /// \brief Velocity error of each actuated joint, reused every step
+  public: std::vector<double> velocityErrors;
+
+  /// \brief Force from the position controller of each actuated joint,
+  /// reused every step
+  public: std::vector<double> positionForces;
+
+  /// \brief Force from the velocity controller of each actuated joint,
+  /// reused every step
+  public: std::vector<double> velocityForces;
 
   /// \brief Mutex projecting trajectory
   public: std::mutex trajectoryMutex;
@@ -300,6 +393,10 @@ class ignition::gazebo::systems::JointTrajectoryControllerPrivate
   /// is used otherwise
   public: bool useHeaderStartTime;
 
+  /// \brief Flag that determines whether targets are interpolated with
+  /// splines between trajectory points
+  public: bool interpolate{false};
+
   /// \brief Flag that determines if all components required for control are
   /// already setup
   public: bool componentSetupFinished;
@@ -348,14 +445,14 @@ void JointTrajectoryController::Configure(
   {
     const auto jointName =
         _ecm.Component<components::Name>(jointEntity)->Data();
-    this->dataPtr->actuatedJoints[jointName] =
-        ActuatedJoint(jointEntity, jointParameters[jointName]);
+    this->dataPtr->AddJoint(jointEntity, jointName,
+                            jointParameters[jointName]);
     ignmsg << "[JointTrajectoryController] Configured joint ["
            << jointName << "(Entity=" << jointEntity << ")].\n";
   }
 
   // Make sure at least one joint is configured
-  if (this->dataPtr->actuatedJoints.empty())
+  if (this->dataPtr->jointEntities.empty())
   {
     ignerr << "[JointTrajectoryController] Failed to initialize because ["
            << model.Name(_ecm) << "(Entity=" << _entity
@@ -373,6 +470,7 @@ void JointTrajectoryController::Configure(
   {
     this->dataPtr->useHeaderStartTime = false;
   }
+  this->dataPtr->interpolate = _sdf->Get<bool>("interpolate", false).first;
 
   // Subscribe to joint trajectory commands
   auto trajectoryTopic = _sdf->Get<std::string>("topic");
@@ -416,11 +514,7 @@ void JointTrajectoryController::PreUpdate(
   // Create required components for each joint (only once)
   if (!this->dataPtr->componentSetupFinished)
   {
-    for (auto &actuatedJoint : this->dataPtr->actuatedJoints)
-    {
-      ActuatedJoint *joint = &actuatedJoint.second;
-      joint->SetupComponents(_ecm);
-    }
+    this->dataPtr->SetupComponents(_ecm);
     this->dataPtr->componentSetupFinished = true;
   }
 
@@ -457,7 +551,7 @@ void JointTrajectoryController::PreUpdate(
       }
 
       // If the new trajectory has no points, consider it reached
-      if (this->dataPtr->trajectory.points.empty())
+      if (this->dataPtr->trajectory.times.empty())
       {
         this->dataPtr->trajectory.status = Trajectory::Reached;
       }
@@ -481,22 +575,9 @@ void JointTrajectoryController::PreUpdate(
     if (isTargetUpdateRequired &&
         this->dataPtr->trajectory.status != Trajectory::Reached)
     {
-      const auto targetPoint =
-          this->dataPtr->trajectory.points[this->dataPtr->trajectory
-                                               .pointIndex];
-      for (auto jointIndex = 0u;
-           jointIndex < this->dataPtr->trajectory.jointNames.size();
-           ++jointIndex)
-      {
-        const auto jointName = this->dataPtr->trajectory.jointNames[jointIndex];
-        if (this->dataPtr->actuatedJoints.count(jointName) == 0)
-        {
-          // Warning about unconfigured joint is already logged above
-          continue;
-        }
-        auto *joint = &this->dataPtr->actuatedJoints[jointName];
-        joint->SetTarget(targetPoint, jointIndex);
-      }
+      this->dataPtr->trajectory.SetTargets(this->dataPtr->targetPositions,
+                                           this->dataPtr->targetVelocities,
+                                           this->dataPtr->targetEfforts);
 
       // If there are no more points after the current one, set the trajectory
       // to Reached
@@ -510,14 +591,15 @@ void JointTrajectoryController::PreUpdate(
       progressMsg.set_data(this->dataPtr->trajectory.ComputeProgress());
       this->dataPtr->progressPub.Publish(progressMsg);
     }
+
+    // Follow the splines towards the current point, if enabled
+    this->dataPtr->trajectory.Interpolate(_info.simTime,
+                                          this->dataPtr->targetPositions,
+                                          this->dataPtr->targetVelocities);
   }
 
   // Control loop
-  for (auto &actuatedJoint : this->dataPtr->actuatedJoints)
-  {
-    auto *joint = &actuatedJoint.second;
-    joint->Update(_ecm, _info.dt);
-  }
+  this->dataPtr->UpdateForces(_ecm, _info.dt);
 }
 
 ////////////////////////////////////////
@@ -575,14 +657,12 @@ std::vector<Entity> JointTrajectoryControllerPrivate::GetEnabledJoints(
                                    jointEntity)->Data();
 
     // Ignore duplicate joints
-    for (const auto &actuatedJoint : this->actuatedJoints)
+    if (std::find(this->jointEntities.begin(), this->jointEntities.end(),
+                  jointEntity) != this->jointEntities.end())
     {
-      if (actuatedJoint.second.entity == jointEntity)
-      {
-        ignwarn << "[JointTrajectoryController] Ignoring duplicate joint ["
-                << jointName << "(Entity=" << jointEntity << ")].\n";
-        continue;
-      }
+      ignwarn << "[JointTrajectoryController] Ignoring duplicate joint ["
+              << jointName << "(Entity=" << jointEntity << ")].\n";
+      continue;
     }
 
     // Make sure the joint type is supported, i.e. it has exactly one
@@ -648,60 +728,154 @@ void JointTrajectoryControllerPrivate::JointTrajectoryCallback(
                " acceleration commands, which are currently ignored.\n";
   }
 
-  // Lock mutex guarding the trajectory
-  std::lock_guard<std::mutex> lock(this->trajectoryMutex);
-
-  if (this->trajectory.status != Trajectory::Reached)
-  {
-    ignwarn << "[JointTrajectoryController] A new JointTrajectory message was"
-               " received while executing a previous trajectory.\n";
-  }
+  // Preprocess the trajectory on this thread, so that the simulation thread
+  // only needs to evaluate it
+  Trajectory newTrajectory;
+  newTrajectory.Load(_msg, this->jointIndices, this->interpolate);
 
   // Get start time of the trajectory from message header if desired
   // If not enabled or there is no header, set start time to 0 and determine
   // it later from simTime
+  newTrajectory.startTime = std::chrono::nanoseconds(0);
   if (this->useHeaderStartTime && _msg.has_header())
   {
     if (_msg.header().has_stamp())
     {
       const auto stamp = _msg.header().stamp();
-      this->trajectory.startTime = std::chrono::seconds(stamp.sec()) +
-                                   std::chrono::nanoseconds(stamp.nsec());
+      newTrajectory.startTime = std::chrono::seconds(stamp.sec()) +
+                                std::chrono::nanoseconds(stamp.nsec());
     }
   }
-  else
+
+  // Lock mutex guarding the trajectory
+  std::lock_guard<std::mutex> lock(this->trajectoryMutex);
+
+  if (this->trajectory.status != Trajectory::Reached)
   {
-    this->trajectory.startTime = std::chrono::nanoseconds(0);
+    ignwarn << "[JointTrajectoryController] A new JointTrajectory message was"
+               " received while executing a previous trajectory.\n";
   }
 
-  // Reset for a new trajectory
+  this->trajectory = std::move(newTrajectory);
+}
+
+//////////////////////////////////////////////////
+void JointTrajectoryControllerPrivate::Reset()
+{
+  // Reset joint targets
+  this->targetPositions = this->initialPositions;
+  std::fill(this->targetVelocities.begin(), this->targetVelocities.end(), 0.0);
+  std::fill(this->targetEfforts.begin(), this->targetEfforts.end(), 0.0);
+
+  // Reset PIDs
+  this->positionPids.Reset();
+  this->velocityPids.Reset();
+
+  // Reset trajectory
   this->trajectory.Reset();
+}
 
-  // Extract joint names and points
-  for (const auto &joint_name : _msg.joint_names())
-  {
-    this->trajectory.jointNames.push_back(joint_name);
-  }
-  for (const auto &point : _msg.points())
+//////////////////////////////////////////////////
+void JointTrajectoryControllerPrivate::AddJoint(const Entity &_entity,
+    const std::string &_name, const JointParameters &_params)
+{
+  this->jointIndices[_name] = this->jointEntities.size();
+  this->jointEntities.push_back(_entity);
+
+  this->initialPositions.push_back(_params.initialPosition);
+  this->targetPositions.push_back(_params.initialPosition);
+  this->targetVelocities.push_back(0.0);
+  this->targetEfforts.push_back(0.0);
+
+  this->positionPids.Add(_params.positionPID);
+  this->velocityPids.Add(_params.velocityPID);
+
+  igndbg << "[JointTrajectoryController] Parameters for joint (Entity="
+         << _entity << "):\n"
+         << "initial_position: ["    << _params.initialPosition       << "]\n"
+         << "position_p_gain: ["     << _params.positionPID.pGain     << "]\n"
+         << "position_i_gain: ["     << _params.positionPID.iGain     << "]\n"
+         << "position_d_gain: ["     << _params.positionPID.dGain     << "]\n"
+         << "position_i_min: ["      << _params.positionPID.iMax      << "]\n"
+         << "position_i_max: ["      << _params.positionPID.iMax      << "]\n"
+         << "position_cmd_min: ["    << _params.positionPID.cmdMin    << "]\n"
+         << "position_cmd_max: ["    << _params.positionPID.cmdMax    << "]\n"
+         << "position_cmd_offset: [" << _params.positionPID.cmdOffset << "]\n"
+         << "velocity_p_gain: ["     << _params.velocityPID.pGain     << "]\n"
+         << "velocity_i_gain: ["     << _params.velocityPID.iGain     << "]\n"
+         << "velocity_d_gain: ["     << _params.velocityPID.dGain     << "]\n"
+         << "velocity_i_min: ["      << _params.velocityPID.iMax      << "]\n"
+         << "velocity_i_max: ["      << _params.velocityPID.iMax      << "]\n"
+         << "velocity_cmd_min: ["    << _params.velocityPID.cmdMin    << "]\n"
+         << "velocity_cmd_max: ["    << _params.velocityPID.cmdMax    << "]\n"
+         << "velocity_cmd_offset: [" << _params.velocityPID.cmdOffset << "]\n";
+}
+
+//////////////////////////////////////////////////
+void JointTrajectoryControllerPrivate::SetupComponents(
+    ignition::gazebo::EntityComponentManager &_ecm) const
+{
+  for (const auto &entity : this->jointEntities)
   {
-    this->trajectory.points.push_back(point);
+    // Create JointPosition component if one does not exist
+    if (nullptr == _ecm.Component<components::JointPosition>(entity))
+    {
+      _ecm.CreateComponent(entity, components::JointPosition());
+    }
+
+    // Create JointVelocity component if one does not exist
+    if (nullptr == _ecm.Component<components::JointVelocity>(entity))
+    {
+      _ecm.CreateComponent(entity, components::JointVelocity());
+    }
+
+    // Create JointForceCmd component if one does not exist
+    if (nullptr == _ecm.Component<components::JointForceCmd>(entity))
+    {
+      _ecm.CreateComponent(entity, components::JointForceCmd({0.0}));
+    }
   }
 }
 
 //////////////////////////////////////////////////
-void JointTrajectoryControllerPrivate::Reset()
+void JointTrajectoryControllerPrivate::UpdateForces(
+    ignition::gazebo::EntityComponentManager &_ecm,
+    const std::chrono::steady_clock::duration &_dt)
 {
-  for (auto &actuatedJoint : this->actuatedJoints)
+  const std::size_t count = this->jointEntities.size();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  // Gather the control errors of all joints. Joints without a state yet have
+  // a NaN error, for which the controllers output no force.
+  this->positionErrors.resize(count);
+  this->velocityErrors.resize(count);
+  for (std::size_t i = 0; i < count; ++i)
   {
-    auto *joint = &actuatedJoint.second;
-    // Reset joint target
-    joint->ResetTarget();
-    // Reset PIDs
-    joint->ResetPIDs();
+    const auto &position =
+        _ecm.Component<components::JointPosition>(
+            this->jointEntities[i])->Data();
+    const auto &velocity =
+        _ecm.Component<components::JointVelocity>(
+            this->jointEntities[i])->Data();
+
+    this->positionErrors[i] = position.empty() ? nan :
+        position[0] - this->targetPositions[i];
+    this->velocityErrors[i] = velocity.empty() ? nan :
+        velocity[0] - this->targetVelocities[i];
   }
 
-  // Reset trajectory
-  this->trajectory.Reset();
+  // Compute the forces of all PID controllers in one pass each
+  this->positionPids.Update(this->positionErrors, _dt, this->positionForces);
+  this->velocityPids.Update(this->velocityErrors, _dt, this->velocityForces);
+
+  // Sum all forces and apply them
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    auto jointForceCmdComponent = _ecm.Component<components::JointForceCmd>(
+        this->jointEntities[i]);
+    jointForceCmdComponent->Data()[0] = this->positionForces[i] +
+        this->velocityForces[i] + this->targetEfforts[i];
+  }
 }
 
 ///////////////////////
@@ -839,160 +1013,187 @@ T JointParameters::NthElementOr(const std::vector<T> &_vec,
   }
 }
 
-/////////////////////
-/// ActuatedJoint ///
-/////////////////////
+////////////////
+/// PidArray ///
+////////////////
 
 //////////////////////////////////////////////////
-ActuatedJoint::ActuatedJoint(const Entity &_entity,
-                             const JointParameters &_params)
+void PidArray::Add(const JointParameters::PID &_params)
 {
-  this->entity = _entity;
-
-  this->initialPosition = _params.initialPosition;
-  this->target.position = _params.initialPosition;
-  this->target.velocity = 0.0;
-  this->target.acceleration = 0.0;
-  this->target.effort = 0.0;
-
-  this->pids.position = ignition::math::PID(_params.positionPID.pGain,
-                                            _params.positionPID.iGain,
-                                            _params.positionPID.dGain,
-                                            _params.positionPID.iMax,
-                                            _params.positionPID.iMin,
-                                            _params.positionPID.cmdMax,
-                                            _params.positionPID.cmdMin,
-                                            _params.positionPID.cmdOffset);
-
-  this->pids.velocity = ignition::math::PID(_params.velocityPID.pGain,
-                                            _params.velocityPID.iGain,
-                                            _params.velocityPID.dGain,
-                                            _params.velocityPID.iMax,
-                                            _params.velocityPID.iMin,
-                                            _params.velocityPID.cmdMax,
-                                            _params.velocityPID.cmdMin,
-                                            _params.velocityPID.cmdOffset);
-
-  igndbg << "[JointTrajectoryController] Parameters for joint (Entity="
-         << _entity << "):\n"
-         << "initial_position: ["    << _params.initialPosition       << "]\n"
-         << "position_p_gain: ["     << _params.positionPID.pGain     << "]\n"
-         << "position_i_gain: ["     << _params.positionPID.iGain     << "]\n"
-         << "position_d_gain: ["     << _params.positionPID.dGain     << "]\n"
-         << "position_i_min: ["      << _params.positionPID.iMax      << "]\n"
-         << "position_i_max: ["      << _params.positionPID.iMax      << "]\n"
-         << "position_cmd_min: ["    << _params.positionPID.cmdMin    << "]\n"
-         << "position_cmd_max: ["    << _params.positionPID.cmdMax    << "]\n"
-         << "position_cmd_offset: [" << _params.positionPID.cmdOffset << "]\n"
-         << "velocity_p_gain: ["     << _params.velocityPID.pGain     << "]\n"
-         << "velocity_i_gain: ["     << _params.velocityPID.iGain     << "]\n"
-         << "velocity_d_gain: ["     << _params.velocityPID.dGain     << "]\n"
-         << "velocity_i_min: ["      << _params.velocityPID.iMax      << "]\n"
-         << "velocity_i_max: ["      << _params.velocityPID.iMax      << "]\n"
-         << "velocity_cmd_min: ["    << _params.velocityPID.cmdMin    << "]\n"
-         << "velocity_cmd_max: ["    << _params.velocityPID.cmdMax    << "]\n"
-         << "velocity_cmd_offset: [" << _params.velocityPID.cmdOffset << "]\n";
+  this->pGain.push_back(_params.pGain);
+  this->iGain.push_back(_params.iGain);
+  this->dGain.push_back(_params.dGain);
+  this->iMin.push_back(_params.iMin);
+  this->iMax.push_back(_params.iMax);
+  this->cmdMin.push_back(_params.cmdMin);
+  this->cmdMax.push_back(_params.cmdMax);
+  this->cmdOffset.push_back(_params.cmdOffset);
+  this->iErr.push_back(0.0);
+  this->pErrLast.push_back(0.0);
 }
 
 //////////////////////////////////////////////////
-void ActuatedJoint::SetupComponents(
-    ignition::gazebo::EntityComponentManager &_ecm) const
+void PidArray::Update(const std::vector<double> &_errors,
+                      const std::chrono::steady_clock::duration &_dt,
+                      std::vector<double> &_cmds)
 {
-  // Create JointPosition component if one does not exist
-  if (nullptr == _ecm.Component<components::JointPosition>(this->entity))
-  {
-    _ecm.CreateComponent(this->entity, components::JointPosition());
-  }
+  const std::size_t count = this->pGain.size();
+  _cmds.resize(count);
 
-  // Create JointVelocity component if one does not exist
-  if (nullptr == _ecm.Component<components::JointVelocity>(this->entity))
+  const double dt = std::chrono::duration<double>(_dt).count();
+  if (dt == 0.0)
   {
-    _ecm.CreateComponent(this->entity, components::JointVelocity());
+    std::fill(_cmds.begin(), _cmds.end(), 0.0);
+    return;
   }
 
-  // Create JointForceCmd component if one does not exist
-  if (nullptr == _ecm.Component<components::JointForceCmd>(this->entity))
+  // Same arithmetic as ignition::math::PID::Update, written with selects
+  // instead of branches so that the loop can be vectorized.
+  for (std::size_t i = 0; i < count; ++i)
   {
-    _ecm.CreateComponent(this->entity, components::JointForceCmd({0.0}));
+    const bool valid = std::isfinite(_errors[i]);
+    const double pErr = valid ? _errors[i] : 0.0;
+
+    const double pTerm = this->pGain[i] * pErr;
+
+    double integral = this->iErr[i] + this->iGain[i] * dt * pErr;
+    const double clampedIntegral =
+        std::min(std::max(integral, this->iMin[i]), this->iMax[i]);
+    integral = this->iMax[i] >= this->iMin[i] ? clampedIntegral : integral;
+
+    const double dTerm = this->dGain[i] * (pErr - this->pErrLast[i]) / dt;
+
+    double cmd = this->cmdOffset[i] - pTerm - integral - dTerm;
+    const double clampedCmd =
+        std::min(std::max(cmd, this->cmdMin[i]), this->cmdMax[i]);
+    cmd = this->cmdMax[i] >= this->cmdMin[i] ? clampedCmd : cmd;
+
+    this->iErr[i] = valid ? integral : this->iErr[i];
+    this->pErrLast[i] = valid ? pErr : this->pErrLast[i];
+    _cmds[i] = valid ? cmd : 0.0;
   }
 }
 
 //////////////////////////////////////////////////
-void ActuatedJoint::SetTarget(
-    const ignition::msgs::JointTrajectoryPoint &_targetPoint,
-    const size_t &_jointIndex)
+void PidArray::Reset()
 {
-  if ((signed)_jointIndex < _targetPoint.positions_size())
-  {
-    this->target.position = _targetPoint.positions(_jointIndex);
-  }
-  if ((signed)_jointIndex < _targetPoint.velocities_size())
-  {
-    this->target.velocity = _targetPoint.velocities(_jointIndex);
-  }
-  if ((signed)_jointIndex < _targetPoint.accelerations_size())
-  {
-    this->target.acceleration = _targetPoint.accelerations(_jointIndex);
-  }
-  if ((signed)_jointIndex < _targetPoint.effort_size())
-  {
-    this->target.effort = _targetPoint.effort(_jointIndex);
-  }
+  std::fill(this->iErr.begin(), this->iErr.end(), 0.0);
+  std::fill(this->pErrLast.begin(), this->pErrLast.end(), 0.0);
 }
 
+//////////////////
+/// Trajectory ///
+//////////////////
+
 //////////////////////////////////////////////////
-void ActuatedJoint::Update(ignition::gazebo::EntityComponentManager &_ecm,
-                           const std::chrono::steady_clock::duration &_dt)
+void Trajectory::Load(const ignition::msgs::JointTrajectory &_msg,
+    const std::unordered_map<std::string, std::size_t> &_jointIndices,
+    bool _interpolate)
 {
-  // Get JointPosition and JointVelocity components
-  const auto jointPositionComponent = _ecm.Component<components::JointPosition>(
-      this->entity);
-  const auto jointVelocityComponent = _ecm.Component<components::JointVelocity>(
-      this->entity);
-
-  // Compute control errors and force for each PID controller
-  double forcePosition = 0.0, forceVelocity = 0.0;
-  if (!jointPositionComponent->Data().empty())
+  this->Reset();
+  this->jointCount = _jointIndices.size();
+
+  // Index of the actuated joint for each joint of the message
+  std::vector<std::size_t> indices;
+  for (const auto &jointName : _msg.joint_names())
   {
-    double errorPosition = jointPositionComponent->Data()[0] -
-                           this->target.position;
-    forcePosition = this->pids.position.Update(errorPosition, _dt);
+    auto it = _jointIndices.find(jointName);
+    if (it == _jointIndices.end())
+    {
+      ignwarn << "[JointTrajectoryController] Joint [" << jointName
+              << "] of the JointTrajectory message is not actuated by this "
+                 "controller and will be ignored.\n";
+      indices.push_back(this->jointCount);
+      continue;
+    }
+    indices.push_back(it->second);
   }
-  if (!jointVelocityComponent->Data().empty())
+
+  // Targets not specified by a point are kept from the previous point
+  const std::size_t pointCount = _msg.points_size();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  this->positions.assign(pointCount * this->jointCount, nan);
+  this->velocities.assign(pointCount * this->jointCount, nan);
+  this->efforts.assign(pointCount * this->jointCount, nan);
+  for (std::size_t p = 0; p < pointCount; ++p)
   {
-    double errorVelocity = jointVelocityComponent->Data()[0] -
-                           this->target.velocity;
-    forceVelocity = this->pids.velocity.Update(errorVelocity, _dt);
-  }
+    const auto &point = _msg.points(static_cast<int>(p));
+    const auto pointTFS = point.time_from_start();
+    this->times.push_back(std::chrono::seconds(pointTFS.sec()) +
+                          std::chrono::nanoseconds(pointTFS.nsec()));
 
-  // Sum all forces
-  const double force = forcePosition + forceVelocity + this->target.effort;
+    const std::size_t row = p * this->jointCount;
+    if (p > 0)
+    {
+      const std::size_t previousRow = row - this->jointCount;
+      for (std::size_t i = 0; i < this->jointCount; ++i)
+      {
+        this->positions[row + i] = this->positions[previousRow + i];
+        this->velocities[row + i] = this->velocities[previousRow + i];
+        this->efforts[row + i] = this->efforts[previousRow + i];
+      }
+    }
 
-  // Get JointForceCmd component and apply command force
-  auto jointForceCmdComponent = _ecm.Component<components::JointForceCmd>(
-      this->entity);
-  jointForceCmdComponent->Data()[0] = force;
-}
+    for (int j = 0; j < static_cast<int>(indices.size()); ++j)
+    {
+      const std::size_t i = indices[j];
+      if (i >= this->jointCount)
+        continue;
 
-//////////////////////////////////////////////////
-void ActuatedJoint::ResetTarget()
-{
-  this->target.position = this->initialPosition;
-  this->target.velocity = 0.0;
-  this->target.acceleration = 0.0;
-  this->target.effort = 0.0;
-}
+      if (j < point.positions_size())
+        this->positions[row + i] = point.positions(j);
+      if (j < point.velocities_size())
+        this->velocities[row + i] = point.velocities(j);
+      if (j < point.effort_size())
+        this->efforts[row + i] = point.effort(j);
+    }
+  }
 
-//////////////////////////////////////////////////
-void ActuatedJoint::ResetPIDs()
-{
-  this->pids.position.Reset();
-  this->pids.velocity.Reset();
-}
+  if (!_interpolate)
+    return;
 
-//////////////////
-/// Trajectory ///
-//////////////////
+  // Position splines over the segment that ends at each point. They are cubic
+  // Hermite splines if the velocities of both ends are known, and linear
+  // otherwise. There is no segment before the first point.
+  this->splineA.assign(pointCount * this->jointCount, nan);
+  this->splineB.assign(pointCount * this->jointCount, nan);
+  this->splineC.assign(pointCount * this->jointCount, nan);
+  this->splineD.assign(pointCount * this->jointCount, nan);
+  for (std::size_t p = 1; p < pointCount; ++p)
+  {
+    const double h =
+        std::chrono::duration<double>(this->times[p] - this->times[p - 1])
+        .count();
+    if (h <= 0.0)
+      continue;
+
+    const std::size_t row = p * this->jointCount;
+    const std::size_t previousRow = row - this->jointCount;
+    for (std::size_t i = 0; i < this->jointCount; ++i)
+    {
+      const double p0 = this->positions[previousRow + i];
+      const double p1 = this->positions[row + i];
+      if (std::isnan(p0) || std::isnan(p1))
+        continue;
+
+      const double v0 = this->velocities[previousRow + i];
+      const double v1 = this->velocities[row + i];
+      this->splineA[row + i] = p0;
+      if (std::isnan(v0) || std::isnan(v1))
+      {
+        this->splineB[row + i] = (p1 - p0) / h;
+        this->splineC[row + i] = 0.0;
+        this->splineD[row + i] = 0.0;
+      }
+      else
+      {
+        this->splineB[row + i] = v0;
+        this->splineC[row + i] = (3.0 * (p1 - p0) / h - 2.0 * v0 - v1) / h;
+        this->splineD[row + i] = (2.0 * (p0 - p1) / h + v0 + v1) / (h * h);
+      }
+    }
+  }
+}
 
 //////////////////////////////////////////////////
 bool Trajectory::UpdateCurrentPoint(
@@ -1011,10 +1212,7 @@ bool Trajectory::UpdateCurrentPoint(
     }
 
     // Break if point needs to be followed
-    const auto pointTFS = this->points[this->pointIndex].time_from_start();
-    const auto pointTime = std::chrono::seconds(pointTFS.sec()) +
-                           std::chrono::nanoseconds(pointTFS.nsec());
-    if (pointTime >= trajectoryTime)
+    if (this->times[this->pointIndex] >= trajectoryTime)
     {
       break;
     }
@@ -1028,23 +1226,80 @@ bool Trajectory::UpdateCurrentPoint(
   return isUpdated;
 }
 
+//////////////////////////////////////////////////
+void Trajectory::SetTargets(std::vector<double> &_positions,
+                            std::vector<double> &_velocities,
+                            std::vector<double> &_efforts) const
+{
+  if (this->pointIndex >= this->times.size())
+    return;
+
+  const std::size_t row = this->pointIndex * this->jointCount;
+  for (std::size_t i = 0; i < this->jointCount; ++i)
+  {
+    const double position = this->positions[row + i];
+    const double velocity = this->velocities[row + i];
+    const double effort = this->efforts[row + i];
+    _positions[i] = std::isnan(position) ? _positions[i] : position;
+    _velocities[i] = std::isnan(velocity) ? _velocities[i] : velocity;
+    _efforts[i] = std::isnan(effort) ? _efforts[i] : effort;
+  }
+}
+
+//////////////////////////////////////////////////
+void Trajectory::Interpolate(
+    const std::chrono::steady_clock::duration &_simTime,
+    std::vector<double> &_positions,
+    std::vector<double> &_velocities) const
+{
+  if (this->splineA.empty() || this->pointIndex == 0 ||
+      this->pointIndex >= this->times.size())
+  {
+    return;
+  }
+
+  // Only interpolate while the current point hasn't been reached
+  const auto trajectoryTime = _simTime - this->startTime;
+  const auto segmentStart = this->times[this->pointIndex - 1];
+  if (trajectoryTime >= this->times[this->pointIndex] ||
+      trajectoryTime < segmentStart)
+  {
+    return;
+  }
+
+  const double s =
+      std::chrono::duration<double>(trajectoryTime - segmentStart).count();
+  const std::size_t row = this->pointIndex * this->jointCount;
+  for (std::size_t i = 0; i < this->jointCount; ++i)
+  {
+    const double a = this->splineA[row + i];
+    const double b = this->splineB[row + i];
+    const double c = this->splineC[row + i];
+    const double d = this->splineD[row + i];
+    const double position = a + s * (b + s * (c + s * d));
+    const double velocity = b + s * (2.0 * c + 3.0 * s * d);
+    _positions[i] = std::isnan(a) ? _positions[i] : position;
+    _velocities[i] = std::isnan(a) ? _velocities[i] : velocity;
+  }
+}
+
 //////////////////////////////////////////////////
 bool Trajectory::IsGoalReached() const
 {
-  return this->pointIndex + 1 >= this->points.size();
+  return this->pointIndex + 1 >= this->times.size();
 }
 
 //////////////////////////////////////////////////
 float Trajectory::ComputeProgress() const
 {
-  if (this->points.size() == 0)
+  if (this->times.size() == 0)
   {
     return 1.0;
   }
   else
   {
     return static_cast<float>(this->pointIndex + 1) /
-           static_cast<float>(this->points.size());
+           static_cast<float>(this->times.size());
   }
 }
 
@@ -1053,8 +1308,14 @@ void Trajectory::Reset()
 {
   this->status = Trajectory::New;
   this->pointIndex = 0;
-  this->jointNames.clear();
-  this->points.clear();
+  this->times.clear();
+  this->positions.clear();
+  this->velocities.clear();
+  this->efforts.clear();
+  this->splineA.clear();
+  this->splineB.clear();
+  this->splineC.clear();
+  this->splineD.clear();
 }
 
 // Register plugin
@@ -56,7 +56,12 @@ namespace systems
   /// MoveIt2. For smooth execution of the trajectory, its points should to be
   /// interpolated before sending them via Ignition Transport (interpolation
   /// might already be implemented in the motion planning framework of your
-  /// choice).
+  /// choice), or `<interpolate>` can be enabled.
+  ///
+  /// Received trajectories are preprocessed on the transport thread into
+  /// per-point targets, and splines if enabled, stored contiguously for all
+  /// joints. The controllers of all joints are then updated together at every
+  /// step.
   ///
   /// The progress of the current trajectory can be tracked on topic whose name
   /// is derived as `<topic>_progress`. This progress is indicated in the range
@@ -74,6 +79,14 @@ namespace systems
   ///  Optional parameter.
   ///  Defaults to false.
   ///
+  /// `<interpolate>` If enabled, the position targets between consecutive
+  ///  trajectory points follow splines: cubic if both points have velocities,
+  ///  and linear otherwise. The velocity targets follow the derivative of the
+  ///  splines. Before the first point, its targets are used as is.
+  ///  Optional parameter.
+  ///  Defaults to false, where the targets of each point are used until its
+  ///  `time_from_start`.
+  ///
   /// `<joint_name>` Name of a joint to control.
   ///  This parameter can be specified multiple times, i.e. once for each joint.
   ///  Optional parameter.
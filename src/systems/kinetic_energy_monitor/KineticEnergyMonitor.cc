@@ -19,10 +19,14 @@
 #include <ignition/msgs/double.pb.h>
 
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <ignition/gazebo/components/AngularVelocity.hh>
 #include <ignition/gazebo/components/Link.hh>
 #include <ignition/gazebo/components/LinearVelocity.hh>
+#include <ignition/gazebo/components/Model.hh>
 #include <ignition/gazebo/components/Name.hh>
 #include <ignition/gazebo/components/Pose.hh>
 #include <ignition/gazebo/components/World.hh>
@@ -32,6 +36,11 @@
 #include <ignition/gazebo/Model.hh>
 #include <ignition/gazebo/Util.hh>
 
+#include <ignition/math/Inertial.hh>
+#include <ignition/math/Matrix3.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
 #include <ignition/plugin/Register.hh>
 
 #include <ignition/transport/Node.hh>
@@ -42,9 +51,85 @@ using namespace ignition;
 using namespace gazebo;
 using namespace systems;
 
+namespace
+{
+//////////////////////////////////////////////////
+/// \brief Compute the kinetic energy of a link, like
+/// Link::WorldKineticEnergy, from its components' data.
+/// \param[in] _inertial Inertial of the link.
+/// \param[in] _pose World pose of the link.
+/// \param[in] _linVel World linear velocity of the link origin.
+/// \param[in] _angVel World angular velocity of the link.
+/// \return Kinetic energy in Joule.
+double kineticEnergy(const math::Inertiald &_inertial,
+    const math::Pose3d &_pose, const math::Vector3d &_linVel,
+    const math::Vector3d &_angVel)
+{
+  // Linear velocity at the center of mass
+  const math::Vector3d comLinVel = _linVel +
+      _angVel.Cross(_pose.Rot().RotateVector(_inertial.Pose().Pos()));
+  const math::Matrix3d moi =
+      math::Inertiald(_inertial.MassMatrix(), _pose * _inertial.Pose()).Moi();
+
+  return 0.5 * (_inertial.MassMatrix().Mass() * comLinVel.SquaredLength() +
+      _angVel.Dot(moi * _angVel));
+}
+}
+
 /// \brief Private data class
 class ignition::gazebo::systems::KineticEnergyMonitorPrivate
 {
+  /// \brief Create the components needed to compute the kinetic energy of a
+  /// link, if they're not present.
+  /// \param[in] _ecm Mutable reference to the ECM.
+  /// \param[in] _link Link entity.
+  public: static void CreateComponents(EntityComponentManager &_ecm,
+      Entity _link);
+
+  /// \brief Start monitoring a link, when attached to the world. Does
+  /// nothing if the link doesn't match the configuration or is already
+  /// monitored.
+  /// \param[in] _ecm Mutable reference to the ECM.
+  /// \param[in] _link Link entity.
+  /// \param[in] _name Name of the link.
+  public: void AddLink(EntityComponentManager &_ecm, Entity _link,
+      const std::string &_name);
+
+  /// \brief Stop monitoring a link, when attached to the world.
+  /// \param[in] _link Link entity.
+  public: void RemoveLink(Entity _link);
+
+  /// \brief Whether the system is attached to the world, and monitors
+  /// the links below.
+  public: bool worldMode{false};
+
+  /// \brief Name of the monitored links.
+  public: std::string linkName;
+
+  /// \brief Names of the monitored models when attached to the world.
+  /// Empty to monitor all models.
+  public: std::unordered_set<std::string> modelNames;
+
+  /// \brief Index of each monitored link in the arrays below, when
+  /// attached to the world.
+  public: std::unordered_map<Entity, std::size_t> linkIndices;
+
+  /// \brief Monitored links, when attached to the world.
+  public: std::vector<Entity> links;
+
+  /// \brief Names of the models of the monitored links.
+  public: std::vector<std::string> linkModelNames;
+
+  /// \brief Kinetic energy of the monitored links during the previous
+  /// step.
+  public: std::vector<double> prevKineticEnergies;
+
+  /// \brief Publishers of the models of the monitored links.
+  public: std::vector<transport::Node::Publisher> pubs;
+
+  /// \brief Ignition communication node.
+  public: transport::Node node;
+
   /// \brief Link of the model.
   public: Entity linkEntity;
 
@@ -79,17 +164,6 @@ void KineticEnergyMonitor::Configure(const Entity &_entity,
         EntityComponentManager &_ecm,
         EventManager &/*_eventMgr*/)
 {
-  this->dataPtr->model = Model(_entity);
-
-  if (!this->dataPtr->model.Valid(_ecm))
-  {
-    ignerr << "KineticEnergyMonitor should be attached to a model "
-      << "entity. Failed to initialize." << std::endl;
-    return;
-  }
-
-  this->dataPtr->modelName = this->dataPtr->model.Name(_ecm);
-
   auto sdfClone = _sdf->Clone();
   std::string linkName;
   if (sdfClone->HasElement("link_name"))
@@ -104,6 +178,46 @@ void KineticEnergyMonitor::Configure(const Entity &_entity,
     return;
   }
 
+  this->dataPtr->keThreshold = sdfClone->Get<double>(
+      "kinetic_energy_threshold", 7.0).first;
+
+  // Monitor links of many models
+  if (_ecm.Component<components::World>(_entity))
+  {
+    this->dataPtr->worldMode = true;
+    this->dataPtr->linkName = linkName;
+
+    for (auto modelElem = sdfClone->GetElementImpl("model"); modelElem;
+         modelElem = modelElem->GetNextElement("model"))
+    {
+      this->dataPtr->modelNames.insert(modelElem->Get<std::string>());
+    }
+
+    // Links created later are added on PreUpdate
+    _ecm.Each<components::Link, components::Name>(
+        [&](const Entity &_link, const components::Link *,
+            const components::Name *_name) -> bool
+        {
+          this->dataPtr->AddLink(_ecm, _link, _name->Data());
+          return true;
+        });
+
+    ignmsg << "KineticEnergyMonitor monitoring [" << linkName << "] on "
+      << this->dataPtr->links.size() << " models" << std::endl;
+    return;
+  }
+
+  this->dataPtr->model = Model(_entity);
+
+  if (!this->dataPtr->model.Valid(_ecm))
+  {
+    ignerr << "KineticEnergyMonitor should be attached to a model or world "
+      << "entity. Failed to initialize." << std::endl;
+    return;
+  }
+
+  this->dataPtr->modelName = this->dataPtr->model.Name(_ecm);
+
   // Get the link entity
   this->dataPtr->linkEntity = this->dataPtr->model.LinkByName(_ecm, linkName);
 
@@ -114,9 +228,6 @@ void KineticEnergyMonitor::Configure(const Entity &_entity,
     return;
   }
 
-  this->dataPtr->keThreshold = sdfClone->Get<double>(
-      "kinetic_energy_threshold", 7.0).first;
-
   std::string defaultTopic{"/model/" + this->dataPtr->modelName +
     "/kinetic_energy"};
   std::string topic = sdfClone->Get<std::string>("topic", defaultTopic).first;
@@ -124,55 +235,187 @@ void KineticEnergyMonitor::Configure(const Entity &_entity,
   ignmsg << "KineticEnergyMonitor publishing messages on "
     << "[" << topic << "]" << std::endl;
 
-  transport::Node node;
-  this->dataPtr->pub = node.Advertise<msgs::Double>(topic);
+  this->dataPtr->pub = this->dataPtr->node.Advertise<msgs::Double>(topic);
 
-  if (!_ecm.Component<components::WorldPose>(this->dataPtr->linkEntity))
+  KineticEnergyMonitorPrivate::CreateComponents(_ecm,
+      this->dataPtr->linkEntity);
+}
+
+//////////////////////////////////////////////////
+void KineticEnergyMonitorPrivate::CreateComponents(
+    EntityComponentManager &_ecm, Entity _link)
+{
+  if (!_ecm.Component<components::WorldPose>(_link))
   {
-    _ecm.CreateComponent(this->dataPtr->linkEntity,
-        components::WorldPose());
+    _ecm.CreateComponent(_link, components::WorldPose());
   }
 
-  if (!_ecm.Component<components::Inertial>(this->dataPtr->linkEntity))
+  if (!_ecm.Component<components::Inertial>(_link))
   {
-    _ecm.CreateComponent(this->dataPtr->linkEntity, components::Inertial());
+    _ecm.CreateComponent(_link, components::Inertial());
   }
 
   // Create a world linear velocity component if one is not present.
-  if (!_ecm.Component<components::WorldLinearVelocity>(
-        this->dataPtr->linkEntity))
+  if (!_ecm.Component<components::WorldLinearVelocity>(_link))
   {
-    _ecm.CreateComponent(this->dataPtr->linkEntity,
-        components::WorldLinearVelocity());
+    _ecm.CreateComponent(_link, components::WorldLinearVelocity());
   }
 
   // Create an angular velocity component if one is not present.
-  if (!_ecm.Component<components::AngularVelocity>(
-        this->dataPtr->linkEntity))
+  if (!_ecm.Component<components::AngularVelocity>(_link))
   {
-    _ecm.CreateComponent(this->dataPtr->linkEntity,
-        components::AngularVelocity());
+    _ecm.CreateComponent(_link, components::AngularVelocity());
   }
 
   // Create an angular velocity component if one is not present.
-  if (!_ecm.Component<components::WorldAngularVelocity>(
-        this->dataPtr->linkEntity))
+  if (!_ecm.Component<components::WorldAngularVelocity>(_link))
   {
-    _ecm.CreateComponent(this->dataPtr->linkEntity,
-        components::WorldAngularVelocity());
+    _ecm.CreateComponent(_link, components::WorldAngularVelocity());
   }
 }
 
+//////////////////////////////////////////////////
+void KineticEnergyMonitorPrivate::AddLink(EntityComponentManager &_ecm,
+    Entity _link, const std::string &_name)
+{
+  if (_name != this->linkName ||
+      this->linkIndices.find(_link) != this->linkIndices.end())
+  {
+    return;
+  }
+
+  const Entity modelEntity = _ecm.ParentEntity(_link);
+  if (!_ecm.Component<components::Model>(modelEntity))
+    return;
+
+  const std::string modelName = Model(modelEntity).Name(_ecm);
+  if (!this->modelNames.empty() &&
+      this->modelNames.find(modelName) == this->modelNames.end())
+  {
+    return;
+  }
+
+  std::string topic = transport::TopicUtils::AsValidTopic(
+      "/model/" + modelName + "/kinetic_energy");
+  if (topic.empty())
+  {
+    ignerr << "Failed to create a valid topic for model [" << modelName
+      << "]" << std::endl;
+    return;
+  }
+
+  CreateComponents(_ecm, _link);
+
+  this->linkIndices[_link] = this->links.size();
+  this->links.push_back(_link);
+  this->linkModelNames.push_back(modelName);
+  this->prevKineticEnergies.push_back(0.0);
+  this->pubs.push_back(this->node.Advertise<msgs::Double>(topic));
+}
+
+//////////////////////////////////////////////////
+void KineticEnergyMonitorPrivate::RemoveLink(Entity _link)
+{
+  auto it = this->linkIndices.find(_link);
+  if (it == this->linkIndices.end())
+    return;
+
+  // Move the last link into the removed one's slot
+  const std::size_t index = it->second;
+  const std::size_t last = this->links.size() - 1;
+  if (index != last)
+  {
+    this->links[index] = this->links[last];
+    this->linkModelNames[index] = std::move(this->linkModelNames[last]);
+    this->prevKineticEnergies[index] = this->prevKineticEnergies[last];
+    this->pubs[index] = std::move(this->pubs[last]);
+    this->linkIndices[this->links[index]] = index;
+  }
+  this->links.pop_back();
+  this->linkModelNames.pop_back();
+  this->prevKineticEnergies.pop_back();
+  this->pubs.pop_back();
+  this->linkIndices.erase(it);
+}
+
+//////////////////////////////////////////////////
+void KineticEnergyMonitor::PreUpdate(const UpdateInfo &/*_info*/,
+    EntityComponentManager &_ecm)
+{
+  if (!this->dataPtr->worldMode)
+    return;
+
+  _ecm.EachNew<components::Link, components::Name>(
+      [&](const Entity &_link, const components::Link *,
+          const components::Name *_name) -> bool
+      {
+        this->dataPtr->AddLink(_ecm, _link, _name->Data());
+        return true;
+      });
+}
+
 //////////////////////////////////////////////////
 void KineticEnergyMonitor::PostUpdate(const UpdateInfo &/*_info*/,
     const EntityComponentManager &_ecm)
 {
+  if (this->dataPtr->worldMode)
+  {
+    // One pass over the links with velocities, only looking up the
+    // monitored ones
+    if (!this->dataPtr->links.empty())
+    {
+      _ecm.Each<components::Link, components::Inertial, components::WorldPose,
+                components::WorldLinearVelocity,
+                components::WorldAngularVelocity>(
+          [&](const Entity &_link, const components::Link *,
+              const components::Inertial *_inertial,
+              const components::WorldPose *_pose,
+              const components::WorldLinearVelocity *_linVel,
+              const components::WorldAngularVelocity *_angVel) -> bool
+          {
+            auto it = this->dataPtr->linkIndices.find(_link);
+            if (it == this->dataPtr->linkIndices.end())
+              return true;
+
+            const std::size_t i = it->second;
+            double currKineticEnergy = kineticEnergy(_inertial->Data(),
+                _pose->Data(), _linVel->Data(), _angVel->Data());
+
+            // We only care about positive values of this (the links looses
+            // energy)
+            double deltaKE =
+                this->dataPtr->prevKineticEnergies[i] - currKineticEnergy;
+            this->dataPtr->prevKineticEnergies[i] = currKineticEnergy;
+
+            if (deltaKE > this->dataPtr->keThreshold)
+            {
+              ignmsg << this->dataPtr->linkModelNames[i]
+                << " Change in kinetic energy above threshold - deltaKE: "
+                << deltaKE << std::endl;
+              msgs::Double msg;
+              msg.set_data(deltaKE);
+              this->dataPtr->pubs[i].Publish(msg);
+            }
+            return true;
+          });
+    }
+
+    _ecm.EachRemoved<components::Link>(
+        [&](const Entity &_link, const components::Link *) -> bool
+        {
+          this->dataPtr->RemoveLink(_link);
+          return true;
+        });
+    return;
+  }
+
   if (this->dataPtr->linkEntity != kNullEntity)
   {
     Link link(this->dataPtr->linkEntity);
-    if (std::nullopt != link.WorldKineticEnergy(_ecm))
+    auto linkEnergy = link.WorldKineticEnergy(_ecm);
+    if (std::nullopt != linkEnergy)
     {
-      double currKineticEnergy = *link.WorldKineticEnergy(_ecm);
+      double currKineticEnergy = *linkEnergy;
 
       // We only care about positive values of this (the links looses energy)
       double deltaKE = this->dataPtr->prevKineticEnergy - currKineticEnergy;
@@ -193,6 +436,7 @@ void KineticEnergyMonitor::PostUpdate(const UpdateInfo &/*_info*/,
 
 IGNITION_ADD_PLUGIN(KineticEnergyMonitor, System,
   KineticEnergyMonitor::ISystemConfigure,
+  KineticEnergyMonitor::ISystemPreUpdate,
   KineticEnergyMonitor::ISystemPostUpdate
 )
 
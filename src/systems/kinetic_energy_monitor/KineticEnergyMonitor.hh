@@ -39,10 +39,20 @@ namespace systems
   /// that surpasses a specific threshold.
   /// This system can be used to detect when a model could be damaged.
   ///
+  /// The system can also be attached to the world, to monitor many models
+  /// with a single instance. The kinetic energy of all their links is then
+  /// computed in one pass over the links' velocities, and each model
+  /// publishes on its default topic.
+  ///
   /// # System Parameters
   ///
   /// `<link_name>`: Name of the link to monitor. This name must match
-  /// a name of link within the model.
+  /// a name of link within the model. When attached to the world, the link
+  /// of this name is monitored on every model which has one.
+  ///
+  /// `<model>`: Only used when attached to the world. Name of a model to
+  /// monitor, may be repeated. If there are none, all models are
+  /// monitored, including the ones spawned later.
   ///
   /// `<kinetic_energy_threshold>`: Threshold, in Joule (J), after which
   /// a message is generated on `<topic>` with the kinetic energy value that
@@ -50,7 +60,8 @@ namespace systems
   ///
   /// `<topic>`: Custom topic that this system will publish to when kinetic
   /// energy surpasses the threshold. This element if optional, and the
-  /// default value is `/model/{name_of_model}/kinetic_energy`.
+  /// default value is `/model/{name_of_model}/kinetic_energy`. It's ignored
+  /// when attached to the world.
   ///
   /// # Example Usage
   ///
@@ -100,6 +111,7 @@ namespace systems
   class IGNITION_GAZEBO_VISIBLE KineticEnergyMonitor:
     public System,
     public ISystemConfigure,
+    public ISystemPreUpdate,
     public ISystemPostUpdate
   {
     /// \brief Constructor
@@ -114,6 +126,10 @@ namespace systems
                            EntityComponentManager &_ecm,
                            EventManager &_eventMgr) final;
 
+    // Documentation inherited
+    public: void PreUpdate(const UpdateInfo &_info,
+                           EntityComponentManager &_ecm) final;
+
     // Documentation inherited
     public: void PostUpdate(const UpdateInfo &_info,
                             const EntityComponentManager &_ecm) final;
@@ -44,20 +44,9 @@ using namespace ignition;
 using namespace gazebo;
 using namespace systems;
 
-class ignition::gazebo::systems::LiftDragPrivate
+/// \brief Properties of one lifting surface.
+class LiftDragSurface
 {
-  // Initialize the system
-  public: void Load(const EntityComponentManager &_ecm,
-                    const sdf::ElementPtr &_sdf);
-
-  /// \brief Compute lift and drag forces and update the corresponding
-  /// components
-  /// \param[in] _ecm Immutable reference to the EntityComponentManager
-  public: void Update(EntityComponentManager &_ecm);
-
-  /// \brief Model interface
-  public: Model model{kNullEntity};
-
   /// \brief Coefficient of Lift / alpha slope.
   /// Lift = C_L * q * S
   /// where q (dynamic pressure) = 0.5 * rho * v^2
@@ -120,11 +109,70 @@ class ignition::gazebo::systems::LiftDragPrivate
   /// value.
   public: double controlJointRadToCL = 4.0;
 
-  /// \brief Link entity targeted this plugin.
-  public: Entity linkEntity;
+  /// \brief Name of the link this surface is attached to.
+  public: std::string linkName;
+
+  /// \brief Name of the joint that actuates a control surface for this
+  /// lifting body. Empty if there is none.
+  public: std::string controlJointName;
+
+  /// \brief Link entity targeted by this surface.
+  public: Entity linkEntity{kNullEntity};
 
   /// \brief Joint entity that actuates a control surface for this lifting body
-  public: Entity controlJointEntity;
+  public: Entity controlJointEntity{kNullEntity};
+};
+
+class ignition::gazebo::systems::LiftDragPrivate
+{
+  // Initialize the system
+  public: void Load(const EntityComponentManager &_ecm,
+                    const sdf::ElementPtr &_sdf);
+
+  /// \brief Read the properties of a surface. Properties that aren't set in
+  /// _sdf keep their current value in _surface.
+  /// \param[in] _sdf Element with the properties.
+  /// \param[in,out] _surface Surface to update.
+  public: void LoadSurface(const sdf::ElementPtr &_sdf,
+                           LiftDragSurface &_surface) const;
+
+  /// \brief Find the link and control joint of a surface.
+  /// \param[in] _ecm Immutable reference to the EntityComponentManager
+  /// \param[in,out] _surface Surface whose entities are set.
+  /// \return True if the surface's link was found.
+  public: bool FindSurfaceEntities(const EntityComponentManager &_ecm,
+                                   LiftDragSurface &_surface) const;
+
+  /// \brief Compute lift and drag forces and update the corresponding
+  /// components
+  /// \param[in] _ecm Immutable reference to the EntityComponentManager
+  public: void Update(EntityComponentManager &_ecm);
+
+  /// \brief Compute the wrench of one surface.
+  /// \param[in,out] _surface The surface.
+  /// \param[in] _pose World pose of the surface's link.
+  /// \param[in] _linVel World linear velocity of the surface's link.
+  /// \param[in] _angVel World angular velocity of the surface's link.
+  /// \param[in] _controlJointPosition Position of the surface's control
+  /// joint, or null if it has none.
+  /// \param[out] _force Force about the link's origin in world frame.
+  /// \param[out] _torque Torque about the link's origin in world frame.
+  /// \return False if the surface is too slow to generate forces.
+  public: bool SurfaceWrench(LiftDragSurface &_surface,
+                             const math::Pose3d &_pose,
+                             const math::Vector3d &_linVel,
+                             const math::Vector3d &_angVel,
+                             const components::JointPosition
+                                 *_controlJointPosition,
+                             math::Vector3d &_force,
+                             math::Vector3d &_torque) const;
+
+  /// \brief Model interface
+  public: Model model{kNullEntity};
+
+  /// \brief All surfaces handled by this system, sorted by link so that
+  /// the state of each link is only looked up once per step.
+  public: std::vector<LiftDragSurface> surfaces;
 
   /// \brief Set during Load to true if the configuration for the system is
   /// valid and the post-update can run
@@ -141,69 +189,105 @@ class ignition::gazebo::systems::LiftDragPrivate
 void LiftDragPrivate::Load(const EntityComponentManager &_ecm,
                            const sdf::ElementPtr &_sdf)
 {
-  this->cla = _sdf->Get<double>("cla", this->cla).first;
-  this->cda = _sdf->Get<double>("cda", this->cda).first;
-  this->cma = _sdf->Get<double>("cma", this->cma).first;
-  this->alphaStall = _sdf->Get<double>("alpha_stall", this->alphaStall).first;
-  this->claStall = _sdf->Get<double>("cla_stall", this->claStall).first;
-  this->cdaStall = _sdf->Get<double>("cda_stall", this->cdaStall).first;
-  this->cmaStall = _sdf->Get<double>("cma_stall", this->cmaStall).first;
-  this->rho = _sdf->Get<double>("air_density", this->rho).first;
-  this->radialSymmetry = _sdf->Get<bool>("radial_symmetry",
-      this->radialSymmetry).first;
-  this->area = _sdf->Get<double>("area", this->area).first;
-  this->alpha0 = _sdf->Get<double>("a0", this->alpha0).first;
-  this->cp = _sdf->Get<ignition::math::Vector3d>("cp", this->cp).first;
+  // Properties set at the top level are the defaults of every surface
+  LiftDragSurface defaults;
+  this->LoadSurface(_sdf, defaults);
+
+  if (_sdf->HasElement("surface"))
+  {
+    for (auto surfaceElem = _sdf->GetElement("surface"); surfaceElem;
+         surfaceElem = surfaceElem->GetNextElement("surface"))
+    {
+      LiftDragSurface surface = defaults;
+      this->LoadSurface(surfaceElem, surface);
+      if (this->FindSurfaceEntities(_ecm, surface))
+        this->surfaces.push_back(surface);
+    }
+  }
+  else if (this->FindSurfaceEntities(_ecm, defaults))
+  {
+    this->surfaces.push_back(defaults);
+  }
+
+  std::stable_sort(this->surfaces.begin(), this->surfaces.end(),
+      [](const LiftDragSurface &_a, const LiftDragSurface &_b)
+      {
+        return _a.linkEntity < _b.linkEntity;
+      });
+
+  // If we have at least one surface, we have a valid configuration
+  this->validConfig = !this->surfaces.empty();
+}
+
+//////////////////////////////////////////////////
+void LiftDragPrivate::LoadSurface(const sdf::ElementPtr &_sdf,
+                                  LiftDragSurface &_surface) const
+{
+  _surface.cla = _sdf->Get<double>("cla", _surface.cla).first;
+  _surface.cda = _sdf->Get<double>("cda", _surface.cda).first;
+  _surface.cma = _sdf->Get<double>("cma", _surface.cma).first;
+  _surface.alphaStall =
+      _sdf->Get<double>("alpha_stall", _surface.alphaStall).first;
+  _surface.claStall = _sdf->Get<double>("cla_stall", _surface.claStall).first;
+  _surface.cdaStall = _sdf->Get<double>("cda_stall", _surface.cdaStall).first;
+  _surface.cmaStall = _sdf->Get<double>("cma_stall", _surface.cmaStall).first;
+  _surface.rho = _sdf->Get<double>("air_density", _surface.rho).first;
+  _surface.radialSymmetry = _sdf->Get<bool>("radial_symmetry",
+      _surface.radialSymmetry).first;
+  _surface.area = _sdf->Get<double>("area", _surface.area).first;
+  _surface.alpha0 = _sdf->Get<double>("a0", _surface.alpha0).first;
+  _surface.cp = _sdf->Get<ignition::math::Vector3d>("cp", _surface.cp).first;
 
   // blade forward (-drag) direction in link frame
-  this->forward =
-      _sdf->Get<ignition::math::Vector3d>("forward", this->forward).first;
-  this->forward.Normalize();
+  _surface.forward =
+      _sdf->Get<ignition::math::Vector3d>("forward", _surface.forward).first;
+  _surface.forward.Normalize();
 
   // blade upward (+lift) direction in link frame
-  this->upward = _sdf->Get<ignition::math::Vector3d>(
-      "upward", this->upward) .first;
-  this->upward.Normalize();
+  _surface.upward = _sdf->Get<ignition::math::Vector3d>(
+      "upward", _surface.upward).first;
+  _surface.upward.Normalize();
 
-  this->controlJointRadToCL = _sdf->Get<double>(
-      "control_joint_rad_to_cl", this->controlJointRadToCL).first;
+  _surface.controlJointRadToCL = _sdf->Get<double>(
+      "control_joint_rad_to_cl", _surface.controlJointRadToCL).first;
 
-  if (_sdf->HasElement("link_name"))
-  {
-    sdf::ElementPtr elem = _sdf->GetElement("link_name");
-    auto linkName = elem->Get<std::string>();
-    this->linkEntity = this->model.LinkByName(_ecm, linkName);
+  _surface.linkName = _sdf->Get<std::string>("link_name",
+      _surface.linkName).first;
+  _surface.controlJointName = _sdf->Get<std::string>("control_joint_name",
+      _surface.controlJointName).first;
+}
 
-    if (this->linkEntity == kNullEntity)
-    {
-      ignerr << "Link with name[" << linkName << "] not found. "
-             << "The LiftDrag will not generate forces\n";
-      this->validConfig = false;
-      return;
-    }
-  }
-  else
+//////////////////////////////////////////////////
+bool LiftDragPrivate::FindSurfaceEntities(const EntityComponentManager &_ecm,
+                                          LiftDragSurface &_surface) const
+{
+  if (_surface.linkName.empty())
   {
-    this->validConfig = false;
+    ignerr << "Missing <link_name>. "
+           << "The LiftDrag will not generate forces\n";
+    return false;
   }
 
+  _surface.linkEntity = this->model.LinkByName(_ecm, _surface.linkName);
+  if (_surface.linkEntity == kNullEntity)
+  {
+    ignerr << "Link with name[" << _surface.linkName << "] not found. "
+           << "The LiftDrag will not generate forces\n";
+    return false;
+  }
 
-  if (_sdf->HasElement("control_joint_name"))
+  if (!_surface.controlJointName.empty())
   {
-    auto controlJointName = _sdf->Get<std::string>("control_joint_name");
-    this->controlJointEntity = this->model.JointByName(_ecm, controlJointName);
-    if (this->controlJointEntity == kNullEntity)
-    {
-      ignerr << "Joint with name[" << controlJointName << "] does not exist.\n";
-    }
-    else
+    _surface.controlJointEntity =
+        this->model.JointByName(_ecm, _surface.controlJointName);
+    if (_surface.controlJointEntity == kNullEntity)
     {
-      this->validConfig = false;
+      ignerr << "Joint with name[" << _surface.controlJointName
+             << "] does not exist.\n";
     }
   }
 
-  // If we reached here, we have a valid configuration
-  this->validConfig = true;
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -216,38 +300,87 @@ LiftDrag::LiftDrag()
 void LiftDragPrivate::Update(EntityComponentManager &_ecm)
 {
   IGN_PROFILE("LiftDragPrivate::Update");
-  // get linear velocity at cp in world frame
-  const auto worldLinVel =
-      _ecm.Component<components::WorldLinearVelocity>(this->linkEntity);
-  const auto worldAngVel =
-      _ecm.Component<components::WorldAngularVelocity>(this->linkEntity);
-  const auto worldPose =
-      _ecm.Component<components::WorldPose>(this->linkEntity);
-
-  components::JointPosition *controlJointPosition = nullptr;
-  if (this->controlJointEntity != kNullEntity)
+
+  // Surfaces are sorted by link, so the link state is looked up once for
+  // all of its surfaces, and their wrenches are applied together.
+  Entity currentLink{kNullEntity};
+  const components::WorldLinearVelocity *worldLinVel{nullptr};
+  const components::WorldAngularVelocity *worldAngVel{nullptr};
+  const components::WorldPose *worldPose{nullptr};
+  math::Vector3d linkForce;
+  math::Vector3d linkTorque;
+  bool hasWrench{false};
+
+  auto applyWrench = [&]()
+  {
+    if (!hasWrench)
+      return;
+    Link link(currentLink);
+    link.AddWorldWrench(_ecm, linkForce, linkTorque);
+  };
+
+  for (auto &surface : this->surfaces)
   {
-    controlJointPosition =
-        _ecm.Component<components::JointPosition>(this->controlJointEntity);
+    if (surface.linkEntity != currentLink)
+    {
+      applyWrench();
+
+      currentLink = surface.linkEntity;
+      // get linear velocity at cp in world frame
+      worldLinVel = _ecm.Component<components::WorldLinearVelocity>(
+          currentLink);
+      worldAngVel = _ecm.Component<components::WorldAngularVelocity>(
+          currentLink);
+      worldPose = _ecm.Component<components::WorldPose>(currentLink);
+      linkForce = math::Vector3d::Zero;
+      linkTorque = math::Vector3d::Zero;
+      hasWrench = false;
+    }
+
+    if (!worldLinVel || !worldAngVel || !worldPose)
+      continue;
+
+    const components::JointPosition *controlJointPosition = nullptr;
+    if (surface.controlJointEntity != kNullEntity)
+    {
+      controlJointPosition = _ecm.Component<components::JointPosition>(
+          surface.controlJointEntity);
+    }
+
+    math::Vector3d force;
+    math::Vector3d torque;
+    if (this->SurfaceWrench(surface, worldPose->Data(), worldLinVel->Data(),
+          worldAngVel->Data(), controlJointPosition, force, torque))
+    {
+      linkForce += force;
+      linkTorque += torque;
+      hasWrench = true;
+    }
   }
 
-  if (!worldLinVel || !worldAngVel || !worldPose)
-    return;
+  applyWrench();
+}
 
-  const auto &pose = worldPose->Data();
-  const auto cpWorld = pose.Rot().RotateVector(this->cp);
-  const auto vel = worldLinVel->Data() + worldAngVel->Data().Cross(cpWorld);
+//////////////////////////////////////////////////
+bool LiftDragPrivate::SurfaceWrench(LiftDragSurface &_surface,
+    const math::Pose3d &_pose, const math::Vector3d &_linVel,
+    const math::Vector3d &_angVel,
+    const components::JointPosition *_controlJointPosition,
+    math::Vector3d &_force, math::Vector3d &_torque) const
+{
+  const auto cpWorld = _pose.Rot().RotateVector(_surface.cp);
+  const auto vel = _linVel + _angVel.Cross(cpWorld);
 
   if (vel.Length() <= 0.01)
-    return;
+    return false;
 
   const auto velI = vel.Normalized();
 
   // rotate forward and upward vectors into world frame
-  const auto forwardI = pose.Rot().RotateVector(this->forward);
+  const auto forwardI = _pose.Rot().RotateVector(_surface.forward);
 
   ignition::math::Vector3d upwardI;
-  if (this->radialSymmetry)
+  if (_surface.radialSymmetry)
   {
     // use inflow velocity to determine upward direction
     // which is the component of inflow perpendicular to forward direction.
@@ -256,7 +389,7 @@ void LiftDragPrivate::Update(EntityComponentManager &_ecm)
   }
   else
   {
-    upwardI = pose.Rot().RotateVector(this->upward);
+    upwardI = _pose.Rot().RotateVector(_surface.upward);
   }
 
   // spanwiseI: a vector normal to lift-drag-plane described in world frame
@@ -311,9 +444,9 @@ void LiftDragPrivate::Update(EntityComponentManager &_ecm)
   // forwardI points toward zero alpha
   // if forwardI is in the same direction as lift, alpha is positive.
   // liftI is in the same direction as forwardI?
-  double alpha = this->alpha0 - std::acos(cosAlpha);
+  double alpha = _surface.alpha0 - std::acos(cosAlpha);
   if (liftI.Dot(forwardI) >= 0.0)
-    alpha = this->alpha0 + std::acos(cosAlpha);
+    alpha = _surface.alpha0 + std::acos(cosAlpha);
 
   // normalize to within +/-90 deg
   while (fabs(alpha) > 0.5 * IGN_PI)
@@ -323,82 +456,82 @@ void LiftDragPrivate::Update(EntityComponentManager &_ecm)
 
   // compute dynamic pressure
   const double speedInLDPlane = velInLDPlane.Length();
-  const double q = 0.5 * this->rho * speedInLDPlane * speedInLDPlane;
+  const double q = 0.5 * _surface.rho * speedInLDPlane * speedInLDPlane;
 
   // compute cl at cp, check for stall, correct for sweep
   double cl;
-  if (alpha > this->alphaStall)
+  if (alpha > _surface.alphaStall)
   {
-    cl = (this->cla * this->alphaStall +
-          this->claStall * (alpha - this->alphaStall)) *
+    cl = (_surface.cla * _surface.alphaStall +
+          _surface.claStall * (alpha - _surface.alphaStall)) *
          cosSweepAngle;
     // make sure cl is still great than 0
     cl = std::max(0.0, cl);
   }
-  else if (alpha < -this->alphaStall)
+  else if (alpha < -_surface.alphaStall)
   {
-    cl = (-this->cla * this->alphaStall +
-          this->claStall * (alpha + this->alphaStall))
+    cl = (-_surface.cla * _surface.alphaStall +
+          _surface.claStall * (alpha + _surface.alphaStall))
          * cosSweepAngle;
     // make sure cl is still less than 0
     cl = std::min(0.0, cl);
   }
   else
-    cl = this->cla * alpha * cosSweepAngle;
+    cl = _surface.cla * alpha * cosSweepAngle;
 
   // modify cl per control joint value
-  if (controlJointPosition)
+  if (_controlJointPosition)
   {
-    cl = cl + this->controlJointRadToCL * controlJointPosition->Data()[0];
+    cl = cl + _surface.controlJointRadToCL * _controlJointPosition->Data()[0];
     /// \todo(anyone): also change cm and cd
   }
 
   // compute lift force at cp
-  ignition::math::Vector3d lift = cl * q * this->area * liftI;
+  ignition::math::Vector3d lift = cl * q * _surface.area * liftI;
 
   // compute cd at cp, check for stall, correct for sweep
   double cd;
-  if (alpha > this->alphaStall)
+  if (alpha > _surface.alphaStall)
   {
-    cd = (this->cda * this->alphaStall +
-          this->cdaStall * (alpha - this->alphaStall))
+    cd = (_surface.cda * _surface.alphaStall +
+          _surface.cdaStall * (alpha - _surface.alphaStall))
          * cosSweepAngle;
   }
-  else if (alpha < -this->alphaStall)
+  else if (alpha < -_surface.alphaStall)
   {
-    cd = (-this->cda * this->alphaStall +
-          this->cdaStall * (alpha + this->alphaStall))
+    cd = (-_surface.cda * _surface.alphaStall +
+          _surface.cdaStall * (alpha + _surface.alphaStall))
          * cosSweepAngle;
   }
   else
-    cd = (this->cda * alpha) * cosSweepAngle;
+    cd = (_surface.cda * alpha) * cosSweepAngle;
 
   // make sure drag is positive
   cd = std::fabs(cd);
 
   // drag at cp
-  ignition::math::Vector3d drag = cd * q * this->area * dragDirection;
+  ignition::math::Vector3d drag = cd * q * _surface.area * dragDirection;
 
   // compute cm at cp, check for stall, correct for sweep
   double cm;
-  if (alpha > this->alphaStall)
+  if (alpha > _surface.alphaStall)
   {
-    cm = (this->cma * this->alphaStall +
-          this->cmaStall * (alpha - this->alphaStall))
+    cm = (_surface.cma * _surface.alphaStall +
+          _surface.cmaStall * (alpha - _surface.alphaStall))
          * cosSweepAngle;
     // make sure cm is still great than 0
     cm = std::max(0.0, cm);
   }
-  else if (alpha < -this->alphaStall)
+  else if (alpha < -_surface.alphaStall)
   {
-    cm = (-this->cma * this->alphaStall +
-          this->cmaStall * (alpha + this->alphaStall))
+    cm = (-_surface.cma * _surface.alphaStall +
+          _surface.cmaStall * (alpha + _surface.alphaStall))
          * cosSweepAngle;
     // make sure cm is still less than 0
     cm = std::min(0.0, cm);
   }
   else
-    cm = this->cma * alpha * cosSweepAngle;
+    cm = _surface.cma * alpha * cosSweepAngle;
 
   /// \todo(anyone): implement cm
   /// for now, reset cm to zero, as cm needs testing
@@ -406,7 +539,7 @@ void LiftDragPrivate::Update(EntityComponentManager &_ecm)
 
   // compute moment (torque) at cp
   // spanwiseI used to be momentDirection
-  ignition::math::Vector3d moment = cm * q * this->area * spanwiseI;
+  ignition::math::Vector3d moment = cm * q * _surface.area * spanwiseI;
 
 
   // force and torque about cg in world frame
@@ -414,7 +547,7 @@ void LiftDragPrivate::Update(EntityComponentManager &_ecm)
   ignition::math::Vector3d torque = moment;
   // Correct for nan or inf
   force.Correct();
-  this->cp.Correct();
+  _surface.cp.Correct();
   torque.Correct();
 
   // We want to apply the force at cp. The old LiftDrag plugin did the
@@ -432,13 +565,13 @@ void LiftDragPrivate::Update(EntityComponentManager &_ecm)
   // \todo(addisu) Create a convenient API for applying forces at offset
   // positions
   const auto totalTorque = torque + cpWorld.Cross(force);
-  Link link(this->linkEntity);
-  link.AddWorldWrench(_ecm, force, totalTorque);
+  _force = force;
+  _torque = totalTorque;
 
   // Debug
-  // auto linkName = _ecm.Component<components::Name>(this->linkEntity)->Data();
+  // const auto &linkName = _surface.linkName;
   // igndbg << "=============================\n";
-  // igndbg << "Link: [" << linkName << "] pose: [" << pose
+  // igndbg << "Link: [" << linkName << "] pose: [" << _pose
   //        << "] dynamic pressure: [" << q << "]\n";
   // igndbg << "spd: [" << vel.Length() << "] vel: [" << vel << "]\n";
   // igndbg << "LD plane spd: [" << velInLDPlane.Length() << "] vel : ["
@@ -453,11 +586,13 @@ void LiftDragPrivate::Update(EntityComponentManager &_ecm)
   // igndbg << "alpha: " << alpha << "\n";
   // igndbg << "lift: " << lift << "\n";
   // igndbg << "drag: " << drag << " cd: " << cd << " cda: "
-  //        << this->cda << "\n";
+  //        << _surface.cda << "\n";
   // igndbg << "moment: " << moment << "\n";
   // igndbg << "force: " << force << "\n";
   // igndbg << "torque: " << torque << "\n";
   // igndbg << "totalTorque: " << totalTorque << "\n";
+
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -475,6 +610,14 @@ void LiftDrag::Configure(const Entity &_entity,
   this->dataPtr->sdfConfig = _sdf->Clone();
 }
 
+//////////////////////////////////////////////////
+bool LiftDrag::ConfigureParallel() const
+{
+  // Configure only reads the model and keeps a copy of the SDF, everything
+  // else is set up on the first PreUpdate.
+  return true;
+}
+
 //////////////////////////////////////////////////
 void LiftDrag::PreUpdate(const UpdateInfo &_info, EntityComponentManager &_ecm)
 {
@@ -496,32 +639,31 @@ void LiftDrag::PreUpdate(const UpdateInfo &_info, EntityComponentManager &_ecm)
     this->dataPtr->initialized = true;
 
 
-    if (this->dataPtr->validConfig)
+    for (const auto &surface : this->dataPtr->surfaces)
     {
-      if (!_ecm.Component<components::WorldPose>(this->dataPtr->linkEntity))
+      if (!_ecm.Component<components::WorldPose>(surface.linkEntity))
       {
-        _ecm.CreateComponent(this->dataPtr->linkEntity,
-                             components::WorldPose());
+        _ecm.CreateComponent(surface.linkEntity, components::WorldPose());
       }
 
       if (!_ecm.Component<components::WorldLinearVelocity>(
-              this->dataPtr->linkEntity))
+              surface.linkEntity))
       {
-        _ecm.CreateComponent(this->dataPtr->linkEntity,
+        _ecm.CreateComponent(surface.linkEntity,
                              components::WorldLinearVelocity());
       }
       if (!_ecm.Component<components::WorldAngularVelocity>(
-              this->dataPtr->linkEntity))
+              surface.linkEntity))
       {
-        _ecm.CreateComponent(this->dataPtr->linkEntity,
+        _ecm.CreateComponent(surface.linkEntity,
                              components::WorldAngularVelocity());
       }
 
-      if ((this->dataPtr->controlJointEntity != kNullEntity) &&
+      if ((surface.controlJointEntity != kNullEntity) &&
           !_ecm.Component<components::JointPosition>(
-              this->dataPtr->controlJointEntity))
+              surface.controlJointEntity))
       {
-        _ecm.CreateComponent(this->dataPtr->controlJointEntity,
+        _ecm.CreateComponent(surface.controlJointEntity,
             components::JointPosition());
       }
     }
@@ -541,6 +683,7 @@ void LiftDrag::PreUpdate(const UpdateInfo &_info, EntityComponentManager &_ecm)
 IGNITION_ADD_PLUGIN(LiftDrag,
                     ignition::gazebo::System,
                     LiftDrag::ISystemConfigure,
+                    LiftDrag::ISystemConfigureParallel,
                     LiftDrag::ISystemPreUpdate)
 
 IGNITION_ADD_PLUGIN_ALIAS(LiftDrag, "ignition::gazebo::systems::LiftDrag")
@@ -59,9 +59,18 @@ namespace systems
   ///               coefficient curve.
   /// cda_stall   : The ratio of coefficient of drag and alpha slope after
   ///               stall.
+  /// surface     : Optional, may be repeated. Each <surface> describes one
+  ///               lifting surface with any of the parameters above. Values
+  ///               not set in a <surface> are taken from the top level. If
+  ///               there are no <surface> elements, the top level parameters
+  ///               describe a single surface. One system handling many
+  ///               surfaces of a model looks up the state of each link only
+  ///               once per step, which is much cheaper than one system per
+  ///               surface.
   class IGNITION_GAZEBO_VISIBLE LiftDrag
       : public System,
         public ISystemConfigure,
+        public ISystemConfigureParallel,
         public ISystemPreUpdate
   {
     /// \brief Constructor
@@ -76,6 +85,9 @@ namespace systems
                            EntityComponentManager &_ecm,
                            EventManager &_eventMgr) override;
 
+    // Documentation inherited
+    public: bool ConfigureParallel() const override;
+
     /// Documentation inherited
     public: void PreUpdate(const UpdateInfo &_info,
                            EntityComponentManager &_ecm) final;
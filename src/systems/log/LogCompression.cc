@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "LogCompression.hh"
+
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace ignition
+{
+namespace gazebo
+{
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+namespace
+{
+/// \brief Size of the uncompressed size stored before the zlib stream.
+constexpr std::size_t kSizeBytes{4};
+
+/// \brief Fastest zlib level, recording happens while simulating.
+constexpr int kCompressionLevel{1};
+}
+
+//////////////////////////////////////////////////
+bool CompressLogMessage(const std::string &_data, const std::string &_type,
+    std::string &_compressed, std::string &_compressedType)
+{
+  if (_data.size() > UINT32_MAX)
+    return false;
+
+  uLongf length = compressBound(static_cast<uLong>(_data.size()));
+  _compressed.resize(kSizeBytes + length);
+
+  // Little endian, so logs can be read on any host
+  const auto size = static_cast<uint32_t>(_data.size());
+  for (std::size_t i = 0; i < kSizeBytes; ++i)
+    _compressed[i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+
+  if (compress2(reinterpret_cast<Bytef *>(&_compressed[kSizeBytes]), &length,
+      reinterpret_cast<const Bytef *>(_data.data()),
+      static_cast<uLong>(_data.size()), kCompressionLevel) != Z_OK)
+  {
+    return false;
+  }
+  _compressed.resize(kSizeBytes + length);
+  _compressedType = _type + kCompressedLogTypeSuffix;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool IsCompressedLogMessage(const std::string &_type)
+{
+  const std::size_t suffixSize = std::strlen(kCompressedLogTypeSuffix);
+  return _type.size() > suffixSize &&
+      _type.compare(_type.size() - suffixSize, suffixSize,
+      kCompressedLogTypeSuffix) == 0;
+}
+
+//////////////////////////////////////////////////
+bool DecompressLogMessage(const std::string &_compressed,
+    const std::string &_compressedType, std::string &_data,
+    std::string &_type)
+{
+  if (!IsCompressedLogMessage(_compressedType) ||
+      _compressed.size() < kSizeBytes)
+  {
+    return false;
+  }
+
+  uint32_t size{0};
+  for (std::size_t i = 0; i < kSizeBytes; ++i)
+  {
+    size |= static_cast<uint32_t>(
+        static_cast<unsigned char>(_compressed[i])) << (8 * i);
+  }
+
+  _data.resize(size);
+  uLongf length = size;
+  if (uncompress(reinterpret_cast<Bytef *>(&_data[0]), &length,
+      reinterpret_cast<const Bytef *>(_compressed.data() + kSizeBytes),
+      static_cast<uLong>(_compressed.size() - kSizeBytes)) != Z_OK ||
+      length != size)
+  {
+    return false;
+  }
+
+  _type = _compressedType.substr(0,
+      _compressedType.size() - std::strlen(kCompressedLogTypeSuffix));
+  return true;
+}
+}
+}
+}
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_LOG_LOGCOMPRESSION_HH_
+#define IGNITION_GAZEBO_SYSTEMS_LOG_LOGCOMPRESSION_HH_
+
+#include <string>
+
+#include <ignition/gazebo/config.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief Suffix appended to the type name of messages which are recorded
+  /// compressed, such as "ignition.msgs.SerializedStateMap+zlib".
+  const char kCompressedLogTypeSuffix[] = "+zlib";
+
+  /// \brief Compress a serialized message to be recorded. The result holds
+  /// the uncompressed size followed by the zlib stream.
+  /// \param[in] _data Serialized message.
+  /// \param[in] _type Type name of the message.
+  /// \param[out] _compressed Compressed message.
+  /// \param[out] _compressedType Type name to record the message with.
+  /// \return False if compression failed.
+  bool CompressLogMessage(const std::string &_data, const std::string &_type,
+      std::string &_compressed, std::string &_compressedType);
+
+  /// \brief Whether a recorded message is compressed.
+  /// \param[in] _type Type name the message was recorded with.
+  /// \return True if compressed by CompressLogMessage.
+  bool IsCompressedLogMessage(const std::string &_type);
+
+  /// \brief Decompress a message compressed by CompressLogMessage.
+  /// \param[in] _compressed Compressed message.
+  /// \param[in] _compressedType Type name the message was recorded with.
+  /// \param[out] _data Serialized message.
+  /// \param[out] _type Type name of the message.
+  /// \return False if the message isn't compressed or is corrupted.
+  bool DecompressLogMessage(const std::string &_compressed,
+      const std::string &_compressedType, std::string &_data,
+      std::string &_type);
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "LogCompression.hh"
+
+using namespace ignition::gazebo::systems;
+
+/////////////////////////////////////////////////
+TEST(LogCompression, RoundTrip)
+{
+  std::string data;
+  for (int i = 0; i < 1000; ++i)
+    data += "entity " + std::to_string(i % 10) + '\0';
+
+  std::string compressed;
+  std::string compressedType;
+  ASSERT_TRUE(CompressLogMessage(data, "ignition.msgs.SerializedStateMap",
+      compressed, compressedType));
+  EXPECT_EQ("ignition.msgs.SerializedStateMap+zlib", compressedType);
+  EXPECT_LT(compressed.size(), data.size());
+  EXPECT_TRUE(IsCompressedLogMessage(compressedType));
+  EXPECT_FALSE(IsCompressedLogMessage("ignition.msgs.SerializedStateMap"));
+
+  std::string decompressed;
+  std::string type;
+  ASSERT_TRUE(DecompressLogMessage(compressed, compressedType, decompressed,
+      type));
+  EXPECT_EQ(data, decompressed);
+  EXPECT_EQ("ignition.msgs.SerializedStateMap", type);
+
+  // Empty messages
+  ASSERT_TRUE(CompressLogMessage("", "ignition.msgs.Pose_V", compressed,
+      compressedType));
+  ASSERT_TRUE(DecompressLogMessage(compressed, compressedType, decompressed,
+      type));
+  EXPECT_TRUE(decompressed.empty());
+  EXPECT_EQ("ignition.msgs.Pose_V", type);
+
+  // Not compressed or corrupted
+  EXPECT_FALSE(DecompressLogMessage(data, "ignition.msgs.Pose_V",
+      decompressed, type));
+  EXPECT_FALSE(DecompressLogMessage("abc", compressedType, decompressed,
+      type));
+  compressed.resize(compressed.size() / 2);
+  EXPECT_FALSE(DecompressLogMessage(compressed, compressedType, decompressed,
+      type));
+}
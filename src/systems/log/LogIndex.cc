@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "LogIndex.hh"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <ignition/common/Console.hh>
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+namespace
+{
+/// \brief Identifies index files, and their version.
+constexpr char kMagic[8] = {'I', 'G', 'N', 'L', 'I', 'D', 'X', '1'};
+
+/// \brief Size of a file.
+/// \param[in] _path Path of the file.
+/// \return Size in bytes, or -1 if it doesn't exist.
+int64_t fileSize(const std::string &_path)
+{
+  std::ifstream file(_path, std::ios::binary | std::ios::ate);
+  if (!file)
+    return -1;
+  return static_cast<int64_t>(file.tellg());
+}
+}
+
+//////////////////////////////////////////////////
+/// \brief Written in host byte order, indexes are read on the host which
+/// recorded the log.
+struct LogIndex::Header
+{
+  /// \brief kMagic.
+  char magic[8];
+
+  /// \brief Size of the log file the index was written for.
+  int64_t logSize;
+
+  /// \brief Sim time of the first recorded message.
+  int64_t start;
+
+  /// \brief Sim time of the last recorded message.
+  int64_t end;
+
+  /// \brief Number of keyframe times following the header.
+  uint64_t keyframeCount;
+
+  /// \brief Number of lifetimes following the keyframe times.
+  uint64_t lifetimeCount;
+};
+
+//////////////////////////////////////////////////
+std::string LogIndex::PathFor(const std::string &_logFile)
+{
+  return _logFile + ".idx";
+}
+
+//////////////////////////////////////////////////
+bool LogIndex::Write(const std::string &_logFile,
+    const std::chrono::nanoseconds &_start,
+    const std::chrono::nanoseconds &_end,
+    const std::vector<std::chrono::nanoseconds> &_keyframes,
+    const std::vector<Lifetime> &_lifetimes)
+{
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.logSize = fileSize(_logFile);
+  header.start = _start.count();
+  header.end = _end.count();
+  header.keyframeCount = _keyframes.size();
+  header.lifetimeCount = _lifetimes.size();
+  if (header.logSize < 0)
+    return false;
+
+  const auto path = PathFor(_logFile);
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (const auto &keyframe : _keyframes)
+  {
+    const int64_t time = keyframe.count();
+    file.write(reinterpret_cast<const char *>(&time), sizeof(time));
+  }
+  file.write(reinterpret_cast<const char *>(_lifetimes.data()),
+      static_cast<std::streamsize>(_lifetimes.size() * sizeof(Lifetime)));
+
+  if (!file)
+  {
+    ignerr << "Failed to write log index [" << path << "]" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+LogIndex::~LogIndex()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool LogIndex::Open(const std::string &_logFile)
+{
+  this->Close();
+  const auto path = PathFor(_logFile);
+
+#ifdef _WIN32
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    return false;
+  this->buffer.assign(std::istreambuf_iterator<char>(file),
+      std::istreambuf_iterator<char>());
+  this->data = this->buffer.data();
+  this->size = this->buffer.size();
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat info;
+  void *addr{MAP_FAILED};
+  if (fstat(fd, &info) == 0 &&
+      static_cast<std::size_t>(info.st_size) >= sizeof(Header))
+  {
+    addr = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+
+  if (MAP_FAILED == addr)
+    return false;
+  this->data = static_cast<const char *>(addr);
+  this->size = info.st_size;
+#endif
+
+  // Check the header, the sizes, and that the log didn't change since
+  auto header = reinterpret_cast<const Header *>(this->data);
+  if (this->size < sizeof(Header) ||
+      std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+      this->size != sizeof(Header) + header->keyframeCount * sizeof(int64_t) +
+      header->lifetimeCount * sizeof(Lifetime))
+  {
+    ignwarn << "Ignoring invalid log index [" << path << "]" << std::endl;
+    this->Close();
+    return false;
+  }
+  if (header->logSize != fileSize(_logFile))
+  {
+    ignwarn << "Ignoring outdated log index [" << path << "]" << std::endl;
+    this->Close();
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void LogIndex::Close()
+{
+#ifndef _WIN32
+  if (nullptr != this->data)
+    munmap(const_cast<char *>(this->data), this->size);
+#endif
+  this->data = nullptr;
+  this->size = 0;
+  this->buffer.clear();
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds LogIndex::StartTime() const
+{
+  return std::chrono::nanoseconds(
+      reinterpret_cast<const Header *>(this->data)->start);
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds LogIndex::EndTime() const
+{
+  return std::chrono::nanoseconds(
+      reinterpret_cast<const Header *>(this->data)->end);
+}
+
+//////////////////////////////////////////////////
+std::size_t LogIndex::KeyframeCount() const
+{
+  return reinterpret_cast<const Header *>(this->data)->keyframeCount;
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds LogIndex::Keyframe(std::size_t _index) const
+{
+  int64_t time;
+  std::memcpy(&time, this->data + sizeof(Header) + _index * sizeof(time),
+      sizeof(time));
+  return std::chrono::nanoseconds(time);
+}
+
+//////////////////////////////////////////////////
+std::size_t LogIndex::LifetimeCount() const
+{
+  return reinterpret_cast<const Header *>(this->data)->lifetimeCount;
+}
+
+//////////////////////////////////////////////////
+const LogIndex::Lifetime *LogIndex::Lifetimes() const
+{
+  return reinterpret_cast<const Lifetime *>(this->data + sizeof(Header) +
+      this->KeyframeCount() * sizeof(int64_t));
+}
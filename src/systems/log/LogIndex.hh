@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_LOG_LOGINDEX_HH_
+#define IGNITION_GAZEBO_SYSTEMS_LOG_LOGINDEX_HH_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief Sidecar file written next to a recorded log, holding what
+  /// playback needs before playing the first step: the time range, the
+  /// keyframe times and the lifetime of every entity.
+  ///
+  /// The file is memory-mapped when opened, so opening it doesn't depend on
+  /// the size of the log. It's only valid for the log file it was written
+  /// for, which is checked through the log's size.
+  class LogIndex
+  {
+    /// \brief Lifetime of an entity in sim nanoseconds.
+    public: struct Lifetime
+    {
+      /// \brief Entity.
+      uint64_t entity;
+
+      /// \brief Sim time the entity was first recorded at.
+      int64_t created;
+
+      /// \brief Sim time the entity was removed at, or the maximum value if
+      /// it was never removed.
+      int64_t removed;
+    };
+
+    /// \brief Name of the index file for a log file.
+    /// \param[in] _logFile Path of the log file.
+    /// \return Path of the index file.
+    public: static std::string PathFor(const std::string &_logFile);
+
+    /// \brief Write an index file.
+    /// \param[in] _logFile Path of the complete log file being indexed.
+    /// \param[in] _start Sim time of the first recorded message.
+    /// \param[in] _end Sim time of the last recorded message.
+    /// \param[in] _keyframes Sim times of the keyframes, in increasing order.
+    /// \param[in] _lifetimes Lifetimes of the entities.
+    /// \return True if written.
+    public: static bool Write(const std::string &_logFile,
+        const std::chrono::nanoseconds &_start,
+        const std::chrono::nanoseconds &_end,
+        const std::vector<std::chrono::nanoseconds> &_keyframes,
+        const std::vector<Lifetime> &_lifetimes);
+
+    /// \brief Destructor. Unmaps the file.
+    public: ~LogIndex();
+
+    /// \brief Map the index file of a log.
+    /// \param[in] _logFile Path of the log file.
+    /// \return False if there's no index, or it's invalid or outdated.
+    public: bool Open(const std::string &_logFile);
+
+    /// \brief Sim time of the first recorded message.
+    /// \return Start time.
+    public: std::chrono::nanoseconds StartTime() const;
+
+    /// \brief Sim time of the last recorded message.
+    /// \return End time.
+    public: std::chrono::nanoseconds EndTime() const;
+
+    /// \brief Number of keyframes.
+    /// \return Keyframe count.
+    public: std::size_t KeyframeCount() const;
+
+    /// \brief Sim time of a keyframe.
+    /// \param[in] _index Index of the keyframe, less than KeyframeCount.
+    /// \return Keyframe time.
+    public: std::chrono::nanoseconds Keyframe(std::size_t _index) const;
+
+    /// \brief Number of entities.
+    /// \return Entity count.
+    public: std::size_t LifetimeCount() const;
+
+    /// \brief Lifetimes of the entities, in the mapped file.
+    /// \return Pointer to LifetimeCount lifetimes.
+    public: const Lifetime *Lifetimes() const;
+
+    /// \brief Layout of the start of the file.
+    private: struct Header;
+
+    /// \brief Unmap the file, if mapped.
+    private: void Close();
+
+    /// \brief Start of the mapped file.
+    private: const char *data{nullptr};
+
+    /// \brief Size of the mapped file.
+    private: std::size_t size{0};
+
+    /// \brief Copy of the file, where it can't be mapped.
+    private: std::vector<char> buffer;
+  };
+}
+}
+}
+}
+
+#endif
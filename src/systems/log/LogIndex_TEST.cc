@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "LogIndex.hh"
+
+using namespace ignition::gazebo::systems;
+using namespace std::chrono_literals;
+
+/////////////////////////////////////////////////
+TEST(LogIndex, WriteOpen)
+{
+  const std::string logFile{"LogIndex_TEST.tlog"};
+  std::remove(LogIndex::PathFor(logFile).c_str());
+  {
+    std::ofstream log(logFile, std::ios::trunc);
+    log << "recorded messages";
+  }
+
+  LogIndex index;
+  EXPECT_FALSE(index.Open(logFile));
+
+  const int64_t never = std::numeric_limits<int64_t>::max();
+  std::vector<LogIndex::Lifetime> lifetimes{{1, 0, never}, {5, 100, 200}};
+  ASSERT_TRUE(LogIndex::Write(logFile, 1ms, 3s, {500ms, 1s}, lifetimes));
+
+  ASSERT_TRUE(index.Open(logFile));
+  EXPECT_EQ(1ms, index.StartTime());
+  EXPECT_EQ(3s, index.EndTime());
+  ASSERT_EQ(2u, index.KeyframeCount());
+  EXPECT_EQ(500ms, index.Keyframe(0));
+  EXPECT_EQ(1s, index.Keyframe(1));
+  ASSERT_EQ(2u, index.LifetimeCount());
+  EXPECT_EQ(1u, index.Lifetimes()[0].entity);
+  EXPECT_EQ(never, index.Lifetimes()[0].removed);
+  EXPECT_EQ(5u, index.Lifetimes()[1].entity);
+  EXPECT_EQ(100, index.Lifetimes()[1].created);
+  EXPECT_EQ(200, index.Lifetimes()[1].removed);
+
+  // Outdated once the log changes
+  {
+    std::ofstream log(logFile, std::ios::app);
+    log << " and more";
+  }
+  EXPECT_FALSE(index.Open(logFile));
+
+  // Invalid
+  {
+    std::ofstream idx(LogIndex::PathFor(logFile), std::ios::trunc);
+    idx << "not an index, but long enough to hold a header of 48 bytes";
+  }
+  EXPECT_FALSE(index.Open(logFile));
+
+  std::remove(LogIndex::PathFor(logFile).c_str());
+  std::remove(logFile.c_str());
+}
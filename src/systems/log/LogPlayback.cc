@@ -17,12 +17,25 @@
 
 #include "LogPlayback.hh"
 
+#include <ignition/msgs/double_v.pb.h>
+#include <ignition/msgs/empty.pb.h>
+#include <ignition/msgs/int32.pb.h>
 #include <ignition/msgs/pose_v.pb.h>
 #include <ignition/msgs/log_playback_stats.pb.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <ignition/common/Filesystem.hh>
 #include <ignition/common/Profiler.hh>
@@ -33,6 +46,7 @@
 #include <ignition/transport/log/QueryOptions.hh>
 #include <ignition/transport/log/Log.hh>
 #include <ignition/transport/log/Message.hh>
+#include <ignition/transport/Node.hh>
 
 #include <sdf/Geometry.hh>
 #include <sdf/Mesh.hh>
@@ -44,9 +58,14 @@
 #include "ignition/gazebo/components/Geometry.hh"
 #include "ignition/gazebo/components/LogPlaybackStatistics.hh"
 #include "ignition/gazebo/components/Material.hh"
+#include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/World.hh"
 
+#include "LogCompression.hh"
+#include "LogIndex.hh"
+#include "ResourceStore.hh"
+
 using namespace ignition;
 using namespace gazebo;
 using namespace systems;
@@ -54,17 +73,146 @@ using namespace systems;
 /// \brief Private LogPlayback data class.
 class ignition::gazebo::systems::LogPlaybackPrivate
 {
+  /// \brief Changed state decoded from the log.
+  public: struct ChangedState
+  {
+    /// \brief True if recorded as a SerializedState, by older versions.
+    bool legacy{false};
+
+    /// \brief State, if legacy.
+    msgs::SerializedState state;
+
+    /// \brief Merged consecutive states, if not legacy.
+    msgs::SerializedStateMap stateMap;
+  };
+
+  /// \brief Messages of a time range decoded from the log, ready to be
+  /// applied to the ECM.
+  public: struct DecodedStep
+  {
+    /// \brief Start of the time range, exclusive.
+    std::chrono::steady_clock::duration start{0};
+
+    /// \brief End of the time range, inclusive.
+    std::chrono::steady_clock::duration end{0};
+
+    /// \brief Last pose of each sequence of poses, in order.
+    std::vector<msgs::Pose_V> poses;
+
+    /// \brief Changed states, in order.
+    std::vector<ChangedState> states;
+  };
+
+  /// \brief Query and parse the messages of a time range. Thread safe.
+  /// \param[in] _start Start of the time range.
+  /// \param[in] _end End of the time range.
+  /// \param[in] _keyframe Time of the keyframe to play, if any. Other
+  /// keyframes are skipped.
+  /// \return The decoded messages.
+  public: DecodedStep Decode(const std::chrono::steady_clock::duration &_start,
+      const std::chrono::steady_clock::duration &_end,
+      const std::optional<std::chrono::steady_clock::duration> &_keyframe);
+
+  /// \brief Query and parse only the keyframe recorded at a given time.
+  /// Thread safe.
+  /// \param[in] _keyframe Time of the keyframe.
+  /// \return The decoded keyframe.
+  public: DecodedStep DecodeKeyframe(
+      const std::chrono::steady_clock::duration &_keyframe);
+
+  /// \brief Parse recorded messages into a decoded step.
+  /// \param[in] _batch Recorded messages, in order.
+  /// \param[in] _keyframe Time of the keyframe to play, if any. Other
+  /// keyframes are skipped.
+  /// \param[in,out] _step Step to append the messages to.
+  public: void DecodeBatch(const transport::log::Batch &_batch,
+      const std::optional<std::chrono::steady_clock::duration> &_keyframe,
+      DecodedStep &_step);
+
+  /// \brief Decode the messages of a seek, from a keyframe to the sought
+  /// time, reusing the keyframe if it was prefetched while scrubbing.
+  /// \param[in] _keyframe Time of the keyframe to start from.
+  /// \param[in] _end Sought time.
+  /// \return The decoded messages.
+  public: DecodedStep DecodeSeek(
+      const std::chrono::steady_clock::duration &_keyframe,
+      const std::chrono::steady_clock::duration &_end);
+
+  /// \brief Get the next keyframe to prefetch while scrubbing. Must be
+  /// called with prefetchMutex locked.
+  /// \return Time of the keyframe, or nullopt if there's none to prefetch.
+  public: std::optional<std::chrono::steady_clock::duration>
+      NextScrubKeyframe() const;
+
+  /// \brief Callback for the scrub direction hint of the GUI.
+  /// \param[in] _msg Positive while scrubbing forward, negative while
+  /// scrubbing backward, zero once scrubbing is over.
+  public: void OnScrub(const msgs::Int32 &_msg);
+
+  /// \brief Service listing the times of the keyframes of the current log.
+  /// \param[out] _res Times in seconds, in increasing order.
+  /// \return True.
+  public: bool OnKeyframes(msgs::Double_V &_res);
+
+  /// \brief Take the prefetched messages of a time range. If they aren't
+  /// the next ones to be prefetched, prefetching restarts after the range.
+  /// \param[in] _start Start of the time range.
+  /// \param[in] _end End of the time range.
+  /// \return The decoded messages, or nullopt if they must be decoded by
+  /// the caller.
+  public: std::optional<DecodedStep> TakePrefetched(
+      const std::chrono::steady_clock::duration &_start,
+      const std::chrono::steady_clock::duration &_end);
+
+  /// \brief Discard prefetched messages and prefetch from a new time.
+  /// \param[in] _start Time to prefetch from.
+  /// \param[in] _step Duration of each step, or zero to keep the current
+  /// one.
+  public: void RestartPrefetch(
+      const std::chrono::steady_clock::duration &_start,
+      const std::chrono::steady_clock::duration &_step);
+
+  /// \brief Decode upcoming steps into the prefetch queue until stopped.
+  public: void PrefetchLoop();
+
+  /// \brief Get the type and serialized data of a recorded message,
+  /// decompressing it if it was recorded compressed.
+  /// \param[in] _msg Recorded message.
+  /// \param[out] _type Type name of the message.
+  /// \param[out] _buffer Holds the data if decompressed.
+  /// \return The serialized data, or nullptr if it couldn't be
+  /// decompressed.
+  public: static const std::string *Unpack(
+      const transport::log::Message &_msg, std::string &_type,
+      std::string &_buffer);
+
   /// \brief Extract model resource files and state file from compression.
   /// \return True if extraction was successful.
   public: bool ExtractStateAndResources();
 
   /// \brief Start log playback.
-  /// \param[in] _logPath Path of recorded state to playback.
   /// \param[in] _ecm The EntityComponentManager of the given simulation
   /// instance.
   /// \return True if any playback has been started successfully.
   public: bool Start(EntityComponentManager &_ecm);
 
+  /// \brief Open the log at logPath and apply its initial state.
+  /// \param[in] _ecm Mutable ECM.
+  /// \return True if the log was opened.
+  public: bool Load(EntityComponentManager &_ecm);
+
+  /// \brief Load the next queued log which can be opened.
+  /// \param[in] _ecm Mutable ECM.
+  /// \return False if no queued log could be opened.
+  public: bool LoadNextLog(EntityComponentManager &_ecm);
+
+  /// \brief Close the current log and forget everything about it, so
+  /// another one can be loaded.
+  public: void CloseLog();
+
+  /// \brief Stop and join the prefetch thread, if running.
+  public: void StopPrefetch();
+
   /// \brief Replace URIs of resources in components with recorded path.
   public: void ReplaceResourceURIs(EntityComponentManager &_ecm);
 
@@ -73,6 +221,11 @@ class ignition::gazebo::systems::LogPlaybackPrivate
   /// \return String of prepended path.
   public: std::string PrependLogPath(const std::string &_uri);
 
+  /// \brief Link the resources listed in the log's manifest from the
+  /// resource store into the log directory, where PrependLogPath expects
+  /// them. Does nothing for logs without a manifest.
+  public: void LinkStoredResources();
+
   /// \brief Keeps track of which entity poses have updated
   /// according to the given message.
   /// \param[in] _msg Message containing pose updates.
@@ -93,14 +246,42 @@ class ignition::gazebo::systems::LogPlaybackPrivate
   public: void Parse(EntityComponentManager &_ecm,
       const msgs::SerializedStateMap &_msg);
 
+  /// \brief Merge a changed state into the changes accumulated so far, so
+  /// each entity and component is only set once on the ECM.
+  /// \param[in] _msg Changed state which comes after the merged one.
+  /// \param[in, out] _merged Accumulated changes.
+  public: static void Merge(const msgs::SerializedStateMap &_msg,
+      msgs::SerializedStateMap &_merged);
+
   /// \brief A batch of data from log file, of all pose messages
   public: transport::log::Batch batch;
 
   /// \brief Pointer to ign-transport Log
   public: std::unique_ptr<transport::log::Log> log;
 
-  /// \brief Indicator of whether any playback instance has ever been started
-  public: static bool started;
+  /// \brief Names of the worlds a playback instance has been started in.
+  /// Each world plays back at most one instance.
+  public: static std::set<std::string> startedWorlds;
+
+  /// \brief Protects startedWorlds.
+  public: static std::mutex startedMutex;
+
+  /// \brief Name of the world played back into.
+  public: std::string worldName;
+
+  /// \brief Paths of the logs to play back, in order.
+  public: std::vector<std::string> logPaths;
+
+  /// \brief Index in logPaths of the next log to load.
+  public: std::size_t nextLog{0};
+
+  /// \brief Sim time the current log started playing at. Logs after the
+  /// first one start at the sim time the previous one ended.
+  public: std::chrono::steady_clock::duration logOffset{0};
+
+  /// \brief True once the entities of a finished log were requested to be
+  /// removed, so the next log is loaded on the following update.
+  public: bool nextLogPending{false};
 
   /// \brief Directory in which to place log file
   public: std::string logPath{""};
@@ -121,12 +302,95 @@ class ignition::gazebo::systems::LogPlaybackPrivate
   /// plugin versions that did not record resources. False for older log files.
   public: bool doReplaceResourceURIs{true};
 
+  /// \brief Resource store to link recorded resources from, overriding the
+  /// one in the log's manifest. Empty to use the manifest's.
+  public: std::string resourceStorePath;
+
   /// \brief Saves which entity poses have changed according to the latest
   /// LogPlaybackPrivate::Parse call.
   public: std::unordered_map<Entity, msgs::Pose> recentEntityPoseUpdates;
+
+  /// \brief Find the keyframe to start from when playing messages between
+  /// two times, if starting from it is cheaper than playing all of them.
+  /// \param[in] _start Time of the last state played.
+  /// \param[in] _end Time of the state to play up to.
+  /// \return Time of the keyframe, or nullopt to play all messages.
+  public: std::optional<std::chrono::steady_clock::duration> SeekKeyframe(
+      const std::chrono::steady_clock::duration &_start,
+      const std::chrono::steady_clock::duration &_end) const;
+
+  /// \brief Topic of the full state keyframes in the log, empty if the log
+  /// has none.
+  public: std::string keyframeTopic;
+
+  /// \brief Times of the keyframes in the log, in increasing order.
+  public: std::vector<std::chrono::steady_clock::duration> keyframeTimes;
+
+  /// \brief End time of the log.
+  public: std::chrono::steady_clock::duration endTime{0};
+
+  /// \brief Index written by LogRecord next to the log, if valid. Lets
+  /// playback start without scanning the log for its time range and
+  /// keyframes.
+  public: LogIndex index;
+
+  /// \brief Protects the log, which is queried by both the update and the
+  /// prefetch threads.
+  public: std::mutex logMutex;
+
+  /// \brief Maximum number of steps decoded ahead, zero to disable
+  /// prefetching.
+  public: std::size_t prefetchSteps{32};
+
+  /// \brief Decodes upcoming steps while the simulation runs.
+  public: std::thread prefetchThread;
+
+  /// \brief Protects the prefetch members below.
+  public: std::mutex prefetchMutex;
+
+  /// \brief Notified when the prefetch queue or cursor changes.
+  public: std::condition_variable prefetchCv;
+
+  /// \brief Steps decoded ahead, in order.
+  public: std::deque<DecodedStep> prefetched;
+
+  /// \brief Start of the next step to be prefetched.
+  public: std::chrono::steady_clock::duration prefetchStart{0};
+
+  /// \brief Duration of the steps to be prefetched, zero until known.
+  public: std::chrono::steady_clock::duration prefetchStep{0};
+
+  /// \brief Incremented on restarts, so steps being decoded from an older
+  /// cursor are discarded.
+  public: unsigned int prefetchGeneration{0};
+
+  /// \brief True while the prefetch thread is decoding a step.
+  public: bool prefetchBusy{false};
+
+  /// \brief Set to stop the prefetch thread.
+  public: bool prefetchStop{false};
+
+  /// \brief Number of keyframes prefetched ahead of the scrubbed time, in
+  /// the scrub direction. Zero disables keyframe prefetching.
+  public: std::size_t prefetchKeyframes{4};
+
+  /// \brief Scrub direction hinted by the GUI, zero when not scrubbing.
+  /// Protected by prefetchMutex.
+  public: int scrubDirection{0};
+
+  /// \brief Last time sought to. Protected by prefetchMutex.
+  public: std::chrono::steady_clock::duration scrubTime{0};
+
+  /// \brief Decoded keyframes, by time. Protected by prefetchMutex.
+  public: std::map<std::chrono::steady_clock::duration,
+      std::shared_ptr<const DecodedStep>> keyframeCache;
+
+  /// \brief Transport node for the scrub hint and keyframe service.
+  public: transport::Node node;
 };
 
-bool LogPlaybackPrivate::started{false};
+std::set<std::string> LogPlaybackPrivate::startedWorlds;
+std::mutex LogPlaybackPrivate::startedMutex;
 
 //////////////////////////////////////////////////
 LogPlayback::LogPlayback()
@@ -137,12 +401,62 @@ LogPlayback::LogPlayback()
 //////////////////////////////////////////////////
 LogPlayback::~LogPlayback()
 {
-  if (!this->dataPtr->extDest.empty())
+  this->dataPtr->CloseLog();
+  if (this->dataPtr->instStarted)
   {
-    common::removeAll(this->dataPtr->extDest);
+    std::lock_guard<std::mutex> lock(LogPlaybackPrivate::startedMutex);
+    LogPlaybackPrivate::startedWorlds.erase(this->dataPtr->worldName);
+  }
+}
+
+//////////////////////////////////////////////////
+void LogPlaybackPrivate::StopPrefetch()
+{
+  if (!this->prefetchThread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(this->prefetchMutex);
+    this->prefetchStop = true;
+  }
+  this->prefetchCv.notify_all();
+  this->prefetchThread.join();
+
+  std::lock_guard<std::mutex> lock(this->prefetchMutex);
+  this->prefetchStop = false;
+  this->prefetchBusy = false;
+  this->prefetched.clear();
+  this->prefetchStart = std::chrono::steady_clock::duration::zero();
+  this->prefetchStep = std::chrono::steady_clock::duration::zero();
+  this->keyframeCache.clear();
+  this->scrubTime = std::chrono::steady_clock::duration::zero();
+  ++this->prefetchGeneration;
+}
+
+//////////////////////////////////////////////////
+void LogPlaybackPrivate::CloseLog()
+{
+  this->StopPrefetch();
+
+  // The batch refers to the log
+  this->batch = transport::log::Batch();
+  this->log.reset();
+
+  {
+    std::lock_guard<std::mutex> lock(this->logMutex);
+    this->keyframeTopic.clear();
+    this->keyframeTimes.clear();
+  }
+  this->endTime = std::chrono::steady_clock::duration::zero();
+  this->recentEntityPoseUpdates.clear();
+  this->doReplaceResourceURIs = true;
+  this->printedEnd = false;
+
+  if (!this->extDest.empty())
+  {
+    common::removeAll(this->extDest);
+    this->extDest.clear();
   }
-  if (this->dataPtr->instStarted)
-    LogPlaybackPrivate::started = false;
 }
 
 //////////////////////////////////////////////////
@@ -170,6 +484,31 @@ void LogPlaybackPrivate::Parse(EntityComponentManager &_ecm,
   _ecm.SetState(_msg);
 }
 
+//////////////////////////////////////////////////
+void LogPlaybackPrivate::Merge(const msgs::SerializedStateMap &_msg,
+    msgs::SerializedStateMap &_merged)
+{
+  auto &mergedEntities = *_merged.mutable_entities();
+  for (const auto &entIt : _msg.entities())
+  {
+    const auto &entityMsg = entIt.second;
+    auto mergedIt = mergedEntities.find(entIt.first);
+
+    // Removals, and entities created again after being removed, discard
+    // everything that came before
+    if (mergedIt == mergedEntities.end() || entityMsg.remove() ||
+        mergedIt->second.remove())
+    {
+      mergedEntities[entIt.first] = entityMsg;
+      continue;
+    }
+
+    auto &mergedComponents = *mergedIt->second.mutable_components();
+    for (const auto &compIt : entityMsg.components())
+      mergedComponents[compIt.first] = compIt.second;
+  }
+}
+
 //////////////////////////////////////////////////
 void LogPlaybackPrivate::Parse(EntityComponentManager &_ecm,
     const msgs::SerializedState &_msg)
@@ -178,61 +517,483 @@ void LogPlaybackPrivate::Parse(EntityComponentManager &_ecm,
 }
 
 //////////////////////////////////////////////////
-void LogPlayback::Configure(const Entity &,
-    const std::shared_ptr<const sdf::Element> &_sdf,
-    EntityComponentManager &_ecm, EventManager &_eventMgr)
+LogPlaybackPrivate::DecodedStep LogPlaybackPrivate::Decode(
+    const std::chrono::steady_clock::duration &_start,
+    const std::chrono::steady_clock::duration &_end,
+    const std::optional<std::chrono::steady_clock::duration> &_keyframe)
 {
-  // Get directory paths from SDF
-  this->dataPtr->logPath = _sdf->Get<std::string>("playback_path");
+  IGN_PROFILE("LogPlaybackPrivate::Decode");
+  DecodedStep step;
+  step.start = _start;
+  step.end = _end;
 
-  this->dataPtr->eventManager = &_eventMgr;
+  transport::log::Batch stepBatch;
+  {
+    std::lock_guard<std::mutex> lock(this->logMutex);
+    stepBatch = this->log->QueryMessages(
+        transport::log::AllTopics({_start, _end}));
+  }
 
-  // Prepend working directory if path is relative
-  this->dataPtr->logPath = common::absPath(this->dataPtr->logPath);
+  this->DecodeBatch(stepBatch, _keyframe, step);
+  return step;
+}
 
-  // Set the entity offset.
-  // \todo This number should be included in the log file.
-  _ecm.SetEntityCreateOffset(math::MAX_I64 / 2);
+//////////////////////////////////////////////////
+LogPlaybackPrivate::DecodedStep LogPlaybackPrivate::DecodeKeyframe(
+    const std::chrono::steady_clock::duration &_keyframe)
+{
+  IGN_PROFILE("LogPlaybackPrivate::DecodeKeyframe");
+  DecodedStep step;
+  step.start = _keyframe;
+  step.end = _keyframe;
 
-  // If path is a file, assume it is a compressed file
-  // (Otherwise assume it is a directory containing recorded files.)
-  if (common::isFile(this->dataPtr->logPath))
+  transport::log::Batch keyframeBatch;
   {
-    if (!this->dataPtr->ExtractStateAndResources())
+    std::lock_guard<std::mutex> lock(this->logMutex);
+    keyframeBatch = this->log->QueryMessages(transport::log::TopicList(
+        this->keyframeTopic, {_keyframe, _keyframe}));
+  }
+
+  this->DecodeBatch(keyframeBatch, _keyframe, step);
+  return step;
+}
+
+//////////////////////////////////////////////////
+void LogPlaybackPrivate::DecodeBatch(const transport::log::Batch &_batch,
+    const std::optional<std::chrono::steady_clock::duration> &_keyframe,
+    DecodedStep &_step)
+{
+  msgs::Pose_V queuedPose;
+  for (const auto &msg : _batch)
+  {
+    // Keyframes are only played when seeking to them
+    if (msg.Topic() == this->keyframeTopic &&
+        (!_keyframe || msg.TimeReceived() != *_keyframe))
     {
-      ignerr << "Cannot play back files.\n";
-      return;
+      continue;
+    }
+
+    std::string msgType;
+    std::string buffer;
+    const auto *data = this->Unpack(msg, msgType, buffer);
+    if (nullptr == data)
+      continue;
+
+    // Only set the last pose of a sequence of poses.
+    if (msgType != "ignition.msgs.Pose_V" && queuedPose.pose_size() > 0)
+    {
+      _step.poses.push_back(std::move(queuedPose));
+      queuedPose.Clear();
+    }
+
+    if (msgType == "ignition.msgs.Pose_V")
+    {
+      // Queue poses to be set later
+      queuedPose.ParseFromString(*data);
+    }
+    else if (msgType == "ignition.msgs.SerializedState")
+    {
+      ChangedState state;
+      state.legacy = true;
+      state.state.ParseFromString(*data);
+      _step.states.push_back(std::move(state));
+    }
+    else if (msgType == "ignition.msgs.SerializedStateMap")
+    {
+      // Merge consecutive states, so seeking across many of them only
+      // touches each entity and component once
+      if (_step.states.empty() || _step.states.back().legacy)
+      {
+        _step.states.emplace_back();
+        _step.states.back().stateMap.ParseFromString(*data);
+      }
+      else
+      {
+        msgs::SerializedStateMap stateMsg;
+        stateMsg.ParseFromString(*data);
+        this->Merge(stateMsg, _step.states.back().stateMap);
+      }
+    }
+    else if (msgType == "ignition.msgs.StringMsg")
+    {
+      // Do nothing, we assume this is the SDF string
+    }
+    else
+    {
+      ignwarn << "Trying to playback unsupported message type ["
+              << msgType << "]" << std::endl;
+    }
+  }
+
+  if (queuedPose.pose_size() > 0)
+    _step.poses.push_back(std::move(queuedPose));
+}
+
+//////////////////////////////////////////////////
+LogPlaybackPrivate::DecodedStep LogPlaybackPrivate::DecodeSeek(
+    const std::chrono::steady_clock::duration &_keyframe,
+    const std::chrono::steady_clock::duration &_end)
+{
+  std::shared_ptr<const DecodedStep> cached;
+  {
+    std::lock_guard<std::mutex> lock(this->prefetchMutex);
+    this->scrubTime = _end;
+    auto it = this->keyframeCache.find(_keyframe);
+    if (it != this->keyframeCache.end())
+      cached = it->second;
+  }
+  // Keyframes ahead of the new time may be prefetched
+  this->prefetchCv.notify_all();
+
+  if (!cached)
+    return this->Decode(_keyframe, _end, _keyframe);
+
+  // The keyframe is played first, then the changes recorded after it
+  auto step = this->Decode(_keyframe, _end, std::nullopt);
+  step.poses.insert(step.poses.begin(), cached->poses.begin(),
+      cached->poses.end());
+  step.states.insert(step.states.begin(), cached->states.begin(),
+      cached->states.end());
+  return step;
+}
+
+//////////////////////////////////////////////////
+std::optional<LogPlaybackPrivate::DecodedStep>
+    LogPlaybackPrivate::TakePrefetched(
+    const std::chrono::steady_clock::duration &_start,
+    const std::chrono::steady_clock::duration &_end)
+{
+  if (0u == this->prefetchSteps)
+    return std::nullopt;
+
+  std::unique_lock<std::mutex> lock(this->prefetchMutex);
+
+  // Wait for the step if it's the one being decoded
+  const auto generation = this->prefetchGeneration;
+  this->prefetchCv.wait(lock, [&]
+  {
+    return !this->prefetched.empty() || !this->prefetchBusy ||
+        this->prefetchStart != _start ||
+        this->prefetchStep != _end - _start ||
+        this->prefetchGeneration != generation;
+  });
+
+  if (!this->prefetched.empty() && this->prefetched.front().start == _start &&
+      this->prefetched.front().end == _end)
+  {
+    auto step = std::move(this->prefetched.front());
+    this->prefetched.pop_front();
+    lock.unlock();
+    this->prefetchCv.notify_all();
+    return step;
+  }
+
+  // Steps changed size, or playback jumped
+  lock.unlock();
+  this->RestartPrefetch(_end, _end - _start);
+  return std::nullopt;
+}
+
+//////////////////////////////////////////////////
+void LogPlaybackPrivate::RestartPrefetch(
+    const std::chrono::steady_clock::duration &_start,
+    const std::chrono::steady_clock::duration &_step)
+{
+  if (0u == this->prefetchSteps)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(this->prefetchMutex);
+    this->prefetched.clear();
+    this->prefetchStart = _start;
+    if (_step > std::chrono::steady_clock::duration::zero())
+      this->prefetchStep = _step;
+    ++this->prefetchGeneration;
+  }
+  this->prefetchCv.notify_all();
+}
+
+//////////////////////////////////////////////////
+std::optional<std::chrono::steady_clock::duration>
+    LogPlaybackPrivate::NextScrubKeyframe() const
+{
+  if (0 == this->scrubDirection || 0u == this->prefetchKeyframes ||
+      this->keyframeTimes.empty())
+  {
+    return std::nullopt;
+  }
+
+  // The keyframe a seek to the scrubbed time starts from, then the ones
+  // after or before it
+  auto it = std::upper_bound(this->keyframeTimes.begin(),
+      this->keyframeTimes.end(), this->scrubTime);
+  auto index = std::max<int64_t>(0, static_cast<int64_t>(
+      std::distance(this->keyframeTimes.begin(), it)) - 1);
+  for (std::size_t i = 0; i <= this->prefetchKeyframes; ++i)
+  {
+    if (index < 0 ||
+        index >= static_cast<int64_t>(this->keyframeTimes.size()))
+    {
+      break;
     }
+    const auto &time = this->keyframeTimes[index];
+    if (this->keyframeCache.find(time) == this->keyframeCache.end())
+      return time;
+    index += this->scrubDirection > 0 ? 1 : -1;
   }
+  return std::nullopt;
+}
 
-  // Enforce only one playback instance
-  if (!LogPlaybackPrivate::started)
+//////////////////////////////////////////////////
+void LogPlaybackPrivate::OnScrub(const msgs::Int32 &_msg)
+{
   {
-    this->dataPtr->Start(_ecm);
+    std::lock_guard<std::mutex> lock(this->prefetchMutex);
+    this->scrubDirection = _msg.data() > 0 ? 1 : (_msg.data() < 0 ? -1 : 0);
   }
-  else
+  this->prefetchCv.notify_all();
+}
+
+//////////////////////////////////////////////////
+bool LogPlaybackPrivate::OnKeyframes(msgs::Double_V &_res)
+{
+  std::lock_guard<std::mutex> lock(this->logMutex);
+  for (const auto &time : this->keyframeTimes)
+  {
+    _res.add_data(
+        std::chrono::duration_cast<std::chrono::duration<double>>(
+        time).count());
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void LogPlaybackPrivate::PrefetchLoop()
+{
+  std::unique_lock<std::mutex> lock(this->prefetchMutex);
+  while (true)
+  {
+    this->prefetchCv.wait(lock, [this]
+    {
+      return this->prefetchStop || this->NextScrubKeyframe() ||
+          (this->prefetchStep > std::chrono::steady_clock::duration::zero() &&
+           this->prefetched.size() < this->prefetchSteps &&
+           this->prefetchStart < this->endTime);
+    });
+    if (this->prefetchStop)
+      break;
+
+    // While scrubbing, keyframes around the scrubbed time come first, since
+    // each seek starts from one
+    if (auto keyframe = this->NextScrubKeyframe())
+    {
+      lock.unlock();
+      auto step = std::make_shared<const DecodedStep>(
+          this->DecodeKeyframe(*keyframe));
+      lock.lock();
+
+      // Keyframes don't depend on the playback cursor, and the cache is
+      // only cleared once this thread is stopped
+      this->keyframeCache[*keyframe] = step;
+
+      // Drop keyframes left behind by the scrubbing first, then the
+      // farthest ahead, past the ones being prefetched
+      const auto maxCached = 2 * this->prefetchKeyframes + 1;
+      while (this->keyframeCache.size() > maxCached)
+      {
+        auto first = this->keyframeCache.begin();
+        auto last = std::prev(this->keyframeCache.end());
+        if (this->scrubDirection < 0)
+        {
+          this->keyframeCache.erase(last->first > this->scrubTime ?
+              last : first);
+        }
+        else
+        {
+          this->keyframeCache.erase(first->first <= this->scrubTime &&
+              std::next(first)->first <= this->scrubTime ? first : last);
+        }
+      }
+      this->prefetchCv.notify_all();
+      continue;
+    }
+
+    const auto start = this->prefetchStart;
+    const auto end = start + this->prefetchStep;
+    const auto generation = this->prefetchGeneration;
+    this->prefetchBusy = true;
+
+    lock.unlock();
+    auto step = this->Decode(start, end, std::nullopt);
+    lock.lock();
+
+    this->prefetchBusy = false;
+    if (generation == this->prefetchGeneration)
+    {
+      this->prefetched.push_back(std::move(step));
+      this->prefetchStart = end;
+    }
+    this->prefetchCv.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+const std::string *LogPlaybackPrivate::Unpack(
+    const transport::log::Message &_msg, std::string &_type,
+    std::string &_buffer)
+{
+  if (!IsCompressedLogMessage(_msg.Type()))
+  {
+    _type = _msg.Type();
+    return &_msg.Data();
+  }
+
+  if (!DecompressLogMessage(_msg.Data(), _msg.Type(), _buffer, _type))
   {
-    ignwarn << "A LogPlayback instance has already been started. "
-      << "Will not start another.\n";
+    ignerr << "Failed to decompress message of type [" << _msg.Type()
+           << "] on topic [" << _msg.Topic() << "]" << std::endl;
+    return nullptr;
   }
+  return &_buffer;
+}
+
+//////////////////////////////////////////////////
+std::optional<std::chrono::steady_clock::duration>
+    LogPlaybackPrivate::SeekKeyframe(
+    const std::chrono::steady_clock::duration &_start,
+    const std::chrono::steady_clock::duration &_end) const
+{
+  // Last keyframe at or before the end
+  auto it = std::upper_bound(this->keyframeTimes.begin(),
+      this->keyframeTimes.end(), _end);
+  if (it == this->keyframeTimes.begin())
+    return std::nullopt;
+  --it;
+
+  // Seeking backward always needs a keyframe, or the start of the log.
+  // Seeking forward only benefits if a whole keyframe interval is skipped.
+  if (_end < _start ||
+      (*it > _start && it != this->keyframeTimes.begin() &&
+       *std::prev(it) > _start))
+  {
+    return *it;
+  }
+  return std::nullopt;
+}
+
+//////////////////////////////////////////////////
+void LogPlayback::Configure(const Entity &_entity,
+    const std::shared_ptr<const sdf::Element> &_sdf,
+    EntityComponentManager &_ecm, EventManager &_eventMgr)
+{
+  // Get directory paths from SDF. Each path is played after the previous
+  // one is over.
+  auto sdf = std::const_pointer_cast<sdf::Element>(_sdf);
+  for (auto pathElem = sdf->FindElement("playback_path"); pathElem;
+      pathElem = pathElem->GetNextElement("playback_path"))
+  {
+    auto path = pathElem->Get<std::string>();
+    // Prepend working directory if path is relative
+    if (!path.empty())
+      this->dataPtr->logPaths.push_back(common::absPath(path));
+  }
+
+  auto nameComp = _ecm.Component<components::Name>(_entity);
+  if (nullptr != nameComp)
+    this->dataPtr->worldName = nameComp->Data();
+
+  this->dataPtr->eventManager = &_eventMgr;
+
+  if (_sdf->HasElement("prefetch_steps"))
+  {
+    this->dataPtr->prefetchSteps = static_cast<std::size_t>(
+        std::max(0, _sdf->Get<int>("prefetch_steps")));
+  }
+
+  if (_sdf->HasElement("prefetch_keyframes"))
+  {
+    this->dataPtr->prefetchKeyframes = static_cast<std::size_t>(
+        std::max(0, _sdf->Get<int>("prefetch_keyframes")));
+  }
+
+  // Scrubbing hints from the GUI, and the keyframes it marks on its timeline
+  const std::string playbackTopic{"/world/" + this->dataPtr->worldName +
+      "/playback"};
+  this->dataPtr->node.Subscribe(playbackTopic + "/scrub",
+      &LogPlaybackPrivate::OnScrub, this->dataPtr.get());
+  this->dataPtr->node.Advertise(playbackTopic + "/keyframes",
+      &LogPlaybackPrivate::OnKeyframes, this->dataPtr.get());
+
+  if (_sdf->HasElement("resource_store"))
+  {
+    this->dataPtr->resourceStorePath = common::absPath(
+        _sdf->Get<std::string>("resource_store"));
+  }
+
+  // Set the entity offset.
+  // \todo This number should be included in the log file.
+  _ecm.SetEntityCreateOffset(math::MAX_I64 / 2);
+
+  this->dataPtr->Start(_ecm);
 }
 
 //////////////////////////////////////////////////
 bool LogPlaybackPrivate::Start(EntityComponentManager &_ecm)
 {
-  if (LogPlaybackPrivate::started)
+  // Enforce only one playback instance per world
   {
-    ignwarn << "A LogPlayback instance has already been started. "
-      << "Will not start another.\n";
-    return true;
+    std::lock_guard<std::mutex> lock(LogPlaybackPrivate::startedMutex);
+    if (LogPlaybackPrivate::startedWorlds.count(this->worldName) > 0)
+    {
+      ignwarn << "A LogPlayback instance has already been started. "
+        << "Will not start another.\n";
+      return true;
+    }
   }
 
-  if (this->logPath.empty())
+  if (this->logPaths.empty())
   {
     ignerr << "Unspecified log path to playback. Nothing to play.\n";
     return false;
   }
 
+  if (!this->LoadNextLog(_ecm))
+    return false;
+
+  this->instStarted = true;
+  std::lock_guard<std::mutex> lock(LogPlaybackPrivate::startedMutex);
+  LogPlaybackPrivate::startedWorlds.insert(this->worldName);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool LogPlaybackPrivate::LoadNextLog(EntityComponentManager &_ecm)
+{
+  while (this->nextLog < this->logPaths.size())
+  {
+    this->logPath = this->logPaths[this->nextLog++];
+    if (this->logPaths.size() > 1)
+    {
+      ignmsg << "Playing log [" << this->nextLog << "/"
+             << this->logPaths.size() << "]" << std::endl;
+    }
+
+    // If path is a file, assume it is a compressed file
+    // (Otherwise assume it is a directory containing recorded files.)
+    if (common::isFile(this->logPath) && !this->ExtractStateAndResources())
+      ignerr << "Cannot play back files.\n";
+    else if (this->Load(_ecm))
+      return true;
+
+    // Move on to the next log
+    this->CloseLog();
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+bool LogPlaybackPrivate::Load(EntityComponentManager &_ecm)
+{
   // Append file name
   std::string dbPath = common::joinPaths(this->logPath, "state.tlog");
   ignmsg << "Loading log file [" + dbPath + "]\n";
@@ -243,11 +1004,15 @@ bool LogPlaybackPrivate::Start(EntityComponentManager &_ecm)
     return false;
   }
 
+  // Before any state is applied and its URIs are replaced
+  this->LinkStoredResources();
+
   // Call Log.hh directly to load a .tlog file
   this->log = std::make_unique<transport::log::Log>();
   if (!this->log->Open(dbPath))
   {
     ignerr << "Failed to open log file [" << dbPath << "]" << std::endl;
+    return false;
   }
 
   // Access all messages in .tlog file
@@ -263,26 +1028,73 @@ bool LogPlaybackPrivate::Start(EntityComponentManager &_ecm)
   // state of the world. Messages received before this are ignored.
   for (; iter != this->batch.end(); ++iter)
   {
-    auto msgType = iter->Type();
+    std::string msgType;
+    std::string buffer;
+    const auto *data = this->Unpack(*iter, msgType, buffer);
+    if (nullptr == data)
+      continue;
+
     if (msgType == "ignition.msgs.SerializedState")
     {
       msgs::SerializedState msg;
-      msg.ParseFromString(iter->Data());
+      msg.ParseFromString(*data);
       this->Parse(_ecm, msg);
       break;
     }
     else if (msgType == "ignition.msgs.SerializedStateMap")
     {
       msgs::SerializedStateMap msg;
-      msg.ParseFromString(iter->Data());
+      msg.ParseFromString(*data);
       this->Parse(_ecm, msg);
       break;
     }
   }
 
+  // Keyframes recorded by LogRecord
+  const std::string keyframeSuffix{"/state_keyframe"};
+  for (const auto &topic : this->log->AllTopics())
+  {
+    if (topic.size() > keyframeSuffix.size() &&
+        topic.compare(topic.size() - keyframeSuffix.size(),
+        keyframeSuffix.size(), keyframeSuffix) == 0)
+    {
+      this->keyframeTopic = topic;
+      break;
+    }
+  }
+  const bool indexed = this->index.Open(dbPath);
+  std::vector<std::chrono::steady_clock::duration> keyframeTimesFound;
+  if (indexed)
+  {
+    igndbg << "Using log index [" << LogIndex::PathFor(dbPath) << "]"
+           << std::endl;
+    for (std::size_t i = 0; i < this->index.KeyframeCount(); ++i)
+      keyframeTimesFound.push_back(this->index.Keyframe(i));
+  }
+  else if (!this->keyframeTopic.empty())
+  {
+    auto keyframes = this->log->QueryMessages(
+        transport::log::TopicList(this->keyframeTopic));
+    for (const auto &msg : keyframes)
+      keyframeTimesFound.push_back(msg.TimeReceived());
+    std::sort(keyframeTimesFound.begin(), keyframeTimesFound.end());
+  }
+  {
+    // Also listed by the keyframe service
+    std::lock_guard<std::mutex> lock(this->logMutex);
+    this->keyframeTimes = std::move(keyframeTimesFound);
+  }
+  if (!this->keyframeTopic.empty())
+  {
+    igndbg << "Log has [" << this->keyframeTimes.size()
+           << "] keyframes on [" << this->keyframeTopic << "]" << std::endl;
+  }
+  this->endTime = indexed ? this->index.EndTime() : this->log->EndTime();
+
   msgs::LogPlaybackStatistics logStats;
-  auto startTime = convert<msgs::Time>(this->log->StartTime());
-  auto endTime = convert<msgs::Time>(this->log->EndTime());
+  auto startTime = convert<msgs::Time>(
+      indexed ? this->index.StartTime() : this->log->StartTime());
+  auto endTime = convert<msgs::Time>(this->endTime);
   logStats.mutable_start_time()->set_sec(startTime.sec());
   logStats.mutable_start_time()->set_nsec(startTime.nsec());
   logStats.mutable_end_time()->set_sec(endTime.sec());
@@ -310,8 +1122,14 @@ bool LogPlaybackPrivate::Start(EntityComponentManager &_ecm)
 
   this->ReplaceResourceURIs(_ecm);
 
-  this->instStarted = true;
-  LogPlaybackPrivate::started = true;
+  // Decode upcoming steps in the background, starting once the step size is
+  // known from the first update, and keyframes while scrubbing
+  if (this->prefetchSteps > 0u || this->prefetchKeyframes > 0u)
+  {
+    this->prefetchThread =
+        std::thread(&LogPlaybackPrivate::PrefetchLoop, this);
+  }
+
   return true;
 }
 
@@ -392,6 +1210,42 @@ void LogPlaybackPrivate::ReplaceResourceURIs(EntityComponentManager &_ecm)
   });
 }
 
+//////////////////////////////////////////////////
+void LogPlaybackPrivate::LinkStoredResources()
+{
+  const auto manifest = ResourceStore::ManifestPath(this->logPath);
+  if (!common::exists(manifest))
+    return;
+
+  std::string storeDir;
+  std::vector<ResourceStore::Entry> entries;
+  if (!ResourceStore::ReadManifest(manifest, storeDir, entries))
+    return;
+
+  if (!this->resourceStorePath.empty())
+    storeDir = this->resourceStorePath;
+
+  ResourceStore store(storeDir);
+  std::size_t missing{0};
+  for (const auto &entry : entries)
+  {
+    if (!store.Link(entry.key, common::joinPaths(this->logPath, entry.path)))
+      ++missing;
+  }
+
+  if (missing > 0)
+  {
+    ignwarn << missing << " of " << entries.size() << " recorded resources "
+            << "couldn't be linked from store [" << storeDir << "]"
+            << std::endl;
+  }
+  else
+  {
+    ignmsg << "Linked " << entries.size() << " recorded resources from "
+           << "store [" << storeDir << "]" << std::endl;
+  }
+}
+
 //////////////////////////////////////////////////
 std::string LogPlaybackPrivate::PrependLogPath(const std::string &_uri)
 {
@@ -483,24 +1337,41 @@ void LogPlayback::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
   if (!this->dataPtr->instStarted)
     return;
 
-  // Get all messages from this timestep
-  // TODO(anyone) Jumping forward can be expensive for long jumps. For now,
-  // just playing every single step so we don't miss insertions and deletions.
-  auto startTime = _info.simTime - _info.dt;
-  auto endTime = _info.simTime;
+  // The entities of the previous log were removed at the end of the last
+  // update. The initial state of the next one is applied as it's loaded.
+  if (this->dataPtr->nextLogPending)
+  {
+    this->dataPtr->nextLogPending = false;
+    this->dataPtr->CloseLog();
+    if (!this->dataPtr->LoadNextLog(_ecm))
+    {
+      ignmsg << "No more logs to play back." << std::endl;
+      this->dataPtr->eventManager->Emit<events::Pause>(true);
+      return;
+    }
+    this->dataPtr->logOffset = _info.simTime;
+    return;
+  }
+
+  // Rewinding or seeking before the current log started plays it from the
+  // start of the simulation
+  if (_info.simTime < this->dataPtr->logOffset)
+    this->dataPtr->logOffset = std::chrono::steady_clock::duration::zero();
+
+  // Get all messages from this timestep. Every single step is played so we
+  // don't miss insertions and deletions, unless a keyframe lets us skip
+  // ahead. Times are relative to the start of the current log.
+  auto startTime = _info.simTime - this->dataPtr->logOffset - _info.dt;
+  auto endTime = _info.simTime - this->dataPtr->logOffset;
 
   bool seekRewind = false;
   std::set<Entity> entitiesToRemove;
-  if (_info.dt < std::chrono::steady_clock::duration::zero())
+  auto keyframeTime = this->dataPtr->SeekKeyframe(startTime, endTime);
+  if (_info.dt < std::chrono::steady_clock::duration::zero() || keyframeTime)
   {
-    // Detected jumping back in time. This can be expensive.
-    // To rewind / seek backward in time, we also need to play every single
-    // step from the beginning so we don't miss insertions and deletions
-    // This is because each serialized state is a changed state and not an
-    // absolute state.
-    // todo(anyone) Record absolute states during recording, i.e. key frames,
-    // so that playback can jump to these states without the need to
-    // incrementally build the states from the beginning
+    // Detected jumping back in time, or far forward. Each serialized state is
+    // a changed state and not an absolute state, so we merge every single
+    // step from the closest keyframe, or from the beginning if there's none.
 
     // Create a list of entities to be removed. The list will be updated later
     // as the log steps forward below
@@ -509,13 +1380,20 @@ void LogPlayback::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
     for (const auto &entity : entities)
       entitiesToRemove.insert(Entity(entity.first));
 
-    startTime = std::chrono::steady_clock::duration::zero();
+    startTime = keyframeTime ? *keyframeTime :
+        std::chrono::steady_clock::duration::zero();
   }
 
-  this->dataPtr->batch = this->dataPtr->log->QueryMessages(
-      transport::log::AllTopics({startTime, endTime}));
-
-  msgs::Pose_V queuedPose;
+  // Steps are usually prefetched, unless playback jumped
+  std::optional<LogPlaybackPrivate::DecodedStep> step;
+  if (seekRewind)
+    this->dataPtr->RestartPrefetch(endTime, {});
+  else
+    step = this->dataPtr->TakePrefetched(startTime, endTime);
+  if (!step && keyframeTime)
+    step = this->dataPtr->DecodeSeek(*keyframeTime, endTime);
+  if (!step)
+    step = this->dataPtr->Decode(startTime, endTime, keyframeTime);
 
   // If new pose updates are received, make sure that only the cached poses
   // from a previous Update cycle are cleared.
@@ -529,93 +1407,40 @@ void LogPlayback::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
   // current Update (we know that there are new poses to be saved if Parse
   // is called).
   bool clearCachedPoseUpdates = true;
+  for (const auto &poses : step->poses)
+    this->dataPtr->Parse(poses, clearCachedPoseUpdates);
 
-  auto iter = this->dataPtr->batch.begin();
-  while (iter != this->dataPtr->batch.end())
+  for (const auto &state : step->states)
   {
-    auto msgType = iter->Type();
-
-    // Only set the last pose of a sequence of poses.
-    if (msgType != "ignition.msgs.Pose_V" && queuedPose.pose_size() > 0)
-    {
-      this->dataPtr->Parse(queuedPose, clearCachedPoseUpdates);
-      queuedPose.Clear();
-    }
-
-    if (msgType == "ignition.msgs.Pose_V")
-    {
-      // Queue poses to be set later
-      queuedPose.ParseFromString(iter->Data());
-    }
-    else if (msgType == "ignition.msgs.SerializedState")
+    // For seeking back in time only:
+    // Update the list of entities to be removed so we do not remove any
+    // entities that are to be created
+    if (seekRewind)
     {
-      msgs::SerializedState msg;
-      msg.ParseFromString(iter->Data());
-
-      // For seeking back in time only:
-      // While stepping, update the list of entities to be removed
-      // so we do not remove any entities that are to be created
-      if (seekRewind)
+      auto updateToRemove = [&](Entity _entity, bool _remove)
       {
-        for (const auto &entIt : msg.entities())
-        {
-          Entity entity{entIt.id()};
-          if (entIt.remove())
-          {
-            entitiesToRemove.insert(entity);
-          }
-          else
-          {
-            entitiesToRemove.erase(entity);
-          }
-        }
+        if (_remove)
+          entitiesToRemove.insert(_entity);
+        else
+          entitiesToRemove.erase(_entity);
+      };
+      if (state.legacy)
+      {
+        for (const auto &entIt : state.state.entities())
+          updateToRemove(entIt.id(), entIt.remove());
       }
-
-      this->dataPtr->Parse(_ecm, msg);
-    }
-    else if (msgType == "ignition.msgs.SerializedStateMap")
-    {
-      msgs::SerializedStateMap msg;
-      msg.ParseFromString(iter->Data());
-
-      // For seeking back in time only:
-      // While stepping, update the list of entities to be removed
-      // so we do not remove any entities that are to be created
-      if (seekRewind)
+      else
       {
-        for (const auto &entIt : msg.entities())
-        {
-          const auto &entityMsg = entIt.second;
-          Entity entity{entityMsg.id()};
-          if (entityMsg.remove())
-          {
-            entitiesToRemove.insert(entity);
-          }
-          else
-          {
-            entitiesToRemove.erase(entity);
-          }
-        }
+        for (const auto &entIt : state.stateMap.entities())
+          updateToRemove(entIt.second.id(), entIt.second.remove());
       }
-
-      this->dataPtr->Parse(_ecm, msg);
-    }
-    else if (msgType == "ignition.msgs.StringMsg")
-    {
-      // Do nothing, we assume this is the SDF string
     }
+
+    if (state.legacy)
+      this->dataPtr->Parse(_ecm, state.state);
     else
-    {
-      ignwarn << "Trying to playback unsupported message type ["
-              << msgType << "]" << std::endl;
-    }
+      this->dataPtr->Parse(_ecm, state.stateMap);
     this->dataPtr->ReplaceResourceURIs(_ecm);
-    ++iter;
-  }
-
-  if (queuedPose.pose_size() > 0)
-  {
-    this->dataPtr->Parse(queuedPose, clearCachedPoseUpdates);
   }
 
   // flag changed entity poses as periodically changed based on
@@ -644,11 +1469,24 @@ void LogPlayback::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
   }
 
   // pause playback if end of log is reached
-  if (_info.simTime >= this->dataPtr->log->EndTime())
+  if (endTime >= this->dataPtr->endTime)
   {
     ignmsg << "End of log file reached. Time: " <<
       std::chrono::duration_cast<std::chrono::seconds>(
-      this->dataPtr->log->EndTime()).count() << " seconds" << std::endl;
+      this->dataPtr->endTime).count() << " seconds" << std::endl;
+
+    // Clear the world for the next log, keeping the world entity and the
+    // systems loaded into it
+    if (this->dataPtr->nextLog < this->dataPtr->logPaths.size())
+    {
+      for (const auto &vertex : _ecm.Entities().Vertices())
+      {
+        if (nullptr == _ecm.Component<components::World>(vertex.first))
+          _ecm.RequestRemoveEntity(vertex.first, false);
+      }
+      this->dataPtr->nextLogPending = true;
+      return;
+    }
 
     this->dataPtr->eventManager->Emit<events::Pause>(true);
   }
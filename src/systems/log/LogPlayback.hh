@@ -37,6 +37,20 @@ namespace systems
   /// \class LogPlayback LogPlayback.hh
   ///   ignition/gazebo/systems/log/LogPlayback.hh
   /// \brief Log state playback
+  ///
+  /// `<playback_path>` may be repeated to play back several logs one after
+  /// another. Once a log is over, its entities are removed and the next log
+  /// starts at the current sim time, while the other systems of the world,
+  /// such as sensors and their rendering scene, stay loaded. One instance
+  /// may play back in each world of a server, so several batches can play
+  /// in parallel worlds.
+  ///
+  /// While the GUI scrubs through the log, it publishes the scrub direction
+  /// on `/world/<world>/playback/scrub` (ignition.msgs.Int32), and the
+  /// keyframes a seek would start from are decoded ahead of time.
+  /// `<prefetch_keyframes>` sets how many, defaulting to 4, and 0 disables
+  /// it. The keyframe times are listed by the
+  /// `/world/<world>/playback/keyframes` service.
   class IGNITION_GAZEBO_VISIBLE LogPlayback:
     public System,
     public ISystemConfigure,
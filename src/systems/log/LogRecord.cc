@@ -18,13 +18,29 @@
 #include "LogRecord.hh"
 
 #include <sys/stat.h>
+#include <ignition/msgs/boolean.pb.h>
+#include <ignition/msgs/empty.pb.h>
 #include <ignition/msgs/stringmsg.pb.h>
 
+#include <atomic>
+#include <chrono>
 #include <string>
+#include <deque>
 #include <fstream>
 #include <ctime>
+#include <functional>
+#include <optional>
+#include <regex>
 #include <set>
+#include <limits>
 #include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
@@ -36,7 +52,6 @@
 #include <ignition/plugin/Register.hh>
 #include <ignition/transport/Node.hh>
 #include <ignition/transport/log/Log.hh>
-#include <ignition/transport/log/Recorder.hh>
 
 #include <sdf/Collision.hh>
 #include <sdf/Element.hh>
@@ -48,6 +63,7 @@
 #include <sdf/Visual.hh>
 #include <sdf/World.hh>
 
+#include "ignition/gazebo/components/Factory.hh"
 #include "ignition/gazebo/components/Geometry.hh"
 #include "ignition/gazebo/components/Light.hh"
 #include "ignition/gazebo/components/Link.hh"
@@ -61,9 +77,59 @@
 
 #include "ignition/gazebo/Util.hh"
 
+#include "LogIndex.hh"
+#include "LogWriter.hh"
+#include "ResourceStore.hh"
+
 using namespace ignition;
 using namespace ignition::gazebo::systems;
 
+namespace
+{
+/// \brief Update entity lifetimes with a recorded state.
+/// \param[in,out] _lifetimes Lifetimes, by entity.
+/// \param[in] _msg Recorded state.
+/// \param[in] _simTime Sim time of the state.
+void updateLifetimes(std::map<uint64_t, LogIndex::Lifetime> &_lifetimes,
+    const msgs::SerializedStateMap &_msg,
+    const std::chrono::steady_clock::duration &_simTime)
+{
+  for (const auto &entIt : _msg.entities())
+  {
+    auto it = _lifetimes.find(entIt.first);
+    if (it == _lifetimes.end())
+    {
+      it = _lifetimes.insert({entIt.first, {entIt.first,
+          _simTime.count(), std::numeric_limits<int64_t>::max()}}).first;
+    }
+    if (entIt.second.remove())
+      it->second.removed = _simTime.count();
+  }
+}
+}
+
+/// \brief Message kept in memory while buffering.
+struct BufferedMessage
+{
+  /// \brief Sim time the message is stamped with.
+  std::chrono::steady_clock::duration time;
+
+  /// \brief Topic the message is recorded on.
+  std::string topic;
+
+  /// \brief Message type name, for serialized messages.
+  std::string type;
+
+  /// \brief Serialized message, for messages from other nodes.
+  std::string data;
+
+  /// \brief Message, for messages recorded from PostUpdate.
+  std::unique_ptr<google::protobuf::Message> msg;
+
+  /// \brief True if the message is a keyframe.
+  bool keyframe{false};
+};
+
 // Private data class.
 class ignition::gazebo::systems::LogRecordPrivate
 {
@@ -101,9 +167,86 @@ class ignition::gazebo::systems::LogRecordPrivate
   /// there are errors saving the models.
   public: bool SaveModels(const std::set<std::string> &_models);
 
+  /// \brief Add the files of a model directory to the resource store, and
+  /// list them in the log's manifest.
+  /// \param[in] _srcPath Model directory.
+  /// \param[in] _modelPath Model SDF file, in the model directory.
+  /// \param[in] _modelSdf Content to store for the model SDF file.
+  /// \return True if all the files were stored.
+  public: bool StoreModelDirectory(const std::string &_srcPath,
+      const std::string &_modelPath, const std::string &_modelSdf);
+
   /// \brief Compress model resource files and state file into one file.
   public: void CompressStateAndResources();
 
+  /// \brief Record a topic published by other nodes, if not recorded yet.
+  /// \param[in] _topic Topic name.
+  public: void RecordTopic(const std::string &_topic);
+
+  /// \brief Update the recorded entity lifetimes and time range.
+  /// \param[in] _msg Changed state being recorded.
+  /// \param[in] _simTime Sim time of the state.
+  public: void UpdateIndex(const msgs::SerializedStateMap &_msg,
+      const std::chrono::steady_clock::duration &_simTime);
+
+  /// \brief Record the advertised topics which match a pattern of
+  /// `<record_topic>`.
+  public: void RecordMatchingTopics();
+
+  /// \brief Read the `<record_component>` and `<ignore_component>` filters.
+  /// \param[in] _sdf SDF of this plugin.
+  public: void LoadComponentFilters(const sdf::ElementPtr &_sdf);
+
+  /// \brief Whether a component type passes the allow and deny lists.
+  /// \param[in] _typeId Component type.
+  /// \return True if the type is recorded.
+  public: bool RecordsComponent(ComponentTypeId _typeId) const;
+
+  /// \brief Get the recorded component types whose changes are due in
+  /// this iteration, according to their recording rates.
+  /// \param[in] _simTime Current sim time.
+  /// \return Component types to record changes of.
+  public: std::unordered_set<ComponentTypeId> DueComponents(
+      const std::chrono::steady_clock::duration &_simTime);
+
+  /// \brief Record a message from PostUpdate, either to the log or to the
+  /// in-memory buffer.
+  /// \param[in] _time Sim time of the message.
+  /// \param[in] _topic Topic the message is recorded on.
+  /// \param[in] _msg Message, which isn't modified anymore by the caller.
+  /// \param[in] _keyframe True if the message is a keyframe.
+  public: void Record(const std::chrono::steady_clock::duration &_time,
+      const std::string &_topic,
+      std::unique_ptr<google::protobuf::Message> _msg,
+      bool _keyframe = false);
+
+  /// \brief Drop the buffered messages which aren't needed anymore to play
+  /// back the last buffer duration. The buffer always starts with a
+  /// keyframe.
+  /// \param[in] _simTime Current sim time.
+  public: void TrimBuffer(const std::chrono::steady_clock::duration &_simTime);
+
+  /// \brief Write the buffered messages to a new log in the log directory.
+  /// The messages are copied, and written and indexed by another thread.
+  /// \param[in] _simTime Current sim time.
+  public: void FlushBuffer(const std::chrono::steady_clock::duration &_simTime);
+
+  /// \brief Callback for the flush service.
+  /// \param[in] _req Unused.
+  /// \param[out] _res True if buffering, in which case the buffer is
+  /// flushed at the end of the current iteration.
+  /// \return True.
+  public: bool OnFlush(const msgs::Empty &_req, msgs::Boolean &_res);
+
+  /// \brief Fill a message with the changes to be recorded in this
+  /// iteration, taking the component filters into account.
+  /// \param[in] _ecm Entity component manager.
+  /// \param[in] _simTime Current sim time.
+  /// \param[out] _msg Message to be filled.
+  public: void FilteredChangedState(const EntityComponentManager &_ecm,
+      const std::chrono::steady_clock::duration &_simTime,
+      msgs::SerializedStateMap &_msg);
+
   /// \brief Indicator of whether any recorder instance has ever been started.
   /// Currently, only one instance is allowed. This enforcement may be removed
   /// in the future.
@@ -112,21 +255,59 @@ class ignition::gazebo::systems::LogRecordPrivate
   /// \brief Indicator of whether this instance has been started
   public: bool instStarted{false};
 
-  /// \brief Ignition transport recorder
-  public: transport::log::Recorder recorder;
+  /// \brief Writes recorded messages to the log file in the background
+  public: LogWriter writer;
 
-  /// \brief Directory in which to place log file
-  public: std::string logPath{""};
+  /// \brief Path of the log file
+  public: std::string dbPath;
 
-  /// \brief File path to write compressed file
-  public: std::string cmpPath{""};
+  /// \brief Sim time of the first iteration recorded
+  public: std::optional<std::chrono::steady_clock::duration> firstTime;
+
+  /// \brief Sim time of the last iteration recorded
+  public: std::chrono::steady_clock::duration lastTime{0};
 
-  /// \brief Clock used to timestamp recorded messages with sim time.
+  /// \brief Sim times of the keyframes recorded
+  public: std::vector<std::chrono::nanoseconds> keyframeTimes;
+
+  /// \brief Lifetime of every entity recorded, written to the log index
+  public: std::map<uint64_t, LogIndex::Lifetime> lifetimes;
+
+  /// \brief Sim time recorded messages from other nodes are stamped with.
   /// This is not the timestamp on the header, rather a logging-specific stamp.
   /// This stamp is used by LogPlayback to step through logs.
   /// In case there's disagreement between these stamps, the one in the
   /// header should be the most accurate.
-  public: std::unique_ptr<transport::NetworkClock> clock;
+  public: std::atomic<std::chrono::steady_clock::duration::rep> simTime{0};
+
+  /// \brief Topics published by other nodes which are being recorded.
+  public: std::set<std::string> recordedTopics;
+
+  /// \brief Patterns of other topics to be recorded as they're advertised.
+  public: std::vector<std::regex> recordTopicPatterns;
+
+  /// \brief Wall time advertised topics were last matched against the
+  /// patterns.
+  public: std::chrono::steady_clock::time_point lastTopicDiscovery;
+
+  /// \brief Topic the SDF string is recorded on
+  public: std::string sdfTopic;
+
+  /// \brief Topic state changes are recorded on
+  public: std::string stateTopic;
+
+  /// \brief Topic full state keyframes are recorded on, empty to not
+  /// record keyframes
+  public: std::string keyframeTopic;
+
+  /// \brief Topic slow step reports are published on, if recorded
+  public: std::string slowStepTopic;
+
+  /// \brief Directory in which to place log file
+  public: std::string logPath{""};
+
+  /// \brief File path to write compressed file
+  public: std::string cmpPath{""};
 
   /// \brief Name of this world
   public: std::string worldName{""};
@@ -134,19 +315,19 @@ class ignition::gazebo::systems::LogRecordPrivate
   /// \brief SDF of this plugin
   public: std::shared_ptr<const sdf::Element> sdf{nullptr};
 
-  /// \brief Transport node for publishing SDF string to be recorded
+  /// \brief Transport node subscribing to the other topics to be recorded
   public: transport::Node node;
 
-  /// \brief Publisher for SDF string
-  public: transport::Node::Publisher sdfPub;
+  /// \brief Sim time between keyframes, 0 to not record keyframes.
+  public: std::chrono::steady_clock::duration keyframeInterval{0};
 
-  /// \brief Publisher for state changes
-  public: transport::Node::Publisher statePub;
+  /// \brief Sim time of the last keyframe recorded.
+  public: std::optional<std::chrono::steady_clock::duration> lastKeyframe;
 
   /// \brief Message holding SDF string of world
   public: msgs::StringMsg sdfMsg;
 
-  /// \brief Whether the SDF has already been published
+  /// \brief Whether the SDF has already been recorded
   public: bool sdfPublished{false};
 
   /// \brief Record with model resources
@@ -157,6 +338,66 @@ class ignition::gazebo::systems::LogRecordPrivate
 
   /// \brief List of saved models if record with resources is enabled.
   public: std::set<std::string> savedModels;
+
+  /// \brief Store model resources are saved to, instead of being copied
+  /// into the log directory. Null to copy them.
+  public: std::unique_ptr<ResourceStore> resourceStore;
+
+  /// \brief True if any component filter or rate was set, otherwise the
+  /// changed state is recorded as is.
+  public: bool filterComponents{false};
+
+  /// \brief Component types to record, empty to record all of them.
+  public: std::unordered_set<ComponentTypeId> allowedComponents;
+
+  /// \brief Component types never recorded.
+  public: std::unordered_set<ComponentTypeId> ignoredComponents;
+
+  /// \brief Sim time between recordings of changes, per component type.
+  /// Types without a period are recorded every iteration.
+  public: std::unordered_map<ComponentTypeId,
+      std::chrono::steady_clock::duration> componentPeriods;
+
+  /// \brief Sim time changes were last recorded, per component type with a
+  /// period.
+  public: std::unordered_map<ComponentTypeId,
+      std::chrono::steady_clock::duration> lastComponentRecords;
+
+  /// \brief True if messages recorded from PostUpdate are compressed.
+  public: bool compressStates{false};
+
+  /// \brief Sim time kept in memory instead of being written to the log,
+  /// 0 to write everything to the log.
+  public: std::chrono::steady_clock::duration bufferDuration{0};
+
+  /// \brief Messages kept in memory, in order. Protected by bufferMutex.
+  public: std::deque<BufferedMessage> buffer;
+
+  /// \brief Sim times of the buffered keyframes. Protected by
+  /// bufferMutex.
+  public: std::deque<std::chrono::steady_clock::duration> bufferedKeyframes;
+
+  /// \brief Protects the buffer, which other topics are recorded to from
+  /// transport threads.
+  public: std::mutex bufferMutex;
+
+  /// \brief Set by the flush service.
+  public: std::atomic<bool> flushRequested{false};
+
+  /// \brief True to flush the buffer when a slow step is reported.
+  public: bool flushOnSlowStep{false};
+
+  /// \brief Set when a slow step is reported.
+  public: std::atomic<bool> slowStepReported{false};
+
+  /// \brief Sim time of the last flush.
+  public: std::optional<std::chrono::steady_clock::duration> lastFlush;
+
+  /// \brief Number of flushes so far, which numbers their directories.
+  public: unsigned int flushCount{0};
+
+  /// \brief Thread writing the last flush.
+  public: std::thread flushThread;
 };
 
 bool LogRecordPrivate::started{false};
@@ -185,8 +426,20 @@ LogRecord::~LogRecord()
 {
   if (this->dataPtr->instStarted)
   {
-    // Use ign-transport directly
-    this->dataPtr->recorder.Stop();
+    // Write everything still queued before indexing and compressing
+    this->dataPtr->writer.Close();
+    if (this->dataPtr->flushThread.joinable())
+      this->dataPtr->flushThread.join();
+
+    if (this->dataPtr->firstTime)
+    {
+      std::vector<LogIndex::Lifetime> lifetimes;
+      lifetimes.reserve(this->dataPtr->lifetimes.size());
+      for (const auto &lifetime : this->dataPtr->lifetimes)
+        lifetimes.push_back(lifetime.second);
+      LogIndex::Write(this->dataPtr->dbPath, *this->dataPtr->firstTime,
+          this->dataPtr->lastTime, this->dataPtr->keyframeTimes, lifetimes);
+    }
 
     if (this->dataPtr->compress)
       this->dataPtr->CompressStateAndResources();
@@ -209,9 +462,50 @@ void LogRecord::Configure(const Entity &_entity,
   this->dataPtr->SetRecordResources(_sdf->Get<bool>("record_resources",
     false).first);
 
+  if (_sdf->HasElement("resource_store"))
+  {
+    auto storePath = _sdf->Get<std::string>("resource_store");
+    if (storePath.empty())
+      storePath = ResourceStore::DefaultPath();
+    this->dataPtr->resourceStore = std::make_unique<ResourceStore>(
+        common::absPath(storePath));
+  }
+
   this->dataPtr->compress = _sdf->Get<bool>("compress", false).first;
+
+  this->dataPtr->compressStates =
+      _sdf->Get<bool>("compress_states", false).first;
+  this->dataPtr->writer.SetCompression(this->dataPtr->compressStates);
+
+  this->dataPtr->LoadComponentFilters(
+      std::const_pointer_cast<sdf::Element>(_sdf));
+
+  auto keyframeInterval = _sdf->Get<double>("keyframe_interval", 0.0).first;
+  if (keyframeInterval > 0.0)
+  {
+    this->dataPtr->keyframeInterval =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(keyframeInterval));
+  }
   this->dataPtr->cmpPath = _sdf->Get<std::string>("compress_path", "").first;
 
+  // Flushed logs must start with a complete state, so buffering needs
+  // keyframes
+  auto bufferDuration = _sdf->Get<double>("buffer_duration", 0.0).first;
+  if (bufferDuration > 0.0)
+  {
+    this->dataPtr->bufferDuration =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(bufferDuration));
+    if (this->dataPtr->keyframeInterval ==
+        std::chrono::steady_clock::duration::zero())
+    {
+      this->dataPtr->keyframeInterval = this->dataPtr->bufferDuration;
+    }
+    this->dataPtr->flushOnSlowStep =
+        _sdf->Get<bool>("flush_on_slow_step", false).first;
+  }
+
   // If plugin is specified in both the SDF tag and on command line, only
   //   activate one recorder.
   if (!LogRecordPrivate::started)
@@ -273,6 +567,11 @@ bool LogRecordPrivate::Start(const std::string &_logPath,
   if (this->recordResources)
   {
     ignmsg << "Resources will be recorded\n";
+    if (this->resourceStore)
+    {
+      ignmsg << "Resources will be saved to store ["
+             << this->resourceStore->Dir() << "]\n";
+    }
   }
 
   // Create log directory
@@ -282,52 +581,80 @@ bool LogRecordPrivate::Start(const std::string &_logPath,
   }
 
   // Use directory basename as topic name, to be able to retrieve at playback
-  std::string sdfTopic = "/" + common::basename(this->logPath) + "/sdf";
-  auto validSdfTopic = transport::TopicUtils::AsValidTopic(sdfTopic);
-  if (!validSdfTopic.empty())
+  this->sdfTopic = transport::TopicUtils::AsValidTopic(
+      "/" + common::basename(this->logPath) + "/sdf");
+  if (this->sdfTopic.empty())
   {
-    this->sdfPub = this->node.Advertise(validSdfTopic,
-        this->sdfMsg.GetTypeName());
-  }
-  else
-  {
-    ignerr << "Failed to generate valid topic to publish SDF. Tried ["
-           << sdfTopic << "]." << std::endl;
+    ignerr << "Failed to generate valid topic to record SDF." << std::endl;
   }
 
   // TODO(louise) Combine with SceneBroadcaster's state topic
-  std::string stateTopic = "/world/" + this->worldName + "/changed_state";
-  auto validStateTopic = transport::TopicUtils::AsValidTopic(stateTopic);
-  if (!validStateTopic.empty())
+  this->stateTopic = transport::TopicUtils::AsValidTopic(
+      "/world/" + this->worldName + "/changed_state");
+  if (this->stateTopic.empty())
   {
-    this->statePub = this->node.Advertise<msgs::SerializedStateMap>(
-        validStateTopic);
+    ignerr << "Failed to generate valid topic to record state." << std::endl;
   }
-  else
+
+  if (this->keyframeInterval > std::chrono::steady_clock::duration::zero())
   {
-    ignerr << "Failed to generate valid topic to publish state. Tried ["
-           << stateTopic << "]." << std::endl;
+    this->keyframeTopic = transport::TopicUtils::AsValidTopic(
+        "/world/" + this->worldName + "/state_keyframe");
+    if (this->keyframeTopic.empty())
+    {
+      ignerr << "Failed to generate valid topic to record keyframes."
+             << std::endl;
+    }
   }
 
-  // Append file name
-  std::string dbPath = common::joinPaths(this->logPath, "state.tlog");
-  if (common::exists(dbPath))
+  if (this->bufferDuration > std::chrono::steady_clock::duration::zero())
   {
-    ignmsg << "Overwriting existing file [" << dbPath << "]\n";
-    common::removeFile(dbPath);
+    // Nothing is written until the buffer is flushed
+    std::string flushService = "/world/" + this->worldName + "/record/flush";
+    this->node.Advertise(flushService, &LogRecordPrivate::OnFlush, this);
+    ignmsg << "Keeping the last ["
+           << std::chrono::duration<double>(this->bufferDuration).count()
+           << "] s of recorded sim time in memory. Call [" << flushService
+           << "] to write it to [" << this->logPath << "]" << std::endl;
   }
-  ignmsg << "Recording to log file [" << dbPath << "]" << std::endl;
+  else
+  {
+    // Append file name
+    std::string dbPath = common::joinPaths(this->logPath, "state.tlog");
+    if (common::exists(dbPath))
+    {
+      ignmsg << "Overwriting existing file [" << dbPath << "]\n";
+      common::removeFile(dbPath);
+    }
+    ignmsg << "Recording to log file [" << dbPath << "]" << std::endl;
+
+    // This calls Log::Open() and loads sql schema
+    if (!this->writer.Open(dbPath))
+      return false;
+    this->dbPath = dbPath;
+  }
+
+  // The SDF, state and keyframes are written directly from PostUpdate,
+  // poses and other topics are subscribed to.
+  igndbg << "Recording default topic[" << this->sdfTopic << "].\n";
+  igndbg << "Recording default topic[" << this->stateTopic << "].\n";
+  if (!this->keyframeTopic.empty())
+    igndbg << "Recording default topic[" << this->keyframeTopic << "].\n";
 
-  // Add default topics if no topics were specified.
   std::string dynPoseTopic = "/world/" + this->worldName +
     "/dynamic_pose/info";
-
   igndbg << "Recording default topic[" << dynPoseTopic << "].\n";
-  igndbg << "Recording default topic[" << sdfTopic << "].\n";
-  igndbg << "Recording default topic[" << stateTopic << "].\n";
-  this->recorder.AddTopic(dynPoseTopic);
-  this->recorder.AddTopic(sdfTopic);
-  this->recorder.AddTopic(stateTopic);
+  this->RecordTopic(dynPoseTopic);
+
+  // Slow step reports, so stalls can be diagnosed when playing back
+  if (this->sdf->Get<bool>("record_diagnostics", false).first ||
+      this->flushOnSlowStep)
+  {
+    this->slowStepTopic = "/world/" + this->worldName +
+      "/diagnostics/slow_step";
+    igndbg << "Recording diagnostics topic[" << this->slowStepTopic << "].\n";
+    this->RecordTopic(this->slowStepTopic);
+  }
 
   // Get the topics to record, if any.
   if (this->sdf->HasElement("record_topic"))
@@ -342,35 +669,365 @@ bool LogRecordPrivate::Start(const std::string &_logPath,
       std::string topic = recordTopicElem->Get<std::string>();
       if (std::regex_match(topic, regexMatch))
       {
-        this->recorder.AddTopic(std::regex(topic));
+        this->recordTopicPatterns.emplace_back(topic);
         igndbg << "Recording topic[" << topic << "] as regular expression.\n";
       }
       else
       {
-        this->recorder.AddTopic(topic);
+        this->RecordTopic(topic);
         igndbg << "Recording topic[" << topic << "] as plain topic.\n";
       }
       recordTopicElem = recordTopicElem->GetNextElement("record_topic");
     }
   }
+  this->RecordMatchingTopics();
 
-  // Timestamp messages with sim time and republish that time on
-  // a ~/log/clock topic (which we don't really need).
-  // Note that the message headers should also have a timestamp
-  auto clockTopic = "/world/" + this->worldName + "/log/clock";
-  this->clock = std::make_unique<transport::NetworkClock>(clockTopic,
-      transport::NetworkClock::TimeBase::SIM);
-  this->recorder.Sync(this->clock.get());
+  this->instStarted = true;
+  return true;
+}
 
-  // This calls Log::Open() and loads sql schema
-  if (this->recorder.Start(dbPath) ==
-      ignition::transport::log::RecorderError::SUCCESS)
+//////////////////////////////////////////////////
+void LogRecordPrivate::RecordTopic(const std::string &_topic)
+{
+  // Topics written directly aren't subscribed to
+  if (_topic == this->sdfTopic || _topic == this->stateTopic ||
+      _topic == this->keyframeTopic ||
+      !this->recordedTopics.insert(_topic).second)
   {
-    this->instStarted = true;
-    return true;
+    return;
+  }
+
+  // Messages are recorded as they arrive, without being deserialized
+  auto cb = [this](const char *_data, const size_t _size,
+      const transport::MessageInfo &_info)
+  {
+    const std::chrono::steady_clock::duration time(this->simTime);
+    if (this->bufferDuration == std::chrono::steady_clock::duration::zero())
+    {
+      this->writer.Write(time, _info.Topic(), _info.Type(),
+          std::string(_data, _size));
+      return;
+    }
+
+    if (this->flushOnSlowStep && _info.Topic() == this->slowStepTopic)
+      this->slowStepReported = true;
+
+    std::lock_guard<std::mutex> lock(this->bufferMutex);
+    this->buffer.push_back({time, _info.Topic(), _info.Type(),
+        std::string(_data, _size), nullptr});
+  };
+  if (!this->node.SubscribeRaw(_topic, cb))
+  {
+    ignerr << "Failed to subscribe to topic [" << _topic << "] for recording"
+           << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::UpdateIndex(const msgs::SerializedStateMap &_msg,
+    const std::chrono::steady_clock::duration &_simTime)
+{
+  if (!this->firstTime)
+    this->firstTime = _simTime;
+  this->lastTime = _simTime;
+
+  updateLifetimes(this->lifetimes, _msg, _simTime);
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::Record(const std::chrono::steady_clock::duration &_time,
+    const std::string &_topic, std::unique_ptr<google::protobuf::Message> _msg,
+    bool _keyframe)
+{
+  if (this->bufferDuration == std::chrono::steady_clock::duration::zero())
+  {
+    this->writer.Write(_time, _topic, std::move(_msg));
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->bufferMutex);
+  this->buffer.push_back({_time, _topic, "", "", std::move(_msg),
+      _keyframe});
+  if (_keyframe)
+    this->bufferedKeyframes.push_back(_time);
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::TrimBuffer(
+    const std::chrono::steady_clock::duration &_simTime)
+{
+  if (_simTime < this->bufferDuration)
+    return;
+  const auto cutoff = _simTime - this->bufferDuration;
+
+  // Drop everything before the latest keyframe at or before the cutoff
+  std::lock_guard<std::mutex> lock(this->bufferMutex);
+  while (this->bufferedKeyframes.size() > 1 &&
+      this->bufferedKeyframes[1] <= cutoff)
+  {
+    this->bufferedKeyframes.pop_front();
+    bool keyframeDropped{false};
+    while (!this->buffer.empty())
+    {
+      if (this->buffer.front().keyframe)
+      {
+        if (keyframeDropped)
+          break;
+        keyframeDropped = true;
+      }
+      this->buffer.pop_front();
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::FlushBuffer(
+    const std::chrono::steady_clock::duration &_simTime)
+{
+  this->lastFlush = _simTime;
+
+  auto flushWriter = std::make_unique<LogWriter>();
+  std::vector<std::chrono::nanoseconds> flushKeyframes;
+  std::map<uint64_t, LogIndex::Lifetime> flushLifetimes;
+  std::chrono::steady_clock::duration start{0};
+  std::string dbPath;
+  {
+    std::lock_guard<std::mutex> lock(this->bufferMutex);
+
+    // Skip messages recorded before the first keyframe, which playback
+    // couldn't apply
+    auto first = this->buffer.begin();
+    while (first != this->buffer.end() && !first->keyframe)
+      ++first;
+    if (first == this->buffer.end())
+    {
+      ignwarn << "Nothing to flush yet, no keyframe was recorded."
+              << std::endl;
+      return;
+    }
+    start = first->time;
+
+    auto dir = common::joinPaths(this->logPath,
+        "flush_" + std::to_string(this->flushCount++));
+    common::createDirectories(dir);
+    dbPath = common::joinPaths(dir, "state.tlog");
+    if (common::exists(dbPath))
+      common::removeFile(dbPath);
+
+    flushWriter->SetCompression(this->compressStates);
+    if (!flushWriter->Open(dbPath))
+      return;
+
+    flushWriter->Write(start, this->sdfTopic,
+        std::make_unique<msgs::StringMsg>(this->sdfMsg));
+
+    // Writing only queues the copies, the other thread writes them
+    for (auto it = first; it != this->buffer.end(); ++it)
+    {
+      if (!it->msg)
+      {
+        flushWriter->Write(it->time, it->topic, it->type,
+            std::string(it->data));
+        continue;
+      }
+
+      std::unique_ptr<google::protobuf::Message> copy(it->msg->New());
+      copy->CopyFrom(*it->msg);
+      if (it->topic == this->stateTopic || it->keyframe)
+      {
+        updateLifetimes(flushLifetimes,
+            static_cast<const msgs::SerializedStateMap &>(*it->msg),
+            it->time);
+      }
+      if (it->keyframe)
+        flushKeyframes.push_back(it->time);
+      flushWriter->Write(it->time, it->topic, std::move(copy));
+    }
+  }
+
+  std::vector<LogIndex::Lifetime> lifetimes;
+  lifetimes.reserve(flushLifetimes.size());
+  for (const auto &lifetime : flushLifetimes)
+    lifetimes.push_back(lifetime.second);
+
+  ignmsg << "Flushing recorded sim time ["
+         << std::chrono::duration<double>(start).count() << "] to ["
+         << std::chrono::duration<double>(_simTime).count() << "] s to ["
+         << dbPath << "]" << std::endl;
+
+  // The index is only valid once the log is complete
+  if (this->flushThread.joinable())
+    this->flushThread.join();
+  this->flushThread = std::thread(
+      [writer = std::move(flushWriter), dbPath, start, end = _simTime,
+       keyframes = std::move(flushKeyframes),
+       lifetimes = std::move(lifetimes)]()
+      {
+        writer->Close();
+        LogIndex::Write(dbPath, start, end, keyframes, lifetimes);
+      });
+}
+
+//////////////////////////////////////////////////
+bool LogRecordPrivate::OnFlush(const msgs::Empty &, msgs::Boolean &_res)
+{
+  this->flushRequested = true;
+  _res.set_data(true);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::RecordMatchingTopics()
+{
+  this->lastTopicDiscovery = std::chrono::steady_clock::now();
+  if (this->recordTopicPatterns.empty())
+    return;
+
+  std::vector<std::string> topics;
+  this->node.TopicList(topics);
+  for (const auto &topic : topics)
+  {
+    if (this->recordedTopics.find(topic) != this->recordedTopics.end())
+      continue;
+
+    for (const auto &pattern : this->recordTopicPatterns)
+    {
+      if (std::regex_match(topic, pattern))
+      {
+        this->RecordTopic(topic);
+        break;
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::LoadComponentFilters(const sdf::ElementPtr &_sdf)
+{
+  // Type IDs are hashes of the names, so types registered by plugins which
+  // aren't loaded yet can be filtered too
+  auto typeId = [](const std::string &_name) -> ComponentTypeId
+  {
+    if (_name.empty())
+      return 0;
+
+    auto id = common::hash64(_name);
+    if (!components::Factory::Instance()->HasType(id))
+    {
+      igndbg << "Component type [" << _name << "] isn't registered yet."
+             << std::endl;
+    }
+    return id;
+  };
+
+  if (_sdf->HasElement("record_component"))
+  {
+    for (auto elem = _sdf->GetElement("record_component"); elem;
+        elem = elem->GetNextElement("record_component"))
+    {
+      auto id = typeId(elem->Get<std::string>());
+      if (0 == id)
+        continue;
+
+      this->allowedComponents.insert(id);
+      this->filterComponents = true;
+
+      auto rate = elem->Get<double>("rate", 0.0).first;
+      if (rate > 0.0)
+      {
+        this->componentPeriods[id] =
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / rate));
+      }
+    }
+  }
+
+  if (_sdf->HasElement("ignore_component"))
+  {
+    for (auto elem = _sdf->GetElement("ignore_component"); elem;
+        elem = elem->GetNextElement("ignore_component"))
+    {
+      auto id = typeId(elem->Get<std::string>());
+      if (0 == id)
+        continue;
+
+      this->ignoredComponents.insert(id);
+      this->filterComponents = true;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool LogRecordPrivate::RecordsComponent(ComponentTypeId _typeId) const
+{
+  return (this->allowedComponents.empty() ||
+      this->allowedComponents.find(_typeId) !=
+      this->allowedComponents.end()) &&
+      this->ignoredComponents.find(_typeId) == this->ignoredComponents.end();
+}
+
+//////////////////////////////////////////////////
+std::unordered_set<ComponentTypeId> LogRecordPrivate::DueComponents(
+    const std::chrono::steady_clock::duration &_simTime)
+{
+  std::unordered_set<ComponentTypeId> types;
+  auto addIfDue = [&](ComponentTypeId _typeId)
+  {
+    if (!this->RecordsComponent(_typeId))
+      return;
+
+    auto period = this->componentPeriods.find(_typeId);
+    if (period != this->componentPeriods.end())
+    {
+      auto last = this->lastComponentRecords.find(_typeId);
+      if (last != this->lastComponentRecords.end() &&
+          _simTime - last->second < period->second)
+      {
+        return;
+      }
+      this->lastComponentRecords[_typeId] = _simTime;
+    }
+    types.insert(_typeId);
+  };
+
+  if (!this->allowedComponents.empty())
+  {
+    for (const auto &typeId : this->allowedComponents)
+      addIfDue(typeId);
   }
   else
-    return false;
+  {
+    for (const auto &typeId : components::Factory::Instance()->TypeIds())
+      addIfDue(typeId);
+  }
+  return types;
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::FilteredChangedState(const EntityComponentManager &_ecm,
+    const std::chrono::steady_clock::duration &_simTime,
+    msgs::SerializedStateMap &_msg)
+{
+  // New and removed entities, with all their recorded components whatever
+  // their rate, so playback can create them
+  _ecm.ChangedState(_msg);
+  for (auto &entIt : *_msg.mutable_entities())
+  {
+    auto &components = *entIt.second.mutable_components();
+    for (auto compIt = components.begin(); compIt != components.end();)
+    {
+      if (this->RecordsComponent(
+          static_cast<ComponentTypeId>(compIt->second.type())))
+        ++compIt;
+      else
+        compIt = components.erase(compIt);
+    }
+  }
+
+  // Changes to existing entities, only for the types due in this iteration
+  auto types = this->DueComponents(_simTime);
+  if (!types.empty())
+    _ecm.State(_msg, {}, types);
 }
 
 //////////////////////////////////////////////////
@@ -531,10 +1188,10 @@ bool LogRecordPrivate::SaveModels(const std::set<std::string> &_models)
       }
     }
 
-    // Copy resource
-    // TODO(anyone): support shared resources. Currently, the entire model
-    // directory is copied, which ensures that meshes and textures in the
-    // model directory are copied.
+    // Copy resource. The entire model directory is saved, which ensures
+    // that meshes and textures in the model directory are saved. Files
+    // shared across models and logs are only stored once when there's a
+    // resource store.
     if (fileFound)
     {
       std::string srcPath = common::parentPath(modelPath);
@@ -590,8 +1247,16 @@ bool LogRecordPrivate::SaveModels(const std::set<std::string> &_models)
         }
       }
 
+      if (this->resourceStore)
+      {
+        if (!this->StoreModelDirectory(srcPath, modelPath,
+            root.Element()->ToString("")))
+        {
+          saveError = true;
+        }
+      }
       // Copy entire model directory
-      if (!common::createDirectories(destPath) ||
+      else if (!common::createDirectories(destPath) ||
           !common::copyDirectory(srcPath, destPath))
       {
         ignerr << "Failed to copy model directory from [" << srcPath
@@ -616,6 +1281,51 @@ bool LogRecordPrivate::SaveModels(const std::set<std::string> &_models)
   return !saveError;
 }
 
+//////////////////////////////////////////////////
+bool LogRecordPrivate::StoreModelDirectory(const std::string &_srcPath,
+    const std::string &_modelPath, const std::string &_modelSdf)
+{
+  bool storeError = false;
+  std::vector<ResourceStore::Entry> entries;
+  std::function<void(const std::string &)> storeDir =
+      [&](const std::string &_dir)
+  {
+    for (common::DirIter file(_dir); file != common::DirIter(); ++file)
+    {
+      const std::string path(*file);
+      if (common::isDirectory(path))
+      {
+        storeDir(path);
+        continue;
+      }
+
+      // The model SDF is saved with its URIs relative to the model
+      const std::string key = path == _modelPath ?
+          this->resourceStore->Add(_modelSdf) :
+          this->resourceStore->AddFile(path);
+      if (key.empty())
+        storeError = true;
+      else
+        entries.push_back({key, path});
+    }
+  };
+  storeDir(_srcPath);
+
+  if (!ResourceStore::AppendManifest(
+      ResourceStore::ManifestPath(this->logPath), this->resourceStore->Dir(),
+      entries))
+  {
+    storeError = true;
+  }
+
+  if (storeError)
+  {
+    ignerr << "Failed to store model directory [" << _srcPath << "] in ["
+           << this->resourceStore->Dir() << "]" << std::endl;
+  }
+  return !storeError;
+}
+
 //////////////////////////////////////////////////
 void LogRecordPrivate::CompressStateAndResources()
 {
@@ -650,7 +1360,7 @@ void LogRecord::PreUpdate(const UpdateInfo &_info,
   // Safe guard to prevent seg faults if recorder could not be started
   if (!this->dataPtr->instStarted)
     return;
-  this->dataPtr->clock->SetTime(_info.simTime);
+  this->dataPtr->simTime = _info.simTime.count();
 }
 
 //////////////////////////////////////////////////
@@ -692,7 +1402,13 @@ void LogRecord::PostUpdate(const UpdateInfo &_info,
         this->dataPtr->sdfMsg.set_data(
             worldSdfComp->Data().Element()->ToString(""));
 
-        this->dataPtr->sdfPub.Publish(this->dataPtr->sdfMsg);
+        // When buffering, the SDF is written at the start of each flush
+        if (this->dataPtr->bufferDuration ==
+            std::chrono::steady_clock::duration::zero())
+        {
+          this->dataPtr->writer.Write(_info.simTime, this->dataPtr->sdfTopic,
+              std::make_unique<msgs::StringMsg>(this->dataPtr->sdfMsg));
+        }
         this->dataPtr->sdfPublished = true;
       }
     }
@@ -700,14 +1416,59 @@ void LogRecord::PostUpdate(const UpdateInfo &_info,
 
   // TODO(louise) Use the SceneBroadcaster's topic once that publishes
   // the changed state
-  // \todo(anyone) A potential enhancement here is have a keyframe mechanism
-  // to store complete state periodically, and then store incremental from
-  // that. It would reduce some of the compute on replaying
-  // (especially in tools like plotting or seeking through logs).
-  msgs::SerializedStateMap stateMsg;
-  _ecm.ChangedState(stateMsg);
-  if (!stateMsg.entities().empty())
-    this->dataPtr->statePub.Publish(stateMsg);
+  // Changes are serialized and written by the writer's thread
+  const bool buffering = this->dataPtr->bufferDuration >
+      std::chrono::steady_clock::duration::zero();
+  auto stateMsg = std::make_unique<msgs::SerializedStateMap>();
+  if (this->dataPtr->filterComponents)
+    this->dataPtr->FilteredChangedState(_ecm, _info.simTime, *stateMsg);
+  else
+    _ecm.ChangedState(*stateMsg);
+  if (!buffering)
+    this->dataPtr->UpdateIndex(*stateMsg, _info.simTime);
+  if (!stateMsg->entities().empty())
+  {
+    this->dataPtr->Record(_info.simTime, this->dataPtr->stateTopic,
+        std::move(stateMsg));
+  }
+
+  // Periodically record the complete state, which already includes this
+  // iteration's changes, so playback can seek without replaying the whole log
+  if (!this->dataPtr->keyframeTopic.empty() &&
+      (!this->dataPtr->lastKeyframe ||
+       _info.simTime - *this->dataPtr->lastKeyframe >=
+       this->dataPtr->keyframeInterval))
+  {
+    auto keyframeMsg = std::make_unique<msgs::SerializedStateMap>();
+    _ecm.State(*keyframeMsg, {}, {}, true);
+    this->dataPtr->Record(_info.simTime, this->dataPtr->keyframeTopic,
+        std::move(keyframeMsg), true);
+    this->dataPtr->lastKeyframe = _info.simTime;
+    if (!buffering)
+      this->dataPtr->keyframeTimes.push_back(_info.simTime);
+  }
+
+  if (buffering)
+  {
+    this->dataPtr->TrimBuffer(_info.simTime);
+
+    // Slow steps often come in bursts, so they trigger at most one flush
+    // per buffer duration
+    bool slowStep = this->dataPtr->slowStepReported.exchange(false) &&
+        (!this->dataPtr->lastFlush ||
+         _info.simTime - *this->dataPtr->lastFlush >=
+         this->dataPtr->bufferDuration);
+    if (this->dataPtr->flushRequested.exchange(false) || slowStep)
+      this->dataPtr->FlushBuffer(_info.simTime);
+  }
+
+  // Pick up topics matching the recorded patterns as they're advertised
+  if (!this->dataPtr->recordTopicPatterns.empty() &&
+      std::chrono::steady_clock::now() - this->dataPtr->lastTopicDiscovery >
+      std::chrono::seconds(1))
+  {
+    this->dataPtr->RecordMatchingTopics();
+  }
 
   // If there are new models loaded, save meshes and textures
   if (this->dataPtr->RecordResources() && _ecm.HasNewEntities())
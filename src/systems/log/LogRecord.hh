@@ -36,6 +36,60 @@ namespace systems
 
   /// \class LogRecord LogRecord.hh ignition/gazebo/systems/log/LogRecord.hh
   /// \brief Log state recorder
+  ///
+  /// The SDF and the changed state of every iteration are written straight
+  /// to the log from PostUpdate, by a background thread. Poses and the
+  /// topics listed in `<record_topic>` are subscribed to and recorded as
+  /// they arrive, stamped with the current sim time.
+  ///
+  /// By default, new and removed entities are recorded with all their
+  /// components. Once any of the following is set, changes to the
+  /// components of existing entities are recorded too, filtered by type:
+  ///
+  /// * `<record_component>`: Name of a component type to record, such as
+  ///   `ign_gazebo_components.Pose`. May be repeated. If none is given, all
+  ///   types are recorded. The optional `rate` attribute sets how often
+  ///   changes are recorded, in Hz of sim time. Changes in between are
+  ///   skipped, so rates suit components which change continuously.
+  /// * `<ignore_component>`: Name of a component type never to record. May
+  ///   be repeated.
+  ///
+  /// Once recording stops, a `state.tlog.idx` index with the time range,
+  /// keyframe times and entity lifetimes is written next to the log, so
+  /// playback can start without scanning it.
+  ///
+  /// With `<compress_states>` set to true, the SDF, states and keyframes are
+  /// compressed one by one as they're written, so the log is smaller while
+  /// recording. LogPlayback decompresses them transparently. `<compress>`
+  /// still zips the whole log directory once recording is over.
+  ///
+  /// With `<record_resources>` set to true, the directories of models with
+  /// meshes are saved into the log. If `<resource_store>` is also given,
+  /// their files are saved to that directory instead, named after their
+  /// content, and only listed in the log's `resources.manifest`. Files
+  /// shared by several models or logs are then stored once. An empty
+  /// `<resource_store>` uses `${IGN_HOMEDIR}/.ignition/gazebo/resources`.
+  /// The store isn't included when the log is compressed.
+  ///
+  /// Besides the changed state of every iteration, the complete state can
+  /// be recorded periodically on `/world/<world name>/state_keyframe`, set
+  /// with `<keyframe_interval>` in seconds of sim time. LogPlayback seeks to
+  /// the closest keyframe instead of replaying the log from the start.
+  ///
+  /// With `<record_diagnostics>` set to true, the slow step reports
+  /// published on `/world/<world name>/diagnostics/slow_step` are recorded,
+  /// see ServerConfig::SetSlowStepThreshold.
+  ///
+  /// With `<buffer_duration>` set, in seconds of sim time, nothing is
+  /// written while recording. The messages of the last buffer duration are
+  /// kept in memory instead, without being serialized, and are written to
+  /// a new `flush_<n>/state.tlog` in the log directory when flushed. A
+  /// flush is triggered by calling `/world/<world name>/record/flush`, and
+  /// with `<flush_on_slow_step>` set to true, by slow step reports, at most
+  /// once per buffer duration. Flushed logs start with a keyframe, so
+  /// keyframes are recorded every buffer duration unless
+  /// `<keyframe_interval>` is set, and up to one keyframe interval more
+  /// than the buffer duration is kept.
   class IGNITION_GAZEBO_VISIBLE LogRecord:
     public System,
     public ISystemConfigure,
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "LogWriter.hh"
+
+#include "LogCompression.hh"
+
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+//////////////////////////////////////////////////
+LogWriter::~LogWriter()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool LogWriter::Open(const std::string &_path)
+{
+  if (this->thread.joinable())
+  {
+    ignerr << "Log writer is already open." << std::endl;
+    return false;
+  }
+
+  if (!this->log.Open(_path, std::ios_base::out))
+  {
+    ignerr << "Failed to open log file [" << _path << "]" << std::endl;
+    return false;
+  }
+
+  this->stop = false;
+  this->thread = std::thread(&LogWriter::Run, this);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void LogWriter::Write(const std::chrono::steady_clock::duration &_time,
+    const std::string &_topic, const std::string &_type, std::string &&_data)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (!this->thread.joinable() || this->stop)
+    return;
+
+  this->queue.push_back({_time, _topic, _type, std::move(_data), nullptr});
+  this->cv.notify_one();
+}
+
+//////////////////////////////////////////////////
+void LogWriter::Write(const std::chrono::steady_clock::duration &_time,
+    const std::string &_topic,
+    std::unique_ptr<google::protobuf::Message> _msg)
+{
+  if (!_msg)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (!this->thread.joinable() || this->stop)
+    return;
+
+  auto type = _msg->GetTypeName();
+  this->queue.push_back({_time, _topic, std::move(type), {}, std::move(_msg)});
+  this->cv.notify_one();
+}
+
+//////////////////////////////////////////////////
+void LogWriter::Close()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->thread.joinable())
+      return;
+    this->stop = true;
+  }
+  this->cv.notify_one();
+  this->thread.join();
+}
+
+//////////////////////////////////////////////////
+void LogWriter::SetCompression(bool _compress)
+{
+  this->compress = _compress;
+}
+
+//////////////////////////////////////////////////
+bool LogWriter::IsOpen() const
+{
+  return this->thread.joinable();
+}
+
+//////////////////////////////////////////////////
+void LogWriter::Run()
+{
+  std::vector<Entry> entries;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->cv.wait(lock, [this]
+      {
+        return this->stop || !this->queue.empty();
+      });
+      if (this->queue.empty())
+        break;
+      std::swap(entries, this->queue);
+    }
+
+    IGN_PROFILE("LogWriter::Run");
+    std::string compressed;
+    std::string compressedType;
+    for (auto &entry : entries)
+    {
+      if (entry.msg)
+      {
+        if (!entry.msg->SerializeToString(&entry.data))
+        {
+          ignerr << "Failed to serialize message of type [" << entry.type
+                 << "] for topic [" << entry.topic << "]" << std::endl;
+          continue;
+        }
+
+        // Compressed one by one, so playback can still query by time
+        if (this->compress && CompressLogMessage(entry.data, entry.type,
+            compressed, compressedType))
+        {
+          std::swap(entry.data, compressed);
+          std::swap(entry.type, compressedType);
+        }
+      }
+
+      if (!this->log.InsertMessage(entry.time, entry.topic, entry.type,
+          entry.data.data(), entry.data.size()))
+      {
+        ignerr << "Failed to record message on topic [" << entry.topic
+               << "]" << std::endl;
+      }
+    }
+    entries.clear();
+  }
+}
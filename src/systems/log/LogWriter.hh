@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_LOG_LOGWRITER_HH_
+#define IGNITION_GAZEBO_SYSTEMS_LOG_LOGWRITER_HH_
+
+#include <google/protobuf/message.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/transport/log/Log.hh>
+
+#include <ignition/gazebo/config.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief Writes messages to an ign-transport log file from a background
+  /// thread, so recording doesn't go through a transport publisher and
+  /// subscriber, and the simulation doesn't wait for the database.
+  ///
+  /// Messages are queued as they're written, and the thread inserts all
+  /// queued messages at once. The log groups consecutive insertions into
+  /// large transactions.
+  class LogWriter
+  {
+    /// \brief Destructor. Writes the remaining messages.
+    public: ~LogWriter();
+
+    /// \brief Create the log file, overwriting it if it exists, and start
+    /// the writing thread.
+    /// \param[in] _path Path of the log file.
+    /// \return True if the file was created.
+    public: bool Open(const std::string &_path);
+
+    /// \brief Queue a serialized message.
+    /// \param[in] _time Time the message is stamped with, usually sim time.
+    /// \param[in] _topic Topic the message is recorded on.
+    /// \param[in] _type Message type name.
+    /// \param[in] _data Serialized message.
+    public: void Write(const std::chrono::steady_clock::duration &_time,
+        const std::string &_topic, const std::string &_type,
+        std::string &&_data);
+
+    /// \brief Queue a message, which is serialized by the writing thread.
+    /// \param[in] _time Time the message is stamped with, usually sim time.
+    /// \param[in] _topic Topic the message is recorded on.
+    /// \param[in] _msg Message, which isn't modified anymore by the caller.
+    public: void Write(const std::chrono::steady_clock::duration &_time,
+        const std::string &_topic,
+        std::unique_ptr<google::protobuf::Message> _msg);
+
+    /// \brief Set whether messages written as message objects are recorded
+    /// compressed, see CompressLogMessage. Serialized messages, which come
+    /// from other nodes, are always recorded as they are.
+    /// \param[in] _compress True to compress.
+    public: void SetCompression(bool _compress);
+
+    /// \brief Write the remaining messages and close the file. Messages
+    /// written afterwards are discarded.
+    public: void Close();
+
+    /// \brief Whether the file is open.
+    /// \return True if open and not closed yet.
+    public: bool IsOpen() const;
+
+    /// \brief Insert queued messages until closed.
+    private: void Run();
+
+    /// \brief Message waiting to be inserted.
+    private: struct Entry
+    {
+      /// \brief Time the message is stamped with.
+      std::chrono::steady_clock::duration time;
+
+      /// \brief Topic the message is recorded on.
+      std::string topic;
+
+      /// \brief Message type name.
+      std::string type;
+
+      /// \brief Serialized message, if already serialized.
+      std::string data;
+
+      /// \brief Message to be serialized, if not serialized yet.
+      std::unique_ptr<google::protobuf::Message> msg;
+    };
+
+    /// \brief Log file written to.
+    private: transport::log::Log log;
+
+    /// \brief Thread inserting the messages.
+    private: std::thread thread;
+
+    /// \brief Protects the queue and the stop flag.
+    private: std::mutex mutex;
+
+    /// \brief Notified when messages are queued or on close.
+    private: std::condition_variable cv;
+
+    /// \brief Messages waiting to be inserted, in order.
+    private: std::vector<Entry> queue;
+
+    /// \brief Set to stop the thread once the queue is empty.
+    private: bool stop{false};
+
+    /// \brief True to compress messages written as message objects.
+    private: std::atomic<bool> compress{false};
+  };
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ResourceStore.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+namespace
+{
+/// \brief First line of a manifest, followed by the store directory.
+const char kStoreLine[] = "store ";
+
+/// \brief Key of some content: its 64 bit hash and its size, so that
+/// colliding hashes of files of different sizes don't share a key.
+/// \param[in] _data Content.
+/// \return Key.
+std::string contentKey(const std::string &_data)
+{
+  std::ostringstream key;
+  key << std::hex << std::setw(16) << std::setfill('0')
+      << common::hash64(_data) << std::dec << "-" << _data.size();
+  return key.str();
+}
+}
+
+//////////////////////////////////////////////////
+ResourceStore::ResourceStore(const std::string &_dir)
+  : dir(_dir)
+{
+}
+
+//////////////////////////////////////////////////
+std::string ResourceStore::DefaultPath()
+{
+  std::string home;
+  common::env(IGN_HOMEDIR, home);
+  return common::joinPaths(home, ".ignition", "gazebo", "resources");
+}
+
+//////////////////////////////////////////////////
+std::string ResourceStore::ManifestPath(const std::string &_logDir)
+{
+  return common::joinPaths(_logDir, "resources.manifest");
+}
+
+//////////////////////////////////////////////////
+bool ResourceStore::AppendManifest(const std::string &_manifest,
+    const std::string &_storeDir, const std::vector<Entry> &_entries)
+{
+  const bool create = !common::exists(_manifest);
+  std::ofstream file(_manifest, std::ios::app);
+  if (!file)
+  {
+    ignerr << "Failed to open resource manifest [" << _manifest << "]"
+           << std::endl;
+    return false;
+  }
+
+  if (create)
+    file << kStoreLine << _storeDir << "\n";
+
+  // Paths may contain spaces, so they take the rest of the line
+  for (const auto &entry : _entries)
+    file << entry.key << " " << entry.path << "\n";
+
+  return static_cast<bool>(file);
+}
+
+//////////////////////////////////////////////////
+bool ResourceStore::ReadManifest(const std::string &_manifest,
+    std::string &_storeDir, std::vector<Entry> &_entries)
+{
+  std::ifstream file(_manifest);
+  std::string line;
+  if (!std::getline(file, line) ||
+      line.compare(0, sizeof(kStoreLine) - 1, kStoreLine) != 0)
+  {
+    ignerr << "Invalid resource manifest [" << _manifest << "]" << std::endl;
+    return false;
+  }
+  _storeDir = line.substr(sizeof(kStoreLine) - 1);
+
+  _entries.clear();
+  while (std::getline(file, line))
+  {
+    const auto space = line.find(' ');
+    if (space == std::string::npos || space == 0 || space + 1 == line.size())
+    {
+      ignwarn << "Skipping invalid line in resource manifest [" << _manifest
+              << "]: " << line << std::endl;
+      continue;
+    }
+    _entries.push_back({line.substr(0, space), line.substr(space + 1)});
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+const std::string &ResourceStore::Dir() const
+{
+  return this->dir;
+}
+
+//////////////////////////////////////////////////
+std::string ResourceStore::Add(const std::string &_data)
+{
+  const std::string key = contentKey(_data);
+  const std::string path = this->FilePath(key);
+  if (common::exists(path))
+    return key;
+
+  if (!common::exists(common::parentPath(path)) &&
+      !common::createDirectories(common::parentPath(path)))
+  {
+    ignerr << "Failed to create directory in resource store ["
+           << this->dir << "]" << std::endl;
+    return "";
+  }
+
+  // Other recorders may be adding the same file, so it's written under a
+  // unique name and renamed, and readers never see a partial file.
+  std::random_device random;
+  const std::string tmpPath = path + ".tmp" + std::to_string(random());
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    file.write(_data.data(), static_cast<std::streamsize>(_data.size()));
+    if (!file)
+    {
+      ignerr << "Failed to write [" << tmpPath << "]" << std::endl;
+      std::remove(tmpPath.c_str());
+      return "";
+    }
+  }
+
+  if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+  {
+    std::remove(tmpPath.c_str());
+    // Renaming onto a file another recorder just added fails on Windows
+    if (!common::exists(path))
+    {
+      ignerr << "Failed to add [" << path << "] to resource store"
+             << std::endl;
+      return "";
+    }
+  }
+  return key;
+}
+
+//////////////////////////////////////////////////
+std::string ResourceStore::AddFile(const std::string &_file)
+{
+  std::ifstream file(_file, std::ios::binary);
+  if (!file)
+  {
+    ignerr << "Failed to read [" << _file << "]" << std::endl;
+    return "";
+  }
+  const std::string data{std::istreambuf_iterator<char>(file),
+      std::istreambuf_iterator<char>()};
+  return this->Add(data);
+}
+
+//////////////////////////////////////////////////
+std::string ResourceStore::FilePath(const std::string &_key) const
+{
+  return common::joinPaths(this->dir, _key.substr(0, 2), _key);
+}
+
+//////////////////////////////////////////////////
+bool ResourceStore::Link(const std::string &_key,
+    const std::string &_dest) const
+{
+  if (common::exists(_dest))
+    return true;
+
+  const std::string src = this->FilePath(_key);
+  if (!common::exists(src))
+  {
+    ignerr << "Resource [" << _key << "] for [" << _dest << "] missing from "
+           << "store [" << this->dir << "]" << std::endl;
+    return false;
+  }
+
+  const std::string parent = common::parentPath(_dest);
+  if (!common::exists(parent) && !common::createDirectories(parent))
+  {
+    ignerr << "Failed to create directory [" << parent << "]" << std::endl;
+    return false;
+  }
+
+#ifndef _WIN32
+  // Linking fails across file systems, where the file is copied instead
+  if (link(src.c_str(), _dest.c_str()) == 0)
+    return true;
+#endif
+
+  return common::copyFile(src, _dest);
+}
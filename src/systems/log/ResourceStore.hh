@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_LOG_RESOURCESTORE_HH_
+#define IGNITION_GAZEBO_SYSTEMS_LOG_RESOURCESTORE_HH_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief Directory of resource files named after their content, shared
+  /// by any number of logs. Each distinct file is stored once, no matter
+  /// how many models or logs use it.
+  ///
+  /// A log refers to the files it uses through a manifest, which maps the
+  /// path each file was recorded from to its key in the store. At playback
+  /// the files are linked back into the log directory, at the paths they
+  /// would have been copied to without a store.
+  class ResourceStore
+  {
+    /// \brief A manifest entry.
+    public: struct Entry
+    {
+      /// \brief Key of the file in the store.
+      std::string key;
+
+      /// \brief Absolute path the file was recorded from.
+      std::string path;
+    };
+
+    /// \brief Constructor.
+    /// \param[in] _dir Directory of the store, created when the first file
+    /// is added.
+    public: explicit ResourceStore(const std::string &_dir);
+
+    /// \brief Store used when none is given,
+    /// `${IGN_HOMEDIR}/.ignition/gazebo/resources`.
+    /// \return Directory of the store.
+    public: static std::string DefaultPath();
+
+    /// \brief Name of the manifest in a log directory.
+    /// \param[in] _logDir Log directory.
+    /// \return Path of the manifest.
+    public: static std::string ManifestPath(const std::string &_logDir);
+
+    /// \brief Append entries to a manifest, creating it if needed.
+    /// \param[in] _manifest Path of the manifest.
+    /// \param[in] _storeDir Store the entries are in, only recorded when the
+    /// manifest is created.
+    /// \param[in] _entries Entries to append.
+    /// \return True if written.
+    public: static bool AppendManifest(const std::string &_manifest,
+        const std::string &_storeDir, const std::vector<Entry> &_entries);
+
+    /// \brief Read a manifest.
+    /// \param[in] _manifest Path of the manifest.
+    /// \param[out] _storeDir Store the entries were recorded in.
+    /// \param[out] _entries Entries of the manifest.
+    /// \return False if the manifest couldn't be read.
+    public: static bool ReadManifest(const std::string &_manifest,
+        std::string &_storeDir, std::vector<Entry> &_entries);
+
+    /// \brief Directory of the store.
+    /// \return Path of the directory.
+    public: const std::string &Dir() const;
+
+    /// \brief Add data to the store, unless it's already there.
+    /// \param[in] _data Content of the file.
+    /// \return Key of the file, empty if it couldn't be written.
+    public: std::string Add(const std::string &_data);
+
+    /// \brief Add a file to the store, unless it's already there.
+    /// \param[in] _file Path of the file.
+    /// \return Key of the file, empty if it couldn't be read or written.
+    public: std::string AddFile(const std::string &_file);
+
+    /// \brief Path of a file in the store.
+    /// \param[in] _key Key of the file.
+    /// \return Path of the file.
+    public: std::string FilePath(const std::string &_key) const;
+
+    /// \brief Make a stored file available at a path, through a hard link
+    /// when possible and a copy otherwise. Existing files are kept.
+    /// \param[in] _key Key of the file.
+    /// \param[in] _dest Path to make the file available at.
+    /// \return True if the file is available at the path.
+    public: bool Link(const std::string &_key, const std::string &_dest) const;
+
+    /// \brief Directory of the store.
+    private: std::string dir;
+  };
+}
+}
+}
+}
+
+#endif
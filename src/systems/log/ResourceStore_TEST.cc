@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+
+#include "ResourceStore.hh"
+
+using namespace ignition;
+using namespace gazebo::systems;
+
+/// \brief Read a whole file.
+/// \param[in] _path Path of the file.
+/// \return Content of the file.
+static std::string readFile(const std::string &_path)
+{
+  std::ifstream file(_path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file),
+      std::istreambuf_iterator<char>()};
+}
+
+/////////////////////////////////////////////////
+TEST(ResourceStore, AddLink)
+{
+  const std::string dir = common::absPath("ResourceStore_TEST");
+  common::removeAll(dir);
+  ResourceStore store(common::joinPaths(dir, "store"));
+
+  // Same content, same key, stored once
+  const std::string mesh(1000, 'm');
+  const auto key = store.Add(mesh);
+  ASSERT_FALSE(key.empty());
+  EXPECT_EQ(key, store.Add(mesh));
+  EXPECT_EQ(mesh, readFile(store.FilePath(key)));
+
+  const auto otherKey = store.Add(mesh + "m");
+  EXPECT_NE(key, otherKey);
+
+  const std::string srcFile = common::joinPaths(dir, "src.dae");
+  {
+    std::ofstream file(srcFile, std::ios::binary);
+    file << mesh;
+  }
+  EXPECT_EQ(key, store.AddFile(srcFile));
+  EXPECT_TRUE(store.AddFile(common::joinPaths(dir, "missing")).empty());
+
+  const std::string dest = common::joinPaths(dir, "log", "model", "a.dae");
+  EXPECT_TRUE(store.Link(key, dest));
+  EXPECT_EQ(mesh, readFile(dest));
+
+  // Existing files are kept
+  EXPECT_TRUE(store.Link(otherKey, dest));
+  EXPECT_EQ(mesh, readFile(dest));
+
+  EXPECT_FALSE(store.Link("0000000000000000-1",
+      common::joinPaths(dir, "log", "b.dae")));
+
+  common::removeAll(dir);
+}
+
+/////////////////////////////////////////////////
+TEST(ResourceStore, Manifest)
+{
+  const std::string dir = common::absPath("ResourceStore_TEST_manifest");
+  common::removeAll(dir);
+  common::createDirectories(dir);
+
+  const auto manifest = ResourceStore::ManifestPath(dir);
+  std::string storeDir;
+  std::vector<ResourceStore::Entry> entries;
+  EXPECT_FALSE(ResourceStore::ReadManifest(manifest, storeDir, entries));
+
+  EXPECT_TRUE(ResourceStore::AppendManifest(manifest, "/store",
+      {{"a-1", "/models/box/model.sdf"}}));
+  EXPECT_TRUE(ResourceStore::AppendManifest(manifest, "/ignored",
+      {{"b-2", "/models/box/meshes/with space.dae"}}));
+
+  ASSERT_TRUE(ResourceStore::ReadManifest(manifest, storeDir, entries));
+  EXPECT_EQ("/store", storeDir);
+  ASSERT_EQ(2u, entries.size());
+  EXPECT_EQ("a-1", entries[0].key);
+  EXPECT_EQ("/models/box/model.sdf", entries[0].path);
+  EXPECT_EQ("b-2", entries[1].key);
+  EXPECT_EQ("/models/box/meshes/with space.dae", entries[1].path);
+
+  common::removeAll(dir);
+}
@@ -19,8 +19,11 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cmath>
+#include <limits>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace ignition
 {
@@ -99,6 +102,96 @@ namespace logical_audio
     return (m * (dist - _innerRadius)) + _sourceEmissionVolume;
   }
 
+  //////////////////////////////////////////////////
+  void addSource(SourceBatch &_batch, bool _playing, const Source &_source,
+      const ignition::math::Vector3d &_sourcePos)
+  {
+    double emissionVolume = _source.emissionVolume;
+    double innerRadius = _source.innerRadius;
+    double falloffDistance = _source.falloffDistance;
+
+    // Fold the early returns of computeVolume into the attributes, so that
+    // computeVolumes doesn't need to branch per source
+    if (!_playing)
+    {
+      emissionVolume = 0.0;
+    }
+    else if ((_source.attFunc == AttenuationFunction::UNDEFINED) ||
+        (_source.attShape == AttenuationShape::UNDEFINED))
+    {
+      // every target is inside of the inner radius, so -1 is returned
+      emissionVolume = -1.0;
+      innerRadius = std::numeric_limits<double>::infinity();
+      falloffDistance = std::numeric_limits<double>::infinity();
+    }
+    else if (emissionVolume < 0.00001)
+    {
+      emissionVolume = 0.0;
+    }
+
+    double slope = 0.0;
+    if (emissionVolume > 0.0)
+      slope = -emissionVolume / (falloffDistance - innerRadius);
+
+    _batch.x.push_back(_sourcePos.X());
+    _batch.y.push_back(_sourcePos.Y());
+    _batch.z.push_back(_sourcePos.Z());
+    _batch.emissionVolume.push_back(emissionVolume);
+    _batch.innerRadius.push_back(innerRadius);
+    _batch.falloffDistance.push_back(falloffDistance);
+    _batch.slope.push_back(slope);
+  }
+
+  //////////////////////////////////////////////////
+  void clearSources(SourceBatch &_batch)
+  {
+    _batch.x.clear();
+    _batch.y.clear();
+    _batch.z.clear();
+    _batch.emissionVolume.clear();
+    _batch.innerRadius.clear();
+    _batch.falloffDistance.clear();
+    _batch.slope.clear();
+  }
+
+  //////////////////////////////////////////////////
+  void computeVolumes(const SourceBatch &_batch,
+      const ignition::math::Vector3d &_targetPos,
+      std::vector<double> &_volumes)
+  {
+    const std::size_t count = _batch.x.size();
+    _volumes.resize(count);
+
+    const double tx = _targetPos.X();
+    const double ty = _targetPos.Y();
+    const double tz = _targetPos.Z();
+
+    const double *x = _batch.x.data();
+    const double *y = _batch.y.data();
+    const double *z = _batch.z.data();
+    const double *emission = _batch.emissionVolume.data();
+    const double *inner = _batch.innerRadius.data();
+    const double *falloff = _batch.falloffDistance.data();
+    const double *slope = _batch.slope.data();
+    double *volumes = _volumes.data();
+
+    // Same arithmetic as computeVolume, written with selects instead of
+    // branches so the loop vectorizes
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      const double dx = x[i] - tx;
+      const double dy = y[i] - ty;
+      const double dz = z[i] - tz;
+      const double dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+      const double e = emission[i];
+      const double r = inner[i];
+      const double linear = (slope[i] * (dist - r)) + e;
+      const double outer = dist >= falloff[i] ? 0.0 : linear;
+      volumes[i] = dist <= r ? e : outer;
+    }
+  }
+
   //////////////////////////////////////////////////
   void setAttenuationFunction(AttenuationFunction &_attenuationFunc,
       std::string _str)
@@ -18,10 +18,12 @@
 #define IGNITION_GAZEBO_SYSTEMS_LOGICAL_AUDIO_SENSOR_PLUGIN_LOGICALAUDIO_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/gazebo/components/LogicalAudio.hh>
 #include <ignition/gazebo/config.hh>
 #include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
 
 namespace ignition
 {
@@ -70,6 +72,61 @@ namespace logical_audio
       const ignition::math::Pose3d &_sourcePose,
       const ignition::math::Pose3d &_targetPose);
 
+  /// \brief A set of audio sources stored as one array per attribute, so
+  /// that the volume of every source at a location can be computed in a
+  /// single loop the compiler can vectorize.
+  /// Sources are added with logical_audio::addSource, which folds the
+  /// playing state and the source's validity into the stored attributes.
+  struct SourceBatch
+  {
+    /// \brief X coordinate of each source's position
+    std::vector<double> x;
+
+    /// \brief Y coordinate of each source's position
+    std::vector<double> y;
+
+    /// \brief Z coordinate of each source's position
+    std::vector<double> z;
+
+    /// \brief The volume of each source inside of its inner radius
+    std::vector<double> emissionVolume;
+
+    /// \brief Each source's inner radius
+    std::vector<double> innerRadius;
+
+    /// \brief Each source's falloff distance
+    std::vector<double> falloffDistance;
+
+    /// \brief Change in volume per unit of distance between the inner
+    /// radius and the falloff distance
+    std::vector<double> slope;
+  };
+
+  /// \brief Add an audio source to a batch.
+  /// \param[in,out] _batch The batch to add the source to.
+  /// \param[in] _playing Whether the audio source is playing or not.
+  /// \param[in] _source The source's attributes. These should have been
+  /// validated, see logical_audio::computeVolume.
+  /// \param[in] _sourcePos The source's world position.
+  void addSource(SourceBatch &_batch, bool _playing, const Source &_source,
+      const ignition::math::Vector3d &_sourcePos);
+
+  /// \brief Remove all sources from a batch, keeping its storage.
+  /// \param[in,out] _batch The batch to clear.
+  void clearSources(SourceBatch &_batch);
+
+  /// \brief Computes the volume level of every source in a batch at a
+  /// certain location. The result for each source is the same as
+  /// logical_audio::computeVolume.
+  /// \param[in] _batch The sources.
+  /// \param[in] _targetPos The position where the volume levels should be
+  /// calculated.
+  /// \param[out] _volumes The volume level of each source, in the order the
+  /// sources were added to _batch.
+  void computeVolumes(const SourceBatch &_batch,
+      const ignition::math::Vector3d &_targetPos,
+      std::vector<double> &_volumes);
+
   /// \brief Set the attenuation function that matches the defined string.
   /// The string is not case sensitive, and must match the spelling
   /// of the values in AttenuationFunction. If the spelling does not match,
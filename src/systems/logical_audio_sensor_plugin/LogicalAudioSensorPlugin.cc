@@ -24,6 +24,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include <ignition/gazebo/components/LogicalAudio.hh>
 #include <ignition/gazebo/components/Model.hh>
@@ -106,6 +107,20 @@ class ignition::gazebo::systems::LogicalAudioSensorPluginPrivate
   /// \brief A mutex used to ensure that the stop source service call does
   /// not interfere with the source's state in the PreUpdate step.
   public: std::mutex stopSourceMutex;
+
+  /// \brief Attributes of all sources in the current step. Kept between
+  /// steps to reuse its storage.
+  public: logical_audio::SourceBatch sources;
+
+  /// \brief The entity of each source in the batch
+  public: std::vector<Entity> sourceEntityList;
+
+  /// \brief Scoped name of each source, only filled in once a source is
+  /// detected
+  public: std::vector<std::string> sourceNames;
+
+  /// \brief Volume of each source at the current microphone
+  public: std::vector<double> volumes;
 };
 
 //////////////////////////////////////////////////
@@ -212,48 +227,63 @@ void LogicalAudioSensorPlugin::PostUpdate(const UpdateInfo &_info,
     std::chrono::duration_cast<std::chrono::nanoseconds>(_info.simTime);
   const auto nanosecondOffset = (simNanoseconds - simSeconds).count();
 
+  if (this->dataPtr->micEntities.empty())
+    return;
+
+  // Source poses don't depend on the microphone, so they're computed once
+  // per step instead of once per microphone
+  auto &sources = this->dataPtr->sources;
+  logical_audio::clearSources(sources);
+  this->dataPtr->sourceEntityList.clear();
+  _ecm.Each<components::LogicalAudioSource,
+            components::LogicalAudioSourcePlayInfo>(
+    [&](const Entity &_entity,
+        const components::LogicalAudioSource *_source,
+        const components::LogicalAudioSourcePlayInfo *_playInfo)
+    {
+      logical_audio::addSource(sources, _playInfo->Data().playing,
+          _source->Data(), worldPose(_entity, _ecm).Pos());
+      this->dataPtr->sourceEntityList.push_back(_entity);
+      return true;
+    });
+
+  const auto &sourceEntityList = this->dataPtr->sourceEntityList;
+  auto &sourceNames = this->dataPtr->sourceNames;
+  auto &volumes = this->dataPtr->volumes;
+  sourceNames.assign(sourceEntityList.size(), std::string());
+
   for (auto & [micEntity, detectionPub] : this->dataPtr->micEntities)
   {
     const auto micPose = worldPose(micEntity, _ecm);
-    const auto micInfo = _ecm.Component<components::LogicalMicrophone>(
+    const auto &micInfo = _ecm.Component<components::LogicalMicrophone>(
         micEntity)->Data();
 
-    _ecm.Each<components::LogicalAudioSource,
-              components::LogicalAudioSourcePlayInfo>(
-      [&, &publisher = detectionPub](const Entity &_entity,
-          const components::LogicalAudioSource *_source,
-          const components::LogicalAudioSourcePlayInfo *_playInfo)
+    logical_audio::computeVolumes(sources, micPose.Pos(), volumes);
+
+    for (std::size_t i = 0; i < volumes.size(); ++i)
+    {
+      const auto vol = volumes[i];
+      if (logical_audio::detect(vol, micInfo.volumeDetectionThreshold))
       {
-        const auto sourcePose = worldPose(_entity, _ecm);
-        const auto vol = logical_audio::computeVolume(
-            _playInfo->Data().playing,
-            _source->Data().attFunc,
-            _source->Data().attShape,
-            _source->Data().emissionVolume,
-            _source->Data().innerRadius,
-            _source->Data().falloffDistance,
-            sourcePose,
-            micPose);
-
-        if (logical_audio::detect(vol, micInfo.volumeDetectionThreshold))
-        {
-          // publish the source that the microphone heard, along with the
-          // volume level the microphone detected. The detected source's
-          // ID is embedded in the message's header
-          ignition::msgs::Double msg;
-          auto header = msg.mutable_header();
-          auto timeStamp = header->mutable_stamp();
-          timeStamp->set_sec(simSeconds.count());
-          timeStamp->set_nsec(nanosecondOffset);
-          auto headerData = header->add_data();
-          headerData->set_key(scopedName(_entity, _ecm));
-          msg.set_data(vol);
-
-          publisher.Publish(msg);
-        }
-
-        return true;
-      });
+        // publish the source that the microphone heard, along with the
+        // volume level the microphone detected. The detected source's
+        // ID is embedded in the message's header
+        auto &sourceName = sourceNames[i];
+        if (sourceName.empty())
+          sourceName = scopedName(sourceEntityList[i], _ecm);
+
+        ignition::msgs::Double msg;
+        auto header = msg.mutable_header();
+        auto timeStamp = header->mutable_stamp();
+        timeStamp->set_sec(simSeconds.count());
+        timeStamp->set_nsec(nanosecondOffset);
+        auto headerData = header->add_data();
+        headerData->set_key(sourceName);
+        msg.set_data(vol);
+
+        detectionPub.Publish(msg);
+      }
+    }
   }
 }
 
@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "LogicalAudio.hh"
 
 namespace logical_audio = ignition::gazebo::logical_audio;
@@ -181,6 +183,69 @@ TEST(LogicalAudioTest, ComputeVolume)
         {20.0, 20.0, 20.0, 0.0, 0.0, 0.0}));
 }
 
+//////////////////////////////////////////////////
+TEST(LogicalAudioTest, ComputeVolumes)
+{
+  std::vector<logical_audio::Source> sources(6);
+  sources[0] = {0u, AttenuationFunction::LINEAR, AttenuationShape::SPHERE,
+      1.0, 5.0, 1.0};
+  sources[1] = {1u, AttenuationFunction::LINEAR, AttenuationShape::SPHERE,
+      0.0, 10.0, 0.5};
+  sources[2] = {2u, AttenuationFunction::LINEAR, AttenuationShape::SPHERE,
+      4.0, 5.0, 0.3};
+  sources[3] = {3u, AttenuationFunction::UNDEFINED, AttenuationShape::SPHERE,
+      1.0, 5.0, 1.0};
+  sources[4] = {4u, AttenuationFunction::LINEAR, AttenuationShape::UNDEFINED,
+      1.0, 5.0, 1.0};
+  sources[5] = {5u, AttenuationFunction::LINEAR, AttenuationShape::SPHERE,
+      1.0, 5.0, 0.0};
+
+  const std::vector<ignition::math::Pose3d> sourcePoses{
+      {0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+      {1.0, 2.0, 0.0, 0.0, 0.0, 0.0},
+      {-3.0, 0.0, 1.0, 0.0, 0.0, 0.0},
+      {0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+      {0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+      {0.0, 0.0, 0.0, 0.0, 0.0, 0.0}};
+
+  const std::vector<ignition::math::Pose3d> targetPoses{
+      {0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+      {1.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+      {3.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+      {0.0, 4.5, 3.0, 0.0, 0.0, 0.0},
+      {5.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+      {20.0, 20.0, 20.0, 0.0, 0.0, 0.0}};
+
+  // the batch should match computeVolume for playing and stopped sources
+  for (const bool playing : {true, false})
+  {
+    logical_audio::SourceBatch batch;
+    for (std::size_t i = 0; i < sources.size(); ++i)
+      logical_audio::addSource(batch, playing, sources[i],
+          sourcePoses[i].Pos());
+
+    std::vector<double> volumes;
+    for (const auto &targetPose : targetPoses)
+    {
+      logical_audio::computeVolumes(batch, targetPose.Pos(), volumes);
+      ASSERT_EQ(sources.size(), volumes.size());
+      for (std::size_t i = 0; i < sources.size(); ++i)
+      {
+        EXPECT_DOUBLE_EQ(
+            logical_audio::computeVolume(playing, sources[i].attFunc,
+              sources[i].attShape, sources[i].emissionVolume,
+              sources[i].innerRadius, sources[i].falloffDistance,
+              sourcePoses[i], targetPose),
+            volumes[i]) << "source " << i << ", target " << targetPose;
+      }
+    }
+
+    logical_audio::clearSources(batch);
+    logical_audio::computeVolumes(batch, targetPoses[0].Pos(), volumes);
+    EXPECT_TRUE(volumes.empty());
+  }
+}
+
 //////////////////////////////////////////////////
 TEST(LogicalAudioTest, AttenuationSetters)
 {
@@ -23,12 +23,14 @@
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <ignition/common/Profiler.hh>
 #include <ignition/plugin/Register.hh>
 
 #include <sdf/Sensor.hh>
 
+#include <ignition/math/Frustum.hh>
 #include <ignition/math/Helpers.hh>
 #include <ignition/transport/Node.hh>
 
@@ -37,12 +39,12 @@
 
 #include "ignition/gazebo/components/LogicalCamera.hh"
 #include "ignition/gazebo/components/Name.hh"
-#include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/ParentEntity.hh"
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/Sensor.hh"
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/SpatialIndex.hh"
 #include "ignition/gazebo/Util.hh"
 
 using namespace ignition;
@@ -64,8 +66,10 @@ class ignition::gazebo::systems::LogicalCameraPrivate
   public: void CreateLogicalCameraEntities(EntityComponentManager &_ecm);
 
   /// \brief Update logicalCamera sensor data based on physics data
+  /// \param[in] _info Current update info.
   /// \param[in] _ecm Immutable reference to ECM.
-  public: void UpdateLogicalCameras(const EntityComponentManager &_ecm);
+  public: void UpdateLogicalCameras(const UpdateInfo &_info,
+      const EntityComponentManager &_ecm);
 
   /// \brief Remove logicalCamera sensors if their entities have been removed
   /// from simulation.
@@ -107,7 +111,7 @@ void LogicalCamera::PostUpdate(const UpdateInfo &_info,
   // Only update and publish if not paused.
   if (!_info.paused)
   {
-    this->dataPtr->UpdateLogicalCameras(_ecm);
+    this->dataPtr->UpdateLogicalCameras(_info, _ecm);
 
     for (auto &it : this->dataPtr->entitySensorMap)
     {
@@ -173,24 +177,12 @@ void LogicalCameraPrivate::CreateLogicalCameraEntities(
 }
 
 //////////////////////////////////////////////////
-void LogicalCameraPrivate::UpdateLogicalCameras(
+void LogicalCameraPrivate::UpdateLogicalCameras(const UpdateInfo &_info,
     const EntityComponentManager &_ecm)
 {
   IGN_PROFILE("LogicalCameraPrivate::UpdateLogicalCameras");
-  std::map<std::string, math::Pose3d> modelPoses;
-
-  _ecm.Each<components::Model, components::Name, components::Pose>(
-      [&](const Entity &,
-        const components::Model *,
-        const components::Name *_name,
-        const components::Pose *_pose)->bool
-      {
-        /// todo(anyone) We currently assume there are only top level models
-        /// Update to retrieve world pose when nested models are supported.
-        modelPoses[_name->Data()] = _pose->Data();
-        return true;
-      });
-
+  std::shared_ptr<const SpatialIndex> index;
+  std::vector<Entity> models;
 
   _ecm.Each<components::LogicalCamera, components::WorldPose>(
     [&](const Entity &_entity,
@@ -200,11 +192,32 @@ void LogicalCameraPrivate::UpdateLogicalCameras(
         auto it = this->entitySensorMap.find(_entity);
         if (it != this->entitySensorMap.end())
         {
+          // The models are only needed on the steps the camera publishes
+          if (it->second->NextDataUpdateTime() > _info.simTime)
+            return true;
+
+          if (!index)
+            index = SpatialIndex::Shared(_info, _ecm);
+
           const math::Pose3d &worldPose = _worldPose->Data();
           it->second->SetPose(worldPose);
-          // Make a copy of modelPoses s.t. SetModelPoses can take ownership
-          auto modelPoses_ = modelPoses;
-          it->second->SetModelPoses(std::move(modelPoses_));
+
+          // Only pass the top level models which may be in view, the sensor
+          // does the exact test
+          math::Frustum frustum(it->second->Near(), it->second->Far(),
+              it->second->HorizontalFOV(), it->second->AspectRatio(),
+              worldPose);
+          index->Query(SpatialIndex::Layer::MODELS, frustum, models);
+
+          std::map<std::string, math::Pose3d> modelPoses;
+          for (const Entity model : models)
+          {
+            auto name = _ecm.Component<components::Name>(model);
+            auto pose = _ecm.Component<components::Pose>(model);
+            if (nullptr != name && nullptr != pose)
+              modelPoses[name->Data()] = pose->Data();
+          }
+          it->second->SetModelPoses(std::move(modelPoses));
         }
         else
         {
@@ -37,6 +37,7 @@
 #include "ignition/gazebo/components/Inertial.hh"
 #include "ignition/gazebo/components/Link.hh"
 #include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/TwistCmd.hh"
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/Link.hh"
 #include "ignition/gazebo/Model.hh"
@@ -360,7 +361,15 @@ void MulticopterVelocityControl::PreUpdate(
     return;
   }
 
-  EigenTwist cmdVel;
+  math::Vector3d linear;
+  math::Vector3d angular;
+  auto twistCmd = _ecm.Component<components::TwistCmd>(this->model.Entity());
+  if (twistCmd)
+  {
+    linear = msgs::Convert(twistCmd->Data().linear());
+    angular = msgs::Convert(twistCmd->Data().angular());
+  }
+  else
   {
     std::lock_guard<std::mutex> lock(this->cmdVelMsgMutex);
     if (!this->cmdVelMsg.has_value())
@@ -368,18 +377,20 @@ void MulticopterVelocityControl::PreUpdate(
       return;
     }
 
-    // Clip with max linear velocity
-    math::Vector3d linear = msgs::Convert(this->cmdVelMsg->linear());
-    linear.Min(this->maximumLinearVelocity);
-    linear.Max(-this->maximumLinearVelocity);
+    linear = msgs::Convert(this->cmdVelMsg->linear());
+    angular = msgs::Convert(this->cmdVelMsg->angular());
+  }
 
-    math::Vector3d angular = msgs::Convert(this->cmdVelMsg->angular());
-    angular.Min(this->maximumAngularVelocity);
-    angular.Max(-this->maximumAngularVelocity);
+  // Clip with max linear velocity
+  linear.Min(this->maximumLinearVelocity);
+  linear.Max(-this->maximumLinearVelocity);
 
-    cmdVel.linear = math::eigen3::convert(linear);
-    cmdVel.angular = math::eigen3::convert(angular);
-  }
+  angular.Min(this->maximumAngularVelocity);
+  angular.Max(-this->maximumAngularVelocity);
+
+  EigenTwist cmdVel;
+  cmdVel.linear = math::eigen3::convert(linear);
+  cmdVel.angular = math::eigen3::convert(angular);
 
   std::optional<FrameData> frameData =
       getFrameData(_ecm, this->comLinkEntity, this->noiseParameters);
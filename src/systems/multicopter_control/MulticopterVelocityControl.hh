@@ -49,6 +49,9 @@ namespace systems
   /// system on each rotor. Note also that only one MulticopterVelocityControl
   /// system is allowed per model.
   ///
+  /// Velocity commands can also be written to a TwistCmd component on the
+  /// model, see components::TwistCmd.
+  ///
   /// This system is inspired by the LeePositionController from RotorS
   /// https://github.com/ethz-asl/rotors_simulator/blob/master/rotors_control/include/rotors_control/lee_position_controller.h
   /// Instead of subscribing to odometry messages, this system uses ground truth
@@ -23,8 +23,11 @@
 
 #include "MulticopterMotorModel.hh"
 
+#include <algorithm>
 #include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <ignition/common/Profiler.hh>
 
@@ -115,44 +118,27 @@ enum class MotorType {
   kForce
 };
 
-class ignition::gazebo::systems::MulticopterMotorModelPrivate
+/// \brief Parameters and state of a single rotor.
+class MulticopterRotor
 {
-  /// \brief Callback for actuator commands.
-  public: void OnActuatorMsg(const ignition::msgs::Actuators &_msg);
-
-  /// \brief Apply link forces and moments based on propeller state.
-  public: void UpdateForcesAndMoments(EntityComponentManager &_ecm);
-
   /// \brief Joint Entity
-  public: Entity jointEntity;
+  public: Entity jointEntity{kNullEntity};
 
   /// \brief Joint name
   public: std::string jointName;
 
   /// \brief Link Entity
-  public: Entity linkEntity;
+  public: Entity linkEntity{kNullEntity};
 
   /// \brief Link name
   public: std::string linkName;
 
   /// \brief Parent link Entity
-  public: Entity parentLinkEntity;
+  public: Entity parentLinkEntity{kNullEntity};
 
   /// \brief Parent link name
   public: std::string parentLinkName;
 
-  /// \brief Model interface
-  public: Model model{kNullEntity};
-
-  /// \brief Topic for actuator commands.
-  public: std::string commandSubTopic;
-
-  /// \brief Topic namespace.
-  public: std::string robotNamespace;
-
-  /// \brief Sampling time (from motor_model.hpp).
-  public: double samplingTime = 0.01;
-
   /// \brief Index of motor on multirotor_base.
   public: int motorNumber = 0;
 
@@ -205,7 +191,72 @@ class ignition::gazebo::systems::MulticopterMotorModelPrivate
 
   /// \brief Filter on rotor velocity that has different time constants
   /// for increasing and decreasing values.
-  public: std::unique_ptr<FirstOrderFilter<double>> rotorVelocityFilter;
+  public: FirstOrderFilter<double> rotorVelocityFilter{
+      this->timeConstantUp, this->timeConstantDown, this->refMotorInput};
+};
+
+class ignition::gazebo::systems::MulticopterMotorModelPrivate
+{
+  /// \brief Load the rotors from SDF. Each <rotor> element starts from the
+  /// parameters at the top level. If there are no <rotor> elements, the top
+  /// level describes a single rotor.
+  /// \param[in] _sdf The SDF element of the plugin.
+  /// \return True if at least one valid rotor was loaded.
+  public: bool Load(const sdf::ElementPtr &_sdf);
+
+  /// \brief Load the parameters of one rotor, keeping the current values
+  /// of those that are not set.
+  /// \param[in] _sdf SDF element holding the parameters.
+  /// \param[in, out] _rotor Rotor to load into.
+  public: static void LoadRotor(const sdf::ElementPtr &_sdf,
+                                MulticopterRotor &_rotor);
+
+  /// \brief Look for the entities of a rotor that haven't been found yet.
+  /// \param[in] _ecm Immutable reference to the EntityComponentManager.
+  /// \param[in, out] _rotor Rotor whose entities are looked up.
+  /// \return True if all the entities of the rotor have been found.
+  public: bool FindRotorEntities(const EntityComponentManager &_ecm,
+                                 MulticopterRotor &_rotor) const;
+
+  /// \brief Callback for actuator commands.
+  public: void OnActuatorMsg(const ignition::msgs::Actuators &_msg);
+
+  /// \brief Apply link forces and moments based on propeller state.
+  public: void UpdateForcesAndMoments(EntityComponentManager &_ecm);
+
+  /// \brief Compute the forces and moments of one velocity controlled rotor
+  /// and update its joint velocity command.
+  /// \param[in] _ecm Mutable reference to the EntityComponentManager.
+  /// \param[in] _windSpeedWorld Wind velocity in the world frame.
+  /// \param[in, out] _rotor The rotor.
+  /// \param[out] _force Force on the rotor link, applied at its center of
+  /// mass, in the world frame.
+  /// \param[out] _parentTorque Torque on the parent link, in the world frame.
+  /// \return False if the rotor is missing components.
+  public: bool UpdateRotor(EntityComponentManager &_ecm,
+                           const math::Vector3d &_windSpeedWorld,
+                           MulticopterRotor &_rotor,
+                           math::Vector3d &_force,
+                           math::Vector3d &_parentTorque);
+
+  /// \brief Rotors handled by this system.
+  public: std::vector<MulticopterRotor> rotors;
+
+  /// \brief Torques accumulated on each parent link in the current step, so
+  /// that each parent link gets a single wrench update.
+  public: std::vector<std::pair<Entity, math::Vector3d>> parentTorques;
+
+  /// \brief Model interface
+  public: Model model{kNullEntity};
+
+  /// \brief Topic for actuator commands.
+  public: std::string commandSubTopic;
+
+  /// \brief Topic namespace.
+  public: std::string robotNamespace;
+
+  /// \brief Sampling time (from motor_model.hpp).
+  public: double samplingTime = 0.01;
 
   /// \brief Received Actuators message. This is nullopt if no message has been
   /// received.
@@ -253,66 +304,119 @@ void MulticopterMotorModel::Configure(const Entity &_entity,
     ignerr << "Please specify a robotNamespace.\n";
   }
 
-  // Get params from SDF
-  if (sdfClone->HasElement("jointName"))
-  {
-    this->dataPtr->jointName = sdfClone->Get<std::string>("jointName");
-  }
+  sdfClone->Get<std::string>("commandSubTopic",
+      this->dataPtr->commandSubTopic, this->dataPtr->commandSubTopic);
 
-  if (this->dataPtr->jointName.empty())
+  if (!this->dataPtr->Load(sdfClone))
+    return;
+
+  // Subscribe to actuator command messages. All rotors share a single
+  // subscription.
+  std::string topic = transport::TopicUtils::AsValidTopic(
+      this->dataPtr->robotNamespace + "/" + this->dataPtr->commandSubTopic);
+  if (topic.empty())
   {
-    ignerr << "MulticopterMotorModel found an empty jointName parameter. "
-           << "Failed to initialize.";
+    ignerr << "Failed to create topic for [" << this->dataPtr->robotNamespace
+           << "]" << std::endl;
     return;
   }
+  this->dataPtr->node.Subscribe(topic,
+      &MulticopterMotorModelPrivate::OnActuatorMsg, this->dataPtr.get());
+}
 
-  if (sdfClone->HasElement("linkName"))
+//////////////////////////////////////////////////
+bool MulticopterMotorModelPrivate::Load(const sdf::ElementPtr &_sdf)
+{
+  // Parameters at the top level are the defaults of all rotors
+  MulticopterRotor defaults;
+  LoadRotor(_sdf, defaults);
+
+  std::vector<MulticopterRotor> loaded;
+  if (_sdf->HasElement("rotor"))
+  {
+    for (auto rotorElem = _sdf->GetElement("rotor"); rotorElem;
+         rotorElem = rotorElem->GetNextElement("rotor"))
+    {
+      MulticopterRotor rotor = defaults;
+      LoadRotor(rotorElem, rotor);
+      loaded.push_back(rotor);
+    }
+  }
+  else
   {
-    this->dataPtr->linkName = sdfClone->Get<std::string>("linkName");
+    loaded.push_back(defaults);
   }
 
-  if (this->dataPtr->linkName.empty())
+  for (auto &rotor : loaded)
   {
-    ignerr << "MulticopterMotorModel found an empty linkName parameter. "
-           << "Failed to initialize.";
-    return;
+    if (rotor.jointName.empty())
+    {
+      ignerr << "MulticopterMotorModel found an empty jointName parameter. "
+             << "Failed to initialize.";
+      return false;
+    }
+
+    if (rotor.linkName.empty())
+    {
+      ignerr << "MulticopterMotorModel found an empty linkName parameter. "
+             << "Failed to initialize.";
+      return false;
+    }
+
+    // Create the first order filter.
+    rotor.rotorVelocityFilter = FirstOrderFilter<double>(
+        rotor.timeConstantUp, rotor.timeConstantDown, rotor.refMotorInput);
   }
 
-  if (sdfClone->HasElement("motorNumber"))
-    this->dataPtr->motorNumber =
-      sdfClone->GetElement("motorNumber")->Get<int>();
-  else
+  this->rotors = std::move(loaded);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void MulticopterMotorModelPrivate::LoadRotor(const sdf::ElementPtr &_sdf,
+    MulticopterRotor &_rotor)
+{
+  // Rotor elements only need to set the parameters that differ from the top
+  // level, so missing parameters are only reported at the top level.
+  const bool topLevel = _sdf->GetName() != "rotor";
+
+  _sdf->Get<std::string>("jointName", _rotor.jointName, _rotor.jointName);
+  _sdf->Get<std::string>("linkName", _rotor.linkName, _rotor.linkName);
+
+  if (_sdf->HasElement("motorNumber"))
+    _rotor.motorNumber = _sdf->GetElement("motorNumber")->Get<int>();
+  else if (topLevel && !_sdf->HasElement("rotor"))
     ignerr << "Please specify a motorNumber.\n";
 
-  if (sdfClone->HasElement("turningDirection"))
+  if (_sdf->HasElement("turningDirection"))
   {
     auto turningDirection =
-        sdfClone->GetElement("turningDirection")->Get<std::string>();
+        _sdf->GetElement("turningDirection")->Get<std::string>();
     if (turningDirection == "cw")
-      this->dataPtr->turningDirection = turning_direction::kCw;
+      _rotor.turningDirection = turning_direction::kCw;
     else if (turningDirection == "ccw")
-      this->dataPtr->turningDirection = turning_direction::kCcw;
+      _rotor.turningDirection = turning_direction::kCcw;
     else
       ignerr << "Please only use 'cw' or 'ccw' as turningDirection.\n";
   }
-  else
+  else if (topLevel && !_sdf->HasElement("rotor"))
   {
     ignerr << "Please specify a turning direction ('cw' or 'ccw').\n";
   }
 
-  if (sdfClone->HasElement("motorType"))
+  if (_sdf->HasElement("motorType"))
   {
-    auto motorType = sdfClone->GetElement("motorType")->Get<std::string>();
+    auto motorType = _sdf->GetElement("motorType")->Get<std::string>();
     if (motorType == "velocity")
-      this->dataPtr->motorType = MotorType::kVelocity;
+      _rotor.motorType = MotorType::kVelocity;
     else if (motorType == "position")
     {
-      this->dataPtr->motorType = MotorType::kPosition;
+      _rotor.motorType = MotorType::kPosition;
       ignerr << "motorType 'position' not supported" << std::endl;
     }
     else if (motorType == "force")
     {
-      this->dataPtr->motorType = MotorType::kForce;
+      _rotor.motorType = MotorType::kForce;
       ignerr << "motorType 'force' not supported" << std::endl;
     }
     else
@@ -321,52 +425,60 @@ void MulticopterMotorModel::Configure(const Entity &_entity,
                "'force' as motorType.\n";
     }
   }
-  else
+  else if (topLevel)
   {
     ignwarn << "motorType not specified, using velocity.\n";
-    this->dataPtr->motorType = MotorType::kVelocity;
+    _rotor.motorType = MotorType::kVelocity;
   }
 
-  sdfClone->Get<std::string>("commandSubTopic",
-      this->dataPtr->commandSubTopic, this->dataPtr->commandSubTopic);
+  _sdf->Get<double>("rotorDragCoefficient",
+      _rotor.rotorDragCoefficient, _rotor.rotorDragCoefficient);
+  _sdf->Get<double>("rollingMomentCoefficient",
+      _rotor.rollingMomentCoefficient, _rotor.rollingMomentCoefficient);
+  _sdf->Get<double>("maxRotVelocity",
+      _rotor.maxRotVelocity, _rotor.maxRotVelocity);
+  _sdf->Get<double>("motorConstant",
+      _rotor.motorConstant, _rotor.motorConstant);
+  _sdf->Get<double>("momentConstant",
+      _rotor.momentConstant, _rotor.momentConstant);
+
+  _sdf->Get<double>("timeConstantUp",
+      _rotor.timeConstantUp, _rotor.timeConstantUp);
+  _sdf->Get<double>("timeConstantDown",
+      _rotor.timeConstantDown, _rotor.timeConstantDown);
+  _sdf->Get<double>("rotorVelocitySlowdownSim",
+      _rotor.rotorVelocitySlowdownSim, _rotor.rotorVelocitySlowdownSim);
+}
 
-  sdfClone->Get<double>("rotorDragCoefficient",
-      this->dataPtr->rotorDragCoefficient,
-      this->dataPtr->rotorDragCoefficient);
-  sdfClone->Get<double>("rollingMomentCoefficient",
-      this->dataPtr->rollingMomentCoefficient,
-      this->dataPtr->rollingMomentCoefficient);
-  sdfClone->Get<double>("maxRotVelocity",
-      this->dataPtr->maxRotVelocity, this->dataPtr->maxRotVelocity);
-  sdfClone->Get<double>("motorConstant",
-      this->dataPtr->motorConstant, this->dataPtr->motorConstant);
-  sdfClone->Get<double>("momentConstant",
-      this->dataPtr->momentConstant, this->dataPtr->momentConstant);
-
-  sdfClone->Get<double>("timeConstantUp",
-      this->dataPtr->timeConstantUp, this->dataPtr->timeConstantUp);
-  sdfClone->Get<double>("timeConstantDown",
-      this->dataPtr->timeConstantDown, this->dataPtr->timeConstantDown);
-  sdfClone->Get<double>("rotorVelocitySlowdownSim",
-      this->dataPtr->rotorVelocitySlowdownSim, 10);
-
-  // Create the first order filter.
-  this->dataPtr->rotorVelocityFilter =
-      std::make_unique<FirstOrderFilter<double>>(
-          this->dataPtr->timeConstantUp, this->dataPtr->timeConstantDown,
-          this->dataPtr->refMotorInput);
-
-  // Subscribe to actuator command messages
-  std::string topic = transport::TopicUtils::AsValidTopic(
-      this->dataPtr->robotNamespace + "/" + this->dataPtr->commandSubTopic);
-  if (topic.empty())
+//////////////////////////////////////////////////
+bool MulticopterMotorModelPrivate::FindRotorEntities(
+    const EntityComponentManager &_ecm, MulticopterRotor &_rotor) const
+{
+  // If the joint or links haven't been identified yet, look for them
+  if (_rotor.jointEntity == kNullEntity)
   {
-    ignerr << "Failed to create topic for [" << this->dataPtr->robotNamespace
-           << "]" << std::endl;
-    return;
+    _rotor.jointEntity = this->model.JointByName(_ecm, _rotor.jointName);
+    if (_rotor.jointEntity == kNullEntity)
+      return false;
+
+    const auto parentLinkName = _ecm.Component<components::ParentLinkName>(
+        _rotor.jointEntity);
+    _rotor.parentLinkName = parentLinkName->Data();
   }
-  this->dataPtr->node.Subscribe(topic,
-      &MulticopterMotorModelPrivate::OnActuatorMsg, this->dataPtr.get());
+
+  if (_rotor.linkEntity == kNullEntity)
+  {
+    _rotor.linkEntity = this->model.LinkByName(_ecm, _rotor.linkName);
+  }
+
+  if (_rotor.parentLinkEntity == kNullEntity)
+  {
+    _rotor.parentLinkEntity =
+        this->model.LinkByName(_ecm, _rotor.parentLinkName);
+  }
+
+  return _rotor.linkEntity != kNullEntity &&
+      _rotor.parentLinkEntity != kNullEntity;
 }
 
 //////////////////////////////////////////////////
@@ -383,76 +495,56 @@ void MulticopterMotorModel::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
         << "s]. System may not work properly." << std::endl;
   }
 
-  // If the joint or links haven't been identified yet, look for them
-  if (this->dataPtr->jointEntity == kNullEntity)
-  {
-    this->dataPtr->jointEntity =
-        this->dataPtr->model.JointByName(_ecm, this->dataPtr->jointName);
-
-    const auto parentLinkName = _ecm.Component<components::ParentLinkName>(
-        this->dataPtr->jointEntity);
-    this->dataPtr->parentLinkName = parentLinkName->Data();
-  }
-
-  if (this->dataPtr->linkEntity == kNullEntity)
-  {
-    this->dataPtr->linkEntity =
-        this->dataPtr->model.LinkByName(_ecm, this->dataPtr->linkName);
-  }
-
-  if (this->dataPtr->parentLinkEntity == kNullEntity)
-  {
-    this->dataPtr->parentLinkEntity =
-        this->dataPtr->model.LinkByName(_ecm, this->dataPtr->parentLinkName);
-  }
-
-  if (this->dataPtr->jointEntity == kNullEntity ||
-      this->dataPtr->linkEntity == kNullEntity ||
-      this->dataPtr->parentLinkEntity == kNullEntity)
+  if (this->dataPtr->rotors.empty())
     return;
 
-  // skip UpdateForcesAndMoments if needed components are missing
+  // skip UpdateForcesAndMoments if needed entities or components are missing
   bool doUpdateForcesAndMoments = true;
 
-  const auto jointVelocity = _ecm.Component<components::JointVelocity>(
-      this->dataPtr->jointEntity);
-  if (!jointVelocity)
-  {
-    _ecm.CreateComponent(this->dataPtr->jointEntity,
-        components::JointVelocity());
-    doUpdateForcesAndMoments = false;
-  }
-  else if (jointVelocity->Data().empty())
+  for (auto &rotor : this->dataPtr->rotors)
   {
-    doUpdateForcesAndMoments = false;
-  }
+    if (!this->dataPtr->FindRotorEntities(_ecm, rotor))
+    {
+      doUpdateForcesAndMoments = false;
+      continue;
+    }
 
-  if (!_ecm.Component<components::JointVelocityCmd>(
-      this->dataPtr->jointEntity))
-  {
-    _ecm.CreateComponent(this->dataPtr->jointEntity,
-        components::JointVelocityCmd({0}));
-    doUpdateForcesAndMoments = false;
-  }
+    const auto jointVelocity = _ecm.Component<components::JointVelocity>(
+        rotor.jointEntity);
+    if (!jointVelocity)
+    {
+      _ecm.CreateComponent(rotor.jointEntity, components::JointVelocity());
+      doUpdateForcesAndMoments = false;
+    }
+    else if (jointVelocity->Data().empty())
+    {
+      doUpdateForcesAndMoments = false;
+    }
 
-  if (!_ecm.Component<components::WorldPose>(this->dataPtr->linkEntity))
-  {
-    _ecm.CreateComponent(this->dataPtr->linkEntity, components::WorldPose());
-    doUpdateForcesAndMoments = false;
-  }
-  if (!_ecm.Component<components::WorldLinearVelocity>(
-      this->dataPtr->linkEntity))
-  {
-    _ecm.CreateComponent(this->dataPtr->linkEntity,
-        components::WorldLinearVelocity());
-    doUpdateForcesAndMoments = false;
-  }
+    if (!_ecm.Component<components::JointVelocityCmd>(rotor.jointEntity))
+    {
+      _ecm.CreateComponent(rotor.jointEntity,
+          components::JointVelocityCmd({0}));
+      doUpdateForcesAndMoments = false;
+    }
 
-  if (!_ecm.Component<components::WorldPose>(this->dataPtr->parentLinkEntity))
-  {
-    _ecm.CreateComponent(this->dataPtr->parentLinkEntity,
-        components::WorldPose());
-    doUpdateForcesAndMoments = false;
+    if (!_ecm.Component<components::WorldPose>(rotor.linkEntity))
+    {
+      _ecm.CreateComponent(rotor.linkEntity, components::WorldPose());
+      doUpdateForcesAndMoments = false;
+    }
+    if (!_ecm.Component<components::WorldLinearVelocity>(rotor.linkEntity))
+    {
+      _ecm.CreateComponent(rotor.linkEntity,
+          components::WorldLinearVelocity());
+      doUpdateForcesAndMoments = false;
+    }
+
+    if (!_ecm.Component<components::WorldPose>(rotor.parentLinkEntity))
+    {
+      _ecm.CreateComponent(rotor.parentLinkEntity, components::WorldPose());
+      doUpdateForcesAndMoments = false;
+    }
   }
 
   // Nothing left to do if paused.
@@ -486,7 +578,8 @@ void MulticopterMotorModelPrivate::UpdateForcesAndMoments(
       _ecm.Component<components::Actuators>(this->model.Entity());
 
   // Actuators messages can come in from transport or via a component. If a
-  // component is available, it takes precedence.
+  // component is available, it takes precedence. The component is how
+  // MulticopterVelocityControl commands the rotors within the same process.
   if (actuatorMsgComp)
   {
     msg = actuatorMsgComp->Data();
@@ -501,173 +594,213 @@ void MulticopterMotorModelPrivate::UpdateForcesAndMoments(
     }
   }
 
-  if (msg.has_value())
-  {
-    if (this->motorNumber > msg->velocity_size() - 1)
-    {
-      ignerr << "You tried to access index " << this->motorNumber
-        << " of the Actuator velocity array which is of size "
-        << msg->velocity_size() << std::endl;
-      return;
-    }
+  // The wind is the same for all rotors
+  math::Vector3d windSpeedWorld;
+  Entity windEntity = _ecm.EntityByComponents(components::Wind());
+  auto windLinearVel =
+      _ecm.Component<components::WorldLinearVelocity>(windEntity);
+  if (windLinearVel)
+    windSpeedWorld = windLinearVel->Data();
 
-    if (this->motorType == MotorType::kVelocity)
-    {
-      this->refMotorInput = std::min(
-          static_cast<double>(msg->velocity(this->motorNumber)),
-          static_cast<double>(this->maxRotVelocity));
-    }
-    //  else if (this->motorType == MotorType::kPosition)
-    else  // if (this->motorType == MotorType::kForce) {
-    {
-      this->refMotorInput = msg->velocity(this->motorNumber);
-    }
-  }
+  this->parentTorques.clear();
 
-  switch (this->motorType)
+  for (auto &rotor : this->rotors)
   {
-    case (MotorType::kPosition):
-    {
-      // double err = joint_->GetAngle(0).Radian() - this->refMotorInput;
-      // double force = pids_.Update(err, this->samplingTime);
-      // joint_->SetForce(0, force);
-      break;
-    }
-    case (MotorType::kForce):
+    if (msg.has_value())
     {
-      // joint_->SetForce(0, this->refMotorInput);
-      break;
-    }
-    default:  // MotorType::kVelocity
-    {
-      const auto jointVelocity = _ecm.Component<components::JointVelocity>(
-          this->jointEntity);
-      double motorRotVel = jointVelocity->Data()[0];
-      if (motorRotVel / (2 * IGN_PI) > 1 / (2 * this->samplingTime))
+      if (rotor.motorNumber > msg->velocity_size() - 1)
       {
-        ignerr << "Aliasing on motor [" << this->motorNumber
-              << "] might occur. Consider making smaller simulation time "
-                 "steps or raising the rotorVelocitySlowdownSim param.\n";
+        ignerr << "You tried to access index " << rotor.motorNumber
+          << " of the Actuator velocity array which is of size "
+          << msg->velocity_size() << std::endl;
+        continue;
       }
-      double realMotorVelocity =
-          motorRotVel * this->rotorVelocitySlowdownSim;
-      // Get the direction of the rotor rotation.
-      int realMotorVelocitySign =
-          (realMotorVelocity > 0) - (realMotorVelocity < 0);
-      // Assuming symmetric propellers (or rotors) for the thrust calculation.
-      double thrust = this->turningDirection * realMotorVelocitySign *
-                      realMotorVelocity * realMotorVelocity *
-                      this->motorConstant;
-
-      using Pose = ignition::math::Pose3d;
-      using Vector3 = ignition::math::Vector3d;
-
-      Link link(this->linkEntity);
-      const auto worldPose = link.WorldPose(_ecm);
-
-      // Apply a force to the link.
-      link.AddWorldForce(_ecm,
-                         worldPose->Rot().RotateVector(Vector3(0, 0, thrust)));
-
-      const auto jointPose = _ecm.Component<components::Pose>(
-          this->jointEntity);
-      if (!jointPose)
+
+      if (rotor.motorType == MotorType::kVelocity)
       {
-        ignerr << "joint " << this->jointName << " has no Pose"
-               << "component" << std::endl;
-        return;
+        rotor.refMotorInput = std::min(
+            static_cast<double>(msg->velocity(rotor.motorNumber)),
+            static_cast<double>(rotor.maxRotVelocity));
       }
-      // computer joint world pose by multiplying child link WorldPose
-      // with joint Pose
-      Pose jointWorldPose = *worldPose * jointPose->Data();
-
-      const auto jointAxisComp = _ecm.Component<components::JointAxis>(
-          this->jointEntity);
-      if (!jointAxisComp)
+      //  else if (rotor.motorType == MotorType::kPosition)
+      else  // if (rotor.motorType == MotorType::kForce) {
       {
-        ignerr << "joint " << this->jointName << " has no JointAxis"
-               << "component" << std::endl;
-        return;
+        rotor.refMotorInput = msg->velocity(rotor.motorNumber);
       }
+    }
 
-      const auto worldLinearVel = link.WorldLinearVelocity(_ecm);
-
-      Entity windEntity = _ecm.EntityByComponents(components::Wind());
-      auto windLinearVel =
-          _ecm.Component<components::WorldLinearVelocity>(windEntity);
-      Vector3 windSpeedWorld = windLinearVel->Data();
-
-      // Forces from Philppe Martin's and Erwan Salaun's
-      // 2010 IEEE Conference on Robotics and Automation paper
-      // The True Role of Accelerometer Feedback in Quadrotor Control
-      // - \omega * \lambda_1 * V_A^{\perp}
-      Vector3 jointAxis =
-          jointWorldPose.Rot().RotateVector(jointAxisComp->Data().Xyz());
-      Vector3 bodyVelocityWorld = *worldLinearVel;
-      Vector3 relativeWindVelocityWorld = bodyVelocityWorld - windSpeedWorld;
-      Vector3 bodyVelocityPerpendicular =
-          relativeWindVelocityWorld -
-          (relativeWindVelocityWorld.Dot(jointAxis) * jointAxis);
-      Vector3 airDrag = -std::abs(realMotorVelocity) *
-                               this->rotorDragCoefficient *
-                               bodyVelocityPerpendicular;
-
-      // Apply air drag to link.
-      link.AddWorldForce(_ecm, airDrag);
-      // Moments get the parent link, such that the resulting torques can be
-      // applied.
-      Vector3 parentWorldTorque;
-      auto parentWrenchComp =
-        _ecm.Component<components::ExternalWorldWrenchCmd>(
-          this->parentLinkEntity);
-      // gazebo_motor_model.cpp subtracts the GetWorldCoGPose() of the
-      // child link from the parent but only uses the rotation component.
-      // Since GetWorldCoGPose() uses the link frame orientation, it
-      // is equivalent to use WorldPose().Rot().
-      Link parentLink(this->parentLinkEntity);
-      const auto parentWorldPose = parentLink.WorldPose(_ecm);
-      // The tansformation from the parent_link to the link_.
-      // Pose poseDifference =
-      //  link_->GetWorldCoGPose() - parent_links.at(0)->GetWorldCoGPose();
-      Pose poseDifference = *worldPose - *parentWorldPose;
-      Vector3 dragTorque(
-          0, 0, -this->turningDirection * thrust * this->momentConstant);
-      // Transforming the drag torque into the parent frame to handle
-      // arbitrary rotor orientations.
-      Vector3 dragTorqueParentFrame =
-          poseDifference.Rot().RotateVector(dragTorque);
-      parentWorldTorque =
-          parentWorldPose->Rot().RotateVector(dragTorqueParentFrame);
-
-      Vector3 rollingMoment;
-      // - \omega * \mu_1 * V_A^{\perp}
-      rollingMoment = -std::abs(realMotorVelocity) *
-                       this->rollingMomentCoefficient *
-                       bodyVelocityPerpendicular;
-      parentWorldTorque += rollingMoment;
-      if (!parentWrenchComp)
+    switch (rotor.motorType)
+    {
+      case (MotorType::kPosition):
+      {
+        // double err = joint_->GetAngle(0).Radian() - rotor.refMotorInput;
+        // double force = pids_.Update(err, this->samplingTime);
+        // joint_->SetForce(0, force);
+        break;
+      }
+      case (MotorType::kForce):
       {
-        components::ExternalWorldWrenchCmd wrench;
-        msgs::Set(wrench.Data().mutable_torque(), parentWorldTorque);
-        _ecm.CreateComponent(this->parentLinkEntity, wrench);
+        // joint_->SetForce(0, rotor.refMotorInput);
+        break;
       }
-      else
+      default:  // MotorType::kVelocity
       {
-        msgs::Set(parentWrenchComp->Data().mutable_torque(),
-          msgs::Convert(parentWrenchComp->Data().torque()) + parentWorldTorque);
+        math::Vector3d force;
+        math::Vector3d parentTorque;
+        if (!this->UpdateRotor(_ecm, windSpeedWorld, rotor, force,
+              parentTorque))
+        {
+          break;
+        }
+
+        // Apply thrust and air drag to the rotor link.
+        Link(rotor.linkEntity).AddWorldForce(_ecm, force);
+
+        // Accumulate the moments on the parent link, which is usually shared
+        // by all rotors of the vehicle.
+        auto it = std::find_if(this->parentTorques.begin(),
+            this->parentTorques.end(),
+            [&rotor](const std::pair<Entity, math::Vector3d> &_p)
+            {
+              return _p.first == rotor.parentLinkEntity;
+            });
+        if (it == this->parentTorques.end())
+          this->parentTorques.emplace_back(rotor.parentLinkEntity,
+              parentTorque);
+        else
+          it->second += parentTorque;
       }
-      // Apply the filter on the motor's velocity.
-      double refMotorRotVel;
-      refMotorRotVel = this->rotorVelocityFilter->UpdateFilter(
-          this->refMotorInput, this->samplingTime);
-
-      const auto jointVelCmd = _ecm.Component<components::JointVelocityCmd>(
-          this->jointEntity);
-      *jointVelCmd = components::JointVelocityCmd(
-          {this->turningDirection * refMotorRotVel
-                              / this->rotorVelocitySlowdownSim});
     }
   }
+
+  // Moments get the parent link, such that the resulting torques can be
+  // applied.
+  for (const auto &[parentLinkEntity, parentWorldTorque] : this->parentTorques)
+  {
+    auto parentWrenchComp =
+      _ecm.Component<components::ExternalWorldWrenchCmd>(parentLinkEntity);
+    if (!parentWrenchComp)
+    {
+      components::ExternalWorldWrenchCmd wrench;
+      msgs::Set(wrench.Data().mutable_torque(), parentWorldTorque);
+      _ecm.CreateComponent(parentLinkEntity, wrench);
+    }
+    else
+    {
+      msgs::Set(parentWrenchComp->Data().mutable_torque(),
+        msgs::Convert(parentWrenchComp->Data().torque()) + parentWorldTorque);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool MulticopterMotorModelPrivate::UpdateRotor(EntityComponentManager &_ecm,
+    const math::Vector3d &_windSpeedWorld, MulticopterRotor &_rotor,
+    math::Vector3d &_force, math::Vector3d &_parentTorque)
+{
+  using Pose = ignition::math::Pose3d;
+  using Vector3 = ignition::math::Vector3d;
+
+  const auto jointVelocity = _ecm.Component<components::JointVelocity>(
+      _rotor.jointEntity);
+  double motorRotVel = jointVelocity->Data()[0];
+  if (motorRotVel / (2 * IGN_PI) > 1 / (2 * this->samplingTime))
+  {
+    ignerr << "Aliasing on motor [" << _rotor.motorNumber
+          << "] might occur. Consider making smaller simulation time "
+             "steps or raising the rotorVelocitySlowdownSim param.\n";
+  }
+  double realMotorVelocity =
+      motorRotVel * _rotor.rotorVelocitySlowdownSim;
+  // Get the direction of the rotor rotation.
+  int realMotorVelocitySign =
+      (realMotorVelocity > 0) - (realMotorVelocity < 0);
+  // Assuming symmetric propellers (or rotors) for the thrust calculation.
+  double thrust = _rotor.turningDirection * realMotorVelocitySign *
+                  realMotorVelocity * realMotorVelocity *
+                  _rotor.motorConstant;
+
+  Link link(_rotor.linkEntity);
+  const auto worldPose = link.WorldPose(_ecm);
+
+  const auto jointPose = _ecm.Component<components::Pose>(
+      _rotor.jointEntity);
+  if (!jointPose)
+  {
+    ignerr << "joint " << _rotor.jointName << " has no Pose"
+           << "component" << std::endl;
+    return false;
+  }
+  // computer joint world pose by multiplying child link WorldPose
+  // with joint Pose
+  Pose jointWorldPose = *worldPose * jointPose->Data();
+
+  const auto jointAxisComp = _ecm.Component<components::JointAxis>(
+      _rotor.jointEntity);
+  if (!jointAxisComp)
+  {
+    ignerr << "joint " << _rotor.jointName << " has no JointAxis"
+           << "component" << std::endl;
+    return false;
+  }
+
+  const auto worldLinearVel = link.WorldLinearVelocity(_ecm);
+
+  // Forces from Philppe Martin's and Erwan Salaun's
+  // 2010 IEEE Conference on Robotics and Automation paper
+  // The True Role of Accelerometer Feedback in Quadrotor Control
+  // - \omega * \lambda_1 * V_A^{\perp}
+  Vector3 jointAxis =
+      jointWorldPose.Rot().RotateVector(jointAxisComp->Data().Xyz());
+  Vector3 bodyVelocityWorld = *worldLinearVel;
+  Vector3 relativeWindVelocityWorld = bodyVelocityWorld - _windSpeedWorld;
+  Vector3 bodyVelocityPerpendicular =
+      relativeWindVelocityWorld -
+      (relativeWindVelocityWorld.Dot(jointAxis) * jointAxis);
+  Vector3 airDrag = -std::abs(realMotorVelocity) *
+                           _rotor.rotorDragCoefficient *
+                           bodyVelocityPerpendicular;
+
+  // Thrust along the rotor axis plus air drag.
+  _force = worldPose->Rot().RotateVector(Vector3(0, 0, thrust)) + airDrag;
+
+  // gazebo_motor_model.cpp subtracts the GetWorldCoGPose() of the
+  // child link from the parent but only uses the rotation component.
+  // Since GetWorldCoGPose() uses the link frame orientation, it
+  // is equivalent to use WorldPose().Rot().
+  Link parentLink(_rotor.parentLinkEntity);
+  const auto parentWorldPose = parentLink.WorldPose(_ecm);
+  // The tansformation from the parent_link to the link_.
+  // Pose poseDifference =
+  //  link_->GetWorldCoGPose() - parent_links.at(0)->GetWorldCoGPose();
+  Pose poseDifference = *worldPose - *parentWorldPose;
+  Vector3 dragTorque(
+      0, 0, -_rotor.turningDirection * thrust * _rotor.momentConstant);
+  // Transforming the drag torque into the parent frame to handle
+  // arbitrary rotor orientations.
+  Vector3 dragTorqueParentFrame =
+      poseDifference.Rot().RotateVector(dragTorque);
+  _parentTorque =
+      parentWorldPose->Rot().RotateVector(dragTorqueParentFrame);
+
+  Vector3 rollingMoment;
+  // - \omega * \mu_1 * V_A^{\perp}
+  rollingMoment = -std::abs(realMotorVelocity) *
+                   _rotor.rollingMomentCoefficient *
+                   bodyVelocityPerpendicular;
+  _parentTorque += rollingMoment;
+
+  // Apply the filter on the motor's velocity.
+  double refMotorRotVel;
+  refMotorRotVel = _rotor.rotorVelocityFilter.UpdateFilter(
+      _rotor.refMotorInput, this->samplingTime);
+
+  const auto jointVelCmd = _ecm.Component<components::JointVelocityCmd>(
+      _rotor.jointEntity);
+  jointVelCmd->Data().assign(1, _rotor.turningDirection * refMotorRotVel
+      / _rotor.rotorVelocitySlowdownSim);
+
+  return true;
 }
 
 IGNITION_ADD_PLUGIN(MulticopterMotorModel,
@@ -33,6 +33,20 @@ namespace systems
 
   /// \brief This system applies a thrust force to models with spinning
   /// propellers. See examples/worlds/quadcopter.sdf for a demonstration.
+  ///
+  /// A single instance can handle all rotors of a vehicle. Each `<rotor>`
+  /// element describes one rotor with any of the per rotor parameters
+  /// (`<jointName>`, `<linkName>`, `<motorNumber>`, `<turningDirection>`,
+  /// ...). Values not set in a `<rotor>` are taken from the top level. If
+  /// there are no `<rotor>` elements, the top level parameters describe a
+  /// single rotor. All rotors share one command subscription, and the drag
+  /// torques of rotors attached to the same parent link are applied in one
+  /// wrench update.
+  ///
+  /// Commands are read from the `Actuators` component of the model if it
+  /// exists, which is how MulticopterVelocityControl drives the rotors
+  /// without going through transport. Otherwise they are received on
+  /// `<robotNamespace>/<commandSubTopic>`.
   class IGNITION_GAZEBO_VISIBLE MulticopterMotorModel
       : public System,
         public ISystemConfigure,
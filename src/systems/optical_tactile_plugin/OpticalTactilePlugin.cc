@@ -16,8 +16,11 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <ignition/common/Profiler.hh>
@@ -48,6 +51,29 @@ using namespace gazebo;
 using namespace systems;
 using namespace optical_tactile_sensor;
 
+/// \brief Coordinates of a set of points, stored as one array per axis so
+/// that they can be processed with vector instructions.
+struct PointArrays
+{
+  /// \brief Resize all arrays.
+  /// \param[in] _size Number of points.
+  void Resize(const std::size_t _size)
+  {
+    this->x.resize(_size);
+    this->y.resize(_size);
+    this->z.resize(_size);
+  }
+
+  /// \brief X coordinates.
+  std::vector<float> x;
+
+  /// \brief Y coordinates.
+  std::vector<float> y;
+
+  /// \brief Z coordinates.
+  std::vector<float> z;
+};
+
 class ignition::gazebo::systems::OpticalTactilePluginPrivate
 {
   /// \brief Load the Contact sensor from an sdf element
@@ -63,22 +89,23 @@ class ignition::gazebo::systems::OpticalTactilePluginPrivate
   public: void DepthCameraCallback(
     const ignition::msgs::PointCloudPacked &_msg);
 
-  /// \brief Map the (i,j) coordinates defined in the top-left corner of the
-  /// camera into its corresponding (X,Y,Z) measurement with respect to the
-  /// camera's origin in the world frame
-  /// \param[in] _i Horizontal camera coordinate defined in the top-left corner
-  /// of the image, pointing rightwards
-  /// \param[in] _j Vertical camera coordinate defined in the top-left corner
-  /// of the image, pointing downwards
-  /// \param[in] _msgBuffer Buffer with the point cloud data
-  /// \returns The corresponding (X,Y,Z) point
-  public: ignition::math::Vector3f MapPointCloudData(const uint64_t &_i,
-    const uint64_t &_j, const char *_msgBuffer);
-
-  /// \brief Check if a specific point from the depth camera is inside
-  /// the contact surface.
-  /// \param[in] _point Point from the depth camera
-  public: bool PointInsideSensor(ignition::math::Vector3f _point);
+  /// \brief Copy the (X,Y,Z) measurements of a set of pixels into point
+  /// arrays. The measurements are with respect to the camera's origin.
+  /// \param[in] _msg Message from the depth camera
+  /// \param[in] _pixels Pairs of horizontal and vertical camera coordinates,
+  /// defined in the top-left corner of the image, pointing rightwards and
+  /// downwards
+  /// \param[out] _points The points, resized to the number of pixels
+  public: static void ExtractPoints(
+    const ignition::msgs::PointCloudPacked &_msg,
+    const std::vector<std::pair<uint64_t, uint64_t>> &_pixels,
+    PointArrays &_points);
+
+  /// \brief Set all points which are not inside the contact surface to
+  /// infinity. This loop has no branches so that the compiler can vectorize
+  /// it.
+  /// \param[in,out] _points Points from the depth camera
+  public: void MaskPointsOutsideSensor(PointArrays &_points) const;
 
   /// \brief Computes the normal forces of the Optical Tactile sensor
   /// \param[in] _msg Message from the depth camera
@@ -141,6 +168,25 @@ class ignition::gazebo::systems::OpticalTactilePluginPrivate
   /// \brief Message returned by the depth camera
   public: ignition::msgs::PointCloudPacked cameraMsg;
 
+  /// \brief Message being processed. It's swapped with cameraMsg so that the
+  /// camera callback isn't blocked while the normal forces are computed, and
+  /// the memory of both messages is reused.
+  public: ignition::msgs::PointCloudPacked processingMsg;
+
+  /// \brief Pixels at which normal forces are computed, cached for the last
+  /// image size.
+  public: std::vector<std::pair<uint64_t, uint64_t>> samplePixels;
+
+  /// \brief Image width and height for which samplePixels was computed.
+  public: std::pair<uint64_t, uint64_t> samplePixelsSize{0u, 0u};
+
+  /// \brief Points at the sample pixels, followed by the points right,
+  /// left, below and above them.
+  public: std::array<PointArrays, 5> samplePoints;
+
+  /// \brief Normal forces at the sample pixels.
+  public: PointArrays normalForces;
+
   /// \brief Mutex for variables mutated by the camera callback.
   /// The variables are: newCameraMsg, cameraMsg.
   public: std::mutex serviceMutex;
@@ -338,16 +384,21 @@ void OpticalTactilePlugin::PostUpdate(
   // TODO(anyone) Get ContactSensor data and merge it with DepthCamera data
 
   // Process camera message if it's new
+  bool newCameraMsg{false};
   {
     std::lock_guard<std::mutex> lock(this->dataPtr->serviceMutex);
     if (this->dataPtr->newCameraMsg)
     {
-      this->dataPtr->ComputeNormalForces(this->dataPtr->cameraMsg,
-        this->dataPtr->visualizeForces);
-
+      this->dataPtr->processingMsg.Swap(&this->dataPtr->cameraMsg);
       this->dataPtr->newCameraMsg = false;
+      newCameraMsg = true;
     }
   }
+  if (newCameraMsg)
+  {
+    this->dataPtr->ComputeNormalForces(this->dataPtr->processingMsg,
+      this->dataPtr->visualizeForces);
+  }
 
   // Publish sensor marker if required and sensor pose has changed
   if (this->dataPtr->visualizeSensor &&
@@ -561,78 +612,66 @@ void OpticalTactilePluginPrivate::DepthCameraCallback(
 }
 
 //////////////////////////////////////////////////
-ignition::math::Vector3f OpticalTactilePluginPrivate::MapPointCloudData(
-  const uint64_t &_i, const uint64_t &_j, const char *_msgBuffer)
+void OpticalTactilePluginPrivate::ExtractPoints(
+  const ignition::msgs::PointCloudPacked &_msg,
+  const std::vector<std::pair<uint64_t, uint64_t>> &_pixels,
+  PointArrays &_points)
 {
-  IGN_PROFILE("OpticalTactilePlugin::MapPointCloudData");
-
-  // Initialize return variable
-  ignition::math::Vector3f measuredPoint(0, 0, 0);
-
-  // Nothing left to do if failed to initialize.
-  if (!this->initialized)
-    return measuredPoint;
+  _points.Resize(_pixels.size());
 
-  // Save original position of the pointer
-  const char *temporaryMsgBuffer = _msgBuffer;
-
-  // Number of bytes from the beginning of the pointer (image coordinates at
-  // 0,0) to the desired (i,j) position
-  uint32_t msgBufferIndex =
-    _j*this->cameraMsg.row_step() + _i*this->cameraMsg.point_step();
-
-  temporaryMsgBuffer += msgBufferIndex;
-  int fieldIndex = 0;
-
-  // X coordinate
-  measuredPoint.X() = *reinterpret_cast<const float *>(
-    temporaryMsgBuffer + this->cameraMsg.field(fieldIndex++).offset());
-  // Y coordinate
-  measuredPoint.Y() = *reinterpret_cast<const float *>(
-    temporaryMsgBuffer + this->cameraMsg.field(fieldIndex++).offset());
-  // Z coordinate
-  measuredPoint.Z() = *reinterpret_cast<const float *>(
-    temporaryMsgBuffer + this->cameraMsg.field(fieldIndex).offset());
+  const char *msgBuffer = _msg.data().data();
+  const uint64_t rowStep = _msg.row_step();
+  const uint64_t pointStep = _msg.point_step();
+  const uint32_t offsetX = _msg.field(0).offset();
+  const uint32_t offsetY = _msg.field(1).offset();
+  const uint32_t offsetZ = _msg.field(2).offset();
 
-  // Check if point is inside the sensor
-  bool pointInside = this->PointInsideSensor(measuredPoint);
-  if (!pointInside)
+  for (std::size_t k = 0; k < _pixels.size(); ++k)
   {
-    measuredPoint.X() = ignition::math::INF_F;
-    measuredPoint.Y() = ignition::math::INF_F;
-    measuredPoint.Z() = ignition::math::INF_F;
+    // Number of bytes from the beginning of the buffer (image coordinates at
+    // 0,0) to the desired (i,j) position
+    const char *point = msgBuffer +
+      _pixels[k].second * rowStep + _pixels[k].first * pointStep;
+
+    _points.x[k] = *reinterpret_cast<const float *>(point + offsetX);
+    _points.y[k] = *reinterpret_cast<const float *>(point + offsetY);
+    _points.z[k] = *reinterpret_cast<const float *>(point + offsetZ);
   }
-
-  return measuredPoint;
 }
 
 //////////////////////////////////////////////////
-bool OpticalTactilePluginPrivate::PointInsideSensor(
-  ignition::math::Vector3f _point)
+void OpticalTactilePluginPrivate::MaskPointsOutsideSensor(
+  PointArrays &_points) const
 {
-  IGN_PROFILE("OpticalTactilePlugin::PointInsideSensor");
-
-  // Nothing left to do if failed to initialize.
-  if (!this->initialized)
-    return false;
+  IGN_PROFILE("OpticalTactilePlugin::MaskPointsOutsideSensor");
 
   // We assume that the depth camera is placed behind the contact surface, i.e.
   // displaced in the -X direction with respect to the model's origin
-  bool insideX =
-    (_point.X() >= std::abs(this->depthCameraOffset.X()) -
-      this->extendedSensing) &&
-    (_point.X() <= (std::abs(this->depthCameraOffset.X()) +
-      this->sensorSize.X() + this->extendedSensing));
-
-  bool insideY =
-    (_point.Y() <= this->sensorSize.Y() / 2 + this->extendedSensing) &&
-    (_point.Y() >= - this->sensorSize.Y() / 2 - this->extendedSensing);
-
-  bool insideZ =
-    (_point.Z() <= this->sensorSize.Z() / 2 + this->extendedSensing) &&
-    (_point.Z() >= - this->sensorSize.Z() / 2 - this->extendedSensing);
-
-  return (insideX && insideY && insideZ);
+  const float minX = static_cast<float>(
+    std::abs(this->depthCameraOffset.X()) - this->extendedSensing);
+  const float maxX = static_cast<float>(
+    std::abs(this->depthCameraOffset.X()) + this->sensorSize.X() +
+    this->extendedSensing);
+  const float maxY =
+    static_cast<float>(this->sensorSize.Y() / 2 + this->extendedSensing);
+  const float maxZ =
+    static_cast<float>(this->sensorSize.Z() / 2 + this->extendedSensing);
+
+  float *x = _points.x.data();
+  float *y = _points.y.data();
+  float *z = _points.z.data();
+  const std::size_t count = _points.x.size();
+  for (std::size_t k = 0; k < count; ++k)
+  {
+    const bool inside =
+      (x[k] >= minX) & (x[k] <= maxX) &
+      (y[k] <= maxY) & (y[k] >= -maxY) &
+      (z[k] <= maxZ) & (z[k] >= -maxZ);
+
+    x[k] = inside ? x[k] : ignition::math::INF_F;
+    y[k] = inside ? y[k] : ignition::math::INF_F;
+    z[k] = inside ? z[k] : ignition::math::INF_F;
+  }
 }
 
 //////////////////////////////////////////////////
@@ -646,59 +685,93 @@ void OpticalTactilePluginPrivate::ComputeNormalForces(
   if (!this->initialized)
     return;
 
-  // Get data from the message
-  const char *msgBuffer = _msg.data().data();
-
-  // Declare variables for storing the XYZ points
-  ignition::math::Vector3f p1, p2, p3, p4, markerPosition;
-
-  // Marker messages representing the normal forces
-  ignition::msgs::Marker positionMarkerMsg;
-  ignition::msgs::Marker forceMarkerMsg;
-
   // We don't get the image's edges because there are no adjacent points to
   // compute the forces
-  for (uint64_t j = 1; j < (_msg.height() - 1);
-      j += this->visualizationResolution)
+  if (_msg.width() < 3 || _msg.height() < 3 || _msg.field_size() < 3)
+    return;
+
+  // Pixels at which forces are computed, one every visualizationResolution
+  // pixels. They only change with the image size.
+  const std::pair<uint64_t, uint64_t> size{_msg.width(), _msg.height()};
+  if (size != this->samplePixelsSize)
   {
-    for (uint64_t i = 1; i < (_msg.width() - 1);
-        i += this->visualizationResolution)
+    const uint64_t step = std::max(this->visualizationResolution, 1);
+    this->samplePixels.clear();
+    for (uint64_t j = 1; j < (size.second - 1); j += step)
     {
-      // Get points for computing normal forces
-      p1 = this->MapPointCloudData(i + 1, j, msgBuffer);
-      p2 = this->MapPointCloudData(i - 1, j, msgBuffer);
-      p3 = this->MapPointCloudData(i, j + 1, msgBuffer);
-      p4 = this->MapPointCloudData(i, j - 1, msgBuffer);
+      for (uint64_t i = 1; i < (size.first - 1); i += step)
+        this->samplePixels.emplace_back(i, j);
+    }
+    this->samplePixelsSize = size;
+  }
 
-      float dxdi = (p1.X() - p2.X()) / std::abs(p1.Y() - p2.Y());
-      float dxdj =  (p3.X() - p4.X()) / std::abs(p3.Z() - p4.Z());
+  // Get the points at, right of, left of, below and above each pixel, and
+  // discard the ones outside of the sensor
+  const std::array<std::pair<int, int>, 5> offsets{{
+    {0, 0}, {1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+  std::vector<std::pair<uint64_t, uint64_t>> pixels(this->samplePixels.size());
+  for (std::size_t n = 0; n < offsets.size(); ++n)
+  {
+    for (std::size_t k = 0; k < pixels.size(); ++k)
+    {
+      pixels[k].first = this->samplePixels[k].first + offsets[n].first;
+      pixels[k].second = this->samplePixels[k].second + offsets[n].second;
+    }
+    this->ExtractPoints(_msg, pixels, this->samplePoints[n]);
+    this->MaskPointsOutsideSensor(this->samplePoints[n]);
+  }
 
-      ignition::math::Vector3f direction(-1, -dxdi, -dxdj);
+  // Compute normal forces for all pixels in one pass. This loop has no
+  // branches so that the compiler can vectorize it.
+  const std::size_t count = this->samplePixels.size();
+  this->normalForces.Resize(count);
+  const float *p1x = this->samplePoints[1].x.data();
+  const float *p1y = this->samplePoints[1].y.data();
+  const float *p2x = this->samplePoints[2].x.data();
+  const float *p2y = this->samplePoints[2].y.data();
+  const float *p3x = this->samplePoints[3].x.data();
+  const float *p3z = this->samplePoints[3].z.data();
+  const float *p4x = this->samplePoints[4].x.data();
+  const float *p4z = this->samplePoints[4].z.data();
+  float *nx = this->normalForces.x.data();
+  float *ny = this->normalForces.y.data();
+  float *nz = this->normalForces.z.data();
+  for (std::size_t k = 0; k < count; ++k)
+  {
+    const float dxdi = (p1x[k] - p2x[k]) / std::abs(p1y[k] - p2y[k]);
+    const float dxdj = (p3x[k] - p4x[k]) / std::abs(p3z[k] - p4z[k]);
 
-      // todo(anyone) multiply vector by contact forces info
+    // todo(anyone) multiply vector by contact forces info
 
-      // todo(anyone) Replace with MatrixX and use vector multiplication instead
-      // of for-loops once the following issue is completed:
-      // https://github.com/ignitionrobotics/ign-math/issues/144
-      ignition::math::Vector3f normalForce = direction.Normalized();
+    // Normalize the direction (-1, -dxdi, -dxdj), whose length is at least 1
+    const float invLength = 1.0f / std::sqrt(1.0f + dxdi * dxdi + dxdj * dxdj);
+    nx[k] = -invLength;
+    ny[k] = -dxdi * invLength;
+    nz[k] = -dxdj * invLength;
+  }
 
-      // todo(mcres) Normal forces are computed even if visualization
-      // is turned off. These forces should be published in the future.
-      if (!_visualizeForces)
-        continue;
+  // todo(mcres) Normal forces are computed even if visualization
+  // is turned off. These forces should be published in the future.
+  if (!_visualizeForces)
+    return;
 
-      markerPosition = this->MapPointCloudData(i, j, msgBuffer);
-      this->visualizePtr->AddNormalForceToMarkerMsgs(positionMarkerMsg,
-        forceMarkerMsg, markerPosition, normalForce,
-        this->tactileSensorWorldPose);
-    }
-  }
+  // Marker messages representing the normal forces
+  ignition::msgs::Marker positionMarkerMsg;
+  ignition::msgs::Marker forceMarkerMsg;
 
-  if (_visualizeForces)
+  const PointArrays &positions = this->samplePoints[0];
+  for (std::size_t k = 0; k < count; ++k)
   {
-    this->visualizePtr->RequestNormalForcesMarkerMsgs(positionMarkerMsg,
-      forceMarkerMsg);
+    ignition::math::Vector3f markerPosition(
+      positions.x[k], positions.y[k], positions.z[k]);
+    ignition::math::Vector3f normalForce(nx[k], ny[k], nz[k]);
+    this->visualizePtr->AddNormalForceToMarkerMsgs(positionMarkerMsg,
+      forceMarkerMsg, markerPosition, normalForce,
+      this->tactileSensorWorldPose);
   }
+
+  this->visualizePtr->RequestNormalForcesMarkerMsgs(positionMarkerMsg,
+    forceMarkerMsg);
 }
 
 IGNITION_ADD_PLUGIN(OpticalTactilePlugin,
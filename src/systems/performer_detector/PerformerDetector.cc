@@ -17,6 +17,9 @@
 
 #include <ignition/msgs/pose.pb.h>
 
+#include <unordered_set>
+#include <vector>
+
 #include <ignition/common/Profiler.hh>
 #include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/math/Vector3.hh>
@@ -27,6 +30,7 @@
 #include <sdf/Geometry.hh>
 
 #include "ignition/gazebo/Model.hh"
+#include "ignition/gazebo/SpatialIndex.hh"
 #include "ignition/gazebo/Util.hh"
 #include "ignition/gazebo/components/Geometry.hh"
 #include "ignition/gazebo/components/Model.hh"
@@ -159,45 +163,58 @@ void PerformerDetector::PostUpdate(
   auto region = this->detectorGeometry -
     (-(modelPose.Pos() + modelPose.Rot() * this->poseOffset.Pos()));
 
-  _ecm.Each<components::Performer, components::Geometry,
-            components::ParentEntity>(
-      [&](const Entity &_entity, const components::Performer *,
-          const components::Geometry *_geometry,
-          const components::ParentEntity *_parent) -> bool
-      {
-        auto pose = _ecm.Component<components::Pose>(_parent->Data())->Data();
-        auto name = _ecm.Component<components::Name>(_parent->Data())->Data();
-        const math::Pose3d relPose = modelPose.Inverse() * pose;
-
-        // We assume the geometry contains a box.
-        auto perfBox = _geometry->Data().BoxShape();
-        if (nullptr == perfBox)
-        {
-          ignerr << "Internal error: geometry of performer [" << _entity
-                 << "] missing box." << std::endl;
-          return true;
-        }
-
-        math::AxisAlignedBox performerVolume{pose.Pos() - perfBox->Size() / 2,
-                                             pose.Pos() + perfBox->Size() / 2};
-
-        bool alreadyDetected = this->IsAlreadyDetected(_entity);
-        if (region.Intersects(performerVolume))
-        {
-          if (!alreadyDetected)
-          {
-            this->AddToDetected(_entity);
-            this->Publish(_entity, name, true, relPose, _info.simTime);
-          }
-        }
-        else if (alreadyDetected)
-        {
-          this->RemoveFromDetected(_entity);
-          this->Publish(_entity, name, false, relPose, _info.simTime);
-        }
-
-        return true;
-      });
+  // Only performers near the region are tested, and detected performers
+  // which aren't near it anymore have left it
+  auto index = SpatialIndex::Shared(_info, _ecm);
+  std::vector<Entity> candidates;
+  index->Query(SpatialIndex::Layer::PERFORMERS, region, candidates);
+
+  std::unordered_set<Entity> inside;
+  for (const Entity performer : candidates)
+  {
+    auto performerVolume =
+        index->Box(SpatialIndex::Layer::PERFORMERS, performer);
+    auto parent = _ecm.Component<components::ParentEntity>(performer);
+    if (!performerVolume || nullptr == parent ||
+        !region.Intersects(*performerVolume))
+    {
+      continue;
+    }
+
+    inside.insert(performer);
+    if (!this->IsAlreadyDetected(performer))
+    {
+      auto pose = _ecm.Component<components::Pose>(parent->Data())->Data();
+      auto name = _ecm.Component<components::Name>(parent->Data())->Data();
+      this->AddToDetected(performer);
+      this->Publish(performer, name, true, modelPose.Inverse() * pose,
+          _info.simTime);
+    }
+  }
+
+  std::vector<Entity> left;
+  for (const Entity performer : this->detectedEntities)
+  {
+    if (inside.find(performer) == inside.end())
+      left.push_back(performer);
+  }
+
+  for (const Entity performer : left)
+  {
+    this->RemoveFromDetected(performer);
+
+    // Removed performers aren't reported
+    auto parent = _ecm.Component<components::ParentEntity>(performer);
+    if (nullptr == parent)
+      continue;
+    auto pose = _ecm.Component<components::Pose>(parent->Data());
+    auto name = _ecm.Component<components::Name>(parent->Data());
+    if (nullptr == pose || nullptr == name)
+      continue;
+
+    this->Publish(performer, name->Data(), false,
+        modelPose.Inverse() * pose->Data(), _info.simTime);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_PHYSICS_ENTITYRECORDS_HH_
+#define IGNITION_GAZEBO_SYSTEMS_PHYSICS_ENTITYRECORDS_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Entity.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief Records of data per entity, stored contiguously and found
+  /// through a flat index by entity slot, so finding a record is an array
+  /// access instead of a hash lookup.
+  ///
+  /// Entities whose slot index is far beyond the others, or which share a
+  /// slot with an entity already in the index, are found through a hash map
+  /// instead. Removing a record moves the last record into its place, so
+  /// pointers to records are invalidated by Insert and Erase.
+  /// \tparam RecordT Type of the records, must be default constructible.
+  template <typename RecordT>
+  class EntityRecords
+  {
+    /// \brief Find the record of an entity.
+    /// \param[in] _entity Entity.
+    /// \return The record, or nullptr if the entity doesn't have one.
+    public: RecordT *Find(const Entity _entity)
+    {
+      const uint32_t slot = this->Slot(_entity);
+      return kNoSlot == slot ? nullptr : &this->records[slot];
+    }
+
+    /// \brief Find the record of an entity.
+    /// \param[in] _entity Entity.
+    /// \return The record, or nullptr if the entity doesn't have one.
+    public: const RecordT *Find(const Entity _entity) const
+    {
+      const uint32_t slot = this->Slot(_entity);
+      return kNoSlot == slot ? nullptr : &this->records[slot];
+    }
+
+    /// \brief Get the record of an entity, adding a default constructed
+    /// record if it doesn't have one.
+    /// \param[in] _entity Entity.
+    /// \return The record.
+    public: RecordT &Insert(const Entity _entity)
+    {
+      if (auto record = this->Find(_entity))
+        return *record;
+
+      const auto slot = static_cast<uint32_t>(this->records.size());
+      this->records.emplace_back();
+      this->entities.push_back(_entity);
+
+      const uint64_t index = EntityIndex(_entity);
+      if (index < this->index.size() + kMaxGap)
+      {
+        if (index >= this->index.size())
+          this->index.resize(index + 1, kNoSlot);
+        if (kNoSlot == this->index[index])
+        {
+          this->index[index] = slot;
+          return this->records.back();
+        }
+      }
+      this->overflow[_entity] = slot;
+      return this->records.back();
+    }
+
+    /// \brief Remove the record of an entity.
+    /// \param[in] _entity Entity.
+    /// \return True if the entity had a record.
+    public: bool Erase(const Entity _entity)
+    {
+      const uint32_t slot = this->Slot(_entity);
+      if (kNoSlot == slot)
+        return false;
+
+      this->SetSlot(_entity, kNoSlot);
+
+      const auto last = static_cast<uint32_t>(this->records.size() - 1);
+      if (slot != last)
+      {
+        this->records[slot] = std::move(this->records[last]);
+        this->entities[slot] = this->entities[last];
+        this->SetSlot(this->entities[slot], slot);
+      }
+      this->records.pop_back();
+      this->entities.pop_back();
+      return true;
+    }
+
+    /// \brief Remove all records.
+    public: void Clear()
+    {
+      this->records.clear();
+      this->entities.clear();
+      this->index.clear();
+      this->overflow.clear();
+    }
+
+    /// \brief Get the number of records.
+    /// \return Number of records.
+    public: std::size_t Size() const
+    {
+      return this->records.size();
+    }
+
+    /// \brief Get the entity of a record, by position in the records.
+    /// \param[in] _pos Position, smaller than Size().
+    /// \return The entity.
+    public: Entity EntityAt(const std::size_t _pos) const
+    {
+      return this->entities[_pos];
+    }
+
+    /// \brief Get a record by position in the records.
+    /// \param[in] _pos Position, smaller than Size().
+    /// \return The record.
+    public: RecordT &RecordAt(const std::size_t _pos)
+    {
+      return this->records[_pos];
+    }
+
+    /// \brief Get the position of an entity's record.
+    /// \param[in] _entity Entity.
+    /// \return The position, or kNoSlot.
+    private: uint32_t Slot(const Entity _entity) const
+    {
+      const uint64_t index = EntityIndex(_entity);
+      if (index < this->index.size())
+      {
+        const uint32_t slot = this->index[index];
+        if (kNoSlot != slot && this->entities[slot] == _entity)
+          return slot;
+      }
+
+      if (this->overflow.empty())
+        return kNoSlot;
+      auto iter = this->overflow.find(_entity);
+      return iter == this->overflow.end() ? kNoSlot : iter->second;
+    }
+
+    /// \brief Set the position of an entity's record, wherever the entity
+    /// is indexed.
+    /// \param[in] _entity Entity, which must have a record.
+    /// \param[in] _slot New position, or kNoSlot to remove the entity from
+    /// the index.
+    private: void SetSlot(const Entity _entity, const uint32_t _slot)
+    {
+      const uint64_t index = EntityIndex(_entity);
+      if (index < this->index.size() && kNoSlot != this->index[index] &&
+          this->entities[this->index[index]] == _entity)
+      {
+        this->index[index] = _slot;
+        return;
+      }
+
+      if (kNoSlot == _slot)
+        this->overflow.erase(_entity);
+      else
+        this->overflow[_entity] = _slot;
+    }
+
+    /// \brief Index entry of slots without a record.
+    private: static constexpr uint32_t kNoSlot =
+        std::numeric_limits<uint32_t>::max();
+
+    /// \brief Largest distance beyond the end of the flat index at which an
+    /// entity is still added to it, so that a few very large entity indices
+    /// don't allocate a huge index.
+    private: static constexpr uint64_t kMaxGap{1u << 16};
+
+    /// \brief Records, without gaps.
+    private: std::vector<RecordT> records;
+
+    /// \brief Entity of each record.
+    private: std::vector<Entity> entities;
+
+    /// \brief Position of the record of each entity slot index, or kNoSlot.
+    private: std::vector<uint32_t> index;
+
+    /// \brief Position of the records of entities which aren't in the flat
+    /// index.
+    private: std::unordered_map<Entity, uint32_t> overflow;
+  };
+}
+}
+}
+}
+#endif
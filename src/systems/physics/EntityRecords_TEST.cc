@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "EntityRecords.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using EntityRecords = systems::EntityRecords<std::string>;
+
+/////////////////////////////////////////////////
+TEST(EntityRecords, InsertFindErase)
+{
+  EntityRecords records;
+  EXPECT_EQ(nullptr, records.Find(1));
+  EXPECT_FALSE(records.Erase(1));
+
+  records.Insert(1) = "one";
+  records.Insert(2) = "two";
+  records.Insert(3) = "three";
+  EXPECT_EQ(3u, records.Size());
+
+  // Existing records are returned
+  EXPECT_EQ("two", records.Insert(2));
+  EXPECT_EQ(3u, records.Size());
+
+  ASSERT_NE(nullptr, records.Find(1));
+  EXPECT_EQ("one", *records.Find(1));
+  EXPECT_EQ(nullptr, records.Find(4));
+
+  // The last record is moved into the erased one's place
+  EXPECT_TRUE(records.Erase(1));
+  EXPECT_EQ(2u, records.Size());
+  EXPECT_EQ(nullptr, records.Find(1));
+  ASSERT_NE(nullptr, records.Find(3));
+  EXPECT_EQ("three", *records.Find(3));
+  EXPECT_EQ(3u, records.EntityAt(0));
+  EXPECT_EQ("three", records.RecordAt(0));
+
+  // Erasing the last record
+  EXPECT_TRUE(records.Erase(2));
+  EXPECT_EQ(nullptr, records.Find(2));
+  EXPECT_EQ("three", *records.Find(3));
+
+  records.Clear();
+  EXPECT_EQ(0u, records.Size());
+  EXPECT_EQ(nullptr, records.Find(3));
+}
+
+/////////////////////////////////////////////////
+TEST(EntityRecords, Overflow)
+{
+  EntityRecords records;
+
+  // Same slot index, different generations
+  const Entity first = MakeEntity(5, 0);
+  const Entity reused = MakeEntity(5, 1);
+
+  // Far beyond the other slot indices
+  const Entity far = MakeEntity(uint64_t{1} << 30, 0);
+
+  records.Insert(first) = "first";
+  records.Insert(reused) = "reused";
+  records.Insert(far) = "far";
+  EXPECT_EQ(3u, records.Size());
+  EXPECT_EQ("first", *records.Find(first));
+  EXPECT_EQ("reused", *records.Find(reused));
+  EXPECT_EQ("far", *records.Find(far));
+  EXPECT_EQ(nullptr, records.Find(MakeEntity(5, 2)));
+
+  // The overflowing record moves when the first one is erased
+  EXPECT_TRUE(records.Erase(first));
+  EXPECT_EQ(nullptr, records.Find(first));
+  EXPECT_EQ("reused", *records.Find(reused));
+  EXPECT_EQ("far", *records.Find(far));
+
+  // The freed slot index can be used again
+  records.Insert(first) = "again";
+  EXPECT_EQ("again", *records.Find(first));
+  EXPECT_TRUE(records.Erase(reused));
+  EXPECT_TRUE(records.Erase(far));
+  EXPECT_EQ(1u, records.Size());
+  EXPECT_EQ("again", *records.Find(first));
+}
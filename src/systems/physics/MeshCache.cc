@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "MeshCache.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/SubMesh.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/gazebo/Util.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+namespace
+{
+/// \brief Identifies cache files and their format version.
+const char kMagic[8] = {'I', 'G', 'N', 'M', 'S', 'H', '0', '1'};
+
+//////////////////////////////////////////////////
+/// \brief Write a value in native byte order.
+template <typename T>
+void write(std::ostream &_out, const T &_value)
+{
+  _out.write(reinterpret_cast<const char *>(&_value), sizeof(T));
+}
+
+//////////////////////////////////////////////////
+/// \brief Read a value written by write().
+template <typename T>
+bool read(std::istream &_in, T &_value)
+{
+  _in.read(reinterpret_cast<char *>(&_value), sizeof(T));
+  return static_cast<bool>(_in);
+}
+
+//////////////////////////////////////////////////
+/// \brief Name of the cache file for a mesh file, from a 64 bit FNV-1a
+/// hash and the size of its content.
+/// \param[in] _fullPath Full path to the mesh file.
+/// \return File name, or empty if the file couldn't be read.
+std::string cacheFileName(const std::string &_fullPath)
+{
+  std::ifstream file(_fullPath, std::ios::binary);
+  if (!file)
+    return "";
+
+  const std::string content((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+
+  uint64_t hash{14695981039346656037ull};
+  for (const char c : content)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+
+  std::ostringstream name;
+  name << std::hex << std::setw(16) << std::setfill('0') << hash << "_"
+       << std::dec << content.size() << ".mesh";
+  return name.str();
+}
+
+//////////////////////////////////////////////////
+/// \brief Read a cached mesh.
+/// \param[in] _cachePath Path to the cache file.
+/// \return The mesh, or nullptr if the file is missing or invalid.
+std::unique_ptr<common::Mesh> readMesh(const std::string &_cachePath)
+{
+  std::ifstream in(_cachePath, std::ios::binary);
+  if (!in)
+    return nullptr;
+
+  char magic[sizeof(kMagic)];
+  in.read(magic, sizeof(magic));
+  if (!in || !std::equal(magic, magic + sizeof(magic), kMagic))
+    return nullptr;
+
+  auto mesh = std::make_unique<common::Mesh>();
+  uint32_t subMeshCount{0};
+  if (!read(in, subMeshCount))
+    return nullptr;
+
+  for (uint32_t s = 0; s < subMeshCount; ++s)
+  {
+    common::SubMesh subMesh;
+
+    uint32_t nameSize{0};
+    if (!read(in, nameSize))
+      return nullptr;
+    std::string name(nameSize, '\0');
+    in.read(&name[0], nameSize);
+    subMesh.SetName(name);
+
+    int32_t primitive{0};
+    if (!read(in, primitive))
+      return nullptr;
+    subMesh.SetPrimitiveType(
+        static_cast<common::SubMesh::PrimitiveType>(primitive));
+
+    uint32_t vertexCount{0};
+    if (!read(in, vertexCount))
+      return nullptr;
+    for (uint32_t i = 0; i < vertexCount; ++i)
+    {
+      double x, y, z;
+      if (!read(in, x) || !read(in, y) || !read(in, z))
+        return nullptr;
+      subMesh.AddVertex(math::Vector3d(x, y, z));
+    }
+
+    uint32_t normalCount{0};
+    if (!read(in, normalCount))
+      return nullptr;
+    for (uint32_t i = 0; i < normalCount; ++i)
+    {
+      double x, y, z;
+      if (!read(in, x) || !read(in, y) || !read(in, z))
+        return nullptr;
+      subMesh.AddNormal(math::Vector3d(x, y, z));
+    }
+
+    uint32_t indexCount{0};
+    if (!read(in, indexCount))
+      return nullptr;
+    for (uint32_t i = 0; i < indexCount; ++i)
+    {
+      uint32_t index{0};
+      if (!read(in, index))
+        return nullptr;
+      subMesh.AddIndex(index);
+    }
+
+    mesh->AddSubMesh(subMesh);
+  }
+
+  return mesh;
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a mesh to the cache. The file is written under a temporary
+/// name and then renamed, so concurrent runs never read a partial file.
+/// \param[in] _cachePath Path to the cache file.
+/// \param[in] _mesh Mesh to be cached.
+void writeMesh(const std::string &_cachePath, const common::Mesh &_mesh)
+{
+  std::ostringstream tmpPath;
+  tmpPath << _cachePath << "." << std::hex << std::random_device()()
+          << ".tmp";
+
+  {
+    std::ofstream out(tmpPath.str(), std::ios::binary);
+    if (!out)
+      return;
+
+    out.write(kMagic, sizeof(kMagic));
+    write(out, static_cast<uint32_t>(_mesh.SubMeshCount()));
+    for (unsigned int s = 0; s < _mesh.SubMeshCount(); ++s)
+    {
+      auto subMesh = _mesh.SubMeshByIndex(s).lock();
+      if (!subMesh)
+      {
+        // Keep the file consistent with the submesh count
+        write(out, uint32_t{0});
+        write(out, static_cast<int32_t>(common::SubMesh::TRIANGLES));
+        write(out, uint32_t{0});
+        write(out, uint32_t{0});
+        write(out, uint32_t{0});
+        continue;
+      }
+
+      const std::string &name = subMesh->Name();
+      write(out, static_cast<uint32_t>(name.size()));
+      out.write(name.data(), name.size());
+
+      write(out, static_cast<int32_t>(subMesh->SubMeshPrimitive()));
+
+      write(out, static_cast<uint32_t>(subMesh->VertexCount()));
+      for (unsigned int i = 0; i < subMesh->VertexCount(); ++i)
+      {
+        auto vertex = subMesh->Vertex(i);
+        write(out, vertex.X());
+        write(out, vertex.Y());
+        write(out, vertex.Z());
+      }
+
+      write(out, static_cast<uint32_t>(subMesh->NormalCount()));
+      for (unsigned int i = 0; i < subMesh->NormalCount(); ++i)
+      {
+        auto normal = subMesh->Normal(i);
+        write(out, normal.X());
+        write(out, normal.Y());
+        write(out, normal.Z());
+      }
+
+      write(out, static_cast<uint32_t>(subMesh->IndexCount()));
+      for (unsigned int i = 0; i < subMesh->IndexCount(); ++i)
+        write(out, static_cast<uint32_t>(subMesh->Index(i)));
+    }
+
+    if (!out)
+    {
+      out.close();
+      common::removeFile(tmpPath.str());
+      return;
+    }
+  }
+
+  if (std::rename(tmpPath.str().c_str(), _cachePath.c_str()) != 0)
+    common::removeFile(tmpPath.str());
+}
+}
+
+//////////////////////////////////////////////////
+MeshCache::MeshCache(const std::string &_directory)
+{
+  if (!_directory.empty())
+    this->directory = common::joinPaths(_directory, "collision_meshes");
+}
+
+//////////////////////////////////////////////////
+MeshCache::ParsedMesh MeshCache::Parse(const std::string &_fullPath) const
+{
+  ParsedMesh parsed;
+  std::string cachePath;
+  if (!this->directory.empty())
+  {
+    auto fileName = cacheFileName(_fullPath);
+    if (!fileName.empty())
+      cachePath = common::joinPaths(this->directory, fileName);
+  }
+
+  if (!cachePath.empty())
+  {
+    parsed.mesh = readMesh(cachePath);
+    if (parsed.mesh)
+    {
+      igndbg << "Loaded collision mesh [" << _fullPath << "] from cache ["
+             << cachePath << "]." << std::endl;
+      parsed.mesh->SetName(_fullPath);
+      return parsed;
+    }
+  }
+
+  parsed.mesh = parseMeshFile(_fullPath);
+  if (!parsed.mesh)
+    return parsed;
+  parsed.complete = true;
+
+  if (!cachePath.empty() && (common::isDirectory(this->directory) ||
+      common::createDirectories(this->directory)))
+  {
+    writeMesh(cachePath, *parsed.mesh);
+  }
+  return parsed;
+}
+
+//////////////////////////////////////////////////
+const common::Mesh *MeshCache::Add(const std::string &_fullPath,
+    ParsedMesh _parsed)
+{
+  auto &meshManager = *common::MeshManager::Instance();
+  if (_parsed.complete && !meshManager.HasMesh(_fullPath))
+  {
+    meshManager.AddMesh(_parsed.mesh.release());
+    return meshManager.MeshByName(_fullPath);
+  }
+
+  // Prefer a complete mesh registered meanwhile
+  if (meshManager.HasMesh(_fullPath))
+    return meshManager.MeshByName(_fullPath);
+
+  auto &mesh = this->meshes[_fullPath];
+  mesh = std::move(_parsed.mesh);
+  return mesh.get();
+}
+
+//////////////////////////////////////////////////
+bool MeshCache::Has(const std::string &_fullPath) const
+{
+  return this->meshes.find(_fullPath) != this->meshes.end() ||
+      common::MeshManager::Instance()->HasMesh(_fullPath);
+}
+
+//////////////////////////////////////////////////
+const common::Mesh *MeshCache::Load(const std::string &_fullPath)
+{
+  auto it = this->meshes.find(_fullPath);
+  if (it != this->meshes.end())
+    return it->second.get();
+
+  auto &meshManager = *common::MeshManager::Instance();
+  if (meshManager.HasMesh(_fullPath))
+    return meshManager.MeshByName(_fullPath);
+
+  return this->Add(_fullPath, this->Parse(_fullPath));
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_PHYSICS_MESHCACHE_HH_
+#define IGNITION_GAZEBO_SYSTEMS_PHYSICS_MESHCACHE_HH_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <ignition/common/Mesh.hh>
+#include <ignition/gazebo/config.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief Loads collision meshes, keeping a copy of their geometry on disk
+  /// so that later runs don't need to parse the original files again.
+  ///
+  /// Cached meshes are stored in a compact binary format under
+  /// `<directory>/collision_meshes`, named after a hash of the original
+  /// file's content, so they are shared by all worlds and runs using the
+  /// same assets. Only the geometry needed for collisions is kept:
+  /// vertices, normals, indices and primitive type of each submesh. Meshes
+  /// read from the disk cache are therefore owned by the cache instead of
+  /// being registered with common::MeshManager, so that rendering doesn't
+  /// get them without their texture coordinates and materials.
+  ///
+  /// Parse doesn't access common::MeshManager nor the meshes of the cache,
+  /// so it can be called from any thread. The other functions must be
+  /// called from a single thread, since common::MeshManager isn't thread
+  /// safe.
+  class MeshCache
+  {
+    /// \brief A mesh parsed by Parse, to be added with Add.
+    public: struct ParsedMesh
+    {
+      /// \brief The mesh, or nullptr if it couldn't be parsed.
+      std::unique_ptr<common::Mesh> mesh;
+
+      /// \brief True if the mesh was parsed from the original file, false
+      /// if it only has the geometry kept by the disk cache.
+      bool complete{false};
+    };
+
+    /// \brief Constructor
+    /// \param[in] _directory Resource cache directory. The disk cache is
+    /// disabled if empty.
+    public: explicit MeshCache(const std::string &_directory = "");
+
+    /// \brief Parse a mesh, from the disk cache if possible, or else from
+    /// the original file, which is then added to the disk cache.
+    /// \param[in] _fullPath Full path to the mesh file.
+    /// \return The parsed mesh.
+    public: ParsedMesh Parse(const std::string &_fullPath) const;
+
+    /// \brief Add a mesh returned by Parse. Complete meshes are registered
+    /// with common::MeshManager under their full path, as
+    /// common::MeshManager::Load does, unless it already has one. Other
+    /// meshes are kept by the cache.
+    /// \param[in] _fullPath Full path to the mesh file.
+    /// \param[in] _parsed Parsed mesh. Failures are remembered, so the mesh
+    /// isn't parsed again.
+    /// \return The mesh, or nullptr if it couldn't be parsed.
+    public: const common::Mesh *Add(const std::string &_fullPath,
+                                    ParsedMesh _parsed);
+
+    /// \brief Whether a mesh was already loaded or added, even if it
+    /// failed to load.
+    /// \param[in] _fullPath Full path to the mesh file.
+    /// \return True if Load wouldn't need to parse the mesh.
+    public: bool Has(const std::string &_fullPath) const;
+
+    /// \brief Load a mesh, parsing and adding it if it wasn't loaded yet.
+    /// \param[in] _fullPath Full path to the mesh file.
+    /// \return The mesh, or nullptr if it couldn't be loaded.
+    public: const common::Mesh *Load(const std::string &_fullPath);
+
+    /// \brief Directory where cached meshes are stored, or empty if the
+    /// disk cache is disabled.
+    private: std::string directory;
+
+    /// \brief Meshes kept by the cache, keyed by full path. Meshes which
+    /// failed to load are null.
+    private: std::unordered_map<std::string,
+        std::unique_ptr<common::Mesh>> meshes;
+  };
+  }
+}
+}
+}
+
+#endif
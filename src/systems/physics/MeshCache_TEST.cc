@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/SubMesh.hh>
+
+#include "ignition/gazebo/test_config.hh"
+
+#include "MeshCache.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+TEST(MeshCache, CacheHitKeepsRegisteredMesh)
+{
+  const std::string directory = common::joinPaths(PROJECT_BINARY_PATH,
+      "test", "MeshCache_TEST");
+  common::removeAll(directory);
+  ASSERT_TRUE(common::createDirectories(directory));
+
+  // Two copies of the same mesh, so the second one is a cache hit which
+  // isn't registered with the mesh manager yet
+  const std::string source = common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "media", "duck.dae");
+  const std::string first = common::joinPaths(directory, "first.dae");
+  const std::string second = common::joinPaths(directory, "second.dae");
+  ASSERT_TRUE(common::copyFile(source, first));
+  ASSERT_TRUE(common::copyFile(source, second));
+
+  systems::MeshCache cache(directory);
+  auto *firstMesh = cache.Load(first);
+  ASSERT_NE(nullptr, firstMesh);
+
+  auto &meshManager = *common::MeshManager::Instance();
+  auto *cachedMesh = cache.Load(second);
+  ASSERT_NE(nullptr, cachedMesh);
+  EXPECT_EQ(firstMesh->VertexCount(), cachedMesh->VertexCount());
+  EXPECT_EQ(firstMesh->IndexCount(), cachedMesh->IndexCount());
+
+  // The geometry-only mesh isn't registered, so the mesh manager still
+  // parses the whole file for rendering
+  EXPECT_EQ(nullptr, meshManager.MeshByName(second));
+  auto *fullMesh = meshManager.Load(second);
+  ASSERT_NE(nullptr, fullMesh);
+  EXPECT_NE(cachedMesh, fullMesh);
+  EXPECT_LT(0u, fullMesh->MaterialCount());
+  auto subMesh = fullMesh->SubMeshByIndex(0).lock();
+  ASSERT_NE(nullptr, subMesh);
+  EXPECT_LT(0u, subMesh->TexCoordCount());
+
+  // Later loads return the same cached mesh
+  EXPECT_EQ(cachedMesh, cache.Load(second));
+
+  common::removeAll(directory);
+}
+
+/////////////////////////////////////////////////
+TEST(MeshCache, ParseDoesntRegister)
+{
+  const std::string directory = common::joinPaths(PROJECT_BINARY_PATH,
+      "test", "MeshCache_TEST_parse");
+  common::removeAll(directory);
+  ASSERT_TRUE(common::createDirectories(directory));
+
+  const std::string path = common::joinPaths(directory, "parsed.dae");
+  ASSERT_TRUE(common::copyFile(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "media", "duck.dae"), path));
+
+  // Parsing happens off the mesh manager, which is only touched by Add
+  systems::MeshCache cache(directory);
+  auto &meshManager = *common::MeshManager::Instance();
+  auto parsed = cache.Parse(path);
+  ASSERT_NE(nullptr, parsed.mesh);
+  EXPECT_TRUE(parsed.complete);
+  EXPECT_FALSE(meshManager.HasMesh(path));
+  EXPECT_FALSE(cache.Has(path));
+
+  auto *mesh = cache.Add(path, std::move(parsed));
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_TRUE(cache.Has(path));
+  EXPECT_EQ(mesh, meshManager.MeshByName(path));
+
+  // Missing files are remembered as failures
+  const std::string missing = common::joinPaths(directory, "missing.dae");
+  auto failed = cache.Parse(missing);
+  EXPECT_EQ(nullptr, failed.mesh);
+  EXPECT_EQ(nullptr, cache.Add(missing, std::move(failed)));
+  EXPECT_TRUE(cache.Has(missing));
+  EXPECT_EQ(nullptr, cache.Load(missing));
+
+  common::removeAll(directory);
+}
@@ -23,13 +23,16 @@
 #include <ignition/msgs/Utility.hh>
 
 #include <algorithm>
+#include <chrono>
+#include <future>
 #include <iostream>
-#include <deque>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
-#include <ignition/common/MeshManager.hh>
 #include <ignition/common/Profiler.hh>
 #include <ignition/common/SystemPaths.hh>
 #include <ignition/math/AxisAlignedBox.hh>
@@ -58,6 +61,7 @@
 
 // Components
 #include "ignition/gazebo/components/AngularAcceleration.hh"
+#include "ignition/gazebo/components/AtRest.hh"
 #include "ignition/gazebo/components/AngularVelocity.hh"
 #include "ignition/gazebo/components/AngularVelocityCmd.hh"
 #include "ignition/gazebo/components/AxisAlignedBox.hh"
@@ -74,6 +78,7 @@
 #include "ignition/gazebo/components/JointAxis.hh"
 #include "ignition/gazebo/components/JointPosition.hh"
 #include "ignition/gazebo/components/JointPositionReset.hh"
+#include "ignition/gazebo/components/JointStates.hh"
 #include "ignition/gazebo/components/JointType.hh"
 #include "ignition/gazebo/components/JointVelocity.hh"
 #include "ignition/gazebo/components/JointVelocityCmd.hh"
@@ -89,6 +94,7 @@
 #include "ignition/gazebo/components/ExternalWorldWrenchCmd.hh"
 #include "ignition/gazebo/components/JointForceCmd.hh"
 #include "ignition/gazebo/components/PhysicsEnginePlugin.hh"
+#include "ignition/gazebo/components/ResourceCache.hh"
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/PoseCmd.hh"
 #include "ignition/gazebo/components/SelfCollide.hh"
@@ -97,6 +103,9 @@
 #include "ignition/gazebo/components/ThreadPitch.hh"
 #include "ignition/gazebo/components/World.hh"
 
+#include "EntityRecords.hh"
+#include "MeshCache.hh"
+
 using namespace ignition;
 using namespace ignition::gazebo::systems;
 namespace components = ignition::gazebo::components;
@@ -149,9 +158,24 @@ class ignition::gazebo::systems::PhysicsPrivate
   /// \param[in] _ecm Constant reference to ECM.
   public: void RemovePhysicsEntities(const EntityComponentManager &_ecm);
 
+  /// \brief Attach the links of a detachable joint in the physics engine.
+  /// \param[in] _entity Detachable joint entity.
+  /// \param[in] _info Links and type of the joint.
+  /// \return False if the physics engine doesn't support detachable joints.
+  public: bool AttachDetachableJoint(const Entity &_entity,
+      const components::DetachableJointInfo &_info);
+
+  /// \brief Detach the links of a detachable joint in the physics engine.
+  /// \param[in] _entity Detachable joint entity.
+  /// \return False if the physics engine doesn't support detaching joints.
+  public: bool DetachDetachableJoint(const Entity &_entity);
+
   /// \brief Update physics from components
   /// \param[in] _ecm Constant reference to ECM.
-  public: void UpdatePhysics(EntityComponentManager &_ecm);
+  /// \param[in] _substep True when re-applying commands before a substep
+  /// other than the first one of an iteration. Joint resets are skipped.
+  public: void UpdatePhysics(EntityComponentManager &_ecm,
+      const bool _substep = false);
 
   /// \brief Step the simulationrfor each world
   /// \param[in] _dt Duration
@@ -180,26 +204,28 @@ class ignition::gazebo::systems::PhysicsPrivate
   public: ignition::math::Pose3d RelativePose(const Entity &_from,
       const Entity &_to, const EntityComponentManager &_ecm) const;
 
-  /// \brief A map between world entity ids in the ECM to World Entities in
-  /// ign-physics.
-  public: std::unordered_map<Entity, WorldPtrType> entityWorldMap;
+  /// \brief Get the top level model of an entity, and the entity's pose
+  /// relative to that model. Physics only moves top level models and
+  /// non-canonical links, so results are memoized for the rest of the
+  /// UpdateSim call and shared by all links in the same model.
+  /// \param[in] _entity A model, or a link whose pose is fixed in its model.
+  /// \param[in] _ecm Constant reference to ECM.
+  /// \return Top level model and pose of _entity relative to it.
+  public: std::pair<Entity, math::Pose3d> PoseFromTopLevelModel(
+      const Entity &_entity, const EntityComponentManager &_ecm);
 
-  /// \brief A map between model entity ids in the ECM to Model Entities in
-  /// ign-physics.
-  public: std::unordered_map<Entity, ModelPtrType> entityModelMap;
+  /// \brief Top level models that moved since bounding boxes were last
+  /// populated. Only tracked while some model has an AxisAlignedBox.
+  public: std::unordered_set<Entity> boundingBoxDirtyModels;
 
-  /// \brief A map between link entity ids in the ECM to Link Entities in
-  /// ign-physics.
-  public: std::unordered_map<Entity, LinkPtrType> entityLinkMap;
+  /// \brief Results of PoseFromTopLevelModel, cleared on every UpdateSim.
+  public: std::unordered_map<Entity, std::pair<Entity, math::Pose3d>>
+      topLevelPoseCache;
 
-  /// \brief Reverse of entityLinkMap. This is used for finding the Entity
-  /// associated with a physics Link
+  /// \brief Reverse of the link handles of physicsEntities. This is used
+  /// for finding the Entity associated with a physics Link
   public: std::unordered_map<LinkPtrType, Entity> linkEntityMap;
 
-  /// \brief A map between model entity ids in the ECM to whether its battery
-  /// has drained.
-  public: std::unordered_map<Entity, bool> entityOffMap;
-
   /// \brief used to store whether physics objects have been created.
   public: bool initialized = false;
 
@@ -251,12 +277,18 @@ class ignition::gazebo::systems::PhysicsPrivate
 
   /// \brief A map between shape entity ids in the ECM to Shape Entities in
   /// ign-physics
-  /// All shapes on this map are also in `entityCollisionMap`. The difference
+  /// All shapes on this map are also in `physicsEntities`. The difference
   /// is that here they've been casted for
   /// `FrictionPyramidSlipComplianceFeatureList`.
   public: std::unordered_map<Entity, ShapeSlipParamPtrType>
       entityShapeSlipParamMap;
 
+  /// \brief Slip compliance last set on each shape in the engine, so that
+  /// unchanged commands aren't applied again. Commands for shapes which
+  /// aren't in the engine yet are applied once they are.
+  public: std::unordered_map<Entity, std::vector<double>>
+      appliedSlipCompliance;
+
   //////////////////////////////////////////////////
   // Joints
 
@@ -276,13 +308,9 @@ class ignition::gazebo::systems::PhysicsPrivate
   public: using ModelJointPtrType = ignition::physics::ModelPtr<
             ignition::physics::FeaturePolicy3d, JointFeatureList>;
 
-  /// \brief A map between joint entity ids in the ECM to Joint Entities in
-  /// ign-physics
-  public: std::unordered_map<Entity, JointPtrType> entityJointMap;
-
   /// \brief A map between model entity ids in the ECM to Model Entities in
   /// ign-physics, with attach feature.
-  /// All models on this map are also in `entityModelMap`. The difference is
+  /// All models on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `JointFeatureList`.
   public: std::unordered_map<Entity, ModelJointPtrType> entityModelJointMap;
 
@@ -306,14 +334,14 @@ class ignition::gazebo::systems::PhysicsPrivate
 
   /// \brief A map between joint entity ids in the ECM to Joint Entities in
   /// ign-physics, with detach feature.
-  /// All joints on this map are also in `entityJointMap`. The difference is
+  /// All joints on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `physics::DetachJointFeature`.
   public: std::unordered_map<Entity, JointDetachableJointPtrType>
       entityJointDetachableJointMap;
 
   /// \brief A map between link entity ids in the ECM to Link Entities in
   /// ign-physics, with attach feature.
-  /// All links on this map are also in `entityLinkMap`. The difference is
+  /// All links on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `DetachableJointFeatureList`.
   public: std::unordered_map<Entity, LinkDetachableJointPtrType>
       entityLinkDetachableJointMap;
@@ -343,23 +371,155 @@ class ignition::gazebo::systems::PhysicsPrivate
   public: using WorldShapeType = ignition::physics::World<
             ignition::physics::FeaturePolicy3d, CollisionFeatureList>;
 
-  /// \brief A map between collision entity ids in the ECM to Shape Entities in
-  /// ign-physics.
-  public: std::unordered_map<Entity, ShapePtrType> entityCollisionMap;
-
   /// \brief A map between shape entities in ign-physics to collision entities
-  /// in the ECM. This is the reverse map of entityCollisionMap.
+  /// in the ECM. This is the reverse of the collision handles of
+  /// physicsEntities.
   public: std::unordered_map<ShapePtrType, Entity> collisionEntityMap;
 
+  /// \brief Everything the system keeps about an entity which has a
+  /// counterpart in ign-physics. An entity only has the handle matching its
+  /// type, the others are null.
+  public: struct PhysicsEntity
+  {
+    /// \brief World in ign-physics.
+    public: WorldPtrType world;
+
+    /// \brief Model in ign-physics.
+    public: ModelPtrType model;
+
+    /// \brief Link in ign-physics.
+    public: LinkPtrType link;
+
+    /// \brief Joint in ign-physics, including attached detachable joints.
+    public: JointPtrType joint;
+
+    /// \brief Shape of a collision in ign-physics.
+    public: ShapePtrType collision;
+
+    /// \brief For links, true once their poses were written back.
+    public: bool posesWritten{false};
+
+    /// \brief For links, world pose last written back.
+    public: math::Pose3d writtenPose;
+
+    /// \brief For links, pose of their top level model when writtenPose was
+    /// written. ign-physics doesn't report which bodies moved during a step,
+    /// so links whose poses match these are considered at rest, and their
+    /// Pose components aren't updated.
+    public: math::Pose3d writtenModelPose;
+
+    /// \brief For models, true if their battery has drained.
+    public: bool off{false};
+  };
+
+  /// \brief Worlds in ign-physics, in the order they were created.
+  public: std::vector<WorldPtrType> worlds;
+
+  /// \brief Engine handles and state of entities, by ECM entity. The hot
+  /// loops find everything about an entity with one array access instead
+  /// of probing several hash maps.
+  public: EntityRecords<PhysicsEntity> physicsEntities;
+
+  /// \brief Get the ign-physics world of an entity.
+  /// \param[in] _entity World entity.
+  /// \return The world, null if the entity isn't a world in ign-physics.
+  /// Invalidated when entities are added or removed.
+  public: const WorldPtrType &EngineWorld(const Entity _entity) const;
+
+  /// \brief Get the ign-physics model of an entity.
+  /// \param[in] _entity Model entity.
+  /// \return The model, null if the entity isn't a model in ign-physics.
+  /// Invalidated when entities are added or removed.
+  public: const ModelPtrType &EngineModel(const Entity _entity) const;
+
+  /// \brief Get the ign-physics link of an entity.
+  /// \param[in] _entity Link entity.
+  /// \return The link, null if the entity isn't a link in ign-physics.
+  /// Invalidated when entities are added or removed.
+  public: const LinkPtrType &EngineLink(const Entity _entity) const;
+
+  /// \brief Get the ign-physics joint of an entity.
+  /// \param[in] _entity Joint entity.
+  /// \return The joint, null if the entity isn't a joint in ign-physics.
+  /// Invalidated when entities are added or removed.
+  public: const JointPtrType &EngineJoint(const Entity _entity) const;
+
+  /// \brief Get the ign-physics shape of a collision entity.
+  /// \param[in] _entity Collision entity.
+  /// \return The shape, null if the entity isn't a collision in
+  /// ign-physics. Invalidated when entities are added or removed.
+  public: const ShapePtrType &EngineCollision(const Entity _entity) const;
+
+  /// \brief Number of engine steps taken per simulation iteration.
+  public: unsigned int substeps{1};
+
+  /// \brief Number of steps a model's links must stay still before the
+  /// model is marked with an AtRest component. Zero never marks models.
+  public: unsigned int restSteps{0};
+
+  /// \brief Number of consecutive steps in which none of the links of each
+  /// non-static top level model moved, up to restSteps.
+  public: std::unordered_map<Entity, unsigned int> modelStillSteps;
+
+  /// \brief Loads collision meshes, through the on-disk cache if the world
+  /// has a resource cache directory.
+  public: std::unique_ptr<MeshCache> meshCache{
+      std::make_unique<MeshCache>()};
+
+  /// \brief Meshes being parsed by worker threads, keyed by full path.
+  /// They're added to the mesh cache on the simulation thread.
+  public: std::unordered_map<std::string,
+      std::future<MeshCache::ParsedMesh>> meshLoads;
+
+  /// \brief Mesh collisions waiting for their mesh to be loaded, and the
+  /// full path of the mesh.
+  public: std::vector<std::pair<Entity, std::string>> pendingMeshCollisions;
+
+  /// \brief Whether collision meshes are loaded in the background. The
+  /// initial world is created synchronously, so this is only enabled
+  /// afterwards, for entities spawned at runtime.
+  public: bool asyncMeshLoading{false};
+
+  /// \brief A contact point as seen from a collision that has a
+  /// ContactSensorData component.
+  public: struct CollisionContact
+  {
+    /// \brief Collision with the ContactSensorData component.
+    Entity collision1;
+
+    /// \brief The other collision.
+    Entity collision2;
+
+    /// \brief Order in which the physics engine reported the contact.
+    std::size_t index;
+
+    /// \brief Contact position in world coordinates.
+    math::Vector3d position;
+  };
+
+  /// \brief Contacts collected by UpdateCollisions, sorted by collision.
+  /// Kept between steps so its storage is reused.
+  public: std::vector<CollisionContact> contactBuffer;
+
+  /// \brief Collisions with a ContactSensorData component, refreshed by
+  /// UpdateCollisions. Kept between steps so its storage is reused.
+  public: std::unordered_set<Entity> contactSensorCollisions;
+
+  /// \brief Collisions touched by each collision with a ContactSensorData
+  /// component in the last step, sorted. The component is only flagged as
+  /// changed when these begin or end touching, so that systems can skip
+  /// contacts which are stable, like objects resting on a shelf.
+  public: std::unordered_map<Entity, std::vector<Entity>> contactPairs;
+
   /// \brief A map between link entity ids in the ECM to Link Entities in
   /// ign-physics, with attach feature.
-  /// All links on this map are also in `entityLinkMap`. The difference is
+  /// All links on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `CollisionFeatureList`.
   public: std::unordered_map<Entity, LinkShapePtrType> entityLinkCollisionMap;
 
   /// \brief A map between world entity ids in the ECM to World Entities in
   /// ign-physics, with attach feature.
-  /// All worlds on this map are also in `entityWorldMap`. The difference is
+  /// All worlds on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `CollisionFeatureList`.
   public: std::unordered_map<Entity, WorldShapePtrType> entityWorldCollisionMap;
 
@@ -377,7 +537,7 @@ class ignition::gazebo::systems::PhysicsPrivate
 
   /// \brief A map between collision entity ids in the ECM to Shape Entities in
   /// ign-physics, with collision filtering feature.
-  /// All links on this map are also in `entityCollisionMap`. The difference is
+  /// All links on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `CollisionMaskFeatureList`.
   public: std::unordered_map<Entity, ShapeFilterMaskPtrType> entityShapeMaskMap;
 
@@ -394,7 +554,7 @@ class ignition::gazebo::systems::PhysicsPrivate
 
   /// \brief A map between link entity ids in the ECM to Link Entities in
   /// ign-physics, with force feature.
-  /// All links on this map are also in `entityLinkMap`. The difference is
+  /// All links on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `LinkForceFeatureList`.
   public: std::unordered_map<Entity, LinkForcePtrType> entityLinkForceMap;
 
@@ -412,7 +572,7 @@ class ignition::gazebo::systems::PhysicsPrivate
 
   /// \brief A map between model entity ids in the ECM to Model Entities in
   /// ign-physics, with bounding box feature.
-  /// All models on this map are also in `entityModelMap`. The difference is
+  /// All models on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `BoundingBoxFeatureList`.
   public: std::unordered_map<Entity, ModelBoundingBoxPtrType>
       entityModelBoundingBoxMap;
@@ -430,7 +590,7 @@ class ignition::gazebo::systems::PhysicsPrivate
 
   /// \brief A map between joint entity ids in the ECM to Joint Entities in
   /// ign-physics, with velocity command feature.
-  /// All joints on this map are also in `entityJointMap`. The difference is
+  /// All joints on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `JointVelocityCommandFeatureList`.
   public: std::unordered_map<Entity, JointVelocityCommandPtrType>
       entityJointVelocityCommandMap;
@@ -470,7 +630,7 @@ class ignition::gazebo::systems::PhysicsPrivate
 
   /// \brief A map between link entity ids in the ECM to Link Entities in
   /// ign-physics, with mesh feature.
-  /// All links on this map are also in `entityLinkMap`. The difference is
+  /// All links on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `MeshFeatureList`.
   public: std::unordered_map<Entity, LinkMeshPtrType>
       entityLinkMeshMap;
@@ -493,14 +653,14 @@ class ignition::gazebo::systems::PhysicsPrivate
 
   /// \brief A map between model entity ids in the ECM to Model Entities in
   /// ign-physics, with Nested Model feature.
-  /// All models on this map are also in `entityModelMap`. The difference is
+  /// All models on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `ConstructedSdfNestedModel`.
   public: std::unordered_map<Entity, ModelNestedModelPtrType>
       entityModelNestedModelMap;
 
   /// \brief A map between model entity ids in the ECM to World Entities in
   /// ign-physics, with Nested Model feature.
-  /// All models on this map are also in `entityWorldMap`. The difference is
+  /// All models on this map are also in `physicsEntities`. The difference is
   /// that here they've been casted for `ConstructedSdfNestedModel`.
   public: std::unordered_map<Entity, WorldNestedModelPtrType>
       entityWorldNestedModelMap;
@@ -539,6 +699,29 @@ void Physics::Configure(const Entity &_entity,
     pluginLib = "libignition-physics-dartsim-plugin.so";
   }
 
+  // Engine steps per iteration
+  if (_sdf->HasElement("substeps"))
+  {
+    auto substeps = _sdf->Get<int>("substeps");
+    if (substeps >= 1)
+    {
+      this->dataPtr->substeps = static_cast<unsigned int>(substeps);
+    }
+    else
+    {
+      ignerr << "Invalid <substeps> [" << substeps
+             << "], must be at least 1. Using 1." << std::endl;
+    }
+  }
+
+  this->dataPtr->restSteps = _sdf->Get<unsigned int>("rest_steps",
+      this->dataPtr->restSteps).first;
+
+  // Cache collision meshes on disk, next to other resources
+  auto cacheComp = _ecm.Component<components::ResourceCache>(_entity);
+  if (cacheComp)
+    this->dataPtr->meshCache = std::make_unique<MeshCache>(cacheComp->Data());
+
   // Update component
   if (!engineComp)
   {
@@ -643,11 +826,24 @@ void Physics::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
   if (this->dataPtr->engine)
   {
     this->dataPtr->CreatePhysicsEntities(_ecm);
+    this->dataPtr->asyncMeshLoading = true;
     this->dataPtr->UpdatePhysics(_ecm);
     // Only step if not paused.
     if (!_info.paused)
     {
-      this->dataPtr->Step(_info.dt);
+      // Engines clear commanded forces after stepping, so commands are
+      // applied again before each substep. The last substep absorbs the
+      // remainder of the division.
+      const auto substeps = this->dataPtr->substeps;
+      const auto substepDt = _info.dt / substeps;
+      for (unsigned int i = 0; i < substeps; ++i)
+      {
+        if (i > 0)
+          this->dataPtr->UpdatePhysics(_ecm, true);
+
+        this->dataPtr->Step(i + 1 < substeps ? substepDt :
+            _info.dt - substepDt * (substeps - 1));
+      }
     }
     this->dataPtr->UpdateSim(_ecm);
 
@@ -669,7 +865,7 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
         const components::Gravity *_gravity)->bool
       {
         // Check if world already exists
-        if (this->entityWorldMap.find(_entity) != this->entityWorldMap.end())
+        if (this->EngineWorld(_entity))
         {
           ignwarn << "World entity [" << _entity
                   << "] marked as new, but it's already on the map."
@@ -681,7 +877,8 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
         world.SetName(_name->Data());
         world.SetGravity(_gravity->Data());
         auto worldPtrPhys = this->engine->ConstructWorld(world);
-        this->entityWorldMap.insert(std::make_pair(_entity, worldPtrPhys));
+        this->physicsEntities.Insert(_entity).world = worldPtrPhys;
+        this->worlds.push_back(worldPtrPhys);
 
         return true;
       });
@@ -695,7 +892,7 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
           const components::ParentEntity *_parent)->bool
       {
         // Check if model already exists
-        if (this->entityModelMap.find(_entity) != this->entityModelMap.end())
+        if (this->EngineModel(_entity))
         {
           ignwarn << "Model entity [" << _entity
                   << "] marked as new, but it's already on the map."
@@ -720,10 +917,10 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
         }
 
         // check if parent is a world
-        auto worldIt = this->entityWorldMap.find(_parent->Data());
-        if (worldIt != this->entityWorldMap.end())
+        const auto &worldPhys = this->EngineWorld(_parent->Data());
+        if (worldPhys)
         {
-          auto worldPtrPhys = worldIt->second;
+          auto worldPtrPhys = worldPhys;
 
           // Use the ConstructNestedModel feature for nested models
           if (model.ModelCount() > 0)
@@ -745,21 +942,21 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
               return true;
             }
             auto modelPtrPhys = nestedModelFeature->ConstructNestedModel(model);
-            this->entityModelMap.insert(std::make_pair(_entity, modelPtrPhys));
+            this->physicsEntities.Insert(_entity).model = modelPtrPhys;
           }
           else
           {
             auto modelPtrPhys = worldPtrPhys->ConstructModel(model);
-            this->entityModelMap.insert(std::make_pair(_entity, modelPtrPhys));
+            this->physicsEntities.Insert(_entity).model = modelPtrPhys;
           }
         }
         // check if parent is a model (nested model)
         else
         {
-          auto parentIt = this->entityModelMap.find(_parent->Data());
-          if (parentIt != this->entityModelMap.end())
+          const auto &parentPhys = this->EngineModel(_parent->Data());
+          if (parentPhys)
           {
-            auto parentPtrPhys = parentIt->second;
+            auto parentPtrPhys = parentPhys;
 
             auto nestedModelFeature = entityCast(_parent->Data(), parentPtrPhys,
                 this->entityModelNestedModelMap);
@@ -788,8 +985,7 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
             auto modelPtrPhys = nestedModelFeature->ConstructNestedModel(model);
             if (modelPtrPhys)
             {
-              this->entityModelMap.insert(
-                  std::make_pair(_entity, modelPtrPhys));
+              this->physicsEntities.Insert(_entity).model = modelPtrPhys;
             }
             else
             {
@@ -818,7 +1014,7 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
         const components::ParentEntity *_parent)->bool
       {
         // Check if link already exists
-        if (this->entityLinkMap.find(_entity) != this->entityLinkMap.end())
+        if (this->EngineLink(_entity))
         {
           ignwarn << "Link entity [" << _entity
                   << "] marked as new, but it's already on the map."
@@ -829,28 +1025,28 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
         // TODO(anyone) Don't load links unless they have collisions
 
         // Check if parent model exists
-        if (this->entityModelMap.find(_parent->Data())
-            == this->entityModelMap.end())
+        if (!this->EngineModel(_parent->Data()))
         {
           ignwarn << "Link's parent entity [" << _parent->Data()
                   << "] not found on model map." << std::endl;
           return true;
         }
-        auto modelPtrPhys = this->entityModelMap.at(_parent->Data());
+        auto modelPtrPhys = this->EngineModel(_parent->Data());
 
         sdf::Link link;
         link.SetName(_name->Data());
         link.SetRawPose(_pose->Data());
 
         // get link inertial
-        auto inertial = _ecm.Component<components::Inertial>(_entity);
+        const components::Inertial *inertial =
+            _ecm.Component<components::Inertial>(_entity);
         if (inertial)
         {
           link.SetInertial(inertial->Data());
         }
 
         auto linkPtrPhys = modelPtrPhys->ConstructLink(link);
-        this->entityLinkMap.insert(std::make_pair(_entity, linkPtrPhys));
+        this->physicsEntities.Insert(_entity).link = linkPtrPhys;
         this->linkEntityMap.insert(std::make_pair(linkPtrPhys, _entity));
 
         return true;
@@ -859,10 +1055,7 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
   // We don't need to add visuals to the physics engine.
 
   // collisions
-  _ecm.EachNew<components::Collision, components::Name, components::Pose,
-            components::Geometry, components::CollisionElement,
-            components::ParentEntity>(
-      [&](const Entity &_entity,
+  auto createCollision = [&](const Entity &_entity,
           const components::Collision *,
           const components::Name *_name,
           const components::Pose *_pose,
@@ -870,8 +1063,7 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
           const components::CollisionElement *_collElement,
           const components::ParentEntity *_parent) -> bool
       {
-        if (this->entityCollisionMap.find(_entity) !=
-            this->entityCollisionMap.end())
+        if (this->EngineCollision(_entity))
         {
            ignwarn << "Collision entity [" << _entity
                    << "] marked as new, but it's already on the map."
@@ -880,14 +1072,13 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
         }
 
         // Check if parent link exists
-        if (this->entityLinkMap.find(_parent->Data())
-            == this->entityLinkMap.end())
+        if (!this->EngineLink(_parent->Data()))
         {
           ignwarn << "Collision's parent entity [" << _parent->Data()
                   << "] not found on link map." << std::endl;
           return true;
         }
-        auto linkPtrPhys = this->entityLinkMap.at(_parent->Data());
+        auto linkPtrPhys = this->EngineLink(_parent->Data());
 
         // Make a copy of the collision DOM so we can set its pose which has
         // been resolved and is now expressed w.r.t the parent link of the
@@ -908,9 +1099,28 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
             return true;
           }
 
-          auto &meshManager = *ignition::common::MeshManager::Instance();
           auto fullPath = asFullPath(meshSdf->Uri(), meshSdf->FilePath());
-          auto *mesh = meshManager.Load(fullPath);
+
+          // Parse new meshes on a worker thread and create the collision once
+          // the mesh is ready, so that spawning doesn't stall the step. The
+          // worker doesn't touch common::MeshManager, which isn't thread
+          // safe.
+          if (this->asyncMeshLoading && !this->meshCache->Has(fullPath))
+          {
+            if (this->meshLoads.find(fullPath) == this->meshLoads.end())
+            {
+              const MeshCache *meshCache = this->meshCache.get();
+              this->meshLoads[fullPath] = std::async(std::launch::async,
+                  [meshCache, fullPath]()
+                  {
+                    return meshCache->Parse(fullPath);
+                  });
+            }
+            this->pendingMeshCollisions.emplace_back(_entity, fullPath);
+            return true;
+          }
+
+          auto *mesh = this->meshCache->Load(fullPath);
           if (nullptr == mesh)
           {
             ignwarn << "Failed to load mesh from [" << fullPath
@@ -980,12 +1190,64 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
           }
         }
 
-        this->entityCollisionMap.insert(
-            std::make_pair(_entity, collisionPtrPhys));
+        this->physicsEntities.Insert(_entity).collision = collisionPtrPhys;
         this->collisionEntityMap.insert(
             std::make_pair(collisionPtrPhys, _entity));
         return true;
-      });
+      };
+
+  // Add the meshes which finished parsing, on this thread
+  for (auto it = this->meshLoads.begin(); it != this->meshLoads.end();)
+  {
+    if (it->second.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready)
+    {
+      this->meshCache->Add(it->first, it->second.get());
+      it = this->meshLoads.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  // Create the collisions whose meshes finished loading
+  std::vector<std::pair<Entity, std::string>> readyMeshCollisions;
+  for (auto it = this->pendingMeshCollisions.begin();
+       it != this->pendingMeshCollisions.end();)
+  {
+    if (this->meshLoads.find(it->second) != this->meshLoads.end())
+    {
+      ++it;
+      continue;
+    }
+    readyMeshCollisions.push_back(*it);
+    it = this->pendingMeshCollisions.erase(it);
+  }
+
+  for (const auto &pending : readyMeshCollisions)
+  {
+    const Entity entity = pending.first;
+    auto collisionComp = _ecm.Component<components::Collision>(entity);
+    auto nameComp = _ecm.Component<components::Name>(entity);
+    auto poseComp = _ecm.Component<components::Pose>(entity);
+    auto geomComp = _ecm.Component<components::Geometry>(entity);
+    auto collElementComp =
+        _ecm.Component<components::CollisionElement>(entity);
+    auto parentComp = _ecm.Component<components::ParentEntity>(entity);
+
+    // The collision may have been removed while its mesh was loading
+    if (collisionComp && nameComp && poseComp && geomComp &&
+        collElementComp && parentComp)
+    {
+      createCollision(entity, collisionComp, nameComp, poseComp, geomComp,
+          collElementComp, parentComp);
+    }
+  }
+
+  _ecm.EachNew<components::Collision, components::Name, components::Pose,
+            components::Geometry, components::CollisionElement,
+            components::ParentEntity>(createCollision);
 
   // joints
   _ecm.EachNew<components::Joint, components::Name, components::JointType,
@@ -1003,7 +1265,7 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
           const components::ChildLinkName *_childLinkName) -> bool
       {
         // Check if joint already exists
-        if (this->entityJointMap.find(_entity) != this->entityJointMap.end())
+        if (this->EngineJoint(_entity))
         {
           ignwarn << "Joint entity [" << _entity
                   << "] marked as new, but it's already on the map."
@@ -1012,14 +1274,13 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
         }
 
         // Check if parent model exists
-        if (this->entityModelMap.find(_parentModel->Data())
-            == this->entityModelMap.end())
+        if (!this->EngineModel(_parentModel->Data()))
         {
           ignwarn << "Joint's parent entity [" << _parentModel->Data()
                   << "] not found on model map." << std::endl;
           return true;
         }
-        auto modelPtrPhys = this->entityModelMap.at(_parentModel->Data());
+        auto modelPtrPhys = this->EngineModel(_parentModel->Data());
 
         auto modelJointFeature = entityCast(_parentModel->Data(), modelPtrPhys,
             this->entityModelJointMap);
@@ -1065,7 +1326,7 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
         {
           // Some joints may not be supported, so only add them to the map if
           // the physics entity is valid
-          this->entityJointMap.insert(std::make_pair(_entity, jointPtrPhys));
+          this->physicsEntities.Insert(_entity).joint = jointPtrPhys;
         }
         return true;
       });
@@ -1074,8 +1335,7 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
       [&](const Entity & _entity, const components::BatterySoC *)->bool
       {
         // Parent entity of battery is model entity
-        this->entityOffMap.insert(std::make_pair(
-          _ecm.ParentEntity(_entity), false));
+        this->physicsEntities.Insert(_ecm.ParentEntity(_entity)).off = false;
         return true;
       });
 
@@ -1084,85 +1344,149 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
       [&](const Entity &_entity,
           const components::DetachableJoint *_jointInfo) -> bool
       {
-        if (_jointInfo->Data().jointType != "fixed")
-        {
-          ignerr << "Detachable joint type [" << _jointInfo->Data().jointType
-                 << "] is currently not supported" << std::endl;
+        // Disabled joints are attached once they're enabled
+        if (!_jointInfo->Data().enabled)
           return true;
-        }
+
         // Check if joint already exists
-        if (this->entityJointMap.find(_entity) != this->entityJointMap.end())
+        if (this->EngineJoint(_entity))
         {
           ignwarn << "Joint entity [" << _entity
                   << "] marked as new, but it's already on the map."
                   << std::endl;
           return true;
         }
+        return this->AttachDetachableJoint(_entity, _jointInfo->Data());
+      });
 
-        // Check if the link entities exist in the physics engine
-        auto parentLinkPhysIt =
-            this->entityLinkMap.find(_jointInfo->Data().parentLink);
-        if (parentLinkPhysIt == this->entityLinkMap.end())
-        {
-          ignwarn << "DetachableJoint's parent link entity ["
-                  << _jointInfo->Data().parentLink << "] not found in link map."
-                  << std::endl;
-          return true;
-        }
+  // Detachable joints which were enabled or disabled keep their entity, so
+  // the links are attached and detached here instead of when the entity is
+  // created or removed.
+  _ecm.EachChanged<components::DetachableJoint>(
+      [&](const Entity &_entity,
+          const components::DetachableJoint *_jointInfo,
+          ComponentState) -> bool
+      {
+        bool attached = this->EngineJoint(_entity).Valid();
+        if (_jointInfo->Data().enabled && !attached)
+          return this->AttachDetachableJoint(_entity, _jointInfo->Data());
+        if (!_jointInfo->Data().enabled && attached)
+          return this->DetachDetachableJoint(_entity);
+        return true;
+      });
+}
 
-        auto childLinkEntity = _jointInfo->Data().childLink;
+//////////////////////////////////////////////////
+bool PhysicsPrivate::AttachDetachableJoint(const Entity &_entity,
+    const components::DetachableJointInfo &_info)
+{
+  if (_info.jointType != "fixed")
+  {
+    ignerr << "Detachable joint type [" << _info.jointType
+           << "] is currently not supported" << std::endl;
+    return true;
+  }
 
-        // Get child link
-        auto childLinkIt = this->entityLinkMap.find(childLinkEntity);
-        if (childLinkIt == this->entityLinkMap.end())
-        {
-          ignwarn << "Failed to find joint's child link [" << childLinkEntity
-                  << "]." << std::endl;
-          return true;
-        }
+  // Check if the link entities exist in the physics engine
+  const auto &parentLinkPhys = this->EngineLink(_info.parentLink);
+  if (!parentLinkPhys)
+  {
+    ignwarn << "DetachableJoint's parent link entity ["
+            << _info.parentLink << "] not found in link map."
+            << std::endl;
+    return true;
+  }
 
-        auto childLinkDetachableJointFeature = entityCast(childLinkEntity,
-            childLinkIt->second, this->entityLinkDetachableJointMap);
-        if (!childLinkDetachableJointFeature)
-        {
-          static bool informed{false};
-          if (!informed)
-          {
-            igndbg << "Attempting to create a detachable joint, but the physics"
-                   << " engine doesn't support feature "
-                   << "[AttachFixedJointFeature]. Detachable joints will be "
-                   << "ignored." << std::endl;
-            informed = true;
-          }
+  auto childLinkEntity = _info.childLink;
 
-          // Break Each call since no DetachableJoints can be processed
-          return false;
-        }
+  // Get child link
+  const auto &childLinkPhys = this->EngineLink(childLinkEntity);
+  if (!childLinkPhys)
+  {
+    ignwarn << "Failed to find joint's child link [" << childLinkEntity
+            << "]." << std::endl;
+    return true;
+  }
+
+  auto childLinkDetachableJointFeature = entityCast(childLinkEntity,
+      childLinkPhys, this->entityLinkDetachableJointMap);
+  if (!childLinkDetachableJointFeature)
+  {
+    static bool informed{false};
+    if (!informed)
+    {
+      igndbg << "Attempting to create a detachable joint, but the physics"
+             << " engine doesn't support feature "
+             << "[AttachFixedJointFeature]. Detachable joints will be "
+             << "ignored." << std::endl;
+      informed = true;
+    }
 
-        const auto poseParent =
-            parentLinkPhysIt->second->FrameDataRelativeToWorld().pose;
-        const auto poseChild =
-            childLinkDetachableJointFeature->FrameDataRelativeToWorld().pose;
+    // Break Each call since no DetachableJoints can be processed
+    return false;
+  }
 
-        // Pose of child relative to parent
-        auto poseParentChild = poseParent.inverse() * poseChild;
-        auto jointPtrPhys = childLinkDetachableJointFeature->AttachFixedJoint(
-            parentLinkPhysIt->second);
-        if (jointPtrPhys.Valid())
-        {
-          // We let the joint be at the origin of the child link.
-          jointPtrPhys->SetTransformFromParent(poseParentChild);
+  const auto poseParent =
+      parentLinkPhys->FrameDataRelativeToWorld().pose;
+  const auto poseChild =
+      childLinkDetachableJointFeature->FrameDataRelativeToWorld().pose;
 
-          igndbg << "Creating detachable joint [" << _entity << "]"
-                 << std::endl;
-          this->entityJointMap.insert(std::make_pair(_entity, jointPtrPhys));
-        }
-        else
-        {
-          ignwarn << "DetachableJoint could not be created." << std::endl;
-        }
-        return true;
-      });
+  // Pose of child relative to parent
+  auto poseParentChild = poseParent.inverse() * poseChild;
+  auto jointPtrPhys = childLinkDetachableJointFeature->AttachFixedJoint(
+      parentLinkPhys);
+  if (jointPtrPhys.Valid())
+  {
+    // We let the joint be at the origin of the child link.
+    jointPtrPhys->SetTransformFromParent(poseParentChild);
+
+    igndbg << "Creating detachable joint [" << _entity << "]"
+           << std::endl;
+    this->physicsEntities.Insert(_entity).joint = jointPtrPhys;
+  }
+  else
+  {
+    ignwarn << "DetachableJoint could not be created." << std::endl;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool PhysicsPrivate::DetachDetachableJoint(const Entity &_entity)
+{
+  const auto &jointPhys = this->EngineJoint(_entity);
+  if (!jointPhys)
+  {
+    ignwarn << "Failed to find joint [" << _entity
+            << "]." << std::endl;
+    return true;
+  }
+
+  auto castEntity = entityCast(_entity, jointPhys,
+      this->entityJointDetachableJointMap);
+  if (!castEntity)
+  {
+    static bool informed{false};
+    if (!informed)
+    {
+      igndbg << "Attempting to detach a joint, but the physics "
+             << "engine doesn't support feature "
+             << "[DetachJointFeature]. Joint won't be detached."
+             << std::endl;
+      informed = true;
+    }
+
+    // Break Each call since no DetachableJoints can be processed
+    return false;
+  }
+
+  igndbg << "Detaching joint [" << _entity << "]" << std::endl;
+  castEntity->Detach();
+
+  // The entity may be attached again, which creates a new joint
+  this->entityJointDetachableJointMap.erase(_entity);
+  this->physicsEntities.Erase(_entity);
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -1179,9 +1503,10 @@ void PhysicsPrivate::RemovePhysicsEntities(const EntityComponentManager &_ecm)
       [&](const Entity &_entity, const components::Model *
           /* _model */) -> bool
       {
-        // Remove model if found
-        auto modelIt = this->entityModelMap.find(_entity);
-        if (modelIt != this->entityModelMap.end())
+        // Remove model if found. Erasing records moves others, so handles
+        // are copied before that.
+        auto modelPhys = this->EngineModel(_entity);
+        if (modelPhys)
         {
           // Remove child links, collisions and joints first
           for (const auto &childLink :
@@ -1190,83 +1515,65 @@ void PhysicsPrivate::RemovePhysicsEntities(const EntityComponentManager &_ecm)
             for (const auto &childCollision :
                  _ecm.ChildrenByComponents(childLink, components::Collision()))
             {
-              auto collIt = this->entityCollisionMap.find(childCollision);
-              if (collIt != this->entityCollisionMap.end())
+              const auto &collPhys = this->EngineCollision(childCollision);
+              if (collPhys)
               {
-                this->collisionEntityMap.erase(collIt->second);
-                this->entityCollisionMap.erase(collIt);
+                this->collisionEntityMap.erase(collPhys);
+                this->physicsEntities.Erase(childCollision);
               }
+              this->appliedSlipCompliance.erase(childCollision);
             }
             // First erase the entry associated with this link from the
-            // linkEntityMap which is the reverse of entityLinkMap
-            auto linkPhysIt = this->entityLinkMap.find(childLink);
-            if (linkPhysIt != this->entityLinkMap.end())
+            // linkEntityMap which is the reverse of the link handles
+            const auto &linkPhys = this->EngineLink(childLink);
+            if (linkPhys)
             {
-              this->linkEntityMap.erase(linkPhysIt->second);
+              this->linkEntityMap.erase(linkPhys);
             }
-            this->entityLinkMap.erase(childLink);
+            this->physicsEntities.Erase(childLink);
           }
 
           for (const auto &childJoint :
                _ecm.ChildrenByComponents(_entity, components::Joint()))
           {
-            this->entityJointMap.erase(childJoint);
+            this->physicsEntities.Erase(childJoint);
           }
 
           // Remove the model from the physics engine
-          modelIt->second->Remove();
-          this->entityModelMap.erase(_entity);
+          modelPhys->Remove();
+          this->physicsEntities.Erase(_entity);
+          this->modelStillSteps.erase(_entity);
         }
         return true;
       });
 
   _ecm.EachRemoved<components::DetachableJoint>(
-      [&](const Entity &_entity, const components::DetachableJoint *) -> bool
+      [&](const Entity &_entity,
+          const components::DetachableJoint *_jointInfo) -> bool
       {
-        auto jointIt = this->entityJointMap.find(_entity);
-        if (jointIt == this->entityJointMap.end())
+        // Disabled joints were already detached
+        if (!_jointInfo->Data().enabled &&
+            !this->EngineJoint(_entity))
         {
-          ignwarn << "Failed to find joint [" << _entity
-                  << "]." << std::endl;
           return true;
         }
-
-        auto castEntity = entityCast(_entity, jointIt->second,
-            this->entityJointDetachableJointMap);
-        if (!castEntity)
-        {
-          static bool informed{false};
-          if (!informed)
-          {
-            igndbg << "Attempting to detach a joint, but the physics "
-                   << "engine doesn't support feature "
-                   << "[DetachJointFeature]. Joint won't be detached."
-                   << std::endl;
-            informed = true;
-          }
-
-          // Break Each call since no DetachableJoints can be processed
-          return false;
-        }
-
-        igndbg << "Detaching joint [" << _entity << "]" << std::endl;
-        castEntity->Detach();
-        return true;
+        return this->DetachDetachableJoint(_entity);
       });
 }
 
 //////////////////////////////////////////////////
-void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
+void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm,
+    const bool _substep)
 {
   IGN_PROFILE("PhysicsPrivate::UpdatePhysics");
   // Battery state
+  bool anyModelOff{false};
   _ecm.Each<components::BatterySoC>(
       [&](const Entity & _entity, const components::BatterySoC *_bat)
       {
-        if (_bat->Data() <= 0)
-          entityOffMap[_ecm.ParentEntity(_entity)] = true;
-        else
-          entityOffMap[_ecm.ParentEntity(_entity)] = false;
+        const bool off = _bat->Data() <= 0;
+        this->physicsEntities.Insert(_ecm.ParentEntity(_entity)).off = off;
+        anyModelOff |= off;
         return true;
       });
 
@@ -1275,48 +1582,52 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
       [&](const Entity &_entity, const components::Joint *,
           const components::Name *_name)
       {
-        auto jointIt = this->entityJointMap.find(_entity);
-        if (jointIt == this->entityJointMap.end())
+        const auto &jointPhys = this->EngineJoint(_entity);
+        if (!jointPhys)
           return true;
 
-        // Model is out of battery
-        if (this->entityOffMap[_ecm.ParentEntity(_entity)])
+        // Model is out of battery. Batteries are usually charged, so joints
+        // don't look up their model unless one of them ran out.
+        const PhysicsEntity *model = anyModelOff ?
+            this->physicsEntities.Find(_ecm.ParentEntity(_entity)) : nullptr;
+        if (model && model->off)
         {
-          std::size_t nDofs = jointIt->second->GetDegreesOfFreedom();
+          std::size_t nDofs = jointPhys->GetDegreesOfFreedom();
           for (std::size_t i = 0; i < nDofs; ++i)
           {
-            jointIt->second->SetForce(i, 0);
+            jointPhys->SetForce(i, 0);
           }
           return true;
         }
 
-        auto posReset = _ecm.Component<components::JointPositionReset>(
-            _entity);
-        auto velReset = _ecm.Component<components::JointVelocityReset>(
-            _entity);
+        // Resets only apply before the first substep of an iteration
+        auto posReset = _substep ? nullptr :
+            _ecm.Component<components::JointPositionReset>(_entity);
+        auto velReset = _substep ? nullptr :
+            _ecm.Component<components::JointVelocityReset>(_entity);
 
         // Reset the velocity
         if (velReset)
         {
           auto& jointVelocity = velReset->Data();
 
-          if (jointVelocity.size() != jointIt->second->GetDegreesOfFreedom())
+          if (jointVelocity.size() != jointPhys->GetDegreesOfFreedom())
           {
             ignwarn << "There is a mismatch in the degrees of freedom "
                     << "between Joint [" << _name->Data() << "(Entity="
                     << _entity << ")] and its JointVelocityReset "
                     << "component. The joint has "
-                    << jointIt->second->GetDegreesOfFreedom()
+                    << jointPhys->GetDegreesOfFreedom()
                     << " while the component has "
                     << jointVelocity.size() << ".\n";
             }
 
             std::size_t nDofs = std::min(
-                jointVelocity.size(), jointIt->second->GetDegreesOfFreedom());
+                jointVelocity.size(), jointPhys->GetDegreesOfFreedom());
 
             for (std::size_t i = 0; i < nDofs; ++i)
             {
-              jointIt->second->SetVelocity(i, jointVelocity[i]);
+              jointPhys->SetVelocity(i, jointVelocity[i]);
             }
         }
 
@@ -1325,21 +1636,21 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
         {
           auto &jointPosition = posReset->Data();
 
-          if (jointPosition.size() != jointIt->second->GetDegreesOfFreedom())
+          if (jointPosition.size() != jointPhys->GetDegreesOfFreedom())
           {
             ignwarn << "There is a mismatch in the degrees of freedom "
                     << "between Joint [" << _name->Data() << "(Entity="
                     << _entity << ")] and its JointPositionyReset "
                     << "component. The joint has "
-                    << jointIt->second->GetDegreesOfFreedom()
+                    << jointPhys->GetDegreesOfFreedom()
                     << " while the component has "
                     << jointPosition.size() << ".\n";
             }
             std::size_t nDofs = std::min(
-                jointPosition.size(), jointIt->second->GetDegreesOfFreedom());
+                jointPosition.size(), jointPhys->GetDegreesOfFreedom());
             for (std::size_t i = 0; i < nDofs; ++i)
             {
-              jointIt->second->SetPosition(i, jointPosition[i]);
+              jointPhys->SetPosition(i, jointPosition[i]);
             }
         }
 
@@ -1348,26 +1659,26 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
 
         if (force)
         {
-          if (force->Data().size() != jointIt->second->GetDegreesOfFreedom())
+          if (force->Data().size() != jointPhys->GetDegreesOfFreedom())
           {
             ignwarn << "There is a mismatch in the degrees of freedom between "
                     << "Joint [" << _name->Data() << "(Entity=" << _entity
                     << ")] and its JointForceCmd component. The joint has "
-                    << jointIt->second->GetDegreesOfFreedom() << " while the "
+                    << jointPhys->GetDegreesOfFreedom() << " while the "
                     << " component has " << force->Data().size() << ".\n";
           }
           std::size_t nDofs = std::min(force->Data().size(),
-                                       jointIt->second->GetDegreesOfFreedom());
+                                       jointPhys->GetDegreesOfFreedom());
           for (std::size_t i = 0; i < nDofs; ++i)
           {
-            jointIt->second->SetForce(i, force->Data()[i]);
+            jointPhys->SetForce(i, force->Data()[i]);
           }
         }
         // Only set joint velocity if joint force is not set.
         // If both the cmd and reset components are found, cmd is ignored.
         else if (velCmd)
         {
-          auto velocityCmd = velCmd->Data();
+          const auto &velocityCmd = velCmd->Data();
 
           if (velReset)
           {
@@ -1379,18 +1690,18 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
             return true;
           }
 
-          if (velocityCmd.size() != jointIt->second->GetDegreesOfFreedom())
+          if (velocityCmd.size() != jointPhys->GetDegreesOfFreedom())
           {
             ignwarn << "There is a mismatch in the degrees of freedom"
                     << " between Joint [" << _name->Data()
                     << "(Entity=" << _entity<< ")] and its "
                     << "JointVelocityCmd component. The joint has "
-                    << jointIt->second->GetDegreesOfFreedom()
+                    << jointPhys->GetDegreesOfFreedom()
                     << " while the component has "
                     << velocityCmd.size() << ".\n";
           }
 
-          auto jointVelFeature = entityCast(_entity, jointIt->second,
+          auto jointVelFeature = entityCast(_entity, jointPhys,
               this->entityJointVelocityCommandMap);
           if (!jointVelFeature)
           {
@@ -1399,7 +1710,7 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
 
           std::size_t nDofs = std::min(
             velocityCmd.size(),
-            jointIt->second->GetDegreesOfFreedom());
+            jointPhys->GetDegreesOfFreedom());
 
           for (std::size_t i = 0; i < nDofs; ++i)
           {
@@ -1415,15 +1726,15 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
       [&](const Entity &_entity,
           const components::ExternalWorldWrenchCmd *_wrenchComp)
       {
-        auto linkIt = this->entityLinkMap.find(_entity);
-        if (linkIt == this->entityLinkMap.end())
+        const auto &linkPhys = this->EngineLink(_entity);
+        if (!linkPhys)
         {
           ignwarn << "Failed to find link [" << _entity
                   << "]." << std::endl;
           return true;
         }
 
-        auto linkForceFeature = entityCast(_entity, linkIt->second,
+        auto linkForceFeature = entityCast(_entity, linkPhys,
             this->entityLinkForceMap);
         if (!linkForceFeature)
         {
@@ -1450,12 +1761,14 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
       });
 
   // Update model pose
-  _ecm.Each<components::Model, components::WorldPoseCmd>(
+  _ecm.Each<components::Model, components::WorldPoseCmd,
+            Optional<components::Static>>(
       [&](const Entity &_entity, const components::Model *,
-          const components::WorldPoseCmd *_poseCmd)
+          const components::WorldPoseCmd *_poseCmd,
+          const components::Static *_staticComp)
       {
-        auto modelIt = this->entityModelMap.find(_entity);
-        if (modelIt == this->entityModelMap.end())
+        const auto &modelPhys = this->EngineModel(_entity);
+        if (!modelPhys)
           return true;
 
         // world pose cmd currently not supported for nested models
@@ -1471,7 +1784,7 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
 
         // TODO(addisu) Store the free group instead of searching for it at
         // every iteration
-        auto freeGroup = modelIt->second->FindFreeGroup();
+        auto freeGroup = modelPhys->FindFreeGroup();
         if (!freeGroup)
           return true;
 
@@ -1489,11 +1802,10 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
 
         freeGroup->SetWorldPose(math::eigen3::convert(_poseCmd->Data() *
                                 linkPose));
+        this->boundingBoxDirtyModels.insert(_entity);
 
         // Process pose commands for static models here, as one-time changes
-        const components::Static *staticComp =
-          _ecm.Component<components::Static>(_entity);
-        if (staticComp && staticComp->Data())
+        if (_staticComp && _staticComp->Data())
         {
           auto worldPoseComp = _ecm.Component<components::Pose>(_entity);
           if (worldPoseComp)
@@ -1509,19 +1821,31 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
         return true;
       });
 
-  // Slip compliance on Collisions
+  // Slip compliance on Collisions. The engine keeps the last value set on
+  // a shape, so commands equal to the last one applied are skipped. Writers
+  // don't need to mark the command as changed.
   _ecm.Each<components::SlipComplianceCmd>(
       [&](const Entity &_entity,
           const components::SlipComplianceCmd *_slipCmdComp)
       {
-        auto shapeIt = this->entityCollisionMap.find(_entity);
-        if (shapeIt == this->entityCollisionMap.end())
+        if (_slipCmdComp->Data().size() != 2)
+          return true;
+
+        auto applied = this->appliedSlipCompliance.find(_entity);
+        if (applied != this->appliedSlipCompliance.end() &&
+            applied->second == _slipCmdComp->Data())
+        {
+          return true;
+        }
+
+        const auto &shapePhys = this->EngineCollision(_entity);
+        if (!shapePhys)
         {
           ignwarn << "Failed to find shape [" << _entity << "]." << std::endl;
           return true;
         }
 
-        auto slipComplianceShape = entityCast(_entity, shapeIt->second,
+        auto slipComplianceShape = entityCast(_entity, shapePhys,
             this->entityShapeSlipParamMap);
 
         if (!slipComplianceShape)
@@ -1534,13 +1858,11 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
           return false;
         }
 
-        if (_slipCmdComp->Data().size() == 2)
-        {
-          slipComplianceShape->SetPrimarySlipCompliance(
-              _slipCmdComp->Data()[0]);
-          slipComplianceShape->SetSecondarySlipCompliance(
-              _slipCmdComp->Data()[1]);
-        }
+        slipComplianceShape->SetPrimarySlipCompliance(
+            _slipCmdComp->Data()[0]);
+        slipComplianceShape->SetSecondarySlipCompliance(
+            _slipCmdComp->Data()[1]);
+        this->appliedSlipCompliance[_entity] = _slipCmdComp->Data();
 
         return true;
       });
@@ -1550,8 +1872,8 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
       [&](const Entity &_entity, const components::Model *,
           const components::AngularVelocityCmd *_angularVelocityCmd)
       {
-        auto modelIt = this->entityModelMap.find(_entity);
-        if (modelIt == this->entityModelMap.end())
+        const auto &modelPhys = this->EngineModel(_entity);
+        if (!modelPhys)
           return true;
 
         // angular vel cmd currently not supported for nested models
@@ -1562,7 +1884,7 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
           return true;
         }
 
-        auto freeGroup = modelIt->second->FindFreeGroup();
+        auto freeGroup = modelPhys->FindFreeGroup();
         if (!freeGroup)
           return true;
 
@@ -1598,8 +1920,8 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
       [&](const Entity &_entity, const components::Model *,
           const components::LinearVelocityCmd *_linearVelocityCmd)
       {
-        auto modelIt = this->entityModelMap.find(_entity);
-        if (modelIt == this->entityModelMap.end())
+        const auto &modelPhys = this->EngineModel(_entity);
+        if (!modelPhys)
           return true;
 
         // linear vel cmd currently not supported for nested models
@@ -1610,7 +1932,7 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
           return true;
         }
 
-        auto freeGroup = modelIt->second->FindFreeGroup();
+        auto freeGroup = modelPhys->FindFreeGroup();
         if (!freeGroup)
           return true;
 
@@ -1660,19 +1982,27 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
 
   // Populate bounding box info
   // Only compute bounding box if component exists to avoid unnecessary
-  // computations
+  // computations. Boxes are only recomputed when their top level model moved
+  // or their component holds an invalid box, which is how consumers request
+  // a fresh one.
   _ecm.Each<components::Model, components::AxisAlignedBox>(
       [&](const Entity &_entity, const components::Model *,
           components::AxisAlignedBox *_bbox)
       {
-        auto modelIt = this->entityModelMap.find(_entity);
-        if (modelIt == this->entityModelMap.end())
+        if (_bbox->Data().Min().X() <= _bbox->Data().Max().X() &&
+            !this->boundingBoxDirtyModels.count(topLevelModel(_entity, _ecm)))
+        {
+          return true;
+        }
+
+        const auto &modelPhys = this->EngineModel(_entity);
+        if (!modelPhys)
         {
           ignwarn << "Failed to find model [" << _entity << "]." << std::endl;
           return true;
         }
 
-        auto bbModel = entityCast(_entity, modelIt->second,
+        auto bbModel = entityCast(_entity, modelPhys,
             this->entityModelBoundingBoxMap);
         if (!bbModel)
         {
@@ -1699,6 +2029,8 @@ void PhysicsPrivate::UpdatePhysics(EntityComponentManager &_ecm)
 
         return true;
       });
+
+  this->boundingBoxDirtyModels.clear();
 }
 
 //////////////////////////////////////////////////
@@ -1711,9 +2043,9 @@ void PhysicsPrivate::Step(const std::chrono::steady_clock::duration &_dt)
 
   input.Get<std::chrono::steady_clock::duration>() = _dt;
 
-  for (auto &world : this->entityWorldMap)
+  for (auto &world : this->worlds)
   {
-    world.second->Step(output, state, input);
+    world->Step(output, state, input);
   }
 }
 
@@ -1753,11 +2085,43 @@ ignition::math::Pose3d PhysicsPrivate::RelativePose(const Entity &_from,
   return transform;
 }
 
+//////////////////////////////////////////////////
+std::pair<Entity, math::Pose3d> PhysicsPrivate::PoseFromTopLevelModel(
+    const Entity &_entity, const EntityComponentManager &_ecm)
+{
+  auto cacheIt = this->topLevelPoseCache.find(_entity);
+  if (cacheIt != this->topLevelPoseCache.end())
+    return cacheIt->second;
+
+  // Parents are resolved first, so each entity in the chain is visited once
+  std::pair<Entity, math::Pose3d> result{_entity, math::Pose3d::Zero};
+  auto parentComp = _ecm.Component<components::ParentEntity>(_entity);
+  if (parentComp && _ecm.Component<components::Model>(parentComp->Data()))
+  {
+    auto parent = this->PoseFromTopLevelModel(parentComp->Data(), _ecm);
+    auto poseComp = _ecm.Component<components::Pose>(_entity);
+    result.first = parent.first;
+    result.second = poseComp ? parent.second * poseComp->Data() :
+        parent.second;
+  }
+
+  this->topLevelPoseCache[_entity] = result;
+  return result;
+}
+
 //////////////////////////////////////////////////
 void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
 {
   IGN_PROFILE("PhysicsPrivate::UpdateSim");
 
+  this->topLevelPoseCache.clear();
+
+  const bool trackBoundingBoxes =
+      _ecm.HasComponentType(components::AxisAlignedBox::typeId);
+
+  // Top level models with links which moved during this step
+  std::unordered_set<Entity> movedModels;
+
   // local pose
   _ecm.Each<components::Link, components::Pose, components::ParentEntity>(
       [&](const Entity &_entity, components::Link * /*_link*/,
@@ -1771,19 +2135,30 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
         if (staticComp && staticComp->Data())
           return true;
 
-        auto linkIt = this->entityLinkMap.find(_entity);
-        if (linkIt != this->entityLinkMap.end())
+        auto physEntity = this->physicsEntities.Find(_entity);
+        if (physEntity && physEntity->link)
         {
           // get top level model of this link
-          auto topLevelModelEnt = topLevelModel(_parent->Data(), _ecm);
+          auto topLevelModelEnt =
+              this->PoseFromTopLevelModel(_parent->Data(), _ecm).first;
 
           auto canonicalLink =
               _ecm.Component<components::CanonicalLink>(_entity);
 
-          auto frameData = linkIt->second->FrameDataRelativeToWorld();
+          auto frameData = physEntity->link->FrameDataRelativeToWorld();
           const auto &worldPose = frameData.pose;
 
-          if (canonicalLink)
+          // Links at rest keep their poses, and aren't marked as changed
+          auto linkWorldPose = math::eigen3::convert(worldPose);
+          auto modelPoseComp =
+              _ecm.Component<components::Pose>(topLevelModelEnt);
+          bool moved = !physEntity->posesWritten ||
+              !this->pose3Eql(physEntity->writtenPose, linkWorldPose) ||
+              (!canonicalLink && modelPoseComp &&
+              !this->pose3Eql(physEntity->writtenModelPose,
+                  modelPoseComp->Data()));
+
+          if (moved && canonicalLink)
           {
             // This is the canonical link, update the top level model.
             // The pose of this link w.r.t its top level model never changes
@@ -1792,9 +2167,8 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
             // pose of this link relative to world so to set the top level
             // model's pose, we have to post-multiply it by the inverse of the
             // transform of the link w.r.t to its top level model.
-            math::Pose3d linkPoseFromTopLevelModel;
-            linkPoseFromTopLevelModel =
-                this->RelativePose(topLevelModelEnt, _entity, _ecm);
+            math::Pose3d linkPoseFromTopLevelModel =
+                this->PoseFromTopLevelModel(_entity, _ecm).second;
 
             // update top level model's pose
             auto mutableModelPose =
@@ -1806,21 +2180,19 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
             _ecm.SetChanged(topLevelModelEnt, components::Pose::typeId,
                 ComponentState::PeriodicChange);
           }
-          else
+          else if (moved)
           {
             // Compute the relative pose of this link from the top level model
             // first get the world pose of the top level model
-            auto worldComp =
-                _ecm.Component<components::ParentEntity>(topLevelModelEnt);
-            // if the worldComp is a nullptr, something is wrong with ECS
-            if (!worldComp)
+            // if the modelPoseComp is a nullptr, something is wrong with ECS
+            if (!modelPoseComp)
             {
-              ignerr << "The parent component of " << topLevelModelEnt
+              ignerr << "The pose component of " << topLevelModelEnt
                      << " could not be found. This should never happen!\n";
               return true;
             }
-            math::Pose3d parentWorldPose =
-                this->RelativePose(worldComp->Data(), _parent->Data(), _ecm);
+            math::Pose3d parentWorldPose = modelPoseComp->Data() *
+                this->PoseFromTopLevelModel(_parent->Data(), _ecm).second;
 
             // Unlike canonical links, pose of regular links can move relative.
             // to the parent. Same for links inside nested models.
@@ -1830,6 +2202,23 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
                 ComponentState::PeriodicChange);
           }
 
+          if (moved && trackBoundingBoxes)
+            this->boundingBoxDirtyModels.insert(topLevelModelEnt);
+
+          if (this->restSteps > 0)
+          {
+            this->modelStillSteps.emplace(topLevelModelEnt, 0);
+            if (moved)
+              movedModels.insert(topLevelModelEnt);
+          }
+
+          if (moved && modelPoseComp)
+          {
+            physEntity->posesWritten = true;
+            physEntity->writtenPose = linkWorldPose;
+            physEntity->writtenModelPose = modelPoseComp->Data();
+          }
+
           // Populate world poses, velocities and accelerations of the link. For
           // now these components are updated only if another system has created
           // the corresponding component on the entity.
@@ -1965,6 +2354,23 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
         return true;
       });
 
+  // Models whose links stayed still for restSteps steps are marked at rest,
+  // so other systems can skip them until they move again
+  for (auto &[model, stillSteps] : this->modelStillSteps)
+  {
+    if (movedModels.find(model) != movedModels.end())
+    {
+      if (stillSteps >= this->restSteps)
+        _ecm.RemoveComponent<components::AtRest>(model);
+      stillSteps = 0;
+    }
+    else if (stillSteps < this->restSteps &&
+        ++stillSteps == this->restSteps)
+    {
+      _ecm.CreateComponent(model, components::AtRest());
+    }
+  }
+
   // pose/velocity/acceleration of non-link entities such as sensors /
   // collisions. These get updated only if another system has created a
   // components::WorldPose component for the entity.
@@ -1982,11 +2388,11 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
           const components::ParentEntity *_parent)->bool
       {
         // check if parent entity is a link, e.g. entity is sensor / collision
-        auto linkIt = this->entityLinkMap.find(_parent->Data());
-        if (linkIt != this->entityLinkMap.end())
+        const auto &linkPhys = this->EngineLink(_parent->Data());
+        if (linkPhys)
         {
           const auto entityFrameData =
-              this->LinkFrameDataAtOffset(linkIt->second, _pose->Data());
+              this->LinkFrameDataAtOffset(linkPhys, _pose->Data());
 
           *_worldPose = components::WorldPose(
               math::eigen3::convert(entityFrameData.pose));
@@ -2004,11 +2410,11 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
           const components::ParentEntity *_parent)->bool
       {
         // check if parent entity is a link, e.g. entity is sensor / collision
-        auto linkIt = this->entityLinkMap.find(_parent->Data());
-        if (linkIt != this->entityLinkMap.end())
+        const auto &linkPhys = this->EngineLink(_parent->Data());
+        if (linkPhys)
         {
           const auto entityFrameData =
-              this->LinkFrameDataAtOffset(linkIt->second, _pose->Data());
+              this->LinkFrameDataAtOffset(linkPhys, _pose->Data());
 
           // set entity world linear velocity
           *_worldLinearVel = components::WorldLinearVelocity(
@@ -2027,11 +2433,11 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
           const components::ParentEntity *_parent)->bool
       {
         // check if parent entity is a link, e.g. entity is sensor / collision
-        auto linkIt = this->entityLinkMap.find(_parent->Data());
-        if (linkIt != this->entityLinkMap.end())
+        const auto &linkPhys = this->EngineLink(_parent->Data());
+        if (linkPhys)
         {
           const auto entityFrameData =
-              this->LinkFrameDataAtOffset(linkIt->second, _pose->Data());
+              this->LinkFrameDataAtOffset(linkPhys, _pose->Data());
 
           auto entityWorldPose = math::eigen3::convert(entityFrameData.pose);
           ignition::math::Vector3d entityWorldAngularVel =
@@ -2053,11 +2459,11 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
           components::LinearAcceleration *_linearAcc,
           const components::ParentEntity *_parent)->bool
       {
-        auto linkIt = this->entityLinkMap.find(_parent->Data());
-        if (linkIt != this->entityLinkMap.end())
+        const auto &linkPhys = this->EngineLink(_parent->Data());
+        if (linkPhys)
         {
           const auto entityFrameData =
-              this->LinkFrameDataAtOffset(linkIt->second, _pose->Data());
+              this->LinkFrameDataAtOffset(linkPhys, _pose->Data());
 
           auto entityWorldPose = math::eigen3::convert(entityFrameData.pose);
           ignition::math::Vector3d entityWorldLinearAcc =
@@ -2098,7 +2504,10 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
     _ecm.RemoveComponent<components::JointVelocityReset>(entity);
   }
 
-  // Clear pending commands
+  // Clear pending commands. Forces, velocities and wrenches only last one
+  // iteration. Slip compliance commands are kept, since the engine keeps the
+  // last value set on a shape and only changed commands are applied, so
+  // systems can leave them untouched until they change.
   _ecm.Each<components::JointForceCmd>(
       [&](const Entity &, components::JointForceCmd *_force) -> bool
       {
@@ -2120,26 +2529,19 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
         return true;
       });
 
-  _ecm.Each<components::SlipComplianceCmd>(
-      [&](const Entity &, components::SlipComplianceCmd *_slip) -> bool
-      {
-        std::fill(_slip->Data().begin(), _slip->Data().end(), 0.0);
-        return true;
-      });
-
   // Update joint positions
   _ecm.Each<components::Joint, components::JointPosition>(
       [&](const Entity &_entity, components::Joint *,
           components::JointPosition *_jointPos) -> bool
       {
-        auto jointIt = this->entityJointMap.find(_entity);
-        if (jointIt != this->entityJointMap.end())
+        const auto &jointPhys = this->EngineJoint(_entity);
+        if (jointPhys)
         {
-          _jointPos->Data().resize(jointIt->second->GetDegreesOfFreedom());
-          for (std::size_t i = 0; i < jointIt->second->GetDegreesOfFreedom();
+          _jointPos->Data().resize(jointPhys->GetDegreesOfFreedom());
+          for (std::size_t i = 0; i < jointPhys->GetDegreesOfFreedom();
                ++i)
           {
-            _jointPos->Data()[i] = jointIt->second->GetPosition(i);
+            _jointPos->Data()[i] = jointPhys->GetPosition(i);
           }
         }
         return true;
@@ -2150,19 +2552,53 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
       [&](const Entity &_entity, components::Joint *,
           components::JointVelocity *_jointVel) -> bool
       {
-        auto jointIt = this->entityJointMap.find(_entity);
-        if (jointIt != this->entityJointMap.end())
+        const auto &jointPhys = this->EngineJoint(_entity);
+        if (jointPhys)
         {
-          _jointVel->Data().resize(jointIt->second->GetDegreesOfFreedom());
-          for (std::size_t i = 0; i < jointIt->second->GetDegreesOfFreedom();
+          _jointVel->Data().resize(jointPhys->GetDegreesOfFreedom());
+          for (std::size_t i = 0; i < jointPhys->GetDegreesOfFreedom();
                ++i)
           {
-            _jointVel->Data()[i] = jointIt->second->GetVelocity(i);
+            _jointVel->Data()[i] = jointPhys->GetVelocity(i);
           }
         }
         return true;
       });
 
+  // Update joint states of whole models, reusing the buffers' storage
+  _ecm.Each<components::Model, components::JointStates>(
+      [&](const Entity &_entity, components::Model *,
+          components::JointStates *_jointStates) -> bool
+      {
+        auto &states = _jointStates->Data();
+        if (states.joints.empty())
+        {
+          states.joints =
+              _ecm.ChildrenByComponents(_entity, components::Joint());
+        }
+
+        states.offsets.clear();
+        states.positions.clear();
+        states.velocities.clear();
+        for (const auto &joint : states.joints)
+        {
+          states.offsets.push_back(states.positions.size());
+
+          const auto &jointPhys = this->EngineJoint(joint);
+          if (!jointPhys)
+            continue;
+
+          for (std::size_t i = 0; i < jointPhys->GetDegreesOfFreedom();
+               ++i)
+          {
+            states.positions.push_back(jointPhys->GetPosition(i));
+            states.velocities.push_back(jointPhys->GetVelocity(i));
+          }
+        }
+        states.offsets.push_back(states.positions.size());
+        return true;
+      });
+
   // TODO(louise) Skip this if there are no collision features
   this->UpdateCollisions(_ecm);
 }
@@ -2186,14 +2622,14 @@ void PhysicsPrivate::UpdateCollisions(EntityComponentManager &_ecm)
     return;
   }
 
-  auto worldIt = this->entityWorldMap.find(worldEntity);
-  if (worldIt == this->entityWorldMap.end())
+  const auto &worldPhys = this->EngineWorld(worldEntity);
+  if (!worldPhys)
   {
     ignwarn << "Failed to find world [" << worldEntity << "]." << std::endl;
     return;
   }
 
-  auto worldCollisionFeature = entityCast(worldEntity, worldIt->second,
+  auto worldCollisionFeature = entityCast(worldEntity, worldPhys,
       this->entityWorldCollisionMap);
   if (!worldCollisionFeature)
   {
@@ -2209,36 +2645,56 @@ void PhysicsPrivate::UpdateCollisions(EntityComponentManager &_ecm)
     return;
   }
 
+  // Only collisions that have a ContactSensorData component need contacts
+  this->contactSensorCollisions.clear();
+  _ecm.Each<components::Collision, components::ContactSensorData>(
+      [&](const Entity &_collEntity, components::Collision *,
+          components::ContactSensorData *) -> bool
+      {
+        this->contactSensorCollisions.insert(_collEntity);
+        return true;
+      });
+
   // Each contact object we get from ign-physics contains the EntityPtrs of the
   // two colliding entities and other data about the contact such as the
-  // position. This map groups contacts so that it is easy to query all the
-  // contacts of one entity.
-  using EntityContactMap = std::unordered_map<Entity,
-      std::deque<const WorldShapeType::ContactPoint *>>;
-
-  // This data structure is essentially a mapping between a pair of entities and
-  // a list of pointers to their contact object. We use a map inside a map to
-  // create msgs::Contact objects conveniently later on.
-  std::unordered_map<Entity, EntityContactMap> entityContactMap;
-
-  // Note that we are temporarily storing pointers to elements in this
-  // ("allContacts") container. Thus, we must make sure it doesn't get destroyed
-  // until the end of this function.
+  // position. Contacts are copied into a flat buffer once for each colliding
+  // entity that needs them, then sorted so that all contacts of one entity,
+  // and within those all contacts with another entity, are contiguous.
+  this->contactBuffer.clear();
   auto allContacts = worldCollisionFeature->GetContactsFromLastStep();
-  for (const auto &contactComposite : allContacts)
+  for (std::size_t i = 0; i < allContacts.size(); ++i)
   {
-    const auto &contact = contactComposite.Get<WorldShapeType::ContactPoint>();
+    const auto &contact =
+        allContacts[i].Get<WorldShapeType::ContactPoint>();
     auto coll1It = this->collisionEntityMap.find(contact.collision1);
     auto coll2It = this->collisionEntityMap.find(contact.collision2);
 
-    if ((coll1It != this->collisionEntityMap.end()) &&
-        (coll2It != this->collisionEntityMap.end()))
+    if ((coll1It == this->collisionEntityMap.end()) ||
+        (coll2It == this->collisionEntityMap.end()))
     {
-      entityContactMap[coll1It->second][coll2It->second].push_back(&contact);
-      entityContactMap[coll2It->second][coll1It->second].push_back(&contact);
+      continue;
+    }
+
+    auto position = math::eigen3::convert(contact.point);
+    if (this->contactSensorCollisions.count(coll1It->second))
+    {
+      this->contactBuffer.push_back(
+          {coll1It->second, coll2It->second, i, position});
+    }
+    if (this->contactSensorCollisions.count(coll2It->second))
+    {
+      this->contactBuffer.push_back(
+          {coll2It->second, coll1It->second, i, position});
     }
   }
 
+  std::sort(this->contactBuffer.begin(), this->contactBuffer.end(),
+      [](const CollisionContact &_a, const CollisionContact &_b)
+      {
+        return std::tie(_a.collision1, _a.collision2, _a.index) <
+               std::tie(_b.collision1, _b.collision2, _b.index);
+      });
+
   // Go through each collision entity that has a ContactData component and
   // set the component value to the list of contacts that correspond to
   // the collision entity
@@ -2246,36 +2702,125 @@ void PhysicsPrivate::UpdateCollisions(EntityComponentManager &_ecm)
       [&](const Entity &_collEntity1, components::Collision *,
           components::ContactSensorData *_contacts) -> bool
       {
-        if (entityContactMap.find(_collEntity1) == entityContactMap.end())
+        // Refill the existing message, so that its contacts and positions
+        // are reused instead of reallocated every step
+        msgs::Contacts &contactsComp = _contacts->Data();
+        contactsComp.Clear();
+
+        auto contactIt = std::lower_bound(this->contactBuffer.begin(),
+            this->contactBuffer.end(), _collEntity1,
+            [](const CollisionContact &_contact, const Entity &_entity)
+            {
+              return _contact.collision1 < _entity;
+            });
+
+        // Compare the touched collisions with the last step's in place
+        auto &pairs = this->contactPairs[_collEntity1];
+        std::size_t pairCount{0};
+        bool pairsChanged{false};
+
+        msgs::Contact *contactMsg{nullptr};
+        Entity collEntity2{kNullEntity};
+        for (; contactIt != this->contactBuffer.end() &&
+            contactIt->collision1 == _collEntity1; ++contactIt)
         {
-          // Clear the last contact data
-          *_contacts = components::ContactSensorData();
-          return true;
-        }
+          if (nullptr == contactMsg || collEntity2 != contactIt->collision2)
+          {
+            collEntity2 = contactIt->collision2;
+            contactMsg = contactsComp.add_contact();
+            contactMsg->mutable_collision1()->set_id(_collEntity1);
+            contactMsg->mutable_collision2()->set_id(contactIt->collision2);
 
-        const auto &contactMap = entityContactMap[_collEntity1];
+            if (pairCount >= pairs.size())
+            {
+              pairs.push_back(collEntity2);
+              pairsChanged = true;
+            }
+            else if (pairs[pairCount] != collEntity2)
+            {
+              pairs[pairCount] = collEntity2;
+              pairsChanged = true;
+            }
+            ++pairCount;
+          }
+          msgs::Set(contactMsg->add_position(), contactIt->position);
+        }
 
-        msgs::Contacts contactsComp;
+        if (pairCount != pairs.size())
+        {
+          pairs.resize(pairCount);
+          pairsChanged = true;
+        }
 
-        for (const auto &[collEntity2, contactData] : contactMap)
+        if (pairsChanged)
         {
-          msgs::Contact *contactMsg = contactsComp.add_contact();
-          contactMsg->mutable_collision1()->set_id(_collEntity1);
-          contactMsg->mutable_collision2()->set_id(collEntity2);
-          for (const auto &contact : contactData)
-          {
-            auto *position = contactMsg->add_position();
-            position->set_x(contact->point.x());
-            position->set_y(contact->point.y());
-            position->set_z(contact->point.z());
-          }
+          _ecm.SetChanged(_collEntity1, components::ContactSensorData::typeId,
+              ComponentState::OneTimeChange);
         }
-        *_contacts = components::ContactSensorData(contactsComp);
 
         return true;
       });
+
+  // Forget collisions which lost their ContactSensorData component
+  if (this->contactPairs.size() > this->contactSensorCollisions.size())
+  {
+    for (auto it = this->contactPairs.begin();
+         it != this->contactPairs.end();)
+    {
+      if (this->contactSensorCollisions.count(it->first) == 0)
+        it = this->contactPairs.erase(it);
+      else
+        ++it;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+const PhysicsPrivate::WorldPtrType &PhysicsPrivate::EngineWorld(
+    const Entity _entity) const
+{
+  static const WorldPtrType kNull;
+  auto physEntity = this->physicsEntities.Find(_entity);
+  return nullptr == physEntity ? kNull : physEntity->world;
 }
 
+//////////////////////////////////////////////////
+const PhysicsPrivate::ModelPtrType &PhysicsPrivate::EngineModel(
+    const Entity _entity) const
+{
+  static const ModelPtrType kNull;
+  auto physEntity = this->physicsEntities.Find(_entity);
+  return nullptr == physEntity ? kNull : physEntity->model;
+}
+
+//////////////////////////////////////////////////
+const PhysicsPrivate::LinkPtrType &PhysicsPrivate::EngineLink(
+    const Entity _entity) const
+{
+  static const LinkPtrType kNull;
+  auto physEntity = this->physicsEntities.Find(_entity);
+  return nullptr == physEntity ? kNull : physEntity->link;
+}
+
+//////////////////////////////////////////////////
+const PhysicsPrivate::JointPtrType &PhysicsPrivate::EngineJoint(
+    const Entity _entity) const
+{
+  static const JointPtrType kNull;
+  auto physEntity = this->physicsEntities.Find(_entity);
+  return nullptr == physEntity ? kNull : physEntity->joint;
+}
+
+//////////////////////////////////////////////////
+const PhysicsPrivate::ShapePtrType &PhysicsPrivate::EngineCollision(
+    const Entity _entity) const
+{
+  static const ShapePtrType kNull;
+  auto physEntity = this->physicsEntities.Find(_entity);
+  return nullptr == physEntity ? kNull : physEntity->collision;
+}
+
+//////////////////////////////////////////////////
 physics::FrameData3d PhysicsPrivate::LinkFrameDataAtOffset(
       const LinkPtrType &_link, const math::Pose3d &_pose) const
 {
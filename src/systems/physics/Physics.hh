@@ -62,6 +62,36 @@ namespace systems
 
   /// \class Physics Physics.hh ignition/gazebo/systems/Physics.hh
   /// \brief Base class for a System.
+  ///
+  /// All models of a world are stepped together in a single engine world,
+  /// because contacts between any of them may appear at any step, and the
+  /// physics engines don't expose their island decomposition. Groups of
+  /// models which never interact, such as a fleet of robots which never
+  /// touch each other, can be stepped in parallel by loading each group
+  /// into its own world, with its own static environment, and stepping the
+  /// worlds in lockstep, see ServerConfig::SetLockstepWorlds.
+  ///
+  /// ## System Parameters
+  ///
+  /// `<engine><filename>`: Physics engine plugin library to load. Defaults
+  /// to DART.
+  ///
+  /// `<substeps>`: Number of engine steps taken per simulation iteration,
+  /// each one `1 / substeps` of the iteration's step size. Commands are
+  /// applied before each engine step, while components are only updated
+  /// after the last one, so other systems keep running at the iteration
+  /// rate. Useful for stiff contacts. Defaults to 1.
+  ///
+  /// `<rest_steps>`: Number of consecutive steps in which none of the links
+  /// of a non-static top level model moved, after which the model gets a
+  /// `components::AtRest` component. The component is removed as soon as
+  /// one of its links moves. ign-physics doesn't report sleeping bodies, so
+  /// links are considered still while their poses are unchanged. Defaults to
+  /// 0, which never marks models.
+  ///
+  /// Collision meshes of entities spawned after the world was loaded are
+  /// loaded on worker threads. Those collisions are added to the engine a
+  /// few steps later, once their meshes are ready.
   class IGNITION_GAZEBO_VISIBLE Physics:
     public System,
     public ISystemConfigure,
@@ -71,15 +71,37 @@ class ignition::gazebo::systems::PosePublisherPrivate
       std::vector<std::pair<Entity, math::Pose3d>> &_poses,
       bool _static);
 
+  /// \brief Remove the poses which haven't changed since they were last
+  /// published.
+  /// \param[in] _ecm Immutable reference to the entity component manager
+  /// \param[in] _consecutive True if poses were last checked on the previous
+  /// iteration, so the changed state of the pose components tells which
+  /// poses changed. Otherwise the poses are compared to the last published
+  /// ones.
+  /// \param[in,out] _poses Poses collected by FillPoses
+  public: void RemoveUnchangedPoses(const EntityComponentManager &_ecm,
+      bool _consecutive,
+      std::vector<std::pair<Entity, math::Pose3d>> &_poses);
+
   /// \brief Publishes poses collected by FillPoses with the provided time
   /// stamp.
   /// \param[in] _poses Pose to publish
   /// \param[in] _stampMsg Time stamp associated with published poses
   /// \param[in] _publisher Publisher to publish the message
+  /// \param[in] _batch True for the pose topic, whose vector message
+  /// gathers the poses of batchSize calls
   public: void PublishPoses(
       std::vector<std::pair<Entity, math::Pose3d>> &_poses,
       const msgs::Time &_stampMsg,
-      transport::Node::Publisher &_publisher);
+      transport::Node::Publisher &_publisher,
+      bool _batch = false);
+
+  /// \brief Fill, filter and publish the poses on the pose topic.
+  /// \param[in] _info Simulation update info
+  /// \param[in] _ecm Immutable reference to the entity component manager
+  /// \param[in] _static True to include static transforms
+  public: void PublishPoseTopic(const UpdateInfo &_info,
+      const EntityComponentManager &_ecm, bool _static);
 
   /// \brief Ignition communication node.
   public: transport::Node node;
@@ -160,10 +182,29 @@ class ignition::gazebo::systems::PosePublisherPrivate
   /// performance.
   public: ignition::msgs::Pose_V poseVMsg;
 
+  /// \brief A variable that gets populated with static poses, kept apart from
+  /// poseVMsg which may hold a batch.
+  public: ignition::msgs::Pose_V staticPoseVMsg;
+
   /// \brief True to publish a vector of poses. False to publish individual pose
   /// msgs.
   public: bool usePoseV = false;
 
+  /// \brief True to publish only the poses which changed
+  public: bool changedOnly = false;
+
+  /// \brief Last published pose of each entity. Only used with changedOnly.
+  public: std::unordered_map<Entity, math::Pose3d> lastPoses;
+
+  /// \brief Iteration at which poses were last checked for changes.
+  public: uint64_t lastCheckIteration{0};
+
+  /// \brief Number of pose publications gathered in each vector message
+  public: unsigned int batchSize{1};
+
+  /// \brief Number of pose publications gathered in poseVMsg so far
+  public: unsigned int batchCount{0};
+
   /// \brief Whether cache variables have been initialized
   public: bool initialized{false};
 };
@@ -241,6 +282,20 @@ void PosePublisher::Configure(const Entity &_entity,
   this->dataPtr->usePoseV =
     _sdf->Get<bool>("use_pose_vector_msg", this->dataPtr->usePoseV).first;
 
+  this->dataPtr->changedOnly =
+    _sdf->Get<bool>("changed_only", this->dataPtr->changedOnly).first;
+
+  int batchSize = _sdf->Get<int>("batch_size", 1).first;
+  if (batchSize > 1 && !this->dataPtr->usePoseV)
+  {
+    ignwarn << "PosePublisher <batch_size> requires <use_pose_vector_msg>. "
+            << "Poses will not be batched." << std::endl;
+  }
+  else if (batchSize > 1)
+  {
+    this->dataPtr->batchSize = static_cast<unsigned int>(batchSize);
+  }
+
   std::string poseTopic = scopedName(_entity, _ecm) + "/pose";
   std::string staticPoseTopic = poseTopic + "_static";
 
@@ -330,24 +385,36 @@ void PosePublisher::PostUpdate(const UpdateInfo &_info,
     }
 
     if (publish)
-    {
-      this->dataPtr->poses.clear();
-      this->dataPtr->FillPoses(_ecm, this->dataPtr->poses, false);
-      this->dataPtr->PublishPoses(this->dataPtr->poses,
-          convert<msgs::Time>(_info.simTime), this->dataPtr->posePub);
-      this->dataPtr->lastPosePubTime = _info.simTime;
-    }
+      this->dataPtr->PublishPoseTopic(_info, _ecm, false);
   }
   // publish all transforms to the same topic
   else if (publish)
   {
-    this->dataPtr->poses.clear();
-    this->dataPtr->FillPoses(_ecm, this->dataPtr->poses, true);
-    this->dataPtr->FillPoses(_ecm, this->dataPtr->poses, false);
-    this->dataPtr->PublishPoses(this->dataPtr->poses,
-        convert<msgs::Time>(_info.simTime), this->dataPtr->posePub);
-    this->dataPtr->lastPosePubTime = _info.simTime;
+    this->dataPtr->PublishPoseTopic(_info, _ecm, true);
+  }
+}
+
+//////////////////////////////////////////////////
+void PosePublisherPrivate::PublishPoseTopic(const UpdateInfo &_info,
+    const EntityComponentManager &_ecm, bool _static)
+{
+  this->poses.clear();
+  if (_static)
+    this->FillPoses(_ecm, this->poses, true);
+  this->FillPoses(_ecm, this->poses, false);
+  this->lastPosePubTime = _info.simTime;
+
+  if (this->changedOnly)
+  {
+    this->RemoveUnchangedPoses(_ecm,
+        _info.iterations == this->lastCheckIteration + 1, this->poses);
+    this->lastCheckIteration = _info.iterations;
+    if (this->poses.empty())
+      return;
   }
+
+  this->PublishPoses(this->poses, convert<msgs::Time>(_info.simTime),
+      this->posePub, true);
 }
 
 //////////////////////////////////////////////////
@@ -488,18 +555,51 @@ void PosePublisherPrivate::FillPoses(const EntityComponentManager &_ecm,
   }
 }
 
+//////////////////////////////////////////////////
+void PosePublisherPrivate::RemoveUnchangedPoses(
+    const EntityComponentManager &_ecm, bool _consecutive,
+    std::vector<std::pair<Entity, math::Pose3d>> &_poses)
+{
+  IGN_PROFILE("PosePublisher::RemoveUnchangedPoses");
+
+  std::size_t kept{0};
+  for (std::size_t i = 0; i < _poses.size(); ++i)
+  {
+    const auto &[entity, pose] = _poses[i];
+    auto lastIt = this->lastPoses.find(entity);
+    if (lastIt == this->lastPoses.end())
+    {
+      this->lastPoses.emplace(entity, pose);
+    }
+    else if ((_consecutive && _ecm.ComponentState(entity,
+        components::Pose::typeId) == ComponentState::NoChange) ||
+        lastIt->second == pose)
+    {
+      continue;
+    }
+    else
+    {
+      lastIt->second = pose;
+    }
+    _poses[kept++] = _poses[i];
+  }
+  _poses.resize(kept);
+}
+
 //////////////////////////////////////////////////
 void PosePublisherPrivate::PublishPoses(
     std::vector<std::pair<Entity, math::Pose3d>> &_poses,
     const msgs::Time &_stampMsg,
-    transport::Node::Publisher &_publisher)
+    transport::Node::Publisher &_publisher,
+    bool _batch)
 {
   IGN_PROFILE("PosePublisher::PublishPoses");
 
   // publish poses
   ignition::msgs::Pose *msg = nullptr;
-  if (this->usePoseV)
-    this->poseVMsg.Clear();
+  auto &vMsg = _batch ? this->poseVMsg : this->staticPoseVMsg;
+  if (this->usePoseV && (!_batch || this->batchCount == 0))
+    vMsg.Clear();
 
   for (const auto &[entity, pose] : _poses)
   {
@@ -509,7 +609,7 @@ void PosePublisherPrivate::PublishPoses(
 
     if (this->usePoseV)
     {
-      msg = this->poseVMsg.add_pose();
+      msg = vMsg.add_pose();
     }
     else
     {
@@ -544,9 +644,14 @@ void PosePublisherPrivate::PublishPoses(
       _publisher.Publish(this->poseMsg);
   }
 
-  // publish pose vector msg
+  // publish pose vector msg once the batch is full
   if (this->usePoseV)
-    _publisher.Publish(this->poseVMsg);
+  {
+    if (_batch && ++this->batchCount < this->batchSize)
+      return;
+    this->batchCount = 0;
+    _publisher.Publish(vMsg);
+  }
 }
 
 IGNITION_ADD_PLUGIN(PosePublisher,
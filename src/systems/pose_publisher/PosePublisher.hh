@@ -63,6 +63,18 @@ namespace systems
   ///                             negative frequency publishes as fast as
   ///                             possible (i.e, at the rate of the simulation
   ///                             step).
+  /// changed_only              : Set to true to publish only the poses that
+  ///                             changed since they were last published on
+  ///                             the "<scoped_entity_name>/pose" topic.
+  ///                             Nothing is published while no pose changes.
+  ///                             Static poses published on the
+  ///                             "<scoped_entity_name>/pose_static" topic are
+  ///                             not affected.
+  /// batch_size                : Number of pose publications to gather in
+  ///                             each ignition::msgs::Pose_V message on the
+  ///                             "<scoped_entity_name>/pose" topic. Each pose
+  ///                             keeps its own time stamp. Requires
+  ///                             use_pose_vector_msg. Defaults to 1.
   class IGNITION_GAZEBO_VISIBLE PosePublisher
       : public System,
         public ISystemConfigure,
@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <ignition/msgs/int32.pb.h>
+#include <ignition/msgs/pose.pb.h>
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Profiler.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/msgs/Utility.hh>
+#include <ignition/plugin/Register.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/Model.hh"
+#include "ignition/gazebo/Util.hh"
+
+#include "RemoteView.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Qt key codes, as published by the KeyPublisher GUI plugin
+enum Key : int32_t
+{
+  kKeyA = 0x41,
+  kKeyD = 0x44,
+  kKeyE = 0x45,
+  kKeyQ = 0x51,
+  kKeyS = 0x53,
+  kKeyW = 0x57,
+  kKeyLeft = 0x01000012,
+  kKeyUp = 0x01000013,
+  kKeyRight = 0x01000014,
+  kKeyDown = 0x01000015
+};
+
+class ignition::gazebo::systems::RemoteViewPrivate
+{
+  /// \brief Callback for key presses
+  /// \param[in] _msg Qt key code
+  public: void OnKey(const msgs::Int32 &_msg);
+
+  /// \brief Callback for pose commands
+  /// \param[in] _msg Pose of the model
+  public: void OnPose(const msgs::Pose &_msg);
+
+  /// \brief Move a pose according to a key
+  /// \param[in] _key Qt key code
+  /// \param[in, out] _pose Pose to move
+  /// \return True if the key moves the pose
+  public: bool ApplyKey(int32_t _key, math::Pose3d &_pose) const;
+
+  /// \brief Ignition communication node.
+  public: transport::Node node;
+
+  /// \brief Model interface
+  public: Model model{kNullEntity};
+
+  /// \brief Distance moved per key press
+  public: double linearStep{0.5};
+
+  /// \brief Angle turned per key press
+  public: double angularStep{0.1};
+
+  /// \brief Keys received since the last update
+  public: std::vector<int32_t> keys;
+
+  /// \brief Pose received since the last update, if any
+  public: std::optional<math::Pose3d> pose;
+
+  /// \brief Protects keys and pose
+  public: std::mutex mutex;
+};
+
+//////////////////////////////////////////////////
+void RemoteViewPrivate::OnKey(const msgs::Int32 &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->keys.push_back(_msg.data());
+}
+
+//////////////////////////////////////////////////
+void RemoteViewPrivate::OnPose(const msgs::Pose &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->pose = msgs::Convert(_msg);
+
+  // Keys received before the pose are relative to the old pose
+  this->keys.clear();
+}
+
+//////////////////////////////////////////////////
+bool RemoteViewPrivate::ApplyKey(int32_t _key, math::Pose3d &_pose) const
+{
+  // Translations are in the model frame, where X is the camera's view
+  // direction
+  math::Vector3d move;
+  switch (_key)
+  {
+    case kKeyW:
+      move.X(this->linearStep);
+      break;
+    case kKeyS:
+      move.X(-this->linearStep);
+      break;
+    case kKeyA:
+      move.Y(this->linearStep);
+      break;
+    case kKeyD:
+      move.Y(-this->linearStep);
+      break;
+    case kKeyQ:
+      move.Z(this->linearStep);
+      break;
+    case kKeyE:
+      move.Z(-this->linearStep);
+      break;
+    // Turn around the world's Z axis, so the horizon stays level
+    case kKeyLeft:
+      _pose.Rot() = math::Quaterniond(0, 0, this->angularStep) * _pose.Rot();
+      return true;
+    case kKeyRight:
+      _pose.Rot() = math::Quaterniond(0, 0, -this->angularStep) *
+          _pose.Rot();
+      return true;
+    // Look up and down around the model's Y axis
+    case kKeyUp:
+      _pose.Rot() = _pose.Rot() * math::Quaterniond(0, -this->angularStep, 0);
+      return true;
+    case kKeyDown:
+      _pose.Rot() = _pose.Rot() * math::Quaterniond(0, this->angularStep, 0);
+      return true;
+    default:
+      return false;
+  }
+
+  _pose.Pos() += _pose.Rot().RotateVector(move);
+  return true;
+}
+
+//////////////////////////////////////////////////
+RemoteView::RemoteView()
+  : dataPtr(std::make_unique<RemoteViewPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+void RemoteView::Configure(const Entity &_entity,
+    const std::shared_ptr<const sdf::Element> &_sdf,
+    EntityComponentManager &_ecm,
+    EventManager &/*_eventMgr*/)
+{
+  this->dataPtr->model = Model(_entity);
+
+  if (!this->dataPtr->model.Valid(_ecm))
+  {
+    ignerr << "RemoteView plugin should be attached to a model entity. "
+           << "Failed to initialize." << std::endl;
+    return;
+  }
+
+  if (!this->dataPtr->model.Static(_ecm))
+  {
+    ignwarn << "RemoteView plugin is attached to a non-static model ["
+            << this->dataPtr->model.Name(_ecm) << "], physics may override "
+            << "the poses it sets." << std::endl;
+  }
+
+  this->dataPtr->linearStep = _sdf->Get<double>("linear_step",
+      this->dataPtr->linearStep).first;
+  this->dataPtr->angularStep = _sdf->Get<double>("angular_step",
+      this->dataPtr->angularStep).first;
+
+  // Subscribe to key presses
+  std::vector<std::string> topics;
+  if (_sdf->HasElement("key_topic"))
+    topics.push_back(_sdf->Get<std::string>("key_topic"));
+  topics.push_back("/keyboard/keypress");
+  auto topic = validTopic(topics);
+  this->dataPtr->node.Subscribe(topic, &RemoteViewPrivate::OnKey,
+      this->dataPtr.get());
+  ignmsg << "RemoteView subscribing to key presses on [" << topic << "]"
+         << std::endl;
+
+  // Subscribe to poses
+  topics.clear();
+  if (_sdf->HasElement("pose_topic"))
+    topics.push_back(_sdf->Get<std::string>("pose_topic"));
+  topics.push_back("/model/" + this->dataPtr->model.Name(_ecm) +
+      "/remote_view/pose");
+  topic = validTopic(topics);
+  this->dataPtr->node.Subscribe(topic, &RemoteViewPrivate::OnPose,
+      this->dataPtr.get());
+  ignmsg << "RemoteView subscribing to poses on [" << topic << "]"
+         << std::endl;
+}
+
+//////////////////////////////////////////////////
+void RemoteView::PreUpdate(const UpdateInfo &/*_info*/,
+    EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("RemoteView::PreUpdate");
+
+  std::vector<int32_t> keys;
+  std::optional<math::Pose3d> pose;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    keys.swap(this->dataPtr->keys);
+    pose.swap(this->dataPtr->pose);
+  }
+
+  // The view also moves while paused, so a paused world can be inspected
+  if (keys.empty() && !pose)
+    return;
+
+  auto entity = this->dataPtr->model.Entity();
+  auto poseComp = _ecm.Component<components::Pose>(entity);
+  if (nullptr == poseComp)
+    return;
+
+  math::Pose3d newPose = pose ? *pose : poseComp->Data();
+  bool changed = pose.has_value();
+  for (auto key : keys)
+    changed = this->dataPtr->ApplyKey(key, newPose) || changed;
+
+  if (!changed)
+    return;
+
+  *poseComp = components::Pose(newPose);
+  _ecm.SetChanged(entity, components::Pose::typeId,
+      ComponentState::OneTimeChange);
+}
+
+IGNITION_ADD_PLUGIN(RemoteView,
+                    ignition::gazebo::System,
+                    RemoteView::ISystemConfigure,
+                    RemoteView::ISystemPreUpdate)
+
+IGNITION_ADD_PLUGIN_ALIAS(RemoteView,
+                          "ignition::gazebo::systems::RemoteView")
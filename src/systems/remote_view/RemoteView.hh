@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_REMOTEVIEW_HH_
+#define IGNITION_GAZEBO_SYSTEMS_REMOTEVIEW_HH_
+
+#include <memory>
+
+#include <ignition/gazebo/System.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  // Forward declaration
+  class RemoteViewPrivate;
+
+  /// \brief Lets a thin client look around a world which is rendered on the
+  /// server.
+  ///
+  /// Attach it to a static model holding a camera sensor. The Sensors
+  /// system renders the camera on the server and publishes its images on
+  /// the sensor's topic. The client only displays those images and sends
+  /// key presses back, which move the model, so its cost doesn't depend on
+  /// the size of the world. See `ign gazebo -g --remote-view`.
+  ///
+  /// Key presses are ignition.msgs.Int32 messages holding Qt key codes, as
+  /// published by the KeyPublisher GUI plugin:
+  ///
+  /// * W / S : Move forward / backward
+  /// * A / D : Move left / right
+  /// * Q / E : Move up / down
+  /// * Left / Right arrows : Turn left / right
+  /// * Up / Down arrows : Look up / down
+  ///
+  /// ## System parameters
+  ///
+  /// * `<key_topic>` : Topic of the key presses, defaults to
+  ///                   `/keyboard/keypress`.
+  /// * `<pose_topic>` : Topic of ignition.msgs.Pose messages which place
+  ///                    the model, defaults to
+  ///                    `/model/<model_name>/remote_view/pose`.
+  /// * `<linear_step>` : Distance moved per key press, in meters, defaults
+  ///                     to 0.5.
+  /// * `<angular_step>` : Angle turned per key press, in radians, defaults
+  ///                      to 0.1.
+  class IGNITION_GAZEBO_VISIBLE RemoteView
+      : public System,
+        public ISystemConfigure,
+        public ISystemPreUpdate
+  {
+    /// \brief Constructor
+    public: RemoteView();
+
+    /// \brief Destructor
+    public: ~RemoteView() override = default;
+
+    // Documentation inherited
+    public: void Configure(const Entity &_entity,
+                           const std::shared_ptr<const sdf::Element> &_sdf,
+                           EntityComponentManager &_ecm,
+                           EventManager &_eventMgr) override;
+
+    // Documentation inherited
+    public: void PreUpdate(const UpdateInfo &_info,
+                           EntityComponentManager &_ecm) override;
+
+    /// \brief Private data pointer
+    private: std::unique_ptr<RemoteViewPrivate> dataPtr;
+  };
+  }
+}
+}
+}
+
+#endif
@@ -17,18 +17,37 @@
 
 #include "SceneBroadcaster.hh"
 
+#include <google/protobuf/arena.h>
+#include <ignition/msgs/boolean.pb.h>
+#include <ignition/msgs/param.pb.h>
 #include <ignition/msgs/scene.pb.h>
+#include <ignition/msgs/uint32_v.pb.h>
+#include <ignition/msgs/uint64.pb.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
 #include <condition_variable>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <ignition/common/Profiler.hh>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Pose3.hh>
 #include <ignition/math/graph/Graph.hh>
 #include <ignition/plugin/Register.hh>
 #include <ignition/transport/Node.hh>
 
+#include "ignition/gazebo/components/AtRest.hh"
 #include "ignition/gazebo/components/CastShadows.hh"
 #include "ignition/gazebo/components/Geometry.hh"
 #include "ignition/gazebo/components/Light.hh"
@@ -44,12 +63,159 @@
 #include "ignition/gazebo/Conversions.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 
+#include "../log/LogCompression.hh"
+
 using namespace std::chrono_literals;
 
 using namespace ignition;
 using namespace gazebo;
 using namespace systems;
 
+namespace
+{
+/// \brief Number of state messages a client which acknowledges states may
+/// be behind before publishing waits for it.
+constexpr uint64_t kMaxStatesInFlight{2};
+
+/// \brief Clients which didn't acknowledge a state for this long are
+/// ignored, so a closed client doesn't stop publishing.
+constexpr std::chrono::seconds kStateAckTimeout{2};
+
+/// \brief Number of bits of each of the three smallest quaternion
+/// components in the compact pose stream.
+constexpr int kQuaternionBits{10};
+
+/// \brief Quantize a coordinate to a multiple of the resolution, clamped to
+/// the 32 bit range.
+/// \param[in] _value Coordinate in meters.
+/// \param[in] _resolution Meters per step.
+/// \return Number of steps.
+int32_t quantize(double _value, double _resolution)
+{
+  const double steps = std::round(_value / _resolution);
+  return static_cast<int32_t>(std::clamp(steps,
+      static_cast<double>(std::numeric_limits<int32_t>::min()),
+      static_cast<double>(std::numeric_limits<int32_t>::max())));
+}
+
+/// \brief Map signed values to unsigned ones, so that small magnitudes
+/// stay small once varint encoded.
+/// \param[in] _value Signed value.
+/// \return Zigzag encoded value.
+uint32_t zigzag(int32_t _value)
+{
+  return (static_cast<uint32_t>(_value) << 1) ^
+      static_cast<uint32_t>(_value >> 31);
+}
+
+/// \brief Pack a rotation in 32 bits with the smallest three method: the
+/// top 2 bits are the index of the largest component of (w, x, y, z), which
+/// is dropped, and the other three follow in order, 10 bits each.
+/// \param[in] _rot Rotation.
+/// \return Packed rotation.
+uint32_t packQuaternion(const math::Quaterniond &_rot)
+{
+  auto rot = _rot;
+  rot.Normalize();
+  const std::array<double, 4> c{rot.W(), rot.X(), rot.Y(), rot.Z()};
+
+  std::size_t largest{0};
+  for (std::size_t i = 1; i < c.size(); ++i)
+  {
+    if (std::abs(c[i]) > std::abs(c[largest]))
+      largest = i;
+  }
+
+  // q and -q are the same rotation, so the dropped component is always
+  // positive, and the others are at most 1/sqrt(2) in magnitude
+  const double sign = c[largest] < 0.0 ? -1.0 : 1.0;
+  const double maxValue = (1 << kQuaternionBits) - 1;
+  uint32_t packed = static_cast<uint32_t>(largest) << (3 * kQuaternionBits);
+  int shift = 2 * kQuaternionBits;
+  for (std::size_t i = 0; i < c.size(); ++i)
+  {
+    if (i == largest)
+      continue;
+    const double normalized = sign * c[i] * IGN_SQRT2;
+    const double steps = std::round((normalized + 1.0) * 0.5 * maxValue);
+    packed |= static_cast<uint32_t>(std::clamp(steps, 0.0, maxValue))
+        << shift;
+    shift -= kQuaternionBits;
+  }
+  return packed;
+}
+
+/// \brief Whether a pose changed less than the thresholds. A threshold of
+/// zero only matches no change at all.
+/// \param[in] _from Previous pose.
+/// \param[in] _to New pose.
+/// \param[in] _position Distance threshold, in meters.
+/// \param[in] _orientation Rotation angle threshold, in radians.
+/// \return True if both the distance and the rotation angle are within
+/// their thresholds.
+bool poseChangeBelow(const math::Pose3d &_from, const math::Pose3d &_to,
+    double _position, double _orientation)
+{
+  if (_from.Pos().Distance(_to.Pos()) > _position)
+    return false;
+
+  // Angle of the rotation between both, q and -q being the same rotation
+  const double dot = std::abs(_from.Rot().W() * _to.Rot().W() +
+      _from.Rot().X() * _to.Rot().X() + _from.Rot().Y() * _to.Rot().Y() +
+      _from.Rot().Z() * _to.Rot().Z());
+  return 2.0 * std::acos(std::min(1.0, dot)) <= _orientation;
+}
+
+/// \brief Poses gathered for a frame of the compact pose stream, as a
+/// structure of arrays, so that they're converted in tight loops over
+/// contiguous memory. Kept between frames so its storage is reused.
+struct CompactPoseFrame
+{
+  /// \brief Remove all poses, keeping the storage.
+  void Clear()
+  {
+    this->entities.clear();
+    this->x.clear();
+    this->y.clear();
+    this->z.clear();
+    this->rot.clear();
+  }
+
+  /// \brief Add the pose of an entity.
+  /// \param[in] _entity Entity.
+  /// \param[in] _pose Pose.
+  void Add(Entity _entity, const math::Pose3d &_pose)
+  {
+    this->entities.push_back(_entity);
+    this->x.push_back(_pose.Pos().X());
+    this->y.push_back(_pose.Pos().Y());
+    this->z.push_back(_pose.Pos().Z());
+    this->rot.push_back(_pose.Rot());
+  }
+
+  /// \brief Entities, in the order they were added.
+  std::vector<Entity> entities;
+
+  /// \brief X coordinates.
+  std::vector<double> x;
+
+  /// \brief Y coordinates.
+  std::vector<double> y;
+
+  /// \brief Z coordinates.
+  std::vector<double> z;
+
+  /// \brief Rotations.
+  std::vector<math::Quaterniond> rot;
+
+  /// \brief Quantized coordinates and packed rotation of each entity.
+  std::vector<std::array<uint32_t, 4>> packed;
+
+  /// \brief Indices of the entities, sorted by entity.
+  std::vector<std::size_t> order;
+};
+}
+
 // Private data class.
 class ignition::gazebo::systems::SceneBroadcasterPrivate
 {
@@ -80,6 +246,33 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   /// \param[out] _res Response containing the last available full state.
   public: void StateAsyncService(const ignition::msgs::StringMsg &_req);
 
+  /// \brief Callback for the interest service, which registers, updates or
+  /// removes a client's interest set.
+  /// \param[in] _req Request, see SceneBroadcaster.
+  /// \param[out] _res True if the interest was registered or removed.
+  /// \return True if the request was valid.
+  public: bool InterestService(const ignition::msgs::Param &_req,
+      ignition::msgs::Boolean &_res);
+
+  /// \brief Callback for state acknowledgements from clients.
+  /// \param[in] _msg Sequence number of the state the client processed, with
+  /// the client's ID in the header.
+  public: void OnStateAck(const msgs::UInt64 &_msg);
+
+  /// \brief Whether all clients which acknowledge states are at most
+  /// kMaxStatesInFlight states behind.
+  /// \return True if a new state can be published.
+  public: bool ClientsCaughtUp();
+
+  /// \brief Publish the state of each interest set, at the same rate as the
+  /// full state.
+  /// \param[in] _info The update information
+  /// \param[in] _manager The entity component manager
+  /// \param[in] _changeEvent True if entities were added or removed, or
+  /// components had one-time changes.
+  public: void InterestUpdate(const UpdateInfo &_info,
+      const EntityComponentManager &_manager, bool _changeEvent);
+
   /// \brief Updates the scene graph when entities are added
   /// \param[in] _manager The entity component manager
   public: void SceneGraphAddEntities(const EntityComponentManager &_manager);
@@ -136,6 +329,11 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   public: void PoseUpdate(const UpdateInfo &_info,
     const EntityComponentManager &_manager);
 
+  /// \brief Publish a frame of the compact pose stream, with the poses in
+  /// compactFrame.
+  /// \param[in] _info The update information
+  public: void CompactPoseUpdate(const UpdateInfo &_info);
+
   /// \brief Transport node.
   public: std::unique_ptr<transport::Node> node{nullptr};
 
@@ -148,6 +346,35 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   /// \brief Rate at which to publish dynamic poses
   public: int dyPoseHertz{60};
 
+  /// \brief Compact pose publisher, see SceneBroadcaster.
+  public: transport::Node::Publisher compactPosePub;
+
+  /// \brief Position resolution of the compact pose stream, in meters.
+  public: double compactPoseResolution{0.001};
+
+  /// \brief Number of compact pose frames between keyframes.
+  public: unsigned int compactPoseKeyframePeriod{60};
+
+  /// \brief Number of compact pose frames since the last keyframe.
+  public: unsigned int compactPoseFrames{0};
+
+  /// \brief True if the compact pose stream had connections on the last
+  /// frame. A new subscriber gets a keyframe first.
+  public: bool compactPoseConnected{false};
+
+  /// \brief Poses of the compact pose frame being built.
+  public: CompactPoseFrame compactFrame;
+
+  /// \brief Last quantized position and packed rotation sent for each
+  /// entity in the compact pose stream, indexed by entity.
+  public: std::vector<std::array<uint32_t, 4>> compactSent;
+
+  /// \brief Whether each entity's entry in compactSent is valid.
+  public: std::vector<bool> compactSentValid;
+
+  /// \brief Entities with a valid entry in compactSent.
+  public: std::vector<Entity> compactSentEntities;
+
   /// \brief Scene publisher
   public: transport::Node::Publisher scenePub;
 
@@ -158,6 +385,9 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   /// \brief State publisher
   public: transport::Node::Publisher statePub;
 
+  /// \brief Compressed state publisher
+  public: transport::Node::Publisher compressedStatePub;
+
   /// \brief Graph containing latest information from entities.
   /// The data in each node is the message associated with that entity only.
   /// i.e, a model node only has a message about the model. It will not
@@ -176,14 +406,86 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   /// \brief Protects scene graph.
   public: std::mutex graphMutex;
 
+  /// \brief Latest scene, served by the scene info service. It's updated
+  /// as entities are added and removed, and only rebuilt from the scene
+  /// graph when that's not possible.
+  public: msgs::Scene sceneCache;
+
+  /// \brief False if sceneCache must be rebuilt from the scene graph.
+  public: bool sceneCacheValid{false};
+
+  /// \brief Protects sceneCache and sceneCacheValid. If both are needed,
+  /// graphMutex is locked first.
+  public: std::mutex sceneCacheMutex;
+
   /// \brief Protects stepMsg.
   public: std::mutex stateMutex;
 
   /// \brief Used to coordinate the state service response.
   public: std::condition_variable stateCv;
 
-  /// \brief Filled on demand for the state service.
-  public: msgs::SerializedStepMap stepMsg;
+  /// \brief Owns stepMsg and all of its entity and component messages.
+  /// Arenas are recycled once published, so the submessages don't need to be
+  /// allocated and freed one by one on every publish. Shared with the
+  /// publisher thread while it publishes stepMsg.
+  public: std::shared_ptr<google::protobuf::Arena> stepArena{
+      std::make_shared<google::protobuf::Arena>()};
+
+  /// \brief Filled on demand for the state service. Allocated on stepArena.
+  public: msgs::SerializedStepMap *stepMsg{
+      google::protobuf::Arena::Create<msgs::SerializedStepMap>(
+          this->stepArena.get())};
+
+  /// \brief Publish the state messages handed over by PostUpdate, until
+  /// stopPublisher is set.
+  public: void PublishStates();
+
+  /// \brief Publishes state messages, so serializing and sending them
+  /// doesn't hold the simulation loop.
+  public: std::thread publisherThread;
+
+  /// \brief State message waiting for the publisher thread. If a new one
+  /// is built before it's published, it's dropped.
+  public: msgs::SerializedStepMap *pendingMsg{nullptr};
+
+  /// \brief Arena owning pendingMsg.
+  public: std::shared_ptr<google::protobuf::Arena> pendingArena;
+
+  /// \brief True if pendingMsg has the full state. It's only replaced by
+  /// another full state, so that clients don't miss entity changes.
+  public: bool pendingFull{false};
+
+  /// \brief Arena released by the publisher thread, to be reused.
+  public: std::shared_ptr<google::protobuf::Arena> spareArena;
+
+  /// \brief Number of state messages dropped because the publisher thread
+  /// fell behind.
+  public: uint64_t droppedStates{0};
+
+  /// \brief Set to stop the publisher thread.
+  public: bool stopPublisher{false};
+
+  /// \brief Sequence number of the last state published.
+  public: uint64_t stateSeq{0};
+
+  /// \brief True if a change event happened while clients were behind, so
+  /// the next state published must be a full one.
+  public: bool fullStatePending{false};
+
+  /// \brief Last state acknowledged by each client, and when, keyed by
+  /// client ID.
+  public: std::map<std::string, std::pair<uint64_t,
+      std::chrono::steady_clock::time_point>> stateAcks;
+
+  /// \brief Protects stateAcks.
+  public: std::mutex stateAckMutex;
+
+  /// \brief Protects the publisher thread's members. If stateMutex is also
+  /// needed, it's locked first.
+  public: std::mutex publishMutex;
+
+  /// \brief Notifies the publisher thread of a new message or of stopping.
+  public: std::condition_variable publishCv;
 
   /// \brief Last time the state was published.
   public: std::chrono::time_point<std::chrono::system_clock>
@@ -193,13 +495,160 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   public: std::chrono::duration<int64_t, std::ratio<1, 1000>>
       statePublishPeriod{std::chrono::milliseconds(1000/60)};
 
+  /// \brief Last time the poses were published.
+  public: std::chrono::time_point<std::chrono::system_clock>
+      lastPosePubTime{std::chrono::system_clock::now()};
+
+  /// \brief Period to publish poses, 60 Hz.
+  public: std::chrono::duration<int64_t, std::ratio<1, 1000>>
+      posePublishPeriod{std::chrono::milliseconds(1000/60)};
+
+  /// \brief Last time the compact poses were published.
+  public: std::chrono::time_point<std::chrono::system_clock>
+      lastCompactPosePubTime{std::chrono::system_clock::now()};
+
+  /// \brief Last time the dynamic poses were published.
+  public: std::chrono::time_point<std::chrono::system_clock>
+      lastDyPosePubTime{std::chrono::system_clock::now()};
+
+  /// \brief Period to publish dynamic poses, defaults to 60 Hz.
+  public: std::chrono::duration<int64_t, std::ratio<1, 1000>>
+      dyPosePublishPeriod{std::chrono::milliseconds(1000/60)};
+
+  /// \brief Entities of models at rest whose poses were already published
+  /// on the dynamic pose topic while at rest.
+  public: std::unordered_set<Entity> restingPublished;
+
+  /// \brief Smallest pose change which is published on the dynamic pose
+  /// topic.
+  public: struct PoseThreshold
+  {
+    /// \brief Distance, in meters.
+    double position{0.0};
+
+    /// \brief Rotation angle, in radians.
+    double orientation{0.0};
+  };
+
+  /// \brief Pose threshold of models without their own.
+  public: PoseThreshold poseThreshold;
+
+  /// \brief Pose thresholds of models, keyed by model name.
+  public: std::unordered_map<std::string, PoseThreshold> modelPoseThresholds;
+
+  /// \brief Last pose published on the dynamic pose topic for each entity
+  /// with a pose threshold.
+  public: std::unordered_map<Entity, math::Pose3d> thresholdPoses;
+
   /// \brief Flag used to indicate if the state service was called.
   public: bool stateServiceRequest{false};
 
   /// \brief A list of async state requests
   public: std::unordered_set<std::string> stateRequests;
+
+  /// \brief Part of the world a client is interested in.
+  public: struct Interest
+  {
+    /// \brief Publisher on the client's state topic.
+    transport::Node::Publisher pub;
+
+    /// \brief Entities requested by the client. Their descendants are
+    /// also included.
+    std::unordered_set<Entity> entities;
+
+    /// \brief Center of the region of interest, in the world frame.
+    math::Vector3d center;
+
+    /// \brief Radius of the region of interest. Top level models within it
+    /// are included with their descendants. Negative if there's no region.
+    double radius{-1.0};
+
+    /// \brief Entities sent in the last message.
+    std::unordered_set<Entity> lastEntities;
+
+    /// \brief Last time the state was published.
+    std::chrono::time_point<std::chrono::system_clock> lastPubTime;
+  };
+
+  /// \brief Interest sets, keyed by the topic their state is published on.
+  public: std::map<std::string, Interest> interests;
+
+  /// \brief Protects interests.
+  public: std::mutex interestMutex;
+
+  /// \brief Destructor, stops the publisher thread.
+  public: ~SceneBroadcasterPrivate();
 };
 
+//////////////////////////////////////////////////
+SceneBroadcasterPrivate::~SceneBroadcasterPrivate()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->publishMutex);
+    this->stopPublisher = true;
+  }
+  this->publishCv.notify_all();
+  if (this->publisherThread.joinable())
+    this->publisherThread.join();
+}
+
+//////////////////////////////////////////////////
+void SceneBroadcasterPrivate::PublishStates()
+{
+  // Reused for each compressed state
+  std::string serialized;
+  std::string compressed;
+
+  while (true)
+  {
+    std::shared_ptr<google::protobuf::Arena> arena;
+    msgs::SerializedStepMap *msg{nullptr};
+    {
+      std::unique_lock<std::mutex> lock(this->publishMutex);
+      this->publishCv.wait(lock, [this]
+          {
+            return this->stopPublisher || nullptr != this->pendingMsg;
+          });
+      if (this->stopPublisher)
+        return;
+
+      std::swap(msg, this->pendingMsg);
+      arena = std::move(this->pendingArena);
+      this->pendingFull = false;
+    }
+
+    if (this->statePub.HasConnections())
+    {
+      IGN_PROFILE("SceneBroadcast::PublishStates Publish State");
+      this->statePub.Publish(*msg);
+    }
+
+    if (this->compressedStatePub.HasConnections())
+    {
+      IGN_PROFILE("SceneBroadcast::PublishStates Publish Compressed State");
+      std::string type;
+      if (msg->SerializeToString(&serialized) &&
+          systems::CompressLogMessage(serialized, msg->GetTypeName(),
+          compressed, type))
+      {
+        this->compressedStatePub.PublishRaw(compressed, type);
+      }
+      else
+      {
+        ignerr << "Failed to compress state message." << std::endl;
+      }
+    }
+
+    // Nobody else can get a reference to the arena once the last one is
+    // here, so it can be reused
+    if (arena.use_count() == 1)
+    {
+      std::lock_guard<std::mutex> lock(this->publishMutex);
+      this->spareArena = std::move(arena);
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 SceneBroadcaster::SceneBroadcaster()
   : System(), dataPtr(std::make_unique<SceneBroadcasterPrivate>())
@@ -225,6 +674,45 @@ void SceneBroadcaster::Configure(
 
   auto readHertz = _sdf->Get<int>("dynamic_pose_hertz", 60);
   this->dataPtr->dyPoseHertz = readHertz.first;
+  if (this->dataPtr->dyPoseHertz > 0)
+  {
+    this->dataPtr->dyPosePublishPeriod =
+        std::chrono::duration<int64_t, std::ratio<1, 1000>>(
+        std::chrono::milliseconds(1000/this->dataPtr->dyPoseHertz));
+  }
+
+  auto sdf = std::const_pointer_cast<sdf::Element>(_sdf);
+  this->dataPtr->poseThreshold.position = std::max(0.0,
+      sdf->Get<double>("pose_position_threshold", 0.0).first);
+  this->dataPtr->poseThreshold.orientation = std::max(0.0,
+      sdf->Get<double>("pose_orientation_threshold", 0.0).first);
+  for (auto elem = sdf->FindElement("model_pose_threshold"); elem;
+      elem = elem->GetNextElement("model_pose_threshold"))
+  {
+    auto modelName = elem->Get<std::string>("model", "").first;
+    if (modelName.empty())
+    {
+      ignerr << "Missing <model> in <model_pose_threshold>, ignoring."
+             << std::endl;
+      continue;
+    }
+    auto &threshold = this->dataPtr->modelPoseThresholds[modelName];
+    threshold.position = std::max(0.0,
+        elem->Get<double>("position", 0.0).first);
+    threshold.orientation = std::max(0.0,
+        elem->Get<double>("orientation", 0.0).first);
+  }
+
+  auto resolution = _sdf->Get<double>("compact_pose_resolution",
+      this->dataPtr->compactPoseResolution);
+  if (resolution.first > 0.0)
+    this->dataPtr->compactPoseResolution = resolution.first;
+
+  auto keyframePeriod = _sdf->Get<unsigned int>(
+      "compact_pose_keyframe_period",
+      this->dataPtr->compactPoseKeyframePeriod);
+  this->dataPtr->compactPoseKeyframePeriod =
+      std::max(1u, keyframePeriod.first);
 
   auto stateHerz = _sdf->Get<int>("state_hertz", 60);
   this->dataPtr->statePublishPeriod =
@@ -254,7 +742,8 @@ void SceneBroadcaster::PostUpdate(const UpdateInfo &_info,
 
   // Create and send pose update if transport connections exist.
   if (this->dataPtr->dyPosePub.HasConnections() ||
-      this->dataPtr->posePub.HasConnections())
+      this->dataPtr->posePub.HasConnections() ||
+      this->dataPtr->compactPosePub.HasConnections())
   {
     this->dataPtr->PoseUpdate(_info, _manager);
   }
@@ -278,27 +767,58 @@ void SceneBroadcaster::PostUpdate(const UpdateInfo &_info,
         jumpBackInTime;
   bool itsPubTime = now - this->dataPtr->lastStatePubTime >
        this->dataPtr->statePublishPeriod;
-  auto shouldPublish = this->dataPtr->statePub.HasConnections() &&
-       (changeEvent || itsPubTime);
+  auto shouldPublish = (this->dataPtr->statePub.HasConnections() ||
+       this->dataPtr->compressedStatePub.HasConnections()) &&
+       (changeEvent || itsPubTime || this->dataPtr->fullStatePending);
+
+  // Wait for slow clients instead of queueing states they can't process,
+  // and send them the latest full state once they catch up
+  if (shouldPublish && !this->dataPtr->ClientsCaughtUp())
+  {
+    shouldPublish = false;
+    this->dataPtr->fullStatePending |= changeEvent;
+  }
 
   if (this->dataPtr->stateServiceRequest || shouldPublish)
   {
     std::unique_lock<std::mutex> lock(this->dataPtr->stateMutex);
-    this->dataPtr->stepMsg.Clear();
 
-    set(this->dataPtr->stepMsg.mutable_stats(), _info);
+    // Reuse the last arena if the publisher thread is done with it, or one
+    // it released. A full state which wasn't published yet is only replaced
+    // by another full state.
+    auto arena = std::move(this->dataPtr->stepArena);
+    bool pendingFull{false};
+    {
+      std::lock_guard<std::mutex> publishLock(this->dataPtr->publishMutex);
+      if (arena.use_count() != 1)
+        arena = std::move(this->dataPtr->spareArena);
+      pendingFull = this->dataPtr->pendingFull;
+    }
+    if (arena)
+      arena->Reset();
+    else
+      arena = std::make_shared<google::protobuf::Arena>();
+
+    this->dataPtr->stepArena = arena;
+    this->dataPtr->stepMsg =
+        google::protobuf::Arena::Create<msgs::SerializedStepMap>(
+            arena.get());
+
+    set(this->dataPtr->stepMsg->mutable_stats(), _info);
 
     // Publish full state if there are change events
-    if (changeEvent || this->dataPtr->stateServiceRequest)
+    const bool full = changeEvent || this->dataPtr->stateServiceRequest ||
+        pendingFull || (shouldPublish && this->dataPtr->fullStatePending);
+    if (full)
     {
-      _manager.State(*this->dataPtr->stepMsg.mutable_state(), {}, {}, true);
+      _manager.State(*this->dataPtr->stepMsg->mutable_state(), {}, {}, true);
     }
     // Otherwise publish just periodic change components
     else
     {
       IGN_PROFILE("SceneBroadcast::PostUpdate UpdateState");
       auto periodicComponents = _manager.ComponentTypesWithPeriodicChanges();
-      _manager.State(*this->dataPtr->stepMsg.mutable_state(),
+      _manager.State(*this->dataPtr->stepMsg->mutable_state(),
           {}, periodicComponents);
     }
 
@@ -314,7 +834,7 @@ void SceneBroadcaster::PostUpdate(const UpdateInfo &_info,
     {
       for (const auto &reqSrv : this->dataPtr->stateRequests)
       {
-        this->dataPtr->node->Request(reqSrv, this->dataPtr->stepMsg);
+        this->dataPtr->node->Request(reqSrv, *this->dataPtr->stepMsg);
       }
       this->dataPtr->stateRequests.clear();
     }
@@ -322,13 +842,120 @@ void SceneBroadcaster::PostUpdate(const UpdateInfo &_info,
     // Poses periodically + change events
     // TODO(louise) Send changed state periodically instead, once it reflects
     // changed components
+    // Serialized and sent by the publisher thread, dropping the previous
+    // message if it's still waiting
     if (shouldPublish)
     {
-      IGN_PROFILE("SceneBroadcast::PostUpdate Publish State");
-      this->dataPtr->statePub.Publish(this->dataPtr->stepMsg);
+      // Clients acknowledge states by sequence number
+      auto seqData = this->dataPtr->stepMsg->mutable_header()->add_data();
+      seqData->set_key("seq");
+      seqData->add_value(std::to_string(++this->dataPtr->stateSeq));
+      this->dataPtr->fullStatePending = false;
+
+      {
+        std::lock_guard<std::mutex> publishLock(this->dataPtr->publishMutex);
+        if (nullptr != this->dataPtr->pendingMsg &&
+            this->dataPtr->droppedStates++ % 100 == 0)
+        {
+          igndbg << "State publisher is falling behind, dropped ["
+                 << this->dataPtr->droppedStates << "] messages so far."
+                 << std::endl;
+        }
+        this->dataPtr->pendingMsg = this->dataPtr->stepMsg;
+        this->dataPtr->pendingArena = arena;
+        this->dataPtr->pendingFull = full;
+
+        if (!this->dataPtr->publisherThread.joinable())
+        {
+          this->dataPtr->publisherThread = std::thread(
+              &SceneBroadcasterPrivate::PublishStates, this->dataPtr.get());
+        }
+      }
+      this->dataPtr->publishCv.notify_one();
       this->dataPtr->lastStatePubTime = now;
     }
   }
+
+  this->dataPtr->InterestUpdate(_info, _manager, changeEvent);
+}
+
+//////////////////////////////////////////////////
+void SceneBroadcasterPrivate::InterestUpdate(const UpdateInfo &_info,
+    const EntityComponentManager &_manager, bool _changeEvent)
+{
+  std::lock_guard<std::mutex> lock(this->interestMutex);
+  if (this->interests.empty())
+    return;
+
+  IGN_PROFILE("SceneBroadcast::InterestUpdate");
+
+  auto now = std::chrono::system_clock::now();
+  for (auto &[topic, interest] : this->interests)
+  {
+    if (!interest.pub.HasConnections() ||
+        (!_changeEvent &&
+         now - interest.lastPubTime <= this->statePublishPeriod))
+    {
+      continue;
+    }
+
+    // The world is always sent, so clients know what the entities belong to
+    std::unordered_set<Entity> entities{this->worldEntity};
+    for (const auto &entity : interest.entities)
+    {
+      if (!_manager.HasEntity(entity))
+        continue;
+      auto descendants = _manager.Descendants(entity);
+      entities.insert(descendants.begin(), descendants.end());
+    }
+
+    if (interest.radius >= 0.0)
+    {
+      _manager.Each<components::Model, components::Pose,
+                    components::ParentEntity>(
+          [&](const Entity &_entity, const components::Model *,
+              const components::Pose *_poseComp,
+              const components::ParentEntity *_parentComp) -> bool
+          {
+            if (_parentComp->Data() == this->worldEntity &&
+                _poseComp->Data().Pos().Distance(interest.center) <=
+                interest.radius)
+            {
+              auto descendants = _manager.Descendants(_entity);
+              entities.insert(descendants.begin(), descendants.end());
+            }
+            return true;
+          });
+    }
+
+    msgs::SerializedStepMap msg;
+    set(msg.mutable_stats(), _info);
+
+    // Entities which just came into the set need all their components
+    if (_changeEvent || entities != interest.lastEntities)
+    {
+      _manager.State(*msg.mutable_state(), entities, {}, true);
+    }
+    else
+    {
+      _manager.State(*msg.mutable_state(), entities,
+          _manager.ComponentTypesWithPeriodicChanges());
+    }
+
+    // Entities which left the set are removed from the client's view
+    for (const auto &entity : interest.lastEntities)
+    {
+      if (entities.find(entity) != entities.end())
+        continue;
+      auto &entityMsg = (*msg.mutable_state()->mutable_entities())[entity];
+      entityMsg.set_id(entity);
+      entityMsg.set_remove(true);
+    }
+
+    interest.pub.Publish(msg);
+    interest.lastPubTime = now;
+    interest.lastEntities = std::move(entities);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -337,9 +964,80 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
 {
   IGN_PROFILE("SceneBroadcast::PoseUpdate");
 
+  // Throttle here instead of using transport::AdvertiseMessageOptions so
+  // that messages aren't built on steps which wouldn't be published. This
+  // follows wall-clock time, so subscribers aren't flooded when simulation
+  // runs faster than real time.
+  auto now = std::chrono::system_clock::now();
+  bool publishDyPose = this->dyPosePub.HasConnections() &&
+      now - this->lastDyPosePubTime > this->dyPosePublishPeriod;
+  bool publishPose = this->posePub.HasConnections() &&
+      now - this->lastPosePubTime > this->posePublishPeriod;
+
+  // The compact stream follows the pose rate
+  const bool compactConnected = this->compactPosePub.HasConnections();
+  if (!compactConnected)
+    this->compactPoseConnected = false;
+  bool publishCompact = compactConnected &&
+      now - this->lastCompactPosePubTime > this->posePublishPeriod;
+  if (!publishDyPose && !publishPose && !publishCompact)
+    return;
+
   msgs::Pose_V poseMsg, dyPoseMsg;
-  bool dyPoseConnections = this->dyPosePub.HasConnections();
-  bool poseConnections = this->posePub.HasConnections();
+  auto &compactFrame = this->compactFrame;
+  compactFrame.Clear();
+
+  // Entities of models at rest are published once on the dynamic pose
+  // topic, so subscribers get their final poses, and then skipped until
+  // they move again
+  std::unordered_set<Entity> resting;
+  auto restingPublished = [&](const Entity _model, const Entity _entity)
+  {
+    if (!_manager.EntityHasComponentType(_model, components::AtRest::typeId))
+      return false;
+    resting.insert(_entity);
+    return this->restingPublished.find(_entity) !=
+        this->restingPublished.end();
+  };
+
+  // Entities which moved less than their model's threshold since their
+  // pose was last published are skipped, so jitter doesn't generate
+  // traffic. The poses last published are kept until they move enough.
+  std::unordered_map<Entity, const PoseThreshold *> modelThresholds;
+  std::unordered_map<Entity, math::Pose3d> thresholdPoses;
+  auto belowThreshold = [&](const Entity _model, const Entity _entity,
+      const math::Pose3d &_pose)
+  {
+    auto thresholdIt = modelThresholds.find(_model);
+    if (thresholdIt == modelThresholds.end())
+    {
+      const PoseThreshold *threshold = &this->poseThreshold;
+      if (!this->modelPoseThresholds.empty())
+      {
+        auto nameComp = _manager.Component<components::Name>(_model);
+        auto it = nullptr == nameComp ? this->modelPoseThresholds.end() :
+            this->modelPoseThresholds.find(nameComp->Data());
+        if (it != this->modelPoseThresholds.end())
+          threshold = &it->second;
+      }
+      thresholdIt = modelThresholds.emplace(_model, threshold).first;
+    }
+
+    const PoseThreshold &threshold = *thresholdIt->second;
+    if (threshold.position <= 0.0 && threshold.orientation <= 0.0)
+      return false;
+
+    auto lastIt = this->thresholdPoses.find(_entity);
+    if (lastIt != this->thresholdPoses.end() &&
+        poseChangeBelow(lastIt->second, _pose, threshold.position,
+        threshold.orientation))
+    {
+      thresholdPoses[_entity] = lastIt->second;
+      return true;
+    }
+    thresholdPoses[_entity] = _pose;
+    return false;
+  };
 
   // Models
   _manager.Each<components::Model, components::Name, components::Pose,
@@ -349,7 +1047,7 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
           const components::Pose *_poseComp,
           const components::Static *_staticComp) -> bool
       {
-        if (poseConnections)
+        if (publishPose)
         {
           // Add to pose msg
           auto pose = poseMsg.add_pose();
@@ -358,7 +1056,12 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
           pose->set_id(_entity);
         }
 
-        if (dyPoseConnections && !_staticComp->Data())
+        if (publishCompact)
+          compactFrame.Add(_entity, _poseComp->Data());
+
+        if (publishDyPose && !_staticComp->Data() &&
+            !restingPublished(_entity, _entity) &&
+            !belowThreshold(_entity, _entity, _poseComp->Data()))
         {
           // Add to dynamic pose msg
           auto dyPose = dyPoseMsg.add_pose();
@@ -378,7 +1081,7 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
           const components::ParentEntity *_parentComp) -> bool
       {
         // Add to pose msg
-        if (poseConnections)
+        if (publishPose)
         {
           auto pose = poseMsg.add_pose();
           msgs::Set(pose, _poseComp->Data());
@@ -386,10 +1089,16 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
           pose->set_id(_entity);
         }
 
+        if (publishCompact)
+          compactFrame.Add(_entity, _poseComp->Data());
+
         // Check whether parent model is static
         auto staticComp = _manager.Component<components::Static>(
           _parentComp->Data());
-        if (dyPoseConnections && !staticComp->Data())
+        if (publishDyPose && !staticComp->Data() &&
+            !restingPublished(_parentComp->Data(), _entity) &&
+            !belowThreshold(_parentComp->Data(), _entity,
+            _poseComp->Data()))
         {
           // Add to dynamic pose msg
           auto dyPose = dyPoseMsg.add_pose();
@@ -401,31 +1110,37 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
         return true;
       });
 
-  if (dyPoseConnections)
+  if (publishDyPose)
   {
     // Set the time stamp in the header
     dyPoseMsg.mutable_header()->mutable_stamp()->CopyFrom(
         convert<msgs::Time>(_info.simTime));
 
     this->dyPosePub.Publish(dyPoseMsg);
+    this->lastDyPosePubTime = now;
+    this->restingPublished = std::move(resting);
+    this->thresholdPoses = std::move(thresholdPoses);
   }
 
   // Visuals
-  if (poseConnections)
+  if (publishPose || publishCompact)
   {
-    poseMsg.mutable_header()->mutable_stamp()->CopyFrom(
-        convert<msgs::Time>(_info.simTime));
-
     _manager.Each<components::Visual, components::Name, components::Pose>(
       [&](const Entity &_entity, const components::Visual *,
           const components::Name *_nameComp,
           const components::Pose *_poseComp) -> bool
       {
         // Add to pose msg
-        auto pose = poseMsg.add_pose();
-        msgs::Set(pose, _poseComp->Data());
-        pose->set_name(_nameComp->Data());
-        pose->set_id(_entity);
+        if (publishPose)
+        {
+          auto pose = poseMsg.add_pose();
+          msgs::Set(pose, _poseComp->Data());
+          pose->set_name(_nameComp->Data());
+          pose->set_id(_entity);
+        }
+
+        if (publishCompact)
+          compactFrame.Add(_entity, _poseComp->Data());
         return true;
       });
 
@@ -436,17 +1151,133 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
             const components::Pose *_poseComp) -> bool
         {
           // Add to pose msg
-          auto pose = poseMsg.add_pose();
-          msgs::Set(pose, _poseComp->Data());
-          pose->set_name(_nameComp->Data());
-          pose->set_id(_entity);
+          if (publishPose)
+          {
+            auto pose = poseMsg.add_pose();
+            msgs::Set(pose, _poseComp->Data());
+            pose->set_name(_nameComp->Data());
+            pose->set_id(_entity);
+          }
+
+          if (publishCompact)
+            compactFrame.Add(_entity, _poseComp->Data());
           return true;
         });
+  }
+
+  if (publishPose)
+  {
+    poseMsg.mutable_header()->mutable_stamp()->CopyFrom(
+        convert<msgs::Time>(_info.simTime));
 
     this->posePub.Publish(poseMsg);
+    this->lastPosePubTime = now;
+  }
+
+  if (publishCompact)
+  {
+    this->CompactPoseUpdate(_info);
+    this->lastCompactPosePubTime = now;
   }
 }
 
+//////////////////////////////////////////////////
+void SceneBroadcasterPrivate::CompactPoseUpdate(const UpdateInfo &_info)
+{
+  IGN_PROFILE("SceneBroadcast::CompactPoseUpdate");
+
+  // Keyframes periodically, and to new subscribers
+  const bool keyframe = !this->compactPoseConnected ||
+      this->compactPoseFrames + 1 >= this->compactPoseKeyframePeriod;
+  this->compactPoseFrames = keyframe ? 0 : this->compactPoseFrames + 1;
+  this->compactPoseConnected = true;
+
+  msgs::UInt32_V msg;
+  auto header = msg.mutable_header();
+  header->mutable_stamp()->CopyFrom(convert<msgs::Time>(_info.simTime));
+  auto data = header->add_data();
+  data->set_key("keyframe");
+  data->add_value(keyframe ? "1" : "0");
+  data = header->add_data();
+  data->set_key("resolution");
+  data->add_value(std::to_string(this->compactPoseResolution));
+
+  // Convert all poses first, one array at a time
+  auto &frame = this->compactFrame;
+  const std::size_t count = frame.entities.size();
+  frame.packed.resize(count);
+  const std::vector<double> *coords[3]{&frame.x, &frame.y, &frame.z};
+  for (std::size_t axis = 0; axis < 3; ++axis)
+  {
+    const auto &values = *coords[axis];
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      frame.packed[i][axis] = static_cast<uint32_t>(
+          quantize(values[i], this->compactPoseResolution));
+    }
+  }
+  for (std::size_t i = 0; i < count; ++i)
+    frame.packed[i][3] = packQuaternion(frame.rot[i]);
+
+  frame.order.resize(count);
+  std::iota(frame.order.begin(), frame.order.end(), std::size_t{0});
+  std::sort(frame.order.begin(), frame.order.end(),
+      [&frame](std::size_t _a, std::size_t _b)
+      {
+        return frame.entities[_a] < frame.entities[_b];
+      });
+
+  // Entities which are gone are dropped on keyframes
+  if (keyframe)
+  {
+    for (const Entity entity : this->compactSentEntities)
+      this->compactSentValid[entity] = false;
+    this->compactSentEntities.clear();
+  }
+
+  Entity previous{0};
+  for (const std::size_t i : frame.order)
+  {
+    const Entity entity = frame.entities[i];
+
+    // IDs are delta encoded, which needs them to fit 32 bits
+    if (entity - previous > std::numeric_limits<uint32_t>::max())
+      continue;
+
+    if (entity >= this->compactSent.size())
+    {
+      this->compactSent.resize(entity + 1);
+      this->compactSentValid.resize(entity + 1, false);
+    }
+
+    const auto &current = frame.packed[i];
+    auto &last = this->compactSent[entity];
+    const bool known = this->compactSentValid[entity];
+    if (!keyframe && known && last == current)
+      continue;
+
+    msg.add_data(static_cast<uint32_t>(entity - previous));
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      // Delta frames only have the change since the last frame with the
+      // entity, so small motions take a single byte per axis
+      const uint32_t reference = keyframe || !known ? 0u : last[axis];
+      msg.add_data(zigzag(static_cast<int32_t>(current[axis] - reference)));
+    }
+    msg.add_data(current[3]);
+    previous = entity;
+
+    last = current;
+    if (!known)
+    {
+      this->compactSentValid[entity] = true;
+      this->compactSentEntities.push_back(entity);
+    }
+  }
+
+  this->compactPosePub.Publish(msg);
+}
+
 //////////////////////////////////////////////////
 void SceneBroadcasterPrivate::SetupTransport(const std::string &_worldName)
 {
@@ -500,6 +1331,15 @@ void SceneBroadcasterPrivate::SetupTransport(const std::string &_worldName)
   ignmsg << "Serving full state (async) on [" << opts.NameSpace() << "/"
          << stateAsyncService << "]" << std::endl;
 
+  // Interest service
+  std::string interestService{"state/interest"};
+
+  this->node->Advertise(interestService,
+      &SceneBroadcasterPrivate::InterestService, this);
+
+  ignmsg << "Serving state interest registration on [" << opts.NameSpace()
+         << "/" << interestService << "]" << std::endl;
+
   // Scene info topic
   std::string sceneTopic{ns + "/scene/info"};
 
@@ -526,13 +1366,29 @@ void SceneBroadcasterPrivate::SetupTransport(const std::string &_worldName)
   ignmsg << "Publishing state changes on [" << stateTopic << "]"
       << std::endl;
 
+  // Compressed state topic, for clients on slow links
+  std::string compressedStateTopic{stateTopic + "/compressed"};
+
+  this->compressedStatePub = this->node->Advertise(compressedStateTopic,
+      std::string(msgs::SerializedStepMap().GetTypeName()) +
+      systems::kCompressedLogTypeSuffix);
+
+  ignmsg << "Publishing compressed state changes on ["
+      << compressedStateTopic << "]" << std::endl;
+
+  // State acknowledgements, for backpressure
+  std::string stateAckTopic{ns + "/state/ack"};
+
+  this->node->Subscribe(stateAckTopic, &SceneBroadcasterPrivate::OnStateAck,
+      this);
+
+  ignmsg << "Listening to state acknowledgements on [" << stateAckTopic << "]"
+      << std::endl;
+
   // Pose info publisher
   std::string poseTopic{"pose/info"};
 
-  transport::AdvertiseMessageOptions poseAdvertOpts;
-  poseAdvertOpts.SetMsgsPerSec(60);
-  this->posePub = this->node->Advertise<msgs::Pose_V>(poseTopic,
-      poseAdvertOpts);
+  this->posePub = this->node->Advertise<msgs::Pose_V>(poseTopic);
 
   ignmsg << "Publishing pose messages on [" << opts.NameSpace() << "/"
          << poseTopic << "]" << std::endl;
@@ -540,29 +1396,51 @@ void SceneBroadcasterPrivate::SetupTransport(const std::string &_worldName)
   // Dynamic pose info publisher
   std::string dyPoseTopic{"dynamic_pose/info"};
 
-  transport::AdvertiseMessageOptions dyPoseAdvertOpts;
-  dyPoseAdvertOpts.SetMsgsPerSec(this->dyPoseHertz);
-  this->dyPosePub = this->node->Advertise<msgs::Pose_V>(dyPoseTopic,
-      dyPoseAdvertOpts);
+  this->dyPosePub = this->node->Advertise<msgs::Pose_V>(dyPoseTopic);
 
   ignmsg << "Publishing dynamic pose messages on [" << opts.NameSpace() << "/"
          << dyPoseTopic << "]" << std::endl;
+
+  // Compact pose publisher
+  std::string compactPoseTopic{"pose/compact"};
+
+  this->compactPosePub = this->node->Advertise<msgs::UInt32_V>(
+      compactPoseTopic);
+
+  ignmsg << "Publishing compact pose messages on [" << opts.NameSpace() << "/"
+         << compactPoseTopic << "]" << std::endl;
 }
 
 //////////////////////////////////////////////////
 bool SceneBroadcasterPrivate::SceneInfoService(ignition::msgs::Scene &_res)
 {
-  std::lock_guard<std::mutex> lock(this->graphMutex);
+  {
+    std::lock_guard<std::mutex> lock(this->sceneCacheMutex);
+    if (this->sceneCacheValid)
+    {
+      _res.CopyFrom(this->sceneCache);
+      return true;
+    }
+  }
 
-  _res.Clear();
+  // The graph is always locked before the cache
+  std::lock_guard<std::mutex> graphLock(this->graphMutex);
+  std::lock_guard<std::mutex> lock(this->sceneCacheMutex);
+
+  if (!this->sceneCacheValid)
+  {
+    this->sceneCache.Clear();
+
+    // Add models
+    AddModels(&this->sceneCache, this->worldEntity, this->sceneGraph);
 
-  // Populate scene message
+    // Add lights
+    AddLights(&this->sceneCache, this->worldEntity, this->sceneGraph);
 
-  // Add models
-  AddModels(&_res, this->worldEntity, this->sceneGraph);
+    this->sceneCacheValid = true;
+  }
 
-  // Add lights
-  AddLights(&_res, this->worldEntity, this->sceneGraph);
+  _res.CopyFrom(this->sceneCache);
 
   return true;
 }
@@ -576,6 +1454,105 @@ void SceneBroadcasterPrivate::StateAsyncService(
   this->stateRequests.insert(_req.data());
 }
 
+//////////////////////////////////////////////////
+bool SceneBroadcasterPrivate::InterestService(
+    const ignition::msgs::Param &_req, ignition::msgs::Boolean &_res)
+{
+  _res.set_data(false);
+
+  const auto &params = _req.params();
+  auto topicIt = params.find("topic");
+  if (topicIt == params.end() || topicIt->second.string_value().empty())
+  {
+    ignerr << "State interest request is missing a [topic]" << std::endl;
+    return false;
+  }
+  const auto &topic = topicIt->second.string_value();
+
+  Interest interest;
+  auto entitiesIt = params.find("entities");
+  if (entitiesIt != params.end())
+  {
+    std::istringstream stream(entitiesIt->second.string_value());
+    Entity entity;
+    while (stream >> entity)
+      interest.entities.insert(entity);
+  }
+
+  auto radiusIt = params.find("radius");
+  if (radiusIt != params.end())
+  {
+    interest.radius = radiusIt->second.double_value();
+    auto centerIt = params.find("center");
+    if (centerIt != params.end())
+      interest.center = msgs::Convert(centerIt->second.vector3d_value());
+  }
+
+  std::lock_guard<std::mutex> lock(this->interestMutex);
+
+  // Nothing of interest, stop publishing on the topic
+  if (interest.entities.empty() && interest.radius < 0.0)
+  {
+    _res.set_data(this->interests.erase(topic) > 0);
+    return true;
+  }
+
+  auto existing = this->interests.find(topic);
+  if (existing != this->interests.end())
+  {
+    interest.pub = existing->second.pub;
+  }
+  else
+  {
+    interest.pub = this->node->Advertise<msgs::SerializedStepMap>(topic);
+    if (!interest.pub)
+    {
+      ignerr << "Failed to advertise state interest topic [" << topic << "]"
+             << std::endl;
+      return false;
+    }
+    ignmsg << "Publishing state of interest on [" << topic << "]"
+           << std::endl;
+  }
+  this->interests[topic] = std::move(interest);
+
+  _res.set_data(true);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SceneBroadcasterPrivate::OnStateAck(const msgs::UInt64 &_msg)
+{
+  std::string id;
+  for (const auto &data : _msg.header().data())
+  {
+    if (data.key() == "id" && data.value_size() > 0)
+      id = data.value(0);
+  }
+
+  std::lock_guard<std::mutex> lock(this->stateAckMutex);
+  this->stateAcks[id] = {_msg.data(), std::chrono::steady_clock::now()};
+}
+
+//////////////////////////////////////////////////
+bool SceneBroadcasterPrivate::ClientsCaughtUp()
+{
+  std::lock_guard<std::mutex> lock(this->stateAckMutex);
+  const auto now = std::chrono::steady_clock::now();
+  for (auto it = this->stateAcks.begin(); it != this->stateAcks.end();)
+  {
+    if (now - it->second.second > kStateAckTimeout)
+    {
+      it = this->stateAcks.erase(it);
+      continue;
+    }
+    if (this->stateSeq - it->second.first >= kMaxStatesInFlight)
+      return false;
+    ++it;
+  }
+  return true;
+}
+
 //////////////////////////////////////////////////
 bool SceneBroadcasterPrivate::StateService(
     ignition::msgs::SerializedStepMap &_res)
@@ -588,11 +1565,11 @@ bool SceneBroadcasterPrivate::StateService(
   this->stateServiceRequest = true;
   auto success = this->stateCv.wait_for(lock, 5s, [&]
   {
-    return this->stepMsg.has_state() && !this->stateServiceRequest;
+    return this->stepMsg->has_state() && !this->stateServiceRequest;
   });
 
   if (success)
-    _res.CopyFrom(this->stepMsg);
+    _res.CopyFrom(*this->stepMsg);
   else
     ignerr << "Timed out waiting for state" << std::endl;
 
@@ -628,6 +1605,10 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
   auto worldVertex = this->sceneGraph.VertexFromId(this->worldEntity);
   newGraph.AddVertex(worldVertex.Name(), worldVertex.Data(), worldVertex.Id());
 
+  // Parents of the new entities, to know if they can be appended to the
+  // cached scene
+  std::unordered_set<Entity> newParents;
+
   // Worlds: check this in case we're loading a world without models
   _manager.EachNew<components::World>(
       [&](const Entity &, const components::World *) -> bool
@@ -652,6 +1633,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), modelMsg, _entity);
         newGraph.AddEdge({_parentComp->Data(), _entity}, true);
+        newParents.insert(_parentComp->Data());
 
         newEntity = true;
         return true;
@@ -673,6 +1655,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), linkMsg, _entity);
         newGraph.AddEdge({_parentComp->Data(), _entity}, true);
+        newParents.insert(_parentComp->Data());
 
         newEntity = true;
         return true;
@@ -700,21 +1683,20 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
         auto geometryComp = _manager.Component<components::Geometry>(_entity);
         if (geometryComp)
         {
-          visualMsg->mutable_geometry()->CopyFrom(
-              convert<msgs::Geometry>(geometryComp->Data()));
+          set(visualMsg->mutable_geometry(), geometryComp->Data());
         }
 
         // Material is optional
         auto materialComp = _manager.Component<components::Material>(_entity);
         if (materialComp)
         {
-          visualMsg->mutable_material()->CopyFrom(
-              convert<msgs::Material>(materialComp->Data()));
+          set(visualMsg->mutable_material(), materialComp->Data());
         }
 
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), visualMsg, _entity);
         newGraph.AddEdge({_parentComp->Data(), _entity}, true);
+        newParents.insert(_parentComp->Data());
 
         newEntity = true;
         return true;
@@ -729,7 +1711,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
           const components::Pose *_poseComp) -> bool
       {
         auto lightMsg = std::make_shared<msgs::Light>();
-        lightMsg->CopyFrom(convert<msgs::Light>(_lightComp->Data()));
+        set(lightMsg.get(), _lightComp->Data());
         lightMsg->set_id(_entity);
         lightMsg->set_parent_id(_parentComp->Data());
         lightMsg->set_name(_nameComp->Data());
@@ -738,11 +1720,34 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), lightMsg, _entity);
         newGraph.AddEdge({_parentComp->Data(), _entity}, true);
+        newParents.insert(_parentComp->Data());
         newEntity = true;
         return true;
       });
 
 
+  // Scene message with the new entities
+  msgs::Scene sceneMsg;
+  if (newEntity)
+  {
+    AddModels(&sceneMsg, this->worldEntity, newGraph);
+
+    // Add lights
+    AddLights(&sceneMsg, this->worldEntity, newGraph);
+  }
+
+  // New top level models and lights can be appended to the cached scene.
+  // Entities added to existing ones need a rebuild.
+  bool attachedToExisting{false};
+  for (const auto &parent : newParents)
+  {
+    if (parent != this->worldEntity && !newGraph.VertexFromId(parent).Valid())
+    {
+      attachedToExisting = true;
+      break;
+    }
+  }
+
   // Update the whole scene graph from the new graph
   {
     std::lock_guard<std::mutex> lock(this->graphMutex);
@@ -761,6 +1766,14 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
         this->sceneGraph.AddEdge(edge.get().Vertices(), edge.get().Data());
       }
     }
+
+    // Updated with the graph, so the scene info service never sees one
+    // without the other
+    std::lock_guard<std::mutex> cacheLock(this->sceneCacheMutex);
+    if (attachedToExisting)
+      this->sceneCacheValid = false;
+    else if (this->sceneCacheValid)
+      this->sceneCache.MergeFrom(sceneMsg);
   }
 
   if (newEntity)
@@ -770,12 +1783,6 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
     if (!this->node)
       this->SetupTransport(this->worldName);
 
-    msgs::Scene sceneMsg;
-
-    AddModels(&sceneMsg, this->worldEntity, newGraph);
-
-    // Add lights
-    AddLights(&sceneMsg, this->worldEntity, newGraph);
     this->scenePub.Publish(sceneMsg);
   }
 }
@@ -814,6 +1821,32 @@ void SceneBroadcasterPrivate::SceneGraphRemoveEntities(
 
   if (!removedEntities.empty())
   {
+    // Remove top level models and lights from the cached scene. Nested ones
+    // need a rebuild.
+    {
+      std::lock_guard<std::mutex> cacheLock(this->sceneCacheMutex);
+      for (const auto &entity : removedEntities)
+      {
+        if (!this->sceneCacheValid)
+          break;
+
+        auto hasId = [entity](const auto &_msg)
+        {
+          return _msg.id() == entity;
+        };
+        auto models = this->sceneCache.mutable_model();
+        auto lights = this->sceneCache.mutable_light();
+        auto model = std::find_if(models->begin(), models->end(), hasId);
+        auto light = std::find_if(lights->begin(), lights->end(), hasId);
+        if (model != models->end())
+          models->erase(model);
+        else if (light != lights->end())
+          lights->erase(light);
+        else
+          this->sceneCacheValid = false;
+      }
+    }
+
     // Send the list of deleted entities
     msgs::UInt32_V deletionMsg;
 
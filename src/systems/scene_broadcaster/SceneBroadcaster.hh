@@ -38,6 +38,85 @@ namespace systems
   **/
   /// \brief System which periodically publishes an ignition::msgs::Scene
   /// message with updated information.
+  ///
+  /// Clients which only need part of the world can register an interest set
+  /// through the `/world/<world_name>/state/interest` service, which takes an
+  /// ignition::msgs::Param request with the following parameters:
+  ///
+  /// * `topic` (string, required): Topic to publish the state on, relative to
+  ///   `/world/<world_name>`. Each topic has a single interest set, which is
+  ///   replaced by later requests.
+  /// * `entities` (string): Space separated IDs of entities of interest. Their
+  ///   descendants are included.
+  /// * `center` (vector3d) and `radius` (double): Region of interest. Top level
+  ///   models within the radius are included with their descendants.
+  ///
+  /// Requests without entities nor radius remove the interest set. The state
+  /// of each set is serialized on its own, so it only contains the world and
+  /// the entities of interest. Entities which leave the set are marked as
+  /// removed.
+  ///
+  /// Each message on `/world/<world_name>/state` has a `seq` key in its
+  /// header. Clients can publish the sequence number of each state after
+  /// processing it, as an ignition::msgs::UInt64 on
+  /// `/world/<world_name>/state/ack`, with an `id` key in its header unique
+  /// to the client. States are then only published while all those clients
+  /// are at most 2 states behind, so they get the latest state when they're
+  /// ready instead of a growing queue. Clients which stop acknowledging for
+  /// 2 seconds are ignored.
+  ///
+  /// Remote viewers can use the compact pose stream on
+  /// `/world/<world_name>/pose/compact` instead of `pose/info`. It carries the
+  /// same entities, in ignition::msgs::UInt32_V messages, at the same
+  /// rate. There are no names, and unchanged entities are left out between
+  /// keyframes. The header has a `keyframe` key ("1" or "0") and a
+  /// `resolution` key (meters per position step). For each entity, in
+  /// increasing ID order, `data` has 5 values:
+  ///
+  /// 1. ID, as the difference from the previous entity's ID, or from 0.
+  /// 2. - 4. X, Y and Z positions, in steps of `resolution` and zigzag
+  ///   encoded. The values are absolute for keyframes and for entities that
+  ///   weren't sent since the last keyframe. Otherwise, they are the
+  ///   difference from the last values sent for the entity.
+  /// 5. Rotation, compressed with the smallest three method. The top 2 bits
+  ///   are the index of the largest component of (w, x, y, z), which is
+  ///   dropped and positive. The other three components follow in order, 10
+  ///   bits each, mapping [-1/sqrt(2), 1/sqrt(2)] to [0, 1023].
+  ///
+  /// The first message to a subscriber is a keyframe, if it was the only
+  /// subscriber. Otherwise it waits for the next periodic keyframe.
+  ///
+  /// Clients on slow links can subscribe to
+  /// `/world/<world_name>/state/compressed` instead of `state`. It carries
+  /// the same messages, compressed with zlib as by the log system, with the
+  /// message type `ignition.msgs.SerializedStepMap+zlib`. Each message is
+  /// compressed on its own, so clients can join at any time. States are
+  /// only serialized and compressed for the topics which have subscribers.
+  ///
+  /// Models marked with components::AtRest by the physics system, and their
+  /// links, are only published once on `dynamic_pose/info` after coming to
+  /// rest, until they move again.
+  ///
+  /// ## System Parameters
+  ///
+  /// - `<compact_pose_resolution>`: Position resolution of the compact pose
+  ///   stream, in meters. Defaults to 0.001.
+  /// - `<compact_pose_keyframe_period>`: Number of compact pose messages
+  ///   between keyframes, defaults to 60.
+  /// - `<pose_position_threshold>`: Distance in meters, defaults to 0.
+  ///   Entities which moved at most this far and rotated at most
+  ///   `<pose_orientation_threshold>` since their pose was last published
+  ///   on `dynamic_pose/info` are left out of it, so jittering and settling
+  ///   models don't generate traffic.
+  /// - `<pose_orientation_threshold>`: Rotation angle in radians, defaults
+  ///   to 0.
+  /// - `<model_pose_threshold>`: Thresholds of a model and its links,
+  ///   replacing the ones above. Can be repeated. Children:
+  ///   - `<model>`: Name of the model.
+  ///   - `<position>`: Distance in meters, defaults to 0.
+  ///   - `<orientation>`: Rotation angle in radians, defaults to 0.
+  ///
+  /// A model with both thresholds at 0 has all its poses published.
   class IGNITION_GAZEBO_VISIBLE SceneBroadcaster:
     public System,
     public ISystemConfigure,
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "LidarPointPacker.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+namespace
+{
+/// \brief Add a field to a point cloud message.
+/// \param[in] _name Name of the field.
+/// \param[in] _type Data type of the field.
+/// \param[in] _size Size of the field in bytes.
+/// \param[in,out] _msg Message, whose point step is increased.
+void addField(const std::string &_name,
+    msgs::PointCloudPacked::Field::DataType _type, uint32_t _size,
+    msgs::PointCloudPacked &_msg)
+{
+  auto field = _msg.add_field();
+  field->set_name(_name);
+  field->set_offset(_msg.point_step());
+  field->set_datatype(_type);
+  field->set_count(1);
+  _msg.set_point_step(_msg.point_step() + _size);
+}
+
+/// \brief Linearly spaced angles.
+/// \param[in] _min First angle.
+/// \param[in] _max Last angle.
+/// \param[in] _count Number of angles.
+/// \param[out] _out Cosine and sine of each angle.
+void sampleAngles(double _min, double _max, unsigned int _count,
+    std::vector<std::pair<float, float>> &_out)
+{
+  _out.resize(_count);
+  const double step = _count > 1 ? (_max - _min) / (_count - 1) : 0.0;
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    const double angle = _min + i * step;
+    _out[i] = {static_cast<float>(std::cos(angle)),
+        static_cast<float>(std::sin(angle))};
+  }
+}
+}
+
+//////////////////////////////////////////////////
+LidarPointPacker::LidarPointPacker(LidarPointFormat _format,
+    bool _intensities, double _rangeResolution)
+  : format(_format), intensities(_intensities),
+    rangeResolution(_rangeResolution)
+{
+}
+
+//////////////////////////////////////////////////
+void LidarPointPacker::SetAngles(double _angleMin, double _angleMax,
+    double _verticalAngleMin, double _verticalAngleMax)
+{
+  this->angleMin = _angleMin;
+  this->angleMax = _angleMax;
+  this->verticalAngleMin = _verticalAngleMin;
+  this->verticalAngleMax = _verticalAngleMax;
+  this->width = 0;
+  this->height = 0;
+}
+
+//////////////////////////////////////////////////
+void LidarPointPacker::UpdateDirections(unsigned int _width,
+    unsigned int _height)
+{
+  if (_width == this->width && _height == this->height)
+    return;
+
+  sampleAngles(this->angleMin, this->angleMax, _width, this->horizontal);
+  sampleAngles(this->verticalAngleMin, this->verticalAngleMax, _height,
+      this->vertical);
+  this->width = _width;
+  this->height = _height;
+}
+
+//////////////////////////////////////////////////
+void LidarPointPacker::Pack(const float *_scan, unsigned int _width,
+    unsigned int _height, unsigned int _channels,
+    msgs::PointCloudPacked &_msg)
+{
+  _msg.clear_field();
+  _msg.set_point_step(0);
+  if (this->format == LidarPointFormat::FLOAT32)
+  {
+    addField("x", msgs::PointCloudPacked::Field::FLOAT32, 4, _msg);
+    addField("y", msgs::PointCloudPacked::Field::FLOAT32, 4, _msg);
+    addField("z", msgs::PointCloudPacked::Field::FLOAT32, 4, _msg);
+    if (this->intensities)
+    {
+      addField("intensity", msgs::PointCloudPacked::Field::FLOAT32, 4,
+          _msg);
+    }
+  }
+  else
+  {
+    addField("range", msgs::PointCloudPacked::Field::UINT16, 2, _msg);
+    if (this->intensities)
+    {
+      addField("intensity", msgs::PointCloudPacked::Field::UINT16, 2,
+          _msg);
+    }
+  }
+
+  const uint32_t pointStep = _msg.point_step();
+  _msg.set_width(_width);
+  _msg.set_height(_height);
+  _msg.set_row_step(pointStep * _width);
+  _msg.set_is_bigendian(false);
+  _msg.set_is_dense(false);
+
+  const bool withIntensity = this->intensities && _channels > 1;
+  std::string *data = _msg.mutable_data();
+  data->resize(static_cast<std::size_t>(pointStep) * _width * _height);
+  char *out = &(*data)[0];
+
+  if (this->format == LidarPointFormat::FLOAT32)
+  {
+    this->UpdateDirections(_width, _height);
+    for (unsigned int j = 0; j < _height; ++j)
+    {
+      const auto &vertical = this->vertical[j];
+      for (unsigned int i = 0; i < _width; ++i)
+      {
+        const float *ray = _scan + (j * _width + i) * _channels;
+        const auto &horizontal = this->horizontal[i];
+        float point[4];
+        const float planar = ray[0] * vertical.first;
+        point[0] = planar * horizontal.first;
+        point[1] = planar * horizontal.second;
+        point[2] = ray[0] * vertical.second;
+        point[3] = withIntensity ? ray[1] : 0.0f;
+        std::memcpy(out, point, pointStep);
+        out += pointStep;
+      }
+    }
+    return;
+  }
+
+  constexpr double kMaxValue = std::numeric_limits<uint16_t>::max();
+  for (unsigned int k = 0; k < _width * _height; ++k)
+  {
+    const float *ray = _scan + k * _channels;
+    uint16_t value[2];
+    const double range = std::round(ray[0] / this->rangeResolution);
+    value[0] = std::isfinite(range) && range > 0.0 && range <= kMaxValue ?
+        static_cast<uint16_t>(range) : 0;
+    value[1] = withIntensity ? static_cast<uint16_t>(
+        std::clamp(std::round(static_cast<double>(ray[1])), 0.0,
+        kMaxValue)) : 0;
+    std::memcpy(out, value, pointStep);
+    out += pointStep;
+  }
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_SENSORS_LIDARPOINTPACKER_HH_
+#define IGNITION_GAZEBO_SYSTEMS_SENSORS_LIDARPOINTPACKER_HH_
+
+#include <utility>
+#include <vector>
+
+#include <ignition/msgs/pointcloud_packed.pb.h>
+
+#include <ignition/gazebo/config.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief Layout of the points packed by LidarPointPacker.
+  enum class LidarPointFormat
+  {
+    /// \brief Organized cloud of `x`, `y` and `z` float32 fields, plus an
+    /// `intensity` float32 field if enabled. Rays which didn't hit anything
+    /// have non-finite coordinates.
+    FLOAT32,
+
+    /// \brief Organized range image with a `range` uint16 field, in units
+    /// of the range resolution, plus an `intensity` uint16 field if enabled.
+    /// Rays which didn't hit anything, or are beyond the largest range
+    /// which can be represented, have a range of zero.
+    UINT16
+  };
+
+  /// \brief Packs the raw frames of a GPU lidar into compact point cloud
+  /// messages, which are several times smaller and faster to serialize
+  /// than laser scans of doubles.
+  ///
+  /// Rows are vertical beams from the lowest one up, and columns are
+  /// horizontal rays from the minimum angle to the maximum one.
+  class LidarPointPacker
+  {
+    /// \brief Constructor
+    /// \param[in] _format Layout of the packed points.
+    /// \param[in] _intensities True to include intensities.
+    /// \param[in] _rangeResolution Distance in meters represented by each
+    /// unit of range in the UINT16 format.
+    public: LidarPointPacker(LidarPointFormat _format, bool _intensities,
+        double _rangeResolution);
+
+    /// \brief Set the angles covered by the lidar.
+    /// \param[in] _angleMin Minimum horizontal angle in radians.
+    /// \param[in] _angleMax Maximum horizontal angle in radians.
+    /// \param[in] _verticalAngleMin Minimum vertical angle in radians.
+    /// \param[in] _verticalAngleMax Maximum vertical angle in radians.
+    public: void SetAngles(double _angleMin, double _angleMax,
+        double _verticalAngleMin, double _verticalAngleMax);
+
+    /// \brief Pack a frame. The message's header is left untouched.
+    /// \param[in] _scan Frame with range and intensity as the first two of
+    /// each ray's channels, in row major order.
+    /// \param[in] _width Number of horizontal rays.
+    /// \param[in] _height Number of vertical beams.
+    /// \param[in] _channels Number of values per ray.
+    /// \param[out] _msg Message filled with the points.
+    public: void Pack(const float *_scan, unsigned int _width,
+        unsigned int _height, unsigned int _channels,
+        msgs::PointCloudPacked &_msg);
+
+    /// \brief Compute the direction of each ray for the given frame size.
+    /// \param[in] _width Number of horizontal rays.
+    /// \param[in] _height Number of vertical beams.
+    private: void UpdateDirections(unsigned int _width,
+        unsigned int _height);
+
+    /// \brief Layout of the packed points.
+    private: LidarPointFormat format;
+
+    /// \brief True to include intensities.
+    private: bool intensities;
+
+    /// \brief Meters per unit of range in the UINT16 format.
+    private: double rangeResolution;
+
+    /// \brief Minimum horizontal angle in radians.
+    private: double angleMin{0.0};
+
+    /// \brief Maximum horizontal angle in radians.
+    private: double angleMax{0.0};
+
+    /// \brief Minimum vertical angle in radians.
+    private: double verticalAngleMin{0.0};
+
+    /// \brief Maximum vertical angle in radians.
+    private: double verticalAngleMax{0.0};
+
+    /// \brief Frame width the directions were computed for.
+    private: unsigned int width{0};
+
+    /// \brief Frame height the directions were computed for.
+    private: unsigned int height{0};
+
+    /// \brief Cosine and sine of each horizontal angle.
+    private: std::vector<std::pair<float, float>> horizontal;
+
+    /// \brief Cosine and sine of each vertical angle.
+    private: std::vector<std::pair<float, float>> vertical;
+  };
+}
+}
+}
+}
+
+#endif
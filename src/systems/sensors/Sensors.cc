@@ -17,14 +17,29 @@
 
 #include "Sensors.hh"
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <map>
+#include <memory>
+#include <optional>
 #include <set>
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <ignition/common/Filesystem.hh>
 #include <ignition/common/Profiler.hh>
 #include <ignition/plugin/Register.hh>
+#include <ignition/transport/Node.hh>
 
 #include <sdf/Sensor.hh>
 
@@ -32,6 +47,8 @@
 
 #include <ignition/rendering/Scene.hh>
 #include <ignition/sensors/CameraSensor.hh>
+#include <ignition/sensors/DepthCameraSensor.hh>
+#include <ignition/sensors/GpuLidarSensor.hh>
 #include <ignition/sensors/RenderingSensor.hh>
 #include <ignition/sensors/ThermalCameraSensor.hh>
 #include <ignition/sensors/Manager.hh>
@@ -41,19 +58,53 @@
 #include "ignition/gazebo/components/DepthCamera.hh"
 #include "ignition/gazebo/components/GpuLidar.hh"
 #include "ignition/gazebo/components/RenderEngineServerPlugin.hh"
+#include "ignition/gazebo/components/ResourceCache.hh"
 #include "ignition/gazebo/components/RgbdCamera.hh"
 #include "ignition/gazebo/components/ThermalCamera.hh"
 #include "ignition/gazebo/components/World.hh"
+#include "ignition/gazebo/Conversions.hh"
 #include "ignition/gazebo/Events.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 
 #include "ignition/gazebo/rendering/Events.hh"
 #include "ignition/gazebo/rendering/RenderUtil.hh"
 
+#include "LidarPointPacker.hh"
+
 using namespace ignition;
 using namespace gazebo;
 using namespace systems;
 
+namespace
+{
+//////////////////////////////////////////////////
+/// \brief Point the persistent shader caches of the OpenGL drivers to a
+/// directory, so shaders compiled by one run are reused by the next. The
+/// drivers key cached programs by driver and GPU, so a driver upgrade
+/// doesn't pick up stale programs. Variables already set by the user are
+/// kept. Must be called before the render engine is loaded.
+/// \param[in] _dir Cache directory.
+/// \return True if the directory exists or was created.
+bool enableShaderCache(const std::string &_dir)
+{
+  if (!common::isDirectory(_dir) && !common::createDirectories(_dir))
+    return false;
+
+#ifndef _WIN32
+  // Mesa
+  setenv("MESA_SHADER_CACHE_DIR", _dir.c_str(), 0);
+  setenv("MESA_GLSL_CACHE_DIR", _dir.c_str(), 0);
+  setenv("MESA_SHADER_CACHE_DISABLE", "false", 0);
+
+  // NVIDIA
+  setenv("__GL_SHADER_DISK_CACHE", "1", 0);
+  setenv("__GL_SHADER_DISK_CACHE_PATH", _dir.c_str(), 0);
+  setenv("__GL_SHADER_DISK_CACHE_SKIP_CLEANUP", "1", 0);
+#endif
+  return true;
+}
+}
+
 // Private data class.
 class ignition::gazebo::systems::SensorsPrivate
 {
@@ -103,9 +154,32 @@ class ignition::gazebo::systems::SensorsPrivate
   /// \brief Flag to signal if rendering update is needed
   public: bool updateAvailable { false };
 
+  /// \brief True while the render thread is rendering an update it took.
+  public: bool rendering { false };
+
+  /// \brief True to let physics continue while sensors are rendered, only
+  /// waiting for rendering once it falls behind by more than maxRenderLag.
+  public: bool asyncRendering { false };
+
+  /// \brief Number of sensor updates which may be merged into a pending
+  /// rendering update while the render thread is busy, when rendering
+  /// asynchronously.
+  public: unsigned int maxRenderLag { 1 };
+
+  /// \brief Number of sensor updates merged into the pending rendering
+  /// update so far.
+  public: unsigned int renderLag { 0 };
+
+  /// \brief True to hide models beyond the far clip plane of all sensors
+  /// before rendering.
+  public: bool distanceCulling { false };
+
   /// \brief Thread that rendering will occur in
   public: std::thread renderThread;
 
+  /// \brief CPUs the render thread is pinned to, empty to not pin it.
+  public: std::vector<unsigned int> renderCpus;
+
   /// \brief Mutex to protect rendering data
   public: std::mutex renderMutex;
 
@@ -125,16 +199,129 @@ class ignition::gazebo::systems::SensorsPrivate
   /// \brief Sensors to include in the next rendering iteration
   public: std::vector<sensors::RenderingSensor *> activeSensors;
 
-  /// \brief Mutex to protect sensorMask
-  public: std::mutex sensorMaskMutex;
+  /// \brief Sensors included in the rendering iteration in progress. Only
+  /// accessed by the rendering thread.
+  public: std::vector<sensors::RenderingSensor *> renderingSensors;
+
+  /// \brief Mutex to protect the schedule
+  public: std::mutex scheduleMutex;
+
+  /// \brief Rendering sensors, ordered by the simulation time at which
+  /// they must be checked next, so only due sensors are visited each step.
+  public: std::set<std::pair<std::chrono::steady_clock::duration,
+      sensors::SensorId>> schedule;
+
+  /// \brief A rendering sensor in the schedule.
+  public: struct ScheduledSensor
+  {
+    /// \brief The sensor.
+    public: sensors::RenderingSensor *sensor{nullptr};
 
-  /// \brief Mask sensor updates for sensors currently being rendered
-  public: std::map<sensors::SensorId,
-    std::chrono::steady_clock::duration> sensorMask;
+    /// \brief Time the sensor is scheduled at.
+    public: std::chrono::steady_clock::duration time{0};
+  };
+
+  /// \brief Scheduled sensors, by ID.
+  public: std::unordered_map<sensors::SensorId, ScheduledSensor> scheduled;
+
+  /// \brief Time a rendering pass is delayed to also render sensors due
+  /// shortly after the first due sensor. Zero to not delay.
+  public: std::chrono::steady_clock::duration renderGroupingWindow{0};
+
+  /// \brief Move a sensor in the schedule. Must hold scheduleMutex.
+  /// \param[in] _id Sensor ID.
+  /// \param[in] _time Time the sensor must be checked next.
+  public: void Reschedule(sensors::SensorId _id,
+      std::chrono::steady_clock::duration _time);
+
+  /// \brief Take the sensors which are due from the schedule. Must hold
+  /// scheduleMutex.
+  /// \param[in] _time Current simulation time.
+  /// \param[out] _sensors Due sensors.
+  public: void TakeDueSensors(std::chrono::steady_clock::duration _time,
+      std::vector<sensors::RenderingSensor *> &_sensors);
 
   /// \brief Pointer to the event manager
   public: EventManager *eventManager{nullptr};
 
+  /// \brief Connection to the events::EnableImageFrames event
+  public: ignition::common::ConnectionPtr enableFramesConn;
+
+  /// \brief Mutex to protect frameRequests
+  public: std::mutex frameRequestMutex;
+
+  /// \brief Number of requests for image frames from each sensor entity
+  public: std::unordered_map<Entity, int> frameRequests;
+
+  /// \brief Connections to the image callbacks of sensors whose frames are
+  /// shared in-process. Only accessed by the rendering thread.
+  public: std::unordered_map<Entity, ignition::common::ConnectionPtr>
+      frameConnections;
+
+  /// \brief Simulation time of the update being rendered. Only accessed by
+  /// the rendering thread.
+  public: std::chrono::steady_clock::duration renderTime{0};
+
+  /// \brief Layout of the packed point clouds published for GPU lidars, or
+  /// nullopt to not publish them.
+  public: std::optional<LidarPointFormat> lidarPointFormat;
+
+  /// \brief True to include intensities in packed lidar point clouds.
+  public: bool lidarPointIntensities{true};
+
+  /// \brief Meters per unit of range in UINT16 packed lidar point clouds.
+  public: double lidarRangeResolution{0.01};
+
+  /// \brief Packed point cloud output of a GPU lidar.
+  public: struct PackedLidar
+  {
+    /// \brief Constructor
+    /// \param[in] _format Layout of the packed points.
+    /// \param[in] _intensities True to include intensities.
+    /// \param[in] _rangeResolution Meters per unit of range.
+    public: PackedLidar(LidarPointFormat _format, bool _intensities,
+        double _rangeResolution)
+      : packer(_format, _intensities, _rangeResolution)
+    {
+    }
+
+    /// \brief Packs the lidar's frames.
+    public: LidarPointPacker packer;
+
+    /// \brief Message reused for every frame.
+    public: msgs::PointCloudPacked msg;
+
+    /// \brief Publisher of the packed point clouds.
+    public: transport::Node::Publisher pub;
+
+    /// \brief Connection to the lidar's frames.
+    public: ignition::common::ConnectionPtr conn;
+  };
+
+  /// \brief Packed point cloud outputs of each GPU lidar entity. Only
+  /// accessed by the rendering thread.
+  public: std::unordered_map<Entity, std::unique_ptr<PackedLidar>>
+      packedLidars;
+
+  /// \brief Node used to publish packed lidar point clouds.
+  public: transport::Node node;
+
+  /// \brief Start publishing packed point clouds for a GPU lidar.
+  /// \param[in] _entity Sensor entity.
+  /// \param[in] _lidar Lidar sensor.
+  public: void AddPackedLidar(const Entity &_entity,
+      sensors::GpuLidarSensor *_lidar);
+
+  /// \brief Callback for events::EnableImageFrames
+  /// \param[in] _entity Sensor entity.
+  /// \param[in] _enable True to start receiving frames, false to stop.
+  public: void OnEnableImageFrames(const Entity &_entity, bool _enable);
+
+  /// \brief Connect to or disconnect from the image callbacks of sensors
+  /// according to the requests for image frames. Called in the rendering
+  /// thread, so it doesn't race with sensor creation and removal.
+  public: void UpdateFrameConnections();
+
   /// \brief Wait for initialization to happen
   private: void WaitForInit();
 
@@ -159,7 +346,8 @@ class ignition::gazebo::systems::SensorsPrivate
   ///
   /// Once in steady state, a rendering operation is triggered by setting
   /// updateAvailable to true, and notifying via the renderCv.
-  /// The rendering operation is done in `RunOnce`.
+  /// The rendering operation is done in `RunOnce`, which clears
+  /// updateAvailable and sets `rendering` while it renders.
   ///
   /// The caller of PostUpdate will not be blocked if there is no
   /// rendering operation currently ongoing. Rendering will occur
@@ -167,6 +355,11 @@ class ignition::gazebo::systems::SensorsPrivate
   //
   /// The caller of PostUpdate will be blocked if there is a rendering
   /// operation currently ongoing, until that completes.
+  ///
+  /// With asyncRendering, the caller of PostUpdate is only blocked while an
+  /// operation is still waiting for the render thread and maxRenderLag
+  /// updates were already merged into it. Otherwise the update is merged, or
+  /// queued behind the operation in progress.
   private: void RenderThread();
 
   /// \brief Launch the rendering thread
@@ -220,34 +413,33 @@ void SensorsPrivate::RunOnce()
   if (!this->scene)
     return;
 
+  // Take the update, so the next one can be posted while rendering
+  const auto updateTime = this->updateTime;
+  this->renderTime = updateTime;
+  this->renderingSensors = std::move(this->activeSensors);
+  this->activeSensors.clear();
+  this->updateAvailable = false;
+  this->renderLag = 0;
+  this->rendering = true;
+  lock.unlock();
+  this->renderCv.notify_one();
+
   IGN_PROFILE("SensorsPrivate::RunOnce");
   {
     IGN_PROFILE("Update");
     this->renderUtil.Update();
   }
+  this->UpdateFrameConnections();
 
-
-  if (!this->activeSensors.empty())
+  if (this->distanceCulling)
   {
-    this->sensorMaskMutex.lock();
-    // Check the active sensors against masked sensors.
-    //
-    // The internal state of a rendering sensor is not updated until the
-    // rendering operation is complete, which can leave us in a position
-    // where the sensor is falsely indicating that an update is needed.
-    //
-    // To prevent this, add sensors that are currently being rendered to
-    // a mask. Sensors are removed from the mask when 90% of the update
-    // delta has passed, which will allow rendering to proceed.
-    for (const auto & sensor : this->activeSensors)
-    {
-      // 90% of update delta (1/UpdateRate());
-      auto delta = std::chrono::duration_cast< std::chrono::milliseconds>(
-        std::chrono::duration< double >(0.9 / sensor->UpdateRate()));
-      this->sensorMask[sensor->Id()] = this->updateTime + delta;
-    }
-    this->sensorMaskMutex.unlock();
+    IGN_PROFILE("CullByDistance");
+    this->renderUtil.SceneManager().CullByDistance();
+  }
+
 
+  if (!this->renderingSensors.empty())
+  {
     {
       IGN_PROFILE("PreRender");
       this->eventManager->Emit<events::PreRender>();
@@ -261,23 +453,171 @@ void SensorsPrivate::RunOnce()
     {
       // publish data
       IGN_PROFILE("RunOnce");
-      this->sensorManager.RunOnce(this->updateTime);
+      this->sensorManager.RunOnce(updateTime);
       this->eventManager->Emit<events::PostRender>();
     }
 
-    this->activeSensors.clear();
+    this->renderingSensors.clear();
   }
 
-  this->updateAvailable = false;
+  lock.lock();
+  this->rendering = false;
   lock.unlock();
   this->renderCv.notify_one();
 }
 
+//////////////////////////////////////////////////
+void SensorsPrivate::Reschedule(sensors::SensorId _id,
+    std::chrono::steady_clock::duration _time)
+{
+  auto &entry = this->scheduled.at(_id);
+  this->schedule.erase({entry.time, _id});
+  entry.time = _time;
+  this->schedule.insert({_time, _id});
+}
+
+//////////////////////////////////////////////////
+void SensorsPrivate::TakeDueSensors(std::chrono::steady_clock::duration _time,
+    std::vector<sensors::RenderingSensor *> &_sensors)
+{
+  if (this->schedule.empty() || this->schedule.begin()->first > _time)
+    return;
+
+  // Delay rendering while other sensors are due within the grouping window,
+  // so they're all rendered in one pass. Sensors are only ever late by less
+  // than the window, and their update phase isn't affected.
+  if (this->renderGroupingWindow > std::chrono::steady_clock::duration::zero())
+  {
+    auto windowEnd = this->schedule.begin()->first + this->renderGroupingWindow;
+    auto next = this->schedule.upper_bound(
+        {_time, std::numeric_limits<sensors::SensorId>::max()});
+    if (next != this->schedule.end() && next->first <= windowEnd)
+      return;
+  }
+
+  // Sensors are rescheduled after the loop, so the iterators stay valid
+  std::vector<std::pair<sensors::SensorId, std::chrono::steady_clock::duration>>
+      rescheduled;
+  for (auto it = this->schedule.begin();
+       it != this->schedule.end() && it->first <= _time; ++it)
+  {
+    auto id = it->second;
+    auto sensor = this->scheduled.at(id).sensor;
+
+    // Already updated, wait for its next update
+    auto nextUpdate = sensor->NextDataUpdateTime();
+    if (nextUpdate > _time)
+    {
+      rescheduled.push_back({id, nextUpdate});
+      continue;
+    }
+
+    _sensors.push_back(sensor);
+
+    // The next update time of a sensor isn't updated until it's rendered,
+    // so it would still be due on the following steps. Check it again once
+    // 90% of its update period has passed, which leaves time for rendering.
+    auto rate = sensor->UpdateRate();
+    auto delta = std::chrono::steady_clock::duration(1);
+    if (rate > 0.0)
+    {
+      delta = std::max(delta,
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(0.9 / rate)));
+    }
+    rescheduled.push_back({id, _time + delta});
+  }
+
+  for (const auto &[id, time] : rescheduled)
+    this->Reschedule(id, time);
+}
+
+//////////////////////////////////////////////////
+void SensorsPrivate::OnEnableImageFrames(const Entity &_entity, bool _enable)
+{
+  std::lock_guard<std::mutex> lock(this->frameRequestMutex);
+  auto &count = this->frameRequests[_entity];
+  count += _enable ? 1 : -1;
+  if (count <= 0)
+    this->frameRequests.erase(_entity);
+}
+
+//////////////////////////////////////////////////
+void SensorsPrivate::UpdateFrameConnections()
+{
+  std::lock_guard<std::mutex> lock(this->frameRequestMutex);
+  for (auto it = this->frameConnections.begin();
+      it != this->frameConnections.end();)
+  {
+    if (this->frameRequests.find(it->first) == this->frameRequests.end())
+      it = this->frameConnections.erase(it);
+    else
+      ++it;
+  }
+
+  for (const auto &request : this->frameRequests)
+  {
+    const Entity entity = request.first;
+    if (this->frameConnections.find(entity) != this->frameConnections.end())
+      continue;
+
+    auto idIter = this->entityToIdMap.find(entity);
+    if (idIter == this->entityToIdMap.end())
+      continue;
+
+    // Each frame is copied once out of the sensor and shared by all
+    // in-process consumers
+    auto share = [this, entity](const msgs::Image &_msg)
+    {
+      this->eventManager->Emit<events::NewImageFrame>(entity,
+          std::make_shared<const msgs::Image>(_msg));
+    };
+
+    // Depth and thermal cameras have their own image callbacks
+    sensors::Sensor *sensor = this->sensorManager.Sensor(idIter->second);
+    ignition::common::ConnectionPtr conn;
+    if (auto depth = dynamic_cast<sensors::DepthCameraSensor *>(sensor))
+      conn = depth->ConnectImageCallback(share);
+    else if (auto thermal =
+        dynamic_cast<sensors::ThermalCameraSensor *>(sensor))
+      conn = thermal->ConnectImageCallback(share);
+    else if (auto camera = dynamic_cast<sensors::CameraSensor *>(sensor))
+      conn = camera->ConnectImageCallback(share);
+
+    if (!conn)
+    {
+      ignerr << "Sensor of entity [" << entity << "] doesn't generate image "
+             << "frames" << std::endl;
+    }
+    this->frameConnections[entity] = conn;
+  }
+}
+
 //////////////////////////////////////////////////
 void SensorsPrivate::RenderThread()
 {
   IGN_PROFILE_THREAD_NAME("RenderThread");
 
+  if (!this->renderCpus.empty())
+  {
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (auto cpu : this->renderCpus)
+      CPU_SET(cpu, &cpus);
+
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (result != 0)
+    {
+      ignwarn << "Failed to set the CPU affinity of the render thread: "
+              << std::strerror(result) << std::endl;
+    }
+#else
+    ignwarn << "<render_cpu_affinity> is only supported on Linux, ignoring "
+            << "it." << std::endl;
+#endif
+  }
+
   igndbg << "SensorsPrivate::RenderThread started" << std::endl;
 
   // We have to wait for rendering sensors to be available
@@ -289,6 +629,8 @@ void SensorsPrivate::RenderThread()
   }
 
   // clean up before exiting
+  this->frameConnections.clear();
+  this->packedLidars.clear();
   for (const auto id : this->sensorIds)
     this->sensorManager.Remove(id);
 
@@ -331,20 +673,31 @@ void Sensors::RemoveSensor(const Entity &_entity)
   auto idIter = this->dataPtr->entityToIdMap.find(_entity);
   if (idIter != this->dataPtr->entityToIdMap.end())
   {
-    // Remove from active sensors as well
-    // Locking mutex to make sure the vector is not being changed while
-    // the rendering thread is iterating over it
+    // Remove from active sensors as well. This is called by the rendering
+    // thread, so only the pending update needs locking.
+    sensors::Sensor *s = this->dataPtr->sensorManager.Sensor(idIter->second);
+    auto rs = dynamic_cast<sensors::RenderingSensor *>(s);
+    auto erase = [rs](std::vector<sensors::RenderingSensor *> &_sensors)
     {
-      std::unique_lock<std::mutex> lock(this->dataPtr->sensorMaskMutex);
-      sensors::Sensor *s = this->dataPtr->sensorManager.Sensor(idIter->second);
-      auto rs = dynamic_cast<sensors::RenderingSensor *>(s);
-      auto activeSensorIt = std::find(this->dataPtr->activeSensors.begin(),
-          this->dataPtr->activeSensors.end(), rs);
-      if (activeSensorIt != this->dataPtr->activeSensors.end())
+      _sensors.erase(std::remove(_sensors.begin(), _sensors.end(), rs),
+          _sensors.end());
+    };
+    {
+      std::unique_lock<std::mutex> lock(this->dataPtr->renderMutex);
+      erase(this->dataPtr->activeSensors);
+    }
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->scheduleMutex);
+      auto schedIt = this->dataPtr->scheduled.find(idIter->second);
+      if (schedIt != this->dataPtr->scheduled.end())
       {
-        this->dataPtr->activeSensors.erase(activeSensorIt);
+        this->dataPtr->schedule.erase({schedIt->second.time, idIter->second});
+        this->dataPtr->scheduled.erase(schedIt);
       }
     }
+    erase(this->dataPtr->renderingSensors);
+    this->dataPtr->frameConnections.erase(_entity);
+    this->dataPtr->packedLidars.erase(_entity);
     this->dataPtr->sensorIds.erase(idIter->second);
     this->dataPtr->sensorManager.Remove(idIter->second);
     this->dataPtr->entityToIdMap.erase(idIter);
@@ -374,6 +727,66 @@ void Sensors::Configure(const Entity &/*_id*/,
       _sdf->Get<std::string>("render_engine", "ogre2").first;
 
   this->dataPtr->renderUtil.SetEngineName(engineName);
+
+  this->dataPtr->asyncRendering =
+      _sdf->Get<bool>("async_rendering", false).first;
+  this->dataPtr->maxRenderLag =
+      _sdf->Get<unsigned int>("max_render_lag",
+      this->dataPtr->maxRenderLag).first;
+  this->dataPtr->distanceCulling =
+      _sdf->Get<bool>("distance_culling", false).first;
+
+  auto groupingWindow = _sdf->Get<double>("render_grouping_window", 0.0).first;
+  if (groupingWindow < 0.0)
+  {
+    ignerr << "<render_grouping_window> can't be negative, sensors won't be "
+           << "grouped." << std::endl;
+    groupingWindow = 0.0;
+  }
+  this->dataPtr->renderGroupingWindow =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(groupingWindow));
+
+  if (_sdf->HasElement("lidar_points_format"))
+  {
+    auto format = _sdf->Get<std::string>("lidar_points_format");
+    if (format == "float32")
+      this->dataPtr->lidarPointFormat = LidarPointFormat::FLOAT32;
+    else if (format == "uint16")
+      this->dataPtr->lidarPointFormat = LidarPointFormat::UINT16;
+    else
+    {
+      ignerr << "Unknown <lidar_points_format> [" << format
+             << "], expected [float32] or [uint16]. Packed lidar point "
+             << "clouds won't be published." << std::endl;
+    }
+  }
+  this->dataPtr->lidarPointIntensities = _sdf->Get<bool>(
+      "lidar_points_intensities",
+      this->dataPtr->lidarPointIntensities).first;
+  this->dataPtr->lidarRangeResolution = _sdf->Get<double>(
+      "lidar_range_resolution", this->dataPtr->lidarRangeResolution).first;
+  if (this->dataPtr->lidarRangeResolution <= 0.0)
+  {
+    ignerr << "<lidar_range_resolution> must be positive, using [0.01]"
+           << std::endl;
+    this->dataPtr->lidarRangeResolution = 0.01;
+  }
+
+  if (_sdf->HasElement("render_cpu_affinity"))
+  {
+    std::istringstream cpus(_sdf->Get<std::string>("render_cpu_affinity"));
+    unsigned int cpu;
+    while (cpus >> cpu)
+      this->dataPtr->renderCpus.push_back(cpu);
+    if (!cpus.eof())
+    {
+      ignerr << "Invalid <render_cpu_affinity>, expected space separated CPU "
+             << "indices. The render thread won't be pinned." << std::endl;
+      this->dataPtr->renderCpus.clear();
+    }
+  }
+
   this->dataPtr->renderUtil.SetEnableSensors(true,
       std::bind(&Sensors::CreateSensor, this,
       std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
@@ -400,6 +813,39 @@ void Sensors::Configure(const Entity &/*_id*/,
     if (renderEngineServerComp && !renderEngineServerComp->Data().empty())
     {
       this->dataPtr->renderUtil.SetEngineName(renderEngineServerComp->Data());
+      engineName = renderEngineServerComp->Data();
+    }
+  }
+
+  // Reuse shaders compiled by previous runs. This happens before the render
+  // engine is loaded on the render thread.
+  if (_sdf->HasElement("shader_cache"))
+  {
+    auto cacheDir = _sdf->Get<std::string>("shader_cache");
+    if (cacheDir.empty() && kNullEntity != worldEntity)
+    {
+      auto cacheComp = _ecm.Component<components::ResourceCache>(worldEntity);
+      if (cacheComp && !cacheComp->Data().empty())
+        cacheDir = common::joinPaths(cacheComp->Data(), "shader_cache");
+    }
+
+    if (cacheDir.empty())
+    {
+      ignerr << "No directory for <shader_cache>, shaders won't be cached."
+             << std::endl;
+    }
+    else
+    {
+      cacheDir = common::joinPaths(cacheDir, engineName);
+      if (enableShaderCache(cacheDir))
+      {
+        igndbg << "Caching shaders in [" << cacheDir << "]" << std::endl;
+      }
+      else
+      {
+        ignerr << "Failed to create shader cache [" << cacheDir << "]"
+               << std::endl;
+      }
     }
   }
 
@@ -408,6 +854,11 @@ void Sensors::Configure(const Entity &/*_id*/,
   this->dataPtr->stopConn = _eventMgr.Connect<events::Stop>(
       std::bind(&SensorsPrivate::Stop, this->dataPtr.get()));
 
+  this->dataPtr->enableFramesConn =
+      _eventMgr.Connect<events::EnableImageFrames>(
+      std::bind(&SensorsPrivate::OnEnableImageFrames, this->dataPtr.get(),
+      std::placeholders::_1, std::placeholders::_2));
+
   // Kick off worker thread
   this->dataPtr->Run();
 }
@@ -458,39 +909,38 @@ void Sensors::PostUpdate(const UpdateInfo &_info,
     auto t = math::secNsecToDuration(time.first, time.second);
 
     std::vector<sensors::RenderingSensor *> activeSensors;
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->scheduleMutex);
+      this->dataPtr->TakeDueSensors(t, activeSensors);
+    }
 
-    this->dataPtr->sensorMaskMutex.lock();
-    for (auto id : this->dataPtr->sensorIds)
+    if (!activeSensors.empty() ||
+        this->dataPtr->renderUtil.PendingSensors() > 0)
     {
-      sensors::Sensor *s = this->dataPtr->sensorManager.Sensor(id);
-      auto rs = dynamic_cast<sensors::RenderingSensor *>(s);
+      std::unique_lock<std::mutex> lock(this->dataPtr->renderMutex);
 
-      auto it = this->dataPtr->sensorMask.find(id);
-      if (it != this->dataPtr->sensorMask.end())
+      // Merge into the update which is still waiting for the render thread.
+      // It will be rendered from the latest state, so it takes this time.
+      if (this->dataPtr->asyncRendering && this->dataPtr->updateAvailable &&
+          this->dataPtr->renderLag < this->dataPtr->maxRenderLag)
       {
-        if (it->second <= t)
-        {
-          this->dataPtr->sensorMask.erase(it);
-        }
-        else
+        auto &pending = this->dataPtr->activeSensors;
+        for (auto sensor : activeSensors)
         {
-          continue;
+          if (std::find(pending.begin(), pending.end(), sensor) ==
+              pending.end())
+          {
+            pending.push_back(sensor);
+          }
         }
+        this->dataPtr->updateTime = t;
+        ++this->dataPtr->renderLag;
+        return;
       }
 
-      if (rs && rs->NextDataUpdateTime() <= t)
-      {
-        activeSensors.push_back(rs);
-      }
-    }
-    this->dataPtr->sensorMaskMutex.unlock();
-
-    if (!activeSensors.empty() ||
-        this->dataPtr->renderUtil.PendingSensors() > 0)
-    {
-      std::unique_lock<std::mutex> lock(this->dataPtr->renderMutex);
       this->dataPtr->renderCv.wait(lock, [this] {
-        return !this->dataPtr->running || !this->dataPtr->updateAvailable; });
+        return !this->dataPtr->running || (!this->dataPtr->updateAvailable &&
+            (this->dataPtr->asyncRendering || !this->dataPtr->rendering)); });
 
       if (!this->dataPtr->running)
       {
@@ -502,6 +952,13 @@ void Sensors::PostUpdate(const UpdateInfo &_info,
       this->dataPtr->updateAvailable = true;
       this->dataPtr->renderCv.notify_one();
     }
+    else if (this->dataPtr->asyncRendering)
+    {
+      // The pending update will be rendered from the latest state
+      std::unique_lock<std::mutex> lock(this->dataPtr->renderMutex);
+      if (this->dataPtr->updateAvailable)
+        this->dataPtr->updateTime = t;
+    }
   }
 }
 
@@ -538,6 +995,15 @@ std::string Sensors::CreateSensor(const Entity &_entity,
   renderingSensor->SetParent(_parentName);
   renderingSensor->SetManualSceneUpdate(true);
 
+  // Checked on the next step
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->scheduleMutex);
+    this->dataPtr->scheduled[sensorId] = {renderingSensor,
+        std::chrono::steady_clock::duration::zero()};
+    this->dataPtr->schedule.insert(
+        {std::chrono::steady_clock::duration::zero(), sensorId});
+  }
+
   // Special case for stereo cameras
   auto cameraSensor = dynamic_cast<sensors::CameraSensor *>(sensor);
   if (nullptr != cameraSensor)
@@ -604,9 +1070,51 @@ std::string Sensors::CreateSensor(const Entity &_entity,
            << " Kelvin." << std::endl;
   }
 
+  auto lidarSensor = dynamic_cast<sensors::GpuLidarSensor *>(sensor);
+  if (nullptr != lidarSensor && this->dataPtr->lidarPointFormat)
+    this->dataPtr->AddPackedLidar(_entity, lidarSensor);
+
   return sensor->Name();
 }
 
+//////////////////////////////////////////////////
+void SensorsPrivate::AddPackedLidar(const Entity &_entity,
+    sensors::GpuLidarSensor *_lidar)
+{
+  auto packed = std::make_unique<PackedLidar>(*this->lidarPointFormat,
+      this->lidarPointIntensities, this->lidarRangeResolution);
+  packed->packer.SetAngles(_lidar->AngleMin().Radian(),
+      _lidar->AngleMax().Radian(), _lidar->VerticalAngleMin().Radian(),
+      _lidar->VerticalAngleMax().Radian());
+
+  auto frame = packed->msg.mutable_header()->add_data();
+  frame->set_key("frame_id");
+  frame->add_value(_lidar->FrameId());
+
+  const std::string topic = _lidar->Topic() + "/packed";
+  packed->pub = this->node.Advertise<msgs::PointCloudPacked>(topic);
+  igndbg << "Publishing packed point clouds of lidar [" << _lidar->Name()
+         << "] on [" << topic << "]" << std::endl;
+
+  // Frames arrive in the rendering thread while the sensor is rendered
+  auto output = packed.get();
+  packed->conn = _lidar->ConnectNewLidarFrame(
+      [this, output](const float *_scan, unsigned int _width,
+          unsigned int _height, unsigned int _channels,
+          const std::string &/*_format*/)
+      {
+        if (!output->pub.HasConnections())
+          return;
+
+        output->packer.Pack(_scan, _width, _height, _channels, output->msg);
+        output->msg.mutable_header()->mutable_stamp()->CopyFrom(
+            convert<msgs::Time>(this->renderTime));
+        output->pub.Publish(output->msg);
+      });
+
+  this->packedLidars[_entity] = std::move(packed);
+}
+
 IGNITION_ADD_PLUGIN(Sensors, System,
   Sensors::ISystemConfigure,
   Sensors::ISystemUpdate,
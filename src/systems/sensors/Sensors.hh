@@ -39,6 +39,54 @@ namespace systems
   /// \class Sensors Sensors.hh ignition/gazebo/systems/Sensors.hh
   /// \brief TODO(louise) Have one system for all sensors, or one per
   /// sensor / sensor type?
+  ///
+  /// All rendering sensors are rendered by a single render thread, which owns
+  /// the render engine's context and scene. The scene graph is updated once
+  /// per frame and shared by all sensors due at that time. Sensors with the
+  /// same update rate are due at the same times, so rigs such as stereo
+  /// pairs and co-located depth and color cameras are rendered in the same
+  /// frame.
+  ///
+  /// Partitioning sensors across several render threads or GPUs isn't
+  /// supported, because the render engines only support one context per
+  /// process, bound to the thread which loaded the engine.
+  ///
+  /// ## System Parameters
+  ///
+  /// - `<render_engine>` Name of the render engine, defaults to `ogre2`.
+  /// Overridden by the render engine given on the command line.
+  /// - `<async_rendering>` True to keep simulating while sensors are
+  /// rendered, defaults to false. Sensor data is stamped with the simulation
+  /// time of the state it was rendered from, which may be later than the
+  /// time the sensor was due.
+  /// - `<max_render_lag>` When rendering asynchronously, number of sensor
+  /// updates merged into an update still waiting for the render thread
+  /// before simulation waits for rendering to catch up, defaults to 1.
+  /// - `<render_grouping_window>` Seconds a rendering pass may be delayed
+  /// so sensors due shortly after the first due sensor are rendered in the
+  /// same pass, defaults to 0. For example, with a 30 Hz and a 10 Hz
+  /// camera, a window of 0.005 renders the 10 Hz camera together with
+  /// every third frame of the 30 Hz camera, instead of a few milliseconds
+  /// apart. Sensors are late by less than the window.
+  /// - `<distance_culling>` True to hide models which are beyond the far
+  /// clip plane of every sensor before rendering, defaults to false. Useful
+  /// in large worlds where most models are out of range of all sensors.
+  /// - `<lidar_points_format>` If set, GPU lidars also publish compact
+  /// `ignition.msgs.PointCloudPacked` messages on `<lidar topic>/packed`.
+  /// Either `float32`, for organized `x`, `y`, `z` points, or `uint16`, for
+  /// an organized range image. Unset by default.
+  /// - `<lidar_points_intensities>` True to include intensities in the
+  /// packed point clouds, defaults to true.
+  /// - `<lidar_range_resolution>` Meters per unit of range in `uint16`
+  /// point clouds, defaults to 0.01.
+  /// - `<render_cpu_affinity>` Space separated indices of the CPUs the
+  /// render thread is pinned to, such as `4 5`. Only supported on Linux.
+  /// Unset by default, which doesn't pin the thread.
+  /// - `<shader_cache>` If set, shaders compiled by the OpenGL driver are
+  /// kept in this directory across runs, which shortens sensor startup. If
+  /// empty, a `shader_cache` directory in the resource cache is used. The
+  /// driver's own cache environment variables take precedence. Unset by
+  /// default.
   class IGNITION_GAZEBO_VISIBLE Sensors:
     public System,
     public ISystemConfigure,
@@ -109,8 +109,16 @@ class ignition::gazebo::systems::TouchPluginPrivate
   /// \brief Whether the plugin is enabled.
   public: bool enabled{false};
 
+  /// \brief Whether the model was touching a target in the last update.
+  public: bool touching{false};
+
+  /// \brief Whether contacts must be checked even if none of the
+  /// collisions' contacts began or ended, because the plugin was enabled or
+  /// targets were added since the last check.
+  public: bool recheck{true};
+
   /// \brief Mutex for variables mutated by the service callback.
-  /// The variables are: touchPub, touchStart, enabled
+  /// The variables are: touchPub, touchStart, enabled, recheck
   public: std::mutex serviceMutex;
 };
 
@@ -212,6 +220,7 @@ void TouchPluginPrivate::Enable(const bool _value)
 
     this->touchStart = DurationType::zero();
     this->enabled = true;
+    this->recheck = true;
 
     igndbg << "Started touch plugin [" << this->ns << "]" << std::endl;
   }
@@ -244,41 +253,63 @@ void TouchPluginPrivate::Update(const UpdateInfo &_info,
         << "s]. System may not work properly." << std::endl;
   }
 
+  bool recheck{false};
   {
     std::lock_guard<std::mutex> lock(this->serviceMutex);
     if (!this->enabled)
       return;
+    recheck = this->recheck;
   }
 
   if (_info.paused)
     return;
 
-  bool touching{false};
-  // Iterate through all the target entities and check if there is a contact
-  // between the target entity and this model
+  // Physics only flags the contacts as changed when collisions begin or end
+  // touching, otherwise the model is still touching what it was touching
   for (const Entity colEntity : this->collisionEntities)
   {
-    auto *contacts = _ecm.Component<components::ContactSensorData>(colEntity);
-    if (contacts)
+    if (recheck)
+      break;
+    recheck = _ecm.ComponentState(colEntity,
+        components::ContactSensorData::typeId) ==
+        ComponentState::OneTimeChange;
+  }
+
+  if (recheck)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->serviceMutex);
+      this->recheck = false;
+    }
+
+    this->touching = false;
+    // Iterate through all the target entities and check if there is a
+    // contact between the target entity and this model
+    for (const Entity colEntity : this->collisionEntities)
     {
-      // Check if the contacts include one of the target entities.
-      for (const auto &contact : contacts->Data().contact())
+      auto *contacts =
+          _ecm.Component<components::ContactSensorData>(colEntity);
+      if (contacts)
       {
-        bool col1Target = std::binary_search(this->targetEntities.begin(),
-            this->targetEntities.end(),
-            contact.collision1().id());
-        bool col2Target = std::binary_search(this->targetEntities.begin(),
-            this->targetEntities.end(),
-            contact.collision2().id());
-        if (col1Target || col2Target)
+        // Check if the contacts include one of the target entities.
+        for (const auto &contact : contacts->Data().contact())
         {
-          touching = true;
+          bool col1Target = std::binary_search(this->targetEntities.begin(),
+              this->targetEntities.end(),
+              contact.collision1().id());
+          bool col2Target = std::binary_search(this->targetEntities.begin(),
+              this->targetEntities.end(),
+              contact.collision2().id());
+          if (col1Target || col2Target)
+          {
+            this->touching = true;
+          }
         }
       }
     }
   }
 
-  if (!touching)
+  if (!this->touching)
   {
     std::lock_guard<std::mutex> lock(this->serviceMutex);
     if (this->touchStart != DurationType::zero())
@@ -338,6 +369,7 @@ void TouchPluginPrivate::AddTargetEntities(const EntityComponentManager &_ecm,
   if (_entities.empty())
     return;
 
+  const std::size_t targetCount = this->targetEntities.size();
   for (Entity entity : _entities)
   {
     // The target name can be a substring of the desired collision name so we
@@ -350,8 +382,15 @@ void TouchPluginPrivate::AddTargetEntities(const EntityComponentManager &_ecm,
     }
   }
 
+  if (this->targetEntities.size() == targetCount)
+    return;
+
   // Sort so that we can do binary search later on.
   std::sort(this->targetEntities.begin(), this->targetEntities.end());
+
+  // New targets may already be in contact
+  std::lock_guard<std::mutex> lock(this->serviceMutex);
+  this->recheck = true;
 }
 
 //////////////////////////////////////////////////
@@ -369,6 +408,14 @@ void TouchPlugin::Configure(const Entity &_entity,
   this->dataPtr->sdfConfig = _sdf->Clone();
 }
 
+//////////////////////////////////////////////////
+bool TouchPlugin::ConfigureParallel() const
+{
+  // Configure only reads the model and keeps a copy of the SDF, everything
+  // else is set up on the first PreUpdate.
+  return true;
+}
+
 //////////////////////////////////////////////////
 void TouchPlugin::PreUpdate(const UpdateInfo &, EntityComponentManager &_ecm)
 {
@@ -411,6 +458,7 @@ void TouchPlugin::PostUpdate(const UpdateInfo &_info,
 IGNITION_ADD_PLUGIN(TouchPlugin,
                     ignition::gazebo::System,
                     TouchPlugin::ISystemConfigure,
+                    TouchPlugin::ISystemConfigureParallel,
                     TouchPlugin::ISystemPreUpdate,
                     TouchPlugin::ISystemPostUpdate)
 
@@ -60,6 +60,7 @@ namespace systems
   class IGNITION_GAZEBO_VISIBLE TouchPlugin
       : public System,
         public ISystemConfigure,
+        public ISystemConfigureParallel,
         public ISystemPreUpdate,
         public ISystemPostUpdate
   {
@@ -75,6 +76,9 @@ namespace systems
                            EntityComponentManager &_ecm,
                            EventManager &_eventMgr) override;
 
+    // Documentation inherited
+    public: bool ConfigureParallel() const override;
+
     /// Documentation inherited
     public: void PreUpdate(const UpdateInfo &_info,
                            EntityComponentManager &_ecm) final;
@@ -20,8 +20,14 @@
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <ignition/common/Profiler.hh>
 #include <ignition/common/Util.hh>
@@ -82,6 +88,9 @@ class systems::InputMatcher
   /// \brief State of the matcher
   protected: bool valid{false};
 
+  /// \brief Tolerance for float comparisons
+  protected: double tol{1e-8};
+
   /// \brief Field comparator used by MessageDifferencer. This is where
   /// tolerance for float comparisons is set
   protected: google::protobuf::util::DefaultFieldComparator comparator;
@@ -166,6 +175,12 @@ class FieldMatcher : public InputMatcher
                      &_fieldDesc,
                  transport::ProtoMsg **_subMsg);
 
+  /// \brief Compare a singular scalar field of the input directly against
+  /// the value extracted from the matcher at construction.
+  /// \param[in] _msg Submessage of the input that contains the field
+  /// \return True if the field of the input equals the expected value.
+  protected: bool MatchScalar(const transport::ProtoMsg &_msg) const;
+
   /// \brief Logic type of this matcher
   protected: const bool logicType;
 
@@ -175,8 +190,141 @@ class FieldMatcher : public InputMatcher
   /// \brief Field descriptor of the field compared by this matcher
   protected: std::vector<const google::protobuf::FieldDescriptor *>
                  fieldDescMatcher;
+
+  /// \brief True if the compared field is a singular scalar, which is
+  /// matched with MatchScalar instead of the MessageDifferencer.
+  protected: bool scalar{false};
+
+  /// \brief Expected value of floating point fields
+  protected: double expectedDouble{0.0};
+
+  /// \brief Expected value of signed integer, bool and enum fields
+  protected: int64_t expectedInt{0};
+
+  /// \brief Expected value of unsigned integer fields
+  protected: uint64_t expectedUint{0};
+
+  /// \brief Expected value of string and bytes fields
+  protected: std::string expectedString;
+};
+
+//////////////////////////////////////////////////
+/// \brief Subscriptions to input topics shared by all the TriggeredPublisher
+/// instances in the process. Each topic is subscribed to only once and every
+/// received message is parsed once, then handed to all the triggers
+/// listening on that topic.
+class InputTopics
+{
+  /// \brief Callback of a trigger
+  public: using Callback = std::function<void(const transport::ProtoMsg &)>;
+
+  /// \brief Add a trigger to an input topic, subscribing to the topic if
+  /// this is its first trigger.
+  /// \param[in] _topic Input topic
+  /// \param[in] _owner Trigger that owns the callback
+  /// \param[in] _cb Callback called with every message on the topic
+  /// \return True if the topic is subscribed.
+  public: static bool Add(const std::string &_topic, const void *_owner,
+                          const Callback &_cb);
+
+  /// \brief Remove a trigger from an input topic. The topic is unsubscribed
+  /// once it has no triggers left. When this returns, the callback of the
+  /// trigger is not running and won't be called again.
+  /// \param[in] _topic Input topic
+  /// \param[in] _owner Trigger that owns the callback
+  public: static void Remove(const std::string &_topic, const void *_owner);
+
+  /// \brief Subscription to a single input topic
+  private: struct Topic
+  {
+    /// \brief Protects callbacks
+    std::mutex mutex;
+
+    /// \brief Callbacks of the triggers on this topic, with their owners
+    std::vector<std::pair<const void *, Callback>> callbacks;
+
+    /// \brief Node that holds the subscription
+    transport::Node node;
+  };
+
+  /// \brief Protects topics
+  private: static std::mutex mutex;
+
+  /// \brief Subscribed topics
+  private: static std::unordered_map<std::string, std::shared_ptr<Topic>>
+               topics;
 };
 
+std::mutex InputTopics::mutex;
+std::unordered_map<std::string, std::shared_ptr<InputTopics::Topic>>
+    InputTopics::topics;
+
+//////////////////////////////////////////////////
+bool InputTopics::Add(const std::string &_topic, const void *_owner,
+                      const Callback &_cb)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &topic = topics[_topic];
+  if (nullptr != topic)
+  {
+    std::lock_guard<std::mutex> topicLock(topic->mutex);
+    topic->callbacks.emplace_back(_owner, _cb);
+    return true;
+  }
+
+  topic = std::make_shared<Topic>();
+  topic->callbacks.emplace_back(_owner, _cb);
+
+  // The subscription only holds a weak reference, so that the topic is
+  // released once its last trigger is removed.
+  std::weak_ptr<Topic> weakTopic = topic;
+  auto msgCb = std::function<void(const transport::ProtoMsg &)>(
+      [weakTopic](const auto &_msg)
+      {
+        auto subscribed = weakTopic.lock();
+        if (nullptr == subscribed)
+          return;
+
+        std::lock_guard<std::mutex> topicLock(subscribed->mutex);
+        for (const auto &cb : subscribed->callbacks)
+          cb.second(_msg);
+      });
+  if (!topic->node.Subscribe(_topic, msgCb))
+  {
+    topics.erase(_topic);
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void InputTopics::Remove(const std::string &_topic, const void *_owner)
+{
+  std::shared_ptr<Topic> released;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = topics.find(_topic);
+    if (it == topics.end())
+      return;
+
+    std::lock_guard<std::mutex> topicLock(it->second->mutex);
+    auto &callbacks = it->second->callbacks;
+    callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(),
+        [&](const auto &_cb)
+        {
+          return _cb.first == _owner;
+        }), callbacks.end());
+
+    if (callbacks.empty())
+    {
+      released = std::move(it->second);
+      topics.erase(it);
+    }
+  }
+  // The node unsubscribes when the last reference to the topic goes away,
+  // outside of the locks.
+}
+
 //////////////////////////////////////////////////
 InputMatcher::InputMatcher(const std::string &_msgType)
     : matchMsg(msgs::Factory::New(_msgType))
@@ -199,6 +347,7 @@ bool InputMatcher::Match(const transport::ProtoMsg &_input) const
 
 void InputMatcher::SetTolerance(double _tol)
 {
+  this->tol = _tol;
   this->comparator.SetDefaultFractionAndMargin(
       std::numeric_limits<double>::min(), _tol);
 }
@@ -291,6 +440,46 @@ FieldMatcher::FieldMatcher(const std::string &_msgType, bool _logicType,
     return;
   }
 
+  // Singular scalar fields are compared directly, so extract the expected
+  // value once here
+  const auto *fieldDesc = this->fieldDescMatcher.back();
+  const auto *refl = matcherSubMsg->GetReflection();
+  using FieldDescriptor = google::protobuf::FieldDescriptor;
+  this->scalar = !fieldDesc->is_repeated();
+  switch (fieldDesc->cpp_type())
+  {
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      this->expectedDouble = refl->GetDouble(*matcherSubMsg, fieldDesc);
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      this->expectedDouble = refl->GetFloat(*matcherSubMsg, fieldDesc);
+      break;
+    case FieldDescriptor::CPPTYPE_INT32:
+      this->expectedInt = refl->GetInt32(*matcherSubMsg, fieldDesc);
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      this->expectedInt = refl->GetInt64(*matcherSubMsg, fieldDesc);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      this->expectedUint = refl->GetUInt32(*matcherSubMsg, fieldDesc);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      this->expectedUint = refl->GetUInt64(*matcherSubMsg, fieldDesc);
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      this->expectedInt = refl->GetBool(*matcherSubMsg, fieldDesc);
+      break;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      this->expectedInt = refl->GetEnumValue(*matcherSubMsg, fieldDesc);
+      break;
+    case FieldDescriptor::CPPTYPE_STRING:
+      this->expectedString = refl->GetString(*matcherSubMsg, fieldDesc);
+      break;
+    default:
+      this->scalar = false;
+      break;
+  }
+
   this->valid = true;
 }
 
@@ -370,11 +559,59 @@ bool FieldMatcher::FindFieldSubMessage(
   return true;
 }
 
+//////////////////////////////////////////////////
+bool FieldMatcher::MatchScalar(const transport::ProtoMsg &_msg) const
+{
+  using FieldDescriptor = google::protobuf::FieldDescriptor;
+  const auto *fieldDesc = this->fieldDescMatcher.back();
+  const auto *refl = _msg.GetReflection();
+
+  // Same criteria as the approximate comparison of the MessageDifferencer
+  auto almostEqual = [this](double _value)
+  {
+    return _value == this->expectedDouble ||
+           std::abs(_value - this->expectedDouble) <= this->tol;
+  };
+
+  switch (fieldDesc->cpp_type())
+  {
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return almostEqual(refl->GetDouble(_msg, fieldDesc));
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return almostEqual(refl->GetFloat(_msg, fieldDesc));
+    case FieldDescriptor::CPPTYPE_INT32:
+      return refl->GetInt32(_msg, fieldDesc) == this->expectedInt;
+    case FieldDescriptor::CPPTYPE_INT64:
+      return refl->GetInt64(_msg, fieldDesc) == this->expectedInt;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return refl->GetUInt32(_msg, fieldDesc) == this->expectedUint;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return refl->GetUInt64(_msg, fieldDesc) == this->expectedUint;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return refl->GetBool(_msg, fieldDesc) == (this->expectedInt != 0);
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return refl->GetEnumValue(_msg, fieldDesc) == this->expectedInt;
+    case FieldDescriptor::CPPTYPE_STRING:
+      return refl->GetString(_msg, fieldDesc) == this->expectedString;
+    default:
+      return false;
+  }
+}
+
 //////////////////////////////////////////////////
 bool FieldMatcher::DoMatch(
     const transport::ProtoMsg &_input) const
 {
-  google::protobuf::util::DefaultFieldComparator comp;
+  if (this->scalar)
+  {
+    const transport::ProtoMsg *subMsgInput = &_input;
+    for (std::size_t i = 0; i < this->fieldDescMatcher.size() - 1; ++i)
+    {
+      subMsgInput = &subMsgInput->GetReflection()->GetMessage(
+          *subMsgInput, this->fieldDescMatcher[i]);
+    }
+    return this->logicType == this->MatchScalar(*subMsgInput);
+  }
 
   auto *matcherRefl = this->matchMsg->GetReflection();
   auto *inputRefl = _input.GetReflection();
@@ -461,6 +698,7 @@ std::unique_ptr<InputMatcher> InputMatcher::Create(
 //////////////////////////////////////////////////
 TriggeredPublisher::~TriggeredPublisher()
 {
+  InputTopics::Remove(this->inputTopic, this);
   this->done = true;
   this->newMatchSignal.notify_one();
   if (this->workerThread.joinable())
@@ -589,7 +827,7 @@ void TriggeredPublisher::Configure(const Entity &,
           this->newMatchSignal.notify_one();
         }
       });
-  if (!this->node.Subscribe(this->inputTopic, msgCb))
+  if (!InputTopics::Add(this->inputTopic, this, msgCb))
   {
     ignerr << "Input subscriber could not be created for topic ["
            << this->inputTopic << "] with message type [" << this->inputMsgType
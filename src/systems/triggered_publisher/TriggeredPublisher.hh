@@ -149,6 +149,13 @@ namespace systems
   /// </plugin>
   /// \endcode
   ///
+  /// ### Performance
+  /// Field matchers on singular scalar fields are compiled once at
+  /// configuration into a typed comparison of the field, with `tol` applied
+  /// to floating point fields. All the triggered publishers in a process that
+  /// listen on the same input topic share a single subscription, so each
+  /// input message is received and parsed only once.
+  ///
   /// ### Limitations
   /// The current implementation of this system does not support specifying a
   /// subfield of a repeated field in the "field" attribute. i.e, if
@@ -22,9 +22,13 @@
 #include <ignition/msgs/entity_factory.pb.h>
 #include <ignition/msgs/light.pb.h>
 #include <ignition/msgs/pose.pb.h>
+#include <ignition/msgs/pose_v.pb.h>
 #include <ignition/msgs/physics.pb.h>
 
+#include <map>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -78,8 +82,32 @@ class UserCommandsInterface
 
   /// \brief World entity.
   public: Entity worldEntity{kNullEntity};
+
+  /// \brief Check whether a child of the world has the given name. The
+  /// names are gathered on the first call and then kept up to date by the
+  /// create commands, so that spawning many entities in one iteration doesn't
+  /// search all entities for each of them. Call ClearTopLevelNames after
+  /// executing commands.
+  /// \param[in] _name Name to look for.
+  /// \return True if a child of the world has this name.
+  public: bool HasTopLevelName(const std::string &_name);
+
+  /// \brief Forget the names gathered by HasTopLevelName.
+  public: void ClearTopLevelNames();
+
+  /// \brief Names of the world's children, see HasTopLevelName.
+  public: std::unordered_set<std::string> topLevelNames;
+
+  /// \brief Whether topLevelNames has been gathered.
+  public: bool topLevelNamesValid{false};
 };
 
+/// \brief SDF roots parsed while handling a create request, keyed by the
+/// message's `from` case and its SDF string or file name, so that identical
+/// descriptions are only parsed once. Null if parsing failed.
+using SdfRootCache = std::map<std::pair<int, std::string>,
+    std::shared_ptr<const sdf::Root>>;
+
 /// \brief All user commands should inherit from this class so they can be
 /// undone / redone.
 class UserCommandBase
@@ -111,11 +139,27 @@ class CreateCommand : public UserCommandBase
   /// \brief Constructor
   /// \param[in] _msg Factory message.
   /// \param[in] _iface Pointer to user commands interface.
+  /// \param[in] _root SDF parsed from the message by Parse, null if the
+  /// message doesn't hold SDF.
   public: CreateCommand(msgs::EntityFactory *_msg,
-      std::shared_ptr<UserCommandsInterface> &_iface);
+      std::shared_ptr<UserCommandsInterface> &_iface,
+      std::shared_ptr<const sdf::Root> _root = nullptr);
+
+  /// \brief Parse the SDF string or file of a factory message. This is
+  /// called from the service callbacks, so that parsing doesn't stall the
+  /// simulation thread.
+  /// \param[in] _msg Factory message.
+  /// \param[in,out] _cache Roots already parsed for the same request.
+  /// \param[out] _root Parsed SDF, null if the message doesn't hold SDF.
+  /// \return False if the SDF failed to parse.
+  public: static bool Parse(const msgs::EntityFactory &_msg,
+      SdfRootCache &_cache, std::shared_ptr<const sdf::Root> &_root);
 
   // Documentation inherited
   public: bool Execute() final;
+
+  /// \brief SDF parsed from the message.
+  private: std::shared_ptr<const sdf::Root> root;
 };
 
 /// \brief Command to remove an entity from simulation.
@@ -207,6 +251,10 @@ class PoseCommand : public UserCommandBase
   // Documentation inherited
   public: bool Execute() final;
 
+  /// \brief Identify the entity moved by the command, before it's resolved.
+  /// \return The entity ID if set, otherwise its name prefixed with "@".
+  public: std::string Target() const;
+
   /// \brief Pose3d equality comparison function.
   public: std::function<bool(const math::Pose3d &, const math::Pose3d &)>
           pose3Eql { [](const math::Pose3d &_a, const math::Pose3d &_b)
@@ -277,6 +325,11 @@ class ignition::gazebo::systems::UserCommandsPrivate
   /// \return True if successful.
   public: bool PoseService(const msgs::Pose &_req, msgs::Boolean &_res);
 
+  /// \brief Callback for the pose edit topic, which queues poses like the
+  /// pose service, without a response.
+  /// \param[in] _msg Poses of one or more entities.
+  public: void OnPoseEdit(const msgs::Pose_V &_msg);
+
   /// \brief Callback for physics service
   /// \param[in] _req Request containing updates to the physics parameters.
   /// \param[in] _res True if message successfully received and queued.
@@ -358,6 +411,13 @@ void UserCommands::Configure(const Entity &_entity,
 
   ignmsg << "Pose service on [" << poseService << "]" << std::endl;
 
+  // Pose edit topic
+  std::string poseEditTopic{"/world/" + validWorldName + "/pose_edit"};
+  this->dataPtr->node.Subscribe(poseEditTopic,
+      &UserCommandsPrivate::OnPoseEdit, this->dataPtr.get());
+
+  ignmsg << "Pose edit topic on [" << poseEditTopic << "]" << std::endl;
+
   // Light service
   std::string lightService{"/world/" + validWorldName + "/light_config"};
   this->dataPtr->node.Advertise(lightService,
@@ -392,9 +452,46 @@ void UserCommands::PreUpdate(const UpdateInfo &/*_info*/,
 
   // TODO(louise) Record current world state for undo
 
+  // Only the latest pose of each entity is applied, unless other commands
+  // come in between, since they may create, remove or rename entities
+  std::unordered_map<std::string, std::size_t> latestPose;
+  for (std::size_t i = 0; i < cmds.size(); ++i)
+  {
+    auto poseCmd = dynamic_cast<PoseCommand *>(cmds[i].get());
+    if (nullptr == poseCmd)
+    {
+      latestPose.clear();
+      continue;
+    }
+
+    auto it = latestPose.find(poseCmd->Target());
+    if (it != latestPose.end())
+    {
+      cmds[it->second].reset();
+      it->second = i;
+    }
+    else
+    {
+      latestPose[poseCmd->Target()] = i;
+    }
+  }
+
   // Execute pending commands
+  bool batching{false};
   for (auto &cmd : cmds)
   {
+    if (nullptr == cmd)
+      continue;
+
+    // Consecutive create commands are executed in a single batch, so views
+    // are updated and plugins are loaded once for all of their entities
+    const bool isCreate = nullptr != dynamic_cast<CreateCommand *>(cmd.get());
+    if (isCreate && !batching)
+      this->dataPtr->iface->creator->BeginBatch();
+    else if (!isCreate && batching)
+      this->dataPtr->iface->creator->CommitBatch();
+    batching = isCreate;
+
     // Execute
     if (!cmd->Execute())
       continue;
@@ -404,6 +501,10 @@ void UserCommands::PreUpdate(const UpdateInfo &/*_info*/,
     // TODO(louise) Move to undo list
   }
 
+  if (batching)
+    this->dataPtr->iface->creator->CommitBatch();
+  this->dataPtr->iface->ClearTopLevelNames();
+
   // TODO(louise) Clear redo list
 }
 
@@ -411,15 +512,28 @@ void UserCommands::PreUpdate(const UpdateInfo &/*_info*/,
 bool UserCommandsPrivate::CreateServiceMultiple(
     const msgs::EntityFactory_V &_req, msgs::Boolean &_res)
 {
-  std::lock_guard<std::mutex> lock(this->pendingMutex);
+  // Parse before taking the lock, identical descriptions only once
+  SdfRootCache cache;
+  std::vector<std::unique_ptr<UserCommandBase>> cmds;
+  cmds.reserve(_req.data_size());
   for (int i = 0; i < _req.data_size(); ++i)
   {
     const msgs::EntityFactory &msg = _req.data(i);
+    std::shared_ptr<const sdf::Root> root;
+    if (!CreateCommand::Parse(msg, cache, root))
+      continue;
+
     // Create command and push it to queue
     auto msgCopy = msg.New();
     msgCopy->CopyFrom(msg);
-    auto cmd = std::make_unique<CreateCommand>(msgCopy, this->iface);
-    this->pendingCmds.push_back(std::move(cmd));
+    cmds.push_back(
+        std::make_unique<CreateCommand>(msgCopy, this->iface, root));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->pendingMutex);
+    for (auto &cmd : cmds)
+      this->pendingCmds.push_back(std::move(cmd));
   }
 
   _res.set_data(true);
@@ -430,10 +544,19 @@ bool UserCommandsPrivate::CreateServiceMultiple(
 bool UserCommandsPrivate::CreateService(const msgs::EntityFactory &_req,
     msgs::Boolean &_res)
 {
+  SdfRootCache cache;
+  std::shared_ptr<const sdf::Root> root;
+  // The request was received even if its SDF is invalid, errors are printed
+  if (!CreateCommand::Parse(_req, cache, root))
+  {
+    _res.set_data(true);
+    return true;
+  }
+
   // Create command and push it to queue
   auto msg = _req.New();
   msg->CopyFrom(_req);
-  auto cmd = std::make_unique<CreateCommand>(msg, this->iface);
+  auto cmd = std::make_unique<CreateCommand>(msg, this->iface, root);
 
   // Push to pending
   {
@@ -502,6 +625,22 @@ bool UserCommandsPrivate::PoseService(const msgs::Pose &_req,
   return true;
 }
 
+//////////////////////////////////////////////////
+void UserCommandsPrivate::OnPoseEdit(const msgs::Pose_V &_msg)
+{
+  std::vector<std::unique_ptr<UserCommandBase>> cmds;
+  for (const auto &pose : _msg.pose())
+  {
+    auto msg = pose.New();
+    msg->CopyFrom(pose);
+    cmds.push_back(std::make_unique<PoseCommand>(msg, this->iface));
+  }
+
+  std::lock_guard<std::mutex> lock(this->pendingMutex);
+  for (auto &cmd : cmds)
+    this->pendingCmds.push_back(std::move(cmd));
+}
+
 //////////////////////////////////////////////////
 bool UserCommandsPrivate::PhysicsService(const msgs::Physics &_req,
     msgs::Boolean &_res)
@@ -535,13 +674,81 @@ UserCommandBase::~UserCommandBase()
   this->msg = nullptr;
 }
 
+//////////////////////////////////////////////////
+bool UserCommandsInterface::HasTopLevelName(const std::string &_name)
+{
+  if (!this->topLevelNamesValid)
+  {
+    this->ecm->Each<components::Name, components::ParentEntity>(
+        [&](const Entity &, const components::Name *_nameComp,
+            const components::ParentEntity *_parentComp) -> bool
+        {
+          if (_parentComp->Data() == this->worldEntity)
+            this->topLevelNames.insert(_nameComp->Data());
+          return true;
+        });
+    this->topLevelNamesValid = true;
+  }
+
+  return this->topLevelNames.find(_name) != this->topLevelNames.end();
+}
+
+//////////////////////////////////////////////////
+void UserCommandsInterface::ClearTopLevelNames()
+{
+  this->topLevelNames.clear();
+  this->topLevelNamesValid = false;
+}
+
 //////////////////////////////////////////////////
 CreateCommand::CreateCommand(msgs::EntityFactory *_msg,
-    std::shared_ptr<UserCommandsInterface> &_iface)
-    : UserCommandBase(_msg, _iface)
+    std::shared_ptr<UserCommandsInterface> &_iface,
+    std::shared_ptr<const sdf::Root> _root)
+    : UserCommandBase(_msg, _iface), root(std::move(_root))
 {
 }
 
+//////////////////////////////////////////////////
+bool CreateCommand::Parse(const msgs::EntityFactory &_msg,
+    SdfRootCache &_cache, std::shared_ptr<const sdf::Root> &_root)
+{
+  IGN_PROFILE("CreateCommand::Parse");
+
+  std::string key;
+  if (_msg.from_case() == msgs::EntityFactory::kSdf)
+    key = _msg.sdf();
+  else if (_msg.from_case() == msgs::EntityFactory::kSdfFilename)
+    key = _msg.sdf_filename();
+  else
+    return true;
+
+  auto cacheKey = std::make_pair(static_cast<int>(_msg.from_case()), key);
+  auto it = _cache.find(cacheKey);
+  if (it != _cache.end())
+  {
+    _root = it->second;
+    return nullptr != _root;
+  }
+
+  auto root = std::make_shared<sdf::Root>();
+  sdf::Errors errors;
+  if (_msg.from_case() == msgs::EntityFactory::kSdf)
+    errors = root->LoadSdfString(key);
+  else
+    errors = root->Load(key);
+
+  if (!errors.empty())
+  {
+    for (auto &err : errors)
+      ignerr << err << std::endl;
+    root.reset();
+  }
+
+  _root = root;
+  _cache[cacheKey] = _root;
+  return nullptr != _root;
+}
+
 //////////////////////////////////////////////////
 bool CreateCommand::Execute()
 {
@@ -552,20 +759,22 @@ bool CreateCommand::Execute()
     return false;
   }
 
-  // Load SDF
-  sdf::Root root;
+  // SDF is parsed when the command is received
+  static const sdf::Root kEmptyRoot;
+  const sdf::Root &root = this->root ? *this->root : kEmptyRoot;
   sdf::Light lightSdf;
-  sdf::Errors errors;
+  Entity cloneEntity{kNullEntity};
   switch (createMsg->from_case())
   {
     case msgs::EntityFactory::kSdf:
-    {
-      errors = root.LoadSdfString(createMsg->sdf());
-      break;
-    }
     case msgs::EntityFactory::kSdfFilename:
     {
-      errors = root.Load(createMsg->sdf_filename());
+      if (!this->root)
+      {
+        ignerr << "Internal error, create message SDF wasn't parsed"
+               << std::endl;
+        return false;
+      }
       break;
     }
     case msgs::EntityFactory::kModel:
@@ -581,9 +790,16 @@ bool CreateCommand::Execute()
     }
     case msgs::EntityFactory::kCloneName:
     {
-      // TODO(louise) Implement clone
-      ignerr << "Cloning an entity is not yet supported." << std::endl;
-      return false;
+      cloneEntity = this->iface->ecm->EntityByComponents(
+          components::Name(createMsg->clone_name()),
+          components::ParentEntity(this->iface->worldEntity));
+      if (kNullEntity == cloneEntity)
+      {
+        ignerr << "Entity named [" << createMsg->clone_name()
+               << "] not found, so it can't be cloned." << std::endl;
+        return false;
+      }
+      break;
     }
     default:
     {
@@ -592,18 +808,15 @@ bool CreateCommand::Execute()
     }
   }
 
-  if (!errors.empty())
-  {
-    for (auto &err : errors)
-      ignerr << err << std::endl;
-    return false;
-  }
-
   bool isModel{false};
   bool isLight{false};
   bool isActor{false};
   bool isRoot{false};
-  if (root.ModelCount() > 0)
+  if (kNullEntity != cloneEntity)
+  {
+    // Cloned from an existing entity
+  }
+  else if (root.ModelCount() > 0)
   {
     isRoot = true;
     isModel = true;
@@ -641,6 +854,10 @@ bool CreateCommand::Execute()
   {
     desiredName = createMsg->name();
   }
+  else if (kNullEntity != cloneEntity)
+  {
+    desiredName = createMsg->clone_name();
+  }
   else if (isModel)
   {
     desiredName = root.ModelByIndex(0)->Name();
@@ -659,9 +876,7 @@ bool CreateCommand::Execute()
   }
 
   // Check if there's already a top-level entity with the given name
-  if (kNullEntity != this->iface->ecm->EntityByComponents(
-      components::Name(desiredName),
-      components::ParentEntity(this->iface->worldEntity)))
+  if (this->iface->HasTopLevelName(desiredName))
   {
     if (!createMsg->allow_renaming())
     {
@@ -674,9 +889,7 @@ bool CreateCommand::Execute()
     // Generate unique name
     std::string newName = desiredName;
     int i = 0;
-    while (kNullEntity != this->iface->ecm->EntityByComponents(
-      components::Name(newName),
-      components::ParentEntity(this->iface->worldEntity)))
+    while (this->iface->HasTopLevelName(newName))
     {
       newName = desiredName + "_" + std::to_string(i++);
     }
@@ -685,7 +898,12 @@ bool CreateCommand::Execute()
 
   // Create entities
   Entity entity{kNullEntity};
-  if (isModel)
+  if (kNullEntity != cloneEntity)
+  {
+    entity = this->iface->ecm->Clone(cloneEntity, this->iface->worldEntity,
+        desiredName);
+  }
+  else if (isModel)
   {
     auto model = *root.ModelByIndex(0);
     model.SetName(desiredName);
@@ -693,9 +911,9 @@ bool CreateCommand::Execute()
   }
   else if (isLight && isRoot)
   {
-    auto light = root.LightByIndex(0);
-    light->SetName(desiredName);
-    entity = this->iface->creator->CreateEntities(light);
+    auto light = *root.LightByIndex(0);
+    light.SetName(desiredName);
+    entity = this->iface->creator->CreateEntities(&light);
   }
   else if (isLight)
   {
@@ -709,7 +927,9 @@ bool CreateCommand::Execute()
     entity = this->iface->creator->CreateEntities(&actor);
   }
 
-  this->iface->creator->SetParent(entity, this->iface->worldEntity);
+  if (kNullEntity == cloneEntity)
+    this->iface->creator->SetParent(entity, this->iface->worldEntity);
+  this->iface->topLevelNames.insert(desiredName);
 
   // Pose
   if (createMsg->has_pose())
@@ -902,6 +1122,18 @@ PoseCommand::PoseCommand(msgs::Pose *_msg,
 {
 }
 
+//////////////////////////////////////////////////
+std::string PoseCommand::Target() const
+{
+  auto poseMsg = dynamic_cast<const msgs::Pose *>(this->msg);
+  if (nullptr == poseMsg)
+    return {};
+
+  if (poseMsg->id() != kNullEntity && poseMsg->id() != 0)
+    return std::to_string(poseMsg->id());
+  return "@" + poseMsg->name();
+}
+
 //////////////////////////////////////////////////
 bool PoseCommand::Execute()
 {
@@ -45,6 +45,13 @@ namespace systems
   /// * **Request type*: ignition.msgs.EntityFactory
   /// * **Response type*: ignition.msgs.Boolean
   ///
+  /// Entities can be created from SDF, a light message, or by cloning an
+  /// existing top-level entity named by `clone_name`. Clones copy all the
+  /// components of the original, so they are much cheaper to create than
+  /// parsing the same SDF again, but the original's plugins aren't loaded for
+  /// them. Clones are named after the original unless `name` is set, so
+  /// `allow_renaming` must be true otherwise.
+  ///
   /// # Spawn multiple entities
   ///
   /// This service can spawn multiple entities in the same iteration,
@@ -54,6 +61,26 @@ namespace systems
   /// * **Request type*: ignition.msgs.EntityFactory_V
   /// * **Response type*: ignition.msgs.Boolean
   ///
+  /// SDF is parsed when the request is received, off the simulation thread,
+  /// and identical SDF strings or files in a request are only parsed once.
+  /// Entities created in the same iteration are created as one batch, so the
+  /// entity component manager's views are updated and plugins are loaded
+  /// once for all of them.
+  ///
+  /// # Set entity poses
+  ///
+  /// * **Service**: `/world/<world name>/set_pose`
+  /// * **Request type*: ignition.msgs.Pose
+  /// * **Response type*: ignition.msgs.Boolean
+  ///
+  /// * **Topic**: `/world/<world name>/pose_edit`
+  /// * **Message type*: ignition.msgs.Pose_V
+  ///
+  /// The topic is meant for interactive edits, such as dragging entities,
+  /// which would otherwise cost a service round trip per update. When
+  /// several poses of the same entity are received within an iteration,
+  /// only the latest one is applied.
+  ///
   /// Try some examples described on examples/worlds/empty.sdf
   class IGNITION_GAZEBO_VISIBLE UserCommands:
     public System,
@@ -73,7 +100,8 @@ namespace systems
                            EventManager &_eventMgr) override;
 
     /// \brief All received commands are queued in order of reception and
-    /// executed in order during PreUpdate.
+    /// executed in order during PreUpdate. Consecutive pose commands for the
+    /// same entity are coalesced into the latest one.
     /// \param[in] _info Contains information about the current simulation
     /// iteration.
     /// \param[in] _ecm The entity component manager.
@@ -21,11 +21,13 @@
 
 #include <ignition/common/Profiler.hh>
 #include <ignition/math/Vector3.hh>
+#include <ignition/msgs/Utility.hh>
 #include <ignition/plugin/Register.hh>
 #include <ignition/transport/Node.hh>
 
 #include "ignition/gazebo/components/AngularVelocityCmd.hh"
 #include "ignition/gazebo/components/LinearVelocityCmd.hh"
+#include "ignition/gazebo/components/TwistCmd.hh"
 #include "ignition/gazebo/Model.hh"
 #include "ignition/gazebo/Util.hh"
 
@@ -121,6 +123,17 @@ void VelocityControl::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
   if (_info.paused)
     return;
 
+  // Unlike transport commands, which are picked up on the next step, the
+  // TwistCmd is applied within the same step
+  auto twistCmd =
+    _ecm.Component<components::TwistCmd>(this->dataPtr->model.Entity());
+  if (twistCmd)
+  {
+    this->dataPtr->linearVelocity = msgs::Convert(twistCmd->Data().linear());
+    this->dataPtr->angularVelocity =
+      msgs::Convert(twistCmd->Data().angular());
+  }
+
   // update angular velocity of model
   auto angularVel =
     _ecm.Component<components::AngularVelocityCmd>(
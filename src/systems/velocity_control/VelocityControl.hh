@@ -34,6 +34,10 @@ namespace systems
 
   /// \brief Linear and angular velocity controller
   /// which is directly set on a model.
+  ///
+  /// Commands are received by default on `/model/{name_of_model}/cmd_vel`, or
+  /// read from a TwistCmd component on the model, see components::TwistCmd.
+  /// Commands from the component are applied within the same step.
   class IGNITION_GAZEBO_VISIBLE VelocityControl
       : public System,
         public ISystemConfigure,
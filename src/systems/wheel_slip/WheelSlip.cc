@@ -17,7 +17,7 @@
 
 #include "WheelSlip.hh"
 
-#include <map>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -69,6 +69,9 @@ class ignition::gazebo::systems::WheelSlipPrivate
 
   public: class LinkSurfaceParams
     {
+      /// \brief Wheel link entity.
+      public: Entity link;
+
       /// \brief Pointer to wheel spin joint.
       public: Entity joint;
 
@@ -96,8 +99,14 @@ class ignition::gazebo::systems::WheelSlipPrivate
       public: double wheelRadius = 0;
     };
 
-  /// \brief The map relating links to their respective surface parameters.
-  public: std::map<Entity, LinkSurfaceParams> mapLinkSurfaceParams;
+  /// \brief Surface parameters of each wheel link, kept contiguous so the
+  /// slip of all wheels is computed in a single pass.
+  public: std::vector<LinkSurfaceParams> linkSurfaceParams;
+
+  /// \brief Slip compliance computed for each wheel on the last update,
+  /// with the same indices as linkSurfaceParams. Wheels whose velocity isn't
+  /// available are left empty.
+  public: std::vector<std::vector<double>> slipCmds;
 
   /// \brief Vector2d equality comparison function.
   public: std::function<bool(const std::vector<double> &,
@@ -226,10 +235,21 @@ bool WheelSlipPrivate::Load(const EntityComponentManager &_ecm,
       continue;
     }
 
-    this->mapLinkSurfaceParams[link.Entity()] = params;
+    params.link = link.Entity();
+
+    auto existing = std::find_if(this->linkSurfaceParams.begin(),
+        this->linkSurfaceParams.end(),
+        [&](const LinkSurfaceParams &_params)
+        {
+          return _params.link == params.link;
+        });
+    if (existing != this->linkSurfaceParams.end())
+      *existing = params;
+    else
+      this->linkSurfaceParams.push_back(params);
   }
 
-  if (this->mapLinkSurfaceParams.empty())
+  if (this->linkSurfaceParams.empty())
   {
     ignerr << "No links and surfaces found, plugin is disabled"
            << std::endl;
@@ -242,22 +262,24 @@ bool WheelSlipPrivate::Load(const EntityComponentManager &_ecm,
 /////////////////////////////////////////////////
 void WheelSlipPrivate::Update(EntityComponentManager &_ecm)
 {
-  for (const auto &linkSurface : this->mapLinkSurfaceParams)
+  // Compute the slip of all wheels first, then write the commands
+  this->slipCmds.resize(this->linkSurfaceParams.size());
+  for (std::size_t i = 0; i < this->linkSurfaceParams.size(); ++i)
   {
-    const auto &params = linkSurface.second;
-
-    // get user-defined normal force constant
-    double force = params.wheelNormalForce;
-
-    auto joint = params.joint;
+    const auto &params = this->linkSurfaceParams[i];
+    auto &slipCmd = this->slipCmds[i];
+    slipCmd.clear();
 
     auto spinAngularVelocityComp =
-        _ecm.Component<components::JointVelocity>(joint);
+        _ecm.Component<components::JointVelocity>(params.joint);
 
     if (!spinAngularVelocityComp || spinAngularVelocityComp->Data().empty())
       continue;
     double spinAngularVelocity = spinAngularVelocityComp->Data()[0];
 
+    // get user-defined normal force constant
+    double force = params.wheelNormalForce;
+
     // As discussed in WheelSlip.hh, the slip1 and slip2
     // parameters have units of inverse viscous damping:
     // [linear velocity / force] or [m / s / N].
@@ -276,25 +298,37 @@ void WheelSlipPrivate::Update(EntityComponentManager &_ecm)
     // and when the vehicle is at rest than the braking form,
     // so it is used for both slip directions.
     double speed = params.wheelRadius * std::abs(spinAngularVelocity);
-    double slip1 = speed / force * params.slipComplianceLateral;
-    double slip2 = speed / force * params.slipComplianceLongitudinal;
+    slipCmd = {speed / force * params.slipComplianceLateral,
+               speed / force * params.slipComplianceLongitudinal};
+  }
 
-    components::SlipComplianceCmd newSlipCmdComp({slip1, slip2});
+  for (std::size_t i = 0; i < this->linkSurfaceParams.size(); ++i)
+  {
+    const auto &slipCmd = this->slipCmds[i];
+    if (slipCmd.empty())
+      continue;
 
+    const auto &collision = this->linkSurfaceParams[i].collision;
     auto currSlipCmdComp =
-        _ecm.Component<components::SlipComplianceCmd>(params.collision);
+        _ecm.Component<components::SlipComplianceCmd>(collision);
     if (currSlipCmdComp)
     {
-      *currSlipCmdComp = newSlipCmdComp;
-      _ecm.SetChanged(params.collision, components::SlipComplianceCmd::typeId,
-                      ComponentState::PeriodicChange);
+      // Only slips which moved beyond the tolerance are written and marked
+      // as changed, so physics skips wheels at rest or at constant speed
+      if (currSlipCmdComp->SetData(slipCmd, this->vecEql))
+      {
+        _ecm.SetChanged(collision, components::SlipComplianceCmd::typeId,
+                        ComponentState::PeriodicChange);
+      }
     }
     else
     {
-      _ecm.CreateComponent(params.collision, newSlipCmdComp);
+      _ecm.CreateComponent(collision,
+          components::SlipComplianceCmd(slipCmd));
     }
   }
 }
+
 //////////////////////////////////////////////////
 WheelSlip::WheelSlip()
   : dataPtr(std::make_unique<WheelSlipPrivate>())
@@ -332,18 +366,15 @@ void WheelSlip::PreUpdate(const UpdateInfo &_info, EntityComponentManager &_ecm)
   {
     if (this->dataPtr->validConfig)
     {
-      for (const auto &linkSurface : this->dataPtr->mapLinkSurfaceParams)
+      for (const auto &params : this->dataPtr->linkSurfaceParams)
       {
-        if (!_ecm.Component<components::WorldAngularVelocity>(
-                linkSurface.first))
+        if (!_ecm.Component<components::WorldAngularVelocity>(params.link))
         {
-          _ecm.CreateComponent(linkSurface.first, components::JointVelocity());
+          _ecm.CreateComponent(params.link, components::JointVelocity());
         }
-        if (!_ecm.Component<components::JointVelocity>(
-                linkSurface.second.joint))
+        if (!_ecm.Component<components::JointVelocity>(params.joint))
         {
-          _ecm.CreateComponent(linkSurface.second.joint,
-                               components::JointVelocity());
+          _ecm.CreateComponent(params.joint, components::JointVelocity());
         }
       }
     }
@@ -21,6 +21,7 @@
 #include <ignition/msgs/boolean.pb.h>
 #include <ignition/msgs/entity_factory.pb.h>
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,7 @@
 #include <sdf/Error.hh>
 
 #include <ignition/common/Profiler.hh>
+#include <ignition/common/Util.hh>
 #include <ignition/msgs/Utility.hh>
 #include <ignition/plugin/Register.hh>
 #include <ignition/transport/Node.hh>
@@ -48,6 +50,9 @@
 #include "ignition/gazebo/components/WindMode.hh"
 
 #include "ignition/gazebo/Link.hh"
+#include "ignition/gazebo/Util.hh"
+
+#include "WindField.hh"
 
 using namespace ignition;
 using namespace gazebo;
@@ -79,6 +84,13 @@ class ignition::gazebo::systems::WindEffectsPrivate
   public: void ApplyWindForce(const UpdateInfo &_info,
                               EntityComponentManager &_ecm);
 
+  /// \brief Calculate and apply forces on links affected by wind, adding the
+  /// wind field sampled at each link to the uniform wind.
+  /// \param[in] _windVel Uniform wind velocity.
+  /// \param[in] _ecm Mutable reference to the EntityComponentManager.
+  public: void ApplyWindFieldForce(const math::Vector3d &_windVel,
+                                   EntityComponentManager &_ecm);
+
   /// \brief Callback for topic for setting the wind seed velocity and enabling
   /// this system.
   /// \param[in] _msg msgs::Wind message.
@@ -165,6 +177,46 @@ class ignition::gazebo::systems::WindEffectsPrivate
   /// \brief Current wind velocity seed and global enable/disable state.
   /// This is set by a transport message.
   public: msgs::Wind currentWindInfo;
+
+  /// \brief Sim time between updates of the wind velocity. Zero updates it
+  /// every step.
+  public: std::chrono::steady_clock::duration windUpdatePeriod{0};
+
+  /// \brief Sim time of the last wind velocity update.
+  public: std::optional<std::chrono::steady_clock::duration>
+      lastWindUpdateTime;
+
+  /// \brief Optional spatially varying wind, added to the uniform wind.
+  public: wind_effects::WindField windField;
+
+  /// \brief Links affected by wind in the current step, used when sampling
+  /// the wind field. The following vectors hold one value per link, and are
+  /// kept between steps to reuse their storage.
+  public: std::vector<Entity> fieldLinks;
+
+  /// \brief Mass of each link times the force approximation scaling factor.
+  public: std::vector<double> fieldLinkScale;
+
+  /// \brief Force on each link due to the uniform wind.
+  public: std::vector<math::Vector3d> fieldLinkForce;
+
+  /// \brief X world position of each link.
+  public: std::vector<double> fieldPosX;
+
+  /// \brief Y world position of each link.
+  public: std::vector<double> fieldPosY;
+
+  /// \brief Z world position of each link.
+  public: std::vector<double> fieldPosZ;
+
+  /// \brief X field velocity at each link.
+  public: std::vector<double> fieldVelX;
+
+  /// \brief Y field velocity at each link.
+  public: std::vector<double> fieldVelY;
+
+  /// \brief Z field velocity at each link.
+  public: std::vector<double> fieldVelZ;
 };
 
 /////////////////////////////////////////////////
@@ -281,6 +333,45 @@ void WindEffectsPrivate::Load(EntityComponentManager &_ecm,
     }
   }
 
+  if (_sdf->HasElement("update_rate"))
+  {
+    double updateRate = _sdf->Get<double>("update_rate");
+    if (updateRate < 0.0)
+    {
+      ignerr << "Please set <update_rate> to a value greater than or equal "
+             << "to 0" << std::endl;
+      return;
+    }
+    if (updateRate > 0.0)
+    {
+      this->windUpdatePeriod =
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1.0 / updateRate));
+    }
+  }
+
+  if (_sdf->HasElement("field"))
+  {
+    auto sdfField = _sdf->GetElementImpl("field");
+    if (!sdfField->HasElement("uri"))
+    {
+      ignerr << "Please set <field><uri> to the wind field file"
+             << std::endl;
+      return;
+    }
+
+    auto uri = sdfField->Get<std::string>("uri");
+    auto path = common::findFile(asFullPath(uri, _sdf->FilePath()));
+    if (path.empty())
+    {
+      ignerr << "Wind field [" << uri << "] could not be found" << std::endl;
+      return;
+    }
+
+    if (!this->windField.Load(path))
+      return;
+  }
+
   if (_sdf->HasElement("force_approximation_scaling_factor"))
   {
     sdf::ElementPtr sdfForceApprox =
@@ -327,7 +418,26 @@ void WindEffectsPrivate::UpdateWindVelocity(const UpdateInfo &_info,
                                             EntityComponentManager &_ecm)
 {
   IGN_PROFILE("WindEffectsPrivate::UpdateWindVelocity");
-  double period = std::chrono::duration<double>(_info.dt).count();
+  auto dt = _info.dt;
+  if (this->windUpdatePeriod > std::chrono::steady_clock::duration::zero())
+  {
+    // Hold the wind between updates, and filter over the whole time that
+    // passed since the last update. Start over if time jumped back.
+    if (this->lastWindUpdateTime)
+    {
+      dt = _info.simTime - this->lastWindUpdateTime.value();
+      if (dt >= std::chrono::steady_clock::duration::zero() &&
+          dt < this->windUpdatePeriod)
+      {
+        return;
+      }
+      if (dt < std::chrono::steady_clock::duration::zero())
+        dt = _info.dt;
+    }
+    this->lastWindUpdateTime = _info.simTime;
+  }
+
+  double period = std::chrono::duration<double>(dt).count();
   double simTime = std::chrono::duration<double>(_info.simTime).count();
   double kMag = period / this->characteristicTimeForWindRise;
   double kMagVertical = period / this->characteristicTimeForWindRiseVertical;
@@ -413,13 +523,19 @@ void WindEffectsPrivate::ApplyWindForce(const UpdateInfo &,
   if (!windVel)
     return;
 
+  if (this->windField.Valid())
+  {
+    this->ApplyWindFieldForce(windVel->Data(), _ecm);
+    return;
+  }
+
   Link link;
 
   _ecm.Each<components::Link, components::Inertial, components::WindMode,
             components::WorldLinearVelocity>(
       [&](const Entity &_entity,
           components::Link *,
-          components::Inertial *_inertial,
+          const components::Inertial *_inertial,
           components::WindMode *_windMode,
           components::WorldLinearVelocity *_linkVel) -> bool
       {
@@ -443,6 +559,65 @@ void WindEffectsPrivate::ApplyWindForce(const UpdateInfo &,
 }
 
 
+//////////////////////////////////////////////////
+void WindEffectsPrivate::ApplyWindFieldForce(const math::Vector3d &_windVel,
+                                             EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("WindEffectsPrivate::ApplyWindFieldForce");
+  this->fieldLinks.clear();
+  this->fieldLinkScale.clear();
+  this->fieldLinkForce.clear();
+  this->fieldPosX.clear();
+  this->fieldPosY.clear();
+  this->fieldPosZ.clear();
+
+  // Gather the links first, so that the field is sampled for all of them in
+  // one pass
+  _ecm.Each<components::Link, components::Inertial, components::WindMode,
+            components::WorldLinearVelocity, components::WorldPose>(
+      [&](const Entity &_entity,
+          components::Link *,
+          const components::Inertial *_inertial,
+          components::WindMode *_windMode,
+          components::WorldLinearVelocity *_linkVel,
+          components::WorldPose *_worldPose) -> bool
+      {
+        // Skip links for which the wind is disabled
+        if (!_windMode->Data())
+        {
+          return true;
+        }
+
+        double scale = _inertial->Data().MassMatrix().Mass() *
+                       this->forceApproximationScalingFactor;
+
+        this->fieldLinks.push_back(_entity);
+        this->fieldLinkScale.push_back(scale);
+        this->fieldLinkForce.push_back(
+            scale * (_windVel - _linkVel->Data()));
+        this->fieldPosX.push_back(_worldPose->Data().Pos().X());
+        this->fieldPosY.push_back(_worldPose->Data().Pos().Y());
+        this->fieldPosZ.push_back(_worldPose->Data().Pos().Z());
+        return true;
+      });
+
+  this->windField.Sample(this->fieldPosX, this->fieldPosY, this->fieldPosZ,
+      this->fieldVelX, this->fieldVelY, this->fieldVelZ);
+
+  Link link;
+  for (std::size_t i = 0; i < this->fieldLinks.size(); ++i)
+  {
+    link.ResetEntity(this->fieldLinks[i]);
+
+    math::Vector3d windForce = this->fieldLinkForce[i] +
+        this->fieldLinkScale[i] * math::Vector3d(this->fieldVelX[i],
+        this->fieldVelY[i], this->fieldVelZ[i]);
+
+    // Apply force at center of mass
+    link.AddWorldForce(_ecm, windForce);
+  }
+}
+
 //////////////////////////////////////////////////
 void WindEffectsPrivate::OnWindMsg(const msgs::Wind &_msg)
 {
@@ -87,6 +87,17 @@ namespace systems
   /// <vertical><noise>
   /// Parameters for the noise that is added to the vertical wind velocity
   /// magnitude.
+  ///
+  /// <update_rate>
+  /// Rate in Hz at which the wind velocity above is recomputed. The wind is
+  /// held between updates. Defaults to 0, which updates it every step.
+  ///
+  /// <field><uri>
+  /// Optional file with a wind velocity field on a regular 3D grid, which is
+  /// added to the uniform wind described above. The field is sampled with
+  /// trilinear interpolation at the world position of every link affected by
+  /// wind, all in one pass each step. See wind_effects::WindField for the
+  /// file format. Relative paths are resolved from the SDF file.
   class IGNITION_GAZEBO_VISIBLE WindEffects:
     public System,
     public ISystemConfigure,
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "WindField.hh"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace wind_effects
+{
+//////////////////////////////////////////////////
+bool WindField::Load(const std::string &_filename)
+{
+  std::ifstream file(_filename);
+  if (!file.is_open())
+  {
+    ignerr << "Failed to open wind field [" << _filename << "]" << std::endl;
+    return false;
+  }
+
+  if (!this->Load(file))
+  {
+    ignerr << "Failed to load wind field [" << _filename << "]" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool WindField::Load(std::istream &_in)
+{
+  // Gather all numbers, skipping comment lines
+  std::stringstream tokens;
+  std::string line;
+  while (std::getline(_in, line))
+  {
+    auto first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#')
+      continue;
+    tokens << line << '\n';
+  }
+
+  std::array<int, 3> newSize;
+  std::array<double, 3> newMin;
+  std::array<double, 3> newMax;
+  for (auto &n : newSize)
+    tokens >> n;
+  for (auto &m : newMin)
+    tokens >> m;
+  for (auto &m : newMax)
+    tokens >> m;
+
+  if (!tokens)
+  {
+    ignerr << "Wind field is missing its size or bounds" << std::endl;
+    return false;
+  }
+
+  for (int i = 0; i < 3; ++i)
+  {
+    if (newSize[i] < 2)
+    {
+      ignerr << "Wind field needs at least 2 points along each axis, got ["
+             << newSize[i] << "]" << std::endl;
+      return false;
+    }
+    if (!(newMax[i] > newMin[i]))
+    {
+      ignerr << "Wind field maximum [" << newMax[i]
+             << "] must be greater than its minimum [" << newMin[i] << "]"
+             << std::endl;
+      return false;
+    }
+  }
+
+  const std::size_t count = static_cast<std::size_t>(newSize[0]) *
+      static_cast<std::size_t>(newSize[1]) *
+      static_cast<std::size_t>(newSize[2]);
+  std::vector<double> newU(count);
+  std::vector<double> newV(count);
+  std::vector<double> newW(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (!(tokens >> newU[i] >> newV[i] >> newW[i]))
+    {
+      ignerr << "Wind field has [" << i << "] velocities, expected ["
+             << count << "]" << std::endl;
+      return false;
+    }
+  }
+
+  this->size = newSize;
+  this->min = newMin;
+  for (int i = 0; i < 3; ++i)
+    this->invSpacing[i] = (newSize[i] - 1) / (newMax[i] - newMin[i]);
+  this->u = std::move(newU);
+  this->v = std::move(newV);
+  this->w = std::move(newW);
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool WindField::Valid() const
+{
+  return !this->u.empty();
+}
+
+//////////////////////////////////////////////////
+math::Vector3d WindField::Sample(const math::Vector3d &_pos) const
+{
+  std::vector<double> vx;
+  std::vector<double> vy;
+  std::vector<double> vz;
+  this->Sample({_pos.X()}, {_pos.Y()}, {_pos.Z()}, vx, vy, vz);
+  return {vx[0], vy[0], vz[0]};
+}
+
+//////////////////////////////////////////////////
+void WindField::Sample(const std::vector<double> &_x,
+    const std::vector<double> &_y,
+    const std::vector<double> &_z,
+    std::vector<double> &_vx,
+    std::vector<double> &_vy,
+    std::vector<double> &_vz) const
+{
+  const std::size_t count = _x.size();
+  if (!this->Valid())
+  {
+    _vx.assign(count, 0.0);
+    _vy.assign(count, 0.0);
+    _vz.assign(count, 0.0);
+    return;
+  }
+
+  _vx.resize(count);
+  _vy.resize(count);
+  _vz.resize(count);
+
+  const double minX = this->min[0];
+  const double minY = this->min[1];
+  const double minZ = this->min[2];
+  const double invX = this->invSpacing[0];
+  const double invY = this->invSpacing[1];
+  const double invZ = this->invSpacing[2];
+  const double lastX = this->size[0] - 1;
+  const double lastY = this->size[1] - 1;
+  const double lastZ = this->size[2] - 1;
+  const int strideY = this->size[0];
+  const int strideZ = this->size[0] * this->size[1];
+
+  const double *gridU = this->u.data();
+  const double *gridV = this->v.data();
+  const double *gridW = this->w.data();
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    // Continuous grid coordinates, clamped to the grid
+    const double fx = std::min(std::max((_x[i] - minX) * invX, 0.0), lastX);
+    const double fy = std::min(std::max((_y[i] - minY) * invY, 0.0), lastY);
+    const double fz = std::min(std::max((_z[i] - minZ) * invZ, 0.0), lastZ);
+
+    // Lower corner of the cell. Points on the last grid plane use the last
+    // cell, with a weight of 1 on its upper corner.
+    const int ix = std::min(static_cast<int>(fx), this->size[0] - 2);
+    const int iy = std::min(static_cast<int>(fy), this->size[1] - 2);
+    const int iz = std::min(static_cast<int>(fz), this->size[2] - 2);
+    const double tx = fx - ix;
+    const double ty = fy - iy;
+    const double tz = fz - iz;
+
+    const int c000 = ix + iy * strideY + iz * strideZ;
+    const int c100 = c000 + 1;
+    const int c010 = c000 + strideY;
+    const int c110 = c010 + 1;
+    const int c001 = c000 + strideZ;
+    const int c101 = c001 + 1;
+    const int c011 = c001 + strideY;
+    const int c111 = c011 + 1;
+
+    const double w000 = (1.0 - tx) * (1.0 - ty) * (1.0 - tz);
+    const double w100 = tx * (1.0 - ty) * (1.0 - tz);
+    const double w010 = (1.0 - tx) * ty * (1.0 - tz);
+    const double w110 = tx * ty * (1.0 - tz);
+    const double w001 = (1.0 - tx) * (1.0 - ty) * tz;
+    const double w101 = tx * (1.0 - ty) * tz;
+    const double w011 = (1.0 - tx) * ty * tz;
+    const double w111 = tx * ty * tz;
+
+    _vx[i] = w000 * gridU[c000] + w100 * gridU[c100] + w010 * gridU[c010] +
+        w110 * gridU[c110] + w001 * gridU[c001] + w101 * gridU[c101] +
+        w011 * gridU[c011] + w111 * gridU[c111];
+    _vy[i] = w000 * gridV[c000] + w100 * gridV[c100] + w010 * gridV[c010] +
+        w110 * gridV[c110] + w001 * gridV[c001] + w101 * gridV[c101] +
+        w011 * gridV[c011] + w111 * gridV[c111];
+    _vz[i] = w000 * gridW[c000] + w100 * gridW[c100] + w010 * gridW[c010] +
+        w110 * gridW[c110] + w001 * gridW[c001] + w101 * gridW[c101] +
+        w011 * gridW[c011] + w111 * gridW[c111];
+  }
+}
+}  // namespace wind_effects
+}  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
+}  // namespace gazebo
+}  // namespace ignition
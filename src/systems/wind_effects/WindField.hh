@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_WIND_EFFECTS_WINDFIELD_HH_
+#define IGNITION_GAZEBO_SYSTEMS_WIND_EFFECTS_WINDFIELD_HH_
+
+#include <array>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/math/Vector3.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace wind_effects
+{
+  /// \brief A wind velocity field stored on a regular 3D grid, which is
+  /// sampled with trilinear interpolation. Positions outside of the grid are
+  /// clamped to its boundary.
+  ///
+  /// The field is read from a whitespace separated text file. Lines starting
+  /// with `#` are ignored. The file contains:
+  /// * The number of grid points along X, Y and Z, each at least 2.
+  /// * The minimum X, Y and Z of the grid, in the world frame.
+  /// * The maximum X, Y and Z of the grid, in the world frame.
+  /// * One X, Y, Z velocity per grid point, with X varying fastest and Z
+  /// slowest.
+  class WindField
+  {
+    /// \brief Load the field from a file.
+    /// \param[in] _filename Path to the file.
+    /// \return True if the field was loaded. On failure the field is left
+    /// unchanged.
+    public: bool Load(const std::string &_filename);
+
+    /// \brief Load the field from a stream, see Load.
+    /// \param[in] _in Stream with the contents of a field file.
+    /// \return True if the field was loaded. On failure the field is left
+    /// unchanged.
+    public: bool Load(std::istream &_in);
+
+    /// \brief Whether a field has been loaded.
+    /// \return True if a field has been loaded.
+    public: bool Valid() const;
+
+    /// \brief Sample the field at one position.
+    /// \param[in] _pos World position.
+    /// \return Interpolated wind velocity, or zero if there is no field.
+    public: math::Vector3d Sample(const math::Vector3d &_pos) const;
+
+    /// \brief Sample the field at many positions in one pass. The loop has
+    /// no branches so that the compiler can vectorize it.
+    /// \param[in] _x X coordinate of each position.
+    /// \param[in] _y Y coordinate of each position.
+    /// \param[in] _z Z coordinate of each position.
+    /// \param[out] _vx X velocity at each position.
+    /// \param[out] _vy Y velocity at each position.
+    /// \param[out] _vz Z velocity at each position.
+    public: void Sample(const std::vector<double> &_x,
+                        const std::vector<double> &_y,
+                        const std::vector<double> &_z,
+                        std::vector<double> &_vx,
+                        std::vector<double> &_vy,
+                        std::vector<double> &_vz) const;
+
+    /// \brief Number of grid points along each axis.
+    private: std::array<int, 3> size{{0, 0, 0}};
+
+    /// \brief Position of the first grid point.
+    private: std::array<double, 3> min{{0.0, 0.0, 0.0}};
+
+    /// \brief Inverse of the distance between grid points along each axis.
+    private: std::array<double, 3> invSpacing{{0.0, 0.0, 0.0}};
+
+    /// \brief X velocity at each grid point.
+    private: std::vector<double> u;
+
+    /// \brief Y velocity at each grid point.
+    private: std::vector<double> v;
+
+    /// \brief Z velocity at each grid point.
+    private: std::vector<double> w;
+  };
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <vector>
+
+#include "WindField.hh"
+
+using WindField = ignition::gazebo::wind_effects::WindField;
+using Vector3d = ignition::math::Vector3d;
+
+/// \brief A 2x2x2 field over [0, 2]x[0, 4]x[0, 1] where the velocity
+/// along X grows with x, along Y with y, and along Z with z.
+static const char kField[] =
+  "# size\n"
+  "2 2 2\n"
+  "# min and max\n"
+  "0 0 0\n"
+  "2 4 1\n"
+  "0 0 0\n"
+  "2 0 0\n"
+  "0 4 0\n"
+  "2 4 0\n"
+  "0 0 1\n"
+  "2 0 1\n"
+  "0 4 1\n"
+  "2 4 1\n";
+
+//////////////////////////////////////////////////
+TEST(WindFieldTest, Load)
+{
+  WindField field;
+  EXPECT_FALSE(field.Valid());
+  EXPECT_EQ(Vector3d::Zero, field.Sample(Vector3d(1, 1, 1)));
+
+  // missing velocities
+  std::stringstream truncated("2 2 2\n0 0 0\n1 1 1\n0 0 0\n");
+  EXPECT_FALSE(field.Load(truncated));
+  EXPECT_FALSE(field.Valid());
+
+  // too few points along an axis
+  std::stringstream flat("1 2 2\n0 0 0\n1 1 1\n");
+  EXPECT_FALSE(field.Load(flat));
+
+  // empty bounds
+  std::stringstream empty("2 2 2\n0 0 0\n1 0 1\n");
+  EXPECT_FALSE(field.Load(empty));
+  EXPECT_FALSE(field.Valid());
+
+  std::stringstream valid(kField);
+  EXPECT_TRUE(field.Load(valid));
+  EXPECT_TRUE(field.Valid());
+
+  EXPECT_FALSE(field.Load("/path/that/does/not/exist"));
+  EXPECT_TRUE(field.Valid());
+}
+
+//////////////////////////////////////////////////
+TEST(WindFieldTest, Sample)
+{
+  WindField field;
+  std::stringstream in(kField);
+  ASSERT_TRUE(field.Load(in));
+
+  // grid points
+  EXPECT_EQ(Vector3d(0, 0, 0), field.Sample(Vector3d(0, 0, 0)));
+  EXPECT_EQ(Vector3d(2, 4, 1), field.Sample(Vector3d(2, 4, 1)));
+  EXPECT_EQ(Vector3d(2, 0, 1), field.Sample(Vector3d(2, 0, 1)));
+
+  // the field is linear, so interpolation is exact
+  EXPECT_EQ(Vector3d(1, 2, 0.5), field.Sample(Vector3d(1, 2, 0.5)));
+  EXPECT_EQ(Vector3d(0.5, 3, 0.25), field.Sample(Vector3d(0.5, 3, 0.25)));
+
+  // outside of the grid is clamped
+  EXPECT_EQ(Vector3d(2, 0, 1), field.Sample(Vector3d(10, -5, 3)));
+  EXPECT_EQ(Vector3d(0, 4, 0), field.Sample(Vector3d(-1, 8, -2)));
+
+  // batched sampling matches single samples
+  std::vector<double> x{0.1, 1.5, 2.0, -3.0, 0.7};
+  std::vector<double> y{0.2, 3.9, 1.0, 2.0, 5.0};
+  std::vector<double> z{0.3, 0.0, 0.9, 0.5, -1.0};
+  std::vector<double> vx;
+  std::vector<double> vy;
+  std::vector<double> vz;
+  field.Sample(x, y, z, vx, vy, vz);
+  ASSERT_EQ(x.size(), vx.size());
+  ASSERT_EQ(x.size(), vy.size());
+  ASSERT_EQ(x.size(), vz.size());
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    auto expected = field.Sample(Vector3d(x[i], y[i], z[i]));
+    EXPECT_DOUBLE_EQ(expected.X(), vx[i]);
+    EXPECT_DOUBLE_EQ(expected.Y(), vy[i]);
+    EXPECT_DOUBLE_EQ(expected.Z(), vz[i]);
+  }
+}
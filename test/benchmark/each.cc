@@ -17,6 +17,7 @@
 
 #include <benchmark/benchmark.h>
 
+#include <functional>
 #include <memory>
 
 #include "ignition/gazebo/Entity.hh"
@@ -117,6 +118,33 @@ BENCHMARK_DEFINE_F(EntityComponentManagerFixture, EachCache)
   }
 }
 
+BENCHMARK_DEFINE_F(EntityComponentManagerFixture, EachCacheStdFunction)
+(benchmark::State &_st)
+{
+  for (auto _ : _st)
+  {
+    auto matchingEntityCount = _st.range(0);
+    for (int eachIter = 0; eachIter < kEachIterations; eachIter++)
+    {
+      int entitiesMatched = 0;
+
+      // Passing a std::function uses the type-erased overload
+      std::function<bool(const Entity &, const World *, const Name *)> cb =
+          [&](const Entity &, const World *, const Name *)->bool
+          {
+            entitiesMatched++;
+            return true;
+          };
+      mgr->Each<World, Name>(cb);
+
+      if (entitiesMatched != matchingEntityCount)
+      {
+        _st.SkipWithError("Failed to match correct number of entities");
+      }
+    }
+  }
+}
+
 class ManyComponentFixture: public benchmark::Fixture
 {
   protected: void SetUp(const ::benchmark::State &_state) override
@@ -386,6 +414,10 @@ BENCHMARK_REGISTER_F(EntityComponentManagerFixture, EachCache)
   ->Unit(benchmark::kMillisecond)
   ->Apply(EachTestArgs);
 
+BENCHMARK_REGISTER_F(EntityComponentManagerFixture, EachCacheStdFunction)
+  ->Unit(benchmark::kMillisecond)
+  ->Apply(EachTestArgs);
+
 BENCHMARK_REGISTER_F(ManyComponentFixture, Each1ComponentNoCache)
   ->Arg(10)
   ->Arg(100)
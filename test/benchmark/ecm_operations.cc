@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <ignition/msgs/serialized_map.pb.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ignition/gazebo/Entity.hh"
+#include "ignition/gazebo/EntityComponentManager.hh"
+
+#include "ignition/gazebo/components/AngularVelocity.hh"
+#include "ignition/gazebo/components/LinearVelocity.hh"
+#include "ignition/gazebo/components/Link.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace components;
+
+/// \brief Expose the protected functions used to process removals and
+/// clear change flags.
+class EntityCompMgrTest : public EntityComponentManager
+{
+  public: void ProcessEntityRemovals()
+  {
+    this->ProcessRemoveEntityRequests();
+  }
+
+  public: void ClearNewAndChanged()
+  {
+    this->ClearNewlyCreatedEntities();
+    this->SetAllComponentsUnchanged();
+  }
+};
+
+/// \brief Populate the ECM with link-like entities.
+/// \param[in] _mgr ECM to populate.
+/// \param[in] _entityCount Number of entities to create.
+/// \return The created entities.
+static std::vector<Entity> Populate(EntityComponentManager &_mgr,
+    int64_t _entityCount)
+{
+  std::vector<Entity> entities;
+  entities.reserve(_entityCount);
+  for (int64_t i = 0; i < _entityCount; ++i)
+  {
+    Entity entity = _mgr.CreateEntity();
+    _mgr.CreateComponent(entity, Link());
+    _mgr.CreateComponent(entity, Name("entity_" + std::to_string(i)));
+    _mgr.CreateComponent(entity, Pose());
+    entities.push_back(entity);
+  }
+  return entities;
+}
+
+// NOLINTNEXTLINE
+void BM_CreateEntities(benchmark::State &_st)
+{
+  auto entityCount = _st.range(0);
+  for (auto _ : _st)
+  {
+    _st.PauseTiming();
+    auto mgr = std::make_unique<EntityComponentManager>();
+    _st.ResumeTiming();
+
+    Populate(*mgr, entityCount);
+
+    _st.PauseTiming();
+    mgr.reset();
+    _st.ResumeTiming();
+  }
+  _st.counters["num_entities"] = entityCount;
+  _st.SetItemsProcessed(_st.iterations() * entityCount);
+}
+
+/// \brief Remove and create a tenth of the entities every iteration, like
+/// a world where models are spawned and removed continuously.
+// NOLINTNEXTLINE
+void BM_CreateRemoveChurn(benchmark::State &_st)
+{
+  auto entityCount = _st.range(0);
+  auto churnCount = std::max<int64_t>(1, entityCount / 10);
+
+  EntityCompMgrTest mgr;
+  auto entities = Populate(mgr, entityCount);
+  mgr.ClearNewAndChanged();
+
+  std::size_t next{0};
+  for (auto _ : _st)
+  {
+    for (int64_t i = 0; i < churnCount; ++i)
+    {
+      mgr.RequestRemoveEntity(entities[next], false);
+      next = (next + 1) % entities.size();
+    }
+    mgr.ProcessEntityRemovals();
+
+    auto created = Populate(mgr, churnCount);
+    mgr.ClearNewAndChanged();
+
+    // Replace the removed entities, oldest first
+    for (int64_t i = 0; i < churnCount; ++i)
+    {
+      auto index = (next + entities.size() - churnCount + i) %
+          entities.size();
+      entities[index] = created[i];
+    }
+  }
+  _st.counters["num_entities"] = entityCount;
+  _st.counters["churn"] = churnCount;
+}
+
+// NOLINTNEXTLINE
+void BM_ComponentRandomAccess(benchmark::State &_st)
+{
+  auto entityCount = _st.range(0);
+  EntityComponentManager mgr;
+  auto entities = Populate(mgr, entityCount);
+
+  std::mt19937 rng(1);
+  std::shuffle(entities.begin(), entities.end(), rng);
+
+  for (auto _ : _st)
+  {
+    for (const auto &entity : entities)
+    {
+      auto pose = mgr.Component<Pose>(entity);
+      benchmark::DoNotOptimize(pose);
+    }
+  }
+  _st.counters["num_entities"] = entityCount;
+  _st.SetItemsProcessed(_st.iterations() * entityCount);
+}
+
+/// \brief Look entities up by name, with the name index enabled if the
+/// second argument is 1.
+// NOLINTNEXTLINE
+void BM_EntityByComponents(benchmark::State &_st)
+{
+  auto entityCount = _st.range(0);
+  EntityComponentManager mgr;
+  mgr.SetNameIndex(_st.range(1) != 0);
+  Populate(mgr, entityCount);
+
+  // Look for entities spread over the whole range
+  const int64_t lookups{100};
+  std::vector<std::string> names;
+  for (int64_t i = 0; i < lookups; ++i)
+    names.push_back("entity_" + std::to_string(i * entityCount / lookups));
+
+  for (auto _ : _st)
+  {
+    for (const auto &name : names)
+    {
+      auto entity = mgr.EntityByComponents(Link(), Name(name));
+      if (kNullEntity == entity)
+        _st.SkipWithError("Failed to find entity");
+      benchmark::DoNotOptimize(entity);
+    }
+  }
+  _st.counters["num_entities"] = entityCount;
+  _st.SetItemsProcessed(_st.iterations() * lookups);
+}
+
+/// \brief Iterate over a component combination for the first time, which
+/// creates its view.
+// NOLINTNEXTLINE
+void BM_FirstEachNewView(benchmark::State &_st)
+{
+  auto entityCount = _st.range(0);
+  for (auto _ : _st)
+  {
+    _st.PauseTiming();
+    auto mgr = std::make_unique<EntityComponentManager>();
+    auto entities = Populate(*mgr, entityCount);
+    for (const auto &entity : entities)
+    {
+      mgr->CreateComponent(entity, LinearVelocity());
+      mgr->CreateComponent(entity, AngularVelocity());
+    }
+    _st.ResumeTiming();
+
+    int64_t matched{0};
+    mgr->Each<Link, Pose, LinearVelocity, AngularVelocity>(
+        [&](const Entity &, const Link *, const Pose *,
+            const LinearVelocity *, const AngularVelocity *) -> bool
+        {
+          ++matched;
+          return true;
+        });
+
+    if (matched != entityCount)
+      _st.SkipWithError("Failed to match all entities");
+
+    _st.PauseTiming();
+    mgr.reset();
+    _st.ResumeTiming();
+  }
+  _st.counters["num_entities"] = entityCount;
+}
+
+// NOLINTNEXTLINE
+void BM_SetState(benchmark::State &_st)
+{
+  auto entityCount = _st.range(0);
+  msgs::SerializedStateMap stateMsg;
+  {
+    EntityComponentManager source;
+    Populate(source, entityCount);
+    source.State(stateMsg);
+  }
+
+  for (auto _ : _st)
+  {
+    _st.PauseTiming();
+    auto mgr = std::make_unique<EntityComponentManager>();
+    _st.ResumeTiming();
+
+    mgr->SetState(stateMsg);
+
+    _st.PauseTiming();
+    if (mgr->EntityCount() != static_cast<std::size_t>(entityCount))
+      _st.SkipWithError("Failed to set all entities");
+    mgr.reset();
+    _st.ResumeTiming();
+  }
+  _st.counters["num_entities"] = entityCount;
+}
+
+/// \brief Serialize the changed state, with a percentage of the poses
+/// changed, given by the second argument.
+// NOLINTNEXTLINE
+void BM_ChangedState(benchmark::State &_st)
+{
+  auto entityCount = _st.range(0);
+  auto changedPercent = _st.range(1);
+
+  EntityCompMgrTest mgr;
+  auto entities = Populate(mgr, entityCount);
+  mgr.ClearNewAndChanged();
+
+  const int64_t changedCount = entityCount * changedPercent / 100;
+  for (int64_t i = 0; i < changedCount; ++i)
+  {
+    mgr.SetChanged(entities[i], Pose::typeId,
+        ComponentState::PeriodicChange);
+  }
+
+  std::size_t serializedSize{0};
+  for (auto _ : _st)
+  {
+    msgs::SerializedStateMap stateMsg;
+    mgr.ChangedState(stateMsg);
+#if GOOGLE_PROTOBUF_VERSION >= 3004000
+    serializedSize = stateMsg.ByteSizeLong();
+#else
+    serializedSize = stateMsg.ByteSize();
+#endif
+  }
+  _st.counters["num_entities"] = entityCount;
+  _st.counters["num_changed"] = changedCount;
+  _st.counters["serialized_size"] = serializedSize;
+}
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_CreateEntities)
+  ->Arg(1000)
+  ->Arg(10000)
+  ->Arg(100000)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_CreateRemoveChurn)
+  ->Arg(1000)
+  ->Arg(10000)
+  ->Arg(100000)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_ComponentRandomAccess)
+  ->Arg(1000)
+  ->Arg(10000)
+  ->Arg(100000)
+  ->Unit(benchmark::kMicrosecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_EntityByComponents)
+  ->Args({1000, 0})
+  ->Args({10000, 0})
+  ->Args({100000, 0})
+  ->Args({1000, 1})
+  ->Args({10000, 1})
+  ->Args({100000, 1})
+  ->Unit(benchmark::kMicrosecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_FirstEachNewView)
+  ->Arg(1000)
+  ->Arg(10000)
+  ->Arg(100000)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_SetState)
+  ->Arg(1000)
+  ->Arg(10000)
+  ->Arg(100000)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_ChangedState)
+  ->Args({10000, 1})
+  ->Args({10000, 10})
+  ->Args({10000, 100})
+  ->Args({100000, 1})
+  ->Args({100000, 10})
+  ->Args({100000, 100})
+  ->Unit(benchmark::kMillisecond);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "ignition/gazebo/Entity.hh"
+#include "ignition/gazebo/EntityComponentManager.hh"
+
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace components;
+
+/// \brief Expose the protected functions used to process removals.
+class EntityCompMgrTest : public EntityComponentManager
+{
+  public: void ProcessEntityRemovals()
+  {
+    this->ProcessRemoveEntityRequests();
+  }
+};
+
+/// \brief Populate the ECM with entities holding a couple of components.
+/// \param[in] _mgr ECM to populate.
+/// \param[in] _entityCount Number of entities to create.
+/// \return The created entities.
+static std::vector<Entity> Populate(EntityComponentManager &_mgr,
+    int _entityCount)
+{
+  std::vector<Entity> entities;
+  entities.reserve(_entityCount);
+  for (int i = 0; i < _entityCount; ++i)
+  {
+    Entity entity = _mgr.CreateEntity();
+    _mgr.CreateComponent(entity, Name("entity_name"));
+    _mgr.CreateComponent(entity, Pose());
+    entities.push_back(entity);
+  }
+  return entities;
+}
+
+// NOLINTNEXTLINE
+void BM_RemoveAllEntitiesOneByOne(benchmark::State &_st)
+{
+  auto entityCount = _st.range(0);
+  for (auto _ : _st)
+  {
+    _st.PauseTiming();
+    auto mgr = std::make_unique<EntityCompMgrTest>();
+    auto entities = Populate(*mgr, entityCount);
+    for (const auto &entity : entities)
+      mgr->RequestRemoveEntity(entity, false);
+    _st.ResumeTiming();
+
+    mgr->ProcessEntityRemovals();
+
+    if (mgr->EntityCount() != 0u)
+      _st.SkipWithError("Failed to remove all entities");
+  }
+  _st.counters["num_entities"] = entityCount;
+}
+
+// NOLINTNEXTLINE
+void BM_RemoveHalfTheComponents(benchmark::State &_st)
+{
+  auto entityCount = _st.range(0);
+  for (auto _ : _st)
+  {
+    _st.PauseTiming();
+    auto mgr = std::make_unique<EntityCompMgrTest>();
+    auto entities = Populate(*mgr, entityCount);
+    _st.ResumeTiming();
+
+    // Remove from the front, so that every removal moves a component from the
+    // back of the storage.
+    for (int i = 0; i < entityCount; i += 2)
+      mgr->RemoveComponent<Pose>(entities[i]);
+  }
+  _st.counters["num_entities"] = entityCount;
+}
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_RemoveAllEntitiesOneByOne)
+  ->Arg(10000)
+  ->Arg(50000)
+  ->Arg(100000)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_RemoveHalfTheComponents)
+  ->Arg(10000)
+  ->Arg(50000)
+  ->Arg(100000)
+  ->Unit(benchmark::kMillisecond);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
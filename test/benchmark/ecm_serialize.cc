@@ -17,13 +17,17 @@
 
 #include <benchmark/benchmark.h>
 
+#include <ignition/msgs/serialized_map.pb.h>
+
 #include <memory>
+#include <sstream>
 
 #include "ignition/gazebo/Entity.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 
 #include "ignition/gazebo/components/AngularVelocity.hh"
 #include "ignition/gazebo/components/Inertial.hh"
+#include "ignition/gazebo/components/JointPosition.hh"
 #include "ignition/gazebo/components/LinearAcceleration.hh"
 #include "ignition/gazebo/components/LinearVelocity.hh"
 #include "ignition/gazebo/components/Name.hh"
@@ -148,7 +152,103 @@ BENCHMARK(BM_Serialize5Component)
   ->Arg(1000)
   ->Unit(benchmark::kMillisecond);
 
-// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+/// \brief Create entities with the POD-like components which dominate
+/// state messages.
+/// \param[in] _entityCount Number of entities to create.
+/// \return The populated manager.
+std::unique_ptr<EntityComponentManager> CreatePodEntities(int _entityCount)
+{
+  auto mgr = std::make_unique<EntityComponentManager>();
+  for (int ii = 0; ii < _entityCount; ++ii)
+  {
+    auto e = mgr->CreateEntity();
+    mgr->CreateComponent(e, Pose(math::Pose3d(ii, 1, 2, 0.1, 0.2, 0.3)));
+    mgr->CreateComponent(e, LinearVelocity(math::Vector3d(ii, 0.5, 0)));
+    mgr->CreateComponent(e, JointPosition({0.1 * ii, 0.2, 0.3}));
+  }
+  return mgr;
+}
+
+/// \brief Serialize the POD-like components of all entities into a state
+/// message, either through streams or straight into the message's buffers.
+/// \param[in] _st Benchmark state.
+/// \param[in] _binary True to use binary serialization.
+void SerializePodComponents(benchmark::State &_st, bool _binary)
+{
+  size_t serializedSize = 0;
+  auto entityCount = _st.range(0);
+  auto mgr = CreatePodEntities(entityCount);
+
+  for (auto _: _st)
+  {
+    msgs::SerializedStateMap stateMsg;
+    auto serialize = [&](const Entity &_entity,
+        const components::BaseComponent *_comp)
+    {
+      auto &entityMsg = (*stateMsg.mutable_entities())[_entity];
+      auto &compMsg = (*entityMsg.mutable_components())[
+          static_cast<int64_t>(_comp->TypeId())];
+      compMsg.set_type(_comp->TypeId());
+      if (_binary)
+      {
+        _comp->SerializeBinary(*compMsg.mutable_component());
+      }
+      else
+      {
+        std::ostringstream ostr;
+        _comp->Serialize(ostr);
+        compMsg.set_component(ostr.str());
+      }
+    };
+
+    mgr->Each<Pose, LinearVelocity, JointPosition>(
+        [&](const Entity &_entity, const Pose *_pose,
+            const LinearVelocity *_vel, const JointPosition *_joint) -> bool
+        {
+          serialize(_entity, _pose);
+          serialize(_entity, _vel);
+          serialize(_entity, _joint);
+          return true;
+        });
+
+#if GOOGLE_PROTOBUF_VERSION >= 3004000
+    serializedSize = stateMsg.ByteSizeLong();
+#else
+    serializedSize = stateMsg.ByteSize();
+#endif
+  }
+  _st.counters["serialized_size"] = serializedSize;
+  _st.counters["num_entities"] = entityCount;
+  _st.counters["num_components"] = 3;
+}
+
+// NOLINTNEXTLINE
+void BM_SerializePodStream(benchmark::State &_st)
+{
+  SerializePodComponents(_st, false);
+}
+
+// NOLINTNEXTLINE
+void BM_SerializePodBinary(benchmark::State &_st)
+{
+  SerializePodComponents(_st, true);
+}
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_SerializePodStream)
+  ->Arg(100)
+  ->Arg(1000)
+  ->Arg(10000)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_SerializePodBinary)
+  ->Arg(100)
+  ->Arg(1000)
+  ->Arg(10000)
+  ->Unit(benchmark::kMillisecond);
+
+, Ubuntu complains that there's an extra ';'
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
 BENCHMARK_MAIN();
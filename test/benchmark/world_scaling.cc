@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+
+#include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/ServerConfig.hh"
+#include "ignition/gazebo/SystemLoader.hh"
+#include "ignition/gazebo/test_config.hh"  // NOLINT(build/include)
+
+#include "../plugins/MockSystem.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+using Clock = std::chrono::steady_clock;
+
+/// \brief Options which can be combined in the last benchmark argument.
+enum WorldOption : int64_t
+{
+  /// \brief Split the models into levels, with a performer on the first
+  /// model.
+  kLevels = 1 << 0,
+
+  /// \brief Record a log while stepping.
+  kLogRecord = 1 << 1,
+
+  /// \brief Load the SceneBroadcaster system.
+  kSceneBroadcaster = 1 << 2
+};
+
+/// \brief Number of models in each row of the generated world, and in each
+/// level when levels are used.
+constexpr int kModelsPerRow{10};
+
+/// \brief Generate a world with a ground plane and models laid out in rows.
+/// \param[in] _models Number of models.
+/// \param[in] _links Number of links in each model.
+/// \param[in] _sensors Number of IMU sensors in each link.
+/// \param[in] _options Combination of WorldOption.
+/// \return SDF string of the world.
+static std::string GenerateWorld(int64_t _models, int64_t _links,
+    int64_t _sensors, int64_t _options)
+{
+  const double linkSpacing{1.5};
+  const double modelSpacingX = _links * linkSpacing + 1.0;
+  const double modelSpacingY{2.0};
+
+  std::ostringstream sdf;
+  sdf << "<?xml version=\"1.0\" ?>\n"
+      << "<sdf version=\"1.6\">\n"
+      << "  <world name=\"world_scaling\">\n"
+      << "    <physics name=\"1ms\" type=\"ignored\">\n"
+      << "      <max_step_size>0.001</max_step_size>\n"
+      << "      <real_time_factor>0</real_time_factor>\n"
+      << "    </physics>\n"
+      << "    <plugin filename=\"ignition-gazebo-physics-system\"\n"
+      << "            name=\"ignition::gazebo::systems::Physics\"/>\n";
+
+  if (_sensors > 0)
+  {
+    sdf << "    <plugin filename=\"ignition-gazebo-imu-system\"\n"
+        << "            name=\"ignition::gazebo::systems::Imu\"/>\n";
+  }
+
+  if (_options & kSceneBroadcaster)
+  {
+    sdf << "    <plugin filename=\"ignition-gazebo-scene-broadcaster-system\"\n"
+        << "            name=\"ignition::gazebo::systems::SceneBroadcaster\"/>"
+        << "\n";
+  }
+
+  sdf << "    <model name=\"ground_plane\">\n"
+      << "      <static>true</static>\n"
+      << "      <link name=\"link\">\n"
+      << "        <collision name=\"collision\">\n"
+      << "          <geometry><plane><normal>0 0 1</normal>"
+      << "<size>10000 10000</size></plane></geometry>\n"
+      << "        </collision>\n"
+      << "      </link>\n"
+      << "    </model>\n";
+
+  for (int64_t m = 0; m < _models; ++m)
+  {
+    const double x = (m % kModelsPerRow) * modelSpacingX;
+    const double y = static_cast<double>(m / kModelsPerRow) * modelSpacingY;
+
+    sdf << "    <model name=\"model_" << m << "\">\n"
+        << "      <pose>" << x << " " << y << " 0.5 0 0 0</pose>\n";
+
+    for (int64_t l = 0; l < _links; ++l)
+    {
+      sdf << "      <link name=\"link_" << l << "\">\n"
+          << "        <pose>" << l * linkSpacing << " 0 0 0 0 0</pose>\n"
+          << "        <inertial><mass>1</mass><inertia>"
+          << "<ixx>0.167</ixx><iyy>0.167</iyy><izz>0.167</izz>"
+          << "</inertia></inertial>\n"
+          << "        <collision name=\"collision\">\n"
+          << "          <geometry><box><size>1 1 1</size></box></geometry>\n"
+          << "        </collision>\n"
+          << "        <visual name=\"visual\">\n"
+          << "          <geometry><box><size>1 1 1</size></box></geometry>\n"
+          << "        </visual>\n";
+
+      for (int64_t s = 0; s < _sensors; ++s)
+      {
+        sdf << "        <sensor name=\"imu_" << s << "\" type=\"imu\">\n"
+            << "          <always_on>1</always_on>\n"
+            << "          <update_rate>100</update_rate>\n"
+            << "        </sensor>\n";
+      }
+      sdf << "      </link>\n";
+    }
+    sdf << "    </model>\n";
+  }
+
+  if (_options & kLevels)
+  {
+    const int64_t rows = (_models + kModelsPerRow - 1) / kModelsPerRow;
+    const double rowLength = kModelsPerRow * modelSpacingX;
+
+    sdf << "    <plugin name=\"ignition::gazebo\" filename=\"dummy\">\n"
+        << "      <performer name=\"perf_model_0\">\n"
+        << "        <ref>model_0</ref>\n"
+        << "        <geometry><box><size>2 2 2</size></box></geometry>\n"
+        << "      </performer>\n";
+
+    for (int64_t r = 0; r < rows; ++r)
+    {
+      sdf << "      <level name=\"level_" << r << "\">\n"
+          << "        <pose>" << rowLength * 0.5 << " " << r * modelSpacingY
+          << " 0.5 0 0 0</pose>\n"
+          << "        <geometry><box><size>" << rowLength << " "
+          << modelSpacingY << " 10</size></box></geometry>\n"
+          << "        <buffer>1</buffer>\n";
+      for (int64_t m = r * kModelsPerRow;
+           m < std::min(_models, (r + 1) * kModelsPerRow); ++m)
+      {
+        // The performer must always be loaded
+        if (m != 0)
+          sdf << "        <ref>model_" << m << "</ref>\n";
+      }
+      sdf << "      </level>\n";
+    }
+    sdf << "    </plugin>\n";
+  }
+
+  sdf << "  </world>\n"
+      << "</sdf>\n";
+  return sdf.str();
+}
+
+/// \brief Get the resident set size of this process.
+/// \return Resident memory in megabytes, or 0 if it isn't available.
+static double ResidentMemoryMb()
+{
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  long pages{0};
+  long residentPages{0};
+  if (statm >> pages >> residentPages)
+  {
+    return static_cast<double>(residentPages) *
+        static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+  }
+#endif
+  return 0.0;
+}
+
+/// \brief Path where logs are recorded.
+/// \return Absolute path.
+static std::string LogPath()
+{
+  return common::joinPaths(PROJECT_BINARY_PATH, "test", "world_scaling_log");
+}
+
+/// \brief Create a server for the given benchmark arguments.
+/// \param[in] _st Benchmark state, with the number of models, links,
+/// sensors and a combination of WorldOption as arguments.
+/// \return New server.
+static std::unique_ptr<Server> CreateServer(const benchmark::State &_st)
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfString(GenerateWorld(_st.range(0), _st.range(1),
+      _st.range(2), _st.range(3)));
+  serverConfig.SetUseLevels(_st.range(3) & kLevels);
+  if (_st.range(3) & kLogRecord)
+  {
+    common::removeAll(LogPath());
+    serverConfig.SetUseLogRecord(true);
+    serverConfig.SetLogRecordPath(LogPath());
+  }
+  return std::make_unique<Server>(serverConfig);
+}
+
+/// \brief Set the counters shared by all benchmarks.
+/// \param[in] _st Benchmark state.
+static void SetWorldCounters(benchmark::State &_st)
+{
+  const auto links = _st.range(0) * _st.range(1);
+  _st.counters["models"] = _st.range(0);
+  _st.counters["links"] = links;
+  _st.counters["sensors"] = links * _st.range(2);
+  _st.counters["options"] = _st.range(3);
+}
+
+/// \brief Arguments of every world size and option, as {models, links,
+/// sensors, options}.
+/// \param[in] _b Benchmark to add the arguments to.
+static void WorldArguments(benchmark::internal::Benchmark *_b)
+{
+  for (int64_t models : {10, 100, 1000})
+  {
+    _b->Args({models, 1, 0, 0});
+    _b->Args({models, 5, 0, 0});
+    _b->Args({models, 1, 2, 0});
+  }
+  _b->Args({100, 1, 1, kLevels});
+  _b->Args({100, 1, 1, kLogRecord});
+  _b->Args({100, 1, 1, kSceneBroadcaster});
+  _b->Args({100, 1, 1, kLevels | kLogRecord | kSceneBroadcaster});
+}
+
+/// \brief Benchmark loading a world and running its first step.
+// NOLINTNEXTLINE
+void BM_Startup(benchmark::State &_st)
+{
+  double memoryMb{0};
+  for (auto _ : _st)
+  {
+    const double memoryBefore = ResidentMemoryMb();
+    auto start = Clock::now();
+
+    auto server = CreateServer(_st);
+    server->Run(true, 1, false);
+
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    _st.SetIterationTime(elapsed.count());
+    memoryMb = ResidentMemoryMb() - memoryBefore;
+
+    _st.PauseTiming();
+    server.reset();
+    _st.ResumeTiming();
+  }
+  SetWorldCounters(_st);
+  _st.counters["memory_mb"] = memoryMb;
+  common::removeAll(LogPath());
+}
+
+/// \brief Benchmark single simulation steps. Besides the total step time,
+/// the time until the end of the PreUpdate and Update phases is reported.
+/// The MockSystem is the last system to run in each phase, so its callbacks
+/// mark the end of that phase. PostUpdate includes the rest of the step.
+// NOLINTNEXTLINE
+void BM_Step(benchmark::State &_st)
+{
+  const double memoryBefore = ResidentMemoryMb();
+  auto server = CreateServer(_st);
+
+  SystemLoader loader;
+  auto plugin = loader.LoadPlugin("libMockSystem.so",
+      "ignition::gazebo::MockSystem", nullptr);
+  if (!plugin.has_value())
+  {
+    _st.SkipWithError("Failed to load MockSystem");
+    return;
+  }
+  auto mockSystem =
+      static_cast<MockSystem *>(plugin.value()->QueryInterface<System>());
+
+  Clock::time_point preUpdateEnd;
+  Clock::time_point updateEnd;
+  mockSystem->preUpdateCallback =
+      [&](const UpdateInfo &, EntityComponentManager &)
+      {
+        preUpdateEnd = Clock::now();
+      };
+  mockSystem->updateCallback =
+      [&](const UpdateInfo &, EntityComponentManager &)
+      {
+        updateEnd = Clock::now();
+      };
+  server->AddSystem(plugin.value());
+
+  // Let levels and systems settle before measuring
+  server->Run(true, 10, false);
+  const double memoryMb = ResidentMemoryMb() - memoryBefore;
+
+  std::chrono::duration<double> preUpdate{0};
+  std::chrono::duration<double> update{0};
+  std::chrono::duration<double> postUpdate{0};
+  for (auto _ : _st)
+  {
+    auto start = Clock::now();
+    server->Run(true, 1, false);
+    auto end = Clock::now();
+
+    preUpdate += preUpdateEnd - start;
+    update += updateEnd - preUpdateEnd;
+    postUpdate += end - updateEnd;
+  }
+
+  const double iterations = static_cast<double>(_st.iterations());
+  SetWorldCounters(_st);
+  _st.counters["memory_mb"] = memoryMb;
+  _st.counters["pre_update_ms"] = preUpdate.count() * 1e3 / iterations;
+  _st.counters["update_ms"] = update.count() * 1e3 / iterations;
+  _st.counters["post_update_ms"] = postUpdate.count() * 1e3 / iterations;
+
+  server.reset();
+  common::removeAll(LogPath());
+}
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_Startup)
+  ->Apply(WorldArguments)
+  ->UseManualTime()
+  ->Iterations(3)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_Step)
+  ->Apply(WorldArguments)
+  ->Unit(benchmark::kMillisecond);
+
+int main(int _argc, char **_argv)
+{
+  common::Console::SetVerbosity(1);
+  setenv("IGN_GAZEBO_SYSTEM_PLUGIN_PATH",
+         (std::string(PROJECT_BINARY_PATH) + "/lib").c_str(), 1);
+
+  benchmark::Initialize(&_argc, _argv);
+  if (benchmark::ReportUnrecognizedArguments(_argc, _argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <ignition/msgs/altimeter.pb.h>
+#include <ignition/msgs/fluid_pressure.pb.h>
+#include <ignition/msgs/imu.pb.h>
+#include <ignition/msgs/magnetometer.pb.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Sensor.hh"
+#include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/test_config.hh"
+
+#include "../helpers/Relay.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Test BatchedSensors system
+class BatchedSensorsTest : public ::testing::Test
+{
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    ignition::common::Console::SetVerbosity(4);
+    setenv("IGN_GAZEBO_SYSTEM_PLUGIN_PATH",
+           (std::string(PROJECT_BINARY_PATH) + "/lib").c_str(), 1);
+  }
+};
+
+/////////////////////////////////////////////////
+// The test checks that all sensors of a falling model publish on the same
+// topics as with their own systems.
+TEST_F(BatchedSensorsTest, ModelFalling)
+{
+  ServerConfig serverConfig;
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/batched_sensors.sdf";
+  serverConfig.SetSdfFile(sdfFile);
+
+  Server server(serverConfig);
+
+  const std::string prefix =
+      "world/batched_sensors/model/sensor_model/link/link/sensor/";
+
+  // Check the topic of each sensor
+  test::Relay testSystem;
+  std::vector<std::string> topics;
+  testSystem.OnPostUpdate([&](const gazebo::UpdateInfo &,
+                              const gazebo::EntityComponentManager &_ecm)
+      {
+        if (!topics.empty())
+          return;
+
+        _ecm.Each<components::Sensor, components::Name,
+                  components::SensorTopic>(
+            [&](const Entity &, const components::Sensor *,
+                const components::Name *_name,
+                const components::SensorTopic *_topic) -> bool
+            {
+              topics.push_back(_topic->Data());
+              EXPECT_EQ(0u, _topic->Data().find(prefix + _name->Data()))
+                  << _topic->Data();
+              return true;
+            });
+      });
+  server.AddSystem(testSystem.systemPtr);
+
+  std::mutex mutex;
+  std::vector<msgs::IMU> imuMsgs;
+  std::vector<msgs::Altimeter> altMsgs;
+  std::vector<msgs::Magnetometer> magMsgs;
+  std::vector<msgs::FluidPressure> pressureMsgs;
+
+  transport::Node node;
+  std::function<void(const msgs::IMU &)> imuCb =
+      [&](const msgs::IMU &_msg)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        imuMsgs.push_back(_msg);
+      };
+  std::function<void(const msgs::Altimeter &)> altCb =
+      [&](const msgs::Altimeter &_msg)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        altMsgs.push_back(_msg);
+      };
+  std::function<void(const msgs::Magnetometer &)> magCb =
+      [&](const msgs::Magnetometer &_msg)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        magMsgs.push_back(_msg);
+      };
+  std::function<void(const msgs::FluidPressure &)> pressureCb =
+      [&](const msgs::FluidPressure &_msg)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        pressureMsgs.push_back(_msg);
+      };
+  node.Subscribe(prefix + "imu_sensor/imu", imuCb);
+  node.Subscribe(prefix + "altimeter_sensor/altimeter", altCb);
+  node.Subscribe(prefix + "magnetometer_sensor/magnetometer", magCb);
+  node.Subscribe(prefix + "air_pressure_sensor/air_pressure", pressureCb);
+
+  // 30 Hz over 100 ms
+  server.Run(true, 100u, false);
+  EXPECT_EQ(4u, topics.size());
+
+  const std::size_t waitForMsgs = 4u;
+  for (int sleep = 0; sleep < 30; ++sleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (imuMsgs.size() == waitForMsgs && altMsgs.size() == waitForMsgs &&
+        magMsgs.size() == waitForMsgs && pressureMsgs.size() == waitForMsgs)
+    {
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(waitForMsgs, imuMsgs.size());
+  ASSERT_EQ(waitForMsgs, altMsgs.size());
+  ASSERT_EQ(waitForMsgs, magMsgs.size());
+  ASSERT_EQ(waitForMsgs, pressureMsgs.size());
+
+  // The model is falling
+  EXPECT_GT(altMsgs.front().vertical_position(),
+      altMsgs.back().vertical_position());
+  EXPECT_LT(altMsgs.back().vertical_velocity(), 0.0);
+
+  // Pressure increases as the model falls
+  EXPECT_LT(pressureMsgs.front().pressure(), pressureMsgs.back().pressure());
+
+  // The world field is reported
+  EXPECT_NE(0.0, magMsgs.back().field_tesla().x());
+}
@@ -18,6 +18,7 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <vector>
 
 #include <ignition/common/Battery.hh>
 #include <ignition/common/Console.hh>
@@ -33,6 +34,8 @@
 #include "ignition/gazebo/test_config.hh"
 #include "ignition/gazebo/Entity.hh"
 #include "ignition/gazebo/components/BatterySoC.hh"
+#include "ignition/gazebo/components/Joint.hh"
+#include "ignition/gazebo/components/JointVelocityCmd.hh"
 #include "ignition/gazebo/components/Link.hh"
 #include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/Name.hh"
@@ -151,3 +154,71 @@ TEST_F(BatteryPluginTest, SingleBattery)
       });
   EXPECT_EQ(batCount, 1);
 }
+
+/////////////////////////////////////////////////
+// A battery integrated at a lower rate drains like one integrated every step
+TEST_F(BatteryPluginTest, UpdateRate)
+{
+  const auto sdfPath = common::joinPaths(std::string(PROJECT_SOURCE_PATH),
+    "test", "worlds", "battery_update_rate.sdf");
+
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(sdfPath);
+
+  // Command the joint, so the batteries drain
+  this->mockSystem->preUpdateCallback =
+    [](const gazebo::UpdateInfo &, gazebo::EntityComponentManager &_ecm)
+    {
+      Entity joint = _ecm.EntityByComponents(components::Joint(),
+          components::Name("wheel_joint"));
+      ASSERT_NE(kNullEntity, joint);
+      if (!_ecm.Component<components::JointVelocityCmd>(joint))
+      {
+        _ecm.CreateComponent(joint,
+            components::JointVelocityCmd(std::vector<double>({1.0})));
+      }
+    };
+
+  // Count the updates of each battery's component
+  double everyStepSoC{1.0};
+  double ratedSoC{1.0};
+  int everyStepUpdates{0};
+  int ratedUpdates{0};
+  this->mockSystem->postUpdateCallback =
+    [&](const gazebo::UpdateInfo &,
+        const gazebo::EntityComponentManager &_ecm)
+    {
+      _ecm.Each<components::BatterySoC, components::Name>(
+          [&](const Entity &, const components::BatterySoC *_batComp,
+              const components::Name *_nameComp) -> bool
+          {
+            if (_nameComp->Data() == "every_step_battery" &&
+                _batComp->Data() != everyStepSoC)
+            {
+              everyStepSoC = _batComp->Data();
+              ++everyStepUpdates;
+            }
+            else if (_nameComp->Data() == "rated_battery" &&
+                _batComp->Data() != ratedSoC)
+            {
+              ratedSoC = _batComp->Data();
+              ++ratedUpdates;
+            }
+            return true;
+          });
+    };
+
+  // Run 2 seconds
+  Server server(serverConfig);
+  server.AddSystem(this->systemPtr);
+  server.Run(true, 2000, false);
+
+  EXPECT_GT(everyStepUpdates, 1000);
+  EXPECT_GE(ratedUpdates, 15);
+  EXPECT_LE(ratedUpdates, 21);
+
+  // Both drained, by close amounts, up to the time left to integrate
+  EXPECT_LT(everyStepSoC, 1.1665 / 1.2009);
+  EXPECT_LT(ratedSoC, 1.1665 / 1.2009);
+  EXPECT_NEAR(everyStepSoC, ratedSoC, 1e-3);
+}
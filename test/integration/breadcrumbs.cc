@@ -550,6 +550,66 @@ TEST_F(BreadcrumbsTest, AllowRenaming)
   EXPECT_TRUE(this->server->HasEntity("B1_0_1"));
 }
 
+/////////////////////////////////////////////////
+// The test checks that pooled breadcrumbs are created on startup and moved
+// into place when deployed
+TEST_F(BreadcrumbsTest, Pool)
+{
+  // Start server
+  this->LoadWorld("test/worlds/breadcrumbs.sdf");
+
+  transport::Node node;
+  auto deploy = node.Advertise<msgs::Empty>("/pool_deploy");
+
+  this->server->Run(true, 1, false);
+  EXPECT_TRUE(this->server->HasEntity("BP_0"));
+  EXPECT_TRUE(this->server->HasEntity("BP_1"));
+  EXPECT_FALSE(this->server->HasEntity("BP_2"));
+  auto entityCount = this->server->EntityCount().value();
+
+  test::Relay testSystem;
+  math::Pose3d poseVehicle;
+  math::Pose3d poseBP0;
+  math::Pose3d poseBP1;
+  testSystem.OnPostUpdate([&](const gazebo::UpdateInfo &,
+                             const gazebo::EntityComponentManager &_ecm)
+  {
+    auto poseOf = [&_ecm](const std::string &_name)
+    {
+      Entity entity = _ecm.EntityByComponents(components::Model(),
+          components::Name(_name));
+      auto poseComp = _ecm.Component<components::Pose>(entity);
+      return poseComp ? poseComp->Data() : math::Pose3d::Zero;
+    };
+    poseVehicle = poseOf("vehicle_blue");
+    poseBP0 = poseOf("BP_0");
+    poseBP1 = poseOf("BP_1");
+  });
+  this->server->AddSystem(testSystem.systemPtr);
+
+  // Pooled breadcrumbs wait at the pool pose
+  this->server->Run(true, 100, false);
+  EXPECT_NEAR(-1000, poseBP0.Pos().Z(), 1e-3);
+  EXPECT_NEAR(-1000, poseBP1.Pos().Z(), 1e-3);
+
+  // Deploying moves the first pooled breadcrumb without creating entities,
+  // apart from removing its joint
+  deploy.Publish(msgs::Empty());
+  this->server->Run(true, 100, false);
+  EXPECT_GE(entityCount, this->server->EntityCount().value());
+  auto poseDiff = poseVehicle.Inverse() * poseBP0;
+  EXPECT_NEAR(-1.2, poseDiff.Pos().X(), 1e-2);
+  EXPECT_NEAR(-1000, poseBP1.Pos().Z(), 1e-3);
+
+  // Once the pool is used up, breadcrumbs are created on deployment
+  deploy.Publish(msgs::Empty());
+  this->server->Run(true, 100, false);
+  deploy.Publish(msgs::Empty());
+  this->server->Run(true, 100, false);
+  EXPECT_TRUE(this->server->HasEntity("BP_2"));
+  EXPECT_LT(-100, poseBP1.Pos().Z());
+}
+
 /////////////////////////////////////////////////
 /// Return a list of model entities whose names match the given regex
 std::vector<Entity> ModelsByNameRegex(
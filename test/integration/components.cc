@@ -47,6 +47,7 @@
 #include "ignition/gazebo/components/Inertial.hh"
 #include "ignition/gazebo/components/Joint.hh"
 #include "ignition/gazebo/components/JointAxis.hh"
+#include "ignition/gazebo/components/JointStates.hh"
 #include "ignition/gazebo/components/JointType.hh"
 #include "ignition/gazebo/components/JointVelocity.hh"
 #include "ignition/gazebo/components/JointVelocityCmd.hh"
@@ -595,6 +596,35 @@ TEST_F(ComponentsTest, JointAxis)
   EXPECT_EQ(comp3.Data().XyzExpressedIn(), "__model__");
 }
 
+/////////////////////////////////////////////////
+TEST_F(ComponentsTest, JointStates)
+{
+  components::JointStatesData data;
+  data.joints = {3, 5};
+  data.offsets = {0, 1, 3};
+  data.positions = {0.1, 0.2, 0.3};
+  data.velocities = {1.1, 1.2, 1.3};
+
+  // Create components
+  auto comp1 = components::JointStates(data);
+  auto comp2 = components::JointStates(data);
+
+  // Equality operators
+  EXPECT_EQ(comp1, comp2);
+  EXPECT_TRUE(comp1 == comp2);
+  EXPECT_FALSE(comp1 != comp2);
+
+  // Stream operators
+  std::ostringstream ostr;
+  comp1.Serialize(ostr);
+  EXPECT_EQ("2 3 3 3 5 0 1 3 0.1 0.2 0.3 1.1 1.2 1.3", ostr.str());
+
+  std::istringstream istr(ostr.str());
+  components::JointStates comp3;
+  comp3.Deserialize(istr);
+  EXPECT_EQ(comp1, comp3);
+}
+
 /////////////////////////////////////////////////
 TEST_F(ComponentsTest, JointType)
 {
@@ -19,6 +19,9 @@
 
 #include <ignition/msgs/contacts.pb.h>
 
+#include <fstream>
+#include <sstream>
+#include <string>
 #include <thread>
 
 #include <ignition/common/Console.hh>
@@ -166,3 +169,69 @@ TEST_F(ContactSystemTest, RemoveContactSensor)
     EXPECT_EQ(0u, contactMsgs.size());
   }
 }
+
+/////////////////////////////////////////////////
+// The test checks that with <publish_on_change>, contacts are only published
+// when they begin or end
+TEST_F(ContactSystemTest, PublishOnChange)
+{
+  // Enable the option on the contact system of the usual world
+  std::ifstream worldFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/contact.sdf");
+  std::stringstream worldStream;
+  worldStream << worldFile.rdbuf();
+  std::string world = worldStream.str();
+
+  const std::string contactPlugin{
+      "name=\"ignition::gazebo::systems::Contact\">"};
+  auto pluginPos = world.find(contactPlugin);
+  ASSERT_NE(std::string::npos, pluginPos);
+  world.insert(pluginPos + contactPlugin.size(),
+      "<publish_on_change>true</publish_on_change>");
+
+  ServerConfig serverConfig;
+  serverConfig.SetSdfString(world);
+
+  Server server(serverConfig);
+
+  std::mutex contactMutex;
+  std::vector<msgs::Contacts> contactMsgs;
+
+  auto contactCb = [&](const msgs::Contacts &_msg) -> void
+  {
+    std::lock_guard<std::mutex> lock(contactMutex);
+    contactMsgs.push_back(_msg);
+  };
+
+  transport::Node node;
+  auto callbackFunc = std::function<void(const msgs::Contacts &)>(contactCb);
+  node.Subscribe("/test_multiple_collisions", callbackFunc);
+
+  // The model falls and comes to rest on the boxes, after which the contacts
+  // aren't republished
+  size_t iters = 1000;
+  server.Run(true, iters, false);
+  {
+    std::lock_guard<std::mutex> lock(contactMutex);
+    ASSERT_GE(contactMsgs.size(), 1u);
+    EXPECT_LT(contactMsgs.size(), iters / 2);
+    EXPECT_EQ(4, contactMsgs.back().contact_size());
+    contactMsgs.clear();
+  }
+
+  server.Run(true, 100, false);
+  {
+    std::lock_guard<std::mutex> lock(contactMutex);
+    EXPECT_EQ(0u, contactMsgs.size());
+  }
+
+  // Removing the boxes ends the contacts, which is published once
+  server.RequestRemoveEntity("box1");
+  server.RequestRemoveEntity("box2");
+  server.Run(true, 10, false);
+  {
+    std::lock_guard<std::mutex> lock(contactMutex);
+    ASSERT_EQ(1u, contactMsgs.size());
+    EXPECT_EQ(0, contactMsgs.back().contact_size());
+  }
+}
@@ -216,4 +216,22 @@ TEST_F(DetachableJointTest, LinksInSameModel)
   // Due integration error, we check that the travelled distance is greater than
   // the expected distance.
   EXPECT_GT(b2Poses.front().Pos().Z() - b2Poses.back().Pos().Z(), expDist);
+
+  b1Poses.clear();
+  b2Poses.clear();
+
+  // The joint of M3 is reused, so attaching again enables it
+  auto attachPub =
+      node.Advertise<msgs::Empty>("/model/M3/detachable_joint/attach");
+  attachPub.Publish(msgs::Empty());
+  std::this_thread::sleep_for(250ms);
+
+  const std::size_t nItersAfterAttach{100};
+  this->server->Run(true, nItersAfterAttach, false);
+
+  ASSERT_EQ(nItersAfterAttach, b2Poses.size());
+
+  // body2 is attached to body1 again. It should stop falling
+  EXPECT_NEAR(b2Poses[nItersAfterAttach / 2].Pos().Z(),
+      b2Poses.back().Pos().Z(), 1e-3);
 }
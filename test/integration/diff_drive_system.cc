@@ -16,6 +16,13 @@
 */
 
 #include <gtest/gtest.h>
+#include <ignition/msgs/pose_v.pb.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/math/Pose3.hh>
 #include <ignition/transport/Node.hh>
@@ -23,6 +30,7 @@
 #include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/TwistCmd.hh"
 #include "ignition/gazebo/Server.hh"
 #include "ignition/gazebo/SystemLoader.hh"
 #include "ignition/gazebo/test_config.hh"
@@ -419,6 +427,182 @@ TEST_P(DiffDriveTest, OdomCustomFrameId)
   EXPECT_EQ(5u, odomPosesCount);
 }
 
+/////////////////////////////////////////////////
+TEST_P(DiffDriveTest, Fleet)
+{
+  // Start server
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/diff_drive_fleet.sdf");
+
+  Server server(serverConfig);
+  EXPECT_FALSE(server.Running());
+  EXPECT_FALSE(*server.Running(0));
+
+  server.SetUpdatePeriod(0ns);
+
+  // Record the vehicle poses
+  test::Relay testSystem;
+  std::map<std::string, std::vector<math::Pose3d>> poses;
+  testSystem.OnPostUpdate([&poses](const gazebo::UpdateInfo &,
+    const gazebo::EntityComponentManager &_ecm)
+    {
+      for (const std::string name : {"vehicle_blue", "vehicle_green"})
+      {
+        auto id = _ecm.EntityByComponents(components::Model(),
+            components::Name(name));
+        EXPECT_NE(kNullEntity, id);
+
+        auto poseComp = _ecm.Component<components::Pose>(id);
+        ASSERT_NE(nullptr, poseComp);
+        poses[name].push_back(poseComp->Data());
+      }
+    });
+  server.AddSystem(testSystem.systemPtr);
+
+  // Both vehicles' odometry comes in a single message
+  std::mutex mutex;
+  std::vector<msgs::Pose_V> odomMsgs;
+  std::function<void(const msgs::Pose_V &)> odomCb =
+    [&](const msgs::Pose_V &_msg)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      odomMsgs.push_back(_msg);
+    };
+
+  transport::Node node;
+  node.Subscribe("/world/diff_drive_fleet/odometry", odomCb);
+  auto pub = node.Advertise<msgs::Twist>("/world/diff_drive_fleet/cmd_vel");
+
+  // Only command the blue vehicle
+  msgs::Twist msg;
+  auto data = msg.mutable_header()->add_data();
+  data->set_key("model");
+  data->add_value("vehicle_blue");
+  msgs::Set(msg.mutable_linear(), math::Vector3d(0.5, 0, 0));
+  msgs::Set(msg.mutable_angular(), math::Vector3d(0.0, 0, 0.2));
+
+  test::Relay commander;
+  commander.OnPreUpdate(
+      [&](const gazebo::UpdateInfo &, const gazebo::EntityComponentManager &)
+      {
+        pub.Publish(msg);
+      });
+  server.AddSystem(commander.systemPtr);
+
+  server.Run(true, 3000, false);
+
+  int sleep = 0;
+  int maxSleep = 30;
+  for (; sleep < maxSleep; ++sleep)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (odomMsgs.size() >= 150)
+        break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_NE(maxSleep, sleep);
+
+  // The blue vehicle moved, the green one didn't
+  const auto &blue = poses["vehicle_blue"];
+  const auto &green = poses["vehicle_green"];
+  ASSERT_EQ(3000u, blue.size());
+  ASSERT_EQ(3000u, green.size());
+  EXPECT_LT(blue.front().Pos().X(), blue.back().Pos().X());
+  EXPECT_LT(blue.front().Rot().Z(), blue.back().Rot().Z());
+  EXPECT_NEAR(green.front().Pos().X(), green.back().Pos().X(), tol);
+  EXPECT_NEAR(green.front().Pos().Y(), green.back().Pos().Y(), tol);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto &last = odomMsgs.back();
+  ASSERT_EQ(2, last.pose_size());
+  for (const auto &pose : last.pose())
+  {
+    if (pose.name() == "vehicle_blue")
+    {
+      EXPECT_LT(0.1, pose.position().x());
+    }
+    else
+    {
+      EXPECT_EQ("vehicle_green", pose.name());
+      EXPECT_NEAR(0.0, pose.position().x(), tol);
+      EXPECT_NEAR(0.0, pose.position().y(), tol);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+// Tests that a command written to the ECM overrides the one received over
+// transport while the TwistCmd component exists
+TEST_P(DiffDriveTest, TwistCmdOverridesTransport)
+{
+  // Start server
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/diff_drive.sdf");
+
+  Server server(serverConfig);
+  EXPECT_FALSE(server.Running());
+  EXPECT_FALSE(*server.Running(0));
+
+  server.SetUpdatePeriod(0ns);
+
+  transport::Node node;
+  auto pub = node.Advertise<msgs::Twist>("/model/vehicle/cmd_vel");
+
+  // Transport turns left, the ECM turns right
+  msgs::Twist transportMsg;
+  msgs::Set(transportMsg.mutable_linear(), math::Vector3d(0.3, 0, 0));
+  msgs::Set(transportMsg.mutable_angular(), math::Vector3d(0, 0, 0.2));
+  msgs::Twist ecmMsg;
+  msgs::Set(ecmMsg.mutable_linear(), math::Vector3d(0.3, 0, 0));
+  msgs::Set(ecmMsg.mutable_angular(), math::Vector3d(0, 0, -0.2));
+
+  bool useEcm{true};
+  std::vector<math::Pose3d> poses;
+  test::Relay testSystem;
+  testSystem.OnPreUpdate(
+      [&](const gazebo::UpdateInfo &, gazebo::EntityComponentManager &_ecm)
+      {
+        pub.Publish(transportMsg);
+
+        auto id = _ecm.EntityByComponents(components::Model(),
+            components::Name("vehicle"));
+        EXPECT_NE(kNullEntity, id);
+
+        auto twistCmd = _ecm.Component<components::TwistCmd>(id);
+        if (useEcm && nullptr == twistCmd)
+          _ecm.CreateComponent(id, components::TwistCmd(ecmMsg));
+        else if (!useEcm && nullptr != twistCmd)
+          _ecm.RemoveComponent<components::TwistCmd>(id);
+      });
+  testSystem.OnPostUpdate([&poses](const gazebo::UpdateInfo &,
+    const gazebo::EntityComponentManager &_ecm)
+    {
+      auto id = _ecm.EntityByComponents(components::Model(),
+          components::Name("vehicle"));
+      auto poseComp = _ecm.Component<components::Pose>(id);
+      ASSERT_NE(nullptr, poseComp);
+      poses.push_back(poseComp->Data());
+    });
+  server.AddSystem(testSystem.systemPtr);
+
+  // The vehicle follows the ECM command, even though transport commands keep
+  // arriving
+  server.Run(true, 2000, false);
+  ASSERT_EQ(2000u, poses.size());
+  EXPECT_LT(poses.front().Pos().X(), poses.back().Pos().X());
+  EXPECT_GT(poses.front().Rot().Yaw() - 0.1, poses.back().Rot().Yaw());
+
+  // Once the component is removed, it follows transport again
+  useEcm = false;
+  server.Run(true, 2000, false);
+  ASSERT_EQ(4000u, poses.size());
+  EXPECT_LT(poses[1999].Rot().Yaw() + 0.1, poses.back().Rot().Yaw());
+}
+
 // Run multiple times
 INSTANTIATE_TEST_SUITE_P(ServerRepeat, DiffDriveTest,
     ::testing::Range(1, 2));
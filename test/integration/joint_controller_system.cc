@@ -23,8 +23,12 @@
 #include <ignition/transport/Node.hh>
 
 #include "ignition/gazebo/components/AngularVelocity.hh"
+#include "ignition/gazebo/components/Joint.hh"
+#include "ignition/gazebo/components/JointVelocityTarget.hh"
 #include "ignition/gazebo/components/Link.hh"
+#include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
 
 #include "ignition/gazebo/Server.hh"
 #include "ignition/gazebo/SystemLoader.hh"
@@ -137,6 +141,97 @@ TEST_F(JointControllerTestFixture, JointVelocityCommand)
   }
 }
 
+/////////////////////////////////////////////////
+// Tests that the JointController accepts joint velocity targets written
+// directly to the ECM by another system
+TEST_F(JointControllerTestFixture, JointVelocityTarget)
+{
+  using namespace std::chrono_literals;
+
+  // Start server
+  ServerConfig serverConfig;
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/joint_controller.sdf";
+  serverConfig.SetSdfFile(sdfFile);
+
+  Server server(serverConfig);
+  EXPECT_FALSE(server.Running());
+  EXPECT_FALSE(*server.Running(0));
+
+  server.SetUpdatePeriod(0ns);
+
+  const std::string linkName = "rotor";
+  const double testAngVel{10.0};
+  bool sendTarget{false};
+
+  test::Relay testSystem;
+  std::vector<math::Vector3d> angularVelocities;
+  testSystem.OnPreUpdate(
+      [&](const gazebo::UpdateInfo &, gazebo::EntityComponentManager &_ecm)
+      {
+        auto link = _ecm.EntityByComponents(components::Link(),
+                                            components::Name(linkName));
+        // Create an AngularVelocity component if it doesn't exist. This signals
+        // physics system to populate the component
+        if (nullptr == _ecm.Component<components::AngularVelocity>(link))
+        {
+          _ecm.CreateComponent(link, components::AngularVelocity());
+        }
+
+        auto model = _ecm.EntityByComponents(components::Model(),
+            components::Name("joint_controller_test"));
+        auto joint = _ecm.EntityByComponents(components::Joint(),
+            components::ParentEntity(model), components::Name("j1"));
+        if (sendTarget &&
+            nullptr == _ecm.Component<components::JointVelocityTarget>(joint))
+        {
+          _ecm.CreateComponent(joint,
+              components::JointVelocityTarget({testAngVel}));
+        }
+      });
+
+  testSystem.OnPostUpdate([&](const gazebo::UpdateInfo &,
+                              const gazebo::EntityComponentManager &_ecm)
+      {
+        _ecm.Each<components::Link, components::Name,
+                  components::AngularVelocity>(
+            [&](const ignition::gazebo::Entity &,
+                const components::Link *,
+                const components::Name *,
+                const components::AngularVelocity *_angularVel) -> bool
+            {
+              angularVelocities.push_back(_angularVel->Data());
+              return true;
+            });
+      });
+
+  server.AddSystem(testSystem.systemPtr);
+
+  const std::size_t initIters = 10;
+  server.Run(true, initIters, false);
+  EXPECT_EQ(initIters, angularVelocities.size());
+  for (const auto &angVel : angularVelocities)
+  {
+    EXPECT_NEAR(0, angVel.Length(), TOL);
+  }
+
+  angularVelocities.clear();
+
+  // The target is written after the controller's PreUpdate, so it's used from
+  // the following step on, without going through transport.
+  sendTarget = true;
+  const std::size_t testIters = 100;
+  server.Run(true, testIters, false);
+
+  ASSERT_EQ(testIters, angularVelocities.size());
+  for (std::size_t i = 1; i < angularVelocities.size(); ++i)
+  {
+    EXPECT_NEAR(0, angularVelocities[i].X(), TOL);
+    EXPECT_NEAR(0, angularVelocities[i].Y(), TOL);
+    EXPECT_NEAR(testAngVel, angularVelocities[i].Z(), TOL);
+  }
+}
+
 /////////////////////////////////////////////////
 // Tests the JointController using joint force commands
 TEST_F(JointControllerTestFixture, JointVelocityCommandWithForce)
@@ -16,6 +16,12 @@
 */
 
 #include <gtest/gtest.h>
+#include <ignition/msgs/model_v.pb.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/transport/Node.hh>
 
@@ -144,3 +150,57 @@ TEST_F(JointStatePublisherTest, LimitedPublisher)
   // Make sure the callback was triggered at least once.
   EXPECT_GT(count, 0);
 }
+
+/////////////////////////////////////////////////
+TEST_F(JointStatePublisherTest, BatchedPublisher)
+{
+  // Start server
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/diff_drive_batched_joint_pub.sdf");
+
+  Server server(serverConfig);
+  EXPECT_FALSE(server.Running());
+  EXPECT_FALSE(*server.Running(0));
+
+  server.SetUpdatePeriod(0ns);
+
+  std::mutex mutex;
+  std::vector<msgs::Model_V> msgs;
+  std::function<void(const msgs::Model_V &)> jointStateCb =
+    [&](const msgs::Model_V &_msg)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      msgs.push_back(_msg);
+    };
+
+  transport::Node node;
+  node.Subscribe("/world/diff_drive/model/vehicle/joint_state", jointStateCb);
+
+  server.Run(true, 10, false);
+
+  // Each message holds 5 steps, each with all the joints and its own stamp
+  for (int sleep = 0; sleep < 30; ++sleep)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (msgs.size() >= 2u)
+        break;
+    }
+    std::this_thread::sleep_for(100ms);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(2u, msgs.size());
+  int64_t lastNsec{-1};
+  for (const auto &msg : msgs)
+  {
+    ASSERT_EQ(5, msg.models_size());
+    for (const auto &model : msg.models())
+    {
+      EXPECT_EQ(3, model.joint_size());
+      EXPECT_GT(model.header().stamp().nsec(), lastNsec);
+      lastNsec = model.header().stamp().nsec();
+    }
+  }
+}
@@ -18,7 +18,9 @@
 #include <gtest/gtest.h>
 
 #include <ignition/msgs/double.pb.h>
+#include <map>
 #include <mutex>
+#include <string>
 
 #include <ignition/common/Console.hh>
 #include <ignition/math/Pose3.hh>
@@ -98,3 +100,48 @@ TEST_F(KineticEnergyMonitorTest, ModelFalling)
   mutex.unlock();
   EXPECT_GT(firstMsg.data(), 2);
 }
+
+/////////////////////////////////////////////////
+// A single monitor attached to the world watches several models
+TEST_F(KineticEnergyMonitorTest, WorldMonitor)
+{
+  ServerConfig serverConfig;
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/kinetic_energy_monitor_world.sdf";
+  serverConfig.SetSdfFile(sdfFile);
+
+  Server server(serverConfig);
+
+  std::mutex countMutex;
+  std::map<std::string, int> msgCounts;
+  transport::Node node;
+  for (const std::string model : {"box1", "box2", "box3"})
+  {
+    std::function<void(const msgs::Double &)> countCb =
+        [&, model](const msgs::Double &_msg)
+        {
+          EXPECT_GT(_msg.data(), 2);
+          std::lock_guard<std::mutex> lock(countMutex);
+          ++msgCounts[model];
+        };
+    node.Subscribe("/model/" + model + "/kinetic_energy", countCb);
+  }
+
+  server.Run(true, 1000u, false);
+
+  // Wait for messages to be received
+  for (int sleep = 0; sleep < 30; ++sleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::lock_guard<std::mutex> lock(countMutex);
+    if (msgCounts["box1"] > 0 && msgCounts["box2"] > 0)
+      break;
+  }
+
+  // Only the listed models are monitored
+  std::lock_guard<std::mutex> lock(countMutex);
+  EXPECT_EQ(1, msgCounts["box1"]);
+  EXPECT_EQ(1, msgCounts["box2"]);
+  EXPECT_EQ(0, msgCounts["box3"]);
+}
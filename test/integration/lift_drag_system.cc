@@ -58,15 +58,14 @@ class LiftDragTestFixture : public ::testing::Test
 
 /////////////////////////////////////////////////
 /// Measure / verify force torques against analytical answers.
-TEST_F(LiftDragTestFixture, VerifyVerticalForce)
+/// \param[in] _sdfFile World to load.
+void verifyVerticalForce(const std::string &_sdfFile)
 {
   using namespace std::chrono_literals;
 
   // Start server
   ServerConfig serverConfig;
-  const auto sdfFile =
-      std::string(PROJECT_SOURCE_PATH) + "/test/worlds/lift_drag.sdf";
-  serverConfig.SetSdfFile(sdfFile);
+  serverConfig.SetSdfFile(_sdfFile);
 
   Server server(serverConfig);
   EXPECT_FALSE(server.Running());
@@ -212,3 +211,18 @@ TEST_F(LiftDragTestFixture, VerifyVerticalForce)
     EXPECT_GT(vertForce, 0);
   }
 }
+
+/////////////////////////////////////////////////
+TEST_F(LiftDragTestFixture, VerifyVerticalForce)
+{
+  verifyVerticalForce(
+      std::string(PROJECT_SOURCE_PATH) + "/test/worlds/lift_drag.sdf");
+}
+
+/////////////////////////////////////////////////
+/// Same as VerifyVerticalForce, with all surfaces in one system
+TEST_F(LiftDragTestFixture, VerifyVerticalForceSurfaces)
+{
+  verifyVerticalForce(
+      std::string(PROJECT_SOURCE_PATH) + "/test/worlds/lift_drag_surfaces.sdf");
+}
@@ -16,6 +16,8 @@
 */
 
 #include <gtest/gtest.h>
+#include <ignition/msgs/boolean.pb.h>
+#include <ignition/msgs/empty.pb.h>
 #include <ignition/msgs/pose_v.pb.h>
 
 #include <algorithm>
@@ -23,7 +25,10 @@
 #ifndef __APPLE__
 #include <filesystem>
 #endif
+#include <fstream>
+#include <limits>
 #include <numeric>
+#include <optional>
 #include <string>
 
 #include <ignition/common/Console.hh>
@@ -317,6 +322,52 @@ TEST_F(LogSystemTest, LogPlaybackStatistics)
   EXPECT_EQ(721000000, endTimePair.second);
 }
 
+/////////////////////////////////////////////////
+TEST_F(LogSystemTest, LogPlaybackBatch)
+{
+  auto logPath = common::joinPaths(PROJECT_SOURCE_PATH, "test", "media",
+      "rolling_shapes_log");
+
+  // The same log twice, the second one starting where the first one ends
+  ServerConfig config;
+  config.SetLogPlaybackPath(logPath);
+  config.AddLogPlaybackPath(logPath);
+
+  Server server(config);
+
+  test::Relay testSystem;
+  std::size_t entityCount{0};
+  std::size_t minEntityCount{std::numeric_limits<std::size_t>::max()};
+  std::chrono::steady_clock::duration simTime{0};
+  testSystem.OnPreUpdate(
+      [&](const UpdateInfo &, EntityComponentManager &_ecm)
+      {
+        minEntityCount = std::min(minEntityCount, _ecm.EntityCount());
+      });
+  testSystem.OnPostUpdate(
+      [&](const UpdateInfo &_info, const EntityComponentManager &_ecm)
+      {
+        simTime = _info.simTime;
+        entityCount = _ecm.EntityCount();
+      });
+
+  server.AddSystem(testSystem.systemPtr);
+  server.Run(true, 1000, false);
+
+  const auto logEntityCount = entityCount;
+  EXPECT_LT(1u, logEntityCount);
+  EXPECT_LT(1u, minEntityCount);
+
+  // The first log ends at 9.721 s
+  server.Run(true, 10000, false);
+  EXPECT_LT(std::chrono::seconds(10), simTime);
+  EXPECT_FALSE(*server.Paused());
+
+  // Only the world was left in between
+  EXPECT_EQ(1u, minEntityCount);
+  EXPECT_EQ(logEntityCount, entityCount);
+}
+
 /////////////////////////////////////////////////
 // Logging behavior when no paths are specified
 TEST_F(LogSystemTest, LogDefaults)
@@ -1689,3 +1740,207 @@ TEST_F(LogSystemTest, LogTopics)
   this->CreateLogsDir();
 #endif
 }
+
+/////////////////////////////////////////////////
+TEST_F(LogSystemTest, LogKeyframes)
+{
+  // Create temp directory to store log
+  this->CreateLogsDir();
+
+  // World with moving entities
+  const auto recordSdfPath = common::joinPaths(
+    std::string(PROJECT_SOURCE_PATH), "test", "worlds",
+    "log_record_dbl_pendulum.sdf");
+
+  // Record with a keyframe every 100 ms of sim time
+  {
+    ServerConfig recordServerConfig;
+    recordServerConfig.SetSdfFile(recordSdfPath);
+    recordServerConfig.SetUseLogRecord(true);
+    recordServerConfig.SetLogRecordPath(this->logDir);
+    recordServerConfig.SetLogRecordKeyframeInterval(
+        std::chrono::milliseconds(100));
+
+    Server recordServer(recordServerConfig);
+    recordServer.Run(true, 500, false);
+  }
+
+  auto logFile = common::joinPaths(this->logDir, "state.tlog");
+  ASSERT_TRUE(common::exists(logFile));
+
+  // Keyframes hold the complete state
+  {
+    transport::log::Log log;
+    ASSERT_TRUE(log.Open(logFile));
+
+    auto batch = log.QueryMessages(transport::log::TopicPattern(
+        std::regex(".*/state_keyframe")));
+    int keyframeCount{0};
+    for (const auto &msg : batch)
+    {
+      EXPECT_EQ("ignition.msgs.SerializedStateMap", msg.Type());
+      msgs::SerializedStateMap stateMsg;
+      stateMsg.ParseFromString(msg.Data());
+      // entity size = 28 in dbl pendulum + 4 in nested model
+      EXPECT_EQ(32, stateMsg.entities_size());
+      ++keyframeCount;
+    }
+    EXPECT_EQ(5, keyframeCount);
+  }
+
+  // Play back, seeking through keyframes
+  ServerConfig playServerConfig;
+  playServerConfig.SetLogPlaybackPath(this->logDir);
+  Server playServer(playServerConfig);
+
+  test::Relay testSystem;
+  std::set<uint64_t> entities;
+  std::chrono::steady_clock::duration simTime{0};
+  testSystem.OnPostUpdate(
+      [&](const UpdateInfo &_info, const EntityComponentManager &_ecm)
+      {
+        simTime = _info.simTime;
+        entities.clear();
+        for (const auto &v : _ecm.Entities().Vertices())
+          entities.insert(v.first);
+      });
+  playServer.AddSystem(testSystem.systemPtr);
+  playServer.Run(true, 10, false);
+
+  auto entitiesAtStart = entities;
+  EXPECT_FALSE(entitiesAtStart.empty());
+
+  transport::Node node;
+  msgs::LogPlaybackControl req;
+  msgs::Boolean res;
+  bool result{false};
+  unsigned int timeout = 1000;
+  std::string service{"/world/default/playback/control"};
+
+  // Seek forward, then backward, both starting from a keyframe
+  for (auto nsec : {400000000, 200000000})
+  {
+    req.mutable_seek()->set_sec(0);
+    req.mutable_seek()->set_nsec(nsec);
+    EXPECT_TRUE(node.Request(service, req, timeout, res, result));
+    EXPECT_TRUE(result);
+    EXPECT_TRUE(res.data());
+
+    // Run 2 iterations because control messages are processed in the end of
+    // an update cycle
+    playServer.Run(true, 2, false);
+    playServer.Run(true, 1, false);
+
+    EXPECT_GE(simTime, std::chrono::nanoseconds(nsec));
+    EXPECT_EQ(entitiesAtStart, entities) << nsec;
+  }
+
+  // Remove artifacts. Recreate new directory
+  this->RemoveLogsDir();
+  this->CreateLogsDir();
+}
+
+/////////////////////////////////////////////////
+TEST_F(LogSystemTest, LogBuffer)
+{
+  // Create temp directory to store log
+  this->CreateLogsDir();
+
+  // Keep the last 200 ms of sim time in memory
+  const auto recordSdfPath = common::joinPaths(
+    std::string(PROJECT_SOURCE_PATH), "test", "worlds",
+    "log_record_dbl_pendulum.sdf");
+  std::ifstream sdfFile(recordSdfPath);
+  std::string sdfString((std::istreambuf_iterator<char>(sdfFile)),
+      std::istreambuf_iterator<char>());
+  const std::string pluginName{
+      "name=\"ignition::gazebo::systems::LogRecord\">"};
+  auto pos = sdfString.find(pluginName);
+  ASSERT_NE(std::string::npos, pos);
+  sdfString.insert(pos + pluginName.size(),
+      "<record_path>" + this->logDir + "</record_path>"
+      "<buffer_duration>0.2</buffer_duration>");
+
+  {
+    // The plugin is loaded from the SDF, so that its buffer options are
+    // kept
+    ServerConfig recordServerConfig;
+    recordServerConfig.SetSdfString(sdfString);
+
+    Server recordServer(recordServerConfig);
+    recordServer.Run(true, 500, false);
+
+    // Nothing is written until flushed
+    EXPECT_FALSE(common::exists(common::joinPaths(this->logDir,
+        "state.tlog")));
+
+    transport::Node node;
+    msgs::Empty req;
+    msgs::Boolean res;
+    bool result{false};
+    EXPECT_TRUE(node.Request("/world/default/record/flush", req, 1000, res,
+        result));
+    EXPECT_TRUE(result);
+    EXPECT_TRUE(res.data());
+
+    // Flushed at the end of the next iteration
+    recordServer.Run(true, 1, false);
+  }
+
+  auto logFile = common::joinPaths(this->logDir, "flush_0", "state.tlog");
+  ASSERT_TRUE(common::exists(logFile));
+
+  // Only the last buffer duration is kept, starting with a keyframe
+  {
+    transport::log::Log log;
+    ASSERT_TRUE(log.Open(logFile));
+
+    int keyframeCount{0};
+    std::optional<std::chrono::nanoseconds> firstState;
+    for (const auto &msg : log.QueryMessages())
+    {
+      if (msg.Type() != "ignition.msgs.SerializedStateMap")
+        continue;
+
+      const bool keyframe =
+          msg.Topic().find("/state_keyframe") != std::string::npos;
+      if (!firstState)
+      {
+        firstState = msg.TimeReceived();
+        ASSERT_TRUE(keyframe);
+
+        // entity size = 28 in dbl pendulum + 4 in nested model
+        msgs::SerializedStateMap stateMsg;
+        stateMsg.ParseFromString(msg.Data());
+        EXPECT_EQ(32, stateMsg.entities_size());
+      }
+      if (keyframe)
+        ++keyframeCount;
+      EXPECT_GE(msg.TimeReceived(), std::chrono::milliseconds(100));
+    }
+    EXPECT_GE(keyframeCount, 1);
+    EXPECT_LE(keyframeCount, 2);
+    ASSERT_TRUE(firstState.has_value());
+    EXPECT_LE(*firstState, std::chrono::milliseconds(301));
+  }
+
+  // The flushed log can be played back
+  ServerConfig playServerConfig;
+  playServerConfig.SetLogPlaybackPath(common::parentPath(logFile));
+  Server playServer(playServerConfig);
+
+  test::Relay testSystem;
+  std::size_t entityCount{0};
+  testSystem.OnPostUpdate(
+      [&](const UpdateInfo &, const EntityComponentManager &_ecm)
+      {
+        entityCount = _ecm.EntityCount();
+      });
+  playServer.AddSystem(testSystem.systemPtr);
+  playServer.Run(true, 10, false);
+  EXPECT_GT(entityCount, 0u);
+
+  // Remove artifacts. Recreate new directory
+  this->RemoveLogsDir();
+  this->CreateLogsDir();
+}
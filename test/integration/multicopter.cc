@@ -66,73 +66,92 @@ class MulticopterTest : public ::testing::Test
     server->SetUpdatePeriod(1ns);
     return server;
   }
-};
-
-/////////////////////////////////////////////////
-// Test that commanded motor speed is applied
-TEST_F(MulticopterTest, CommandedMotorSpeed)
-{
-  // Start server
-  auto server = this->StartServer("/test/worlds/quadcopter.sdf");
 
-  test::Relay testSystem;
-  transport::Node node;
-  auto cmdMotorSpeed =
-      node.Advertise<msgs::Actuators>("/X3/gazebo/command/motor_speed");
-
-  const std::size_t iterTestStart{100};
-  const std::size_t nIters{500};
-  testSystem.OnPreUpdate(
-      [&](const gazebo::UpdateInfo &_info, gazebo::EntityComponentManager &_ecm)
-      {
-        // Create components, if the don't exist, on the first iteration
-        if (_info.iterations == 1)
+  /// \brief Command a motor speed and check that every rotor reaches it.
+  /// \param[in] _filePath Path of the world, relative to the source tree.
+  protected: void CheckCommandedMotorSpeed(const std::string &_filePath)
+  {
+    // Start server
+    auto server = this->StartServer(_filePath);
+
+    test::Relay testSystem;
+    transport::Node node;
+    auto cmdMotorSpeed =
+        node.Advertise<msgs::Actuators>("/X3/gazebo/command/motor_speed");
+
+    const std::size_t iterTestStart{100};
+    const std::size_t nIters{500};
+    testSystem.OnPreUpdate(
+        [&](const gazebo::UpdateInfo &_info,
+            gazebo::EntityComponentManager &_ecm)
         {
-          for (const auto &e : _ecm.EntitiesByComponents(components::Joint()))
+          // Create components, if the don't exist, on the first iteration
+          if (_info.iterations == 1)
           {
-            if (!_ecm.Component<components::JointVelocity>(e))
+            for (const auto &e :
+                _ecm.EntitiesByComponents(components::Joint()))
             {
-              _ecm.CreateComponent(e, components::JointVelocity());
+              if (!_ecm.Component<components::JointVelocity>(e))
+              {
+                _ecm.CreateComponent(e, components::JointVelocity());
+              }
             }
           }
-        }
-      });
+        });
 
-  testSystem.OnPostUpdate(
-      [&](const gazebo::UpdateInfo &_info,
-          const gazebo::EntityComponentManager &_ecm)
-      {
-        // Command a motor speed
-        // After nIters iterations, check angular velocity of each of the rotors
-        const double cmdSpeed{100};
-        if (_info.iterations == iterTestStart)
-        {
-          msgs::Actuators msg;
-          msg.mutable_velocity()->Resize(4, cmdSpeed);
-          cmdMotorSpeed.Publish(msg);
-        }
-        else if (_info.iterations == iterTestStart + nIters)
+    testSystem.OnPostUpdate(
+        [&](const gazebo::UpdateInfo &_info,
+            const gazebo::EntityComponentManager &_ecm)
         {
-          int count = 0;
-          // Check that each rotor's velocity matches the commanded value
-          for (const auto &e : _ecm.EntitiesByComponents(components::Joint()))
+          // Command a motor speed
+          // After nIters iterations, check angular velocity of each of the
+          // rotors
+          const double cmdSpeed{100};
+          if (_info.iterations == iterTestStart)
+          {
+            msgs::Actuators msg;
+            msg.mutable_velocity()->Resize(4, cmdSpeed);
+            cmdMotorSpeed.Publish(msg);
+          }
+          else if (_info.iterations == iterTestStart + nIters)
           {
-            auto *jointVel = _ecm.Component<components::JointVelocity>(e);
-            EXPECT_NE(nullptr, jointVel);
-            EXPECT_FALSE(jointVel->Data().empty());
-            if (jointVel->Data().size() > 0)
+            int count = 0;
+            // Check that each rotor's velocity matches the commanded value
+            for (const auto &e :
+                _ecm.EntitiesByComponents(components::Joint()))
             {
-              ++count;
-              EXPECT_NEAR(cmdSpeed, std::abs(jointVel->Data()[0]), 1e-2);
+              auto *jointVel = _ecm.Component<components::JointVelocity>(e);
+              EXPECT_NE(nullptr, jointVel);
+              EXPECT_FALSE(jointVel->Data().empty());
+              if (jointVel->Data().size() > 0)
+              {
+                ++count;
+                EXPECT_NEAR(cmdSpeed, std::abs(jointVel->Data()[0]), 1e-2);
+              }
             }
+
+            EXPECT_EQ(4, count);
           }
+        });
 
-          EXPECT_EQ(4, count);
-        }
-      });
+    server->AddSystem(testSystem.systemPtr);
+    server->Run(true, iterTestStart + nIters, false);
+  }
+};
 
-  server->AddSystem(testSystem.systemPtr);
-  server->Run(true, iterTestStart + nIters, false);
+/////////////////////////////////////////////////
+// Test that commanded motor speed is applied
+TEST_F(MulticopterTest, CommandedMotorSpeed)
+{
+  this->CheckCommandedMotorSpeed("/test/worlds/quadcopter.sdf");
+}
+
+/////////////////////////////////////////////////
+// Test that commanded motor speed is applied when a single system handles
+// all rotors
+TEST_F(MulticopterTest, CommandedMotorSpeedRotors)
+{
+  this->CheckCommandedMotorSpeed("/test/worlds/quadcopter_rotors.sdf");
 }
 
 /////////////////////////////////////////////////
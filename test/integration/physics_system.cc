@@ -18,6 +18,9 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
 #include <vector>
 
 #include <ignition/common/Console.hh>
@@ -34,6 +37,7 @@
 #include "ignition/gazebo/SystemLoader.hh"
 #include "ignition/gazebo/test_config.hh"  // NOLINT(build/include)
 
+#include "ignition/gazebo/components/AtRest.hh"
 #include "ignition/gazebo/components/AxisAlignedBox.hh"
 #include "ignition/gazebo/components/CanonicalLink.hh"
 #include "ignition/gazebo/components/Collision.hh"
@@ -159,6 +163,127 @@ TEST_F(PhysicsSystemFixture, FallingObject)
   EXPECT_NEAR(spherePoses.back().Pos().Z(), zStopped, 5e-2);
 }
 
+/////////////////////////////////////////////////
+TEST_F(PhysicsSystemFixture, Substeps)
+{
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/falling.sdf";
+
+  sdf::Root root;
+  root.Load(sdfFile);
+  const sdf::World *world = root.WorldByIndex(0);
+  const sdf::Model *model = world->ModelByIndex(0);
+
+  // Take 10 engine steps per iteration
+  std::ifstream file(sdfFile);
+  std::string sdfString((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  const std::string pluginName = "name=\"ignition::gazebo::systems::Physics\">";
+  auto pos = sdfString.find(pluginName);
+  ASSERT_NE(std::string::npos, pos);
+  sdfString.insert(pos + pluginName.size(), "<substeps>10</substeps>");
+
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfString(sdfString);
+
+  gazebo::Server server(serverConfig);
+  server.SetUpdatePeriod(1us);
+
+  const std::string modelName = "sphere";
+  std::vector<ignition::math::Pose3d> spherePoses;
+  std::chrono::steady_clock::duration simTime{0};
+
+  // Create a system that records the poses of the sphere
+  test::Relay testSystem;
+
+  testSystem.OnPostUpdate(
+    [&](const gazebo::UpdateInfo &_info,
+    const gazebo::EntityComponentManager &_ecm)
+    {
+      simTime = _info.simTime;
+      _ecm.Each<components::Model, components::Name, components::Pose>(
+        [&](const ignition::gazebo::Entity &, const components::Model *,
+        const components::Name *_name, const components::Pose *_pose)->bool
+        {
+          if (_name->Data() == modelName) {
+            spherePoses.push_back(_pose->Data());
+          }
+          return true;
+        });
+    });
+
+  server.AddSystem(testSystem.systemPtr);
+  const size_t iters = 10;
+  server.Run(true, iters, false);
+
+  // Other systems still run once per iteration
+  const double dt = 0.001;
+  EXPECT_EQ(iters, spherePoses.size());
+  EXPECT_EQ(std::chrono::milliseconds(iters), simTime);
+
+  // Smaller engine steps track the analytical solution more closely than
+  // the 2e-4 tolerance of the FallingObject test
+  const double grav = world->Gravity().Z();
+  const double zInit = model->RawPose().Pos().Z();
+  const double zExpected = zInit + 0.5 * grav * pow(iters * dt, 2);
+  ASSERT_FALSE(spherePoses.empty());
+  EXPECT_NEAR(spherePoses.back().Pos().Z(), zExpected, 2e-5);
+}
+
+/////////////////////////////////////////////////
+TEST_F(PhysicsSystemFixture, AtRest)
+{
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/falling.sdf";
+
+  // Mark models at rest after 10 still steps
+  std::ifstream file(sdfFile);
+  std::string sdfString((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  const std::string pluginName = "name=\"ignition::gazebo::systems::Physics\">";
+  auto pos = sdfString.find(pluginName);
+  ASSERT_NE(std::string::npos, pos);
+  sdfString.insert(pos + pluginName.size(), "<rest_steps>10</rest_steps>");
+
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfString(sdfString);
+
+  gazebo::Server server(serverConfig);
+  server.SetUpdatePeriod(1us);
+
+  bool sphereAtRest{false};
+  std::size_t movingModels{0};
+  test::Relay testSystem;
+  testSystem.OnPostUpdate(
+    [&](const gazebo::UpdateInfo &,
+    const gazebo::EntityComponentManager &_ecm)
+    {
+      auto sphere = _ecm.EntityByComponents(components::Model(),
+          components::Name("sphere"));
+      sphereAtRest = _ecm.EntityHasComponentType(sphere,
+          components::AtRest::typeId);
+
+      movingModels = 0;
+      _ecm.Each<components::Model, Without<components::AtRest>>(
+        [&](const ignition::gazebo::Entity &, const components::Model *)->bool
+        {
+          ++movingModels;
+          return true;
+        });
+    });
+  server.AddSystem(testSystem.systemPtr);
+
+  // The sphere is falling
+  server.Run(true, 100, false);
+  EXPECT_FALSE(sphereAtRest);
+  EXPECT_EQ(2u, movingModels);
+
+  // It lands on the static box and stops. Static models are never marked.
+  server.Run(true, 2000, false);
+  EXPECT_TRUE(sphereAtRest);
+  EXPECT_EQ(1u, movingModels);
+}
+
 /////////////////////////////////////////////////
 // This tests whether links with fixed joints keep their relative transforms
 // after physics. For that to work properly, the canonical link implementation
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <thread>
+
+#include <ignition/msgs/int32.pb.h>
+#include <ignition/msgs/pose.pb.h>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/msgs/Utility.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/test_config.hh"
+
+#include "../helpers/Relay.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace std::chrono_literals;
+
+/// \brief Test RemoteView system
+class RemoteViewTest : public ::testing::Test
+{
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    common::Console::SetVerbosity(4);
+    setenv("IGN_GAZEBO_SYSTEM_PLUGIN_PATH",
+           (std::string(PROJECT_BINARY_PATH) + "/lib").c_str(), 1);
+  }
+};
+
+/////////////////////////////////////////////////
+/// \brief Run the server until the viewer's pose changes.
+/// \param[in] _server Server to run.
+/// \param[in] _pose Latest pose of the viewer, updated by a system.
+/// \return True if the pose changed.
+bool runUntilMoved(Server &_server, const math::Pose3d &_pose)
+{
+  const auto initialPose = _pose;
+  for (int sleep = 0; sleep < 30; ++sleep)
+  {
+    std::this_thread::sleep_for(100ms);
+    _server.Run(true, 1, false);
+    if (_pose != initialPose)
+      return true;
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+TEST_F(RemoteViewTest, KeysAndPose)
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/remote_view.sdf");
+
+  Server server(serverConfig);
+
+  math::Pose3d pose;
+  test::Relay testSystem;
+  testSystem.OnPostUpdate([&pose](const UpdateInfo &,
+      const EntityComponentManager &_ecm)
+      {
+        auto id = _ecm.EntityByComponents(components::Model(),
+            components::Name("viewer"));
+        ASSERT_NE(kNullEntity, id);
+
+        auto poseComp = _ecm.Component<components::Pose>(id);
+        ASSERT_NE(nullptr, poseComp);
+        pose = poseComp->Data();
+      });
+  server.AddSystem(testSystem.systemPtr);
+
+  server.Run(true, 10, false);
+  EXPECT_EQ(math::Pose3d(0, 0, 1, 0, 0, 0), pose);
+
+  transport::Node node;
+  auto keyPub = node.Advertise<msgs::Int32>("/test/keypress");
+  auto posePub = node.Advertise<msgs::Pose>(
+      "/model/viewer/remote_view/pose");
+
+  // Unknown keys don't move the viewer
+  msgs::Int32 keyMsg;
+  keyMsg.set_data(0x58);
+  keyPub.Publish(keyMsg);
+  server.Run(true, 10, false);
+  EXPECT_EQ(math::Pose3d(0, 0, 1, 0, 0, 0), pose);
+
+  // W moves forward along the view direction
+  keyMsg.set_data(0x57);
+  keyPub.Publish(keyMsg);
+  ASSERT_TRUE(runUntilMoved(server, pose));
+  EXPECT_EQ(math::Pose3d(0.5, 0, 1, 0, 0, 0), pose);
+
+  // Left arrow turns left, then W moves along the new direction
+  keyMsg.set_data(0x01000012);
+  keyPub.Publish(keyMsg);
+  ASSERT_TRUE(runUntilMoved(server, pose));
+  EXPECT_NEAR(0.1, pose.Rot().Yaw(), 1e-6);
+
+  keyMsg.set_data(0x57);
+  keyPub.Publish(keyMsg);
+  ASSERT_TRUE(runUntilMoved(server, pose));
+  EXPECT_NEAR(0.5 + 0.5 * cos(0.1), pose.Pos().X(), 1e-6);
+  EXPECT_NEAR(0.5 * sin(0.1), pose.Pos().Y(), 1e-6);
+  EXPECT_NEAR(1.0, pose.Pos().Z(), 1e-6);
+
+  // Poses place the viewer directly
+  math::Pose3d target(1, 2, 3, 0, 0.2, 0.3);
+  posePub.Publish(msgs::Convert(target));
+  ASSERT_TRUE(runUntilMoved(server, pose));
+  EXPECT_EQ(target, pose);
+}
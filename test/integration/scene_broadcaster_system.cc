@@ -18,9 +18,19 @@
 #include <gtest/gtest.h>
 #include <google/protobuf/util/message_differencer.h>
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include <ignition/common/Console.hh>
+#include <ignition/msgs/boolean.pb.h>
+#include <ignition/msgs/param.pb.h>
+#include <ignition/msgs/uint32_v.pb.h>
+#include <ignition/msgs/Utility.hh>
 #include <ignition/transport/Node.hh>
 
 #include "ignition/gazebo/Server.hh"
@@ -90,6 +100,127 @@ TEST_P(SceneBroadcasterTest, PoseInfo)
   EXPECT_TRUE(received);
 }
 
+/////////////////////////////////////////////////
+TEST_P(SceneBroadcasterTest, CompactPose)
+{
+  // Start server
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/shapes.sdf");
+
+  gazebo::Server server(serverConfig);
+  EXPECT_EQ(16u, *server.EntityCount());
+
+  transport::Node node;
+
+  bool received{false};
+  std::function<void(const msgs::UInt32_V &)> cb =
+      [&](const msgs::UInt32_V &_msg)
+  {
+    if (received)
+      return;
+
+    std::map<std::string, std::string> header;
+    for (const auto &data : _msg.header().data())
+      header[data.key()] = data.value(0);
+
+    // The first message to a new subscriber is a keyframe
+    EXPECT_EQ("1", header["keyframe"]);
+    const double resolution = std::stod(header["resolution"]);
+    EXPECT_DOUBLE_EQ(0.001, resolution);
+
+    // ID, position and rotation of the same entities as pose/info
+    ASSERT_EQ(50, _msg.data_size());
+
+    // Keyframes have absolute positions, look for the box
+    bool foundBox{false};
+    for (int i = 0; i < _msg.data_size(); i += 5)
+    {
+      math::Vector3d pos;
+      for (int j = 0; j < 3; ++j)
+      {
+        const uint32_t value = _msg.data(i + 1 + j);
+        const int32_t steps = static_cast<int32_t>(value >> 1) ^
+            -static_cast<int32_t>(value & 1);
+        pos[j] = steps * resolution;
+      }
+      if (pos == math::Vector3d(1, 2, 3))
+        foundBox = true;
+    }
+    EXPECT_TRUE(foundBox);
+
+    received = true;
+  };
+  EXPECT_TRUE(node.Subscribe("/world/default/pose/compact", cb));
+
+  unsigned int sleep{0u};
+  unsigned int maxSleep{10u};
+  // cppcheck-suppress unmatchedSuppression
+  // cppcheck-suppress knownConditionTrueFalse
+  while (!received && sleep++ < maxSleep)
+  {
+    server.Run(true, 1, false);
+    IGN_SLEEP_MS(100);
+  }
+
+  EXPECT_TRUE(received);
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneBroadcasterTest, PoseThreshold)
+{
+  // Start server
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/pose_threshold.sdf");
+
+  gazebo::Server server(serverConfig);
+  transport::Node node;
+
+  // Names of the poses in each dynamic pose message
+  std::mutex mutex;
+  std::vector<std::multiset<std::string>> received;
+  std::function<void(const msgs::Pose_V &)> cb = [&](const msgs::Pose_V &_msg)
+  {
+    std::multiset<std::string> names;
+    for (const auto &pose : _msg.pose())
+      names.insert(pose.name());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    received.push_back(names);
+  };
+  EXPECT_TRUE(node.Subscribe("/world/pose_threshold/dynamic_pose/info", cb));
+
+  unsigned int sleep{0u};
+  unsigned int maxSleep{30u};
+  while (sleep++ < maxSleep)
+  {
+    server.Run(true, 10, false);
+    IGN_SLEEP_MS(50);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (received.size() >= 3)
+      break;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_LE(3u, received.size());
+
+  // The first message has all dynamic poses
+  EXPECT_EQ(1u, received[0].count("filtered"));
+  EXPECT_EQ(1u, received[0].count("unfiltered"));
+  EXPECT_EQ(2u, received[0].count("link"));
+
+  // The filtered model fell less than its threshold, so it's left out
+  // afterwards, while the other model is always published
+  for (std::size_t i = 1; i < received.size(); ++i)
+  {
+    EXPECT_EQ(0u, received[i].count("filtered")) << i;
+    EXPECT_EQ(1u, received[i].count("unfiltered")) << i;
+    EXPECT_EQ(1u, received[i].count("link")) << i;
+  }
+}
+
 /////////////////////////////////////////////////
 TEST_P(SceneBroadcasterTest, SceneInfo)
 {
@@ -460,6 +591,108 @@ TEST_P(SceneBroadcasterTest, State)
   EXPECT_TRUE(received);
 }
 
+/////////////////////////////////////////////////
+TEST_P(SceneBroadcasterTest, CompressedState)
+{
+  // Start server
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/shapes.sdf");
+
+  gazebo::Server server(serverConfig);
+  transport::Node node;
+
+  // Compressed messages hold the uncompressed size followed by the zlib
+  // stream
+  std::atomic<int> received{0};
+  std::function<void(const char *, const size_t,
+      const transport::MessageInfo &)> cb =
+      [&](const char *_data, const size_t _size,
+          const transport::MessageInfo &_info)
+  {
+    EXPECT_EQ("ignition.msgs.SerializedStepMap+zlib", _info.Type());
+    ASSERT_LT(4u, _size);
+
+    uint32_t size{0};
+    for (int i = 0; i < 4; ++i)
+    {
+      size |= static_cast<uint32_t>(
+          static_cast<unsigned char>(_data[i])) << (8 * i);
+    }
+    EXPECT_LT(0u, size);
+    received++;
+  };
+  EXPECT_TRUE(node.SubscribeRaw("/world/default/state/compressed", cb,
+      "ignition.msgs.SerializedStepMap+zlib"));
+
+  unsigned int sleep{0u};
+  unsigned int maxSleep{30u};
+  while (received < 2 && sleep++ < maxSleep)
+  {
+    server.Run(true, 100, false);
+    IGN_SLEEP_MS(100);
+  }
+  EXPECT_LE(2, received);
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneBroadcasterTest, StateInterest)
+{
+  // Start server
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/shapes.sdf");
+
+  gazebo::Server server(serverConfig);
+  EXPECT_EQ(16u, *server.EntityCount());
+  transport::Node node;
+
+  // Run server so the services are advertised
+  server.Run(true, 1, false);
+
+  // Only the sphere is close to the origin
+  msgs::Param req;
+  (*req.mutable_params())["topic"].set_string_value("interest_test");
+  (*req.mutable_params())["radius"].set_double_value(1.5);
+  msgs::Set((*req.mutable_params())["center"].mutable_vector3d_value(),
+      math::Vector3d::Zero);
+
+  msgs::Boolean res;
+  bool result{false};
+  EXPECT_TRUE(node.Request("/world/default/state/interest", req, 5000, res,
+      result));
+  EXPECT_TRUE(result);
+  EXPECT_TRUE(res.data());
+
+  bool received{false};
+  std::function<void(const msgs::SerializedStepMap &)> cb =
+      [&](const msgs::SerializedStepMap &_msg)
+  {
+    // World and sphere model, link, collision and visual
+    EXPECT_EQ(5, _msg.state().entities_size());
+    received = true;
+  };
+  EXPECT_TRUE(node.Subscribe("/world/default/interest_test", cb));
+
+  unsigned int sleep{0u};
+  unsigned int maxSleep{10u};
+  // cppcheck-suppress unmatchedSuppression
+  // cppcheck-suppress knownConditionTrueFalse
+  while (!received && sleep++ < maxSleep)
+  {
+    server.Run(true, 1, false);
+    IGN_SLEEP_MS(100);
+  }
+  EXPECT_TRUE(received);
+
+  // Without entities nor region, the interest is removed
+  req.mutable_params()->erase("radius");
+  EXPECT_TRUE(node.Request("/world/default/state/interest", req, 5000, res,
+      result));
+  EXPECT_TRUE(result);
+  EXPECT_TRUE(res.data());
+}
+
 /////////////////////////////////////////////////
 TEST_P(SceneBroadcasterTest, StateStatic)
 {
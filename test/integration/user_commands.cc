@@ -18,7 +18,9 @@
 #include <gtest/gtest.h>
 
 #include <ignition/msgs/entity_factory.pb.h>
+#include <ignition/msgs/entity_factory_v.pb.h>
 #include <ignition/msgs/light.pb.h>
+#include <ignition/msgs/pose_v.pb.h>
 
 #include <ignition/common/Console.hh>
 #include <ignition/math/Pose3.hh>
@@ -333,6 +335,100 @@ TEST_F(UserCommandsTest, Create)
       components::Name("test_model")));
 }
 
+/////////////////////////////////////////////////
+TEST_F(UserCommandsTest, CreateMultiple)
+{
+  // Start server
+  ServerConfig serverConfig;
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/examples/worlds/empty.sdf";
+  serverConfig.SetSdfFile(sdfFile);
+
+  Server server(serverConfig);
+  EXPECT_FALSE(server.Running());
+  EXPECT_FALSE(*server.Running(0));
+
+  // Create a system just to get the ECM
+  EntityComponentManager *ecm{nullptr};
+  test::Relay testSystem;
+  testSystem.OnPreUpdate([&](const gazebo::UpdateInfo &,
+                             gazebo::EntityComponentManager &_ecm)
+      {
+        ecm = &_ecm;
+      });
+
+  server.AddSystem(testSystem.systemPtr);
+
+  // Run server and check we have the ECM
+  EXPECT_EQ(nullptr, ecm);
+  server.Run(true, 1, false);
+  EXPECT_NE(nullptr, ecm);
+
+  auto entityCount = ecm->EntityCount();
+
+  auto modelStr = std::string("<?xml version=\"1.0\" ?>") +
+      "<sdf version='1.6'>" +
+      "<model name='spawned_model'>" +
+      "<link name='link'>" +
+      "<visual name='visual'>" +
+      "<geometry><sphere><radius>1.0</radius></sphere></geometry>" +
+      "</visual>" +
+      "</link>" +
+      "</model>" +
+      "</sdf>";
+
+  auto badStr = std::string("<?xml version='1.0' ?>") +
+      "<sdf version='1.6'>" +
+      "</sdfo>";
+
+  // Many copies of the same model, which get unique names, and a malformed
+  // SDF which is skipped
+  const int count = 20;
+  msgs::EntityFactory_V req;
+  for (int i = 0; i < count; ++i)
+  {
+    auto data = req.add_data();
+    data->set_sdf(modelStr);
+    data->set_allow_renaming(true);
+    data->mutable_pose()->mutable_position()->set_x(i);
+  }
+  req.add_data()->set_sdf(badStr);
+
+  msgs::Boolean res;
+  bool result;
+  unsigned int timeout = 5000;
+  std::string service{"/world/empty/create_multiple"};
+
+  transport::Node node;
+  EXPECT_TRUE(node.Request(service, req, timeout, res, result));
+  EXPECT_TRUE(result);
+  EXPECT_TRUE(res.data());
+
+  // Run an iteration and check all models were created with their poses
+  server.Run(true, 1, false);
+
+  // 3 entities per model: model, link and visual
+  EXPECT_EQ(entityCount + count * 3, ecm->EntityCount());
+
+  auto model = ecm->EntityByComponents(components::Model(),
+      components::Name("spawned_model"));
+  ASSERT_NE(kNullEntity, model);
+  EXPECT_EQ(math::Pose3d::Zero,
+      ecm->Component<components::Pose>(model)->Data());
+
+  for (int i = 0; i < count - 1; ++i)
+  {
+    auto name = "spawned_model_" + std::to_string(i);
+    model = ecm->EntityByComponents(components::Model(),
+        components::Name(name));
+    ASSERT_NE(kNullEntity, model) << name;
+
+    auto poseComp = ecm->Component<components::Pose>(model);
+    ASSERT_NE(nullptr, poseComp);
+    EXPECT_DOUBLE_EQ(i + 1.0, poseComp->Data().Pos().X());
+  }
+}
+
 /////////////////////////////////////////////////
 TEST_F(UserCommandsTest, Remove)
 {
@@ -694,6 +790,73 @@ TEST_F(UserCommandsTest, Pose)
   EXPECT_NEAR(500.0, poseComp->Data().Pos().Y(), 0.2);
 }
 
+/////////////////////////////////////////////////
+TEST_F(UserCommandsTest, PoseEdit)
+{
+  // Start server
+  ServerConfig serverConfig;
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/shapes.sdf";
+  serverConfig.SetSdfFile(sdfFile);
+
+  Server server(serverConfig);
+
+  // Create a system just to get the ECM
+  EntityComponentManager *ecm{nullptr};
+  test::Relay testSystem;
+  testSystem.OnPreUpdate([&](const gazebo::UpdateInfo &,
+                             gazebo::EntityComponentManager &_ecm)
+      {
+        ecm = &_ecm;
+      });
+
+  server.AddSystem(testSystem.systemPtr);
+  server.Run(true, 1, false);
+  ASSERT_NE(nullptr, ecm);
+
+  auto boxEntity = ecm->EntityByComponents(components::Name("box"));
+  ASSERT_NE(kNullEntity, boxEntity);
+  auto sphereEntity = ecm->EntityByComponents(components::Name("sphere"));
+  ASSERT_NE(kNullEntity, sphereEntity);
+
+  transport::Node node;
+  auto pub = node.Advertise<msgs::Pose_V>("/world/default/pose_edit");
+
+  // Several poses of the box in one message and across messages, the
+  // latest one is applied
+  msgs::Pose_V msg;
+  auto pose = msg.add_pose();
+  pose->set_name("box");
+  pose->mutable_position()->set_y(10.0);
+  pose = msg.add_pose();
+  pose->set_id(sphereEntity);
+  pose->mutable_position()->set_y(30.0);
+  pose = msg.add_pose();
+  pose->set_name("box");
+  pose->mutable_position()->set_y(20.0);
+
+  // Wait for the subscriber to be discovered
+  int sleep = 0;
+  while (!pub.HasConnections() && sleep++ < 100)
+    IGN_SLEEP_MS(10);
+  ASSERT_TRUE(pub.HasConnections());
+
+  EXPECT_TRUE(pub.Publish(msg));
+  msg.mutable_pose(2)->mutable_position()->set_y(40.0);
+  EXPECT_TRUE(pub.Publish(msg));
+  IGN_SLEEP_MS(100);
+
+  server.Run(true, 1, false);
+
+  auto poseComp = ecm->Component<components::Pose>(boxEntity);
+  ASSERT_NE(nullptr, poseComp);
+  EXPECT_NEAR(40.0, poseComp->Data().Pos().Y(), 0.2);
+
+  poseComp = ecm->Component<components::Pose>(sphereEntity);
+  ASSERT_NE(nullptr, poseComp);
+  EXPECT_NEAR(30.0, poseComp->Data().Pos().Y(), 0.2);
+}
+
 /////////////////////////////////////////////////
 TEST_F(UserCommandsTest, Light)
 {
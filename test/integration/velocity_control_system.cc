@@ -23,6 +23,7 @@
 #include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/TwistCmd.hh"
 #include "ignition/gazebo/Server.hh"
 #include "ignition/gazebo/SystemLoader.hh"
 #include "ignition/gazebo/test_config.hh"
@@ -145,6 +146,76 @@ TEST_P(VelocityControlTest, PublishCmd)
       "/model/vehicle_blue/cmd_vel");
 }
 
+/////////////////////////////////////////////////
+// Tests that a command written to the ECM overrides the one received over
+// transport while the TwistCmd component exists
+TEST_P(VelocityControlTest, TwistCmdOverridesTransport)
+{
+  // Start server
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/velocity_control.sdf");
+
+  Server server(serverConfig);
+  EXPECT_FALSE(server.Running());
+  EXPECT_FALSE(*server.Running(0));
+
+  server.SetUpdatePeriod(0ns);
+
+  transport::Node node;
+  auto pub = node.Advertise<msgs::Twist>("/model/vehicle_blue/cmd_vel");
+
+  // Transport turns left, the ECM turns right
+  msgs::Twist transportMsg;
+  msgs::Set(transportMsg.mutable_linear(), math::Vector3d(0.5, 0, 0));
+  msgs::Set(transportMsg.mutable_angular(), math::Vector3d(0, 0, 0.2));
+  msgs::Twist ecmMsg;
+  msgs::Set(ecmMsg.mutable_linear(), math::Vector3d(0.5, 0, 0));
+  msgs::Set(ecmMsg.mutable_angular(), math::Vector3d(0, 0, -0.2));
+
+  bool useEcm{true};
+  std::vector<math::Pose3d> poses;
+  test::Relay testSystem;
+  testSystem.OnPreUpdate(
+      [&](const gazebo::UpdateInfo &, gazebo::EntityComponentManager &_ecm)
+      {
+        pub.Publish(transportMsg);
+
+        auto id = _ecm.EntityByComponents(components::Model(),
+            components::Name("vehicle_blue"));
+        EXPECT_NE(kNullEntity, id);
+
+        auto twistCmd = _ecm.Component<components::TwistCmd>(id);
+        if (useEcm && nullptr == twistCmd)
+          _ecm.CreateComponent(id, components::TwistCmd(ecmMsg));
+        else if (!useEcm && nullptr != twistCmd)
+          _ecm.RemoveComponent<components::TwistCmd>(id);
+      });
+  testSystem.OnPostUpdate([&poses](const gazebo::UpdateInfo &,
+    const gazebo::EntityComponentManager &_ecm)
+    {
+      auto id = _ecm.EntityByComponents(components::Model(),
+          components::Name("vehicle_blue"));
+      auto poseComp = _ecm.Component<components::Pose>(id);
+      ASSERT_NE(nullptr, poseComp);
+      poses.push_back(poseComp->Data());
+    });
+  server.AddSystem(testSystem.systemPtr);
+
+  // The vehicle follows the ECM command, even though transport commands keep
+  // arriving
+  server.Run(true, 2000, false);
+  ASSERT_EQ(2000u, poses.size());
+  EXPECT_LT(poses.front().Pos().X(), poses.back().Pos().X());
+  EXPECT_GT(poses.front().Rot().Yaw() - 0.1, poses.back().Rot().Yaw());
+
+  // Once the component is removed, it follows transport again
+  useEcm = false;
+  server.Run(true, 2000, false);
+  ASSERT_EQ(4000u, poses.size());
+  EXPECT_LT(poses[1999].Rot().Yaw() + 0.1, poses.back().Rot().Yaw());
+}
+
 // Run multiple times
 INSTANTIATE_TEST_SUITE_P(ServerRepeat, VelocityControlTest,
     ::testing::Range(1, 2));
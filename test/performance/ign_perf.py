@@ -19,6 +19,86 @@ def read_data(filename):
                 entries.append([float(r) for r in row])
     return (header, np.array(entries))
 
+def read_systems(filename):
+    """Read the per system statistics written by the runner.
+
+    Returns a list of rows as dictionaries, one per system, phase and
+    statistics window."""
+    rows = []
+    with open(filename) as csvfile:
+        reader = csv.reader(csvfile, delimiter=',', quotechar='"',
+                            skipinitialspace=True)
+        for row in reader:
+            if not row or row[0][0] == '#':
+                continue
+            rows.append({
+                'sim_time': float(row[0]) + 1e-9 * float(row[1]),
+                'system': row[2],
+                'phase': row[3],
+                'count': int(row[4]),
+                'mean': float(row[5]),
+                'p50': float(row[6]),
+                'p99': float(row[7]),
+                'max': float(row[8]),
+            })
+    return rows
+
+def summarize_systems(rows):
+    """Combine the statistics windows of each system and phase.
+
+    The mean is weighted by the number of steps in each window. Percentiles
+    can't be combined exactly, so the median of the window p50s and the
+    largest window p99 are reported."""
+    groups = {}
+    for row in rows:
+        groups.setdefault((row['system'], row['phase']), []).append(row)
+
+    summary = []
+    for (system, phase), windows in groups.items():
+        count = sum(w['count'] for w in windows)
+        total = sum(w['mean'] * w['count'] for w in windows)
+        summary.append({
+            'system': system,
+            'phase': phase,
+            'count': count,
+            'total': total,
+            'mean': total / count if count else 0.0,
+            'p50': float(np.median([w['p50'] for w in windows])),
+            'p99': max(w['p99'] for w in windows),
+            'max': max(w['max'] for w in windows),
+        })
+    return sorted(summary, key=lambda s: s['total'], reverse=True)
+
+def print_systems_table(summary):
+    name_width = max([len(s['system']) for s in summary] + [6])
+    print(f'{"System":<{name_width}}  {"Phase":<11}  {"Steps":>7}  '
+          f'{"Mean ms":>9}  {"P50 ms":>9}  {"P99 ms":>9}  {"Max ms":>9}')
+    for s in summary:
+        print(f'{s["system"]:<{name_width}}  {s["phase"]:<11}  '
+              f'{s["count"]:>7}  {s["mean"]:>9.4f}  {s["p50"]:>9.4f}  '
+              f'{s["p99"]:>9.4f}  {s["max"]:>9.4f}')
+
+def print_systems_breakdown(summary, width=40):
+    """Print the share of the measured time of each phase, then of each
+    system within it, as text bars."""
+    total = sum(s['total'] for s in summary)
+    if total <= 0:
+        return
+
+    for phase in ['levels', 'pre_update', 'update', 'post_update']:
+        systems = [s for s in summary if s['phase'] == phase]
+        phase_total = sum(s['total'] for s in systems)
+        if not systems:
+            continue
+
+        share = phase_total / total
+        print(f'{phase:<11} {"#" * round(share * width):<{width}} '
+              f'{share * 100:6.2f}%')
+        for s in systems:
+            share = s['total'] / total
+            print(f'  {"#" * round(share * width):<{width}}   '
+                  f'{share * 100:6.2f}% {s["system"]}')
+
 def compute_rtfs(data):
     # Compute time deltas
     real_dt = np.diff(real_time)
@@ -33,6 +113,9 @@ if __name__ == '__main__':
     parser.add_argument('--summarize', action='store_true')
     parser.add_argument('--plot', action='store_true')
     parser.add_argument('--hist', action='store_true')
+    parser.add_argument('--systems', metavar='SYSTEMS_CSV',
+                        help='systems.csv written by the runner, to report '
+                             'the time spent in each system and phase')
     args = parser.parse_args()
 
     (header, data) = read_data(args.filename)
@@ -69,6 +152,19 @@ if __name__ == '__main__':
         print(f'  Sim Time:  {mx_sim:0.5f}')
         print(f'  Real Time: {mx_real:0.5f}')
 
+        step_ms = 1e3 * np.diff(real_time)
+        print('Step real time (ms):')
+        for p in [50, 90, 99, 99.9]:
+            print(f'  P{p:<5} {np.percentile(step_ms, p):0.5f}')
+        print(f'  Max    {np.max(step_ms):0.5f}')
+
+    if args.systems:
+        summary = summarize_systems(read_systems(args.systems))
+        print()
+        print_systems_table(summary)
+        print()
+        print_systems_breakdown(summary)
+
     if args.plot:
         plt.figure()
         plt.plot(sim_time[:-1], rtfs)
@@ -86,4 +182,5 @@ if __name__ == '__main__':
         plt.grid(True)
 
 
-    plt.show()
+    if args.plot or args.hist:
+        plt.show()
@@ -17,17 +17,243 @@
 
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 #include <ignition/math/Stopwatch.hh>
 #include <ignition/common/Console.hh>
+#include <ignition/msgs/param_v.pb.h>
+#include <ignition/transport/Node.hh>
 
 #include "ignition/gazebo/Server.hh"
 #include "ignition/gazebo/SystemLoader.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/test_config.hh"  // NOLINT(build/include)
 
+#include "../helpers/Relay.hh"
+
 using namespace ignition;
 using namespace gazebo;
+using namespace std::chrono_literals;
+
+using Clock = std::chrono::steady_clock;
+
+/// \brief Length of each level along X, in meters.
+constexpr double kLevelSize{10.0};
+
+/// \brief Distance performers move each step, in meters. They cross a level
+/// every 50 steps.
+constexpr double kPerformerSpeed{0.2};
+
+/// \brief Steps run before measuring, which load the initial levels.
+constexpr uint64_t kWarmupSteps{20};
+
+/// \brief Steps measured for each world.
+constexpr uint64_t kMeasuredSteps{1000};
+
+/// \brief Generate a world with a row of levels along X, each holding static
+/// models, and performers spread evenly along the row. Performers aren't
+/// part of any level, so they're always loaded. There's no physics, so the
+/// steps measure the level manager and the entity component manager.
+/// \param[in] _name World name.
+/// \param[in] _levels Number of levels.
+/// \param[in] _performers Number of performers.
+/// \param[in] _entitiesPerLevel Number of models in each level.
+/// \return SDF string of the world.
+static std::string LevelWorld(const std::string &_name, int _levels,
+    int _performers, int _entitiesPerLevel)
+{
+  const double length = _levels * kLevelSize;
+
+  std::ostringstream sdf;
+  sdf << "<?xml version=\"1.0\" ?>\n"
+      << "<sdf version=\"1.6\">\n"
+      << "  <world name=\"" << _name << "\">\n"
+      // Any system keeps the default ones, including physics, from loading
+      << "    <plugin filename=\"ignition-gazebo-user-commands-system\"\n"
+      << "            name=\"ignition::gazebo::systems::UserCommands\"/>\n";
+
+  for (int p = 0; p < _performers; ++p)
+  {
+    sdf << "    <model name=\"performer_" << p << "\">\n"
+        << "      <pose>" << (p + 0.5) * length / _performers
+        << " 0 0.5 0 0 0</pose>\n"
+        << "      <link name=\"link\"/>\n"
+        << "    </model>\n";
+  }
+
+  for (int l = 0; l < _levels; ++l)
+  {
+    for (int e = 0; e < _entitiesPerLevel; ++e)
+    {
+      sdf << "    <model name=\"level_" << l << "_model_" << e << "\">\n"
+          << "      <static>true</static>\n"
+          << "      <pose>"
+          << l * kLevelSize + (e + 0.5) * kLevelSize / _entitiesPerLevel
+          << " 2 0.5 0 0 0</pose>\n"
+          << "      <link name=\"link\">\n"
+          << "        <visual name=\"visual\">\n"
+          << "          <geometry><box><size>0.1 0.1 0.1</size></box>"
+          << "</geometry>\n"
+          << "        </visual>\n"
+          << "      </link>\n"
+          << "    </model>\n";
+    }
+  }
+
+  sdf << "    <plugin name=\"ignition::gazebo\" filename=\"dummy\">\n";
+  for (int p = 0; p < _performers; ++p)
+  {
+    sdf << "      <performer name=\"perf_" << p << "\">\n"
+        << "        <ref>performer_" << p << "</ref>\n"
+        << "        <geometry><box><size>2 2 2</size></box></geometry>\n"
+        << "      </performer>\n";
+  }
+  for (int l = 0; l < _levels; ++l)
+  {
+    sdf << "      <level name=\"level_" << l << "\">\n"
+        << "        <pose>" << (l + 0.5) * kLevelSize << " 0 0 0 0 0</pose>\n"
+        << "        <geometry><box><size>" << kLevelSize << " "
+        << kLevelSize << " " << kLevelSize << "</size></box></geometry>\n"
+        << "        <buffer>1</buffer>\n";
+    for (int e = 0; e < _entitiesPerLevel; ++e)
+      sdf << "        <ref>level_" << l << "_model_" << e << "</ref>\n";
+    sdf << "      </level>\n";
+  }
+  sdf << "    </plugin>\n"
+      << "  </world>\n"
+      << "</sdf>\n";
+  return sdf.str();
+}
+
+/// \brief State at the start of the PreUpdate phase of one step.
+struct StepRecord
+{
+  /// \brief When PreUpdate started.
+  Clock::time_point time;
+
+  /// \brief Number of entities.
+  std::size_t entityCount;
+};
+
+/// \brief Step time statistics, in milliseconds.
+struct StepSummary
+{
+  /// \brief Median time of steps which didn't load nor unload entities.
+  double steadyP50Ms{0.0};
+
+  /// \brief 99th percentile time of steps which didn't load nor unload
+  /// entities.
+  double steadyP99Ms{0.0};
+
+  /// \brief Longest step which loaded or unloaded entities.
+  double transitionMaxMs{0.0};
+
+  /// \brief Number of steps which loaded or unloaded entities.
+  std::size_t transitions{0};
+};
+
+/// \brief Get a percentile of some values.
+/// \param[in] _values Values, they're sorted in place.
+/// \param[in] _p Percentile, between 0 and 1.
+/// \return The percentile, or 0 if there are no values.
+static double Percentile(std::vector<double> &_values, double _p)
+{
+  if (_values.empty())
+    return 0.0;
+
+  std::sort(_values.begin(), _values.end());
+  auto index = static_cast<std::size_t>(_p * (_values.size() - 1));
+  return _values[index];
+}
+
+/// \brief Summarize consecutive steps. A step's time is the time between
+/// the start of its PreUpdate and the previous one, so it includes the
+/// levels loaded at its start and the entities removed at the end of the
+/// previous step. The first record only marks the start of the second step.
+/// \param[in] _records Records of consecutive steps.
+/// \return Summary of the steps.
+static StepSummary Summarize(const std::vector<StepRecord> &_records)
+{
+  StepSummary summary;
+  std::vector<double> steady;
+  for (std::size_t i = 1; i < _records.size(); ++i)
+  {
+    const double ms = std::chrono::duration<double, std::milli>(
+        _records[i].time - _records[i - 1].time).count();
+    if (_records[i].entityCount != _records[i - 1].entityCount)
+    {
+      summary.transitionMaxMs = std::max(summary.transitionMaxMs, ms);
+      ++summary.transitions;
+    }
+    else
+    {
+      steady.push_back(ms);
+    }
+  }
+  summary.steadyP50Ms = Percentile(steady, 0.5);
+  summary.steadyP99Ms = Percentile(steady, 0.99);
+  return summary;
+}
+
+/// \brief Statistics of one phase, combined over several stats/systems
+/// messages.
+struct PhaseStats
+{
+  /// \brief Number of steps.
+  int count{0};
+
+  /// \brief Mean time, in milliseconds.
+  double meanMs{0.0};
+
+  /// \brief Longest time, in milliseconds.
+  double maxMs{0.0};
+};
+
+/// \brief Add the statistics of a phase in a stats/systems message.
+/// \param[in] _msg Message.
+/// \param[in] _name Name of the system.
+/// \param[in] _phase Phase.
+/// \param[in, out] _stats Statistics to add to.
+static void AddPhaseStats(const msgs::Param_V &_msg, const std::string &_name,
+    const std::string &_phase, PhaseStats &_stats)
+{
+  for (const auto &param : _msg.param())
+  {
+    const auto &params = param.params();
+    auto name = params.find("name");
+    auto count = params.find(_phase + "_count");
+    auto mean = params.find(_phase + "_mean_ms");
+    auto max = params.find(_phase + "_max_ms");
+    if (name == params.end() || name->second.string_value() != _name ||
+        count == params.end() || mean == params.end() || max == params.end())
+    {
+      continue;
+    }
+
+    const int total = _stats.count + count->second.int_value();
+    if (total == 0)
+      continue;
+
+    _stats.meanMs = (_stats.meanMs * _stats.count +
+        mean->second.double_value() * count->second.int_value()) / total;
+    _stats.maxMs = std::max(_stats.maxMs, max->second.double_value());
+    _stats.count = total;
+  }
+}
 
 TEST(LevelManagerPerfrormance, LevelVsNoLevel)
 {
@@ -76,3 +302,266 @@ TEST(LevelManagerPerfrormance, LevelVsNoLevel)
 
   EXPECT_LE(levelsDuration.count(), nolevelsDuration.count());
 }
+
+/////////////////////////////////////////////////
+// Move performers along a row of levels, and measure the steps which load
+// and unload levels, the steps in between, and UpdateLevelsState, for
+// every combination of level count, performer count and level size.
+TEST(LevelManagerPerfrormance, Scaling)
+{
+  common::Console::SetVerbosity(1);
+
+  setenv("IGN_GAZEBO_SYSTEM_PLUGIN_PATH",
+         (std::string(PROJECT_BINARY_PATH) + "/lib").c_str(), 1);
+
+  const std::array<int, 2> levelCounts{16, 256};
+  const std::array<int, 2> performerCounts{1, 8};
+  const std::array<int, 2> entityCounts{10, 100};
+
+  // UpdateLevelsState statistics, by {levels, performers, entities}
+  std::map<std::tuple<int, int, int>, PhaseStats> levelsStats;
+
+  std::cout << std::setw(7) << "levels" << std::setw(11) << "performers"
+            << std::setw(9) << "entities" << std::setw(12) << "steady p50"
+            << std::setw(12) << "steady p99" << std::setw(13) << "transitions"
+            << std::setw(16) << "transition max" << std::setw(13)
+            << "levels mean" << std::setw(12) << "levels max"
+            << "  (ms)" << std::endl;
+
+  for (int levels : levelCounts)
+  {
+    for (int performers : performerCounts)
+    {
+      for (int entities : entityCounts)
+      {
+        const std::string worldName = "levels_" + std::to_string(levels) +
+            "_" + std::to_string(performers) + "_" + std::to_string(entities);
+
+        std::mutex mutex;
+        std::vector<msgs::Param_V> statsMsgs;
+        std::function<void(const msgs::Param_V &)> statsCb =
+            [&](const msgs::Param_V &_msg)
+            {
+              std::lock_guard<std::mutex> lock(mutex);
+              statsMsgs.push_back(_msg);
+            };
+        transport::Node node;
+        node.Subscribe("/world/" + worldName + "/stats/systems", statsCb);
+
+        ServerConfig serverConfig;
+        serverConfig.SetSdfString(LevelWorld(worldName, levels, performers,
+            entities));
+        serverConfig.SetUseLevels(true);
+
+        Server server(serverConfig);
+        server.SetUpdatePeriod(1ns);
+
+        // Record each step and move the performers, wrapping around at the
+        // end of the row
+        const double length = levels * kLevelSize;
+        std::vector<Entity> performerEntities;
+        std::vector<StepRecord> records;
+        records.reserve(kWarmupSteps + kMeasuredSteps + 2);
+
+        test::Relay relay;
+        relay.OnPreUpdate(
+            [&](const UpdateInfo &, EntityComponentManager &_ecm)
+            {
+              records.push_back({Clock::now(), _ecm.EntityCount()});
+
+              if (performerEntities.empty())
+              {
+                for (int p = 0; p < performers; ++p)
+                {
+                  performerEntities.push_back(_ecm.EntityByComponents(
+                      components::Model(),
+                      components::Name("performer_" + std::to_string(p))));
+                }
+              }
+
+              for (const auto &entity : performerEntities)
+              {
+                auto poseComp = _ecm.Component<components::Pose>(entity);
+                if (nullptr == poseComp)
+                  continue;
+
+                auto pose = poseComp->Data();
+                double x = pose.Pos().X() + kPerformerSpeed;
+                if (x > length)
+                  x -= length;
+                pose.Pos().X(x);
+                *poseComp = components::Pose(pose);
+                _ecm.SetChanged(entity, components::Pose::typeId,
+                    ComponentState::OneTimeChange);
+              }
+            });
+        server.AddSystem(relay.systemPtr);
+
+        // Statistics are published at most once per second, at the start
+        // of a step, and cover the steps since the previous message. Flush
+        // the ones of the warm up, then the ones of the measured steps.
+        server.Run(true, kWarmupSteps, false);
+        std::this_thread::sleep_for(1100ms);
+        server.Run(true, 1, false);
+        const uint64_t measuredStart = *server.IterationCount();
+
+        server.Run(true, kMeasuredSteps, false);
+        std::this_thread::sleep_for(1100ms);
+        server.Run(true, 1, false);
+        const uint64_t measuredEnd = *server.IterationCount();
+
+        // Steps are 1 ms long in sim time
+        auto stampMs = [](const msgs::Param_V &_msg)
+        {
+          return static_cast<uint64_t>(_msg.header().stamp().sec()) * 1000 +
+              static_cast<uint64_t>(_msg.header().stamp().nsec()) / 1000000;
+        };
+
+        PhaseStats stats;
+        for (int sleep = 0; sleep < 100; ++sleep)
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!statsMsgs.empty() && stampMs(statsMsgs.back()) >= measuredEnd)
+          {
+            for (const auto &msg : statsMsgs)
+            {
+              if (stampMs(msg) > measuredStart)
+                AddPhaseStats(msg, "LevelManager", "levels", stats);
+            }
+            break;
+          }
+          std::this_thread::sleep_for(10ms);
+        }
+        EXPECT_GT(stats.count, 0) << worldName;
+        levelsStats[{levels, performers, entities}] = stats;
+
+        // Only the steps of the measured run, without the flush steps
+        const auto summary = Summarize({records.begin() + kWarmupSteps + 1,
+            records.end() - 1});
+
+        // Every performer crosses several levels
+        EXPECT_GT(summary.transitions, 0u) << worldName;
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::setw(7) << levels << std::setw(11) << performers
+                  << std::setw(9) << entities
+                  << std::setw(12) << summary.steadyP50Ms
+                  << std::setw(12) << summary.steadyP99Ms
+                  << std::setw(13) << summary.transitions
+                  << std::setw(16) << summary.transitionMaxMs
+                  << std::setw(13) << stats.meanMs
+                  << std::setw(12) << stats.maxMs << std::endl;
+      }
+    }
+  }
+
+  // Performers only check the levels near them, so the cost of updating
+  // the levels mustn't grow with the number of levels. 16 times more levels
+  // are allowed at most 4 times the cost, to leave room for noise.
+  const int fewLevels = levelCounts.front();
+  const int manyLevels = levelCounts.back();
+  for (int performers : performerCounts)
+  {
+    for (int entities : entityCounts)
+    {
+      const auto &few = levelsStats[{fewLevels, performers, entities}];
+      const auto &many = levelsStats[{manyLevels, performers, entities}];
+      EXPECT_LT(many.meanMs, 4.0 * few.meanMs)
+          << "UpdateLevelsState regressed with " << performers
+          << " performers and " << entities << " entities per level: "
+          << few.meanMs << " ms with " << fewLevels << " levels, "
+          << many.meanMs << " ms with " << manyLevels << " levels.";
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+// Measure the step latency of a primary as the number of secondaries grows.
+// Each secondary simulates one performer, in its own level. All servers run
+// in this process, which doesn't measure the network, but does measure the
+// step hand-off, state merging and level bookkeeping on both sides.
+TEST(DistributedPerformance, SecondaryScaling)
+{
+  common::Console::SetVerbosity(1);
+
+  setenv("IGN_GAZEBO_SYSTEM_PLUGIN_PATH",
+         (std::string(PROJECT_BINARY_PATH) + "/lib").c_str(), 1);
+
+  const std::array<int, 4> secondaryCounts{1, 2, 4, 8};
+  const int entitiesPerLevel{10};
+
+  // Median step time, by number of secondaries
+  std::map<int, double> p50Ms;
+
+  std::cout << std::setw(12) << "secondaries" << std::setw(10) << "p50"
+            << std::setw(10) << "p99" << std::setw(10) << "max"
+            << "  (ms)" << std::endl;
+
+  for (int secondaries : secondaryCounts)
+  {
+    const std::string worldName = "distributed_" +
+        std::to_string(secondaries);
+    const std::string world = LevelWorld(worldName, secondaries, secondaries,
+        entitiesPerLevel);
+
+    ServerConfig primaryConfig;
+    primaryConfig.SetSdfString(world);
+    primaryConfig.SetNetworkRole("primary");
+    primaryConfig.SetNetworkSecondaries(secondaries);
+    primaryConfig.SetUseLevels(true);
+
+    auto primary = std::make_unique<Server>(primaryConfig);
+    primary->SetUpdatePeriod(1ns);
+
+    std::vector<Clock::time_point> stepTimes;
+    stepTimes.reserve(kWarmupSteps + kMeasuredSteps);
+    test::Relay relay;
+    relay.OnPreUpdate(
+        [&](const UpdateInfo &, EntityComponentManager &)
+        {
+          stepTimes.push_back(Clock::now());
+        });
+    primary->AddSystem(relay.systemPtr);
+
+    ServerConfig secondaryConfig;
+    secondaryConfig.SetSdfString(world);
+    secondaryConfig.SetNetworkRole("secondary");
+    secondaryConfig.SetUseLevels(true);
+
+    std::vector<std::unique_ptr<Server>> secondaryServers;
+    for (int i = 0; i < secondaries; ++i)
+    {
+      secondaryServers.push_back(std::make_unique<Server>(secondaryConfig));
+      secondaryServers.back()->Run(false, 0, false);
+    }
+
+    // Returns once all secondaries joined and the steps are done
+    EXPECT_TRUE(primary->Run(true, kWarmupSteps + kMeasuredSteps, false));
+
+    std::vector<double> ms;
+    for (std::size_t i = kWarmupSteps; i < stepTimes.size(); ++i)
+    {
+      ms.push_back(std::chrono::duration<double, std::milli>(
+          stepTimes[i] - stepTimes[i - 1]).count());
+    }
+    EXPECT_EQ(kMeasuredSteps, ms.size()) << worldName;
+
+    p50Ms[secondaries] = Percentile(ms, 0.5);
+    std::cout << std::fixed << std::setprecision(3)
+              << std::setw(12) << secondaries
+              << std::setw(10) << p50Ms[secondaries]
+              << std::setw(10) << Percentile(ms, 0.99)
+              << std::setw(10) << Percentile(ms, 1.0) << std::endl;
+
+    primary.reset();
+    secondaryServers.clear();
+  }
+
+  // Secondaries step in parallel, so the latency mustn't grow faster than
+  // the number of secondaries.
+  const int fewest = secondaryCounts.front();
+  const int most = secondaryCounts.back();
+  EXPECT_LT(p50Ms[most], p50Ms[fewest] * most / fewest)
+      << "Step latency regressed: " << p50Ms[fewest] << " ms with " << fewest
+      << " secondaries, " << p50Ms[most] << " ms with " << most << ".";
+}
@@ -16,11 +16,18 @@
  */
 
 #include <array>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include <ignition/msgs.hh>
 #include <ignition/math/Stopwatch.hh>
 #include <ignition/common/Console.hh>
 
+#include <sdf/Root.hh>
+#include <sdf/World.hh>
+
 #include "ignition/transport/Node.hh"
 
 #include "ignition/gazebo/Server.hh"
@@ -95,9 +102,26 @@ int main(int _argc, char** _argv)
       }
     };
 
+  // Timing statistics of each system, published about once per second
+  std::mutex systemStatsMutex;
+  std::vector<ignition::msgs::Param_V> systemStats;
+  std::function<void(const ignition::msgs::Param_V &)> cb3 =
+    [&](const ignition::msgs::Param_V &_msg)
+    {
+      std::lock_guard<std::mutex> lock(systemStatsMutex);
+      systemStats.push_back(_msg);
+    };
+
   node.Subscribe("/clock", cb);
   node.Subscribe("/stats", cb2);
 
+  sdf::Root root;
+  if (root.Load(sdfFile).empty() && root.WorldCount() > 0)
+  {
+    node.Subscribe("/world/" + root.WorldByIndex(0)->Name() +
+        "/stats/systems", cb3);
+  }
+
   // Run the server
   server.Run(true, iterations, false);
 
@@ -114,5 +138,47 @@ int main(int _argc, char** _argv)
         << msg.sim().sec() << ", " << msg.sim().nsec() << std::endl;
   }
 
+  // One row per system and phase for each statistics window
+  std::ofstream systemsOfs("systems.csv", std::ofstream::out);
+
+  systemsOfs << "# Filename: " << sdfFile << std::endl;
+  systemsOfs << "# Iterations: " << iterations << std::endl;
+  systemsOfs << "# Rate: " << updateRate << std::endl;
+  systemsOfs << "# sim s, sim ns, system, phase, count, mean ms, p50 ms, "
+             << "p99 ms, max ms" << std::endl;
+
+  std::lock_guard<std::mutex> lock(systemStatsMutex);
+  for (const auto &msg : systemStats)
+  {
+    const auto &stamp = msg.header().stamp();
+    for (const auto &param : msg.param())
+    {
+      const auto &params = param.params();
+      auto name = params.find("name");
+      if (name == params.end())
+        continue;
+
+      for (const std::string phase :
+          {"levels", "pre_update", "update", "post_update"})
+      {
+        auto count = params.find(phase + "_count");
+        if (count == params.end() || count->second.int_value() == 0)
+          continue;
+
+        auto ms = [&](const std::string &_stat)
+        {
+          auto value = params.find(phase + "_" + _stat + "_ms");
+          return value == params.end() ? 0.0 : value->second.double_value();
+        };
+
+        systemsOfs << stamp.sec() << ", " << stamp.nsec() << ", "
+                   << name->second.string_value() << ", " << phase << ", "
+                   << count->second.int_value() << ", " << ms("mean") << ", "
+                   << ms("p50") << ", " << ms("p99") << ", " << ms("max")
+                   << std::endl;
+      }
+    }
+  }
+
   return 0;
 }